@@ -26,7 +26,9 @@
 #include <ray/api/task_caller.h>
 #include <ray/api/wait_result.h>
 
+#include <atomic>
 #include <boost/callable_traits.hpp>
+#include <future>
 #include <memory>
 #include <msgpack.hpp>
 #include <mutex>
@@ -85,6 +87,22 @@ template <typename T>
 WaitResult<T> Wait(const std::vector<ray::ObjectRef<T>> &objects, int num_objects,
                    int timeout_ms);
 
+/// Get a list of objects from the object store without blocking the calling thread.
+///
+/// \param[in] objects The object array which should be got.
+/// \return future of the results in the order of the objects, which is ready when all
+/// the objects are, or holds the first error raised while getting them.
+template <typename T>
+std::future<std::vector<std::shared_ptr<T>>> WhenAll(
+    const std::vector<ray::ObjectRef<T>> &objects);
+
+/// Wait for the first of a list of objects without blocking the calling thread.
+///
+/// \param[in] objects The object array which should be waited, it must not be empty.
+/// \return future of the index of the first object which is ready.
+template <typename T>
+std::future<size_t> WhenAny(const std::vector<ray::ObjectRef<T>> &objects);
+
 /// Create a `TaskCaller` for calling remote function.
 /// It is used for normal task, such as ray::Task(Plus1, 1), ray::Task(Plus, 1, 2).
 /// \param[in] func The function to be remote executed.
@@ -190,6 +208,83 @@ inline WaitResult<T> Wait(const std::vector<ray::ObjectRef<T>> &objects, int num
   return WaitResult<T>(std::move(readys), std::move(unreadys));
 }
 
+template <typename T>
+inline std::future<std::vector<std::shared_ptr<T>>> WhenAll(
+    const std::vector<ray::ObjectRef<T>> &objects) {
+  struct State {
+    std::mutex mutex;
+    std::vector<ray::ObjectRef<T>> objects;
+    std::vector<std::shared_ptr<T>> results;
+    size_t remaining;
+    bool done = false;
+    std::promise<std::vector<std::shared_ptr<T>>> promise;
+  };
+  auto state = std::make_shared<State>();
+  state->objects = objects;
+  state->results.resize(objects.size());
+  state->remaining = objects.size();
+  auto future = state->promise.get_future();
+  if (objects.empty()) {
+    state->promise.set_value({});
+    return future;
+  }
+  for (size_t i = 0; i < objects.size(); i++) {
+    ray::internal::GetRayRuntime()->GetAsync(
+        objects[i].ID(), [state, i](std::shared_ptr<msgpack::sbuffer> packed_object,
+                                    std::exception_ptr error) {
+          std::shared_ptr<T> result;
+          if (!error) {
+            try {
+              result = UnpackResult<T>(packed_object);
+            } catch (...) {
+              error = std::current_exception();
+            }
+          }
+          std::lock_guard<std::mutex> lock(state->mutex);
+          if (state->done) {
+            return;
+          }
+          if (error) {
+            state->done = true;
+            state->promise.set_exception(error);
+            return;
+          }
+          state->results[i] = std::move(result);
+          if (--state->remaining == 0) {
+            state->done = true;
+            state->promise.set_value(std::move(state->results));
+          }
+        });
+  }
+  return future;
+}
+
+template <typename T>
+inline std::future<size_t> WhenAny(const std::vector<ray::ObjectRef<T>> &objects) {
+  if (objects.empty()) {
+    throw ray::internal::RayException("WhenAny needs at least one object");
+  }
+  struct State {
+    std::vector<ray::ObjectRef<T>> objects;
+    std::atomic<bool> done{false};
+    std::promise<size_t> promise;
+  };
+  auto state = std::make_shared<State>();
+  state->objects = objects;
+  auto future = state->promise.get_future();
+  for (size_t i = 0; i < objects.size(); i++) {
+    // An object whose get failed is ready as well, the error is raised when it is got.
+    ray::internal::GetRayRuntime()->GetAsync(
+        objects[i].ID(),
+        [state, i](std::shared_ptr<msgpack::sbuffer>, std::exception_ptr) {
+          if (!state->done.exchange(true)) {
+            state->promise.set_value(i);
+          }
+        });
+  }
+  return future;
+}
+
 template <typename FuncType>
 inline ray::internal::TaskCaller<FuncType> TaskInternal(FuncType &func) {
   ray::internal::RemoteFunctionHolder remote_func_holder(func);
@@ -303,17 +303,24 @@ class FunctionManager {
 
   template <typename Function>
   bool RegisterNonMemberFunc(std::string const &name, Function f) {
+    // A lambda holding the function pointer fits the small buffer of std::function,
+    // and is called without the extra indirection of a std::bind wrapper.
     return map_invokers_
-        .emplace(name, std::bind(&Invoker<Function>::Apply, std::move(f),
-                                 std::placeholders::_1))
+        .emplace(name,
+                 [f](const std::vector<msgpack::sbuffer> &args_buffer) {
+                   return Invoker<Function>::Apply(f, args_buffer);
+                 })
         .second;
   }
 
   template <typename Function>
   bool RegisterMemberFunc(std::string const &name, Function f) {
     return map_mem_func_invokers_
-        .emplace(name, std::bind(&Invoker<Function>::ApplyMember, std::move(f),
-                                 std::placeholders::_1, std::placeholders::_2))
+        .emplace(name,
+                 [f](msgpack::sbuffer *ptr,
+                     const std::vector<msgpack::sbuffer> &args_buffer) {
+                   return Invoker<Function>::ApplyMember(f, ptr, args_buffer);
+                 })
         .second;
   }
 
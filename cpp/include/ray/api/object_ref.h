@@ -17,6 +17,7 @@
 #include <ray/api/ray_runtime_holder.h>
 #include <ray/api/serializer.h>
 
+#include <future>
 #include <memory>
 #include <msgpack.hpp>
 #include <utility>
@@ -75,6 +76,12 @@ class ObjectRef {
   /// \return shared pointer of the result.
   std::shared_ptr<T> Get() const;
 
+  /// Get the object from the object store without blocking the calling thread while
+  /// the object is not ready. The object is kept alive until the result is set.
+  ///
+  /// \return future of the result.
+  std::future<std::shared_ptr<T>> GetAsync() const;
+
   /// Make ObjectRef serializable
   MSGPACK_DEFINE(id_);
 
@@ -84,14 +91,43 @@ class ObjectRef {
 
 // ---------- implementation ----------
 template <typename T>
-inline static std::shared_ptr<T> GetFromRuntime(const ObjectRef<T> &object) {
-  auto packed_object = internal::GetRayRuntime()->Get(object.ID());
+inline static std::shared_ptr<T> UnpackResult(
+    const std::shared_ptr<msgpack::sbuffer> &packed_object) {
   CheckResult(packed_object);
 
   return ray::internal::Serializer::Deserialize<std::shared_ptr<T>>(
       packed_object->data(), packed_object->size());
 }
 
+template <typename T>
+inline static std::shared_ptr<T> GetFromRuntime(const ObjectRef<T> &object) {
+  auto runtime = internal::GetRayRuntime();
+  auto cached = runtime->GetCachedValue(object.ID(), typeid(T));
+  if (cached != nullptr) {
+    return std::static_pointer_cast<T>(cached);
+  }
+  auto packed_object = runtime->Get(object.ID());
+  auto value = UnpackResult<T>(packed_object);
+  runtime->CacheValue(object.ID(), typeid(T), value, packed_object->size());
+  return value;
+}
+
+/// Set a promise with the result of an asynchronous get, unpacked by `unpack`.
+template <typename R, typename Unpack>
+inline static void SetPromise(std::promise<R> &promise,
+                              const std::shared_ptr<msgpack::sbuffer> &packed_object,
+                              std::exception_ptr error, Unpack unpack) {
+  if (error) {
+    promise.set_exception(error);
+    return;
+  }
+  try {
+    unpack(promise, packed_object);
+  } catch (...) {
+    promise.set_exception(std::current_exception());
+  }
+}
+
 template <typename T>
 ObjectRef<T>::ObjectRef() {}
 
@@ -120,6 +156,23 @@ inline std::shared_ptr<T> ObjectRef<T>::Get() const {
   return GetFromRuntime(*this);
 }
 
+template <typename T>
+inline std::future<std::shared_ptr<T>> ObjectRef<T>::GetAsync() const {
+  auto promise = std::make_shared<std::promise<std::shared_ptr<T>>>();
+  auto future = promise->get_future();
+  ObjectRef<T> object = *this;
+  internal::GetRayRuntime()->GetAsync(
+      id_, [promise, object](std::shared_ptr<msgpack::sbuffer> packed_object,
+                             std::exception_ptr error) {
+        SetPromise(*promise, packed_object, error,
+                   [](std::promise<std::shared_ptr<T>> &promise,
+                      const std::shared_ptr<msgpack::sbuffer> &packed_object) {
+                     promise.set_value(UnpackResult<T>(packed_object));
+                   });
+      });
+  return future;
+}
+
 template <>
 class ObjectRef<void> {
  public:
@@ -149,6 +202,27 @@ class ObjectRef<void> {
     CheckResult(packed_object);
   }
 
+  /// Wait for the object without blocking the calling thread while the object is not
+  /// ready.
+  ///
+  /// \return future which is ready when the object is.
+  std::future<void> GetAsync() const {
+    auto promise = std::make_shared<std::promise<void>>();
+    auto future = promise->get_future();
+    ObjectRef<void> object = *this;
+    internal::GetRayRuntime()->GetAsync(
+        id_, [promise, object](std::shared_ptr<msgpack::sbuffer> packed_object,
+                               std::exception_ptr error) {
+          SetPromise(*promise, packed_object, error,
+                     [](std::promise<void> &promise,
+                        const std::shared_ptr<msgpack::sbuffer> &packed_object) {
+                       CheckResult(packed_object);
+                       promise.set_value();
+                     });
+        });
+    return future;
+  }
+
   /// Make ObjectRef serializable
   MSGPACK_DEFINE(id_);
 
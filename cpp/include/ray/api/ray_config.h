@@ -52,6 +52,17 @@ class RayConfig {
 
   // A mapping the names of custom resources to the quantities for them available.
   std::unordered_map<std::string, int> resources;
+
+  // The maximum total size in bytes of the objects whose deserialized values are cached,
+  // so that getting the same object again returns the same value without deserializing
+  // it. The cached values are shared by all the gets of an object, and must not be
+  // modified. 0 disables the cache.
+  int64_t deserialized_value_cache_bytes = 0;
+
+  // The number of workers each worker process of this application hosts. The workers
+  // of a process share its memory, so more of them fit on a node, but a crash of one
+  // worker takes down the others.
+  int num_workers_per_process = 1;
 };
 
 }  // namespace ray
\ No newline at end of file
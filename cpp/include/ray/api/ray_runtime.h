@@ -18,8 +18,11 @@
 #include <ray/api/task_options.h>
 
 #include <cstdint>
+#include <exception>
+#include <functional>
 #include <memory>
 #include <msgpack.hpp>
+#include <typeindex>
 #include <typeinfo>
 #include <vector>
 
@@ -42,11 +45,20 @@ struct RemoteFunctionHolder {
   std::string function_name;
 };
 
+/// The callback of an asynchronous get, invoked with the result buffer, or with the
+/// exception raised while getting the object.
+using GetAsyncCallback =
+    std::function<void(std::shared_ptr<msgpack::sbuffer>, std::exception_ptr)>;
+
 class RayRuntime {
  public:
   virtual std::string Put(std::shared_ptr<msgpack::sbuffer> data) = 0;
   virtual std::shared_ptr<msgpack::sbuffer> Get(const std::string &id) = 0;
 
+  /// Get an object without blocking. The callback may run on a Ray thread, and must not
+  /// block.
+  virtual void GetAsync(const std::string &id, GetAsyncCallback callback) = 0;
+
   virtual std::vector<std::shared_ptr<msgpack::sbuffer>> Get(
       const std::vector<std::string> &ids) = 0;
 
@@ -56,6 +68,9 @@ class RayRuntime {
   virtual std::string Call(const RemoteFunctionHolder &remote_function_holder,
                            std::vector<TaskArg> &args,
                            const CallOptions &task_options) = 0;
+  virtual std::vector<std::string> CallBatch(
+      const RemoteFunctionHolder &remote_function_holder,
+      std::vector<std::vector<TaskArg>> &args_list, const CallOptions &task_options) = 0;
   virtual std::string CreateActor(const RemoteFunctionHolder &remote_function_holder,
                                   std::vector<TaskArg> &args,
                                   const ActorCreationOptions &create_options) = 0;
@@ -64,6 +79,18 @@ class RayRuntime {
                                 const CallOptions &call_options) = 0;
   virtual void AddLocalReference(const std::string &id) = 0;
   virtual void RemoveLocalReference(const std::string &id) = 0;
+
+  /// Look up the value an object was deserialized to before.
+  ///
+  /// \return The value, or nullptr if it is not cached.
+  virtual std::shared_ptr<void> GetCachedValue(const std::string &id,
+                                               std::type_index type) = 0;
+  /// Cache the value an object was deserialized to, until the object is no longer
+  /// referenced by this process.
+  ///
+  /// \param[in] size The serialized size of the object.
+  virtual void CacheValue(const std::string &id, std::type_index type,
+                          std::shared_ptr<void> value, size_t size) = 0;
   virtual std::string GetActorId(bool global, const std::string &actor_name) = 0;
   virtual void KillActor(const std::string &str_actor_id, bool no_restart) = 0;
   virtual void ExitActor() = 0;
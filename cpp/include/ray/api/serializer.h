@@ -16,7 +16,10 @@
 
 #include <ray/api/ray_exception.h>
 
+#include <cstring>
+#include <limits>
 #include <msgpack.hpp>
+#include <type_traits>
 
 namespace ray {
 namespace internal {
@@ -33,7 +36,7 @@ class Serializer {
   template <typename T>
   static T Deserialize(const char *data, size_t size) {
     msgpack::unpacked unpacked;
-    msgpack::unpack(unpacked, data, size);
+    msgpack::unpack(unpacked, data, size, ReferenceRawData);
     return unpacked.get().as<T>();
   }
 
@@ -44,15 +47,37 @@ class Serializer {
 
   template <typename T>
   static T Deserialize(const char *data, size_t size, size_t *off) {
-    msgpack::unpacked unpacked = msgpack::unpack(data, size, *off);
+    msgpack::unpacked unpacked = msgpack::unpack(data, size, *off, ReferenceRawData);
     return unpacked.get().as<T>();
   }
 
   template <typename T>
-  static std::pair<bool, T> DeserializeWhenNil(const char *data, size_t size) {
+  static std::enable_if_t<std::is_arithmetic<T>::value, std::pair<bool, T>>
+  DeserializeWhenNil(const char *data, size_t size) {
+    std::pair<bool, T> result;
+    if (DecodeArithmetic(data, size, &result)) {
+      return result;
+    }
+    return DeserializeObjectWhenNil<T>(data, size);
+  }
+
+  template <typename T>
+  static std::enable_if_t<!std::is_arithmetic<T>::value, std::pair<bool, T>>
+  DeserializeWhenNil(const char *data, size_t size) {
+    return DeserializeObjectWhenNil<T>(data, size);
+  }
+
+  static bool HasError(char *data, size_t size) {
+    msgpack::unpacked unpacked = msgpack::unpack(data, size);
+    return unpacked.get().is_nil() && size > 1;
+  }
+
+ private:
+  template <typename T>
+  static std::pair<bool, T> DeserializeObjectWhenNil(const char *data, size_t size) {
     T val;
     size_t off = 0;
-    msgpack::unpacked unpacked = msgpack::unpack(data, size, off);
+    msgpack::unpacked unpacked = msgpack::unpack(data, size, off, ReferenceRawData);
     if (!unpacked.get().convert_if_not_nil(val)) {
       return {false, {}};
     }
@@ -60,9 +85,117 @@ class Serializer {
     return {true, val};
   }
 
-  static bool HasError(char *data, size_t size) {
-    msgpack::unpacked unpacked = msgpack::unpack(data, size);
-    return unpacked.get().is_nil() && size > 1;
+  /// Decode a nil, bool, integer or float argument straight from its msgpack bytes,
+  /// without unpacking it into a zone first. This is the common case of small tasks,
+  /// where unpacking dominates the cost of the call.
+  /// \return false if the value needs a conversion that is left to msgpack, such as an
+  /// integer out of the range of T or an integer converted to a float.
+  template <typename T>
+  static bool DecodeArithmetic(const char *data, size_t size, std::pair<bool, T> *out) {
+    if (size == 0) {
+      return false;
+    }
+    auto type = static_cast<uint8_t>(data[0]);
+    if (type == 0xc0 && size == 1) {
+      *out = {false, T{}};
+      return true;
+    }
+    return DecodeValue(type, data + 1, size - 1, out);
+  }
+
+  static bool DecodeValue(uint8_t type, const char *, size_t size,
+                          std::pair<bool, bool> *out) {
+    if ((type == 0xc2 || type == 0xc3) && size == 0) {
+      *out = {true, type == 0xc3};
+      return true;
+    }
+    return false;
+  }
+
+  template <typename T>
+  static std::enable_if_t<std::is_floating_point<T>::value, bool> DecodeValue(
+      uint8_t type, const char *data, size_t size, std::pair<bool, T> *out) {
+    if (type == 0xca && size == sizeof(float)) {
+      uint32_t bits = LoadBigEndian<uint32_t>(data);
+      float value;
+      std::memcpy(&value, &bits, sizeof(value));
+      *out = {true, static_cast<T>(value)};
+      return true;
+    }
+    if (type == 0xcb && size == sizeof(double)) {
+      uint64_t bits = LoadBigEndian<uint64_t>(data);
+      double value;
+      std::memcpy(&value, &bits, sizeof(value));
+      *out = {true, static_cast<T>(value)};
+      return true;
+    }
+    return false;
+  }
+
+  template <typename T>
+  static std::enable_if_t<std::is_integral<T>::value, bool> DecodeValue(
+      uint8_t type, const char *data, size_t size, std::pair<bool, T> *out) {
+    int64_t value = 0;
+    bool is_negative = false;
+    if (type <= 0x7f && size == 0) {
+      value = type;
+    } else if (type >= 0xe0 && size == 0) {
+      value = static_cast<int8_t>(type);
+      is_negative = true;
+    } else if (type == 0xcc && size == 1) {
+      value = LoadBigEndian<uint8_t>(data);
+    } else if (type == 0xcd && size == 2) {
+      value = LoadBigEndian<uint16_t>(data);
+    } else if (type == 0xce && size == 4) {
+      value = LoadBigEndian<uint32_t>(data);
+    } else if (type == 0xcf && size == 8) {
+      uint64_t unsigned_value = LoadBigEndian<uint64_t>(data);
+      if (unsigned_value > static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+        return false;
+      }
+      *out = {true, static_cast<T>(unsigned_value)};
+      return true;
+    } else if (type == 0xd0 && size == 1) {
+      value = static_cast<int8_t>(LoadBigEndian<uint8_t>(data));
+      is_negative = value < 0;
+    } else if (type == 0xd1 && size == 2) {
+      value = static_cast<int16_t>(LoadBigEndian<uint16_t>(data));
+      is_negative = value < 0;
+    } else if (type == 0xd2 && size == 4) {
+      value = static_cast<int32_t>(LoadBigEndian<uint32_t>(data));
+      is_negative = value < 0;
+    } else if (type == 0xd3 && size == 8) {
+      value = static_cast<int64_t>(LoadBigEndian<uint64_t>(data));
+      is_negative = value < 0;
+    } else {
+      return false;
+    }
+    if (is_negative
+            ? !std::is_signed<T>::value ||
+                  value < static_cast<int64_t>(std::numeric_limits<T>::lowest())
+            : static_cast<uint64_t>(value) >
+                  static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+      return false;
+    }
+    *out = {true, static_cast<T>(value)};
+    return true;
+  }
+
+  template <typename U>
+  static U LoadBigEndian(const char *data) {
+    U value = 0;
+    for (size_t i = 0; i < sizeof(U); i++) {
+      value = static_cast<U>((value << 8) | static_cast<uint8_t>(data[i]));
+    }
+    return value;
+  }
+
+  /// Let the strings and binaries of an unpacked object point into the serialized
+  /// data instead of copying them into the unpacking zone, so that a large string or
+  /// byte array argument is copied once, when it is converted to the target type. The
+  /// serialized data outlives the unpacked object in all the functions above.
+  static bool ReferenceRawData(msgpack::type::object_type type, std::size_t, void *) {
+    return type == msgpack::type::STR || type == msgpack::type::BIN;
   }
 };
 
@@ -16,6 +16,9 @@
 
 #include <ray/api/static_check.h>
 #include <ray/api/task_options.h>
+
+#include <tuple>
+#include <utility>
 namespace ray {
 namespace internal {
 
@@ -29,6 +32,12 @@ class TaskCaller {
   template <typename... Args>
   ObjectRef<boost::callable_traits::return_type_t<F>> Remote(Args &&... args);
 
+  /// Submit one task per element of `args_list`, called with the elements of the
+  /// tuple. This is cheaper than calling `Remote` in a loop when submitting many tasks.
+  template <typename... Args>
+  std::vector<ObjectRef<boost::callable_traits::return_type_t<F>>> RemoteBatch(
+      std::vector<std::tuple<Args...>> args_list);
+
   TaskCaller &SetName(std::string name) {
     task_options_.name = std::move(name);
     return *this;
@@ -45,6 +54,12 @@ class TaskCaller {
   }
 
  private:
+  template <typename Tuple, size_t... I>
+  static void WrapTupleArgs(std::vector<TaskArg> *task_args, Tuple &tuple,
+                            std::index_sequence<I...>) {
+    Arguments::WrapArgs(task_args, std::get<I>(tuple)...);
+  }
+
   RayRuntime *runtime_;
   RemoteFunctionHolder remote_function_holder_{};
   std::string function_name_;
@@ -73,5 +88,26 @@ ObjectRef<boost::callable_traits::return_type_t<F>> TaskCaller<F>::Remote(
   auto returned_object_id = runtime_->Call(remote_function_holder_, args_, task_options_);
   return ObjectRef<ReturnType>(returned_object_id);
 }
+
+template <typename F>
+template <typename... Args>
+std::vector<ObjectRef<boost::callable_traits::return_type_t<F>>>
+TaskCaller<F>::RemoteBatch(std::vector<std::tuple<Args...>> args_list) {
+  StaticCheck<F, Args...>();
+  CheckTaskOptions(task_options_.resources);
+  using ReturnType = boost::callable_traits::return_type_t<F>;
+  std::vector<std::vector<TaskArg>> task_args_list(args_list.size());
+  for (size_t i = 0; i < args_list.size(); i++) {
+    WrapTupleArgs(&task_args_list[i], args_list[i], std::index_sequence_for<Args...>{});
+  }
+  auto returned_object_ids =
+      runtime_->CallBatch(remote_function_holder_, task_args_list, task_options_);
+  std::vector<ObjectRef<ReturnType>> object_refs;
+  object_refs.reserve(returned_object_ids.size());
+  for (auto &id : returned_object_ids) {
+    object_refs.push_back(ObjectRef<ReturnType>(id));
+  }
+  return object_refs;
+}
 }  // namespace internal
 }  // namespace ray
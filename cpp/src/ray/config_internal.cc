@@ -48,6 +48,13 @@ ABSL_FLAG(std::string, ray_logs_dir, "", "Logs dir for workers.");
 
 ABSL_FLAG(std::string, ray_node_ip_address, "", "The ip address for this node.");
 
+ABSL_FLAG(int64_t, ray_deserialized_value_cache_bytes, -1,
+          "The maximum total size of the objects whose deserialized values are cached. "
+          "0 disables the cache.");
+
+ABSL_FLAG(int32_t, ray_num_workers_per_process, 0,
+          "The number of workers hosted by this worker process.");
+
 /// flag serialized_runtime_env is added in setup_runtime_env.py.
 ABSL_FLAG(std::string, serialized_runtime_env, "{}",
           "The serialized parsed runtime env dict.");
@@ -75,6 +82,10 @@ void ConfigInternal::Init(RayConfig &config, int argc, char **argv) {
   if (!config.resources.empty()) {
     resources = config.resources;
   }
+  deserialized_value_cache_bytes = config.deserialized_value_cache_bytes;
+  if (config.num_workers_per_process > 0) {
+    num_workers_per_process = config.num_workers_per_process;
+  }
   if (argc != 0 && argv != nullptr) {
     // Parse config from command line.
     absl::ParseCommandLine(argc, argv);
@@ -111,6 +122,13 @@ void ConfigInternal::Init(RayConfig &config, int argc, char **argv) {
     if (!FLAGS_ray_node_ip_address.CurrentValue().empty()) {
       node_ip_address = FLAGS_ray_node_ip_address.CurrentValue();
     }
+    if (absl::GetFlag<int64_t>(FLAGS_ray_deserialized_value_cache_bytes) >= 0) {
+      deserialized_value_cache_bytes =
+          absl::GetFlag<int64_t>(FLAGS_ray_deserialized_value_cache_bytes);
+    }
+    if (absl::GetFlag<int32_t>(FLAGS_ray_num_workers_per_process) > 0) {
+      num_workers_per_process = absl::GetFlag<int32_t>(FLAGS_ray_num_workers_per_process);
+    }
   }
   if (worker_type == WorkerType::DRIVER && run_mode == RunMode::CLUSTER) {
     if (redis_ip.empty()) {
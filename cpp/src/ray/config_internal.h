@@ -59,6 +59,10 @@ class ConfigInternal {
 
   std::unordered_map<std::string, int> resources;
 
+  int64_t deserialized_value_cache_bytes = 0;
+
+  int num_workers_per_process = 1;
+
   static ConfigInternal &Instance() {
     static ConfigInternal config;
     return config;
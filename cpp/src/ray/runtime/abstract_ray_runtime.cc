@@ -61,6 +61,10 @@ std::shared_ptr<AbstractRayRuntime> AbstractRayRuntime::DoInit() {
     }
   }
   RAY_CHECK(runtime);
+  if (ConfigInternal::Instance().deserialized_value_cache_bytes > 0) {
+    runtime->value_cache_.reset(new DeserializedValueCache(
+        ConfigInternal::Instance().deserialized_value_cache_bytes));
+  }
   abstract_ray_runtime_ = runtime;
   return runtime;
 }
@@ -96,6 +100,11 @@ std::shared_ptr<msgpack::sbuffer> AbstractRayRuntime::Get(const std::string &obj
   return object_store_->Get(ObjectID::FromBinary(object_id), -1);
 }
 
+void AbstractRayRuntime::GetAsync(const std::string &object_id,
+                                  GetAsyncCallback callback) {
+  object_store_->GetAsync(ObjectID::FromBinary(object_id), std::move(callback));
+}
+
 inline static std::vector<ObjectID> StringIDsToObjectIDs(
     const std::vector<std::string> &ids) {
   std::vector<ObjectID> object_ids;
@@ -159,6 +168,24 @@ std::string AbstractRayRuntime::Call(const RemoteFunctionHolder &remote_function
   return task_submitter_->SubmitTask(invocation_spec, task_options).Binary();
 }
 
+std::vector<std::string> AbstractRayRuntime::CallBatch(
+    const RemoteFunctionHolder &remote_function_holder,
+    std::vector<std::vector<ray::internal::TaskArg>> &args_list,
+    const CallOptions &task_options) {
+  std::vector<InvocationSpec> invocation_specs;
+  invocation_specs.reserve(args_list.size());
+  for (auto &args : args_list) {
+    invocation_specs.push_back(BuildInvocationSpec1(
+        TaskType::NORMAL_TASK, remote_function_holder, args, ActorID::Nil()));
+  }
+  std::vector<std::string> object_ids;
+  object_ids.reserve(args_list.size());
+  for (auto &id : task_submitter_->SubmitTasks(invocation_specs, task_options)) {
+    object_ids.push_back(id.Binary());
+  }
+  return object_ids;
+}
+
 std::string AbstractRayRuntime::CreateActor(
     const RemoteFunctionHolder &remote_function_holder,
     std::vector<ray::internal::TaskArg> &args,
@@ -196,7 +223,26 @@ void AbstractRayRuntime::AddLocalReference(const std::string &id) {
 void AbstractRayRuntime::RemoveLocalReference(const std::string &id) {
   if (CoreWorkerProcess::IsInitialized()) {
     auto &core_worker = CoreWorkerProcess::GetCoreWorker();
-    core_worker.RemoveLocalReference(ObjectID::FromBinary(id));
+    auto object_id = ObjectID::FromBinary(id);
+    core_worker.RemoveLocalReference(object_id);
+    if (value_cache_ != nullptr && !core_worker.HasReference(object_id)) {
+      value_cache_->Erase(id);
+    }
+  }
+}
+
+std::shared_ptr<void> AbstractRayRuntime::GetCachedValue(const std::string &id,
+                                                         std::type_index type) {
+  if (value_cache_ == nullptr) {
+    return nullptr;
+  }
+  return value_cache_->Get(id, type);
+}
+
+void AbstractRayRuntime::CacheValue(const std::string &id, std::type_index type,
+                                    std::shared_ptr<void> value, size_t size) {
+  if (value_cache_ != nullptr) {
+    value_cache_->Put(id, type, std::move(value), size);
   }
 }
 
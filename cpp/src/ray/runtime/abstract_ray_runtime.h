@@ -20,6 +20,7 @@
 #include <mutex>
 
 #include "../config_internal.h"
+#include "./object/deserialized_value_cache.h"
 #include "./object/object_store.h"
 #include "./task/task_executor.h"
 #include "./task/task_submitter.h"
@@ -50,6 +51,8 @@ class AbstractRayRuntime : public RayRuntime {
 
   std::shared_ptr<msgpack::sbuffer> Get(const std::string &id);
 
+  void GetAsync(const std::string &id, GetAsyncCallback callback);
+
   std::vector<std::shared_ptr<msgpack::sbuffer>> Get(const std::vector<std::string> &ids);
 
   std::vector<bool> Wait(const std::vector<std::string> &ids, int num_objects,
@@ -59,6 +62,11 @@ class AbstractRayRuntime : public RayRuntime {
                    std::vector<ray::internal::TaskArg> &args,
                    const CallOptions &task_options);
 
+  std::vector<std::string> CallBatch(
+      const RemoteFunctionHolder &remote_function_holder,
+      std::vector<std::vector<ray::internal::TaskArg>> &args_list,
+      const CallOptions &task_options);
+
   std::string CreateActor(const RemoteFunctionHolder &remote_function_holder,
                           std::vector<ray::internal::TaskArg> &args,
                           const ActorCreationOptions &create_options);
@@ -72,6 +80,11 @@ class AbstractRayRuntime : public RayRuntime {
 
   void RemoveLocalReference(const std::string &id);
 
+  std::shared_ptr<void> GetCachedValue(const std::string &id, std::type_index type);
+
+  void CacheValue(const std::string &id, std::type_index type,
+                  std::shared_ptr<void> value, size_t size);
+
   std::string GetActorId(bool global, const std::string &actor_name);
 
   void KillActor(const std::string &str_actor_id, bool no_restart);
@@ -94,6 +107,8 @@ class AbstractRayRuntime : public RayRuntime {
   std::unique_ptr<TaskSubmitter> task_submitter_;
   std::unique_ptr<TaskExecutor> task_executor_;
   std::unique_ptr<ObjectStore> object_store_;
+  /// Null if the cache is disabled.
+  std::unique_ptr<DeserializedValueCache> value_cache_;
 
  private:
   static std::shared_ptr<AbstractRayRuntime> abstract_ray_runtime_;
@@ -37,5 +37,9 @@ ActorID LocalModeRayRuntime::GetNextActorID() {
   return actor_id;
 }
 
+LocalModeObjectStore &LocalModeRayRuntime::GetLocalModeObjectStore() {
+  return static_cast<LocalModeObjectStore &>(*object_store_);
+}
+
 }  // namespace internal
 }  // namespace ray
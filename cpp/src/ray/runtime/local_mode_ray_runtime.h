@@ -21,11 +21,15 @@
 namespace ray {
 namespace internal {
 
+class LocalModeObjectStore;
+
 class LocalModeRayRuntime : public AbstractRayRuntime {
  public:
   LocalModeRayRuntime();
 
   ActorID GetNextActorID();
+
+  LocalModeObjectStore &GetLocalModeObjectStore();
 };
 
 }  // namespace internal
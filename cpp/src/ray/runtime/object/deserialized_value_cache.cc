@@ -0,0 +1,90 @@
+// Copyright 2020-2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "deserialized_value_cache.h"
+
+namespace ray {
+namespace internal {
+
+DeserializedValueCache::DeserializedValueCache(size_t capacity_bytes)
+    : capacity_bytes_(capacity_bytes) {}
+
+std::shared_ptr<void> DeserializedValueCache::Get(const std::string &id,
+                                                  std::type_index type) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto object_it = entries_.find(id);
+  if (object_it == entries_.end()) {
+    return nullptr;
+  }
+  auto it = object_it->second.find(type);
+  if (it == object_it->second.end()) {
+    return nullptr;
+  }
+  lru_.splice(lru_.end(), lru_, it->second.lru_it);
+  return it->second.value;
+}
+
+void DeserializedValueCache::Put(const std::string &id, std::type_index type,
+                                 std::shared_ptr<void> value, size_t size) {
+  if (size > capacity_bytes_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto object_it = entries_.find(id);
+  if (object_it != entries_.end() && object_it->second.count(type) > 0) {
+    // Another thread deserialized the object at the same time.
+    return;
+  }
+  while (size_bytes_ + size > capacity_bytes_) {
+    EraseEntry(lru_.front());
+  }
+  auto lru_it = lru_.insert(lru_.end(), Key(id, type));
+  entries_[id].emplace(type, Entry{std::move(value), size, lru_it});
+  size_bytes_ += size;
+}
+
+void DeserializedValueCache::Erase(const std::string &id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto object_it = entries_.find(id);
+  if (object_it == entries_.end()) {
+    return;
+  }
+  for (const auto &entry : object_it->second) {
+    size_bytes_ -= entry.second.size;
+    lru_.erase(entry.second.lru_it);
+  }
+  entries_.erase(object_it);
+}
+
+size_t DeserializedValueCache::SizeBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return size_bytes_;
+}
+
+void DeserializedValueCache::EraseEntry(const Key &key) {
+  // Copy the key, it may be the one in the LRU list that is erased below.
+  const Key erased_key = key;
+  auto object_it = entries_.find(erased_key.first);
+  auto it = object_it->second.find(erased_key.second);
+  size_bytes_ -= it->second.size;
+  lru_.erase(it->second.lru_it);
+  object_it->second.erase(it);
+  if (object_it->second.empty()) {
+    entries_.erase(object_it);
+  }
+}
+
+}  // namespace internal
+}  // namespace ray
@@ -0,0 +1,82 @@
+// Copyright 2020-2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+
+namespace ray {
+namespace internal {
+
+/// Values deserialized from objects, so that getting the same object again does not
+/// deserialize it again. Values are keyed by object ID and by the type they were
+/// deserialized to, since an object may be read as different types. The least
+/// recently used values are evicted once the cached objects exceed the capacity.
+class DeserializedValueCache {
+ public:
+  /// \param[in] capacity_bytes The maximum total serialized size of the objects whose
+  /// values are cached.
+  explicit DeserializedValueCache(size_t capacity_bytes);
+
+  /// Look up the value of an object deserialized to a type.
+  ///
+  /// \return The value, or nullptr if it is not cached.
+  std::shared_ptr<void> Get(const std::string &id, std::type_index type);
+
+  /// Cache the value of an object deserialized to a type. Values of objects larger
+  /// than the capacity are not cached.
+  ///
+  /// \param[in] size The serialized size of the object.
+  void Put(const std::string &id, std::type_index type, std::shared_ptr<void> value,
+           size_t size);
+
+  /// Drop the values of an object, e.g. because it is no longer referenced.
+  void Erase(const std::string &id);
+
+  /// The total serialized size of the objects whose values are cached.
+  size_t SizeBytes() const;
+
+ private:
+  using Key = std::pair<std::string, std::type_index>;
+
+  struct Entry {
+    std::shared_ptr<void> value;
+    size_t size;
+    /// The position of the entry in the LRU list.
+    std::list<Key>::iterator lru_it;
+  };
+
+  /// The values of an object, by type.
+  using ObjectEntries = std::unordered_map<std::type_index, Entry>;
+
+  /// Drop the value of an object for one type.
+  void EraseEntry(const Key &key);
+
+  const size_t capacity_bytes_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, ObjectEntries> entries_;
+  /// Keys of the entries, the least recently used first.
+  std::list<Key> lru_;
+  size_t size_bytes_ = 0;
+};
+
+}  // namespace internal
+}  // namespace ray
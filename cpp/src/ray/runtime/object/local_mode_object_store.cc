@@ -17,6 +17,7 @@
 #include <ray/api/ray_exception.h>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <list>
 #include <thread>
@@ -25,6 +26,30 @@
 
 namespace ray {
 namespace internal {
+
+namespace {
+
+/// A buffer holding the serialized data of a put object, so that the object is stored
+/// without copying the data. The data is not modified once it is put.
+class SbufferBuffer : public ::ray::Buffer {
+ public:
+  explicit SbufferBuffer(std::shared_ptr<msgpack::sbuffer> data)
+      : data_(std::move(data)) {}
+
+  uint8_t *Data() const override { return reinterpret_cast<uint8_t *>(data_->data()); }
+
+  size_t Size() const override { return data_->size(); }
+
+  bool OwnsData() const override { return true; }
+
+  bool IsPlasmaBuffer() const override { return false; }
+
+ private:
+  std::shared_ptr<msgpack::sbuffer> data_;
+};
+
+}  // namespace
+
 LocalModeObjectStore::LocalModeObjectStore(LocalModeRayRuntime &local_mode_ray_tuntime)
     : local_mode_ray_tuntime_(local_mode_ray_tuntime) {
   memory_store_ = std::make_unique<CoreWorkerMemoryStore>();
@@ -37,8 +62,7 @@ void LocalModeObjectStore::PutRaw(std::shared_ptr<msgpack::sbuffer> data,
 
 void LocalModeObjectStore::PutRaw(std::shared_ptr<msgpack::sbuffer> data,
                                   const ObjectID &object_id) {
-  auto buffer = std::make_shared<::ray::LocalMemoryBuffer>(
-      reinterpret_cast<uint8_t *>(data->data()), data->size(), true);
+  auto buffer = std::make_shared<SbufferBuffer>(std::move(data));
   auto status = memory_store_->Put(
       ::ray::RayObject(buffer, nullptr, std::vector<rpc::ObjectReference>()), object_id);
   if (!status) {
@@ -102,6 +126,35 @@ std::vector<bool> LocalModeObjectStore::Wait(const std::vector<ObjectID> &ids,
   return result;
 }
 
+void LocalModeObjectStore::GetAsync(const ObjectID &object_id,
+                                    GetAsyncCallback callback) {
+  memory_store_->GetAsync(object_id, [callback](std::shared_ptr<RayObject> result) {
+    auto data_buffer = result->GetData();
+    auto sbuffer = std::make_shared<msgpack::sbuffer>(data_buffer->Size());
+    sbuffer->write(reinterpret_cast<const char *>(data_buffer->Data()),
+                   data_buffer->Size());
+    callback(std::move(sbuffer), nullptr);
+  });
+}
+
+void LocalModeObjectStore::WhenReady(const std::vector<ObjectID> &ids,
+                                     std::function<void()> callback) {
+  if (ids.empty()) {
+    callback();
+    return;
+  }
+  auto num_pending = std::make_shared<std::atomic<size_t>>(ids.size());
+  auto shared_callback = std::make_shared<std::function<void()>>(std::move(callback));
+  for (const auto &id : ids) {
+    memory_store_->GetAsync(
+        id, [num_pending, shared_callback](std::shared_ptr<RayObject> result) {
+          if (num_pending->fetch_sub(1) == 1) {
+            (*shared_callback)();
+          }
+        });
+  }
+}
+
 void LocalModeObjectStore::AddLocalReference(const std::string &id) { return; }
 
 void LocalModeObjectStore::RemoveLocalReference(const std::string &id) { return; }
@@ -36,6 +36,12 @@ class LocalModeObjectStore : public ObjectStore {
 
   void RemoveLocalReference(const std::string &id);
 
+  void GetAsync(const ObjectID &object_id, GetAsyncCallback callback);
+
+  /// Call `callback` once all the given objects are in the store. It runs right away if
+  /// they already are, and otherwise in the thread that puts the last of them.
+  void WhenReady(const std::vector<ObjectID> &ids, std::function<void()> callback);
+
  private:
   void PutRaw(std::shared_ptr<msgpack::sbuffer> data, ObjectID *object_id);
 
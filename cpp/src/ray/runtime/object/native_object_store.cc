@@ -18,10 +18,12 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <list>
 #include <thread>
 
 #include "../abstract_ray_runtime.h"
+#include "ray/common/ray_config.h"
 
 namespace ray {
 namespace internal {
@@ -31,6 +33,25 @@ using ray::core::CoreWorkerProcess;
 void NativeObjectStore::PutRaw(std::shared_ptr<msgpack::sbuffer> data,
                                ObjectID *object_id) {
   auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+  if (static_cast<int64_t>(data->size()) >=
+      ::ray::RayConfig::instance().max_direct_call_object_size()) {
+    // Large objects go to plasma anyway, so copy the serialized data straight into a
+    // plasma buffer instead of into an intermediate LocalMemoryBuffer.
+    std::shared_ptr<::ray::Buffer> buffer;
+    auto status = core_worker.CreateOwned(
+        std::make_shared<::ray::LocalMemoryBuffer>(nullptr, 0), data->size(), {},
+        object_id, &buffer, /*created_by_worker=*/true, /*owner_address=*/nullptr,
+        /*inline_small_object=*/false);
+    if (!status.ok()) {
+      throw RayException("Put object error: " + status.ToString());
+    }
+    std::memcpy(buffer->Data(), data->data(), data->size());
+    status = core_worker.SealOwned(*object_id, /*pin_object=*/true);
+    if (!status.ok()) {
+      throw RayException("Put object error: " + status.ToString());
+    }
+    return;
+  }
   auto buffer = std::make_shared<::ray::LocalMemoryBuffer>(
       reinterpret_cast<uint8_t *>(data->data()), data->size(), true);
   auto status = core_worker.Put(
@@ -93,21 +114,45 @@ std::vector<std::shared_ptr<msgpack::sbuffer>> NativeObjectStore::GetRaw(
   std::vector<std::shared_ptr<msgpack::sbuffer>> result_sbuffers;
   result_sbuffers.reserve(results.size());
   for (size_t i = 0; i < results.size(); i++) {
-    const auto &meta = results[i]->GetMetadata();
-    const auto &data_buffer = results[i]->GetData();
-    if (meta != nullptr) {
-      std::string meta_str((char *)meta->Data(), meta->Size());
-      CheckException(meta_str, data_buffer);
-    }
-
-    auto sbuffer = std::make_shared<msgpack::sbuffer>(data_buffer->Size());
-    sbuffer->write(reinterpret_cast<const char *>(data_buffer->Data()),
-                   data_buffer->Size());
-    result_sbuffers.push_back(sbuffer);
+    result_sbuffers.push_back(ToSbuffer(results[i]));
   }
   return result_sbuffers;
 }
 
+std::shared_ptr<msgpack::sbuffer> NativeObjectStore::ToSbuffer(
+    const std::shared_ptr<RayObject> &result) {
+  const auto &meta = result->GetMetadata();
+  const auto &data_buffer = result->GetData();
+  if (meta != nullptr) {
+    std::string meta_str((char *)meta->Data(), meta->Size());
+    CheckException(meta_str, data_buffer);
+  }
+
+  auto sbuffer = std::make_shared<msgpack::sbuffer>(data_buffer->Size());
+  sbuffer->write(reinterpret_cast<const char *>(data_buffer->Data()),
+                 data_buffer->Size());
+  return sbuffer;
+}
+
+void NativeObjectStore::GetAsync(const ObjectID &object_id, GetAsyncCallback callback) {
+  auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+  // The core worker looks up the in-memory store first, and subscribes to the raylet
+  // for objects in plasma, so no thread waits for the object.
+  core_worker.GetAsync(
+      object_id,
+      [this, callback](std::shared_ptr<RayObject> result, ObjectID, void *) {
+        std::shared_ptr<msgpack::sbuffer> sbuffer;
+        std::exception_ptr error;
+        try {
+          sbuffer = ToSbuffer(result);
+        } catch (...) {
+          error = std::current_exception();
+        }
+        callback(std::move(sbuffer), error);
+      },
+      nullptr);
+}
+
 std::vector<bool> NativeObjectStore::Wait(const std::vector<ObjectID> &ids,
                                           int num_objects, int timeout_ms) {
   std::vector<bool> results;
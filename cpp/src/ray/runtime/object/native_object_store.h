@@ -31,6 +31,8 @@ class NativeObjectStore : public ObjectStore {
 
   void RemoveLocalReference(const std::string &id);
 
+  void GetAsync(const ObjectID &object_id, GetAsyncCallback callback);
+
  private:
   void PutRaw(std::shared_ptr<msgpack::sbuffer> data, ObjectID *object_id);
 
@@ -42,6 +44,9 @@ class NativeObjectStore : public ObjectStore {
                                                         int timeout_ms);
   void CheckException(const std::string &meta_str,
                       const std::shared_ptr<Buffer> &data_buffer);
+
+  /// Copy a result of the core worker to a buffer, throwing its error if any.
+  std::shared_ptr<msgpack::sbuffer> ToSbuffer(const std::shared_ptr<RayObject> &result);
 };
 
 }  // namespace internal
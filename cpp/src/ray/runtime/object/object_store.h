@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <ray/api/ray_runtime.h>
 #include <ray/api/wait_result.h>
 
 #include <memory>
@@ -60,6 +61,13 @@ class ObjectStore {
   std::vector<std::shared_ptr<msgpack::sbuffer>> Get(
       const std::vector<ObjectID> &ids, int timeout_ms = default_get_timeout_ms);
 
+  /// Get a single object from the object store without blocking.
+  ///
+  /// \param[in] object_id The object id which should be got.
+  /// \param[in] callback The callback invoked with the result buffer, or with the
+  /// exception raised while getting the object, once the object is ready.
+  virtual void GetAsync(const ObjectID &object_id, GetAsyncCallback callback) = 0;
+
   /// Wait for a list of ObjectRefs to be locally available,
   /// until specified number of objects are ready, or specified timeout has passed.
   ///
@@ -16,10 +16,13 @@
 
 #include <ray/api/ray_exception.h>
 
+#include <algorithm>
 #include <boost/asio/post.hpp>
 #include <memory>
+#include <thread>
 
 #include "../abstract_ray_runtime.h"
+#include "../object/local_mode_object_store.h"
 
 namespace ray {
 namespace internal {
@@ -27,7 +30,8 @@ namespace internal {
 LocalModeTaskSubmitter::LocalModeTaskSubmitter(
     LocalModeRayRuntime &local_mode_ray_tuntime)
     : local_mode_ray_tuntime_(local_mode_ray_tuntime) {
-  thread_pool_.reset(new boost::asio::thread_pool(10));
+  thread_pool_.reset(new boost::asio::thread_pool(
+      std::max(10u, std::thread::hardware_concurrency())));
 }
 
 ObjectID LocalModeTaskSubmitter::Submit(InvocationSpec &invocation,
@@ -73,11 +77,9 @@ ObjectID LocalModeTaskSubmitter::Submit(InvocationSpec &invocation,
   ObjectID return_object_id = task_specification.ReturnId(0);
 
   std::shared_ptr<msgpack::sbuffer> actor;
-  std::shared_ptr<absl::Mutex> mutex;
   if (invocation.task_type == TaskType::ACTOR_TASK) {
     absl::MutexLock lock(&actor_contexts_mutex_);
     actor = actor_contexts_.at(invocation.actor_id).get()->current_actor;
-    mutex = actor_contexts_.at(invocation.actor_id).get()->actor_mutex;
   }
   AbstractRayRuntime *runtime = &local_mode_ray_tuntime_;
   if (invocation.task_type == TaskType::ACTOR_CREATION_TASK ||
@@ -88,17 +90,21 @@ ObjectID LocalModeTaskSubmitter::Submit(InvocationSpec &invocation,
     TaskExecutor::Invoke(task_specification, actor, runtime, actor_contexts_,
                          actor_contexts_mutex_);
   } else {
-    boost::asio::post(*thread_pool_.get(),
-                      std::bind(
-                          [actor, mutex, runtime, this](TaskSpecification &ts) {
-                            if (mutex) {
-                              absl::MutexLock lock(mutex.get());
-                            }
-                            TaskExecutor::Invoke(ts, actor, runtime,
-                                                 this->actor_contexts_,
-                                                 this->actor_contexts_mutex_);
-                          },
-                          std::move(task_specification)));
+    std::vector<ObjectID> dependencies;
+    for (size_t i = 0; i < task_specification.NumArgs(); i++) {
+      if (task_specification.ArgByRef(i)) {
+        dependencies.push_back(task_specification.ArgId(i));
+      }
+    }
+    // Only hand the task to the pool once its arguments are ready, so that no thread of
+    // the pool blocks on a dependency while runnable tasks wait behind it.
+    local_mode_ray_tuntime_.GetLocalModeObjectStore().WhenReady(
+        dependencies, [runtime, this, task_specification]() {
+          boost::asio::post(*thread_pool_, [runtime, this, task_specification]() {
+            TaskExecutor::Invoke(task_specification, nullptr, runtime, actor_contexts_,
+                                 actor_contexts_mutex_);
+          });
+        });
   }
   return return_object_id;
 }
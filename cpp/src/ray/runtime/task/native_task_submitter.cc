@@ -53,6 +53,32 @@ ObjectID NativeTaskSubmitter::SubmitTask(InvocationSpec &invocation,
   return Submit(invocation, call_options);
 }
 
+std::vector<ObjectID> NativeTaskSubmitter::SubmitTasks(
+    std::vector<InvocationSpec> &invocations, const CallOptions &call_options) {
+  std::vector<ObjectID> return_ids;
+  if (invocations.empty()) {
+    return return_ids;
+  }
+  auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+  TaskOptions options{};
+  options.name = call_options.name;
+  options.resources = call_options.resources;
+  std::vector<std::vector<std::unique_ptr<::ray::TaskArg>>> args_list;
+  args_list.reserve(invocations.size());
+  for (auto &invocation : invocations) {
+    args_list.push_back(std::move(invocation.args));
+  }
+  std::vector<std::vector<ObjectID>> task_return_ids;
+  core_worker.SubmitTasks(BuildRayFunction(invocations[0]), args_list, options,
+                          &task_return_ids, 1,
+                          std::make_pair(PlacementGroupID::Nil(), -1), true, "");
+  return_ids.reserve(task_return_ids.size());
+  for (auto &ids : task_return_ids) {
+    return_ids.push_back(ids[0]);
+  }
+  return return_ids;
+}
+
 ActorID NativeTaskSubmitter::CreateActor(InvocationSpec &invocation,
                                          const ActorCreationOptions &create_options) {
   auto &core_worker = CoreWorkerProcess::GetCoreWorker();
@@ -68,7 +68,7 @@ namespace internal {
 
 using ray::core::CoreWorkerProcess;
 
-std::shared_ptr<msgpack::sbuffer> TaskExecutor::current_actor_ = nullptr;
+thread_local std::shared_ptr<msgpack::sbuffer> TaskExecutor::current_actor_ = nullptr;
 
 TaskExecutor::TaskExecutor(AbstractRayRuntime &abstract_ray_tuntime_)
     : abstract_ray_tuntime_(abstract_ray_tuntime_) {}
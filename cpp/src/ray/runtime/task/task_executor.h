@@ -85,7 +85,9 @@ class TaskExecutor {
 
  private:
   AbstractRayRuntime &abstract_ray_tuntime_;
-  static std::shared_ptr<msgpack::sbuffer> current_actor_;
+  /// The actor hosted by the worker of the current thread, since a worker process can
+  /// host more than one worker.
+  static thread_local std::shared_ptr<msgpack::sbuffer> current_actor_;
 };
 }  // namespace internal
 }  // namespace ray
@@ -32,6 +32,18 @@ class TaskSubmitter {
   virtual ObjectID SubmitTask(InvocationSpec &invocation,
                               const CallOptions &call_options) = 0;
 
+  /// Submit a batch of normal tasks sharing the same options. Submitters that can do
+  /// better than submitting the tasks one by one override this.
+  virtual std::vector<ObjectID> SubmitTasks(std::vector<InvocationSpec> &invocations,
+                                            const CallOptions &call_options) {
+    std::vector<ObjectID> return_ids;
+    return_ids.reserve(invocations.size());
+    for (auto &invocation : invocations) {
+      return_ids.push_back(SubmitTask(invocation, call_options));
+    }
+    return return_ids;
+  }
+
   virtual ActorID CreateActor(InvocationSpec &invocation,
                               const ActorCreationOptions &create_options) = 0;
 
@@ -109,6 +109,26 @@ TEST(RayApiTest, PutTest) {
   EXPECT_EQ(1, *i1);
 }
 
+TEST(RayApiTest, DeserializedValueCacheTest) {
+  ray::Shutdown();
+  ray::RayConfig config;
+  config.local_mode = true;
+  config.deserialized_value_cache_bytes = 1024;
+  ray::Init(config);
+
+  auto obj = ray::Put(std::string("hello"));
+  auto value1 = obj.Get();
+  auto value2 = ray::Get(obj);
+  EXPECT_EQ("hello", *value1);
+  // The second get returns the value deserialized by the first one.
+  EXPECT_EQ(value1.get(), value2.get());
+
+  // Objects larger than the cache are deserialized on each get.
+  auto large_obj = ray::Put(std::string(2048, 'a'));
+  EXPECT_NE(large_obj.Get().get(), large_obj.Get().get());
+  ray::Shutdown();
+}
+
 TEST(RayApiTest, StaticGetTest) {
   ray::RayConfig config;
   config.local_mode = true;
@@ -142,6 +162,26 @@ TEST(RayApiTest, WaitTest) {
   EXPECT_EQ(*getResult[2], 5);
 }
 
+TEST(RayApiTest, GetAsyncTest) {
+  ray::RayConfig config;
+  config.local_mode = true;
+  ray::Init(config);
+  auto r0 = ray::Task(Return1).Remote();
+  auto r1 = ray::Task(Plus1).Remote(3);
+  auto r2 = ray::Task(Plus).Remote(2, 3);
+  EXPECT_EQ(*r1.GetAsync().get(), 4);
+
+  std::vector<ray::ObjectRef<int>> objects = {r0, r1, r2};
+  auto results = ray::WhenAll(objects).get();
+  EXPECT_EQ(results.size(), 3);
+  EXPECT_EQ(*results[0], 1);
+  EXPECT_EQ(*results[1], 4);
+  EXPECT_EQ(*results[2], 5);
+
+  size_t index = ray::WhenAny(objects).get();
+  EXPECT_LT(index, objects.size());
+}
+
 TEST(RayApiTest, CallWithValueTest) {
   auto r0 = ray::Task(Return1).Remote();
   auto r1 = ray::Task(Plus1).Remote(3);
@@ -179,6 +219,44 @@ TEST(RayApiTest, CallWithObjectTest) {
   EXPECT_EQ(return4, 9);
 }
 
+TEST(RayApiTest, TaskGraphTest) {
+  // A chain longer than the task pool, where each task depends on the previous one.
+  auto chain = ray::Task(Return1).Remote();
+  for (int i = 0; i < 100; i++) {
+    chain = ray::Task(Plus1).Remote(chain);
+  }
+  // Many tasks depending on the same object, joined pairwise into one result.
+  std::vector<ray::ObjectRef<int>> level;
+  for (int i = 0; i < 64; i++) {
+    level.push_back(ray::Task(Plus).Remote(chain, 0));
+  }
+  while (level.size() > 1) {
+    std::vector<ray::ObjectRef<int>> next;
+    for (size_t i = 0; i < level.size(); i += 2) {
+      next.push_back(ray::Task(Plus).Remote(level[i], level[i + 1]));
+    }
+    level = std::move(next);
+  }
+  EXPECT_EQ(*(chain.Get()), 101);
+  EXPECT_EQ(*(level[0].Get()), 101 * 64);
+}
+
+TEST(RayApiTest, CallBatchTest) {
+  auto r0 = ray::Task(Return1).Remote();
+  std::vector<std::tuple<ray::ObjectRef<int>, int>> args_list;
+  for (int i = 0; i < 10; i++) {
+    args_list.emplace_back(r0, i);
+  }
+  auto refs = ray::Task(Plus).RemoteBatch(args_list);
+  EXPECT_EQ(refs.size(), 10u);
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(*(refs[i].Get()), i + 1);
+  }
+
+  auto empty = ray::Task(Plus1).RemoteBatch(std::vector<std::tuple<int>>());
+  EXPECT_TRUE(empty.empty());
+}
+
 TEST(RayApiTest, ActorTest) {
   ray::RayConfig config;
   config.local_mode = true;
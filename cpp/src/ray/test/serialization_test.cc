@@ -15,6 +15,9 @@
 #include <gtest/gtest.h>
 #include <ray/api.h>
 
+#include <cstring>
+#include <limits>
+
 TEST(SerializationTest, TypeHybridTest) {
   uint32_t in_arg1 = 123456789, out_arg1;
   std::string in_arg2 = "123567ABC", out_arg2;
@@ -40,4 +43,61 @@ TEST(SerializationTest, TypeHybridTest) {
 
   EXPECT_EQ(in_arg1, out_arg1);
   EXPECT_EQ(in_arg2, out_arg2);
-}
\ No newline at end of file
+}
+TEST(SerializationTest, RawDataTest) {
+  std::string in_arg1(1 << 20, 'a');
+  std::vector<char> in_arg2(1 << 20, 'b');
+  msgpack::sbuffer buffer =
+      ray::internal::Serializer::Serialize(std::make_tuple(in_arg1, in_arg2));
+
+  // Strings and binaries are referenced from the buffer while unpacking, and copied
+  // into the results.
+  auto out = ray::internal::Serializer::Deserialize<
+      std::tuple<std::string, std::vector<char>>>(buffer.data(), buffer.size());
+  std::memset(buffer.data(), 0, buffer.size());
+  EXPECT_EQ(in_arg1, std::get<0>(out));
+  EXPECT_EQ(in_arg2, std::get<1>(out));
+}
+
+template <typename T>
+std::pair<bool, T> RoundTrip(const T &in) {
+  msgpack::sbuffer buffer = ray::internal::Serializer::Serialize(in);
+  return ray::internal::Serializer::DeserializeWhenNil<T>(buffer.data(), buffer.size());
+}
+
+TEST(SerializationTest, ArithmeticArgTest) {
+  std::vector<int64_t> values{0,      1,
+                              127,    128,
+                              -1,     -32,
+                              -33,    65535,
+                              -65536, std::numeric_limits<int64_t>::max(),
+                              std::numeric_limits<int64_t>::min()};
+  for (int64_t value : values) {
+    auto out = RoundTrip(value);
+    EXPECT_TRUE(out.first);
+    EXPECT_EQ(out.second, value);
+  }
+  EXPECT_EQ(RoundTrip(std::numeric_limits<uint64_t>::max()).second,
+            std::numeric_limits<uint64_t>::max());
+  EXPECT_EQ(RoundTrip<int8_t>(-100).second, -100);
+  EXPECT_EQ(RoundTrip(1.5f).second, 1.5f);
+  EXPECT_EQ(RoundTrip(-2.25).second, -2.25);
+  EXPECT_EQ(RoundTrip(true).second, true);
+  EXPECT_EQ(RoundTrip(false).second, false);
+
+  // Nil arguments are reported as such.
+  msgpack::sbuffer nil = ray::internal::Serializer::Serialize(msgpack::type::nil_t());
+  EXPECT_FALSE(
+      ray::internal::Serializer::DeserializeWhenNil<int>(nil.data(), nil.size()).first);
+
+  // Conversions the fast path does not handle are still done by msgpack.
+  msgpack::sbuffer integer = ray::internal::Serializer::Serialize(3);
+  EXPECT_EQ(ray::internal::Serializer::DeserializeWhenNil<double>(integer.data(),
+                                                                  integer.size())
+                .second,
+            3.0);
+  msgpack::sbuffer large = ray::internal::Serializer::Serialize(1000);
+  EXPECT_THROW(
+      ray::internal::Serializer::DeserializeWhenNil<uint8_t>(large.data(), large.size()),
+      msgpack::type_error);
+}
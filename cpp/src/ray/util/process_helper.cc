@@ -193,12 +193,17 @@ void ProcessHelper::RayStart(CoreWorkerOptions::TaskExecutionCallback callback)
   options.node_manager_port = ConfigInternal::Instance().node_manager_port;
   options.raylet_ip_address = node_ip;
   options.driver_name = "cpp_worker";
-  options.num_workers = 1;
+  // A driver process hosts only the driver.
+  options.num_workers = options.worker_type == WorkerType::DRIVER
+                            ? 1
+                            : ConfigInternal::Instance().num_workers_per_process;
   options.task_execution_callback = callback;
   rpc::JobConfig job_config;
   for (const auto &path : ConfigInternal::Instance().code_search_path) {
     job_config.add_code_search_path(path);
   }
+  job_config.set_num_cpp_workers_per_process(
+      ConfigInternal::Instance().num_workers_per_process);
   std::string serialized_job_config;
   RAY_CHECK(job_config.SerializeToString(&serialized_job_config));
   options.serialized_job_config = serialized_job_config;
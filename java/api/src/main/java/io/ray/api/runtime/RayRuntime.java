@@ -130,6 +130,16 @@ public interface RayRuntime {
    */
   ObjectRef call(RayFunc func, Object[] args, CallOptions options);
 
+  /**
+   * Invoke a remote function once per argument list, submitting all the tasks in one batch.
+   *
+   * @param func The remote function to run.
+   * @param argsList The arguments of each invocation.
+   * @param options The options shared by all the invocations.
+   * @return The result object of each invocation.
+   */
+  List<ObjectRef> callBatch(RayFunc func, List<Object[]> argsList, CallOptions options);
+
   /**
    * Invoke a remote Python function.
    *
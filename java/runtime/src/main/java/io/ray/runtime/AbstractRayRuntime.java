@@ -141,6 +141,31 @@ public abstract class AbstractRayRuntime implements RayRuntimeInternal {
     return callNormalFunction(functionDescriptor, args, returnType, options);
   }
 
+  @Override
+  public List<ObjectRef> callBatch(RayFunc func, List<Object[]> argsList, CallOptions options) {
+    RayFunction rayFunction = functionManager.getFunction(workerContext.getCurrentJobId(), func);
+    FunctionDescriptor functionDescriptor = rayFunction.functionDescriptor;
+    Optional<Class<?>> returnType = rayFunction.getReturnType();
+    int numReturns = returnType.isPresent() ? 1 : 0;
+    List<List<FunctionArg>> functionArgsList =
+        argsList.stream()
+            .map(args -> ArgumentsBuilder.wrap(args, functionDescriptor.getLanguage()))
+            .collect(Collectors.toList());
+    if (options == null) {
+      options = new CallOptions.Builder().build();
+    }
+    List<List<ObjectId>> returnIdsList =
+        taskSubmitter.submitTasks(functionDescriptor, functionArgsList, numReturns, options);
+    Preconditions.checkState(returnIdsList.size() == argsList.size());
+    List<ObjectRef> results = new ArrayList<>(returnIdsList.size());
+    for (List<ObjectId> returnIds : returnIdsList) {
+      Preconditions.checkState(returnIds.size() == numReturns);
+      results.add(
+          returnIds.isEmpty() ? null : new ObjectRefImpl(returnIds.get(0), returnType.get()));
+    }
+    return results;
+  }
+
   @Override
   public ObjectRef call(PyFunction pyFunction, Object[] args, CallOptions options) {
     PyFunctionDescriptor functionDescriptor =
@@ -37,6 +37,20 @@ public class NativeTaskSubmitter implements TaskSubmitter {
     return returnIds.stream().map(ObjectId::new).collect(Collectors.toList());
   }
 
+  @Override
+  public List<List<ObjectId>> submitTasks(
+      FunctionDescriptor functionDescriptor,
+      List<List<FunctionArg>> argsList,
+      int numReturns,
+      CallOptions options) {
+    List<List<byte[]>> returnIdsList =
+        nativeSubmitTasks(
+            functionDescriptor, functionDescriptor.hashCode(), argsList, numReturns, options);
+    return returnIdsList.stream()
+        .map(returnIds -> returnIds.stream().map(ObjectId::new).collect(Collectors.toList()))
+        .collect(Collectors.toList());
+  }
+
   @Override
   public BaseActorHandle createActor(
       FunctionDescriptor functionDescriptor, List<FunctionArg> args, ActorCreationOptions options)
@@ -126,6 +140,13 @@ public class NativeTaskSubmitter implements TaskSubmitter {
       int numReturns,
       CallOptions callOptions);
 
+  private static native List<List<byte[]>> nativeSubmitTasks(
+      FunctionDescriptor functionDescriptor,
+      int functionDescriptorHash,
+      List<List<FunctionArg>> argsList,
+      int numReturns,
+      CallOptions callOptions);
+
   private static native byte[] nativeCreateActor(
       FunctionDescriptor functionDescriptor,
       int functionDescriptorHash,
@@ -9,6 +9,7 @@ import io.ray.api.options.CallOptions;
 import io.ray.api.options.PlacementGroupCreationOptions;
 import io.ray.api.placementgroup.PlacementGroup;
 import io.ray.runtime.functionmanager.FunctionDescriptor;
+import java.util.ArrayList;
 import java.util.List;
 
 /** A set of methods to submit tasks and create actors. */
@@ -29,6 +30,27 @@ public interface TaskSubmitter {
       int numReturns,
       CallOptions options);
 
+  /**
+   * Submit a batch of normal tasks of the same function, one task per argument list.
+   *
+   * @param functionDescriptor The remote function to execute.
+   * @param argsList Arguments of each task.
+   * @param numReturns Return object count of each task.
+   * @param options Options shared by all the tasks.
+   * @return Ids of the return objects of each task.
+   */
+  default List<List<ObjectId>> submitTasks(
+      FunctionDescriptor functionDescriptor,
+      List<List<FunctionArg>> argsList,
+      int numReturns,
+      CallOptions options) {
+    List<List<ObjectId>> returnIdsList = new ArrayList<>(argsList.size());
+    for (List<FunctionArg> args : argsList) {
+      returnIdsList.add(submitTask(functionDescriptor, args, numReturns, options));
+    }
+    return returnIdsList;
+  }
+
   /**
    * Create an actor.
    *
@@ -2,11 +2,14 @@ package io.ray.test;
 
 import com.google.common.collect.ImmutableList;
 import com.google.common.collect.ImmutableMap;
+import io.ray.api.ObjectRef;
 import io.ray.api.Ray;
+import io.ray.api.function.RayFunc2;
 import io.ray.api.id.ObjectId;
 import io.ray.runtime.task.ArgumentsBuilder;
 import java.nio.ByteBuffer;
 import java.nio.charset.StandardCharsets;
+import java.util.ArrayList;
 import java.util.Arrays;
 import java.util.List;
 import java.util.Map;
@@ -160,6 +163,20 @@ public class RayCallTest extends BaseTest {
         6, (int) Ray.task(RayCallTest::testSixParams, 1, 1, 1, 1, 1, 1).remote().get());
   }
 
+  @Test
+  public void testCallBatch() {
+    List<Object[]> argsList = new ArrayList<>();
+    for (int i = 0; i < 10; i++) {
+      argsList.add(new Object[] {i, 1});
+    }
+    RayFunc2<Integer, Integer, Integer> func = RayCallTest::testTwoParams;
+    List<ObjectRef> results = TestUtils.getRuntime().callBatch(func, argsList, null);
+    Assert.assertEquals(results.size(), 10);
+    for (int i = 0; i < 10; i++) {
+      Assert.assertEquals(results.get(i).get(), i + 1);
+    }
+  }
+
   private static Boolean testLargeRawData(byte[] data) {
     return Arrays.equals(data, getLargeRawData());
   }
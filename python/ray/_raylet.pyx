@@ -326,14 +326,17 @@ cdef prepare_args(
         int64_t put_threshold
         int64_t rpc_inline_threshold
         int64_t total_inlined
+        c_bool dedup_args
         shared_ptr[CBuffer] arg_data
         c_vector[CObjectID] inlined_ids
         c_vector[CObjectReference] inlined_refs
+        c_vector[CObjectReference] no_refs
 
     worker = ray.worker.global_worker
     put_threshold = RayConfig.instance().max_direct_call_object_size()
     total_inlined = 0
     rpc_inline_threshold = RayConfig.instance().task_rpc_inlined_bytes_limit()
+    dedup_args = RayConfig.instance().task_arg_dedup_window_ms() > 0
     for arg in args:
         if isinstance(arg, ObjectRef):
             c_arg = (<ObjectRef>arg).native()
@@ -378,6 +381,19 @@ cdef prepare_args(
                             inlined_refs))))
                 inlined_ids.clear()
                 total_inlined += <int64_t>size
+            elif (dedup_args and <int64_t>size > put_threshold and
+                    not serialized_arg.contained_object_refs):
+                # Hand the value to the core worker, which puts it into plasma
+                # once for all the tasks that pass the same content.
+                arg_data = dynamic_pointer_cast[CBuffer, LocalMemoryBuffer](
+                        make_shared[LocalMemoryBuffer](size))
+                (<SerializedObject>serialized_arg).write_to(
+                    Buffer.make(arg_data))
+                args_vector.push_back(
+                    unique_ptr[CTaskArg](new CTaskArgByValue(
+                        make_shared[CRayObject](
+                            arg_data, string_to_buffer(metadata),
+                            no_refs))))
             else:
                 args_vector.push_back(unique_ptr[CTaskArg](
                     new CTaskArgByReference(CObjectID.FromBinary(
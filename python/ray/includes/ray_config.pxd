@@ -57,6 +57,8 @@ cdef extern from "ray/common/ray_config.h" nogil:
 
         int64_t task_rpc_inlined_bytes_limit() const
 
+        int64_t task_arg_dedup_window_ms() const
+
         uint32_t max_tasks_in_flight_per_worker() const
 
         uint64_t metrics_report_interval_ms() const
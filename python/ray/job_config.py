@@ -21,6 +21,9 @@ class JobConfig:
         runtime_env (dict): A runtime environment dictionary (see
             ``runtime_env.py`` for detailed documentation).
         client_job (bool): A boolean represent the source of the job.
+        scheduling_weight (float): The share of the cluster that the job
+            gets relative to other jobs, when the raylets dispatch tasks by
+            fair share across jobs.
     """
 
     def __init__(self,
@@ -31,7 +34,8 @@ class JobConfig:
                  runtime_env=None,
                  client_job=False,
                  metadata=None,
-                 ray_namespace=None):
+                 ray_namespace=None,
+                 scheduling_weight=1.0):
         if worker_env is None:
             self.worker_env = dict()
         else:
@@ -47,6 +51,9 @@ class JobConfig:
         self.client_job = client_job
         self.metadata = metadata or {}
         self.ray_namespace = ray_namespace
+        assert scheduling_weight > 0, \
+            f"The scheduling weight must be positive: {scheduling_weight}"
+        self.scheduling_weight = scheduling_weight
         self.set_runtime_env(runtime_env)
 
     def set_metadata(self, key: str, value: str) -> None:
@@ -95,6 +102,7 @@ class JobConfig:
                 self.get_serialized_runtime_env()
             for k, v in self.metadata.items():
                 self._cached_pb.metadata[k] = v
+            self._cached_pb.scheduling_weight = self.scheduling_weight
         return self._cached_pb
 
     def get_runtime_env_uris(self):
@@ -264,6 +264,12 @@ MAX_INT64_VALUE = 9223372036854775807
 # Object Spilling related constants
 DEFAULT_OBJECT_PREFIX = "ray_spilled_objects"
 
+# Whether to serialize torch tensors as numpy arrays, whose data is written to
+# the object store out of band instead of being pickled, and to move them back
+# to their device straight from the object store when they are deserialized.
+SERIALIZE_TORCH_TENSORS_OUT_OF_BAND = env_bool(
+    "RAY_SERIALIZE_TORCH_TENSORS_OUT_OF_BAND", False)
+
 GCS_PORT_ENVIRONMENT_VARIABLE = "RAY_GCS_SERVER_PORT"
 
 HEALTHCHECK_EXPIRATION_S = os.environ.get("RAY_HEALTHCHECK_EXPIRATION_S", 10)
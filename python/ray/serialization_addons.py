@@ -3,6 +3,11 @@ This module is intended for implementing internal serializers for some
 site packages.
 """
 
+import sys
+import warnings
+
+from ray import ray_constants
+
 
 def register_pydantic_serializer(serialization_context):
     try:
@@ -47,6 +52,45 @@ def register_starlette_serializer(serialization_context):
     )
 
 
+def _torch_tensor_deserializer(array, device):
+    import torch
+    with warnings.catch_warnings():
+        # The array is backed by the read-only object store buffer. It is only
+        # read here, by the copy to the device or into a new CPU tensor.
+        warnings.simplefilter("ignore", UserWarning)
+        tensor = torch.from_numpy(array)
+        if device == "cpu":
+            return tensor.clone()
+        return tensor.to(device)
+
+
+def register_torch_serializer(serialization_context):
+    if not ray_constants.SERIALIZE_TORCH_TENSORS_OUT_OF_BAND:
+        return
+    # Importing torch is slow, so only handle tensors if the program already
+    # imported it. The deserializer imports it when it receives a tensor.
+    torch = sys.modules.get("torch")
+    if torch is None:
+        return
+
+    # Torch pickles the storage of a tensor into the pickle stream, which is
+    # copied into the object store, and copied again by torch when it is loaded.
+    # As a numpy array, the data goes to the object store as a pickle5 buffer,
+    # and a GPU tensor is copied to its device straight from the object store.
+    def torch_tensor_reducer(tensor):
+        if (type(tensor) is not torch.Tensor or tensor.requires_grad
+                or tensor.layout != torch.strided or tensor.is_quantized
+                or tensor.dtype in (torch.bfloat16, torch.complex32)):
+            # Numpy doesn't support these, fall back to torch's pickling.
+            return tensor.__reduce_ex__(5)
+        array = tensor.detach().cpu().contiguous().numpy()
+        return _torch_tensor_deserializer, (array, str(tensor.device))
+
+    serialization_context._register_cloudpickle_reducer(
+        torch.Tensor, torch_tensor_reducer)
+
+
 def apply(serialization_context):
     register_pydantic_serializer(serialization_context)
     register_starlette_serializer(serialization_context)
+    register_torch_serializer(serialization_context)
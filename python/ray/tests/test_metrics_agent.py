@@ -43,6 +43,13 @@ _METRICS = [
     "ray_object_store_used_memory",
     "ray_object_store_num_local_objects",
     "ray_object_manager_num_pull_requests",
+    # "ray_object_manager_chunk_round_trip_ms_sum",
+    # "ray_object_manager_chunk_bandwidth_mb_sum",
+    # "ray_object_manager_push_queueing_ms_sum",
+    # "ray_object_manager_spilled_chunk_read_ms_sum",
+    # "ray_object_manager_receive_buffer_create_ms_sum",
+    # "ray_object_manager_chunk_write_ms_sum",
+    # "ray_object_manager_pull_retries_sum",
     "ray_object_directory_subscriptions",
     "ray_object_directory_updates",
     "ray_object_directory_lookups",
@@ -57,15 +64,19 @@ _METRICS = [
     "ray_internal_num_infeasible_tasks",
     # "ray_object_spilling_bandwidth_mb",
     # "ray_object_restoration_bandwidth_mb",
+    # "ray_core_worker_memory_store_used_memory",
+    # "ray_core_worker_task_lineage_bytes",
+    # "ray_core_worker_task_lineage_evicted",
     # "ray_unintentional_worker_failures_total",
     # "ray_node_failure_total",
     "ray_pending_actors",
     "ray_pending_placement_groups",
     "ray_outbound_heartbeat_size_kb_sum",
     "ray_operation_count",
-    "ray_operation_run_time_ms",
-    "ray_operation_queue_time_ms",
+    "ray_operation_run_time_ms_sum",
+    "ray_operation_queue_time_ms_sum",
     "ray_operation_active_count",
+    "ray_io_context_queue_depth",
 ]
 
 # This list of metrics should be kept in sync with
@@ -650,6 +650,28 @@ def test_recursive_resolve(ray_start_shared_local_modes):
     assert ray.get(ref) == 42
 
 
+def test_torch_tensor_out_of_band(monkeypatch, shutdown_only):
+    torch = pytest.importorskip("torch")
+    monkeypatch.setenv("RAY_SERIALIZE_TORCH_TENSORS_OUT_OF_BAND", "true")
+    monkeypatch.setattr(ray.ray_constants,
+                        "SERIALIZE_TORCH_TENSORS_OUT_OF_BAND", True)
+    ray.init(num_cpus=1)
+
+    @ray.remote
+    def double(tensor):
+        tensor *= 2
+        return tensor
+
+    tensor = torch.arange(1000, dtype=torch.float32).reshape(10, 100)
+    result = ray.get(double.remote(tensor))
+    assert result.dtype == tensor.dtype
+    assert torch.equal(result, tensor * 2)
+    # Tensors that numpy can't hold fall back to torch's pickling.
+    grad = torch.ones(4, requires_grad=True)
+    assert ray.get(ray.put(grad)).requires_grad
+    assert ray.get(ray.put(tensor[:, ::2])).shape == (10, 50)
+
+
 if __name__ == "__main__":
     import pytest
     sys.exit(pytest.main(["-v", __file__]))
@@ -129,6 +129,48 @@ parser.add_argument(
     default=False,
     action="store_true",
     help="True if Ray debugger is made available externally.")
+parser.add_argument(
+    "--zygote-socket",
+    required=False,
+    type=str,
+    default=None,
+    help="If set, run as a zygote that forks a new worker for every "
+    "connection to this Unix socket.")
+
+
+def run_zygote(socket_path):
+    """Fork a new worker for every connection to socket_path.
+
+    The zygote replies to each connection with the pid of the forked worker.
+    This function only returns in the forked workers, which then start up like
+    a regular worker. The zygote exits once the raylet that started it is gone.
+    """
+    import signal
+    import socket
+
+    raylet_pid = os.getppid()
+    # The forked workers are tracked by the raylet, so let the kernel reap
+    # them instead of leaving zombies behind.
+    signal.signal(signal.SIGCHLD, signal.SIG_IGN)
+    server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    server.bind(socket_path)
+    server.listen(128)
+    server.settimeout(1)
+    while True:
+        try:
+            conn, _ = server.accept()
+        except socket.timeout:
+            if os.getppid() != raylet_pid:
+                sys.exit(0)
+            continue
+        with conn:
+            conn.recv(64)
+            pid = os.fork()
+            if pid == 0:
+                server.close()
+                signal.signal(signal.SIGCHLD, signal.SIG_DFL)
+                return
+            conn.sendall(f"{pid}\n".encode())
 
 if __name__ == "__main__":
     # NOTE(sang): For some reason, if we move the code below
@@ -139,6 +181,10 @@ if __name__ == "__main__":
     ray._private.ray_logging.setup_logger(args.logging_level,
                                           args.logging_format)
 
+    if args.zygote_socket:
+        # Everything imported so far is shared with the forked workers.
+        run_zygote(args.zygote_socket)
+
     if args.worker_type == "WORKER":
         mode = ray.WORKER_MODE
     elif args.worker_type == "SPILL_WORKER":
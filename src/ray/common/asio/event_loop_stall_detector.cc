@@ -0,0 +1,223 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/asio/event_loop_stall_detector.h"
+
+#include <signal.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "absl/debugging/stacktrace.h"
+#include "absl/debugging/symbolize.h"
+#include "absl/time/clock.h"
+#include "ray/common/ray_config.h"
+#include "ray/util/event.h"
+#include "ray/util/event_label.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace {
+
+#ifdef __linux__
+
+constexpr int kMaxStackFrames = 64;
+
+/// The frames written by the stuck thread in its signal handler.
+struct StackCapture {
+  void *frames[kMaxStackFrames];
+  std::atomic<int> depth{-1};
+};
+
+/// The capture in progress, or nullptr. Only the watchdog thread captures stacks, so
+/// there is at most one.
+std::atomic<StackCapture *> stack_capture{nullptr};
+
+/// The signal sent to a stuck thread to make it record its own stack.
+int StackCaptureSignal() { return SIGRTMIN + 5; }
+
+void StackCaptureHandler(int) {
+  StackCapture *capture = stack_capture.load();
+  if (capture != nullptr) {
+    capture->depth.store(
+        absl::GetStackTrace(capture->frames, kMaxStackFrames, /*skip_count=*/1));
+  }
+}
+
+/// Capture the symbolized stack of another thread of this process.
+///
+/// \return The stack, or an empty string if the thread did not answer in time.
+std::string CaptureStack(pthread_t thread) {
+  static std::once_flag install_flag;
+  std::call_once(install_flag, [] {
+    struct sigaction action = {};
+    action.sa_handler = StackCaptureHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    RAY_CHECK(sigaction(StackCaptureSignal(), &action, nullptr) == 0);
+  });
+
+  // The capture is static, so that a handler that runs after we stop waiting does not
+  // write to freed memory.
+  static StackCapture capture;
+  capture.depth.store(-1);
+  stack_capture.store(&capture);
+  if (pthread_kill(thread, StackCaptureSignal()) != 0) {
+    stack_capture.store(nullptr);
+    return "";
+  }
+  const auto deadline = absl::Now() + absl::Milliseconds(100);
+  while (capture.depth.load() < 0 && absl::Now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  stack_capture.store(nullptr);
+
+  const int depth = capture.depth.load();
+  static constexpr size_t buf_size = 16 * 1024;
+  static char buf[buf_size];
+  std::string output;
+  for (int i = 0; i < depth; i++) {
+    if (absl::Symbolize(capture.frames[i], buf, buf_size)) {
+      output.append("    ").append(buf).append("\n");
+    } else {
+      output.append("    (unknown)\n");
+    }
+  }
+  return output;
+}
+
+#endif
+
+}  // namespace
+
+void RunningHandler::Start(std::shared_ptr<const std::string> name,
+                           int64_t start_time_ns) {
+  absl::MutexLock lock(&mutex);
+  handler_name = std::move(name);
+  this->start_time_ns = start_time_ns;
+  sequence++;
+#ifdef __linux__
+  thread = pthread_self();
+#endif
+}
+
+void RunningHandler::Finish() {
+  absl::MutexLock lock(&mutex);
+  handler_name = nullptr;
+}
+
+EventLoopStallDetector &EventLoopStallDetector::Instance() {
+  // Leaked, because the watchdog thread is never joined.
+  static auto *instance = new EventLoopStallDetector();
+  return *instance;
+}
+
+void EventLoopStallDetector::Register(
+    const std::string &io_context_name,
+    const std::shared_ptr<RunningHandler> &running_handler) {
+  absl::MutexLock lock(&mutex_);
+  entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                [](const Entry &entry) {
+                                  return entry.running_handler.expired();
+                                }),
+                 entries_.end());
+  entries_.push_back({io_context_name, running_handler});
+}
+
+void EventLoopStallDetector::StartOnce() {
+  std::call_once(start_flag_, [this] { std::thread([this] { Run(); }).detach(); });
+}
+
+void EventLoopStallDetector::Run() {
+  while (true) {
+    const int64_t threshold_ms = RayConfig::instance().event_loop_stall_threshold_ms();
+    if (threshold_ms > 0) {
+      CheckStalls(threshold_ms);
+    }
+    // Check twice per threshold, so a stall is reported at most half a threshold late.
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(std::max<int64_t>(threshold_ms / 2, 10)));
+  }
+}
+
+void EventLoopStallDetector::CheckStalls(int64_t threshold_ms) {
+  std::vector<Entry> entries;
+  {
+    absl::MutexLock lock(&mutex_);
+    entries = entries_;
+  }
+  const int64_t now_ns = absl::GetCurrentTimeNanos();
+  for (const auto &entry : entries) {
+    auto running_handler = entry.running_handler.lock();
+    if (!running_handler) {
+      continue;
+    }
+    std::string handler_name;
+    int64_t running_ms = 0;
+#ifdef __linux__
+    uint64_t sequence = 0;
+    pthread_t thread;
+#endif
+    {
+      absl::MutexLock lock(&running_handler->mutex);
+      if (running_handler->handler_name == nullptr ||
+          running_handler->reported_sequence == running_handler->sequence) {
+        continue;
+      }
+      running_ms = (now_ns - running_handler->start_time_ns) / 1000000;
+      if (running_ms < threshold_ms) {
+        continue;
+      }
+      running_handler->reported_sequence = running_handler->sequence;
+      handler_name = *running_handler->handler_name;
+#ifdef __linux__
+      sequence = running_handler->sequence;
+      thread = running_handler->thread;
+#endif
+    }
+
+    std::string stack;
+#ifdef __linux__
+    stack = CaptureStack(thread);
+    {
+      // Drop the stack if the handler finished before the thread answered.
+      absl::MutexLock lock(&running_handler->mutex);
+      if (running_handler->handler_name == nullptr ||
+          running_handler->sequence != sequence) {
+        stack.clear();
+      }
+    }
+#endif
+    if (stack.empty()) {
+      stack = "    (unavailable)\n";
+    }
+
+    RAY_LOG(WARNING) << "Handler " << handler_name << " has been running on "
+                     << entry.io_context_name << " for " << running_ms
+                     << " ms. Stack of the event loop thread:\n"
+                     << stack;
+    RAY_EVENT(WARNING, EL_RAY_EVENT_LOOP_STALLED)
+            .WithField("io_context", entry.io_context_name)
+            .WithField("handler", handler_name)
+            .WithField("running_ms", running_ms)
+        << "Handler " << handler_name << " has been running on "
+        << entry.io_context_name << " for " << running_ms << " ms.\n"
+        << stack;
+  }
+}
+
+}  // namespace ray
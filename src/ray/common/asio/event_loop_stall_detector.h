@@ -0,0 +1,94 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+#include "absl/synchronization/mutex.h"
+
+namespace ray {
+
+/// The handler that is running on an event loop, as seen by the stall detector.
+struct RunningHandler {
+  /// Mark a handler as running on the calling thread.
+  void Start(std::shared_ptr<const std::string> name, int64_t start_time_ns);
+
+  /// Mark the running handler as done.
+  void Finish();
+
+  absl::Mutex mutex;
+  /// The name of the running handler, or nullptr if no handler is running.
+  std::shared_ptr<const std::string> handler_name GUARDED_BY(mutex);
+  int64_t start_time_ns GUARDED_BY(mutex) = 0;
+  /// Incremented each time a handler starts, so a stall is reported only once.
+  uint64_t sequence GUARDED_BY(mutex) = 0;
+  uint64_t reported_sequence GUARDED_BY(mutex) = 0;
+#ifdef __linux__
+  /// The thread that runs the handler.
+  pthread_t thread GUARDED_BY(mutex);
+#endif
+};
+
+/// \class EventLoopStallDetector
+///
+/// A watchdog that reports handlers that have been running on an event loop for longer
+/// than `event_loop_stall_threshold_ms`. Unlike `handler_warning_timeout_ms`, a stall is
+/// reported while the handler is still running, with the stack of the stuck thread, so
+/// it also catches handlers that never return.
+///
+/// One watchdog thread serves all the event loops of the process. It is started by the
+/// first handler that runs with the threshold set.
+class EventLoopStallDetector {
+ public:
+  static EventLoopStallDetector &Instance();
+
+  /// Watch the handlers of an event loop. The event loop is forgotten once
+  /// `running_handler` is destroyed.
+  ///
+  /// \param io_context_name The name of the event loop, used in the reports.
+  /// \param running_handler The handler that is running on the event loop.
+  void Register(const std::string &io_context_name,
+                const std::shared_ptr<RunningHandler> &running_handler);
+
+  /// Start the watchdog thread if it is not started yet.
+  void StartOnce();
+
+ private:
+  EventLoopStallDetector() = default;
+
+  /// Periodically check all the event loops, run by the watchdog thread.
+  void Run();
+
+  /// Report the stalled handlers of all the event loops.
+  void CheckStalls(int64_t threshold_ms);
+
+  struct Entry {
+    std::string io_context_name;
+    std::weak_ptr<RunningHandler> running_handler;
+  };
+
+  absl::Mutex mutex_;
+  std::vector<Entry> entries_ GUARDED_BY(mutex_);
+  std::once_flag start_flag_;
+};
+
+}  // namespace ray
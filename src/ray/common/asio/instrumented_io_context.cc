@@ -20,29 +20,63 @@
 #include <utility>
 #include "ray/stats/metric.h"
 
-DEFINE_stats(operation_count, "operation count", ("Method"), (), ray::stats::GAUGE);
-DEFINE_stats(operation_run_time_ms, "operation execution time", ("Method"), (),
-             ray::stats::GAUGE);
-DEFINE_stats(operation_queue_time_ms, "operation queuing time", ("Method"), (),
-             ray::stats::GAUGE);
-DEFINE_stats(operation_active_count, "activate operation number", ("Method"), (),
-             ray::stats::GAUGE);
 namespace {
 
-/// A helper for creating a snapshot view of the global stats.
-/// This acquires a reader lock on the provided global stats, and creates a
-/// lockless copy of the stats.
-GlobalStats to_global_stats_view(std::shared_ptr<GuardedGlobalStats> stats) {
-  absl::MutexLock lock(&(stats->mutex));
-  return GlobalStats(stats->stats);
+// The metrics are created on first use, because io_contexts can be static too. They
+// are never destroyed, because bound handles must not outlive them.
+
+const std::vector<double> &OperationTimeBucketsMs() {
+  static const auto *buckets =
+      new std::vector<double>{0.1, 0.5, 1, 5, 10, 50, 100, 500, 1000, 5000};
+  return *buckets;
+}
+
+/// The number of handlers of each name that were posted.
+ray::stats::FastSum &OperationCount() {
+  static auto *metric =
+      new ray::stats::FastSum("operation_count", "operation count", "", {"Method"});
+  return *metric;
+}
+
+/// The number of handlers of each name that are queued or running. Each handler adds
+/// 1 when it is posted and -1 when it is done, so the sum is the current number.
+ray::stats::FastSum &OperationActiveCount() {
+  static auto *metric = new ray::stats::FastSum(
+      "operation_active_count", "activate operation number", "", {"Method"});
+  return *metric;
+}
+
+ray::stats::FastHistogram &OperationQueueTimeMs() {
+  static auto *metric = new ray::stats::FastHistogram(
+      "operation_queue_time_ms", "operation queuing time", "ms",
+      OperationTimeBucketsMs(), {"Method"});
+  return *metric;
+}
+
+ray::stats::FastHistogram &OperationRunTimeMs() {
+  static auto *metric = new ray::stats::FastHistogram(
+      "operation_run_time_ms", "operation execution time", "ms",
+      OperationTimeBucketsMs(), {"Method"});
+  return *metric;
+}
+
+/// The number of handlers that are queued or running in each io_context.
+ray::stats::FastSum &IoContextQueueDepth() {
+  static auto *metric =
+      new ray::stats::FastSum("io_context_queue_depth",
+                              "number of queued or running handlers", "", {"IoContext"});
+  return *metric;
 }
 
-/// A helper for creating a snapshot view of the stats for a handler.
-/// This acquires a lock on the provided guarded handler stats, and creates a
-/// lockless copy of the stats.
-HandlerStats to_handler_stats_view(std::shared_ptr<GuardedHandlerStats> stats) {
-  absl::MutexLock lock(&(stats->mutex));
-  return HandlerStats(stats->stats);
+/// The handler stats that the calling thread has looked up, by io_context id and
+/// handler name. The entries of destroyed io_contexts are kept, since there are few
+/// io_contexts per process.
+using HandlerStatsCache = absl::flat_hash_map<
+    uint64_t, absl::flat_hash_map<std::string, std::shared_ptr<GuardedHandlerStats>>>;
+
+HandlerStatsCache &ThreadHandlerStatsCache() {
+  static thread_local HandlerStatsCache cache;
+  return cache;
 }
 
 /// A helper for converting a duration into a human readable string, such as "5.346 ms".
@@ -63,6 +97,59 @@ std::string to_human_readable(int64_t duration) {
 
 }  // namespace
 
+GuardedHandlerStats::GuardedHandlerStats(const std::string &handler_name)
+    : name(std::make_shared<const std::string>(handler_name)),
+      count_metric(OperationCount().Bind({{"Method", handler_name}})),
+      active_count_metric(OperationActiveCount().Bind({{"Method", handler_name}})),
+      queue_time_metric(OperationQueueTimeMs().Bind({{"Method", handler_name}})),
+      execution_time_metric(OperationRunTimeMs().Bind({{"Method", handler_name}})) {}
+
+HandlerStatsShard &GuardedHandlerStats::LocalShard() {
+  // Threads are assigned shards round robin, the first time they record any stats.
+  static std::atomic<size_t> next_shard{0};
+  static thread_local size_t shard = next_shard.fetch_add(1) % kNumShards;
+  return shards[shard];
+}
+
+HandlerStats GuardedHandlerStats::Snapshot() const {
+  HandlerStats stats;
+  for (const auto &shard : shards) {
+    stats.cum_count += shard.cum_count.load(std::memory_order_relaxed);
+    stats.curr_count += shard.curr_count.load(std::memory_order_relaxed);
+    stats.cum_execution_time += shard.cum_execution_time.load(std::memory_order_relaxed);
+    stats.running_count += shard.running_count.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+GuardedGlobalStats::GuardedGlobalStats(const std::string &io_context_name)
+    : queue_depth_metric(IoContextQueueDepth().Bind({{"IoContext", io_context_name}})),
+      running_handler(std::make_shared<ray::RunningHandler>()) {}
+
+void GuardedGlobalStats::RecordQueueTime(int64_t queue_time_ns) {
+  cum_queue_time.fetch_add(queue_time_ns, std::memory_order_relaxed);
+  int64_t min = min_queue_time.load(std::memory_order_relaxed);
+  while (queue_time_ns < min &&
+         !min_queue_time.compare_exchange_weak(min, queue_time_ns,
+                                               std::memory_order_relaxed)) {
+  }
+  int64_t max = max_queue_time.load(std::memory_order_relaxed);
+  while (queue_time_ns > max &&
+         !max_queue_time.compare_exchange_weak(max, queue_time_ns,
+                                               std::memory_order_relaxed)) {
+  }
+}
+
+GlobalStats GuardedGlobalStats::Snapshot() const {
+  GlobalStats stats;
+  stats.cum_queue_time = cum_queue_time.load(std::memory_order_relaxed);
+  stats.min_queue_time = min_queue_time.load(std::memory_order_relaxed);
+  stats.max_queue_time = max_queue_time.load(std::memory_order_relaxed);
+  return stats;
+}
+
+std::atomic<uint64_t> instrumented_io_context::next_id_{0};
+
 void instrumented_io_context::post(std::function<void()> handler,
                                    const std::string name) {
   if (!RayConfig::instance().event_stats()) {
@@ -115,13 +202,12 @@ void instrumented_io_context::dispatch(std::function<void()> handler,
 std::shared_ptr<StatsHandle> instrumented_io_context::RecordStart(
     const std::string &name, int64_t expected_queueing_delay_ns) {
   auto stats = GetOrCreate(name);
-  {
-    absl::MutexLock lock(&(stats->mutex));
-    stats->stats.cum_count++;
-    stats->stats.curr_count++;
-  }
-  STATS_operation_count.Record(stats->stats.curr_count, name);
-  STATS_operation_active_count.Record(stats->stats.curr_count, name);
+  auto &shard = stats->LocalShard();
+  shard.cum_count.fetch_add(1, std::memory_order_relaxed);
+  shard.curr_count.fetch_add(1, std::memory_order_relaxed);
+  stats->count_metric.Record(1);
+  stats->active_count_metric.Record(1);
+  global_stats_->queue_depth_metric.Record(1);
   return std::make_shared<StatsHandle>(
       name, absl::GetCurrentTimeNanos() + expected_queueing_delay_ns, stats,
       global_stats_);
@@ -131,49 +217,49 @@ void instrumented_io_context::RecordExecution(const std::function<void()> &fn,
                                               std::shared_ptr<StatsHandle> handle) {
   int64_t start_execution = absl::GetCurrentTimeNanos();
   // Update running count
-  {
-    auto &stats = handle->handler_stats;
-    absl::MutexLock lock(&(stats->mutex));
-    stats->stats.running_count++;
+  auto &shard = handle->handler_stats->LocalShard();
+  shard.running_count.fetch_add(1, std::memory_order_relaxed);
+  const bool detect_stall = RayConfig::instance().event_loop_stall_threshold_ms() > 0;
+  if (detect_stall) {
+    ray::EventLoopStallDetector::Instance().StartOnce();
+    handle->global_stats->running_handler->Start(handle->handler_stats->name,
+                                                 start_execution);
   }
   // Execute actual handler.
   fn();
+  if (detect_stall) {
+    handle->global_stats->running_handler->Finish();
+  }
   int64_t end_execution = absl::GetCurrentTimeNanos();
   // Update execution time stats.
   const auto execution_time_ns = end_execution - start_execution;
   // Update handler-specific stats.
-  STATS_operation_run_time_ms.Record(execution_time_ns / 1000000, handle->handler_name);
+  const auto queue_time_ns = start_execution - handle->start_time;
   {
     auto &stats = handle->handler_stats;
-    absl::MutexLock lock(&(stats->mutex));
+    stats->execution_time_metric.Record(execution_time_ns / 1e6);
+    stats->queue_time_metric.Record(queue_time_ns / 1e6);
+    stats->active_count_metric.Record(-1);
     // Handler-specific execution stats.
-    stats->stats.cum_execution_time += execution_time_ns;
+    shard.cum_execution_time.fetch_add(execution_time_ns, std::memory_order_relaxed);
     // Handler-specific current count.
-    stats->stats.curr_count--;
-    STATS_operation_active_count.Record(stats->stats.curr_count, handle->handler_name);
+    shard.curr_count.fetch_sub(1, std::memory_order_relaxed);
     // Handler-specific running count.
-    stats->stats.running_count--;
+    shard.running_count.fetch_sub(1, std::memory_order_relaxed);
   }
   // Update global stats.
-  const auto queue_time_ns = start_execution - handle->start_time;
-  STATS_operation_queue_time_ms.Record(queue_time_ns / 1000000, handle->handler_name);
-  {
-    auto global_stats = handle->global_stats;
-    absl::MutexLock lock(&(global_stats->mutex));
-    // Global queue stats.
-    global_stats->stats.cum_queue_time += queue_time_ns;
-    if (global_stats->stats.min_queue_time > queue_time_ns) {
-      global_stats->stats.min_queue_time = queue_time_ns;
-    }
-    if (global_stats->stats.max_queue_time < queue_time_ns) {
-      global_stats->stats.max_queue_time = queue_time_ns;
-    }
-  }
+  handle->global_stats->queue_depth_metric.Record(-1);
+  handle->global_stats->RecordQueueTime(queue_time_ns);
   handle->execution_recorded = true;
 }
 
 std::shared_ptr<GuardedHandlerStats> instrumented_io_context::GetOrCreate(
     const std::string &name) {
+  auto &cache = ThreadHandlerStatsCache()[id_];
+  auto cache_it = cache.find(name);
+  if (cache_it != cache.end()) {
+    return cache_it->second;
+  }
   // Get this handler's stats.
   mutex_.ReaderLock();
   auto it = post_handler_stats_.find(name);
@@ -184,8 +270,8 @@ std::shared_ptr<GuardedHandlerStats> instrumented_io_context::GetOrCreate(
     // this allows the common path, in which the handler already exists in the hash table,
     // to only require the readers lock.
     absl::WriterMutexLock lock(&mutex_);
-    const auto pair =
-        post_handler_stats_.try_emplace(name, std::make_shared<GuardedHandlerStats>());
+    const auto pair = post_handler_stats_.try_emplace(
+        name, std::make_shared<GuardedHandlerStats>(name));
     if (pair.second) {
       it = pair.first;
     } else {
@@ -197,11 +283,12 @@ std::shared_ptr<GuardedHandlerStats> instrumented_io_context::GetOrCreate(
   } else {
     mutex_.ReaderUnlock();
   }
+  cache.emplace(name, it->second);
   return it->second;
 }
 
 GlobalStats instrumented_io_context::get_global_stats() const {
-  return to_global_stats_view(global_stats_);
+  return global_stats_->Snapshot();
 }
 
 absl::optional<HandlerStats> instrumented_io_context::get_handler_stats(
@@ -211,7 +298,7 @@ absl::optional<HandlerStats> instrumented_io_context::get_handler_stats(
   if (it == post_handler_stats_.end()) {
     return {};
   }
-  return to_handler_stats_view(it->second);
+  return it->second->Snapshot();
 }
 
 std::vector<std::pair<std::string, HandlerStats>>
@@ -223,7 +310,7 @@ instrumented_io_context::get_handler_stats() const {
   std::transform(
       post_handler_stats_.begin(), post_handler_stats_.end(), std::back_inserter(stats),
       [](const std::pair<std::string, std::shared_ptr<GuardedHandlerStats>> &p) {
-        return std::make_pair(p.first, to_handler_stats_view(p.second));
+        return std::make_pair(p.first, p.second->Snapshot());
       });
   return stats;
 }
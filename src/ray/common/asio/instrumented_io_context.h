@@ -14,11 +14,15 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <boost/asio.hpp>
 #include <limits>
 #include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
+#include "ray/common/asio/event_loop_stall_detector.h"
 #include "ray/common/ray_config.h"
+#include "ray/stats/metric.h"
 #include "ray/util/logging.h"
 
 /// Count, queueing, and execution statistics for an asio handler.
@@ -40,26 +44,65 @@ struct GlobalStats {
   int64_t max_queue_time = -1;
 };
 
-/// A mutex wrapper around a handler stats struct.
+/// The stats of a handler that are updated by one group of threads. Padded to a cache
+/// line, so that threads updating different shards rarely contend.
+struct HandlerStatsShard {
+  std::atomic<int64_t> cum_count{0};
+  std::atomic<int64_t> curr_count{0};
+  std::atomic<int64_t> cum_execution_time{0};
+  std::atomic<int64_t> running_count{0};
+  char padding[64 - 4 * sizeof(std::atomic<int64_t>)];
+};
+
+/// The stats of a handler, sharded by thread so that recording them takes no lock and
+/// rarely shares a cache line with another thread. The shards are summed on read.
 struct GuardedHandlerStats {
-  // Stats for some handler.
-  HandlerStats stats;
+  /// Bind the exported metrics of the handler.
+  explicit GuardedHandlerStats(const std::string &handler_name);
+
+  /// The shard of the calling thread.
+  HandlerStatsShard &LocalShard();
+
+  /// Sum the shards. The sum is not a consistent snapshot if handlers are running.
+  HandlerStats Snapshot() const;
 
-  // The mutex protecting the reading and writing of these stats.
-  // This mutex should be acquired with a reader lock before reading, and should be
-  // acquired with a writer lock before writing.
-  mutable absl::Mutex mutex;
+  // The name of the handler, shared with the stall detector while it runs.
+  const std::shared_ptr<const std::string> name;
+
+  static constexpr size_t kNumShards = 16;
+
+  // Stats for some handler, by shard.
+  std::array<HandlerStatsShard, kNumShards> shards;
+
+  // The exported metrics of the handler. They are bound once, so that recording them
+  // is cheap.
+  const ray::stats::FastMetric::BoundMetric count_metric;
+  const ray::stats::FastMetric::BoundMetric active_count_metric;
+  const ray::stats::FastMetric::BoundMetric queue_time_metric;
+  const ray::stats::FastMetric::BoundMetric execution_time_metric;
 };
 
-/// A mutex wrapper around a handler stats struct.
+/// The stats over all handlers of an io_context. Recording them takes no lock.
 struct GuardedGlobalStats {
-  // Stats over all handlers.
-  GlobalStats stats;
+  /// Bind the exported metrics of the io_context.
+  explicit GuardedGlobalStats(const std::string &io_context_name);
+
+  /// Record the queueing time of a handler.
+  void RecordQueueTime(int64_t queue_time_ns);
 
-  // The mutex protecting the reading and writing of these stats.
-  // This mutex should be acquired with a reader lock before reading, and should be
-  // acquired with a writer lock before writing.
-  mutable absl::Mutex mutex;
+  /// Copy the stats.
+  GlobalStats Snapshot() const;
+
+  // Queue stats over all handlers.
+  std::atomic<int64_t> cum_queue_time{0};
+  std::atomic<int64_t> min_queue_time{std::numeric_limits<int64_t>::max()};
+  std::atomic<int64_t> max_queue_time{-1};
+
+  // The exported number of handlers that are queued or running in the io_context.
+  const ray::stats::FastMetric::BoundMetric queue_depth_metric;
+
+  // The handler that is running, watched by the stall detector.
+  const std::shared_ptr<ray::RunningHandler> running_handler;
 };
 
 /// An opaque stats handle, used to manually instrument event loop handlers that don't
@@ -86,17 +129,31 @@ struct StatsHandle {
     if (!execution_recorded) {
       // If handler execution was never recorded, we need to clean up some queueing
       // stats in order to prevent those stats from leaking.
-      absl::MutexLock lock(&(handler_stats->mutex));
-      handler_stats->stats.curr_count--;
+      handler_stats->LocalShard().curr_count.fetch_sub(1, std::memory_order_relaxed);
+      handler_stats->active_count_metric.Record(-1);
+      global_stats->queue_depth_metric.Record(-1);
     }
   }
 };
 
 /// A proxy for boost::asio::io_context that collects statistics about posted handlers.
+///
+/// With `event_stats` enabled, the queueing and execution times of each handler are
+/// exported as histograms, and the number of queued or running handlers as the queue
+/// depth of the io_context. They are recorded as fast metrics, which take no lock.
+/// With `event_loop_stall_threshold_ms` also set, handlers that run for longer than the
+/// threshold are reported by the EventLoopStallDetector while they are still running.
 class instrumented_io_context : public boost::asio::io_context {
  public:
   /// Initializes the global stats struct after calling the base contructor.
-  instrumented_io_context() : global_stats_(std::make_shared<GuardedGlobalStats>()) {}
+  ///
+  /// \param name The name of this io_context in the exported metrics.
+  explicit instrumented_io_context(const std::string &name = "")
+      : id_(next_id_.fetch_add(1)),
+        global_stats_(std::make_shared<GuardedGlobalStats>(name)) {
+    ray::EventLoopStallDetector::Instance().Register(name,
+                                                     global_stats_->running_handler);
+  }
 
   /// A proxy post function that collects count, queueing, and execution statistics for
   /// the given handler.
@@ -179,13 +236,22 @@ class instrumented_io_context : public boost::asio::io_context {
  private:
   using HandlerStatsTable =
       absl::flat_hash_map<std::string, std::shared_ptr<GuardedHandlerStats>>;
-  /// Get the mutex-guarded stats for this handler if it exists, otherwise create the
-  /// stats for this handler and return an iterator pointing to it.
+  /// Get the stats for this handler if it exists, otherwise create the stats for this
+  /// handler and return an iterator pointing to it. The stats are interned in a cache
+  /// of the calling thread, so that looking up a handler that this thread has seen
+  /// before takes no lock.
   ///
   /// \param name A human-readable name for the handler, to be used for viewing stats
   /// for the provided handler.
   std::shared_ptr<GuardedHandlerStats> GetOrCreate(const std::string &name);
 
+  /// The source of `id_`.
+  static std::atomic<uint64_t> next_id_;
+
+  /// A process-unique id of this io_context, which keys the thread caches of handler
+  /// stats. Unlike the address of the io_context, it is never reused.
+  const uint64_t id_;
+
   /// Global stats, across all handlers.
   std::shared_ptr<GuardedGlobalStats> global_stats_;
 
@@ -20,7 +20,12 @@
 namespace ray {
 
 PeriodicalRunner::PeriodicalRunner(instrumented_io_context &io_service)
-    : io_service_(io_service) {}
+    : io_service_(io_service) {
+  if (RayConfig::instance().periodical_runner_timer_wheel_tick_ms() > 0) {
+    wheel_ = std::make_unique<TimerWheel>(
+        io_service_, RayConfig::instance().periodical_runner_timer_wheel_tick_ms());
+  }
+}
 
 PeriodicalRunner::~PeriodicalRunner() {
   for (const auto &timer : timers_) {
@@ -31,7 +36,11 @@ PeriodicalRunner::~PeriodicalRunner() {
 
 void PeriodicalRunner::RunFnPeriodically(std::function<void()> fn, uint64_t period_ms,
                                          const std::string name) {
-  if (period_ms > 0) {
+  if (period_ms > 0 && wheel_ != nullptr) {
+    io_service_.post([this, fn = std::move(fn), period_ms, name]() {
+      DoRunFnOnWheel(fn, period_ms, name);
+    });
+  } else if (period_ms > 0) {
     auto timer = std::make_shared<boost::asio::deadline_timer>(io_service_);
     timers_.push_back(timer);
     io_service_.post(
@@ -64,6 +73,24 @@ void PeriodicalRunner::DoRunFnPeriodically(const std::function<void()> &fn,
       });
 }
 
+void PeriodicalRunner::DoRunFnOnWheel(const std::function<void()> &fn,
+                                      uint64_t period_ms, const std::string &name) {
+  fn();
+  if (RayConfig::instance().event_stats()) {
+    auto stats_handle =
+        io_service_.RecordStart(name, static_cast<int64_t>(period_ms) * 1000000);
+    wheel_->Schedule(period_ms, [this, fn, period_ms, name, stats_handle]() {
+      io_service_.RecordExecution([this, &fn, period_ms,
+                                   &name]() { DoRunFnOnWheel(fn, period_ms, name); },
+                                  stats_handle);
+    });
+  } else {
+    wheel_->Schedule(period_ms, [this, fn, period_ms, name]() {
+      DoRunFnOnWheel(fn, period_ms, name);
+    });
+  }
+}
+
 void PeriodicalRunner::DoRunFnPeriodicallyInstrumented(
     const std::function<void()> &fn, boost::posix_time::milliseconds period,
     boost::asio::deadline_timer &timer, const std::string name) {
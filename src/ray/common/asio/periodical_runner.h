@@ -17,6 +17,7 @@
 #include <boost/asio.hpp>
 #include <boost/asio/deadline_timer.hpp>
 #include "ray/common/asio/instrumented_io_context.h"
+#include "ray/common/asio/timer_wheel.h"
 
 namespace ray {
 
@@ -25,6 +26,8 @@ namespace ray {
 /// It can run functions with specified period. Each function is triggered by its timer.
 /// To run a function, call `RunFnPeriodically(fn, period_ms)`.
 /// All registered functions will stop running once this object is destructed.
+/// If `periodical_runner_timer_wheel_tick_ms` is set, the functions share one
+/// `TimerWheel` instead of having a timer each.
 class PeriodicalRunner {
  public:
   PeriodicalRunner(instrumented_io_context &io_service);
@@ -44,8 +47,13 @@ class PeriodicalRunner {
                                        boost::asio::deadline_timer &timer,
                                        const std::string name);
 
+  void DoRunFnOnWheel(const std::function<void()> &fn, uint64_t period_ms,
+                      const std::string &name);
+
   instrumented_io_context &io_service_;
   std::vector<std::shared_ptr<boost::asio::deadline_timer>> timers_;
+  /// The wheel that runs the functions, if enabled.
+  std::unique_ptr<TimerWheel> wheel_;
 };
 
 }  // namespace ray
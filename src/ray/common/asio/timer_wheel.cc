@@ -0,0 +1,98 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/asio/timer_wheel.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "ray/util/logging.h"
+
+namespace ray {
+
+TimerWheel::TimerWheel(instrumented_io_context &io_service, uint64_t tick_ms,
+                       size_t num_slots)
+    : io_service_(io_service),
+      tick_ms_(tick_ms),
+      slots_(num_slots),
+      ticker_(io_service) {
+  RAY_CHECK(tick_ms_ > 0);
+  RAY_CHECK(!slots_.empty());
+}
+
+TimerWheel::~TimerWheel() { ticker_.cancel(); }
+
+TimerWheel::TimerId TimerWheel::Schedule(uint64_t delay_ms, std::function<void()> fn) {
+  const uint64_t ticks = std::max<uint64_t>(1, (delay_ms + tick_ms_ - 1) / tick_ms_);
+  const size_t slot = (current_slot_ + ticks) % slots_.size();
+  const TimerId id = next_id_++;
+  auto &timers = slots_[slot];
+  timers.push_back(Timer{id, (ticks - 1) / slots_.size(), std::move(fn)});
+  timers_.emplace(id, std::make_pair(slot, std::prev(timers.end())));
+  StartTicking();
+  return id;
+}
+
+bool TimerWheel::Cancel(TimerId id) {
+  auto it = timers_.find(id);
+  if (it == timers_.end()) {
+    return false;
+  }
+  slots_[it->second.first].erase(it->second.second);
+  timers_.erase(it);
+  return true;
+}
+
+void TimerWheel::StartTicking() {
+  if (ticking_) {
+    return;
+  }
+  ticking_ = true;
+  ticker_.expires_from_now(boost::posix_time::milliseconds(tick_ms_));
+  ticker_.async_wait([this](const boost::system::error_code &error) {
+    if (error == boost::asio::error::operation_aborted) {
+      // The wheel was destroyed.
+      return;
+    }
+    RAY_CHECK(!error) << error.message();
+    ticking_ = false;
+    Tick();
+  });
+}
+
+void TimerWheel::Tick() {
+  current_slot_ = (current_slot_ + 1) % slots_.size();
+  // Take the expired timers out of the wheel before running any of them, since
+  // they may schedule or cancel timers.
+  std::list<Timer> expired;
+  auto &timers = slots_[current_slot_];
+  for (auto it = timers.begin(); it != timers.end();) {
+    auto next = std::next(it);
+    if (it->rounds == 0) {
+      timers_.erase(it->id);
+      expired.splice(expired.end(), timers, it);
+    } else {
+      it->rounds--;
+    }
+    it = next;
+  }
+  if (!timers_.empty()) {
+    StartTicking();
+  }
+  for (auto &timer : expired) {
+    timer.fn();
+  }
+}
+
+}  // namespace ray
@@ -0,0 +1,97 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <boost/asio.hpp>
+#include <boost/asio/deadline_timer.hpp>
+#include <functional>
+#include <list>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "ray/common/asio/instrumented_io_context.h"
+
+namespace ray {
+
+/// \class TimerWheel
+/// A hashed timer wheel attached to an io_context. All of its timers are driven by a
+/// single asio timer that ticks every `tick_ms` while any timer is pending, so that
+/// scheduling and canceling a timer is O(1) and doesn't touch the asio timer queue.
+/// The timers that expire on the same tick run together. Deadlines are rounded to
+/// the tick, so a timer may fire up to one tick early or late.
+///
+/// Timers scheduled further out than one turn of the wheel stay in their slot for
+/// as many turns as needed. This class is not thread-safe, it must be used from the
+/// thread that runs the io_context. Pending timers never run after the wheel is
+/// destroyed.
+class TimerWheel {
+ public:
+  using TimerId = uint64_t;
+
+  /// \param io_service The event loop that runs the timers.
+  /// \param tick_ms The resolution of the wheel.
+  /// \param num_slots The number of ticks in one turn of the wheel.
+  TimerWheel(instrumented_io_context &io_service, uint64_t tick_ms,
+             size_t num_slots = 512);
+
+  ~TimerWheel();
+
+  /// Run a function once after a delay.
+  ///
+  /// \param delay_ms The delay, rounded up to a whole number of ticks, at least one.
+  /// \param fn The function to run.
+  /// \return The id of the timer, to cancel it.
+  TimerId Schedule(uint64_t delay_ms, std::function<void()> fn);
+
+  /// Cancel a pending timer.
+  ///
+  /// \param id The id returned by Schedule().
+  /// \return Whether the timer was pending, false if it already ran or was canceled.
+  bool Cancel(TimerId id);
+
+  /// The number of pending timers.
+  size_t Size() const { return timers_.size(); }
+
+ private:
+  struct Timer {
+    TimerId id;
+    /// The number of times the wheel passes the slot of the timer before it expires.
+    uint64_t rounds;
+    std::function<void()> fn;
+  };
+
+  /// Start the asio timer if it isn't running.
+  void StartTicking();
+
+  /// Advance the wheel by one slot, and run the timers that expire in it.
+  void Tick();
+
+  instrumented_io_context &io_service_;
+  const uint64_t tick_ms_;
+  /// The slots of the wheel, each holding the timers that are due when the wheel
+  /// reaches it.
+  std::vector<std::list<Timer>> slots_;
+  /// The slot of the last tick.
+  size_t current_slot_ = 0;
+  TimerId next_id_ = 1;
+  /// The slot and position of each pending timer.
+  absl::flat_hash_map<TimerId, std::pair<size_t, std::list<Timer>::iterator>> timers_;
+  /// The asio timer that drives the wheel.
+  boost::asio::deadline_timer ticker_;
+  /// Whether `ticker_` is waiting for the next tick.
+  bool ticking_ = false;
+};
+
+}  // namespace ray
@@ -14,13 +14,16 @@
 
 #include "ray/common/client_connection.h"
 
+#include <algorithm>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/generic/stream_protocol.hpp>
 #include <boost/asio/placeholders.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
 #include <boost/bind.hpp>
 #include <chrono>
+#include <cstring>
 #include <sstream>
 #include <thread>
 
@@ -67,7 +70,8 @@ std::shared_ptr<ServerConnection> ServerConnection::Create(local_stream_socket &
 
 ServerConnection::ServerConnection(local_stream_socket &&socket)
     : socket_(std::move(socket)),
-      async_write_max_messages_(1),
+      async_write_max_messages_(std::max(
+          1, RayConfig::instance().client_connection_async_write_max_messages())),
       async_write_queue_(),
       async_write_in_flight_(false),
       async_write_broken_pipe_(false) {}
@@ -79,25 +83,36 @@ ServerConnection::~ServerConnection() {
   }
 }
 
+/// Drop the first `bytes` bytes from a buffer sequence, after a partial read or write.
+template <typename Buffer>
+static void ConsumeBuffers(std::vector<Buffer> *buffers, size_t bytes) {
+  auto it = buffers->begin();
+  while (it != buffers->end() && bytes >= boost::asio::buffer_size(*it)) {
+    bytes -= boost::asio::buffer_size(*it);
+    ++it;
+  }
+  buffers->erase(buffers->begin(), it);
+  if (!buffers->empty()) {
+    buffers->front() = buffers->front() + bytes;
+  }
+}
+
 Status ServerConnection::WriteBuffer(
     const std::vector<boost::asio::const_buffer> &buffer) {
   boost::system::error_code error;
+  // Write all the buffers with one gathering system call, rather than one call per
+  // buffer, so that a message costs a single write when the socket has room for it.
   // Loop until all bytes are written while handling interrupts.
   // When profiling with pprof, unhandled interrupts were being sent by the profiler to
   // the raylet process, which was causing synchronous reads and writes to fail.
-  for (const auto &b : buffer) {
-    uint64_t bytes_remaining = boost::asio::buffer_size(b);
-    uint64_t position = 0;
-    while (bytes_remaining != 0) {
-      size_t bytes_written =
-          socket_.write_some(boost::asio::buffer(b + position, bytes_remaining), error);
-      position += bytes_written;
-      bytes_remaining -= bytes_written;
-      if (error.value() == EINTR) {
-        continue;
-      } else if (error.value() != boost::system::errc::errc_t::success) {
-        return boost_to_ray_status(error);
-      }
+  std::vector<boost::asio::const_buffer> remaining(buffer);
+  while (!remaining.empty()) {
+    size_t bytes_written = socket_.write_some(remaining, error);
+    ConsumeBuffers(&remaining, bytes_written);
+    if (error.value() == EINTR) {
+      continue;
+    } else if (error.value() != boost::system::errc::errc_t::success) {
+      return boost_to_ray_status(error);
     }
   }
   return ray::Status::OK();
@@ -133,19 +148,14 @@ Status ServerConnection::ReadBuffer(
     const std::vector<boost::asio::mutable_buffer> &buffer) {
   boost::system::error_code error;
   // Loop until all bytes are read while handling interrupts.
-  for (const auto &b : buffer) {
-    uint64_t bytes_remaining = boost::asio::buffer_size(b);
-    uint64_t position = 0;
-    while (bytes_remaining != 0) {
-      size_t bytes_read =
-          socket_.read_some(boost::asio::buffer(b + position, bytes_remaining), error);
-      position += bytes_read;
-      bytes_remaining -= bytes_read;
-      if (error.value() == EINTR) {
-        continue;
-      } else if (error.value() != boost::system::errc::errc_t::success) {
-        return boost_to_ray_status(error);
-      }
+  std::vector<boost::asio::mutable_buffer> remaining(buffer);
+  while (!remaining.empty()) {
+    size_t bytes_read = socket_.read_some(remaining, error);
+    ConsumeBuffers(&remaining, bytes_read);
+    if (error.value() == EINTR) {
+      continue;
+    } else if (error.value() != boost::system::errc::errc_t::success) {
+      return boost_to_ray_status(error);
     }
   }
   return Status::OK();
@@ -363,7 +373,9 @@ ClientConnection::ClientConnection(
       debug_label_(debug_label),
       message_type_enum_names_(message_type_enum_names),
       error_message_type_(error_message_type),
-      error_message_data_(error_message_data) {}
+      error_message_data_(error_message_data),
+      read_buffer_bytes_(RayConfig::instance().client_connection_read_buffer_bytes()),
+      read_buffer_offset_(0) {}
 
 void ClientConnection::Register() {
   RAY_CHECK(!registered_);
@@ -371,6 +383,10 @@ void ClientConnection::Register() {
 }
 
 void ClientConnection::ProcessMessages() {
+  if (read_buffer_bytes_ > 0) {
+    ProcessBufferedMessages();
+    return;
+  }
   // Wait for a message header from the client. The message header includes the
   // protocol version, the message type, and the length of the message.
   std::vector<boost::asio::mutable_buffer> header{
@@ -440,6 +456,59 @@ void ClientConnection::ProcessMessageHeader(const boost::system::error_code &err
   }
 }
 
+void ClientConnection::ProcessBufferedMessages() {
+  const size_t header_size =
+      sizeof(read_cookie_) + sizeof(read_type_) + sizeof(read_length_);
+  size_t needed = header_size;
+  size_t available = read_buffer_.size() - read_buffer_offset_;
+  if (available >= header_size) {
+    const uint8_t *header = read_buffer_.data() + read_buffer_offset_;
+    std::memcpy(&read_cookie_, header, sizeof(read_cookie_));
+    std::memcpy(&read_type_, header + sizeof(read_cookie_), sizeof(read_type_));
+    std::memcpy(&read_length_, header + sizeof(read_cookie_) + sizeof(read_type_),
+                sizeof(read_length_));
+    if (!CheckRayCookie()) {
+      ServerConnection::Close();
+      return;
+    }
+    needed = header_size + read_length_;
+    if (available >= needed) {
+      read_message_.assign(header + header_size, header + needed);
+      read_buffer_offset_ += needed;
+      ServerConnection::bytes_read_ += read_length_;
+      // The message handler calls back into ProcessMessages for the next message, so
+      // go through the event loop instead of recursing over all buffered messages.
+      boost::asio::post(ServerConnection::socket_.get_executor(),
+                        [this, this_ptr = shared_ClientConnection_from_this()]() {
+                          ProcessMessage(boost::system::error_code());
+                        });
+      return;
+    }
+  }
+
+  // Move the partial message to the front of the buffer, and read at least the rest
+  // of it, or a full chunk if more is available.
+  read_buffer_.erase(read_buffer_.begin(), read_buffer_.begin() + read_buffer_offset_);
+  read_buffer_offset_ = 0;
+  size_t old_size = read_buffer_.size();
+  size_t read_size = std::max<size_t>(read_buffer_bytes_, needed - available);
+  read_buffer_.resize(old_size + read_size);
+  ServerConnection::socket_.async_read_some(
+      boost::asio::buffer(read_buffer_.data() + old_size, read_size),
+      [this, this_ptr = shared_ClientConnection_from_this(), old_size](
+          const boost::system::error_code &error, size_t bytes_transferred) {
+        read_buffer_.resize(old_size + bytes_transferred);
+        if (error) {
+          read_type_ = error_message_type_;
+          read_message_ = error_message_data_;
+          read_length_ = 0;
+          ProcessMessage(error);
+          return;
+        }
+        ProcessBufferedMessages();
+      });
+}
+
 bool ClientConnection::CheckRayCookie() {
   if (read_cookie_ == RayConfig::instance().ray_cookie()) {
     return true;
@@ -225,6 +225,9 @@ class ClientConnection : public ServerConnection {
   /// Process an error from reading the message header, then process the
   /// message from the client.
   void ProcessMessage(const boost::system::error_code &error);
+  /// Process the next message in the read buffer, reading more from the client when
+  /// the buffer doesn't hold a complete message. Used when reads are batched.
+  void ProcessBufferedMessages();
   /// Check if the ray cookie in a received message is correct. Note, if the cookie
   /// is wrong and the remote endpoint is known, raylet process will crash. If the remote
   /// endpoint is unknown, this method will only print a warning.
@@ -255,6 +258,12 @@ class ClientConnection : public ServerConnection {
   int64_t read_type_;
   uint64_t read_length_;
   std::vector<uint8_t> read_message_;
+  /// Size of the chunks to read from the client, 0 if reads are not batched.
+  const uint64_t read_buffer_bytes_;
+  /// Bytes read from the client but not processed yet, when reads are batched. The
+  /// unprocessed bytes start at `read_buffer_offset_`.
+  std::vector<uint8_t> read_buffer_;
+  size_t read_buffer_offset_;
 };
 
 }  // namespace ray
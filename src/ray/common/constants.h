@@ -34,6 +34,10 @@ constexpr char kObjectTablePrefix[] = "ObjectTable";
 /// Prefix for the task table keys in redis.
 constexpr char kTaskTablePrefix[] = "TaskTable";
 
+/// Prefix of the spilled URLs of objects that are held compressed in the memory of
+/// the raylet that spilled them.
+constexpr char kCompressedObjectURLPrefix[] = "compressed://";
+
 constexpr char kWorkerDynamicOptionPlaceholder[] =
     "RAY_WORKER_DYNAMIC_OPTION_PLACEHOLDER";
 
@@ -46,6 +46,35 @@ using ObjectIDIndexType = uint32_t;
 // Declaration.
 uint64_t MurmurHash64A(const void *key, int len, unsigned int seed);
 
+/// Hash the bytes of an ID of size N. Most bytes of an ID are random, or the output
+/// of a cryptographic hash, so mixing them 8 bytes at a time spreads the hash as well
+/// as MurmurHash does, at a fraction of the cost. N is a constant, so the loop is
+/// unrolled by the compiler.
+template <size_t N>
+inline uint64_t HashIDBytes(const uint8_t *data) {
+  constexpr uint64_t kMultiplier = 0x9e3779b97f4a7c15ULL;
+  uint64_t hash = N * kMultiplier;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= N; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    hash = (hash ^ word) * kMultiplier;
+    hash ^= hash >> 32;
+  }
+  if (i < N) {
+    uint64_t word = 0;
+    std::memcpy(&word, data + i, N - i);
+    hash = (hash ^ word) * kMultiplier;
+    hash ^= hash >> 32;
+  }
+  // Finalize so that every input bit affects the low bits, which hash tables use to
+  // pick buckets.
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
 // Change the compiler alignment to 1 byte (default is 8).
 #pragma pack(push, 1)
 
@@ -454,7 +483,7 @@ size_t BaseID<T>::Hash() const {
   // Note(ashione): hash code lazy calculation(it's invoked every time if hash code is
   // default value 0)
   if (!hash_) {
-    hash_ = MurmurHash64A(Data(), T::Size(), 0);
+    hash_ = HashIDBytes<T::Size()>(Data());
   }
   return hash_;
 }
@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <chrono>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "ray/common/common_protocol.h"
 #include "ray/common/task/task_spec.h"
@@ -105,6 +108,53 @@ TEST(HashTest, TestNilHash) {
   ASSERT_NE(id1.Hash(), id2.Hash());
 }
 
+TEST(HashTest, TestHashDistribution) {
+  // Object IDs of one task only differ in their index. Their hashes should still be
+  // spread evenly over the buckets of a hash table.
+  const TaskID task_id = TaskID::ForFakeTask();
+  const int num_buckets = 1024;
+  const int num_ids = 256 * num_buckets;
+  std::vector<int> buckets(num_buckets, 0);
+  for (int i = 0; i < num_ids; i++) {
+    buckets[ObjectID::FromIndex(task_id, i).Hash() % num_buckets]++;
+  }
+  for (int count : buckets) {
+    ASSERT_GT(count, 256 / 2);
+    ASSERT_LT(count, 256 * 2);
+  }
+}
+
+TEST(HashTest, BenchmarkHash) {
+  std::vector<ObjectID> ids;
+  for (int i = 0; i < 1000; i++) {
+    ids.push_back(ObjectID::FromRandom());
+  }
+  const int num_rounds = 10000;
+  uint64_t result = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < num_rounds; round++) {
+    for (const auto &id : ids) {
+      result += HashIDBytes<ObjectID::Size()>(id.Data());
+    }
+  }
+  auto id_hash_time = std::chrono::steady_clock::now() - start;
+  start = std::chrono::steady_clock::now();
+  for (int round = 0; round < num_rounds; round++) {
+    for (const auto &id : ids) {
+      result += MurmurHash64A(id.Data(), ObjectID::Size(), 0);
+    }
+  }
+  auto murmur_hash_time = std::chrono::steady_clock::now() - start;
+  double num_hashes = num_rounds * ids.size();
+  RAY_LOG(INFO) << "ns per hash, HashIDBytes: "
+                << std::chrono::duration<double, std::nano>(id_hash_time).count() /
+                       num_hashes
+                << ", MurmurHash64A: "
+                << std::chrono::duration<double, std::nano>(murmur_hash_time).count() /
+                       num_hashes
+                << ", checksum " << result;
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
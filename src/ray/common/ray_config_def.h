@@ -21,6 +21,10 @@
 /// The duration between dumping debug info to logs, or 0 to disable.
 RAY_CONFIG(uint64_t, debug_dump_period_milliseconds, 10000)
 
+/// Whether the raylet renders the event loop stats of its debug state dump and writes
+/// the dump from a background thread, instead of on its main loop.
+RAY_CONFIG(bool, debug_dump_in_background, false)
+
 /// Whether to enable Ray event stats collection.
 /// TODO(ekl) this seems to segfault Java unit tests when on by default?
 RAY_CONFIG(bool, event_stats, false)
@@ -31,6 +35,15 @@ RAY_CONFIG(bool, event_stats, false)
 /// NOTE: This requires event_stats=1.
 RAY_CONFIG(int64_t, event_stats_print_interval_ms, 10000)
 
+/// Whether to record spans of the task lifecycle (lease request, queueing and argument
+/// pull in the raylet, argument fetch, execution and return put in the worker) in the
+/// raylet, core workers and GCS. Each process writes its spans to its log directory as
+/// a Chrome trace file when it shuts down. The file can be opened in Perfetto.
+RAY_CONFIG(bool, span_tracing_enabled, false)
+
+/// The number of most recent spans kept by each process when span tracing is enabled.
+RAY_CONFIG(uint64_t, span_tracing_buffer_size, 100000)
+
 /// In theory, this is used to detect Ray cookie mismatches.
 /// This magic number (hex for "RAY") is used instead of zero, rationale is
 /// that it could still be possible that some random program sends an int64_t
@@ -38,16 +51,36 @@ RAY_CONFIG(int64_t, event_stats_print_interval_ms, 10000)
 /// particular magic number.
 RAY_CONFIG(int64_t, ray_cookie, 0x5241590000000000)
 
+/// The max number of queued messages a local socket connection, such as the one
+/// between the raylet and a worker, writes out in one vectored write.
+RAY_CONFIG(int, client_connection_async_write_max_messages, 1)
+
+/// If non-zero, the raylet and the plasma store read client messages in chunks of up
+/// to this many bytes, and process all the messages of a chunk, instead of reading
+/// the header and the body of each message separately.
+RAY_CONFIG(uint64_t, client_connection_read_buffer_bytes, 0)
+
 /// The duration that a single handler on the event loop can take before a
 /// warning is logged that the handler is taking too long.
 RAY_CONFIG(int64_t, handler_warning_timeout_ms, 1000)
 
+/// The duration that a single handler on an event loop can run before it is reported
+/// as stalled, with the stack of the event loop thread. Unlike
+/// handler_warning_timeout_ms, the report is made while the handler is still running.
+/// 0 means the stall detector is disabled.
+/// NOTE: This requires event_stats=1.
+RAY_CONFIG(int64_t, event_loop_stall_threshold_ms, 0)
+
 /// The duration between heartbeats sent by the raylets.
 RAY_CONFIG(uint64_t, raylet_heartbeat_period_milliseconds, 1000)
 /// If a component has not sent a heartbeat in the last num_heartbeats_timeout
 /// heartbeat intervals, the raylet monitor process will report
 /// it as dead to the db_client table.
 RAY_CONFIG(int64_t, num_heartbeats_timeout, 30)
+/// Whether the gcs server takes every resource report it pulls from a raylet as a
+/// heartbeat of that raylet. If set, raylets skip most of their heartbeats while the
+/// gcs server keeps pulling their resource reports.
+RAY_CONFIG(bool, gcs_heartbeat_piggyback_on_resource_reports, false)
 /// For a raylet, if the last heartbeat was sent more than this many
 /// heartbeat periods ago, then a warning will be logged that the heartbeat
 /// handler is drifting.
@@ -87,12 +120,81 @@ RAY_CONFIG(size_t, free_objects_batch_size, 100)
 
 RAY_CONFIG(bool, lineage_pinning_enabled, false)
 
+/// If non-zero, the max total size in bytes of task specs that a worker keeps
+/// for finished tasks so that their return objects can be reconstructed. Above
+/// this, the lineage of the oldest finished tasks is evicted and their return
+/// objects are no longer reconstructable. 0 means no limit.
+RAY_CONFIG(int64_t, max_lineage_bytes, 0)
+
 /// Whether to re-populate plasma memory. This avoids memory allocation failures
 /// at runtime (SIGBUS errors creating new objects), however it will use more memory
 /// upfront and can slow down Ray startup.
 /// See also: https://github.com/ray-project/ray/issues/14182
 RAY_CONFIG(bool, preallocate_plasma_memory, false)
 
+/// Whether to ask the kernel to back plasma memory with transparent huge pages.
+/// Unlike running the store on a hugetlbfs directory, this doesn't need huge
+/// pages to be reserved up front, but for /dev/shm it requires
+/// /sys/kernel/mm/transparent_hugepage/shmem_enabled to be "advise" or "always".
+RAY_CONFIG(bool, plasma_transparent_hugepages, false)
+
+/// The NUMA placement of plasma memory. "local" binds it to the NUMA node the
+/// raylet runs on, and "interleave" spreads it over all nodes. Empty leaves the
+/// placement to the kernel. Only supported on Linux.
+RAY_CONFIG(std::string, plasma_numa_policy, "")
+
+/// Whether to serve small plasma objects from size-class segregated slabs carved
+/// out of the plasma shared memory. This avoids fragmenting the dlmalloc heap when
+/// many small objects are created and deleted.
+RAY_CONFIG(bool, plasma_slab_allocator_enabled, false)
+
+/// Objects up to this size are allocated from slabs when the slab allocator is
+/// enabled. Larger objects are allocated through dlmalloc.
+RAY_CONFIG(int64_t, plasma_slab_max_object_size, 1024 * 1024)
+
+/// The size of each slab of the plasma slab allocator.
+RAY_CONFIG(int64_t, plasma_slab_size, 16 * 1024 * 1024)
+
+/// The policy that picks which plasma objects to evict first. One of "lru",
+/// "gdsf" (Greedy-Dual-Size-Frequency, which prefers evicting large, rarely used
+/// objects) and "2q" (which keeps objects that were used more than once safe
+/// from scans).
+RAY_CONFIG(std::string, plasma_eviction_policy, "lru")
+
+/// Whether plasma evicts copies that are cheap to get back before the others:
+/// copies pulled from other nodes, and copies of objects that were spilled. The
+/// eviction policy above only orders the remaining objects.
+RAY_CONFIG(bool, plasma_evict_replaceable_copies_first, false)
+
+/// Plasma create requests are served by priority (task returns, then restored
+/// objects, then puts) while the store is short on memory. A request that has
+/// waited for longer than this is served next regardless of its priority, so that
+/// low priority requests are not starved. -1 disables this.
+RAY_CONFIG(int64_t, plasma_create_request_starvation_timeout_ms, 10000)
+
+/// The fraction of the plasma store a single job may fill with the objects its
+/// workers create. Objects beyond the quota are allocated by the fallback
+/// allocator instead of evicting or spilling the objects of other jobs. 1
+/// disables the quota.
+RAY_CONFIG(double, plasma_job_memory_quota_fraction, 1.0)
+
+/// The capacity in bytes of the shared memory rings that carry the Get, Release
+/// and Contains requests of a plasma client, and their replies. The client socket
+/// is then only used to pass fds and to wake up a sleeping side. 0 disables the
+/// rings. Only supported on Linux.
+RAY_CONFIG(int64_t, plasma_client_ring_size, 0)
+
+/// How long a plasma client busy-polls its reply ring before it goes to sleep on
+/// the socket.
+RAY_CONFIG(int64_t, plasma_client_ring_spin_us, 50)
+
+/// The maximum total size in bytes of the sealed objects a plasma client keeps mapped
+/// after they were released, so that getting them again doesn't need a request to the
+/// store. The store is told about the release of the least recently released objects
+/// once the size is exceeded. The store can't evict the objects meanwhile. 0 sends
+/// each release to the store right away.
+RAY_CONFIG(int64_t, plasma_client_release_delay_bytes, 0)
+
 /// Whether to use the hybrid scheduling policy, or one of the legacy spillback
 /// strategies. In the hybrid scheduling strategy, leases are packed until a threshold,
 /// then spread via weighted (by critical resource usage).
@@ -103,6 +205,17 @@ RAY_CONFIG(float, scheduler_spread_threshold,
                ? std::stof(getenv("RAY_SCHEDULER_SPREAD_THRESHOLD"))
                : 0.5)
 
+/// The weight of data locality in the hybrid scheduling policy when tasks are spilled
+/// back. The critical resource utilization of a node is lowered by this weight times
+/// the fraction of the task's argument bytes that the node holds. Set to 0 to ignore
+/// where the arguments are.
+RAY_CONFIG(float, scheduler_locality_weight, 0.5)
+
+/// How long the raylet holds the tasks of a gang before it fails all of them. This
+/// covers both waiting for all tasks of the gang to arrive and waiting for resources
+/// to place all of them at once.
+RAY_CONFIG(int64_t, gang_scheduling_timeout_ms, 60000)
+
 // The max allowed size in bytes of a return object from direct actor calls.
 // Objects larger than this size will be spilled/promoted to plasma.
 RAY_CONFIG(int64_t, max_direct_call_object_size, 100 * 1024)
@@ -115,6 +228,28 @@ RAY_CONFIG(int64_t, max_grpc_message_size, 100 * 1024 * 1024)
 // of retries is non zero.
 RAY_CONFIG(int64_t, grpc_server_retry_timeout_milliseconds, 1000)
 
+/// The number of completion queues and polling threads of the gRPC servers of the
+/// raylet and the core workers. The object manager server has its own setting.
+RAY_CONFIG(int, node_manager_grpc_server_threads, 1)
+RAY_CONFIG(int, core_worker_grpc_server_threads, 1)
+
+/// CPUs to pin the polling threads of gRPC servers to, as a ';' separated list of
+/// "<server name>=<cpu list>" entries, for example
+/// "ObjectManager=2-3;NodeManager=node0". The cpu lists use the Linux cpulist format,
+/// and "node<N>" stands for the CPUs of NUMA node N. Core worker servers are named
+/// after the worker type, such as "worker" or "driver". Servers not listed are not
+/// pinned. Only supported on Linux.
+RAY_CONFIG(std::string, grpc_server_polling_cpus, "")
+
+/// If non-zero, each PeriodicalRunner drives all of its functions from one timer
+/// wheel that ticks every this many milliseconds, rather than from an asio timer per
+/// function. Periods are rounded to the tick.
+RAY_CONFIG(uint64_t, periodical_runner_timer_wheel_tick_ms, 0)
+
+/// The number of finished gRPC client calls of each reply type that are kept for
+/// reuse by later calls, along with their reply messages. 0 allocates every call.
+RAY_CONFIG(uint64_t, grpc_client_call_pool_size, 0)
+
 // The min number of retries for direct actor creation tasks. The actual number
 // of creation retries will be MAX(actor_creation_min_retries, max_restarts).
 RAY_CONFIG(uint64_t, actor_creation_min_retries, 3)
@@ -150,6 +285,14 @@ RAY_CONFIG(int64_t, fetch_warn_timeout_milliseconds, 60000)
 /// Temporary workaround for https://github.com/ray-project/ray/pull/16402.
 RAY_CONFIG(bool, yield_plasma_lock_workaround, true)
 
+/// Whether the workers of a process hosting more than one worker (e.g. Java or C++
+/// workers with `num_workers_per_process` > 1) share one connection to the plasma
+/// store, and so one table of mapped store memory, instead of one each.
+RAY_CONFIG(bool, core_worker_share_plasma_client, false)
+/// The longest a worker blocks in a get on a shared plasma client, so that the other
+/// workers of the process don't wait behind it for the client.
+RAY_CONFIG(int64_t, shared_plasma_client_get_slice_ms, 10)
+
 // Whether to inline object status in serialized references.
 // See https://github.com/ray-project/ray/issues/16025 for more details.
 RAY_CONFIG(bool, inline_object_status_in_refs, true)
@@ -171,6 +314,20 @@ RAY_CONFIG(int64_t, kill_worker_timeout_milliseconds, 100)
 /// starting_worker_timeout_callback() is called.
 RAY_CONFIG(int64_t, worker_register_timeout_seconds, 30)
 
+/// Whether the raylet starts workers with posix_spawnp() instead of fork() and exec().
+/// posix_spawnp() doesn't copy the page tables of the raylet, which makes starting
+/// many workers at once faster when the raylet uses a lot of memory.
+RAY_CONFIG(bool, worker_launch_use_posix_spawn, false)
+
+/// Whether to fork Python workers from a pre-initialized zygote process per job and
+/// runtime env instead of starting a new interpreter for every worker. Not supported
+/// on Windows.
+RAY_CONFIG(bool, worker_zygote_enabled, false)
+
+/// The duration that we wait for a worker zygote to fork a worker before starting
+/// the worker the regular way.
+RAY_CONFIG(int64_t, worker_zygote_fork_timeout_ms, 1000)
+
 /// Allow up to 5 seconds for connecting to Redis.
 RAY_CONFIG(int64_t, redis_db_connect_retries, 50)
 RAY_CONFIG(int64_t, redis_db_connect_wait_milliseconds, 100)
@@ -183,6 +340,21 @@ RAY_CONFIG(int, object_manager_timer_freq_ms, 100)
 /// ObjectManager.
 RAY_CONFIG(int, object_manager_pull_timeout_ms, 10000)
 
+/// The fraction of the memory available for pulls that wait and task argument
+/// bundles must leave free to be activated. Active bundles are only deactivated once
+/// the memory is exceeded, so small changes in the available memory don't make
+/// bundles flap between active and inactive, evicting and re-pulling objects.
+RAY_CONFIG(double, pull_manager_admission_headroom_fraction, 0.05)
+
+/// The number of queued task argument bundles, after the active ones, whose locally
+/// restorable spilled objects are restored ahead of time, so that the tasks don't wait
+/// for the restore once their bundle is activated. 0 disables restoring ahead.
+RAY_CONFIG(uint64_t, pull_manager_restore_ahead_bundles, 0)
+
+/// The fraction of the memory available for pulls that objects restored ahead of time
+/// may take, on top of the memory of the active pulls.
+RAY_CONFIG(double, pull_manager_restore_ahead_fraction, 0.1)
+
 /// Timeout, in milliseconds, to wait until the Push request fails.
 /// Special value:
 /// Negative: waiting infinitely.
@@ -196,6 +368,67 @@ RAY_CONFIG(int, object_manager_push_timeout_ms, 10000)
 /// NOTE(ekl): this has been raised to lower broadcast overheads.
 RAY_CONFIG(uint64_t, object_manager_default_chunk_size, 5 * 1024 * 1024)
 
+/// The maximum chunk size of object pushes. Pushes to nodes with a larger measured
+/// bandwidth-delay product use chunks up to this size, so that fewer messages are
+/// in flight. It must be below max_grpc_message_size. Setting it to at most
+/// object_manager_default_chunk_size disables adaptive chunk sizes.
+RAY_CONFIG(uint64_t, object_manager_max_chunk_size, 64 * 1024 * 1024)
+
+/// The maximum number of objects looked up in a single location request to their
+/// owner. Lookups made while a request to the same owner is in flight are batched
+/// into the next request.
+RAY_CONFIG(int64_t, object_directory_max_lookup_batch_size, 1000)
+
+/// How long the object directory serves locations learned from a lookup or from an
+/// ended location subscription without asking the owner again. 0 disables caching.
+RAY_CONFIG(int64_t, object_directory_location_cache_ttl_ms, 1000)
+
+/// The maximum number of object location updates reported to an owner in a single
+/// request. Updates are buffered per owner, and a later update of the same object
+/// location replaces a buffered one. 0 reports each update in its own request.
+RAY_CONFIG(int64_t, object_directory_max_location_report_batch_size, 0)
+
+/// How long object location updates are buffered before they are reported to their
+/// owner, unless a full batch is buffered earlier.
+RAY_CONFIG(int64_t, object_directory_location_report_interval_ms, 10)
+
+/// Whether to send chunks of objects in the local object store straight from
+/// shared memory, instead of copying them into the push request first.
+RAY_CONFIG(bool, object_manager_zero_copy_push, true)
+
+/// The number of gRPC channels to each remote object manager that pushes are spread
+/// over.
+RAY_CONFIG(int, object_manager_push_connections, 4)
+
+/// Whether each push channel to a remote object manager gets a TCP connection of its
+/// own, so that pushes use several connections in parallel on fast links, and pulls
+/// and frees go through another connection that doesn't queue behind the pushed
+/// chunks. Otherwise, gRPC shares one connection between all the channels.
+RAY_CONFIG(bool, object_manager_separate_connections, false)
+
+/// Object chunks pushed to a node whose measured bandwidth is below this many MB/s are
+/// compressed with zlib on the object manager RPC threads. 0 disables compression.
+RAY_CONFIG(uint64_t, object_manager_compression_max_mbps, 0)
+
+/// Objects of at least this size that are on several nodes are pulled from up
+/// to object_manager_max_pull_stripes of them at once, each node sending an equal
+/// share of the chunks. -1 disables striped pulls.
+RAY_CONFIG(int64_t, object_manager_striped_pull_min_size, 64 * 1024 * 1024)
+
+/// The maximum number of nodes a striped pull fetches the chunks of an object from.
+RAY_CONFIG(int64_t, object_manager_max_pull_stripes, 4)
+
+/// The push bandwidth of a node is shared between the priorities of the pulls that
+/// requested the pushes, such as ray.get() ahead of task argument prefetching.
+/// Each priority gets this many times the bandwidth of the next lower one.
+RAY_CONFIG(int64_t, object_manager_push_priority_weight_ratio, 4)
+
+/// Once a node is pushing an object to this many nodes, further pull requests for
+/// it are redirected to one of those nodes, which forwards each chunk as soon as
+/// it has received it. Objects requested by many nodes are thus broadcast along
+/// a tree. -1 disables this.
+RAY_CONFIG(int64_t, object_manager_max_pushes_per_object, 8)
+
 /// The maximum number of outbound bytes to allow to be outstanding. This avoids
 /// excessive memory usage during object broadcast to many receivers.
 RAY_CONFIG(uint64_t, object_manager_max_bytes_in_flight, 2L * 1024 * 1024 * 1024)
@@ -206,9 +439,45 @@ RAY_CONFIG(uint32_t, maximum_gcs_deletion_batch_size, 1000)
 /// Maximum number of items in one batch to scan/get/delete from GCS storage.
 RAY_CONFIG(uint32_t, maximum_gcs_storage_operation_batch_size, 1000)
 
+/// Whether the gcs server coalesces writes to Redis. While a write batch to a shard is
+/// in flight, further writes to that shard are buffered, repeated writes to a key keep
+/// only the latest value, and the buffer is sent as one MSET once the batch is replied.
+RAY_CONFIG(bool, gcs_storage_coalesce_writes, false)
+
+/// Whether the gcs server keeps the per job index of its Redis tables as one Redis set
+/// per job. Reading or dropping the entries of a job then touches only that job's keys
+/// instead of scanning every key of the table. The index layout is not compatible with
+/// data written with this disabled.
+RAY_CONFIG(bool, gcs_storage_use_index_sets, false)
+
+/// If set, the gcs server keeps its tables in memory and persists them to a local
+/// write-ahead log at this path instead of writing them to Redis.
+RAY_CONFIG(std::string, gcs_storage_file_path, "")
+
+/// The GCS store log is compacted into a snapshot once it grows past this many bytes
+/// (and past twice the size of the last snapshot). 0 disables compaction.
+RAY_CONFIG(uint64_t, gcs_file_store_compaction_bytes, 256 * 1024 * 1024)
+
+/// Whether workers subscribe to the actors of the handles they receive in batches,
+/// through one subscription to the actors of each job, instead of one subscription
+/// and one lookup per actor.
+RAY_CONFIG(bool, batch_actor_subscriptions, false)
+
 /// Maximum number of rows in GCS profile table.
 RAY_CONFIG(int32_t, maximum_profile_table_rows_count, 10 * 1000)
 
+/// How often workers send their buffered profile events to the GCS.
+RAY_CONFIG(int64_t, profile_events_flush_interval_ms, 1000)
+
+/// Workers send their buffered profile events to the GCS early once this many events
+/// are buffered. 0 means they are only sent every profile_events_flush_interval_ms.
+RAY_CONFIG(int64_t, profile_events_max_batch_size, 0)
+
+/// The maximum number of profile events a worker buffers while its previous batch is
+/// still being written to the GCS. Events beyond this are dropped and counted. 0
+/// means the buffered events are dropped whenever the GCS falls behind.
+RAY_CONFIG(int64_t, profile_events_max_buffered, 0)
+
 /// When getting objects from object store, max number of ids to print in the warning
 /// message.
 RAY_CONFIG(uint32_t, object_store_get_max_ids_to_print_in_warning, 20)
@@ -223,12 +492,51 @@ RAY_CONFIG(int64_t, internal_gcs_service_connect_wait_milliseconds, 100)
 /// The interval at which the gcs server will check if redis has gone down.
 /// When this happens, gcs server will kill itself.
 RAY_CONFIG(uint64_t, gcs_redis_heartbeat_interval_milliseconds, 100)
+/// Number of async connections the gcs server opens to each Redis shard. Commands are
+/// spread over the connections by key, so commands on one key keep their order.
+RAY_CONFIG(uint64_t, gcs_redis_connections_per_shard, 1)
+/// Whether to route keys to Redis shards with a consistent hash ring instead of modulo
+/// hashing, so that changing the set of shards only moves a small part of the keys.
+/// Keys written under one routing scheme are not found under the other.
+RAY_CONFIG(bool, gcs_redis_consistent_hash_sharding, false)
 /// Duration to wait between retries for leasing worker in gcs server.
 RAY_CONFIG(uint32_t, gcs_lease_worker_retry_interval_ms, 200)
 /// Duration to wait between retries for creating actor in gcs server.
 RAY_CONFIG(uint32_t, gcs_create_actor_retry_interval_ms, 200)
+/// Whether the gcs server keeps a leased standby worker on another node for each
+/// alive actor that can restart. When the actor fails, it is created on the standby
+/// worker right away instead of leasing a new worker and starting its process. The
+/// standby worker holds the resources of the actor on its node.
+RAY_CONFIG(bool, gcs_actor_standby_worker_enabled, false)
+/// Maximum number of pending actors the gcs server hands to the actor scheduler per
+/// event loop turn when resources change. The rest are scheduled in later turns so
+/// that actor RPCs keep being served while a large backlog drains. 0 means unlimited.
+RAY_CONFIG(uint64_t, gcs_actor_scheduling_batch_size, 0)
+/// Maximum number of actors the gcs server reschedules per event loop turn when it
+/// recovers the actors that were being scheduled before a restart. If set, recovery
+/// starts once the gcs server serves requests, so that nodes can register and
+/// report while the actors are rescheduled. 0 reschedules all of them before the
+/// gcs server starts serving.
+RAY_CONFIG(uint64_t, gcs_actor_recovery_batch_size, 0)
+/// Whether the gcs server loads the tables data into the node, heartbeat, resource,
+/// job and object managers in parallel when it starts.
+RAY_CONFIG(bool, gcs_parallel_manager_initialization, false)
 /// Duration to wait between retries for creating placement group in gcs server.
 RAY_CONFIG(uint32_t, gcs_create_placement_group_retry_interval_ms, 200)
+/// Maximum number of placement groups the gcs server schedules at the same time. The
+/// resources of a placement group are reserved in the gcs view of the cluster as soon
+/// as its bundles are placed, so concurrent placement groups pick different resources,
+/// and a conflict with the actual resources of a raylet fails the prepare phase and
+/// sends the placement group back to the pending queue.
+RAY_CONFIG(uint32_t, gcs_max_concurrent_placement_group_scheduling, 1)
+/// How often the gcs server tries to make room for a pending STRICT_PACK placement
+/// group that fits on no node, by moving the bundles of other placement groups to
+/// other nodes. Only bundles of placement groups whose actors can all restart are
+/// moved. Tasks running in a moved bundle fail as if its node died. 0 disables it.
+RAY_CONFIG(uint32_t, gcs_placement_group_defrag_interval_ms, 0)
+/// Maximum number of bundles the gcs server moves to make room for a placement group
+/// each gcs_placement_group_defrag_interval_ms.
+RAY_CONFIG(uint32_t, gcs_placement_group_defrag_max_bundles, 4)
 /// Maximum number of destroyed actors in GCS server memory cache.
 RAY_CONFIG(uint32_t, maximum_gcs_destroyed_actor_cached_count, 100000)
 /// Maximum number of dead nodes in GCS server memory cache.
@@ -239,11 +547,24 @@ RAY_CONFIG(int64_t, gcs_dump_debug_log_interval_minutes, 1)
 RAY_CONFIG(int, gcs_resource_report_poll_period_ms, 100)
 // The number of concurrent polls to polls to GCS.
 RAY_CONFIG(uint64_t, gcs_max_concurrent_resource_pulls, 100)
+/// If true, the GCS doesn't poll the raylets for resource reports. Instead, each
+/// raylet pushes its report to the GCS if it changed, checking every
+/// `raylet_report_resources_period_milliseconds` with at most one report in flight,
+/// and the GCS coalesces the reports it receives between two broadcasts.
+RAY_CONFIG(bool, raylet_push_resource_reports, false)
+/// If true, a raylet fetches the total resources of all nodes from the GCS in a single
+/// request when it starts, instead of one request per node it learns about from the
+/// initial node table. This speeds up joining a large cluster.
+RAY_CONFIG(bool, raylet_fetch_all_node_resources_on_join, false)
 // Feature flag to use grpc instead of redis for resource broadcast.
 // TODO(ekl) broken as of https://github.com/ray-project/ray/issues/16858
 RAY_CONFIG(bool, grpc_based_resource_broadcast, false)
 // Feature flag to enable grpc based pubsub in GCS.
 RAY_CONFIG(bool, gcs_grpc_based_pubsub, false)
+/// If non-zero, the GCS holds actor, job and node messages for grpc based
+/// subscribers for up to this many milliseconds, so that the messages to one
+/// subscriber go out as one batch. 0 publishes each message as soon as possible.
+RAY_CONFIG(uint64_t, gcs_publish_batch_window_ms, 0)
 
 /// Duration to sleep after failing to put an object in plasma because it is full.
 RAY_CONFIG(uint32_t, object_store_full_delay_ms, 10)
@@ -283,6 +604,16 @@ RAY_CONFIG(uint64_t, gcs_service_address_check_interval_milliseconds, 1000)
 /// The batch size for metrics export.
 RAY_CONFIG(int64_t, metrics_report_batch_size, 100)
 
+/// If positive, every process that initializes stats serves its OpenCensus views in
+/// the Prometheus text format over HTTP at /metrics, without going through the
+/// metrics agent. Processes on the same node take the first free port starting at
+/// this one. 0 disables the endpoint.
+RAY_CONFIG(int64_t, native_metrics_export_port, 0)
+
+/// The number of ports, starting at native_metrics_export_port, a process tries
+/// before giving up on serving metrics natively.
+RAY_CONFIG(int64_t, native_metrics_export_port_range, 64)
+
 /// Whether or not we enable metrics collection.
 RAY_CONFIG(int64_t, enable_metrics_collection, true)
 
@@ -297,6 +628,49 @@ RAY_CONFIG(int64_t, task_rpc_inlined_bytes_limit, 10 * 1024 * 1024)
 /// pipelining task submission.
 RAY_CONFIG(uint32_t, max_tasks_in_flight_per_worker, 1)
 
+/// When max_tasks_in_flight_per_worker > 1, adapt the number of tasks pipelined to each
+/// leased worker so that roughly this many milliseconds of work are queued on it, based
+/// on the measured durations of recent tasks with the same scheduling key. Short tasks
+/// then fill the pipeline, while long tasks are sent one at a time to avoid head-of-line
+/// blocking. A value of 0 always fills the pipeline up to
+/// max_tasks_in_flight_per_worker.
+RAY_CONFIG(int64_t, task_pipeline_target_ms, 0)
+
+/// The maximum number of queued actor tasks that a caller sends to the same actor in
+/// one PushTaskBatch request. Replies to a batch are only delivered once every task in
+/// it has finished, so this should only be raised for actors with many tiny tasks. A
+/// value of 1 sends every task in its own PushTask request.
+RAY_CONFIG(uint32_t, push_task_batch_max_size, 1)
+
+/// The maximum number of borrowed objects whose status a worker asks their owner
+/// about in one GetObjectStatusBatch request. Objects received in the same event loop
+/// tick are batched per owner, and a batch is replied to once every object in it has
+/// been created. A value of 1 sends a GetObjectStatus request per object.
+RAY_CONFIG(uint32_t, get_object_status_batch_max_size, 1)
+
+/// The maximum number of task spec templates that a caller defines on each worker it
+/// pushes tasks to. Once a worker has cached the template of a remote function, later
+/// tasks of that function are sent without their function descriptor, resources and
+/// runtime env. A value of 0 always sends the full task spec.
+RAY_CONFIG(uint32_t, max_task_spec_templates_per_worker, 0)
+
+/// The number of consecutively submitted task specs that a worker allocates from the
+/// same protobuf arena. An arena is freed only once all of its specs are released, so
+/// long-lived specs (e.g., pinned for lineage reconstruction) keep the rest of their
+/// arena alive. A value of 0 allocates every task spec on the heap.
+RAY_CONFIG(uint32_t, task_spec_arena_num_tasks, 0)
+
+/// How long a worker reuses the plasma object it put for a large task argument passed
+/// by value, for later tasks that pass an argument with the same content. Arguments of
+/// at least max_direct_call_object_size bytes are fingerprinted when the task spec is
+/// built. A value of 0 puts each such argument on its own, or inlines it.
+RAY_CONFIG(int64_t, task_arg_dedup_window_ms, 0)
+
+/// Whether an owner may reuse an idle worker lease for queued tasks of another
+/// scheduling key with the same resource shape and runtime env, instead of returning
+/// the worker and requesting a new lease from the raylet.
+RAY_CONFIG(bool, worker_lease_reuse_across_scheduling_keys, true)
+
 /// Interval to restart dashboard agent after the process exit.
 RAY_CONFIG(uint32_t, agent_restart_interval_ms, 1000)
 
@@ -307,10 +681,50 @@ RAY_CONFIG(uint32_t, agent_register_timeout_ms, 30 * 1000)
 /// after this interval.
 RAY_CONFIG(uint32_t, agent_manager_retry_interval_ms, 1000);
 
+/// Whether the raylet shares one request to the agent between the concurrent
+/// creations of the same runtime env for the same job, and reuses a successful
+/// creation until the job finishes.
+RAY_CONFIG(bool, deduplicate_runtime_env_creation, false)
+
+/// Whether the raylet rebinds an idle worker of a finished job to a new job with the
+/// same language, runtime env and worker options, instead of starting a new worker
+/// process. The workers of finished jobs are then kept within the soft limit.
+RAY_CONFIG(bool, reuse_workers_across_jobs, false)
+
+/// Whether the raylet runs one scheduling pass for all the lease requests and
+/// unblocked tasks that arrive within one turn of its event loop, instead of one
+/// pass per request.
+RAY_CONFIG(bool, coalesce_scheduling_passes, false)
+
+/// Whether the raylet only checks whether infeasible tasks became feasible after the
+/// resource total of some node grew, instead of on every scheduling pass.
+RAY_CONFIG(bool, skip_unchanged_infeasible_checks, false)
+
+/// Whether the raylet dispatches the queued tasks of each resource shape by weighted
+/// fair share across jobs, see `JobConfig.scheduling_weight`, instead of in the order
+/// they were queued.
+RAY_CONFIG(bool, fair_share_scheduling_across_jobs, false)
+
+/// Whether the raylet kills the worker of a retriable normal task of lower priority,
+/// when a task of higher priority does not fit on the node or any other node. The
+/// owner of the killed task retries it.
+RAY_CONFIG(bool, preempt_lower_priority_tasks, false)
+
+/// Whether the raylet discovers the NVLink and PCIe topology of its GPUs at start, with
+/// `nvidia-smi topo -m`, and gives tasks that need several GPUs the closest ones.
+RAY_CONFIG(bool, gpu_topology_aware_allocation, false)
+
 /// The maximum number of resource shapes included in the resource
 /// load reported by each raylet.
 RAY_CONFIG(int64_t, max_resource_shapes_per_load_report, 100)
 
+/// If true, a raylet reports one demand entry per resource shape, summing the queues
+/// of all scheduling classes with that shape. If there are more shapes than
+/// `max_resource_shapes_per_load_report`, the quantities of the shapes are rounded
+/// up to coarser and coarser powers of two until the shapes fit, rather than the
+/// extra shapes being dropped from the report.
+RAY_CONFIG(bool, compact_resource_load_report, false)
+
 /// If true, the worker's queue backlog size will be propagated to the heartbeat batch
 /// data.
 RAY_CONFIG(bool, report_worker_backlog, true)
@@ -328,6 +742,11 @@ RAY_CONFIG(uint64_t, kill_idle_workers_interval_ms, 200)
 /// The idle time threshold for an idle worker to be killed.
 RAY_CONFIG(int64_t, idle_worker_killing_time_threshold_ms, 1000)
 
+/// The weight of the latest interval in the moving average of worker demand per job
+/// and runtime env. The average is used to prestart workers and to keep idle workers
+/// alive ahead of the leases we expect. Value of 0 means the demand is not tracked.
+RAY_CONFIG(double, worker_demand_ewma_alpha, 0)
+
 // The interval where metrics are exported in milliseconds.
 RAY_CONFIG(uint64_t, metrics_report_interval_ms, 10000)
 
@@ -363,13 +782,87 @@ RAY_CONFIG(int64_t, min_spilling_size, 100 * 1024 * 1024)
 /// take more than this percentage of the available memory.
 RAY_CONFIG(float, object_spilling_threshold, 0.8)
 
+/// If above 0, the raylet spills objects in the background once the bytes of the
+/// objects in the object store plus the bytes of the creates waiting for space go
+/// above this fraction of the object store memory, and keeps spilling until they
+/// go below object_spilling_low_watermark. This keeps spilling ahead of object
+/// creation, instead of starting it when creates block. 0 disables it.
+RAY_CONFIG(float, object_spilling_high_watermark, 0)
+
+/// The fraction of the object store memory that background spilling brings the
+/// usage down to. See object_spilling_high_watermark.
+RAY_CONFIG(float, object_spilling_low_watermark, 0.6)
+
+/// The period of the object store usage checks of background spilling.
+RAY_CONFIG(uint64_t, object_spilling_watermark_check_period_ms, 100)
+
 /// Maximum number of objects that can be fused into a single file.
 RAY_CONFIG(int64_t, max_fused_object_count, 2000)
 
+/// The maximum number of primary copies that a draining raylet migrates to other
+/// nodes at the same time.
+RAY_CONFIG(int64_t, object_migration_max_in_flight, 16)
+/// The maximum total size of the primary copies that a draining raylet migrates at
+/// the same time. A larger object is still migrated on its own.
+RAY_CONFIG(int64_t, object_migration_max_bytes_in_flight, 256 * 1024 * 1024)
+/// How long a draining raylet waits for another node to pin a migrated copy before
+/// it keeps the copy pinned itself.
+RAY_CONFIG(int64_t, object_migration_timeout_ms, 60000)
+
+/// The maximum number of bytes of compressed objects the raylet keeps in its own
+/// memory. When the object store is full, primary copies that compress well are
+/// compressed into this tier before any object is spilled, and they are restored
+/// from it without an IO worker. 0 disables the tier.
+RAY_CONFIG(int64_t, object_compression_tier_size, 0)
+
+/// Only objects that shrink by at least this factor are kept in the compression
+/// tier. The others are spilled as usual.
+RAY_CONFIG(double, object_compression_min_ratio, 2.0)
+
+/// Objects larger than this are never compressed, because compression runs on
+/// the raylet's main thread.
+RAY_CONFIG(int64_t, object_compression_max_object_size, 16 * 1024 * 1024)
+
+/// Comma separated list of local directories that the raylet spills objects to
+/// and restores them from itself, without IO workers. If set, this takes
+/// precedence over object_spilling_config. Empty to spill through IO workers.
+RAY_CONFIG(std::string, native_object_spilling_directories, "")
+
+/// The number of threads of the raylet that read and write spilled files in each
+/// of the native_object_spilling_directories. Every directory is assumed to be a
+/// separate device, with its own queue of reads and writes.
+RAY_CONFIG(int, native_object_spilling_io_threads, 2)
+
+/// With native object spilling, a fused file larger than this is written as
+/// several parts of about this size, in parallel on the IO threads of its
+/// directory. This helps storage that is faster with concurrent writes, like
+/// network filesystems and mounted object stores. 0 writes every file as a
+/// single part.
+RAY_CONFIG(uint64_t, native_object_spilling_part_size, 0)
+
+/// With native object spilling, a file of fused spilled objects is compacted once
+/// this fraction of its bytes belongs to freed objects: its remaining objects are
+/// rewritten into a new file, and the old file is deleted. 0 disables compaction,
+/// so that a file is only deleted once all of its objects are freed.
+RAY_CONFIG(double, spilled_file_compaction_dead_ratio, 0)
+
 /// Grace period until we throw the OOM error to the application in seconds.
 /// In unlimited allocation mode, this is the time delay prior to fallback allocating.
 RAY_CONFIG(int64_t, oom_grace_period_s, 2)
 
+/// The fraction of the memory of the node (or of its memory cgroup) in use, including
+/// memory outside of the object store, above which the raylet stops dispatching tasks
+/// to workers and prestarting workers, and other raylets avoid spilling tasks to it.
+/// 0 disables this check.
+RAY_CONFIG(double, raylet_memory_pressure_usage_threshold, 0)
+/// The percentage of time over the last 10 seconds in which some tasks of the node
+/// stalled waiting for memory ("some avg10" of the memory pressure stall information),
+/// above which the node is under memory pressure as above. 0 disables this check.
+RAY_CONFIG(double, raylet_memory_pressure_stall_threshold, 0)
+/// How often the raylet samples the memory use of the node when one of the thresholds
+/// above is set.
+RAY_CONFIG(uint64_t, raylet_memory_monitor_interval_ms, 250)
+
 /// Whether or not the external storage is file system.
 /// This is configured based on object_spilling_config.
 RAY_CONFIG(bool, is_external_storage_type_fs, true)
@@ -379,6 +872,20 @@ RAY_CONFIG(bool, is_external_storage_type_fs, true)
 /// dependency locality when choosing a worker for leasing.
 RAY_CONFIG(bool, locality_aware_leasing_enabled, true)
 
+/// Locality-aware leasing doesn't prefer a node for holding more than this many bytes
+/// of the task's arguments, so that the load of the nodes decides between nodes that
+/// both hold at least this much. 0 for no cap.
+RAY_CONFIG(uint64_t, locality_aware_leasing_max_locality_bytes, 0)
+
+/// How many bytes of the task's arguments a fully loaded node is worth less than an
+/// idle node to locality-aware leasing, so that tasks aren't all sent to an overloaded
+/// node that holds their arguments. 0 to ignore the load of the nodes.
+RAY_CONFIG(uint64_t, locality_aware_leasing_load_penalty_bytes, 0)
+
+/// The interval at which the workers refresh the node loads used by locality-aware
+/// leasing, if the load penalty is enabled.
+RAY_CONFIG(uint64_t, locality_aware_leasing_load_refresh_ms, 1000)
+
 /* Configuration parameters for logging */
 /// Parameters for log rotation. This value is equivalent to RotatingFileHandler's
 /// maxBytes argument.
@@ -396,9 +903,43 @@ RAY_CONFIG(int64_t, timeout_ms_task_wait_for_death_info, 1000)
 /// Maximum amount of memory that will be used by running tasks' args.
 RAY_CONFIG(float, max_task_args_memory_fraction, 0.7)
 
+/// The number of shards in each core worker's in-memory object store. Objects
+/// are assigned to shards by ID and each shard has its own lock, so that puts
+/// from RPC handlers and gets from user threads on different objects do not
+/// contend.
+RAY_CONFIG(uint64_t, memory_store_num_shards, 1)
+
+/// If non-zero, the number of bytes of inlined objects a core worker keeps in
+/// its in-memory store. Above this, the oldest objects that the worker owns are
+/// promoted to plasma until usage falls to 80% of the limit. 0 means no limit.
+RAY_CONFIG(int64_t, memory_store_max_bytes, 0)
+
+/// If non-zero, the concurrency groups of a threaded actor share one pool of this
+/// many threads instead of each group owning max_concurrency threads. Each
+/// group's max_concurrency remains a limit on how many of its tasks run at
+/// once. If the pool is smaller than the sum of the groups' limits, tasks that
+/// block can hold up other groups.
+RAY_CONFIG(int64_t, actor_concurrency_groups_shared_pool_size, 0)
+
+/// If non-zero, the stack size in bytes of each fiber that runs an async actor
+/// call. Fiber stacks are then pooled and reused. 0 uses the boost default
+/// allocator, which maps a fresh stack for every call.
+RAY_CONFIG(uint64_t, async_actor_fiber_stack_size, 0)
+
 /// The maximum number of objects to publish for each publish calls.
 RAY_CONFIG(int, publish_batch_size, 5000)
 
+/// If non-zero, core workers hold published object notifications (e.g. a
+/// borrower telling an owner that it dropped its reference) for up to this many
+/// milliseconds so that notifications to the same owner go out as one batch.
+/// 0 publishes each notification as soon as possible.
+RAY_CONFIG(uint64_t, worker_publish_batch_window_ms, 0)
+
+/// If true, an object locations update that core workers haven't sent yet is
+/// replaced by a newer update of the same object, so subscribers only receive the
+/// latest locations.
+RAY_CONFIG(bool, worker_publish_coalesce_superseded_messages, false)
+
 /// The maximum command batch size.
 RAY_CONFIG(int64_t, max_command_batch_size, 2000)
 
@@ -420,6 +961,11 @@ RAY_CONFIG(uint32_t, max_error_msg_size_bytes, 512 * 1024)
 /// If enabled, raylet will report resources only when resources are changed.
 RAY_CONFIG(bool, enable_light_weight_resource_report, true)
 
+/// When light weight resource reports are enabled, every this many reports of a
+/// raylet carry all of its resources rather than only the ones that changed. This
+/// lets receivers that missed a report converge.
+RAY_CONFIG(uint64_t, resource_report_full_snapshot_interval, 10)
+
 // The number of seconds to wait for the Raylet to start. This is normally
 // fast, but when RAY_preallocate_plasma_memory=1 is set, it may take some time
 // (a few GB/s) to populate all the pages on Raylet startup.
@@ -442,6 +988,11 @@ RAY_CONFIG(std::string, custom_unit_instance_resources, "")
 // Maximum size of the batches when broadcasting resources to raylet.
 RAY_CONFIG(uint64_t, resource_broadcast_batch_size, 512);
 
+// The maximum number of raylets the GCS (and each relaying raylet) sends a resource
+// broadcast to directly. The remaining raylets receive it through a relay tree of
+// this fanout. 0 means the GCS sends the broadcast to every raylet itself.
+RAY_CONFIG(uint64_t, resource_broadcast_fanout, 0);
+
 // If enabled and worker stated in container, the container will add
 // resource limit.
 RAY_CONFIG(bool, worker_resource_limits_enabled, false)
@@ -449,6 +1000,25 @@ RAY_CONFIG(bool, worker_resource_limits_enabled, false)
 /// ServerCall instance number of each RPC service handler
 RAY_CONFIG(int64_t, gcs_max_active_rpcs_per_handler, 100)
 
+/// Number of gcs server completion queues and polling threads reserved for liveness
+/// RPCs, so that a flood of other requests can't delay heartbeats. 0 means liveness
+/// RPCs share the other completion queues.
+RAY_CONFIG(uint32_t, gcs_server_priority_rpc_thread_num, 0)
+
+/// Bulk read RPCs to the gcs server, such as GetAllActorInfo, that waited longer than
+/// this in the event loop are rejected instead of handled. -1 means they are never
+/// rejected.
+RAY_CONFIG(int64_t, gcs_bulk_read_rpc_shed_queueing_ms, -1)
+
+/// Page size used by the gcs client to fetch all actors, nodes or jobs. Smaller pages
+/// bound the size of each reply the gcs server builds. 0 means everything is fetched
+/// in a single reply.
+RAY_CONFIG(int64_t, gcs_bulk_query_page_size, 0)
+
+/// Whether the gcs client serves actor and job lookups from the data it keeps up to
+/// date through its subscriptions, instead of asking the gcs server.
+RAY_CONFIG(bool, gcs_client_cache_enabled, false)
+
 /// grpc keepalive sent interval
 /// This is only configured in GCS server now.
 /// NOTE: It is not ideal for other components because
@@ -462,3 +1032,8 @@ RAY_CONFIG(int64_t, grpc_keepalive_timeout_ms, 20000);
 
 /// Whether to use log reporter in event framework
 RAY_CONFIG(bool, event_log_reporter_enabled, false)
+
+/// If positive, events are written to the event log by a background thread in
+/// batches, and up to this many events wait to be written. Events are dropped when
+/// the queue is full. If 0, events are written by the thread that reports them.
+RAY_CONFIG(int64_t, event_reporter_queue_size, 0)
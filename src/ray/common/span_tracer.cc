@@ -0,0 +1,148 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/span_tracer.h"
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+
+#include "ray/common/ray_config.h"
+#include "ray/util/filesystem.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace {
+
+int GetPid() {
+#ifdef _WIN32
+  return _getpid();
+#else
+  return getpid();
+#endif
+}
+
+}  // namespace
+
+SpanTracer &SpanTracer::Instance() {
+  // Leaked, so that spans can be recorded by threads that outlive static destruction.
+  static auto *instance = new SpanTracer();
+  return *instance;
+}
+
+void SpanTracer::Start(const std::string &component, const std::string &log_dir) {
+  if (!RayConfig::instance().span_tracing_enabled()) {
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  component_ = component;
+  log_dir_ = log_dir;
+  capacity_ = std::max<uint64_t>(RayConfig::instance().span_tracing_buffer_size(), 1);
+  spans_.clear();
+  spans_.reserve(capacity_);
+  next_ = 0;
+  enabled_.store(true);
+  RAY_LOG(INFO) << "Span tracing is enabled for " << component << ", keeping the last "
+                << capacity_ << " spans.";
+}
+
+void SpanTracer::Record(const char *name, const TaskID &task_id, int64_t start_time_ns,
+                        int64_t end_time_ns) {
+  if (!IsEnabled()) {
+    return;
+  }
+  Span span{name, task_id, start_time_ns, end_time_ns,
+            std::hash<std::thread::id>()(std::this_thread::get_id())};
+  absl::MutexLock lock(&mutex_);
+  if (spans_.size() < capacity_) {
+    spans_.push_back(span);
+  } else {
+    spans_[next_] = span;
+  }
+  next_ = (next_ + 1) % capacity_;
+}
+
+std::vector<Span> SpanTracer::GetSpans() const {
+  absl::MutexLock lock(&mutex_);
+  if (spans_.size() < capacity_) {
+    return spans_;
+  }
+  std::vector<Span> spans;
+  spans.reserve(spans_.size());
+  spans.insert(spans.end(), spans_.begin() + next_, spans_.end());
+  spans.insert(spans.end(), spans_.begin(), spans_.begin() + next_);
+  return spans;
+}
+
+std::string SpanTracer::ToChromeTrace(const std::string &component, int pid,
+                                      const std::vector<Span> &spans) {
+  // Spans are complete ("X") events with microsecond timestamps. The task ID is both an
+  // argument, to search by, and the flow ID, so that Perfetto links the spans of a
+  // task across processes.
+  std::stringstream json;
+  json << "{\"traceEvents\":[{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+       << ",\"args\":{\"name\":\"" << component << " " << pid << "\"}}";
+  for (const auto &span : spans) {
+    const auto task_id = span.task_id.Hex();
+    json << ",\n{\"name\":\"" << span.name << "\",\"cat\":\"" << component
+         << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << span.thread_id
+         << ",\"ts\":" << span.start_time_ns / 1000
+         << ",\"dur\":" << (span.end_time_ns - span.start_time_ns) / 1000
+         << ",\"bind_id\":\"" << task_id << "\",\"flow_in\":true,\"flow_out\":true"
+         << ",\"args\":{\"task_id\":\"" << task_id << "\"}}";
+  }
+  json << "]}\n";
+  return json.str();
+}
+
+Status SpanTracer::Dump() {
+  if (!IsEnabled()) {
+    return Status::OK();
+  }
+  std::string component;
+  std::string log_dir;
+  {
+    absl::MutexLock lock(&mutex_);
+    component = component_;
+    log_dir = log_dir_;
+  }
+  const int pid = GetPid();
+  const auto path =
+      JoinPaths(log_dir, "spans_" + component + "_" + std::to_string(pid) + ".json");
+  const auto tmp_path = path + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::trunc);
+    file << ToChromeTrace(component, pid, GetSpans());
+    if (!file.good()) {
+      return Status::IOError("Failed to write spans to " + tmp_path);
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    return Status::IOError("Failed to rename " + tmp_path + " to " + path);
+  }
+  RAY_LOG(INFO) << "Wrote spans to " << path;
+  return Status::OK();
+}
+
+}  // namespace ray
@@ -0,0 +1,113 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "ray/common/id.h"
+#include "ray/common/status.h"
+
+namespace ray {
+
+/// A timed step of the lifecycle of a task in this process.
+struct Span {
+  /// The name of the step. It must be a string literal.
+  const char *name;
+  /// The task the step belongs to. It is the key that correlates the spans of a task
+  /// across processes.
+  TaskID task_id;
+  int64_t start_time_ns;
+  int64_t end_time_ns;
+  uint64_t thread_id;
+};
+
+/// \class SpanTracer
+///
+/// Records the spans of the tasks that go through this process into a ring buffer of the
+/// most recent `span_tracing_buffer_size` spans, and writes them as a Chrome trace
+/// event file that can be opened in Perfetto. The spans of one node are written to its
+/// log directory, one file per process, and their timestamps come from the wall clock,
+/// so the files of a node can be loaded together.
+///
+/// The tracer is disabled until Start() is called. A disabled tracer records nothing.
+///
+/// This class is thread safe.
+class SpanTracer {
+ public:
+  static SpanTracer &Instance();
+
+  /// Start recording spans, if `span_tracing_enabled` is set.
+  ///
+  /// \param component The name of this process in the trace, e.g. "raylet".
+  /// \param log_dir The directory that Dump() writes to.
+  void Start(const std::string &component, const std::string &log_dir);
+
+  bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  /// Record a span. Does nothing if the tracer is disabled.
+  void Record(const char *name, const TaskID &task_id, int64_t start_time_ns,
+              int64_t end_time_ns);
+
+  /// Write the recorded spans to `spans_<component>_<pid>.json` in the log directory,
+  /// replacing the file of a previous dump. Does nothing if the tracer is disabled.
+  Status Dump();
+
+  /// Format spans as a Chrome trace event JSON document.
+  static std::string ToChromeTrace(const std::string &component, int pid,
+                                   const std::vector<Span> &spans);
+
+  /// Return the recorded spans, oldest first.
+  std::vector<Span> GetSpans() const;
+
+ private:
+  SpanTracer() = default;
+
+  std::atomic<bool> enabled_{false};
+  mutable absl::Mutex mutex_;
+  std::string component_ GUARDED_BY(mutex_);
+  std::string log_dir_ GUARDED_BY(mutex_);
+  /// The ring buffer. Once it is full, `next_` is the position of the oldest span.
+  std::vector<Span> spans_ GUARDED_BY(mutex_);
+  size_t capacity_ GUARDED_BY(mutex_) = 0;
+  size_t next_ GUARDED_BY(mutex_) = 0;
+};
+
+/// Record a span for the lifetime of this object.
+class ScopedSpan {
+ public:
+  ScopedSpan(const char *name, const TaskID &task_id)
+      : name_(name),
+        task_id_(task_id),
+        start_time_ns_(SpanTracer::Instance().IsEnabled() ? absl::GetCurrentTimeNanos()
+                                                          : 0) {}
+
+  ~ScopedSpan() {
+    if (start_time_ns_ != 0) {
+      SpanTracer::Instance().Record(name_, task_id_, start_time_ns_,
+                                    absl::GetCurrentTimeNanos());
+    }
+  }
+
+ private:
+  const char *name_;
+  const TaskID task_id_;
+  const int64_t start_time_ns_;
+};
+
+}  // namespace ray
@@ -14,6 +14,8 @@
 
 #include "ray/common/task/task_spec.h"
 
+#include <array>
+#include <atomic>
 #include <boost/functional/hash.hpp>
 #include <sstream>
 
@@ -22,40 +24,120 @@
 
 namespace ray {
 
-absl::Mutex TaskSpecification::mutex_;
-std::unordered_map<SchedulingClassDescriptor, SchedulingClass>
-    TaskSpecification::sched_cls_to_id_;
-std::unordered_map<SchedulingClass, SchedulingClassDescriptor>
-    TaskSpecification::sched_id_to_cls_;
-int TaskSpecification::next_sched_id_;
+namespace {
+
+/// Scheduling classes are interned in a table that is split into shards by the hash
+/// of the descriptor. Lookups of known classes only take a reader lock on one shard,
+/// and the hash of a descriptor is computed once per lookup.
+constexpr size_t kNumSchedulingClassShards = 16;
+
+/// Descriptors are stored by id in chunks that are never freed or moved, so looking up
+/// the descriptor of an id doesn't take a lock.
+constexpr int kSchedulingClassChunkSize = 1024;
+constexpr int kMaxSchedulingClassChunks = 1024;
+
+struct SchedulingClassShard {
+  absl::Mutex mutex;
+  /// The hash of a descriptor to the ids of the descriptors with that hash.
+  std::unordered_map<size_t, std::vector<SchedulingClass>> ids_by_hash GUARDED_BY(mutex);
+};
+
+struct SchedulingClassChunk {
+  std::array<std::atomic<SchedulingClassDescriptor *>, kSchedulingClassChunkSize> slots;
+};
+
+struct SchedulingClassTable {
+  std::array<SchedulingClassShard, kNumSchedulingClassShards> shards;
+  std::array<std::atomic<SchedulingClassChunk *>, kMaxSchedulingClassChunks> chunks;
+  /// Serializes the assignment of new ids.
+  absl::Mutex next_id_mutex;
+  SchedulingClass next_id GUARDED_BY(next_id_mutex) = 0;
+};
+
+/// The table is never destroyed, since other static destructors may still use it.
+SchedulingClassTable &GetSchedulingClassTable() {
+  static SchedulingClassTable *table = new SchedulingClassTable();
+  return *table;
+}
+
+SchedulingClassDescriptor *FindSchedulingClassDescriptor(SchedulingClass id) {
+  if (id <= 0 || id > kSchedulingClassChunkSize * kMaxSchedulingClassChunks) {
+    return nullptr;
+  }
+  int index = id - 1;
+  auto *chunk = GetSchedulingClassTable()
+                    .chunks[index / kSchedulingClassChunkSize]
+                    .load(std::memory_order_acquire);
+  if (chunk == nullptr) {
+    return nullptr;
+  }
+  return chunk->slots[index % kSchedulingClassChunkSize].load(std::memory_order_acquire);
+}
+
+SchedulingClass FindSchedulingClass(const std::vector<SchedulingClass> &ids,
+                                    const ResourceSet &sched_cls) {
+  for (SchedulingClass id : ids) {
+    if (*FindSchedulingClassDescriptor(id) == sched_cls) {
+      return id;
+    }
+  }
+  return 0;
+}
+
+}  // namespace
 
 SchedulingClassDescriptor &TaskSpecification::GetSchedulingClassDescriptor(
     SchedulingClass id) {
-  absl::MutexLock lock(&mutex_);
-  auto it = sched_id_to_cls_.find(id);
-  RAY_CHECK(it != sched_id_to_cls_.end()) << "invalid id: " << id;
-  return it->second;
+  auto *descriptor = FindSchedulingClassDescriptor(id);
+  RAY_CHECK(descriptor != nullptr) << "invalid id: " << id;
+  return *descriptor;
 }
 
 SchedulingClass TaskSpecification::GetSchedulingClass(const ResourceSet &sched_cls) {
-  SchedulingClass sched_cls_id;
-  absl::MutexLock lock(&mutex_);
-  auto it = sched_cls_to_id_.find(sched_cls);
-  if (it == sched_cls_to_id_.end()) {
-    sched_cls_id = ++next_sched_id_;
-    // TODO(ekl) we might want to try cleaning up task types in these cases
-    if (sched_cls_id > 100) {
-      RAY_LOG(WARNING) << "More than " << sched_cls_id
-                       << " types of tasks seen, this may reduce performance.";
-    } else if (sched_cls_id > 1000) {
-      RAY_LOG(ERROR) << "More than " << sched_cls_id
-                     << " types of tasks seen, this may reduce performance.";
+  auto &table = GetSchedulingClassTable();
+  size_t hash = std::hash<ResourceSet>()(sched_cls);
+  auto &shard = table.shards[hash % kNumSchedulingClassShards];
+  {
+    absl::ReaderMutexLock lock(&shard.mutex);
+    auto it = shard.ids_by_hash.find(hash);
+    if (it != shard.ids_by_hash.end()) {
+      SchedulingClass sched_cls_id = FindSchedulingClass(it->second, sched_cls);
+      if (sched_cls_id != 0) {
+        return sched_cls_id;
+      }
     }
-    sched_cls_to_id_[sched_cls] = sched_cls_id;
-    sched_id_to_cls_[sched_cls_id] = sched_cls;
-  } else {
-    sched_cls_id = it->second;
   }
+
+  absl::MutexLock lock(&shard.mutex);
+  auto &ids = shard.ids_by_hash[hash];
+  // Another thread may have added the class since the lookup above.
+  SchedulingClass sched_cls_id = FindSchedulingClass(ids, sched_cls);
+  if (sched_cls_id != 0) {
+    return sched_cls_id;
+  }
+  {
+    absl::MutexLock id_lock(&table.next_id_mutex);
+    sched_cls_id = ++table.next_id;
+    RAY_CHECK(sched_cls_id <= kSchedulingClassChunkSize * kMaxSchedulingClassChunks)
+        << "Too many types of tasks seen: " << sched_cls_id;
+    int index = sched_cls_id - 1;
+    auto &chunk = table.chunks[index / kSchedulingClassChunkSize];
+    if (chunk.load(std::memory_order_relaxed) == nullptr) {
+      chunk.store(new SchedulingClassChunk(), std::memory_order_release);
+    }
+    chunk.load(std::memory_order_relaxed)
+        ->slots[index % kSchedulingClassChunkSize]
+        .store(new SchedulingClassDescriptor(sched_cls), std::memory_order_release);
+  }
+  // TODO(ekl) we might want to try cleaning up task types in these cases
+  if (sched_cls_id > 100) {
+    RAY_LOG(WARNING) << "More than " << sched_cls_id
+                     << " types of tasks seen, this may reduce performance.";
+  } else if (sched_cls_id > 1000) {
+    RAY_LOG(ERROR) << "More than " << sched_cls_id
+                   << " types of tasks seen, this may reduce performance.";
+  }
+  ids.push_back(sched_cls_id);
   return sched_cls_id;
 }
 
@@ -78,12 +160,12 @@ void TaskSpecification::ComputeResources() {
     required_resources_.reset(new ResourceSet(MapFromProtobuf(required_resources)));
   }
 
-  auto &required_placement_resources = message_->required_placement_resources().empty()
-                                           ? required_resources
-                                           : message_->required_placement_resources();
+  auto &required_placement_resources = message_->required_placement_resources();
 
   if (required_placement_resources.empty()) {
-    required_placement_resources_ = ResourceSet::Nil();
+    // The placement resources default to the required resources, share them instead
+    // of parsing them again.
+    required_placement_resources_ = required_resources_;
   } else {
     required_placement_resources_.reset(
         new ResourceSet(MapFromProtobuf(required_placement_resources)));
@@ -94,8 +176,7 @@ void TaskSpecification::ComputeResources() {
     // the actor tasks need not be scheduled.
 
     // Map the scheduling class descriptor to an integer for performance.
-    auto sched_cls = GetRequiredPlacementResources();
-    sched_cls_id_ = GetSchedulingClass(sched_cls);
+    sched_cls_id_ = GetSchedulingClass(GetRequiredPlacementResources());
   }
 }
 
@@ -333,11 +414,42 @@ std::string TaskSpecification::ConcurrencyGroupName() const {
   return message_->concurrency_group_name();
 }
 
+bool TaskSpecification::IsGangTask() const { return !message_->gang_id().empty(); }
+
+std::string TaskSpecification::GangId() const {
+  RAY_CHECK(IsGangTask());
+  return message_->gang_id();
+}
+
+int32_t TaskSpecification::GangSize() const {
+  RAY_CHECK(IsGangTask());
+  return message_->gang_size();
+}
+
+int32_t TaskSpecification::Priority() const { return message_->priority(); }
+
+bool TaskSpecification::IsStreamingGenerator() const {
+  return message_->streaming_generator();
+}
+
+ObjectID TaskSpecification::GeneratorItemId(int64_t item_index) const {
+  return ObjectID::FromIndex(TaskId(), NumReturns() + 1 + item_index);
+}
+
+bool TaskSpecification::IsRetriable() const {
+  return IsNormalTask() && message_->max_retries() != 0;
+}
+
 bool TaskSpecification::IsAsyncioActor() const {
   RAY_CHECK(IsActorCreationTask());
   return message_->actor_creation_task_spec().is_asyncio();
 }
 
+bool TaskSpecification::ExecuteOutOfOrder() const {
+  RAY_CHECK(IsActorCreationTask());
+  return message_->actor_creation_task_spec().execute_out_of_order();
+}
+
 bool TaskSpecification::IsDetachedActor() const {
   return IsActorCreationTask() && message_->actor_creation_task_spec().is_detached();
 }
@@ -218,6 +218,8 @@ class TaskSpecification : public MessageWrapper<rpc::TaskSpec> {
 
   bool IsAsyncioActor() const;
 
+  bool ExecuteOutOfOrder() const;
+
   bool IsDetachedActor() const;
 
   ObjectID ActorDummyObject() const;
@@ -244,6 +246,31 @@ class TaskSpecification : public MessageWrapper<rpc::TaskSpec> {
 
   std::string ConcurrencyGroupName() const;
 
+  /// Whether this task belongs to a gang of tasks that are scheduled together.
+  bool IsGangTask() const;
+
+  /// The ID of the gang of this task. Only valid if `IsGangTask()`.
+  std::string GangId() const;
+
+  /// The number of tasks in the gang of this task. Only valid if `IsGangTask()`.
+  int32_t GangSize() const;
+
+  /// The priority of this task, higher is more important.
+  int32_t Priority() const;
+
+  /// Whether the task is retried if its worker dies, so that the raylet may preempt it.
+  bool IsRetriable() const;
+
+  /// Whether the task is a streaming generator, whose yielded objects are reported to
+  /// the owner one by one while it runs.
+  bool IsStreamingGenerator() const;
+
+  /// The ID of an object a streaming generator task yielded. These follow the IDs of
+  /// the regular return objects.
+  ///
+  /// \param item_index The index of the yielded object, starting from 0.
+  ObjectID GeneratorItemId(int64_t item_index) const;
+
  private:
   void ComputeResources();
 
@@ -253,18 +280,9 @@ class TaskSpecification : public MessageWrapper<rpc::TaskSpec> {
   std::shared_ptr<ResourceSet> required_resources_;
   /// Field storing required placement resources. Initialized in constructor.
   std::shared_ptr<ResourceSet> required_placement_resources_;
-  /// Cached scheduling class of this task.
+  /// Cached scheduling class of this task. It is copied along with the spec, so the
+  /// class is only looked up when a spec is built or received.
   SchedulingClass sched_cls_id_;
-
-  /// Below static fields could be mutated in `ComputeResources` concurrently due to
-  /// multi-threading, we need a mutex to protect it.
-  static absl::Mutex mutex_;
-  /// Keep global static id mappings for SchedulingClass for performance.
-  static std::unordered_map<SchedulingClassDescriptor, SchedulingClass> sched_cls_to_id_
-      GUARDED_BY(mutex_);
-  static std::unordered_map<SchedulingClass, SchedulingClassDescriptor> sched_id_to_cls_
-      GUARDED_BY(mutex_);
-  static int next_sched_id_ GUARDED_BY(mutex_);
 };
 
 /// \class WorkerCacheKey
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <google/protobuf/arena.h>
+
 #include "ray/common/buffer.h"
 #include "ray/common/ray_object.h"
 #include "ray/common/task/task_spec.h"
@@ -59,6 +61,8 @@ class TaskArgByValue : public TaskArg {
     RAY_CHECK(value) << "Value can't be null.";
   }
 
+  const std::shared_ptr<RayObject> &GetValue() const { return value_; }
+
   void ToProto(rpc::TaskArg *arg_proto) const {
     if (value_->HasData()) {
       const auto &data = value_->GetData();
@@ -83,6 +87,22 @@ class TaskSpecBuilder {
  public:
   TaskSpecBuilder() : message_(std::make_shared<rpc::TaskSpec>()) {}
 
+  /// Build the task spec in the given arena, which saves the many small heap
+  /// allocations of a task spec. The arena is kept alive until every task spec built
+  /// in it has been released.
+  ///
+  /// \param arena The arena to allocate the spec from. If null, the spec is allocated
+  /// on the heap.
+  explicit TaskSpecBuilder(std::shared_ptr<google::protobuf::Arena> arena) {
+    if (arena == nullptr) {
+      message_ = std::make_shared<rpc::TaskSpec>();
+    } else {
+      message_ = std::shared_ptr<rpc::TaskSpec>(
+          google::protobuf::Arena::CreateMessage<rpc::TaskSpec>(arena.get()),
+          [arena](rpc::TaskSpec *) {});
+    }
+  }
+
   /// Build the `TaskSpecification` object.
   TaskSpecification Build() { return TaskSpecification(message_); }
 
@@ -172,7 +192,7 @@ class TaskSpecBuilder {
       int max_concurrency = 1, bool is_detached = false, std::string name = "",
       std::string ray_namespace = "", bool is_asyncio = false,
       const std::vector<ConcurrencyGroup> &concurrency_groups = {},
-      const std::string &extension_data = "") {
+      const std::string &extension_data = "", bool execute_out_of_order = false) {
     message_->set_type(TaskType::ACTOR_CREATION_TASK);
     auto actor_creation_spec = message_->mutable_actor_creation_task_spec();
     actor_creation_spec->set_actor_id(actor_id.Binary());
@@ -186,6 +206,7 @@ class TaskSpecBuilder {
     actor_creation_spec->set_name(name);
     actor_creation_spec->set_ray_namespace(ray_namespace);
     actor_creation_spec->set_is_asyncio(is_asyncio);
+    actor_creation_spec->set_execute_out_of_order(execute_out_of_order);
     actor_creation_spec->set_extension_data(extension_data);
     actor_creation_spec->set_serialized_actor_handle(serialized_actor_handle);
     for (const auto &concurrency_group : concurrency_groups) {
@@ -220,6 +241,36 @@ class TaskSpecBuilder {
     return *this;
   }
 
+  /// Add the task to a gang of tasks that are scheduled together.
+  /// See `common.proto` for meaning of the arguments.
+  ///
+  /// \return Reference to the builder object itself.
+  TaskSpecBuilder &SetGang(const std::string &gang_id, int32_t gang_size) {
+    message_->set_gang_id(gang_id);
+    message_->set_gang_size(gang_size);
+    return *this;
+  }
+
+  /// Set the priority of the task, and the number of times it may be retried, which
+  /// tells the raylet whether it may preempt the task.
+  /// See `common.proto` for meaning of the arguments.
+  ///
+  /// \return Reference to the builder object itself.
+  TaskSpecBuilder &SetPriority(int32_t priority, int32_t max_retries) {
+    message_->set_priority(priority);
+    message_->set_max_retries(max_retries);
+    return *this;
+  }
+
+  /// Mark the task as a streaming generator, which reports the objects it yields to
+  /// the owner while it runs.
+  ///
+  /// \return Reference to the builder object itself.
+  TaskSpecBuilder &SetStreamingGenerator(bool streaming_generator) {
+    message_->set_streaming_generator(streaming_generator);
+    return *this;
+  }
+
  private:
   std::shared_ptr<rpc::TaskSpec> message_;
 };
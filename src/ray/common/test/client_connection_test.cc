@@ -14,11 +14,13 @@
 
 #include "ray/common/client_connection.h"
 #include "ray/common/asio/instrumented_io_context.h"
+#include "ray/common/ray_config.h"
 
 #include <boost/asio.hpp>
 #include <boost/asio/error.hpp>
 #include <list>
 #include <memory>
+#include <thread>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -139,6 +141,50 @@ TEST_F(ClientConnectionTest, SimpleAsyncWrite) {
   ASSERT_EQ(num_messages, 3);
 }
 
+TEST_F(ClientConnectionTest, BatchedAsyncReadWrite) {
+  // Coalesce the writes, and read in chunks smaller than most messages, so that
+  // messages are split across reads.
+  RayConfig::instance().initialize(
+      R"({"client_connection_async_write_max_messages": 16,
+          "client_connection_read_buffer_bytes": 32})");
+  const int total_messages = 20;
+  int num_messages = 0;
+
+  ClientHandler client_handler = [](ClientConnection &client) {};
+  MessageHandler noop_handler = [](std::shared_ptr<ClientConnection> client,
+                                   int64_t message_type,
+                                   const std::vector<uint8_t> &message) {};
+  MessageHandler message_handler = [&num_messages](
+                                       std::shared_ptr<ClientConnection> client,
+                                       int64_t message_type,
+                                       const std::vector<uint8_t> &message) {
+    ASSERT_EQ(message_type, num_messages);
+    ASSERT_EQ(message, std::vector<uint8_t>(num_messages * 5, num_messages));
+    num_messages += 1;
+    if (num_messages < total_messages) {
+      client->ProcessMessages();
+    }
+  };
+
+  auto writer = ClientConnection::Create(client_handler, noop_handler, std::move(in_),
+                                         "writer", {}, error_message_type_);
+  auto reader = ClientConnection::Create(client_handler, message_handler,
+                                         std::move(out_), "reader", {},
+                                         error_message_type_);
+
+  for (int i = 0; i < total_messages; i++) {
+    std::vector<uint8_t> message(i * 5, i);
+    writer->WriteMessageAsync(i, message.size(), message.data(),
+                              [](const ray::Status &status) { RAY_CHECK_OK(status); });
+  }
+  reader->ProcessMessages();
+  io_service_.run();
+  ASSERT_EQ(num_messages, total_messages);
+  RayConfig::instance().initialize(
+      R"({"client_connection_async_write_max_messages": 1,
+          "client_connection_read_buffer_bytes": 0})");
+}
+
 TEST_F(ClientConnectionTest, SimpleSyncReadWriteMessage) {
   auto writer = ServerConnection::Create(std::move(in_));
   auto reader = ServerConnection::Create(std::move(out_));
@@ -151,6 +197,26 @@ TEST_F(ClientConnectionTest, SimpleSyncReadWriteMessage) {
   RAY_CHECK(write_buffer == read_buffer);
 }
 
+TEST_F(ClientConnectionTest, SyncReadWriteLargeMessages) {
+  auto writer = ServerConnection::Create(std::move(in_));
+  auto reader = ServerConnection::Create(std::move(out_));
+
+  // Messages larger than the socket buffer are written and read in several parts.
+  std::vector<std::vector<uint8_t>> write_buffers = {
+      std::vector<uint8_t>(4 << 20, 1), {}, std::vector<uint8_t>(1 << 20, 2)};
+  std::thread write_thread([&writer, &write_buffers]() {
+    for (const auto &write_buffer : write_buffers) {
+      RAY_CHECK_OK(writer->WriteMessage(42, write_buffer.size(), write_buffer.data()));
+    }
+  });
+  for (const auto &write_buffer : write_buffers) {
+    std::vector<uint8_t> read_buffer;
+    RAY_CHECK_OK(reader->ReadMessage(42, &read_buffer));
+    ASSERT_EQ(write_buffer, read_buffer);
+  }
+  write_thread.join();
+}
+
 TEST_F(ClientConnectionTest, SimpleAsyncReadWriteBuffers) {
   auto writer = ServerConnection::Create(std::move(in_));
   auto reader = ServerConnection::Create(std::move(out_));
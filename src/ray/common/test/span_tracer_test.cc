@@ -0,0 +1,57 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/span_tracer.h"
+
+#include "gtest/gtest.h"
+#include "ray/common/ray_config.h"
+
+namespace ray {
+
+TEST(SpanTracerTest, TestDisabledByDefault) {
+  auto &tracer = SpanTracer::Instance();
+  tracer.Start("test", "/tmp");
+  ASSERT_FALSE(tracer.IsEnabled());
+  tracer.Record("Span", TaskID::Nil(), 1000, 2000);
+  ASSERT_TRUE(tracer.GetSpans().empty());
+}
+
+TEST(SpanTracerTest, TestRingBuffer) {
+  RayConfig::instance().initialize(
+      R"({"span_tracing_enabled": true, "span_tracing_buffer_size": 2})");
+  auto &tracer = SpanTracer::Instance();
+  tracer.Start("test", "/tmp");
+  ASSERT_TRUE(tracer.IsEnabled());
+
+  const auto task_id = TaskID::ForFakeTask();
+  tracer.Record("First", task_id, 1000, 2000);
+  tracer.Record("Second", task_id, 2000, 3000);
+  { ScopedSpan span("Third", task_id); }
+
+  // Only the two most recent spans are kept, oldest first.
+  auto spans = tracer.GetSpans();
+  ASSERT_EQ(spans.size(), 2);
+  ASSERT_STREQ(spans[0].name, "Second");
+  ASSERT_STREQ(spans[1].name, "Third");
+  ASSERT_EQ(spans[1].task_id, task_id);
+  ASSERT_GE(spans[1].end_time_ns, spans[1].start_time_ns);
+
+  const auto trace = SpanTracer::ToChromeTrace("test", 1, spans);
+  ASSERT_NE(trace.find("\"name\":\"Second\""), std::string::npos);
+  ASSERT_NE(trace.find("\"ts\":2,\"dur\":1"), std::string::npos);
+  ASSERT_NE(trace.find("\"task_id\":\"" + task_id.Hex() + "\""), std::string::npos);
+  ASSERT_TRUE(tracer.Dump().ok());
+}
+
+}  // namespace ray
@@ -0,0 +1,63 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/asio/timer_wheel.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+TEST(TimerWheelTest, TestScheduleAndCancel) {
+  instrumented_io_context io_service;
+  // A small wheel, so that some timers need more than one turn.
+  TimerWheel wheel(io_service, /*tick_ms=*/1, /*num_slots=*/4);
+  std::vector<std::string> fired;
+
+  wheel.Schedule(10, [&fired]() { fired.push_back("late"); });
+  wheel.Schedule(2, [&fired, &wheel]() {
+    fired.push_back("early");
+    // Timers can be scheduled from a running timer.
+    wheel.Schedule(1, [&fired]() { fired.push_back("rescheduled"); });
+  });
+  auto canceled = wheel.Schedule(3, [&fired]() { fired.push_back("canceled"); });
+  ASSERT_EQ(wheel.Size(), 3);
+  ASSERT_TRUE(wheel.Cancel(canceled));
+  ASSERT_FALSE(wheel.Cancel(canceled));
+  ASSERT_EQ(wheel.Size(), 2);
+
+  // The wheel stops ticking once no timers are pending, so this returns.
+  io_service.run();
+  ASSERT_EQ(fired, (std::vector<std::string>{"early", "rescheduled", "late"}));
+  ASSERT_EQ(wheel.Size(), 0);
+}
+
+TEST(TimerWheelTest, TestTimersOfTheSameTickRunTogether) {
+  instrumented_io_context io_service;
+  TimerWheel wheel(io_service, /*tick_ms=*/5);
+  int num_fired = 0;
+  for (int i = 0; i < 100; i++) {
+    // Delays that round up to the same tick.
+    wheel.Schedule(6 + i % 4, [&num_fired]() { num_fired++; });
+  }
+  // A single tick of the io_service runs all of them.
+  io_service.run_one();
+  ASSERT_EQ(num_fired, 0);
+  io_service.run_one();
+  ASSERT_EQ(num_fired, 100);
+}
+
+}  // namespace ray
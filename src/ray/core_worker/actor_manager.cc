@@ -165,25 +165,72 @@ bool ActorManager::AddActorHandle(std::unique_ptr<ActorHandle> actor_handle,
   }
 
   if (inserted) {
-    // Register a callback to handle actor notifications.
-    auto actor_notification_callback =
-        std::bind(&ActorManager::HandleActorStateNotification, this,
-                  std::placeholders::_1, std::placeholders::_2);
-    RAY_CHECK_OK(gcs_client_->Actors().AsyncSubscribe(
-        actor_id, actor_notification_callback,
-        [this, actor_id, cached_actor_name](Status status) {
-          if (status.ok() && !cached_actor_name.empty()) {
-            {
-              absl::MutexLock lock(&cache_mutex_);
-              cached_actor_name_to_ids_.emplace(cached_actor_name, actor_id);
-            }
-          }
-        }));
+    if (io_service_ == nullptr) {
+      SubscribeActor(actor_id, cached_actor_name);
+    } else {
+      bool post_batch;
+      {
+        absl::MutexLock lock(&subscribe_mutex_);
+        post_batch = pending_subscriptions_.empty();
+        pending_subscriptions_.emplace_back(actor_id, cached_actor_name);
+      }
+      if (post_batch) {
+        io_service_->post([this]() { SubscribePendingActors(); },
+                          "ActorManager.SubscribePendingActors");
+      }
+    }
   }
 
   return inserted;
 }
 
+void ActorManager::SubscribeActor(const ActorID &actor_id,
+                                  const std::string &cached_actor_name) {
+  // Register a callback to handle actor notifications.
+  auto actor_notification_callback =
+      std::bind(&ActorManager::HandleActorStateNotification, this,
+                std::placeholders::_1, std::placeholders::_2);
+  RAY_CHECK_OK(gcs_client_->Actors().AsyncSubscribe(
+      actor_id, actor_notification_callback,
+      [this, actor_id, cached_actor_name](Status status) {
+        if (status.ok() && !cached_actor_name.empty()) {
+          {
+            absl::MutexLock lock(&cache_mutex_);
+            cached_actor_name_to_ids_.emplace(cached_actor_name, actor_id);
+          }
+        }
+      }));
+}
+
+void ActorManager::SubscribePendingActors() {
+  std::vector<std::pair<ActorID, std::string>> subscriptions;
+  {
+    absl::MutexLock lock(&subscribe_mutex_);
+    subscriptions.swap(pending_subscriptions_);
+  }
+  std::vector<ActorID> actor_ids;
+  actor_ids.reserve(subscriptions.size());
+  for (const auto &subscription : subscriptions) {
+    actor_ids.push_back(subscription.first);
+  }
+  auto actor_notification_callback =
+      std::bind(&ActorManager::HandleActorStateNotification, this,
+                std::placeholders::_1, std::placeholders::_2);
+  RAY_CHECK_OK(gcs_client_->Actors().AsyncSubscribeBatch(
+      actor_ids, actor_notification_callback,
+      [this, subscriptions](Status status) {
+        if (!status.ok()) {
+          return;
+        }
+        absl::MutexLock lock(&cache_mutex_);
+        for (const auto &subscription : subscriptions) {
+          if (!subscription.second.empty()) {
+            cached_actor_name_to_ids_.emplace(subscription.second, subscription.first);
+          }
+        }
+      }));
+}
+
 void ActorManager::WaitForActorOutOfScope(
     const ActorID &actor_id,
     std::function<void(const ActorID &)> actor_out_of_scope_callback) {
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "absl/container/flat_hash_map.h"
+#include "ray/common/asio/instrumented_io_context.h"
 #include "ray/core_worker/actor_handle.h"
 #include "ray/core_worker/reference_count.h"
 #include "ray/core_worker/transport/direct_actor_transport.h"
@@ -77,13 +78,18 @@ class DefaultActorCreator : public ActorCreatorInterface {
 /// by raylet.
 class ActorManager {
  public:
+  /// \param io_service If set, the actors of the handles added before this event loop
+  /// gets to run are subscribed to from the GCS in one batch. Otherwise each actor is
+  /// subscribed to as its handle is added.
   explicit ActorManager(
       std::shared_ptr<gcs::GcsClient> gcs_client,
       std::shared_ptr<CoreWorkerDirectActorTaskSubmitterInterface> direct_actor_submitter,
-      std::shared_ptr<ReferenceCounterInterface> reference_counter)
+      std::shared_ptr<ReferenceCounterInterface> reference_counter,
+      instrumented_io_context *io_service = nullptr)
       : gcs_client_(gcs_client),
         direct_actor_submitter_(direct_actor_submitter),
-        reference_counter_(reference_counter) {}
+        reference_counter_(reference_counter),
+        io_service_(io_service) {}
 
   ~ActorManager() = default;
 
@@ -207,6 +213,15 @@ class ActorManager {
   void HandleActorStateNotification(const ActorID &actor_id,
                                     const rpc::ActorTableData &actor_data);
 
+  /// Subscribe to the state of an actor from GCS.
+  ///
+  /// \param[in] actor_id The actor to subscribe to.
+  /// \param[in] cached_actor_name Actor name to cache once subscribed, if not empty.
+  void SubscribeActor(const ActorID &actor_id, const std::string &cached_actor_name);
+
+  /// Subscribe to the state of all the actors in `pending_subscriptions_` in one batch.
+  void SubscribePendingActors() LOCKS_EXCLUDED(subscribe_mutex_);
+
   /// GCS client.
   std::shared_ptr<gcs::GcsClient> gcs_client_;
 
@@ -231,6 +246,17 @@ class ActorManager {
   /// getting them from GCS frequently.
   absl::flat_hash_map<std::string, ActorID> cached_actor_name_to_ids_
       GUARDED_BY(cache_mutex_);
+
+  /// The event loop to batch actor subscriptions on, or nullptr to subscribe to each
+  /// actor separately.
+  instrumented_io_context *io_service_;
+
+  /// Protects access `pending_subscriptions_`.
+  absl::Mutex subscribe_mutex_;
+
+  /// The actors to subscribe to in the next batch, and the names to cache for them.
+  std::vector<std::pair<ActorID, std::string>> pending_subscriptions_
+      GUARDED_BY(subscribe_mutex_);
 };
 
 }  // namespace core
@@ -83,6 +83,10 @@ struct TaskOptions {
   /// value.  Can override existing environment variables and introduce new ones.
   /// Propagated to child actors and/or tasks.
   const std::unordered_map<std::string, std::string> override_environment_variables;
+  /// The priority of this task, higher is more important. See `TaskSpec.priority`.
+  int32_t priority = 0;
+  /// Whether the task is a streaming generator. See `TaskSpec.streaming_generator`.
+  bool is_streaming_generator = false;
 };
 
 /// Options for actor creation tasks.
@@ -99,7 +103,8 @@ struct ActorCreationOptions {
       const std::string &serialized_runtime_env = "{}",
       const std::unordered_map<std::string, std::string> &override_environment_variables =
           {},
-      const std::vector<ConcurrencyGroup> &concurrency_groups = {})
+      const std::vector<ConcurrencyGroup> &concurrency_groups = {},
+      bool execute_out_of_order = false)
       : max_restarts(max_restarts),
         max_task_retries(max_task_retries),
         max_concurrency(max_concurrency),
@@ -114,7 +119,8 @@ struct ActorCreationOptions {
         placement_group_capture_child_tasks(placement_group_capture_child_tasks),
         serialized_runtime_env(serialized_runtime_env),
         override_environment_variables(override_environment_variables),
-        concurrency_groups(concurrency_groups.begin(), concurrency_groups.end()){};
+        concurrency_groups(concurrency_groups.begin(), concurrency_groups.end()),
+        execute_out_of_order(execute_out_of_order){};
 
   /// Maximum number of times that the actor should be restarted if it dies
   /// unexpectedly. A value of -1 indicates infinite restarts. If it's 0, the
@@ -162,6 +168,9 @@ struct ActorCreationOptions {
   /// The actor concurrency groups to indicate how this actor perform its
   /// methods concurrently.
   const std::vector<ConcurrencyGroup> concurrency_groups;
+  /// Whether to execute tasks as soon as their dependencies are ready instead of
+  /// in per-caller submission order.
+  const bool execute_out_of_order = false;
 };
 
 using PlacementStrategy = rpc::PlacementStrategy;
@@ -145,6 +145,8 @@ ObjectIDIndexType WorkerContext::GetNextPutIndex() {
 
 const JobID &WorkerContext::GetCurrentJobID() const { return current_job_id_; }
 
+void WorkerContext::ResetJob(const JobID &job_id) { current_job_id_ = job_id; }
+
 const TaskID &WorkerContext::GetCurrentTaskID() const {
   return GetThreadContext().GetCurrentTaskID();
 }
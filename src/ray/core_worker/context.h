@@ -34,6 +34,9 @@ class WorkerContext {
 
   const JobID &GetCurrentJobID() const;
 
+  /// Rebind this worker to another job. Only valid while the worker isn't leased.
+  void ResetJob(const JobID &job_id);
+
   const TaskID &GetCurrentTaskID() const;
 
   const PlacementGroupID &GetCurrentPlacementGroupId() const;
@@ -14,9 +14,14 @@
 
 #include "ray/core_worker/core_worker.h"
 
+#include <algorithm>
+#include <climits>
+#include <random>
+
 #include "boost/fiber/all.hpp"
 #include "ray/common/bundle_spec.h"
 #include "ray/common/ray_config.h"
+#include "ray/common/span_tracer.h"
 #include "ray/common/task/task_util.h"
 #include "ray/core_worker/context.h"
 #include "ray/core_worker/transport/direct_actor_transport.h"
@@ -37,7 +42,9 @@ void BuildCommonTaskSpec(
     TaskSpecBuilder &builder, const JobID &job_id, const TaskID &task_id,
     const std::string name, const TaskID &current_task_id, const uint64_t task_index,
     const TaskID &caller_id, const rpc::Address &address, const RayFunction &function,
-    const std::vector<std::unique_ptr<TaskArg>> &args, uint64_t num_returns,
+    const std::vector<std::unique_ptr<TaskArg>> &args,
+    const std::function<std::unique_ptr<TaskArg>(const TaskArg &)> &deduplicate_arg,
+    uint64_t num_returns,
     const std::unordered_map<std::string, double> &required_resources,
     const std::unordered_map<std::string, double> &required_placement_resources,
     std::vector<ObjectID> *return_ids, const BundleID &bundle_id,
@@ -54,7 +61,8 @@ void BuildCommonTaskSpec(
       concurrency_group_name);
   // Set task arguments.
   for (const auto &arg : args) {
-    builder.AddArg(*arg);
+    auto deduplicated_arg = deduplicate_arg(*arg);
+    builder.AddArg(deduplicated_arg != nullptr ? *deduplicated_arg : *arg);
   }
 
   // Compute return IDs.
@@ -80,10 +88,10 @@ JobID GetProcessJobID(const CoreWorkerOptions &options) {
   return options.job_id;
 }
 
-// Helper function converts GetObjectLocationsOwnerReply to ObjectLocation
-ObjectLocation CreateObjectLocation(const rpc::GetObjectLocationsOwnerReply &reply) {
+// Helper function converts WorkerObjectLocationsPubMessage to ObjectLocation
+ObjectLocation CreateObjectLocation(
+    const rpc::WorkerObjectLocationsPubMessage &object_info) {
   std::vector<NodeID> node_ids;
-  const auto &object_info = reply.object_location_info();
   node_ids.reserve(object_info.node_ids_size());
   for (auto i = 0; i < object_info.node_ids_size(); i++) {
     node_ids.push_back(NodeID::FromBinary(object_info.node_ids(i)));
@@ -188,6 +196,12 @@ CoreWorkerProcess::CoreWorkerProcess(const CoreWorkerOptions &options)
 
   RAY_CHECK_OK(gcs_client_->Connect(io_service_));
 
+  if (options_.num_workers > 1 &&
+      RayConfig::instance().core_worker_share_plasma_client()) {
+    plasma_client_ = std::make_shared<plasma::PlasmaClient>();
+    RAY_CHECK_OK(plasma_client_->Connect(options_.store_socket));
+  }
+
   if (options_.num_workers == 1) {
     // We need to create the worker instance here if:
     // 1. This is a driver process. In this case, the driver is ready to use right after
@@ -229,7 +243,11 @@ CoreWorkerProcess::CoreWorkerProcess(const CoreWorkerOptions &options)
   // Initialize event framework.
   if (RayConfig::instance().event_log_reporter_enabled() && !options_.log_dir.empty()) {
     RayEventInit(ray::rpc::Event_SourceType::Event_SourceType_CORE_WORKER,
-                 std::unordered_map<std::string, std::string>(), options_.log_dir);
+                 std::unordered_map<std::string, std::string>(), options_.log_dir,
+                 RayConfig::instance().event_reporter_queue_size());
+  }
+  if (!options_.log_dir.empty()) {
+    SpanTracer::Instance().Start("core_worker", options_.log_dir);
   }
 
   io_thread_ = std::thread([&] {
@@ -269,6 +287,9 @@ CoreWorkerProcess::~CoreWorkerProcess() {
   if (io_thread_.joinable()) {
     io_thread_.join();
   }
+  if (plasma_client_ != nullptr) {
+    RAY_IGNORE_EXPR(plasma_client_->Disconnect());
+  }
 }
 
 void CoreWorkerProcess::EnsureInitialized() {
@@ -366,7 +387,8 @@ std::shared_ptr<CoreWorker> CoreWorkerProcess::GetWorker(
 std::shared_ptr<CoreWorker> CoreWorkerProcess::CreateWorker() {
   auto worker = std::make_shared<CoreWorker>(
       options_,
-      global_worker_id_ != WorkerID::Nil() ? global_worker_id_ : WorkerID::FromRandom());
+      global_worker_id_ != WorkerID::Nil() ? global_worker_id_ : WorkerID::FromRandom(),
+      plasma_client_);
   RAY_LOG(DEBUG) << "Worker " << worker->GetWorkerID() << " is created.";
   if (options_.num_workers == 1) {
     global_worker_ = worker;
@@ -428,7 +450,8 @@ void CoreWorkerProcess::RunTaskExecutionLoop() {
   core_worker_process.reset();
 }
 
-CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_id)
+CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_id,
+                       std::shared_ptr<plasma::PlasmaClient> shared_store_client)
     : options_(options),
       get_call_site_(RayConfig::instance().record_ref_creation_sites()
                          ? options_.get_lang_stack
@@ -496,7 +519,8 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
   // Start RPC server after all the task receivers are properly initialized and we have
   // our assigned port from the raylet.
   core_worker_server_ = std::make_unique<rpc::GrpcServer>(
-      WorkerTypeString(options_.worker_type), assigned_port);
+      WorkerTypeString(options_.worker_type), assigned_port,
+      RayConfig::instance().core_worker_grpc_server_threads());
   core_worker_server_->RegisterService(grpc_service_);
   core_worker_server_->Run();
 
@@ -552,7 +576,10 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
 
   // Initialize profiler.
   profiler_ = std::make_shared<worker::Profiler>(
-      worker_context_, options_.node_ip_address, io_service_, gcs_client_);
+      worker_context_, options_.node_ip_address, io_service_, gcs_client_,
+      RayConfig::instance().profile_events_flush_interval_ms(),
+      RayConfig::instance().profile_events_max_batch_size(),
+      RayConfig::instance().profile_events_max_buffered());
 
   core_worker_client_pool_ =
       std::make_shared<rpc::CoreWorkerClientPool>(*client_call_manager_);
@@ -561,7 +588,11 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
       /*periodical_runner=*/&periodical_runner_,
       /*get_time_ms=*/[]() { return absl::GetCurrentTimeNanos() / 1e6; },
       /*subscriber_timeout_ms=*/RayConfig::instance().subscriber_timeout_ms(),
-      /*publish_batch_size_=*/RayConfig::instance().publish_batch_size());
+      /*publish_batch_size_=*/RayConfig::instance().publish_batch_size(),
+      /*publish_batch_window_ms=*/
+      RayConfig::instance().worker_publish_batch_window_ms(),
+      /*coalesce_superseded_messages=*/
+      RayConfig::instance().worker_publish_coalesce_superseded_messages());
   object_info_subscriber_ = std::make_unique<pubsub::Subscriber>(
       /*subscriber_id=*/GetWorkerID(),
       /*max_command_batch_size*/ RayConfig::instance().max_command_batch_size(),
@@ -594,7 +625,8 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
       (options_.worker_type != WorkerType::SPILL_WORKER &&
        options_.worker_type != WorkerType::RESTORE_WORKER &&
        options_.worker_type != WorkerType::UTIL_WORKER),
-      /*get_current_call_site=*/boost::bind(&CoreWorker::CurrentCallSite, this)));
+      /*get_current_call_site=*/boost::bind(&CoreWorker::CurrentCallSite, this),
+      shared_store_client));
   memory_store_.reset(new CoreWorkerMemoryStore(
       [this](const RayObject &object, const ObjectID &object_id) {
         PutObjectIntoPlasma(object, object_id);
@@ -651,7 +683,8 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
           }
         }
       },
-      check_node_alive_fn, reconstruct_object_callback));
+      check_node_alive_fn, reconstruct_object_callback,
+      RayConfig::instance().max_lineage_bytes()));
 
   // Create an entry for the driver task in the task table. This task is
   // added immediately with status RUNNING. This allows us to push errors
@@ -710,12 +743,32 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
     }
     return addr;
   };
-  auto lease_policy = RayConfig::instance().locality_aware_leasing_enabled()
-                          ? std::shared_ptr<LeasePolicyInterface>(
-                                std::make_shared<LocalityAwareLeasePolicy>(
-                                    reference_counter_, node_addr_factory, rpc_address_))
-                          : std::shared_ptr<LeasePolicyInterface>(
-                                std::make_shared<LocalLeasePolicy>(rpc_address_));
+  NodeLoadProvider node_load_provider = nullptr;
+  if (RayConfig::instance().locality_aware_leasing_enabled() &&
+      RayConfig::instance().locality_aware_leasing_load_penalty_bytes() > 0) {
+    node_load_provider = [this](const NodeID &node_id) {
+      absl::optional<double> load;
+      absl::MutexLock lock(&node_loads_mutex_);
+      auto it = node_loads_.find(node_id);
+      if (it != node_loads_.end()) {
+        load = it->second;
+      }
+      return load;
+    };
+    periodical_runner_.RunFnPeriodically(
+        [this] { RefreshNodeLoads(); },
+        RayConfig::instance().locality_aware_leasing_load_refresh_ms());
+  }
+  auto lease_policy =
+      RayConfig::instance().locality_aware_leasing_enabled()
+          ? std::shared_ptr<LeasePolicyInterface>(
+                std::make_shared<LocalityAwareLeasePolicy>(
+                    reference_counter_, node_addr_factory, rpc_address_,
+                    node_load_provider,
+                    RayConfig::instance().locality_aware_leasing_max_locality_bytes(),
+                    RayConfig::instance().locality_aware_leasing_load_penalty_bytes()))
+          : std::shared_ptr<LeasePolicyInterface>(
+                std::make_shared<LocalLeasePolicy>(rpc_address_));
 
   direct_task_submitter_ = std::make_unique<CoreWorkerDirectTaskSubmitter>(
       rpc_address_, local_raylet_client_, core_worker_client_pool_, raylet_client_factory,
@@ -728,9 +781,10 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
              uint64_t object_size) {
         reference_counter_->ReportLocalityData(object_id, locations, object_size);
       };
-  future_resolver_.reset(new FutureResolver(memory_store_, reference_counter_,
-                                            std::move(report_locality_data_callback),
-                                            core_worker_client_pool_, rpc_address_));
+  future_resolver_.reset(new FutureResolver(
+      memory_store_, reference_counter_, std::move(report_locality_data_callback),
+      core_worker_client_pool_, rpc_address_, io_service_,
+      RayConfig::instance().get_object_status_batch_max_size()));
 
   // Unfortunately the raylet client has to be constructed after the receivers.
   if (direct_task_receiver_ != nullptr) {
@@ -739,8 +793,9 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
                                 task_argument_waiter_);
   }
 
-  actor_manager_ = std::make_unique<ActorManager>(gcs_client_, direct_actor_submitter_,
-                                                  reference_counter_);
+  actor_manager_ = std::make_unique<ActorManager>(
+      gcs_client_, direct_actor_submitter_, reference_counter_,
+      RayConfig::instance().batch_actor_subscriptions() ? &io_service_ : nullptr);
 
   std::function<Status(const ObjectID &object_id, const ObjectLookupCallback &callback)>
       object_lookup_fn;
@@ -791,6 +846,13 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
   // Used to detect if the object is in the plasma store.
   max_direct_call_object_size_ = RayConfig::instance().max_direct_call_object_size();
 
+  const int64_t task_arg_dedup_window_ms =
+      RayConfig::instance().task_arg_dedup_window_ms();
+  if (task_arg_dedup_window_ms > 0) {
+    periodical_runner_.RunFnPeriodically([this] { ReleaseExpiredTaskArgs(); },
+                                         task_arg_dedup_window_ms);
+  }
+
   /// If periodic asio stats print is enabled, it will print it.
   const auto event_stats_print_interval_ms =
       RayConfig::instance().event_stats_print_interval_ms();
@@ -804,6 +866,7 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
 }
 
 void CoreWorker::Shutdown() {
+  RAY_UNUSED(SpanTracer::Instance().Dump());
   io_service_.stop();
   if (options_.worker_type == WorkerType::WORKER) {
     task_execution_service_.stop();
@@ -921,15 +984,14 @@ void CoreWorker::OnNodeRemoved(const NodeID &node_id) {
   // will eventually be stored for the objects (either an
   // UnreconstructableError or a value reconstructed from lineage).
   memory_store_->Delete(lost_objects);
-  for (const auto &object_id : lost_objects) {
-    // NOTE(swang): There is a race condition where this can return false if
-    // the reference went out of scope since the call to the ref counter to get
-    // the lost objects. It's okay to not mark the object as failed or recover
-    // the object since there are no reference holders.
-    auto recovered = object_recovery_manager_->RecoverObject(object_id);
-    if (!recovered) {
-      RAY_LOG(DEBUG) << "Object " << object_id << " lost due to node failure " << node_id;
-    }
+  // NOTE(swang): There is a race condition where some objects may be
+  // unrecoverable if the reference went out of scope since the call to the
+  // ref counter to get the lost objects. It's okay to not mark the object as
+  // failed or recover the object since there are no reference holders.
+  std::vector<ObjectID> unrecoverable;
+  object_recovery_manager_->RecoverObjects(lost_objects, &unrecoverable);
+  for (const auto &object_id : unrecoverable) {
+    RAY_LOG(DEBUG) << "Object " << object_id << " lost due to node failure " << node_id;
   }
 }
 
@@ -1011,6 +1073,31 @@ void CoreWorker::CheckForRayletFailure() {
   }
 }
 
+void CoreWorker::RefreshNodeLoads() {
+  RAY_CHECK_OK(gcs_client_->NodeResources().AsyncGetAllResourceUsage(
+      [this](const rpc::ResourceUsageBatchData &data) {
+        absl::flat_hash_map<NodeID, double> node_loads;
+        for (const auto &resources : data.batch()) {
+          auto total = resources.resources_total().find(kCPU_ResourceLabel);
+          if (total == resources.resources_total().end() || total->second <= 0) {
+            continue;
+          }
+          double used = total->second;
+          auto available = resources.resources_available().find(kCPU_ResourceLabel);
+          if (available != resources.resources_available().end()) {
+            used -= available->second;
+          }
+          auto queued = resources.resource_load().find(kCPU_ResourceLabel);
+          if (queued != resources.resource_load().end()) {
+            used += queued->second;
+          }
+          node_loads[NodeID::FromBinary(resources.node_id())] = used / total->second;
+        }
+        absl::MutexLock lock(&node_loads_mutex_);
+        node_loads_ = std::move(node_loads);
+      }));
+}
+
 void CoreWorker::InternalHeartbeat() {
   // Retry tasks.
   std::vector<TaskSpecification> tasks_to_resubmit;
@@ -1042,6 +1129,10 @@ void CoreWorker::InternalHeartbeat() {
   if (options_.worker_type == WorkerType::DRIVER && options_.interactive) {
     memory_store_->NotifyUnhandledErrors();
   }
+
+  stats::MemoryStoreUsedMemory().Record(memory_store_->UsedMemory());
+  stats::TaskLineageBytes().Record(task_manager_->LineageFootprintBytes());
+  stats::TaskLineageEvicted().Record(task_manager_->NumLineageEvicted());
 }
 
 std::unordered_map<ObjectID, std::pair<size_t, size_t>>
@@ -1533,6 +1624,47 @@ Status CoreWorker::Delete(const std::vector<ObjectID> &object_ids, bool local_on
   return plasma_store_provider_->Delete(plasma_object_ids, local_only);
 }
 
+Status CoreWorker::ReplicateObject(const ObjectID &object_id, int num_replicas) {
+  bool owned_by_us = false;
+  NodeID pinned_at;
+  bool spilled = false;
+  if (!reference_counter_->IsPlasmaObjectPinnedOrSpilled(object_id, &owned_by_us,
+                                                         &pinned_at, &spilled) ||
+      !owned_by_us) {
+    return Status::Invalid("Only plasma objects owned by this worker can be replicated.");
+  }
+
+  // Pick alive nodes that don't have a copy yet, in random order.
+  absl::flat_hash_set<NodeID> excluded_nodes;
+  excluded_nodes.insert(pinned_at);
+  const auto object_locations = reference_counter_->GetObjectLocations(object_id);
+  if (object_locations.has_value()) {
+    excluded_nodes.insert(object_locations->begin(), object_locations->end());
+  }
+  std::vector<rpc::Address> candidates;
+  for (const auto &entry : gcs_client_->Nodes().GetAll()) {
+    const auto &node_info = entry.second;
+    if (node_info.state() != rpc::GcsNodeInfo::ALIVE ||
+        excluded_nodes.contains(entry.first)) {
+      continue;
+    }
+    rpc::Address address;
+    address.set_raylet_id(node_info.node_id());
+    address.set_ip_address(node_info.node_manager_address());
+    address.set_port(node_info.node_manager_port());
+    candidates.push_back(address);
+  }
+  std::mt19937_64 gen(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+  std::shuffle(candidates.begin(), candidates.end(), gen);
+  if (candidates.size() > static_cast<size_t>(num_replicas)) {
+    candidates.resize(num_replicas);
+  }
+  RAY_LOG(DEBUG) << "Replicating object " << object_id << " to " << candidates.size()
+                 << " nodes";
+  object_recovery_manager_->ReplicateObject(object_id, candidates);
+  return Status::OK();
+}
+
 Status CoreWorker::GetLocationFromOwner(
     const std::vector<ObjectID> &object_ids, int64_t timeout_ms,
     std::vector<std::shared_ptr<ObjectLocation>> *results) {
@@ -1547,26 +1679,52 @@ Status CoreWorker::GetLocationFromOwner(
   auto location_by_id =
       std::make_shared<absl::flat_hash_map<ObjectID, std::shared_ptr<ObjectLocation>>>();
 
+  // Look up the objects of each owner in a single request.
+  absl::flat_hash_map<WorkerID, std::pair<rpc::Address, std::vector<ObjectID>>>
+      objects_by_owner;
   for (const auto &object_id : object_ids) {
     auto owner_address = GetOwnerAddress(object_id);
+    auto &owner_objects =
+        objects_by_owner[WorkerID::FromBinary(owner_address.worker_id())];
+    owner_objects.first = owner_address;
+    owner_objects.second.push_back(object_id);
+  }
+
+  for (const auto &entry : objects_by_owner) {
+    const auto &owner_address = entry.second.first;
+    const auto &owner_object_ids = entry.second.second;
     auto client = core_worker_client_pool_->GetOrConnect(owner_address);
     rpc::GetObjectLocationsOwnerRequest request;
-    auto object_location_request = request.mutable_object_location_request();
-    object_location_request->set_intended_worker_id(owner_address.worker_id());
-    object_location_request->set_object_id(object_id.Binary());
+    request.set_intended_worker_id(owner_address.worker_id());
+    for (const auto &object_id : owner_object_ids) {
+      request.add_object_ids(object_id.Binary());
+    }
     client->GetObjectLocationsOwner(
         request,
-        [object_id, mutex, num_remaining, ready_promise, location_by_id](
+        [owner_object_ids, mutex, num_remaining, ready_promise, location_by_id](
             const Status &status, const rpc::GetObjectLocationsOwnerReply &reply) {
           absl::MutexLock lock(mutex.get());
-          if (status.ok()) {
-            location_by_id->emplace(
-                object_id, std::make_shared<ObjectLocation>(CreateObjectLocation(reply)));
+          if (status.ok() &&
+              reply.object_location_infos_size() ==
+                  static_cast<int>(owner_object_ids.size())) {
+            for (size_t i = 0; i < owner_object_ids.size(); i++) {
+              const auto &object_info = reply.object_location_infos(i);
+              if (object_info.ref_removed()) {
+                RAY_LOG(WARNING) << "Failed to query location information for "
+                                 << owner_object_ids[i]
+                                 << ", the object has been freed by its owner.";
+                continue;
+              }
+              location_by_id->emplace(
+                  owner_object_ids[i],
+                  std::make_shared<ObjectLocation>(CreateObjectLocation(object_info)));
+            }
           } else {
-            RAY_LOG(WARNING) << "Failed to query location information for " << object_id
-                             << " with error: " << status.ToString();
+            RAY_LOG(WARNING) << "Failed to query location information for "
+                             << owner_object_ids.size()
+                             << " objects with error: " << status.ToString();
           }
-          (*num_remaining)--;
+          (*num_remaining) -= owner_object_ids.size();
           if (*num_remaining == 0) {
             ready_promise->set_value();
           }
@@ -1701,6 +1859,101 @@ std::unordered_map<std::string, double> AddPlacementGroupConstraint(
   return resources;
 }
 
+std::shared_ptr<google::protobuf::Arena> CoreWorker::NextTaskSpecArena() {
+  const uint32_t num_tasks_per_arena = RayConfig::instance().task_spec_arena_num_tasks();
+  if (num_tasks_per_arena == 0) {
+    return nullptr;
+  }
+  absl::MutexLock lock(&mutex_);
+  if (task_spec_arena_ == nullptr || task_spec_arena_num_tasks_ >= num_tasks_per_arena) {
+    task_spec_arena_ = std::make_shared<google::protobuf::Arena>();
+    task_spec_arena_num_tasks_ = 0;
+  }
+  task_spec_arena_num_tasks_++;
+  return task_spec_arena_;
+}
+
+std::unique_ptr<TaskArg> CoreWorker::DeduplicateTaskArg(const TaskArg &arg) {
+  const int64_t window_ms = RayConfig::instance().task_arg_dedup_window_ms();
+  if (window_ms <= 0) {
+    return nullptr;
+  }
+  const auto *arg_by_value = dynamic_cast<const TaskArgByValue *>(&arg);
+  if (arg_by_value == nullptr) {
+    return nullptr;
+  }
+  const auto &value = arg_by_value->GetValue();
+  // Values holding references are left inline, so that the references they contain
+  // are counted as before.
+  if (!value->HasData() || !value->GetNestedRefs().empty() ||
+      static_cast<int64_t>(value->GetSize()) < max_direct_call_object_size_ ||
+      value->GetData()->Size() > static_cast<size_t>(INT_MAX)) {
+    return nullptr;
+  }
+  const auto &data = value->GetData();
+  const int size = static_cast<int>(data->Size());
+  // Two hashes with different seeds, so that different contents practically never
+  // share a fingerprint.
+  DeduplicatedTaskArgKey key{
+      MurmurHash64A(data->Data(), size, 0), MurmurHash64A(data->Data(), size, 1),
+      value->HasMetadata() ? std::string(reinterpret_cast<const char *>(
+                                             value->GetMetadata()->Data()),
+                                         value->GetMetadata()->Size())
+                           : std::string()};
+  const int64_t now_ms = current_time_ms();
+  {
+    absl::MutexLock lock(&deduplicated_task_args_mutex_);
+    auto it = deduplicated_task_args_.find(key);
+    if (it != deduplicated_task_args_.end() && it->second.second > now_ms) {
+      return std::make_unique<TaskArgByReference>(it->second.first, rpc_address_);
+    }
+  }
+
+  ObjectID object_id;
+  if (!Put(*value, /*contained_object_ids=*/{}, &object_id).ok()) {
+    // Pass the value inline, as without deduplication.
+    return nullptr;
+  }
+  // Keep the object in scope while it may be reused. Submitted tasks hold their own
+  // references to it.
+  AddLocalReference(object_id, CurrentCallSite());
+  absl::optional<ObjectID> replaced_object_id;
+  {
+    absl::MutexLock lock(&deduplicated_task_args_mutex_);
+    auto &entry = deduplicated_task_args_[key];
+    if (!entry.first.IsNil()) {
+      replaced_object_id = entry.first;
+    }
+    entry = std::make_pair(object_id, now_ms + window_ms);
+  }
+  if (replaced_object_id.has_value()) {
+    RemoveLocalReference(*replaced_object_id);
+  }
+  RAY_LOG(DEBUG) << "Put task argument " << object_id << " of " << value->GetSize()
+                 << " bytes for reuse by later tasks";
+  return std::make_unique<TaskArgByReference>(object_id, rpc_address_);
+}
+
+void CoreWorker::ReleaseExpiredTaskArgs() {
+  const int64_t now_ms = current_time_ms();
+  std::vector<ObjectID> expired_object_ids;
+  {
+    absl::MutexLock lock(&deduplicated_task_args_mutex_);
+    for (auto it = deduplicated_task_args_.begin();
+         it != deduplicated_task_args_.end();) {
+      if (it->second.second <= now_ms) {
+        expired_object_ids.push_back(it->second.first);
+        deduplicated_task_args_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+  }
+  for (const auto &object_id : expired_object_ids) {
+    RemoveLocalReference(object_id);
+  }
+}
+
 void CoreWorker::SubmitTask(const RayFunction &function,
                             const std::vector<std::unique_ptr<TaskArg>> &args,
                             const TaskOptions &task_options,
@@ -1708,7 +1961,7 @@ void CoreWorker::SubmitTask(const RayFunction &function,
                             BundleID placement_options,
                             bool placement_group_capture_child_tasks,
                             const std::string &debugger_breakpoint) {
-  TaskSpecBuilder builder;
+  TaskSpecBuilder builder(NextTaskSpecArena());
   const auto next_task_index = worker_context_.GetNextTaskIndex();
   const auto task_id =
       TaskID::ForNormalTask(worker_context_.GetCurrentJobID(),
@@ -1731,11 +1984,15 @@ void CoreWorker::SubmitTask(const RayFunction &function,
   // TODO(ekl) offload task building onto a thread pool for performance
   BuildCommonTaskSpec(builder, worker_context_.GetCurrentJobID(), task_id, task_name,
                       worker_context_.GetCurrentTaskID(), next_task_index, GetCallerId(),
-                      rpc_address_, function, args, task_options.num_returns,
+                      rpc_address_, function, args,
+                      [this](const TaskArg &arg) { return DeduplicateTaskArg(arg); },
+                      task_options.num_returns,
                       constrained_resources, required_resources, return_ids,
                       placement_options, placement_group_capture_child_tasks,
                       debugger_breakpoint, task_options.serialized_runtime_env,
                       override_environment_variables);
+  builder.SetPriority(task_options.priority, max_retries);
+  builder.SetStreamingGenerator(task_options.is_streaming_generator);
   TaskSpecification task_spec = builder.Build();
   RAY_LOG(DEBUG) << "Submit task " << task_spec.DebugString();
   if (options_.is_local_mode) {
@@ -1751,6 +2008,65 @@ void CoreWorker::SubmitTask(const RayFunction &function,
   }
 }
 
+void CoreWorker::SubmitTasks(
+    const RayFunction &function,
+    const std::vector<std::vector<std::unique_ptr<TaskArg>>> &args_list,
+    const TaskOptions &task_options, std::vector<std::vector<ObjectID>> *return_ids,
+    int max_retries, BundleID placement_options,
+    bool placement_group_capture_child_tasks, const std::string &debugger_breakpoint) {
+  auto constrained_resources = AddPlacementGroupConstraint(
+      task_options.resources, placement_options.first, placement_options.second);
+  const std::unordered_map<std::string, double> required_resources;
+  auto task_name = task_options.name.empty()
+                       ? function.GetFunctionDescriptor()->DefaultTaskName()
+                       : task_options.name;
+  std::unordered_map<std::string, std::string> current_override_environment_variables =
+      worker_context_.GetCurrentOverrideEnvironmentVariables();
+  std::unordered_map<std::string, std::string> override_environment_variables =
+      task_options.override_environment_variables;
+  override_environment_variables.insert(current_override_environment_variables.begin(),
+                                        current_override_environment_variables.end());
+
+  std::vector<TaskSpecification> task_specs;
+  task_specs.reserve(args_list.size());
+  return_ids->resize(args_list.size());
+  for (size_t i = 0; i < args_list.size(); i++) {
+    TaskSpecBuilder builder(NextTaskSpecArena());
+    const auto next_task_index = worker_context_.GetNextTaskIndex();
+    const auto task_id =
+        TaskID::ForNormalTask(worker_context_.GetCurrentJobID(),
+                              worker_context_.GetCurrentTaskID(), next_task_index);
+    BuildCommonTaskSpec(builder, worker_context_.GetCurrentJobID(), task_id, task_name,
+                        worker_context_.GetCurrentTaskID(), next_task_index,
+                        GetCallerId(), rpc_address_, function, args_list[i],
+                        [this](const TaskArg &arg) { return DeduplicateTaskArg(arg); },
+                        task_options.num_returns, constrained_resources,
+                        required_resources, &(*return_ids)[i], placement_options,
+                        placement_group_capture_child_tasks, debugger_breakpoint,
+                        task_options.serialized_runtime_env,
+                        override_environment_variables);
+    builder.SetPriority(task_options.priority, max_retries);
+    builder.SetStreamingGenerator(task_options.is_streaming_generator);
+    task_specs.push_back(builder.Build());
+  }
+  RAY_LOG(DEBUG) << "Submit " << task_specs.size() << " tasks of " << task_name;
+  if (options_.is_local_mode) {
+    for (const auto &task_spec : task_specs) {
+      ExecuteTaskLocalMode(task_spec);
+    }
+  } else {
+    task_manager_->AddPendingTasks(rpc_address_, task_specs, CurrentCallSite(),
+                                   max_retries);
+    io_service_.post(
+        [this, task_specs = std::move(task_specs)]() {
+          for (const auto &task_spec : task_specs) {
+            RAY_UNUSED(direct_task_submitter_->SubmitTask(task_spec));
+          }
+        },
+        "CoreWorker.SubmitTasks");
+  }
+}
+
 Status CoreWorker::CreateActor(const RayFunction &function,
                                const std::vector<std::unique_ptr<TaskArg>> &args,
                                const ActorCreationOptions &actor_creation_options,
@@ -1791,7 +2107,9 @@ Status CoreWorker::CreateActor(const RayFunction &function,
   BuildCommonTaskSpec(
       builder, job_id, actor_creation_task_id, task_name,
       worker_context_.GetCurrentTaskID(), next_task_index, GetCallerId(), rpc_address_,
-      function, args, 1, new_resource, new_placement_resources, &return_ids,
+      function, args,
+      [this](const TaskArg &arg) { return DeduplicateTaskArg(arg); }, 1, new_resource,
+      new_placement_resources, &return_ids,
       actor_creation_options.placement_options,
       actor_creation_options.placement_group_capture_child_tasks,
       "", /* debugger_breakpoint */
@@ -1809,7 +2127,8 @@ Status CoreWorker::CreateActor(const RayFunction &function,
       actor_creation_options.dynamic_worker_options,
       actor_creation_options.max_concurrency, actor_creation_options.is_detached,
       actor_name, actor_creation_options.ray_namespace, actor_creation_options.is_asyncio,
-      actor_creation_options.concurrency_groups, extension_data);
+      actor_creation_options.concurrency_groups, extension_data,
+      actor_creation_options.execute_out_of_order);
   // Add the actor handle before we submit the actor creation task, since the
   // actor handle must be in scope by the time the GCS sends the
   // WaitForActorOutOfScopeRequest.
@@ -1938,7 +2257,7 @@ void CoreWorker::SubmitActorTask(const ActorID &actor_id, const RayFunction &fun
   const int num_returns = task_options.num_returns + 1;
 
   // Build common task spec.
-  TaskSpecBuilder builder;
+  TaskSpecBuilder builder(NextTaskSpecArena());
   const auto next_task_index = worker_context_.GetNextTaskIndex();
   const TaskID actor_task_id = TaskID::ForActorTask(
       worker_context_.GetCurrentJobID(), worker_context_.GetCurrentTaskID(),
@@ -1951,7 +2270,9 @@ void CoreWorker::SubmitActorTask(const ActorID &actor_id, const RayFunction &fun
   BuildCommonTaskSpec(
       builder, actor_handle->CreationJobID(), actor_task_id, task_name,
       worker_context_.GetCurrentTaskID(), next_task_index, GetCallerId(), rpc_address_,
-      function, args, num_returns, task_options.resources, required_resources, return_ids,
+      function, args,
+      [this](const TaskArg &arg) { return DeduplicateTaskArg(arg); }, num_returns,
+      task_options.resources, required_resources, return_ids,
       std::make_pair(PlacementGroupID::Nil(), -1),
       true, /* placement_group_capture_child_tasks */
       "",   /* debugger_breakpoint */
@@ -2020,6 +2341,42 @@ Status CoreWorker::CancelChildren(const TaskID &task_id, bool force_kill) {
   }
 }
 
+void CoreWorker::RegisterActorChannelHandler(const std::string &channel_name,
+                                             ActorChannelHandler handler) {
+  absl::MutexLock lock(&actor_channel_mutex_);
+  if (handler == nullptr) {
+    actor_channel_handlers_.erase(channel_name);
+  } else {
+    actor_channel_handlers_[channel_name] = std::move(handler);
+  }
+}
+
+Status CoreWorker::SendActorChannelMessages(const ActorID &actor_id,
+                                            const std::string &channel_name,
+                                            std::vector<std::string> messages,
+                                            std::function<void(Status)> on_ack) {
+  std::string worker_id;
+  auto client = direct_actor_submitter_->GetActorRpcClient(actor_id, &worker_id);
+  if (client == nullptr) {
+    return Status::NotFound("Actor " + actor_id.Hex() + " is not connected.");
+  }
+  rpc::PushActorChannelMessagesRequest request;
+  request.set_intended_worker_id(worker_id);
+  request.set_sender_actor_id(worker_context_.GetCurrentActorID().Binary());
+  request.set_channel_name(channel_name);
+  for (auto &message : messages) {
+    request.add_messages(std::move(message));
+  }
+  client->PushActorChannelMessages(
+      request, [on_ack](const Status &status,
+                        const rpc::PushActorChannelMessagesReply &reply) {
+        if (on_ack != nullptr) {
+          on_ack(status);
+        }
+      });
+  return Status::OK();
+}
+
 Status CoreWorker::KillActor(const ActorID &actor_id, bool force_kill, bool no_restart) {
   if (options_.is_local_mode) {
     return KillActorLocalMode(actor_id);
@@ -2189,9 +2546,9 @@ Status CoreWorker::AllocateReturnObject(const ObjectID &object_id,
       data_buffer = std::make_shared<LocalMemoryBuffer>(data_size);
       task_output_inlined_bytes += static_cast<int64_t>(data_size);
     } else {
-      RAY_RETURN_NOT_OK(CreateExisting(metadata, data_size, object_id, owner_address,
-                                       &data_buffer,
-                                       /*created_by_worker=*/true));
+      RAY_RETURN_NOT_OK(plasma_store_provider_->Create(
+          metadata, data_size, object_id, owner_address, &data_buffer,
+          /*created_by_worker=*/true, /*is_task_return=*/true));
       object_already_exists = !data_buffer;
     }
   }
@@ -2234,8 +2591,11 @@ Status CoreWorker::ExecuteTask(const TaskSpecification &task_spec,
   // execution and unpinned once the task completes. We will notify the caller
   // about any IDs that we are still borrowing by the time the task completes.
   std::vector<ObjectID> borrowed_ids;
-  RAY_CHECK_OK(
-      GetAndPinArgsForExecutor(task_spec, &args, &arg_reference_ids, &borrowed_ids));
+  {
+    ScopedSpan span("GetArgs", task_spec.TaskId());
+    RAY_CHECK_OK(
+        GetAndPinArgsForExecutor(task_spec, &args, &arg_reference_ids, &borrowed_ids));
+  }
 
   std::vector<ObjectID> return_ids;
   for (size_t i = 0; i < task_spec.NumReturns(); i++) {
@@ -2270,11 +2630,14 @@ Status CoreWorker::ExecuteTask(const TaskSpecification &task_spec,
 
   std::shared_ptr<LocalMemoryBuffer> creation_task_exception_pb_bytes = nullptr;
 
-  status = options_.task_execution_callback(
-      task_type, task_spec.GetName(), func,
-      task_spec.GetRequiredResources().GetResourceMap(), args, arg_reference_ids,
-      return_ids, task_spec.GetDebuggerBreakpoint(), return_objects,
-      creation_task_exception_pb_bytes);
+  {
+    ScopedSpan span("Execute", task_spec.TaskId());
+    status = options_.task_execution_callback(
+        task_type, task_spec.GetName(), func,
+        task_spec.GetRequiredResources().GetResourceMap(), args, arg_reference_ids,
+        return_ids, task_spec.GetDebuggerBreakpoint(), return_objects,
+        creation_task_exception_pb_bytes);
+  }
 
   // Get the reference counts for any IDs that we borrowed during this task and
   // return them to the caller. This will notify the caller of any IDs that we
@@ -2339,6 +2702,7 @@ Status CoreWorker::SealReturnObject(const ObjectID &return_id,
                              : std::make_unique<rpc::Address>(
                                    worker_context_.GetCurrentTask()->CallerAddress());
   if (return_object->GetData() != nullptr && return_object->GetData()->IsPlasmaBuffer()) {
+    ScopedSpan span("PutReturn", worker_context_.GetCurrentTaskID());
     status = SealExisting(return_id, /*pin_object=*/true, std::move(caller_address));
     if (!status.ok()) {
       RAY_LOG(FATAL) << "Failed to seal object " << return_id
@@ -2348,6 +2712,60 @@ Status CoreWorker::SealReturnObject(const ObjectID &return_id,
   return status;
 }
 
+Status CoreWorker::ReportGeneratorItemReturns(int64_t item_index,
+                                              const std::shared_ptr<RayObject> &item) {
+  const auto &task_spec = *worker_context_.GetCurrentTask();
+  if (!task_spec.IsStreamingGenerator()) {
+    return Status::Invalid("Task " + task_spec.TaskId().Hex() +
+                           " is not a streaming generator.");
+  }
+  if (options_.is_local_mode) {
+    return Status::NotImplemented(
+        "Streaming generators are not supported in local mode.");
+  }
+  rpc::ReportGeneratorItemReturnsRequest request;
+  request.set_generator_id(task_spec.TaskId().Binary());
+  request.mutable_worker_addr()->CopyFrom(rpc_address_);
+  request.set_item_index(item_index);
+  auto return_object = request.mutable_returned_object();
+  return_object->set_object_id(task_spec.GeneratorItemId(item_index).Binary());
+  return_object->set_size(item->GetSize());
+  if (item->GetData() != nullptr && item->GetData()->IsPlasmaBuffer()) {
+    return_object->set_in_plasma(true);
+  } else {
+    if (item->GetData() != nullptr) {
+      return_object->set_data(item->GetData()->Data(), item->GetData()->Size());
+    }
+    if (item->GetMetadata() != nullptr) {
+      return_object->set_metadata(item->GetMetadata()->Data(),
+                                  item->GetMetadata()->Size());
+    }
+  }
+  for (const auto &nested_ref : item->GetNestedRefs()) {
+    return_object->add_nested_inlined_refs()->CopyFrom(nested_ref);
+  }
+
+  auto conn = core_worker_client_pool_->GetOrConnect(task_spec.CallerAddress());
+  std::promise<Status> status_promise;
+  conn->ReportGeneratorItemReturns(
+      request, [&status_promise](const Status &returned_status,
+                                 const rpc::ReportGeneratorItemReturnsReply &reply) {
+        status_promise.set_value(returned_status);
+      });
+  // Block until the owner has the object, which keeps the objects in order and
+  // stops the task from running ahead of a slow owner.
+  return status_promise.get_future().get();
+}
+
+Status CoreWorker::TryReadObjectRefStream(const TaskID &generator_id,
+                                          ObjectID *object_id, bool *end_of_stream) {
+  return task_manager_->TryReadObjectRefStream(generator_id, object_id, end_of_stream);
+}
+
+void CoreWorker::DelObjectRefStream(const TaskID &generator_id) {
+  task_manager_->DelObjectRefStream(generator_id);
+}
+
 void CoreWorker::ExecuteTaskLocalMode(const TaskSpecification &task_spec,
                                       const ActorID &actor_id) {
   auto resource_ids = std::make_shared<ResourceMappingType>();
@@ -2467,6 +2885,12 @@ void CoreWorker::HandlePushTask(const rpc::PushTaskRequest &request,
     return;
   }
 
+  if (request.spec_template_id() != 0 &&
+      !ApplyTaskSpecTemplate(const_cast<rpc::PushTaskRequest *>(&request))) {
+    send_reply_callback(Status::Invalid("Unknown task spec template"), nullptr, nullptr);
+    return;
+  }
+
   // Increment the task_queue_length
   task_queue_length_ += 1;
 
@@ -2496,6 +2920,60 @@ void CoreWorker::HandlePushTask(const rpc::PushTaskRequest &request,
   }
 }
 
+bool CoreWorker::ApplyTaskSpecTemplate(rpc::PushTaskRequest *request) {
+  const auto caller_worker_id =
+      WorkerID::FromBinary(request->task_spec().caller_address().worker_id());
+  absl::MutexLock lock(&mutex_);
+  auto &caller_templates = spec_templates_[caller_worker_id];
+  if (request->defines_spec_template()) {
+    rpc::TaskSpec spec_template;
+    rpc::CopySpecTemplateFields(request->task_spec(), &spec_template);
+    caller_templates[request->spec_template_id()] = std::move(spec_template);
+    return true;
+  }
+  auto it = caller_templates.find(request->spec_template_id());
+  if (it == caller_templates.end()) {
+    RAY_LOG(WARNING) << "Received a task with unknown spec template "
+                     << request->spec_template_id() << " from worker "
+                     << caller_worker_id;
+    return false;
+  }
+  request->mutable_task_spec()->MergeFrom(it->second);
+  return true;
+}
+
+void CoreWorker::HandlePushTaskBatch(const rpc::PushTaskBatchRequest &request,
+                                     rpc::PushTaskBatchReply *reply,
+                                     rpc::SendReplyCallback send_reply_callback) {
+  const int num_tasks = request.requests_size();
+  if (num_tasks == 0) {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+    return;
+  }
+  for (int i = 0; i < num_tasks; i++) {
+    reply->add_replies();
+    reply->add_status_codes(static_cast<int>(StatusCode::OK));
+    reply->add_status_messages("");
+  }
+  // Each task is handled as if it was pushed on its own. Tasks may be replied to from
+  // different threads, so the number of pending replies is atomic.
+  auto num_pending = std::make_shared<std::atomic<int>>(num_tasks);
+  for (int i = 0; i < num_tasks; i++) {
+    HandlePushTask(request.requests(i), reply->mutable_replies(i),
+                   [reply, i, num_pending, send_reply_callback](
+                       Status status, std::function<void()> success,
+                       std::function<void()> failure) {
+                     if (!status.ok()) {
+                       reply->set_status_codes(i, static_cast<int>(status.code()));
+                       reply->set_status_messages(i, status.message());
+                     }
+                     if (num_pending->fetch_sub(1) == 1) {
+                       send_reply_callback(Status::OK(), nullptr, nullptr);
+                     }
+                   });
+  }
+}
+
 void CoreWorker::HandleStealTasks(const rpc::StealTasksRequest &request,
                                   rpc::StealTasksReply *reply,
                                   rpc::SendReplyCallback send_reply_callback) {
@@ -2568,6 +3046,40 @@ void CoreWorker::HandleGetObjectStatus(const rpc::GetObjectStatusRequest &reques
   RemoveLocalReference(object_id);
 }
 
+void CoreWorker::HandleGetObjectStatusBatch(
+    const rpc::GetObjectStatusBatchRequest &request,
+    rpc::GetObjectStatusBatchReply *reply, rpc::SendReplyCallback send_reply_callback) {
+  if (HandleWrongRecipient(WorkerID::FromBinary(request.owner_worker_id()),
+                           send_reply_callback)) {
+    return;
+  }
+  const int num_objects = request.object_ids_size();
+  if (num_objects == 0) {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+    return;
+  }
+  for (int i = 0; i < num_objects; i++) {
+    reply->add_replies();
+  }
+  // Each object is handled as if its status was requested on its own. Objects may
+  // become available on different threads, so the number of pending replies is
+  // atomic.
+  auto num_pending = std::make_shared<std::atomic<int>>(num_objects);
+  for (int i = 0; i < num_objects; i++) {
+    rpc::GetObjectStatusRequest object_request;
+    object_request.set_owner_worker_id(request.owner_worker_id());
+    object_request.set_object_id(request.object_ids(i));
+    HandleGetObjectStatus(
+        object_request, reply->mutable_replies(i),
+        [num_pending, send_reply_callback](Status status, std::function<void()> success,
+                                           std::function<void()> failure) {
+          if (num_pending->fetch_sub(1) == 1) {
+            send_reply_callback(Status::OK(), nullptr, nullptr);
+          }
+        });
+  }
+}
+
 void CoreWorker::PopulateObjectStatus(const ObjectID &object_id,
                                       std::shared_ptr<RayObject> obj,
                                       rpc::GetObjectStatusReply *reply) {
@@ -2750,6 +3262,39 @@ void CoreWorker::HandleRemoveObjectLocationOwner(
   send_reply_callback(status, nullptr, nullptr);
 }
 
+void CoreWorker::HandleUpdateObjectLocationBatch(
+    const rpc::UpdateObjectLocationBatchRequest &request,
+    rpc::UpdateObjectLocationBatchReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  if (HandleWrongRecipient(WorkerID::FromBinary(request.intended_worker_id()),
+                           send_reply_callback)) {
+    return;
+  }
+  // Coalesce the updates of each object, so that its subscribers get one message for
+  // the whole batch. A later update of the same location replaces an earlier one.
+  std::vector<ObjectID> object_ids;
+  absl::flat_hash_map<ObjectID, absl::flat_hash_map<NodeID, bool>> updates;
+  for (const auto &update : request.updates()) {
+    auto object_id = ObjectID::FromBinary(update.object_id());
+    if (update.pinned()) {
+      // The primary copy was migrated to the node, e.g. because its node is drained.
+      RAY_UNUSED(reference_counter_->MoveObjectPinnedAtRaylet(
+          object_id, NodeID::FromBinary(update.node_id())));
+    }
+    auto it = updates.find(object_id);
+    if (it == updates.end()) {
+      object_ids.push_back(object_id);
+      it = updates.emplace(object_id, absl::flat_hash_map<NodeID, bool>()).first;
+    }
+    it->second[NodeID::FromBinary(update.node_id())] = update.added();
+  }
+  for (const auto &object_id : object_ids) {
+    // Objects that went out of scope are skipped, as for single updates.
+    RAY_UNUSED(reference_counter_->UpdateObjectLocations(object_id, updates[object_id]));
+  }
+  send_reply_callback(Status::OK(), nullptr, nullptr);
+}
+
 void CoreWorker::ProcessSubscribeObjectLocations(
     const rpc::WorkerObjectLocationsSubMessage &message) {
   const auto intended_worker_id = WorkerID::FromBinary(message.intended_worker_id());
@@ -2772,16 +3317,20 @@ void CoreWorker::HandleGetObjectLocationsOwner(
     const rpc::GetObjectLocationsOwnerRequest &request,
     rpc::GetObjectLocationsOwnerReply *reply,
     rpc::SendReplyCallback send_reply_callback) {
-  auto &object_location_request = request.object_location_request();
-  if (HandleWrongRecipient(
-          WorkerID::FromBinary(object_location_request.intended_worker_id()),
-          send_reply_callback)) {
+  if (HandleWrongRecipient(WorkerID::FromBinary(request.intended_worker_id()),
+                           send_reply_callback)) {
     return;
   }
-  auto object_id = ObjectID::FromBinary(object_location_request.object_id());
-  auto object_info = reply->mutable_object_location_info();
-  auto status = reference_counter_->FillObjectInformation(object_id, object_info);
-  send_reply_callback(status, nullptr, nullptr);
+  for (const auto &object_id_binary : request.object_ids()) {
+    auto object_id = ObjectID::FromBinary(object_id_binary);
+    auto object_info = reply->add_object_location_infos();
+    // Objects that have already been freed are reported one by one, so that they
+    // don't fail the lookup of the other objects in the batch.
+    if (!reference_counter_->FillObjectInformation(object_id, object_info).ok()) {
+      object_info->set_ref_removed(true);
+    }
+  }
+  send_reply_callback(Status::OK(), nullptr, nullptr);
 }
 
 void CoreWorker::ProcessSubscribeForRefRemoved(
@@ -3088,6 +3637,26 @@ void CoreWorker::HandleExit(const rpc::ExitRequest &request, rpc::ExitReply *rep
                       [this]() { Exit(rpc::WorkerExitType::INTENDED_EXIT); });
 }
 
+void CoreWorker::HandleResetWorkerJob(const rpc::ResetWorkerJobRequest &request,
+                                      rpc::ResetWorkerJobReply *reply,
+                                      rpc::SendReplyCallback send_reply_callback) {
+  // Same idleness condition as for exiting: objects owned by this worker belong to the
+  // previous job, so the worker can't be handed to another job while it owns any.
+  bool is_idle = !reference_counter_->OwnObjects() &&
+                 local_raylet_client_->GetPinsInFlight() == 0;
+  bool can_reset = is_idle && options_.worker_type == WorkerType::WORKER &&
+                   worker_context_.GetCurrentActorID().IsNil();
+  if (can_reset) {
+    const auto job_id = JobID::FromBinary(request.job_id());
+    RAY_LOG(INFO) << "Rebinding worker from job " << worker_context_.GetCurrentJobID()
+                  << " to job " << job_id;
+    worker_context_.ResetJob(job_id);
+    job_config_->ParseFromString(request.serialized_job_config());
+  }
+  reply->set_success(can_reset);
+  send_reply_callback(Status::OK(), nullptr, nullptr);
+}
+
 void CoreWorker::HandleAssignObjectOwner(const rpc::AssignObjectOwnerRequest &request,
                                          rpc::AssignObjectOwnerReply *reply,
                                          rpc::SendReplyCallback send_reply_callback) {
@@ -3109,6 +3678,44 @@ void CoreWorker::HandleAssignObjectOwner(const rpc::AssignObjectOwnerRequest &re
   send_reply_callback(Status::OK(), nullptr, nullptr);
 }
 
+void CoreWorker::HandlePushActorChannelMessages(
+    const rpc::PushActorChannelMessagesRequest &request,
+    rpc::PushActorChannelMessagesReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  if (HandleWrongRecipient(WorkerID::FromBinary(request.intended_worker_id()),
+                           send_reply_callback)) {
+    return;
+  }
+  ActorChannelHandler handler;
+  {
+    absl::MutexLock lock(&actor_channel_mutex_);
+    auto it = actor_channel_handlers_.find(request.channel_name());
+    if (it != actor_channel_handlers_.end()) {
+      handler = it->second;
+    }
+  }
+  if (handler == nullptr) {
+    send_reply_callback(
+        Status::NotFound("No handler registered for actor channel " +
+                         request.channel_name()),
+        nullptr, nullptr);
+    return;
+  }
+  const auto sender_actor_id = ActorID::FromBinary(request.sender_actor_id());
+  for (const auto &message : request.messages()) {
+    handler(sender_actor_id, message);
+  }
+  send_reply_callback(Status::OK(), nullptr, nullptr);
+}
+
+void CoreWorker::HandleReportGeneratorItemReturns(
+    const rpc::ReportGeneratorItemReturnsRequest &request,
+    rpc::ReportGeneratorItemReturnsReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  task_manager_->HandleReportGeneratorItemReturns(request);
+  send_reply_callback(Status::OK(), nullptr, nullptr);
+}
+
 void CoreWorker::YieldCurrentFiber(FiberEvent &event) {
   RAY_CHECK(worker_context_.CurrentActorIsAsync());
   boost::this_fiber::yield();
@@ -220,7 +220,9 @@ struct CoreWorkerOptions {
 /// thread with a worker. You can obtain the worker ID via
 /// `CoreWorkerProcess::GetCoreWorker()->GetWorkerID()`. Currently a Java worker process
 /// starts multiple workers by default, but can be configured to start only 1 worker by
-/// speicifying `num_java_workers_per_process` in the job config.
+/// speicifying `num_java_workers_per_process` in the job config. A C++ worker process
+/// starts `num_cpp_workers_per_process` workers, 1 by default. The workers of a process
+/// can share one connection to the plasma store, see `core_worker_share_plasma_client`.
 ///
 /// If only 1 worker is started (either because the worker type is driver, or the
 /// `num_workers` in `CoreWorkerOptions` is set to 1), all threads will be automatically
@@ -344,6 +346,10 @@ class CoreWorkerProcess {
   // Client to the GCS shared by core worker interfaces.
   std::shared_ptr<gcs::GcsClient> gcs_client_;
 
+  /// Client to the plasma store shared by the workers of this process, if
+  /// `core_worker_share_plasma_client` is set and the process hosts more than 1 worker.
+  std::shared_ptr<plasma::PlasmaClient> plasma_client_;
+
   // Current node id.
   NodeID current_node_id_;
 };
@@ -357,7 +363,10 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   ///
   /// \param[in] options The various initialization options.
   /// \param[in] worker_id ID of this worker.
-  CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_id);
+  /// \param[in] shared_store_client The plasma client shared by the workers of the
+  /// process, or nullptr to connect one for this worker.
+  CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_id,
+             std::shared_ptr<plasma::PlasmaClient> shared_store_client = nullptr);
 
   CoreWorker(CoreWorker const &) = delete;
 
@@ -443,6 +452,12 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
     }
   }
 
+  /// Whether this worker still has any reference to the object, e.g. from the language
+  /// frontend, from a pending task or as a borrower.
+  bool HasReference(const ObjectID &object_id) const {
+    return reference_counter_->HasReference(object_id);
+  }
+
   /// Returns a map of all ObjectIDs currently in scope with a pair of their
   /// (local, submitted_task) reference counts. For debugging purposes.
   std::unordered_map<ObjectID, std::pair<size_t, size_t>> GetAllReferenceCounts() const;
@@ -663,6 +678,19 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   /// \return Status.
   Status Delete(const std::vector<ObjectID> &object_ids, bool local_only);
 
+  /// Keep extra pinned copies of a plasma object that we own on other nodes.
+  /// This trades object store memory for faster recovery: if the node with the
+  /// primary copy dies, a replica is pinned instead of re-executing the
+  /// object's lineage. Readers may also pull from any replica.
+  ///
+  /// \param[in] object_id ID of the object to replicate.
+  /// \param[in] num_replicas Number of extra copies to request. Nodes that
+  /// already hold a copy are skipped, so fewer replicas may be created if the
+  /// cluster does not have enough nodes.
+  /// \return Status::Invalid if we do not own the object or it is not in
+  /// plasma.
+  Status ReplicateObject(const ObjectID &object_id, int num_replicas);
+
   /// Get the locations of a list objects. Locations that failed to be retrieved
   /// will be returned as nullptrs.
   ///
@@ -730,6 +758,27 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
                   bool placement_group_capture_child_tasks,
                   const std::string &debugger_breakpoint);
 
+  /// Submit a batch of normal tasks of the same function and options. This is cheaper
+  /// than submitting them one by one, since the tasks are registered with the task
+  /// manager under one lock acquisition, and handed to the submitter in one event.
+  ///
+  /// \param[in] function The remote function to execute.
+  /// \param[in] args_list Arguments of each task.
+  /// \param[in] task_options Options for the tasks.
+  /// \param[out] return_ids Ids of the return objects of each task.
+  /// \param[in] max_retires max number of retry when a task fails.
+  /// \param[in] placement_options placement group options.
+  /// \param[in] placement_group_capture_child_tasks whether or not the submitted tasks
+  /// should capture parent's placement group implicilty.
+  /// \param[in] debugger_breakpoint breakpoint to drop into for the debugger after the
+  /// tasks start executing, or "" if we do not want to drop into the debugger.
+  void SubmitTasks(const RayFunction &function,
+                   const std::vector<std::vector<std::unique_ptr<TaskArg>>> &args_list,
+                   const TaskOptions &task_options,
+                   std::vector<std::vector<ObjectID>> *return_ids, int max_retries,
+                   BundleID placement_options, bool placement_group_capture_child_tasks,
+                   const std::string &debugger_breakpoint);
+
   /// Create an actor.
   ///
   /// \param[in] caller_id ID of the task submitter.
@@ -792,6 +841,41 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
                        const TaskOptions &task_options,
                        std::vector<ObjectID> *return_ids);
 
+  /// Handler for messages received on an actor channel. Called with the ID of
+  /// the sending actor and one message payload.
+  using ActorChannelHandler =
+      std::function<void(const ActorID &sender_actor_id, const std::string &message)>;
+
+  /// Register the handler for messages sent to this actor on a channel. This
+  /// replaces any handler previously registered under the same name.
+  ///
+  /// Channels are a lightweight alternative to actor tasks for high-rate
+  /// actor-to-actor communication: messages go straight over the existing
+  /// connection to the peer and skip task spec construction, task manager
+  /// bookkeeping and return objects. The handler runs on the core worker's
+  /// RPC thread and should not block.
+  ///
+  /// \param[in] channel_name The name of the channel.
+  /// \param[in] handler The handler, or nullptr to unregister the channel.
+  void RegisterActorChannelHandler(const std::string &channel_name,
+                                   ActorChannelHandler handler);
+
+  /// Send messages on a channel to another actor. Messages sent from one
+  /// worker to the same actor and channel are delivered in order as long as
+  /// the actor is not restarted in between.
+  ///
+  /// \param[in] actor_id The receiving actor. We must hold a handle to it.
+  /// \param[in] channel_name The name of the channel on the receiving actor.
+  /// \param[in] messages The message payloads.
+  /// \param[in] on_ack Optional callback invoked once the receiver has handed
+  /// the messages to its handler, or with an error if delivery failed. Pass
+  /// nullptr for fire-and-forget.
+  /// \return Status::NotFound if the actor is not currently connected.
+  Status SendActorChannelMessages(const ActorID &actor_id,
+                                  const std::string &channel_name,
+                                  std::vector<std::string> messages,
+                                  std::function<void(Status)> on_ack = nullptr);
+
   /// Tell an actor to exit immediately, without completing outstanding work.
   ///
   /// \param[in] actor_id ID of the actor to kill.
@@ -891,6 +975,27 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   Status SealReturnObject(const ObjectID &return_id,
                           std::shared_ptr<RayObject> return_object);
 
+  /// Report an object the executing streaming generator task yielded to the owner of
+  /// the task, so that the caller can use it before the task finishes. The object
+  /// must be allocated and sealed like a return object, with the ID from
+  /// `TaskSpecification::GeneratorItemId`. This blocks until the owner received the
+  /// object, so the objects arrive in order and before the task reply.
+  ///
+  /// \param[in] item_index The index of the object among the yielded objects.
+  /// \param[in] item The sealed object.
+  /// \return Status.
+  Status ReportGeneratorItemReturns(int64_t item_index,
+                                    const std::shared_ptr<RayObject> &item);
+
+  /// Read the next object a streaming generator task that we submitted yielded. See
+  /// `TaskManager::TryReadObjectRefStream`.
+  Status TryReadObjectRefStream(const TaskID &generator_id, ObjectID *object_id,
+                                bool *end_of_stream);
+
+  /// Delete the object ref stream of a streaming generator task that we submitted,
+  /// once the caller does not read it anymore.
+  void DelObjectRefStream(const TaskID &generator_id);
+
   /// Get a handle to an actor.
   ///
   /// NOTE: This function should be called ONLY WHEN we know actor handle exists.
@@ -933,6 +1038,11 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   void HandlePushTask(const rpc::PushTaskRequest &request, rpc::PushTaskReply *reply,
                       rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Implements gRPC server handler.
+  void HandlePushTaskBatch(const rpc::PushTaskBatchRequest &request,
+                           rpc::PushTaskBatchReply *reply,
+                           rpc::SendReplyCallback send_reply_callback) override;
+
   /// Implements gRPC server handler.
   void HandleStealTasks(const rpc::StealTasksRequest &request,
                         rpc::StealTasksReply *reply,
@@ -949,6 +1059,11 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
                              rpc::GetObjectStatusReply *reply,
                              rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Implements gRPC server handler.
+  void HandleGetObjectStatusBatch(const rpc::GetObjectStatusBatchRequest &request,
+                                  rpc::GetObjectStatusBatchReply *reply,
+                                  rpc::SendReplyCallback send_reply_callback) override;
+
   /// Implements gRPC server handler.
   void HandleWaitForActorOutOfScope(const rpc::WaitForActorOutOfScopeRequest &request,
                                     rpc::WaitForActorOutOfScopeReply *reply,
@@ -975,6 +1090,12 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
       rpc::RemoveObjectLocationOwnerReply *reply,
       rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Implements gRPC server handler.
+  void HandleUpdateObjectLocationBatch(
+      const rpc::UpdateObjectLocationBatchRequest &request,
+      rpc::UpdateObjectLocationBatchReply *reply,
+      rpc::SendReplyCallback send_reply_callback) override;
+
   /// Implements gRPC server handler.
   void HandleGetObjectLocationsOwner(const rpc::GetObjectLocationsOwnerRequest &request,
                                      rpc::GetObjectLocationsOwnerReply *reply,
@@ -1038,12 +1159,29 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   void HandleExit(const rpc::ExitRequest &request, rpc::ExitReply *reply,
                   rpc::SendReplyCallback send_reply_callback) override;
 
+  // Rebind this idle worker to another job, so that the raylet can reuse it for the
+  // tasks of that job. This request fails if the worker owns any object or is an actor.
+  void HandleResetWorkerJob(const rpc::ResetWorkerJobRequest &request,
+                            rpc::ResetWorkerJobReply *reply,
+                            rpc::SendReplyCallback send_reply_callback) override;
+
   // Set local worker as the owner of object.
   // Request by borrower's worker, execute by owner's worker.
   void HandleAssignObjectOwner(const rpc::AssignObjectOwnerRequest &request,
                                rpc::AssignObjectOwnerReply *reply,
                                rpc::SendReplyCallback send_reply_callback) override;
 
+  // Deliver actor channel messages to the handler registered for the channel.
+  void HandlePushActorChannelMessages(const rpc::PushActorChannelMessagesRequest &request,
+                                      rpc::PushActorChannelMessagesReply *reply,
+                                      rpc::SendReplyCallback send_reply_callback) override;
+
+  // Add an object a streaming generator task we own yielded to the task's stream.
+  void HandleReportGeneratorItemReturns(
+      const rpc::ReportGeneratorItemReturnsRequest &request,
+      rpc::ReportGeneratorItemReturnsReply *reply,
+      rpc::SendReplyCallback send_reply_callback) override;
+
   ///
   /// Public methods related to async actor call. This should only be used when
   /// the actor is (1) direct actor and (2) using asyncio mode.
@@ -1094,6 +1232,10 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   /// Check if the raylet has failed. If so, shutdown.
   void CheckForRayletFailure();
 
+  /// Fetch the resource usage of all nodes from the GCS, and update the node loads
+  /// used by locality-aware leasing.
+  void RefreshNodeLoads();
+
   /// Heartbeat for internal bookkeeping.
   void InternalHeartbeat();
 
@@ -1221,6 +1363,31 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   /// messages.
   void ProcessPubsubCommands(const Commands &commands, const NodeID &subscriber_id);
 
+  /// Get the arena to build the next submitted task spec in, starting a new one every
+  /// task_spec_arena_num_tasks specs.
+  ///
+  /// \return The arena, or null if task specs should be allocated on the heap.
+  std::shared_ptr<google::protobuf::Arena> NextTaskSpecArena();
+
+  /// Pass a large argument passed by value by reference instead, to a plasma object
+  /// that is shared by all the tasks passing the same content within
+  /// task_arg_dedup_window_ms.
+  ///
+  /// \param[in] arg The argument of a task being submitted.
+  /// \return The argument to submit instead, or null to submit the argument as is.
+  std::unique_ptr<TaskArg> DeduplicateTaskArg(const TaskArg &arg)
+      LOCKS_EXCLUDED(deduplicated_task_args_mutex_);
+
+  /// Release the plasma objects of the deduplicated task arguments whose window ended.
+  void ReleaseExpiredTaskArgs() LOCKS_EXCLUDED(deduplicated_task_args_mutex_);
+
+  /// Fill in the template fields of a pushed task spec from the caller's template, or
+  /// cache the template if the request defines it.
+  ///
+  /// \param[in,out] request The pushed task, with a non-zero spec_template_id.
+  /// \return False if the request refers to a template that was never defined.
+  bool ApplyTaskSpecTemplate(rpc::PushTaskRequest *request);
+
   /// Returns whether the message was sent to the wrong worker. The right error reply
   /// is sent automatically. Messages end up on the wrong worker when a worker dies
   /// and a new one takes its place with the same place. In this situation, we want
@@ -1274,7 +1441,7 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   TaskID main_thread_task_id_ GUARDED_BY(mutex_);
 
   /// Event loop where the IO events are handled. e.g. async GCS operations.
-  instrumented_io_context io_service_;
+  instrumented_io_context io_service_{"core_worker_io"};
 
   /// Keeps the io_service_ alive.
   boost::asio::io_service::work io_work_;
@@ -1288,6 +1455,15 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   /// The runner to run function periodically.
   PeriodicalRunner periodical_runner_;
 
+  /// Protects node_loads_, which is read by the lease policy from the submitting
+  /// threads.
+  absl::Mutex node_loads_mutex_;
+
+  /// Recent load of each node, as the fraction of its CPUs that are in use or
+  /// demanded by queued tasks. Only refreshed if locality-aware leasing weighs the
+  /// load of the nodes.
+  absl::flat_hash_map<NodeID, double> node_loads_ GUARDED_BY(node_loads_mutex_);
+
   /// RPC server used to receive tasks to execute.
   std::unique_ptr<rpc::GrpcServer> core_worker_server_;
 
@@ -1374,6 +1550,28 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   /// we cannot access the thread-local worker contexts from GetCoreWorkerStats()
   TaskSpecification current_task_ GUARDED_BY(mutex_);
 
+  /// The arena that submitted task specs are currently built in, and the number of
+  /// specs built in it so far.
+  std::shared_ptr<google::protobuf::Arena> task_spec_arena_ GUARDED_BY(mutex_);
+  uint32_t task_spec_arena_num_tasks_ GUARDED_BY(mutex_) = 0;
+
+  /// The fingerprint of a deduplicated task argument: two hashes of its data, and its
+  /// metadata.
+  using DeduplicatedTaskArgKey = std::tuple<uint64_t, uint64_t, std::string>;
+
+  /// Protects deduplicated_task_args_.
+  absl::Mutex deduplicated_task_args_mutex_;
+
+  /// The plasma objects put for large task arguments, with the time until which later
+  /// tasks passing the same content reuse them.
+  absl::flat_hash_map<DeduplicatedTaskArgKey, std::pair<ObjectID, int64_t>>
+      deduplicated_task_args_ GUARDED_BY(deduplicated_task_args_mutex_);
+
+  /// Task spec templates defined by the workers that push tasks to us, keyed by the
+  /// caller's worker ID and the template ID. See PushTaskRequest.spec_template_id.
+  absl::flat_hash_map<WorkerID, absl::flat_hash_map<int64_t, rpc::TaskSpec>>
+      spec_templates_ GUARDED_BY(mutex_);
+
   /// Key value pairs to be displayed on Web UI.
   std::unordered_map<std::string, std::string> webui_display_ GUARDED_BY(mutex_);
 
@@ -1387,7 +1585,7 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   std::atomic<int64_t> num_executed_tasks_;
 
   /// Event loop where tasks are processed.
-  instrumented_io_context task_execution_service_;
+  instrumented_io_context task_execution_service_{"core_worker_task_execution"};
 
   /// The asio work to keep task_execution_service_ alive.
   boost::asio::io_service::work task_execution_service_work_;
@@ -1413,6 +1611,13 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   // Queue of tasks to resubmit when the specified time passes.
   std::deque<std::pair<int64_t, TaskSpecification>> to_resubmit_ GUARDED_BY(mutex_);
 
+  // Guard for `actor_channel_handlers_` map.
+  mutable absl::Mutex actor_channel_mutex_;
+
+  // Handlers for messages received on each actor channel, keyed by channel name.
+  absl::flat_hash_map<std::string, ActorChannelHandler> actor_channel_handlers_
+      GUARDED_BY(actor_channel_mutex_);
+
   /// Map of named actor registry. It doesn't need to hold a lock because
   /// local mode is single-threaded.
   absl::flat_hash_map<std::string, ActorID> local_mode_named_actor_registry_;
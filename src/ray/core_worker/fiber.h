@@ -15,6 +15,8 @@
 #pragma once
 
 #include <boost/fiber/all.hpp>
+#include <deque>
+#include <memory>
 
 #include "ray/util/logging.h"
 namespace ray {
@@ -83,27 +85,79 @@ using FiberChannel = boost::fibers::unbuffered_channel<std::function<void()>>;
 
 class FiberState {
  public:
-  FiberState(int max_concurrency) : rate_limiter_(max_concurrency) {
+  /// \param max_concurrency The maximum number of fibers running at once.
+  /// \param stack_size If non-zero, the stack size of each fiber in bytes. Stacks
+  /// are then pooled and reused across fibers instead of being allocated per call.
+  FiberState(int max_concurrency, size_t stack_size = 0)
+      : rate_limiter_(max_concurrency) {
     fiber_runner_thread_ =
         std::thread(
-            [&]() {
-              while (!channel_.is_closed()) {
+            [&, stack_size]() {
+              // Only this thread creates fibers, so the stack pool needs no locking.
+              std::unique_ptr<boost::fibers::pooled_fixedsize_stack> stack_pool;
+              if (stack_size > 0) {
+                stack_pool =
+                    std::make_unique<boost::fibers::pooled_fixedsize_stack>(stack_size);
+              }
+              // Drain the channel into a local queue from a separate fiber, so that
+              // the submitter never waits for a free slot.
+              boost::fibers::fiber receiver([&]() {
+                while (!channel_.is_closed()) {
+                  std::function<void()> func;
+                  auto op_status = channel_.pop(func);
+                  if (op_status == boost::fibers::channel_op_status::success) {
+                    {
+                      std::unique_lock<boost::fibers::mutex> lock(pending_mutex_);
+                      pending_.push_back(std::move(func));
+                    }
+                    pending_cond_.notify_one();
+                  } else if (op_status == boost::fibers::channel_op_status::closed) {
+                    // The channel was closed. We will just exit the loop and finish
+                    // cleanup.
+                    break;
+                  } else {
+                    RAY_LOG(ERROR)
+                        << "Async actor fiber channel returned unexpected error code, "
+                        << "shutting down the worker thread. Please submit a github "
+                        << "issue at https://github.com/ray-project/ray";
+                    break;
+                  }
+                }
+                {
+                  std::unique_lock<boost::fibers::mutex> lock(pending_mutex_);
+                  receiver_done_ = true;
+                }
+                pending_cond_.notify_one();
+              });
+
+              while (true) {
                 std::function<void()> func;
-                auto op_status = channel_.pop(func);
-                if (op_status == boost::fibers::channel_op_status::success) {
-                  boost::fibers::fiber(boost::fibers::launch::dispatch, func).detach();
-                } else if (op_status == boost::fibers::channel_op_status::closed) {
-                  // The channel was closed. We will just exit the loop and finish
-                  // cleanup.
-                  break;
+                {
+                  std::unique_lock<boost::fibers::mutex> lock(pending_mutex_);
+                  pending_cond_.wait(
+                      lock, [this]() { return receiver_done_ || !pending_.empty(); });
+                  if (receiver_done_) {
+                    break;
+                  }
+                  func = std::move(pending_.front());
+                  pending_.pop_front();
+                }
+                // Take a slot before creating the fiber, so that calls waiting for a
+                // slot do not each hold a fiber stack.
+                rate_limiter_.Acquire();
+                auto run = [this, func]() {
+                  func();
+                  rate_limiter_.Release();
+                };
+                if (stack_pool != nullptr) {
+                  boost::fibers::fiber(std::allocator_arg, *stack_pool,
+                                       boost::fibers::launch::dispatch, run)
+                      .detach();
                 } else {
-                  RAY_LOG(ERROR)
-                      << "Async actor fiber channel returned unexpected error code, "
-                      << "shutting down the worker thread. Please submit a github issue "
-                      << "at https://github.com/ray-project/ray";
-                  return;
+                  boost::fibers::fiber(boost::fibers::launch::dispatch, run).detach();
                 }
               }
+              receiver.join();
               // The event here is used to make sure fiber_runner_thread_ never
               // terminates. Because fiber_shutdown_event_ is never notified,
               // fiber_runner_thread_ will immediately start working on any ready fibers.
@@ -112,11 +166,7 @@ class FiberState {
   }
 
   void EnqueueFiber(std::function<void()> &&callback) {
-    auto op_status = channel_.push([this, callback]() {
-      rate_limiter_.Acquire();
-      callback();
-      rate_limiter_.Release();
-    });
+    auto op_status = channel_.push(std::move(callback));
     RAY_CHECK(op_status == boost::fibers::channel_op_status::success);
   }
 
@@ -135,6 +185,15 @@ class FiberState {
   /// The fiber semaphore used to limit the number of concurrent fibers
   /// running at once.
   FiberRateLimiter rate_limiter_;
+  /// Calls received from channel_ that are waiting for a slot in rate_limiter_.
+  /// Only touched from fiber_runner_thread_.
+  std::deque<std::function<void()>> pending_;
+  /// Protects pending_ and receiver_done_ between the fibers of fiber_runner_thread_.
+  boost::fibers::mutex pending_mutex_;
+  /// Notified when pending_ or receiver_done_ changes.
+  boost::fibers::condition_variable pending_cond_;
+  /// Whether channel_ has been closed and drained.
+  bool receiver_done_ = false;
   /// The fiber event used to block fiber_runner_thread_ from shutdown.
   /// is_asyncio_ must be true.
   FiberEvent shutdown_worker_event_;
@@ -14,6 +14,8 @@
 
 #include "ray/core_worker/future_resolver.h"
 
+#include <algorithm>
+
 namespace ray {
 namespace core {
 
@@ -24,6 +26,20 @@ void FutureResolver::ResolveFutureAsync(const ObjectID &object_id,
     // with a borrowed reference executes on the object's owning worker.
     return;
   }
+  if (max_batch_size_ > 1) {
+    bool flush_scheduled;
+    {
+      absl::MutexLock lock(&mu_);
+      flush_scheduled = !pending_batches_.empty();
+      auto &batch = pending_batches_[WorkerID::FromBinary(owner_address.worker_id())];
+      batch.owner_address = owner_address;
+      batch.object_ids.push_back(object_id);
+    }
+    if (!flush_scheduled) {
+      io_service_.post([this]() { FlushBatches(); }, "FutureResolver.FlushBatches");
+    }
+    return;
+  }
   auto conn = owner_clients_->GetOrConnect(owner_address);
 
   rpc::GetObjectStatusRequest request;
@@ -36,6 +52,48 @@ void FutureResolver::ResolveFutureAsync(const ObjectID &object_id,
       });
 }
 
+void FutureResolver::FlushBatches() {
+  absl::flat_hash_map<WorkerID, OwnerBatch> batches;
+  {
+    absl::MutexLock lock(&mu_);
+    batches.swap(pending_batches_);
+  }
+  for (auto &entry : batches) {
+    auto &batch = entry.second;
+    for (size_t start = 0; start < batch.object_ids.size(); start += max_batch_size_) {
+      size_t end = std::min<size_t>(start + max_batch_size_, batch.object_ids.size());
+      SendBatch(batch.owner_address,
+                std::vector<ObjectID>(batch.object_ids.begin() + start,
+                                      batch.object_ids.begin() + end));
+    }
+  }
+}
+
+void FutureResolver::SendBatch(const rpc::Address &owner_address,
+                               std::vector<ObjectID> object_ids) {
+  auto conn = owner_clients_->GetOrConnect(owner_address);
+  rpc::GetObjectStatusBatchRequest request;
+  request.set_owner_worker_id(owner_address.worker_id());
+  for (const auto &object_id : object_ids) {
+    request.add_object_ids(object_id.Binary());
+  }
+  conn->GetObjectStatusBatch(
+      request, [this, object_ids = std::move(object_ids), owner_address](
+                   const Status &status, const rpc::GetObjectStatusBatchReply &reply) {
+        for (size_t i = 0; i < object_ids.size(); i++) {
+          if (status.ok() && static_cast<int>(i) < reply.replies_size()) {
+            ProcessResolvedObject(object_ids[i], owner_address, status,
+                                  reply.replies(i));
+          } else {
+            ProcessResolvedObject(object_ids[i], owner_address,
+                                  status.ok() ? Status::IOError("Missing object status")
+                                              : status,
+                                  rpc::GetObjectStatusReply());
+          }
+        }
+      });
+}
+
 void FutureResolver::ProcessResolvedObject(const ObjectID &object_id,
                                            const rpc::Address &owner_address,
                                            const Status &status,
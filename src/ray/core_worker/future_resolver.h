@@ -15,7 +15,11 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "ray/common/asio/instrumented_io_context.h"
 #include "ray/common/grpc_util.h"
 #include "ray/common/id.h"
 #include "ray/core_worker/store_provider/memory_store/memory_store.h"
@@ -37,17 +41,21 @@ class FutureResolver {
                  std::shared_ptr<ReferenceCounter> ref_counter,
                  ReportLocalityDataCallback report_locality_data_callback,
                  std::shared_ptr<rpc::CoreWorkerClientPool> core_worker_client_pool,
-                 const rpc::Address &rpc_address)
+                 const rpc::Address &rpc_address, instrumented_io_context &io_service,
+                 uint32_t max_batch_size = 1)
       : in_memory_store_(store),
         reference_counter_(ref_counter),
         report_locality_data_callback_(std::move(report_locality_data_callback)),
         owner_clients_(core_worker_client_pool),
-        rpc_address_(rpc_address) {}
+        rpc_address_(rpc_address),
+        io_service_(io_service),
+        max_batch_size_(max_batch_size) {}
 
   /// Resolve the value for a future. This will periodically contact the given
   /// owner until the owner dies or the owner has finished creating the object.
   /// In either case, this will put an OBJECT_IN_PLASMA error as the future's
-  /// value.
+  /// value. If batching is enabled, the futures of the same owner that are
+  /// resolved in the same event loop tick share a request.
   ///
   /// \param[in] object_id The ID of the future to resolve.
   /// \param[in] owner_address The address of the task or actor that owns the
@@ -65,6 +73,19 @@ class FutureResolver {
                              const rpc::GetObjectStatusReply &object_status);
 
  private:
+  /// Futures of one owner that wait to be sent in a batch.
+  struct OwnerBatch {
+    rpc::Address owner_address;
+    std::vector<ObjectID> object_ids;
+  };
+
+  /// Send the status requests of all batched futures.
+  void FlushBatches();
+
+  /// Ask an owner about the status of a batch of its futures.
+  void SendBatch(const rpc::Address &owner_address,
+                 std::vector<ObjectID> object_ids);
+
   /// Used to store values of resolved futures.
   std::shared_ptr<CoreWorkerMemoryStore> in_memory_store_;
 
@@ -81,6 +102,17 @@ class FutureResolver {
   /// address, so the owner can contact us to ask when our reference to the
   /// object has gone out of scope.
   const rpc::Address rpc_address_;
+
+  /// Event loop that batched requests are flushed on.
+  instrumented_io_context &io_service_;
+
+  /// The maximum number of futures in one status request.
+  const uint32_t max_batch_size_;
+
+  absl::Mutex mu_;
+
+  /// Futures waiting for the next flush, by owner.
+  absl::flat_hash_map<WorkerID, OwnerBatch> pending_batches_ GUARDED_BY(mu_);
 };
 
 }  // namespace core
@@ -14,10 +14,16 @@
 
 #include "ray/core_worker/lease_policy.h"
 
+#include <algorithm>
+
 namespace ray {
 namespace core {
 
 rpc::Address LocalityAwareLeasePolicy::GetBestNodeForTask(const TaskSpecification &spec) {
+  // All tasks of a gang must be queued at the same raylet to be placed together.
+  if (spec.IsGangTask()) {
+    return fallback_rpc_address_;
+  }
   if (auto node_id = GetBestNodeIdForTask(spec)) {
     if (auto addr = node_addr_factory_(node_id.value())) {
       return addr.value();
@@ -27,6 +33,8 @@ rpc::Address LocalityAwareLeasePolicy::GetBestNodeForTask(const TaskSpecificatio
 }
 
 /// Criteria for "best" node: The node with the most object bytes (from object_ids) local.
+/// If a cap or a load penalty is configured, the node with the highest score instead,
+/// where the score is the local bytes up to the cap, less the penalty times the load.
 absl::optional<NodeID> LocalityAwareLeasePolicy::GetBestNodeIdForTask(
     const TaskSpecification &spec) {
   const auto object_ids = spec.GetDependencyIds();
@@ -51,7 +59,27 @@ absl::optional<NodeID> LocalityAwareLeasePolicy::GetBestNodeIdForTask(
                        << ", won't be included in locality cost";
     }
   }
-  return max_bytes_node;
+  if (max_locality_bytes_ == 0 &&
+      (node_load_provider_ == nullptr || load_penalty_bytes_ == 0)) {
+    return max_bytes_node;
+  }
+  double max_score = 0;
+  absl::optional<NodeID> max_score_node;
+  for (const auto &entry : bytes_local_table) {
+    double score = max_locality_bytes_ > 0
+                       ? std::min(entry.second, max_locality_bytes_)
+                       : entry.second;
+    if (node_load_provider_ != nullptr && load_penalty_bytes_ > 0) {
+      if (auto load = node_load_provider_(entry.first)) {
+        score -= load.value() * load_penalty_bytes_;
+      }
+    }
+    if (!max_score_node.has_value() || score > max_score) {
+      max_score = score;
+      max_score_node = entry.first;
+    }
+  }
+  return max_score_node;
 }
 
 rpc::Address LocalLeasePolicy::GetBestNodeForTask(const TaskSpecification &spec) {
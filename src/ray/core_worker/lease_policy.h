@@ -49,16 +49,30 @@ class LeasePolicyInterface {
 using NodeAddrFactory =
     std::function<absl::optional<rpc::Address>(const NodeID &node_id)>;
 
+/// Returns the recent load of a node, as the fraction of its CPUs that are in use or
+/// demanded by queued tasks, or nullopt if the load of the node is unknown.
+using NodeLoadProvider = std::function<absl::optional<double>(const NodeID &node_id)>;
+
 /// Class used by the core worker to implement a locality-aware lease policy for
 /// picking a worker node for a lease request. This class is not thread-safe.
 class LocalityAwareLeasePolicy : public LeasePolicyInterface {
  public:
+  /// \param node_load_provider Recent load of the nodes, nullptr to ignore the load.
+  /// \param max_locality_bytes Local bytes beyond this don't make a node a better
+  /// choice, 0 for no cap.
+  /// \param load_penalty_bytes How many local bytes a fully loaded node is worth less
+  /// than an idle one, 0 to ignore the load.
   LocalityAwareLeasePolicy(
       std::shared_ptr<LocalityDataProviderInterface> locality_data_provider,
-      NodeAddrFactory node_addr_factory, const rpc::Address fallback_rpc_address)
+      NodeAddrFactory node_addr_factory, const rpc::Address fallback_rpc_address,
+      NodeLoadProvider node_load_provider = nullptr, uint64_t max_locality_bytes = 0,
+      uint64_t load_penalty_bytes = 0)
       : locality_data_provider_(locality_data_provider),
         node_addr_factory_(node_addr_factory),
-        fallback_rpc_address_(fallback_rpc_address) {}
+        fallback_rpc_address_(fallback_rpc_address),
+        node_load_provider_(node_load_provider),
+        max_locality_bytes_(max_locality_bytes),
+        load_penalty_bytes_(load_penalty_bytes) {}
 
   ~LocalityAwareLeasePolicy() {}
 
@@ -77,6 +91,15 @@ class LocalityAwareLeasePolicy : public LeasePolicyInterface {
 
   /// RPC address of fallback node (usually the local node).
   const rpc::Address fallback_rpc_address_;
+
+  /// Provider of the recent load of the nodes, may be nullptr.
+  NodeLoadProvider node_load_provider_;
+
+  /// Cap on the local bytes counted for a node, 0 for no cap.
+  const uint64_t max_locality_bytes_;
+
+  /// Local bytes subtracted from the score of a node per unit of load.
+  const uint64_t load_penalty_bytes_;
 };
 
 /// Class used by the core worker to implement a local-only lease policy for picking
@@ -181,8 +181,7 @@ JNIEXPORT void JNICALL Java_io_ray_runtime_RayNativeRuntime_nativeInitialize(
             auto result = *result_ptr;
             if (result != nullptr) {
               if (result->HasData()) {
-                memcpy(result->GetData()->Data(), return_objects[i]->GetData()->Data(),
-                       data_size);
+                CopyBufferData(return_objects[i]->GetData(), result->GetData()->Data());
               }
             }
 
@@ -57,7 +57,7 @@ Status PutSerializedObject(JNIEnv *env, jobject obj, ObjectID object_id,
   // here.
   if (data != nullptr) {
     if (data->Size() > 0) {
-      memcpy(data->Data(), native_ray_object->GetData()->Data(), data->Size());
+      CopyBufferData(native_ray_object->GetData(), data->Data());
     }
     if (object_id.IsNil()) {
       RAY_CHECK_OK(CoreWorkerProcess::GetCoreWorker().SealOwned(
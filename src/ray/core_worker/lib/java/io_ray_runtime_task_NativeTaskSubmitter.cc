@@ -320,6 +320,34 @@ JNIEXPORT jobject JNICALL Java_io_ray_runtime_task_NativeTaskSubmitter_nativeSub
   return NativeIdVectorToJavaByteArrayList(env, return_ids);
 }
 
+JNIEXPORT jobject JNICALL Java_io_ray_runtime_task_NativeTaskSubmitter_nativeSubmitTasks(
+    JNIEnv *env, jclass p, jobject functionDescriptor, jint functionDescriptorHash,
+    jobject argsList, jint numReturns, jobject callOptions) {
+  // The function and the options are shared by all the tasks, so they are converted
+  // only once for the whole batch.
+  const auto &ray_function =
+      ToRayFunction(env, functionDescriptor, functionDescriptorHash);
+  std::vector<std::vector<std::unique_ptr<TaskArg>>> task_args_list;
+  JavaListToNativeVector<std::vector<std::unique_ptr<TaskArg>>>(
+      env, argsList, &task_args_list,
+      [](JNIEnv *env, jobject args) { return ToTaskArgs(env, args); });
+  auto task_options = ToTaskOptions(env, numReturns, callOptions);
+  auto placement_group_options = ToPlacementGroupOptions(env, callOptions);
+
+  std::vector<std::vector<ObjectID>> return_ids_list;
+  CoreWorkerProcess::GetCoreWorker().SubmitTasks(
+      ray_function, task_args_list, task_options, &return_ids_list,
+      /*max_retries=*/0,
+      /*placement_options=*/placement_group_options,
+      /*placement_group_capture_child_tasks=*/true,
+      /*debugger_breakpoint*/ "");
+
+  return NativeVectorToJavaList<std::vector<ObjectID>>(
+      env, return_ids_list, [](JNIEnv *env, const std::vector<ObjectID> &return_ids) {
+        return NativeIdVectorToJavaByteArrayList(env, return_ids);
+      });
+}
+
 JNIEXPORT jbyteArray JNICALL
 Java_io_ray_runtime_task_NativeTaskSubmitter_nativeCreateActor(
     JNIEnv *env, jclass p, jobject functionDescriptor, jint functionDescriptorHash,
@@ -277,16 +277,21 @@ extern JavaVM *jvm;
   }
 
 /// Represents a byte buffer of Java byte array.
+/// The elements of the array are only fetched to native memory when `Data()` is first
+/// called, so a buffer that is only copied with `CopyTo` costs a single copy.
 /// The destructor will automatically call ReleaseByteArrayElements.
 /// NOTE: Instances of this class cannot be used across threads.
 class JavaByteArrayBuffer : public Buffer {
  public:
   JavaByteArrayBuffer(JNIEnv *env, jbyteArray java_byte_array)
-      : env_(env), java_byte_array_(java_byte_array) {
-    native_bytes_ = env_->GetByteArrayElements(java_byte_array_, nullptr);
-  }
+      : env_(env), java_byte_array_(java_byte_array), native_bytes_(nullptr) {}
 
-  uint8_t *Data() const override { return reinterpret_cast<uint8_t *>(native_bytes_); }
+  uint8_t *Data() const override {
+    if (native_bytes_ == nullptr) {
+      native_bytes_ = env_->GetByteArrayElements(java_byte_array_, nullptr);
+    }
+    return reinterpret_cast<uint8_t *>(native_bytes_);
+  }
 
   size_t Size() const override { return env_->GetArrayLength(java_byte_array_); }
 
@@ -294,17 +299,41 @@ class JavaByteArrayBuffer : public Buffer {
 
   bool IsPlasmaBuffer() const override { return false; }
 
+  /// Copy the elements of the array to `dest`, which must hold `Size()` bytes.
+  void CopyTo(uint8_t *dest) const {
+    if (native_bytes_ != nullptr) {
+      memcpy(dest, native_bytes_, Size());
+    } else {
+      env_->GetByteArrayRegion(java_byte_array_, 0, Size(),
+                               reinterpret_cast<jbyte *>(dest));
+    }
+  }
+
   ~JavaByteArrayBuffer() {
-    env_->ReleaseByteArrayElements(java_byte_array_, native_bytes_, JNI_ABORT);
+    if (native_bytes_ != nullptr) {
+      env_->ReleaseByteArrayElements(java_byte_array_, native_bytes_, JNI_ABORT);
+    }
     env_->DeleteLocalRef(java_byte_array_);
   }
 
  private:
   JNIEnv *env_;
   jbyteArray java_byte_array_;
-  jbyte *native_bytes_;
+  mutable jbyte *native_bytes_;
 };
 
+/// Copy the data of a buffer to `dest`, which must hold `buffer->Size()` bytes. A buffer
+/// of a Java byte array is copied from the array directly, instead of through a native
+/// copy of its elements.
+inline void CopyBufferData(const std::shared_ptr<Buffer> &buffer, uint8_t *dest) {
+  auto java_buffer = std::dynamic_pointer_cast<JavaByteArrayBuffer>(buffer);
+  if (java_buffer) {
+    java_buffer->CopyTo(dest);
+  } else {
+    memcpy(dest, buffer->Data(), buffer->Size());
+  }
+}
+
 /// Convert a Java byte array to a C++ string.
 inline std::string JavaByteArrayToNativeString(JNIEnv *env, const jbyteArray &bytes) {
   const auto size = env->GetArrayLength(bytes);
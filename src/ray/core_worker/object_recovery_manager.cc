@@ -20,71 +20,158 @@ namespace ray {
 namespace core {
 
 bool ObjectRecoveryManager::RecoverObject(const ObjectID &object_id) {
-  // Check the ReferenceCounter to see if there is a location for the object.
-  bool owned_by_us = false;
-  NodeID pinned_at;
-  bool spilled = false;
-  bool ref_exists = reference_counter_->IsPlasmaObjectPinnedOrSpilled(
-      object_id, &owned_by_us, &pinned_at, &spilled);
-  if (!ref_exists) {
-    // References that have gone out of scope cannot be recovered.
-    return false;
-  }
+  std::vector<ObjectID> unrecoverable;
+  RecoverObjects({object_id}, &unrecoverable);
+  return unrecoverable.empty();
+}
 
-  if (!owned_by_us) {
-    RAY_LOG(DEBUG) << "Reconstruction for borrowed objects (" << object_id
-                   << ") is not supported";
-    reconstruction_failure_callback_(object_id, /*pin_object=*/false);
-    return true;
-  }
+void ObjectRecoveryManager::RecoverObjects(const std::vector<ObjectID> &object_ids,
+                                           std::vector<ObjectID> *unrecoverable) {
+  std::vector<ObjectID> to_recover;
+  for (const auto &object_id : object_ids) {
+    // Check the ReferenceCounter to see if there is a location for the object.
+    bool owned_by_us = false;
+    NodeID pinned_at;
+    bool spilled = false;
+    bool ref_exists = reference_counter_->IsPlasmaObjectPinnedOrSpilled(
+        object_id, &owned_by_us, &pinned_at, &spilled);
+    if (!ref_exists) {
+      // References that have gone out of scope cannot be recovered.
+      unrecoverable->push_back(object_id);
+      continue;
+    }
+
+    if (!owned_by_us) {
+      RAY_LOG(DEBUG) << "Reconstruction for borrowed objects (" << object_id
+                     << ") is not supported";
+      reconstruction_failure_callback_(object_id, /*pin_object=*/false);
+      continue;
+    }
 
-  bool already_pending_recovery = true;
-  if (pinned_at.IsNil() && !spilled) {
-    {
+    bool already_pending_recovery = true;
+    if (pinned_at.IsNil() && !spilled) {
       absl::MutexLock lock(&mu_);
       // Mark that we are attempting recovery for this object to prevent
       // duplicate restarts of the same object.
       already_pending_recovery = !objects_pending_recovery_.insert(object_id).second;
     }
+
+    if (!already_pending_recovery) {
+      RAY_LOG(DEBUG) << "Starting recovery for object " << object_id;
+      in_memory_store_->GetAsync(
+          object_id, [this, object_id](std::shared_ptr<RayObject> obj) {
+            absl::MutexLock lock(&mu_);
+            RAY_CHECK(objects_pending_recovery_.erase(object_id)) << object_id;
+            RAY_LOG(INFO) << "Recovery complete for object " << object_id;
+          });
+      to_recover.push_back(object_id);
+    } else {
+      RAY_LOG(DEBUG) << "Recovery already started for object " << object_id;
+    }
   }
 
-  if (!already_pending_recovery) {
-    RAY_LOG(DEBUG) << "Starting recovery for object " << object_id;
-    in_memory_store_->GetAsync(
-        object_id, [this, object_id](std::shared_ptr<RayObject> obj) {
-          absl::MutexLock lock(&mu_);
-          RAY_CHECK(objects_pending_recovery_.erase(object_id)) << object_id;
-          RAY_LOG(INFO) << "Recovery complete for object " << object_id;
-        });
-    // Lookup the object in the GCS to find another copy.
+  if (to_recover.empty()) {
+    return;
+  }
+
+  // Lookup the objects in the GCS to find other copies. Once every lookup has
+  // returned, handle the whole batch at once.
+  struct PendingLookups {
+    absl::Mutex mu;
+    size_t num_pending;
+    absl::flat_hash_map<ObjectID, std::vector<rpc::Address>> locations;
+  };
+  auto lookups = std::make_shared<PendingLookups>();
+  lookups->num_pending = to_recover.size();
+  for (const auto &object_id : to_recover) {
     RAY_CHECK_OK(object_lookup_(
-        object_id,
-        [this](const ObjectID &object_id, const std::vector<rpc::Address> &locations) {
-          PinOrReconstructObject(object_id, locations);
+        object_id, [this, lookups](const ObjectID &object_id,
+                                   const std::vector<rpc::Address> &locations) {
+          absl::flat_hash_map<ObjectID, std::vector<rpc::Address>> all_locations;
+          {
+            absl::MutexLock lock(&lookups->mu);
+            lookups->locations[object_id] = locations;
+            if (--lookups->num_pending > 0) {
+              return;
+            }
+            all_locations.swap(lookups->locations);
+          }
+          PinOrReconstructObjects(all_locations);
         }));
-  } else {
-    RAY_LOG(DEBUG) << "Recovery already started for object " << object_id;
   }
-  return true;
 }
 
 void ObjectRecoveryManager::PinOrReconstructObject(
     const ObjectID &object_id, const std::vector<rpc::Address> &locations) {
-  RAY_LOG(DEBUG) << "Lost object " << object_id << " has " << locations.size()
-                 << " locations";
-  if (!locations.empty()) {
-    auto locations_copy = locations;
-    const auto location = locations_copy.back();
-    locations_copy.pop_back();
-    PinExistingObjectCopy(object_id, location, locations_copy);
-  } else if (lineage_reconstruction_enabled_) {
-    // There are no more copies to pin, try to reconstruct the object.
-    ReconstructObject(object_id);
-  } else {
-    reconstruction_failure_callback_(object_id, /*pin_object=*/true);
+  PinOrReconstructObjects({{object_id, locations}});
+}
+
+void ObjectRecoveryManager::PinOrReconstructObjects(
+    const absl::flat_hash_map<ObjectID, std::vector<rpc::Address>> &locations) {
+  // Objects to pin, grouped by the node that we will try first.
+  absl::flat_hash_map<NodeID, std::pair<rpc::Address, std::vector<ObjectID>>>
+      objects_by_node;
+  absl::flat_hash_map<ObjectID, std::vector<rpc::Address>> other_locations;
+  std::vector<ObjectID> to_reconstruct;
+  for (const auto &entry : locations) {
+    const auto &object_id = entry.first;
+    RAY_LOG(DEBUG) << "Lost object " << object_id << " has " << entry.second.size()
+                   << " locations";
+    if (!entry.second.empty()) {
+      auto locations_copy = entry.second;
+      const auto location = locations_copy.back();
+      locations_copy.pop_back();
+      auto &node_objects =
+          objects_by_node[NodeID::FromBinary(location.raylet_id())];
+      node_objects.first = location;
+      node_objects.second.push_back(object_id);
+      other_locations[object_id] = std::move(locations_copy);
+    } else if (lineage_reconstruction_enabled_) {
+      // There are no more copies to pin, try to reconstruct the object.
+      to_reconstruct.push_back(object_id);
+    } else {
+      reconstruction_failure_callback_(object_id, /*pin_object=*/true);
+    }
+  }
+
+  for (const auto &entry : objects_by_node) {
+    const auto &raylet_address = entry.second.first;
+    const auto &object_ids = entry.second.second;
+    if (object_ids.size() == 1) {
+      PinExistingObjectCopy(object_ids[0], raylet_address,
+                            other_locations[object_ids[0]]);
+      continue;
+    }
+    absl::flat_hash_map<ObjectID, std::vector<rpc::Address>> node_other_locations;
+    for (const auto &object_id : object_ids) {
+      node_other_locations[object_id] = std::move(other_locations[object_id]);
+    }
+    PinExistingObjectCopies(raylet_address, object_ids, std::move(node_other_locations));
+  }
+
+  if (!to_reconstruct.empty()) {
+    ReconstructObjects(to_reconstruct);
   }
 }
 
+std::shared_ptr<PinObjectsInterface> ObjectRecoveryManager::GetPinningClient(
+    const rpc::Address &raylet_address) {
+  const auto node_id = NodeID::FromBinary(raylet_address.raylet_id());
+  if (node_id == NodeID::FromBinary(rpc_address_.raylet_id())) {
+    return local_object_pinning_client_;
+  }
+  absl::MutexLock lock(&mu_);
+  auto client_it = remote_object_pinning_clients_.find(node_id);
+  if (client_it == remote_object_pinning_clients_.end()) {
+    RAY_LOG(DEBUG) << "Connecting to raylet " << node_id;
+    client_it = remote_object_pinning_clients_
+                    .emplace(node_id, client_factory_(raylet_address.ip_address(),
+                                                      raylet_address.port()))
+                    .first;
+  }
+  return client_it->second;
+}
+
 void ObjectRecoveryManager::PinExistingObjectCopy(
     const ObjectID &object_id, const rpc::Address &raylet_address,
     const std::vector<rpc::Address> &other_locations) {
@@ -94,22 +181,7 @@ void ObjectRecoveryManager::PinExistingObjectCopy(
   RAY_LOG(DEBUG) << "Trying to pin copy of lost object " << object_id << " at node "
                  << node_id;
 
-  std::shared_ptr<PinObjectsInterface> client;
-  if (node_id == NodeID::FromBinary(rpc_address_.raylet_id())) {
-    client = local_object_pinning_client_;
-  } else {
-    absl::MutexLock lock(&mu_);
-    auto client_it = remote_object_pinning_clients_.find(node_id);
-    if (client_it == remote_object_pinning_clients_.end()) {
-      RAY_LOG(DEBUG) << "Connecting to raylet " << node_id;
-      client_it = remote_object_pinning_clients_
-                      .emplace(node_id, client_factory_(raylet_address.ip_address(),
-                                                        raylet_address.port()))
-                      .first;
-    }
-    client = client_it->second;
-  }
-
+  auto client = GetPinningClient(raylet_address);
   client->PinObjectIDs(rpc_address_, {object_id},
                        [this, object_id, other_locations, node_id](
                            const Status &status, const rpc::PinObjectIDsReply &reply) {
@@ -128,27 +200,88 @@ void ObjectRecoveryManager::PinExistingObjectCopy(
                        });
 }
 
-void ObjectRecoveryManager::ReconstructObject(const ObjectID &object_id) {
-  // Notify the task manager that we are retrying the task that created this
-  // object.
-  const auto task_id = object_id.TaskId();
+void ObjectRecoveryManager::PinExistingObjectCopies(
+    const rpc::Address &raylet_address, const std::vector<ObjectID> &object_ids,
+    absl::flat_hash_map<ObjectID, std::vector<rpc::Address>> other_locations) {
+  const auto node_id = NodeID::FromBinary(raylet_address.raylet_id());
+  RAY_LOG(DEBUG) << "Trying to pin copies of " << object_ids.size()
+                 << " lost objects at node " << node_id;
+
+  auto client = GetPinningClient(raylet_address);
+  client->PinObjectIDs(
+      rpc_address_, object_ids,
+      [this, object_ids, raylet_address, node_id,
+       other_locations = std::move(other_locations)](
+          const Status &status, const rpc::PinObjectIDsReply &reply) mutable {
+        if (status.ok()) {
+          for (const auto &object_id : object_ids) {
+            RAY_CHECK(in_memory_store_->Put(RayObject(rpc::ErrorType::OBJECT_IN_PLASMA),
+                                            object_id));
+            reference_counter_->UpdateObjectPinnedAtRaylet(object_id, node_id);
+          }
+        } else {
+          RAY_LOG(INFO) << "Error pinning new copies of " << object_ids.size()
+                        << " lost objects at node " << node_id
+                        << ", trying each object separately";
+          for (const auto &object_id : object_ids) {
+            PinExistingObjectCopy(object_id, raylet_address,
+                                  other_locations[object_id]);
+          }
+        }
+      });
+}
+
+void ObjectRecoveryManager::ReplicateObject(
+    const ObjectID &object_id, const std::vector<rpc::Address> &raylet_addresses) {
+  for (const auto &raylet_address : raylet_addresses) {
+    const auto node_id = NodeID::FromBinary(raylet_address.raylet_id());
+    RAY_LOG(DEBUG) << "Replicating object " << object_id << " to node " << node_id;
+    GetPinningClient(raylet_address)
+        ->ReplicateObjectIDs(rpc_address_, {object_id},
+                             [object_id, node_id](const Status &status,
+                                                  const rpc::PinObjectIDsReply &reply) {
+                               if (!status.ok()) {
+                                 RAY_LOG(INFO) << "Failed to replicate object "
+                                               << object_id << " to node " << node_id
+                                               << ": " << status;
+                               }
+                             });
+  }
+}
+
+void ObjectRecoveryManager::ReconstructObjects(const std::vector<ObjectID> &object_ids) {
+  // Notify the task manager that we are retrying the tasks that created these
+  // objects. Objects returned by the same task share one resubmission.
+  absl::flat_hash_map<TaskID, bool> resubmitted;
   std::vector<ObjectID> task_deps;
-  auto status = task_resubmitter_->ResubmitTask(task_id, &task_deps);
-
-  if (status.ok()) {
-    // Try to recover the task's dependencies.
-    for (const auto &dep : task_deps) {
-      auto recovered = RecoverObject(dep);
-      if (!recovered) {
-        RAY_LOG(INFO) << "Failed to reconstruct object " << dep << ": "
-                      << status.message();
-        // We do not pin the dependency because we may not be the owner.
-        reconstruction_failure_callback_(dep, /*pin_object=*/false);
-      }
+  for (const auto &object_id : object_ids) {
+    const auto task_id = object_id.TaskId();
+    auto it = resubmitted.find(task_id);
+    if (it == resubmitted.end()) {
+      auto status = task_resubmitter_->ResubmitTask(task_id, &task_deps);
+      it = resubmitted.emplace(task_id, status.ok()).first;
     }
-  } else {
-    RAY_LOG(INFO) << "Failed to reconstruct object " << object_id;
-    reconstruction_failure_callback_(object_id, /*pin_object=*/true);
+    if (!it->second) {
+      RAY_LOG(INFO) << "Failed to reconstruct object " << object_id;
+      reconstruction_failure_callback_(object_id, /*pin_object=*/true);
+    }
+  }
+
+  // Try to recover the tasks' dependencies. Dependencies shared by several
+  // resubmitted tasks are only recovered once.
+  absl::flat_hash_set<ObjectID> seen;
+  std::vector<ObjectID> deps_to_recover;
+  for (const auto &dep : task_deps) {
+    if (seen.insert(dep).second) {
+      deps_to_recover.push_back(dep);
+    }
+  }
+  std::vector<ObjectID> unrecoverable;
+  RecoverObjects(deps_to_recover, &unrecoverable);
+  for (const auto &dep : unrecoverable) {
+    RAY_LOG(INFO) << "Failed to reconstruct object " << dep;
+    // We do not pin the dependency because we may not be the owner.
+    reconstruction_failure_callback_(dep, /*pin_object=*/false);
   }
 }
 
@@ -15,6 +15,8 @@
 #pragma once
 
 #include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/synchronization/mutex.h"
 #include "ray/common/id.h"
 #include "ray/core_worker/reference_count.h"
@@ -87,6 +89,31 @@ class ObjectRecoveryManager {
   /// reconstruction failure callback will be called for this object).
   bool RecoverObject(const ObjectID &object_id);
 
+  /// Recover a batch of lost objects, e.g. all objects lost with a node. This
+  /// follows the same algorithm as RecoverObject, but works on the whole
+  /// batch at each step so that recovery does not serialize on the owner:
+  /// objects that still have copies on the same node are pinned with one
+  /// request, each creating task is resubmitted at most once, and the
+  /// arguments of all resubmitted tasks are recovered together as the next
+  /// batch, so ancestors shared by many lost objects are only recovered once.
+  /// Resubmitted tasks run as soon as their own arguments are available.
+  ///
+  /// \param[in] object_ids The objects to recover.
+  /// \param[out] unrecoverable The objects for which we have no metadata, i.e.
+  /// those for which RecoverObject would return false.
+  void RecoverObjects(const std::vector<ObjectID> &object_ids,
+                      std::vector<ObjectID> *unrecoverable);
+
+  /// Ask the given raylets to pull a copy of an object that we own and pin it,
+  /// so that recovery can pin one of these replicas instead of reconstructing
+  /// the object if its primary copy is lost. Replicas are released when the
+  /// object goes out of scope, like the primary copy.
+  ///
+  /// \param[in] object_id The object to replicate.
+  /// \param[in] raylet_addresses The raylets that should keep a replica.
+  void ReplicateObject(const ObjectID &object_id,
+                       const std::vector<rpc::Address> &raylet_addresses);
+
  private:
   /// Pin a new copy for a lost object from the given locations or, if that
   /// fails, attempt to reconstruct it by resubmitting the task that created
@@ -94,14 +121,32 @@ class ObjectRecoveryManager {
   void PinOrReconstructObject(const ObjectID &object_id,
                               const std::vector<rpc::Address> &locations);
 
+  /// Batched version of PinOrReconstructObject. Objects whose next candidate
+  /// location is the same node are pinned with a single request.
+  void PinOrReconstructObjects(
+      const absl::flat_hash_map<ObjectID, std::vector<rpc::Address>> &locations);
+
+  /// Pin new copies of several objects at the same location. If the request
+  /// fails, fall back to pinning each object on its own, since the raylet
+  /// fails the whole request if any of the objects is missing.
+  void PinExistingObjectCopies(
+      const rpc::Address &raylet_address, const std::vector<ObjectID> &object_ids,
+      absl::flat_hash_map<ObjectID, std::vector<rpc::Address>> other_locations);
+
+  /// Get a client for pinning objects at the given raylet.
+  std::shared_ptr<PinObjectsInterface> GetPinningClient(
+      const rpc::Address &raylet_address);
+
   /// Pin a new copy for the object at the given location. If that fails, then
   /// try one of the other locations.
   void PinExistingObjectCopy(const ObjectID &object_id,
                              const rpc::Address &raylet_address,
                              const std::vector<rpc::Address> &other_locations);
 
-  /// Reconstruct an object by resubmitting the task that created it.
-  void ReconstructObject(const ObjectID &object_id);
+  /// Reconstruct objects by resubmitting the tasks that created them. Each
+  /// task is resubmitted once, and the arguments of all resubmitted tasks are
+  /// recovered as one batch.
+  void ReconstructObjects(const std::vector<ObjectID> &object_ids);
 
   /// Used to resubmit tasks.
   std::shared_ptr<TaskResubmissionInterface> task_resubmitter_;
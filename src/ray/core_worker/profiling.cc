@@ -30,8 +30,12 @@ ProfileEvent::ProfileEvent(const std::shared_ptr<Profiler> &profiler,
 
 Profiler::Profiler(WorkerContext &worker_context, const std::string &node_ip_address,
                    instrumented_io_context &io_service,
-                   const std::shared_ptr<gcs::GcsClient> &gcs_client)
-    : io_service_(io_service),
+                   const std::shared_ptr<gcs::GcsClient> &gcs_client,
+                   int64_t flush_interval_ms, int64_t max_batch_size,
+                   int64_t max_buffered_events)
+    : max_batch_size_(max_batch_size),
+      max_buffered_events_(max_buffered_events),
+      io_service_(io_service),
       periodical_runner_(io_service_),
       rpc_profile_data_(new rpc::ProfileTableData()),
       gcs_client_(gcs_client) {
@@ -39,19 +43,50 @@ Profiler::Profiler(WorkerContext &worker_context, const std::string &node_ip_add
   rpc_profile_data_->set_component_id(worker_context.GetWorkerID().Binary());
   rpc_profile_data_->set_node_ip_address(node_ip_address);
   periodical_runner_.RunFnPeriodically(
-      [this] { FlushEvents(); }, 1000,
+      [this] { FlushEvents(); }, flush_interval_ms,
       "CoreWorker.deadline_timer.flush_profiling_events");
 }
 
 void Profiler::AddEvent(const rpc::ProfileTableData::ProfileEvent &event) {
+  bool flush_now = false;
+  {
+    absl::MutexLock lock(&mutex_);
+    int64_t num_buffered = rpc_profile_data_->profile_events_size();
+    if (max_buffered_events_ > 0 && num_buffered >= max_buffered_events_) {
+      num_events_dropped_++;
+      RAY_LOG_EVERY_MS(WARNING, 10000)
+          << "The GCS is backlogged processing profiling data, " << num_events_dropped_
+          << " events have been dropped so far.";
+      return;
+    }
+    rpc_profile_data_->add_profile_events()->CopyFrom(event);
+    if (max_batch_size_ > 0 && num_buffered + 1 >= max_batch_size_ &&
+        !early_flush_pending_ && !profile_flush_active_) {
+      early_flush_pending_ = true;
+      flush_now = true;
+    }
+  }
+  if (flush_now) {
+    io_service_.post([this]() { FlushEvents(); },
+                     "CoreWorker.flush_profiling_events_early");
+  }
+}
+
+int64_t Profiler::NumEventsDropped() const {
   absl::MutexLock lock(&mutex_);
-  rpc_profile_data_->add_profile_events()->CopyFrom(event);
+  return num_events_dropped_;
 }
 
 void Profiler::FlushEvents() {
   auto cur_profile_data = std::make_shared<rpc::ProfileTableData>();
   {
     absl::MutexLock lock(&mutex_);
+    early_flush_pending_ = false;
+    if (profile_flush_active_ && max_buffered_events_ > 0) {
+      // The previous batch is still in flight. Keep buffering the events, up to
+      // max_buffered_events_, and send them once the GCS has caught up.
+      return;
+    }
     if (rpc_profile_data_->profile_events_size() != 0) {
       cur_profile_data->set_component_type(rpc_profile_data_->component_type());
       cur_profile_data->set_component_id(rpc_profile_data_->component_id());
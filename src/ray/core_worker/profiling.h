@@ -29,19 +29,34 @@ namespace worker {
 
 class Profiler {
  public:
+  /// \param flush_interval_ms How often buffered events are sent to the GCS.
+  /// \param max_batch_size Send the buffered events early once there are this many
+  /// of them. 0 means only send them periodically.
+  /// \param max_buffered_events The maximum number of events kept while the GCS is
+  /// behind. Further events are dropped. 0 means the buffered events are dropped
+  /// whenever the GCS is behind.
   Profiler(WorkerContext &worker_context, const std::string &node_ip_address,
            instrumented_io_context &io_service,
-           const std::shared_ptr<gcs::GcsClient> &gcs_client);
+           const std::shared_ptr<gcs::GcsClient> &gcs_client,
+           int64_t flush_interval_ms = 1000, int64_t max_batch_size = 0,
+           int64_t max_buffered_events = 0);
 
   // Add an event to the queue to be flushed periodically.
   void AddEvent(const rpc::ProfileTableData::ProfileEvent &event) LOCKS_EXCLUDED(mutex_);
 
+  /// Return the number of events dropped because too many were buffered.
+  int64_t NumEventsDropped() const LOCKS_EXCLUDED(mutex_);
+
  private:
   // Flush all of the events that have been added since last flush to the GCS.
   void FlushEvents() LOCKS_EXCLUDED(mutex_);
 
   // Mutex guarding rpc_profile_data_.
-  absl::Mutex mutex_;
+  mutable absl::Mutex mutex_;
+
+  const int64_t max_batch_size_;
+
+  const int64_t max_buffered_events_;
 
   // ASIO IO service event loop. Must be started by the caller.
   instrumented_io_context &io_service_;
@@ -56,6 +71,12 @@ class Profiler {
   /// Whether a profile flush is already in progress.
   bool profile_flush_active_ GUARDED_BY(mutex_) = false;
 
+  /// Whether a flush was posted because the buffer reached max_batch_size_.
+  bool early_flush_pending_ GUARDED_BY(mutex_) = false;
+
+  /// The number of events dropped because too many were buffered.
+  int64_t num_events_dropped_ GUARDED_BY(mutex_) = 0;
+
   // Client to the GCS used to push profile events to it.
   std::shared_ptr<gcs::GcsClient> gcs_client_;
 };
@@ -15,15 +15,17 @@
 #include "ray/core_worker/reference_count.h"
 
 #define PRINT_REF_COUNT(it)                                                              \
-  RAY_LOG(DEBUG) << "REF " << it->first << " borrowers: " << it->second.borrowers.size() \
+  RAY_LOG(DEBUG) << "REF " << it->first                                                  \
+                 << " borrowers: " << it->second.nested().borrowers.size()               \
                  << " local_ref_count: " << it->second.local_ref_count                   \
                  << " submitted_count: " << it->second.submitted_task_ref_count          \
-                 << " contained_in_owned: " << it->second.contained_in_owned.size()      \
+                 << " contained_in_owned: "                                              \
+                 << it->second.nested().contained_in_owned.size()                        \
                  << " contained_in_borrowed: "                                           \
-                 << (it->second.contained_in_borrowed_id.has_value()                     \
-                         ? *it->second.contained_in_borrowed_id                          \
+                 << (it->second.nested().contained_in_borrowed_id.has_value()            \
+                         ? *it->second.nested().contained_in_borrowed_id                 \
                          : ObjectID::Nil())                                              \
-                 << " contains: " << it->second.contains.size()                          \
+                 << " contains: " << it->second.nested().contains.size()                 \
                  << " lineage_ref_count: " << it->second.lineage_ref_count;
 
 namespace {}  // namespace
@@ -32,12 +34,12 @@ namespace ray {
 namespace core {
 
 bool ReferenceCounter::OwnObjects() const {
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   return !object_id_refs_.empty();
 }
 
 bool ReferenceCounter::OwnedByUs(const ObjectID &object_id) const {
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   auto it = object_id_refs_.find(object_id);
   if (it != object_id_refs_.end()) {
     return it->second.owned_by_us;
@@ -108,16 +110,16 @@ bool ReferenceCounter::AddBorrowedObjectInternal(const ObjectID &object_id,
     return false;
   }
 
-  it->second.owner_address = owner_address;
+  it->second.owner_address = InternOwnerAddress(owner_address);
 
   if (!outer_id.IsNil()) {
     auto outer_it = object_id_refs_.find(outer_id);
     if (outer_it != object_id_refs_.end() && !outer_it->second.owned_by_us) {
       RAY_LOG(DEBUG) << "Setting borrowed inner ID " << object_id
                      << " contained_in_borrowed: " << outer_id;
-      RAY_CHECK(!it->second.contained_in_borrowed_id.has_value());
-      it->second.contained_in_borrowed_id = outer_id;
-      outer_it->second.contains.insert(object_id);
+      RAY_CHECK(!it->second.nested().contained_in_borrowed_id.has_value());
+      it->second.mutable_nested().contained_in_borrowed_id = outer_id;
+      outer_it->second.mutable_nested().contains.insert(object_id);
     }
   }
   return true;
@@ -145,7 +147,7 @@ void ReferenceCounter::AddObjectRefStats(
         ref_proto->set_call_site(it->second.second);
       }
     }
-    for (const auto &obj_id : ref.second.contained_in_owned) {
+    for (const auto &obj_id : ref.second.nested().contained_in_owned) {
       ref_proto->add_contained_in_owned(obj_id.Binary());
     }
   }
@@ -175,8 +177,9 @@ void ReferenceCounter::AddOwnedObject(const ObjectID &object_id,
   // because this corresponds to a submitted task whose return ObjectID will be created
   // in the frontend language, incrementing the reference count.
   auto it = object_id_refs_
-                .emplace(object_id, Reference(owner_address, call_site, object_size,
-                                              is_reconstructable, pinned_at_raylet_id))
+                .emplace(object_id, Reference(InternOwnerAddress(owner_address), call_site,
+                                              object_size, is_reconstructable,
+                                              pinned_at_raylet_id))
                 .first;
   if (!inner_ids.empty()) {
     // Mark that this object ID contains other inner IDs. Then, we will not GC
@@ -363,7 +366,7 @@ void ReferenceCounter::RemoveSubmittedTaskReferences(
 
 bool ReferenceCounter::GetOwner(const ObjectID &object_id,
                                 rpc::Address *owner_address) const {
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   return GetOwnerInternal(object_id, owner_address);
 }
 
@@ -382,9 +385,37 @@ bool ReferenceCounter::GetOwnerInternal(const ObjectID &object_id,
   }
 }
 
+std::shared_ptr<const rpc::Address> ReferenceCounter::InternOwnerAddress(
+    const rpc::Address &address) {
+  const auto worker_id = WorkerID::FromBinary(address.worker_id());
+  auto &entry = owner_addresses_[worker_id];
+  auto interned = entry.lock();
+  // Compare the remaining fields too, so that interning never changes the
+  // address that a Reference records.
+  if (interned == nullptr || interned->raylet_id() != address.raylet_id() ||
+      interned->ip_address() != address.ip_address() ||
+      interned->port() != address.port()) {
+    interned = std::make_shared<const rpc::Address>(address);
+    entry = interned;
+  }
+  // Purge expired entries once the table has doubled since the last sweep, so
+  // that the cost is amortized over insertions.
+  if (owner_addresses_.size() >= owner_addresses_purge_threshold_) {
+    for (auto it = owner_addresses_.begin(); it != owner_addresses_.end();) {
+      if (it->second.expired()) {
+        owner_addresses_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+    owner_addresses_purge_threshold_ = std::max<size_t>(2 * owner_addresses_.size(), 64);
+  }
+  return interned;
+}
+
 std::vector<rpc::Address> ReferenceCounter::GetOwnerAddresses(
     const std::vector<ObjectID> object_ids) const {
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   std::vector<rpc::Address> owner_addresses;
   for (const auto &object_id : object_ids) {
     rpc::Address owner_addr;
@@ -408,7 +439,7 @@ std::vector<rpc::Address> ReferenceCounter::GetOwnerAddresses(
 }
 
 bool ReferenceCounter::IsPlasmaObjectFreed(const ObjectID &object_id) const {
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   return freed_objects_.find(object_id) != freed_objects_.end();
 }
 
@@ -454,7 +485,7 @@ void ReferenceCounter::DeleteReferenceInternal(ReferenceTable::iterator it,
     // If distributed ref counting is enabled, then delete the object once its
     // ref count across all processes is 0.
     should_delete_value = true;
-    for (const auto &inner_id : it->second.contains) {
+    for (const auto &inner_id : it->second.nested().contains) {
       auto inner_it = object_id_refs_.find(inner_id);
       if (inner_it != object_id_refs_.end()) {
         RAY_LOG(DEBUG) << "Try to delete inner object " << inner_id;
@@ -462,12 +493,12 @@ void ReferenceCounter::DeleteReferenceInternal(ReferenceTable::iterator it,
           // If this object ID was nested in an owned object, make sure that
           // the outer object counted towards the ref count for the inner
           // object.
-          RAY_CHECK(inner_it->second.contained_in_owned.erase(id));
+          RAY_CHECK(inner_it->second.mutable_nested().contained_in_owned.erase(id));
         } else {
           // If this object ID was nested in a borrowed object, make sure that
           // we have already returned this information through a previous
           // GetAndClearLocalBorrowers call.
-          RAY_CHECK(!inner_it->second.contained_in_borrowed_id.has_value())
+          RAY_CHECK(!inner_it->second.nested().contained_in_borrowed_id.has_value())
               << "Outer object " << id << ", inner object " << inner_id;
         }
         DeleteReferenceInternal(inner_it, deleted);
@@ -571,10 +602,26 @@ void ReferenceCounter::UpdateObjectPinnedAtRaylet(const ObjectID &object_id,
   }
 }
 
+bool ReferenceCounter::MoveObjectPinnedAtRaylet(const ObjectID &object_id,
+                                                const NodeID &raylet_id) {
+  absl::MutexLock lock(&mutex_);
+  auto it = object_id_refs_.find(object_id);
+  if (it == object_id_refs_.end() || !it->second.owned_by_us ||
+      !it->second.pinned_at_raylet_id.has_value() ||
+      freed_objects_.count(object_id) > 0) {
+    return false;
+  }
+  RAY_LOG(DEBUG) << "Object " << object_id << " moved from raylet "
+                 << *it->second.pinned_at_raylet_id << " to " << raylet_id;
+  it->second.pinned_at_raylet_id = raylet_id;
+  AddObjectLocationInternal(it, raylet_id);
+  return true;
+}
+
 bool ReferenceCounter::IsPlasmaObjectPinnedOrSpilled(const ObjectID &object_id,
                                                      bool *owned_by_us, NodeID *pinned_at,
                                                      bool *spilled) const {
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   auto it = object_id_refs_.find(object_id);
   if (it != object_id_refs_.end()) {
     if (it->second.owned_by_us) {
@@ -588,20 +635,20 @@ bool ReferenceCounter::IsPlasmaObjectPinnedOrSpilled(const ObjectID &object_id,
 }
 
 bool ReferenceCounter::HasReference(const ObjectID &object_id) const {
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   return object_id_refs_.find(object_id) != object_id_refs_.end();
 }
 
 size_t ReferenceCounter::NumObjectIDsInScope() const {
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   return object_id_refs_.size();
 }
 
 std::unordered_set<ObjectID> ReferenceCounter::GetAllInScopeObjectIDs() const {
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   std::unordered_set<ObjectID> in_scope_object_ids;
   in_scope_object_ids.reserve(object_id_refs_.size());
-  for (auto it : object_id_refs_) {
+  for (const auto &it : object_id_refs_) {
     in_scope_object_ids.insert(it.first);
   }
   return in_scope_object_ids;
@@ -609,10 +656,10 @@ std::unordered_set<ObjectID> ReferenceCounter::GetAllInScopeObjectIDs() const {
 
 std::unordered_map<ObjectID, std::pair<size_t, size_t>>
 ReferenceCounter::GetAllReferenceCounts() const {
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   std::unordered_map<ObjectID, std::pair<size_t, size_t>> all_ref_counts;
   all_ref_counts.reserve(object_id_refs_.size());
-  for (auto it : object_id_refs_) {
+  for (const auto &it : object_id_refs_) {
     all_ref_counts.emplace(it.first,
                            std::pair<size_t, size_t>(it.second.local_ref_count,
                                                      it.second.submitted_task_ref_count));
@@ -662,21 +709,26 @@ bool ReferenceCounter::GetAndClearLocalBorrowersInternal(const ObjectID &object_
   // Clear the local list of borrowers that we have accumulated. The receiver
   // of the returned borrowed_refs must merge this list into their own list
   // until all active borrowers are merged into the owner.
-  it->second.borrowers.clear();
-  it->second.stored_in_objects.clear();
+  if (it->second.nested_info.get() == nullptr) {
+    // Nothing was nested in or borrowed through this ID.
+    return true;
+  }
+  auto &nested = it->second.mutable_nested();
+  nested.borrowers.clear();
+  nested.stored_in_objects.clear();
 
-  if (it->second.contained_in_borrowed_id.has_value()) {
+  if (nested.contained_in_borrowed_id.has_value()) {
     /// This ID was nested in another ID that we (or a nested task) borrowed.
     /// Make sure that we also returned the ID that contained it.
-    RAY_CHECK(borrowed_refs->count(it->second.contained_in_borrowed_id.value()) > 0);
+    RAY_CHECK(borrowed_refs->count(nested.contained_in_borrowed_id.value()) > 0);
     /// Clear the fact that this ID was nested because we are including it in
     /// the returned borrowed_refs. If the nested ID is not being borrowed by
     /// us, then it will be deleted recursively when deleting the outer ID.
-    it->second.contained_in_borrowed_id.reset();
+    nested.contained_in_borrowed_id.reset();
   }
 
   // Attempt to pop children.
-  for (const auto &contained_id : it->second.contains) {
+  for (const auto &contained_id : nested.contains) {
     GetAndClearLocalBorrowersInternal(contained_id, borrowed_refs);
   }
 
@@ -693,28 +745,29 @@ void ReferenceCounter::MergeRemoteBorrowers(const ObjectID &object_id,
   }
   const auto &borrower_ref = borrower_it->second;
   RAY_LOG(DEBUG) << "Borrower ref " << object_id << " has "
-                 << borrower_ref.borrowers.size() << " borrowers "
+                 << borrower_ref.nested().borrowers.size() << " borrowers "
                  << ", has local: " << borrower_ref.local_ref_count
                  << " submitted: " << borrower_ref.submitted_task_ref_count
-                 << " contained_in_owned " << borrower_ref.contained_in_owned.size();
+                 << " contained_in_owned " << borrower_ref.nested().contained_in_owned.size();
 
   auto it = object_id_refs_.find(object_id);
   if (it == object_id_refs_.end()) {
     it = object_id_refs_.emplace(object_id, Reference()).first;
   }
-  if (!it->second.owner_address && borrower_ref.contained_in_borrowed_id.has_value()) {
+  if (!it->second.owner_address &&
+      borrower_ref.nested().contained_in_borrowed_id.has_value()) {
     // We don't have owner information about this object ID yet and the worker
     // received it because it was nested in another ID that the worker was
     // borrowing. Copy this information to our local table.
     RAY_CHECK(borrower_ref.owner_address);
-    AddBorrowedObjectInternal(object_id, *borrower_it->second.contained_in_borrowed_id,
+    AddBorrowedObjectInternal(object_id, *borrower_ref.nested().contained_in_borrowed_id,
                               *borrower_ref.owner_address);
   }
   std::vector<rpc::WorkerAddress> new_borrowers;
 
   // The worker is still using the reference, so it is still a borrower.
   if (borrower_ref.RefCount() > 0) {
-    auto inserted = it->second.borrowers.insert(worker_addr).second;
+    auto inserted = it->second.mutable_nested().borrowers.insert(worker_addr).second;
     // If we are the owner of id, then send WaitForRefRemoved to borrower.
     if (inserted) {
       RAY_LOG(DEBUG) << "Adding borrower " << worker_addr.ip_address << ":"
@@ -724,8 +777,8 @@ void ReferenceCounter::MergeRemoteBorrowers(const ObjectID &object_id,
   }
 
   // Add any other workers that this worker passed the ID to as new borrowers.
-  for (const auto &nested_borrower : borrower_ref.borrowers) {
-    auto inserted = it->second.borrowers.insert(nested_borrower).second;
+  for (const auto &nested_borrower : borrower_ref.nested().borrowers) {
+    auto inserted = it->second.mutable_nested().borrowers.insert(nested_borrower).second;
     if (inserted) {
       RAY_LOG(DEBUG) << "Adding borrower " << nested_borrower.ip_address << ":"
                      << nested_borrower.port << " to id " << object_id;
@@ -743,14 +796,14 @@ void ReferenceCounter::MergeRemoteBorrowers(const ObjectID &object_id,
 
   // If the borrower stored this object ID inside another object ID that it did
   // not own, then mark that the object ID is nested inside another.
-  for (const auto &stored_in_object : borrower_ref.stored_in_objects) {
+  for (const auto &stored_in_object : borrower_ref.nested().stored_in_objects) {
     AddNestedObjectIdsInternal(stored_in_object.first, {object_id},
                                stored_in_object.second);
   }
 
   // Recursively merge any references that were contained in this object, to
   // handle any borrowers of nested objects.
-  for (const auto &inner_id : borrower_ref.contains) {
+  for (const auto &inner_id : borrower_ref.nested().contains) {
     MergeRemoteBorrowers(inner_id, worker_addr, borrowed_refs);
   }
 }
@@ -765,7 +818,7 @@ void ReferenceCounter::CleanupBorrowersOnRefRemoved(
   // Erase the previous borrower.
   auto it = object_id_refs_.find(object_id);
   RAY_CHECK(it != object_id_refs_.end()) << object_id;
-  RAY_CHECK(it->second.borrowers.erase(borrower_addr));
+  RAY_CHECK(it->second.mutable_nested().borrowers.erase(borrower_addr));
   DeleteReferenceInternal(it, nullptr);
 }
 
@@ -834,7 +887,7 @@ void ReferenceCounter::AddNestedObjectIdsInternal(
       // contained in the outer object ID so we do not GC the inner objects
       // until the outer object goes out of scope.
       for (const auto &inner_id : inner_ids) {
-        it->second.contains.insert(inner_id);
+        it->second.mutable_nested().contains.insert(inner_id);
         RAY_LOG(DEBUG) << "Setting inner ID " << inner_id
                        << " contained_in_owned: " << object_id;
       }
@@ -842,7 +895,7 @@ void ReferenceCounter::AddNestedObjectIdsInternal(
       // That's why we use two loops, and we should avoid using `it` hearafter.
       for (const auto &inner_id : inner_ids) {
         auto inner_it = object_id_refs_.emplace(inner_id, Reference()).first;
-        inner_it->second.contained_in_owned.insert(object_id);
+        inner_it->second.mutable_nested().contained_in_owned.insert(object_id);
       }
     }
   } else {
@@ -858,14 +911,16 @@ void ReferenceCounter::AddNestedObjectIdsInternal(
       }
       // Add the task's caller as a borrower.
       if (inner_it->second.owned_by_us) {
-        auto inserted = inner_it->second.borrowers.insert(owner_address).second;
+        auto inserted =
+            inner_it->second.mutable_nested().borrowers.insert(owner_address).second;
         if (inserted) {
           // Wait for it to remove its reference.
           WaitForRefRemoved(inner_it, owner_address, object_id);
         }
       } else {
-        auto inserted =
-            inner_it->second.stored_in_objects.emplace(object_id, owner_address).second;
+        auto inserted = inner_it->second.mutable_nested()
+                            .stored_in_objects.emplace(object_id, owner_address)
+                            .second;
         // This should be the first time that we have stored this object ID
         // inside this return ID.
         RAY_CHECK(inserted);
@@ -878,7 +933,7 @@ void ReferenceCounter::HandleRefRemoved(const ObjectID &object_id) {
   ReferenceTable borrowed_refs;
   RAY_UNUSED(GetAndClearLocalBorrowersInternal(object_id, &borrowed_refs));
   for (const auto &pair : borrowed_refs) {
-    RAY_LOG(DEBUG) << pair.first << " has " << pair.second.borrowers.size()
+    RAY_LOG(DEBUG) << pair.first << " has " << pair.second.nested().borrowers.size()
                    << " borrowers";
   }
   auto it = object_id_refs_.find(object_id);
@@ -994,9 +1049,33 @@ bool ReferenceCounter::RemoveObjectLocation(const ObjectID &object_id,
   return true;
 }
 
+bool ReferenceCounter::UpdateObjectLocations(
+    const ObjectID &object_id, const absl::flat_hash_map<NodeID, bool> &updates) {
+  absl::MutexLock lock(&mutex_);
+  auto it = object_id_refs_.find(object_id);
+  if (it == object_id_refs_.end()) {
+    RAY_LOG(DEBUG) << "Tried to update the object locations for an object " << object_id
+                   << " that doesn't exist in the reference table. It can happen if the "
+                      "object is already evicted.";
+    return false;
+  }
+  bool changed = false;
+  for (const auto &update : updates) {
+    if (update.second) {
+      changed |= it->second.locations.emplace(update.first).second;
+    } else {
+      changed |= it->second.locations.erase(update.first) > 0;
+    }
+  }
+  if (changed) {
+    PushToLocationSubscribers(it);
+  }
+  return true;
+}
+
 absl::optional<absl::flat_hash_set<NodeID>> ReferenceCounter::GetObjectLocations(
     const ObjectID &object_id) {
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   auto it = object_id_refs_.find(object_id);
   if (it == object_id_refs_.end()) {
     RAY_LOG(WARNING) << "Tried to get the object locations for an object " << object_id
@@ -1007,7 +1086,7 @@ absl::optional<absl::flat_hash_set<NodeID>> ReferenceCounter::GetObjectLocations
 }
 
 size_t ReferenceCounter::GetObjectSize(const ObjectID &object_id) const {
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   auto it = object_id_refs_.find(object_id);
   if (it == object_id_refs_.end()) {
     return 0;
@@ -1046,7 +1125,7 @@ bool ReferenceCounter::HandleObjectSpilled(const ObjectID &object_id,
 
 absl::optional<LocalityData> ReferenceCounter::GetLocalityData(
     const ObjectID &object_id) {
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   // Uses the reference table to return locality data for an object.
   auto it = object_id_refs_.find(object_id);
   if (it == object_id_refs_.end()) {
@@ -1116,7 +1195,8 @@ void ReferenceCounter::AddBorrowerAddress(const ObjectID &object_id,
 
   RAY_LOG(DEBUG) << "Add borrower " << borrower_address.DebugString() << " for object "
                  << object_id;
-  auto inserted = it->second.borrowers.insert(borrower_worker_address).second;
+  auto inserted =
+      it->second.mutable_nested().borrowers.insert(borrower_worker_address).second;
   if (inserted) {
     WaitForRefRemoved(it, borrower_worker_address);
   }
@@ -1191,23 +1271,25 @@ void ReferenceCounter::PublishObjectLocationSnapshot(const ObjectID &object_id)
 ReferenceCounter::Reference ReferenceCounter::Reference::FromProto(
     const rpc::ObjectReferenceCount &ref_count) {
   Reference ref;
-  ref.owner_address = ref_count.reference().owner_address();
+  ref.owner_address =
+      std::make_shared<const rpc::Address>(ref_count.reference().owner_address());
   ref.local_ref_count = ref_count.has_local_ref() ? 1 : 0;
 
   for (const auto &borrower : ref_count.borrowers()) {
-    ref.borrowers.insert(rpc::WorkerAddress(borrower));
+    ref.mutable_nested().borrowers.insert(rpc::WorkerAddress(borrower));
   }
   for (const auto &object : ref_count.stored_in_objects()) {
     const auto &object_id = ObjectID::FromBinary(object.object_id());
-    ref.stored_in_objects.emplace(object_id, rpc::WorkerAddress(object.owner_address()));
+    ref.mutable_nested().stored_in_objects.emplace(
+        object_id, rpc::WorkerAddress(object.owner_address()));
   }
   for (const auto &id : ref_count.contains()) {
-    ref.contains.insert(ObjectID::FromBinary(id));
+    ref.mutable_nested().contains.insert(ObjectID::FromBinary(id));
   }
   const auto contained_in_borrowed_id =
       ObjectID::FromBinary(ref_count.contained_in_borrowed_id());
   if (!contained_in_borrowed_id.IsNil()) {
-    ref.contained_in_borrowed_id = contained_in_borrowed_id;
+    ref.mutable_nested().contained_in_borrowed_id = contained_in_borrowed_id;
   }
   return ref;
 }
@@ -1218,18 +1300,19 @@ void ReferenceCounter::Reference::ToProto(rpc::ObjectReferenceCount *ref) const
   }
   bool has_local_ref = RefCount() > 0;
   ref->set_has_local_ref(has_local_ref);
-  for (const auto &borrower : borrowers) {
+  const auto &info = nested();
+  for (const auto &borrower : info.borrowers) {
     ref->add_borrowers()->CopyFrom(borrower.ToProto());
   }
-  for (const auto &object : stored_in_objects) {
+  for (const auto &object : info.stored_in_objects) {
     auto ref_object = ref->add_stored_in_objects();
     ref_object->set_object_id(object.first.Binary());
     ref_object->mutable_owner_address()->CopyFrom(object.second.ToProto());
   }
-  if (contained_in_borrowed_id.has_value()) {
-    ref->set_contained_in_borrowed_id(contained_in_borrowed_id->Binary());
+  if (info.contained_in_borrowed_id.has_value()) {
+    ref->set_contained_in_borrowed_id(info.contained_in_borrowed_id->Binary());
   }
-  for (const auto &contains_id : contains) {
+  for (const auto &contains_id : info.contains) {
     ref->add_contains(contains_id.Binary());
   }
 }
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <boost/bind.hpp>
+#include <memory>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
@@ -337,6 +338,15 @@ class ReferenceCounter : public ReferenceCounterInterface,
   void UpdateObjectPinnedAtRaylet(const ObjectID &object_id, const NodeID &raylet_id)
       LOCKS_EXCLUDED(mutex_);
 
+  /// Move the pinned location of an object stored in plasma to another raylet, after
+  /// the raylet that pinned it migrated its copy there, e.g. to drain its node.
+  ///
+  /// \param[in] object_id The object to update.
+  /// \param[in] raylet_id The raylet that is now pinning the object ID.
+  /// \return Whether the object is still pinned, and was moved.
+  bool MoveObjectPinnedAtRaylet(const ObjectID &object_id, const NodeID &raylet_id)
+      LOCKS_EXCLUDED(mutex_);
+
   /// Check whether the object is pinned at a remote plasma store node or
   /// spilled to external storage. In either case, a copy of the object is
   /// available to fetch.
@@ -392,6 +402,18 @@ class ReferenceCounter : public ReferenceCounterInterface,
   bool RemoveObjectLocation(const ObjectID &object_id, const NodeID &node_id)
       LOCKS_EXCLUDED(mutex_);
 
+  /// Add and remove locations of the given object. The subscribers to the locations
+  /// are notified once, if the locations changed. The owner must have the object ref
+  /// in scope.
+  ///
+  /// \param[in] object_id The object to update.
+  /// \param[in] updates Whether the object was added to (true) or removed from
+  /// (false) each node.
+  /// \return True if the reference exists, false otherwise.
+  bool UpdateObjectLocations(const ObjectID &object_id,
+                             const absl::flat_hash_map<NodeID, bool> &updates)
+      LOCKS_EXCLUDED(mutex_);
+
   /// Get the locations of the given object. The owner must have the object ref in
   /// scope.
   ///
@@ -466,19 +488,101 @@ class ReferenceCounter : public ReferenceCounterInterface,
       LOCKS_EXCLUDED(mutex_);
 
  private:
+  /// The rarely used fields of a Reference, kept out of line so that the
+  /// common case (a plain owned or borrowed object) stays small.
+  struct NestedReferenceInfo {
+    /// Object IDs that we own and that contain this object ID.
+    /// ObjectIDs are added to this field when we discover that this object
+    /// contains other IDs. This can happen in 2 cases:
+    ///  1. We call ray.put() and store the inner ID(s) in the outer object.
+    ///  2. A task that we submitted returned an ID(s).
+    /// ObjectIDs are erased from this field when their Reference is deleted.
+    absl::flat_hash_set<ObjectID> contained_in_owned;
+    /// An Object ID that we (or one of our children) borrowed that contains
+    /// this object ID, which is also borrowed. This is used in cases where an
+    /// ObjectID is nested. We need to notify the owner of the outer ID of any
+    /// borrowers of this object, so we keep this field around until
+    /// GetAndClearLocalBorrowersInternal is called on the outer ID. This field
+    /// is updated in 2 cases:
+    ///  1. We deserialize an ID that we do not own and that was stored in
+    ///     another object that we do not own.
+    ///  2. Case (1) occurred for a task that we submitted and we also do not
+    ///     own the inner or outer object. Then, we need to notify our caller
+    ///     that the task we submitted is a borrower for the inner ID.
+    /// This field is reset to null once GetAndClearLocalBorrowersInternal is
+    /// called on contained_in_borrowed_id. For each borrower, this field is
+    /// set at most once during the reference's lifetime. If the object ID is
+    /// later found to be nested in a second object, we do not need to remember
+    /// the second ID because we will already have notified the owner of the
+    /// first outer object about our reference.
+    absl::optional<ObjectID> contained_in_borrowed_id;
+    /// The object IDs contained in this object. These could be objects that we
+    /// own or are borrowing. This field is updated in 2 cases:
+    ///  1. We call ray.put() on this ID and store the contained IDs.
+    ///  2. We call ray.get() on an ID whose contents we do not know and we
+    ///     discover that it contains these IDs.
+    absl::flat_hash_set<ObjectID> contains;
+    /// A list of processes that are we gave a reference to that are still
+    /// borrowing the ID. This field is updated in 2 cases:
+    ///  1. If we are a borrower of the ID, then we add a process to this list
+    ///     if we passed that process a copy of the ID via task submission and
+    ///     the process is still using the ID by the time it finishes its task.
+    ///     Borrowers are removed from the list when we recursively merge our
+    ///     list into the owner.
+    ///  2. If we are the owner of the ID, then either the above case, or when
+    ///     we hear from a borrower that it has passed the ID to other
+    ///     borrowers. A borrower is removed from the list when it responds
+    ///     that it is no longer using the reference.
+    absl::flat_hash_set<rpc::WorkerAddress> borrowers;
+    /// When a process that is borrowing an object ID stores the ID inside the
+    /// return value of a task that it executes, the caller of the task is also
+    /// considered a borrower for as long as its reference to the task's return
+    /// ID stays in scope. Thus, the borrower must notify the owner that the
+    /// task's caller is also a borrower. The key is the task's return ID, and
+    /// the value is the task ID and address of the task's caller.
+    absl::flat_hash_map<ObjectID, rpc::WorkerAddress> stored_in_objects;
+  };
+
+  /// An owning pointer to a NestedReferenceInfo that deep-copies, so that
+  /// References (which are copied when merging borrowers) never alias.
+  class NestedReferenceInfoPtr {
+   public:
+    NestedReferenceInfoPtr() = default;
+    NestedReferenceInfoPtr(const NestedReferenceInfoPtr &other)
+        : info_(other.info_ ? std::make_unique<NestedReferenceInfo>(*other.info_)
+                            : nullptr) {}
+    NestedReferenceInfoPtr(NestedReferenceInfoPtr &&other) = default;
+    NestedReferenceInfoPtr &operator=(const NestedReferenceInfoPtr &other) {
+      info_ = other.info_ ? std::make_unique<NestedReferenceInfo>(*other.info_) : nullptr;
+      return *this;
+    }
+    NestedReferenceInfoPtr &operator=(NestedReferenceInfoPtr &&other) = default;
+
+    const NestedReferenceInfo *get() const { return info_.get(); }
+    NestedReferenceInfo &GetOrCreate() {
+      if (!info_) {
+        info_ = std::make_unique<NestedReferenceInfo>();
+      }
+      return *info_;
+    }
+
+   private:
+    std::unique_ptr<NestedReferenceInfo> info_;
+  };
+
   struct Reference {
     /// Constructor for a reference whose origin is unknown.
     Reference() {}
     Reference(std::string call_site, const int64_t object_size)
         : call_site(call_site), object_size(object_size) {}
     /// Constructor for a reference that we created.
-    Reference(const rpc::Address &owner_address, std::string call_site,
+    Reference(std::shared_ptr<const rpc::Address> owner_address, std::string call_site,
               const int64_t object_size, bool is_reconstructable,
               const absl::optional<NodeID> &pinned_at_raylet_id)
         : call_site(call_site),
           object_size(object_size),
           owned_by_us(true),
-          owner_address(owner_address),
+          owner_address(std::move(owner_address)),
           pinned_at_raylet_id(pinned_at_raylet_id),
           is_reconstructable(is_reconstructable) {}
 
@@ -494,8 +598,20 @@ class ReferenceCounter : public ReferenceCounterInterface,
     /// - ObjectIDs that we own, that contain this ObjectID, and that are still
     ///   in scope.
     size_t RefCount() const {
-      return local_ref_count + submitted_task_ref_count + contained_in_owned.size();
+      return local_ref_count + submitted_task_ref_count +
+             nested().contained_in_owned.size();
+    }
+
+    /// The nested/borrower bookkeeping for this reference. Returns a shared
+    /// empty instance if nothing has been recorded yet.
+    const NestedReferenceInfo &nested() const {
+      static const NestedReferenceInfo kEmpty;
+      const auto *info = nested_info.get();
+      return info ? *info : kEmpty;
     }
+    /// Mutable access to the nested/borrower bookkeeping, allocating it on
+    /// first use.
+    NestedReferenceInfo &mutable_nested() { return nested_info.GetOrCreate(); }
 
     /// Whether this reference is no longer in scope. A reference is in scope
     /// if any of the following are true:
@@ -505,9 +621,10 @@ class ReferenceCounter : public ReferenceCounterInterface,
     /// - We gave the reference to at least one other process.
     bool OutOfScope(bool lineage_pinning_enabled) const {
       bool in_scope = RefCount() > 0;
-      bool was_contained_in_borrowed_id = contained_in_borrowed_id.has_value();
-      bool has_borrowers = borrowers.size() > 0;
-      bool was_stored_in_objects = stored_in_objects.size() > 0;
+      const auto &info = nested();
+      bool was_contained_in_borrowed_id = info.contained_in_borrowed_id.has_value();
+      bool has_borrowers = info.borrowers.size() > 0;
+      bool was_stored_in_objects = info.stored_in_objects.size() > 0;
 
       bool has_lineage_references = false;
       if (lineage_pinning_enabled && owned_by_us && !is_reconstructable) {
@@ -543,8 +660,9 @@ class ReferenceCounter : public ReferenceCounterInterface,
     /// The object's owner's address, if we know it. If this process is the
     /// owner, then this is added during creation of the Reference. If this is
     /// process is a borrower, the borrower must add the owner's address before
-    /// using the ObjectID.
-    absl::optional<rpc::Address> owner_address;
+    /// using the ObjectID. Interned, so that the many objects owned by the
+    /// same worker share a single copy of the address.
+    std::shared_ptr<const rpc::Address> owner_address;
     /// If this object is owned by us and stored in plasma, and reference
     /// counting is enabled, then some raylet must be pinning the object value.
     /// This is the address of that raylet.
@@ -561,56 +679,9 @@ class ReferenceCounter : public ReferenceCounterInterface,
     size_t local_ref_count = 0;
     /// The ref count for submitted tasks that depend on the ObjectID.
     size_t submitted_task_ref_count = 0;
-    /// Object IDs that we own and that contain this object ID.
-    /// ObjectIDs are added to this field when we discover that this object
-    /// contains other IDs. This can happen in 2 cases:
-    ///  1. We call ray.put() and store the inner ID(s) in the outer object.
-    ///  2. A task that we submitted returned an ID(s).
-    /// ObjectIDs are erased from this field when their Reference is deleted.
-    absl::flat_hash_set<ObjectID> contained_in_owned;
-    /// An Object ID that we (or one of our children) borrowed that contains
-    /// this object ID, which is also borrowed. This is used in cases where an
-    /// ObjectID is nested. We need to notify the owner of the outer ID of any
-    /// borrowers of this object, so we keep this field around until
-    /// GetAndClearLocalBorrowersInternal is called on the outer ID. This field
-    /// is updated in 2 cases:
-    ///  1. We deserialize an ID that we do not own and that was stored in
-    ///     another object that we do not own.
-    ///  2. Case (1) occurred for a task that we submitted and we also do not
-    ///     own the inner or outer object. Then, we need to notify our caller
-    ///     that the task we submitted is a borrower for the inner ID.
-    /// This field is reset to null once GetAndClearLocalBorrowersInternal is
-    /// called on contained_in_borrowed_id. For each borrower, this field is
-    /// set at most once during the reference's lifetime. If the object ID is
-    /// later found to be nested in a second object, we do not need to remember
-    /// the second ID because we will already have notified the owner of the
-    /// first outer object about our reference.
-    absl::optional<ObjectID> contained_in_borrowed_id;
-    /// The object IDs contained in this object. These could be objects that we
-    /// own or are borrowing. This field is updated in 2 cases:
-    ///  1. We call ray.put() on this ID and store the contained IDs.
-    ///  2. We call ray.get() on an ID whose contents we do not know and we
-    ///     discover that it contains these IDs.
-    absl::flat_hash_set<ObjectID> contains;
-    /// A list of processes that are we gave a reference to that are still
-    /// borrowing the ID. This field is updated in 2 cases:
-    ///  1. If we are a borrower of the ID, then we add a process to this list
-    ///     if we passed that process a copy of the ID via task submission and
-    ///     the process is still using the ID by the time it finishes its task.
-    ///     Borrowers are removed from the list when we recursively merge our
-    ///     list into the owner.
-    ///  2. If we are the owner of the ID, then either the above case, or when
-    ///     we hear from a borrower that it has passed the ID to other
-    ///     borrowers. A borrower is removed from the list when it responds
-    ///     that it is no longer using the reference.
-    absl::flat_hash_set<rpc::WorkerAddress> borrowers;
-    /// When a process that is borrowing an object ID stores the ID inside the
-    /// return value of a task that it executes, the caller of the task is also
-    /// considered a borrower for as long as its reference to the task's return
-    /// ID stays in scope. Thus, the borrower must notify the owner that the
-    /// task's caller is also a borrower. The key is the task's return ID, and
-    /// the value is the task ID and address of the task's caller.
-    absl::flat_hash_map<ObjectID, rpc::WorkerAddress> stored_in_objects;
+    /// Nesting and borrowing bookkeeping. Most references are never nested
+    /// or borrowed, so this is only allocated on first write.
+    NestedReferenceInfoPtr nested_info;
     /// The number of tasks that depend on this object that may be retried in
     /// the future (pending execution or finished but retryable). If the object
     /// is inlined (not stored in plasma), then its lineage ref count is 0
@@ -635,9 +706,14 @@ class ReferenceCounter : public ReferenceCounterInterface,
 
   using ReferenceTable = absl::flat_hash_map<ObjectID, Reference>;
 
+  /// Return the shared copy of the given owner address, creating it if no
+  /// live Reference holds one yet.
+  std::shared_ptr<const rpc::Address> InternOwnerAddress(const rpc::Address &address)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   bool GetOwnerInternal(const ObjectID &object_id,
                         rpc::Address *owner_address = nullptr) const
-      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+      SHARED_LOCKS_REQUIRED(mutex_);
 
   /// Release the pinned plasma object, if any. Also unsets the raylet address
   /// that the object was pinned at, if the address was set.
@@ -792,12 +868,22 @@ class ReferenceCounter : public ReferenceCounterInterface,
   /// borrower's ref count for the ID goes to 0.
   rpc::CoreWorkerClientPool borrower_pool_;
 
-  /// Protects access to the reference counting state.
+  /// Protects access to the reference counting state. Methods that only read the
+  /// state take it in shared mode, so that lookups such as HasReference and GetOwner
+  /// from many threads do not serialize behind each other.
   mutable absl::Mutex mutex_;
 
   /// Holds all reference counts and dependency information for tracked ObjectIDs.
   ReferenceTable object_id_refs_ GUARDED_BY(mutex_);
 
+  /// Interned owner addresses, keyed by the owner's worker ID. Entries expire
+  /// once no Reference points at them and are purged lazily.
+  absl::flat_hash_map<WorkerID, std::weak_ptr<const rpc::Address>> owner_addresses_
+      GUARDED_BY(mutex_);
+
+  /// Size of owner_addresses_ at which expired entries are next purged.
+  size_t owner_addresses_purge_threshold_ GUARDED_BY(mutex_) = 64;
+
   /// Objects whose values have been freed by the language frontend.
   /// The values in plasma will not be pinned. An object ID is
   /// removed from this set once its Reference has been deleted
@@ -573,6 +573,26 @@ TEST_F(ReferenceCountTest, TestGetLocalityData) {
   ASSERT_FALSE(locality_data_obj2_no_object_size.has_value());
 }
 
+// Tests that a batch of location updates is applied at once.
+TEST_F(ReferenceCountTest, TestUpdateObjectLocations) {
+  ObjectID obj = ObjectID::FromRandom();
+  NodeID node1 = NodeID::FromRandom();
+  NodeID node2 = NodeID::FromRandom();
+  rpc::Address address;
+  address.set_ip_address("1234");
+  rc->AddOwnedObject(obj, {}, address, "file.py:42", 100, false,
+                     absl::optional<NodeID>(node1));
+
+  // The subscribers are notified once for the whole batch.
+  EXPECT_CALL(*publisher_, Publish(::testing::_, ::testing::_, ::testing::_)).Times(1);
+  ASSERT_TRUE(rc->UpdateObjectLocations(obj, {{node1, false}, {node2, true}}));
+  ASSERT_EQ(*rc->GetObjectLocations(obj), absl::flat_hash_set<NodeID>({node2}));
+  // Updates that don't change the locations aren't published.
+  ASSERT_TRUE(rc->UpdateObjectLocations(obj, {{node1, false}, {node2, true}}));
+
+  ASSERT_FALSE(rc->UpdateObjectLocations(ObjectID::FromRandom(), {{node1, true}}));
+}
+
 // Tests that we can get the owner address correctly for objects that we own,
 // objects that we borrowed via a serialized object ID, and objects whose
 // origin we do not know.
@@ -2281,6 +2301,34 @@ TEST_F(ReferenceCountLineageEnabledTest, TestPlasmaLocation) {
   deleted->clear();
 }
 
+TEST_F(ReferenceCountTest, TestMoveObjectPinnedAtRaylet) {
+  ObjectID id = ObjectID::FromRandom();
+  NodeID node_id = NodeID::FromRandom();
+  NodeID new_node_id = NodeID::FromRandom();
+  bool owned_by_us;
+  NodeID pinned_at;
+  bool spilled;
+
+  rc->AddOwnedObject(id, {}, rpc::Address(), "", 0, true);
+  rc->AddLocalReference(id, "");
+  // The object must be pinned somewhere before it can be moved.
+  ASSERT_FALSE(rc->MoveObjectPinnedAtRaylet(id, new_node_id));
+  rc->UpdateObjectPinnedAtRaylet(id, node_id);
+  ASSERT_TRUE(rc->MoveObjectPinnedAtRaylet(id, new_node_id));
+  ASSERT_TRUE(rc->IsPlasmaObjectPinnedOrSpilled(id, &owned_by_us, &pinned_at, &spilled));
+  ASSERT_EQ(pinned_at, new_node_id);
+  auto locations = rc->GetObjectLocations(id);
+  ASSERT_TRUE(locations.has_value());
+  ASSERT_TRUE(locations->count(new_node_id) > 0);
+
+  // Removing the old node doesn't lose the object anymore.
+  ASSERT_TRUE(rc->ResetObjectsOnRemovedNode(node_id).empty());
+  auto objects = rc->ResetObjectsOnRemovedNode(new_node_id);
+  ASSERT_EQ(objects.size(), 1);
+  ASSERT_EQ(objects[0], id);
+  rc->RemoveLocalReference(id, nullptr);
+}
+
 TEST_F(ReferenceCountTest, TestFree) {
   auto deleted = std::make_shared<std::unordered_set<ObjectID>>();
   auto callback = [&](const ObjectID &object_id) { deleted->insert(object_id); };
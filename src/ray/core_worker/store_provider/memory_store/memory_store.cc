@@ -147,19 +147,36 @@ CoreWorkerMemoryStore::CoreWorkerMemoryStore(
     : store_in_plasma_(store_in_plasma),
       ref_counter_(counter),
       raylet_client_(raylet_client),
+      max_bytes_(RayConfig::instance().memory_store_max_bytes()),
       check_signals_(check_signals),
-      unhandled_exception_handler_(unhandled_exception_handler) {}
+      unhandled_exception_handler_(unhandled_exception_handler) {
+  const auto num_shards =
+      std::max<uint64_t>(RayConfig::instance().memory_store_num_shards(), 1);
+  shards_.reserve(num_shards);
+  for (uint64_t i = 0; i < num_shards; i++) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+CoreWorkerMemoryStore::Shard &CoreWorkerMemoryStore::GetShard(
+    const ObjectID &object_id) const {
+  if (shards_.size() == 1) {
+    return *shards_[0];
+  }
+  return *shards_[object_id.Hash() % shards_.size()];
+}
 
 void CoreWorkerMemoryStore::GetAsync(
     const ObjectID &object_id, std::function<void(std::shared_ptr<RayObject>)> callback) {
   std::shared_ptr<RayObject> ptr;
+  auto &shard = GetShard(object_id);
   {
-    absl::MutexLock lock(&mu_);
-    auto iter = objects_.find(object_id);
-    if (iter != objects_.end()) {
+    absl::MutexLock lock(&shard.mu);
+    auto iter = shard.objects.find(object_id);
+    if (iter != shard.objects.end()) {
       ptr = iter->second;
     } else {
-      object_async_get_requests_[object_id].push_back(callback);
+      shard.object_async_get_requests[object_id].push_back(callback);
     }
     if (ptr != nullptr) {
       ptr->SetAccessed();
@@ -173,10 +190,11 @@ void CoreWorkerMemoryStore::GetAsync(
 
 std::shared_ptr<RayObject> CoreWorkerMemoryStore::GetIfExists(const ObjectID &object_id) {
   std::shared_ptr<RayObject> ptr;
+  auto &shard = GetShard(object_id);
   {
-    absl::MutexLock lock(&mu_);
-    auto iter = objects_.find(object_id);
-    if (iter != objects_.end()) {
+    absl::MutexLock lock(&shard.mu);
+    auto iter = shard.objects.find(object_id);
+    if (iter != shard.objects.end()) {
       ptr = iter->second;
     }
     if (ptr != nullptr) {
@@ -188,9 +206,10 @@ std::shared_ptr<RayObject> CoreWorkerMemoryStore::GetIfExists(const ObjectID &ob
 
 std::shared_ptr<RayObject> CoreWorkerMemoryStore::GetOrPromoteToPlasma(
     const ObjectID &object_id) {
-  absl::MutexLock lock(&mu_);
-  auto iter = objects_.find(object_id);
-  if (iter != objects_.end()) {
+  auto &shard = GetShard(object_id);
+  absl::MutexLock lock(&shard.mu);
+  auto iter = shard.objects.find(object_id);
+  if (iter != shard.objects.end()) {
     auto obj = iter->second;
     obj->SetAccessed();
     if (obj->IsInPlasmaError()) {
@@ -200,7 +219,7 @@ std::shared_ptr<RayObject> CoreWorkerMemoryStore::GetOrPromoteToPlasma(
   }
   RAY_CHECK(store_in_plasma_ != nullptr)
       << "Cannot promote object without plasma provider callback.";
-  promoted_to_plasma_.insert(object_id);
+  shard.promoted_to_plasma.insert(object_id);
   return nullptr;
 }
 
@@ -213,33 +232,34 @@ bool CoreWorkerMemoryStore::Put(const RayObject &object, const ObjectID &object_
   // TODO(edoakes): we should instead return a flag to the caller to put the object in
   // plasma.
   bool should_put_in_plasma = false;
+  auto &shard = GetShard(object_id);
   {
-    absl::MutexLock lock(&mu_);
+    absl::MutexLock lock(&shard.mu);
 
-    auto iter = objects_.find(object_id);
-    if (iter != objects_.end()) {
+    auto iter = shard.objects.find(object_id);
+    if (iter != shard.objects.end()) {
       return true;  // Object already exists in the store, which is fine.
     }
 
-    auto async_callback_it = object_async_get_requests_.find(object_id);
-    if (async_callback_it != object_async_get_requests_.end()) {
+    auto async_callback_it = shard.object_async_get_requests.find(object_id);
+    if (async_callback_it != shard.object_async_get_requests.end()) {
       auto &callbacks = async_callback_it->second;
       async_callbacks = std::move(callbacks);
-      object_async_get_requests_.erase(async_callback_it);
+      shard.object_async_get_requests.erase(async_callback_it);
     }
 
-    auto promoted_it = promoted_to_plasma_.find(object_id);
-    if (promoted_it != promoted_to_plasma_.end()) {
+    auto promoted_it = shard.promoted_to_plasma.find(object_id);
+    if (promoted_it != shard.promoted_to_plasma.end()) {
       RAY_CHECK(store_in_plasma_ != nullptr);
       // Only need to promote to plasma if it wasn't already put into plasma
       // by the task that created the object.
       should_put_in_plasma = !object.IsInPlasmaError();
-      promoted_to_plasma_.erase(promoted_it);
+      shard.promoted_to_plasma.erase(promoted_it);
     }
 
     bool should_add_entry = true;
-    auto object_request_iter = object_get_requests_.find(object_id);
-    if (object_request_iter != object_get_requests_.end()) {
+    auto object_request_iter = shard.object_get_requests.find(object_id);
+    if (object_request_iter != shard.object_get_requests.end()) {
       auto &get_requests = object_request_iter->second;
       for (auto &get_request : get_requests) {
         get_request->Set(object_id, object_entry);
@@ -256,7 +276,7 @@ bool CoreWorkerMemoryStore::Put(const RayObject &object, const ObjectID &object_
 
     if (should_add_entry) {
       // If there is no existing get request, then add the `RayObject` to map.
-      EmplaceObjectAndUpdateStats(object_id, object_entry);
+      EmplaceObjectAndUpdateStats(shard, object_id, object_entry);
     } else {
       // It is equivalent to the object being added and immediately deleted from the
       // store.
@@ -281,6 +301,10 @@ bool CoreWorkerMemoryStore::Put(const RayObject &object, const ObjectID &object_
     cb(object_entry);
   }
 
+  if (max_bytes_ > 0 && used_bytes_.load() > max_bytes_) {
+    PromoteColdObjectsIfOverBudget();
+  }
+
   return stored_in_direct_memory;
 }
 
@@ -306,16 +330,17 @@ Status CoreWorkerMemoryStore::GetImpl(const std::vector<ObjectID> &object_ids,
     absl::flat_hash_set<ObjectID> remaining_ids;
     absl::flat_hash_set<ObjectID> ids_to_remove;
 
-    absl::MutexLock lock(&mu_);
     // Check for existing objects and see if this get request can be fullfilled.
     for (size_t i = 0; i < object_ids.size() && count < num_objects; i++) {
       const auto &object_id = object_ids[i];
-      auto iter = objects_.find(object_id);
-      if (iter != objects_.end()) {
+      auto &shard = GetShard(object_id);
+      absl::MutexLock lock(&shard.mu);
+      auto iter = shard.objects.find(object_id);
+      if (iter != shard.objects.end()) {
         iter->second->SetAccessed();
         (*results)[i] = iter->second;
         if (remove_after_get) {
-          // Note that we cannot remove the object_id from `objects_` now,
+          // Note that we cannot remove the object_id from `objects` now,
           // because `object_ids` might have duplicate ids.
           ids_to_remove.insert(object_id);
         }
@@ -329,7 +354,9 @@ Status CoreWorkerMemoryStore::GetImpl(const std::vector<ObjectID> &object_ids,
     // Clean up the objects if ref counting is off.
     if (ref_counter_ == nullptr) {
       for (const auto &object_id : ids_to_remove) {
-        EraseObjectAndUpdateStats(object_id);
+        auto &shard = GetShard(object_id);
+        absl::MutexLock lock(&shard.mu);
+        EraseObjectAndUpdateStats(shard, object_id);
       }
     }
 
@@ -340,12 +367,24 @@ Status CoreWorkerMemoryStore::GetImpl(const std::vector<ObjectID> &object_ids,
 
     size_t required_objects = num_objects - (object_ids.size() - remaining_ids.size());
 
-    // Otherwise, create a GetRequest to track remaining objects.
+    // Otherwise, create a GetRequest to track remaining objects. Each object is
+    // registered under its own shard's lock, so an object that was put after
+    // the check above is handed to the request directly instead.
     get_request =
         std::make_shared<GetRequest>(std::move(remaining_ids), required_objects,
                                      remove_after_get, abort_if_any_object_is_exception);
     for (const auto &object_id : get_request->ObjectIds()) {
-      object_get_requests_[object_id].push_back(get_request);
+      auto &shard = GetShard(object_id);
+      absl::MutexLock lock(&shard.mu);
+      auto iter = shard.objects.find(object_id);
+      if (iter == shard.objects.end()) {
+        shard.object_get_requests[object_id].push_back(get_request);
+        continue;
+      }
+      get_request->Set(object_id, iter->second);
+      if (remove_after_get && ref_counter_ == nullptr) {
+        EraseObjectAndUpdateStats(shard, object_id);
+      }
     }
   }
 
@@ -389,29 +428,28 @@ Status CoreWorkerMemoryStore::GetImpl(const std::vector<ObjectID> &object_ids,
     RAY_CHECK_OK(raylet_client_->NotifyDirectCallTaskUnblocked());
   }
 
-  {
-    absl::MutexLock lock(&mu_);
-    // Populate results.
-    for (size_t i = 0; i < object_ids.size(); i++) {
-      const auto &object_id = object_ids[i];
-      if ((*results)[i] == nullptr) {
-        (*results)[i] = get_request->Get(object_id);
-      }
+  // Populate results.
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    const auto &object_id = object_ids[i];
+    if ((*results)[i] == nullptr) {
+      (*results)[i] = get_request->Get(object_id);
     }
+  }
 
-    // Remove get request.
-    for (const auto &object_id : get_request->ObjectIds()) {
-      auto object_request_iter = object_get_requests_.find(object_id);
-      if (object_request_iter != object_get_requests_.end()) {
-        auto &get_requests = object_request_iter->second;
-        // Erase get_request from the vector.
-        auto it = std::find(get_requests.begin(), get_requests.end(), get_request);
-        if (it != get_requests.end()) {
-          get_requests.erase(it);
-          // If the vector is empty, remove the object ID from the map.
-          if (get_requests.empty()) {
-            object_get_requests_.erase(object_request_iter);
-          }
+  // Remove get request.
+  for (const auto &object_id : get_request->ObjectIds()) {
+    auto &shard = GetShard(object_id);
+    absl::MutexLock lock(&shard.mu);
+    auto object_request_iter = shard.object_get_requests.find(object_id);
+    if (object_request_iter != shard.object_get_requests.end()) {
+      auto &get_requests = object_request_iter->second;
+      // Erase get_request from the vector.
+      auto it = std::find(get_requests.begin(), get_requests.end(), get_request);
+      if (it != get_requests.end()) {
+        get_requests.erase(it);
+        // If the vector is empty, remove the object ID from the map.
+        if (get_requests.empty()) {
+          shard.object_get_requests.erase(object_request_iter);
         }
       }
     }
@@ -475,35 +513,38 @@ Status CoreWorkerMemoryStore::Wait(const absl::flat_hash_set<ObjectID> &object_i
 
 void CoreWorkerMemoryStore::Delete(const absl::flat_hash_set<ObjectID> &object_ids,
                                    absl::flat_hash_set<ObjectID> *plasma_ids_to_delete) {
-  absl::MutexLock lock(&mu_);
   for (const auto &object_id : object_ids) {
-    auto it = objects_.find(object_id);
-    if (it != objects_.end()) {
+    auto &shard = GetShard(object_id);
+    absl::MutexLock lock(&shard.mu);
+    auto it = shard.objects.find(object_id);
+    if (it != shard.objects.end()) {
       if (it->second->IsInPlasmaError()) {
         plasma_ids_to_delete->insert(object_id);
       } else {
         OnDelete(it->second);
-        EraseObjectAndUpdateStats(object_id);
+        EraseObjectAndUpdateStats(shard, object_id);
       }
     }
   }
 }
 
 void CoreWorkerMemoryStore::Delete(const std::vector<ObjectID> &object_ids) {
-  absl::MutexLock lock(&mu_);
   for (const auto &object_id : object_ids) {
-    auto it = objects_.find(object_id);
-    if (it != objects_.end()) {
+    auto &shard = GetShard(object_id);
+    absl::MutexLock lock(&shard.mu);
+    auto it = shard.objects.find(object_id);
+    if (it != shard.objects.end()) {
       OnDelete(it->second);
-      EraseObjectAndUpdateStats(object_id);
+      EraseObjectAndUpdateStats(shard, object_id);
     }
   }
 }
 
 bool CoreWorkerMemoryStore::Contains(const ObjectID &object_id, bool *in_plasma) {
-  absl::MutexLock lock(&mu_);
-  auto it = objects_.find(object_id);
-  if (it != objects_.end()) {
+  auto &shard = GetShard(object_id);
+  absl::MutexLock lock(&shard.mu);
+  auto it = shard.objects.find(object_id);
+  if (it != shard.objects.end()) {
     if (it->second->IsInPlasmaError()) {
       *in_plasma = true;
     }
@@ -529,60 +570,132 @@ void CoreWorkerMemoryStore::OnDelete(std::shared_ptr<RayObject> obj) {
 }
 
 void CoreWorkerMemoryStore::NotifyUnhandledErrors() {
-  absl::MutexLock lock(&mu_);
   int64_t threshold = absl::GetCurrentTimeNanos() - kUnhandledErrorGracePeriodNanos;
-  auto it = objects_.begin();
   int count = 0;
-  while (it != objects_.end() && count < kMaxUnhandledErrorScanItems) {
-    const auto &obj = it->second;
-    if (IsUnhandledError(obj) && obj->CreationTimeNanos() < threshold &&
-        unhandled_exception_handler_ != nullptr) {
-      obj->SetAccessed();
-      unhandled_exception_handler_(*obj);
+  for (const auto &shard : shards_) {
+    absl::MutexLock lock(&shard->mu);
+    auto it = shard->objects.begin();
+    while (it != shard->objects.end() && count < kMaxUnhandledErrorScanItems) {
+      const auto &obj = it->second;
+      if (IsUnhandledError(obj) && obj->CreationTimeNanos() < threshold &&
+          unhandled_exception_handler_ != nullptr) {
+        obj->SetAccessed();
+        unhandled_exception_handler_(*obj);
+      }
+      it++;
+      count++;
     }
-    it++;
-    count++;
   }
 }
 
-inline void CoreWorkerMemoryStore::EraseObjectAndUpdateStats(const ObjectID &object_id) {
-  auto it = objects_.find(object_id);
-  if (it == objects_.end()) {
+inline void CoreWorkerMemoryStore::EraseObjectAndUpdateStats(Shard &shard,
+                                                             const ObjectID &object_id) {
+  auto it = shard.objects.find(object_id);
+  if (it == shard.objects.end()) {
     return;
   }
 
   if (it->second->IsInPlasmaError()) {
-    num_in_plasma_ -= 1;
+    shard.num_in_plasma -= 1;
   } else {
-    num_local_objects_ -= 1;
-    used_object_store_memory_ -= it->second->GetSize();
+    shard.num_local_objects -= 1;
+    shard.used_object_store_memory -= it->second->GetSize();
+    used_bytes_ -= it->second->GetSize();
   }
-  RAY_CHECK(num_in_plasma_ >= 0 && num_local_objects_ >= 0 &&
-            used_object_store_memory_ >= 0);
-  objects_.erase(it);
+  RAY_CHECK(shard.num_in_plasma >= 0 && shard.num_local_objects >= 0 &&
+            shard.used_object_store_memory >= 0);
+  shard.objects.erase(it);
 }
 
 inline void CoreWorkerMemoryStore::EmplaceObjectAndUpdateStats(
-    const ObjectID &object_id, std::shared_ptr<RayObject> &object_entry) {
-  auto inserted = objects_.emplace(object_id, object_entry).second;
+    Shard &shard, const ObjectID &object_id, std::shared_ptr<RayObject> &object_entry) {
+  auto inserted = shard.objects.emplace(object_id, object_entry).second;
   if (inserted) {
     if (object_entry->IsInPlasmaError()) {
-      num_in_plasma_ += 1;
+      shard.num_in_plasma += 1;
     } else {
-      num_local_objects_ += 1;
-      used_object_store_memory_ += object_entry->GetSize();
+      shard.num_local_objects += 1;
+      shard.used_object_store_memory += object_entry->GetSize();
+      used_bytes_ += object_entry->GetSize();
     }
   }
-  RAY_CHECK(num_in_plasma_ >= 0 && num_local_objects_ >= 0 &&
-            used_object_store_memory_ >= 0);
+  RAY_CHECK(shard.num_in_plasma >= 0 && shard.num_local_objects >= 0 &&
+            shard.used_object_store_memory >= 0);
+}
+
+uint64_t CoreWorkerMemoryStore::UsedMemory() const { return used_bytes_.load(); }
+
+void CoreWorkerMemoryStore::PromoteColdObjectsIfOverBudget() {
+  // Promotion needs a way to reach plasma and to tell which objects we own.
+  if (store_in_plasma_ == nullptr || ref_counter_ == nullptr) {
+    return;
+  }
+  // Only one thread promotes at a time. This also stops the Put() of the
+  // in-plasma marker made by store_in_plasma_ from recursing back in here.
+  if (promoting_to_plasma_.exchange(true)) {
+    return;
+  }
+
+  // Collect the objects that can be promoted. Errors and plasma markers are
+  // tiny and borrowed objects must be promoted by their owner.
+  std::vector<std::pair<ObjectID, std::shared_ptr<RayObject>>> candidates;
+  for (const auto &shard : shards_) {
+    absl::MutexLock lock(&shard->mu);
+    for (const auto &it : shard->objects) {
+      if (!it.second->IsException() && ref_counter_->OwnedByUs(it.first)) {
+        candidates.emplace_back(it.first, it.second);
+      }
+    }
+  }
+  // Oldest objects first.
+  std::sort(candidates.begin(), candidates.end(), [](const auto &a, const auto &b) {
+    return a.second->CreationTimeNanos() < b.second->CreationTimeNanos();
+  });
+
+  // Promote down to a low watermark so that the scan above is amortized over
+  // many puts.
+  const int64_t low_watermark = max_bytes_ - max_bytes_ / 5;
+  for (const auto &candidate : candidates) {
+    if (used_bytes_.load() <= low_watermark) {
+      break;
+    }
+    const auto &object_id = candidate.first;
+    {
+      auto &shard = GetShard(object_id);
+      absl::MutexLock lock(&shard.mu);
+      auto it = shard.objects.find(object_id);
+      if (it == shard.objects.end() || it->second != candidate.second) {
+        // Deleted or replaced since we looked.
+        continue;
+      }
+      EraseObjectAndUpdateStats(shard, object_id);
+    }
+    // Concurrent gets of the object block until store_in_plasma_ puts the
+    // in-plasma marker back into the store.
+    RAY_LOG(DEBUG) << "Memory store is over budget, promoting " << object_id
+                   << " to plasma";
+    store_in_plasma_(*candidate.second, object_id);
+  }
+  promoting_to_plasma_ = false;
+}
+
+int CoreWorkerMemoryStore::Size() {
+  int size = 0;
+  for (const auto &shard : shards_) {
+    absl::MutexLock lock(&shard->mu);
+    size += shard->objects.size();
+  }
+  return size;
 }
 
 MemoryStoreStats CoreWorkerMemoryStore::GetMemoryStoreStatisticalData() {
-  absl::MutexLock lock(&mu_);
   MemoryStoreStats item;
-  item.num_in_plasma = num_in_plasma_;
-  item.num_local_objects = num_local_objects_;
-  item.used_object_store_memory = used_object_store_memory_;
+  for (const auto &shard : shards_) {
+    absl::MutexLock lock(&shard->mu);
+    item.num_in_plasma += shard->num_in_plasma;
+    item.num_local_objects += shard->num_local_objects;
+    item.used_object_store_memory += shard->used_object_store_memory;
+  }
   return item;
 }
 
@@ -16,6 +16,8 @@
 
 #include <gtest/gtest_prod.h>
 
+#include <atomic>
+
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/synchronization/mutex.h"
@@ -143,10 +145,7 @@ class CoreWorkerMemoryStore {
   /// Returns the number of objects in this store.
   ///
   /// \return Count of objects in the store.
-  int Size() {
-    absl::MutexLock lock(&mu_);
-    return objects_.size();
-  }
+  int Size();
 
   /// Returns stats data of memory usage.
   ///
@@ -156,7 +155,7 @@ class CoreWorkerMemoryStore {
   /// Returns the memory usage of this store.
   ///
   /// \return Total size of objects in the store.
-  uint64_t UsedMemory();
+  uint64_t UsedMemory() const;
 
   /// Raise any unhandled errors that have not been accessed within a timeout.
   /// This is used to surface unhandled task errors in interactive consoles.
@@ -178,14 +177,56 @@ class CoreWorkerMemoryStore {
   /// Called when an object is deleted from the store.
   void OnDelete(std::shared_ptr<RayObject> obj);
 
+  /// If the store holds more than memory_store_max_bytes, promote the oldest
+  /// objects that we own to plasma until usage drops below a low watermark.
+  /// Must be called without holding any shard lock.
+  void PromoteColdObjectsIfOverBudget();
+
+  /// A slice of the store. Objects are assigned to a shard by ID, and all state
+  /// for an object (its value, pending get requests and stats) lives in that
+  /// shard, so puts and gets of unrelated objects do not contend on one lock.
+  struct Shard {
+    /// Protects the data structures below.
+    mutable absl::Mutex mu;
+
+    /// Set of objects that should be promoted to plasma once available.
+    absl::flat_hash_set<ObjectID> promoted_to_plasma GUARDED_BY(mu);
+
+    /// Map from object ID to `RayObject`.
+    /// NOTE: This map should be modified by EmplaceObjectAndUpdateStats and
+    /// EraseObjectAndUpdateStats.
+    absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> objects GUARDED_BY(mu);
+
+    /// Map from object ID to its get requests.
+    absl::flat_hash_map<ObjectID, std::vector<std::shared_ptr<GetRequest>>>
+        object_get_requests GUARDED_BY(mu);
+
+    /// Map from object ID to its async get requests.
+    absl::flat_hash_map<ObjectID,
+                        std::vector<std::function<void(std::shared_ptr<RayObject>)>>>
+        object_async_get_requests GUARDED_BY(mu);
+
+    /// Number of objects in the plasma store for this shard.
+    int32_t num_in_plasma GUARDED_BY(mu) = 0;
+    /// Number of objects that don't exist in the plasma store.
+    int32_t num_local_objects GUARDED_BY(mu) = 0;
+    /// Number of object store memory used by this shard. (It doesn't include plasma
+    /// store memory usage).
+    int64_t used_object_store_memory GUARDED_BY(mu) = 0;
+  };
+
+  /// Return the shard that holds the given object.
+  Shard &GetShard(const ObjectID &object_id) const;
+
   /// Emplace the given object entry to the in-memory-store and update stats properly.
-  void EmplaceObjectAndUpdateStats(const ObjectID &object_id,
+  void EmplaceObjectAndUpdateStats(Shard &shard, const ObjectID &object_id,
                                    std::shared_ptr<RayObject> &object_entry)
-      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+      EXCLUSIVE_LOCKS_REQUIRED(shard.mu);
 
   /// Erase the object of the object id from the in memory store and update stats
   /// properly.
-  void EraseObjectAndUpdateStats(const ObjectID &object_id) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void EraseObjectAndUpdateStats(Shard &shard, const ObjectID &object_id)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.mu);
 
   /// Optional callback for putting objects into the plasma store.
   std::function<void(const RayObject &, const ObjectID &)> store_in_plasma_;
@@ -197,42 +238,23 @@ class CoreWorkerMemoryStore {
   // If set, this will be used to notify worker blocked / unblocked on get calls.
   std::shared_ptr<raylet::RayletClient> raylet_client_ = nullptr;
 
-  /// Protects the data structures below.
-  mutable absl::Mutex mu_;
-
-  /// Set of objects that should be promoted to plasma once available.
-  absl::flat_hash_set<ObjectID> promoted_to_plasma_ GUARDED_BY(mu_);
+  /// The shards of the store. Fixed at construction.
+  std::vector<std::unique_ptr<Shard>> shards_;
 
-  /// Map from object ID to `RayObject`.
-  /// NOTE: This map should be modified by EmplaceObjectAndUpdateStats and
-  /// EraseObjectAndUpdateStats.
-  absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> objects_ GUARDED_BY(mu_);
+  /// If non-zero, the number of bytes above which objects are promoted to plasma.
+  const int64_t max_bytes_;
 
-  /// Map from object ID to its get requests.
-  absl::flat_hash_map<ObjectID, std::vector<std::shared_ptr<GetRequest>>>
-      object_get_requests_ GUARDED_BY(mu_);
+  /// Total size of the objects in all shards, excluding plasma markers.
+  std::atomic<int64_t> used_bytes_{0};
 
-  /// Map from object ID to its async get requests.
-  absl::flat_hash_map<ObjectID,
-                      std::vector<std::function<void(std::shared_ptr<RayObject>)>>>
-      object_async_get_requests_ GUARDED_BY(mu_);
+  /// Whether a thread is currently promoting objects to plasma.
+  std::atomic<bool> promoting_to_plasma_{false};
 
   /// Function passed in to be called to check for signals (e.g., Ctrl-C).
   std::function<Status()> check_signals_;
 
   /// Function called to report unhandled exceptions.
   std::function<void(const RayObject &)> unhandled_exception_handler_;
-
-  ///
-  /// Below information is stats.
-  ///
-  /// Number of objects in the plasma store for this memory store.
-  int32_t num_in_plasma_ GUARDED_BY(mu_) = 0;
-  /// Number of objects that don't exist in the plasma store.
-  int32_t num_local_objects_ GUARDED_BY(mu_) = 0;
-  /// Number of object store memory used by this memory store. (It doesn't include plasma
-  /// store memory usage).
-  int64_t used_object_store_memory_ GUARDED_BY(mu_) = 0;
 };
 
 }  // namespace core
@@ -57,8 +57,13 @@ CoreWorkerPlasmaStoreProvider::CoreWorkerPlasmaStoreProvider(
     const std::shared_ptr<raylet::RayletClient> raylet_client,
     const std::shared_ptr<ReferenceCounter> reference_counter,
     std::function<Status()> check_signals, bool warmup,
-    std::function<std::string()> get_current_call_site)
+    std::function<std::string()> get_current_call_site,
+    std::shared_ptr<plasma::PlasmaClient> shared_store_client)
     : raylet_client_(raylet_client),
+      store_client_(shared_store_client != nullptr
+                        ? shared_store_client
+                        : std::make_shared<plasma::PlasmaClient>()),
+      store_client_shared_(shared_store_client != nullptr),
       reference_counter_(reference_counter),
       check_signals_(check_signals) {
   if (get_current_call_site != nullptr) {
@@ -68,14 +73,19 @@ CoreWorkerPlasmaStoreProvider::CoreWorkerPlasmaStoreProvider(
   }
   object_store_full_delay_ms_ = RayConfig::instance().object_store_full_delay_ms();
   buffer_tracker_ = std::make_shared<BufferTracker>();
-  RAY_CHECK_OK(store_client_.Connect(store_socket));
+  if (!store_client_shared_) {
+    RAY_CHECK_OK(store_client_->Connect(store_socket));
+  }
   if (warmup) {
     RAY_CHECK_OK(WarmupStore());
   }
 }
 
 CoreWorkerPlasmaStoreProvider::~CoreWorkerPlasmaStoreProvider() {
-  RAY_IGNORE_EXPR(store_client_.Disconnect());
+  // A shared client is disconnected by the worker process once all its workers are gone.
+  if (!store_client_shared_) {
+    RAY_IGNORE_EXPR(store_client_->Disconnect());
+  }
 }
 
 Status CoreWorkerPlasmaStoreProvider::Put(const RayObject &object,
@@ -108,15 +118,19 @@ Status CoreWorkerPlasmaStoreProvider::Create(const std::shared_ptr<Buffer> &meta
                                              const ObjectID &object_id,
                                              const rpc::Address &owner_address,
                                              std::shared_ptr<Buffer> *data,
-                                             bool created_by_worker) {
+                                             bool created_by_worker,
+                                             bool is_task_return) {
   auto source = plasma::flatbuf::ObjectSource::CreatedByWorker;
+  auto priority = is_task_return ? plasma::flatbuf::CreatePriority::TaskReturn
+                                 : plasma::flatbuf::CreatePriority::UserPut;
   if (!created_by_worker) {
     source = plasma::flatbuf::ObjectSource::RestoredFromStorage;
+    priority = plasma::flatbuf::CreatePriority::Restore;
   }
-  Status status = store_client_.CreateAndSpillIfNeeded(
+  Status status = store_client_->CreateAndSpillIfNeeded(
       object_id, owner_address, data_size, metadata ? metadata->Data() : nullptr,
       metadata ? metadata->Size() : 0, data, source,
-      /*device_num=*/0);
+      /*device_num=*/0, priority);
 
   if (status.IsObjectStoreFull()) {
     RAY_LOG(ERROR) << "Failed to put object " << object_id
@@ -144,11 +158,11 @@ Status CoreWorkerPlasmaStoreProvider::Create(const std::shared_ptr<Buffer> &meta
 }
 
 Status CoreWorkerPlasmaStoreProvider::Seal(const ObjectID &object_id) {
-  return store_client_.Seal(object_id);
+  return store_client_->Seal(object_id);
 }
 
 Status CoreWorkerPlasmaStoreProvider::Release(const ObjectID &object_id) {
-  return store_client_.Release(object_id);
+  return store_client_->Release(object_id);
 }
 
 Status CoreWorkerPlasmaStoreProvider::FetchAndGetFromPlasmaStore(
@@ -156,14 +170,28 @@ Status CoreWorkerPlasmaStoreProvider::FetchAndGetFromPlasmaStore(
     int64_t timeout_ms, bool fetch_only, bool in_direct_call, const TaskID &task_id,
     absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> *results,
     bool *got_exception) {
+  RAY_RETURN_NOT_OK(FetchFromRaylet(batch_ids, fetch_only, in_direct_call, task_id));
+  return GetFromPlasmaStore(remaining, batch_ids, timeout_ms,
+                            /*num_objects_to_wait_for=*/0, results, got_exception);
+}
+
+Status CoreWorkerPlasmaStoreProvider::FetchFromRaylet(
+    const std::vector<ObjectID> &batch_ids, bool fetch_only, bool in_direct_call,
+    const TaskID &task_id) {
   const auto owner_addresses = reference_counter_->GetOwnerAddresses(batch_ids);
-  RAY_RETURN_NOT_OK(raylet_client_->FetchOrReconstruct(
-      batch_ids, owner_addresses, fetch_only, /*mark_worker_blocked*/ !in_direct_call,
-      task_id));
+  return raylet_client_->FetchOrReconstruct(batch_ids, owner_addresses, fetch_only,
+                                            /*mark_worker_blocked*/ !in_direct_call,
+                                            task_id);
+}
 
+Status CoreWorkerPlasmaStoreProvider::GetFromPlasmaStore(
+    absl::flat_hash_set<ObjectID> &remaining, const std::vector<ObjectID> &batch_ids,
+    int64_t timeout_ms, int64_t num_objects_to_wait_for,
+    absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> *results,
+    bool *got_exception) {
   std::vector<plasma::ObjectBuffer> plasma_results;
-  RAY_RETURN_NOT_OK(store_client_.Get(batch_ids, timeout_ms, &plasma_results,
-                                      /*is_from_worker=*/true));
+  RAY_RETURN_NOT_OK(store_client_->Get(batch_ids, timeout_ms, &plasma_results,
+                                      /*is_from_worker=*/true, num_objects_to_wait_for));
 
   // Add successfully retrieved objects to the result map and remove them from
   // the set of IDs to get.
@@ -201,7 +229,7 @@ Status CoreWorkerPlasmaStoreProvider::GetIfLocal(
     absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> *results) {
   std::vector<plasma::ObjectBuffer> plasma_results;
   // Since this path is used only for spilling, we should set is_from_worker: false.
-  RAY_RETURN_NOT_OK(store_client_.Get(object_ids, /*timeout_ms=*/0, &plasma_results,
+  RAY_RETURN_NOT_OK(store_client_->Get(object_ids, /*timeout_ms=*/0, &plasma_results,
                                       /*is_from_worker=*/false));
 
   for (size_t i = 0; i < object_ids.size(); i++) {
@@ -255,10 +283,8 @@ Status CoreWorkerPlasmaStoreProvider::Get(
   std::vector<ObjectID> id_vector(object_ids.begin(), object_ids.end());
   int64_t total_size = static_cast<int64_t>(object_ids.size());
   for (int64_t start = 0; start < total_size; start += batch_size) {
-    batch_ids.clear();
-    for (int64_t i = start; i < batch_size && i < total_size; i++) {
-      batch_ids.push_back(id_vector[start + i]);
-    }
+    batch_ids.assign(id_vector.begin() + start,
+                     id_vector.begin() + std::min(start + batch_size, total_size));
     RAY_RETURN_NOT_OK(
         FetchAndGetFromPlasmaStore(remaining, batch_ids, /*timeout_ms=*/0,
                                    /*fetch_only=*/true, ctx.CurrentTaskIsDirectCall(),
@@ -271,12 +297,29 @@ Status CoreWorkerPlasmaStoreProvider::Get(
     return UnblockIfNeeded(raylet_client_, ctx);
   }
 
-  // If not all objects were successfully fetched, repeatedly call FetchOrReconstruct
-  // and Get from the local object store in batches. This loop will run indefinitely
-  // until the objects are all fetched if timeout is -1.
+  // This is a separate IPC from the fetches in direct call mode.
+  if (ctx.CurrentTaskIsDirectCall() && ctx.ShouldReleaseResourcesOnBlockingCalls()) {
+    RAY_RETURN_NOT_OK(raylet_client_->NotifyDirectCallTaskBlocked(
+        /*release_resources_during_plasma_fetch=*/false));
+  }
+  // Ask the raylet for all of the remaining objects up front, so that they are
+  // pulled or reconstructed in parallel rather than one batch at a time.
+  std::vector<ObjectID> remaining_ids(remaining.begin(), remaining.end());
+  int64_t num_remaining = static_cast<int64_t>(remaining_ids.size());
+  for (int64_t start = 0; start < num_remaining; start += batch_size) {
+    batch_ids.assign(remaining_ids.begin() + start,
+                     remaining_ids.begin() + std::min(start + batch_size, num_remaining));
+    RAY_RETURN_NOT_OK(FetchFromRaylet(batch_ids, /*fetch_only=*/false,
+                                      ctx.CurrentTaskIsDirectCall(),
+                                      ctx.GetCurrentTaskID()));
+  }
+
+  // Then take the objects from plasma as they are sealed. Each get returns as soon
+  // as any object of its batch is sealed, so a slow object doesn't hold up the
+  // others. This loop will run indefinitely until the objects are all fetched if
+  // timeout is -1.
   bool should_break = false;
   bool timed_out = false;
-  int64_t remaining_timeout = timeout_ms;
   auto fetch_start_time_ms = current_time_ms();
   while (!remaining.empty() && !should_break) {
     batch_ids.clear();
@@ -289,25 +332,27 @@ Status CoreWorkerPlasmaStoreProvider::Get(
 
     int64_t batch_timeout = std::max(RayConfig::instance().get_timeout_milliseconds(),
                                      int64_t(10 * batch_ids.size()));
-    if (remaining_timeout >= 0) {
+    if (timeout_ms >= 0) {
+      int64_t remaining_timeout =
+          std::max<int64_t>(timeout_ms - (current_time_ms() - fetch_start_time_ms), 0);
       batch_timeout = std::min(remaining_timeout, batch_timeout);
-      remaining_timeout -= batch_timeout;
-      timed_out = remaining_timeout <= 0;
+    }
+    if (store_client_shared_) {
+      // The client is locked while the get blocks, so wait in short slices.
+      batch_timeout = std::min(
+          batch_timeout, RayConfig::instance().shared_plasma_client_get_slice_ms());
     }
 
     size_t previous_size = remaining.size();
-    // This is a separate IPC from the FetchAndGet in direct call mode.
-    if (ctx.CurrentTaskIsDirectCall() && ctx.ShouldReleaseResourcesOnBlockingCalls()) {
-      RAY_RETURN_NOT_OK(raylet_client_->NotifyDirectCallTaskBlocked(
-          /*release_resources_during_plasma_fetch=*/false));
-    }
-    RAY_RETURN_NOT_OK(
-        FetchAndGetFromPlasmaStore(remaining, batch_ids, batch_timeout,
-                                   /*fetch_only=*/false, ctx.CurrentTaskIsDirectCall(),
-                                   ctx.GetCurrentTaskID(), results, got_exception));
+    RAY_RETURN_NOT_OK(GetFromPlasmaStore(remaining, batch_ids, batch_timeout,
+                                         /*num_objects_to_wait_for=*/1, results,
+                                         got_exception));
+    timed_out = timeout_ms >= 0 &&
+                current_time_ms() - fetch_start_time_ms >= timeout_ms;
     should_break = timed_out || *got_exception;
 
-    if ((previous_size - remaining.size()) < batch_ids.size()) {
+    bool made_progress = remaining.size() < previous_size;
+    if (!made_progress) {
       WarnIfFetchHanging(fetch_start_time_ms, remaining);
     }
     if (check_signals_) {
@@ -319,7 +364,7 @@ Status CoreWorkerPlasmaStoreProvider::Get(
       }
     }
     if (RayConfig::instance().yield_plasma_lock_workaround() && !should_break &&
-        remaining.size() > 0) {
+        !made_progress && remaining.size() > 0) {
       // Yield the plasma lock to other threads. This is a temporary workaround since we
       // are holding the lock for a long time, so it can easily starve inbound RPC
       // requests to Release() buffers which only require holding the lock for brief
@@ -340,7 +385,7 @@ Status CoreWorkerPlasmaStoreProvider::Get(
 
 Status CoreWorkerPlasmaStoreProvider::Contains(const ObjectID &object_id,
                                                bool *has_object) {
-  return store_client_.Contains(object_id, has_object);
+  return store_client_->Contains(object_id, has_object);
 }
 
 Status CoreWorkerPlasmaStoreProvider::Wait(
@@ -393,7 +438,7 @@ Status CoreWorkerPlasmaStoreProvider::Delete(
 }
 
 std::string CoreWorkerPlasmaStoreProvider::MemoryUsageString() {
-  return store_client_.DebugString();
+  return store_client_->DebugString();
 }
 
 absl::flat_hash_map<ObjectID, std::pair<int64_t, std::string>>
@@ -90,7 +90,8 @@ class CoreWorkerPlasmaStoreProvider {
       const std::shared_ptr<raylet::RayletClient> raylet_client,
       const std::shared_ptr<ReferenceCounter> reference_counter,
       std::function<Status()> check_signals, bool warmup,
-      std::function<std::string()> get_current_call_site = nullptr);
+      std::function<std::string()> get_current_call_site = nullptr,
+      std::shared_ptr<plasma::PlasmaClient> shared_store_client = nullptr);
 
   ~CoreWorkerPlasmaStoreProvider();
 
@@ -116,9 +117,14 @@ class CoreWorkerPlasmaStoreProvider {
   /// \param[in] object_id The ID of the object.
   /// \param[in] owner_address The address of the object's owner.
   /// \param[out] data The mutable object buffer in plasma that can be written to.
+  /// \param[in] created_by_worker False if the object is restored from external
+  /// storage.
+  /// \param[in] is_task_return Whether the object is the return value of a task.
+  /// The store serves the creation of task returns first when it is low on memory.
   Status Create(const std::shared_ptr<Buffer> &metadata, const size_t data_size,
                 const ObjectID &object_id, const rpc::Address &owner_address,
-                std::shared_ptr<Buffer> *data, bool created_by_worker);
+                std::shared_ptr<Buffer> *data, bool created_by_worker,
+                bool is_task_return = false);
 
   /// Seal an object buffer created with Create().
   ///
@@ -194,6 +200,36 @@ class CoreWorkerPlasmaStoreProvider {
       absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> *results,
       bool *got_exception);
 
+  /// Ask the raylet to fetch a set of objects, without waiting for them.
+  ///
+  /// \param[in] batch_ids IDs of the objects to fetch.
+  /// \param[in] fetch_only Whether the raylet should only fetch or also attempt to
+  /// reconstruct objects.
+  /// \param[in] in_direct_call_task Whether the current task is direct call.
+  /// \param[in] task_id The current TaskID.
+  /// \return Status.
+  Status FetchFromRaylet(const std::vector<ObjectID> &batch_ids, bool fetch_only,
+                         bool in_direct_call_task, const TaskID &task_id);
+
+  /// Get a set of objects from the local plasma store. Successfully fetched
+  /// objects will be removed from the input set of remaining IDs and added to the
+  /// results map.
+  ///
+  /// \param[in/out] remaining IDs of the remaining objects to get.
+  /// \param[in] batch_ids IDs of the objects to get.
+  /// \param[in] timeout_ms Timeout in milliseconds.
+  /// \param[in] num_objects_to_wait_for Return as soon as this many objects are
+  /// sealed, or 0 to wait for all of them.
+  /// \param[out] results Map of objects to write results into.
+  /// \param[out] got_exception Set to true if any of the fetched objects contained an
+  /// exception.
+  /// \return Status.
+  Status GetFromPlasmaStore(
+      absl::flat_hash_set<ObjectID> &remaining, const std::vector<ObjectID> &batch_ids,
+      int64_t timeout_ms, int64_t num_objects_to_wait_for,
+      absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> *results,
+      bool *got_exception);
+
   /// Print a warning if we've attempted the fetch for too long and some
   /// objects are still unavailable.
   static void WarnIfFetchHanging(int64_t fetch_start_time_ms,
@@ -206,7 +242,10 @@ class CoreWorkerPlasmaStoreProvider {
   Status WarmupStore();
 
   const std::shared_ptr<raylet::RayletClient> raylet_client_;
-  plasma::PlasmaClient store_client_;
+  /// The client to the local plasma store. It is either owned by this provider, or
+  /// connected by the worker process and shared with the other workers of the process.
+  std::shared_ptr<plasma::PlasmaClient> store_client_;
+  const bool store_client_shared_;
   /// Used to look up a plasma object's owner.
   const std::shared_ptr<ReferenceCounter> reference_counter_;
   std::function<Status()> check_signals_;
@@ -35,7 +35,44 @@ void TaskManager::AddPendingTask(const rpc::Address &caller_address,
                                  const std::string &call_site, int max_retries) {
   RAY_LOG(DEBUG) << "Adding pending task " << spec.TaskId() << " with " << max_retries
                  << " retries";
+  size_t num_returns = AddPendingTaskReferences(caller_address, spec, call_site);
+
+  // Count the task before it can be completed by another thread.
+  num_submissible_tasks_++;
+  num_pending_tasks_++;
+  auto &shard = ShardOf(spec.TaskId());
+  absl::MutexLock lock(&shard.mu);
+  RAY_CHECK(shard.tasks.emplace(spec.TaskId(), TaskEntry(spec, max_retries, num_returns))
+                .second);
+}
+
+void TaskManager::AddPendingTasks(const rpc::Address &caller_address,
+                                  const std::vector<TaskSpecification> &specs,
+                                  const std::string &call_site, int max_retries) {
+  RAY_LOG(DEBUG) << "Adding " << specs.size() << " pending tasks with " << max_retries
+                 << " retries";
+  std::vector<size_t> num_returns;
+  num_returns.reserve(specs.size());
+  for (const auto &spec : specs) {
+    num_returns.push_back(AddPendingTaskReferences(caller_address, spec, call_site));
+  }
+
+  // Count the tasks before they can be completed by another thread.
+  num_submissible_tasks_ += specs.size();
+  num_pending_tasks_ += specs.size();
+  for (size_t i = 0; i < specs.size(); i++) {
+    auto &shard = ShardOf(specs[i].TaskId());
+    absl::MutexLock lock(&shard.mu);
+    RAY_CHECK(shard.tasks
+                  .emplace(specs[i].TaskId(),
+                           TaskEntry(specs[i], max_retries, num_returns[i]))
+                  .second);
+  }
+}
 
+size_t TaskManager::AddPendingTaskReferences(const rpc::Address &caller_address,
+                                             const TaskSpecification &spec,
+                                             const std::string &call_site) {
   // Add references for the dependencies to the task.
   std::vector<ObjectID> task_deps;
   for (size_t i = 0; i < spec.NumArgs(); i++) {
@@ -57,6 +94,11 @@ void TaskManager::AddPendingTask(const rpc::Address &caller_address,
   }
   reference_counter_->UpdateSubmittedTaskReferences(task_deps);
 
+  if (spec.IsStreamingGenerator()) {
+    absl::MutexLock lock(&object_ref_streams_mu_);
+    object_ref_streams_.emplace(spec.TaskId(), ObjectRefStream());
+  }
+
   // Add new owned objects for the return values of the task.
   size_t num_returns = spec.NumReturns();
   if (spec.IsActorTask()) {
@@ -74,14 +116,7 @@ void TaskManager::AddPendingTask(const rpc::Address &caller_address,
                                          /*is_reconstructable=*/true);
     }
   }
-
-  {
-    absl::MutexLock lock(&mu_);
-    RAY_CHECK(submissible_tasks_
-                  .emplace(spec.TaskId(), TaskEntry(spec, max_retries, num_returns))
-                  .second);
-    num_pending_tasks_++;
-  }
+  return num_returns;
 }
 
 Status TaskManager::ResubmitTask(const TaskID &task_id,
@@ -89,15 +124,17 @@ Status TaskManager::ResubmitTask(const TaskID &task_id,
   TaskSpecification spec;
   bool resubmit = false;
   {
-    absl::MutexLock lock(&mu_);
-    auto it = submissible_tasks_.find(task_id);
-    if (it == submissible_tasks_.end()) {
+    auto &shard = ShardOf(task_id);
+    absl::MutexLock lock(&shard.mu);
+    auto it = shard.tasks.find(task_id);
+    if (it == shard.tasks.end()) {
       return Status::Invalid("Task spec missing");
     }
 
     if (!it->second.pending) {
       resubmit = true;
       it->second.pending = true;
+      UnpinLineage(it->second);
       if (it->second.num_retries_left > 0) {
         it->second.num_retries_left--;
       } else {
@@ -141,7 +178,7 @@ void TaskManager::DrainAndShutdown(std::function<void()> shutdown) {
     if (num_pending_tasks_ > 0) {
       has_pending_tasks = true;
       RAY_LOG(WARNING)
-          << "This worker is still managing " << submissible_tasks_.size()
+          << "This worker is still managing " << num_submissible_tasks_.load()
           << " in flight tasks, waiting for them to finish before shutting down.";
       shutdown_hook_ = shutdown;
     }
@@ -153,28 +190,270 @@ void TaskManager::DrainAndShutdown(std::function<void()> shutdown) {
   }
 }
 
+TaskManager::TaskShard &TaskManager::ShardOf(const TaskID &task_id) {
+  return task_shards_[std::hash<TaskID>()(task_id) % kNumTaskShards];
+}
+
+const TaskManager::TaskShard &TaskManager::ShardOf(const TaskID &task_id) const {
+  return task_shards_[std::hash<TaskID>()(task_id) % kNumTaskShards];
+}
+
 bool TaskManager::IsTaskSubmissible(const TaskID &task_id) const {
-  absl::MutexLock lock(&mu_);
-  return submissible_tasks_.count(task_id) > 0;
+  const auto &shard = ShardOf(task_id);
+  absl::MutexLock lock(&shard.mu);
+  return shard.tasks.count(task_id) > 0;
 }
 
 bool TaskManager::IsTaskPending(const TaskID &task_id) const {
-  absl::MutexLock lock(&mu_);
-  const auto it = submissible_tasks_.find(task_id);
-  if (it == submissible_tasks_.end()) {
+  const auto &shard = ShardOf(task_id);
+  absl::MutexLock lock(&shard.mu);
+  const auto it = shard.tasks.find(task_id);
+  if (it == shard.tasks.end()) {
     return false;
   }
   return it->second.pending;
 }
 
-size_t TaskManager::NumSubmissibleTasks() const {
-  absl::MutexLock lock(&mu_);
-  return submissible_tasks_.size();
+size_t TaskManager::NumSubmissibleTasks() const { return num_submissible_tasks_; }
+
+size_t TaskManager::NumPendingTasks() const { return num_pending_tasks_; }
+
+int64_t TaskManager::LineageFootprintBytes() const {
+  return total_lineage_footprint_bytes_;
+}
+
+int64_t TaskManager::NumLineageEvicted() const { return num_lineage_evicted_; }
+
+void TaskManager::PinLineage(const TaskID &task_id, TaskEntry &entry) {
+  RAY_CHECK(entry.lineage_footprint_bytes == 0);
+  entry.lineage_footprint_bytes = entry.spec.GetMessage().ByteSizeLong();
+  total_lineage_footprint_bytes_ += entry.lineage_footprint_bytes;
+  if (max_lineage_bytes_ > 0) {
+    absl::MutexLock lock(&mu_);
+    lineage_eviction_queue_.push_back(task_id);
+  }
 }
 
-size_t TaskManager::NumPendingTasks() const {
+void TaskManager::UnpinLineage(TaskEntry &entry) {
+  total_lineage_footprint_bytes_ -= entry.lineage_footprint_bytes;
+  entry.lineage_footprint_bytes = 0;
+}
+
+void TaskManager::EvictLineageIfNeeded(std::vector<ObjectID> *args_to_release) {
+  if (max_lineage_bytes_ <= 0) {
+    return;
+  }
+  while (total_lineage_footprint_bytes_ > max_lineage_bytes_) {
+    TaskID task_id;
+    {
+      absl::MutexLock lock(&mu_);
+      if (lineage_eviction_queue_.empty()) {
+        break;
+      }
+      task_id = lineage_eviction_queue_.front();
+      lineage_eviction_queue_.pop_front();
+    }
+    auto &shard = ShardOf(task_id);
+    absl::MutexLock lock(&shard.mu);
+    auto it = shard.tasks.find(task_id);
+    if (it == shard.tasks.end() || it->second.lineage_footprint_bytes == 0) {
+      // Already erased or resubmitted since it was queued.
+      continue;
+    }
+    RAY_LOG(DEBUG) << "Evicting lineage of task " << task_id << " of size "
+                   << it->second.lineage_footprint_bytes;
+    UnpinLineage(it->second);
+    GetTaskArgIds(it->second.spec, args_to_release);
+    shard.tasks.erase(it);
+    num_submissible_tasks_--;
+    num_lineage_evicted_++;
+  }
+
+  // Drop stale queue entries so that the queue stays proportional to the
+  // number of tasks that are still pinned. The shards can't be locked while
+  // holding mu_, so the queue is filtered outside of it, and the tasks pinned
+  // in the meantime are appended after the filtered ones.
+  std::deque<TaskID> queue;
+  {
+    absl::MutexLock lock(&mu_);
+    if (lineage_eviction_queue_.size() <= 2 * num_submissible_tasks_) {
+      return;
+    }
+    queue.swap(lineage_eviction_queue_);
+  }
+  std::deque<TaskID> live_queue;
+  absl::flat_hash_set<TaskID> seen;
+  for (const auto &task_id : queue) {
+    const auto &shard = ShardOf(task_id);
+    absl::MutexLock lock(&shard.mu);
+    auto it = shard.tasks.find(task_id);
+    if (it != shard.tasks.end() && it->second.lineage_footprint_bytes > 0 &&
+        seen.insert(task_id).second) {
+      live_queue.push_back(task_id);
+    }
+  }
   absl::MutexLock lock(&mu_);
-  return num_pending_tasks_;
+  live_queue.insert(live_queue.end(), lineage_eviction_queue_.begin(),
+                    lineage_eviction_queue_.end());
+  lineage_eviction_queue_.swap(live_queue);
+}
+
+void TaskManager::GetTaskArgIds(const TaskSpecification &spec,
+                                std::vector<ObjectID> *ids) {
+  for (size_t i = 0; i < spec.NumArgs(); i++) {
+    if (spec.ArgByRef(i)) {
+      ids->push_back(spec.ArgId(i));
+    } else {
+      const auto &inlined_refs = spec.ArgInlinedRefs(i);
+      for (const auto &inlined_ref : inlined_refs) {
+        ids->push_back(ObjectID::FromBinary(inlined_ref.object_id()));
+      }
+    }
+  }
+}
+
+bool TaskManager::HandleTaskReturn(const TaskID &task_id, const ObjectID &object_id,
+                                   const rpc::ReturnObject &return_object,
+                                   const rpc::Address &worker_addr) {
+  bool stored_in_direct_memory = false;
+  reference_counter_->UpdateObjectSize(object_id, return_object.size());
+  RAY_LOG(DEBUG) << "Task return object " << object_id << " has size "
+                 << return_object.size();
+
+  const auto nested_refs =
+      VectorFromProtobuf<rpc::ObjectReference>(return_object.nested_inlined_refs());
+  if (return_object.in_plasma()) {
+    const auto pinned_at_raylet_id = NodeID::FromBinary(worker_addr.raylet_id());
+    if (check_node_alive_(pinned_at_raylet_id)) {
+      reference_counter_->UpdateObjectPinnedAtRaylet(object_id, pinned_at_raylet_id);
+      // Mark it as in plasma with a dummy object.
+      RAY_CHECK(
+          in_memory_store_->Put(RayObject(rpc::ErrorType::OBJECT_IN_PLASMA), object_id));
+    } else {
+      RAY_LOG(DEBUG) << "Task " << task_id << " returned object " << object_id
+                     << " in plasma on a dead node, attempting to recover.";
+      reconstruct_object_callback_(object_id);
+    }
+  } else {
+    // NOTE(swang): If a direct object was promoted to plasma, then we do not
+    // record the node ID that it was pinned at, which means that we will not
+    // be able to reconstruct it if the plasma object copy is lost. However,
+    // this is okay because the pinned copy is on the local node, so we will
+    // fate-share with the object if the local node fails.
+    std::shared_ptr<LocalMemoryBuffer> data_buffer;
+    if (return_object.data().size() > 0) {
+      data_buffer = std::make_shared<LocalMemoryBuffer>(
+          const_cast<uint8_t *>(
+              reinterpret_cast<const uint8_t *>(return_object.data().data())),
+          return_object.data().size());
+    }
+    std::shared_ptr<LocalMemoryBuffer> metadata_buffer;
+    if (return_object.metadata().size() > 0) {
+      metadata_buffer = std::make_shared<LocalMemoryBuffer>(
+          const_cast<uint8_t *>(
+              reinterpret_cast<const uint8_t *>(return_object.metadata().data())),
+          return_object.metadata().size());
+    }
+
+    stored_in_direct_memory = in_memory_store_->Put(
+        RayObject(data_buffer, metadata_buffer, nested_refs), object_id);
+  }
+
+  rpc::Address owner_address;
+  if (reference_counter_->GetOwner(object_id, &owner_address) && !nested_refs.empty()) {
+    std::vector<ObjectID> nested_ids;
+    for (const auto &nested_ref : nested_refs) {
+      nested_ids.emplace_back(ObjectRefToId(nested_ref));
+    }
+    reference_counter_->AddNestedObjectIds(object_id, nested_ids, owner_address);
+  }
+  return stored_in_direct_memory;
+}
+
+bool TaskManager::HandleReportGeneratorItemReturns(
+    const rpc::ReportGeneratorItemReturnsRequest &request) {
+  const auto generator_id = TaskID::FromBinary(request.generator_id());
+  const auto &return_object = request.returned_object();
+  const auto object_id = ObjectID::FromBinary(return_object.object_id());
+  const int64_t item_index = request.item_index();
+  rpc::Address caller_address;
+  {
+    auto &shard = ShardOf(generator_id);
+    absl::MutexLock lock(&shard.mu);
+    auto it = shard.tasks.find(generator_id);
+    if (it == shard.tasks.end() || !it->second.pending) {
+      RAY_LOG(DEBUG) << "Ignoring item " << item_index << " of generator "
+                     << generator_id << ", which is no longer pending";
+      return false;
+    }
+    caller_address = it->second.spec.CallerAddress();
+  }
+  {
+    absl::MutexLock lock(&object_ref_streams_mu_);
+    auto it = object_ref_streams_.find(generator_id);
+    // A retried task reports the items of its previous attempts again.
+    if (it == object_ref_streams_.end() || item_index < it->second.next_index ||
+        it->second.items.contains(item_index)) {
+      return false;
+    }
+    // The stream holds a local reference to the item until it is read.
+    reference_counter_->AddOwnedObject(object_id, /*inner_ids=*/{}, caller_address,
+                                       /*call_site=*/"", return_object.size(),
+                                       /*is_reconstructable=*/false);
+    reference_counter_->AddLocalReference(object_id, /*call_site=*/"");
+    it->second.items.emplace(item_index, object_id);
+  }
+  HandleTaskReturn(generator_id, object_id, return_object, request.worker_addr());
+  return true;
+}
+
+Status TaskManager::TryReadObjectRefStream(const TaskID &generator_id,
+                                           ObjectID *object_id, bool *end_of_stream) {
+  absl::MutexLock lock(&object_ref_streams_mu_);
+  *object_id = ObjectID::Nil();
+  *end_of_stream = false;
+  auto it = object_ref_streams_.find(generator_id);
+  if (it == object_ref_streams_.end()) {
+    return Status::NotFound("No object ref stream for task " + generator_id.Hex());
+  }
+  auto &stream = it->second;
+  auto item = stream.items.find(stream.next_index);
+  if (item != stream.items.end()) {
+    *object_id = item->second;
+    stream.items.erase(item);
+    stream.next_index++;
+  } else if (stream.finished) {
+    *end_of_stream = true;
+  }
+  return Status::OK();
+}
+
+void TaskManager::DelObjectRefStream(const TaskID &generator_id) {
+  std::vector<ObjectID> unread_ids;
+  {
+    absl::MutexLock lock(&object_ref_streams_mu_);
+    auto it = object_ref_streams_.find(generator_id);
+    if (it == object_ref_streams_.end()) {
+      return;
+    }
+    for (const auto &item : it->second.items) {
+      unread_ids.push_back(item.second);
+    }
+    object_ref_streams_.erase(it);
+  }
+  std::vector<ObjectID> deleted;
+  for (const auto &object_id : unread_ids) {
+    reference_counter_->RemoveLocalReference(object_id, &deleted);
+  }
+  in_memory_store_->Delete(deleted);
+}
+
+void TaskManager::FinishObjectRefStream(const TaskID &generator_id) {
+  absl::MutexLock lock(&object_ref_streams_mu_);
+  auto it = object_ref_streams_.find(generator_id);
+  if (it != object_ref_streams_.end()) {
+    it->second.finished = true;
+  }
 }
 
 void TaskManager::CompletePendingTask(const TaskID &task_id,
@@ -183,72 +462,22 @@ void TaskManager::CompletePendingTask(const TaskID &task_id,
   RAY_LOG(DEBUG) << "Completing task " << task_id;
 
   std::vector<ObjectID> direct_return_ids;
-  std::vector<ObjectID> plasma_return_ids;
   for (int i = 0; i < reply.return_objects_size(); i++) {
     const auto &return_object = reply.return_objects(i);
     ObjectID object_id = ObjectID::FromBinary(return_object.object_id());
-    reference_counter_->UpdateObjectSize(object_id, return_object.size());
-    RAY_LOG(DEBUG) << "Task return object " << object_id << " has size "
-                   << return_object.size();
-
-    const auto nested_refs =
-        VectorFromProtobuf<rpc::ObjectReference>(return_object.nested_inlined_refs());
-    if (return_object.in_plasma()) {
-      const auto pinned_at_raylet_id = NodeID::FromBinary(worker_addr.raylet_id());
-      if (check_node_alive_(pinned_at_raylet_id)) {
-        reference_counter_->UpdateObjectPinnedAtRaylet(object_id, pinned_at_raylet_id);
-        // Mark it as in plasma with a dummy object.
-        RAY_CHECK(in_memory_store_->Put(RayObject(rpc::ErrorType::OBJECT_IN_PLASMA),
-                                        object_id));
-      } else {
-        RAY_LOG(DEBUG) << "Task " << task_id << " returned object " << object_id
-                       << " in plasma on a dead node, attempting to recover.";
-        reconstruct_object_callback_(object_id);
-      }
-    } else {
-      // NOTE(swang): If a direct object was promoted to plasma, then we do not
-      // record the node ID that it was pinned at, which means that we will not
-      // be able to reconstruct it if the plasma object copy is lost. However,
-      // this is okay because the pinned copy is on the local node, so we will
-      // fate-share with the object if the local node fails.
-      std::shared_ptr<LocalMemoryBuffer> data_buffer;
-      if (return_object.data().size() > 0) {
-        data_buffer = std::make_shared<LocalMemoryBuffer>(
-            const_cast<uint8_t *>(
-                reinterpret_cast<const uint8_t *>(return_object.data().data())),
-            return_object.data().size());
-      }
-      std::shared_ptr<LocalMemoryBuffer> metadata_buffer;
-      if (return_object.metadata().size() > 0) {
-        metadata_buffer = std::make_shared<LocalMemoryBuffer>(
-            const_cast<uint8_t *>(
-                reinterpret_cast<const uint8_t *>(return_object.metadata().data())),
-            return_object.metadata().size());
-      }
-
-      bool stored_in_direct_memory = in_memory_store_->Put(
-          RayObject(data_buffer, metadata_buffer, nested_refs), object_id);
-      if (stored_in_direct_memory) {
-        direct_return_ids.push_back(object_id);
-      }
-    }
-
-    rpc::Address owner_address;
-    if (reference_counter_->GetOwner(object_id, &owner_address) && !nested_refs.empty()) {
-      std::vector<ObjectID> nested_ids;
-      for (const auto &nested_ref : nested_refs) {
-        nested_ids.emplace_back(ObjectRefToId(nested_ref));
-      }
-      reference_counter_->AddNestedObjectIds(object_id, nested_ids, owner_address);
+    if (HandleTaskReturn(task_id, object_id, return_object, worker_addr)) {
+      direct_return_ids.push_back(object_id);
     }
   }
 
   TaskSpecification spec;
   bool release_lineage = true;
+  std::vector<ObjectID> evicted_lineage_args;
   {
-    absl::MutexLock lock(&mu_);
-    auto it = submissible_tasks_.find(task_id);
-    RAY_CHECK(it != submissible_tasks_.end())
+    auto &shard = ShardOf(task_id);
+    absl::MutexLock lock(&shard.mu);
+    auto it = shard.tasks.find(task_id);
+    RAY_CHECK(it != shard.tasks.end())
         << "Tried to complete task that was not pending " << task_id;
     spec = it->second.spec;
 
@@ -274,12 +503,21 @@ void TaskManager::CompletePendingTask(const TaskID &task_id,
     if (task_retryable) {
       // Pin the task spec if it may be retried again.
       release_lineage = false;
+      PinLineage(task_id, it->second);
     } else {
-      submissible_tasks_.erase(it);
+      shard.tasks.erase(it);
+      num_submissible_tasks_--;
     }
   }
+  EvictLineageIfNeeded(&evicted_lineage_args);
+  if (spec.IsStreamingGenerator()) {
+    FinishObjectRefStream(task_id);
+  }
 
   RemoveFinishedTaskReferences(spec, release_lineage, worker_addr, reply.borrowed_refs());
+  if (!evicted_lineage_args.empty()) {
+    reference_counter_->ReleaseLineageReferences(evicted_lineage_args);
+  }
 
   ShutdownIfNeeded();
 }
@@ -296,16 +534,18 @@ bool TaskManager::PendingTaskFailed(
   TaskSpecification spec;
   bool release_lineage = true;
   {
-    absl::MutexLock lock(&mu_);
-    auto it = submissible_tasks_.find(task_id);
-    RAY_CHECK(it != submissible_tasks_.end())
+    auto &shard = ShardOf(task_id);
+    absl::MutexLock lock(&shard.mu);
+    auto it = shard.tasks.find(task_id);
+    RAY_CHECK(it != shard.tasks.end())
         << "Tried to complete task that was not pending " << task_id;
     RAY_CHECK(it->second.pending)
         << "Tried to complete task that was not pending " << task_id;
     spec = it->second.spec;
     num_retries_left = it->second.num_retries_left;
     if (num_retries_left == 0) {
-      submissible_tasks_.erase(it);
+      shard.tasks.erase(it);
+      num_submissible_tasks_--;
       num_pending_tasks_--;
     } else if (num_retries_left == -1) {
       release_lineage = false;
@@ -414,10 +654,11 @@ void TaskManager::RemoveFinishedTaskReferences(
 
 void TaskManager::RemoveLineageReference(const ObjectID &object_id,
                                          std::vector<ObjectID> *released_objects) {
-  absl::MutexLock lock(&mu_);
   const TaskID &task_id = object_id.TaskId();
-  auto it = submissible_tasks_.find(task_id);
-  if (it == submissible_tasks_.end()) {
+  auto &shard = ShardOf(task_id);
+  absl::MutexLock lock(&shard.mu);
+  auto it = shard.tasks.find(task_id);
+  if (it == shard.tasks.end()) {
     RAY_LOG(DEBUG) << "No lineage for object " << object_id;
     return;
   }
@@ -434,30 +675,24 @@ void TaskManager::RemoveLineageReference(const ObjectID &object_id,
   if (it->second.reconstructable_return_ids.empty() && !it->second.pending) {
     // If the task can no longer be retried, decrement the lineage ref count
     // for each of the task's args.
-    for (size_t i = 0; i < it->second.spec.NumArgs(); i++) {
-      if (it->second.spec.ArgByRef(i)) {
-        released_objects->push_back(it->second.spec.ArgId(i));
-      } else {
-        const auto &inlined_refs = it->second.spec.ArgInlinedRefs(i);
-        for (const auto &inlined_ref : inlined_refs) {
-          released_objects->push_back(ObjectID::FromBinary(inlined_ref.object_id()));
-        }
-      }
-    }
+    GetTaskArgIds(it->second.spec, released_objects);
 
     // The task has finished and none of the return IDs are in scope anymore,
     // so it is safe to remove the task spec.
-    submissible_tasks_.erase(it);
+    UnpinLineage(it->second);
+    shard.tasks.erase(it);
+    num_submissible_tasks_--;
   }
 }
 
 bool TaskManager::MarkTaskCanceled(const TaskID &task_id) {
-  absl::MutexLock lock(&mu_);
-  auto it = submissible_tasks_.find(task_id);
-  if (it != submissible_tasks_.end()) {
+  auto &shard = ShardOf(task_id);
+  absl::MutexLock lock(&shard.mu);
+  auto it = shard.tasks.find(task_id);
+  if (it != shard.tasks.end()) {
     it->second.num_retries_left = 0;
   }
-  return it != submissible_tasks_.end();
+  return it != shard.tasks.end();
 }
 
 void TaskManager::MarkPendingTaskFailed(
@@ -465,6 +700,9 @@ void TaskManager::MarkPendingTaskFailed(
     const std::shared_ptr<rpc::RayException> &creation_task_exception) {
   RAY_LOG(DEBUG) << "Treat task as failed. task_id: " << task_id
                  << ", error_type: " << ErrorType_Name(error_type);
+  if (spec.IsStreamingGenerator()) {
+    FinishObjectRefStream(task_id);
+  }
   int64_t num_returns = spec.NumReturns();
   for (int i = 0; i < num_returns; i++) {
     const auto object_id = ObjectID::FromIndex(task_id, /*index=*/i + 1);
@@ -500,9 +738,10 @@ void TaskManager::MarkPendingTaskFailed(
 }
 
 absl::optional<TaskSpecification> TaskManager::GetTaskSpec(const TaskID &task_id) const {
-  absl::MutexLock lock(&mu_);
-  auto it = submissible_tasks_.find(task_id);
-  if (it == submissible_tasks_.end()) {
+  const auto &shard = ShardOf(task_id);
+  absl::MutexLock lock(&shard.mu);
+  auto it = shard.tasks.find(task_id);
+  if (it == shard.tasks.end()) {
     return absl::optional<TaskSpecification>();
   }
   return it->second.spec;
@@ -511,10 +750,12 @@ absl::optional<TaskSpecification> TaskManager::GetTaskSpec(const TaskID &task_id
 std::vector<TaskID> TaskManager::GetPendingChildrenTasks(
     const TaskID &parent_task_id) const {
   std::vector<TaskID> ret_vec;
-  absl::MutexLock lock(&mu_);
-  for (auto it : submissible_tasks_) {
-    if ((it.second.pending) && (it.second.spec.ParentTaskId() == parent_task_id)) {
-      ret_vec.push_back(it.first);
+  for (const auto &shard : task_shards_) {
+    absl::MutexLock lock(&shard.mu);
+    for (const auto &it : shard.tasks) {
+      if ((it.second.pending) && (it.second.spec.ParentTaskId() == parent_task_id)) {
+        ret_vec.push_back(it.first);
+      }
     }
   }
   return ret_vec;
@@ -14,6 +14,10 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <deque>
+
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
@@ -68,12 +72,14 @@ class TaskManager : public TaskFinisherInterface, public TaskResubmissionInterfa
               std::shared_ptr<ReferenceCounter> reference_counter,
               RetryTaskCallback retry_task_callback,
               const std::function<bool(const NodeID &node_id)> &check_node_alive,
-              ReconstructObjectCallback reconstruct_object_callback)
+              ReconstructObjectCallback reconstruct_object_callback,
+              int64_t max_lineage_bytes = 0)
       : in_memory_store_(in_memory_store),
         reference_counter_(reference_counter),
         retry_task_callback_(retry_task_callback),
         check_node_alive_(check_node_alive),
-        reconstruct_object_callback_(reconstruct_object_callback) {
+        reconstruct_object_callback_(reconstruct_object_callback),
+        max_lineage_bytes_(max_lineage_bytes) {
     reference_counter_->SetReleaseLineageCallback(
         [this](const ObjectID &object_id, std::vector<ObjectID> *ids_to_release) {
           RemoveLineageReference(object_id, ids_to_release);
@@ -91,6 +97,17 @@ class TaskManager : public TaskFinisherInterface, public TaskResubmissionInterfa
   void AddPendingTask(const rpc::Address &caller_address, const TaskSpecification &spec,
                       const std::string &call_site, int max_retries = 0);
 
+  /// Add a batch of tasks that are pending execution, taking the task table lock once.
+  ///
+  /// \param[in] caller_address The rpc address of the calling task.
+  /// \param[in] specs The specs of the pending tasks.
+  /// \param[in] max_retries Number of times each task may be retried
+  /// on failure.
+  /// \return Void.
+  void AddPendingTasks(const rpc::Address &caller_address,
+                       const std::vector<TaskSpecification> &specs,
+                       const std::string &call_site, int max_retries = 0);
+
   /// Resubmit a task that has completed execution before. This is used to
   /// reconstruct objects stored in Plasma that were lost.
   ///
@@ -118,6 +135,32 @@ class TaskManager : public TaskFinisherInterface, public TaskResubmissionInterfa
   void CompletePendingTask(const TaskID &task_id, const rpc::PushTaskReply &reply,
                            const rpc::Address &worker_addr) override;
 
+  /// Write an object a pending streaming generator task yielded to the memory store,
+  /// and add it to the object ref stream of the task.
+  ///
+  /// \param[in] request The report from the worker executing the task.
+  /// \return Whether the object was added, false if the task is no longer pending or
+  /// the object was already reported by a previous attempt of the task.
+  bool HandleReportGeneratorItemReturns(
+      const rpc::ReportGeneratorItemReturnsRequest &request);
+
+  /// Read the next object a streaming generator task yielded. The reference the stream
+  /// held to the object is handed to the caller, which must remove it once it is done
+  /// with the object.
+  ///
+  /// \param[in] generator_id ID of the streaming generator task.
+  /// \param[out] object_id The next object, or nil if the task has not yielded it yet.
+  /// \param[out] end_of_stream Whether the task finished and all its objects were
+  /// read. A failed task ends the stream too, its error is stored in its return object.
+  /// \return NotFound if the task is not a streaming generator or its stream was
+  /// deleted.
+  Status TryReadObjectRefStream(const TaskID &generator_id, ObjectID *object_id,
+                                bool *end_of_stream);
+
+  /// Delete the object ref stream of a streaming generator task, releasing the
+  /// objects that were not read.
+  void DelObjectRefStream(const TaskID &generator_id);
+
   /// A pending task failed. This will either retry the task or mark the task
   /// as failed if there are no retries left.
   ///
@@ -186,7 +229,22 @@ class TaskManager : public TaskFinisherInterface, public TaskResubmissionInterfa
   /// Return the number of pending tasks.
   size_t NumPendingTasks() const;
 
+  /// Return the total size of the specs of finished tasks that are pinned
+  /// only so that their return objects can be reconstructed.
+  int64_t LineageFootprintBytes() const;
+
+  /// Return the number of finished tasks whose lineage was evicted early
+  /// because the lineage footprint exceeded max_lineage_bytes.
+  int64_t NumLineageEvicted() const;
+
  private:
+  /// Add the references of a pending task to its dependencies and return objects.
+  ///
+  /// \return The number of return objects owned by the task.
+  size_t AddPendingTaskReferences(const rpc::Address &caller_address,
+                                  const TaskSpecification &spec,
+                                  const std::string &call_site);
+
   struct TaskEntry {
     TaskEntry(const TaskSpecification &spec_arg, int num_retries_left_arg,
               size_t num_returns)
@@ -226,8 +284,68 @@ class TaskManager : public TaskFinisherInterface, public TaskResubmissionInterfa
     //    pending tasks and tasks that finished execution but that may be
     //    retried in the future.
     absl::flat_hash_set<ObjectID> reconstructable_return_ids;
+    // The size of the spec counted towards the lineage footprint. This is
+    // non-zero only while the task is finished and pinned for lineage.
+    int64_t lineage_footprint_bytes = 0;
+  };
+
+  /// A part of the task table. Tasks are spread over the shards by TaskID, so that
+  /// threads that submit and complete different tasks rarely contend for a lock.
+  struct TaskShard {
+    /// Protects tasks. A shard lock may be held while taking mu_, but not the
+    /// other way around, and at most one shard lock is held at a time.
+    mutable absl::Mutex mu;
+    /// The submissible tasks of this shard.
+    absl::flat_hash_map<TaskID, TaskEntry> tasks GUARDED_BY(mu);
+  };
+
+  static constexpr size_t kNumTaskShards = 16;
+
+  /// The objects a streaming generator task yielded that were not read yet.
+  struct ObjectRefStream {
+    /// The unread objects, by the index the task yielded them at.
+    absl::flat_hash_map<int64_t, ObjectID> items;
+    /// The index of the next object to read.
+    int64_t next_index = 0;
+    /// Whether the task finished, so no objects will be added.
+    bool finished = false;
   };
 
+  TaskShard &ShardOf(const TaskID &task_id);
+  const TaskShard &ShardOf(const TaskID &task_id) const;
+
+  /// Count a finished task that is pinned for lineage towards the lineage
+  /// footprint. The lock of the task's shard must be held.
+  void PinLineage(const TaskID &task_id, TaskEntry &entry) LOCKS_EXCLUDED(mu_);
+
+  /// Stop counting a task towards the lineage footprint, e.g. because it is
+  /// being resubmitted or erased. The lock of the task's shard must be held.
+  void UnpinLineage(TaskEntry &entry);
+
+  /// Erase the lineage of the oldest finished tasks until the lineage
+  /// footprint is within max_lineage_bytes_. Their return objects can no
+  /// longer be reconstructed. No shard lock may be held.
+  ///
+  /// \param[out] args_to_release The arguments of the evicted tasks, whose
+  /// lineage refs should be released.
+  void EvictLineageIfNeeded(std::vector<ObjectID> *args_to_release) LOCKS_EXCLUDED(mu_);
+
+  /// Store a return object of a task in the memory store, or record its plasma
+  /// location.
+  ///
+  /// \return Whether the object was stored in the memory store.
+  bool HandleTaskReturn(const TaskID &task_id, const ObjectID &object_id,
+                        const rpc::ReturnObject &return_object,
+                        const rpc::Address &worker_addr);
+
+  /// Mark that a streaming generator task will not yield any more objects.
+  void FinishObjectRefStream(const TaskID &generator_id)
+      LOCKS_EXCLUDED(object_ref_streams_mu_);
+
+  /// Append the IDs of the plasma and inlined objects that this task depends
+  /// on.
+  static void GetTaskArgIds(const TaskSpecification &spec, std::vector<ObjectID> *ids);
+
   /// Remove a lineage reference to this object ID. This should be called
   /// whenever a task that depended on this object ID can no longer be retried.
   void RemoveLineageReference(const ObjectID &object_id,
@@ -272,19 +390,46 @@ class TaskManager : public TaskFinisherInterface, public TaskResubmissionInterfa
   // The last time we logged a task failure.
   int64_t last_log_time_ms_ GUARDED_BY(mu_) = 0;
 
-  /// Protects below fields.
+  /// Protects the failure log throttling state above, the lineage eviction
+  /// queue and the shutdown hook.
   mutable absl::Mutex mu_;
 
-  /// This map contains one entry per task that may be submitted for
-  /// execution. This includes both tasks that are currently pending execution
-  /// and tasks that finished execution but that may be retried again in the
-  /// future.
-  absl::flat_hash_map<TaskID, TaskEntry> submissible_tasks_ GUARDED_BY(mu_);
+  /// The task table, which contains one entry per task that may be submitted
+  /// for execution. This includes both tasks that are currently pending
+  /// execution and tasks that finished execution but that may be retried again
+  /// in the future.
+  std::array<TaskShard, kNumTaskShards> task_shards_;
+
+  /// Number of tasks in the task table.
+  std::atomic<size_t> num_submissible_tasks_{0};
 
   /// Number of tasks that are pending. This is a count of all tasks in
-  /// submissible_tasks_ that have been submitted and are currently pending
+  /// the task table that have been submitted and are currently pending
   /// execution.
-  size_t num_pending_tasks_ = 0;
+  std::atomic<size_t> num_pending_tasks_{0};
+
+  /// Max total size of lineage to keep for finished tasks. 0 means no limit.
+  const int64_t max_lineage_bytes_;
+
+  /// Total size of the specs of finished tasks that are pinned for lineage.
+  std::atomic<int64_t> total_lineage_footprint_bytes_{0};
+
+  /// Finished tasks pinned for lineage, oldest first. Entries that have since
+  /// been erased or resubmitted are skipped lazily. Only maintained when
+  /// max_lineage_bytes_ is set.
+  std::deque<TaskID> lineage_eviction_queue_ GUARDED_BY(mu_);
+
+  /// Number of tasks whose lineage was evicted to stay under the limit.
+  std::atomic<int64_t> num_lineage_evicted_{0};
+
+  /// Protects object_ref_streams_. No other lock may be taken while holding it,
+  /// except the lock of the reference counter.
+  mutable absl::Mutex object_ref_streams_mu_;
+
+  /// The object ref streams of streaming generator tasks, until the caller deletes
+  /// them.
+  absl::flat_hash_map<TaskID, ObjectRefStream> object_ref_streams_
+      GUARDED_BY(object_ref_streams_mu_);
 
   /// Optional shutdown hook to call when pending tasks all finish.
   std::function<void()> shutdown_hook_ GUARDED_BY(mu_) = nullptr;
@@ -44,6 +44,17 @@ class MockActorInfoAccessor : public gcs::ServiceBasedActorInfoAccessor {
     return Status::OK();
   }
 
+  Status AsyncSubscribeBatch(
+      const std::vector<ActorID> &actor_ids,
+      const gcs::SubscribeCallback<ActorID, rpc::ActorTableData> &subscribe,
+      const gcs::StatusCallback &done) {
+    num_batches_++;
+    for (const auto &actor_id : actor_ids) {
+      callback_map_.emplace(actor_id, subscribe);
+    }
+    return Status::OK();
+  }
+
   bool ActorStateNotificationPublished(const ActorID &actor_id,
                                        const rpc::ActorTableData &actor_data) {
     auto it = callback_map_.find(actor_id);
@@ -59,6 +70,8 @@ class MockActorInfoAccessor : public gcs::ServiceBasedActorInfoAccessor {
 
   absl::flat_hash_map<ActorID, gcs::SubscribeCallback<ActorID, rpc::ActorTableData>>
       callback_map_;
+
+  int num_batches_ = 0;
 };
 
 class MockGcsClient : public gcs::ServiceBasedGcsClient {
@@ -288,6 +301,32 @@ TEST_F(ActorManagerTest, TestActorStateNotificationAlive) {
       actor_info_accessor_->ActorStateNotificationPublished(actor_id, actor_table_data));
 }
 
+TEST_F(ActorManagerTest, TestBatchActorSubscriptions) {
+  instrumented_io_context io_service;
+  actor_manager_ = std::make_shared<ActorManager>(
+      gcs_client_mock_, direct_actor_submitter_, reference_counter_, &io_service);
+  std::vector<ActorID> actor_ids;
+  for (int i = 0; i < 3; i++) {
+    actor_ids.push_back(AddActorHandle());
+  }
+  // The subscriptions wait for the event loop to run.
+  for (const auto &actor_id : actor_ids) {
+    ASSERT_FALSE(actor_info_accessor_->CheckSubscriptionRequested(actor_id));
+  }
+  io_service.poll();
+  ASSERT_EQ(actor_info_accessor_->num_batches_, 1);
+  for (const auto &actor_id : actor_ids) {
+    ASSERT_TRUE(actor_info_accessor_->CheckSubscriptionRequested(actor_id));
+  }
+
+  EXPECT_CALL(*direct_actor_submitter_, ConnectActor(_, _, _)).Times(1);
+  rpc::ActorTableData actor_table_data;
+  actor_table_data.set_actor_id(actor_ids[0].Binary());
+  actor_table_data.set_state(rpc::ActorTableData::ALIVE);
+  ASSERT_TRUE(actor_info_accessor_->ActorStateNotificationPublished(actor_ids[0],
+                                                                    actor_table_data));
+}
+
 }  // namespace core
 }  // namespace ray
 
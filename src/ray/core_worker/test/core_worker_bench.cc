@@ -0,0 +1,286 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A benchmark of task submission and execution through the core worker, without any
+// language frontend. It starts Redis, a GCS server and a raylet whose workers are
+// mock_worker processes, and a C++ driver submits tasks through CoreWorker. For each
+// number of CPUs of the raylet, it runs each scenario and reports the throughput and
+// the latency percentiles from submission to the return value being available:
+//
+//   noop:   normal tasks with an empty inlined return value.
+//   inline: normal tasks that return --inline_return_size bytes inlined in the reply.
+//   plasma: normal tasks that return --plasma_return_size bytes through plasma.
+//   actor:  calls with an empty return value to one actor per CPU.
+//
+// At most --max_tasks_in_flight tasks are pending at a time, like a driver that
+// waits for its results in batches.
+//
+// Example:
+//   bazel run //:core_worker_bench -- --num_cpus=1,4,16 --num_tasks=20000
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_split.h"
+#include "absl/time/clock.h"
+#include "gflags/gflags.h"
+#include "hiredis/hiredis.h"
+#include "ray/common/buffer.h"
+#include "ray/common/ray_object.h"
+#include "ray/common/test_util.h"
+#include "ray/core_worker/core_worker.h"
+#include "ray/util/logging.h"
+
+DEFINE_string(raylet, "", "The path of the raylet binary.");
+DEFINE_string(mock_worker, "", "The path of the mock_worker binary.");
+DEFINE_string(gcs_server, "", "The path of the gcs_server binary.");
+DEFINE_string(redis_cli, "", "The path of the redis-cli binary.");
+DEFINE_string(redis_server, "", "The path of the redis-server binary.");
+DEFINE_int32(node_manager_port, 2100, "The port of the raylet.");
+DEFINE_string(num_cpus, "1,2,4,8", "The numbers of CPUs of the raylet, one run each.");
+DEFINE_string(scenarios, "noop,inline,plasma,actor", "The scenarios to run.");
+DEFINE_int32(num_tasks, 10000, "The number of tasks of each scenario.");
+DEFINE_int32(max_tasks_in_flight, 1000, "The maximum number of pending tasks.");
+DEFINE_int64(inline_return_size, 1024, "The size of the inlined return values.");
+DEFINE_int64(plasma_return_size, 1024 * 1024, "The size of the plasma return values.");
+
+namespace ray {
+namespace core {
+
+namespace {
+
+/// The result of one scenario.
+struct ScenarioResult {
+  absl::Duration elapsed;
+  std::vector<int64_t> latencies_us;
+};
+
+int64_t Percentile(const std::vector<int64_t> &sorted, double percentile) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  return sorted[std::min(sorted.size() - 1,
+                         static_cast<size_t>(sorted.size() * percentile / 100))];
+}
+
+void FlushRedis() {
+  redisContext *context = redisConnect("127.0.0.1", 6379);
+  freeReplyObject(redisCommand(context, "FLUSHALL"));
+  freeReplyObject(redisCommand(context, "SET NumRedisShards 1"));
+  freeReplyObject(redisCommand(context, "LPUSH RedisShards 127.0.0.1:6380"));
+  redisFree(context);
+}
+
+std::unique_ptr<TaskArg> Int64Arg(int64_t value) {
+  auto buffer = std::make_shared<LocalMemoryBuffer>(sizeof(value));
+  std::memcpy(buffer->Data(), &value, sizeof(value));
+  return std::unique_ptr<TaskArg>(new TaskArgByValue(
+      std::make_shared<RayObject>(buffer, nullptr, std::vector<rpc::ObjectReference>())));
+}
+
+/// Submit `num_tasks` tasks with `submit`, keeping at most max_tasks_in_flight of them
+/// pending, and time each until its return value is available.
+ScenarioResult RunTasks(int num_tasks, const std::function<ObjectID(int)> &submit) {
+  auto &driver = CoreWorkerProcess::GetCoreWorker();
+  std::mutex mutex;
+  std::condition_variable cv;
+  int num_pending = 0;
+  ScenarioResult result;
+  result.latencies_us.reserve(num_tasks);
+  const auto start = absl::Now();
+  for (int i = 0; i < num_tasks; i++) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&] { return num_pending < FLAGS_max_tasks_in_flight; });
+      num_pending++;
+    }
+    const auto submit_time = absl::GetCurrentTimeNanos();
+    const auto return_id = submit(i);
+    driver.GetAsync(
+        return_id,
+        [&, submit_time](std::shared_ptr<RayObject>, ObjectID, void *) {
+          std::lock_guard<std::mutex> lock(mutex);
+          result.latencies_us.push_back((absl::GetCurrentTimeNanos() - submit_time) /
+                                        1000);
+          num_pending--;
+          cv.notify_one();
+        },
+        nullptr);
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [&] { return num_pending == 0; });
+  result.elapsed = absl::Now() - start;
+  std::sort(result.latencies_us.begin(), result.latencies_us.end());
+  return result;
+}
+
+ObjectID SubmitNormalTask(const std::string &function_name,
+                          std::vector<std::unique_ptr<TaskArg>> args) {
+  std::unordered_map<std::string, double> resources{{"CPU", 1}};
+  TaskOptions options("", 1, resources);
+  RayFunction function(Language::PYTHON, FunctionDescriptorBuilder::BuildPython(
+                                             function_name, "", "", ""));
+  std::vector<ObjectID> return_ids;
+  CoreWorkerProcess::GetCoreWorker().SubmitTask(
+      function, args, options, &return_ids, /*max_retries=*/0,
+      std::make_pair(PlacementGroupID::Nil(), -1), true, /*debugger_breakpoint=*/"");
+  return return_ids[0];
+}
+
+ObjectID SubmitActorTask(const ActorID &actor_id) {
+  std::unordered_map<std::string, double> resources;
+  TaskOptions options("", 1, resources);
+  RayFunction function(Language::PYTHON, FunctionDescriptorBuilder::BuildPython(
+                                             "MergeInputArgsAsOutput", "", "", ""));
+  std::vector<ObjectID> return_ids;
+  CoreWorkerProcess::GetCoreWorker().SubmitActorTask(actor_id, function, {}, options,
+                                                     &return_ids);
+  return return_ids[0];
+}
+
+/// Create an actor that takes a CPU, and wait until it has run its first call.
+ActorID CreateActor() {
+  auto &driver = CoreWorkerProcess::GetCoreWorker();
+  std::unordered_map<std::string, double> resources{{"CPU", 1}};
+  RayFunction function(Language::PYTHON, FunctionDescriptorBuilder::BuildPython(
+                                             "actor creation task", "", "", ""));
+  ActorCreationOptions options{/*max_restarts=*/0,
+                               /*max_task_retries=*/0,
+                               /*max_concurrency=*/1,
+                               resources,
+                               resources,
+                               {},
+                               /*is_detached=*/false,
+                               /*name=*/"",
+                               /*ray_namespace=*/"",
+                               /*is_asyncio=*/false};
+  ActorID actor_id;
+  RAY_CHECK_OK(driver.CreateActor(function, {}, options, /*extension_data=*/"",
+                                  &actor_id));
+  std::vector<std::shared_ptr<RayObject>> results;
+  RAY_CHECK_OK(driver.Get({SubmitActorTask(actor_id)}, -1, &results));
+  return actor_id;
+}
+
+ScenarioResult RunScenario(const std::string &scenario,
+                           const std::vector<ActorID> &actors) {
+  if (scenario == "noop") {
+    return RunTasks(FLAGS_num_tasks, [](int) {
+      return SubmitNormalTask("MergeInputArgsAsOutput", {});
+    });
+  } else if (scenario == "inline" || scenario == "plasma") {
+    const int64_t size =
+        scenario == "inline" ? FLAGS_inline_return_size : FLAGS_plasma_return_size;
+    return RunTasks(FLAGS_num_tasks, [size](int) {
+      std::vector<std::unique_ptr<TaskArg>> args;
+      args.push_back(Int64Arg(size));
+      return SubmitNormalTask("ReturnBytes", std::move(args));
+    });
+  }
+  RAY_CHECK(scenario == "actor") << "Unknown scenario " << scenario;
+  return RunTasks(FLAGS_num_tasks, [&actors](int i) {
+    return SubmitActorTask(actors[i % actors.size()]);
+  });
+}
+
+/// Start a raylet with the given number of CPUs, and run the scenarios against it
+/// from a new driver.
+void RunAll(int num_cpus, const std::vector<std::string> &scenarios) {
+  std::string store_socket;
+  const auto raylet_socket = TestSetupUtil::StartRaylet(
+      "127.0.0.1", FLAGS_node_manager_port, "127.0.0.1",
+      "\"CPU," + std::to_string(num_cpus) + "\"", &store_socket);
+  static uint32_t job_counter = 1;
+  CoreWorkerOptions options;
+  options.worker_type = WorkerType::DRIVER;
+  options.language = Language::PYTHON;
+  options.store_socket = store_socket;
+  options.raylet_socket = raylet_socket;
+  options.job_id = JobID::FromInt(job_counter++);
+  options.gcs_options = gcs::GcsClientOptions("127.0.0.1", 6379, "");
+  options.enable_logging = true;
+  options.install_failure_signal_handler = true;
+  options.node_ip_address = "127.0.0.1";
+  options.node_manager_port = FLAGS_node_manager_port;
+  options.raylet_ip_address = "127.0.0.1";
+  options.driver_name = "core_worker_bench";
+  options.num_workers = 1;
+  CoreWorkerProcess::Initialize(options);
+
+  std::vector<ActorID> actors;
+  for (const auto &scenario : scenarios) {
+    if (scenario == "actor" && actors.empty()) {
+      for (int i = 0; i < num_cpus; i++) {
+        actors.push_back(CreateActor());
+      }
+    }
+    // Warm up the worker pool, so that worker startup isn't measured.
+    RunScenario(scenario, actors);
+    const auto result = RunScenario(scenario, actors);
+    const double seconds = absl::ToDoubleSeconds(result.elapsed);
+    std::cout << "CPUs: " << num_cpus << ", scenario: " << scenario
+              << ", throughput: " << static_cast<int64_t>(FLAGS_num_tasks / seconds)
+              << " tasks/s, latency (us): p50 = " << Percentile(result.latencies_us, 50)
+              << ", p90 = " << Percentile(result.latencies_us, 90)
+              << ", p99 = " << Percentile(result.latencies_us, 99)
+              << ", max = " << Percentile(result.latencies_us, 100) << std::endl;
+  }
+
+  CoreWorkerProcess::Shutdown();
+  TestSetupUtil::StopRaylet(raylet_socket);
+}
+
+}  // namespace
+
+}  // namespace core
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  RAY_CHECK(!FLAGS_raylet.empty() && !FLAGS_mock_worker.empty() &&
+            !FLAGS_gcs_server.empty() && !FLAGS_redis_cli.empty() &&
+            !FLAGS_redis_server.empty())
+      << "The paths of the raylet, mock_worker, gcs_server, redis-cli and "
+         "redis-server binaries are required.";
+  RAY_CHECK(FLAGS_inline_return_size > 0 && FLAGS_plasma_return_size > 0);
+  ray::TEST_RAYLET_EXEC_PATH = FLAGS_raylet;
+  ray::TEST_MOCK_WORKER_EXEC_PATH = FLAGS_mock_worker;
+  ray::TEST_GCS_SERVER_EXEC_PATH = FLAGS_gcs_server;
+  ray::TEST_REDIS_CLIENT_EXEC_PATH = FLAGS_redis_cli;
+  ray::TEST_REDIS_SERVER_EXEC_PATH = FLAGS_redis_server;
+
+  // The mock workers connect to the GCS through Redis at port 6379.
+  ray::TestSetupUtil::StartUpRedisServers(std::vector<int>{6379, 6380});
+  ray::core::FlushRedis();
+  const auto gcs_server_socket = ray::TestSetupUtil::StartGcsServer("127.0.0.1");
+
+  std::vector<std::string> scenarios = absl::StrSplit(FLAGS_scenarios, ',');
+  // The actors hold all the CPUs until the driver exits, so they go last.
+  std::stable_partition(scenarios.begin(), scenarios.end(),
+                        [](const std::string &scenario) { return scenario != "actor"; });
+  for (const auto &num_cpus : absl::StrSplit(FLAGS_num_cpus, ',')) {
+    ray::core::RunAll(std::stoi(std::string(num_cpus)), scenarios);
+  }
+
+  ray::TestSetupUtil::StopGcsServer(gcs_server_socket);
+  ray::TestSetupUtil::ShutDownRedisServers();
+  gflags::ShutDownCommandLineFlags();
+  return 0;
+}
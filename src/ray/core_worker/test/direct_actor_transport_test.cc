@@ -67,6 +67,11 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
     callbacks.push_back(callback);
   }
 
+  void PushActorTasks(std::vector<rpc::PushTaskRequestAndCallback> requests) override {
+    batch_sizes.push_back(requests.size());
+    rpc::CoreWorkerClientInterface::PushActorTasks(std::move(requests));
+  }
+
   int64_t ClientProcessedUpToSeqno() override { return acked_seqno; }
 
   bool ReplyPushTask(Status status = Status::OK(), size_t index = 0) {
@@ -82,6 +87,7 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
   rpc::Address addr;
   std::vector<rpc::ClientCallback<rpc::PushTaskReply>> callbacks;
   std::vector<uint64_t> received_seq_nos;
+  std::vector<size_t> batch_sizes;
   int64_t acked_seqno = 0;
 };
 
@@ -166,6 +172,36 @@ TEST_F(DirectActorSubmitterTest, TestSubmitTask) {
   ASSERT_THAT(worker_client_->received_seq_nos, ElementsAre(0, 1));
 }
 
+TEST_F(DirectActorSubmitterTest, TestPendingTasksSentTogether) {
+  rpc::Address addr;
+  auto worker_id = WorkerID::FromRandom();
+  addr.set_worker_id(worker_id.Binary());
+  ActorID actor_id = ActorID::Of(JobID::FromInt(0), TaskID::Nil(), 0);
+  submitter_.AddActorQueueIfNotExists(actor_id);
+
+  for (int i = 0; i < 3; i++) {
+    auto task = CreateActorTaskHelper(actor_id, worker_id, i);
+    ASSERT_TRUE(submitter_.SubmitTask(task).ok());
+  }
+  ASSERT_EQ(worker_client_->callbacks.size(), 0);
+
+  // Tasks queued while the actor was not connected are handed to the client at once,
+  // so that it can batch them.
+  submitter_.ConnectActor(actor_id, addr, 0);
+  ASSERT_THAT(worker_client_->batch_sizes, ElementsAre(3));
+  ASSERT_EQ(worker_client_->callbacks.size(), 3);
+
+  auto task = CreateActorTaskHelper(actor_id, worker_id, 3);
+  ASSERT_TRUE(submitter_.SubmitTask(task).ok());
+  ASSERT_THAT(worker_client_->batch_sizes, ElementsAre(3, 1));
+
+  EXPECT_CALL(*task_finisher_, CompletePendingTask(TaskID::Nil(), _, _)).Times(4);
+  while (!worker_client_->callbacks.empty()) {
+    ASSERT_TRUE(worker_client_->ReplyPushTask());
+  }
+  ASSERT_THAT(worker_client_->received_seq_nos, ElementsAre(0, 1, 2, 3));
+}
+
 TEST_F(DirectActorSubmitterTest, TestQueueingWarning) {
   rpc::Address addr;
   auto worker_id = WorkerID::FromRandom();
@@ -297,6 +333,25 @@ TEST_F(DirectActorSubmitterTest, TestActorDead) {
   submitter_.DisconnectActor(actor_id, 1, /*dead=*/true);
 }
 
+TEST_F(DirectActorSubmitterTest, TestGetActorRpcClient) {
+  rpc::Address addr;
+  auto worker_id = WorkerID::FromRandom();
+  addr.set_worker_id(worker_id.Binary());
+  ActorID actor_id = ActorID::Of(JobID::FromInt(0), TaskID::Nil(), 0);
+  std::string intended_worker_id;
+  ASSERT_EQ(submitter_.GetActorRpcClient(actor_id, &intended_worker_id), nullptr);
+
+  submitter_.AddActorQueueIfNotExists(actor_id);
+  ASSERT_EQ(submitter_.GetActorRpcClient(actor_id, &intended_worker_id), nullptr);
+
+  submitter_.ConnectActor(actor_id, addr, 0);
+  ASSERT_EQ(submitter_.GetActorRpcClient(actor_id, &intended_worker_id), worker_client_);
+  ASSERT_EQ(intended_worker_id, worker_id.Binary());
+
+  submitter_.DisconnectActor(actor_id, 0, /*dead=*/false);
+  ASSERT_EQ(submitter_.GetActorRpcClient(actor_id, &intended_worker_id), nullptr);
+}
+
 TEST_F(DirectActorSubmitterTest, TestActorRestartNoRetry) {
   rpc::Address addr;
   auto worker_id = WorkerID::FromRandom();
@@ -209,5 +209,47 @@ TEST(LocalityAwareLeasePolicyTest, TestBestLocalityFallbackAddrFetchFail) {
   ASSERT_EQ(NodeID::FromBinary(best_node_address.raylet_id()), fallback_node);
 }
 
+TEST(LocalityAwareLeasePolicyTest, TestLoadPenaltyAvoidsOverloadedNode) {
+  absl::flat_hash_map<ObjectID, LocalityData> locality_data;
+  NodeID fallback_node = NodeID::FromRandom();
+  rpc::Address fallback_rpc_address = MockNodeAddrFactory(fallback_node).value();
+  NodeID busy_node = NodeID::FromRandom();
+  NodeID idle_node = NodeID::FromRandom();
+  ObjectID obj1 = ObjectID::FromRandom();
+  ObjectID obj2 = ObjectID::FromRandom();
+  // The busy node holds more bytes, but is overloaded.
+  locality_data.emplace(obj1, LocalityData{100, {busy_node, idle_node}});
+  locality_data.emplace(obj2, LocalityData{10, {busy_node}});
+  auto mock_locality_data_provider =
+      std::make_shared<MockLocalityDataProvider>(locality_data);
+  auto node_load_provider = [busy_node](const NodeID &node_id) {
+    return absl::optional<double>(node_id == busy_node ? 2.0 : 0.0);
+  };
+  std::vector<ObjectID> deps{obj1, obj2};
+  auto task_spec = CreateFakeTask(deps);
+
+  // A small penalty doesn't outweigh the extra local bytes.
+  LocalityAwareLeasePolicy small_penalty_policy(
+      mock_locality_data_provider, MockNodeAddrFactory, fallback_rpc_address,
+      node_load_provider, /*max_locality_bytes=*/0, /*load_penalty_bytes=*/4);
+  rpc::Address best_node_address = small_penalty_policy.GetBestNodeForTask(task_spec);
+  ASSERT_EQ(NodeID::FromBinary(best_node_address.raylet_id()), busy_node);
+
+  // A large penalty does.
+  LocalityAwareLeasePolicy large_penalty_policy(
+      mock_locality_data_provider, MockNodeAddrFactory, fallback_rpc_address,
+      node_load_provider, /*max_locality_bytes=*/0, /*load_penalty_bytes=*/50);
+  best_node_address = large_penalty_policy.GetBestNodeForTask(task_spec);
+  ASSERT_EQ(NodeID::FromBinary(best_node_address.raylet_id()), idle_node);
+
+  // With a cap on the local bytes, even a small penalty decides between nodes that
+  // both hold more than the cap.
+  LocalityAwareLeasePolicy capped_policy(
+      mock_locality_data_provider, MockNodeAddrFactory, fallback_rpc_address,
+      node_load_provider, /*max_locality_bytes=*/64, /*load_penalty_bytes=*/1);
+  best_node_address = capped_policy.GetBestNodeForTask(task_spec);
+  ASSERT_EQ(NodeID::FromBinary(best_node_address.raylet_id()), idle_node);
+}
+
 }  // namespace core
 }  // namespace ray
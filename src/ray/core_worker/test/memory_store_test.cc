@@ -16,7 +16,10 @@
 
 #include "ray/core_worker/store_provider/memory_store/memory_store.h"
 
+#include <thread>
+
 #include "gtest/gtest.h"
+#include "ray/common/ray_config.h"
 #include "ray/common/test_util.h"
 
 namespace ray {
@@ -74,9 +77,9 @@ TEST(TestMemoryStore, TestMemoryStoreStats) {
   // Iterate through the memory store and compare the values that are obtained by
   // GetMemoryStoreStatisticalData.
   auto fill_expected_memory_stats = [&](MemoryStoreStats &expected_item) {
-    {
-      absl::MutexLock lock(&provider->mu_);
-      for (const auto &it : provider->objects_) {
+    for (const auto &shard : provider->shards_) {
+      absl::MutexLock lock(&shard->mu);
+      for (const auto &it : shard->objects) {
         if (it.second->IsInPlasmaError()) {
           expected_item.num_in_plasma += 1;
         } else {
@@ -127,6 +130,57 @@ TEST(TestMemoryStore, TestMemoryStoreStats) {
   ASSERT_EQ(item.used_object_store_memory, expected_item3.used_object_store_memory);
 }
 
+TEST(TestMemoryStore, TestShardedGetAndWait) {
+  RayConfig::instance().initialize(R"({"memory_store_num_shards": 4})");
+  WorkerContext context(WorkerType::WORKER, WorkerID::FromRandom(), JobID::FromInt(0));
+  std::shared_ptr<CoreWorkerMemoryStore> provider =
+      std::make_shared<CoreWorkerMemoryStore>(nullptr, nullptr, nullptr, nullptr,
+                                              nullptr);
+
+  std::vector<ObjectID> ids;
+  for (int i = 0; i < 16; i++) {
+    ids.push_back(ObjectID::FromRandom());
+  }
+  // Half of the objects are available before the get.
+  RayObject obj(rpc::ErrorType::TASK_EXECUTION_EXCEPTION);
+  for (int i = 0; i < 8; i++) {
+    ASSERT_TRUE(provider->Put(obj, ids[i]));
+  }
+  ASSERT_EQ(provider->Size(), 8);
+
+  int num_async_gets = 0;
+  provider->GetAsync(ids[15], [&](std::shared_ptr<RayObject> obj) { num_async_gets++; });
+
+  // The rest are put while the get is blocked on them.
+  std::thread putter([&]() {
+    for (int i = 8; i < 16; i++) {
+      ASSERT_TRUE(provider->Put(obj, ids[i]));
+    }
+  });
+  std::vector<std::shared_ptr<RayObject>> results;
+  ASSERT_TRUE(provider
+                  ->Get(ids, ids.size(), /*timeout_ms=*/-1, context,
+                        /*remove_after_get=*/false, &results)
+                  .ok());
+  putter.join();
+  for (const auto &result : results) {
+    ASSERT_TRUE(result != nullptr);
+  }
+  ASSERT_EQ(num_async_gets, 1);
+  ASSERT_EQ(provider->Size(), 16);
+
+  absl::flat_hash_set<ObjectID> ready;
+  ASSERT_TRUE(provider
+                  ->Wait(absl::flat_hash_set<ObjectID>(ids.begin(), ids.end()),
+                         ids.size(), /*timeout_ms=*/0, context, &ready)
+                  .ok());
+  ASSERT_EQ(ready.size(), ids.size());
+
+  provider->Delete(ids);
+  ASSERT_EQ(provider->Size(), 0);
+  RayConfig::instance().initialize(R"({"memory_store_num_shards": 1})");
+}
+
 }  // namespace core
 }  // namespace ray
 
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #define BOOST_BIND_NO_PLACEHOLDERS
+#include <cstring>
+
 #include "ray/common/test_util.h"
 #include "ray/core_worker/context.h"
 #include "ray/core_worker/core_worker.h"
@@ -79,6 +81,8 @@ class MockWorker {
       return MergeInputArgsAsOutput(args, return_ids, results);
     } else if ("WhileTrueLoop" == typed_descriptor->ModuleName()) {
       return WhileTrueLoop(args, return_ids, results);
+    } else if ("ReturnBytes" == typed_descriptor->ModuleName()) {
+      return ReturnBytes(args, return_ids, results);
     } else {
       return Status::TypeError("Unknown function descriptor: " +
                                typed_descriptor->ModuleName());
@@ -128,6 +132,29 @@ class MockWorker {
     return Status::OK();
   }
 
+  /// Return objects of the size given by the argument, allocated the way a language
+  /// worker allocates them, i.e., in plasma if they are too large to inline.
+  Status ReturnBytes(const std::vector<std::shared_ptr<RayObject>> &args,
+                     const std::vector<ObjectID> &return_ids,
+                     std::vector<std::shared_ptr<RayObject>> *results) {
+    RAY_CHECK(args.size() == 1 && args[0]->GetData()->Size() == sizeof(int64_t));
+    int64_t size;
+    std::memcpy(&size, args[0]->GetData()->Data(), sizeof(size));
+    auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+    int64_t task_output_inlined_bytes = 0;
+    for (const auto &return_id : return_ids) {
+      std::shared_ptr<RayObject> result;
+      RAY_RETURN_NOT_OK(core_worker.AllocateReturnObject(
+          return_id, size, nullptr, {}, task_output_inlined_bytes, &result));
+      if (result != nullptr && result->GetData() != nullptr) {
+        std::memset(result->GetData()->Data(), 1, size);
+      }
+      RAY_RETURN_NOT_OK(core_worker.SealReturnObject(return_id, result));
+      results->push_back(result);
+    }
+    return Status::OK();
+  }
+
   Status WhileTrueLoop(const std::vector<std::shared_ptr<RayObject>> &args,
                        const std::vector<ObjectID> &return_ids,
                        std::vector<std::shared_ptr<RayObject>> *results) {
@@ -66,6 +66,17 @@ class MockRayletClient : public PinObjectsInterface {
     callbacks.push_back(callback);
   }
 
+  void ReplicateObjectIDs(
+      const rpc::Address &caller_address, const std::vector<ObjectID> &object_ids,
+      const rpc::ClientCallback<rpc::PinObjectIDsReply> &callback) override {
+    num_objects_replicated += object_ids.size();
+    callback(Status::OK(), rpc::PinObjectIDsReply());
+  }
+
+  void MigrateObjectIDs(
+      const rpc::Address &owner_address, const std::vector<ObjectID> &object_ids,
+      const rpc::ClientCallback<rpc::PinObjectIDsReply> &callback) override {}
+
   size_t Flush() {
     size_t flushed = callbacks.size();
     for (const auto &callback : callbacks) {
@@ -76,6 +87,7 @@ class MockRayletClient : public PinObjectsInterface {
   }
 
   std::list<rpc::ClientCallback<rpc::PinObjectIDsReply>> callbacks = {};
+  size_t num_objects_replicated = 0;
 };
 
 class MockObjectDirectory {
@@ -91,14 +103,13 @@ class MockObjectDirectory {
   }
 
   size_t Flush() {
-    size_t flushed = callbacks.size();
-    for (const auto &pair : callbacks) {
+    // Callbacks may look up more objects, so only flush the current ones.
+    std::vector<std::pair<ObjectID, ObjectLookupCallback>> to_flush;
+    to_flush.swap(callbacks);
+    for (const auto &pair : to_flush) {
       pair.second(pair.first, locations[pair.first]);
     }
-    for (size_t i = 0; i < flushed; i++) {
-      callbacks.erase(callbacks.begin());
-    }
-    return flushed;
+    return to_flush.size();
   }
 
   std::vector<std::pair<ObjectID, ObjectLookupCallback>> callbacks = {};
@@ -256,6 +267,73 @@ TEST_F(ObjectRecoveryManagerTest, TestReconstructionChain) {
   }
 }
 
+TEST_F(ObjectRecoveryManagerTest, TestRecoverObjectsBatchesPins) {
+  NodeID remote_node_id = NodeID::FromRandom();
+  rpc::Address address;
+  address.set_raylet_id(remote_node_id.Binary());
+  std::vector<ObjectID> object_ids;
+  for (int i = 0; i < 3; i++) {
+    ObjectID object_id = ObjectID::FromRandom();
+    ref_counter_->AddOwnedObject(object_id, {}, rpc::Address(), "", 0, true);
+    object_directory_->SetLocations(object_id, {address});
+    object_ids.push_back(object_id);
+  }
+
+  std::vector<ObjectID> unrecoverable;
+  manager_.RecoverObjects(object_ids, &unrecoverable);
+  ASSERT_TRUE(unrecoverable.empty());
+  ASSERT_EQ(object_directory_->Flush(), 3);
+  // All copies on the same node are pinned with a single request.
+  ASSERT_EQ(raylet_client_->Flush(), 1);
+  ASSERT_TRUE(failed_reconstructions_.empty());
+  ASSERT_EQ(task_resubmitter_->num_tasks_resubmitted, 0);
+}
+
+TEST_F(ObjectRecoveryManagerTest, TestRecoverObjectsSharedAncestor) {
+  // Two lost objects created by different tasks that both depend on the same
+  // lost object.
+  ObjectID ancestor = ObjectID::FromRandom();
+  ref_counter_->AddOwnedObject(ancestor, {}, rpc::Address(), "", 0, true);
+  task_resubmitter_->AddTask(ancestor.TaskId(), {});
+  std::vector<ObjectID> object_ids;
+  for (int i = 0; i < 2; i++) {
+    ObjectID object_id = ObjectID::FromRandom();
+    ref_counter_->AddOwnedObject(object_id, {}, rpc::Address(), "", 0, true);
+    task_resubmitter_->AddTask(object_id.TaskId(), {ancestor});
+    object_ids.push_back(object_id);
+  }
+
+  std::vector<ObjectID> unrecoverable;
+  manager_.RecoverObjects(object_ids, &unrecoverable);
+  ASSERT_TRUE(unrecoverable.empty());
+  ASSERT_EQ(object_directory_->Flush(), 2);
+  ASSERT_EQ(task_resubmitter_->num_tasks_resubmitted, 2);
+  // The shared ancestor is looked up and resubmitted only once.
+  ASSERT_EQ(object_directory_->Flush(), 1);
+  ASSERT_EQ(task_resubmitter_->num_tasks_resubmitted, 3);
+  ASSERT_TRUE(failed_reconstructions_.empty());
+}
+
+TEST_F(ObjectRecoveryManagerTest, TestRecoverFromReplica) {
+  ObjectID object_id = ObjectID::FromRandom();
+  ref_counter_->AddOwnedObject(object_id, {}, rpc::Address(), "", 0, true);
+  task_resubmitter_->AddTask(object_id.TaskId(), {});
+  NodeID replica_node_id = NodeID::FromRandom();
+  rpc::Address replica_address;
+  replica_address.set_raylet_id(replica_node_id.Binary());
+  manager_.ReplicateObject(object_id, {replica_address});
+  ASSERT_EQ(raylet_client_->num_objects_replicated, 1);
+
+  // The primary copy is lost, but the replica is pinned instead of
+  // resubmitting the task.
+  object_directory_->SetLocations(object_id, {replica_address});
+  ASSERT_TRUE(manager_.RecoverObject(object_id));
+  ASSERT_EQ(object_directory_->Flush(), 1);
+  ASSERT_EQ(raylet_client_->Flush(), 1);
+  ASSERT_TRUE(failed_reconstructions_.empty());
+  ASSERT_EQ(task_resubmitter_->num_tasks_resubmitted, 0);
+}
+
 }  // namespace core
 }  // namespace ray
 
@@ -25,8 +25,10 @@ namespace core {
 class MockActorSchedulingQueue {
  public:
   MockActorSchedulingQueue(instrumented_io_context &main_io_service,
-                           DependencyWaiter &waiter)
-      : queue_(main_io_service, waiter) {}
+                           DependencyWaiter &waiter, bool execute_out_of_order = false)
+      : queue_(main_io_service, waiter, std::make_shared<PoolManager>(),
+               /*is_asyncio=*/false, /*fiber_max_concurrency=*/1, kMaxReorderWaitSeconds,
+               execute_out_of_order) {}
   void Add(int64_t seq_no, int64_t client_processed_up_to,
            std::function<void(rpc::SendReplyCallback)> accept_request,
            std::function<void(rpc::SendReplyCallback)> reject_request,
@@ -158,6 +160,39 @@ TEST(SchedulingQueueTest, TestOutOfOrder) {
   ASSERT_EQ(n_steal, 0);
 }
 
+TEST(SchedulingQueueTest, TestExecuteOutOfOrder) {
+  ObjectID obj1 = ObjectID::FromRandom();
+  ObjectID obj2 = ObjectID::FromRandom();
+  instrumented_io_context io_service;
+  MockWaiter waiter;
+  MockActorSchedulingQueue queue(io_service, waiter, /*execute_out_of_order=*/true);
+  std::vector<int64_t> executed;
+  int n_rej = 0;
+  auto fn_ok = [&executed](int64_t seq_no) {
+    return [&executed, seq_no](rpc::SendReplyCallback callback) {
+      executed.push_back(seq_no);
+    };
+  };
+  auto fn_rej = [&n_rej](rpc::SendReplyCallback callback) { n_rej++; };
+  // Sequence number gaps and unready dependencies don't block later tasks.
+  queue.Add(3, -1, fn_ok(3), fn_rej, nullptr);
+  queue.Add(0, -1, fn_ok(0), fn_rej, nullptr, nullptr, TaskID::Nil(),
+            ObjectIdsToRefs({obj1}));
+  queue.Add(1, -1, fn_ok(1), fn_rej, nullptr, nullptr, TaskID::Nil(),
+            ObjectIdsToRefs({obj2}));
+  ASSERT_EQ(executed, std::vector<int64_t>({3}));
+
+  waiter.Complete(1);
+  ASSERT_EQ(executed, std::vector<int64_t>({3, 1}));
+
+  waiter.Complete(0);
+  ASSERT_EQ(executed, std::vector<int64_t>({3, 1, 0}));
+
+  // There is no sequencing timeout to cancel the missing task 2.
+  io_service.run();
+  ASSERT_EQ(n_rej, 0);
+}
+
 TEST(SchedulingQueueTest, TestSeqWaitTimeout) {
   instrumented_io_context io_service;
   MockWaiter waiter;
@@ -357,6 +392,39 @@ TEST(SchedulingQueueTest, TestStealingOddNumberTasks) {
   ASSERT_EQ(n_steal, 5);
 }
 
+TEST(BoundedExecutorTest, TestSharedPoolRespectsGroupLimits) {
+  // Two executors share a pool with enough threads for both, and each must
+  // stay within its own max_concurrency.
+  auto shared_pool = std::make_shared<boost::asio::thread_pool>(3);
+  BoundedExecutor group_a(1, shared_pool);
+  BoundedExecutor group_b(2, shared_pool);
+  std::atomic<int> running_a(0);
+  std::atomic<int> running_b(0);
+  std::atomic<int> max_running_a(0);
+  std::atomic<int> max_running_b(0);
+  std::atomic<int> done(0);
+
+  auto make_task = [&done](std::atomic<int> &running, std::atomic<int> &max_running) {
+    return [&done, &running, &max_running]() {
+      int now = ++running;
+      int prev = max_running.load();
+      while (now > prev && !max_running.compare_exchange_weak(prev, now)) {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      --running;
+      ++done;
+    };
+  };
+  for (int i = 0; i < 6; i++) {
+    group_a.PostBlocking(make_task(running_a, max_running_a));
+    group_b.PostBlocking(make_task(running_b, max_running_b));
+  }
+  shared_pool->join();
+  ASSERT_EQ(done, 12);
+  ASSERT_LE(max_running_a, 1);
+  ASSERT_LE(max_running_b, 2);
+}
+
 }  // namespace core
 }  // namespace ray
 
@@ -14,6 +14,8 @@
 
 #include "ray/core_worker/task_manager.h"
 
+#include <thread>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -40,7 +42,7 @@ TaskSpecification CreateTaskHelper(uint64_t num_returns,
 
 class TaskManagerTest : public ::testing::Test {
  public:
-  TaskManagerTest(bool lineage_pinning_enabled = false)
+  TaskManagerTest(bool lineage_pinning_enabled = false, int64_t max_lineage_bytes = 0)
       : store_(std::shared_ptr<CoreWorkerMemoryStore>(new CoreWorkerMemoryStore())),
         publisher_(std::make_shared<mock_pubsub::MockPublisher>()),
         subscriber_(std::make_shared<mock_pubsub::MockSubscriber>()),
@@ -55,7 +57,8 @@ class TaskManagerTest : public ::testing::Test {
                  [this](const NodeID &node_id) { return all_nodes_alive_; },
                  [this](const ObjectID &object_id) {
                    objects_to_recover_.push_back(object_id);
-                 }) {}
+                 },
+                 max_lineage_bytes) {}
 
   std::shared_ptr<CoreWorkerMemoryStore> store_;
   std::shared_ptr<mock_pubsub::MockPublisher> publisher_;
@@ -72,6 +75,16 @@ class TaskManagerLineageTest : public TaskManagerTest {
   TaskManagerLineageTest() : TaskManagerTest(true) {}
 };
 
+/// Lineage pinning with room for the specs of one single-arg task, but not two.
+class TaskManagerLineageBudgetTest : public TaskManagerTest {
+ public:
+  TaskManagerLineageBudgetTest()
+      : TaskManagerTest(
+            true,
+            CreateTaskHelper(1, {ObjectID::FromRandom()}).GetMessage().ByteSizeLong() *
+                3 / 2) {}
+};
+
 TEST_F(TaskManagerTest, TestTaskSuccess) {
   rpc::Address caller_address;
   ObjectID dep1 = ObjectID::FromRandom();
@@ -110,6 +123,122 @@ TEST_F(TaskManagerTest, TestTaskSuccess) {
   ASSERT_EQ(reference_counter_->NumObjectIDsInScope(), 0);
 }
 
+TEST_F(TaskManagerTest, TestAddPendingTasks) {
+  rpc::Address caller_address;
+  ObjectID dep = ObjectID::FromRandom();
+  std::vector<TaskSpecification> specs;
+  for (int i = 0; i < 3; i++) {
+    specs.push_back(CreateTaskHelper(1, {dep}));
+  }
+  manager_.AddPendingTasks(caller_address, specs, "");
+  for (const auto &spec : specs) {
+    ASSERT_TRUE(manager_.IsTaskPending(spec.TaskId()));
+  }
+  ASSERT_EQ(manager_.NumPendingTasks(), 3);
+  // The shared dependency and one return object per task.
+  ASSERT_EQ(reference_counter_->NumObjectIDsInScope(), 4);
+
+  for (const auto &spec : specs) {
+    rpc::PushTaskReply reply;
+    auto return_object = reply.add_return_objects();
+    return_object->set_object_id(spec.ReturnId(0).Binary());
+    auto data = GenerateRandomBuffer();
+    return_object->set_data(data->Data(), data->Size());
+    manager_.CompletePendingTask(spec.TaskId(), reply, rpc::Address());
+    ASSERT_FALSE(manager_.IsTaskPending(spec.TaskId()));
+  }
+  ASSERT_EQ(manager_.NumPendingTasks(), 0);
+  ASSERT_EQ(reference_counter_->NumObjectIDsInScope(), 3);
+}
+
+TEST_F(TaskManagerTest, TestConcurrentSubmitAndComplete) {
+  rpc::Address caller_address;
+  const int num_threads = 4;
+  const int num_tasks_per_thread = 250;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([this, &caller_address, num_tasks_per_thread]() {
+      for (int i = 0; i < num_tasks_per_thread; i++) {
+        auto spec = CreateTaskHelper(1, {});
+        manager_.AddPendingTask(caller_address, spec, "");
+        rpc::PushTaskReply reply;
+        auto return_object = reply.add_return_objects();
+        return_object->set_object_id(spec.ReturnId(0).Binary());
+        auto data = GenerateRandomBuffer();
+        return_object->set_data(data->Data(), data->Size());
+        manager_.CompletePendingTask(spec.TaskId(), reply, rpc::Address());
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(manager_.NumPendingTasks(), 0);
+  ASSERT_EQ(manager_.NumSubmissibleTasks(), 0);
+  // Only the return objects remain in scope.
+  ASSERT_EQ(reference_counter_->NumObjectIDsInScope(),
+            static_cast<size_t>(num_threads * num_tasks_per_thread));
+}
+
+TEST_F(TaskManagerTest, TestStreamingGeneratorItems) {
+  rpc::Address caller_address;
+  auto spec = CreateTaskHelper(1, {});
+  spec.GetMutableMessage().set_streaming_generator(true);
+  manager_.AddPendingTask(caller_address, spec, "");
+  const auto generator_id = spec.TaskId();
+  WorkerContext ctx(WorkerType::WORKER, WorkerID::FromRandom(), JobID::FromInt(0));
+
+  auto report_item = [&](int64_t item_index) {
+    rpc::ReportGeneratorItemReturnsRequest request;
+    request.set_generator_id(generator_id.Binary());
+    request.set_item_index(item_index);
+    auto return_object = request.mutable_returned_object();
+    return_object->set_object_id(spec.GeneratorItemId(item_index).Binary());
+    auto data = GenerateRandomBuffer();
+    return_object->set_data(data->Data(), data->Size());
+    return manager_.HandleReportGeneratorItemReturns(request);
+  };
+
+  ObjectID object_id;
+  bool end_of_stream;
+  RAY_CHECK_OK(manager_.TryReadObjectRefStream(generator_id, &object_id, &end_of_stream));
+  ASSERT_TRUE(object_id.IsNil());
+  ASSERT_FALSE(end_of_stream);
+
+  // Items are readable before the task finishes.
+  ASSERT_TRUE(report_item(0));
+  ASSERT_TRUE(report_item(1));
+  // A retried task reports the same item again.
+  ASSERT_FALSE(report_item(0));
+  RAY_CHECK_OK(manager_.TryReadObjectRefStream(generator_id, &object_id, &end_of_stream));
+  ASSERT_EQ(object_id, spec.GeneratorItemId(0));
+  std::vector<std::shared_ptr<RayObject>> results;
+  RAY_CHECK_OK(store_->Get({object_id}, 1, -1, ctx, false, &results));
+  ASSERT_FALSE(results[0]->IsException());
+  ASSERT_FALSE(report_item(0));
+
+  rpc::PushTaskReply reply;
+  auto return_object = reply.add_return_objects();
+  return_object->set_object_id(spec.ReturnId(0).Binary());
+  manager_.CompletePendingTask(generator_id, reply, rpc::Address());
+  ASSERT_FALSE(report_item(2));
+
+  RAY_CHECK_OK(manager_.TryReadObjectRefStream(generator_id, &object_id, &end_of_stream));
+  ASSERT_EQ(object_id, spec.GeneratorItemId(1));
+  RAY_CHECK_OK(manager_.TryReadObjectRefStream(generator_id, &object_id, &end_of_stream));
+  ASSERT_TRUE(object_id.IsNil());
+  ASSERT_TRUE(end_of_stream);
+
+  // The read items are now referenced by the reader.
+  std::vector<ObjectID> removed;
+  reference_counter_->RemoveLocalReference(spec.GeneratorItemId(0), &removed);
+  reference_counter_->RemoveLocalReference(spec.GeneratorItemId(1), &removed);
+  ASSERT_EQ(removed.size(), 2);
+  manager_.DelObjectRefStream(spec.TaskId());
+  ASSERT_FALSE(
+      manager_.TryReadObjectRefStream(generator_id, &object_id, &end_of_stream).ok());
+}
+
 TEST_F(TaskManagerTest, TestTaskFailure) {
   rpc::Address caller_address;
   ObjectID dep1 = ObjectID::FromRandom();
@@ -524,6 +653,57 @@ TEST_F(TaskManagerLineageTest, TestResubmitTask) {
   ASSERT_EQ(num_retries_, 1);
 }
 
+TEST_F(TaskManagerLineageBudgetTest, TestLineageEvictedOverBudget) {
+  rpc::Address caller_address;
+  ObjectID dep1 = ObjectID::FromRandom();
+  ObjectID dep2 = ObjectID::FromRandom();
+  auto spec1 = CreateTaskHelper(1, {dep1});
+  auto spec2 = CreateTaskHelper(1, {dep2});
+  int num_retries = 3;
+
+  auto complete_in_plasma = [this](const TaskSpecification &spec) {
+    rpc::PushTaskReply reply;
+    auto return_object = reply.add_return_objects();
+    return_object->set_object_id(spec.ReturnId(0).Binary());
+    auto data = GenerateRandomBuffer();
+    return_object->set_data(data->Data(), data->Size());
+    return_object->set_in_plasma(true);
+    manager_.CompletePendingTask(spec.TaskId(), reply, rpc::Address());
+  };
+
+  manager_.AddPendingTask(caller_address, spec1, "", num_retries);
+  reference_counter_->AddLocalReference(spec1.ReturnId(0), "");
+  complete_in_plasma(spec1);
+  // The first task fits within the budget and is pinned.
+  ASSERT_TRUE(manager_.IsTaskSubmissible(spec1.TaskId()));
+  ASSERT_TRUE(reference_counter_->HasReference(dep1));
+  ASSERT_EQ(manager_.LineageFootprintBytes(),
+            static_cast<int64_t>(spec1.GetMessage().ByteSizeLong()));
+
+  manager_.AddPendingTask(caller_address, spec2, "", num_retries);
+  reference_counter_->AddLocalReference(spec2.ReturnId(0), "");
+  complete_in_plasma(spec2);
+  // The oldest lineage is evicted to make room for the second task.
+  ASSERT_FALSE(manager_.IsTaskSubmissible(spec1.TaskId()));
+  ASSERT_FALSE(reference_counter_->HasReference(dep1));
+  ASSERT_TRUE(manager_.IsTaskSubmissible(spec2.TaskId()));
+  ASSERT_TRUE(reference_counter_->HasReference(dep2));
+  ASSERT_EQ(manager_.LineageFootprintBytes(),
+            static_cast<int64_t>(spec2.GetMessage().ByteSizeLong()));
+  ASSERT_EQ(manager_.NumLineageEvicted(), 1);
+
+  // The evicted task can no longer be resubmitted.
+  std::vector<ObjectID> resubmitted_task_deps;
+  ASSERT_FALSE(manager_.ResubmitTask(spec1.TaskId(), &resubmitted_task_deps).ok());
+
+  // Releasing the remaining lineage brings the footprint back to zero.
+  reference_counter_->RemoveLocalReference(spec1.ReturnId(0), nullptr);
+  reference_counter_->RemoveLocalReference(spec2.ReturnId(0), nullptr);
+  ASSERT_FALSE(manager_.IsTaskSubmissible(spec2.TaskId()));
+  ASSERT_FALSE(reference_counter_->HasReference(dep2));
+  ASSERT_EQ(manager_.LineageFootprintBytes(), 0);
+}
+
 }  // namespace core
 }  // namespace ray
 
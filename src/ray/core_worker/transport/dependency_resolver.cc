@@ -19,20 +19,26 @@ namespace core {
 
 struct TaskState {
   TaskState(TaskSpecification t,
-            absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> deps)
-      : task(t), local_dependencies(deps), dependencies_remaining(deps.size()) {}
+            absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> &&deps)
+      : task(std::move(t)),
+        local_dependencies(std::move(deps)),
+        dependencies_remaining(local_dependencies.size()) {}
   /// The task to be run.
   TaskSpecification task;
+  /// Protects the fields below. Each task has its own lock so that resolving
+  /// the arguments of unrelated tasks does not contend.
+  absl::Mutex mu;
   /// The local dependencies to resolve for this task. Objects are nullptr if not yet
   /// resolved.
-  absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> local_dependencies;
+  absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> local_dependencies
+      GUARDED_BY(mu);
   /// Number of local dependencies that aren't yet resolved (have nullptrs in the above
   /// map).
-  size_t dependencies_remaining;
+  size_t dependencies_remaining GUARDED_BY(mu);
 };
 
 void InlineDependencies(
-    absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> dependencies,
+    const absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> &dependencies,
     TaskSpecification &task, std::vector<ObjectID> *inlined_dependency_ids,
     std::vector<ObjectID> *contained_ids) {
   auto &msg = task.GetMutableMessage();
@@ -73,6 +79,7 @@ void InlineDependencies(
 void LocalDependencyResolver::ResolveDependencies(TaskSpecification &task,
                                                   std::function<void()> on_complete) {
   absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> local_dependencies;
+  local_dependencies.reserve(task.NumArgs());
   for (size_t i = 0; i < task.NumArgs(); i++) {
     if (task.ArgByRef(i)) {
       local_dependencies.emplace(task.ArgId(i), nullptr);
@@ -88,8 +95,18 @@ void LocalDependencyResolver::ResolveDependencies(TaskSpecification &task,
       std::make_shared<TaskState>(task, std::move(local_dependencies));
   num_pending_ += 1;
 
-  for (const auto &it : state->local_dependencies) {
-    const ObjectID &obj_id = it.first;
+  // Copy the IDs out first: GetAsync may run the callback inline, and the
+  // callback mutates the map under the task's lock.
+  std::vector<ObjectID> dependency_ids;
+  {
+    absl::MutexLock lock(&state->mu);
+    dependency_ids.reserve(state->local_dependencies.size());
+    for (const auto &it : state->local_dependencies) {
+      dependency_ids.push_back(it.first);
+    }
+  }
+
+  for (const auto &obj_id : dependency_ids) {
     in_memory_store_->GetAsync(obj_id, [this, state, obj_id,
                                         on_complete](std::shared_ptr<RayObject> obj) {
       RAY_CHECK(obj != nullptr);
@@ -97,7 +114,7 @@ void LocalDependencyResolver::ResolveDependencies(TaskSpecification &task,
       std::vector<ObjectID> inlined_dependency_ids;
       std::vector<ObjectID> contained_ids;
       {
-        absl::MutexLock lock(&mu_);
+        absl::MutexLock lock(&state->mu);
         state->local_dependencies[obj_id] = std::move(obj);
         if (--state->dependencies_remaining == 0) {
           InlineDependencies(state->local_dependencies, state->task,
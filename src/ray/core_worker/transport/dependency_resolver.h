@@ -54,9 +54,6 @@ class LocalDependencyResolver {
 
   /// Number of tasks pending dependency resolution.
   std::atomic<int> num_pending_;
-
-  /// Protects against concurrent access to internal state.
-  absl::Mutex mu_;
 };
 
 }  // namespace core
@@ -277,7 +277,9 @@ void CoreWorkerDirectActorTaskSubmitter::SendPendingTasks(const ActorID &actor_i
     client_queue.pending_force_kill.reset();
   }
 
-  // Submit all pending requests.
+  // Submit all pending requests. Tasks that go through the client's send queue are
+  // handed over together, so that the client can coalesce them into batches.
+  std::vector<rpc::PushTaskRequestAndCallback> batch;
   auto &requests = client_queue.requests;
   auto head = requests.begin();
   while (head != requests.end() &&
@@ -290,9 +292,12 @@ void CoreWorkerDirectActorTaskSubmitter::SendPendingTasks(const ActorID &actor_i
     head = requests.erase(head);
 
     RAY_CHECK(!client_queue.worker_id.empty());
-    PushActorTask(client_queue, task_spec, skip_queue);
+    PushActorTask(client_queue, task_spec, skip_queue, &batch);
     client_queue.next_send_position++;
   }
+  if (!batch.empty()) {
+    client_queue.rpc_client->PushActorTasks(std::move(batch));
+  }
 }
 
 void CoreWorkerDirectActorTaskSubmitter::ResendOutOfOrderTasks(const ActorID &actor_id) {
@@ -314,9 +319,9 @@ void CoreWorkerDirectActorTaskSubmitter::ResendOutOfOrderTasks(const ActorID &ac
   client_queue.out_of_order_completed_tasks.clear();
 }
 
-void CoreWorkerDirectActorTaskSubmitter::PushActorTask(const ClientQueue &queue,
-                                                       const TaskSpecification &task_spec,
-                                                       bool skip_queue) {
+void CoreWorkerDirectActorTaskSubmitter::PushActorTask(
+    const ClientQueue &queue, const TaskSpecification &task_spec, bool skip_queue,
+    std::vector<rpc::PushTaskRequestAndCallback> *batch) {
   auto request = std::make_unique<rpc::PushTaskRequest>();
   // NOTE(swang): CopyFrom is needed because if we use Swap here and the task
   // fails, then the task data will be gone when the TaskManager attempts to
@@ -344,8 +349,7 @@ void CoreWorkerDirectActorTaskSubmitter::PushActorTask(const ClientQueue &queue,
   }
 
   rpc::Address addr(queue.rpc_client->Addr());
-  queue.rpc_client->PushActorTask(
-      std::move(request), skip_queue,
+  rpc::ClientCallback<rpc::PushTaskReply> callback =
       [this, addr, task_id, actor_id, actor_counter, task_spec, task_skipped](
           Status status, const rpc::PushTaskReply &reply) {
         bool increment_completed_tasks = true;
@@ -415,7 +419,12 @@ void CoreWorkerDirectActorTaskSubmitter::PushActorTask(const ClientQueue &queue,
                          << " and size of out_of_order_tasks set is "
                          << queue.out_of_order_completed_tasks.size();
         }
-      });
+      };
+  if (batch != nullptr && !skip_queue) {
+    batch->emplace_back(std::move(request), std::move(callback));
+  } else {
+    queue.rpc_client->PushActorTask(std::move(request), skip_queue, callback);
+  }
 }
 
 bool CoreWorkerDirectActorTaskSubmitter::IsActorAlive(const ActorID &actor_id) const {
@@ -425,6 +434,19 @@ bool CoreWorkerDirectActorTaskSubmitter::IsActorAlive(const ActorID &actor_id) c
   return (iter != client_queues_.end() && iter->second.rpc_client);
 }
 
+std::shared_ptr<rpc::CoreWorkerClientInterface>
+CoreWorkerDirectActorTaskSubmitter::GetActorRpcClient(const ActorID &actor_id,
+                                                      std::string *worker_id) const {
+  absl::MutexLock lock(&mu_);
+
+  auto iter = client_queues_.find(actor_id);
+  if (iter == client_queues_.end() || !iter->second.rpc_client) {
+    return nullptr;
+  }
+  *worker_id = iter->second.worker_id;
+  return iter->second.rpc_client;
+}
+
 void CoreWorkerDirectTaskReceiver::Init(
     std::shared_ptr<rpc::CoreWorkerClientPool> client_pool, rpc::Address rpc_address,
     std::shared_ptr<DependencyWaiter> dependency_waiter) {
@@ -456,6 +478,7 @@ void CoreWorkerDirectTaskReceiver::HandleTask(
 
   if (task_spec.IsActorCreationTask()) {
     SetMaxActorConcurrency(task_spec.IsAsyncioActor(), task_spec.MaxActorConcurrency());
+    execute_out_of_order_ = task_spec.ExecuteOutOfOrder();
   }
 
   // Only assign resources for non-actor tasks. Actor tasks inherit the resources
@@ -568,7 +591,8 @@ void CoreWorkerDirectTaskReceiver::HandleTask(
           task_spec.CallerWorkerId(),
           std::unique_ptr<SchedulingQueue>(
               new ActorSchedulingQueue(task_main_io_service_, *waiter_, pool_manager_,
-                                       is_asyncio_, fiber_max_concurrency_)));
+                                       is_asyncio_, fiber_max_concurrency_,
+                                       kMaxReorderWaitSeconds, execute_out_of_order_)));
       it = result.first;
     }
 
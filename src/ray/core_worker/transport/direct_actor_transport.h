@@ -27,6 +27,7 @@
 #include "absl/synchronization/mutex.h"
 #include "ray/common/asio/instrumented_io_context.h"
 #include "ray/common/id.h"
+#include "ray/common/ray_config.h"
 #include "ray/common/ray_object.h"
 #include "ray/core_worker/context.h"
 #include "ray/core_worker/fiber.h"
@@ -134,6 +135,15 @@ class CoreWorkerDirectActorTaskSubmitter
   /// Check timeout tasks that are waiting for Death info.
   void CheckTimeoutTasks();
 
+  /// Get the RPC client of a connected actor, for sending requests that are
+  /// not tasks.
+  ///
+  /// \param[in] actor_id The actor ID.
+  /// \param[out] worker_id The ID of the worker the actor is running on.
+  /// \return The RPC client, or nullptr if the actor is not connected.
+  std::shared_ptr<rpc::CoreWorkerClientInterface> GetActorRpcClient(
+      const ActorID &actor_id, std::string *worker_id) const;
+
  private:
   struct ClientQueue {
     /// The current state of the actor. If this is ALIVE, then we should have
@@ -235,9 +245,13 @@ class CoreWorkerDirectActorTaskSubmitter
   /// \param[in] task_spec The task to send.
   /// \param[in] skip_queue Whether to skip the task queue. This will send the
   /// task for execution immediately.
+  /// \param[out] batch If set, a task that does not skip the queue is appended here
+  /// instead of being sent, so that the caller can send it with other tasks.
   /// \return Void.
   void PushActorTask(const ClientQueue &queue, const TaskSpecification &task_spec,
-                     bool skip_queue) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+                     bool skip_queue,
+                     std::vector<rpc::PushTaskRequestAndCallback> *batch = nullptr)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
   /// Send all pending tasks for an actor.
   ///
@@ -289,14 +303,31 @@ class BoundedExecutor;
 
 /// A manager that manages a set of thread pool. which will perform
 /// the methods defined in one concurrency group.
+///
+/// If actor_concurrency_groups_shared_pool_size is set, the concurrency groups
+/// do not get threads of their own. They all run on one shared pool of that
+/// size, and each group's max_concurrency is only a logical limit on top of it.
 class PoolManager final {
  public:
   explicit PoolManager(const std::vector<ConcurrencyGroup> &concurrency_groups = {},
                        const int32_t default_group_max_concurrency = 1) {
+    const auto shared_pool_size =
+        RayConfig::instance().actor_concurrency_groups_shared_pool_size();
+    if (shared_pool_size > 0 &&
+        (!concurrency_groups.empty() || default_group_max_concurrency > 1)) {
+      shared_pool_ = std::make_shared<boost::asio::thread_pool>(shared_pool_size);
+    }
+    auto make_executor = [this](int32_t max_concurrency) {
+      if (shared_pool_ != nullptr) {
+        return std::make_shared<BoundedExecutor>(max_concurrency, shared_pool_);
+      }
+      return std::make_shared<BoundedExecutor>(max_concurrency);
+    };
+
     for (auto &group : concurrency_groups) {
       const auto name = group.name;
       const auto max_concurrency = group.max_concurrency;
-      auto pool = std::make_shared<BoundedExecutor>(max_concurrency);
+      auto pool = make_executor(max_concurrency);
       auto &fds = group.function_descriptors;
       for (auto fd : fds) {
         functions_to_thread_pool_index_[fd->ToString()] = pool;
@@ -306,8 +337,16 @@ class PoolManager final {
     // If max concurrency of default group is 1, the tasks of default group
     // will be performed in main thread instead of any executor pool.
     if (default_group_max_concurrency > 1) {
-      default_thread_pool_ =
-          std::make_shared<BoundedExecutor>(default_group_max_concurrency);
+      default_thread_pool_ = make_executor(default_group_max_concurrency);
+    }
+  }
+
+  ~PoolManager() {
+    // The executors refer to themselves from the work they post, so the shared
+    // pool must be drained before they are destroyed.
+    if (shared_pool_ != nullptr) {
+      shared_pool_->stop();
+      shared_pool_->join();
     }
   }
 
@@ -341,6 +380,10 @@ class PoolManager final {
   // The thread pool for default concurrency group. It's nullptr if its max concurrency
   // is 1.
   std::shared_ptr<BoundedExecutor> default_thread_pool_ = nullptr;
+
+  // The threads shared by all concurrency groups, if enabled. Otherwise nullptr and
+  // each group has a pool of its own.
+  std::shared_ptr<boost::asio::thread_pool> shared_pool_ = nullptr;
 };
 
 /// Object dependency and RPC state of an inbound request.
@@ -433,14 +476,24 @@ class DependencyWaiterImpl : public DependencyWaiter {
 class BoundedExecutor {
  public:
   BoundedExecutor(int max_concurrency)
-      : num_running_(0), max_concurrency_(max_concurrency), pool_(max_concurrency){};
+      : num_running_(0),
+        max_concurrency_(max_concurrency),
+        pool_(std::make_shared<boost::asio::thread_pool>(max_concurrency)){};
+
+  /// Create an executor that runs its work on a thread pool shared with other
+  /// executors. max_concurrency still bounds how much of this executor's work
+  /// runs at once. The owner of the shared pool must stop and join it before
+  /// destroying this executor.
+  BoundedExecutor(int max_concurrency,
+                  std::shared_ptr<boost::asio::thread_pool> shared_pool)
+      : num_running_(0), max_concurrency_(max_concurrency), pool_(shared_pool){};
 
   /// Posts work to the pool, blocking if no free threads are available.
   void PostBlocking(std::function<void()> fn) {
     mu_.LockWhen(absl::Condition(this, &BoundedExecutor::ThreadsAvailable));
     num_running_ += 1;
     mu_.Unlock();
-    boost::asio::post(pool_, [this, fn]() {
+    boost::asio::post(*pool_, [this, fn]() {
       fn();
       absl::MutexLock lock(&mu_);
       num_running_ -= 1;
@@ -459,7 +512,7 @@ class BoundedExecutor {
   /// The max number of concurrently running tasks allowed.
   const int max_concurrency_;
   /// The underlying thread pool for running tasks.
-  boost::asio::thread_pool pool_;
+  std::shared_ptr<boost::asio::thread_pool> pool_;
 };
 
 /// Used to implement task queueing at the worker. Abstraction to provide a common
@@ -485,14 +538,18 @@ class SchedulingQueue {
 
 /// Used to ensure serial order of task execution per actor handle.
 /// See direct_actor.proto for a description of the ordering protocol.
+/// If execute_out_of_order is set, tasks are instead executed as soon as their
+/// dependencies are ready, regardless of their sequence number.
 class ActorSchedulingQueue : public SchedulingQueue {
  public:
   ActorSchedulingQueue(
       instrumented_io_context &main_io_service, DependencyWaiter &waiter,
       std::shared_ptr<PoolManager> pool_manager = std::make_shared<PoolManager>(),
       bool is_asyncio = false, int fiber_max_concurrency = 1,
-      int64_t reorder_wait_seconds = kMaxReorderWaitSeconds)
+      int64_t reorder_wait_seconds = kMaxReorderWaitSeconds,
+      bool execute_out_of_order = false)
       : reorder_wait_seconds_(reorder_wait_seconds),
+        execute_out_of_order_(execute_out_of_order),
         wait_timer_(main_io_service),
         main_thread_id_(boost::this_thread::get_id()),
         waiter_(waiter),
@@ -501,7 +558,8 @@ class ActorSchedulingQueue : public SchedulingQueue {
     if (is_asyncio_) {
       RAY_LOG(INFO) << "Setting actor as async with max_concurrency="
                     << fiber_max_concurrency << ", creating new fiber thread.";
-      fiber_state_ = std::make_unique<FiberState>(fiber_max_concurrency);
+      fiber_state_ = std::make_unique<FiberState>(
+          fiber_max_concurrency, RayConfig::instance().async_actor_fiber_stack_size());
     }
   }
 
@@ -588,27 +646,26 @@ class ActorSchedulingQueue : public SchedulingQueue {
       pending_actor_tasks_.erase(head);
     }
 
+    if (execute_out_of_order_) {
+      // Process every request whose dependencies are ready. Sequence number gaps
+      // don't block execution, so there is nothing to time out on.
+      for (auto it = pending_actor_tasks_.begin(); it != pending_actor_tasks_.end();) {
+        if (it->second.CanExecute()) {
+          ExecuteRequest(it->second);
+          it = pending_actor_tasks_.erase(it);
+        } else {
+          it++;
+        }
+      }
+      return;
+    }
+
     // Process as many in-order requests as we can.
     while (!pending_actor_tasks_.empty() &&
            pending_actor_tasks_.begin()->first == next_seq_no_ &&
            pending_actor_tasks_.begin()->second.CanExecute()) {
       auto head = pending_actor_tasks_.begin();
-      auto request = head->second;
-
-      if (is_asyncio_) {
-        // Process async actor task.
-        fiber_state_->EnqueueFiber([request]() mutable { request.Accept(); });
-      } else {
-        // Process actor tasks.
-        RAY_CHECK(pool_manager_ != nullptr);
-        auto pool = pool_manager_->GetPool(request.ConcurrencyGroupName(),
-                                           request.FunctionDescriptor());
-        if (pool == nullptr) {
-          request.Accept();
-        } else {
-          pool->PostBlocking([request]() mutable { request.Accept(); });
-        }
-      }
+      ExecuteRequest(head->second);
       pending_actor_tasks_.erase(head);
       next_seq_no_++;
     }
@@ -632,6 +689,25 @@ class ActorSchedulingQueue : public SchedulingQueue {
   }
 
  private:
+  /// Hand a request whose dependencies are ready to the fiber or thread pool
+  /// that should run it.
+  void ExecuteRequest(InboundRequest request) {
+    if (is_asyncio_) {
+      // Process async actor task.
+      fiber_state_->EnqueueFiber([request]() mutable { request.Accept(); });
+    } else {
+      // Process actor tasks.
+      RAY_CHECK(pool_manager_ != nullptr);
+      auto pool = pool_manager_->GetPool(request.ConcurrencyGroupName(),
+                                         request.FunctionDescriptor());
+      if (pool == nullptr) {
+        request.Accept();
+      } else {
+        pool->PostBlocking([request]() mutable { request.Accept(); });
+      }
+    }
+  }
+
   /// Called when we time out waiting for an earlier task to show up.
   void OnSequencingWaitTimeout() {
     RAY_CHECK(boost::this_thread::get_id() == main_thread_id_);
@@ -647,6 +723,9 @@ class ActorSchedulingQueue : public SchedulingQueue {
 
   /// Max time in seconds to wait for dependencies to show up.
   const int64_t reorder_wait_seconds_ = 0;
+  /// Whether to execute requests as their dependencies become ready instead of
+  /// in sequence number order.
+  const bool execute_out_of_order_ = false;
   /// Sorted map of (accept, rej) task callbacks keyed by their sequence number.
   std::map<int64_t, InboundRequest> pending_actor_tasks_;
   /// The next sequence number we are waiting for to arrive.
@@ -852,6 +931,9 @@ class CoreWorkerDirectTaskReceiver {
   std::shared_ptr<PoolManager> pool_manager_;
   /// Whether this actor use asyncio for concurrency.
   bool is_asyncio_ = false;
+  /// Whether this actor executes tasks as their dependencies become ready
+  /// instead of in per-caller submission order.
+  bool execute_out_of_order_ = false;
 
   /// Set the max concurrency for fiber actor.
   /// This should be called once for the actor creation task.
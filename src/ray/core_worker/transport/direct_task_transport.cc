@@ -14,6 +14,9 @@
 
 #include "ray/core_worker/transport/direct_task_transport.h"
 
+#include <cmath>
+#include "ray/common/span_tracer.h"
+
 #include "ray/core_worker/transport/dependency_resolver.h"
 
 namespace ray {
@@ -77,13 +80,14 @@ Status CoreWorkerDirectTaskSubmitter::SubmitTask(TaskSpecification task_spec) {
             task_spec.GetSchedulingClass(), task_spec.GetDependencyIds(),
             task_spec.IsActorCreationTask() ? task_spec.ActorCreationId()
                                             : ActorID::Nil(),
-            task_spec.GetRuntimeEnvHash());
+            task_spec.GetRuntimeEnvHash(),
+            task_spec.IsGangTask() ? task_spec.TaskId() : TaskID::Nil());
         auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
         scheduling_key_entry.task_queue.push_back(task_spec);
         scheduling_key_entry.resource_spec = task_spec;
 
         if (!scheduling_key_entry.AllPipelinesToWorkersFull(
-                max_tasks_in_flight_per_worker_)) {
+                PipelineSize(scheduling_key_entry))) {
           // The pipelines to the current workers are not full yet, so we don't need more
           // workers.
 
@@ -94,7 +98,7 @@ Status CoreWorkerDirectTaskSubmitter::SubmitTask(TaskSpecification task_spec) {
             RAY_CHECK(worker_to_lease_entry_.find(active_worker_addr) !=
                       worker_to_lease_entry_.end());
             auto &lease_entry = worker_to_lease_entry_[active_worker_addr];
-            if (!lease_entry.PipelineToWorkerFull(max_tasks_in_flight_per_worker_)) {
+            if (!lease_entry.PipelineToWorkerFull(PipelineSize(scheduling_key_entry))) {
               OnWorkerIdle(active_worker_addr, scheduling_key, false,
                            lease_entry.assigned_resources);
               // If we find a worker with a non-full pipeline, all we need to do is to
@@ -261,6 +265,9 @@ void CoreWorkerDirectTaskSubmitter::StealTasksOrReturnWorker(
     if (max_tasks_in_flight_per_worker_ > 1) {
       CancelWorkerLeaseIfNeeded(scheduling_key);
     }
+    if (ReassignWorkerToCompatibleKey(thief_addr, scheduling_key)) {
+      return;
+    }
     ReturnWorker(thief_addr, was_error, scheduling_key);
     return;
   }
@@ -323,6 +330,54 @@ void CoreWorkerDirectTaskSubmitter::StealTasksOrReturnWorker(
       }));
 }
 
+bool CoreWorkerDirectTaskSubmitter::ReassignWorkerToCompatibleKey(
+    const rpc::WorkerAddress &addr, const SchedulingKey &scheduling_key) {
+  if (!RayConfig::instance().worker_lease_reuse_across_scheduling_keys()) {
+    return false;
+  }
+  // Leases for actor creation tasks and gang members are tied to their key.
+  if (!std::get<2>(scheduling_key).IsNil() || !std::get<4>(scheduling_key).IsNil()) {
+    return false;
+  }
+
+  // A lease can serve any key with the same resource shape and runtime env. Among
+  // those, pick the one with the most queued tasks.
+  const SchedulingKey *target_key = nullptr;
+  size_t target_queue_size = 0;
+  for (const auto &entry : scheduling_key_entries_) {
+    const auto &key = entry.first;
+    if (key == scheduling_key || std::get<0>(key) != std::get<0>(scheduling_key) ||
+        std::get<3>(key) != std::get<3>(scheduling_key) || !std::get<2>(key).IsNil() ||
+        !std::get<4>(key).IsNil()) {
+      continue;
+    }
+    if (entry.second.task_queue.size() > target_queue_size) {
+      target_key = &key;
+      target_queue_size = entry.second.task_queue.size();
+    }
+  }
+  if (target_key == nullptr) {
+    return false;
+  }
+  // Copy the key, since erasing the old entry below may rehash the map.
+  const SchedulingKey new_key = *target_key;
+
+  RAY_LOG(DEBUG) << "Reusing the lease on worker " << addr.worker_id
+                 << " for another scheduling key with " << target_queue_size
+                 << " queued tasks";
+  auto &old_entry = scheduling_key_entries_[scheduling_key];
+  old_entry.active_workers.erase(addr);
+  if (old_entry.CanDelete()) {
+    scheduling_key_entries_.erase(scheduling_key);
+  }
+
+  auto &lease_entry = worker_to_lease_entry_[addr];
+  lease_entry.scheduling_key = new_key;
+  RAY_CHECK(scheduling_key_entries_[new_key].active_workers.emplace(addr).second);
+  OnWorkerIdle(addr, new_key, /*was_error=*/false, lease_entry.assigned_resources);
+  return true;
+}
+
 void CoreWorkerDirectTaskSubmitter::OnWorkerIdle(
     const rpc::WorkerAddress &addr, const SchedulingKey &scheduling_key, bool was_error,
     const google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> &assigned_resources) {
@@ -350,7 +405,7 @@ void CoreWorkerDirectTaskSubmitter::OnWorkerIdle(
     auto &client = *client_cache_->GetOrConnect(addr.ToProto());
 
     while (!current_queue.empty() &&
-           !lease_entry.PipelineToWorkerFull(max_tasks_in_flight_per_worker_)) {
+           !lease_entry.PipelineToWorkerFull(PipelineSize(scheduling_key_entry))) {
       auto task_spec = current_queue.front();
       // Increment the number of tasks in flight to the worker
       lease_entry.tasks_in_flight++;
@@ -449,7 +504,8 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
   // enough room in an existing worker's pipeline to send the new tasks. If the pipelines
   // are not full, we do not request a new worker (unless work stealing is enabled, in
   // which case we can request a worker under the Eager Worker Requesting mode)
-  if (!scheduling_key_entry.AllPipelinesToWorkersFull(max_tasks_in_flight_per_worker_) &&
+  if (!scheduling_key_entry.AllPipelinesToWorkersFull(
+          PipelineSize(scheduling_key_entry)) &&
       max_tasks_in_flight_per_worker_ == 1) {
     // The pipelines to the current workers are not full yet, so we don't need more
     // workers.
@@ -496,8 +552,8 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
 
   lease_client->RequestWorkerLease(
       resource_spec,
-      [this, scheduling_key](const Status &status,
-                             const rpc::RequestWorkerLeaseReply &reply) {
+      [this, scheduling_key, lease_start_ns = absl::GetCurrentTimeNanos()](
+          const Status &status, const rpc::RequestWorkerLeaseReply &reply) {
         absl::MutexLock lock(&mu_);
 
         auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
@@ -506,19 +562,24 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
         auto lease_client = std::move(pending_lease_request.first);
         const auto task_id = pending_lease_request.second;
         pending_lease_request = std::make_pair(nullptr, TaskID::Nil());
+        SpanTracer::Instance().Record("LeaseRequest", task_id, lease_start_ns,
+                                      absl::GetCurrentTimeNanos());
 
         if (status.ok()) {
-          if (reply.runtime_env_setup_failed()) {
+          if (reply.runtime_env_setup_failed() || reply.gang_scheduling_failed()) {
             // If the runtime_env failed to be set up, we fail all of the pending
             // tasks in the queue. This makes an implicit assumption that runtime_env
             // failures are not transient -- we may consider adding some retries
-            // in the future.
+            // in the future. The same holds for a gang that timed out, whose
+            // queue only has the task of this lease request.
+            const auto error_type = reply.runtime_env_setup_failed()
+                                        ? rpc::ErrorType::RUNTIME_ENV_SETUP_FAILED
+                                        : rpc::ErrorType::TASK_CANCELLED;
             auto &task_queue = scheduling_key_entry.task_queue;
             while (!task_queue.empty()) {
               auto &task_spec = task_queue.front();
               RAY_UNUSED(task_finisher_->MarkPendingTaskFailed(
-                  task_spec.TaskId(), task_spec, rpc::ErrorType::RUNTIME_ENV_SETUP_FAILED,
-                  nullptr));
+                  task_spec.TaskId(), task_spec, error_type, nullptr));
               task_queue.pop_front();
             }
             if (scheduling_key_entry.CanDelete()) {
@@ -549,8 +610,9 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
           // A lease request to a remote raylet failed. Retry locally if the lease is
           // still needed.
           // TODO(swang): Fail after some number of retries?
-          RAY_LOG(ERROR) << "Retrying attempt to schedule task at remote node. Error: "
-                         << status.ToString();
+          RAY_LOG_RATE_LIMITED(ERROR, 1, 10)
+              << "Retrying attempt to schedule task at remote node. Error: "
+              << status.ToString();
 
           RequestNewWorkerIfNeeded(scheduling_key);
 
@@ -568,6 +630,22 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
   pending_lease_request = std::make_pair(lease_client, task_id);
 }
 
+uint32_t CoreWorkerDirectTaskSubmitter::PipelineSize(
+    const SchedulingKeyEntry &scheduling_key_entry) const {
+  if (max_tasks_in_flight_per_worker_ <= 1 || task_pipeline_target_ms_ <= 0) {
+    return max_tasks_in_flight_per_worker_;
+  }
+  const double avg_ms = scheduling_key_entry.avg_task_duration_ms;
+  if (avg_ms < 0) {
+    // No task with this key has finished yet, so it may be long-running. Send one
+    // task at a time until we know better.
+    return 1;
+  }
+  const double size = std::ceil(task_pipeline_target_ms_ / std::max(avg_ms, 1.0));
+  return static_cast<uint32_t>(std::min(
+      std::max(size, 1.0), static_cast<double>(max_tasks_in_flight_per_worker_)));
+}
+
 void CoreWorkerDirectTaskSubmitter::PushNormalTask(
     const rpc::WorkerAddress &addr, rpc::CoreWorkerClientInterface &client,
     const SchedulingKey &scheduling_key, const TaskSpecification &task_spec,
@@ -583,10 +661,11 @@ void CoreWorkerDirectTaskSubmitter::PushNormalTask(
   request->mutable_task_spec()->CopyFrom(task_spec.GetMessage());
   request->mutable_resource_mapping()->CopyFrom(assigned_resources);
   request->set_intended_worker_id(addr.worker_id.Binary());
+  const int64_t push_time_ms = current_time_ms();
   client.PushNormalTask(
       std::move(request),
       [this, task_spec, task_id, is_actor, is_actor_creation, scheduling_key, addr,
-       assigned_resources](Status status, const rpc::PushTaskReply &reply) {
+       assigned_resources, push_time_ms](Status status, const rpc::PushTaskReply &reply) {
         {
           absl::MutexLock lock(&mu_);
           executing_tasks_.erase(task_id);
@@ -603,6 +682,17 @@ void CoreWorkerDirectTaskSubmitter::PushNormalTask(
           RAY_CHECK(scheduling_key_entry.total_tasks_in_flight >= 1);
           scheduling_key_entry.total_tasks_in_flight--;
 
+          // Tasks pipelined to a worker run one after another, so a task started no
+          // earlier than the previous reply from the same worker.
+          const int64_t now_ms = current_time_ms();
+          if (status.ok() && !reply.task_stolen()) {
+            const double duration_ms =
+                now_ms - std::max(push_time_ms, lease_entry.last_reply_time_ms);
+            auto &avg = scheduling_key_entry.avg_task_duration_ms;
+            avg = avg < 0 ? duration_ms : 0.8 * avg + 0.2 * duration_ms;
+          }
+          lease_entry.last_reply_time_ms = now_ms;
+
           if (reply.worker_exiting()) {
             RAY_LOG(DEBUG) << "Worker " << addr.worker_id
                            << " replied that it is exiting.";
@@ -650,7 +740,8 @@ Status CoreWorkerDirectTaskSubmitter::CancelTask(TaskSpecification task_spec,
   const SchedulingKey scheduling_key(
       task_spec.GetSchedulingClass(), task_spec.GetDependencyIds(),
       task_spec.IsActorCreationTask() ? task_spec.ActorCreationId() : ActorID::Nil(),
-      task_spec.GetRuntimeEnvHash());
+      task_spec.GetRuntimeEnvHash(),
+      task_spec.IsGangTask() ? task_spec.TaskId() : TaskID::Nil());
   std::shared_ptr<rpc::CoreWorkerClientInterface> client = nullptr;
   {
     absl::MutexLock lock(&mu_);
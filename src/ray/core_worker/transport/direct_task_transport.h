@@ -48,10 +48,14 @@ typedef std::function<std::shared_ptr<WorkerLeaseInterface>(const std::string &i
 // the actor creation task just reuses an existing worker, then raylet will not
 // be aware of the actor and is not able to manage it.  It is also keyed on
 // RuntimeEnvHash, because a worker can only run a task if the worker's RuntimeEnvHash
-// matches the RuntimeEnvHash required by the task spec.
+// matches the RuntimeEnvHash required by the task spec. Finally, it is keyed on the
+// task ID of tasks that belong to a gang, because the raylet can only place a gang
+// once it has a lease request for each of its tasks. Since the key only affects where
+// a lease is granted, an idle lease may still be reused for another key with the same
+// SchedulingClass and RuntimeEnvHash.
 typedef int RuntimeEnvHash;
-using SchedulingKey =
-    std::tuple<SchedulingClass, std::vector<ObjectID>, ActorID, RuntimeEnvHash>;
+using SchedulingKey = std::tuple<SchedulingClass, std::vector<ObjectID>, ActorID,
+                                 RuntimeEnvHash, TaskID>;
 
 // This class is thread-safe.
 class CoreWorkerDirectTaskSubmitter {
@@ -78,6 +82,7 @@ class CoreWorkerDirectTaskSubmitter {
         actor_creator_(std::move(actor_creator)),
         client_cache_(core_worker_client_pool),
         max_tasks_in_flight_per_worker_(max_tasks_in_flight_per_worker),
+        task_pipeline_target_ms_(::RayConfig::instance().task_pipeline_target_ms()),
         cancel_retry_timer_(std::move(cancel_timer)) {}
 
   /// Schedule a task for direct submission to a worker.
@@ -185,6 +190,18 @@ class CoreWorkerDirectTaskSubmitter {
       const google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> &assigned_resources)
       EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  /// Hand an idle lease over to another scheduling key that has queued tasks and the
+  /// same resource shape and runtime env, instead of returning the worker to the
+  /// raylet and requesting a new lease for that key.
+  ///
+  /// \param[in] addr The address of the idle worker.
+  /// \param[in] scheduling_key The scheduling key the worker is currently assigned to.
+  /// \return True if the worker was reassigned and is now running tasks for another
+  /// key, false if it should be returned.
+  bool ReassignWorkerToCompatibleKey(const rpc::WorkerAddress &addr,
+                                     const SchedulingKey &scheduling_key)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   /// Push a task to a specific worker.
   void PushNormalTask(const rpc::WorkerAddress &addr,
                       rpc::CoreWorkerClientInterface &client,
@@ -237,6 +254,10 @@ class CoreWorkerDirectTaskSubmitter {
   // worker using a single lease.
   const uint32_t max_tasks_in_flight_per_worker_;
 
+  // The amount of work, in milliseconds, to keep pipelined to each worker. If 0, the
+  // pipeline is always filled up to max_tasks_in_flight_per_worker_.
+  const int64_t task_pipeline_target_ms_;
+
   /// A LeaseEntry struct is used to condense the metadata about a single executor:
   /// (1) The lease client through which the worker should be returned
   /// (2) The expiration time of a worker's lease.
@@ -248,6 +269,9 @@ class CoreWorkerDirectTaskSubmitter {
     std::shared_ptr<WorkerLeaseInterface> lease_client;
     int64_t lease_expiration_time;
     uint32_t tasks_in_flight = 0;
+    // The time at which the worker last replied to a pushed task, used to estimate the
+    // duration of pipelined tasks.
+    int64_t last_reply_time_ms = 0;
     bool currently_stealing = false;
     google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> assigned_resources;
     SchedulingKey scheduling_key;
@@ -258,7 +282,7 @@ class CoreWorkerDirectTaskSubmitter {
         google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> assigned_resources =
             google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry>(),
         SchedulingKey scheduling_key = std::make_tuple(0, std::vector<ObjectID>(),
-                                                       ActorID::Nil(), 0))
+                                                       ActorID::Nil(), 0, TaskID::Nil()))
         : lease_client(lease_client),
           lease_expiration_time(lease_expiration_time),
           assigned_resources(assigned_resources),
@@ -266,7 +290,7 @@ class CoreWorkerDirectTaskSubmitter {
 
     // Check whether the pipeline to the worker associated with a LeaseEntry is full.
     inline bool PipelineToWorkerFull(uint32_t max_tasks_in_flight_per_worker) const {
-      return tasks_in_flight == max_tasks_in_flight_per_worker;
+      return tasks_in_flight >= max_tasks_in_flight_per_worker;
     }
 
     // Check whether the worker is a thief who is in the process of stealing tasks.
@@ -308,6 +332,9 @@ class CoreWorkerDirectTaskSubmitter {
         absl::flat_hash_set<rpc::WorkerAddress>();
     // Keep track of how many tasks with this SchedulingKey are in flight, in total
     uint32_t total_tasks_in_flight = 0;
+    // Moving average of the duration of tasks with this SchedulingKey, measured by the
+    // owner. Negative until the first task completes.
+    double avg_task_duration_ms = -1;
 
     // Check whether it's safe to delete this SchedulingKeyEntry from the
     // scheduling_key_entries_ hashmap.
@@ -347,6 +374,14 @@ class CoreWorkerDirectTaskSubmitter {
   absl::flat_hash_map<SchedulingKey, SchedulingKeyEntry> scheduling_key_entries_
       GUARDED_BY(mu_);
 
+  /// Compute how many tasks to pipeline to each worker leased for a scheduling key.
+  /// This is max_tasks_in_flight_per_worker_, unless task_pipeline_target_ms_ is set, in
+  /// which case the window shrinks for keys whose tasks take long to run.
+  ///
+  /// \param[in] scheduling_key_entry The entry of the scheduling key.
+  /// \return The maximum number of tasks in flight per worker for this key.
+  uint32_t PipelineSize(const SchedulingKeyEntry &scheduling_key_entry) const;
+
   // Tasks that were cancelled while being resolved.
   absl::flat_hash_set<TaskID> cancelled_tasks_ GUARDED_BY(mu_);
 
@@ -71,5 +71,32 @@ Status InternalKVAccessor::Exists(const std::string &key, bool &exist) {
   return ret_promise.get_future().get();
 }
 
+Status InternalKVAccessor::MultiGet(
+    const std::vector<std::string> &keys,
+    std::unordered_map<std::string, std::string> &values) {
+  std::promise<Status> ret_promise;
+  RAY_CHECK_OK(
+      AsyncInternalKVMultiGet(keys, [&ret_promise, &values](Status status, auto &v) {
+        if (v) {
+          values = *v;
+        }
+        ret_promise.set_value(status);
+      }));
+  return ret_promise.get_future().get();
+}
+
+Status InternalKVAccessor::MultiPut(
+    const std::unordered_map<std::string, std::string> &kvs, bool overwrite,
+    int &added_num) {
+  std::promise<Status> ret_promise;
+  RAY_CHECK_OK(AsyncInternalKVMultiPut(
+      kvs, overwrite,
+      [&ret_promise, &added_num](Status status, boost::optional<int> added) {
+        added_num = added.value_or(0);
+        ret_promise.set_value(status);
+      }));
+  return ret_promise.get_future().get();
+}
+
 }  // namespace gcs
 }  // namespace ray
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "ray/common/id.h"
 #include "ray/common/placement_group.h"
 #include "ray/common/task/task_spec.h"
@@ -120,6 +122,36 @@ class ActorInfoAccessor {
       const SubscribeCallback<ActorID, rpc::ActorTableData> &subscribe,
       const StatusCallback &done) = 0;
 
+  /// Subscribe to any update operations of a batch of actors.
+  ///
+  /// \param actor_ids The IDs of actors to be subscribed to.
+  /// \param subscribe Callback that will be called each time when one of the actors is
+  /// updated.
+  /// \param done Callback that will be called when the subscription of all the actors
+  /// is complete.
+  /// \return Status
+  virtual Status AsyncSubscribeBatch(
+      const std::vector<ActorID> &actor_ids,
+      const SubscribeCallback<ActorID, rpc::ActorTableData> &subscribe,
+      const StatusCallback &done) {
+    if (actor_ids.empty()) {
+      if (done) {
+        done(Status::OK());
+      }
+      return Status::OK();
+    }
+    auto num_pending = std::make_shared<std::atomic<size_t>>(actor_ids.size());
+    for (const auto &actor_id : actor_ids) {
+      RAY_RETURN_NOT_OK(
+          AsyncSubscribe(actor_id, subscribe, [num_pending, done](Status status) {
+            if (--*num_pending == 0 && done) {
+              done(status);
+            }
+          }));
+    }
+    return Status::OK();
+  }
+
   /// Cancel subscription to an actor.
   ///
   /// \param actor_id The ID of the actor to be unsubscribed to.
@@ -535,6 +567,13 @@ class NodeResourceInfoAccessor {
   virtual Status AsyncGetAllAvailableResources(
       const MultiItemCallback<rpc::AvailableResources> &callback) = 0;
 
+  /// Get total resources of all nodes from GCS asynchronously, with a single request.
+  ///
+  /// \param callback Callback that will be called after lookup finishes.
+  /// \return Status
+  virtual Status AsyncGetAllTotalResources(
+      const MultiItemCallback<rpc::TotalResources> &callback) = 0;
+
   /// Update resources of node in GCS asynchronously.
   ///
   /// \param node_id The ID of node to update dynamic resources.
@@ -835,6 +874,27 @@ class InternalKVAccessor {
   virtual Status AsyncInternalKVDel(const std::string &key,
                                     const StatusCallback &callback) = 0;
 
+  /// Asynchronously get the values of many keys in one request.
+  ///
+  /// \param keys The keys to lookup.
+  /// \param callback Callback that will be called with the values of the keys that
+  /// exist.
+  /// \return Status
+  virtual Status AsyncInternalKVMultiGet(
+      const std::vector<std::string> &keys,
+      const OptionalItemCallback<std::unordered_map<std::string, std::string>>
+          &callback) = 0;
+
+  /// Asynchronously set the values of many keys in one request.
+  ///
+  /// \param kvs The <key, value> pairs to set.
+  /// \param overwrite Whether to overwrite the existing keys.
+  /// \param callback Callback that will be called with the number of keys added.
+  /// \return Status
+  virtual Status AsyncInternalKVMultiPut(
+      const std::unordered_map<std::string, std::string> &kvs, bool overwrite,
+      const OptionalItemCallback<int> &callback) = 0;
+
   // These are sync functions of the async above
 
   /// List keys with prefix stored in internal kv
@@ -877,6 +937,25 @@ class InternalKVAccessor {
   /// \return Status
   Status Exists(const std::string &key, bool &exist);
 
+  /// Retrieve the values of many keys
+  ///
+  /// \param keys The keys to lookup
+  /// \param values It's an output parameter. It'll be set to the values of the keys
+  ///    that exist.
+  /// \return Status
+  Status MultiGet(const std::vector<std::string> &keys,
+                  std::unordered_map<std::string, std::string> &values);
+
+  /// Set many <key, value> pairs in the store
+  ///
+  /// \param kvs The pairs to set
+  /// \param overwrite If it's true, it'll overwrite the existing keys.
+  /// \param added_num It's an output parameter. It'll be set to the number of keys
+  ///    added.
+  /// \return Status
+  Status MultiPut(const std::unordered_map<std::string, std::string> &kvs,
+                  bool overwrite, int &added_num);
+
  protected:
   InternalKVAccessor() = default;
 };
@@ -14,6 +14,7 @@
 
 #include "ray/gcs/gcs_client/service_based_accessor.h"
 
+#include "ray/common/ray_config.h"
 #include "ray/gcs/gcs_client/service_based_gcs_client.h"
 
 namespace ray {
@@ -21,9 +22,67 @@ namespace gcs {
 
 using namespace ray::rpc;
 
+/// Fetch the result of a paginated bulk query page by page, and pass all the items to
+/// `callback` once the last page arrives or a page fails.
+///
+/// \param request The request of the first page. Its `limit` is the page size.
+/// \param send Sends a request and invokes the given callback with the reply.
+/// \param get_items Returns the items of a reply.
+/// \param result The items received so far.
+/// \param callback The callback to pass all the items to.
+template <typename Item, typename Request, typename Reply>
+static void FetchAllPages(
+    Request request,
+    std::function<void(const Request &, const ClientCallback<Reply> &)> send,
+    std::function<const google::protobuf::RepeatedPtrField<Item> &(const Reply &)>
+        get_items,
+    std::shared_ptr<std::vector<Item>> result, const MultiItemCallback<Item> &callback) {
+  auto on_reply = [request, send, get_items, result, callback](
+                      const Status &status, const Reply &reply) mutable {
+    const auto &items = get_items(reply);
+    result->insert(result->end(), items.begin(), items.end());
+    if (status.ok() && !reply.next_page_token().empty()) {
+      request.set_page_token(reply.next_page_token());
+      FetchAllPages<Item>(std::move(request), std::move(send), std::move(get_items),
+                          std::move(result), callback);
+      return;
+    }
+    callback(status, *result);
+  };
+  send(request, on_reply);
+}
+
+/// The order of the states an actor goes through between two restarts.
+static int ActorStateOrder(rpc::ActorTableData::ActorState state) {
+  switch (state) {
+  case rpc::ActorTableData::DEPENDENCIES_UNREADY:
+    return 0;
+  case rpc::ActorTableData::RESTARTING:
+    return 1;
+  case rpc::ActorTableData::PENDING_CREATION:
+    return 2;
+  case rpc::ActorTableData::ALIVE:
+    return 3;
+  default:
+    return 4;
+  }
+}
+
+/// Whether `actor_data` is not older than `cached`. Notifications and lookups of an
+/// actor can arrive out of order, the number of restarts and the state tell which one
+/// is the latest.
+static bool IsActorDataNotOlder(const rpc::ActorTableData &cached,
+                                const rpc::ActorTableData &actor_data) {
+  if (actor_data.num_restarts() != cached.num_restarts()) {
+    return actor_data.num_restarts() > cached.num_restarts();
+  }
+  return ActorStateOrder(actor_data.state()) >= ActorStateOrder(cached.state());
+}
+
 ServiceBasedJobInfoAccessor::ServiceBasedJobInfoAccessor(
     ServiceBasedGcsClient *client_impl)
-    : client_impl_(client_impl) {}
+    : cache_enabled_(RayConfig::instance().gcs_client_cache_enabled()),
+      client_impl_(client_impl) {}
 
 Status ServiceBasedJobInfoAccessor::AsyncAdd(
     const std::shared_ptr<JobTableData> &data_ptr, const StatusCallback &callback) {
@@ -66,23 +125,34 @@ Status ServiceBasedJobInfoAccessor::AsyncSubscribeAll(
     const SubscribeCallback<JobID, JobTableData> &subscribe, const StatusCallback &done) {
   RAY_CHECK(subscribe != nullptr);
   fetch_all_data_operation_ = [this, subscribe](const StatusCallback &done) {
-    auto callback = [subscribe, done](
+    auto callback = [this, subscribe, done](
                         const Status &status,
                         const std::vector<rpc::JobTableData> &job_info_list) {
       for (auto &job_info : job_info_list) {
-        subscribe(JobID::FromBinary(job_info.job_id()), job_info);
+        auto job_id = JobID::FromBinary(job_info.job_id());
+        UpdateJobCache(job_id, job_info);
+        subscribe(job_id, job_info);
+      }
+      if (cache_enabled_ && status.ok()) {
+        absl::MutexLock lock(&mutex_);
+        job_cache_complete_ = true;
       }
       if (done) {
         done(status);
       }
     };
-    RAY_CHECK_OK(AsyncGetAll(callback));
+    // Fetch from the GCS server even if the cache is complete, it may have missed
+    // updates while the GCS server was restarting.
+    FetchAllJobs(callback);
   };
   subscribe_operation_ = [this, subscribe](const StatusCallback &done) {
-    auto on_subscribe = [subscribe](const std::string &id, const std::string &data) {
+    auto on_subscribe = [this, subscribe](const std::string &id,
+                                          const std::string &data) {
       JobTableData job_data;
       job_data.ParseFromString(data);
-      subscribe(JobID::FromHex(id), job_data);
+      auto job_id = JobID::FromHex(id);
+      UpdateJobCache(job_id, job_data);
+      subscribe(job_id, job_data);
     };
     return client_impl_->GetGcsPubSub().SubscribeAll(JOB_CHANNEL, on_subscribe, done);
   };
@@ -113,18 +183,63 @@ void ServiceBasedJobInfoAccessor::AsyncResubscribe(bool is_pubsub_server_restart
   }
 }
 
+void ServiceBasedJobInfoAccessor::UpdateJobCache(const JobID &job_id,
+                                                 const rpc::JobTableData &job_data) {
+  if (!cache_enabled_) {
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  auto &cached = job_cache_[job_id];
+  // A finished job never comes back.
+  if (!cached.is_dead() || job_data.is_dead()) {
+    cached = job_data;
+  }
+}
+
 Status ServiceBasedJobInfoAccessor::AsyncGetAll(
     const MultiItemCallback<rpc::JobTableData> &callback) {
   RAY_LOG(DEBUG) << "Getting all job info.";
   RAY_CHECK(callback);
+  if (cache_enabled_) {
+    std::vector<rpc::JobTableData> result;
+    bool complete;
+    {
+      absl::MutexLock lock(&mutex_);
+      complete = job_cache_complete_;
+      if (complete) {
+        result.reserve(job_cache_.size());
+        for (const auto &entry : job_cache_) {
+          result.push_back(entry.second);
+        }
+      }
+    }
+    if (complete) {
+      callback(Status::OK(), result);
+      return Status::OK();
+    }
+  }
+  FetchAllJobs(callback);
+  return Status::OK();
+}
+
+void ServiceBasedJobInfoAccessor::FetchAllJobs(
+    const MultiItemCallback<rpc::JobTableData> &callback) {
   rpc::GetAllJobInfoRequest request;
-  client_impl_->GetGcsRpcClient().GetAllJobInfo(
-      request, [callback](const Status &status, const rpc::GetAllJobInfoReply &reply) {
-        auto result = VectorFromProtobuf(reply.job_info_list());
+  request.set_limit(RayConfig::instance().gcs_bulk_query_page_size());
+  FetchAllPages<rpc::JobTableData, rpc::GetAllJobInfoRequest, rpc::GetAllJobInfoReply>(
+      request,
+      [this](const rpc::GetAllJobInfoRequest &request,
+             const ClientCallback<rpc::GetAllJobInfoReply> &callback) {
+        client_impl_->GetGcsRpcClient().GetAllJobInfo(request, callback);
+      },
+      [](const rpc::GetAllJobInfoReply &reply) -> const auto & {
+        return reply.job_info_list();
+      },
+      std::make_shared<std::vector<rpc::JobTableData>>(),
+      [callback](const Status &status, const std::vector<rpc::JobTableData> &result) {
         callback(status, result);
         RAY_LOG(DEBUG) << "Finished getting all job info.";
       });
-  return Status::OK();
 }
 
 Status ServiceBasedJobInfoAccessor::AsyncGetNextJobID(
@@ -143,12 +258,33 @@ Status ServiceBasedJobInfoAccessor::AsyncGetNextJobID(
 
 ServiceBasedActorInfoAccessor::ServiceBasedActorInfoAccessor(
     ServiceBasedGcsClient *client_impl)
-    : client_impl_(client_impl) {}
+    : cache_enabled_(RayConfig::instance().gcs_client_cache_enabled()),
+      client_impl_(client_impl) {}
 
 Status ServiceBasedActorInfoAccessor::AsyncGet(
     const ActorID &actor_id, const OptionalItemCallback<rpc::ActorTableData> &callback) {
   RAY_LOG(DEBUG) << "Getting actor info, actor id = " << actor_id
                  << ", job id = " << actor_id.JobId();
+  if (cache_enabled_) {
+    boost::optional<rpc::ActorTableData> cached;
+    {
+      absl::MutexLock lock(&mutex_);
+      auto it = actor_cache_.find(actor_id);
+      if (it != actor_cache_.end()) {
+        cached = it->second;
+      }
+    }
+    if (cached) {
+      callback(Status::OK(), cached);
+      return Status::OK();
+    }
+  }
+  GetFromGcs(actor_id, callback);
+  return Status::OK();
+}
+
+void ServiceBasedActorInfoAccessor::GetFromGcs(
+    const ActorID &actor_id, const OptionalItemCallback<rpc::ActorTableData> &callback) {
   rpc::GetActorInfoRequest request;
   request.set_actor_id(actor_id.Binary());
   client_impl_->GetGcsRpcClient().GetActorInfo(
@@ -163,16 +299,25 @@ Status ServiceBasedActorInfoAccessor::AsyncGet(
                        << ", actor id = " << actor_id
                        << ", job id = " << actor_id.JobId();
       });
-  return Status::OK();
 }
 
 Status ServiceBasedActorInfoAccessor::AsyncGetAll(
     const MultiItemCallback<rpc::ActorTableData> &callback) {
   RAY_LOG(DEBUG) << "Getting all actor info.";
   rpc::GetAllActorInfoRequest request;
-  client_impl_->GetGcsRpcClient().GetAllActorInfo(
-      request, [callback](const Status &status, const rpc::GetAllActorInfoReply &reply) {
-        auto result = VectorFromProtobuf(reply.actor_table_data());
+  request.set_limit(RayConfig::instance().gcs_bulk_query_page_size());
+  FetchAllPages<rpc::ActorTableData, rpc::GetAllActorInfoRequest,
+                rpc::GetAllActorInfoReply>(
+      request,
+      [this](const rpc::GetAllActorInfoRequest &request,
+             const ClientCallback<rpc::GetAllActorInfoReply> &callback) {
+        client_impl_->GetGcsRpcClient().GetAllActorInfo(request, callback);
+      },
+      [](const rpc::GetAllActorInfoReply &reply) -> const auto & {
+        return reply.actor_table_data();
+      },
+      std::make_shared<std::vector<rpc::ActorTableData>>(),
+      [callback](const Status &status, const std::vector<rpc::ActorTableData> &result) {
         callback(status, result);
         RAY_LOG(DEBUG) << "Finished getting all actor info, status = " << status;
       });
@@ -271,12 +416,18 @@ Status ServiceBasedActorInfoAccessor::AsyncSubscribeAll(
     const SubscribeCallback<ActorID, rpc::ActorTableData> &subscribe,
     const StatusCallback &done) {
   RAY_CHECK(subscribe != nullptr);
+  {
+    absl::MutexLock lock(&mutex_);
+    subscribed_all_ = true;
+  }
   fetch_all_data_operation_ = [this, subscribe](const StatusCallback &done) {
-    auto callback = [subscribe, done](
+    auto callback = [this, subscribe, done](
                         const Status &status,
                         const std::vector<rpc::ActorTableData> &actor_info_list) {
       for (auto &actor_info : actor_info_list) {
-        subscribe(ActorID::FromBinary(actor_info.actor_id()), actor_info);
+        auto actor_id = ActorID::FromBinary(actor_info.actor_id());
+        UpdateActorCache(actor_id, actor_info);
+        subscribe(actor_id, actor_info);
       }
       if (done) {
         done(status);
@@ -286,10 +437,13 @@ Status ServiceBasedActorInfoAccessor::AsyncSubscribeAll(
   };
 
   subscribe_all_operation_ = [this, subscribe](const StatusCallback &done) {
-    auto on_subscribe = [subscribe](const std::string &id, const std::string &data) {
+    auto on_subscribe = [this, subscribe](const std::string &id,
+                                          const std::string &data) {
       ActorTableData actor_data;
       actor_data.ParseFromString(data);
-      subscribe(ActorID::FromBinary(actor_data.actor_id()), actor_data);
+      auto actor_id = ActorID::FromBinary(actor_data.actor_id());
+      UpdateActorCache(actor_id, actor_data);
+      subscribe(actor_id, actor_data);
     };
     return client_impl_->GetGcsPubSub().SubscribeAll(ACTOR_CHANNEL, on_subscribe, done);
   };
@@ -308,25 +462,30 @@ Status ServiceBasedActorInfoAccessor::AsyncSubscribe(
 
   auto fetch_data_operation = [this, actor_id,
                                subscribe](const StatusCallback &fetch_done) {
-    auto callback = [actor_id, subscribe, fetch_done](
+    auto callback = [this, actor_id, subscribe, fetch_done](
                         const Status &status,
                         const boost::optional<rpc::ActorTableData> &result) {
       if (result) {
+        UpdateActorCache(actor_id, *result);
         subscribe(actor_id, *result);
       }
       if (fetch_done) {
         fetch_done(status);
       }
     };
-    RAY_CHECK_OK(AsyncGet(actor_id, callback));
+    // Bypass the cache, the fetch is what fills it.
+    GetFromGcs(actor_id, callback);
   };
 
   auto subscribe_operation = [this, actor_id,
                               subscribe](const StatusCallback &subscribe_done) {
-    auto on_subscribe = [subscribe](const std::string &id, const std::string &data) {
+    auto on_subscribe = [this, subscribe](const std::string &id,
+                                          const std::string &data) {
       ActorTableData actor_data;
       actor_data.ParseFromString(data);
-      subscribe(ActorID::FromHex(id), actor_data);
+      auto actor_id = ActorID::FromHex(id);
+      UpdateActorCache(actor_id, actor_data);
+      subscribe(actor_id, actor_data);
     };
     return client_impl_->GetGcsPubSub().Subscribe(ACTOR_CHANNEL, actor_id.Hex(),
                                                   on_subscribe, subscribe_done);
@@ -341,9 +500,171 @@ Status ServiceBasedActorInfoAccessor::AsyncSubscribe(
       [fetch_data_operation, done](const Status &status) { fetch_data_operation(done); });
 }
 
+Status ServiceBasedActorInfoAccessor::AsyncSubscribeBatch(
+    const std::vector<ActorID> &actor_ids,
+    const SubscribeCallback<ActorID, rpc::ActorTableData> &subscribe,
+    const StatusCallback &done) {
+  RAY_CHECK(subscribe != nullptr);
+  absl::flat_hash_map<JobID, std::shared_ptr<absl::flat_hash_set<ActorID>>>
+      actors_by_job;
+  for (const auto &actor_id : actor_ids) {
+    auto &job_actors = actors_by_job[actor_id.JobId()];
+    if (job_actors == nullptr) {
+      job_actors = std::make_shared<absl::flat_hash_set<ActorID>>();
+    }
+    job_actors->insert(actor_id);
+  }
+  RAY_LOG(DEBUG) << "Subscribing update operations of " << actor_ids.size()
+                 << " actors of " << actors_by_job.size() << " jobs.";
+  if (actors_by_job.empty()) {
+    if (done) {
+      done(Status::OK());
+    }
+    return Status::OK();
+  }
+
+  auto num_pending = std::make_shared<std::atomic<size_t>>(actors_by_job.size());
+  auto on_job_done = [num_pending, done](const Status &status) {
+    if (--*num_pending == 0 && done) {
+      done(status);
+    }
+  };
+  for (const auto &entry : actors_by_job) {
+    const auto &job_id = entry.first;
+    auto job_actors = entry.second;
+    auto fetch = [this, job_id, job_actors, on_job_done]() {
+      FetchJobActors(job_id, job_actors, on_job_done);
+    };
+    bool subscribe_job = false;
+    bool fetch_now = false;
+    {
+      absl::MutexLock lock(&mutex_);
+      for (const auto &actor_id : *job_actors) {
+        batch_subscribers_[actor_id] = subscribe;
+      }
+      auto it = job_subscriptions_.find(job_id);
+      if (it == job_subscriptions_.end()) {
+        job_subscriptions_[job_id].on_subscribed.push_back(fetch);
+        subscribe_job = true;
+      } else if (!it->second.subscribed) {
+        // Look up the actors once the subscription is complete, so that no update
+        // after the lookup is missed.
+        it->second.on_subscribed.push_back(fetch);
+      } else {
+        fetch_now = true;
+      }
+    }
+    if (subscribe_job) {
+      RAY_CHECK_OK(SubscribeJobActors(job_id, [this, job_id](const Status &status) {
+        std::vector<std::function<void()>> on_subscribed;
+        {
+          absl::MutexLock lock(&mutex_);
+          auto &subscription = job_subscriptions_[job_id];
+          subscription.subscribed = true;
+          on_subscribed.swap(subscription.on_subscribed);
+        }
+        for (const auto &callback : on_subscribed) {
+          callback();
+        }
+      }));
+    } else if (fetch_now) {
+      fetch();
+    }
+  }
+  return Status::OK();
+}
+
+Status ServiceBasedActorInfoAccessor::SubscribeJobActors(const JobID &job_id,
+                                                         const StatusCallback &done) {
+  auto on_subscribe = [this](const std::string &id, const std::string &data) {
+    ActorTableData actor_data;
+    actor_data.ParseFromString(data);
+    NotifyBatchSubscriber(ActorID::FromBinary(actor_data.actor_id()), actor_data);
+  };
+  // The job ID is the suffix of the IDs of the actors of the job.
+  return client_impl_->GetGcsPubSub().SubscribeByPattern(
+      ACTOR_CHANNEL, "*" + job_id.Hex(), on_subscribe, done);
+}
+
+void ServiceBasedActorInfoAccessor::FetchJobActors(
+    const JobID &job_id, std::shared_ptr<absl::flat_hash_set<ActorID>> actor_ids,
+    const StatusCallback &done) {
+  rpc::GetAllActorInfoRequest request;
+  request.set_limit(RayConfig::instance().gcs_bulk_query_page_size());
+  request.mutable_filters()->set_job_id(job_id.Binary());
+  FetchAllPages<rpc::ActorTableData, rpc::GetAllActorInfoRequest,
+                rpc::GetAllActorInfoReply>(
+      request,
+      [this](const rpc::GetAllActorInfoRequest &request,
+             const ClientCallback<rpc::GetAllActorInfoReply> &callback) {
+        client_impl_->GetGcsRpcClient().GetAllActorInfo(request, callback);
+      },
+      [](const rpc::GetAllActorInfoReply &reply) -> const auto & {
+        return reply.actor_table_data();
+      },
+      std::make_shared<std::vector<rpc::ActorTableData>>(),
+      [this, actor_ids, done](const Status &status,
+                              const std::vector<rpc::ActorTableData> &result) {
+        for (const auto &actor_data : result) {
+          auto actor_id = ActorID::FromBinary(actor_data.actor_id());
+          if (actor_ids == nullptr || actor_ids->contains(actor_id)) {
+            NotifyBatchSubscriber(actor_id, actor_data);
+          }
+        }
+        if (done) {
+          done(status);
+        }
+      });
+}
+
+void ServiceBasedActorInfoAccessor::NotifyBatchSubscriber(
+    const ActorID &actor_id, const rpc::ActorTableData &actor_data) {
+  SubscribeCallback<ActorID, rpc::ActorTableData> subscribe;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = batch_subscribers_.find(actor_id);
+    if (it == batch_subscribers_.end()) {
+      return;
+    }
+    subscribe = it->second;
+  }
+  UpdateActorCache(actor_id, actor_data);
+  subscribe(actor_id, actor_data);
+}
+
+void ServiceBasedActorInfoAccessor::UpdateActorCache(
+    const ActorID &actor_id, const rpc::ActorTableData &actor_data) {
+  if (!cache_enabled_) {
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  // Only the subscribed actors are kept up to date.
+  if (!subscribed_all_ && !subscribe_operations_.count(actor_id) &&
+      !batch_subscribers_.contains(actor_id)) {
+    return;
+  }
+  auto it = actor_cache_.find(actor_id);
+  if (it == actor_cache_.end()) {
+    actor_cache_.emplace(actor_id, actor_data);
+  } else if (IsActorDataNotOlder(it->second, actor_data)) {
+    it->second = actor_data;
+  }
+}
+
 Status ServiceBasedActorInfoAccessor::AsyncUnsubscribe(const ActorID &actor_id) {
   RAY_LOG(DEBUG) << "Cancelling subscription to an actor, actor id = " << actor_id
                  << ", job id = " << actor_id.JobId();
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!subscribed_all_) {
+      actor_cache_.erase(actor_id);
+    }
+    if (batch_subscribers_.erase(actor_id) > 0) {
+      // The subscription to the actors of the job is shared, keep it and drop the
+      // notifications of this actor.
+      return Status::OK();
+    }
+  }
   auto status = client_impl_->GetGcsPubSub().Unsubscribe(ACTOR_CHANNEL, actor_id.Hex());
   absl::MutexLock lock(&mutex_);
   subscribe_operations_.erase(actor_id);
@@ -370,6 +691,12 @@ void ServiceBasedActorInfoAccessor::AsyncResubscribe(bool is_pubsub_server_resta
         fetch_all_data_operation_(fetch_all_done);
       }));
     }
+    for (const auto &entry : job_subscriptions_) {
+      const auto job_id = entry.first;
+      RAY_CHECK_OK(SubscribeJobActors(job_id, [this, job_id](const Status &status) {
+        FetchJobActors(job_id, nullptr, nullptr);
+      }));
+    }
     for (auto &item : subscribe_operations_) {
       auto &actor_id = item.first;
       RAY_CHECK_OK(item.second([this, actor_id](const Status &status) {
@@ -390,10 +717,19 @@ void ServiceBasedActorInfoAccessor::AsyncResubscribe(bool is_pubsub_server_resta
     for (auto &item : fetch_data_operations_) {
       item.second(nullptr);
     }
+    for (const auto &entry : job_subscriptions_) {
+      FetchJobActors(entry.first, nullptr, nullptr);
+    }
   }
 }
 
 bool ServiceBasedActorInfoAccessor::IsActorUnsubscribed(const ActorID &actor_id) {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (batch_subscribers_.contains(actor_id)) {
+      return false;
+    }
+  }
   return client_impl_->GetGcsPubSub().IsUnsubscribed(ACTOR_CHANNEL, actor_id.Hex());
 }
 
@@ -492,13 +828,18 @@ Status ServiceBasedNodeInfoAccessor::AsyncGetAll(
     const MultiItemCallback<GcsNodeInfo> &callback) {
   RAY_LOG(DEBUG) << "Getting information of all nodes.";
   rpc::GetAllNodeInfoRequest request;
-  client_impl_->GetGcsRpcClient().GetAllNodeInfo(
-      request, [callback](const Status &status, const rpc::GetAllNodeInfoReply &reply) {
-        std::vector<GcsNodeInfo> result;
-        result.reserve((reply.node_info_list_size()));
-        for (int index = 0; index < reply.node_info_list_size(); ++index) {
-          result.emplace_back(reply.node_info_list(index));
-        }
+  request.set_limit(RayConfig::instance().gcs_bulk_query_page_size());
+  FetchAllPages<GcsNodeInfo, rpc::GetAllNodeInfoRequest, rpc::GetAllNodeInfoReply>(
+      request,
+      [this](const rpc::GetAllNodeInfoRequest &request,
+             const ClientCallback<rpc::GetAllNodeInfoReply> &callback) {
+        client_impl_->GetGcsRpcClient().GetAllNodeInfo(request, callback);
+      },
+      [](const rpc::GetAllNodeInfoReply &reply) -> const auto & {
+        return reply.node_info_list();
+      },
+      std::make_shared<std::vector<GcsNodeInfo>>(),
+      [callback](const Status &status, const std::vector<GcsNodeInfo> &result) {
         callback(status, result);
         RAY_LOG(DEBUG) << "Finished getting information of all nodes, status = "
                        << status;
@@ -707,6 +1048,21 @@ Status ServiceBasedNodeResourceInfoAccessor::AsyncGetAllAvailableResources(
   return Status::OK();
 }
 
+Status ServiceBasedNodeResourceInfoAccessor::AsyncGetAllTotalResources(
+    const MultiItemCallback<rpc::TotalResources> &callback) {
+  rpc::GetAllTotalResourcesRequest request;
+  client_impl_->GetGcsRpcClient().GetAllTotalResources(
+      request,
+      [callback](const Status &status, const rpc::GetAllTotalResourcesReply &reply) {
+        std::vector<rpc::TotalResources> result =
+            VectorFromProtobuf(reply.resources_list());
+        callback(status, result);
+        RAY_LOG(DEBUG) << "Finished getting total resources of all nodes, status = "
+                       << status;
+      });
+  return Status::OK();
+}
+
 Status ServiceBasedNodeResourceInfoAccessor::AsyncUpdateResources(
     const NodeID &node_id, const ResourceMap &resources, const StatusCallback &callback) {
   RAY_LOG(DEBUG) << "Updating node resources, node id = " << node_id;
@@ -1626,16 +1982,69 @@ Status ServiceBasedInternalKVAccessor::AsyncInternalKVKeys(
     const OptionalItemCallback<std::vector<std::string>> &callback) {
   rpc::InternalKVKeysRequest req;
   req.set_prefix(prefix);
-  client_impl_->GetGcsRpcClient().InternalKVKeys(
-      req, [callback](const Status &status, const rpc::InternalKVKeysReply &reply) {
+  req.set_limit(RayConfig::instance().gcs_bulk_query_page_size());
+  FetchAllPages<std::string, rpc::InternalKVKeysRequest, rpc::InternalKVKeysReply>(
+      req,
+      [this](const rpc::InternalKVKeysRequest &request,
+             const ClientCallback<rpc::InternalKVKeysReply> &callback) {
+        client_impl_->GetGcsRpcClient().InternalKVKeys(request, callback);
+      },
+      [](const rpc::InternalKVKeysReply &reply) -> const auto & {
+        return reply.results();
+      },
+      std::make_shared<std::vector<std::string>>(),
+      [callback](const Status &status, const std::vector<std::string> &result) {
         if (!status.ok()) {
           callback(status, boost::none);
         } else {
-          callback(status, VectorFromProtobuf(reply.results()));
+          callback(status, result);
         }
       });
   return Status::OK();
 }
 
+Status ServiceBasedInternalKVAccessor::AsyncInternalKVMultiGet(
+    const std::vector<std::string> &keys,
+    const OptionalItemCallback<std::unordered_map<std::string, std::string>> &callback) {
+  rpc::InternalKVMultiGetRequest req;
+  for (const auto &key : keys) {
+    req.add_keys(key);
+  }
+  client_impl_->GetGcsRpcClient().InternalKVMultiGet(
+      req, [keys, callback](const Status &status,
+                            const rpc::InternalKVMultiGetReply &reply) {
+        if (!status.ok() || reply.found_size() != static_cast<int>(keys.size())) {
+          callback(status, boost::none);
+          return;
+        }
+        std::unordered_map<std::string, std::string> values;
+        int value_index = 0;
+        for (size_t i = 0; i < keys.size(); i++) {
+          if (reply.found(i)) {
+            values[keys[i]] = reply.values(value_index++);
+          }
+        }
+        callback(status, std::move(values));
+      });
+  return Status::OK();
+}
+
+Status ServiceBasedInternalKVAccessor::AsyncInternalKVMultiPut(
+    const std::unordered_map<std::string, std::string> &kvs, bool overwrite,
+    const OptionalItemCallback<int> &callback) {
+  rpc::InternalKVMultiPutRequest req;
+  for (const auto &kv : kvs) {
+    req.add_keys(kv.first);
+    req.add_values(kv.second);
+  }
+  req.set_overwrite(overwrite);
+  client_impl_->GetGcsRpcClient().InternalKVMultiPut(
+      req,
+      [callback](const Status &status, const rpc::InternalKVMultiPutReply &reply) {
+        callback(status, reply.added_num());
+      });
+  return Status::OK();
+}
+
 }  // namespace gcs
 }  // namespace ray
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "ray/common/task/task_spec.h"
 #include "ray/gcs/accessor.h"
 #include "ray/util/sequencer.h"
@@ -52,6 +54,13 @@ class ServiceBasedJobInfoAccessor : public JobInfoAccessor {
   Status AsyncGetNextJobID(const ItemCallback<JobID> &callback) override;
 
  private:
+  /// Fetch all the jobs from the GCS server.
+  void FetchAllJobs(const MultiItemCallback<rpc::JobTableData> &callback);
+
+  /// Keep the data of a job in `job_cache_`, unless the cached data is newer.
+  void UpdateJobCache(const JobID &job_id, const rpc::JobTableData &job_data)
+      LOCKS_EXCLUDED(mutex_);
+
   /// Save the fetch data operation in this function, so we can call it again when GCS
   /// server restarts from a failure.
   FetchDataOperation fetch_all_data_operation_;
@@ -60,6 +69,18 @@ class ServiceBasedJobInfoAccessor : public JobInfoAccessor {
   /// server restarts from a failure.
   SubscribeOperation subscribe_operation_;
 
+  /// Whether `AsyncGetAll` is served from `job_cache_` once it is complete.
+  const bool cache_enabled_;
+
+  absl::Mutex mutex_;
+
+  /// The data of all the jobs, kept up to date through the subscription to all jobs.
+  absl::flat_hash_map<JobID, rpc::JobTableData> job_cache_ GUARDED_BY(mutex_);
+
+  /// Whether `job_cache_` has all the jobs, i.e. the first fetch after subscribing to
+  /// all jobs has finished.
+  bool job_cache_complete_ GUARDED_BY(mutex_) = false;
+
   ServiceBasedGcsClient *client_impl_;
 };
 
@@ -102,6 +123,14 @@ class ServiceBasedActorInfoAccessor : public ActorInfoAccessor {
                         const SubscribeCallback<ActorID, rpc::ActorTableData> &subscribe,
                         const StatusCallback &done) override;
 
+  /// Subscribe to a batch of actors. Instead of a subscription and a lookup per actor,
+  /// this subscribes once to all the actors of each job in the batch and filters the
+  /// notifications locally, and looks up the actors of each job with one query.
+  Status AsyncSubscribeBatch(
+      const std::vector<ActorID> &actor_ids,
+      const SubscribeCallback<ActorID, rpc::ActorTableData> &subscribe,
+      const StatusCallback &done) override;
+
   Status AsyncUnsubscribe(const ActorID &actor_id) override;
 
   void AsyncResubscribe(bool is_pubsub_server_restarted) override;
@@ -109,6 +138,39 @@ class ServiceBasedActorInfoAccessor : public ActorInfoAccessor {
   bool IsActorUnsubscribed(const ActorID &actor_id) override;
 
  private:
+  /// The subscription to all the actors of a job, shared by the actors subscribed to
+  /// through `AsyncSubscribeBatch`.
+  struct JobActorsSubscription {
+    /// Whether the subscription is complete.
+    bool subscribed = false;
+    /// Callbacks to run once the subscription is complete.
+    std::vector<std::function<void()>> on_subscribed;
+  };
+
+  /// Subscribe to the notifications of all the actors of a job, and pass the ones of
+  /// batch subscribed actors to their callbacks.
+  Status SubscribeJobActors(const JobID &job_id, const StatusCallback &done);
+
+  /// Look up the actors of a job in one query, and pass the given actors to their
+  /// callbacks. If `actor_ids` is empty, pass all the batch subscribed actors.
+  void FetchJobActors(const JobID &job_id,
+                      std::shared_ptr<absl::flat_hash_set<ActorID>> actor_ids,
+                      const StatusCallback &done);
+
+  /// Pass an actor notification to the callback of a batch subscribed actor, if any.
+  void NotifyBatchSubscriber(const ActorID &actor_id,
+                             const rpc::ActorTableData &actor_data)
+      LOCKS_EXCLUDED(mutex_);
+
+  /// Look up an actor from the GCS server, bypassing the cache.
+  void GetFromGcs(const ActorID &actor_id,
+                  const OptionalItemCallback<rpc::ActorTableData> &callback);
+
+  /// Keep the data of a subscribed actor in `actor_cache_`, unless the cached data is
+  /// newer.
+  void UpdateActorCache(const ActorID &actor_id, const rpc::ActorTableData &actor_data)
+      LOCKS_EXCLUDED(mutex_);
+
   /// Save the subscribe operation in this function, so we can call it again when PubSub
   /// server restarts from a failure.
   SubscribeOperation subscribe_all_operation_;
@@ -128,6 +190,24 @@ class ServiceBasedActorInfoAccessor : public ActorInfoAccessor {
   std::unordered_map<ActorID, FetchDataOperation> fetch_data_operations_
       GUARDED_BY(mutex_);
 
+  /// The callbacks of the actors subscribed to through `AsyncSubscribeBatch`.
+  absl::flat_hash_map<ActorID, SubscribeCallback<ActorID, rpc::ActorTableData>>
+      batch_subscribers_ GUARDED_BY(mutex_);
+
+  /// The shared subscriptions to the actors of each job.
+  absl::flat_hash_map<JobID, JobActorsSubscription> job_subscriptions_
+      GUARDED_BY(mutex_);
+
+  /// Whether `AsyncGet` is served from `actor_cache_` when possible.
+  const bool cache_enabled_;
+
+  /// Whether all actors are subscribed to.
+  bool subscribed_all_ GUARDED_BY(mutex_) = false;
+
+  /// The latest data of the subscribed actors, kept up to date by their notifications.
+  /// An actor leaves the cache when it is unsubscribed from.
+  absl::flat_hash_map<ActorID, rpc::ActorTableData> actor_cache_ GUARDED_BY(mutex_);
+
   ServiceBasedGcsClient *client_impl_;
 };
 
@@ -218,6 +298,9 @@ class ServiceBasedNodeResourceInfoAccessor : public NodeResourceInfoAccessor {
   Status AsyncGetAllAvailableResources(
       const MultiItemCallback<rpc::AvailableResources> &callback) override;
 
+  Status AsyncGetAllTotalResources(
+      const MultiItemCallback<rpc::TotalResources> &callback) override;
+
   Status AsyncUpdateResources(const NodeID &node_id, const ResourceMap &resources,
                               const StatusCallback &callback) override;
 
@@ -490,6 +573,13 @@ class ServiceBasedInternalKVAccessor : public InternalKVAccessor {
                                const OptionalItemCallback<bool> &callback) override;
   Status AsyncInternalKVDel(const std::string &key,
                             const StatusCallback &callback) override;
+  Status AsyncInternalKVMultiGet(
+      const std::vector<std::string> &keys,
+      const OptionalItemCallback<std::unordered_map<std::string, std::string>>
+          &callback) override;
+  Status AsyncInternalKVMultiPut(const std::unordered_map<std::string, std::string> &kvs,
+                                 bool overwrite,
+                                 const OptionalItemCallback<int> &callback) override;
 
  private:
   ServiceBasedGcsClient *client_impl_;
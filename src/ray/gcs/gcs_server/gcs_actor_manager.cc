@@ -18,6 +18,7 @@
 #include <utility>
 
 #include "ray/common/ray_config.h"
+#include "ray/gcs/gcs_server/gcs_pagination.h"
 #include "ray/gcs/pb_util.h"
 #include "ray/stats/stats.h"
 
@@ -30,6 +31,23 @@ bool is_uuid(const std::string &str) {
   return regex_match(str, e);  // note: case sensitive now
 }
 
+/// Whether an actor matches the filters of a GetAllActorInfo request.
+static bool MatchesFilters(const rpc::ActorTableData &actor,
+                           const rpc::GetAllActorInfoRequest::Filters &filters) {
+  if (!filters.job_id().empty() && actor.job_id() != filters.job_id()) {
+    return false;
+  }
+  if (!filters.node_id().empty() && actor.address().raylet_id() != filters.node_id()) {
+    return false;
+  }
+  if (filters.states_size() > 0 &&
+      std::find(filters.states().begin(), filters.states().end(), actor.state()) ==
+          filters.states().end()) {
+    return false;
+  }
+  return true;
+}
+
 NodeID GcsActor::GetNodeID() const {
   const auto &raylet_id_binary = actor_table_data_.address().raylet_id();
   if (raylet_id_binary.empty()) {
@@ -112,6 +130,8 @@ GcsActorManager::GcsActorManager(
       destroy_owned_placement_group_if_needed_(destroy_owned_placement_group_if_needed),
       get_ray_namespace_(get_ray_namespace),
       runtime_env_manager_(runtime_env_manager),
+      scheduling_batch_size_(RayConfig::instance().gcs_actor_scheduling_batch_size()),
+      recovery_batch_size_(RayConfig::instance().gcs_actor_recovery_batch_size()),
       run_delayed_(run_delayed),
       actor_gc_delay_(RayConfig::instance().gcs_actor_table_min_duration_ms()) {
   RAY_CHECK(worker_client_factory_);
@@ -196,11 +216,25 @@ void GcsActorManager::HandleGetAllActorInfo(const rpc::GetAllActorInfoRequest &r
   RAY_LOG(DEBUG) << "Getting all actor info.";
   ++counts_[CountType::GET_ALL_ACTOR_INFO_REQUEST];
   if (request.show_dead_jobs() == false) {
+    // Only the actors of the requested page are copied into the reply.
+    std::vector<std::pair<std::string, const rpc::ActorTableData *>> entries;
+    entries.reserve(registered_actors_.size() + destroyed_actors_.size());
     for (const auto &iter : registered_actors_) {
-      reply->add_actor_table_data()->CopyFrom(iter.second->GetActorTableData());
+      const auto &actor = iter.second->GetActorTableData();
+      if (MatchesFilters(actor, request.filters())) {
+        entries.emplace_back(iter.first.Binary(), &actor);
+      }
     }
     for (const auto &iter : destroyed_actors_) {
-      reply->add_actor_table_data()->CopyFrom(iter.second->GetActorTableData());
+      const auto &actor = iter.second->GetActorTableData();
+      if (MatchesFilters(actor, request.filters())) {
+        entries.emplace_back(iter.first.Binary(), &actor);
+      }
+    }
+    for (const auto *actor : SelectPage(std::move(entries), request.page_token(),
+                                        request.limit(),
+                                        reply->mutable_next_page_token())) {
+      reply->add_actor_table_data()->CopyFrom(*actor);
     }
     RAY_LOG(DEBUG) << "Finished getting all actor info.";
     GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
@@ -211,10 +245,19 @@ void GcsActorManager::HandleGetAllActorInfo(const rpc::GetAllActorInfoRequest &r
   // We don't maintain an in-memory cache of all actors which belong to dead
   // jobs, so fetch it from redis.
   Status status = gcs_table_storage_->ActorTable().GetAll(
-      [reply, send_reply_callback](
+      [request, reply, send_reply_callback](
           const std::unordered_map<ActorID, rpc::ActorTableData> &result) {
+        std::vector<std::pair<std::string, const rpc::ActorTableData *>> entries;
+        entries.reserve(result.size());
         for (const auto &pair : result) {
-          reply->add_actor_table_data()->CopyFrom(pair.second);
+          if (MatchesFilters(pair.second, request.filters())) {
+            entries.emplace_back(pair.first.Binary(), &pair.second);
+          }
+        }
+        for (const auto *actor : SelectPage(std::move(entries), request.page_token(),
+                                            request.limit(),
+                                            reply->mutable_next_page_token())) {
+          reply->add_actor_table_data()->CopyFrom(*actor);
         }
         GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
         RAY_LOG(DEBUG) << "Finished getting all actor info.";
@@ -557,6 +600,7 @@ void GcsActorManager::DestroyActor(const ActorID &actor_id) {
     RAY_LOG(INFO) << "Tried to destroy actor that does not exist " << actor_id;
     return;
   }
+  gcs_actor_scheduler_->ReleaseStandbyWorker(actor_id);
   const auto &task_id = it->second->GetCreationTaskSpecification().TaskId();
   it->second->GetMutableActorTableData()->mutable_task_spec()->Clear();
   it->second->GetMutableActorTableData()->set_timestamp(current_sys_time_ms());
@@ -666,7 +710,7 @@ absl::flat_hash_set<ActorID> GcsActorManager::GetUnresolvedActorsByOwnerWorker(
 }
 
 void GcsActorManager::CollectStats() const {
-  stats::PendingActors.Record(pending_actors_.size());
+  stats::PendingActors.Record(pending_actors_.size() + actors_to_schedule_.size());
 }
 
 void GcsActorManager::OnWorkerDead(const ray::NodeID &node_id,
@@ -838,6 +882,7 @@ void GcsActorManager::ReconstructActor(
         }));
     gcs_actor_scheduler_->Schedule(actor);
   } else {
+    gcs_actor_scheduler_->ReleaseStandbyWorker(actor_id);
     // Remove actor from `named_actors_` if its name is not empty.
     if (!actor->GetName().empty()) {
       auto namespace_it = named_actors_.find(actor->GetRayNamespace());
@@ -916,6 +961,15 @@ void GcsActorManager::OnActorCreationSuccess(const std::shared_ptr<GcsActor> &ac
   RAY_CHECK(!node_id.IsNil());
   RAY_CHECK(created_actors_[node_id].emplace(worker_id, actor_id).second);
 
+  // Keep a standby worker on another node, so that the actor restarts without waiting
+  // for a new worker if it fails.
+  if (RayConfig::instance().gcs_actor_standby_worker_enabled() &&
+      (mutable_actor_table_data->max_restarts() == -1 ||
+       static_cast<int64_t>(mutable_actor_table_data->num_restarts()) <
+           mutable_actor_table_data->max_restarts())) {
+    gcs_actor_scheduler_->PrepareStandbyWorker(actor);
+  }
+
   auto actor_table_data = *mutable_actor_table_data;
   // The backend storage is reliable in the future, so the status must be ok.
   RAY_CHECK_OK(gcs_table_storage_->ActorTable().Put(
@@ -944,8 +998,36 @@ void GcsActorManager::SchedulePendingActors() {
 
   RAY_LOG(DEBUG) << "Scheduling actor creation tasks, size = " << pending_actors_.size();
   auto actors = std::move(pending_actors_);
+  pending_actors_.clear();
+  if (scheduling_batch_size_ == 0) {
+    gcs_actor_scheduler_->ScheduleBatch(std::move(actors));
+    return;
+  }
+
   for (auto &actor : actors) {
-    gcs_actor_scheduler_->Schedule(std::move(actor));
+    actors_to_schedule_.emplace_back(std::move(actor));
+  }
+  if (!schedule_batch_posted_) {
+    ScheduleActorsBatch();
+  }
+}
+
+void GcsActorManager::ScheduleActorsBatch() {
+  schedule_batch_posted_ = false;
+  // Actors that fail to schedule go back to `pending_actors_` through
+  // `OnActorCreationFailed`, so they are not retried by this drain.
+  std::vector<std::shared_ptr<GcsActor>> batch;
+  while (batch.size() < scheduling_batch_size_ && !actors_to_schedule_.empty()) {
+    batch.emplace_back(std::move(actors_to_schedule_.front()));
+    actors_to_schedule_.pop_front();
+  }
+  gcs_actor_scheduler_->ScheduleBatch(std::move(batch));
+  if (!actors_to_schedule_.empty()) {
+    RAY_LOG(DEBUG) << "Deferring scheduling of " << actors_to_schedule_.size()
+                   << " actors to the next batch.";
+    schedule_batch_posted_ = true;
+    run_delayed_([this] { ScheduleActorsBatch(); },
+                 boost::posix_time::milliseconds(0));
   }
 }
 
@@ -1009,12 +1091,44 @@ void GcsActorManager::Initialize(const GcsInitData &gcs_init_data) {
       // We should not reschedule actors in state of `ALIVE`.
       // We could not reschedule actors in state of `DEPENDENCIES_UNREADY` because the
       // dependencies of them may not have been resolved yet.
+      if (recovery_batch_size_ > 0) {
+        actors_to_reschedule_.emplace_back(actor);
+        continue;
+      }
       RAY_LOG(INFO) << "Rescheduling a non-alive actor, actor id = "
                     << actor->GetActorID() << ", state = " << actor->GetState()
                     << ", job id = " << actor->GetActorID().JobId();
       gcs_actor_scheduler_->Reschedule(actor);
     }
   }
+  if (!actors_to_reschedule_.empty()) {
+    RAY_LOG(INFO) << "Rescheduling " << actors_to_reschedule_.size()
+                  << " non-alive actors in batches of " << recovery_batch_size_;
+    run_delayed_([this] { RescheduleActorsBatch(); }, boost::posix_time::milliseconds(0));
+  }
+}
+
+void GcsActorManager::RescheduleActorsBatch() {
+  uint64_t num_rescheduled = 0;
+  while (num_rescheduled < recovery_batch_size_ && !actors_to_reschedule_.empty()) {
+    auto actor = std::move(actors_to_reschedule_.front());
+    actors_to_reschedule_.pop_front();
+    // The actor may have been destroyed or restarted since it was recovered.
+    auto iter = registered_actors_.find(actor->GetActorID());
+    if (iter == registered_actors_.end() || iter->second != actor ||
+        (actor->GetState() != ray::rpc::ActorTableData::PENDING_CREATION &&
+         actor->GetState() != ray::rpc::ActorTableData::RESTARTING)) {
+      continue;
+    }
+    RAY_LOG(INFO) << "Rescheduling a non-alive actor, actor id = "
+                  << actor->GetActorID() << ", state = " << actor->GetState()
+                  << ", job id = " << actor->GetActorID().JobId();
+    gcs_actor_scheduler_->Reschedule(actor);
+    num_rescheduled++;
+  }
+  if (!actors_to_reschedule_.empty()) {
+    run_delayed_([this] { RescheduleActorsBatch(); }, boost::posix_time::milliseconds(0));
+  }
 }
 
 void GcsActorManager::OnJobFinished(const JobID &job_id) {
@@ -1185,9 +1299,17 @@ void GcsActorManager::CancelActorInScheduling(const std::shared_ptr<GcsActor> &a
                                      return actor->GetActorID() == actor_id;
                                    });
 
+    auto to_schedule_it =
+        std::find_if(actors_to_schedule_.begin(), actors_to_schedule_.end(),
+                     [actor_id](const std::shared_ptr<GcsActor> &actor) {
+                       return actor->GetActorID() == actor_id;
+                     });
+
     // The actor was pending scheduling. Remove it from the queue.
     if (pending_it != pending_actors_.end()) {
       pending_actors_.erase(pending_it);
+    } else if (to_schedule_it != actors_to_schedule_.end()) {
+      actors_to_schedule_.erase(to_schedule_it);
     } else {
       // When actor creation request of this actor id is pending in raylet,
       // it doesn't responds, and the actor should be still in leasing state.
@@ -1219,7 +1341,8 @@ std::string GcsActorManager::DebugString() const {
          << ", Destroyed actors count: " << destroyed_actors_.size()
          << ", Named actors count: " << num_named_actors
          << ", Unresolved actors count: " << unresolved_actors_.size()
-         << ", Pending actors count: " << pending_actors_.size()
+         << ", Pending actors count: "
+         << pending_actors_.size() + actors_to_schedule_.size()
          << ", Created actors count: " << created_actors_.size() << "}";
   return stream.str();
 }
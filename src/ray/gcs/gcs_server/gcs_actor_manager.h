@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <deque>
 #include <utility>
 
 #include "absl/container/flat_hash_map.h"
@@ -263,7 +264,9 @@ class GcsActorManager : public rpc::ActorInfoHandler {
 
   /// Schedule actors in the `pending_actors_` queue.
   /// This method should be called when new nodes are registered or resources
-  /// change.
+  /// change. If `gcs_actor_scheduling_batch_size` is set, at most that many actors
+  /// are handed to the scheduler per event loop turn so that actor RPCs are not
+  /// starved while a large backlog is drained.
   void SchedulePendingActors();
 
   /// Handle a node death. This will restart all actors associated with the
@@ -305,6 +308,8 @@ class GcsActorManager : public rpc::ActorInfoHandler {
 
   /// Initialize with the gcs tables data synchronously.
   /// This should be called when GCS server restarts after a failure.
+  /// If `gcs_actor_recovery_batch_size` is set, the actors that were being scheduled
+  /// are rescheduled in batches from the event loop, starting after this returns.
   ///
   /// \param gcs_init_data.
   void Initialize(const GcsInitData &gcs_init_data);
@@ -438,6 +443,14 @@ class GcsActorManager : public rpc::ActorInfoHandler {
   void CancelActorInScheduling(const std::shared_ptr<GcsActor> &actor,
                                const TaskID &task_id);
 
+  /// Hand the next batch of `actors_to_schedule_` to the scheduler, and post the
+  /// remainder to the event loop.
+  void ScheduleActorsBatch();
+
+  /// Reschedule the next batch of `actors_to_reschedule_`, and post the remainder to
+  /// the event loop.
+  void RescheduleActorsBatch();
+
   /// Callbacks of pending `RegisterActor` requests.
   /// Maps actor ID to actor registration callbacks, which is used to filter duplicated
   /// messages from a driver/worker caused by some network problems.
@@ -468,6 +481,15 @@ class GcsActorManager : public rpc::ActorInfoHandler {
       unresolved_actors_;
   /// The pending actors which will not be scheduled until there's a resource change.
   std::vector<std::shared_ptr<GcsActor>> pending_actors_;
+  /// Pending actors that were taken off `pending_actors_` by
+  /// `SchedulePendingActors` but not yet handed to the scheduler because the drain
+  /// is batched.
+  std::deque<std::shared_ptr<GcsActor>> actors_to_schedule_;
+  /// Whether a batch of `actors_to_schedule_` is already posted to the event loop.
+  bool schedule_batch_posted_ = false;
+  /// Actors recovered by `Initialize` that are not yet rescheduled because the
+  /// recovery is batched.
+  std::deque<std::shared_ptr<GcsActor>> actors_to_reschedule_;
   /// Map contains the relationship of node and created actors. Each node ID
   /// maps to a map from worker ID to the actor created on that worker.
   absl::flat_hash_map<NodeID, absl::flat_hash_map<WorkerID, ActorID>> created_actors_;
@@ -493,6 +515,11 @@ class GcsActorManager : public rpc::ActorInfoHandler {
   /// necessary for actor creation.
   std::function<std::string(const JobID &)> get_ray_namespace_;
   RuntimeEnvManager &runtime_env_manager_;
+  /// Maximum number of actors to schedule per event loop turn. 0 means unlimited.
+  const uint64_t scheduling_batch_size_;
+  /// Maximum number of recovered actors to reschedule per event loop turn. 0 means
+  /// they are all rescheduled by `Initialize`.
+  const uint64_t recovery_batch_size_;
   /// Run a function on a delay. This is useful for guaranteeing data will be
   /// accessible for a minimum amount of time.
   std::function<void(std::function<void(void)>, boost::posix_time::milliseconds)>
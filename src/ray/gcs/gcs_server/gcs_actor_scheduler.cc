@@ -17,6 +17,7 @@
 #include "ray/common/asio/asio_util.h"
 #include "ray/common/asio/instrumented_io_context.h"
 #include "ray/common/ray_config.h"
+#include "ray/common/span_tracer.h"
 #include "ray/gcs/gcs_server/gcs_actor_manager.h"
 #include "src/ray/protobuf/node_manager.pb.h"
 
@@ -46,6 +47,19 @@ GcsActorScheduler::GcsActorScheduler(
 void GcsActorScheduler::Schedule(std::shared_ptr<GcsActor> actor) {
   RAY_CHECK(actor->GetNodeID().IsNil() && actor->GetWorkerID().IsNil());
 
+  // Create the actor on its standby worker directly if it has one.
+  auto standby_iter = standby_workers_.find(actor->GetActorID());
+  if (standby_iter != standby_workers_.end()) {
+    const auto reply = std::move(standby_iter->second);
+    standby_workers_.erase(standby_iter);
+    const auto worker_id = WorkerID::FromBinary(reply.worker_address().worker_id());
+    standby_worker_to_actor_.erase(worker_id);
+    RAY_LOG(INFO) << "Creating actor " << actor->GetActorID() << " on its standby worker "
+                  << worker_id << ", job id = " << actor->GetActorID().JobId();
+    HandleWorkerLeaseGrantedReply(actor, reply);
+    return;
+  }
+
   // Select a node to lease worker for the actor.
   const auto &node = SelectNode(actor);
 
@@ -121,6 +135,17 @@ std::vector<ActorID> GcsActorScheduler::CancelOnNode(const NodeID &node_id) {
     }
   }
 
+  // The standby workers on the node are gone with it.
+  for (auto iter = standby_workers_.begin(); iter != standby_workers_.end();) {
+    const auto &worker_address = iter->second.worker_address();
+    if (NodeID::FromBinary(worker_address.raylet_id()) == node_id) {
+      standby_worker_to_actor_.erase(WorkerID::FromBinary(worker_address.worker_id()));
+      standby_workers_.erase(iter++);
+    } else {
+      ++iter;
+    }
+  }
+
   raylet_client_pool_->Disconnect(node_id);
 
   return actor_ids;
@@ -154,6 +179,14 @@ void GcsActorScheduler::CancelOnLeasing(const NodeID &node_id, const ActorID &ac
 
 ActorID GcsActorScheduler::CancelOnWorker(const NodeID &node_id,
                                           const WorkerID &worker_id) {
+  // A standby worker is not assigned to its actor yet, just forget it.
+  auto standby_iter = standby_worker_to_actor_.find(worker_id);
+  if (standby_iter != standby_worker_to_actor_.end()) {
+    standby_workers_.erase(standby_iter->second);
+    standby_worker_to_actor_.erase(standby_iter);
+    return ActorID::Nil();
+  }
+
   // Remove the worker from creating map and return ID of the actor associated with the
   // removed worker if exist, else return NilID.
   ActorID assigned_actor_id;
@@ -206,6 +239,111 @@ void GcsActorScheduler::ReleaseUnusedWorkers(
   }
 }
 
+void GcsActorScheduler::PrepareStandbyWorker(std::shared_ptr<GcsActor> actor) {
+  const auto &actor_id = actor->GetActorID();
+  if (standby_workers_.contains(actor_id) ||
+      actors_leasing_standby_workers_.contains(actor_id)) {
+    return;
+  }
+  // The standby worker must survive the failure of the node of the actor.
+  std::vector<std::shared_ptr<rpc::GcsNodeInfo>> candidate_nodes;
+  for (const auto &entry : gcs_node_manager_.GetAllAliveNodes()) {
+    if (entry.first != actor->GetNodeID() &&
+        !nodes_of_releasing_unused_workers_.contains(entry.first)) {
+      candidate_nodes.emplace_back(entry.second);
+    }
+  }
+  if (candidate_nodes.empty()) {
+    return;
+  }
+  static std::mt19937_64 gen_(
+      std::chrono::high_resolution_clock::now().time_since_epoch().count());
+  std::uniform_int_distribution<size_t> distribution(0, candidate_nodes.size() - 1);
+  const auto &node = candidate_nodes[distribution(gen_)];
+  RAY_LOG(DEBUG) << "Leasing standby worker from node "
+                 << NodeID::FromBinary(node->node_id()) << " for actor " << actor_id;
+
+  rpc::Address remote_address;
+  remote_address.set_raylet_id(node->node_id());
+  remote_address.set_ip_address(node->node_manager_address());
+  remote_address.set_port(node->node_manager_port());
+  auto lease_client = GetOrConnectLeaseClient(remote_address);
+  actors_leasing_standby_workers_.insert(actor_id);
+  lease_client->RequestWorkerLease(
+      actor->GetCreationTaskSpecification(),
+      [this, actor](const Status &status, const rpc::RequestWorkerLeaseReply &reply) {
+        HandleStandbyWorkerLeaseReply(actor, status, reply);
+      },
+      report_worker_backlog_ ? 0 : -1);
+}
+
+void GcsActorScheduler::ReleaseStandbyWorker(const ActorID &actor_id) {
+  // A lease still in flight is returned when its reply arrives.
+  actors_leasing_standby_workers_.erase(actor_id);
+  auto iter = standby_workers_.find(actor_id);
+  if (iter == standby_workers_.end()) {
+    return;
+  }
+  const auto &worker_address = iter->second.worker_address();
+  standby_worker_to_actor_.erase(WorkerID::FromBinary(worker_address.worker_id()));
+  ReturnStandbyWorker(worker_address);
+  standby_workers_.erase(iter);
+}
+
+void GcsActorScheduler::HandleStandbyWorkerLeaseReply(
+    std::shared_ptr<GcsActor> actor, const Status &status,
+    const rpc::RequestWorkerLeaseReply &reply) {
+  const auto &actor_id = actor->GetActorID();
+  const auto &worker_address = reply.worker_address();
+  const bool granted = status.ok() && !worker_address.raylet_id().empty();
+  if (actors_leasing_standby_workers_.erase(actor_id) == 0) {
+    // The standby worker was released while leasing it.
+    if (granted) {
+      ReturnStandbyWorker(worker_address);
+    }
+    return;
+  }
+  if (!granted) {
+    RAY_LOG(DEBUG) << "Failed to lease a standby worker for actor " << actor_id
+                   << ", status = " << status;
+    return;
+  }
+  // The actor may have failed over to the node of the standby worker meanwhile.
+  if (actor->GetState() != rpc::ActorTableData::ALIVE ||
+      NodeID::FromBinary(worker_address.raylet_id()) == actor->GetNodeID()) {
+    ReturnStandbyWorker(worker_address);
+    return;
+  }
+  RAY_LOG(INFO) << "Leased standby worker "
+                << WorkerID::FromBinary(worker_address.worker_id()) << " at node "
+                << NodeID::FromBinary(worker_address.raylet_id()) << " for actor "
+                << actor_id << ", job id = " << actor_id.JobId();
+  standby_worker_to_actor_[WorkerID::FromBinary(worker_address.worker_id())] = actor_id;
+  standby_workers_.emplace(actor_id, reply);
+}
+
+void GcsActorScheduler::ReturnStandbyWorker(const rpc::Address &worker_address) {
+  auto maybe_node =
+      gcs_node_manager_.GetAliveNode(NodeID::FromBinary(worker_address.raylet_id()));
+  if (!maybe_node.has_value()) {
+    return;
+  }
+  const auto &node = maybe_node.value();
+  rpc::Address remote_address;
+  remote_address.set_raylet_id(node->node_id());
+  remote_address.set_ip_address(node->node_manager_address());
+  remote_address.set_port(node->node_manager_port());
+  auto lease_client = GetOrConnectLeaseClient(remote_address);
+  // The worker was started for the actor, so it is not reused for other tasks.
+  const auto worker_id = WorkerID::FromBinary(worker_address.worker_id());
+  auto status = lease_client->ReturnWorker(worker_address.port(), worker_id,
+                                           /*disconnect_worker=*/true);
+  if (!status.ok()) {
+    RAY_LOG(WARNING) << "Failed to return standby worker " << worker_id << ": "
+                     << status;
+  }
+}
+
 void GcsActorScheduler::LeaseWorkerFromNode(std::shared_ptr<GcsActor> actor,
                                             std::shared_ptr<rpc::GcsNodeInfo> node) {
   RAY_CHECK(actor && node);
@@ -231,8 +369,11 @@ void GcsActorScheduler::LeaseWorkerFromNode(std::shared_ptr<GcsActor> actor,
   int backlog_size = report_worker_backlog_ ? 0 : -1;
   lease_client->RequestWorkerLease(
       actor->GetCreationTaskSpecification(),
-      [this, actor, node](const Status &status,
-                          const rpc::RequestWorkerLeaseReply &reply) {
+      [this, actor, node, lease_start_ns = absl::GetCurrentTimeNanos()](
+          const Status &status, const rpc::RequestWorkerLeaseReply &reply) {
+        SpanTracer::Instance().Record("ActorLeaseRequest",
+                                      actor->GetCreationTaskSpecification().TaskId(),
+                                      lease_start_ns, absl::GetCurrentTimeNanos());
         HandleWorkerLeaseReply(actor, node, status, reply);
       },
       backlog_size);
@@ -424,6 +565,21 @@ bool GcsActorScheduler::KillActorOnWorker(const rpc::Address &worker_address,
   return true;
 }
 
+void RayletBasedActorScheduler::ScheduleBatch(
+    std::vector<std::shared_ptr<GcsActor>> actors) {
+  const auto &alive_nodes = gcs_node_manager_.GetAllAliveNodes();
+  batch_alive_nodes_.reserve(alive_nodes.size());
+  for (const auto &entry : alive_nodes) {
+    batch_alive_nodes_.emplace_back(entry.second);
+  }
+  // Node membership can't change while the batch is being scheduled because both run
+  // on the same event loop.
+  for (auto &actor : actors) {
+    Schedule(std::move(actor));
+  }
+  batch_alive_nodes_.clear();
+}
+
 std::shared_ptr<rpc::GcsNodeInfo> RayletBasedActorScheduler::SelectNode(
     std::shared_ptr<GcsActor> actor) {
   // Select a node to lease worker for the actor.
@@ -443,13 +599,18 @@ std::shared_ptr<rpc::GcsNodeInfo> RayletBasedActorScheduler::SelectNode(
 }
 
 std::shared_ptr<rpc::GcsNodeInfo> RayletBasedActorScheduler::SelectNodeRandomly() const {
+  static std::mt19937_64 gen_(
+      std::chrono::high_resolution_clock::now().time_since_epoch().count());
+  if (!batch_alive_nodes_.empty()) {
+    std::uniform_int_distribution<size_t> distribution(0, batch_alive_nodes_.size() - 1);
+    return batch_alive_nodes_[distribution(gen_)];
+  }
+
   auto &alive_nodes = gcs_node_manager_.GetAllAliveNodes();
   if (alive_nodes.empty()) {
     return nullptr;
   }
 
-  static std::mt19937_64 gen_(
-      std::chrono::high_resolution_clock::now().time_since_epoch().count());
   std::uniform_int_distribution<int> distribution(0, alive_nodes.size() - 1);
   int key_index = distribution(gen_);
   int index = 0;
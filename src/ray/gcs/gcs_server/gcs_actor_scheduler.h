@@ -44,6 +44,16 @@ class GcsActorSchedulerInterface {
   /// \param actor to be scheduled.
   virtual void Schedule(std::shared_ptr<GcsActor> actor) = 0;
 
+  /// Schedule a batch of actors. Implementations may share node selection work across
+  /// the batch; by default every actor is scheduled on its own.
+  ///
+  /// \param actors The actors to be scheduled.
+  virtual void ScheduleBatch(std::vector<std::shared_ptr<GcsActor>> actors) {
+    for (auto &actor : actors) {
+      Schedule(std::move(actor));
+    }
+  }
+
   /// Reschedule the specified actor after gcs server restarts.
   ///
   /// \param actor to be scheduled.
@@ -75,6 +85,17 @@ class GcsActorSchedulerInterface {
   virtual void ReleaseUnusedWorkers(
       const std::unordered_map<NodeID, std::vector<WorkerID>> &node_to_workers) = 0;
 
+  /// Lease a standby worker for an alive actor on another node, which the actor is
+  /// created on the next time it is scheduled. By default no standby is kept.
+  ///
+  /// \param actor The alive actor.
+  virtual void PrepareStandbyWorker(std::shared_ptr<GcsActor> actor) {}
+
+  /// Return the standby worker of an actor to its node, if it has one.
+  ///
+  /// \param actor_id ID of the actor.
+  virtual void ReleaseStandbyWorker(const ActorID &actor_id) {}
+
   virtual ~GcsActorSchedulerInterface() {}
 };
 
@@ -145,6 +166,17 @@ class GcsActorScheduler : public GcsActorSchedulerInterface {
   void ReleaseUnusedWorkers(
       const std::unordered_map<NodeID, std::vector<WorkerID>> &node_to_workers) override;
 
+  /// Lease a standby worker for an alive actor on a random node other than the one of
+  /// the actor. Nothing is leased if the raylet spills the lease back.
+  ///
+  /// \param actor The alive actor.
+  void PrepareStandbyWorker(std::shared_ptr<GcsActor> actor) override;
+
+  /// Return the standby worker of an actor to its node, if it has one.
+  ///
+  /// \param actor_id ID of the actor.
+  void ReleaseStandbyWorker(const ActorID &actor_id) override;
+
  protected:
   /// The GcsLeasedWorker is kind of abstraction of remote leased worker inside raylet. It
   /// contains the address of remote leased worker as well as the leased resources and the
@@ -278,6 +310,18 @@ class GcsActorScheduler : public GcsActorSchedulerInterface {
   /// Kill the actor on a node
   bool KillActorOnWorker(const rpc::Address &worker_address, ActorID actor_id);
 
+  /// Handler to process the reply of a standby worker lease.
+  ///
+  /// \param actor The actor the standby worker is leased for.
+  /// \param status Status of the reply of `RequestWorkerLeaseRequest`.
+  /// \param reply The reply of `RequestWorkerLeaseRequest`.
+  void HandleStandbyWorkerLeaseReply(std::shared_ptr<GcsActor> actor,
+                                     const Status &status,
+                                     const rpc::RequestWorkerLeaseReply &reply);
+
+  /// Return a leased standby worker to its node.
+  void ReturnStandbyWorker(const rpc::Address &worker_address);
+
  protected:
   /// The io loop that is used to delay execution of tasks (e.g.,
   /// execute_after).
@@ -305,6 +349,12 @@ class GcsActorScheduler : public GcsActorSchedulerInterface {
   bool report_worker_backlog_;
   /// The nodes which are releasing unused workers.
   absl::flat_hash_set<NodeID> nodes_of_releasing_unused_workers_;
+  /// The actors for which a standby worker lease request is in flight.
+  absl::flat_hash_set<ActorID> actors_leasing_standby_workers_;
+  /// Map from actor ID to the granted lease of its standby worker.
+  absl::flat_hash_map<ActorID, rpc::RequestWorkerLeaseReply> standby_workers_;
+  /// Map from standby worker ID to the actor it is leased for.
+  absl::flat_hash_map<WorkerID, ActorID> standby_worker_to_actor_;
   /// The cached raylet clients used to communicate with raylet.
   std::shared_ptr<rpc::NodeManagerClientPool> raylet_client_pool_;
   /// The cached core worker clients which are used to communicate with leased worker.
@@ -318,6 +368,12 @@ class RayletBasedActorScheduler : public GcsActorScheduler {
   using GcsActorScheduler::GcsActorScheduler;
   virtual ~RayletBasedActorScheduler() = default;
 
+  /// Schedule a batch of actors. The alive nodes are collected once for the whole
+  /// batch, so that picking a random node is constant time per actor.
+  ///
+  /// \param actors The actors to be scheduled.
+  void ScheduleBatch(std::vector<std::shared_ptr<GcsActor>> actors) override;
+
  protected:
   /// Randomly select a node from the node pool to schedule the actor.
   ///
@@ -343,6 +399,9 @@ class RayletBasedActorScheduler : public GcsActorScheduler {
   ///
   /// \return The selected node. If the selection fails, `nullptr` is returned.
   std::shared_ptr<rpc::GcsNodeInfo> SelectNodeRandomly() const;
+
+  /// Alive nodes collected at the start of `ScheduleBatch`. Empty outside of a batch.
+  std::vector<std::shared_ptr<rpc::GcsNodeInfo>> batch_alive_nodes_;
 };
 
 }  // namespace gcs
@@ -27,6 +27,8 @@ GcsHeartbeatManager::GcsHeartbeatManager(
       on_node_death_callback_(std::move(on_node_death_callback)),
       num_heartbeats_timeout_(RayConfig::instance().num_heartbeats_timeout()),
       periodical_runner_(io_service) {
+  RAY_CHECK(num_heartbeats_timeout_ > 0);
+  timer_wheel_.resize(num_heartbeats_timeout_ + 1);
   RAY_LOG(INFO) << "GcsHeartbeatManager start, num_heartbeats_timeout="
                 << num_heartbeats_timeout_;
   io_service_thread_.reset(new std::thread([this] {
@@ -40,7 +42,7 @@ GcsHeartbeatManager::GcsHeartbeatManager(
 void GcsHeartbeatManager::Initialize(const GcsInitData &gcs_init_data) {
   for (const auto &item : gcs_init_data.Nodes()) {
     if (item.second.state() == rpc::GcsNodeInfo::ALIVE) {
-      heartbeats_.emplace(item.first, num_heartbeats_timeout_);
+      AddLease(item.first);
     }
   }
 }
@@ -68,23 +70,43 @@ void GcsHeartbeatManager::Stop() {
 
 void GcsHeartbeatManager::AddNode(const NodeID &node_id) {
   io_service_.post(
-      [this, node_id] { heartbeats_.emplace(node_id, num_heartbeats_timeout_); },
-      "GcsHeartbeatManager.AddNode");
+      [this, node_id] { AddLease(node_id); }, "GcsHeartbeatManager.AddNode");
+}
+
+void GcsHeartbeatManager::RenewLease(const NodeID &node_id) {
+  absl::MutexLock lock(&renewals_mutex_);
+  pending_renewals_.insert(node_id);
+}
+
+void GcsHeartbeatManager::AddLease(const NodeID &node_id) {
+  int64_t expiry = current_tick_ + num_heartbeats_timeout_;
+  if (heartbeats_.emplace(node_id, expiry).second) {
+    timer_wheel_[expiry % timer_wheel_.size()].push_back(node_id);
+  }
+}
+
+bool GcsHeartbeatManager::ExtendLease(const NodeID &node_id) {
+  auto iter = heartbeats_.find(node_id);
+  if (iter == heartbeats_.end()) {
+    return false;
+  }
+  // The node stays in its current slot. When that slot is reached, the node is moved
+  // to the slot of its new expiry.
+  iter->second = current_tick_ + num_heartbeats_timeout_;
+  return true;
 }
 
 void GcsHeartbeatManager::HandleReportHeartbeat(
     const rpc::ReportHeartbeatRequest &request, rpc::ReportHeartbeatReply *reply,
     rpc::SendReplyCallback send_reply_callback) {
   NodeID node_id = NodeID::FromBinary(request.heartbeat().node_id());
-  auto iter = heartbeats_.find(node_id);
-  if (iter == heartbeats_.end()) {
+  if (!ExtendLease(node_id)) {
     // Reply the raylet with an error so the raylet can crash itself.
     GCS_RPC_SEND_REPLY(send_reply_callback, reply,
                        Status::Disconnected("Node has been dead"));
     return;
   }
 
-  iter->second = num_heartbeats_timeout_;
   GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
 }
 
@@ -96,16 +118,32 @@ void GcsHeartbeatManager::HandleCheckAlive(const rpc::CheckAliveRequest &request
 }
 
 void GcsHeartbeatManager::DetectDeadNodes() {
-  for (auto it = heartbeats_.begin(); it != heartbeats_.end();) {
-    auto current = it++;
-    current->second = current->second - 1;
-    if (current->second == 0) {
-      auto node_id = current->first;
-      RAY_LOG(WARNING) << "Node timed out: " << node_id;
-      heartbeats_.erase(current);
-      if (on_node_death_callback_) {
-        on_node_death_callback_(node_id);
-      }
+  absl::flat_hash_set<NodeID> renewals;
+  {
+    absl::MutexLock lock(&renewals_mutex_);
+    renewals.swap(pending_renewals_);
+  }
+  for (const auto &node_id : renewals) {
+    ExtendLease(node_id);
+  }
+
+  ++current_tick_;
+  std::vector<NodeID> due;
+  due.swap(timer_wheel_[current_tick_ % timer_wheel_.size()]);
+  for (const auto &node_id : due) {
+    auto iter = heartbeats_.find(node_id);
+    if (iter == heartbeats_.end()) {
+      continue;
+    }
+    if (iter->second > current_tick_) {
+      // The lease was extended since it was scheduled. Check it again when it expires.
+      timer_wheel_[iter->second % timer_wheel_.size()].push_back(node_id);
+      continue;
+    }
+    RAY_LOG(WARNING) << "Node timed out: " << node_id;
+    heartbeats_.erase(iter);
+    if (on_node_death_callback_) {
+      on_node_death_callback_(node_id);
     }
   }
 }
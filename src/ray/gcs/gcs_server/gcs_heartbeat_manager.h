@@ -16,6 +16,8 @@
 #pragma once
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
 #include "ray/common/asio/instrumented_io_context.h"
 #include "ray/common/asio/periodical_runner.h"
 #include "ray/common/id.h"
@@ -29,7 +31,13 @@ namespace ray {
 namespace gcs {
 
 /// GcsHeartbeatManager is responsible for monitoring nodes liveness as well as
-/// handing heartbeat rpc requests. This class is not thread-safe.
+/// handing heartbeat rpc requests. This class is not thread-safe, except for
+/// `RenewLease`.
+///
+/// Each alive node holds a lease that a heartbeat extends to `num_heartbeats_timeout`
+/// ticks from now. Leases are kept in a timer wheel and a node's lease is only checked
+/// when the tick it could expire at is reached, so a heartbeat is O(1) and a tick costs
+/// O(leases due at that tick) rather than O(nodes).
 class GcsHeartbeatManager : public rpc::HeartbeatInfoHandler {
  public:
   /// Create a GcsHeartbeatManager.
@@ -69,11 +77,24 @@ class GcsHeartbeatManager : public rpc::HeartbeatInfoHandler {
   /// \param node_id ID of the node to be registered.
   void AddNode(const NodeID &node_id);
 
+  /// Extend the lease of a node as if it had sent a heartbeat. This is used when other
+  /// traffic, such as resource reports, already proves that the node is alive. It is
+  /// thread safe and takes effect at the next tick.
+  ///
+  /// \param node_id ID of the node to renew the lease of.
+  void RenewLease(const NodeID &node_id) LOCKS_EXCLUDED(renewals_mutex_);
+
  protected:
   /// Check that if any raylet is inactive due to no heartbeat for a period of time.
   /// If found any, mark it as dead.
   void DetectDeadNodes();
 
+  /// Start or extend the lease of a node. Returns false if the node isn't registered.
+  bool ExtendLease(const NodeID &node_id);
+
+  /// Register a node whose lease is not tracked yet.
+  void AddLease(const NodeID &node_id);
+
  private:
   /// The main event loop for node failure detector.
   instrumented_io_context &io_service_;
@@ -84,9 +105,17 @@ class GcsHeartbeatManager : public rpc::HeartbeatInfoHandler {
   int64_t num_heartbeats_timeout_;
   /// The runner to run function periodically.
   PeriodicalRunner periodical_runner_;
-  /// For each Raylet that we receive a heartbeat from, the number of ticks
-  /// that may pass before the Raylet will be declared dead.
+  /// For each Raylet that we receive a heartbeat from, the tick at which its lease
+  /// expires and the Raylet will be declared dead.
   absl::flat_hash_map<NodeID, int64_t> heartbeats_;
+  /// The timer wheel. The slot `tick % timer_wheel_.size()` holds the nodes whose
+  /// lease is checked at `tick`. Every node in `heartbeats_` is in exactly one slot.
+  std::vector<std::vector<NodeID>> timer_wheel_;
+  /// The number of ticks since the detect loop started.
+  int64_t current_tick_ = 0;
+  /// Leases renewed from other threads since the last tick.
+  absl::Mutex renewals_mutex_;
+  absl::flat_hash_set<NodeID> pending_renewals_ GUARDED_BY(renewals_mutex_);
   /// Is the detect started.
   bool is_started_ = false;
 };
@@ -14,6 +14,7 @@
 
 #include "ray/gcs/gcs_server/gcs_job_manager.h"
 
+#include "ray/gcs/gcs_server/gcs_pagination.h"
 #include "ray/gcs/pb_util.h"
 
 namespace ray {
@@ -141,10 +142,16 @@ void GcsJobManager::HandleGetAllJobInfo(const rpc::GetAllJobInfoRequest &request
                                         rpc::GetAllJobInfoReply *reply,
                                         rpc::SendReplyCallback send_reply_callback) {
   RAY_LOG(INFO) << "Getting all job info.";
-  auto on_done = [reply, send_reply_callback](
+  auto on_done = [request, reply, send_reply_callback](
                      const std::unordered_map<JobID, JobTableData> &result) {
-    for (auto &data : result) {
-      reply->add_job_info_list()->CopyFrom(data.second);
+    std::vector<std::pair<std::string, const JobTableData *>> entries;
+    entries.reserve(result.size());
+    for (const auto &data : result) {
+      entries.emplace_back(data.first.Binary(), &data.second);
+    }
+    for (const auto *job : SelectPage(std::move(entries), request.page_token(),
+                                      request.limit(), reply->mutable_next_page_token())) {
+      reply->add_job_info_list()->CopyFrom(*job);
     }
     RAY_LOG(INFO) << "Finished getting all job info.";
     GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
@@ -76,16 +76,110 @@ void GcsInternalKVManager::HandleInternalKVExists(
 void GcsInternalKVManager::HandleInternalKVKeys(
     const rpc::InternalKVKeysRequest &request, rpc::InternalKVKeysReply *reply,
     rpc::SendReplyCallback send_reply_callback) {
-  std::vector<std::string> cmd = {"KEYS", request.prefix() + "*"};
+  if (request.limit() <= 0) {
+    std::vector<std::string> cmd = {"KEYS", request.prefix() + "*"};
+    RAY_CHECK_OK(redis_client_->GetPrimaryContext()->RunArgvAsync(
+        cmd, [reply, send_reply_callback](auto redis_reply) {
+          const auto &results = redis_reply->ReadAsStringArray();
+          for (const auto &result : results) {
+            reply->add_results(result);
+          }
+          GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
+        }));
+    return;
+  }
+  // A page is one SCAN, the cursor of redis is the page token. Unlike KEYS, this
+  // doesn't block redis for the whole key space.
+  const std::string cursor =
+      request.page_token().empty() ? "0" : request.page_token();
+  ScanKeys(request.prefix(), cursor, request.limit(), reply, send_reply_callback);
+}
+
+void GcsInternalKVManager::ScanKeys(const std::string &prefix, const std::string &cursor,
+                                    int64_t limit, rpc::InternalKVKeysReply *reply,
+                                    rpc::SendReplyCallback send_reply_callback) {
+  std::vector<std::string> cmd = {"SCAN", cursor, "MATCH", prefix + "*", "COUNT",
+                                  std::to_string(limit)};
   RAY_CHECK_OK(redis_client_->GetPrimaryContext()->RunArgvAsync(
-      cmd, [reply, send_reply_callback](auto redis_reply) {
-        const auto &results = redis_reply->ReadAsStringArray();
-        for (const auto &result : results) {
-          reply->add_results(result);
+      cmd, [this, prefix, limit, reply, send_reply_callback](auto redis_reply) {
+        std::vector<std::string> keys;
+        size_t next_cursor = redis_reply->ReadAsScanArray(&keys);
+        for (const auto &key : keys) {
+          reply->add_results(key);
+        }
+        if (next_cursor == 0) {
+          GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
+        } else if (reply->results_size() == 0) {
+          // SCAN can return no matching keys before the end, don't hand out empty
+          // pages.
+          ScanKeys(prefix, std::to_string(next_cursor), limit, reply,
+                   send_reply_callback);
+        } else {
+          reply->set_next_page_token(std::to_string(next_cursor));
+          GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
         }
-        GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
       }));
 }
 
+void GcsInternalKVManager::HandleInternalKVMultiGet(
+    const rpc::InternalKVMultiGetRequest &request, rpc::InternalKVMultiGetReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  const int num_keys = request.keys_size();
+  if (num_keys == 0) {
+    GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
+    return;
+  }
+  // The commands are pipelined on the redis connection, and their replies arrive in
+  // order on the same thread.
+  auto values = std::make_shared<std::vector<boost::optional<std::string>>>(num_keys);
+  auto num_pending = std::make_shared<int>(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<std::string> cmd = {"HGET", request.keys(i), "value"};
+    RAY_CHECK_OK(redis_client_->GetPrimaryContext()->RunArgvAsync(
+        cmd, [i, values, num_pending, reply, send_reply_callback](auto redis_reply) {
+          if (!redis_reply->IsNil()) {
+            (*values)[i] = redis_reply->ReadAsString();
+          }
+          if (--*num_pending > 0) {
+            return;
+          }
+          for (const auto &value : *values) {
+            reply->add_found(static_cast<bool>(value));
+            if (value) {
+              reply->add_values(*value);
+            }
+          }
+          GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
+        }));
+  }
+}
+
+void GcsInternalKVManager::HandleInternalKVMultiPut(
+    const rpc::InternalKVMultiPutRequest &request, rpc::InternalKVMultiPutReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  if (request.keys_size() != request.values_size()) {
+    GCS_RPC_SEND_REPLY(send_reply_callback, reply,
+                       Status::Invalid("The numbers of keys and values differ"));
+    return;
+  }
+  const int num_keys = request.keys_size();
+  if (num_keys == 0) {
+    GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
+    return;
+  }
+  auto num_pending = std::make_shared<int>(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<std::string> cmd = {request.overwrite() ? "HSET" : "HSETNX",
+                                    request.keys(i), "value", request.values(i)};
+    RAY_CHECK_OK(redis_client_->GetPrimaryContext()->RunArgvAsync(
+        cmd, [num_pending, reply, send_reply_callback](auto redis_reply) {
+          reply->set_added_num(reply->added_num() + redis_reply->ReadAsInteger());
+          if (--*num_pending == 0) {
+            GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
+          }
+        }));
+  }
+}
+
 }  // namespace gcs
 }  // namespace ray
@@ -49,7 +49,21 @@ class GcsInternalKVManager : public rpc::InternalKVHandler {
                             rpc::InternalKVKeysReply *reply,
                             rpc::SendReplyCallback send_reply_callback);
 
+  void HandleInternalKVMultiGet(const rpc::InternalKVMultiGetRequest &request,
+                                rpc::InternalKVMultiGetReply *reply,
+                                rpc::SendReplyCallback send_reply_callback);
+
+  void HandleInternalKVMultiPut(const rpc::InternalKVMultiPutRequest &request,
+                                rpc::InternalKVMultiPutReply *reply,
+                                rpc::SendReplyCallback send_reply_callback);
+
  private:
+  /// Scan the keys with the prefix from the cursor, until a page has keys or the scan
+  /// ends, and reply with them.
+  void ScanKeys(const std::string &prefix, const std::string &cursor, int64_t limit,
+                rpc::InternalKVKeysReply *reply,
+                rpc::SendReplyCallback send_reply_callback);
+
   std::shared_ptr<RedisClient> redis_client_;
 };
 
@@ -15,6 +15,7 @@
 #include "ray/gcs/gcs_server/gcs_node_manager.h"
 
 #include "ray/common/ray_config.h"
+#include "ray/gcs/gcs_server/gcs_pagination.h"
 #include "ray/gcs/pb_util.h"
 #include "ray/stats/stats.h"
 #include "src/ray/protobuf/gcs.pb.h"
@@ -82,11 +83,25 @@ void GcsNodeManager::HandleUnregisterNode(const rpc::UnregisterNodeRequest &requ
 void GcsNodeManager::HandleGetAllNodeInfo(const rpc::GetAllNodeInfoRequest &request,
                                           rpc::GetAllNodeInfoReply *reply,
                                           rpc::SendReplyCallback send_reply_callback) {
-  for (const auto &entry : alive_nodes_) {
-    reply->add_node_info_list()->CopyFrom(*entry.second);
+  auto wants_state = [&request](rpc::GcsNodeInfo::GcsNodeState state) {
+    return request.states_size() == 0 ||
+           std::find(request.states().begin(), request.states().end(), state) !=
+               request.states().end();
+  };
+  std::vector<std::pair<std::string, const rpc::GcsNodeInfo *>> entries;
+  if (wants_state(rpc::GcsNodeInfo::ALIVE)) {
+    for (const auto &entry : alive_nodes_) {
+      entries.emplace_back(entry.first.Binary(), entry.second.get());
+    }
+  }
+  if (wants_state(rpc::GcsNodeInfo::DEAD)) {
+    for (const auto &entry : dead_nodes_) {
+      entries.emplace_back(entry.first.Binary(), entry.second.get());
+    }
   }
-  for (const auto &entry : dead_nodes_) {
-    reply->add_node_info_list()->CopyFrom(*entry.second);
+  for (const auto *node : SelectPage(std::move(entries), request.page_token(),
+                                     request.limit(), reply->mutable_next_page_token())) {
+    reply->add_node_info_list()->CopyFrom(*node);
   }
   GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
   ++counts_[CountType::GET_ALL_NODE_INFO_REQUEST];
@@ -0,0 +1,70 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ray {
+namespace gcs {
+
+/// Select one page of the entries of a bulk query. Pages are cut in ID order, so a
+/// page token stays valid while the table changes between two requests.
+///
+/// Only the selected entries are sorted, and the caller only copies the selected items
+/// into its reply, so a page costs O(N + limit * log(limit)) time for N entries.
+///
+/// \param entries The entries that match the query, as (binary ID, item) pairs.
+/// \param page_token Only entries with IDs greater than this one are selected. Empty
+/// means from the start.
+/// \param limit Maximum number of entries to select. 0 means no limit.
+/// \param[out] next_page_token Set to the ID of the last selected entry if more
+/// entries remain, otherwise cleared.
+/// \return The selected items.
+template <typename T>
+std::vector<T> SelectPage(std::vector<std::pair<std::string, T>> entries,
+                          const std::string &page_token, int64_t limit,
+                          std::string *next_page_token) {
+  next_page_token->clear();
+  if (!page_token.empty()) {
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [&page_token](const std::pair<std::string, T> &entry) {
+                                   return entry.first <= page_token;
+                                 }),
+                  entries.end());
+  }
+  auto by_id = [](const std::pair<std::string, T> &a,
+                  const std::pair<std::string, T> &b) { return a.first < b.first; };
+  if (limit > 0 && entries.size() > static_cast<size_t>(limit)) {
+    std::nth_element(entries.begin(), entries.begin() + limit, entries.end(), by_id);
+    entries.resize(limit);
+    std::sort(entries.begin(), entries.end(), by_id);
+    *next_page_token = entries.back().first;
+  } else if (!page_token.empty()) {
+    std::sort(entries.begin(), entries.end(), by_id);
+  }
+
+  std::vector<T> result;
+  result.reserve(entries.size());
+  for (auto &entry : entries) {
+    result.push_back(std::move(entry.second));
+  }
+  return result;
+}
+
+}  // namespace gcs
+}  // namespace ray
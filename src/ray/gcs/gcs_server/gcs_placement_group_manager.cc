@@ -118,13 +118,19 @@ GcsPlacementGroupManager::GcsPlacementGroupManager(
     std::shared_ptr<GcsPlacementGroupSchedulerInterface> scheduler,
     std::shared_ptr<gcs::GcsTableStorage> gcs_table_storage,
     GcsResourceManager &gcs_resource_manager,
-    std::function<std::string(const JobID &)> get_ray_namespace)
+    std::function<std::string(const JobID &)> get_ray_namespace,
+    std::function<absl::flat_hash_set<PlacementGroupID>()> get_pinned_placement_groups)
     : io_context_(io_context),
       gcs_placement_group_scheduler_(std::move(scheduler)),
       gcs_table_storage_(std::move(gcs_table_storage)),
       gcs_resource_manager_(gcs_resource_manager),
-      get_ray_namespace_(get_ray_namespace) {
+      get_ray_namespace_(get_ray_namespace),
+      get_pinned_placement_groups_(std::move(get_pinned_placement_groups)) {
   Tick();
+  if (get_pinned_placement_groups_ &&
+      RayConfig::instance().gcs_placement_group_defrag_interval_ms() > 0) {
+    DefragmentTick();
+  }
 }
 
 void GcsPlacementGroupManager::RegisterPlacementGroup(
@@ -235,12 +241,12 @@ void GcsPlacementGroupManager::OnPlacementGroupCreationFailed(
     // NOTE: If a node is dead, the placement group scheduler should try to recover the
     // group by rescheduling the bundles of the dead node. This should have higher
     // priority than trying to place other placement groups.
-    pending_placement_groups_.emplace_front(std::move(placement_group));
+    pending_placement_groups_.emplace_front(placement_group);
   } else {
-    pending_placement_groups_.emplace_back(std::move(placement_group));
+    pending_placement_groups_.emplace_back(placement_group);
   }
 
-  MarkSchedulingDone();
+  MarkSchedulingDone(placement_group->GetPlacementGroupID());
   RetryCreatingPlacementGroup();
 }
 
@@ -250,8 +256,8 @@ void GcsPlacementGroupManager::OnPlacementGroupCreationSuccess(
                 << ", id: " << placement_group->GetPlacementGroupID();
   placement_group->UpdateState(rpc::PlacementGroupTableData::CREATED);
   // Mark the scheduling done firstly.
-  MarkSchedulingDone();
   auto placement_group_id = placement_group->GetPlacementGroupID();
+  MarkSchedulingDone(placement_group_id);
   RAY_CHECK_OK(gcs_table_storage_->PlacementGroupTable().Put(
       placement_group_id, placement_group->GetPlacementGroupTableData(),
       [this, placement_group_id](Status status) {
@@ -274,14 +280,31 @@ void GcsPlacementGroupManager::OnPlacementGroupCreationSuccess(
 }
 
 void GcsPlacementGroupManager::SchedulePendingPlacementGroups() {
-  // Update the placement group load to report load information to the autoscaler.
-  if (pending_placement_groups_.empty() || IsSchedulingInProgress()) {
-    return;
-  }
-  const auto placement_group = pending_placement_groups_.front();
-  const auto &placement_group_id = placement_group->GetPlacementGroupID();
-  // Do not reschedule if the placement group has removed already.
-  if (registered_placement_groups_.contains(placement_group_id)) {
+  // Several placement groups can be scheduled at the same time. The scheduler reserves
+  // the resources of each of them as soon as its bundles are placed, so the next one is
+  // placed on the remaining resources.
+  absl::flat_hash_set<PlacementGroupID> scheduled_ids;
+  std::vector<std::shared_ptr<GcsPlacementGroup>> still_scheduling;
+  while (!pending_placement_groups_.empty() && !IsSchedulingInProgress()) {
+    const auto placement_group = pending_placement_groups_.front();
+    const auto &placement_group_id = placement_group->GetPlacementGroupID();
+    // A placement group that failed synchronously is back in the queue, it is retried
+    // after `gcs_create_placement_group_retry_interval_ms`.
+    if (scheduled_ids.contains(placement_group_id)) {
+      break;
+    }
+    pending_placement_groups_.pop_front();
+    // Do not reschedule if the placement group has removed already.
+    if (!registered_placement_groups_.contains(placement_group_id)) {
+      continue;
+    }
+    // A placement group re-queued by a dead node may still be leasing its bundles, keep
+    // it pending until that scheduling is done.
+    if (IsSchedulingInProgress(placement_group_id)) {
+      still_scheduling.push_back(placement_group);
+      continue;
+    }
+    scheduled_ids.insert(placement_group_id);
     MarkSchedulingStarted(placement_group_id);
     gcs_placement_group_scheduler_->ScheduleUnplacedBundles(
         placement_group,
@@ -292,7 +315,58 @@ void GcsPlacementGroupManager::SchedulePendingPlacementGroups() {
           OnPlacementGroupCreationSuccess(std::move(placement_group));
         });
   }
-  pending_placement_groups_.pop_front();
+  pending_placement_groups_.insert(pending_placement_groups_.begin(),
+                                   still_scheduling.begin(), still_scheduling.end());
+}
+
+void GcsPlacementGroupManager::DefragmentPlacementGroups() {
+  if (pending_placement_groups_.empty() || IsSchedulingInProgress() ||
+      !get_pinned_placement_groups_) {
+    return;
+  }
+  // Only STRICT_PACK placement groups can be blocked by bundles spread over the nodes,
+  // the other strategies split their bundles over the nodes instead.
+  auto target_it = std::find_if(
+      pending_placement_groups_.begin(), pending_placement_groups_.end(),
+      [this](const std::shared_ptr<GcsPlacementGroup> &placement_group) {
+        return placement_group->GetStrategy() == rpc::PlacementStrategy::STRICT_PACK &&
+               placement_group->GetState() == rpc::PlacementGroupTableData::PENDING &&
+               registered_placement_groups_.contains(
+                   placement_group->GetPlacementGroupID()) &&
+               !IsSchedulingInProgress(placement_group->GetPlacementGroupID());
+      });
+  if (target_it == pending_placement_groups_.end()) {
+    return;
+  }
+  const auto target = *target_it;
+  const auto pinned_placement_groups = get_pinned_placement_groups_();
+  auto moved_bundles = gcs_placement_group_scheduler_->ReleaseBundlesToFit(
+      target,
+      [this, &pinned_placement_groups](const PlacementGroupID &placement_group_id) {
+        auto iter = registered_placement_groups_.find(placement_group_id);
+        return iter != registered_placement_groups_.end() &&
+               iter->second->GetState() == rpc::PlacementGroupTableData::CREATED &&
+               !pinned_placement_groups.contains(placement_group_id) &&
+               !IsSchedulingInProgress(placement_group_id);
+      },
+      RayConfig::instance().gcs_placement_group_defrag_max_bundles());
+  if (moved_bundles.empty()) {
+    return;
+  }
+
+  // Schedule the target first, so it gets the room made for it, and then place the
+  // moved bundles again.
+  pending_placement_groups_.erase(target_it);
+  for (const auto &bundles : moved_bundles) {
+    auto &placement_group = registered_placement_groups_.at(bundles.first);
+    for (const auto &bundle_index : bundles.second) {
+      placement_group->GetMutableBundle(bundle_index)->clear_node_id();
+    }
+    placement_group->UpdateState(rpc::PlacementGroupTableData::RESCHEDULING);
+    pending_placement_groups_.emplace_front(placement_group);
+  }
+  pending_placement_groups_.emplace_front(target);
+  SchedulePendingPlacementGroups();
 }
 
 void GcsPlacementGroupManager::HandleCreatePlacementGroup(
@@ -620,6 +694,12 @@ void GcsPlacementGroupManager::Tick() {
   execute_after(io_context_, [this] { Tick(); }, 1000 /* milliseconds */);
 }
 
+void GcsPlacementGroupManager::DefragmentTick() {
+  DefragmentPlacementGroups();
+  execute_after(io_context_, [this] { DefragmentTick(); },
+                RayConfig::instance().gcs_placement_group_defrag_interval_ms());
+}
+
 void GcsPlacementGroupManager::UpdatePlacementGroupLoad() {
   std::shared_ptr<rpc::PlacementGroupLoad> placement_group_load =
       std::make_shared<rpc::PlacementGroupLoad>();
@@ -13,12 +13,14 @@
 // limitations under the License.
 
 #pragma once
+#include <algorithm>
 #include <utility>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "ray/common/asio/instrumented_io_context.h"
 #include "ray/common/id.h"
+#include "ray/common/ray_config.h"
 #include "ray/common/task/task_execution_spec.h"
 #include "ray/common/task/task_spec.h"
 #include "ray/gcs/gcs_server/gcs_init_data.h"
@@ -141,12 +143,18 @@ class GcsPlacementGroupManager : public rpc::PlacementGroupInfoHandler {
   /// \param scheduler Used to schedule placement group creation tasks.
   /// \param gcs_table_storage Used to flush placement group data to storage.
   /// \param gcs_resource_manager Reference of GcsResourceManager.
+  /// \param get_ray_namespace Get the ray namespace of a job.
+  /// \param get_pinned_placement_groups Get the placement groups whose bundles must not
+  /// be moved to other nodes, e.g. because they run actors that cannot restart. If not
+  /// set, placement group bundles are never moved.
   explicit GcsPlacementGroupManager(
       instrumented_io_context &io_context,
       std::shared_ptr<GcsPlacementGroupSchedulerInterface> scheduler,
       std::shared_ptr<gcs::GcsTableStorage> gcs_table_storage,
       GcsResourceManager &gcs_resource_manager,
-      std::function<std::string(const JobID &)> get_ray_namespace);
+      std::function<std::string(const JobID &)> get_ray_namespace,
+      std::function<absl::flat_hash_set<PlacementGroupID>()>
+          get_pinned_placement_groups = nullptr);
 
   ~GcsPlacementGroupManager() = default;
 
@@ -195,6 +203,12 @@ class GcsPlacementGroupManager : public rpc::PlacementGroupInfoHandler {
   /// Schedule placement_groups in the `pending_placement_groups_` queue.
   void SchedulePendingPlacementGroups();
 
+  /// Make room for the first pending STRICT_PACK placement group which fits on no node,
+  /// by moving up to `gcs_placement_group_defrag_max_bundles` bundles of created
+  /// placement groups that are not pinned to other nodes. The pending placement group
+  /// is scheduled first, followed by the placement groups whose bundles were moved.
+  void DefragmentPlacementGroups();
+
   /// Get the placement_group ID for the named placement_group. Returns nil if the
   /// placement_group was not found.
   /// \param name The name of the  placement_group to look up.
@@ -274,25 +288,32 @@ class GcsPlacementGroupManager : public rpc::PlacementGroupInfoHandler {
 
   /// Mark the manager that there's a placement group scheduling going on.
   void MarkSchedulingStarted(const PlacementGroupID placement_group_id) {
-    scheduling_in_progress_id_ = placement_group_id;
+    scheduling_in_progress_ids_.insert(placement_group_id);
   }
 
-  /// Mark the manager that there's no more placement group scheduling going on.
-  void MarkSchedulingDone() { scheduling_in_progress_id_ = PlacementGroupID::Nil(); }
+  /// Mark the manager that the scheduling of a placement group is done.
+  void MarkSchedulingDone(const PlacementGroupID &placement_group_id) {
+    scheduling_in_progress_ids_.erase(placement_group_id);
+  }
 
   /// Check if the placement group of a given id is scheduling.
   bool IsSchedulingInProgress(const PlacementGroupID &placement_group_id) const {
-    return scheduling_in_progress_id_ == placement_group_id;
+    return scheduling_in_progress_ids_.contains(placement_group_id);
   }
 
-  /// Check if there's any placement group scheduling going on.
+  /// Check if as many placement groups as allowed are scheduling.
   bool IsSchedulingInProgress() const {
-    return scheduling_in_progress_id_ != PlacementGroupID::Nil();
+    return scheduling_in_progress_ids_.size() >=
+           std::max<uint32_t>(
+               RayConfig::instance().gcs_max_concurrent_placement_group_scheduling(), 1);
   }
 
   // Method that is invoked every second.
   void Tick();
 
+  /// Method that is invoked every `gcs_placement_group_defrag_interval_ms`.
+  void DefragmentTick();
+
   // Update placement group load information so that the autoscaler can use it.
   void UpdatePlacementGroupLoad();
 
@@ -328,10 +349,9 @@ class GcsPlacementGroupManager : public rpc::PlacementGroupInfoHandler {
   /// Used to update placement group information upon creation, deletion, etc.
   std::shared_ptr<gcs::GcsTableStorage> gcs_table_storage_;
 
-  /// The placement group id that is in progress of scheduling bundles.
-  /// TODO(sang): Currently, only one placement group can be scheduled at a time.
-  /// We should probably support concurrenet creation (or batching).
-  PlacementGroupID scheduling_in_progress_id_ = PlacementGroupID::Nil();
+  /// The ids of the placement groups that are in progress of scheduling bundles, at
+  /// most `gcs_max_concurrent_placement_group_scheduling` of them.
+  absl::flat_hash_set<PlacementGroupID> scheduling_in_progress_ids_;
 
   /// Reference of GcsResourceManager.
   GcsResourceManager &gcs_resource_manager_;
@@ -339,6 +359,9 @@ class GcsPlacementGroupManager : public rpc::PlacementGroupInfoHandler {
   /// Get ray namespace.
   std::function<std::string(const JobID &)> get_ray_namespace_;
 
+  /// Get the placement groups whose bundles must not be moved.
+  std::function<absl::flat_hash_set<PlacementGroupID>()> get_pinned_placement_groups_;
+
   /// Maps placement group names to their placement group ID for lookups by
   /// name, first keyed by namespace.
   absl::flat_hash_map<std::string, absl::flat_hash_map<std::string, PlacementGroupID>>
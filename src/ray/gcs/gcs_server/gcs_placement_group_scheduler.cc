@@ -159,19 +159,30 @@ void GcsPlacementGroupScheduler::ScheduleUnplacedBundles(
   RAY_CHECK(placement_group_leasing_in_progress_
                 .emplace(placement_group->GetPlacementGroupID(), lease_status_tracker)
                 .second);
+  // Reserve the bundle resources in the cluster view right away, so that placement
+  // groups scheduled while this one is leasing are placed on the remaining resources.
+  // They are returned if the prepare or commit phase fails.
+  AcquireBundleResources(lease_status_tracker->GetBundleLocations());
+
+  // Send one prepare request to each node, for all the bundles scheduled on it.
+  absl::flat_hash_map<NodeID, std::vector<std::shared_ptr<BundleSpecification>>>
+      node_to_bundles;
+  for (const auto &bundle : bundles) {
+    node_to_bundles[selected_nodes[bundle->BundleId()]].push_back(bundle);
+  }
 
   /// TODO(AlisaWu): Change the strategy when reserve resource failed.
-  for (const auto &bundle : bundles) {
-    const auto &bundle_id = bundle->BundleId();
-    const auto &node_id = selected_nodes[bundle_id];
-    lease_status_tracker->MarkPreparePhaseStarted(node_id, bundle);
+  for (const auto &entry : node_to_bundles) {
+    const auto &node_id = entry.first;
+    const auto &bundles_on_node = entry.second;
+    lease_status_tracker->MarkPreparePhaseStarted(node_id, bundles_on_node);
     // TODO(sang): The callback might not be called at all if nodes are dead. We should
     // handle this case properly.
-    PrepareResources(bundle, gcs_node_manager_.GetAliveNode(node_id),
-                     [this, bundle, node_id, lease_status_tracker, failure_callback,
-                      success_callback](const Status &status) {
-                       lease_status_tracker->MarkPrepareRequestReturned(node_id, bundle,
-                                                                        status);
+    PrepareResources(bundles_on_node, gcs_node_manager_.GetAliveNode(node_id),
+                     [this, bundles_on_node, node_id, lease_status_tracker,
+                      failure_callback, success_callback](const Status &status) {
+                       lease_status_tracker->MarkPrepareRequestReturned(
+                           node_id, bundles_on_node, status);
                        if (lease_status_tracker->AllPrepareRequestsReturned()) {
                          OnAllBundlePrepareRequestReturned(
                              lease_status_tracker, failure_callback, success_callback);
@@ -204,7 +215,7 @@ void GcsPlacementGroupScheduler::MarkScheduleCancelled(
 }
 
 void GcsPlacementGroupScheduler::PrepareResources(
-    const std::shared_ptr<BundleSpecification> &bundle,
+    const std::vector<std::shared_ptr<BundleSpecification>> &bundles,
     const absl::optional<std::shared_ptr<ray::rpc::GcsNodeInfo>> &node,
     const StatusCallback &callback) {
   if (!node.has_value()) {
@@ -214,43 +225,51 @@ void GcsPlacementGroupScheduler::PrepareResources(
 
   const auto lease_client = GetLeaseClientFromNode(node.value());
   const auto node_id = NodeID::FromBinary(node.value()->node_id());
-  RAY_LOG(DEBUG) << "Preparing resource from node " << node_id
-                 << " for a bundle: " << bundle->DebugString();
+  RAY_LOG(DEBUG) << "Preparing resource from node " << node_id << " for "
+                 << bundles.size() << " bundles of placement group "
+                 << bundles.front()->PlacementGroupId();
+  std::vector<std::shared_ptr<const BundleSpecification>> bundle_specs(bundles.begin(),
+                                                                       bundles.end());
   lease_client->PrepareBundleResources(
-      *bundle, [node_id, bundle, callback](
-                   const Status &status, const rpc::PrepareBundleResourcesReply &reply) {
+      bundle_specs,
+      [node_id, bundles, callback](const Status &status,
+                                   const rpc::PrepareBundleResourcesReply &reply) {
         auto result = reply.success() ? Status::OK()
                                       : Status::IOError("Failed to reserve resource");
         if (result.ok()) {
-          RAY_LOG(DEBUG) << "Finished leasing resource from " << node_id
-                         << " for bundle: " << bundle->DebugString();
+          RAY_LOG(DEBUG) << "Finished leasing resource from " << node_id << " for "
+                         << bundles.size() << " bundles.";
         } else {
-          RAY_LOG(DEBUG) << "Failed to lease resource from " << node_id
-                         << " for bundle: " << bundle->DebugString();
+          RAY_LOG(DEBUG) << "Failed to lease resource from " << node_id << " for "
+                         << bundles.size() << " bundles.";
         }
         callback(result);
       });
 }
 
 void GcsPlacementGroupScheduler::CommitResources(
-    const std::shared_ptr<BundleSpecification> &bundle,
+    const std::vector<std::shared_ptr<BundleSpecification>> &bundles,
     const absl::optional<std::shared_ptr<ray::rpc::GcsNodeInfo>> &node,
     const StatusCallback callback) {
   RAY_CHECK(node.has_value());
   const auto lease_client = GetLeaseClientFromNode(node.value());
   const auto node_id = NodeID::FromBinary(node.value()->node_id());
 
-  RAY_LOG(DEBUG) << "Committing resource to a node " << node_id
-                 << " for a bundle: " << bundle->DebugString();
+  RAY_LOG(DEBUG) << "Committing resource to a node " << node_id << " for "
+                 << bundles.size() << " bundles of placement group "
+                 << bundles.front()->PlacementGroupId();
+  std::vector<std::shared_ptr<const BundleSpecification>> bundle_specs(bundles.begin(),
+                                                                       bundles.end());
   lease_client->CommitBundleResources(
-      *bundle, [bundle, node_id, callback](const Status &status,
-                                           const rpc::CommitBundleResourcesReply &reply) {
+      bundle_specs,
+      [bundles, node_id, callback](const Status &status,
+                                   const rpc::CommitBundleResourcesReply &reply) {
         if (status.ok()) {
-          RAY_LOG(DEBUG) << "Finished committing resource to " << node_id
-                         << " for bundle: " << bundle->DebugString();
+          RAY_LOG(DEBUG) << "Finished committing resource to " << node_id << " for "
+                         << bundles.size() << " bundles.";
         } else {
-          RAY_LOG(DEBUG) << "Failed to commit resource to " << node_id
-                         << " for bundle: " << bundle->DebugString();
+          RAY_LOG(DEBUG) << "Failed to commit resource to " << node_id << " for "
+                         << bundles.size() << " bundles.";
         }
         RAY_CHECK(callback);
         callback(status);
@@ -303,15 +322,22 @@ void GcsPlacementGroupScheduler::CommitAllBundles(
   const std::shared_ptr<BundleLocations> &prepared_bundle_locations =
       lease_status_tracker->GetPreparedBundleLocations();
   lease_status_tracker->MarkCommitPhaseStarted();
+  // Send one commit request to each node, for all the bundles prepared on it.
+  absl::flat_hash_map<NodeID, std::vector<std::shared_ptr<BundleSpecification>>>
+      node_to_bundles;
   for (const auto &bundle_to_commit : *prepared_bundle_locations) {
-    const auto &node_id = bundle_to_commit.second.first;
+    node_to_bundles[bundle_to_commit.second.first].push_back(
+        bundle_to_commit.second.second);
+  }
+  for (const auto &entry : node_to_bundles) {
+    const auto &node_id = entry.first;
     const auto &node = gcs_node_manager_.GetAliveNode(node_id);
-    const auto &bundle = bundle_to_commit.second.second;
+    const auto &bundles = entry.second;
 
-    auto commit_resources_callback = [this, lease_status_tracker, bundle, node_id,
+    auto commit_resources_callback = [this, lease_status_tracker, bundles, node_id,
                                       schedule_failure_handler,
                                       schedule_success_handler](const Status &status) {
-      lease_status_tracker->MarkCommitRequestReturned(node_id, bundle, status);
+      lease_status_tracker->MarkCommitRequestReturned(node_id, bundles, status);
       if (lease_status_tracker->AllCommitRequestReturned()) {
         OnAllBundleCommitRequestReturned(lease_status_tracker, schedule_failure_handler,
                                          schedule_success_handler);
@@ -319,7 +345,7 @@ void GcsPlacementGroupScheduler::CommitAllBundles(
     };
 
     if (node.has_value()) {
-      CommitResources(bundle, node, commit_resources_callback);
+      CommitResources(bundles, node, commit_resources_callback);
     } else {
       RAY_LOG(INFO) << "Failed to commit resources because the node is dead, node id = "
                     << node_id;
@@ -414,11 +440,6 @@ void GcsPlacementGroupScheduler::OnAllBundleCommitRequestReturned(
     return;
   }
 
-  // Acquire bundle resources from gcs resources manager.
-  const auto &committed_bundle_locations =
-      lease_status_tracker->GetCommittedBundleLocations();
-  AcquireBundleResources(committed_bundle_locations);
-
   if (!lease_status_tracker->AllCommitRequestsSuccessful()) {
     // Update the state to be reschedule so that the failure handle will reschedule the
     // failed bundles.
@@ -502,6 +523,87 @@ void GcsPlacementGroupScheduler::ReleaseUnusedBundles(
   }
 }
 
+absl::flat_hash_map<PlacementGroupID, std::vector<int64_t>>
+GcsPlacementGroupScheduler::ReleaseBundlesToFit(
+    const std::shared_ptr<GcsPlacementGroup> &placement_group,
+    const std::function<bool(const PlacementGroupID &)> &is_movable,
+    size_t max_bundles) {
+  absl::flat_hash_map<PlacementGroupID, std::vector<int64_t>> released_bundles;
+  ResourceSet required_resources;
+  for (const auto &bundle : placement_group->GetUnplacedBundles()) {
+    required_resources.AddResources(bundle->GetRequiredResources());
+  }
+
+  // Find the node on which the fewest bundles have to be moved.
+  using BundleLocation =
+      std::pair<BundleID, std::pair<NodeID, std::shared_ptr<BundleSpecification>>>;
+  NodeID target_node_id = NodeID::Nil();
+  std::vector<BundleLocation> bundles_to_move;
+  for (const auto &node : gcs_resource_manager_.GetClusterResources()) {
+    if (!required_resources.IsSubset(node.second.GetTotalResources())) {
+      continue;
+    }
+    auto available_resources = node.second.GetAvailableResources();
+    if (required_resources.IsSubset(available_resources)) {
+      // The placement group fits already.
+      return released_bundles;
+    }
+    const auto &maybe_bundle_locations =
+        committed_bundle_location_index_.GetBundleLocationsOnNode(node.first);
+    if (!maybe_bundle_locations.has_value()) {
+      continue;
+    }
+    std::vector<BundleLocation> candidates;
+    for (const auto &bundle : *maybe_bundle_locations.value()) {
+      if (candidates.size() >= max_bundles ||
+          required_resources.IsSubset(available_resources)) {
+        break;
+      }
+      const auto &bundle_placement_group_id = bundle.first.first;
+      if (placement_group_leasing_in_progress_.contains(bundle_placement_group_id) ||
+          !is_movable(bundle_placement_group_id)) {
+        continue;
+      }
+      available_resources.AddResources(bundle.second.second->GetRequiredResources());
+      candidates.push_back(bundle);
+    }
+    if (required_resources.IsSubset(available_resources) &&
+        (target_node_id.IsNil() || candidates.size() < bundles_to_move.size())) {
+      target_node_id = node.first;
+      bundles_to_move = std::move(candidates);
+    }
+  }
+  if (target_node_id.IsNil()) {
+    return released_bundles;
+  }
+
+  // Only move the bundles if they can be placed again on the other nodes.
+  std::vector<ResourceSet> moved_resources;
+  for (const auto &bundle : bundles_to_move) {
+    moved_resources.push_back(bundle.second.second->GetRequiredResources());
+  }
+  const auto selected_nodes = gcs_resource_scheduler_.Schedule(
+      moved_resources, SchedulingType::PACK,
+      [&target_node_id](const NodeID &node_id) { return node_id != target_node_id; });
+  if (selected_nodes.empty()) {
+    return released_bundles;
+  }
+
+  const auto target_node = gcs_node_manager_.GetAliveNode(target_node_id);
+  for (const auto &bundle : bundles_to_move) {
+    const auto &bundle_spec = bundle.second.second;
+    RAY_LOG(INFO) << "Moving bundle " << bundle_spec->DebugString() << " off node "
+                  << target_node_id << " to make room for placement group "
+                  << placement_group->GetPlacementGroupID();
+    CancelResourceReserve(bundle_spec, target_node);
+    gcs_resource_manager_.ReleaseResources(target_node_id,
+                                           bundle_spec->GetRequiredResources());
+    committed_bundle_location_index_.Erase(bundle.first);
+    released_bundles[bundle.first.first].push_back(bundle.first.second);
+  }
+  return released_bundles;
+}
+
 void GcsPlacementGroupScheduler::DestroyPlacementGroupPreparedBundleResources(
     const PlacementGroupID &placement_group_id) {
   // Get the locations of prepared bundles.
@@ -630,6 +732,24 @@ bool BundleLocationIndex::Erase(const PlacementGroupID &placement_group_id) {
   return true;
 }
 
+bool BundleLocationIndex::Erase(const BundleID &bundle_id) {
+  auto it = placement_group_to_bundle_locations_.find(bundle_id.first);
+  if (it == placement_group_to_bundle_locations_.end()) {
+    return false;
+  }
+  auto bundle_it = it->second->find(bundle_id);
+  if (bundle_it == it->second->end()) {
+    return false;
+  }
+  const auto &node_id = bundle_it->second.first;
+  const auto leased_bundles_it = node_to_leased_bundles_.find(node_id);
+  if (leased_bundles_it != node_to_leased_bundles_.end()) {
+    leased_bundles_it->second->erase(bundle_id);
+  }
+  it->second->erase(bundle_it);
+  return true;
+}
+
 const absl::optional<std::shared_ptr<BundleLocations> const>
 BundleLocationIndex::GetBundleLocations(const PlacementGroupID &placement_group_id) {
   auto it = placement_group_to_bundle_locations_.find(placement_group_id);
@@ -674,33 +794,42 @@ LeaseStatusTracker::LeaseStatusTracker(
 }
 
 bool LeaseStatusTracker::MarkPreparePhaseStarted(
-    const NodeID &node_id, std::shared_ptr<BundleSpecification> bundle) {
-  const auto &bundle_id = bundle->BundleId();
-  return node_to_bundles_when_preparing_[node_id].emplace(bundle_id).second;
+    const NodeID &node_id,
+    const std::vector<std::shared_ptr<BundleSpecification>> &bundles) {
+  bool started = true;
+  auto &leasing_bundles = node_to_bundles_when_preparing_[node_id];
+  for (const auto &bundle : bundles) {
+    started = leasing_bundles.emplace(bundle->BundleId()).second && started;
+  }
+  return started;
 }
 
 void LeaseStatusTracker::MarkPrepareRequestReturned(
-    const NodeID &node_id, const std::shared_ptr<BundleSpecification> bundle,
+    const NodeID &node_id,
+    const std::vector<std::shared_ptr<BundleSpecification>> &bundles,
     const Status &status) {
-  RAY_CHECK(prepare_request_returned_count_ <= bundles_to_schedule_.size());
+  RAY_CHECK(prepare_request_returned_count_ + bundles.size() <=
+            bundles_to_schedule_.size());
   auto leasing_bundles = node_to_bundles_when_preparing_.find(node_id);
   RAY_CHECK(leasing_bundles != node_to_bundles_when_preparing_.end());
-  auto bundle_iter = leasing_bundles->second.find(bundle->BundleId());
-  RAY_CHECK(bundle_iter != leasing_bundles->second.end());
+  for (const auto &bundle : bundles) {
+    const auto &bundle_id = bundle->BundleId();
+    auto bundle_iter = leasing_bundles->second.find(bundle_id);
+    RAY_CHECK(bundle_iter != leasing_bundles->second.end());
+
+    // Remove the bundle from the leasing map as the reply is returned from the
+    // remote node.
+    leasing_bundles->second.erase(bundle_iter);
 
-  // Remove the bundle from the leasing map as the reply is returned from the
-  // remote node.
-  leasing_bundles->second.erase(bundle_iter);
+    // If the request succeeds, record it.
+    if (status.ok()) {
+      preparing_bundle_locations_->emplace(bundle_id, std::make_pair(node_id, bundle));
+    }
+  }
   if (leasing_bundles->second.empty()) {
     node_to_bundles_when_preparing_.erase(leasing_bundles);
   }
-
-  // If the request succeeds, record it.
-  const auto &bundle_id = bundle->BundleId();
-  if (status.ok()) {
-    preparing_bundle_locations_->emplace(bundle_id, std::make_pair(node_id, bundle));
-  }
-  prepare_request_returned_count_ += 1;
+  prepare_request_returned_count_ += bundles.size();
 }
 
 bool LeaseStatusTracker::AllPrepareRequestsReturned() const {
@@ -714,15 +843,18 @@ bool LeaseStatusTracker::AllPrepareRequestsSuccessful() const {
 }
 
 void LeaseStatusTracker::MarkCommitRequestReturned(
-    const NodeID &node_id, const std::shared_ptr<BundleSpecification> bundle,
+    const NodeID &node_id,
+    const std::vector<std::shared_ptr<BundleSpecification>> &bundles,
     const Status &status) {
-  commit_request_returned_count_ += 1;
-  // If the request succeeds, record it.
-  const auto &bundle_id = bundle->BundleId();
-  if (!status.ok()) {
-    uncommitted_bundle_locations_->emplace(bundle_id, std::make_pair(node_id, bundle));
-  } else {
-    committed_bundle_locations_->emplace(bundle_id, std::make_pair(node_id, bundle));
+  commit_request_returned_count_ += bundles.size();
+  for (const auto &bundle : bundles) {
+    // If the request succeeds, record it.
+    const auto &bundle_id = bundle->BundleId();
+    if (!status.ok()) {
+      uncommitted_bundle_locations_->emplace(bundle_id, std::make_pair(node_id, bundle));
+    } else {
+      committed_bundle_locations_->emplace(bundle_id, std::make_pair(node_id, bundle));
+    }
   }
 }
 
@@ -85,6 +85,19 @@ class GcsPlacementGroupSchedulerInterface {
   virtual void ReleaseUnusedBundles(
       const std::unordered_map<NodeID, std::vector<rpc::Bundle>> &node_to_bundles) = 0;
 
+  /// Release committed bundles of other placement groups, so that a placement group
+  /// which fits on no node fits on one. The released bundles must fit on the other
+  /// nodes.
+  ///
+  /// \param placement_group The placement group to make room for.
+  /// \param is_movable Whether the bundles of a placement group may be released.
+  /// \param max_bundles The maximum number of bundles to release.
+  /// \return The released bundles, empty if no room could be made.
+  virtual absl::flat_hash_map<PlacementGroupID, std::vector<int64_t>> ReleaseBundlesToFit(
+      const std::shared_ptr<GcsPlacementGroup> &placement_group,
+      const std::function<bool(const PlacementGroupID &)> &is_movable,
+      size_t max_bundles) = 0;
+
   virtual ~GcsPlacementGroupSchedulerInterface() {}
 };
 
@@ -185,23 +198,25 @@ class LeaseStatusTracker {
       const ScheduleMap &schedule_map);
   ~LeaseStatusTracker() = default;
 
-  /// Indicate the tracker that prepare requests are sent to a specific node.
+  /// Indicate the tracker that a prepare request is sent to a specific node.
   ///
   /// \param node_id Id of a node where prepare request is sent.
-  /// \param bundle Bundle specification the node is supposed to prepare.
+  /// \param bundles Bundle specifications the node is supposed to prepare.
   /// \return False if the prepare phase was already started. True otherwise.
-  bool MarkPreparePhaseStarted(const NodeID &node_id,
-                               std::shared_ptr<BundleSpecification> bundle);
+  bool MarkPreparePhaseStarted(
+      const NodeID &node_id,
+      const std::vector<std::shared_ptr<BundleSpecification>> &bundles);
 
-  /// Indicate the tracker that all prepare requests are returned.
+  /// Indicate the tracker that a prepare request is returned.
   ///
   /// \param node_id Id of a node where prepare request is returned.
-  /// \param bundle Bundle specification the node was supposed to schedule.
+  /// \param bundles Bundle specifications the node was supposed to schedule.
   /// \param status Status of the prepare response.
   /// \param void
-  void MarkPrepareRequestReturned(const NodeID &node_id,
-                                  std::shared_ptr<BundleSpecification> bundle,
-                                  const Status &status);
+  void MarkPrepareRequestReturned(
+      const NodeID &node_id,
+      const std::vector<std::shared_ptr<BundleSpecification>> &bundles,
+      const Status &status);
 
   /// Used to know if all prepare requests are returned.
   ///
@@ -213,14 +228,15 @@ class LeaseStatusTracker {
   /// \return True if all prepare requests were successful.
   bool AllPrepareRequestsSuccessful() const;
 
-  /// Indicate the tracker that the commit request of a bundle from a node has returned.
+  /// Indicate the tracker that the commit request of bundles from a node has returned.
   ///
   /// \param node_id Id of a node where commit request is returned.
-  /// \param bundle Bundle specification the node was supposed to schedule.
+  /// \param bundles Bundle specifications the node was supposed to schedule.
   /// \param status Status of the returned commit request.
-  void MarkCommitRequestReturned(const NodeID &node_id,
-                                 const std::shared_ptr<BundleSpecification> bundle,
-                                 const Status &status);
+  void MarkCommitRequestReturned(
+      const NodeID &node_id,
+      const std::vector<std::shared_ptr<BundleSpecification>> &bundles,
+      const Status &status);
 
   /// Used to know if all commit requests are returend.
   ///
@@ -345,6 +361,12 @@ class BundleLocationIndex {
   /// \return True if succeed. False otherwise.
   bool Erase(const PlacementGroupID &placement_group_id);
 
+  /// Erase the location of a single bundle.
+  ///
+  /// \param bundle_id The id of the bundle.
+  /// \return True if succeed. False otherwise.
+  bool Erase(const BundleID &bundle_id);
+
   /// Get BundleLocation of placement group id.
   ///
   /// \param placement_group_id Placement group id of this bundle locations.
@@ -442,25 +464,40 @@ class GcsPlacementGroupScheduler : public GcsPlacementGroupSchedulerInterface {
   void ReleaseUnusedBundles(const std::unordered_map<NodeID, std::vector<rpc::Bundle>>
                                 &node_to_bundles) override;
 
+  /// Release committed bundles of other placement groups, so that a placement group
+  /// which fits on no node fits on one. The node which needs the fewest bundles moved
+  /// is picked, and the released bundles must fit on the other nodes with the current
+  /// resources.
+  ///
+  /// \param placement_group The placement group to make room for.
+  /// \param is_movable Whether the bundles of a placement group may be released.
+  /// \param max_bundles The maximum number of bundles to release.
+  /// \return The released bundles, empty if no room could be made.
+  absl::flat_hash_map<PlacementGroupID, std::vector<int64_t>> ReleaseBundlesToFit(
+      const std::shared_ptr<GcsPlacementGroup> &placement_group,
+      const std::function<bool(const PlacementGroupID &)> &is_movable,
+      size_t max_bundles) override;
+
  protected:
-  /// Send a bundle PREPARE request to a node. The PREPARE request will lock resources
-  /// on a node until COMMIT or CANCEL requests are sent to a node.
+  /// Send a PREPARE request for all the bundles scheduled on a node. The PREPARE
+  /// request will lock resources on a node until COMMIT or CANCEL requests are sent to
+  /// a node.
   ///
-  /// \param bundle A bundle to schedule on a node.
-  /// \param node A node to prepare resources for a given bundle.
+  /// \param bundles Bundles to schedule on a node.
+  /// \param node A node to prepare resources for the given bundles.
   /// \param callback
   void PrepareResources(
-      const std::shared_ptr<BundleSpecification> &bundle,
+      const std::vector<std::shared_ptr<BundleSpecification>> &bundles,
       const absl::optional<std::shared_ptr<ray::rpc::GcsNodeInfo>> &node,
       const StatusCallback &callback);
 
-  /// Send a bundle COMMIT request to a node. This means the placement group creation
-  /// is ready and GCS will commit resources on a given node.
+  /// Send a COMMIT request for all the bundles prepared on a node. This means the
+  /// placement group creation is ready and GCS will commit resources on a given node.
   ///
-  /// \param bundle A bundle to schedule on a node.
-  /// \param node A node to commit resources for a given bundle.
+  /// \param bundles Bundles to schedule on a node.
+  /// \param node A node to commit resources for the given bundles.
   /// \param callback
-  void CommitResources(const std::shared_ptr<BundleSpecification> &bundle,
+  void CommitResources(const std::vector<std::shared_ptr<BundleSpecification>> &bundles,
                        const absl::optional<std::shared_ptr<ray::rpc::GcsNodeInfo>> &node,
                        const StatusCallback callback);
 
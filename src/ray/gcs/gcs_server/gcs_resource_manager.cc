@@ -180,19 +180,88 @@ void GcsResourceManager::HandleGetAllAvailableResources(
   ++counts_[CountType::GET_ALL_AVAILABLE_RESOURCES_REQUEST];
 }
 
+void GcsResourceManager::HandleGetAllTotalResources(
+    const rpc::GetAllTotalResourcesRequest &request,
+    rpc::GetAllTotalResourcesReply *reply, rpc::SendReplyCallback send_reply_callback) {
+  for (const auto &iter : cluster_scheduling_resources_) {
+    auto resource = reply->add_resources_list();
+    resource->set_node_id(iter.first.Binary());
+    for (const auto &res : iter.second.GetTotalResources().GetResourceMap()) {
+      (*resource->mutable_resources_total())[res.first] = res.second;
+    }
+  }
+  GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
+  ++counts_[CountType::GET_ALL_TOTAL_RESOURCES_REQUEST];
+}
+
+namespace {
+
+/// Apply the resources of a report to a map of resources. A delta only overwrites the
+/// resources it holds, and a full snapshot replaces the map. Resources with nothing
+/// left are removed, because ResourceSet and its users expect positive amounts.
+void ApplyResources(const google::protobuf::Map<std::string, double> &report,
+                    bool is_delta, google::protobuf::Map<std::string, double> *resources) {
+  if (!is_delta) {
+    resources->clear();
+  }
+  for (const auto &entry : report) {
+    if (entry.second > 0) {
+      (*resources)[entry.first] = entry.second;
+    } else {
+      resources->erase(entry.first);
+    }
+  }
+}
+
+/// Fold a newer report of a node into an older one that has not been broadcast yet,
+/// so that the changes of both reach the receivers.
+void MergeResourceReport(const rpc::ResourcesData &newer, rpc::ResourcesData *older) {
+  rpc::ResourcesData merged = newer;
+  if (newer.resources_delta()) {
+    // The newer entries win. Entries of the older report stay, including zeros,
+    // which receivers of a delta need to see.
+    merged.mutable_resources_total()->insert(older->resources_total().begin(),
+                                             older->resources_total().end());
+    if (newer.resources_available_changed() || older->resources_available_changed()) {
+      merged.mutable_resources_available()->insert(
+          older->resources_available().begin(), older->resources_available().end());
+      merged.set_resources_available_changed(true);
+    }
+    merged.set_resources_delta(older->resources_delta());
+  }
+  if (!newer.resource_load_changed() && older->resource_load_changed()) {
+    *merged.mutable_resource_load() = older->resource_load();
+    merged.set_resource_load_changed(true);
+  }
+  merged.set_should_global_gc(newer.should_global_gc() || older->should_global_gc());
+  older->Swap(&merged);
+}
+
+}  // namespace
+
 void GcsResourceManager::UpdateFromResourceReport(const rpc::ResourcesData &data) {
   NodeID node_id = NodeID::FromBinary(data.node_id());
+  auto usage_iter = node_resource_usages_.find(node_id);
+  if (usage_iter != node_resource_usages_.end() && data.resources_version() > 0 &&
+      data.resources_version() <= usage_iter->second.resources_version()) {
+    // This report is older than the last one we applied.
+    return;
+  }
   auto resources_data = std::make_shared<rpc::ResourcesData>();
   resources_data->CopyFrom(data);
 
   if (RayConfig::instance().gcs_task_scheduling_enabled()) {
     UpdateNodeNormalTaskResources(node_id, *resources_data);
   } else {
-    if (node_resource_usages_.count(node_id) == 0 ||
+    if (usage_iter == node_resource_usages_.end() ||
         resources_data->resources_available_changed()) {
-      const auto &resource_changed =
-          MapFromProtobuf(resources_data->resources_available());
-      SetAvailableResources(node_id, ResourceSet(resource_changed));
+      google::protobuf::Map<std::string, double> resources_available;
+      if (usage_iter != node_resource_usages_.end()) {
+        resources_available = usage_iter->second.resources_available();
+      }
+      ApplyResources(resources_data->resources_available(),
+                     resources_data->resources_delta(), &resources_available);
+      SetAvailableResources(node_id, ResourceSet(MapFromProtobuf(resources_available)));
     }
   }
 
@@ -202,7 +271,12 @@ void GcsResourceManager::UpdateFromResourceReport(const rpc::ResourcesData &data
       resources_data->resources_available_changed() ||
       resources_data->resource_load_changed()) {
     absl::MutexLock guard(&resource_buffer_mutex_);
-    resources_buffer_[node_id] = *resources_data;
+    auto buffer_iter = resources_buffer_.find(node_id);
+    if (buffer_iter == resources_buffer_.end()) {
+      resources_buffer_.emplace(node_id, *resources_data);
+    } else {
+      MergeResourceReport(*resources_data, &buffer_iter->second);
+    }
   }
 }
 
@@ -220,29 +294,11 @@ void GcsResourceManager::HandleGetAllResourceUsage(
     rpc::SendReplyCallback send_reply_callback) {
   if (!node_resource_usages_.empty()) {
     auto batch = std::make_shared<rpc::ResourceUsageBatchData>();
-    absl::flat_hash_map<ResourceSet, rpc::ResourceDemand> aggregate_load;
     for (const auto &usage : node_resource_usages_) {
-      // Aggregate the load reported by each raylet.
-      auto load = usage.second.resource_load_by_shape();
-      for (const auto &demand : load.resource_demands()) {
-        auto scheduling_key = ResourceSet(MapFromProtobuf(demand.shape()));
-        auto &aggregate_demand = aggregate_load[scheduling_key];
-        aggregate_demand.set_num_ready_requests_queued(
-            aggregate_demand.num_ready_requests_queued() +
-            demand.num_ready_requests_queued());
-        aggregate_demand.set_num_infeasible_requests_queued(
-            aggregate_demand.num_infeasible_requests_queued() +
-            demand.num_infeasible_requests_queued());
-        if (RayConfig::instance().report_worker_backlog()) {
-          aggregate_demand.set_backlog_size(aggregate_demand.backlog_size() +
-                                            demand.backlog_size());
-        }
-      }
-
       batch->add_batch()->CopyFrom(usage.second);
     }
 
-    for (const auto &demand : aggregate_load) {
+    for (const auto &demand : aggregate_load_) {
       auto demand_proto = batch->mutable_resource_load_by_shape()->add_resource_demands();
       demand_proto->CopyFrom(demand.second);
       for (const auto &resource_pair : demand.first.GetResourceMap()) {
@@ -264,19 +320,53 @@ void GcsResourceManager::HandleGetAllResourceUsage(
   ++counts_[CountType::GET_ALL_RESOURCE_USAGE_REQUEST];
 }
 
+void GcsResourceManager::UpdateAggregateLoad(const rpc::ResourceLoad &load, int sign) {
+  for (const auto &demand : load.resource_demands()) {
+    auto scheduling_key = ResourceSet(MapFromProtobuf(demand.shape()));
+    auto &aggregate_demand = aggregate_load_[scheduling_key];
+    aggregate_demand.set_num_ready_requests_queued(
+        aggregate_demand.num_ready_requests_queued() +
+        sign * demand.num_ready_requests_queued());
+    aggregate_demand.set_num_infeasible_requests_queued(
+        aggregate_demand.num_infeasible_requests_queued() +
+        sign * demand.num_infeasible_requests_queued());
+    if (RayConfig::instance().report_worker_backlog()) {
+      aggregate_demand.set_backlog_size(aggregate_demand.backlog_size() +
+                                        sign * demand.backlog_size());
+    }
+    if (aggregate_demand.num_ready_requests_queued() == 0 &&
+        aggregate_demand.num_infeasible_requests_queued() == 0 &&
+        aggregate_demand.backlog_size() == 0) {
+      aggregate_load_.erase(scheduling_key);
+    }
+  }
+}
+
 void GcsResourceManager::UpdateNodeResourceUsage(const NodeID &node_id,
                                                  const rpc::ResourcesData &resources) {
   auto iter = node_resource_usages_.find(node_id);
+  if (iter != node_resource_usages_.end()) {
+    UpdateAggregateLoad(iter->second.resource_load_by_shape(), -1);
+  }
+  UpdateAggregateLoad(resources.resource_load_by_shape(), 1);
   if (iter == node_resource_usages_.end()) {
-    auto resources_data = std::make_shared<rpc::ResourcesData>();
-    resources_data->CopyFrom(resources);
-    node_resource_usages_[node_id] = *resources_data;
+    auto &usage = node_resource_usages_[node_id];
+    usage.CopyFrom(resources);
+    usage.clear_resources_total();
+    usage.clear_resources_available();
+    ApplyResources(resources.resources_total(), /*is_delta=*/false,
+                   usage.mutable_resources_total());
+    ApplyResources(resources.resources_available(), /*is_delta=*/false,
+                   usage.mutable_resources_available());
   } else {
+    // The stored usage is always complete, so deltas are applied on top of it.
     if (resources.resources_total_size() > 0) {
-      (*iter->second.mutable_resources_total()) = resources.resources_total();
+      ApplyResources(resources.resources_total(), resources.resources_delta(),
+                     iter->second.mutable_resources_total());
     }
     if (resources.resources_available_changed()) {
-      (*iter->second.mutable_resources_available()) = resources.resources_available();
+      ApplyResources(resources.resources_available(), resources.resources_delta(),
+                     iter->second.mutable_resources_available());
     }
     if (resources.resource_load_changed()) {
       (*iter->second.mutable_resource_load()) = resources.resource_load();
@@ -285,6 +375,9 @@ void GcsResourceManager::UpdateNodeResourceUsage(const NodeID &node_id,
       (*iter->second.mutable_resources_normal_task()) = resources.resources_normal_task();
     }
     (*iter->second.mutable_resource_load_by_shape()) = resources.resource_load_by_shape();
+    iter->second.set_object_pulls_queued(resources.object_pulls_queued());
+    iter->second.set_memory_pressure(resources.memory_pressure());
+    iter->second.set_resources_version(resources.resources_version());
   }
 }
 
@@ -355,7 +448,11 @@ void GcsResourceManager::OnNodeDead(const NodeID &node_id) {
     absl::MutexLock guard(&resource_buffer_mutex_);
     resources_buffer_.erase(node_id);
   }
-  node_resource_usages_.erase(node_id);
+  auto usage_iter = node_resource_usages_.find(node_id);
+  if (usage_iter != node_resource_usages_.end()) {
+    UpdateAggregateLoad(usage_iter->second.resource_load_by_shape(), -1);
+    node_resource_usages_.erase(usage_iter);
+  }
   cluster_scheduling_resources_.erase(node_id);
 }
 
@@ -439,7 +536,9 @@ std::string GcsResourceManager::DebugString() const {
          << ", ReportResourceUsage request count: "
          << counts_[CountType::REPORT_RESOURCE_USAGE_REQUEST]
          << ", GetAllResourceUsage request count: "
-         << counts_[CountType::GET_ALL_RESOURCE_USAGE_REQUEST] << "}";
+         << counts_[CountType::GET_ALL_RESOURCE_USAGE_REQUEST]
+         << ", GetAllTotalResources request count: "
+         << counts_[CountType::GET_ALL_TOTAL_RESOURCES_REQUEST] << "}";
   return stream.str();
 }
 
@@ -70,6 +70,11 @@ class GcsResourceManager : public rpc::NodeResourceInfoHandler {
       rpc::GetAllAvailableResourcesReply *reply,
       rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Handle get total resources of all nodes.
+  void HandleGetAllTotalResources(const rpc::GetAllTotalResourcesRequest &request,
+                                  rpc::GetAllTotalResourcesReply *reply,
+                                  rpc::SendReplyCallback send_reply_callback) override;
+
   /// Handle report resource usage rpc come from raylet.
   void HandleReportResourceUsage(const rpc::ReportResourceUsageRequest &request,
                                  rpc::ReportResourceUsageReply *reply,
@@ -175,6 +180,12 @@ class GcsResourceManager : public rpc::NodeResourceInfoHandler {
   /// Send any buffered resource usage as a single publish.
   void SendBatchedResourceUsage();
 
+  /// Add the load of a node to the aggregate load of the cluster, or remove it.
+  ///
+  /// \param load The load by shape reported by the node.
+  /// \param sign 1 to add the load, -1 to remove it.
+  void UpdateAggregateLoad(const rpc::ResourceLoad &load, int sign);
+
   /// Prelocked version of GetResourceUsageBatchForBroadcast. This is necessary for need
   /// the functionality as part of a larger transaction.
   void GetResourceUsageBatchForBroadcast_Locked(rpc::ResourceUsageBatchData &buffer)
@@ -184,6 +195,10 @@ class GcsResourceManager : public rpc::NodeResourceInfoHandler {
   PeriodicalRunner periodical_runner_;
   /// Newest resource usage of all nodes.
   absl::flat_hash_map<NodeID, rpc::ResourcesData> node_resource_usages_;
+  /// The sum of the load by shape in `node_resource_usages_`. It is updated with each
+  /// report, so that replying with the cluster load costs O(shapes) rather than
+  /// O(nodes * shapes).
+  absl::flat_hash_map<ResourceSet, rpc::ResourceDemand> aggregate_load_;
 
   /// Protect the lightweight heartbeat deltas which are accessed by different threads.
   absl::Mutex resource_buffer_mutex_;
@@ -217,7 +232,8 @@ class GcsResourceManager : public rpc::NodeResourceInfoHandler {
     GET_ALL_AVAILABLE_RESOURCES_REQUEST = 3,
     REPORT_RESOURCE_USAGE_REQUEST = 4,
     GET_ALL_RESOURCE_USAGE_REQUEST = 5,
-    CountType_MAX = 6,
+    GET_ALL_TOTAL_RESOURCES_REQUEST = 6,
+    CountType_MAX = 7,
   };
   uint64_t counts_[CountType::CountType_MAX] = {0};
 };
@@ -49,7 +49,7 @@ double LeastResourceScorer::Calculate(const FixedPoint &requested,
   if (requested > available) {
     return -1;
   }
-  return (available - requested).Double() / available.Double();
+  return static_cast<double>((available - requested).Raw()) / available.Raw();
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////
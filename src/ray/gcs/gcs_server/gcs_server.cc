@@ -14,6 +14,8 @@
 
 #include "ray/gcs/gcs_server/gcs_server.h"
 
+#include <thread>
+
 #include "ray/common/asio/asio_util.h"
 #include "ray/common/asio/instrumented_io_context.h"
 #include "ray/common/network_util.h"
@@ -24,6 +26,7 @@
 #include "ray/gcs/gcs_server/gcs_object_manager.h"
 #include "ray/gcs/gcs_server/gcs_placement_group_manager.h"
 #include "ray/gcs/gcs_server/gcs_worker_manager.h"
+#include "ray/gcs/gcs_server/grpc_based_gcs_pub_sub.h"
 #include "ray/gcs/gcs_server/stats_handler_impl.h"
 #include "ray/gcs/gcs_server/task_info_handler_impl.h"
 #include "ray/stats/stats.h"
@@ -38,7 +41,8 @@ GcsServer::GcsServer(const ray::gcs::GcsServerConfig &config,
       main_service_(main_service),
       rpc_server_(config.grpc_server_name, config.grpc_server_port,
                   config.grpc_server_thread_num,
-                  /*keepalive_time_ms=*/RayConfig::instance().grpc_keepalive_time_ms()),
+                  /*keepalive_time_ms=*/RayConfig::instance().grpc_keepalive_time_ms(),
+                  config.grpc_server_priority_thread_num),
       client_call_manager_(main_service),
       raylet_client_pool_(
           std::make_shared<rpc::NodeManagerClientPool>(client_call_manager_)),
@@ -87,21 +91,35 @@ void GcsServer::Start() {
       main_service_, redis_client_->GetPrimaryContext(), [this]() { Stop(); });
   gcs_redis_failure_detector_->Start();
 
-  // Init gcs pub sub instance.
-  gcs_pub_sub_ = std::make_shared<gcs::GcsPubSub>(redis_client_);
-
   if (config_.grpc_pubsub_enabled) {
-    // Init grpc based pubsub
-    // TODO(before merging): Make these constants configurable.
+    // Init grpc based pubsub. Actor, job and node messages are published to both
+    // Redis and the grpc based subscribers.
     grpc_pubsub_publisher_.reset(new pubsub::Publisher(
         /*periodical_runner=*/&pubsub_periodical_runner_,
         /*get_time_ms=*/[]() { return absl::GetCurrentTimeNanos() / 1e6; },
         /*subscriber_timeout_ms=*/RayConfig::instance().subscriber_timeout_ms(),
-        /*publish_batch_size_=*/RayConfig::instance().publish_batch_size()));
+        /*publish_batch_size_=*/RayConfig::instance().publish_batch_size(),
+        /*publish_batch_window_ms=*/
+        RayConfig::instance().gcs_publish_batch_window_ms()));
+    auto grpc_based_pub_sub =
+        std::make_shared<GrpcBasedGcsPubSub>(redis_client_, grpc_pubsub_publisher_);
+    pubsub_service_ = std::make_unique<rpc::PublisherGrpcService>(main_service_,
+                                                                 *grpc_based_pub_sub);
+    rpc_server_.RegisterService(*pubsub_service_);
+    gcs_pub_sub_ = std::move(grpc_based_pub_sub);
+  } else {
+    // Init gcs pub sub instance.
+    gcs_pub_sub_ = std::make_shared<gcs::GcsPubSub>(redis_client_);
   }
 
   // Init gcs table storage.
-  gcs_table_storage_ = std::make_shared<gcs::RedisGcsTableStorage>(redis_client_);
+  const auto &storage_file_path = RayConfig::instance().gcs_storage_file_path();
+  if (!storage_file_path.empty()) {
+    gcs_table_storage_ =
+        std::make_shared<gcs::FileGcsTableStorage>(main_service_, storage_file_path);
+  } else {
+    gcs_table_storage_ = std::make_shared<gcs::RedisGcsTableStorage>(redis_client_);
+  }
 
   // Load gcs tables data asynchronously.
   auto gcs_init_data = std::make_shared<GcsInitData>(gcs_table_storage_);
@@ -110,16 +128,16 @@ void GcsServer::Start() {
 
 void GcsServer::DoStart(const GcsInitData &gcs_init_data) {
   // Init gcs resource manager.
-  InitGcsResourceManager(gcs_init_data);
+  InitGcsResourceManager();
 
   // Init gcs resource scheduler.
   InitGcsResourceScheduler();
 
   // Init gcs node manager.
-  InitGcsNodeManager(gcs_init_data);
+  InitGcsNodeManager();
 
   // Init gcs heartbeat manager.
-  InitGcsHeartbeatManager(gcs_init_data);
+  InitGcsHeartbeatManager();
 
   // Init KV Manager
   InitKVManager();
@@ -128,7 +146,14 @@ void GcsServer::DoStart(const GcsInitData &gcs_init_data) {
   InitRuntimeEnvManager();
 
   // Init gcs job manager.
-  InitGcsJobManager(gcs_init_data);
+  InitGcsJobManager();
+
+  // Init object manager.
+  InitObjectManager();
+
+  // Load the tables data into the managers above before the placement group and
+  // actor managers recover, which schedules work on the nodes.
+  LoadManagersFromTables(gcs_init_data);
 
   // Init gcs placement group manager.
   InitGcsPlacementGroupManager(gcs_init_data);
@@ -136,9 +161,6 @@ void GcsServer::DoStart(const GcsInitData &gcs_init_data) {
   // Init gcs actor manager.
   InitGcsActorManager(gcs_init_data);
 
-  // Init object manager.
-  InitObjectManager(gcs_init_data);
-
   // Init gcs worker manager.
   InitGcsWorkerManager();
 
@@ -190,7 +212,9 @@ void GcsServer::Stop() {
     // time, causing many nodes die after GCS's failure.
     gcs_heartbeat_manager_->Stop();
 
-    gcs_resource_report_poller_->Stop();
+    if (gcs_resource_report_poller_ != nullptr) {
+      gcs_resource_report_poller_->Stop();
+    }
 
     if (config_.grpc_based_resource_broadcast) {
       grpc_based_resource_broadcaster_->Stop();
@@ -207,18 +231,16 @@ void GcsServer::Stop() {
   }
 }
 
-void GcsServer::InitGcsNodeManager(const GcsInitData &gcs_init_data) {
+void GcsServer::InitGcsNodeManager() {
   RAY_CHECK(redis_client_ && gcs_table_storage_ && gcs_pub_sub_);
   gcs_node_manager_ = std::make_shared<GcsNodeManager>(gcs_pub_sub_, gcs_table_storage_);
-  // Initialize by gcs tables data.
-  gcs_node_manager_->Initialize(gcs_init_data);
   // Register service.
   node_info_service_.reset(
       new rpc::NodeInfoGrpcService(main_service_, *gcs_node_manager_));
   rpc_server_.RegisterService(*node_info_service_);
 }
 
-void GcsServer::InitGcsHeartbeatManager(const GcsInitData &gcs_init_data) {
+void GcsServer::InitGcsHeartbeatManager() {
   RAY_CHECK(gcs_node_manager_);
   gcs_heartbeat_manager_ = std::make_shared<GcsHeartbeatManager>(
       heartbeat_manager_io_service_, /*on_node_death_callback=*/
@@ -227,21 +249,17 @@ void GcsServer::InitGcsHeartbeatManager(const GcsInitData &gcs_init_data) {
             [this, node_id] { return gcs_node_manager_->OnNodeFailure(node_id); },
             "GcsServer.NodeDeathCallback");
       });
-  // Initialize by gcs tables data.
-  gcs_heartbeat_manager_->Initialize(gcs_init_data);
   // Register service.
   heartbeat_info_service_.reset(new rpc::HeartbeatInfoGrpcService(
       heartbeat_manager_io_service_, *gcs_heartbeat_manager_));
-  rpc_server_.RegisterService(*heartbeat_info_service_);
+  rpc_server_.RegisterService(*heartbeat_info_service_, /*priority=*/true);
 }
 
-void GcsServer::InitGcsResourceManager(const GcsInitData &gcs_init_data) {
+void GcsServer::InitGcsResourceManager() {
   RAY_CHECK(gcs_table_storage_ && gcs_pub_sub_);
   gcs_resource_manager_ = std::make_shared<GcsResourceManager>(
       main_service_, gcs_pub_sub_, gcs_table_storage_,
       !config_.grpc_based_resource_broadcast);
-  // Initialize by gcs tables data.
-  gcs_resource_manager_->Initialize(gcs_init_data);
   // Register service.
   node_resource_info_service_.reset(
       new rpc::NodeResourceInfoGrpcService(main_service_, *gcs_resource_manager_));
@@ -254,11 +272,10 @@ void GcsServer::InitGcsResourceScheduler() {
       std::make_shared<GcsResourceScheduler>(*gcs_resource_manager_);
 }
 
-void GcsServer::InitGcsJobManager(const GcsInitData &gcs_init_data) {
+void GcsServer::InitGcsJobManager() {
   RAY_CHECK(gcs_table_storage_ && gcs_pub_sub_);
   gcs_job_manager_ = std::make_unique<GcsJobManager>(gcs_table_storage_, gcs_pub_sub_,
                                                      *runtime_env_manager_);
-  gcs_job_manager_->Initialize(gcs_init_data);
   // Register service.
   job_info_service_ =
       std::make_unique<rpc::JobInfoGrpcService>(main_service_, *gcs_job_manager_);
@@ -326,7 +343,28 @@ void GcsServer::InitGcsPlacementGroupManager(const GcsInitData &gcs_init_data) {
 
   gcs_placement_group_manager_ = std::make_shared<GcsPlacementGroupManager>(
       main_service_, scheduler, gcs_table_storage_, *gcs_resource_manager_,
-      [this](const JobID &job_id) { return gcs_job_manager_->GetRayNamespace(job_id); });
+      [this](const JobID &job_id) { return gcs_job_manager_->GetRayNamespace(job_id); },
+      [this]() {
+        // The bundles of a placement group can only be moved if all its actors can
+        // restart on another node.
+        absl::flat_hash_set<PlacementGroupID> pinned_placement_groups;
+        for (const auto &entry : gcs_actor_manager_->GetRegisteredActors()) {
+          const auto &actor_table_data = entry.second->GetActorTableData();
+          const auto &placement_group_id =
+              actor_table_data.task_spec().placement_group_id();
+          if (actor_table_data.state() == rpc::ActorTableData::DEAD ||
+              placement_group_id.empty()) {
+            continue;
+          }
+          if (actor_table_data.max_restarts() != -1 &&
+              static_cast<int64_t>(actor_table_data.num_restarts()) >=
+                  actor_table_data.max_restarts()) {
+            pinned_placement_groups.insert(
+                PlacementGroupID::FromBinary(placement_group_id));
+          }
+        }
+        return pinned_placement_groups;
+      });
   // Initialize by gcs tables data.
   gcs_placement_group_manager_->Initialize(gcs_init_data);
   // Register service.
@@ -335,18 +373,49 @@ void GcsServer::InitGcsPlacementGroupManager(const GcsInitData &gcs_init_data) {
   rpc_server_.RegisterService(*placement_group_info_service_);
 }
 
-void GcsServer::InitObjectManager(const GcsInitData &gcs_init_data) {
+void GcsServer::InitObjectManager() {
   RAY_CHECK(gcs_table_storage_ && gcs_pub_sub_ && gcs_node_manager_);
   gcs_object_manager_.reset(
       new GcsObjectManager(gcs_table_storage_, gcs_pub_sub_, *gcs_node_manager_));
-  // Initialize by gcs tables data.
-  gcs_object_manager_->Initialize(gcs_init_data);
   // Register service.
   object_info_service_.reset(
       new rpc::ObjectInfoGrpcService(main_service_, *gcs_object_manager_));
   rpc_server_.RegisterService(*object_info_service_);
 }
 
+void GcsServer::LoadManagersFromTables(const GcsInitData &gcs_init_data) {
+  RAY_CHECK(gcs_node_manager_ && gcs_heartbeat_manager_ && gcs_resource_manager_ &&
+            gcs_job_manager_ && gcs_object_manager_);
+  // Each of these only fills the state of its own manager. The event loops don't
+  // touch them yet, because the rpc server is not running and no event listener is
+  // installed.
+  std::vector<std::function<void()>> loaders = {
+      [this, &gcs_init_data] { gcs_node_manager_->Initialize(gcs_init_data); },
+      [this, &gcs_init_data] { gcs_heartbeat_manager_->Initialize(gcs_init_data); },
+      [this, &gcs_init_data] { gcs_resource_manager_->Initialize(gcs_init_data); },
+      [this, &gcs_init_data] { gcs_job_manager_->Initialize(gcs_init_data); },
+      [this, &gcs_init_data] { gcs_object_manager_->Initialize(gcs_init_data); },
+  };
+  if (!RayConfig::instance().gcs_parallel_manager_initialization()) {
+    for (const auto &loader : loaders) {
+      loader();
+    }
+    return;
+  }
+  // The first manager is loaded on this thread, each of the others on a thread of
+  // its own.
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < loaders.size(); i++) {
+    threads.emplace_back(loaders[i]);
+  }
+  loaders[0]();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  RAY_LOG(INFO) << "Loaded the gcs tables data into " << loaders.size()
+                << " managers in parallel.";
+}
+
 void GcsServer::StoreGcsServerAddressInRedis() {
   std::string ip = config_.node_ip_address;
   if (ip.empty()) {
@@ -373,9 +442,16 @@ void GcsServer::InitTaskInfoHandler() {
 }
 
 void GcsServer::InitResourceReportPolling(const GcsInitData &gcs_init_data) {
+  if (RayConfig::instance().raylet_push_resource_reports()) {
+    // The raylets push their reports through ReportResourceUsage.
+    return;
+  }
   gcs_resource_report_poller_.reset(new GcsResourceReportPoller(
       raylet_client_pool_, [this](const rpc::ResourcesData &report) {
         gcs_resource_manager_->UpdateFromResourceReport(report);
+        if (RayConfig::instance().gcs_heartbeat_piggyback_on_resource_reports()) {
+          gcs_heartbeat_manager_->RenewLease(NodeID::FromBinary(report.node_id()));
+        }
       }));
 
   gcs_resource_report_poller_->Initialize(gcs_init_data);
@@ -456,7 +532,9 @@ void GcsServer::InstallEventListeners() {
     gcs_placement_group_manager_->SchedulePendingPlacementGroups();
     gcs_actor_manager_->SchedulePendingActors();
     gcs_heartbeat_manager_->AddNode(NodeID::FromBinary(node->node_id()));
-    gcs_resource_report_poller_->HandleNodeAdded(*node);
+    if (gcs_resource_report_poller_ != nullptr) {
+      gcs_resource_report_poller_->HandleNodeAdded(*node);
+    }
     if (config_.grpc_based_resource_broadcast) {
       grpc_based_resource_broadcaster_->HandleNodeAdded(*node);
     }
@@ -470,7 +548,9 @@ void GcsServer::InstallEventListeners() {
         gcs_placement_group_manager_->OnNodeDead(node_id);
         gcs_actor_manager_->OnNodeDead(node_id);
         raylet_client_pool_->Disconnect(NodeID::FromBinary(node->node_id()));
-        gcs_resource_report_poller_->HandleNodeRemoved(*node);
+        if (gcs_resource_report_poller_ != nullptr) {
+          gcs_resource_report_poller_->HandleNodeRemoved(*node);
+        }
         if (config_.grpc_based_resource_broadcast) {
           grpc_based_resource_broadcaster_->HandleNodeRemoved(*node);
         }
@@ -40,6 +40,7 @@ struct GcsServerConfig {
   std::string grpc_server_name = "GcsServer";
   uint16_t grpc_server_port = 0;
   uint16_t grpc_server_thread_num = 1;
+  uint16_t grpc_server_priority_thread_num = 0;
   std::string redis_password;
   std::string redis_address;
   uint16_t redis_port = 6379;
@@ -87,19 +88,19 @@ class GcsServer {
   void DoStart(const GcsInitData &gcs_init_data);
 
   /// Initialize gcs node manager.
-  void InitGcsNodeManager(const GcsInitData &gcs_init_data);
+  void InitGcsNodeManager();
 
   /// Initialize gcs heartbeat manager.
-  void InitGcsHeartbeatManager(const GcsInitData &gcs_init_data);
+  void InitGcsHeartbeatManager();
 
   /// Initialize gcs resource manager.
-  void InitGcsResourceManager(const GcsInitData &gcs_init_data);
+  void InitGcsResourceManager();
 
   /// Initialize gcs resource scheduler.
   void InitGcsResourceScheduler();
 
   /// Initialize gcs job manager.
-  void InitGcsJobManager(const GcsInitData &gcs_init_data);
+  void InitGcsJobManager();
 
   /// Initialize gcs actor manager.
   void InitGcsActorManager(const GcsInitData &gcs_init_data);
@@ -108,7 +109,12 @@ class GcsServer {
   void InitGcsPlacementGroupManager(const GcsInitData &gcs_init_data);
 
   /// Initialize gcs object manager.
-  void InitObjectManager(const GcsInitData &gcs_init_data);
+  void InitObjectManager();
+
+  /// Load the gcs tables data into the node, heartbeat, resource, job and object
+  /// managers. They don't depend on each other, so they are loaded in parallel if
+  /// `gcs_parallel_manager_initialization` is set.
+  void LoadManagersFromTables(const GcsInitData &gcs_init_data);
 
   /// Initialize gcs worker manager.
   void InitGcsWorkerManager();
@@ -217,6 +223,8 @@ class GcsServer {
   std::shared_ptr<gcs::GcsPubSub> gcs_pub_sub_;
   /// Grpc based pubsub.
   std::shared_ptr<pubsub::Publisher> grpc_pubsub_publisher_;
+  /// Grpc based pubsub's service, which is served by `gcs_pub_sub_`.
+  std::unique_ptr<rpc::PublisherGrpcService> pubsub_service_;
   /// Grpc based pubsub's periodical runner.
   PeriodicalRunner pubsub_periodical_runner_;
   /// The gcs table storage.
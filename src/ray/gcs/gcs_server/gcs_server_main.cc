@@ -16,6 +16,7 @@
 
 #include "gflags/gflags.h"
 #include "ray/common/ray_config.h"
+#include "ray/common/span_tracer.h"
 #include "ray/gcs/gcs_server/gcs_server.h"
 #include "ray/gcs/store_client/redis_store_client.h"
 #include "ray/util/event.h"
@@ -52,6 +53,22 @@ int main(int argc, char *argv[]) {
 
   RayConfig::instance().initialize(config_list);
 
+  const auto &storage_file_path = RayConfig::instance().gcs_storage_file_path();
+  if (!storage_file_path.empty()) {
+    // The file based storage can only be opened by one client at a time, so write the
+    // config and close it before the gcs server opens it.
+    instrumented_io_context service;
+    boost::asio::io_service::work work(service);
+    auto storage =
+        std::make_shared<ray::gcs::FileGcsTableStorage>(service, storage_file_path);
+    ray::rpc::StoredConfig stored_config;
+    stored_config.set_config(config_list);
+    RAY_CHECK_OK(storage->InternalConfigTable().Put(
+        ray::UniqueID::Nil(), stored_config,
+        [&service](const ray::Status &status) { service.stop(); }));
+    service.run();
+  }
+
   auto promise = std::make_shared<std::promise<void>>();
   std::thread([=] {
     instrumented_io_context service;
@@ -84,11 +101,15 @@ int main(int argc, char *argv[]) {
   // Initialize event framework.
   if (RayConfig::instance().event_log_reporter_enabled() && !log_dir.empty()) {
     ray::RayEventInit(ray::rpc::Event_SourceType::Event_SourceType_GCS,
-                      std::unordered_map<std::string, std::string>(), log_dir);
+                      std::unordered_map<std::string, std::string>(), log_dir,
+                      RayConfig::instance().event_reporter_queue_size());
+  }
+  if (!log_dir.empty()) {
+    ray::SpanTracer::Instance().Start("gcs_server", log_dir);
   }
 
   // IO Service for main loop.
-  instrumented_io_context main_service;
+  instrumented_io_context main_service("gcs_server");
   // Ensure that the IO service keeps running. Without this, the main_service will exit
   // as soon as there is no more work to be processed.
   boost::asio::io_service::work work(main_service);
@@ -98,6 +119,8 @@ int main(int argc, char *argv[]) {
   gcs_server_config.grpc_server_port = gcs_server_port;
   gcs_server_config.grpc_server_thread_num =
       RayConfig::instance().gcs_server_rpc_server_thread_num();
+  gcs_server_config.grpc_server_priority_thread_num =
+      RayConfig::instance().gcs_server_priority_rpc_thread_num();
   gcs_server_config.redis_address = redis_address;
   gcs_server_config.redis_port = redis_port;
   gcs_server_config.redis_password = redis_password;
@@ -114,6 +137,7 @@ int main(int argc, char *argv[]) {
   auto handler = [&main_service, &gcs_server](const boost::system::error_code &error,
                                               int signal_number) {
     RAY_LOG(INFO) << "GCS server received SIGTERM, shutting down...";
+    RAY_UNUSED(ray::SpanTracer::Instance().Dump());
     main_service.stop();
     gcs_server.Stop();
   };
@@ -17,6 +17,7 @@
 #include <utility>
 
 #include "ray/common/asio/instrumented_io_context.h"
+#include "ray/gcs/store_client/file_store_client.h"
 #include "ray/gcs/store_client/in_memory_store_client.h"
 #include "ray/gcs/store_client/redis_store_client.h"
 #include "src/ray/protobuf/gcs.pb.h"
@@ -430,5 +431,31 @@ class InMemoryGcsTableStorage : public GcsTableStorage {
   }
 };
 
+/// \class FileGcsTableStorage
+/// FileGcsTableStorage is an implementation of `GcsTableStorage`
+/// that keeps data in memory and persists it to a local write-ahead log.
+class FileGcsTableStorage : public GcsTableStorage {
+ public:
+  FileGcsTableStorage(instrumented_io_context &main_io_service,
+                      const std::string &log_path) {
+    store_client_ = std::make_shared<FileStoreClient>(main_io_service, log_path);
+    job_table_.reset(new GcsJobTable(store_client_));
+    actor_table_.reset(new GcsActorTable(store_client_));
+    placement_group_table_.reset(new GcsPlacementGroupTable(store_client_));
+    task_table_.reset(new GcsTaskTable(store_client_));
+    task_lease_table_.reset(new GcsTaskLeaseTable(store_client_));
+    task_reconstruction_table_.reset(new GcsTaskReconstructionTable(store_client_));
+    object_table_.reset(new GcsObjectTable(store_client_));
+    node_table_.reset(new GcsNodeTable(store_client_));
+    node_resource_table_.reset(new GcsNodeResourceTable(store_client_));
+    placement_group_schedule_table_.reset(
+        new GcsPlacementGroupScheduleTable(store_client_));
+    resource_usage_batch_table_.reset(new GcsResourceUsageBatchTable(store_client_));
+    profile_table_.reset(new GcsProfileTable(store_client_));
+    worker_table_.reset(new GcsWorkerTable(store_client_));
+    system_config_table_.reset(new GcsInternalConfigTable(store_client_));
+  }
+};
+
 }  // namespace gcs
 }  // namespace ray
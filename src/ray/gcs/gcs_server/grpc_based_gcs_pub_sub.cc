@@ -0,0 +1,100 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/gcs_server/grpc_based_gcs_pub_sub.h"
+
+namespace ray {
+namespace gcs {
+
+namespace {
+
+bool IsGcsChannel(rpc::ChannelType channel_type) {
+  return channel_type == rpc::ChannelType::GCS_ACTOR_CHANNEL ||
+         channel_type == rpc::ChannelType::GCS_JOB_CHANNEL ||
+         channel_type == rpc::ChannelType::GCS_NODE_INFO_CHANNEL;
+}
+
+}  // namespace
+
+Status GrpcBasedGcsPubSub::Publish(const std::string &channel, const std::string &id,
+                                   const std::string &data, const StatusCallback &done) {
+  rpc::PubMessage pub_message;
+  // Every message is also published to the empty key, which subscribes to the whole
+  // channel.
+  std::vector<std::string> keys{""};
+  if (channel == ACTOR_CHANNEL) {
+    const auto actor_id = ActorID::FromHex(id);
+    auto *actor_message = pub_message.mutable_actor_message();
+    RAY_CHECK(actor_message->ParseFromString(data));
+    pub_message.set_channel_type(rpc::ChannelType::GCS_ACTOR_CHANNEL);
+    pub_message.set_key_id(actor_id.Binary());
+    keys.push_back(actor_id.Binary());
+    keys.push_back(JobFilterKey(actor_id.JobId()));
+    const auto &raylet_id = actor_message->address().raylet_id();
+    if (!raylet_id.empty()) {
+      keys.push_back(NodeFilterKey(NodeID::FromBinary(raylet_id)));
+    }
+  } else if (channel == JOB_CHANNEL) {
+    const auto job_id = JobID::FromHex(id);
+    RAY_CHECK(pub_message.mutable_job_message()->ParseFromString(data));
+    pub_message.set_channel_type(rpc::ChannelType::GCS_JOB_CHANNEL);
+    pub_message.set_key_id(job_id.Binary());
+    keys.push_back(job_id.Binary());
+  } else if (channel == NODE_CHANNEL) {
+    const auto node_id = NodeID::FromHex(id);
+    RAY_CHECK(pub_message.mutable_node_info_message()->ParseFromString(data));
+    pub_message.set_channel_type(rpc::ChannelType::GCS_NODE_INFO_CHANNEL);
+    pub_message.set_key_id(node_id.Binary());
+    keys.push_back(node_id.Binary());
+  } else {
+    return GcsPubSub::Publish(channel, id, data, done);
+  }
+  publisher_->PublishToKeys(pub_message.channel_type(), pub_message, keys);
+  return GcsPubSub::Publish(channel, id, data, done);
+}
+
+void GrpcBasedGcsPubSub::HandlePubsubLongPolling(
+    const rpc::PubsubLongPollingRequest &request, rpc::PubsubLongPollingReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  const auto subscriber_id = pubsub::SubscriberID::FromBinary(request.subscriber_id());
+  RAY_LOG(DEBUG) << "Got a long polling request from a subscriber " << subscriber_id;
+  publisher_->ConnectToSubscriber(subscriber_id, reply, std::move(send_reply_callback));
+}
+
+void GrpcBasedGcsPubSub::HandlePubsubCommandBatch(
+    const rpc::PubsubCommandBatchRequest &request, rpc::PubsubCommandBatchReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  const auto subscriber_id = pubsub::SubscriberID::FromBinary(request.subscriber_id());
+  for (const auto &command : request.commands()) {
+    if (!IsGcsChannel(command.channel_type())) {
+      RAY_LOG(WARNING) << "Ignoring a pubsub command for channel "
+                       << static_cast<int>(command.channel_type())
+                       << ", which is not published by the GCS.";
+    } else if (command.has_unsubscribe_message()) {
+      publisher_->UnregisterSubscription(command.channel_type(), subscriber_id,
+                                         command.key_id());
+    } else if (command.has_subscribe_message()) {
+      publisher_->RegisterSubscription(command.channel_type(), subscriber_id,
+                                       command.key_id());
+    } else {
+      RAY_LOG(WARNING) << "Ignoring an invalid pubsub command from subscriber "
+                       << subscriber_id << ", "
+                       << static_cast<int>(command.command_message_one_of_case());
+    }
+  }
+  send_reply_callback(Status::OK(), nullptr, nullptr);
+}
+
+}  // namespace gcs
+}  // namespace ray
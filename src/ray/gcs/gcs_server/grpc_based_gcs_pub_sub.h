@@ -0,0 +1,67 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "ray/gcs/pubsub/gcs_pub_sub.h"
+#include "ray/pubsub/publisher.h"
+#include "ray/rpc/gcs_server/gcs_rpc_server.h"
+
+namespace ray {
+namespace gcs {
+
+/// \class GrpcBasedGcsPubSub
+///
+/// GrpcBasedGcsPubSub publishes the actor, job and node messages of the GCS to the
+/// subscribers of the gRPC based publisher, in addition to Redis. Subscribers filter
+/// these channels on the server side: a subscriber only receives the messages of the
+/// actors, jobs or nodes it subscribed to, or of all the actors of a job or on a node.
+/// Other channels are only published to Redis.
+///
+/// It also serves the long polling and command requests of the subscribers.
+class GrpcBasedGcsPubSub : public GcsPubSub, public rpc::PublisherServiceHandler {
+ public:
+  GrpcBasedGcsPubSub(std::shared_ptr<RedisClient> redis_client,
+                     std::shared_ptr<pubsub::Publisher> publisher)
+      : GcsPubSub(std::move(redis_client)), publisher_(std::move(publisher)) {}
+
+  /// Publish the message to Redis, and to the gRPC subscribers if it belongs to a
+  /// channel that is served by the gRPC based publisher.
+  Status Publish(const std::string &channel, const std::string &id,
+                 const std::string &data, const StatusCallback &done) override;
+
+  void HandlePubsubLongPolling(const rpc::PubsubLongPollingRequest &request,
+                               rpc::PubsubLongPollingReply *reply,
+                               rpc::SendReplyCallback send_reply_callback) override;
+
+  void HandlePubsubCommandBatch(const rpc::PubsubCommandBatchRequest &request,
+                                rpc::PubsubCommandBatchReply *reply,
+                                rpc::SendReplyCallback send_reply_callback) override;
+
+  /// The key to subscribe to the messages of all the actors of a job.
+  static std::string JobFilterKey(const JobID &job_id) {
+    return "job:" + job_id.Binary();
+  }
+
+  /// The key to subscribe to the messages of all the actors on a node.
+  static std::string NodeFilterKey(const NodeID &node_id) {
+    return "node:" + node_id.Binary();
+  }
+
+ private:
+  std::shared_ptr<pubsub::Publisher> publisher_;
+};
+
+}  // namespace gcs
+}  // namespace ray
@@ -24,6 +24,7 @@ GrpcBasedResourceBroadcaster::GrpcBasedResourceBroadcaster(
         get_resource_usage_batch_for_broadcast,
     std::function<void(const rpc::Address &,
                        std::shared_ptr<rpc::NodeManagerClientPool> &, std::string &,
+                       const std::vector<rpc::Address> &,
                        const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &)>
         send_batch
 
@@ -35,7 +36,8 @@ GrpcBasedResourceBroadcaster::GrpcBasedResourceBroadcaster(
       send_batch_(send_batch),
       num_skipped_nodes_(0),
       broadcast_period_ms_(
-          RayConfig::instance().raylet_report_resources_period_milliseconds()) {}
+          RayConfig::instance().raylet_report_resources_period_milliseconds()),
+      broadcast_fanout_(RayConfig::instance().resource_broadcast_fanout()) {}
 
 GrpcBasedResourceBroadcaster::~GrpcBasedResourceBroadcaster() {}
 
@@ -119,15 +121,23 @@ void GrpcBasedResourceBroadcaster::SendBroadcast() {
 
   absl::MutexLock guard(&mutex_);
   num_skipped_nodes_ = 0;
+  std::vector<rpc::Address> targets;
   for (const auto &pair : nodes_) {
-    const auto &node_id = pair.first;
-    const auto &address = pair.second;
-
-    auto already_inflight = inflight_updates_[node_id];
+    auto already_inflight = inflight_updates_[pair.first];
     if (already_inflight) {
       num_skipped_nodes_++;
       continue;
     }
+    targets.push_back(pair.second);
+  }
+
+  // Only the head of each group is sent to directly. It relays the batch to the rest of
+  // its group, so the GCS only tracks the head's request as inflight.
+  for (auto &group : rpc::SplitBroadcastTargets(std::move(targets), broadcast_fanout_)) {
+    const auto &address = group.front();
+    const auto node_id = NodeID::FromBinary(address.raylet_id());
+    std::vector<rpc::Address> forward_to(std::make_move_iterator(group.begin() + 1),
+                                         std::make_move_iterator(group.end()));
 
     double start_time = absl::GetCurrentTimeNanos();
     auto callback = [this, node_id, start_time](
@@ -145,7 +155,7 @@ void GrpcBasedResourceBroadcaster::SendBroadcast() {
       }
     };
     inflight_updates_[node_id] = true;
-    send_batch_(address, raylet_client_pool_, serialized_batch, callback);
+    send_batch_(address, raylet_client_pool_, serialized_batch, forward_to, callback);
   }
 }
 
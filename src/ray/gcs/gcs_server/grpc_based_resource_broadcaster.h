@@ -29,15 +29,17 @@ class GrpcBasedResourceBroadcaster {
       /* Default values should only be changed for testing. */
       std::function<void(const rpc::Address &,
                          std::shared_ptr<rpc::NodeManagerClientPool> &, std::string &,
+                         const std::vector<rpc::Address> &,
                          const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &)>
           send_batch =
               [](const rpc::Address &address,
                  std::shared_ptr<rpc::NodeManagerClientPool> &raylet_client_pool,
                  std::string &serialized_resource_usage_batch,
+                 const std::vector<rpc::Address> &forward_to,
                  const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &callback) {
                 auto raylet_client = raylet_client_pool->GetOrConnectByAddress(address);
                 raylet_client->UpdateResourceUsage(serialized_resource_usage_batch,
-                                                   callback);
+                                                   forward_to, callback);
               });
   ~GrpcBasedResourceBroadcaster();
 
@@ -75,7 +77,7 @@ class GrpcBasedResourceBroadcaster {
       get_resource_usage_batch_for_broadcast_;
 
   std::function<void(const rpc::Address &, std::shared_ptr<rpc::NodeManagerClientPool> &,
-                     std::string &,
+                     std::string &, const std::vector<rpc::Address> &,
                      const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &)>
       send_batch_;
 
@@ -91,6 +93,9 @@ class GrpcBasedResourceBroadcaster {
   /// diagnostic purposes.
   uint64_t num_skipped_nodes_;
   const uint64_t broadcast_period_ms_;
+  /// The maximum number of raylets to send each broadcast to directly. The other raylets
+  /// receive it through relaying raylets. 0 means every raylet is sent to directly.
+  uint64_t broadcast_fanout_;
 
   void SendBroadcast();
 
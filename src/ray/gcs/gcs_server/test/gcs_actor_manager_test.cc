@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <memory>
 
 #include "gtest/gtest.h"
@@ -30,7 +31,9 @@ class MockActorScheduler : public gcs::GcsActorSchedulerInterface {
   MockActorScheduler() {}
 
   void Schedule(std::shared_ptr<gcs::GcsActor> actor) { actors.push_back(actor); }
-  void Reschedule(std::shared_ptr<gcs::GcsActor> actor) {}
+  void Reschedule(std::shared_ptr<gcs::GcsActor> actor) {
+    rescheduled_actors.push_back(actor);
+  }
   void ReleaseUnusedWorkers(
       const std::unordered_map<NodeID, std::vector<WorkerID>> &node_to_workers) {}
 
@@ -40,6 +43,22 @@ class MockActorScheduler : public gcs::GcsActorSchedulerInterface {
                                      const TaskID &task_id));
 
   std::vector<std::shared_ptr<gcs::GcsActor>> actors;
+  std::vector<std::shared_ptr<gcs::GcsActor>> rescheduled_actors;
+};
+
+/// Init data with tables filled in by the test instead of loaded from storage.
+class FakeGcsInitData : public gcs::GcsInitData {
+ public:
+  FakeGcsInitData() : gcs::GcsInitData(nullptr) {}
+
+  void AddJob(const rpc::JobTableData &job_table_data) {
+    job_table_data_[JobID::FromBinary(job_table_data.job_id())] = job_table_data;
+  }
+
+  void AddActor(const rpc::ActorTableData &actor_table_data) {
+    actor_table_data_[ActorID::FromBinary(actor_table_data.actor_id())] =
+        actor_table_data;
+  }
 };
 
 class MockWorkerClient : public rpc::CoreWorkerClientInterface {
@@ -273,6 +292,110 @@ TEST_F(GcsActorManagerTest, TestSchedulingFailed) {
   ASSERT_EQ(finished_actors.size(), 1);
 }
 
+TEST_F(GcsActorManagerTest, TestSchedulePendingActorsInBatches) {
+  RayConfig::instance().initialize(R"({"gcs_actor_scheduling_batch_size": 2})");
+  skip_delay_ = false;
+  gcs::GcsActorManager batching_actor_manager(
+      mock_actor_scheduler_, gcs_table_storage_, gcs_pub_sub_, *runtime_env_mgr_,
+      [](const ActorID &actor_id) {},
+      [this](const JobID &job_id) { return job_namespace_table_[job_id]; },
+      [this](std::function<void(void)> fn, boost::posix_time::milliseconds delay) {
+        delay_ = delay;
+        delayed_to_run_ = fn;
+      },
+      [this](const rpc::Address &addr) { return worker_client_; });
+  RayConfig::instance().initialize(R"({"gcs_actor_scheduling_batch_size": 0})");
+
+  for (int i = 0; i < 5; i++) {
+    auto request = Mocker::GenRegisterActorRequest(JobID::FromInt(1));
+    batching_actor_manager.OnActorCreationFailed(
+        std::make_shared<gcs::GcsActor>(request.task_spec(), ""));
+  }
+
+  // Only the first batch is scheduled right away, the rest is posted.
+  batching_actor_manager.SchedulePendingActors();
+  ASSERT_EQ(mock_actor_scheduler_->actors.size(), 2);
+  ASSERT_TRUE(delayed_to_run_ != nullptr);
+
+  // Scheduling again while a batch is posted must not post a second one.
+  auto posted = std::move(delayed_to_run_);
+  delayed_to_run_ = nullptr;
+  batching_actor_manager.SchedulePendingActors();
+  ASSERT_EQ(mock_actor_scheduler_->actors.size(), 2);
+  ASSERT_TRUE(delayed_to_run_ == nullptr);
+
+  posted();
+  ASSERT_EQ(mock_actor_scheduler_->actors.size(), 4);
+  ASSERT_TRUE(delayed_to_run_ != nullptr);
+  posted = std::move(delayed_to_run_);
+  delayed_to_run_ = nullptr;
+  posted();
+  ASSERT_EQ(mock_actor_scheduler_->actors.size(), 5);
+  ASSERT_TRUE(delayed_to_run_ == nullptr);
+  mock_actor_scheduler_->actors.clear();
+}
+
+TEST_F(GcsActorManagerTest, TestRescheduleRecoveredActorsInBatches) {
+  RayConfig::instance().initialize(R"({"gcs_actor_recovery_batch_size": 2})");
+  skip_delay_ = false;
+  gcs::GcsActorManager recovering_actor_manager(
+      mock_actor_scheduler_, gcs_table_storage_, gcs_pub_sub_, *runtime_env_mgr_,
+      [](const ActorID &actor_id) {},
+      [this](const JobID &job_id) { return job_namespace_table_[job_id]; },
+      [this](std::function<void(void)> fn, boost::posix_time::milliseconds delay) {
+        delay_ = delay;
+        delayed_to_run_ = fn;
+      },
+      [this](const rpc::Address &addr) { return worker_client_; });
+  RayConfig::instance().initialize(R"({"gcs_actor_recovery_batch_size": 0})");
+
+  auto job_id = JobID::FromInt(1);
+  FakeGcsInitData gcs_init_data;
+  gcs_init_data.AddJob(*Mocker::GenJobTableData(job_id));
+  for (int i = 0; i < 5; i++) {
+    auto actor_table_data = Mocker::GenActorTableData(job_id);
+    actor_table_data->set_state(rpc::ActorTableData::RESTARTING);
+    actor_table_data->set_is_detached(true);
+    gcs_init_data.AddActor(*actor_table_data);
+  }
+
+  // The actors are registered right away, but rescheduled from the event loop.
+  recovering_actor_manager.Initialize(gcs_init_data);
+  ASSERT_EQ(recovering_actor_manager.GetRegisteredActors().size(), 5);
+  ASSERT_TRUE(mock_actor_scheduler_->rescheduled_actors.empty());
+  ASSERT_TRUE(delayed_to_run_ != nullptr);
+
+  auto posted = std::move(delayed_to_run_);
+  delayed_to_run_ = nullptr;
+  posted();
+  ASSERT_EQ(mock_actor_scheduler_->rescheduled_actors.size(), 2);
+  ASSERT_TRUE(delayed_to_run_ != nullptr);
+
+  // An actor that was created in the meantime is not rescheduled.
+  std::shared_ptr<gcs::GcsActor> created_actor;
+  for (const auto &entry : recovering_actor_manager.GetRegisteredActors()) {
+    const auto &rescheduled = mock_actor_scheduler_->rescheduled_actors;
+    if (std::find(rescheduled.begin(), rescheduled.end(), entry.second) ==
+        rescheduled.end()) {
+      created_actor = entry.second;
+      break;
+    }
+  }
+  ASSERT_TRUE(created_actor != nullptr);
+  created_actor->UpdateState(rpc::ActorTableData::ALIVE);
+
+  while (delayed_to_run_ != nullptr) {
+    posted = std::move(delayed_to_run_);
+    delayed_to_run_ = nullptr;
+    posted();
+  }
+  const auto &rescheduled = mock_actor_scheduler_->rescheduled_actors;
+  ASSERT_EQ(rescheduled.size(), 4);
+  ASSERT_TRUE(std::find(rescheduled.begin(), rescheduled.end(), created_actor) ==
+              rescheduled.end());
+  mock_actor_scheduler_->rescheduled_actors.clear();
+}
+
 TEST_F(GcsActorManagerTest, TestWorkerFailure) {
   auto job_id = JobID::FromInt(1);
   auto registered_actor = RegisterActor(job_id);
@@ -989,6 +1112,59 @@ TEST_F(GcsActorManagerTest, TestActorTableDataDelayedGC) {
   }
 }
 
+TEST_F(GcsActorManagerTest, TestGetAllActorInfoPagination) {
+  auto job_id_1 = JobID::FromInt(1);
+  auto job_id_2 = JobID::FromInt(2);
+  for (int i = 0; i < 5; i++) {
+    auto request = Mocker::GenRegisterActorRequest(i < 3 ? job_id_1 : job_id_2);
+    Status status = gcs_actor_manager_->RegisterActor(
+        request, [](std::shared_ptr<gcs::GcsActor> actor) {});
+    ASSERT_TRUE(status.ok());
+  }
+  auto callback = [](Status status, std::function<void()> success,
+                     std::function<void()> failure) {};
+
+  // Fetch all actors two at a time. The pages are in actor ID order and don't overlap.
+  std::vector<std::string> actor_ids;
+  std::string page_token;
+  int num_pages = 0;
+  do {
+    rpc::GetAllActorInfoRequest request;
+    rpc::GetAllActorInfoReply reply;
+    request.set_limit(2);
+    request.set_page_token(page_token);
+    gcs_actor_manager_->HandleGetAllActorInfo(request, &reply, callback);
+    ASSERT_LE(reply.actor_table_data().size(), 2);
+    for (const auto &actor : reply.actor_table_data()) {
+      actor_ids.push_back(actor.actor_id());
+    }
+    page_token = reply.next_page_token();
+    num_pages++;
+  } while (!page_token.empty());
+  ASSERT_EQ(num_pages, 3);
+  ASSERT_EQ(actor_ids.size(), 5);
+  ASSERT_TRUE(std::is_sorted(actor_ids.begin(), actor_ids.end()));
+  ASSERT_EQ(std::adjacent_find(actor_ids.begin(), actor_ids.end()), actor_ids.end());
+
+  // Filter by job.
+  {
+    rpc::GetAllActorInfoRequest request;
+    rpc::GetAllActorInfoReply reply;
+    request.mutable_filters()->set_job_id(job_id_2.Binary());
+    gcs_actor_manager_->HandleGetAllActorInfo(request, &reply, callback);
+    ASSERT_EQ(reply.actor_table_data().size(), 2);
+    ASSERT_TRUE(reply.next_page_token().empty());
+  }
+  // Filter by state.
+  {
+    rpc::GetAllActorInfoRequest request;
+    rpc::GetAllActorInfoReply reply;
+    request.mutable_filters()->add_states(rpc::ActorTableData::ALIVE);
+    gcs_actor_manager_->HandleGetAllActorInfo(request, &reply, callback);
+    ASSERT_EQ(reply.actor_table_data().size(), 0);
+  }
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
@@ -120,6 +120,45 @@ TEST_F(GcsActorSchedulerTest, TestScheduleActorSuccess) {
   ASSERT_EQ(actor->GetWorkerID(), worker_id);
 }
 
+TEST_F(GcsActorSchedulerTest, TestScheduleBatch) {
+  std::unordered_set<NodeID> node_ids;
+  for (int i = 0; i < 3; i++) {
+    auto node = Mocker::GenNodeInfo();
+    node_ids.insert(NodeID::FromBinary(node->node_id()));
+    gcs_node_manager_->AddNode(node);
+  }
+
+  auto job_id = JobID::FromInt(1);
+  std::vector<std::shared_ptr<gcs::GcsActor>> actors;
+  for (int i = 0; i < 10; i++) {
+    auto create_actor_request = Mocker::GenCreateActorRequest(job_id);
+    actors.emplace_back(
+        std::make_shared<gcs::GcsActor>(create_actor_request.task_spec(), ""));
+  }
+
+  // Every actor of the batch should be leased from one of the alive nodes.
+  gcs_actor_scheduler_->ScheduleBatch(actors);
+  ASSERT_EQ(10, raylet_client_->num_workers_requested);
+  ASSERT_EQ(0, failure_actors_.size());
+  for (const auto &actor : actors) {
+    ASSERT_TRUE(node_ids.count(actor->GetNodeID()));
+  }
+
+  // An empty cluster fails the whole batch.
+  for (const auto &node_id : node_ids) {
+    gcs_node_manager_->RemoveNode(node_id);
+  }
+  std::vector<std::shared_ptr<gcs::GcsActor>> more_actors;
+  for (int i = 0; i < 2; i++) {
+    auto create_actor_request = Mocker::GenCreateActorRequest(job_id);
+    more_actors.emplace_back(
+        std::make_shared<gcs::GcsActor>(create_actor_request.task_spec(), ""));
+  }
+  gcs_actor_scheduler_->ScheduleBatch(more_actors);
+  ASSERT_EQ(10, raylet_client_->num_workers_requested);
+  ASSERT_EQ(2, failure_actors_.size());
+}
+
 TEST_F(GcsActorSchedulerTest, TestScheduleRetryWhenLeasing) {
   auto node = Mocker::GenNodeInfo();
   auto node_id = NodeID::FromBinary(node->node_id());
@@ -468,6 +507,55 @@ TEST_F(GcsActorSchedulerTest, TestReschedule) {
   ASSERT_EQ(2, success_actors_.size());
 }
 
+TEST_F(GcsActorSchedulerTest, TestStandbyWorker) {
+  auto node1 = Mocker::GenNodeInfo();
+  auto node2 = Mocker::GenNodeInfo();
+  gcs_node_manager_->AddNode(node1);
+  gcs_node_manager_->AddNode(node2);
+  ASSERT_EQ(2, gcs_node_manager_->GetAllAliveNodes().size());
+
+  auto job_id = JobID::FromInt(1);
+  auto create_actor_request = Mocker::GenCreateActorRequest(job_id);
+  auto actor = std::make_shared<gcs::GcsActor>(create_actor_request.task_spec(), "");
+  gcs_actor_scheduler_->Schedule(actor);
+  auto actor_node_id = actor->GetNodeID();
+  ASSERT_TRUE(raylet_client_->GrantWorkerLease("", 0, WorkerID::FromRandom(),
+                                               actor_node_id, NodeID::Nil()));
+  ASSERT_TRUE(worker_client_->ReplyPushTask());
+  ASSERT_EQ(1, success_actors_.size());
+  actor->UpdateState(rpc::ActorTableData::ALIVE);
+
+  // The standby worker is leased from the other node.
+  gcs_actor_scheduler_->PrepareStandbyWorker(actor);
+  ASSERT_EQ(2, raylet_client_->num_workers_requested);
+  auto standby_node_id = NodeID::FromBinary(node1->node_id()) == actor_node_id
+                             ? NodeID::FromBinary(node2->node_id())
+                             : NodeID::FromBinary(node1->node_id());
+  WorkerID standby_worker_id = WorkerID::FromRandom();
+  ASSERT_TRUE(raylet_client_->GrantWorkerLease("", 0, standby_worker_id, standby_node_id,
+                                               NodeID::Nil()));
+
+  // When the actor fails, it is created on the standby worker without a new lease.
+  actor->UpdateAddress(rpc::Address());
+  actor->GetMutableActorTableData()->clear_resource_mapping();
+  actor->UpdateState(rpc::ActorTableData::RESTARTING);
+  gcs_actor_scheduler_->Schedule(actor);
+  ASSERT_EQ(2, raylet_client_->num_workers_requested);
+  ASSERT_TRUE(worker_client_->ReplyPushTask());
+  ASSERT_EQ(2, success_actors_.size());
+  ASSERT_EQ(actor->GetNodeID(), standby_node_id);
+  ASSERT_EQ(actor->GetWorkerID(), standby_worker_id);
+
+  // A released standby worker is returned to its node.
+  actor->UpdateState(rpc::ActorTableData::ALIVE);
+  gcs_actor_scheduler_->PrepareStandbyWorker(actor);
+  ASSERT_EQ(3, raylet_client_->num_workers_requested);
+  ASSERT_TRUE(raylet_client_->GrantWorkerLease("", 0, WorkerID::FromRandom(),
+                                               actor_node_id, NodeID::Nil()));
+  gcs_actor_scheduler_->ReleaseStandbyWorker(actor->GetActorID());
+  ASSERT_EQ(1, raylet_client_->num_workers_disconnected);
+}
+
 TEST_F(GcsActorSchedulerTest, TestReleaseUnusedWorkers) {
   // Test the case that GCS won't send `RequestWorkerLease` request to the raylet,
   // if there is still a pending `ReleaseUnusedWorkers` request.
@@ -0,0 +1,544 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A load generator for a single gcs_server. It simulates many raylets from one
+// process: the simulated nodes register, send heartbeats and resource reports, and
+// the workers on them register actors and create and remove placement groups, all at
+// the given rates. Pubsub subscribers listen to the channels raylets and workers
+// subscribe to. Every report interval it prints the latency percentiles of each RPC,
+// the messages the subscribers received and, given its pid, the CPU usage of the GCS.
+//
+// All simulated nodes point to one fake node manager in this process, which accepts
+// the bundles of placement groups. The fake node manager can't tell the nodes apart,
+// so run the GCS with raylet_push_resource_reports, so that it takes the pushed
+// reports instead of polling the nodes. Actors are only registered, not scheduled,
+// since there are no workers to run them.
+//
+// Example:
+//   gcs_server --gcs_server_port=6380 --redis_address=127.0.0.1 --redis_port=6379 \
+//       --config_list=<base64 of {"raylet_push_resource_reports": true}> ...
+//   gcs_load_bench --gcs_port=6380 --num_nodes=2000 --resource_report_period_ms=100 \
+//       --actor_rate=100 --placement_group_rate=10 --num_subscribers=200 \
+//       --gcs_pid=$(pgrep gcs_server)
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/random/random.h"
+#include "absl/time/clock.h"
+#include "gflags/gflags.h"
+#include "ray/common/asio/instrumented_io_context.h"
+#include "ray/common/asio/periodical_runner.h"
+#include "ray/common/id.h"
+#include "ray/common/ray_config.h"
+#include "ray/gcs/pubsub/gcs_pub_sub.h"
+#include "ray/gcs/redis_client.h"
+#include "ray/gcs/test/gcs_test_util.h"
+#include "ray/rpc/gcs_server/gcs_rpc_client.h"
+#include "ray/rpc/grpc_server.h"
+#include "ray/rpc/node_manager/node_manager_server.h"
+#include "ray/util/logging.h"
+#include "ray/util/util.h"
+
+DEFINE_string(gcs_address, "127.0.0.1", "The address of the GCS server.");
+DEFINE_int32(gcs_port, 0, "The port of the GCS server.");
+DEFINE_string(redis_address, "127.0.0.1", "The address of the Redis server.");
+DEFINE_int32(redis_port, 6379, "The port of the Redis server.");
+DEFINE_string(redis_password, "", "The password of the Redis server.");
+DEFINE_int32(num_nodes, 1000, "The number of simulated nodes.");
+DEFINE_double(node_register_rate, 100, "The number of nodes registered per second.");
+DEFINE_double(cpus_per_node, 16, "The number of CPUs of each simulated node.");
+DEFINE_int64(heartbeat_period_ms, 1000, "The heartbeat period of each node.");
+DEFINE_int64(resource_report_period_ms, 100,
+             "The resource report period of each node. 0 disables the reports.");
+DEFINE_double(actor_rate, 10, "The number of actors registered per second.");
+DEFINE_double(placement_group_rate, 1,
+              "The number of placement groups created, and then removed, per second.");
+DEFINE_int32(bundles_per_placement_group, 2, "The number of bundles of each group.");
+DEFINE_int32(num_subscribers, 0,
+             "The number of pubsub subscribers, each with a Redis connection.");
+DEFINE_int32(duration_s, 60, "How long to generate load for.");
+DEFINE_int32(report_interval_s, 10, "How often to print the statistics.");
+DEFINE_int32(gcs_pid, 0, "The pid of the GCS server, to report its CPU usage.");
+DEFINE_int32(num_rpc_threads, 1, "The number of threads polling the RPC replies.");
+DEFINE_string(ray_config, "{}", "A JSON object of Ray config overrides.");
+
+namespace ray {
+
+namespace {
+
+/// The period of the ticks that spread the periodic requests of the nodes.
+constexpr int64_t kTickMs = 10;
+
+/// A node manager that accepts every request, for the GCS to talk to on behalf of all
+/// the simulated nodes.
+class FakeNodeManager : public rpc::NodeManagerServiceHandler {
+ public:
+  explicit FakeNodeManager(instrumented_io_context &io_service)
+      : server_("GcsLoadBenchNodeManager", 0), service_(io_service, *this) {
+    server_.RegisterService(service_);
+    server_.Run();
+  }
+
+  ~FakeNodeManager() { server_.Shutdown(); }
+
+  int GetPort() const { return server_.GetPort(); }
+
+  void HandleUpdateResourceUsage(const rpc::UpdateResourceUsageRequest &request,
+                                 rpc::UpdateResourceUsageReply *reply,
+                                 rpc::SendReplyCallback send_reply_callback) override {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+
+  void HandleRequestResourceReport(const rpc::RequestResourceReportRequest &request,
+                                   rpc::RequestResourceReportReply *reply,
+                                   rpc::SendReplyCallback send_reply_callback) override {
+    // The request doesn't say which node it is for.
+    send_reply_callback(Status::NotImplemented("Resource reports are pushed"), nullptr,
+                        nullptr);
+  }
+
+  void HandleRequestWorkerLease(const rpc::RequestWorkerLeaseRequest &request,
+                                rpc::RequestWorkerLeaseReply *reply,
+                                rpc::SendReplyCallback send_reply_callback) override {
+    // There are no workers, actors are never scheduled.
+    send_reply_callback(Status::NotImplemented("No workers to lease"), nullptr,
+                        nullptr);
+  }
+
+  void HandleReturnWorker(const rpc::ReturnWorkerRequest &request,
+                          rpc::ReturnWorkerReply *reply,
+                          rpc::SendReplyCallback send_reply_callback) override {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+
+  void HandleReleaseUnusedWorkers(const rpc::ReleaseUnusedWorkersRequest &request,
+                                  rpc::ReleaseUnusedWorkersReply *reply,
+                                  rpc::SendReplyCallback send_reply_callback) override {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+
+  void HandleCancelWorkerLease(const rpc::CancelWorkerLeaseRequest &request,
+                               rpc::CancelWorkerLeaseReply *reply,
+                               rpc::SendReplyCallback send_reply_callback) override {
+    reply->set_success(true);
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+
+  void HandlePrepareBundleResources(
+      const rpc::PrepareBundleResourcesRequest &request,
+      rpc::PrepareBundleResourcesReply *reply,
+      rpc::SendReplyCallback send_reply_callback) override {
+    reply->set_success(true);
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+
+  void HandleCommitBundleResources(
+      const rpc::CommitBundleResourcesRequest &request,
+      rpc::CommitBundleResourcesReply *reply,
+      rpc::SendReplyCallback send_reply_callback) override {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+
+  void HandleCancelResourceReserve(
+      const rpc::CancelResourceReserveRequest &request,
+      rpc::CancelResourceReserveReply *reply,
+      rpc::SendReplyCallback send_reply_callback) override {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+
+  void HandlePinObjectIDs(const rpc::PinObjectIDsRequest &request,
+                          rpc::PinObjectIDsReply *reply,
+                          rpc::SendReplyCallback send_reply_callback) override {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+
+  void HandleGetNodeStats(const rpc::GetNodeStatsRequest &request,
+                          rpc::GetNodeStatsReply *reply,
+                          rpc::SendReplyCallback send_reply_callback) override {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+
+  void HandleGlobalGC(const rpc::GlobalGCRequest &request, rpc::GlobalGCReply *reply,
+                      rpc::SendReplyCallback send_reply_callback) override {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+
+  void HandleFormatGlobalMemoryInfo(
+      const rpc::FormatGlobalMemoryInfoRequest &request,
+      rpc::FormatGlobalMemoryInfoReply *reply,
+      rpc::SendReplyCallback send_reply_callback) override {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+
+  void HandleRequestObjectSpillage(const rpc::RequestObjectSpillageRequest &request,
+                                   rpc::RequestObjectSpillageReply *reply,
+                                   rpc::SendReplyCallback send_reply_callback) override {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+
+  void HandleReleaseUnusedBundles(const rpc::ReleaseUnusedBundlesRequest &request,
+                                  rpc::ReleaseUnusedBundlesReply *reply,
+                                  rpc::SendReplyCallback send_reply_callback) override {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+
+  void HandleGetSystemConfig(const rpc::GetSystemConfigRequest &request,
+                             rpc::GetSystemConfigReply *reply,
+                             rpc::SendReplyCallback send_reply_callback) override {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+
+  void HandleGetGcsServerAddress(const rpc::GetGcsServerAddressRequest &request,
+                                 rpc::GetGcsServerAddressReply *reply,
+                                 rpc::SendReplyCallback send_reply_callback) override {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+
+  void HandleDrainObjects(const rpc::DrainObjectsRequest &request,
+                          rpc::DrainObjectsReply *reply,
+                          rpc::SendReplyCallback send_reply_callback) override {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+
+ private:
+  rpc::GrpcServer server_;
+  rpc::NodeManagerGrpcService service_;
+};
+
+/// The latencies and failures of one RPC method since the last report.
+struct RpcStats {
+  std::vector<int64_t> latencies_us;
+  int64_t num_failed = 0;
+};
+
+int64_t Percentile(const std::vector<int64_t> &sorted, double percentile) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  return sorted[std::min(sorted.size() - 1,
+                         static_cast<size_t>(sorted.size() * percentile / 100))];
+}
+
+/// The CPU time of a process in seconds, from /proc, or -1 if it can't be read.
+double GetProcessCpuSeconds(int pid) {
+  std::ifstream file("/proc/" + std::to_string(pid) + "/stat");
+  std::string stat((std::istreambuf_iterator<char>(file)),
+                   std::istreambuf_iterator<char>());
+  // The command name in parentheses may contain spaces, the fields after it don't.
+  auto pos = stat.rfind(')');
+  if (pos == std::string::npos || pos + 2 >= stat.size()) {
+    return -1;
+  }
+  std::istringstream fields(stat.substr(pos + 2));
+  std::string field;
+  int64_t utime = 0, stime = 0;
+  // utime and stime are the 14th and 15th fields, the 12th and 13th after the name.
+  for (int i = 0; i < 13 && fields >> field; i++) {
+    if (i == 11) {
+      utime = std::stoll(field);
+    } else if (i == 12) {
+      stime = std::stoll(field);
+    }
+  }
+  return static_cast<double>(utime + stime) / sysconf(_SC_CLK_TCK);
+}
+
+/// Drives the simulated nodes and workers. Everything runs on one io service, so the
+/// state needs no locking.
+class LoadGenerator {
+ public:
+  LoadGenerator(instrumented_io_context &io_service,
+                rpc::ClientCallManager &client_call_manager, int node_manager_port)
+      : io_service_(io_service),
+        runner_(io_service),
+        gcs_client_(FLAGS_gcs_address, FLAGS_gcs_port, client_call_manager),
+        node_manager_port_(node_manager_port),
+        job_id_(JobID::FromInt(1)) {}
+
+  void Start() {
+    for (int i = 0; i < FLAGS_num_subscribers; i++) {
+      Subscribe();
+    }
+    rpc::AddJobRequest request;
+    request.mutable_data()->CopyFrom(*Mocker::GenJobTableData(job_id_));
+    Call<rpc::AddJobReply>("AddJob", [this, request](const auto &callback) {
+      gcs_client_.AddJob(request, callback);
+    });
+    last_report_time_ = absl::Now();
+    last_gcs_cpu_seconds_ = FLAGS_gcs_pid > 0 ? GetProcessCpuSeconds(FLAGS_gcs_pid) : -1;
+    runner_.RunFnPeriodically([this] { Tick(); }, kTickMs, "GcsLoadBench.Tick");
+    runner_.RunFnPeriodically([this] { Report(); }, FLAGS_report_interval_s * 1000,
+                              "GcsLoadBench.Report");
+  }
+
+ private:
+  /// Send a request and record its latency under the given name once it replies.
+  template <typename Reply>
+  void Call(const std::string &name,
+            std::function<void(const rpc::ClientCallback<Reply> &)> send,
+            std::function<void(const Reply &)> on_success = nullptr) {
+    const auto send_time = absl::GetCurrentTimeNanos();
+    send([this, name, send_time, on_success](const Status &status, const Reply &reply) {
+      auto &stats = rpc_stats_[name];
+      stats.latencies_us.push_back((absl::GetCurrentTimeNanos() - send_time) / 1000);
+      if (!status.ok()) {
+        stats.num_failed++;
+      } else if (on_success) {
+        on_success(reply);
+      }
+    });
+  }
+
+  void Tick() {
+    tick_++;
+    // Register the nodes gradually, as a cluster scales up.
+    register_credit_ += FLAGS_node_register_rate * kTickMs / 1000;
+    while (register_credit_ >= 1 &&
+           static_cast<int>(nodes_.size()) < FLAGS_num_nodes) {
+      register_credit_--;
+      RegisterNode();
+    }
+
+    // Each tick sends the periodic requests of the slice of nodes that are due, so
+    // that the requests of a period are spread over it.
+    SendDue(FLAGS_heartbeat_period_ms, [this](const NodeID &node_id) {
+      rpc::ReportHeartbeatRequest request;
+      request.mutable_heartbeat()->set_node_id(node_id.Binary());
+      Call<rpc::ReportHeartbeatReply>(
+          "ReportHeartbeat", [this, request](const auto &callback) {
+            gcs_client_.ReportHeartbeat(request, callback);
+          });
+    });
+    SendDue(FLAGS_resource_report_period_ms, [this](const NodeID &node_id) {
+      rpc::ReportResourceUsageRequest request;
+      auto resources = request.mutable_resources();
+      resources->set_node_id(node_id.Binary());
+      (*resources->mutable_resources_total())["CPU"] = FLAGS_cpus_per_node;
+      // Tasks come and go, so the available resources change between reports.
+      (*resources->mutable_resources_available())["CPU"] =
+          absl::Uniform<int>(bitgen_, 0, static_cast<int>(FLAGS_cpus_per_node) + 1);
+      resources->set_resources_available_changed(true);
+      Call<rpc::ReportResourceUsageReply>(
+          "ReportResourceUsage", [this, request](const auto &callback) {
+            gcs_client_.ReportResourceUsage(request, callback);
+          });
+    });
+
+    if (nodes_.empty()) {
+      return;
+    }
+    actor_credit_ += FLAGS_actor_rate * kTickMs / 1000;
+    while (actor_credit_ >= 1) {
+      actor_credit_--;
+      RegisterActor();
+    }
+    placement_group_credit_ += FLAGS_placement_group_rate * kTickMs / 1000;
+    while (placement_group_credit_ >= 1) {
+      placement_group_credit_--;
+      CreatePlacementGroup();
+    }
+  }
+
+  void SendDue(int64_t period_ms, const std::function<void(const NodeID &)> &send) {
+    if (period_ms <= 0) {
+      return;
+    }
+    const uint64_t num_slices = std::max<int64_t>(period_ms / kTickMs, 1);
+    for (size_t i = tick_ % num_slices; i < nodes_.size(); i += num_slices) {
+      send(nodes_[i]);
+    }
+  }
+
+  void RegisterNode() {
+    const auto node_id = NodeID::FromRandom();
+    rpc::RegisterNodeRequest request;
+    auto node_info = request.mutable_node_info();
+    node_info->set_node_id(node_id.Binary());
+    node_info->set_node_manager_address("127.0.0.1");
+    node_info->set_node_manager_port(node_manager_port_);
+    node_info->set_object_manager_port(node_manager_port_);
+    node_info->set_node_manager_hostname("gcs_load_bench");
+    node_info->set_state(rpc::GcsNodeInfo::ALIVE);
+    Call<rpc::RegisterNodeReply>(
+        "RegisterNode",
+        [this, request](const auto &callback) {
+          gcs_client_.RegisterNode(request, callback);
+        },
+        [this, node_id](const rpc::RegisterNodeReply &) { nodes_.push_back(node_id); });
+  }
+
+  void RegisterActor() {
+    auto request = Mocker::GenRegisterActorRequest(job_id_);
+    const auto actor_id = TaskSpecification(request.task_spec()).ActorCreationId();
+    Call<rpc::RegisterActorReply>(
+        "RegisterActor",
+        [this, request](const auto &callback) {
+          gcs_client_.RegisterActor(request, callback);
+        },
+        [this, actor_id](const rpc::RegisterActorReply &) {
+          // Workers look up the actors they get a handle to.
+          rpc::GetActorInfoRequest request;
+          request.set_actor_id(actor_id.Binary());
+          Call<rpc::GetActorInfoReply>("GetActorInfo",
+                                       [this, request](const auto &callback) {
+                                         gcs_client_.GetActorInfo(request, callback);
+                                       });
+        });
+  }
+
+  void CreatePlacementGroup() {
+    auto request = Mocker::GenCreatePlacementGroupRequest(
+        "", rpc::PlacementStrategy::SPREAD, FLAGS_bundles_per_placement_group,
+        /*cpu_num=*/1.0, job_id_);
+    const auto placement_group_id =
+        request.placement_group_spec().placement_group_id();
+    Call<rpc::CreatePlacementGroupReply>(
+        "CreatePlacementGroup",
+        [this, request](const auto &callback) {
+          gcs_client_.CreatePlacementGroup(request, callback);
+        },
+        [this, placement_group_id](const rpc::CreatePlacementGroupReply &) {
+          rpc::WaitPlacementGroupUntilReadyRequest request;
+          request.set_placement_group_id(placement_group_id);
+          Call<rpc::WaitPlacementGroupUntilReadyReply>(
+              "WaitPlacementGroupUntilReady",
+              [this, request](const auto &callback) {
+                gcs_client_.WaitPlacementGroupUntilReady(request, callback);
+              },
+              [this, placement_group_id](const rpc::WaitPlacementGroupUntilReadyReply &) {
+                rpc::RemovePlacementGroupRequest request;
+                request.set_placement_group_id(placement_group_id);
+                Call<rpc::RemovePlacementGroupReply>(
+                    "RemovePlacementGroup", [this, request](const auto &callback) {
+                      gcs_client_.RemovePlacementGroup(request, callback);
+                    });
+              });
+        });
+  }
+
+  /// Subscribe to the channels that raylets and workers subscribe to, over a Redis
+  /// connection of its own.
+  void Subscribe() {
+    gcs::RedisClientOptions options(FLAGS_redis_address, FLAGS_redis_port,
+                                    FLAGS_redis_password);
+    auto redis_client = std::make_shared<gcs::RedisClient>(options);
+    RAY_CHECK_OK(redis_client->Connect(io_service_));
+    auto pub_sub = std::make_shared<gcs::GcsPubSub>(redis_client);
+    for (const auto &channel :
+         {NODE_CHANNEL, NODE_RESOURCE_CHANNEL, ACTOR_CHANNEL, RESOURCES_BATCH_CHANNEL}) {
+      RAY_CHECK_OK(pub_sub->SubscribeAll(
+          channel,
+          [this](const std::string &id, const std::string &data) {
+            num_messages_received_++;
+          },
+          nullptr));
+    }
+    redis_clients_.push_back(redis_client);
+    pub_subs_.push_back(pub_sub);
+  }
+
+  void Report() {
+    const auto now = absl::Now();
+    const double seconds = absl::ToDoubleSeconds(now - last_report_time_);
+    last_report_time_ = now;
+    std::cout << "Nodes: " << nodes_.size() << ", pubsub messages received: "
+              << static_cast<int64_t>(num_messages_received_ / seconds) << "/s";
+    num_messages_received_ = 0;
+    if (FLAGS_gcs_pid > 0) {
+      const double gcs_cpu_seconds = GetProcessCpuSeconds(FLAGS_gcs_pid);
+      if (gcs_cpu_seconds >= 0 && last_gcs_cpu_seconds_ >= 0) {
+        std::cout << ", GCS CPU: "
+                  << static_cast<int64_t>(
+                         (gcs_cpu_seconds - last_gcs_cpu_seconds_) / seconds * 100)
+                  << "%";
+      }
+      last_gcs_cpu_seconds_ = gcs_cpu_seconds;
+    }
+    std::cout << "\n";
+    for (auto &entry : rpc_stats_) {
+      auto &latencies = entry.second.latencies_us;
+      std::sort(latencies.begin(), latencies.end());
+      std::cout << "  " << entry.first << ": "
+                << static_cast<int64_t>(latencies.size() / seconds)
+                << "/s, failed: " << entry.second.num_failed
+                << ", latency (us): p50 = " << Percentile(latencies, 50)
+                << ", p99 = " << Percentile(latencies, 99)
+                << ", max = " << Percentile(latencies, 100) << "\n";
+    }
+    std::cout << std::flush;
+    rpc_stats_.clear();
+  }
+
+  instrumented_io_context &io_service_;
+  PeriodicalRunner runner_;
+  rpc::GcsRpcClient gcs_client_;
+  const int node_manager_port_;
+  const JobID job_id_;
+  absl::BitGen bitgen_;
+  uint64_t tick_ = 0;
+  double register_credit_ = 0;
+  double actor_credit_ = 0;
+  double placement_group_credit_ = 0;
+  /// The registered nodes.
+  std::vector<NodeID> nodes_;
+  std::vector<std::shared_ptr<gcs::RedisClient>> redis_clients_;
+  std::vector<std::shared_ptr<gcs::GcsPubSub>> pub_subs_;
+  int64_t num_messages_received_ = 0;
+  /// The stats of each RPC method, by name.
+  std::map<std::string, RpcStats> rpc_stats_;
+  absl::Time last_report_time_;
+  double last_gcs_cpu_seconds_ = -1;
+};
+
+}  // namespace
+
+}  // namespace ray
+
+int main(int argc, char *argv[]) {
+  InitShutdownRAII ray_log_shutdown_raii(ray::RayLog::StartRayLog,
+                                         ray::RayLog::ShutDownRayLog, argv[0],
+                                         ray::RayLogLevel::WARNING,
+                                         /*log_dir=*/"");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  RAY_CHECK(FLAGS_gcs_port > 0) << "--gcs_port is required.";
+  RayConfig::instance().initialize(FLAGS_ray_config);
+
+  instrumented_io_context io_service("gcs_load_bench");
+  boost::asio::io_service::work work(io_service);
+  std::thread io_thread([&io_service] { io_service.run(); });
+  {
+    ray::FakeNodeManager node_manager(io_service);
+    ray::rpc::ClientCallManager client_call_manager(io_service, FLAGS_num_rpc_threads);
+    ray::LoadGenerator generator(io_service, client_call_manager,
+                                 node_manager.GetPort());
+    io_service.post([&generator] { generator.Start(); }, "GcsLoadBench.Start");
+    std::this_thread::sleep_for(std::chrono::seconds(FLAGS_duration_s));
+    io_service.stop();
+    io_thread.join();
+  }
+  gflags::ShutDownCommandLineFlags();
+  return 0;
+}
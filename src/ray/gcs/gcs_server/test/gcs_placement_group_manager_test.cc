@@ -53,6 +53,19 @@ class MockPlacementGroupScheduler : public gcs::GcsPlacementGroupSchedulerInterf
     return bundles;
   }
 
+  absl::flat_hash_map<PlacementGroupID, std::vector<int64_t>> ReleaseBundlesToFit(
+      const std::shared_ptr<gcs::GcsPlacementGroup> &placement_group,
+      const std::function<bool(const PlacementGroupID &)> &is_movable,
+      size_t max_bundles) override {
+    absl::flat_hash_map<PlacementGroupID, std::vector<int64_t>> bundles;
+    for (const auto &entry : bundles_to_release_) {
+      if (is_movable(entry.first)) {
+        bundles.insert(entry);
+      }
+    }
+    return bundles;
+  }
+
   int GetPlacementGroupCount() {
     absl::MutexLock lock(&mutex_);
     return placement_groups_.size();
@@ -60,6 +73,7 @@ class MockPlacementGroupScheduler : public gcs::GcsPlacementGroupSchedulerInterf
 
   PlacementGroupID group_on_dead_node_;
   std::vector<int64_t> bundles_on_dead_node_;
+  absl::flat_hash_map<PlacementGroupID, std::vector<int64_t>> bundles_to_release_;
   std::vector<std::shared_ptr<gcs::GcsPlacementGroup>> placement_groups_;
   absl::Mutex mutex_;
 };
@@ -75,7 +89,8 @@ class GcsPlacementGroupManagerTest : public ::testing::Test {
     gcs_placement_group_manager_.reset(new gcs::GcsPlacementGroupManager(
         io_service_, mock_placement_group_scheduler_, gcs_table_storage_,
         *gcs_resource_manager_,
-        [this](const JobID &job_id) { return job_namespace_table_[job_id]; }));
+        [this](const JobID &job_id) { return job_namespace_table_[job_id]; },
+        [this]() { return pinned_placement_groups_; }));
     for (int i = 1; i <= 10; i++) {
       auto job_id = JobID::FromInt(i);
       job_namespace_table_[job_id] = "";
@@ -136,6 +151,7 @@ class GcsPlacementGroupManagerTest : public ::testing::Test {
   std::shared_ptr<MockPlacementGroupScheduler> mock_placement_group_scheduler_;
   std::unique_ptr<gcs::GcsPlacementGroupManager> gcs_placement_group_manager_;
   std::unordered_map<JobID, std::string> job_namespace_table_;
+  absl::flat_hash_set<PlacementGroupID> pinned_placement_groups_;
 
  private:
   std::unique_ptr<std::thread> thread_io_service_;
@@ -184,6 +200,25 @@ TEST_F(GcsPlacementGroupManagerTest, TestSchedulingFailed) {
   ASSERT_EQ(placement_group->GetState(), rpc::PlacementGroupTableData::CREATED);
 }
 
+TEST_F(GcsPlacementGroupManagerTest, TestConcurrentScheduling) {
+  RayConfig::instance().initialize(
+      R"({"gcs_max_concurrent_placement_group_scheduling": 2})");
+  for (int i = 0; i < 3; ++i) {
+    RegisterPlacementGroup(Mocker::GenCreatePlacementGroupRequest(),
+                           [](const Status &status) {});
+  }
+  // Only two placement groups are scheduled at the same time.
+  WaitForExpectedPgCount(2);
+  ASSERT_EQ(mock_placement_group_scheduler_->GetPlacementGroupCount(), 2);
+
+  // The third one is scheduled once one of them is created.
+  auto placement_group = mock_placement_group_scheduler_->placement_groups_.front();
+  OnPlacementGroupCreationSuccess(placement_group);
+  WaitForExpectedPgCount(3);
+  RayConfig::instance().initialize(
+      R"({"gcs_max_concurrent_placement_group_scheduling": 1})");
+}
+
 TEST_F(GcsPlacementGroupManagerTest, TestGetPlacementGroupIDByName) {
   auto request = Mocker::GenCreatePlacementGroupRequest("test_name");
   std::atomic<int> registered_placement_group_count(0);
@@ -384,6 +419,51 @@ TEST_F(GcsPlacementGroupManagerTest, TestRescheduleWhenNodeDead) {
             placement_group->GetPlacementGroupID());
 }
 
+TEST_F(GcsPlacementGroupManagerTest, TestDefragmentPlacementGroups) {
+  auto request1 = Mocker::GenCreatePlacementGroupRequest();
+  RegisterPlacementGroup(request1, [](Status status) {});
+  WaitForExpectedPgCount(1);
+  auto created_group = mock_placement_group_scheduler_->placement_groups_.back();
+  created_group->GetMutableBundle(0)->set_node_id(NodeID::FromRandom().Binary());
+  created_group->GetMutableBundle(1)->set_node_id(NodeID::FromRandom().Binary());
+  mock_placement_group_scheduler_->placement_groups_.pop_back();
+  OnPlacementGroupCreationSuccess(created_group);
+  ASSERT_EQ(created_group->GetState(), rpc::PlacementGroupTableData::CREATED);
+
+  auto request2 =
+      Mocker::GenCreatePlacementGroupRequest("", rpc::PlacementStrategy::STRICT_PACK);
+  RegisterPlacementGroup(request2, [](Status status) {});
+  WaitForExpectedPgCount(1);
+  auto pending_group = mock_placement_group_scheduler_->placement_groups_.back();
+  mock_placement_group_scheduler_->placement_groups_.pop_back();
+  mock_placement_group_scheduler_->bundles_to_release_
+      [created_group->GetPlacementGroupID()] = {0};
+
+  // The bundles of a pinned placement group are not moved.
+  pinned_placement_groups_.insert(created_group->GetPlacementGroupID());
+  gcs_placement_group_manager_->OnPlacementGroupCreationFailed(pending_group);
+  gcs_placement_group_manager_->DefragmentPlacementGroups();
+  ASSERT_EQ(created_group->GetState(), rpc::PlacementGroupTableData::CREATED);
+  WaitForExpectedPgCount(1);
+  mock_placement_group_scheduler_->placement_groups_.pop_back();
+
+  // The released bundle is unplaced, and the pending placement group is scheduled before
+  // the placement group whose bundle was moved.
+  pinned_placement_groups_.clear();
+  gcs_placement_group_manager_->OnPlacementGroupCreationFailed(pending_group);
+  gcs_placement_group_manager_->DefragmentPlacementGroups();
+  ASSERT_EQ(created_group->GetState(), rpc::PlacementGroupTableData::RESCHEDULING);
+  WaitForExpectedPgCount(1);
+  ASSERT_EQ(mock_placement_group_scheduler_->placement_groups_[0]->GetPlacementGroupID(),
+            pending_group->GetPlacementGroupID());
+  EXPECT_TRUE(
+      NodeID::FromBinary(created_group->GetBundles()[0]->GetMutableMessage().node_id())
+          .IsNil());
+  EXPECT_FALSE(
+      NodeID::FromBinary(created_group->GetBundles()[1]->GetMutableMessage().node_id())
+          .IsNil());
+}
+
 TEST_F(GcsPlacementGroupManagerTest, TestAutomaticCleanupWhenActorDeadAndJobDead) {
   // Test the scenario where actor dead -> job dead.
   const auto job_id = JobID::FromInt(1);
@@ -58,6 +58,24 @@ TEST_F(GcsResourceManagerTest, TestBasic) {
   ASSERT_TRUE(gcs_resource_manager_->AcquireResources(node_id, resource_set));
 }
 
+TEST_F(GcsResourceManagerTest, TestGetAllTotalResources) {
+  auto node_id = NodeID::FromRandom();
+  gcs_resource_manager_->UpdateResourceCapacity(node_id, {{"CPU", 10}, {"GPU", 2}});
+  // Acquired resources don't change the total.
+  std::unordered_map<std::string, double> acquired = {{"CPU", 4}};
+  ASSERT_TRUE(gcs_resource_manager_->AcquireResources(node_id, ResourceSet(acquired)));
+
+  rpc::GetAllTotalResourcesRequest request;
+  rpc::GetAllTotalResourcesReply reply;
+  auto send_reply_callback = [](ray::Status status, std::function<void()> f1,
+                                std::function<void()> f2) {};
+  gcs_resource_manager_->HandleGetAllTotalResources(request, &reply, send_reply_callback);
+  ASSERT_EQ(reply.resources_list_size(), 1);
+  ASSERT_EQ(reply.resources_list(0).node_id(), node_id.Binary());
+  ASSERT_EQ(reply.resources_list(0).resources_total().at("CPU"), 10);
+  ASSERT_EQ(reply.resources_list(0).resources_total().at("GPU"), 2);
+}
+
 TEST_F(GcsResourceManagerTest, TestResourceUsageAPI) {
   auto node = Mocker::GenNodeInfo();
   auto node_id = NodeID::FromBinary(node->node_id());
@@ -85,6 +103,62 @@ TEST_F(GcsResourceManagerTest, TestResourceUsageAPI) {
   ASSERT_EQ(get_all_reply2.resource_usage_data().batch().size(), 0);
 }
 
+TEST_F(GcsResourceManagerTest, TestResourceUsageDelta) {
+  auto node_id = NodeID::FromRandom();
+  rpc::ResourcesData snapshot;
+  snapshot.set_node_id(node_id.Binary());
+  snapshot.set_resources_version(1);
+  snapshot.set_resources_available_changed(true);
+  (*snapshot.mutable_resources_available())["CPU"] = 2;
+  (*snapshot.mutable_resources_available())["GPU"] = 1;
+  (*snapshot.mutable_resources_total())["CPU"] = 2;
+  (*snapshot.mutable_resources_total())["GPU"] = 1;
+  gcs_resource_manager_->UpdateFromResourceReport(snapshot);
+
+  // Only the CPUs changed.
+  rpc::ResourcesData delta;
+  delta.set_node_id(node_id.Binary());
+  delta.set_resources_version(2);
+  delta.set_resources_delta(true);
+  delta.set_resources_available_changed(true);
+  (*delta.mutable_resources_available())["CPU"] = 0;
+  gcs_resource_manager_->UpdateFromResourceReport(delta);
+
+  // A report older than the last applied one is ignored.
+  rpc::ResourcesData stale = delta;
+  stale.set_resources_version(1);
+  (*stale.mutable_resources_available())["GPU"] = 0;
+  gcs_resource_manager_->UpdateFromResourceReport(stale);
+
+  rpc::GetAllResourceUsageRequest get_all_request;
+  rpc::GetAllResourceUsageReply get_all_reply;
+  auto send_reply_callback = [](ray::Status status, std::function<void()> f1,
+                                std::function<void()> f2) {};
+  gcs_resource_manager_->HandleGetAllResourceUsage(get_all_request, &get_all_reply,
+                                                   send_reply_callback);
+  ASSERT_EQ(get_all_reply.resource_usage_data().batch().size(), 1);
+  const auto &usage = get_all_reply.resource_usage_data().batch(0);
+  ASSERT_EQ(usage.resources_available().size(), 1);
+  ASSERT_EQ(usage.resources_available().at("GPU"), 1);
+  ASSERT_EQ(usage.resources_total().size(), 2);
+  const auto available = gcs_resource_manager_->GetClusterResources()
+                             .at(node_id)
+                             .GetAvailableResources()
+                             .GetResourceMap();
+  ASSERT_EQ(available.count("CPU"), 0);
+  ASSERT_EQ(available.at("GPU"), 1);
+
+  // The delta is merged into the snapshot that has not been broadcast yet.
+  rpc::ResourceUsageBroadcastData broadcast;
+  gcs_resource_manager_->GetResourceUsageBatchForBroadcast(broadcast);
+  ASSERT_EQ(broadcast.batch().size(), 1);
+  const auto &merged = broadcast.batch(0).data();
+  ASSERT_FALSE(merged.resources_delta());
+  ASSERT_EQ(merged.resources_version(), 2);
+  ASSERT_EQ(merged.resources_available().at("CPU"), 0);
+  ASSERT_EQ(merged.resources_available().at("GPU"), 1);
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
@@ -151,19 +151,21 @@ struct GcsServerMocker {
 
     /// ResourceReserveInterface
     void PrepareBundleResources(
-        const BundleSpecification &bundle_spec,
+        const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
         const ray::rpc::ClientCallback<ray::rpc::PrepareBundleResourcesReply> &callback)
         override {
       num_lease_requested += 1;
+      num_lease_bundles_requested += bundle_specs.size();
       lease_callbacks.push_back(callback);
     }
 
     /// ResourceReserveInterface
     void CommitBundleResources(
-        const BundleSpecification &bundle_spec,
+        const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
         const ray::rpc::ClientCallback<ray::rpc::CommitBundleResourcesReply> &callback)
         override {
       num_commit_requested += 1;
+      num_commit_bundles_requested += bundle_specs.size();
       commit_callbacks.push_back(callback);
     }
 
@@ -230,6 +232,14 @@ struct GcsServerMocker {
         const rpc::Address &caller_address, const std::vector<ObjectID> &object_ids,
         const ray::rpc::ClientCallback<ray::rpc::PinObjectIDsReply> &callback) override {}
 
+    void ReplicateObjectIDs(
+        const rpc::Address &caller_address, const std::vector<ObjectID> &object_ids,
+        const ray::rpc::ClientCallback<ray::rpc::PinObjectIDsReply> &callback) override {}
+
+    void MigrateObjectIDs(
+        const rpc::Address &owner_address, const std::vector<ObjectID> &object_ids,
+        const ray::rpc::ClientCallback<ray::rpc::PinObjectIDsReply> &callback) override {}
+
     /// DependencyWaiterInterface
     ray::Status WaitForDirectActorCallArgs(
         const std::vector<rpc::ObjectReference> &references, int64_t tag) override {
@@ -251,7 +261,7 @@ struct GcsServerMocker {
 
     /// ResourceUsageInterface
     void UpdateResourceUsage(
-        std::string &address,
+        std::string &address, const std::vector<rpc::Address> &forward_to,
         const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &callback) override {
       RAY_CHECK(false) << "Unused";
     };
@@ -268,8 +278,10 @@ struct GcsServerMocker {
     std::list<rpc::ClientCallback<rpc::CancelWorkerLeaseReply>> cancel_callbacks = {};
     std::list<rpc::ClientCallback<rpc::ReleaseUnusedWorkersReply>> release_callbacks = {};
     int num_lease_requested = 0;
+    int num_lease_bundles_requested = 0;
     int num_return_requested = 0;
     int num_commit_requested = 0;
+    int num_commit_bundles_requested = 0;
 
     int num_release_unused_bundles_requested = 0;
     std::list<rpc::ClientCallback<rpc::PrepareBundleResourcesReply>> lease_callbacks = {};
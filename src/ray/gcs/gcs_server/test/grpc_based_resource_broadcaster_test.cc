@@ -28,6 +28,7 @@ class GrpcBasedResourceBroadcasterTest : public ::testing::Test {
  public:
   GrpcBasedResourceBroadcasterTest()
       : num_batches_sent_(0),
+        num_forwarded_(0),
         broadcaster_(
             /*raylet_client_pool*/ nullptr,
             /*get_resource_usage_batch_for_broadcast*/
@@ -42,8 +43,10 @@ class GrpcBasedResourceBroadcasterTest : public ::testing::Test {
             /*send_batch*/
             [this](const rpc::Address &address,
                    std::shared_ptr<rpc::NodeManagerClientPool> &pool, std::string &data,
+                   const std::vector<rpc::Address> &forward_to,
                    const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &callback) {
               num_batches_sent_++;
+              num_forwarded_ += forward_to.size();
               callbacks_.push_back(callback);
             }) {}
 
@@ -56,6 +59,7 @@ class GrpcBasedResourceBroadcasterTest : public ::testing::Test {
   }
 
   int num_batches_sent_;
+  size_t num_forwarded_;
   std::deque<rpc::ClientCallback<rpc::UpdateResourceUsageReply>> callbacks_;
 
   GrpcBasedResourceBroadcaster broadcaster_;
@@ -111,6 +115,28 @@ TEST_F(GrpcBasedResourceBroadcasterTest, TestStragglerNodes) {
   ASSERT_EQ(num_batches_sent_, 27);
 }
 
+TEST_F(GrpcBasedResourceBroadcasterTest, TestBroadcastTree) {
+  broadcaster_.broadcast_fanout_ = 3;
+  for (int i = 0; i < 10; i++) {
+    auto node_info = Mocker::GenNodeInfo();
+    broadcaster_.HandleNodeAdded(*node_info);
+  }
+
+  // Only the heads of the 3 relay groups are sent to directly, and they relay the batch
+  // to the remaining 7 nodes.
+  SendBroadcast();
+  ASSERT_EQ(callbacks_.size(), 3);
+  ASSERT_EQ(num_batches_sent_, 3);
+  ASSERT_EQ(num_forwarded_, 7);
+
+  // The group heads haven't replied yet, so the next round skips them and builds the
+  // tree out of the other 7 nodes.
+  SendBroadcast();
+  ASSERT_EQ(callbacks_.size(), 6);
+  ASSERT_EQ(num_batches_sent_, 6);
+  ASSERT_EQ(num_forwarded_, 11);
+}
+
 TEST_F(GrpcBasedResourceBroadcasterTest, TestNodeRemoval) {
   auto node_info = Mocker::GenNodeInfo();
   broadcaster_.HandleNodeAdded(*node_info);
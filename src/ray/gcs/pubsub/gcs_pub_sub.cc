@@ -45,6 +45,14 @@ Status GcsPubSub::SubscribeAll(const std::string &channel, const Callback &subsc
   return SubscribeInternal(channel, subscribe, done, true);
 }
 
+Status GcsPubSub::SubscribeByPattern(const std::string &channel,
+                                     const std::string &id_pattern,
+                                     const Callback &subscribe,
+                                     const StatusCallback &done) {
+  return SubscribeInternal(channel, subscribe, done, true,
+                           boost::optional<std::string>(id_pattern));
+}
+
 Status GcsPubSub::Unsubscribe(const std::string &channel_name, const std::string &id) {
   std::string pattern = GenChannelPattern(channel_name, id);
 
@@ -80,6 +80,17 @@ class GcsPubSub {
   Status SubscribeAll(const std::string &channel, const Callback &subscribe,
                       const StatusCallback &done);
 
+  /// Subscribe to messages whose ID matches a glob pattern under the specified channel.
+  ///
+  /// \param channel The channel to subscribe from redis.
+  /// \param id_pattern The glob pattern of the ids of messages to be subscribed.
+  /// \param subscribe Callback that will be called when a subscription message is
+  /// received.
+  /// \param done Callback that will be called when subscription is complete.
+  /// \return Status
+  Status SubscribeByPattern(const std::string &channel, const std::string &id_pattern,
+                            const Callback &subscribe, const StatusCallback &done);
+
   /// Unsubscribe to messages with the specified ID under the specified channel.
   ///
   /// \param channel The channel to unsubscribe from redis.
@@ -14,6 +14,8 @@
 
 #include "ray/gcs/redis_client.h"
 
+#include <algorithm>
+
 #include "ray/common/ray_config.h"
 #include "ray/gcs/redis_context.h"
 
@@ -129,37 +131,46 @@ Status RedisClient::Connect(std::vector<instrumented_io_context *> io_services)
       /*password=*/options_.password_, options_.enable_sync_conn_,
       options_.enable_async_conn_, options_.enable_subscribe_conn_));
 
+  std::vector<std::string> addresses;
+  std::vector<int> ports;
   if (options_.enable_sharding_conn_) {
     // Moving sharding into constructor defaultly means that sharding = true.
     // This design decision may worth a look.
-    std::vector<std::string> addresses;
-    std::vector<int> ports;
     GetRedisShards(primary_context_->sync_context(), &addresses, &ports);
     if (addresses.empty()) {
       RAY_CHECK(ports.empty());
       addresses.push_back(options_.server_ip_);
       ports.push_back(options_.server_port_);
     }
+  } else {
+    addresses.push_back(options_.server_ip_);
+    ports.push_back(options_.server_port_);
+  }
 
-    for (size_t i = 0; i < addresses.size(); ++i) {
-      size_t io_service_index = (i + 1) % io_services.size();
-      instrumented_io_context &io_service = *io_services[io_service_index];
-      // Populate shard_contexts.
-      shard_contexts_.push_back(std::make_shared<RedisContext>(io_service));
+  const size_t connections_per_shard =
+      std::max<uint64_t>(1, RayConfig::instance().gcs_redis_connections_per_shard());
+  size_t num_connections = 0;
+  for (size_t i = 0; i < addresses.size(); ++i) {
+    std::vector<std::shared_ptr<RedisContext>> pool;
+    for (size_t j = 0; j < connections_per_shard; ++j) {
+      // Without sharding, the shard connections share the primary context's event
+      // loop as before.
+      size_t io_service_index =
+          options_.enable_sharding_conn_ ? (++num_connections) % io_services.size() : 0;
+      auto context = std::make_shared<RedisContext>(*io_services[io_service_index]);
       // Only async context is used in sharding context, so wen disable the other two.
-      RAY_CHECK_OK(shard_contexts_[i]->Connect(
-          addresses[i], ports[i], /*sharding=*/true,
-          /*password=*/options_.password_, /*enable_sync_conn=*/false,
-          /*enable_async_conn=*/true, /*enable_subscribe_conn=*/false));
+      RAY_CHECK_OK(context->Connect(addresses[i], ports[i], /*sharding=*/true,
+                                    /*password=*/options_.password_,
+                                    /*enable_sync_conn=*/false,
+                                    /*enable_async_conn=*/true,
+                                    /*enable_subscribe_conn=*/false));
+      pool.push_back(std::move(context));
     }
-  } else {
-    shard_contexts_.push_back(std::make_shared<RedisContext>(*io_services[0]));
-    // Only async context is used in sharding context, so wen disable the other two.
-    RAY_CHECK_OK(shard_contexts_[0]->Connect(
-        options_.server_ip_, options_.server_port_,
-        /*sharding=*/true,
-        /*password=*/options_.password_, /*enable_sync_conn=*/false,
-        /*enable_async_conn=*/true, /*enable_subscribe_conn=*/false));
+    shard_contexts_.push_back(pool.front());
+    shard_connection_pools_.push_back(std::move(pool));
+  }
+  if (RayConfig::instance().gcs_redis_consistent_hash_sharding()) {
+    BuildShardRing(addresses, ports);
   }
 
   Attach();
@@ -173,10 +184,12 @@ Status RedisClient::Connect(std::vector<instrumented_io_context *> io_services)
 void RedisClient::Attach() {
   // Take care of sharding contexts.
   RAY_CHECK(shard_asio_async_clients_.empty()) << "Attach shall be called only once";
-  for (std::shared_ptr<RedisContext> context : shard_contexts_) {
-    instrumented_io_context &io_service = context->io_service();
-    shard_asio_async_clients_.emplace_back(
-        new RedisAsioClient(io_service, context->async_context()));
+  for (const auto &pool : shard_connection_pools_) {
+    for (const auto &context : pool) {
+      instrumented_io_context &io_service = context->io_service();
+      shard_asio_async_clients_.emplace_back(
+          new RedisAsioClient(io_service, context->async_context()));
+    }
   }
 
   instrumented_io_context &io_service = primary_context_->io_service();
@@ -196,11 +209,43 @@ void RedisClient::Disconnect() {
   RAY_LOG(DEBUG) << "RedisClient disconnected.";
 }
 
+void RedisClient::BuildShardRing(const std::vector<std::string> &addresses,
+                                 const std::vector<int> &ports) {
+  // Each shard owns several points named after its address, so the ring only depends
+  // on the set of shards and not on their order. Adding or removing a shard moves only
+  // the keys of the ranges it gains or loses.
+  static std::hash<std::string> hash;
+  const size_t points_per_shard = 64;
+  shard_ring_.clear();
+  shard_ring_.reserve(addresses.size() * points_per_shard);
+  for (size_t i = 0; i < addresses.size(); ++i) {
+    const std::string shard_name = addresses[i] + ":" + std::to_string(ports[i]);
+    for (size_t point = 0; point < points_per_shard; ++point) {
+      shard_ring_.emplace_back(hash(shard_name + "#" + std::to_string(point)), i);
+    }
+  }
+  std::sort(shard_ring_.begin(), shard_ring_.end());
+}
+
 std::shared_ptr<RedisContext> RedisClient::GetShardContext(const std::string &shard_key) {
   RAY_CHECK(!shard_contexts_.empty());
   static std::hash<std::string> hash;
-  size_t index = hash(shard_key) % shard_contexts_.size();
-  return shard_contexts_[index];
+  size_t key_hash = hash(shard_key);
+  size_t index;
+  if (shard_ring_.empty()) {
+    index = key_hash % shard_contexts_.size();
+  } else {
+    // The key belongs to the first point at or after its hash, wrapping around.
+    auto it = std::lower_bound(shard_ring_.begin(), shard_ring_.end(),
+                               std::make_pair(key_hash, size_t(0)));
+    index = it == shard_ring_.end() ? shard_ring_.front().second : it->second;
+  }
+  const auto &pool = shard_connection_pools_[index];
+  if (pool.size() == 1) {
+    return pool.front();
+  }
+  // Use the hash bits not consumed by the shard choice to spread keys over the pool.
+  return pool[(key_hash / shard_contexts_.size()) % pool.size()];
 }
 
 int RedisClient::GetNextJobID() {
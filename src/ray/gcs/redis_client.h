@@ -85,10 +85,15 @@ class RedisClient {
   /// Disconnect with Redis. Non-thread safe.
   void Disconnect();
 
+  /// Get one context per data shard. Use these for commands that must visit every
+  /// shard exactly once, such as scans.
   std::vector<std::shared_ptr<RedisContext>> GetShardContexts() {
     return shard_contexts_;
   }
 
+  /// Get the context to send a command on `shard_key` to. The shard is picked by
+  /// hashing the key, and so is the connection within the shard's pool, so commands
+  /// on the same key always go through the same connection and keep their order.
   std::shared_ptr<RedisContext> GetShardContext(const std::string &shard_key);
 
   std::shared_ptr<RedisContext> GetPrimaryContext() { return primary_context_; }
@@ -100,6 +105,10 @@ class RedisClient {
   /// one event loop should be attached at a time.
   void Attach();
 
+  /// Build the consistent hash ring over `shard_contexts_`.
+  void BuildShardRing(const std::vector<std::string> &addresses,
+                      const std::vector<int> &ports);
+
   RedisClientOptions options_;
 
   /// Whether this client is connected to redis.
@@ -107,6 +116,12 @@ class RedisClient {
 
   // The following contexts write to the data shard
   std::vector<std::shared_ptr<RedisContext>> shard_contexts_;
+  // The connection pool of each data shard. `shard_contexts_[i]` is the first
+  // connection of `shard_connection_pools_[i]`.
+  std::vector<std::vector<std::shared_ptr<RedisContext>>> shard_connection_pools_;
+  // Points of the consistent hash ring, sorted by hash, with the index of the shard
+  // owning each point. Empty if keys are routed by modulo hashing.
+  std::vector<std::pair<size_t, size_t>> shard_ring_;
   std::vector<std::unique_ptr<RedisAsioClient>> shard_asio_async_clients_;
   std::vector<std::unique_ptr<RedisAsioClient>> shard_asio_subscribe_clients_;
   // The following context writes everything to the primary shard
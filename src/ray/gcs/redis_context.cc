@@ -154,6 +154,11 @@ void CallbackReply::ParseAsStringArray(redisReply *redis_reply) {
   string_array_reply_.reserve(array_size);
   for (size_t i = 0; i < array_size; ++i) {
     auto *entry = redis_reply->element[i];
+    // MGET returns nil for keys that don't exist.
+    if (REDIS_REPLY_NIL == entry->type) {
+      string_array_reply_.push_back(std::string());
+      continue;
+    }
     RAY_CHECK(REDIS_REPLY_STRING == entry->type) << "Unexcepted type: " << entry->type;
     string_array_reply_.push_back(std::string(entry->str, entry->len));
   }
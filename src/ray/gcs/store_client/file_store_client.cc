@@ -0,0 +1,494 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/store_client/file_store_client.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "ray/common/ray_config.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace gcs {
+
+namespace {
+
+/// Append a record to `out`, prefixed by its length as 4 little-endian bytes.
+void AppendFramedRecord(const rpc::StoreLogRecord &record, std::string *out) {
+  const std::string payload = record.SerializeAsString();
+  const uint32_t size = static_cast<uint32_t>(payload.size());
+  for (int i = 0; i < 4; i++) {
+    out->push_back(static_cast<char>((size >> (8 * i)) & 0xff));
+  }
+  out->append(payload);
+}
+
+Status SyncFile(FILE *file) {
+  if (fflush(file) != 0) {
+    return Status::IOError("Failed to flush the GCS store log.");
+  }
+#ifdef _WIN32
+  int result = _commit(_fileno(file));
+#else
+  int result = fsync(fileno(file));
+#endif
+  if (result != 0) {
+    return Status::IOError("Failed to sync the GCS store log.");
+  }
+  return Status::OK();
+}
+
+void RemoveFromIndex(
+    absl::flat_hash_map<std::string, absl::flat_hash_set<std::string>> &index,
+    const std::string &index_key, const std::string &key) {
+  auto iter = index.find(index_key);
+  if (iter != index.end()) {
+    iter->second.erase(key);
+    if (iter->second.empty()) {
+      index.erase(iter);
+    }
+  }
+}
+
+}  // namespace
+
+FileStoreClient::FileStoreClient(instrumented_io_context &main_io_service,
+                                 std::string log_path)
+    : main_io_service_(main_io_service), log_path_(std::move(log_path)) {
+  Recover();
+  log_file_ = fopen(log_path_.c_str(), "ab");
+  RAY_CHECK(log_file_ != nullptr) << "Failed to open the GCS store log " << log_path_;
+  writer_thread_ = std::thread([this] { WriterLoop(); });
+}
+
+FileStoreClient::~FileStoreClient() {
+  {
+    absl::MutexLock lock(&mutex_);
+    stopped_ = true;
+    pending_cv_.Signal();
+  }
+  writer_thread_.join();
+  if (log_file_ != nullptr) {
+    fclose(log_file_);
+  }
+}
+
+Status FileStoreClient::AsyncPut(const std::string &table_name, const std::string &key,
+                                 const std::string &data,
+                                 const StatusCallback &callback) {
+  rpc::StoreLogRecord record;
+  record.set_op(rpc::StoreLogRecord::PUT);
+  record.set_table_name(table_name);
+  record.add_keys(key);
+  record.set_data(data);
+  AppendRecord(record, callback);
+  return Status::OK();
+}
+
+Status FileStoreClient::AsyncPutWithIndex(const std::string &table_name,
+                                          const std::string &key,
+                                          const std::string &index_key,
+                                          const std::string &data,
+                                          const StatusCallback &callback) {
+  rpc::StoreLogRecord record;
+  record.set_op(rpc::StoreLogRecord::PUT_WITH_INDEX);
+  record.set_table_name(table_name);
+  record.add_keys(key);
+  record.add_index_keys(index_key);
+  record.set_data(data);
+  AppendRecord(record, callback);
+  return Status::OK();
+}
+
+Status FileStoreClient::AsyncGet(const std::string &table_name, const std::string &key,
+                                 const OptionalItemCallback<std::string> &callback) {
+  boost::optional<std::string> data;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto table_iter = tables_.find(table_name);
+    if (table_iter != tables_.end()) {
+      auto iter = table_iter->second.records_.find(key);
+      if (iter != table_iter->second.records_.end()) {
+        data = iter->second;
+      }
+    }
+  }
+  main_io_service_.post([callback, data]() { callback(Status::OK(), data); },
+                        "GcsFileStore.Get");
+  return Status::OK();
+}
+
+Status FileStoreClient::AsyncGetByIndex(
+    const std::string &table_name, const std::string &index_key,
+    const MapCallback<std::string, std::string> &callback) {
+  std::unordered_map<std::string, std::string> result;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto table_iter = tables_.find(table_name);
+    if (table_iter != tables_.end()) {
+      const auto &table = table_iter->second;
+      auto iter = table.index_keys_.find(index_key);
+      if (iter != table.index_keys_.end()) {
+        for (auto &key : iter->second) {
+          auto kv_iter = table.records_.find(key);
+          if (kv_iter != table.records_.end()) {
+            result[kv_iter->first] = kv_iter->second;
+          }
+        }
+      }
+    }
+  }
+  main_io_service_.post([result, callback]() { callback(result); },
+                        "GcsFileStore.GetByIndex");
+  return Status::OK();
+}
+
+Status FileStoreClient::AsyncGetAll(
+    const std::string &table_name,
+    const MapCallback<std::string, std::string> &callback) {
+  std::unordered_map<std::string, std::string> result;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto table_iter = tables_.find(table_name);
+    if (table_iter != tables_.end()) {
+      result.insert(table_iter->second.records_.begin(),
+                    table_iter->second.records_.end());
+    }
+  }
+  main_io_service_.post([result, callback]() { callback(result); },
+                        "GcsFileStore.GetAll");
+  return Status::OK();
+}
+
+Status FileStoreClient::AsyncDelete(const std::string &table_name,
+                                    const std::string &key,
+                                    const StatusCallback &callback) {
+  rpc::StoreLogRecord record;
+  record.set_op(rpc::StoreLogRecord::DELETE);
+  record.set_table_name(table_name);
+  record.add_keys(key);
+  AppendRecord(record, callback);
+  return Status::OK();
+}
+
+Status FileStoreClient::AsyncDeleteWithIndex(const std::string &table_name,
+                                             const std::string &key,
+                                             const std::string &index_key,
+                                             const StatusCallback &callback) {
+  rpc::StoreLogRecord record;
+  record.set_op(rpc::StoreLogRecord::DELETE_WITH_INDEX);
+  record.set_table_name(table_name);
+  record.add_keys(key);
+  record.add_index_keys(index_key);
+  AppendRecord(record, callback);
+  return Status::OK();
+}
+
+Status FileStoreClient::AsyncBatchDelete(const std::string &table_name,
+                                         const std::vector<std::string> &keys,
+                                         const StatusCallback &callback) {
+  rpc::StoreLogRecord record;
+  record.set_op(rpc::StoreLogRecord::BATCH_DELETE);
+  record.set_table_name(table_name);
+  for (const auto &key : keys) {
+    record.add_keys(key);
+  }
+  AppendRecord(record, callback);
+  return Status::OK();
+}
+
+Status FileStoreClient::AsyncBatchDeleteWithIndex(
+    const std::string &table_name, const std::vector<std::string> &keys,
+    const std::vector<std::string> &index_keys, const StatusCallback &callback) {
+  RAY_CHECK(keys.size() == index_keys.size());
+  rpc::StoreLogRecord record;
+  record.set_op(rpc::StoreLogRecord::BATCH_DELETE_WITH_INDEX);
+  record.set_table_name(table_name);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    record.add_keys(keys[i]);
+    record.add_index_keys(index_keys[i]);
+  }
+  AppendRecord(record, callback);
+  return Status::OK();
+}
+
+Status FileStoreClient::AsyncDeleteByIndex(const std::string &table_name,
+                                           const std::string &index_key,
+                                           const StatusCallback &callback) {
+  rpc::StoreLogRecord record;
+  record.set_op(rpc::StoreLogRecord::DELETE_BY_INDEX);
+  record.set_table_name(table_name);
+  record.add_index_keys(index_key);
+  AppendRecord(record, callback);
+  return Status::OK();
+}
+
+int FileStoreClient::GetNextJobID() {
+  absl::MutexLock lock(&mutex_);
+  rpc::StoreLogRecord record;
+  record.set_op(rpc::StoreLogRecord::NEXT_JOB_ID);
+  record.set_job_id(job_id_ + 1);
+  auto seq = AppendRecordLocked(record, nullptr);
+  // Job ids must never be handed out twice, so wait until the counter is durable.
+  while (synced_seq_ < seq && !stopped_) {
+    synced_cv_.Wait(&mutex_);
+  }
+  return record.job_id();
+}
+
+void FileStoreClient::ApplyRecord(const rpc::StoreLogRecord &record) {
+  if (record.op() == rpc::StoreLogRecord::NEXT_JOB_ID) {
+    job_id_ = std::max(job_id_, record.job_id());
+    return;
+  }
+  auto &table = tables_[record.table_name()];
+  switch (record.op()) {
+  case rpc::StoreLogRecord::PUT:
+    table.records_[record.keys(0)] = record.data();
+    break;
+  case rpc::StoreLogRecord::PUT_WITH_INDEX:
+    table.records_[record.keys(0)] = record.data();
+    table.index_keys_[record.index_keys(0)].insert(record.keys(0));
+    break;
+  case rpc::StoreLogRecord::DELETE:
+  case rpc::StoreLogRecord::BATCH_DELETE:
+    for (const auto &key : record.keys()) {
+      table.records_.erase(key);
+    }
+    break;
+  case rpc::StoreLogRecord::DELETE_WITH_INDEX:
+  case rpc::StoreLogRecord::BATCH_DELETE_WITH_INDEX:
+    for (int i = 0; i < record.keys_size(); i++) {
+      table.records_.erase(record.keys(i));
+      RemoveFromIndex(table.index_keys_, record.index_keys(i), record.keys(i));
+    }
+    break;
+  case rpc::StoreLogRecord::DELETE_BY_INDEX: {
+    auto iter = table.index_keys_.find(record.index_keys(0));
+    if (iter != table.index_keys_.end()) {
+      for (const auto &key : iter->second) {
+        table.records_.erase(key);
+      }
+      table.index_keys_.erase(iter);
+    }
+    break;
+  }
+  default:
+    RAY_LOG(FATAL) << "Unknown GCS store log record type " << record.op();
+  }
+}
+
+int64_t FileStoreClient::AppendRecord(const rpc::StoreLogRecord &record,
+                                      const StatusCallback &callback) {
+  absl::MutexLock lock(&mutex_);
+  return AppendRecordLocked(record, callback);
+}
+
+int64_t FileStoreClient::AppendRecordLocked(const rpc::StoreLogRecord &record,
+                                            const StatusCallback &callback) {
+  ApplyRecord(record);
+  auto size_before = pending_log_.size();
+  AppendFramedRecord(record, &pending_log_);
+  log_bytes_ += pending_log_.size() - size_before;
+  if (callback) {
+    pending_callbacks_.push_back(callback);
+  }
+  pending_cv_.Signal();
+  return ++appended_seq_;
+}
+
+void FileStoreClient::Recover() {
+  std::ifstream in(log_path_, std::ios::binary);
+  if (!in.is_open()) {
+    return;
+  }
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+  const std::string content = buffer.str();
+  in.close();
+
+  absl::MutexLock lock(&mutex_);
+  size_t offset = 0;
+  int64_t num_records = 0;
+  while (offset + 4 <= content.size()) {
+    uint32_t size = 0;
+    for (int i = 0; i < 4; i++) {
+      size |= static_cast<uint32_t>(static_cast<uint8_t>(content[offset + i])) << (8 * i);
+    }
+    if (offset + 4 + size > content.size()) {
+      break;
+    }
+    rpc::StoreLogRecord record;
+    if (!record.ParseFromArray(content.data() + offset + 4, size)) {
+      break;
+    }
+    ApplyRecord(record);
+    offset += 4 + size;
+    num_records++;
+  }
+  if (offset != content.size()) {
+    // The tail is a record that was being written when the process died. Its write was
+    // never acknowledged, so it is safe to drop.
+    RAY_LOG(WARNING) << "Dropping " << content.size() - offset
+                     << " bytes of a torn record at the end of the GCS store log "
+                     << log_path_;
+    std::ofstream out(log_path_, std::ios::binary | std::ios::trunc);
+    out.write(content.data(), offset);
+  }
+  log_bytes_ = offset;
+  RAY_LOG(INFO) << "Recovered " << num_records << " records from the GCS store log "
+                << log_path_;
+}
+
+std::string FileStoreClient::SnapshotLocked() const {
+  std::string snapshot;
+  if (job_id_ > 0) {
+    rpc::StoreLogRecord record;
+    record.set_op(rpc::StoreLogRecord::NEXT_JOB_ID);
+    record.set_job_id(job_id_);
+    AppendFramedRecord(record, &snapshot);
+  }
+  for (const auto &table_entry : tables_) {
+    const auto &table = table_entry.second;
+    absl::flat_hash_set<std::string> indexed_keys;
+    for (const auto &index_entry : table.index_keys_) {
+      for (const auto &key : index_entry.second) {
+        auto iter = table.records_.find(key);
+        if (iter == table.records_.end()) {
+          continue;
+        }
+        rpc::StoreLogRecord record;
+        record.set_op(rpc::StoreLogRecord::PUT_WITH_INDEX);
+        record.set_table_name(table_entry.first);
+        record.add_keys(key);
+        record.add_index_keys(index_entry.first);
+        record.set_data(iter->second);
+        AppendFramedRecord(record, &snapshot);
+        indexed_keys.insert(key);
+      }
+    }
+    for (const auto &entry : table.records_) {
+      if (indexed_keys.contains(entry.first)) {
+        continue;
+      }
+      rpc::StoreLogRecord record;
+      record.set_op(rpc::StoreLogRecord::PUT);
+      record.set_table_name(table_entry.first);
+      record.add_keys(entry.first);
+      record.set_data(entry.second);
+      AppendFramedRecord(record, &snapshot);
+    }
+  }
+  return snapshot;
+}
+
+void FileStoreClient::WriterLoop() {
+  const uint64_t compaction_bytes =
+      RayConfig::instance().gcs_file_store_compaction_bytes();
+  while (true) {
+    std::string data;
+    std::vector<StatusCallback> callbacks;
+    int64_t seq;
+    bool compact = false;
+    {
+      absl::MutexLock lock(&mutex_);
+      while (pending_log_.empty() && !stopped_) {
+        pending_cv_.Wait(&mutex_);
+      }
+      if (pending_log_.empty() && stopped_) {
+        break;
+      }
+      // Compact only once the log is also twice the size of the last snapshot, so that
+      // a large live state doesn't cause a compaction on every write.
+      if (compaction_bytes > 0 &&
+          static_cast<uint64_t>(log_bytes_) >
+              std::max(compaction_bytes, 2 * static_cast<uint64_t>(snapshot_bytes_))) {
+        // The snapshot already includes the effect of the pending records.
+        data = SnapshotLocked();
+        pending_log_.clear();
+        log_bytes_ = data.size();
+        snapshot_bytes_ = data.size();
+        compact = true;
+      } else {
+        data.swap(pending_log_);
+      }
+      callbacks.swap(pending_callbacks_);
+      seq = appended_seq_;
+    }
+
+    auto status = compact ? ReplaceLogFile(data) : AppendToLogFile(data);
+    if (!status.ok()) {
+      RAY_LOG(ERROR) << "Failed to write the GCS store log " << log_path_ << ": "
+                     << status.ToString();
+    }
+    {
+      absl::MutexLock lock(&mutex_);
+      synced_seq_ = seq;
+      synced_cv_.SignalAll();
+    }
+    for (auto &callback : callbacks) {
+      main_io_service_.post([callback, status]() { callback(status); },
+                            "GcsFileStore.Write");
+    }
+  }
+}
+
+Status FileStoreClient::AppendToLogFile(const std::string &data) {
+  if (fwrite(data.data(), 1, data.size(), log_file_) != data.size()) {
+    return Status::IOError("Failed to append to the GCS store log.");
+  }
+  return SyncFile(log_file_);
+}
+
+Status FileStoreClient::ReplaceLogFile(const std::string &snapshot) {
+  const std::string tmp_path = log_path_ + ".tmp";
+  FILE *tmp_file = fopen(tmp_path.c_str(), "wb");
+  if (tmp_file == nullptr) {
+    return Status::IOError("Failed to create the GCS store snapshot.");
+  }
+  bool written = fwrite(snapshot.data(), 1, snapshot.size(), tmp_file) == snapshot.size();
+  auto status = written ? SyncFile(tmp_file)
+                        : Status::IOError("Failed to write the GCS store snapshot.");
+  fclose(tmp_file);
+  if (!status.ok()) {
+    std::remove(tmp_path.c_str());
+    return status;
+  }
+
+  fclose(log_file_);
+#ifdef _WIN32
+  std::remove(log_path_.c_str());
+#endif
+  if (std::rename(tmp_path.c_str(), log_path_.c_str()) != 0) {
+    status = Status::IOError("Failed to replace the GCS store log with the snapshot.");
+  }
+  log_file_ = fopen(log_path_.c_str(), "ab");
+  RAY_CHECK(log_file_ != nullptr) << "Failed to open the GCS store log " << log_path_;
+  RAY_LOG(INFO) << "Compacted the GCS store log " << log_path_ << " to "
+                << snapshot.size() << " bytes.";
+  return status;
+}
+
+}  // namespace gcs
+
+}  // namespace ray
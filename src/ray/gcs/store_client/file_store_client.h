@@ -0,0 +1,157 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdio>
+#include <thread>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+#include "ray/common/asio/instrumented_io_context.h"
+#include "ray/gcs/store_client/store_client.h"
+#include "src/ray/protobuf/gcs.pb.h"
+
+namespace ray {
+
+namespace gcs {
+
+/// \class FileStoreClient
+///
+/// FileStoreClient keeps all tables in memory and makes them durable through a local
+/// write-ahead log. Every mutation is applied in memory and appended to the log. A
+/// background thread writes and syncs the appended records in groups, and the write
+/// callbacks run only once their records are on disk. On construction the log is
+/// replayed. When it grows past `gcs_file_store_compaction_bytes`, it is rewritten as
+/// a snapshot of the current tables.
+///
+/// This class is thread safe.
+class FileStoreClient : public StoreClient {
+ public:
+  /// Create a FileStoreClient and recover the tables from the log at `log_path`.
+  ///
+  /// \param main_io_service The event loop to run callbacks on.
+  /// \param log_path Path of the write-ahead log file. It is created if missing.
+  FileStoreClient(instrumented_io_context &main_io_service, std::string log_path);
+
+  ~FileStoreClient();
+
+  Status AsyncPut(const std::string &table_name, const std::string &key,
+                  const std::string &data, const StatusCallback &callback) override;
+
+  Status AsyncPutWithIndex(const std::string &table_name, const std::string &key,
+                           const std::string &index_key, const std::string &data,
+                           const StatusCallback &callback) override;
+
+  Status AsyncGet(const std::string &table_name, const std::string &key,
+                  const OptionalItemCallback<std::string> &callback) override;
+
+  Status AsyncGetByIndex(const std::string &table_name, const std::string &index_key,
+                         const MapCallback<std::string, std::string> &callback) override;
+
+  Status AsyncGetAll(const std::string &table_name,
+                     const MapCallback<std::string, std::string> &callback) override;
+
+  Status AsyncDelete(const std::string &table_name, const std::string &key,
+                     const StatusCallback &callback) override;
+
+  Status AsyncDeleteWithIndex(const std::string &table_name, const std::string &key,
+                              const std::string &index_key,
+                              const StatusCallback &callback) override;
+
+  Status AsyncBatchDelete(const std::string &table_name,
+                          const std::vector<std::string> &keys,
+                          const StatusCallback &callback) override;
+
+  Status AsyncBatchDeleteWithIndex(const std::string &table_name,
+                                   const std::vector<std::string> &keys,
+                                   const std::vector<std::string> &index_keys,
+                                   const StatusCallback &callback) override;
+
+  Status AsyncDeleteByIndex(const std::string &table_name, const std::string &index_key,
+                            const StatusCallback &callback) override;
+
+  int GetNextJobID() override;
+
+ private:
+  struct Table {
+    // Mapping from key to data.
+    absl::flat_hash_map<std::string, std::string> records_;
+    // Mapping from index key to keys.
+    absl::flat_hash_map<std::string, absl::flat_hash_set<std::string>> index_keys_;
+  };
+
+  /// Apply a record to the in-memory tables.
+  void ApplyRecord(const rpc::StoreLogRecord &record) EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Apply a record in memory and queue it for the log. The callback is posted to the
+  /// main event loop after the record is synced.
+  ///
+  /// \return The sequence number of the record.
+  int64_t AppendRecord(const rpc::StoreLogRecord &record, const StatusCallback &callback);
+
+  int64_t AppendRecordLocked(const rpc::StoreLogRecord &record,
+                             const StatusCallback &callback)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Replay the log file into the in-memory tables, dropping a torn trailing record.
+  void Recover();
+
+  /// Serialize the current tables as a sequence of log records.
+  std::string SnapshotLocked() const EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Group commit loop run by `writer_thread_`.
+  void WriterLoop();
+
+  /// Append framed records to the log file and sync it.
+  Status AppendToLogFile(const std::string &data);
+
+  /// Replace the log file with a snapshot and reopen it for appending.
+  Status ReplaceLogFile(const std::string &snapshot);
+
+  /// Async API callbacks are posted to main_io_service_ to keep their order.
+  instrumented_io_context &main_io_service_;
+  const std::string log_path_;
+  /// The log file, opened for appending. Only used by `writer_thread_` after
+  /// construction.
+  FILE *log_file_ = nullptr;
+
+  /// Mutex to protect all the fields below.
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, Table> tables_ GUARDED_BY(mutex_);
+  int job_id_ GUARDED_BY(mutex_) = 0;
+  /// Framed records appended since the last group commit.
+  std::string pending_log_ GUARDED_BY(mutex_);
+  /// Callbacks of the records in `pending_log_`.
+  std::vector<StatusCallback> pending_callbacks_ GUARDED_BY(mutex_);
+  /// Size of the log file, including `pending_log_`.
+  int64_t log_bytes_ GUARDED_BY(mutex_) = 0;
+  /// Size of the last snapshot written by a compaction.
+  int64_t snapshot_bytes_ GUARDED_BY(mutex_) = 0;
+  /// Sequence number of the last record appended and of the last record synced.
+  int64_t appended_seq_ GUARDED_BY(mutex_) = 0;
+  int64_t synced_seq_ GUARDED_BY(mutex_) = 0;
+  bool stopped_ GUARDED_BY(mutex_) = false;
+  /// Signaled when records are appended or the client is stopped.
+  absl::CondVar pending_cv_;
+  /// Signaled when a group of records is synced.
+  absl::CondVar synced_cv_;
+
+  std::thread writer_thread_;
+};
+
+}  // namespace gcs
+
+}  // namespace ray
@@ -36,7 +36,7 @@ Status InMemoryStoreClient::AsyncPutWithIndex(const std::string &table_name,
   auto table = GetOrCreateTable(table_name);
   absl::MutexLock lock(&(table->mutex_));
   table->records_[key] = data;
-  table->index_keys_[index_key].emplace_back(key);
+  table->index_keys_[index_key].insert(key);
   main_io_service_.post([callback]() { callback(Status::OK()); },
                         "GcsInMemoryStore.PutWithIndex");
   return Status::OK();
@@ -94,12 +94,9 @@ Status InMemoryStoreClient::AsyncDeleteWithIndex(const std::string &table_name,
   // Remove index-key data.
   auto iter = table->index_keys_.find(index_key);
   if (iter != table->index_keys_.end()) {
-    auto it = std::find(iter->second.begin(), iter->second.end(), key);
-    if (it != iter->second.end()) {
-      iter->second.erase(it);
-      if (iter->second.size() == 0) {
-        table->index_keys_.erase(iter);
-      }
+    iter->second.erase(key);
+    if (iter->second.empty()) {
+      table->index_keys_.erase(iter);
     }
   }
 
@@ -142,12 +139,9 @@ Status InMemoryStoreClient::AsyncBatchDeleteWithIndex(
 
     auto iter = table->index_keys_.find(index_key);
     if (iter != table->index_keys_.end()) {
-      auto it = std::find(iter->second.begin(), iter->second.end(), key);
-      if (it != iter->second.end()) {
-        iter->second.erase(it);
-        if (iter->second.size() == 0) {
-          table->index_keys_.erase(iter);
-        }
+      iter->second.erase(key);
+      if (iter->second.empty()) {
+        table->index_keys_.erase(iter);
       }
     }
   }
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/synchronization/mutex.h"
 #include "ray/common/asio/instrumented_io_context.h"
 #include "ray/gcs/store_client/store_client.h"
@@ -76,7 +77,7 @@ class InMemoryStoreClient : public StoreClient {
     // Mapping from key to data.
     absl::flat_hash_map<std::string, std::string> records_ GUARDED_BY(mutex_);
     // Mapping from index key to keys.
-    absl::flat_hash_map<std::string, std::vector<std::string>> index_keys_
+    absl::flat_hash_map<std::string, absl::flat_hash_set<std::string>> index_keys_
         GUARDED_BY(mutex_);
   };
 
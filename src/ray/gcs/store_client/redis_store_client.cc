@@ -14,6 +14,7 @@
 
 #include "ray/gcs/store_client/redis_store_client.h"
 
+#include <algorithm>
 #include <functional>
 
 #include "ray/common/ray_config.h"
@@ -27,9 +28,17 @@ namespace gcs {
 std::string RedisStoreClient::table_separator_ = ":";
 std::string RedisStoreClient::index_table_separator_ = "&";
 
+RedisStoreClient::RedisStoreClient(std::shared_ptr<RedisClient> redis_client)
+    : redis_client_(std::move(redis_client)),
+      coalesce_writes_(RayConfig::instance().gcs_storage_coalesce_writes()),
+      use_index_sets_(RayConfig::instance().gcs_storage_use_index_sets()) {}
+
 Status RedisStoreClient::AsyncPut(const std::string &table_name, const std::string &key,
                                   const std::string &data,
                                   const StatusCallback &callback) {
+  if (coalesce_writes_) {
+    return CoalescedPut(GenRedisKey(table_name, key), data, callback);
+  }
   return DoPut(GenRedisKey(table_name, key), data, callback);
 }
 
@@ -38,6 +47,21 @@ Status RedisStoreClient::AsyncPutWithIndex(const std::string &table_name,
                                            const std::string &index_key,
                                            const std::string &data,
                                            const StatusCallback &callback) {
+  FlushPendingWrite(GenRedisKey(table_name, key));
+  if (use_index_sets_) {
+    // Write the data before adding the key to the index, so that a key found through
+    // the index always has its data.
+    auto status = DoPut(GenRedisKey(table_name, key), data, callback);
+    if (!status.ok()) {
+      if (callback != nullptr) {
+        callback(status);
+      }
+      return status;
+    }
+    const auto &index_set_key = GenRedisIndexSetKey(table_name, index_key);
+    return redis_client_->GetShardContext(index_set_key)
+        ->RunArgvAsync({"SADD", index_set_key, key}, nullptr);
+  }
   // NOTE: To ensure the atomicity of `AsyncPutWithIndex`, we can't write data to Redis in
   // the callback function of index writing.
   // Write index to Redis.
@@ -74,6 +98,7 @@ Status RedisStoreClient::AsyncGet(const std::string &table_name, const std::stri
   };
 
   std::string redis_key = GenRedisKey(table_name, key);
+  FlushPendingWrite(redis_key);
   std::vector<std::string> args = {"GET", redis_key};
 
   auto shard_context = redis_client_->GetShardContext(redis_key);
@@ -84,6 +109,7 @@ Status RedisStoreClient::AsyncGetAll(
     const std::string &table_name,
     const MapCallback<std::string, std::string> &callback) {
   RAY_CHECK(callback);
+  FlushAllPendingWrites();
   std::string match_pattern = GenRedisMatchPattern(table_name);
   auto scanner = std::make_shared<RedisScanner>(redis_client_, table_name);
   auto on_done = [callback,
@@ -104,6 +130,7 @@ Status RedisStoreClient::AsyncDelete(const std::string &table_name,
   }
 
   std::string redis_key = GenRedisKey(table_name, key);
+  FlushPendingWrite(redis_key);
   // We always replace `DEL` with `UNLINK`.
   std::vector<std::string> args = {"UNLINK", redis_key};
 
@@ -115,6 +142,9 @@ Status RedisStoreClient::AsyncDeleteWithIndex(const std::string &table_name,
                                               const std::string &key,
                                               const std::string &index_key,
                                               const StatusCallback &callback) {
+  if (use_index_sets_) {
+    return AsyncBatchDeleteWithIndex(table_name, {key}, {index_key}, callback);
+  }
   std::vector<std::string> redis_keys;
   redis_keys.reserve(2);
   redis_keys.push_back(GenRedisKey(table_name, key));
@@ -139,6 +169,27 @@ Status RedisStoreClient::AsyncBatchDeleteWithIndex(
     const std::vector<std::string> &index_keys, const StatusCallback &callback) {
   RAY_CHECK(keys.size() == index_keys.size());
 
+  if (use_index_sets_) {
+    // Remove the keys from their indexes before deleting the data, so that a key found
+    // through an index always has its data.
+    absl::flat_hash_map<std::string, std::vector<std::string>> srem_commands;
+    std::vector<std::string> redis_keys;
+    redis_keys.reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      auto &command = srem_commands[index_keys[i]];
+      if (command.empty()) {
+        command = {"SREM", GenRedisIndexSetKey(table_name, index_keys[i])};
+      }
+      command.push_back(keys[i]);
+      redis_keys.push_back(GenRedisKey(table_name, keys[i]));
+    }
+    for (const auto &entry : srem_commands) {
+      RAY_CHECK_OK(redis_client_->GetShardContext(entry.second[1])
+                       ->RunArgvAsync(entry.second, nullptr));
+    }
+    return DeleteByKeys(redis_keys, callback);
+  }
+
   std::vector<std::string> redis_keys;
   redis_keys.reserve(2 * keys.size());
   for (size_t i = 0; i < keys.size(); ++i) {
@@ -153,6 +204,22 @@ Status RedisStoreClient::AsyncGetByIndex(
     const std::string &table_name, const std::string &index_key,
     const MapCallback<std::string, std::string> &callback) {
   RAY_CHECK(callback);
+  FlushAllPendingWrites();
+  if (use_index_sets_) {
+    auto on_members = [this, callback, table_name](const std::vector<std::string> &keys) {
+      if (keys.empty()) {
+        callback(std::unordered_map<std::string, std::string>());
+        return;
+      }
+      std::vector<std::string> redis_keys;
+      redis_keys.reserve(keys.size());
+      for (auto &key : keys) {
+        redis_keys.push_back(GenRedisKey(table_name, key));
+      }
+      RAY_CHECK_OK(MGetValues(redis_client_, table_name, redis_keys, callback));
+    };
+    return GetIndexSetMembers(table_name, index_key, on_members);
+  }
   std::string match_pattern = GenRedisMatchPattern(table_name, index_key);
   auto scanner = std::make_shared<RedisScanner>(redis_client_, table_name);
   auto on_done = [this, callback, scanner, table_name, index_key](
@@ -176,6 +243,23 @@ Status RedisStoreClient::AsyncGetByIndex(
 Status RedisStoreClient::AsyncDeleteByIndex(const std::string &table_name,
                                             const std::string &index_key,
                                             const StatusCallback &callback) {
+  FlushAllPendingWrites();
+  if (use_index_sets_) {
+    // Dropping a job's entries only touches the keys in its index set, instead of
+    // scanning the whole key space.
+    auto index_set_key = GenRedisIndexSetKey(table_name, index_key);
+    auto on_members = [this, callback, table_name,
+                       index_set_key](const std::vector<std::string> &keys) {
+      std::vector<std::string> redis_keys;
+      redis_keys.reserve(keys.size() + 1);
+      for (auto &key : keys) {
+        redis_keys.push_back(GenRedisKey(table_name, key));
+      }
+      redis_keys.push_back(index_set_key);
+      RAY_CHECK_OK(DeleteByKeys(redis_keys, callback));
+    };
+    return GetIndexSetMembers(table_name, index_key, on_members);
+  }
   std::string match_pattern = GenRedisMatchPattern(table_name, index_key);
   auto scanner = std::make_shared<RedisScanner>(redis_client_, table_name);
   auto on_done = [this, table_name, index_key, callback, scanner](
@@ -202,6 +286,21 @@ Status RedisStoreClient::AsyncDeleteByIndex(const std::string &table_name,
   return scanner->ScanKeys(match_pattern, on_done);
 }
 
+Status RedisStoreClient::GetIndexSetMembers(
+    const std::string &table_name, const std::string &index_key,
+    const std::function<void(const std::vector<std::string> &)> &callback) {
+  auto index_set_key = GenRedisIndexSetKey(table_name, index_key);
+  auto on_reply = [callback](const std::shared_ptr<CallbackReply> &reply) {
+    std::vector<std::string> keys;
+    if (!reply->IsNil()) {
+      keys = reply->ReadAsStringArray();
+    }
+    callback(keys);
+  };
+  return redis_client_->GetShardContext(index_set_key)
+      ->RunArgvAsync({"SMEMBERS", index_set_key}, on_reply);
+}
+
 Status RedisStoreClient::DoPut(const std::string &key, const std::string &data,
                                const StatusCallback &callback) {
   std::vector<std::string> args = {"SET", key, data};
@@ -217,8 +316,98 @@ Status RedisStoreClient::DoPut(const std::string &key, const std::string &data,
   return shard_context->RunArgvAsync(args, write_callback);
 }
 
+Status RedisStoreClient::CoalescedPut(const std::string &key, const std::string &data,
+                                      const StatusCallback &callback) {
+  auto shard_context = redis_client_->GetShardContext(key);
+  absl::MutexLock lock(&mutex_);
+  auto &shard = pending_writes_[shard_context.get()];
+  if (shard.shard_context == nullptr) {
+    shard.shard_context = shard_context;
+  }
+  auto it = shard.writes.find(key);
+  if (it == shard.writes.end()) {
+    shard.keys.push_back(key);
+    it = shard.writes.emplace(key, PendingShardWrites::PendingWrite()).first;
+  }
+  // Only the latest value of a key is written. Earlier writes to the key are
+  // acknowledged when it is.
+  it->second.data = data;
+  if (callback) {
+    it->second.callbacks.push_back(callback);
+  }
+  if (shard.num_inflight_batches == 0) {
+    SendPendingWrites(shard);
+  }
+  return Status::OK();
+}
+
+void RedisStoreClient::SendPendingWrites(PendingShardWrites &shard) {
+  const size_t batch_size =
+      RayConfig::instance().maximum_gcs_storage_operation_batch_size();
+  size_t index = 0;
+  while (index < shard.keys.size()) {
+    std::vector<std::string> args = {"MSET"};
+    auto callbacks = std::make_shared<std::vector<StatusCallback>>();
+    size_t end = std::min(index + batch_size, shard.keys.size());
+    for (; index < end; index++) {
+      auto it = shard.writes.find(shard.keys[index]);
+      args.push_back(it->first);
+      args.push_back(std::move(it->second.data));
+      for (auto &callback : it->second.callbacks) {
+        callbacks->push_back(std::move(callback));
+      }
+    }
+    shard.num_inflight_batches++;
+    RedisContext *shard_context = shard.shard_context.get();
+    RAY_CHECK_OK(shard.shard_context->RunArgvAsync(
+        args,
+        [this, shard_context, callbacks](const std::shared_ptr<CallbackReply> &reply) {
+          auto status = reply->ReadAsStatus();
+          OnWriteBatchReplied(shard_context);
+          for (auto &callback : *callbacks) {
+            callback(status);
+          }
+        }));
+  }
+  shard.keys.clear();
+  shard.writes.clear();
+}
+
+void RedisStoreClient::OnWriteBatchReplied(RedisContext *shard_context) {
+  absl::MutexLock lock(&mutex_);
+  auto &shard = pending_writes_[shard_context];
+  RAY_CHECK(shard.num_inflight_batches > 0);
+  shard.num_inflight_batches--;
+  if (shard.num_inflight_batches == 0) {
+    SendPendingWrites(shard);
+  }
+}
+
+void RedisStoreClient::FlushPendingWrite(const std::string &key) {
+  if (!coalesce_writes_) {
+    return;
+  }
+  auto shard_context = redis_client_->GetShardContext(key);
+  absl::MutexLock lock(&mutex_);
+  auto it = pending_writes_.find(shard_context.get());
+  if (it != pending_writes_.end() && it->second.writes.contains(key)) {
+    SendPendingWrites(it->second);
+  }
+}
+
+void RedisStoreClient::FlushAllPendingWrites() {
+  if (!coalesce_writes_) {
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  for (auto &entry : pending_writes_) {
+    SendPendingWrites(entry.second);
+  }
+}
+
 Status RedisStoreClient::DeleteByKeys(const std::vector<std::string> &keys,
                                       const StatusCallback &callback) {
+  FlushAllPendingWrites();
   // Delete for each shard.
   // We always replace `DEL` with `UNLINK`.
   int total_count = 0;
@@ -289,6 +478,13 @@ std::string RedisStoreClient::GenRedisKey(const std::string &table_name,
   return ss.str();
 }
 
+std::string RedisStoreClient::GenRedisIndexSetKey(const std::string &table_name,
+                                                  const std::string &index_key) {
+  std::stringstream ss;
+  ss << table_name << index_table_separator_ << index_key;
+  return ss.str();
+}
+
 std::string RedisStoreClient::GenRedisMatchPattern(const std::string &table_name) {
   std::stringstream ss;
   ss << table_name << table_separator_ << "*";
@@ -362,15 +558,35 @@ RedisStoreClient::RedisScanner::RedisScanner(std::shared_ptr<RedisClient> redis_
 Status RedisStoreClient::RedisScanner::ScanKeysAndValues(
     std::string match_pattern,
     const ItemCallback<std::unordered_map<std::string, std::string>> &callback) {
-  auto on_done = [this, callback](const Status &status,
-                                  const std::vector<std::string> &result) {
-    if (result.empty()) {
-      callback(std::unordered_map<std::string, std::string>());
-    } else {
-      RAY_CHECK_OK(MGetValues(redis_client_, table_name_, result, callback));
+  // Values are fetched batch by batch while the scan goes on, so that restoring a large
+  // table doesn't wait for the whole key space to be scanned before the first `MGET`.
+  fetch_values_callback_ = [this, callback](
+                               const std::unordered_map<std::string, std::string> &result) {
+    bool finished = false;
+    {
+      absl::MutexLock lock(&mutex_);
+      key_value_map_.insert(result.begin(), result.end());
+      --pending_fetch_count_;
+      finished = scan_finished_ && pending_fetch_count_ == 0;
+    }
+    if (finished) {
+      callback(key_value_map_);
     }
   };
-  return ScanKeys(match_pattern, on_done);
+  auto on_done = [this, callback](const Status &status) {
+    bool finished = false;
+    {
+      absl::MutexLock lock(&mutex_);
+      scan_finished_ = true;
+      finished = pending_fetch_count_ == 0;
+      fetch_values_callback_ = nullptr;
+    }
+    if (finished) {
+      callback(key_value_map_);
+    }
+  };
+  Scan(match_pattern, on_done);
+  return Status::OK();
 }
 
 Status RedisStoreClient::RedisScanner::ScanKeys(
@@ -437,7 +653,22 @@ void RedisStoreClient::RedisScanner::OnScanCallback(
       shard_it->second = cursor;
     }
 
-    keys_.insert(scan_result.begin(), scan_result.end());
+    if (fetch_values_callback_) {
+      std::vector<std::string> new_keys;
+      for (auto &key : scan_result) {
+        // SCAN may return a key more than once.
+        if (keys_.insert(key).second) {
+          new_keys.emplace_back(std::move(key));
+        }
+      }
+      if (!new_keys.empty()) {
+        ++pending_fetch_count_;
+        RAY_CHECK_OK(
+            MGetValues(redis_client_, table_name_, new_keys, fetch_values_callback_));
+      }
+    } else {
+      keys_.insert(scan_result.begin(), scan_result.end());
+    }
   }
 
   // If pending_request_count_ is equal to 0, it means that the scan of this batch is
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "ray/gcs/redis_client.h"
 #include "ray/gcs/redis_context.h"
@@ -26,8 +27,7 @@ namespace gcs {
 
 class RedisStoreClient : public StoreClient {
  public:
-  explicit RedisStoreClient(std::shared_ptr<RedisClient> redis_client)
-      : redis_client_(std::move(redis_client)) {}
+  explicit RedisStoreClient(std::shared_ptr<RedisClient> redis_client);
 
   Status AsyncPut(const std::string &table_name, const std::string &key,
                   const std::string &data, const StatusCallback &callback) override;
@@ -99,6 +99,19 @@ class RedisStoreClient : public StoreClient {
     /// All keys that scanned from redis.
     absl::flat_hash_set<std::string> keys_;
 
+    /// Values fetched for the scanned keys, used by `ScanKeysAndValues`.
+    std::unordered_map<std::string, std::string> key_value_map_;
+
+    /// Invoked with the values of each batch of newly scanned keys, while
+    /// `ScanKeysAndValues` is in progress.
+    ItemCallback<std::unordered_map<std::string, std::string>> fetch_values_callback_;
+
+    /// Number of value fetches that haven't been replied yet.
+    size_t pending_fetch_count_ = 0;
+
+    /// Whether all shards have been scanned.
+    bool scan_finished_ = false;
+
     /// The scan cursor for each shard.
     std::unordered_map<size_t, size_t> shard_to_cursor_;
 
@@ -111,9 +124,49 @@ class RedisStoreClient : public StoreClient {
   Status DoPut(const std::string &key, const std::string &data,
                const StatusCallback &callback);
 
+  /// Writes that are buffered for one Redis shard when writes are coalesced.
+  struct PendingShardWrites {
+    /// The latest buffered value of a key and the callbacks of every write to it.
+    struct PendingWrite {
+      std::string data;
+      std::vector<StatusCallback> callbacks;
+    };
+
+    std::shared_ptr<RedisContext> shard_context;
+    /// Keys in the order of their first buffered write.
+    std::vector<std::string> keys;
+    absl::flat_hash_map<std::string, PendingWrite> writes;
+    /// Number of write batches sent to this shard that haven't been replied yet.
+    int64_t num_inflight_batches = 0;
+  };
+
+  /// Buffer a write. The write is sent right away if no write batch is in flight to
+  /// the key's shard, otherwise it is coalesced with the other writes buffered for
+  /// the shard and sent as one `MSET` when the in-flight batches are replied.
+  Status CoalescedPut(const std::string &key, const std::string &data,
+                      const StatusCallback &callback);
+
+  /// Send all writes buffered for a shard as `MSET` batches.
+  void SendPendingWrites(PendingShardWrites &shard) EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Called when a write batch sent to a shard is replied.
+  void OnWriteBatchReplied(RedisContext *shard_context);
+
+  /// Send the buffered write of a key, if any, so that a following command on the
+  /// key is ordered after it.
+  void FlushPendingWrite(const std::string &key);
+
+  /// Send the buffered writes of all shards.
+  void FlushAllPendingWrites();
+
   Status DeleteByKeys(const std::vector<std::string> &keys,
                       const StatusCallback &callback);
 
+  /// Read the keys of an index set.
+  Status GetIndexSetMembers(
+      const std::string &table_name, const std::string &index_key,
+      const std::function<void(const std::vector<std::string> &)> &callback);
+
   /// The return value is a map, whose key is the shard and the value is a list of batch
   /// operations.
   static std::unordered_map<RedisContext *, std::list<std::vector<std::string>>>
@@ -130,6 +183,11 @@ class RedisStoreClient : public StoreClient {
   static std::string GenRedisKey(const std::string &table_name, const std::string &key,
                                  const std::string &index_key);
 
+  /// The key of the Redis set that holds the keys of `table_name` indexed by
+  /// `index_key`, used when `gcs_storage_use_index_sets` is enabled.
+  static std::string GenRedisIndexSetKey(const std::string &table_name,
+                                         const std::string &index_key);
+
   static std::string GenRedisMatchPattern(const std::string &table_name);
 
   static std::string GenRedisMatchPattern(const std::string &table_name,
@@ -147,6 +205,19 @@ class RedisStoreClient : public StoreClient {
                            const MapCallback<std::string, std::string> &callback);
 
   std::shared_ptr<RedisClient> redis_client_;
+
+  /// Whether consecutive writes are coalesced, see `gcs_storage_coalesce_writes`.
+  const bool coalesce_writes_;
+
+  /// Whether indexes are kept as Redis sets, see `gcs_storage_use_index_sets`.
+  const bool use_index_sets_;
+
+  /// Mutex to protect the pending_writes_ field.
+  absl::Mutex mutex_;
+
+  /// Buffered writes, keyed by shard.
+  absl::flat_hash_map<RedisContext *, PendingShardWrites> pending_writes_
+      GUARDED_BY(mutex_);
 };
 
 }  // namespace gcs
@@ -0,0 +1,100 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/store_client/file_store_client.h"
+
+#include <cstdio>
+#include <future>
+
+#include "ray/gcs/store_client/test/store_client_test_base.h"
+
+namespace ray {
+
+namespace gcs {
+
+class FileStoreClientTest : public StoreClientTestBase {
+ public:
+  void InitStoreClient() override {
+    log_path_ = ::testing::TempDir() + "gcs_file_store_" + UniqueID::FromRandom().Hex();
+    store_client_ =
+        std::make_shared<FileStoreClient>(*(io_service_pool_->Get()), log_path_);
+  }
+
+  void DisconnectStoreClient() override {
+    store_client_.reset();
+    std::remove(log_path_.c_str());
+  }
+
+ protected:
+  std::string log_path_;
+};
+
+TEST_F(FileStoreClientTest, AsyncPutAndAsyncGetTest) { TestAsyncPutAndAsyncGet(); }
+
+TEST_F(FileStoreClientTest, AsyncPutAndDeleteWithIndexTest) {
+  TestAsyncPutAndDeleteWithIndex();
+}
+
+TEST_F(FileStoreClientTest, AsyncGetAllAndBatchDeleteTest) {
+  TestAsyncGetAllAndBatchDelete();
+}
+
+TEST_F(FileStoreClientTest, TestAsyncDeleteWithIndex) { TestAsyncDeleteWithIndex(); }
+
+TEST_F(FileStoreClientTest, TestAsyncBatchDeleteWithIndex) {
+  TestAsyncBatchDeleteWithIndex();
+}
+
+TEST_F(FileStoreClientTest, TestRecoverFromLog) {
+  const std::string table_name = "recover_table";
+  std::promise<bool> put_done;
+  RAY_CHECK_OK(store_client_->AsyncPut(table_name, "key1", "value1", nullptr));
+  RAY_CHECK_OK(store_client_->AsyncPutWithIndex(
+      table_name, "key2", "index", "value2",
+      [&put_done](const Status &status) { put_done.set_value(status.ok()); }));
+  ASSERT_TRUE(put_done.get_future().get());
+  ASSERT_EQ(store_client_->GetNextJobID(), 1);
+  ASSERT_EQ(store_client_->GetNextJobID(), 2);
+
+  // Reopen the log and check that the tables, index and job counter are recovered.
+  store_client_.reset();
+  store_client_ = std::make_shared<FileStoreClient>(*(io_service_pool_->Get()), log_path_);
+  std::promise<std::unordered_map<std::string, std::string>> get_all;
+  RAY_CHECK_OK(store_client_->AsyncGetAll(
+      table_name, [&get_all](const std::unordered_map<std::string, std::string> &result) {
+        get_all.set_value(result);
+      }));
+  auto records = get_all.get_future().get();
+  ASSERT_EQ(records.size(), 2);
+  ASSERT_EQ(records["key1"], "value1");
+  std::promise<std::unordered_map<std::string, std::string>> get_by_index;
+  RAY_CHECK_OK(store_client_->AsyncGetByIndex(
+      table_name, "index",
+      [&get_by_index](const std::unordered_map<std::string, std::string> &result) {
+        get_by_index.set_value(result);
+      }));
+  auto indexed = get_by_index.get_future().get();
+  ASSERT_EQ(indexed.size(), 1);
+  ASSERT_EQ(indexed["key2"], "value2");
+  ASSERT_EQ(store_client_->GetNextJobID(), 3);
+}
+
+}  // namespace gcs
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
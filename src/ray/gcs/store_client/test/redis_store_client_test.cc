@@ -14,6 +14,8 @@
 
 #include "ray/gcs/store_client/redis_store_client.h"
 
+#include <future>
+
 #include "ray/common/test_util.h"
 #include "ray/gcs/redis_client.h"
 #include "ray/gcs/store_client/test/store_client_test_base.h"
@@ -63,6 +65,61 @@ TEST_F(RedisStoreClientTest, TestAsyncBatchDeleteWithIndex) {
   TestAsyncBatchDeleteWithIndex();
 }
 
+TEST_F(RedisStoreClientTest, TestIndexSets) {
+  RayConfig::instance().initialize(R"({"gcs_storage_use_index_sets": true})");
+  store_client_ = std::make_shared<RedisStoreClient>(redis_client_);
+  RayConfig::instance().initialize(R"({"gcs_storage_use_index_sets": false})");
+
+  TestAsyncPutAndDeleteWithIndex();
+  TestAsyncDeleteWithIndex();
+  TestAsyncBatchDeleteWithIndex();
+}
+
+TEST_F(RedisStoreClientTest, TestConnectionPool) {
+  redis_client_->Disconnect();
+  RayConfig::instance().initialize(
+      R"({"gcs_redis_connections_per_shard": 4, "gcs_redis_consistent_hash_sharding": true})");
+  InitStoreClient();
+  RayConfig::instance().initialize(
+      R"({"gcs_redis_connections_per_shard": 1, "gcs_redis_consistent_hash_sharding": false})");
+  ASSERT_EQ(redis_client_->GetShardContexts().size(), 1);
+  // Commands on one key always use the same connection.
+  ASSERT_EQ(redis_client_->GetShardContext("key"), redis_client_->GetShardContext("key"));
+
+  TestAsyncPutAndAsyncGet();
+  TestAsyncPutAndDeleteWithIndex();
+  TestAsyncGetAllAndBatchDelete();
+}
+
+TEST_F(RedisStoreClientTest, TestCoalescedPut) {
+  RayConfig::instance().initialize(R"({"gcs_storage_coalesce_writes": true})");
+  auto store_client = std::make_shared<RedisStoreClient>(redis_client_);
+  RayConfig::instance().initialize(R"({"gcs_storage_coalesce_writes": false})");
+
+  const std::string table_name = "coalesced_table";
+  const std::string key = "key";
+  const int num_puts = 100;
+  std::atomic<int> num_put_callbacks(0);
+  for (int i = 0; i < num_puts; i++) {
+    RAY_CHECK_OK(store_client->AsyncPut(table_name, key, std::to_string(i),
+                                        [&num_put_callbacks](const Status &status) {
+                                          RAY_CHECK_OK(status);
+                                          ++num_put_callbacks;
+                                        }));
+  }
+
+  // A read is ordered after the buffered writes and sees the latest value.
+  std::promise<std::string> promise;
+  RAY_CHECK_OK(store_client->AsyncGet(
+      table_name, key,
+      [&promise](const Status &status, const boost::optional<std::string> &result) {
+        RAY_CHECK_OK(status);
+        promise.set_value(result ? *result : "");
+      }));
+  ASSERT_EQ(promise.get_future().get(), std::to_string(num_puts - 1));
+  ASSERT_EQ(num_put_callbacks, num_puts);
+}
+
 }  // namespace gcs
 
 }  // namespace ray
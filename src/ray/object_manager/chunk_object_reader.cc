@@ -28,7 +28,8 @@ uint64_t ChunkObjectReader::GetNumChunks() const {
          chunk_size_;
 }
 
-absl::optional<std::string> ChunkObjectReader::GetChunk(uint64_t chunk_index) const {
+ChunkObjectReader::ChunkSections ChunkObjectReader::GetChunkSections(
+    uint64_t chunk_index) const {
   // The spilled file stores metadata before data. But the GetChunk needs to
   // return data before metadata. We achieve by first read from data section,
   // then read from metadata section.
@@ -37,29 +38,57 @@ absl::optional<std::string> ChunkObjectReader::GetChunk(uint64_t chunk_index) co
       std::min(chunk_size_,
                object_->GetDataSize() + object_->GetMetadataSize() - cur_chunk_offset);
 
-  std::string result(cur_chunk_size, '\0');
-  size_t result_offset = 0;
-
+  ChunkSections sections;
   if (cur_chunk_offset < object_->GetDataSize()) {
-    // read from data section.
-    auto offset = cur_chunk_offset;
-    auto size = std::min(object_->GetDataSize() - cur_chunk_offset, cur_chunk_size);
-    if (!object_->ReadFromDataSection(offset, size, &result[result_offset])) {
-      return absl::optional<std::string>();
-    }
-    result_offset = size;
+    sections.data_offset = cur_chunk_offset;
+    sections.data_size =
+        std::min(object_->GetDataSize() - cur_chunk_offset, cur_chunk_size);
   }
 
   if (cur_chunk_offset + cur_chunk_size > object_->GetDataSize()) {
-    // read from metadata section.
-    auto offset =
+    sections.metadata_offset =
         std::max(cur_chunk_offset, object_->GetDataSize()) - object_->GetDataSize();
-    auto size = std::min(cur_chunk_offset + cur_chunk_size - object_->GetDataSize(),
-                         cur_chunk_size);
-    if (!object_->ReadFromMetadataSection(offset, size, &result[result_offset])) {
-      return absl::optional<std::string>();
-    }
+    sections.metadata_size =
+        std::min(cur_chunk_offset + cur_chunk_size - object_->GetDataSize(),
+                 cur_chunk_size);
+  }
+  return sections;
+}
+
+absl::optional<std::string> ChunkObjectReader::GetChunk(uint64_t chunk_index) const {
+  const auto sections = GetChunkSections(chunk_index);
+  std::string result(sections.data_size + sections.metadata_size, '\0');
+
+  if (sections.data_size > 0 &&
+      !object_->ReadFromDataSection(sections.data_offset, sections.data_size,
+                                    &result[0])) {
+    return absl::optional<std::string>();
+  }
+
+  if (sections.metadata_size > 0 &&
+      !object_->ReadFromMetadataSection(sections.metadata_offset, sections.metadata_size,
+                                        &result[sections.data_size])) {
+    return absl::optional<std::string>();
   }
   return absl::optional<std::string>(std::move(result));
 }
+
+bool ChunkObjectReader::GetChunkRanges(
+    uint64_t chunk_index, std::vector<absl::Span<const uint8_t>> *ranges) const {
+  const auto sections = GetChunkSections(chunk_index);
+  const uint8_t *data = object_->GetDataPointer();
+  const uint8_t *metadata = object_->GetMetadataPointer();
+  if ((sections.data_size > 0 && data == nullptr) ||
+      (sections.metadata_size > 0 && metadata == nullptr)) {
+    return false;
+  }
+  ranges->clear();
+  if (sections.data_size > 0) {
+    ranges->emplace_back(data + sections.data_offset, sections.data_size);
+  }
+  if (sections.metadata_size > 0) {
+    ranges->emplace_back(metadata + sections.metadata_offset, sections.metadata_size);
+  }
+  return true;
+}
 };  // namespace ray
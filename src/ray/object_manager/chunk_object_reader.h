@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <vector>
+
+#include "absl/types/span.h"
 #include "ray/object_manager/spilled_object_reader.h"
 
 namespace ray {
@@ -29,6 +32,8 @@ class ChunkObjectReader {
 
   uint64_t GetNumChunks() const;
 
+  uint64_t GetChunkSize() const { return chunk_size_; }
+
   /// Return the value in a given chunk, identified by chunk_index.
   /// It migh return an empty optional if the file is deleted.
   ///
@@ -36,9 +41,28 @@ class ChunkObjectReader {
   ///                    equal to GetNumChunks() yields undefined behavior.
   absl::optional<std::string> GetChunk(uint64_t chunk_index) const;
 
+  /// Return the memory of a given chunk without copying it, if the object is in
+  /// memory. The memory stays valid as long as this reader is alive.
+  ///
+  /// \param chunk_index the index of chunk to return.
+  /// \param[out] ranges the memory of the chunk, in order.
+  /// \return false if the object is not in memory, use GetChunk then.
+  bool GetChunkRanges(uint64_t chunk_index,
+                      std::vector<absl::Span<const uint8_t>> *ranges) const;
+
   const IObjectReader &GetObject() const { return *object_; }
 
  private:
+  /// The part of a chunk in the data section and the part in the metadata section.
+  struct ChunkSections {
+    uint64_t data_offset = 0;
+    uint64_t data_size = 0;
+    uint64_t metadata_offset = 0;
+    uint64_t metadata_size = 0;
+  };
+
+  ChunkSections GetChunkSections(uint64_t chunk_index) const;
+
   const std::shared_ptr<IObjectReader> object_;
   const uint64_t chunk_size_;
 };
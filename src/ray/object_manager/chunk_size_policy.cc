@@ -0,0 +1,116 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/chunk_size_policy.h"
+
+#include <cmath>
+
+namespace ray {
+
+namespace {
+/// The weight of older samples is multiplied by this on every new sample.
+const double kDecay = 0.95;
+/// The number of samples needed before the chunk size is adapted.
+const int64_t kMinSamples = 8;
+/// The number of chunks in flight to a node that should cover its
+/// bandwidth-delay product.
+const uint64_t kChunksPerBandwidthDelayProduct = 4;
+/// Adaptive chunk sizes are rounded to a multiple of this.
+const uint64_t kChunkSizeGranularity = 1024 * 1024;
+}  // namespace
+
+void ChunkSizePolicy::RecordChunkSent(const NodeID &node_id, uint64_t num_bytes,
+                                      double seconds) {
+  if (seconds <= 0) {
+    return;
+  }
+  absl::MutexLock lock(&mu_);
+  auto &stats = links_[node_id];
+  const double x = static_cast<double>(num_bytes);
+  stats.weight = stats.weight * kDecay + 1;
+  stats.bytes = stats.bytes * kDecay + x;
+  stats.seconds = stats.seconds * kDecay + seconds;
+  stats.bytes_squared = stats.bytes_squared * kDecay + x * x;
+  stats.bytes_seconds = stats.bytes_seconds * kDecay + x * seconds;
+  stats.num_samples++;
+}
+
+uint64_t ChunkSizePolicy::GetBandwidthDelayProduct(const NodeID &node_id) const {
+  absl::MutexLock lock(&mu_);
+  auto it = links_.find(node_id);
+  if (it == links_.end() || it->second.num_samples < kMinSamples) {
+    return 0;
+  }
+  const auto &stats = it->second;
+  const double mean_bytes = stats.bytes / stats.weight;
+  const double mean_seconds = stats.seconds / stats.weight;
+  const double variance = stats.bytes_squared / stats.weight - mean_bytes * mean_bytes;
+  const double covariance =
+      stats.bytes_seconds / stats.weight - mean_bytes * mean_seconds;
+  // The chunks must differ in size for the regression to tell the delay from the
+  // transfer time, e.g. because the last chunks of objects are smaller.
+  if (variance <= 1 || covariance <= 0) {
+    return 0;
+  }
+  const double seconds_per_byte = covariance / variance;
+  const double rtt = mean_seconds - seconds_per_byte * mean_bytes;
+  if (rtt <= 0) {
+    return 0;
+  }
+  return static_cast<uint64_t>(rtt / seconds_per_byte);
+}
+
+double ChunkSizePolicy::GetBandwidth(const NodeID &node_id) const {
+  absl::MutexLock lock(&mu_);
+  auto it = links_.find(node_id);
+  if (it == links_.end() || it->second.num_samples < kMinSamples) {
+    return 0;
+  }
+  const auto &stats = it->second;
+  const double mean_bytes = stats.bytes / stats.weight;
+  const double mean_seconds = stats.seconds / stats.weight;
+  const double variance = stats.bytes_squared / stats.weight - mean_bytes * mean_bytes;
+  const double covariance =
+      stats.bytes_seconds / stats.weight - mean_bytes * mean_seconds;
+  if (variance > 1 && covariance > 0) {
+    return variance / covariance;
+  }
+  // Without the regression, the delay counts as transfer time, which underestimates
+  // the bandwidth.
+  return mean_seconds > 0 ? mean_bytes / mean_seconds : 0;
+}
+
+uint64_t ChunkSizePolicy::GetChunkSize(const NodeID &node_id,
+                                       uint64_t object_size) const {
+  uint64_t chunk_size = default_chunk_size_;
+  if (max_chunk_size_ > default_chunk_size_) {
+    // Round to whole MiB, so that noise in the measurements doesn't change the chunk
+    // size of every push.
+    const uint64_t adaptive_chunk_size =
+        (GetBandwidthDelayProduct(node_id) / kChunksPerBandwidthDelayProduct +
+         kChunkSizeGranularity / 2) /
+        kChunkSizeGranularity * kChunkSizeGranularity;
+    chunk_size =
+        std::min(max_chunk_size_, std::max(default_chunk_size_, adaptive_chunk_size));
+  }
+  // Objects that are slightly larger than a chunk are sent in one, rather than
+  // paying for a whole extra message for the tail.
+  if (object_size > chunk_size && object_size <= chunk_size + chunk_size / 4 &&
+      object_size <= max_chunk_size_) {
+    chunk_size = object_size;
+  }
+  return chunk_size;
+}
+
+}  // namespace ray
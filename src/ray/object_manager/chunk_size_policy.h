@@ -0,0 +1,84 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "ray/common/id.h"
+
+namespace ray {
+
+/// Picks the chunk size of object pushes to each node from the measured latency
+/// and bandwidth of past chunks. Links with a large bandwidth-delay product get
+/// larger chunks, so that few chunks in flight keep them busy.
+///
+/// The latency of a chunk is modeled as rtt + bytes / bandwidth, which is fitted
+/// by a linear regression over exponentially decaying samples.
+///
+/// This class is thread-safe.
+class ChunkSizePolicy {
+ public:
+  /// Create a chunk size policy.
+  ///
+  /// \param default_chunk_size The chunk size used without measurements, and the
+  /// minimum chunk size.
+  /// \param max_chunk_size The maximum chunk size. Adaptive sizing is disabled if
+  /// this is not larger than the default chunk size.
+  ChunkSizePolicy(uint64_t default_chunk_size, uint64_t max_chunk_size)
+      : default_chunk_size_(default_chunk_size),
+        max_chunk_size_(std::max(default_chunk_size, max_chunk_size)) {}
+
+  /// Record a chunk that was pushed to a node.
+  ///
+  /// \param node_id The node the chunk was pushed to.
+  /// \param num_bytes The size of the chunk.
+  /// \param seconds The time from sending the chunk to receiving the reply.
+  void RecordChunkSent(const NodeID &node_id, uint64_t num_bytes, double seconds);
+
+  /// Return the chunk size to push an object to a node with.
+  ///
+  /// \param node_id The node to push to.
+  /// \param object_size The sum of the object size and metadata size.
+  uint64_t GetChunkSize(const NodeID &node_id, uint64_t object_size) const;
+
+  /// Return the estimated bandwidth-delay product of the link to a node in bytes,
+  /// or 0 if there aren't enough measurements.
+  uint64_t GetBandwidthDelayProduct(const NodeID &node_id) const;
+
+  /// Return the estimated bandwidth of the link to a node in bytes per second, or 0
+  /// if there aren't enough measurements.
+  double GetBandwidth(const NodeID &node_id) const;
+
+ private:
+  /// Exponentially decaying sums for the regression of latency over bytes.
+  struct LinkStats {
+    double weight = 0;
+    double bytes = 0;
+    double seconds = 0;
+    double bytes_squared = 0;
+    double bytes_seconds = 0;
+    int64_t num_samples = 0;
+  };
+
+  const uint64_t default_chunk_size_;
+  const uint64_t max_chunk_size_;
+
+  mutable absl::Mutex mu_;
+  absl::flat_hash_map<NodeID, LinkStats> links_ GUARDED_BY(mu_);
+};
+
+}  // namespace ray
@@ -19,13 +19,20 @@ namespace ray {
 
 MemoryObjectReader::MemoryObjectReader(plasma::ObjectBuffer object_buffer,
                                        rpc::Address owner_address)
-    : object_buffer_(std::move(object_buffer)),
+    : MemoryObjectReader(std::move(object_buffer.data),
+                         std::move(object_buffer.metadata), std::move(owner_address)) {}
+
+MemoryObjectReader::MemoryObjectReader(std::shared_ptr<Buffer> data,
+                                       std::shared_ptr<Buffer> metadata,
+                                       rpc::Address owner_address)
+    : data_(std::move(data)),
+      metadata_(std::move(metadata)),
       owner_address_(std::move(owner_address)) {}
 
-uint64_t MemoryObjectReader::GetDataSize() const { return object_buffer_.data->Size(); }
+uint64_t MemoryObjectReader::GetDataSize() const { return data_->Size(); }
 
 uint64_t MemoryObjectReader::GetMetadataSize() const {
-  return object_buffer_.metadata->Size();
+  return metadata_->Size();
 }
 
 const rpc::Address &MemoryObjectReader::GetOwnerAddress() const { return owner_address_; }
@@ -35,7 +42,7 @@ bool MemoryObjectReader::ReadFromDataSection(uint64_t offset, uint64_t size,
   if (offset + size > GetDataSize()) {
     return false;
   }
-  std::memcpy(output, object_buffer_.data->Data() + offset, size);
+  std::memcpy(output, data_->Data() + offset, size);
   return true;
 }
 
@@ -44,8 +51,16 @@ bool MemoryObjectReader::ReadFromMetadataSection(uint64_t offset, uint64_t size,
   if (offset + size > GetMetadataSize()) {
     return false;
   }
-  std::memcpy(output, object_buffer_.metadata->Data() + offset, size);
+  std::memcpy(output, metadata_->Data() + offset, size);
   return true;
 }
 
+const uint8_t *MemoryObjectReader::GetDataPointer() const {
+  return data_->Data();
+}
+
+const uint8_t *MemoryObjectReader::GetMetadataPointer() const {
+  return metadata_->Data();
+}
+
 }  // namespace ray
@@ -25,6 +25,15 @@ class MemoryObjectReader : public IObjectReader {
  public:
   MemoryObjectReader(plasma::ObjectBuffer object_buffer, rpc::Address owner_address);
 
+  /// Create a reader over an object that is held outside of plasma.
+  ///
+  /// \param data The data of the object.
+  /// \param metadata The metadata of the object, which must not be null but can be
+  /// empty.
+  /// \param owner_address The address of the owner of the object.
+  MemoryObjectReader(std::shared_ptr<Buffer> data, std::shared_ptr<Buffer> metadata,
+                     rpc::Address owner_address);
+
   uint64_t GetDataSize() const override;
 
   uint64_t GetMetadataSize() const override;
@@ -35,8 +44,13 @@ class MemoryObjectReader : public IObjectReader {
   bool ReadFromMetadataSection(uint64_t offset, uint64_t size,
                                char *output) const override;
 
+  const uint8_t *GetDataPointer() const override;
+
+  const uint8_t *GetMetadataPointer() const override;
+
  private:
-  const plasma::ObjectBuffer object_buffer_;
+  const std::shared_ptr<Buffer> data_;
+  const std::shared_ptr<Buffer> metadata_;
   const rpc::Address owner_address_;
 };
 
@@ -15,7 +15,9 @@
 #include "ray/object_manager/object_buffer_pool.h"
 
 #include "ray/common/status.h"
+#include "ray/stats/stats.h"
 #include "ray/util/logging.h"
+#include "ray/util/util.h"
 
 namespace ray {
 
@@ -36,14 +38,26 @@ ObjectBufferPool::~ObjectBufferPool() {
   RAY_CHECK_OK(store_client_.Disconnect());
 }
 
-uint64_t ObjectBufferPool::GetNumChunks(uint64_t data_size) {
-  return (data_size + default_chunk_size_ - 1) / default_chunk_size_;
+uint64_t ObjectBufferPool::GetNumChunks(uint64_t data_size, uint64_t chunk_size) {
+  if (chunk_size == 0) {
+    chunk_size = default_chunk_size_;
+  }
+  return (data_size + chunk_size - 1) / chunk_size;
 }
 
-uint64_t ObjectBufferPool::GetBufferLength(uint64_t chunk_index, uint64_t data_size) {
-  return (chunk_index + 1) * default_chunk_size_ > data_size
-             ? data_size % default_chunk_size_
-             : default_chunk_size_;
+uint64_t ObjectBufferPool::GetBufferLength(uint64_t chunk_index, uint64_t data_size,
+                                           uint64_t chunk_size) {
+  if (chunk_size == 0) {
+    chunk_size = default_chunk_size_;
+  }
+  return (chunk_index + 1) * chunk_size > data_size ? data_size % chunk_size
+                                                    : chunk_size;
+}
+
+uint64_t ObjectBufferPool::GetChunkSize(const ObjectID &object_id) {
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  auto it = create_buffer_state_.find(object_id);
+  return it == create_buffer_state_.end() ? 0 : it->second.chunk_size;
 }
 
 std::pair<std::shared_ptr<MemoryObjectReader>, ray::Status>
@@ -75,7 +89,10 @@ ObjectBufferPool::CreateObjectReader(const ObjectID &object_id,
 ray::Status ObjectBufferPool::CreateChunk(const ObjectID &object_id,
                                           const rpc::Address &owner_address,
                                           uint64_t data_size, uint64_t metadata_size,
-                                          uint64_t chunk_index) {
+                                          uint64_t chunk_index, uint64_t chunk_size) {
+  if (chunk_size == 0) {
+    chunk_size = default_chunk_size_;
+  }
   std::unique_lock<std::mutex> lock(pool_mutex_);
   if (create_buffer_state_.count(object_id) == 0) {
     int64_t object_size = data_size - metadata_size;
@@ -84,9 +101,13 @@ ray::Status ObjectBufferPool::CreateChunk(const ObjectID &object_id,
 
     // Release the buffer pool lock during the blocking create call.
     lock.unlock();
+    const int64_t create_start_ms = current_time_ms();
     Status s = store_client_.CreateAndSpillIfNeeded(
         object_id, owner_address, object_size, NULL, metadata_size, &data,
-        plasma::flatbuf::ObjectSource::ReceivedFromRemoteRaylet);
+        plasma::flatbuf::ObjectSource::ReceivedFromRemoteRaylet, /*device_num=*/0,
+        plasma::flatbuf::CreatePriority::Restore);
+    stats::ObjectManagerReceiveBufferCreateMs().Record(current_time_ms() -
+                                                       create_start_ms);
     lock.lock();
 
     // Another thread may have succeeded in creating the chunk while the lock
@@ -101,27 +122,46 @@ ray::Status ObjectBufferPool::CreateChunk(const ObjectID &object_id,
       }
       // Read object into store.
       uint8_t *mutable_data = data->Data();
-      uint64_t num_chunks = GetNumChunks(data_size);
+      uint64_t num_chunks = GetNumChunks(data_size, chunk_size);
       create_buffer_state_.emplace(
           std::piecewise_construct, std::forward_as_tuple(object_id),
-          std::forward_as_tuple(BuildChunks(object_id, mutable_data, data_size, data)));
+          std::forward_as_tuple(
+              BuildChunks(object_id, mutable_data, data_size, chunk_size, data),
+              owner_address, data_size, metadata_size, chunk_size));
       RAY_LOG(DEBUG) << "Created object " << object_id
                      << " in plasma store, number of chunks: " << num_chunks
                      << ", chunk index: " << chunk_index;
       RAY_CHECK(create_buffer_state_[object_id].chunk_info.size() == num_chunks);
     }
   }
-  if (create_buffer_state_[object_id].chunk_state[chunk_index] !=
-      CreateChunkState::AVAILABLE) {
+  auto &state = create_buffer_state_[object_id];
+  if (state.chunk_size != chunk_size || chunk_index >= state.chunk_state.size()) {
+    // Another node sent the object with a different chunk size first. The chunks
+    // of this sender are dropped, the object is pulled with the existing chunk
+    // size on the next retry.
+    return ray::Status::Invalid("Chunk size " + std::to_string(chunk_size) +
+                                " doesn't match the chunk size " +
+                                std::to_string(state.chunk_size) +
+                                " that the object is received with.");
+  }
+  if (state.chunk_state[chunk_index] != CreateChunkState::AVAILABLE) {
     // There can be only one reference to this chunk at any given time.
     return ray::Status::IOError("Chunk already received by a different thread.");
   }
-  create_buffer_state_[object_id].chunk_state[chunk_index] = CreateChunkState::REFERENCED;
+  state.chunk_state[chunk_index] = CreateChunkState::REFERENCED;
   return ray::Status::OK();
 }
 
 void ObjectBufferPool::WriteChunk(const ObjectID &object_id, const uint64_t chunk_index,
                                   const std::string &data) {
+  WriteChunk(object_id, chunk_index,
+             {absl::Span<const uint8_t>(reinterpret_cast<const uint8_t *>(data.data()),
+                                        data.size())});
+}
+
+void ObjectBufferPool::WriteChunk(const ObjectID &object_id, const uint64_t chunk_index,
+                                  const std::vector<absl::Span<const uint8_t>> &data) {
+  const int64_t write_start_ms = current_time_ms();
   std::lock_guard<std::mutex> lock(pool_mutex_);
   auto it = create_buffer_state_.find(object_id);
   if (it == create_buffer_state_.end() ||
@@ -132,10 +172,19 @@ void ObjectBufferPool::WriteChunk(const ObjectID &object_id, const uint64_t chun
   }
   RAY_CHECK(it->second.chunk_info.size() > chunk_index);
   auto &chunk_info = it->second.chunk_info.at(chunk_index);
-  RAY_CHECK(data.size() == chunk_info.buffer_length)
-      << "size mismatch!  data size: " << data.size()
+  uint64_t data_size = 0;
+  for (const auto &range : data) {
+    data_size += range.size();
+  }
+  RAY_CHECK(data_size == chunk_info.buffer_length)
+      << "size mismatch!  data size: " << data_size
       << " chunk size: " << chunk_info.buffer_length;
-  std::memcpy(chunk_info.data, data.data(), chunk_info.buffer_length);
+  uint8_t *destination = chunk_info.data;
+  for (const auto &range : data) {
+    std::memcpy(destination, range.data(), range.size());
+    destination += range.size();
+  }
+  stats::ObjectManagerChunkWriteMs().Record(current_time_ms() - write_start_ms);
   it->second.chunk_state.at(chunk_index) = CreateChunkState::SEALED;
   it->second.num_seals_remaining--;
   if (it->second.num_seals_remaining == 0) {
@@ -147,6 +196,62 @@ void ObjectBufferPool::WriteChunk(const ObjectID &object_id, const uint64_t chun
   }
 }
 
+std::vector<uint64_t> ObjectBufferPool::GetMissingChunks(const ObjectID &object_id,
+                                                         uint64_t data_size,
+                                                         uint64_t chunk_size) {
+  std::vector<uint64_t> missing_chunks;
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  auto it = create_buffer_state_.find(object_id);
+  if (it != create_buffer_state_.end()) {
+    chunk_size = it->second.chunk_size;
+  }
+  const uint64_t num_chunks = GetNumChunks(data_size, chunk_size);
+  for (uint64_t chunk_index = 0; chunk_index < num_chunks; chunk_index++) {
+    // Chunks that are being written count as received.
+    if (it == create_buffer_state_.end() ||
+        (chunk_index < it->second.chunk_state.size() &&
+         it->second.chunk_state[chunk_index] == CreateChunkState::AVAILABLE)) {
+      missing_chunks.push_back(chunk_index);
+    }
+  }
+  return missing_chunks;
+}
+
+bool ObjectBufferPool::GetReceivedChunks(const ObjectID &object_id, uint64_t *num_chunks,
+                                         std::vector<uint64_t> *chunk_indices) {
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  auto it = create_buffer_state_.find(object_id);
+  if (it == create_buffer_state_.end()) {
+    return false;
+  }
+  *num_chunks = it->second.chunk_state.size();
+  for (uint64_t chunk_index = 0; chunk_index < *num_chunks; chunk_index++) {
+    if (it->second.chunk_state[chunk_index] == CreateChunkState::SEALED) {
+      chunk_indices->push_back(chunk_index);
+    }
+  }
+  return true;
+}
+
+absl::optional<ObjectBufferPool::ReceivedChunk> ObjectBufferPool::GetReceivedChunk(
+    const ObjectID &object_id, uint64_t chunk_index) {
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  auto it = create_buffer_state_.find(object_id);
+  if (it == create_buffer_state_.end() || chunk_index >= it->second.chunk_state.size() ||
+      it->second.chunk_state[chunk_index] != CreateChunkState::SEALED) {
+    return absl::nullopt;
+  }
+  const auto &chunk_info = it->second.chunk_info[chunk_index];
+  ReceivedChunk chunk;
+  chunk.owner_address = it->second.owner_address;
+  chunk.data_size = it->second.data_size;
+  chunk.metadata_size = it->second.metadata_size;
+  chunk.chunk_size = it->second.chunk_size;
+  chunk.data.assign(reinterpret_cast<const char *>(chunk_info.data),
+                    chunk_info.buffer_length);
+  return chunk;
+}
+
 void ObjectBufferPool::AbortCreate(const ObjectID &object_id) {
   std::lock_guard<std::mutex> lock(pool_mutex_);
   auto it = create_buffer_state_.find(object_id);
@@ -160,20 +265,19 @@ void ObjectBufferPool::AbortCreate(const ObjectID &object_id) {
 }
 
 std::vector<ObjectBufferPool::ChunkInfo> ObjectBufferPool::BuildChunks(
-    const ObjectID &object_id, uint8_t *data, uint64_t data_size,
+    const ObjectID &object_id, uint8_t *data, uint64_t data_size, uint64_t chunk_size,
     std::shared_ptr<Buffer> buffer_ref) {
   uint64_t space_remaining = data_size;
   std::vector<ChunkInfo> chunks;
   int64_t position = 0;
   while (space_remaining) {
     position = data_size - space_remaining;
-    if (space_remaining < default_chunk_size_) {
+    if (space_remaining < chunk_size) {
       chunks.emplace_back(chunks.size(), data + position, space_remaining, buffer_ref);
       space_remaining = 0;
     } else {
-      chunks.emplace_back(chunks.size(), data + position, default_chunk_size_,
-                          buffer_ref);
-      space_remaining -= default_chunk_size_;
+      chunks.emplace_back(chunks.size(), data + position, chunk_size, buffer_ref);
+      space_remaining -= chunk_size;
     }
   }
   return chunks;
@@ -22,6 +22,8 @@
 #include <mutex>
 #include <vector>
 
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "ray/common/id.h"
 #include "ray/common/status.h"
 #include "ray/object_manager/memory_object_reader.h"
@@ -52,6 +54,21 @@ class ObjectBufferPool {
     std::shared_ptr<Buffer> buffer_ref;
   };
 
+  /// A copy of a chunk of an object that is being received, with what is needed
+  /// to push it on to another node.
+  struct ReceivedChunk {
+    /// The address of the object's owner.
+    rpc::Address owner_address;
+    /// The sum of the object size and metadata size.
+    uint64_t data_size;
+    /// The size of the metadata.
+    uint64_t metadata_size;
+    /// The chunk size that the object is split into.
+    uint64_t chunk_size;
+    /// The data of the chunk.
+    std::string data;
+  };
+
   /// Constructor.
   ///
   /// \param store_socket_name The socket name of the store to which plasma clients
@@ -67,15 +84,24 @@ class ObjectBufferPool {
   /// Computes the number of chunks needed to transfer an object and its metadata.
   ///
   /// \param data_size The size of the object + metadata.
+  /// \param chunk_size The chunk size, or 0 for the default chunk size.
   /// \return The number of chunks into which the object will be split.
-  uint64_t GetNumChunks(uint64_t data_size);
+  uint64_t GetNumChunks(uint64_t data_size, uint64_t chunk_size = 0);
 
   /// Computes the buffer length of a chunk of an object.
   ///
   /// \param chunk_index The chunk index for which to obtain the buffer length.
   /// \param data_size The size of the object + metadata.
+  /// \param chunk_size The chunk size, or 0 for the default chunk size.
   /// \return The buffer length of the chunk at chunk_index.
-  uint64_t GetBufferLength(uint64_t chunk_index, uint64_t data_size);
+  uint64_t GetBufferLength(uint64_t chunk_index, uint64_t data_size,
+                           uint64_t chunk_size = 0);
+
+  /// Returns the chunk size that an object is being received with.
+  ///
+  /// \param object_id The ObjectID.
+  /// \return The chunk size, or 0 if the object isn't being received.
+  uint64_t GetChunkSize(const ObjectID &object_id);
 
   /// Returns an object reader for read.
   ///
@@ -100,13 +126,16 @@ class ObjectBufferPool {
   /// \param data_size The sum of the object size and metadata size.
   /// \param metadata_size The size of the metadata.
   /// \param chunk_index The index of the chunk.
+  /// \param chunk_size The chunk size that the sender split the object into, or 0
+  /// for the default chunk size.
   /// \return status of invoking this method.
   /// An IOError status is returned if object creation on the store client fails,
   /// or if create is invoked consecutively on the same chunk
-  /// (with no intermediate AbortCreateChunk).
+  /// (with no intermediate AbortCreateChunk). An Invalid status is returned if the
+  /// object is being received with a different chunk size already.
   ray::Status CreateChunk(const ObjectID &object_id, const rpc::Address &owner_address,
                           uint64_t data_size, uint64_t metadata_size,
-                          uint64_t chunk_index);
+                          uint64_t chunk_index, uint64_t chunk_size = 0);
 
   /// Write to a Chunk of an object. If all chunks of an object is written,
   /// it seals the object.
@@ -121,6 +150,46 @@ class ObjectBufferPool {
   void WriteChunk(const ObjectID &object_id, uint64_t chunk_index,
                   const std::string &data);
 
+  /// Write to a chunk of an object, from data that is split into several ranges,
+  /// e.g. the slices of a gRPC buffer. See WriteChunk above.
+  ///
+  /// \param object_id The ObjectID.
+  /// \param chunk_index The index of the chunk.
+  /// \param data The ranges of data to write into the chunk, in order.
+  void WriteChunk(const ObjectID &object_id, uint64_t chunk_index,
+                  const std::vector<absl::Span<const uint8_t>> &data);
+
+  /// Returns the chunks of an object that weren't received yet. These are all
+  /// chunks if the object isn't being created.
+  ///
+  /// \param object_id The ObjectID.
+  /// \param data_size The sum of the object size and metadata size.
+  /// \param chunk_size The chunk size to use if the object isn't being created, or
+  /// 0 for the default chunk size.
+  /// \return The indices of the missing chunks, in order.
+  std::vector<uint64_t> GetMissingChunks(const ObjectID &object_id, uint64_t data_size,
+                                         uint64_t chunk_size = 0);
+
+  /// Returns the chunks of an object that is being received that were written
+  /// already.
+  ///
+  /// \param object_id The ObjectID.
+  /// \param[out] num_chunks The number of chunks of the object.
+  /// \param[out] chunk_indices The indices of the written chunks, in order.
+  /// \return False if the object isn't being received.
+  bool GetReceivedChunks(const ObjectID &object_id, uint64_t *num_chunks,
+                         std::vector<uint64_t> *chunk_indices);
+
+  /// Copy a written chunk of an object that is being received, so that it can be
+  /// pushed on to other nodes before the whole object is received.
+  ///
+  /// \param object_id The ObjectID.
+  /// \param chunk_index The index of the chunk.
+  /// \return The chunk, or nothing if the object isn't being received anymore or
+  /// the chunk wasn't written yet.
+  absl::optional<ReceivedChunk> GetReceivedChunk(const ObjectID &object_id,
+                                                 uint64_t chunk_index);
+
   /// Free a list of objects from object store.
   ///
   /// \param object_ids the The list of ObjectIDs to be deleted.
@@ -140,7 +209,7 @@ class ObjectBufferPool {
   /// Splits an object into ceil(data_size/chunk_size) chunks, which will
   /// either be read or written to in parallel.
   std::vector<ChunkInfo> BuildChunks(const ObjectID &object_id, uint8_t *data,
-                                     uint64_t data_size,
+                                     uint64_t data_size, uint64_t chunk_size,
                                      std::shared_ptr<Buffer> buffer_ref);
 
   /// The state of a chunk associated with a create operation.
@@ -149,10 +218,16 @@ class ObjectBufferPool {
   /// Holds the state of a create buffer.
   struct CreateBufferState {
     CreateBufferState() {}
-    CreateBufferState(std::vector<ChunkInfo> chunk_info)
+    CreateBufferState(std::vector<ChunkInfo> chunk_info,
+                      const rpc::Address &owner_address, uint64_t data_size,
+                      uint64_t metadata_size, uint64_t chunk_size)
         : chunk_info(chunk_info),
           chunk_state(chunk_info.size(), CreateChunkState::AVAILABLE),
-          num_seals_remaining(chunk_info.size()) {}
+          num_seals_remaining(chunk_info.size()),
+          owner_address(owner_address),
+          data_size(data_size),
+          metadata_size(metadata_size),
+          chunk_size(chunk_size) {}
     /// A vector maintaining information about the chunks which comprise
     /// an object.
     std::vector<ChunkInfo> chunk_info;
@@ -161,6 +236,14 @@ class ObjectBufferPool {
     std::vector<CreateChunkState> chunk_state;
     /// The number of chunks left to seal before the buffer is sealed.
     uint64_t num_seals_remaining;
+    /// The address of the object's owner.
+    rpc::Address owner_address;
+    /// The sum of the object size and metadata size.
+    uint64_t data_size;
+    /// The size of the metadata.
+    uint64_t metadata_size;
+    /// The chunk size that the object is split into.
+    uint64_t chunk_size;
   };
 
   /// Returned when GetChunk or CreateChunk fails.
@@ -14,9 +14,14 @@
 
 #include "ray/object_manager/object_manager.h"
 
+#include <zlib.h>
+
 #include <chrono>
+#include <cstring>
 
+#include "absl/strings/match.h"
 #include "ray/common/common_protocol.h"
+#include "ray/object_manager/push_request_reader.h"
 #include "ray/stats/stats.h"
 #include "ray/util/util.h"
 
@@ -24,6 +29,55 @@ namespace asio = boost::asio;
 
 namespace ray {
 
+namespace {
+
+/// Compress a chunk with the fastest zlib level.
+///
+/// \return False if compression failed.
+bool CompressChunk(const std::string &chunk, std::string *compressed) {
+  uLongf compressed_size = compressBound(chunk.size());
+  compressed->resize(compressed_size);
+  if (compress2(reinterpret_cast<Bytef *>(&(*compressed)[0]), &compressed_size,
+                reinterpret_cast<const Bytef *>(chunk.data()), chunk.size(),
+                Z_BEST_SPEED) != Z_OK) {
+    return false;
+  }
+  compressed->resize(compressed_size);
+  return true;
+}
+
+/// Decompress a chunk compressed by CompressChunk, which may be split into several
+/// ranges, into a buffer of exactly the original size.
+///
+/// \return False if the data is corrupted.
+bool DecompressChunk(const std::vector<absl::Span<const uint8_t>> &compressed,
+                     uint64_t chunk_size, std::string *chunk) {
+  chunk->resize(chunk_size);
+  z_stream stream;
+  std::memset(&stream, 0, sizeof(stream));
+  if (inflateInit(&stream) != Z_OK) {
+    return false;
+  }
+  stream.next_out = reinterpret_cast<Bytef *>(&(*chunk)[0]);
+  stream.avail_out = chunk_size;
+  int result = Z_OK;
+  for (const auto &range : compressed) {
+    if (range.empty()) {
+      continue;
+    }
+    stream.next_in = const_cast<Bytef *>(range.data());
+    stream.avail_in = range.size();
+    result = inflate(&stream, Z_NO_FLUSH);
+    if (result != Z_OK) {
+      break;
+    }
+  }
+  inflateEnd(&stream);
+  return result == Z_STREAM_END && stream.total_out == chunk_size;
+}
+
+}  // namespace
+
 ObjectStoreRunner::ObjectStoreRunner(const ObjectManagerConfig &config,
                                      SpillObjectsCallback spill_objects_callback,
                                      std::function<void()> object_store_full_callback,
@@ -53,6 +107,7 @@ ObjectManager::ObjectManager(
     const ObjectManagerConfig &config, IObjectDirectory *object_directory,
     RestoreSpilledObjectCallback restore_spilled_object,
     std::function<std::string(const ObjectID &)> get_spilled_object_url,
+    ReadCompressedObjectCallback read_compressed_object,
     SpillObjectsCallback spill_objects_callback,
     std::function<void()> object_store_full_callback,
     AddObjectCallback add_object_callback, DeleteObjectCallback delete_object_callback,
@@ -93,8 +148,11 @@ ObjectManager::ObjectManager(
       client_call_manager_(main_service, config_.rpc_service_threads_number),
       restore_spilled_object_(restore_spilled_object),
       get_spilled_object_url_(get_spilled_object_url),
+      read_compressed_object_(read_compressed_object),
       pull_retry_timer_(*main_service_,
-                        boost::posix_time::milliseconds(config.timer_freq_ms)) {
+                        boost::posix_time::milliseconds(config.timer_freq_ms)),
+      chunk_size_policy_(config_.object_chunk_size,
+                         RayConfig::instance().object_manager_max_chunk_size()) {
   RAY_CHECK(config_.rpc_service_threads_number > 0);
 
   push_manager_.reset(new PushManager(/* max_chunks_in_flight= */ std::max(
@@ -110,11 +168,17 @@ ObjectManager::ObjectManager(
                                          const NodeID &client_id) {
     SendPullRequest(object_id, client_id);
   };
+  const auto &send_striped_pull_request =
+      [this](const ObjectID &object_id, const std::vector<NodeID> &node_ids,
+             size_t object_size) {
+        SendStripedPullRequest(object_id, node_ids, object_size);
+      };
   const auto &cancel_pull_request = [this](const ObjectID &object_id) {
     // We must abort this object because it may have only been partially
     // created and will cause a leak if we never receive the rest of the
     // object. This is a no-op if the object is already sealed or evicted.
     buffer_pool_.AbortCreate(object_id);
+    relayed_objects_.erase(object_id);
   };
   const auto &get_time = []() { return absl::GetCurrentTimeNanos() / 1e9; };
   int64_t available_memory = config.object_store_memory;
@@ -124,7 +188,8 @@ ObjectManager::ObjectManager(
   pull_manager_.reset(new PullManager(self_node_id_, object_is_local, send_pull_request,
                                       cancel_pull_request, restore_spilled_object_,
                                       get_time, config.pull_timeout_ms, available_memory,
-                                      pin_object, get_spilled_object_url));
+                                      pin_object, get_spilled_object_url,
+                                      send_striped_pull_request));
   // Start object manager rpc server and send & receive request threads
   StartRpcService();
 }
@@ -137,6 +202,15 @@ bool ObjectManager::IsPlasmaObjectSpillable(const ObjectID &object_id) {
   return plasma::plasma_store_runner->IsPlasmaObjectSpillable(object_id);
 }
 
+void ObjectManager::SetObjectProvenance(const ObjectID &object_id,
+                                        plasma::ObjectProvenance provenance) {
+  plasma::plasma_store_runner->SetObjectProvenance(object_id, provenance);
+}
+
+int64_t ObjectManager::GetPendingCreateBytes() const {
+  return plasma::plasma_store_runner->GetPendingCreateBytes();
+}
+
 void ObjectManager::RunRpcService(int index) {
   SetThreadName("rpc.obj.mgr." + std::to_string(index));
   rpc_service_.run();
@@ -187,6 +261,25 @@ void ObjectManager::HandleObjectAdded(const ObjectInfo &object_info) {
     }
     unfulfilled_push_requests_.erase(iter);
   }
+
+  // The chunks that weren't forwarded to the nodes that pulled the object while it
+  // was being received are pushed from the object store now.
+  auto relay_it = relayed_objects_.find(object_id);
+  if (relay_it != relayed_objects_.end()) {
+    for (const auto &pair : relay_it->second) {
+      const auto &state = pair.second;
+      std::vector<uint64_t> chunk_indices;
+      for (uint64_t chunk_index = 0; chunk_index < state.wanted.size(); chunk_index++) {
+        if (state.wanted[chunk_index] && !state.sent[chunk_index]) {
+          chunk_indices.push_back(chunk_index);
+        }
+      }
+      if (!chunk_indices.empty()) {
+        Push(object_id, pair.first, chunk_indices);
+      }
+    }
+    relayed_objects_.erase(relay_it);
+  }
 }
 
 void ObjectManager::HandleObjectDeleted(const ObjectID &object_id) {
@@ -238,22 +331,49 @@ void ObjectManager::CancelPull(uint64_t request_id) {
   }
 }
 
-void ObjectManager::SendPullRequest(const ObjectID &object_id, const NodeID &client_id) {
+void ObjectManager::SendPullRequest(const ObjectID &object_id, const NodeID &client_id,
+                                    const std::vector<uint64_t> &chunk_indices) {
   auto rpc_client = GetRpcClient(client_id);
   if (rpc_client) {
+    // Pushes for ray.get() are served ahead of those for prefetched task arguments.
+    const int64_t priority = pull_manager_->GetPullPriority(object_id);
+    // The chunks must match the ones already received. Striped pulls pick the
+    // chunks themselves, so they need the chunk size too.
+    uint64_t chunk_size = buffer_pool_.GetChunkSize(object_id);
+    if (chunk_size == 0 && !chunk_indices.empty()) {
+      chunk_size = config_.object_chunk_size;
+    }
     // Try pulling from the client.
     rpc_service_.post(
-        [this, object_id, client_id, rpc_client]() {
+        [this, object_id, client_id, rpc_client, chunk_indices, priority, chunk_size]() {
           rpc::PullRequest pull_request;
           pull_request.set_object_id(object_id.Binary());
           pull_request.set_node_id(self_node_id_.Binary());
+          pull_request.set_priority(priority);
+          pull_request.set_chunk_size(chunk_size);
+          for (auto chunk_index : chunk_indices) {
+            pull_request.add_chunk_indices(chunk_index);
+          }
 
           rpc_client->Pull(
-              pull_request,
-              [object_id, client_id](const Status &status, const rpc::PullReply &reply) {
+              pull_request, [this, object_id, client_id, chunk_indices](
+                                const Status &status, const rpc::PullReply &reply) {
                 if (!status.ok()) {
                   RAY_LOG(WARNING) << "Send pull " << object_id << " request to client "
                                    << client_id << " failed due to" << status.message();
+                  return;
+                }
+                if (!reply.relay_node_id().empty()) {
+                  const auto relay_node_id = NodeID::FromBinary(reply.relay_node_id());
+                  RAY_LOG(DEBUG) << "Pull of " << object_id << " from " << client_id
+                                 << " redirected to " << relay_node_id;
+                  main_service_->post(
+                      [this, object_id, relay_node_id, chunk_indices]() {
+                        if (pull_manager_->IsObjectActive(object_id)) {
+                          SendPullRequest(object_id, relay_node_id, chunk_indices);
+                        }
+                      },
+                      "ObjectManager.RedirectPull");
                 }
               });
         },
@@ -265,6 +385,24 @@ void ObjectManager::SendPullRequest(const ObjectID &object_id, const NodeID &cli
   }
 }
 
+void ObjectManager::SendStripedPullRequest(const ObjectID &object_id,
+                                           const std::vector<NodeID> &node_ids,
+                                           size_t object_size) {
+  RAY_CHECK(!node_ids.empty());
+  // Only ask for the chunks that weren't received yet, so that on a retry the
+  // chunks a slow node didn't send are spread over all nodes.
+  const auto missing_chunks = buffer_pool_.GetMissingChunks(object_id, object_size);
+  std::vector<std::vector<uint64_t>> stripes(node_ids.size());
+  for (size_t i = 0; i < missing_chunks.size(); i++) {
+    stripes[i % stripes.size()].push_back(missing_chunks[i]);
+  }
+  for (size_t i = 0; i < node_ids.size(); i++) {
+    if (!stripes[i].empty()) {
+      SendPullRequest(object_id, node_ids[i], stripes[i]);
+    }
+  }
+}
+
 void ObjectManager::HandlePushTaskTimeout(const ObjectID &object_id,
                                           const NodeID &node_id) {
   RAY_LOG(WARNING) << "Invalid Push request ObjectID: " << object_id
@@ -287,8 +425,9 @@ void ObjectManager::HandlePushTaskTimeout(const ObjectID &object_id,
 }
 
 void ObjectManager::HandleSendFinished(const ObjectID &object_id, const NodeID &node_id,
-                                       uint64_t chunk_index, double start_time,
-                                       double end_time, ray::Status status) {
+                                       uint64_t chunk_index, uint64_t chunk_bytes,
+                                       double start_time, double end_time,
+                                       ray::Status status) {
   RAY_LOG(DEBUG) << "HandleSendFinished on " << self_node_id_ << " to " << node_id
                  << " of object " << object_id << " chunk " << chunk_index
                  << ", status: " << status.ToString();
@@ -296,20 +435,52 @@ void ObjectManager::HandleSendFinished(const ObjectID &object_id, const NodeID &
     // TODO(rkn): What do we want to do if the send failed?
     RAY_LOG(DEBUG) << "Failed to send a push request for an object " << object_id
                    << " to " << node_id << ". Chunk index: " << chunk_index;
+    absl::MutexLock lock(&transfer_stats_mutex_);
+    auto &peer_stats = transfer_stats_[node_id];
+    peer_stats.set_chunks_send_failed(peer_stats.chunks_send_failed() + 1);
+    return;
   }
+  const double round_trip_s = end_time - start_time;
+  const stats::TagsType tags = {{stats::PeerNodeKey, node_id.Hex()}};
+  stats::ObjectManagerChunkRoundTripMs().Record(round_trip_s * 1000, tags);
+  if (round_trip_s > 0) {
+    stats::ObjectManagerChunkBandwidthMB().Record(
+        chunk_bytes / round_trip_s / (1024 * 1024), tags);
+  }
+  absl::MutexLock lock(&transfer_stats_mutex_);
+  auto &peer_stats = transfer_stats_[node_id];
+  peer_stats.set_bytes_sent(peer_stats.bytes_sent() + chunk_bytes);
+  peer_stats.set_chunks_sent(peer_stats.chunks_sent() + 1);
+  peer_stats.set_chunk_round_trip_total_s(peer_stats.chunk_round_trip_total_s() +
+                                          round_trip_s);
 }
 
-void ObjectManager::Push(const ObjectID &object_id, const NodeID &node_id) {
+void ObjectManager::Push(const ObjectID &object_id, const NodeID &node_id,
+                         const std::vector<uint64_t> &chunk_indices, int64_t priority,
+                         uint64_t chunk_size) {
   RAY_LOG(DEBUG) << "Push on " << self_node_id_ << " to " << node_id << " of object "
                  << object_id;
   if (local_objects_.count(object_id) != 0) {
-    return PushLocalObject(object_id, node_id);
+    return PushLocalObject(object_id, node_id, chunk_indices, priority, chunk_size);
   }
 
   // Push from spilled object directly if the object is on local disk.
   auto object_url = get_spilled_object_url_(object_id);
-  if (!object_url.empty() && RayConfig::instance().is_external_storage_type_fs()) {
-    return PushFromFilesystem(object_id, node_id, object_url);
+  if (absl::StartsWith(object_url, kCompressedObjectURLPrefix)) {
+    if (PushCompressedObject(object_id, node_id, chunk_indices, priority, chunk_size)) {
+      return;
+    }
+    // The object couldn't be decompressed outside of plasma. Restore it into plasma,
+    // it is pushed below once it is local again.
+    restore_spilled_object_(object_id, object_url, [object_id](const Status &status) {
+      if (!status.ok()) {
+        RAY_LOG(ERROR) << "Failed to restore compressed object " << object_id
+                       << " for a push: " << status;
+      }
+    });
+  } else if (!object_url.empty() && RayConfig::instance().is_external_storage_type_fs()) {
+    return PushFromFilesystem(object_id, node_id, object_url, chunk_indices, priority,
+                              chunk_size);
   }
 
   // Avoid setting duplicated timer for the same object and node pair.
@@ -343,7 +514,9 @@ void ObjectManager::Push(const ObjectID &object_id, const NodeID &node_id) {
   }
 }
 
-void ObjectManager::PushLocalObject(const ObjectID &object_id, const NodeID &node_id) {
+void ObjectManager::PushLocalObject(const ObjectID &object_id, const NodeID &node_id,
+                                    const std::vector<uint64_t> &chunk_indices,
+                                    int64_t priority, uint64_t chunk_size) {
   const ObjectInfo &object_info = local_objects_[object_id].object_info;
   uint64_t data_size = static_cast<uint64_t>(object_info.data_size);
   uint64_t metadata_size = static_cast<uint64_t>(object_info.metadata_size);
@@ -387,17 +560,60 @@ void ObjectManager::PushLocalObject(const ObjectID &object_id, const NodeID &nod
     }
   }
 
+  if (chunk_size == 0) {
+    chunk_size = chunk_size_policy_.GetChunkSize(node_id, object_reader->GetObjectSize());
+  }
+  PushObjectInternal(
+      object_id, node_id,
+      std::make_shared<ChunkObjectReader>(std::move(object_reader), chunk_size),
+      chunk_indices, priority);
+}
+
+bool ObjectManager::PushCompressedObject(const ObjectID &object_id,
+                                         const NodeID &node_id,
+                                         const std::vector<uint64_t> &chunk_indices,
+                                         int64_t priority, uint64_t chunk_size) {
+  std::shared_ptr<IObjectReader> object_reader;
+  auto it = compressed_object_readers_.find(object_id);
+  if (it != compressed_object_readers_.end()) {
+    object_reader = it->second.lock();
+  }
+  if (object_reader == nullptr) {
+    if (read_compressed_object_ == nullptr) {
+      return false;
+    }
+    object_reader = read_compressed_object_(object_id);
+    if (object_reader == nullptr) {
+      return false;
+    }
+    // Forget the readers of the pushes that have finished.
+    for (auto reader_it = compressed_object_readers_.begin();
+         reader_it != compressed_object_readers_.end();) {
+      if (reader_it->second.expired()) {
+        compressed_object_readers_.erase(reader_it++);
+      } else {
+        reader_it++;
+      }
+    }
+    compressed_object_readers_[object_id] = object_reader;
+  }
+  if (chunk_size == 0) {
+    chunk_size = chunk_size_policy_.GetChunkSize(node_id, object_reader->GetObjectSize());
+  }
   PushObjectInternal(object_id, node_id,
-                     std::make_shared<ChunkObjectReader>(std::move(object_reader),
-                                                         config_.object_chunk_size));
+                     std::make_shared<ChunkObjectReader>(object_reader, chunk_size),
+                     chunk_indices, priority);
+  return true;
 }
 
 void ObjectManager::PushFromFilesystem(const ObjectID &object_id, const NodeID &node_id,
-                                       const std::string &spilled_url) {
+                                       const std::string &spilled_url,
+                                       const std::vector<uint64_t> &chunk_indices,
+                                       int64_t priority, uint64_t chunk_size) {
   // SpilledObjectReader::CreateSpilledObjectReader does synchronous IO; schedule it off
   // main thread.
   rpc_service_.post(
-      [this, object_id, node_id, spilled_url, chunk_size = config_.object_chunk_size]() {
+      [this, object_id, node_id, spilled_url, chunk_indices, priority, chunk_size]() {
         auto optional_spilled_object =
             SpilledObjectReader::CreateSpilledObjectReader(spilled_url);
         if (!optional_spilled_object.has_value()) {
@@ -405,17 +621,22 @@ void ObjectManager::PushFromFilesystem(const ObjectID &object_id, const NodeID &
               << "Ignoring stale read request for already deleted object: " << object_id;
           return;
         }
+        auto spilled_object = std::make_shared<SpilledObjectReader>(
+            std::move(optional_spilled_object.value()));
         auto chunk_object_reader = std::make_shared<ChunkObjectReader>(
-            std::make_shared<SpilledObjectReader>(
-                std::move(optional_spilled_object.value())),
-            chunk_size);
+            spilled_object,
+            chunk_size != 0
+                ? chunk_size
+                : chunk_size_policy_.GetChunkSize(node_id,
+                                                  spilled_object->GetObjectSize()));
 
         // Schedule PushObjectInternal back to main_service as PushObjectInternal access
         // thread unsafe datastructure.
         main_service_->post(
-            [this, object_id, node_id,
+            [this, object_id, node_id, chunk_indices, priority,
              chunk_object_reader = std::move(chunk_object_reader)]() {
-              PushObjectInternal(object_id, node_id, std::move(chunk_object_reader));
+              PushObjectInternal(object_id, node_id, std::move(chunk_object_reader),
+                                 chunk_indices, priority);
             },
             "ObjectManager.PushLocalSpilledObjectInternal");
       },
@@ -423,7 +644,9 @@ void ObjectManager::PushFromFilesystem(const ObjectID &object_id, const NodeID &
 }
 
 void ObjectManager::PushObjectInternal(const ObjectID &object_id, const NodeID &node_id,
-                                       std::shared_ptr<ChunkObjectReader> chunk_reader) {
+                                       std::shared_ptr<ChunkObjectReader> chunk_reader,
+                                       const std::vector<uint64_t> &chunk_indices,
+                                       int64_t priority) {
   auto rpc_client = GetRpcClient(node_id);
   if (!rpc_client) {
     // Push is best effort, so do nothing here.
@@ -436,14 +659,36 @@ void ObjectManager::PushObjectInternal(const ObjectID &object_id, const NodeID &
                  << ", number of chunks: " << chunk_reader->GetNumChunks()
                  << ", total data size: " << chunk_reader->GetObject().GetObjectSize();
 
+  // Only the requested chunks are sent if the receiver pulls from several nodes.
+  std::vector<uint64_t> chunks_to_send;
+  for (auto chunk_index : chunk_indices) {
+    if (chunk_index < chunk_reader->GetNumChunks()) {
+      chunks_to_send.push_back(chunk_index);
+    }
+  }
+  if (chunk_indices.empty()) {
+    for (uint64_t chunk_index = 0; chunk_index < chunk_reader->GetNumChunks();
+         chunk_index++) {
+      chunks_to_send.push_back(chunk_index);
+    }
+  }
+  if (chunks_to_send.empty()) {
+    return;
+  }
+  const uint64_t object_size = chunk_reader->GetObject().GetObjectSize();
+  const uint64_t num_bytes =
+      chunk_indices.empty()
+          ? object_size
+          : std::min(object_size, chunks_to_send.size() * chunk_reader->GetChunkSize());
+
   auto push_id = UniqueID::FromRandom();
   push_manager_->StartPush(
-      node_id, object_id, chunk_reader->GetNumChunks(), [=](int64_t chunk_id) {
+      node_id, object_id, chunks_to_send.size(), [=](int64_t i) {
         rpc_service_.post(
             [=]() {
               // Post to the multithreaded RPC event loop so that data is copied
               // off of the main thread.
-              SendObjectChunk(push_id, object_id, node_id, chunk_id, rpc_client,
+              SendObjectChunk(push_id, object_id, node_id, chunks_to_send[i], rpc_client,
                               [=](const Status &status) {
                                 // Post back to the main event loop because the
                                 // PushManager is thread-safe.
@@ -456,7 +701,8 @@ void ObjectManager::PushObjectInternal(const ObjectID &object_id, const NodeID &
                               std::move(chunk_reader));
             },
             "ObjectManager.Push");
-      });
+      },
+      priority, num_bytes);
 }
 
 void ObjectManager::SendObjectChunk(const UniqueID &push_id, const ObjectID &object_id,
@@ -475,21 +721,23 @@ void ObjectManager::SendObjectChunk(const UniqueID &push_id, const ObjectID &obj
   push_request.set_data_size(chunk_reader->GetObject().GetObjectSize());
   push_request.set_metadata_size(chunk_reader->GetObject().GetMetadataSize());
   push_request.set_chunk_index(chunk_index);
-
-  // read a chunk into push_request and handle errors.
-  auto optional_chunk = chunk_reader->GetChunk(chunk_index);
-  if (!optional_chunk.has_value()) {
-    RAY_LOG(DEBUG) << "Read chunk " << chunk_index << " of object " << object_id
-                   << " failed. It may have been evicted.";
-    on_complete(Status::IOError("Failed to read spilled object"));
-    return;
-  }
-  push_request.set_data(std::move(optional_chunk.value()));
+  const uint64_t chunk_size = chunk_reader->GetChunkSize();
+  push_request.set_chunk_size(chunk_size);
+  const uint64_t chunk_bytes = std::min(
+      chunk_size, chunk_reader->GetObject().GetObjectSize() - chunk_index * chunk_size);
+  // Chunks to slow links are compressed, at the cost of copying them.
+  const uint64_t compression_max_mbps =
+      RayConfig::instance().object_manager_compression_max_mbps();
+  const double bandwidth = chunk_size_policy_.GetBandwidth(node_id);
+  const bool compress = compression_max_mbps > 0 && bandwidth > 0 &&
+                        bandwidth < compression_max_mbps * 1024.0 * 1024.0;
+  // The bytes sent over the link, which the link's bandwidth is measured with.
+  auto bytes_sent = std::make_shared<uint64_t>(chunk_bytes);
 
   // record the time cost between send chunk and receive reply
   rpc::ClientCallback<rpc::PushReply> callback =
-      [this, start_time, object_id, node_id, chunk_index, on_complete](
-          const Status &status, const rpc::PushReply &reply) {
+      [this, start_time, object_id, node_id, chunk_index, chunk_bytes, bytes_sent,
+       on_complete](const Status &status, const rpc::PushReply &reply) {
         // TODO: Just print warning here, should we try to resend this chunk?
         if (!status.ok()) {
           RAY_LOG(WARNING) << "Send object " << object_id << " chunk to node " << node_id
@@ -497,10 +745,58 @@ void ObjectManager::SendObjectChunk(const UniqueID &push_id, const ObjectID &obj
                            << ", chunk index: " << chunk_index;
         }
         double end_time = absl::GetCurrentTimeNanos() / 1e9;
-        HandleSendFinished(object_id, node_id, chunk_index, start_time, end_time, status);
+        if (status.ok()) {
+          chunk_size_policy_.RecordChunkSent(node_id, *bytes_sent, end_time - start_time);
+        }
+        HandleSendFinished(object_id, node_id, chunk_index, chunk_bytes, start_time,
+                           end_time, status);
         on_complete(status);
       };
 
+  // Objects in the local object store are sent from shared memory. The slices
+  // keep the reader, and so the object, pinned until gRPC is done with them.
+  std::vector<absl::Span<const uint8_t>> ranges;
+  if (!compress && RayConfig::instance().object_manager_zero_copy_push() &&
+      chunk_reader->GetChunkRanges(chunk_index, &ranges)) {
+    auto release_reader = [](void *reader) {
+      delete static_cast<std::shared_ptr<ChunkObjectReader> *>(reader);
+    };
+    std::vector<grpc::Slice> slices;
+    for (const auto &range : ranges) {
+      slices.emplace_back(const_cast<uint8_t *>(range.data()), range.size(),
+                          release_reader,
+                          new std::shared_ptr<ChunkObjectReader>(chunk_reader));
+    }
+    rpc_client->Push(push_request, slices, callback);
+    return;
+  }
+
+  // read a chunk into push_request and handle errors.
+  const int64_t read_start_ms = current_time_ms();
+  auto optional_chunk = chunk_reader->GetChunk(chunk_index);
+  if (chunk_reader->GetObject().GetDataPointer() == nullptr) {
+    // The object is not in memory, so the chunk was read from external storage.
+    stats::ObjectManagerSpilledChunkReadMs().Record(current_time_ms() - read_start_ms);
+  }
+  if (!optional_chunk.has_value()) {
+    RAY_LOG(DEBUG) << "Read chunk " << chunk_index << " of object " << object_id
+                   << " failed. It may have been evicted.";
+    on_complete(Status::IOError("Failed to read spilled object"));
+    return;
+  }
+  std::string compressed;
+  // Only send the compressed chunk if it saves at least an eighth of the bytes.
+  if (compress && CompressChunk(optional_chunk.value(), &compressed) &&
+      compressed.size() < chunk_bytes - chunk_bytes / 8) {
+    stats::ObjectManagerCompressionBytesSaved().Record(
+        chunk_bytes - compressed.size(), {{stats::PeerNodeKey, node_id.Hex()}});
+    *bytes_sent = compressed.size();
+    push_request.set_compressed(true);
+    push_request.set_uncompressed_size(chunk_bytes);
+    push_request.set_data(std::move(compressed));
+  } else {
+    push_request.set_data(std::move(optional_chunk.value()));
+  }
   rpc_client->Push(push_request, callback);
 }
 
@@ -698,6 +994,30 @@ void ObjectManager::WaitComplete(const UniqueID &wait_id) {
 /// Implementation of ObjectManagerServiceHandler
 void ObjectManager::HandlePush(const rpc::PushRequest &request, rpc::PushReply *reply,
                                rpc::SendReplyCallback send_reply_callback) {
+  const std::string &data = request.data();
+  ReceivePushedChunk(request, {absl::Span<const uint8_t>(
+                                  reinterpret_cast<const uint8_t *>(data.data()),
+                                  data.size())});
+  send_reply_callback(Status::OK(), nullptr, nullptr);
+}
+
+void ObjectManager::HandleRawPush(const grpc::ByteBuffer &request,
+                                  grpc::ByteBuffer *reply,
+                                  rpc::SendReplyCallback send_reply_callback) {
+  PushRequestReader reader;
+  if (!reader.Parse(request)) {
+    send_reply_callback(Status::Invalid("Failed to parse the push request."), nullptr,
+                        nullptr);
+    return;
+  }
+  ReceivePushedChunk(reader.GetRequest(), reader.GetData());
+  SerializeRawPushReply(rpc::PushReply(), reply);
+  send_reply_callback(Status::OK(), nullptr, nullptr);
+}
+
+void ObjectManager::ReceivePushedChunk(
+    const rpc::PushRequest &request,
+    const std::vector<absl::Span<const uint8_t>> &data) {
   ObjectID object_id = ObjectID::FromBinary(request.object_id());
   NodeID node_id = NodeID::FromBinary(request.node_id());
 
@@ -706,10 +1026,39 @@ void ObjectManager::HandlePush(const rpc::PushRequest &request, rpc::PushReply *
   uint64_t metadata_size = request.metadata_size();
   uint64_t data_size = request.data_size();
   const rpc::Address &owner_address = request.owner_address();
-  const std::string &data = request.data();
 
-  bool success = ReceiveObjectChunk(node_id, object_id, owner_address, data_size,
-                                    metadata_size, chunk_index, data);
+  bool success;
+  if (request.compressed()) {
+    std::string chunk;
+    success = DecompressChunk(data, request.uncompressed_size(), &chunk);
+    if (success) {
+      success = ReceiveObjectChunk(
+          node_id, object_id, owner_address, data_size, metadata_size, chunk_index,
+          {absl::Span<const uint8_t>(reinterpret_cast<const uint8_t *>(chunk.data()),
+                                     chunk.size())},
+          request.chunk_size());
+    } else {
+      RAY_LOG(WARNING) << "Failed to decompress chunk " << chunk_index << " of object "
+                       << object_id << " from node " << node_id;
+    }
+  } else {
+    success = ReceiveObjectChunk(node_id, object_id, owner_address, data_size,
+                                 metadata_size, chunk_index, data, request.chunk_size());
+  }
+  {
+    absl::MutexLock lock(&transfer_stats_mutex_);
+    auto &peer_stats = transfer_stats_[node_id];
+    if (success) {
+      uint64_t chunk_bytes = 0;
+      for (const auto &range : data) {
+        chunk_bytes += range.size();
+      }
+      peer_stats.set_bytes_received(peer_stats.bytes_received() + chunk_bytes);
+      peer_stats.set_chunks_received(peer_stats.chunks_received() + 1);
+    } else {
+      peer_stats.set_chunks_received_dropped(peer_stats.chunks_received_dropped() + 1);
+    }
+  }
   num_chunks_received_total_++;
   if (!success) {
     num_chunks_received_total_failed_++;
@@ -718,17 +1067,15 @@ void ObjectManager::HandlePush(const rpc::PushRequest &request, rpc::PushReply *
                   << num_chunks_received_total_failed_ << "/"
                   << num_chunks_received_total_ << " failed";
   }
-
-  send_reply_callback(Status::OK(), nullptr, nullptr);
 }
 
-bool ObjectManager::ReceiveObjectChunk(const NodeID &node_id, const ObjectID &object_id,
-                                       const rpc::Address &owner_address,
-                                       uint64_t data_size, uint64_t metadata_size,
-                                       uint64_t chunk_index, const std::string &data) {
+bool ObjectManager::ReceiveObjectChunk(
+    const NodeID &node_id, const ObjectID &object_id, const rpc::Address &owner_address,
+    uint64_t data_size, uint64_t metadata_size, uint64_t chunk_index,
+    const std::vector<absl::Span<const uint8_t>> &data, uint64_t chunk_size) {
   RAY_LOG(DEBUG) << "ReceiveObjectChunk on " << self_node_id_ << " from " << node_id
                  << " of object " << object_id << " chunk index: " << chunk_index
-                 << ", chunk data size: " << data.size()
+                 << ", chunk data ranges: " << data.size()
                  << ", object size: " << data_size;
 
   if (!pull_manager_->IsObjectActive(object_id)) {
@@ -737,7 +1084,7 @@ bool ObjectManager::ReceiveObjectChunk(const NodeID &node_id, const ObjectID &ob
     return false;
   }
   auto chunk_status = buffer_pool_.CreateChunk(object_id, owner_address, data_size,
-                                               metadata_size, chunk_index);
+                                               metadata_size, chunk_index, chunk_size);
   if (!pull_manager_->IsObjectActive(object_id)) {
     num_chunks_received_cancelled_++;
     // This object is no longer being actively pulled. Abort the object. We
@@ -751,6 +1098,13 @@ bool ObjectManager::ReceiveObjectChunk(const NodeID &node_id, const ObjectID &ob
   if (chunk_status.ok()) {
     // Avoid handling this chunk if it's already being handled by another process.
     buffer_pool_.WriteChunk(object_id, chunk_index, data);
+    if (RayConfig::instance().object_manager_max_pushes_per_object() >= 0) {
+      main_service_->post(
+          [this, object_id, chunk_index]() {
+            OnObjectChunkReceived(object_id, chunk_index);
+          },
+          "ObjectManager.ObjectChunkReceived");
+    }
     return true;
   } else {
     num_chunks_received_failed_due_to_plasma_++;
@@ -766,9 +1120,162 @@ void ObjectManager::HandlePull(const rpc::PullRequest &request, rpc::PullReply *
   RAY_LOG(DEBUG) << "Received pull request from node " << node_id << " for object ["
                  << object_id << "].";
 
-  main_service_->post([this, object_id, node_id]() { Push(object_id, node_id); },
-                      "ObjectManager.HandlePull");
-  send_reply_callback(Status::OK(), nullptr, nullptr);
+  std::vector<uint64_t> chunk_indices(request.chunk_indices().begin(),
+                                      request.chunk_indices().end());
+  main_service_->post(
+      [this, object_id, node_id, chunk_indices, priority = request.priority(),
+       chunk_size = request.chunk_size(), reply, send_reply_callback]() {
+        if (!TryRedirectPull(object_id, node_id, reply) &&
+            !TryRelayObject(object_id, node_id, chunk_indices, chunk_size)) {
+          Push(object_id, node_id, chunk_indices, priority, chunk_size);
+        }
+        send_reply_callback(Status::OK(), nullptr, nullptr);
+      },
+      "ObjectManager.HandlePull");
+}
+
+bool ObjectManager::TryRedirectPull(const ObjectID &object_id, const NodeID &node_id,
+                                    rpc::PullReply *reply) {
+  const int64_t max_pushes = RayConfig::instance().object_manager_max_pushes_per_object();
+  if (max_pushes < 0) {
+    return false;
+  }
+  std::vector<NodeID> node_ids;
+  if (local_objects_.count(object_id) != 0) {
+    node_ids = push_manager_->GetPushDestinations(object_id);
+  } else {
+    auto it = relayed_objects_.find(object_id);
+    if (it != relayed_objects_.end()) {
+      for (const auto &pair : it->second) {
+        node_ids.push_back(pair.first);
+      }
+    }
+  }
+  // Keep serving the nodes this node was serving already, e.g. on a retry.
+  if (node_ids.size() < static_cast<size_t>(max_pushes) ||
+      std::find(node_ids.begin(), node_ids.end(), node_id) != node_ids.end()) {
+    return false;
+  }
+  std::uniform_int_distribution<size_t> distribution(0, node_ids.size() - 1);
+  const auto &relay_node_id = node_ids[distribution(gen_)];
+  RAY_LOG(DEBUG) << "Redirecting pull of " << object_id << " from " << node_id << " to "
+                 << relay_node_id;
+  reply->set_relay_node_id(relay_node_id.Binary());
+  return true;
+}
+
+bool ObjectManager::TryRelayObject(const ObjectID &object_id, const NodeID &node_id,
+                                   const std::vector<uint64_t> &chunk_indices,
+                                   uint64_t chunk_size) {
+  if (RayConfig::instance().object_manager_max_pushes_per_object() < 0 ||
+      local_objects_.count(object_id) != 0) {
+    return false;
+  }
+  // The chunks are forwarded as received, so the chunk indices only match if the
+  // node wants the same chunk size.
+  if (chunk_size != 0 && chunk_size != buffer_pool_.GetChunkSize(object_id)) {
+    return false;
+  }
+  uint64_t num_chunks = 0;
+  std::vector<uint64_t> received_chunks;
+  if (!buffer_pool_.GetReceivedChunks(object_id, &num_chunks, &received_chunks)) {
+    return false;
+  }
+  auto &state = relayed_objects_[object_id][node_id];
+  if (state.wanted.empty()) {
+    state.wanted.resize(num_chunks, false);
+    state.sent.resize(num_chunks, false);
+  }
+  // A repeated request means that the node is still missing these chunks, so
+  // they are forwarded again.
+  for (uint64_t chunk_index = 0; chunk_index < num_chunks; chunk_index++) {
+    if (chunk_indices.empty()) {
+      state.wanted[chunk_index] = true;
+      state.sent[chunk_index] = false;
+    }
+  }
+  for (auto chunk_index : chunk_indices) {
+    if (chunk_index < num_chunks) {
+      state.wanted[chunk_index] = true;
+      state.sent[chunk_index] = false;
+    }
+  }
+  RAY_LOG(DEBUG) << "Relaying " << object_id << " to " << node_id << ", "
+                 << received_chunks.size() << "/" << num_chunks << " chunks received";
+  for (auto chunk_index : received_chunks) {
+    if (state.wanted[chunk_index]) {
+      ForwardReceivedChunk(object_id, node_id, chunk_index, &state);
+    }
+  }
+  return true;
+}
+
+void ObjectManager::OnObjectChunkReceived(const ObjectID &object_id,
+                                          uint64_t chunk_index) {
+  auto it = relayed_objects_.find(object_id);
+  if (it == relayed_objects_.end()) {
+    return;
+  }
+  for (auto &pair : it->second) {
+    auto &state = pair.second;
+    if (chunk_index < state.wanted.size() && state.wanted[chunk_index] &&
+        !state.sent[chunk_index]) {
+      ForwardReceivedChunk(object_id, pair.first, chunk_index, &state);
+    }
+  }
+}
+
+void ObjectManager::ForwardReceivedChunk(const ObjectID &object_id,
+                                         const NodeID &node_id, uint64_t chunk_index,
+                                         RelayState *state) {
+  auto rpc_client = GetRpcClient(node_id);
+  if (!rpc_client) {
+    return;
+  }
+  state->sent[chunk_index] = true;
+  rpc_service_.post(
+      [this, object_id, node_id, chunk_index, rpc_client, push_id = state->push_id]() {
+        // Copy the chunk off of the main thread.
+        auto chunk = buffer_pool_.GetReceivedChunk(object_id, chunk_index);
+        if (!chunk.has_value()) {
+          // The object was sealed or aborted in the meantime. Once it's local, the
+          // chunk is pushed from the object store instead.
+          main_service_->post(
+              [this, object_id, node_id, chunk_index]() {
+                auto it = relayed_objects_.find(object_id);
+                if (it != relayed_objects_.end()) {
+                  auto node_it = it->second.find(node_id);
+                  if (node_it != it->second.end()) {
+                    node_it->second.sent[chunk_index] = false;
+                  }
+                } else if (local_objects_.count(object_id) != 0) {
+                  Push(object_id, node_id, {chunk_index});
+                }
+              },
+              "ObjectManager.ForwardChunkFailed");
+          return;
+        }
+        rpc::PushRequest push_request;
+        push_request.set_push_id(push_id.Binary());
+        push_request.set_object_id(object_id.Binary());
+        push_request.mutable_owner_address()->CopyFrom(chunk->owner_address);
+        push_request.set_node_id(self_node_id_.Binary());
+        push_request.set_data_size(chunk->data_size);
+        push_request.set_metadata_size(chunk->metadata_size);
+        push_request.set_chunk_index(chunk_index);
+        push_request.set_chunk_size(chunk->chunk_size);
+        push_request.set_data(std::move(chunk->data));
+        rpc_client->Push(push_request, [object_id, node_id, chunk_index](
+                                           const Status &status,
+                                           const rpc::PushReply &reply) {
+          if (!status.ok()) {
+            RAY_LOG(WARNING) << "Forward object " << object_id << " chunk to node "
+                             << node_id << " failed due to" << status.message()
+                             << ", chunk index: " << chunk_index;
+          }
+        });
+      },
+      "ObjectManager.ForwardChunk");
 }
 
 void ObjectManager::HandleFreeObjects(const rpc::FreeObjectsRequest &request,
@@ -831,7 +1338,9 @@ std::shared_ptr<rpc::ObjectManagerClient> ObjectManager::GetRpcClient(
       return nullptr;
     }
     auto object_manager_client = std::make_shared<rpc::ObjectManagerClient>(
-        connection_info.ip, connection_info.port, client_call_manager_);
+        connection_info.ip, connection_info.port, client_call_manager_,
+        RayConfig::instance().object_manager_push_connections(),
+        RayConfig::instance().object_manager_separate_connections());
 
     RAY_LOG(DEBUG) << "Get rpc client, address: " << connection_info.ip
                    << ", port: " << connection_info.port
@@ -884,6 +1393,15 @@ void ObjectManager::FillObjectStoreStats(rpc::GetNodeStatsReply *reply) const {
   stats->set_object_pulls_queued(pull_manager_->HasPullsQueued());
 }
 
+void ObjectManager::FillObjectTransferStats(rpc::GetNodeStatsReply *reply) const {
+  absl::MutexLock lock(&transfer_stats_mutex_);
+  for (const auto &entry : transfer_stats_) {
+    auto peer_stats = reply->add_object_transfer_stats();
+    peer_stats->CopyFrom(entry.second);
+    peer_stats->set_node_id(entry.first.Binary());
+  }
+}
+
 void ObjectManager::Tick(const boost::system::error_code &e) {
   RAY_CHECK(!e) << "The raylet's object manager has failed unexpectedly with error: " << e
                 << ". Please file a bug report on here: "
@@ -28,12 +28,14 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "ray/common/asio/instrumented_io_context.h"
 #include "ray/common/id.h"
 #include "ray/common/ray_config.h"
 #include "ray/common/status.h"
 #include "ray/object_manager/chunk_object_reader.h"
+#include "ray/object_manager/chunk_size_policy.h"
 #include "ray/object_manager/common.h"
 #include "ray/object_manager/object_buffer_pool.h"
 #include "ray/object_manager/object_directory.h"
@@ -115,6 +117,11 @@ class ObjectManager : public ObjectManagerInterface,
   using RestoreSpilledObjectCallback = std::function<void(
       const ObjectID &, const std::string &, std::function<void(const ray::Status &)>)>;
 
+  /// Returns a reader over an object of the compression tier without restoring it
+  /// into plasma, or nullptr if the object isn't compressed on this node.
+  using ReadCompressedObjectCallback =
+      std::function<std::shared_ptr<IObjectReader>(const ObjectID &)>;
+
   /// Implementation of object manager service
 
   /// Handle push request from remote object manager
@@ -128,6 +135,15 @@ class ObjectManager : public ObjectManagerInterface,
   void HandlePush(const rpc::PushRequest &request, rpc::PushReply *reply,
                   rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Handle a serialized push request from remote object manager. The chunk data
+  /// is written into the local object store straight from the gRPC buffer.
+  ///
+  /// \param request The serialized push request
+  /// \param reply The serialized reply to the sender
+  /// \param send_reply_callback Callback of the request
+  void HandleRawPush(const grpc::ByteBuffer &request, grpc::ByteBuffer *reply,
+                     rpc::SendReplyCallback send_reply_callback) override;
+
   /// Handle pull request from remote object manager
   ///
   /// \param request Pull request
@@ -165,6 +181,7 @@ class ObjectManager : public ObjectManagerInterface,
       const ObjectManagerConfig &config, IObjectDirectory *object_directory,
       RestoreSpilledObjectCallback restore_spilled_object,
       std::function<std::string(const ObjectID &)> get_spilled_object_url,
+      ReadCompressedObjectCallback read_compressed_object,
       SpillObjectsCallback spill_objects_callback,
       std::function<void()> object_store_full_callback,
       AddObjectCallback add_object_callback, DeleteObjectCallback delete_object_callback,
@@ -183,14 +200,32 @@ class ObjectManager : public ObjectManagerInterface,
   /// local object manager. False otherwise.
   bool IsPlasmaObjectSpillable(const ObjectID &object_id);
 
+  /// This methods call the plasma store which runs in a separate thread.
+  /// Tell the plasma store that the local copy of the object is no longer the only
+  /// copy, e.g., because the object was spilled, so that it is evicted first.
+  void SetObjectProvenance(const ObjectID &object_id,
+                           plasma::ObjectProvenance provenance);
+
+  /// This methods call the plasma store which runs in a separate thread.
+  /// Return the bytes of the objects that wait for space to be created in the
+  /// plasma store.
+  int64_t GetPendingCreateBytes() const;
+
   /// Consider pushing an object to a remote object manager. This object manager
   /// may choose to ignore the Push call (e.g., if Push is called twice in a row
   /// on the same object, the second one might be ignored).
   ///
   /// \param object_id The object's object id.
   /// \param node_id The remote node's id.
+  /// \param chunk_indices The chunks to push, or empty to push all chunks. This is
+  /// ignored if the object is not local yet.
+  /// \param priority The BundlePriority of the pull that requested the push.
+  /// \param chunk_size The chunk size to push with, or 0 to pick it from the
+  /// measured link to the node.
   /// \return Void.
-  void Push(const ObjectID &object_id, const NodeID &node_id);
+  void Push(const ObjectID &object_id, const NodeID &node_id,
+            const std::vector<uint64_t> &chunk_indices = {}, int64_t priority = 0,
+            uint64_t chunk_size = 0);
 
   /// Pull a bundle of objects. This will attempt to make all objects in the
   /// bundle local until the request is canceled with the returned ID.
@@ -246,6 +281,11 @@ class ObjectManager : public ObjectManagerInterface,
   /// \param Output parameter.
   void FillObjectStoreStats(rpc::GetNodeStatsReply *reply) const;
 
+  /// Populate the stats of the object transfers with each other node.
+  ///
+  /// \param Output parameter.
+  void FillObjectTransferStats(rpc::GetNodeStatsReply *reply) const;
+
   void Tick(const boost::system::error_code &e);
 
   /// Get the current object store memory usage.
@@ -259,6 +299,13 @@ class ObjectManager : public ObjectManagerInterface,
 
   bool PullManagerHasPullsQueued() const { return pull_manager_->HasPullsQueued(); }
 
+  /// See PullManager::GetObjectBytesByNode.
+  int64_t GetObjectBytesByNode(
+      const std::vector<ObjectID> &object_ids,
+      absl::flat_hash_map<NodeID, int64_t> *bytes_by_node) const {
+    return pull_manager_->GetObjectBytesByNode(object_ids, bytes_by_node);
+  }
+
  private:
   friend class TestObjectManager;
 
@@ -316,16 +363,39 @@ class ObjectManager : public ObjectManagerInterface,
   ///
   /// \param object_id The object's object id.
   /// \param node_id The remote node's id.
+  /// \param chunk_indices The chunks to push, or empty to push all chunks.
+  /// \param priority The BundlePriority of the pull that requested the push.
+  /// \param chunk_size The chunk size to push with, or 0 to pick it.
   /// \return Void.
-  void PushLocalObject(const ObjectID &object_id, const NodeID &node_id);
+  void PushLocalObject(const ObjectID &object_id, const NodeID &node_id,
+                       const std::vector<uint64_t> &chunk_indices, int64_t priority,
+                       uint64_t chunk_size);
 
   /// Pushing a known spilled object to a remote object manager.
   /// \param object_id The object's object id.
   /// \param node_id The remote node's id.
   /// \param spilled_url The url of the spilled object.
+  /// \param chunk_indices The chunks to push, or empty to push all chunks.
+  /// \param priority The BundlePriority of the pull that requested the push.
+  /// \param chunk_size The chunk size to push with, or 0 to pick it.
   /// \return Void.
   void PushFromFilesystem(const ObjectID &object_id, const NodeID &node_id,
-                          const std::string &spilled_url);
+                          const std::string &spilled_url,
+                          const std::vector<uint64_t> &chunk_indices, int64_t priority,
+                          uint64_t chunk_size);
+
+  /// Pushing an object of the compression tier to a remote object manager. The
+  /// object is decompressed into the memory of the raylet, not into plasma, so that
+  /// forwarding it doesn't evict local objects.
+  /// \param object_id The object's object id.
+  /// \param node_id The remote node's id.
+  /// \param chunk_indices The chunks to push, or empty to push all chunks.
+  /// \param priority The BundlePriority of the pull that requested the push.
+  /// \param chunk_size The chunk size to push with, or 0 to pick it.
+  /// \return Whether the push was started.
+  bool PushCompressedObject(const ObjectID &object_id, const NodeID &node_id,
+                            const std::vector<uint64_t> &chunk_indices,
+                            int64_t priority, uint64_t chunk_size);
 
   /// The internal implementation of pushing an object.
   ///
@@ -333,8 +403,11 @@ class ObjectManager : public ObjectManagerInterface,
   /// \param node_id The remote node's id.
   /// \param chunk_reader Chunk reader used to read a chunk of the object
   /// Status::OK() if the read succeeded.
+  /// \param chunk_indices The chunks to push, or empty to push all chunks.
+  /// \param priority The BundlePriority of the pull that requested the push.
   void PushObjectInternal(const ObjectID &object_id, const NodeID &node_id,
-                          std::shared_ptr<ChunkObjectReader> chunk_reader);
+                          std::shared_ptr<ChunkObjectReader> chunk_reader,
+                          const std::vector<uint64_t> &chunk_indices, int64_t priority);
 
   /// Send one chunk of the object to remote object manager
   ///
@@ -374,6 +447,7 @@ class ObjectManager : public ObjectManagerInterface,
   /// \param object_id The ID of the object that was sent.
   /// \param node_id The ID of the node that the chunk was sent to.
   /// \param chunk_index The index of the chunk.
+  /// \param chunk_bytes The size of the chunk.
   /// \param start_time_us The time when the object manager began sending the
   /// chunk.
   /// \param end_time_us The time when the object manager finished sending the
@@ -381,8 +455,8 @@ class ObjectManager : public ObjectManagerInterface,
   /// \param status The status of the send (e.g., did it succeed or fail).
   /// \return Void.
   void HandleSendFinished(const ObjectID &object_id, const NodeID &node_id,
-                          uint64_t chunk_index, double start_time_us, double end_time_us,
-                          ray::Status status);
+                          uint64_t chunk_index, uint64_t chunk_bytes,
+                          double start_time_us, double end_time_us, ray::Status status);
 
   /// Handle Push task timeout.
   void HandlePushTaskTimeout(const ObjectID &object_id, const NodeID &node_id);
@@ -404,19 +478,68 @@ class ObjectManager : public ObjectManagerInterface,
   /// \param metadata_size Metadata size
   /// \param chunk_index Chunk index
   /// \param data Chunk data
+  /// \param chunk_size The chunk size the sender split the object into, or 0 for
+  /// the default chunk size
   /// \return Whether the chunk was successfully written into the local object
   /// store. This can fail if the chunk was already received in the past, or if
   /// the object is no longer being actively pulled.
   bool ReceiveObjectChunk(const NodeID &node_id, const ObjectID &object_id,
                           const rpc::Address &owner_address, uint64_t data_size,
                           uint64_t metadata_size, uint64_t chunk_index,
-                          const std::string &data);
+                          const std::vector<absl::Span<const uint8_t>> &data,
+                          uint64_t chunk_size = 0);
+
+  /// Receive the chunk of a push request and record the outcome.
+  ///
+  /// \param request Push request, whose data field is ignored
+  /// \param data Chunk data
+  void ReceivePushedChunk(const rpc::PushRequest &request,
+                          const std::vector<absl::Span<const uint8_t>> &data);
 
   /// Send pull request
   ///
   /// \param object_id Object id
   /// \param client_id Remote server client id
-  void SendPullRequest(const ObjectID &object_id, const NodeID &client_id);
+  /// \param chunk_indices The chunks to pull, or empty to pull all chunks
+  void SendPullRequest(const ObjectID &object_id, const NodeID &client_id,
+                       const std::vector<uint64_t> &chunk_indices = {});
+
+  /// Redirect a pull request to one of the nodes that this node is pushing the
+  /// object to already, if there are object_manager_max_pushes_per_object of them.
+  ///
+  /// \param object_id Object id
+  /// \param node_id The node that pulls the object
+  /// \param reply The reply to set the node to pull from instead in
+  /// \return Whether the request was redirected
+  bool TryRedirectPull(const ObjectID &object_id, const NodeID &node_id,
+                       rpc::PullReply *reply);
+
+  /// Serve a pull request for an object that is still being received, by
+  /// forwarding each chunk once it's received.
+  ///
+  /// \param object_id Object id
+  /// \param node_id The node that pulls the object
+  /// \param chunk_indices The chunks to forward, or empty to forward all chunks
+  /// \param chunk_size The chunk size the node asked for, or 0 for any
+  /// \return False if the object isn't being received, or with another chunk size
+  bool TryRelayObject(const ObjectID &object_id, const NodeID &node_id,
+                      const std::vector<uint64_t> &chunk_indices, uint64_t chunk_size);
+
+  /// Forward the chunks of objects that are being received to the nodes that
+  /// pull them from here. Called once a chunk is written to the local object store.
+  ///
+  /// \param object_id Object id
+  /// \param chunk_index Chunk index
+  void OnObjectChunkReceived(const ObjectID &object_id, uint64_t chunk_index);
+
+  /// Pull the chunks of an object that are still missing from several nodes at
+  /// once, each node sending an equal share of them.
+  ///
+  /// \param object_id Object id
+  /// \param node_ids Remote nodes that have the object
+  /// \param object_size The sum of the object size and metadata size
+  void SendStripedPullRequest(const ObjectID &object_id,
+                              const std::vector<NodeID> &node_ids, size_t object_size);
 
   /// Get the rpc client according to the node ID
   ///
@@ -465,6 +588,28 @@ class ObjectManager : public ObjectManagerInterface,
       ObjectID, std::unordered_map<NodeID, std::unique_ptr<boost::asio::deadline_timer>>>
       unfulfilled_push_requests_;
 
+  /// The chunks of an object being received that a node pulls from here.
+  struct RelayState {
+    /// The ID of the push of the forwarded chunks.
+    UniqueID push_id = UniqueID::FromRandom();
+    /// Whether the node asked for each chunk.
+    std::vector<bool> wanted;
+    /// Whether each chunk was forwarded to the node.
+    std::vector<bool> sent;
+  };
+
+  /// Forward a received chunk to a node that pulls the object from here.
+  void ForwardReceivedChunk(const ObjectID &object_id, const NodeID &node_id,
+                            uint64_t chunk_index, RelayState *state);
+
+  /// The nodes that pull objects from here while they are still being received.
+  /// Once an object is local, the chunks that weren't forwarded yet are pushed.
+  absl::flat_hash_map<ObjectID, absl::flat_hash_map<NodeID, RelayState>>
+      relayed_objects_;
+
+  /// Used to pick the nodes that pull requests are redirected to.
+  std::mt19937_64 gen_{std::random_device()()};
+
   /// The gPRC server.
   rpc::GrpcServer object_manager_server_;
 
@@ -485,12 +630,22 @@ class ObjectManager : public ObjectManagerInterface,
   /// This returns the empty string if the object was not spilled locally.
   std::function<std::string(const ObjectID &)> get_spilled_object_url_;
 
+  /// Callback to read an object of the compression tier out of plasma.
+  const ReadCompressedObjectCallback read_compressed_object_;
+
+  /// Readers over decompressed objects that are still being pushed, so that
+  /// concurrent pushes of the same object share one decompressed copy.
+  absl::flat_hash_map<ObjectID, std::weak_ptr<IObjectReader>> compressed_object_readers_;
+
   /// Pull manager retry timer .
   boost::asio::deadline_timer pull_retry_timer_;
 
   /// Object push manager.
   std::unique_ptr<PushManager> push_manager_;
 
+  /// Picks the chunk size of pushes from the measured links to the other nodes.
+  ChunkSizePolicy chunk_size_policy_;
+
   /// Object pull manager.
   std::unique_ptr<PullManager> pull_manager_;
 
@@ -512,6 +667,13 @@ class ObjectManager : public ObjectManagerInterface,
   /// create the object in plasma. This is usually due to out-of-memory in
   /// plasma.
   size_t num_chunks_received_failed_due_to_plasma_ = 0;
+
+  /// Protects transfer_stats_, which is updated from the RPC threads.
+  mutable absl::Mutex transfer_stats_mutex_;
+
+  /// The object transfers with each other node.
+  absl::flat_hash_map<NodeID, rpc::ObjectTransferStats> transfer_stats_
+      GUARDED_BY(transfer_stats_mutex_);
 };
 
 }  // namespace ray
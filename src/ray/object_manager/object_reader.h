@@ -51,5 +51,14 @@ class IObjectReader {
   /// \return bool.
   virtual bool ReadFromMetadataSection(uint64_t offset, uint64_t size,
                                        char *output) const = 0;
+
+  /// Return the data section if the object is in memory, so that it can be sent
+  /// without a copy. The memory stays valid as long as the reader is alive.
+  ///
+  /// \return nullptr if the object is not in memory.
+  virtual const uint8_t *GetDataPointer() const { return nullptr; }
+
+  /// Return the metadata section if the object is in memory, see GetDataPointer.
+  virtual const uint8_t *GetMetadataPointer() const { return nullptr; }
 };
 }  // namespace ray
@@ -14,7 +14,10 @@
 
 #include "ray/object_manager/ownership_based_object_directory.h"
 
+#include "ray/common/asio/asio_util.h"
+#include "ray/common/ray_config.h"
 #include "ray/stats/stats.h"
+#include "ray/util/util.h"
 
 namespace ray {
 
@@ -123,13 +126,19 @@ ray::Status OwnershipBasedObjectDirectory::ReportObjectAdded(
                    << "This should only happen for Plasma store warmup objects.";
     return Status::OK();
   }
+  metrics_num_object_locations_added_++;
+  // Drop cached locations that predate this update.
+  location_cache_.erase(object_id);
+  if (RayConfig::instance().object_directory_max_location_report_batch_size() > 0) {
+    BufferLocationUpdate(object_id, node_id, owner_address, /*added=*/true);
+    return Status::OK();
+  }
+
   rpc::AddObjectLocationOwnerRequest request;
   request.set_intended_worker_id(object_info.owner_worker_id.Binary());
   request.set_object_id(object_id.Binary());
   request.set_node_id(node_id.Binary());
 
-  metrics_num_object_locations_added_++;
-
   auto operation = [rpc_client, request, worker_id, object_id,
                     node_id](const SequencerDoneCallback &done_callback) {
     rpc_client->AddObjectLocationOwner(
@@ -163,13 +172,18 @@ ray::Status OwnershipBasedObjectDirectory::ReportObjectRemoved(
     return Status::OK();
   }
 
+  metrics_num_object_locations_removed_++;
+  location_cache_.erase(object_id);
+  if (RayConfig::instance().object_directory_max_location_report_batch_size() > 0) {
+    BufferLocationUpdate(object_id, node_id, owner_address, /*added=*/false);
+    return Status::OK();
+  }
+
   rpc::RemoveObjectLocationOwnerRequest request;
   request.set_intended_worker_id(worker_id.Binary());
   request.set_object_id(object_id.Binary());
   request.set_node_id(node_id.Binary());
 
-  metrics_num_object_locations_removed_++;
-
   auto operation = [rpc_client, request, worker_id, object_id,
                     node_id](const SequencerDoneCallback &done_callback) {
     rpc_client->RemoveObjectLocationOwner(
@@ -191,6 +205,101 @@ ray::Status OwnershipBasedObjectDirectory::ReportObjectRemoved(
   return Status::OK();
 };
 
+void OwnershipBasedObjectDirectory::BufferLocationUpdate(
+    const ObjectID &object_id, const NodeID &node_id, const rpc::Address &owner_address,
+    bool added) {
+  const auto owner_id = WorkerID::FromBinary(owner_address.worker_id());
+  auto &owner_state = owner_location_reports_[owner_id];
+  owner_state.owner_address = owner_address;
+  // An update replaces the pending one of the same object location, e.g. an object
+  // that is evicted right after it was sealed is only reported as removed.
+  auto it = owner_state.latest_update_index.find(object_id);
+  if (it != owner_state.latest_update_index.end() &&
+      owner_state.pending_updates[it->second].node_id() == node_id.Binary()) {
+    owner_state.pending_updates[it->second].set_added(added);
+  } else {
+    owner_state.latest_update_index[object_id] = owner_state.pending_updates.size();
+    rpc::ObjectLocationUpdate update;
+    update.set_object_id(object_id.Binary());
+    update.set_node_id(node_id.Binary());
+    update.set_added(added);
+    owner_state.pending_updates.push_back(std::move(update));
+  }
+
+  if (owner_state.request_in_flight) {
+    // The updates are sent once the request in flight is done.
+    return;
+  }
+  if (static_cast<int64_t>(owner_state.pending_updates.size()) >=
+      RayConfig::instance().object_directory_max_location_report_batch_size()) {
+    SendLocationUpdates(owner_id);
+  } else if (!owner_state.flush_scheduled) {
+    owner_state.flush_scheduled = true;
+    execute_after(
+        io_service_,
+        [this, owner_id]() {
+          auto it = owner_location_reports_.find(owner_id);
+          if (it != owner_location_reports_.end()) {
+            it->second.flush_scheduled = false;
+            SendLocationUpdates(owner_id);
+          }
+        },
+        RayConfig::instance().object_directory_location_report_interval_ms());
+  }
+}
+
+void OwnershipBasedObjectDirectory::SendLocationUpdates(const WorkerID &owner_id) {
+  auto it = owner_location_reports_.find(owner_id);
+  RAY_CHECK(it != owner_location_reports_.end());
+  auto &owner_state = it->second;
+  if (owner_state.request_in_flight) {
+    return;
+  }
+  if (owner_state.pending_updates.empty()) {
+    if (!owner_state.flush_scheduled) {
+      owner_location_reports_.erase(it);
+    }
+    return;
+  }
+  auto rpc_client = GetClient(owner_state.owner_address);
+  RAY_CHECK(rpc_client != nullptr);
+
+  // Send up to a batch of the updates, oldest first. Only one request per owner is in
+  // flight, so that the owner applies the updates in order.
+  const size_t batch_size = std::min<size_t>(
+      owner_state.pending_updates.size(),
+      RayConfig::instance().object_directory_max_location_report_batch_size());
+  rpc::UpdateObjectLocationBatchRequest request;
+  request.set_intended_worker_id(owner_state.owner_address.worker_id());
+  for (size_t i = 0; i < batch_size; i++) {
+    *request.add_updates() = std::move(owner_state.pending_updates[i]);
+  }
+  owner_state.pending_updates.erase(owner_state.pending_updates.begin(),
+                                    owner_state.pending_updates.begin() + batch_size);
+  owner_state.latest_update_index.clear();
+  for (size_t i = 0; i < owner_state.pending_updates.size(); i++) {
+    owner_state.latest_update_index[ObjectID::FromBinary(
+        owner_state.pending_updates[i].object_id())] = i;
+  }
+  owner_state.request_in_flight = true;
+
+  const int num_updates = request.updates_size();
+  rpc_client->UpdateObjectLocationBatch(
+      request, [this, owner_id, num_updates](
+                   Status status, const rpc::UpdateObjectLocationBatchReply &reply) {
+        if (!status.ok()) {
+          RAY_LOG(DEBUG) << "Worker " << owner_id << " failed to update " << num_updates
+                         << " object locations, the owner has most likely died: "
+                         << status.ToString();
+        }
+        auto it = owner_location_reports_.find(owner_id);
+        RAY_CHECK(it != owner_location_reports_.end());
+        it->second.request_in_flight = false;
+        // Updates buffered while the request was in flight have waited long enough.
+        SendLocationUpdates(owner_id);
+      });
+}
+
 void OwnershipBasedObjectDirectory::ObjectLocationSubscriptionCallback(
     const rpc::WorkerObjectLocationsPubMessage &location_info, const ObjectID &object_id,
     bool location_lookup_failed) {
@@ -202,6 +311,8 @@ void OwnershipBasedObjectDirectory::ObjectLocationSubscriptionCallback(
   }
   // Once this flag is set to true, it should never go back to false.
   it->second.subscribed = true;
+  // The subscription is now the source of truth for the object's locations.
+  location_cache_.erase(object_id);
 
   // Update entries for this object.
   auto location_updated = UpdateObjectLocations(
@@ -315,6 +426,13 @@ ray::Status OwnershipBasedObjectDirectory::UnsubscribeObjectLocations(
   }
   entry->second.callbacks.erase(callback_id);
   if (entry->second.callbacks.empty()) {
+    if (entry->second.subscribed) {
+      // The subscription kept the locations up to date until now, so they can serve
+      // lookups for a while.
+      CacheLocations(object_id, entry->second.current_object_locations,
+                     entry->second.spilled_url, entry->second.spilled_node_id,
+                     entry->second.object_size);
+    }
     object_location_subscriber_->Unsubscribe(
         rpc::ChannelType::WORKER_OBJECT_LOCATIONS_CHANNEL, entry->second.owner_address,
         object_id.Binary());
@@ -345,43 +463,112 @@ ray::Status OwnershipBasedObjectDirectory::LookupLocations(
           callback(object_id, locations, spilled_url, spilled_node_id, object_size);
         },
         "ObjectDirectory.LookupLocations");
-  } else {
-    WorkerID worker_id = WorkerID::FromBinary(owner_address.worker_id());
-    std::shared_ptr<rpc::CoreWorkerClient> rpc_client = GetClient(owner_address);
-    if (rpc_client == nullptr) {
-      RAY_LOG(WARNING) << "Object " << object_id << " does not have owner. "
-                       << "LookupLocations returns an empty list of locations.";
-      // We post the callback to the event loop in order to avoid mutating data structures
-      // shared with the caller and potentially invalidating caller iterators.
-      // See https://github.com/ray-project/ray/issues/2959.
-      io_service_.post(
-          [callback, object_id]() {
-            callback(object_id, std::unordered_set<NodeID>(), "", NodeID::Nil(), 0);
-          },
-          "ObjectDirectory.LookupLocations");
-      return Status::OK();
-    }
+    return Status::OK();
+  }
 
-    rpc::GetObjectLocationsOwnerRequest request;
-    auto object_location_request = request.mutable_object_location_request();
-    object_location_request->set_intended_worker_id(owner_address.worker_id());
-    object_location_request->set_object_id(object_id.Binary());
+  EvictExpiredLocations();
+  auto cached = location_cache_.find(object_id);
+  if (cached != location_cache_.end()) {
+    // The locations were learned recently, so serve them without asking the owner.
+    auto &locations = cached->second.node_ids;
+    auto &spilled_url = cached->second.spilled_url;
+    auto &spilled_node_id = cached->second.spilled_node_id;
+    auto object_size = cached->second.object_size;
+    io_service_.post(
+        [callback, object_id, locations, spilled_url, spilled_node_id, object_size]() {
+          callback(object_id, locations, spilled_url, spilled_node_id, object_size);
+        },
+        "ObjectDirectory.LookupLocations");
+    return Status::OK();
+  }
+
+  WorkerID worker_id = WorkerID::FromBinary(owner_address.worker_id());
+  if (GetClient(owner_address) == nullptr) {
+    RAY_LOG(WARNING) << "Object " << object_id << " does not have owner. "
+                     << "LookupLocations returns an empty list of locations.";
+    // We post the callback to the event loop in order to avoid mutating data structures
+    // shared with the caller and potentially invalidating caller iterators.
+    // See https://github.com/ray-project/ray/issues/2959.
+    io_service_.post(
+        [callback, object_id]() {
+          callback(object_id, std::unordered_set<NodeID>(), "", NodeID::Nil(), 0);
+        },
+        "ObjectDirectory.LookupLocations");
+    return Status::OK();
+  }
+
+  // Lookups of objects of the same owner are sent in batches. The request is sent
+  // from the event loop, so that all lookups made in the current handler share it.
+  auto &owner_state = owner_lookups_[worker_id];
+  owner_state.owner_address = owner_address;
+  owner_state.pending_lookups.emplace_back(object_id, callback);
+  if (!owner_state.request_in_flight) {
+    owner_state.request_in_flight = true;
+    io_service_.post([this, worker_id]() { SendLocationLookups(worker_id); },
+                     "ObjectDirectory.SendLocationLookups");
+  }
+  return Status::OK();
+}
 
-    rpc_client->GetObjectLocationsOwner(
-        request, [this, worker_id, object_id, callback](
-                     Status status, const rpc::GetObjectLocationsOwnerReply &reply) {
+void OwnershipBasedObjectDirectory::SendLocationLookups(const WorkerID &owner_id) {
+  auto it = owner_lookups_.find(owner_id);
+  RAY_CHECK(it != owner_lookups_.end());
+  auto &owner_state = it->second;
+  if (owner_state.pending_lookups.empty()) {
+    owner_lookups_.erase(it);
+    return;
+  }
+  auto rpc_client = GetClient(owner_state.owner_address);
+  RAY_CHECK(rpc_client != nullptr);
+
+  // Send up to a batch of the lookups, oldest first.
+  const size_t batch_size = std::min<size_t>(
+      owner_state.pending_lookups.size(),
+      std::max<int64_t>(RayConfig::instance().object_directory_max_lookup_batch_size(),
+                        1));
+  auto lookups = std::make_shared<std::vector<std::pair<ObjectID, OnLocationsFound>>>(
+      std::make_move_iterator(owner_state.pending_lookups.begin()),
+      std::make_move_iterator(owner_state.pending_lookups.begin() + batch_size));
+  owner_state.pending_lookups.erase(owner_state.pending_lookups.begin(),
+                                    owner_state.pending_lookups.begin() + batch_size);
+
+  rpc::GetObjectLocationsOwnerRequest request;
+  request.set_intended_worker_id(owner_state.owner_address.worker_id());
+  for (const auto &lookup : *lookups) {
+    request.add_object_ids(lookup.first.Binary());
+  }
+
+  rpc_client->GetObjectLocationsOwner(
+      request, [this, owner_id, lookups](Status status,
+                                         const rpc::GetObjectLocationsOwnerReply &reply) {
+        if (status.ok() &&
+            reply.object_location_infos_size() != static_cast<int>(lookups->size())) {
+          status = Status::Invalid("Owner returned " +
+                                   std::to_string(reply.object_location_infos_size()) +
+                                   " locations for " + std::to_string(lookups->size()) +
+                                   " objects");
+        }
+        for (size_t i = 0; i < lookups->size(); i++) {
+          const auto &object_id = (*lookups)[i].first;
+          const auto &callback = (*lookups)[i].second;
           std::unordered_set<NodeID> node_ids;
           std::string spilled_url;
           NodeID spilled_node_id;
           size_t object_size = 0;
 
           if (!status.ok()) {
-            RAY_LOG(ERROR) << "Worker " << worker_id << " failed to get the location for "
+            RAY_LOG(ERROR) << "Worker " << owner_id << " failed to get the location for "
                            << object_id << status.ToString();
             mark_as_failed_(object_id, rpc::ErrorType::OBJECT_UNRECONSTRUCTABLE);
+          } else if (reply.object_location_infos(i).ref_removed()) {
+            RAY_LOG(ERROR) << "Worker " << owner_id << " failed to get the location for "
+                           << object_id << ", the object has been freed.";
+            mark_as_failed_(object_id, rpc::ErrorType::OBJECT_UNRECONSTRUCTABLE);
           } else {
-            UpdateObjectLocations(reply.object_location_info(), gcs_client_, &node_ids,
+            UpdateObjectLocations(reply.object_location_infos(i), gcs_client_, &node_ids,
                                   &spilled_url, &spilled_node_id, &object_size);
+            CacheLocations(object_id, node_ids, spilled_url, spilled_node_id,
+                           object_size);
           }
           RAY_LOG(DEBUG) << "Looked up locations for " << object_id
                          << ", returning: " << node_ids.size()
@@ -393,9 +580,42 @@ ray::Status OwnershipBasedObjectDirectory::LookupLocations(
           // client's lookup callback stack.
           // See https://github.com/ray-project/ray/issues/2959.
           callback(object_id, node_ids, spilled_url, spilled_node_id, object_size);
-        });
+        }
+        // Send the lookups that were made while this request was in flight.
+        SendLocationLookups(owner_id);
+      });
+}
+
+void OwnershipBasedObjectDirectory::CacheLocations(
+    const ObjectID &object_id, const std::unordered_set<NodeID> &node_ids,
+    const std::string &spilled_url, const NodeID &spilled_node_id, size_t object_size) {
+  const int64_t ttl_ms = RayConfig::instance().object_directory_location_cache_ttl_ms();
+  if (ttl_ms <= 0) {
+    return;
+  }
+  const int64_t expiration_time_ms = current_time_ms() + ttl_ms;
+  auto &entry = location_cache_[object_id];
+  entry.node_ids = node_ids;
+  entry.spilled_url = spilled_url;
+  entry.spilled_node_id = spilled_node_id;
+  entry.object_size = object_size;
+  entry.expiration_time_ms = expiration_time_ms;
+  location_cache_expirations_.emplace_back(expiration_time_ms, object_id);
+  EvictExpiredLocations();
+}
+
+void OwnershipBasedObjectDirectory::EvictExpiredLocations() {
+  const int64_t now_ms = current_time_ms();
+  while (!location_cache_expirations_.empty() &&
+         location_cache_expirations_.front().first <= now_ms) {
+    const auto &object_id = location_cache_expirations_.front().second;
+    auto it = location_cache_.find(object_id);
+    // Only evict the entry if it wasn't refreshed since.
+    if (it != location_cache_.end() && it->second.expiration_time_ms <= now_ms) {
+      location_cache_.erase(it);
+    }
+    location_cache_expirations_.pop_front();
   }
-  return Status::OK();
 }
 
 void OwnershipBasedObjectDirectory::LookupRemoteConnectionInfo(
@@ -424,6 +644,14 @@ OwnershipBasedObjectDirectory::LookupAllRemoteConnections() const {
 }
 
 void OwnershipBasedObjectDirectory::HandleNodeRemoved(const NodeID &node_id) {
+  for (auto it = location_cache_.begin(); it != location_cache_.end();) {
+    if (it->second.node_ids.count(node_id) > 0 ||
+        it->second.spilled_node_id == node_id) {
+      location_cache_.erase(it++);
+    } else {
+      it++;
+    }
+  }
   for (auto &listener : listeners_) {
     const ObjectID &object_id = listener.first;
     if (listener.second.current_object_locations.count(node_id) > 0) {
@@ -480,6 +708,8 @@ std::string OwnershipBasedObjectDirectory::DebugString() const {
   result << std::fixed << std::setprecision(3);
   result << "OwnershipBasedObjectDirectory:";
   result << "\n- num listeners: " << listeners_.size();
+  result << "\n- num cached locations: " << location_cache_.size();
+  result << "\n- num owners with pending lookups: " << owner_lookups_.size();
   result << "\n- cumulative location updates: "
          << cum_metrics_num_object_location_updates_;
   result << "\n- num location updates per second: "
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -101,6 +102,42 @@ class OwnershipBasedObjectDirectory : public IObjectDirectory {
     rpc::Address owner_address;
   };
 
+  /// Location lookups of the objects owned by one worker.
+  struct OwnerLookupState {
+    /// The address of the owner.
+    rpc::Address owner_address;
+    /// The objects to look up in the next request, with the callbacks to call
+    /// once their locations are known.
+    std::vector<std::pair<ObjectID, OnLocationsFound>> pending_lookups;
+    /// Whether a request to the owner is in flight or about to be sent.
+    bool request_in_flight = false;
+  };
+
+  /// Location updates of the objects owned by one worker, to report to it.
+  struct OwnerLocationReportState {
+    /// The address of the owner.
+    rpc::Address owner_address;
+    /// The updates to send in the next request, in the order they happened.
+    std::vector<rpc::ObjectLocationUpdate> pending_updates;
+    /// The index of the latest pending update of each object.
+    absl::flat_hash_map<ObjectID, size_t> latest_update_index;
+    /// Whether a request to the owner is in flight.
+    bool request_in_flight = false;
+    /// Whether a flush of the pending updates is scheduled.
+    bool flush_scheduled = false;
+  };
+
+  /// Locations of an object that are served without asking its owner until they
+  /// expire.
+  struct CachedLocations {
+    std::unordered_set<NodeID> node_ids;
+    std::string spilled_url;
+    NodeID spilled_node_id;
+    size_t object_size = 0;
+    /// The time in milliseconds at which the entry expires.
+    int64_t expiration_time_ms = 0;
+  };
+
   /// Reference to the event loop.
   instrumented_io_context &io_service_;
   /// Reference to the gcs client.
@@ -122,10 +159,43 @@ class OwnershipBasedObjectDirectory : public IObjectDirectory {
   /// Used to order add/remove updates for a single ObjectID,
   /// so we don't lose updates at the directory.
   Sequencer<ObjectID> sequencer_;
+  /// Pending location lookups, by the ID of the owner.
+  absl::flat_hash_map<WorkerID, OwnerLookupState> owner_lookups_;
+  /// Buffered location updates, by the ID of the owner.
+  absl::flat_hash_map<WorkerID, OwnerLocationReportState> owner_location_reports_;
+  /// Recently learned locations of objects that aren't subscribed to.
+  absl::flat_hash_map<ObjectID, CachedLocations> location_cache_;
+  /// The cache entries in the order they were inserted, which is also the order in
+  /// which they expire. An object may appear more than once if it was re-inserted.
+  std::deque<std::pair<int64_t, ObjectID>> location_cache_expirations_;
 
   /// Get or create the rpc client in the worker_rpc_clients.
   std::shared_ptr<rpc::CoreWorkerClient> GetClient(const rpc::Address &owner_address);
 
+  /// Send the next batch of pending location lookups to an owner, if there are any.
+  ///
+  /// \param owner_id The ID of the owner.
+  void SendLocationLookups(const WorkerID &owner_id);
+
+  /// Buffer a location update to report to the owner of the object in a batch.
+  void BufferLocationUpdate(const ObjectID &object_id, const NodeID &node_id,
+                            const rpc::Address &owner_address, bool added);
+
+  /// Send the pending location updates to an owner, if there are any and no request
+  /// to the owner is in flight.
+  ///
+  /// \param owner_id The ID of the owner.
+  void SendLocationUpdates(const WorkerID &owner_id);
+
+  /// Cache the locations of an object, if the cache is enabled.
+  void CacheLocations(const ObjectID &object_id,
+                      const std::unordered_set<NodeID> &node_ids,
+                      const std::string &spilled_url, const NodeID &spilled_node_id,
+                      size_t object_size);
+
+  /// Drop the cache entries that have expired.
+  void EvictExpiredLocations();
+
   /// Internal callback function used by object location subscription.
   void ObjectLocationSubscriptionCallback(
       const rpc::WorkerObjectLocationsPubMessage &location_info,
@@ -23,6 +23,7 @@
 
 #include <algorithm>
 #include <deque>
+#include <list>
 #include <mutex>
 #include <tuple>
 #include <unordered_map>
@@ -95,6 +96,11 @@ struct ObjectInUseEntry {
   PlasmaObject object;
   /// A flag representing whether the object has been sealed.
   bool is_sealed;
+  /// Whether the client released the object, but didn't tell the store yet. The
+  /// count is zero then.
+  bool release_delayed = false;
+  /// The position of the object in the delayed releases, if release_delayed.
+  std::list<ObjectID>::iterator delayed_release_it;
 };
 
 class PlasmaClient::Impl : public std::enable_shared_from_this<PlasmaClient::Impl> {
@@ -114,7 +120,9 @@ class PlasmaClient::Impl : public std::enable_shared_from_this<PlasmaClient::Imp
                                 const ray::rpc::Address &owner_address, int64_t data_size,
                                 const uint8_t *metadata, int64_t metadata_size,
                                 std::shared_ptr<Buffer> *data, fb::ObjectSource source,
-                                int device_num = 0);
+                                int device_num = 0,
+                                fb::CreatePriority priority =
+                                    fb::CreatePriority::UserPut);
 
   Status RetryCreate(const ObjectID &object_id, uint64_t request_id,
                      const uint8_t *metadata, uint64_t *retry_with_request_id,
@@ -126,8 +134,18 @@ class PlasmaClient::Impl : public std::enable_shared_from_this<PlasmaClient::Imp
                               std::shared_ptr<Buffer> *data, fb::ObjectSource source,
                               int device_num);
 
+  Status CreateBatch(const std::vector<ObjectID> &object_ids,
+                     const ray::rpc::Address &owner_address,
+                     const std::vector<int64_t> &data_sizes,
+                     const std::vector<const uint8_t *> &metadata,
+                     const std::vector<int64_t> &metadata_sizes,
+                     std::vector<std::shared_ptr<Buffer>> *data,
+                     std::vector<Status> *statuses, fb::ObjectSource source,
+                     int device_num, fb::CreatePriority priority);
+
   Status Get(const std::vector<ObjectID> &object_ids, int64_t timeout_ms,
-             std::vector<ObjectBuffer> *object_buffers, bool is_from_worker);
+             std::vector<ObjectBuffer> *object_buffers, bool is_from_worker,
+             int64_t num_objects_to_wait_for);
 
   Status Get(const ObjectID *object_ids, int64_t num_objects, int64_t timeout_ms,
              ObjectBuffer *object_buffers, bool is_from_worker);
@@ -140,6 +158,8 @@ class PlasmaClient::Impl : public std::enable_shared_from_this<PlasmaClient::Imp
 
   Status Seal(const ObjectID &object_id);
 
+  Status SealBatch(const std::vector<ObjectID> &object_ids);
+
   Status Delete(const std::vector<ObjectID> &object_ids);
 
   Status Evict(int64_t num_bytes, int64_t &num_bytes_evicted);
@@ -158,6 +178,12 @@ class PlasmaClient::Impl : public std::enable_shared_from_this<PlasmaClient::Imp
                            uint64_t *retry_with_request_id,
                            std::shared_ptr<Buffer> *data);
 
+  /// Helper method to map and cache an object that the store created for this
+  /// client.
+  void MapCreatedObject(const ObjectID &object_id, const uint8_t *metadata,
+                        PlasmaObject *object, MEMFD_TYPE store_fd, int64_t mmap_size,
+                        std::shared_ptr<Buffer> *data);
+
   /// Check if store_fd has already been received from the store. If yes,
   /// return it. Otherwise, receive it from the store (see analogous logic
   /// in store.cc).
@@ -176,13 +202,32 @@ class PlasmaClient::Impl : public std::enable_shared_from_this<PlasmaClient::Imp
   Status GetBuffers(const ObjectID *object_ids, int64_t num_objects, int64_t timeout_ms,
                     const std::function<std::shared_ptr<Buffer>(
                         const ObjectID &, const std::shared_ptr<Buffer> &)> &wrap_buffer,
-                    ObjectBuffer *object_buffers, bool is_from_worker);
+                    ObjectBuffer *object_buffers, bool is_from_worker,
+                    int64_t num_objects_to_wait_for);
 
   uint8_t *LookupMmappedFile(MEMFD_TYPE store_fd_val);
 
   void IncrementObjectCount(const ObjectID &object_id, PlasmaObject *object,
                             bool is_sealed);
 
+  /// Tell the store that the client no longer uses an object, whose count is zero.
+  Status SendRelease(const ObjectID &object_id);
+
+  /// Send the delayed releases, the least recently released first, until the delayed
+  /// objects take at most `max_bytes`.
+  Status FlushDelayedReleases(int64_t max_bytes);
+
+  /// Remove an object from the delayed releases, without telling the store.
+  void CancelDelayedRelease(ObjectInUseEntry *object_entry);
+
+  /// Ask the store for shared memory rings to send the Get, Release and Contains
+  /// requests through. The client keeps using the socket if the store can't set
+  /// them up.
+  ///
+  /// \param capacity The capacity in bytes of each ring.
+  /// \return The return status.
+  Status SetupRings(int64_t capacity);
+
   /// The boost::asio IO context for the client.
   instrumented_io_context main_service_;
   /// The connection to the store service.
@@ -204,6 +249,11 @@ class PlasmaClient::Impl : public std::enable_shared_from_this<PlasmaClient::Imp
   int64_t store_capacity_;
   /// A hash set to record the ids that users want to delete but still in use.
   std::unordered_set<ObjectID> deletion_cache_;
+  /// The sealed objects that were released but are kept in objects_in_use_, so that
+  /// getting them again is served locally. The least recently released first.
+  std::list<ObjectID> delayed_releases_;
+  /// The total size of the objects in delayed_releases_.
+  int64_t delayed_release_bytes_ = 0;
   /// A mutex which protects this class.
   std::recursive_mutex client_mutex_;
 };
@@ -249,7 +299,7 @@ bool PlasmaClient::Impl::IsInUse(const ObjectID &object_id) {
   std::lock_guard<std::recursive_mutex> guard(client_mutex_);
 
   const auto elem = objects_in_use_.find(object_id);
-  return (elem != objects_in_use_.end());
+  return (elem != objects_in_use_.end() && !elem->second->release_delayed);
 }
 
 void PlasmaClient::Impl::IncrementObjectCount(const ObjectID &object_id,
@@ -268,7 +318,12 @@ void PlasmaClient::Impl::IncrementObjectCount(const ObjectID &object_id,
     object_entry = objects_in_use_[object_id].get();
   } else {
     object_entry = elem->second.get();
-    RAY_CHECK(object_entry->count > 0);
+    if (object_entry->release_delayed) {
+      // The store still counts the object as used by this client.
+      CancelDelayedRelease(object_entry);
+    } else {
+      RAY_CHECK(object_entry->count > 0);
+    }
   }
   // Increment the count of the number of instances of this object that are
   // being used by this client. The corresponding decrement should happen in
@@ -304,18 +359,26 @@ Status PlasmaClient::Impl::HandleCreateReply(const ObjectID &object_id,
 
   // If the CreateReply included an error, then the store will not send a file
   // descriptor.
-  if (object.device_num == 0) {
+  MapCreatedObject(object_id, metadata, &object, store_fd, mmap_size, data);
+  return Status::OK();
+}
+
+void PlasmaClient::Impl::MapCreatedObject(const ObjectID &object_id,
+                                          const uint8_t *metadata, PlasmaObject *object,
+                                          MEMFD_TYPE store_fd, int64_t mmap_size,
+                                          std::shared_ptr<Buffer> *data) {
+  if (object->device_num == 0) {
     // The metadata should come right after the data.
-    RAY_CHECK(object.metadata_offset == object.data_offset + object.data_size);
+    RAY_CHECK(object->metadata_offset == object->data_offset + object->data_size);
     *data = std::make_shared<PlasmaMutableBuffer>(
-        shared_from_this(), GetStoreFdAndMmap(store_fd, mmap_size) + object.data_offset,
-        object.data_size);
+        shared_from_this(), GetStoreFdAndMmap(store_fd, mmap_size) + object->data_offset,
+        object->data_size);
     // If plasma_create is being called from a transfer, then we will not copy the
     // metadata here. The metadata will be written along with the data streamed
     // from the transfer.
     if (metadata != NULL) {
       // Copy the metadata to the buffer.
-      memcpy((*data)->Data() + object.data_size, metadata, object.metadata_size);
+      memcpy((*data)->Data() + object->data_size, metadata, object->metadata_size);
     }
   } else {
     RAY_LOG(FATAL) << "GPU is not enabled.";
@@ -324,19 +387,18 @@ Status PlasmaClient::Impl::HandleCreateReply(const ObjectID &object_id,
   // Increment the count of the number of instances of this object that this
   // client is using. A call to PlasmaClient::Release is required to decrement
   // this count. Cache the reference to the object.
-  IncrementObjectCount(object_id, &object, false);
+  IncrementObjectCount(object_id, object, false);
   // We increment the count a second time (and the corresponding decrement will
   // happen in a PlasmaClient::Release call in plasma_seal) so even if the
   // buffer returned by PlasmaClient::Create goes out of scope, the object does
   // not get released before the call to PlasmaClient::Seal happens.
-  IncrementObjectCount(object_id, &object, false);
-  return Status::OK();
+  IncrementObjectCount(object_id, object, false);
 }
 
 Status PlasmaClient::Impl::CreateAndSpillIfNeeded(
     const ObjectID &object_id, const ray::rpc::Address &owner_address, int64_t data_size,
     const uint8_t *metadata, int64_t metadata_size, std::shared_ptr<Buffer> *data,
-    fb::ObjectSource source, int device_num) {
+    fb::ObjectSource source, int device_num, fb::CreatePriority priority) {
   std::unique_lock<std::recursive_mutex> guard(client_mutex_);
   uint64_t retry_with_request_id = 0;
 
@@ -344,7 +406,7 @@ Status PlasmaClient::Impl::CreateAndSpillIfNeeded(
                  << data_size << " and metadata size " << metadata_size;
   RAY_RETURN_NOT_OK(SendCreateRequest(store_conn_, object_id, owner_address, data_size,
                                       metadata_size, source, device_num,
-                                      /*try_immediately=*/false));
+                                      /*try_immediately=*/false, priority));
   Status status = HandleCreateReply(object_id, metadata, &retry_with_request_id, data);
 
   while (retry_with_request_id > 0) {
@@ -381,15 +443,68 @@ Status PlasmaClient::Impl::TryCreateImmediately(
                  << data_size << " and metadata size " << metadata_size;
   RAY_RETURN_NOT_OK(SendCreateRequest(store_conn_, object_id, owner_address, data_size,
                                       metadata_size, source, device_num,
-                                      /*try_immediately=*/true));
+                                      /*try_immediately=*/true,
+                                      fb::CreatePriority::UserPut));
   return HandleCreateReply(object_id, metadata, nullptr, data);
 }
 
+Status PlasmaClient::Impl::CreateBatch(
+    const std::vector<ObjectID> &object_ids, const ray::rpc::Address &owner_address,
+    const std::vector<int64_t> &data_sizes, const std::vector<const uint8_t *> &metadata,
+    const std::vector<int64_t> &metadata_sizes,
+    std::vector<std::shared_ptr<Buffer>> *data, std::vector<Status> *statuses,
+    fb::ObjectSource source, int device_num, fb::CreatePriority priority) {
+  std::unique_lock<std::recursive_mutex> guard(client_mutex_);
+  RAY_CHECK(object_ids.size() == metadata.size());
+
+  RAY_LOG(DEBUG) << "called plasma_create_batch on conn " << store_conn_ << " for "
+                 << object_ids.size() << " objects";
+  RAY_RETURN_NOT_OK(SendCreateBatchRequest(store_conn_, object_ids, owner_address,
+                                           data_sizes, metadata_sizes, source,
+                                           device_num, priority));
+  std::vector<uint8_t> buffer;
+  RAY_RETURN_NOT_OK(
+      PlasmaReceive(store_conn_, MessageType::PlasmaCreateBatchReply, &buffer));
+  std::vector<ObjectID> ids;
+  std::vector<uint64_t> retry_with_request_ids;
+  std::vector<PlasmaObject> objects;
+  std::vector<MEMFD_TYPE> store_fds;
+  std::vector<int64_t> mmap_sizes;
+  RAY_RETURN_NOT_OK(ReadCreateBatchReply(buffer.data(), buffer.size(), &ids,
+                                         &retry_with_request_ids, &objects, &store_fds,
+                                         &mmap_sizes, statuses));
+  RAY_CHECK(ids == object_ids);
+
+  // The store sends the file descriptors of the created objects right after the
+  // reply, so map all of them before retrying the unfinished requests.
+  data->assign(object_ids.size(), nullptr);
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    if (retry_with_request_ids[i] == 0 && (*statuses)[i].ok()) {
+      MapCreatedObject(object_ids[i], metadata[i], &objects[i], store_fds[i],
+                       mmap_sizes[i], &(*data)[i]);
+    }
+  }
+
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    while (retry_with_request_ids[i] > 0) {
+      guard.unlock();
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(RayConfig::instance().object_store_full_delay_ms()));
+      guard.lock();
+      RAY_LOG(DEBUG) << "Retrying request for object " << object_ids[i]
+                     << " with request ID " << retry_with_request_ids[i];
+      (*statuses)[i] = RetryCreate(object_ids[i], retry_with_request_ids[i], metadata[i],
+                                   &retry_with_request_ids[i], &(*data)[i]);
+    }
+  }
+  return Status::OK();
+}
+
 Status PlasmaClient::Impl::GetBuffers(
     const ObjectID *object_ids, int64_t num_objects, int64_t timeout_ms,
     const std::function<std::shared_ptr<Buffer>(
         const ObjectID &, const std::shared_ptr<Buffer> &)> &wrap_buffer,
-    ObjectBuffer *object_buffers, bool is_from_worker) {
+    ObjectBuffer *object_buffers, bool is_from_worker, int64_t num_objects_to_wait_for) {
   // Fill out the info for the objects that are already in use locally.
   bool all_present = true;
   for (int64_t i = 0; i < num_objects; ++i) {
@@ -437,7 +552,7 @@ Status PlasmaClient::Impl::GetBuffers(
   // If we get here, then the objects aren't all currently in use by this
   // client, so we need to send a request to the plasma store.
   RAY_RETURN_NOT_OK(SendGetRequest(store_conn_, &object_ids[0], num_objects, timeout_ms,
-                                   is_from_worker));
+                                   is_from_worker, num_objects_to_wait_for));
   std::vector<uint8_t> buffer;
   RAY_RETURN_NOT_OK(PlasmaReceive(store_conn_, MessageType::PlasmaGetReply, &buffer));
   std::vector<ObjectID> received_object_ids(num_objects);
@@ -499,7 +614,7 @@ Status PlasmaClient::Impl::GetBuffers(
 
 Status PlasmaClient::Impl::Get(const std::vector<ObjectID> &object_ids,
                                int64_t timeout_ms, std::vector<ObjectBuffer> *out,
-                               bool is_from_worker) {
+                               bool is_from_worker, int64_t num_objects_to_wait_for) {
   std::lock_guard<std::recursive_mutex> guard(client_mutex_);
 
   const auto wrap_buffer = [=](const ObjectID &object_id,
@@ -509,7 +624,7 @@ Status PlasmaClient::Impl::Get(const std::vector<ObjectID> &object_ids,
   const size_t num_objects = object_ids.size();
   *out = std::vector<ObjectBuffer>(num_objects);
   return GetBuffers(&object_ids[0], num_objects, timeout_ms, wrap_buffer, &(*out)[0],
-                    is_from_worker);
+                    is_from_worker, num_objects_to_wait_for);
 }
 
 Status PlasmaClient::Impl::MarkObjectUnused(const ObjectID &object_id) {
@@ -536,14 +651,47 @@ Status PlasmaClient::Impl::Release(const ObjectID &object_id) {
   RAY_CHECK(object_entry->second->count >= 0);
   // Check if the client is no longer using this object.
   if (object_entry->second->count == 0) {
-    // Tell the store that the client no longer needs the object.
-    RAY_RETURN_NOT_OK(MarkObjectUnused(object_id));
-    RAY_RETURN_NOT_OK(SendReleaseRequest(store_conn_, object_id));
-    auto iter = deletion_cache_.find(object_id);
-    if (iter != deletion_cache_.end()) {
-      deletion_cache_.erase(object_id);
-      RAY_RETURN_NOT_OK(Delete({object_id}));
+    auto &entry = *object_entry->second;
+    int64_t size = entry.object.data_size + entry.object.metadata_size;
+    int64_t max_bytes = RayConfig::instance().plasma_client_release_delay_bytes();
+    if (!entry.is_sealed || size > max_bytes || deletion_cache_.count(object_id) > 0) {
+      return SendRelease(object_id);
     }
+    // Keep the object, and tell the store once it is among the least recently
+    // released ones.
+    entry.release_delayed = true;
+    entry.delayed_release_it =
+        delayed_releases_.insert(delayed_releases_.end(), object_id);
+    delayed_release_bytes_ += size;
+    return FlushDelayedReleases(max_bytes);
+  }
+  return Status::OK();
+}
+
+Status PlasmaClient::Impl::SendRelease(const ObjectID &object_id) {
+  // Tell the store that the client no longer needs the object.
+  RAY_RETURN_NOT_OK(MarkObjectUnused(object_id));
+  RAY_RETURN_NOT_OK(SendReleaseRequest(store_conn_, object_id));
+  auto iter = deletion_cache_.find(object_id);
+  if (iter != deletion_cache_.end()) {
+    deletion_cache_.erase(object_id);
+    RAY_RETURN_NOT_OK(Delete({object_id}));
+  }
+  return Status::OK();
+}
+
+void PlasmaClient::Impl::CancelDelayedRelease(ObjectInUseEntry *object_entry) {
+  object_entry->release_delayed = false;
+  delayed_releases_.erase(object_entry->delayed_release_it);
+  delayed_release_bytes_ -=
+      object_entry->object.data_size + object_entry->object.metadata_size;
+}
+
+Status PlasmaClient::Impl::FlushDelayedReleases(int64_t max_bytes) {
+  while (delayed_release_bytes_ > max_bytes) {
+    ObjectID object_id = delayed_releases_.front();
+    CancelDelayedRelease(objects_in_use_[object_id].get());
+    RAY_RETURN_NOT_OK(SendRelease(object_id));
   }
   return Status::OK();
 }
@@ -600,6 +748,49 @@ Status PlasmaClient::Impl::Seal(const ObjectID &object_id) {
   return Release(object_id);
 }
 
+Status PlasmaClient::Impl::SealBatch(const std::vector<ObjectID> &object_ids) {
+  std::lock_guard<std::recursive_mutex> guard(client_mutex_);
+
+  // Check all of the objects before sealing any of them, so that a bad ID
+  // doesn't leave the batch half sealed.
+  for (const auto &object_id : object_ids) {
+    auto object_entry = objects_in_use_.find(object_id);
+    if (object_entry == objects_in_use_.end()) {
+      return Status::ObjectNotFound(
+          "SealBatch() called on an object without a reference to it");
+    }
+    if (object_entry->second->is_sealed) {
+      return Status::ObjectAlreadySealed(
+          "SealBatch() called on an already sealed object");
+    }
+  }
+
+  for (const auto &object_id : object_ids) {
+    objects_in_use_[object_id]->is_sealed = true;
+  }
+  RAY_RETURN_NOT_OK(SendSealBatchRequest(store_conn_, object_ids));
+  std::vector<uint8_t> buffer;
+  RAY_RETURN_NOT_OK(
+      PlasmaReceive(store_conn_, MessageType::PlasmaSealBatchReply, &buffer));
+  std::vector<ObjectID> sealed_ids;
+  std::vector<PlasmaError> errors;
+  RAY_RETURN_NOT_OK(
+      ReadSealBatchReply(buffer.data(), buffer.size(), &sealed_ids, &errors));
+  RAY_CHECK(sealed_ids == object_ids);
+  Status status;
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    if (status.ok()) {
+      status = PlasmaErrorStatus(errors[i]);
+    }
+    // Drop the reference taken on creation, see Seal.
+    auto release_status = Release(object_ids[i]);
+    if (status.ok()) {
+      status = release_status;
+    }
+  }
+  return status;
+}
+
 Status PlasmaClient::Impl::Abort(const ObjectID &object_id) {
   std::lock_guard<std::recursive_mutex> guard(client_mutex_);
   auto object_entry = objects_in_use_.find(object_id);
@@ -632,6 +823,12 @@ Status PlasmaClient::Impl::Delete(const std::vector<ObjectID> &object_ids) {
 
   std::vector<ObjectID> not_in_use_ids;
   for (auto &object_id : object_ids) {
+    auto object_entry = objects_in_use_.find(object_id);
+    if (object_entry != objects_in_use_.end() && object_entry->second->release_delayed) {
+      // Send the delayed release first, the store doesn't delete used objects.
+      CancelDelayedRelease(object_entry->second.get());
+      RAY_RETURN_NOT_OK(SendRelease(object_id));
+    }
     // If the object is in used, skip it.
     if (objects_in_use_.count(object_id) == 0) {
       not_in_use_ids.push_back(object_id);
@@ -678,6 +875,28 @@ Status PlasmaClient::Impl::Connect(const std::string &store_socket_name,
   std::vector<uint8_t> buffer;
   RAY_RETURN_NOT_OK(PlasmaReceive(store_conn_, MessageType::PlasmaConnectReply, &buffer));
   RAY_RETURN_NOT_OK(ReadConnectReply(buffer.data(), buffer.size(), &store_capacity_));
+  int64_t ring_size = RayConfig::instance().plasma_client_ring_size();
+  if (ring_size > 0) {
+    RAY_RETURN_NOT_OK(SetupRings(ring_size));
+  }
+  return Status::OK();
+}
+
+Status PlasmaClient::Impl::SetupRings(int64_t capacity) {
+  RAY_RETURN_NOT_OK(SendRingSetupRequest(store_conn_, capacity));
+  std::vector<uint8_t> buffer;
+  RAY_RETURN_NOT_OK(
+      PlasmaReceive(store_conn_, MessageType::PlasmaRingSetupReply, &buffer));
+  RAY_RETURN_NOT_OK(ReadRingSetupReply(buffer.data(), buffer.size(), &capacity));
+  if (capacity == 0) {
+    // The store couldn't set up the rings, keep using the socket.
+    return Status::OK();
+  }
+  MEMFD_TYPE_NON_UNIQUE fd;
+  RAY_RETURN_NOT_OK(store_conn_->RecvFd(&fd));
+  std::unique_ptr<ClientRings> rings;
+  RAY_RETURN_NOT_OK(ClientRings::Map(fd, capacity, &rings));
+  store_conn_->EnableRings(std::move(rings));
   return Status::OK();
 }
 
@@ -691,6 +910,8 @@ Status PlasmaClient::Impl::Disconnect() {
   // Close the connections to Plasma. The Plasma store will release the objects
   // that were in use by us when handling the SIGPIPE.
   store_conn_.reset();
+  delayed_releases_.clear();
+  delayed_release_bytes_ = 0;
   return Status::OK();
 }
 
@@ -729,9 +950,11 @@ Status PlasmaClient::CreateAndSpillIfNeeded(const ObjectID &object_id,
                                             int64_t data_size, const uint8_t *metadata,
                                             int64_t metadata_size,
                                             std::shared_ptr<Buffer> *data,
-                                            fb::ObjectSource source, int device_num) {
+                                            fb::ObjectSource source, int device_num,
+                                            fb::CreatePriority priority) {
   return impl_->CreateAndSpillIfNeeded(object_id, owner_address, data_size, metadata,
-                                       metadata_size, data, source, device_num);
+                                       metadata_size, data, source, device_num,
+                                       priority);
 }
 
 Status PlasmaClient::TryCreateImmediately(const ObjectID &object_id,
@@ -745,8 +968,10 @@ Status PlasmaClient::TryCreateImmediately(const ObjectID &object_id,
 }
 
 Status PlasmaClient::Get(const std::vector<ObjectID> &object_ids, int64_t timeout_ms,
-                         std::vector<ObjectBuffer> *object_buffers, bool is_from_worker) {
-  return impl_->Get(object_ids, timeout_ms, object_buffers, is_from_worker);
+                         std::vector<ObjectBuffer> *object_buffers, bool is_from_worker,
+                         int64_t num_objects_to_wait_for) {
+  return impl_->Get(object_ids, timeout_ms, object_buffers, is_from_worker,
+                    num_objects_to_wait_for);
 }
 
 Status PlasmaClient::Release(const ObjectID &object_id) {
@@ -759,8 +984,25 @@ Status PlasmaClient::Contains(const ObjectID &object_id, bool *has_object) {
 
 Status PlasmaClient::Abort(const ObjectID &object_id) { return impl_->Abort(object_id); }
 
+Status PlasmaClient::CreateBatch(const std::vector<ObjectID> &object_ids,
+                                 const ray::rpc::Address &owner_address,
+                                 const std::vector<int64_t> &data_sizes,
+                                 const std::vector<const uint8_t *> &metadata,
+                                 const std::vector<int64_t> &metadata_sizes,
+                                 std::vector<std::shared_ptr<Buffer>> *data,
+                                 std::vector<Status> *statuses, fb::ObjectSource source,
+                                 int device_num, fb::CreatePriority priority) {
+  return impl_->CreateBatch(object_ids, owner_address, data_sizes, metadata,
+                            metadata_sizes, data, statuses, source, device_num,
+                            priority);
+}
+
 Status PlasmaClient::Seal(const ObjectID &object_id) { return impl_->Seal(object_id); }
 
+Status PlasmaClient::SealBatch(const std::vector<ObjectID> &object_ids) {
+  return impl_->SealBatch(object_ids);
+}
+
 Status PlasmaClient::Delete(const ObjectID &object_id) {
   return impl_->Delete(std::vector<ObjectID>{object_id});
 }
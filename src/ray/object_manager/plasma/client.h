@@ -87,6 +87,8 @@ class PlasmaClient {
   ///        device_num = 0 corresponds to the host,
   ///        device_num = 1 corresponds to GPU0,
   ///        device_num = 2 corresponds to GPU1, etc.
+  /// \param priority The priority class of the request. While the store is
+  ///        short on memory, requests of a higher priority are served first.
   /// \return The return status.
   ///
   /// The returned object must be released once it is done with.  It must also
@@ -95,7 +97,9 @@ class PlasmaClient {
                                 const ray::rpc::Address &owner_address, int64_t data_size,
                                 const uint8_t *metadata, int64_t metadata_size,
                                 std::shared_ptr<Buffer> *data,
-                                plasma::flatbuf::ObjectSource source, int device_num = 0);
+                                plasma::flatbuf::ObjectSource source, int device_num = 0,
+                                plasma::flatbuf::CreatePriority priority =
+                                    plasma::flatbuf::CreatePriority::UserPut);
 
   /// Create an object in the Plasma Store. Any metadata for this object must be
   /// be passed in when the object is created.
@@ -129,6 +133,36 @@ class PlasmaClient {
                               std::shared_ptr<Buffer> *data,
                               plasma::flatbuf::ObjectSource source, int device_num = 0);
 
+  /// Create a batch of objects in the Plasma Store with a single request to the
+  /// store. This behaves like calling CreateAndSpillIfNeeded for each object in
+  /// order, but saves a round trip to the store per object.
+  ///
+  /// \param object_ids The IDs to use for the newly created objects.
+  /// \param owner_address The address of the owner of all of the objects.
+  /// \param data_sizes The size in bytes of the data of each object.
+  /// \param metadata The metadata of each object, or NULL if it has none.
+  /// \param metadata_sizes The size in bytes of the metadata of each object.
+  /// \param data The buffers of the created objects will be written here.
+  ///        Entries of objects that could not be created are set to nullptr.
+  /// \param statuses The result of creating each object will be written here.
+  /// \param device_num The number of the device where the objects are created.
+  /// \param priority The priority class of the requests.
+  /// \return An error if the request to the store failed. The results of the
+  ///         individual objects are returned in statuses.
+  ///
+  /// Each created object must be released and either sealed or aborted, as
+  /// for CreateAndSpillIfNeeded.
+  Status CreateBatch(const std::vector<ObjectID> &object_ids,
+                     const ray::rpc::Address &owner_address,
+                     const std::vector<int64_t> &data_sizes,
+                     const std::vector<const uint8_t *> &metadata,
+                     const std::vector<int64_t> &metadata_sizes,
+                     std::vector<std::shared_ptr<Buffer>> *data,
+                     std::vector<Status> *statuses, plasma::flatbuf::ObjectSource source,
+                     int device_num = 0,
+                     plasma::flatbuf::CreatePriority priority =
+                         plasma::flatbuf::CreatePriority::UserPut);
+
   /// Get some objects from the Plasma Store. This function will block until the
   /// objects have all been created and sealed in the Plasma Store or the
   /// timeout expires.
@@ -143,9 +177,12 @@ class PlasmaClient {
   ///        request times out. If this value is -1, then no timeout is set.
   /// \param[out] object_buffers The object results.
   /// \param is_from_worker Whether or not if the Get request comes from a Ray workers.
+  /// \param num_objects_to_wait_for Return as soon as this many of the objects are
+  ///        sealed, or 0 to wait for all of them.
   /// \return The return status.
   Status Get(const std::vector<ObjectID> &object_ids, int64_t timeout_ms,
-             std::vector<ObjectBuffer> *object_buffers, bool is_from_worker);
+             std::vector<ObjectBuffer> *object_buffers, bool is_from_worker,
+             int64_t num_objects_to_wait_for = 0);
 
   /// Tell Plasma that the client no longer needs the object. This should be
   /// called after Get() or Create() when the client is done with the object.
@@ -184,6 +221,13 @@ class PlasmaClient {
   /// \return The return status.
   Status Seal(const ObjectID &object_id);
 
+  /// Seal a batch of objects in the object store with a single request. If any
+  /// of the objects can't be sealed by this client, none of them are sealed.
+  ///
+  /// \param object_ids The IDs of the objects to seal.
+  /// \return The return status.
+  Status SealBatch(const std::vector<ObjectID> &object_ids);
+
   /// Delete an object from the object store. This currently assumes that the
   /// object is present, has been sealed and not used by another client. Otherwise,
   /// it is a no operation.
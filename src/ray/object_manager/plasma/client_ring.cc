@@ -0,0 +1,230 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/client_ring.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "ray/util/logging.h"
+
+namespace plasma {
+
+namespace {
+// Every message is preceded by its type and length.
+struct FrameHeader {
+  int64_t type;
+  int64_t length;
+};
+
+// Keep the indices of the two sides on separate cache lines, so that the
+// producer and the consumer don't keep stealing them from each other.
+const int64_t kCacheLineSize = 64;
+}  // namespace
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+              "Shared memory rings need address free atomics.");
+
+struct SpscRing::Header {
+  /// The position up to which the consumer has read. Only written by the consumer.
+  alignas(kCacheLineSize) std::atomic<uint64_t> head;
+  /// The position up to which the producer has written. Only written by the
+  /// producer.
+  alignas(kCacheLineSize) std::atomic<uint64_t> tail;
+  /// Set while the consumer is (about to go) asleep.
+  alignas(kCacheLineSize) std::atomic<int32_t> consumer_waiting;
+};
+
+int64_t SpscRing::RequiredSize(int64_t capacity) {
+  // Round up so that rings placed back to back keep their header aligned.
+  int64_t aligned_capacity =
+      (capacity + kCacheLineSize - 1) / kCacheLineSize * kCacheLineSize;
+  return static_cast<int64_t>(sizeof(Header)) + aligned_capacity;
+}
+
+void SpscRing::Initialize(void *memory, bool consumer_waiting) {
+  auto header = new (memory) Header();
+  header->head.store(0);
+  header->tail.store(0);
+  header->consumer_waiting.store(consumer_waiting ? 1 : 0);
+}
+
+SpscRing::SpscRing(void *memory, int64_t capacity)
+    : header_(static_cast<Header *>(memory)),
+      data_(static_cast<uint8_t *>(memory) + sizeof(Header)),
+      capacity_(capacity) {
+  RAY_CHECK(capacity_ > static_cast<int64_t>(sizeof(FrameHeader)));
+}
+
+bool SpscRing::Fits(int64_t length) const {
+  return static_cast<int64_t>(sizeof(FrameHeader)) + length <= capacity_;
+}
+
+bool SpscRing::TryPush(int64_t type, const uint8_t *message, int64_t length) {
+  uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+  uint64_t head = header_->head.load(std::memory_order_acquire);
+  uint64_t needed = sizeof(FrameHeader) + length;
+  if (static_cast<uint64_t>(capacity_) - (tail - head) < needed) {
+    return false;
+  }
+  FrameHeader frame{type, length};
+  CopyIn(tail, &frame, sizeof(frame));
+  if (length > 0) {
+    CopyIn(tail + sizeof(frame), message, length);
+  }
+  header_->tail.store(tail + needed, std::memory_order_release);
+  return true;
+}
+
+bool SpscRing::TryPop(int64_t *type, std::vector<uint8_t> *message) {
+  uint64_t head = header_->head.load(std::memory_order_relaxed);
+  uint64_t tail = header_->tail.load(std::memory_order_acquire);
+  if (head == tail) {
+    return false;
+  }
+  FrameHeader frame;
+  CopyOut(head, &frame, sizeof(frame));
+  RAY_CHECK(frame.length >= 0 &&
+            sizeof(frame) + static_cast<uint64_t>(frame.length) <= tail - head)
+      << "Corrupted message in the plasma client ring.";
+  *type = frame.type;
+  message->resize(frame.length);
+  if (frame.length > 0) {
+    CopyOut(head + sizeof(frame), message->data(), frame.length);
+  }
+  header_->head.store(head + sizeof(frame) + frame.length, std::memory_order_release);
+  return true;
+}
+
+void SpscRing::MarkConsumerWaiting() {
+  header_->consumer_waiting.store(1, std::memory_order_seq_cst);
+  // Order the flag before the consumer's last look at the tail, see ClaimWakeup.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+bool SpscRing::ClaimWakeup() {
+  // Order the producer's push before reading the flag. Together with the fence in
+  // MarkConsumerWaiting, either the consumer sees the new message or the producer
+  // sees the flag.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (header_->consumer_waiting.load(std::memory_order_relaxed) == 0) {
+    return false;
+  }
+  return header_->consumer_waiting.exchange(0, std::memory_order_seq_cst) == 1;
+}
+
+void SpscRing::CopyIn(uint64_t position, const void *data, int64_t length) {
+  auto offset = static_cast<int64_t>(position % capacity_);
+  auto first = std::min(length, capacity_ - offset);
+  std::memcpy(data_ + offset, data, first);
+  std::memcpy(data_, static_cast<const uint8_t *>(data) + first, length - first);
+}
+
+void SpscRing::CopyOut(uint64_t position, void *data, int64_t length) const {
+  auto offset = static_cast<int64_t>(position % capacity_);
+  auto first = std::min(length, capacity_ - offset);
+  std::memcpy(data, data_ + offset, first);
+  std::memcpy(static_cast<uint8_t *>(data) + first, data_, length - first);
+}
+
+ClientRings::ClientRings(uint8_t *memory, int64_t mmap_size, int64_t capacity,
+                         MEMFD_TYPE_NON_UNIQUE fd)
+    : memory_(memory),
+      mmap_size_(mmap_size),
+      capacity_(capacity),
+      fd_(fd),
+      requests_(memory, capacity),
+      replies_(memory + SpscRing::RequiredSize(capacity), capacity) {}
+
+#ifdef __linux__
+
+namespace {
+int64_t MmapSize(int64_t capacity) { return 2 * SpscRing::RequiredSize(capacity); }
+}  // namespace
+
+ray::Status ClientRings::Create(int64_t capacity, std::unique_ptr<ClientRings> *rings) {
+  int64_t mmap_size = MmapSize(capacity);
+  int fd = static_cast<int>(syscall(SYS_memfd_create, "plasma_client_ring", 0));
+  if (fd < 0) {
+    return ray::Status::IOError("memfd_create failed: " + std::string(strerror(errno)));
+  }
+  if (ftruncate(fd, static_cast<off_t>(mmap_size)) != 0) {
+    auto status =
+        ray::Status::IOError("ftruncate failed: " + std::string(strerror(errno)));
+    close(fd);
+    return status;
+  }
+  void *memory = mmap(nullptr, mmap_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (memory == MAP_FAILED) {
+    auto status = ray::Status::IOError("mmap failed: " + std::string(strerror(errno)));
+    close(fd);
+    return status;
+  }
+  auto base = static_cast<uint8_t *>(memory);
+  // The store consumes requests only after the client woke it up for the first
+  // time, while the client polls for replies before it goes to sleep.
+  SpscRing::Initialize(base, /*consumer_waiting=*/true);
+  SpscRing::Initialize(base + SpscRing::RequiredSize(capacity),
+                       /*consumer_waiting=*/false);
+  rings->reset(new ClientRings(base, mmap_size, capacity, fd));
+  return ray::Status::OK();
+}
+
+ray::Status ClientRings::Map(MEMFD_TYPE_NON_UNIQUE fd, int64_t capacity,
+                             std::unique_ptr<ClientRings> *rings) {
+  int64_t mmap_size = MmapSize(capacity);
+  void *memory = mmap(nullptr, mmap_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    return ray::Status::IOError("mmap failed: " + std::string(strerror(errno)));
+  }
+  rings->reset(new ClientRings(static_cast<uint8_t *>(memory), mmap_size, capacity,
+                               INVALID_FD));
+  return ray::Status::OK();
+}
+
+ClientRings::~ClientRings() {
+  if (munmap(memory_, mmap_size_) != 0) {
+    RAY_LOG(ERROR) << "Failed to unmap the plasma client rings: " << strerror(errno);
+  }
+  if (fd_ != INVALID_FD) {
+    close(fd_);
+  }
+}
+
+#else
+
+ray::Status ClientRings::Create(int64_t capacity, std::unique_ptr<ClientRings> *rings) {
+  return ray::Status::NotImplemented(
+      "Plasma client rings are only supported on Linux.");
+}
+
+ray::Status ClientRings::Map(MEMFD_TYPE_NON_UNIQUE fd, int64_t capacity,
+                             std::unique_ptr<ClientRings> *rings) {
+  return ray::Status::NotImplemented(
+      "Plasma client rings are only supported on Linux.");
+}
+
+ClientRings::~ClientRings() {}
+
+#endif  // __linux__
+
+}  // namespace plasma
@@ -0,0 +1,136 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ray/common/status.h"
+#include "ray/object_manager/plasma/compat.h"
+
+namespace plasma {
+
+// SpscRing is a lock-free single producer, single consumer queue of framed
+// messages placed in memory shared by two processes.
+//
+// The ring only moves bytes; waking up a consumer that went to sleep is left to
+// the caller (plasma uses the client socket for this). The handshake is:
+//   - The consumer calls MarkConsumerWaiting() and then tries to pop once more
+//     before it sleeps.
+//   - The producer calls ClaimWakeup() after every push and sends a wakeup iff
+//     it returns true.
+// Exactly one side claims the flag, so no wakeup is lost and none is sent twice.
+class SpscRing {
+ public:
+  /// The number of bytes of shared memory needed for a ring of the given capacity.
+  static int64_t RequiredSize(int64_t capacity);
+
+  /// Construct the ring state at the given memory. This must be called exactly
+  /// once, before any process attaches to the ring.
+  ///
+  /// \param memory The memory of the ring, at least RequiredSize(capacity) bytes.
+  /// \param consumer_waiting Whether the consumer starts out asleep, i.e., the
+  /// first push needs to send a wakeup.
+  static void Initialize(void *memory, bool consumer_waiting);
+
+  /// Attach to a ring that was initialized with Initialize().
+  SpscRing(void *memory, int64_t capacity);
+
+  /// Whether a message of the given length can ever fit into the ring.
+  bool Fits(int64_t length) const;
+
+  /// Append a message to the ring. Must only be called by the producer.
+  ///
+  /// \return False if there is currently not enough space for the message.
+  bool TryPush(int64_t type, const uint8_t *message, int64_t length);
+
+  /// Pop the oldest message from the ring. Must only be called by the consumer.
+  ///
+  /// \return False if the ring is empty.
+  bool TryPop(int64_t *type, std::vector<uint8_t> *message);
+
+  /// Announce that the consumer is about to sleep. Must only be called by the
+  /// consumer.
+  void MarkConsumerWaiting();
+
+  /// Clear the waiting flag of the consumer.
+  ///
+  /// \return Whether the flag was set, i.e., whether the consumer needs a wakeup
+  /// (when called by the producer) or whether a wakeup is not on its way yet
+  /// (when called by the consumer).
+  bool ClaimWakeup();
+
+ private:
+  struct Header;
+
+  void CopyIn(uint64_t position, const void *data, int64_t length);
+
+  void CopyOut(uint64_t position, void *data, int64_t length) const;
+
+  Header *header_;
+  uint8_t *data_;
+  const int64_t capacity_;
+};
+
+// ClientRings is the shared memory with the request and the reply ring of one
+// plasma client. The store creates it and passes its fd to the client over the
+// socket, after which the Get, Release and Contains requests of the client and
+// their replies go through the rings instead of the socket.
+class ClientRings {
+ public:
+  /// Create the rings of a client in a new anonymous shared memory file.
+  ///
+  /// \param capacity The capacity in bytes of each of the two rings.
+  /// \param[out] rings The created rings.
+  /// \return NotImplemented on platforms without anonymous shared memory files.
+  static ray::Status Create(int64_t capacity, std::unique_ptr<ClientRings> *rings);
+
+  /// Map the rings created by the store. The fd is closed afterwards.
+  ///
+  /// \param fd The fd received from the store.
+  /// \param capacity The capacity in bytes of each of the two rings.
+  /// \param[out] rings The mapped rings.
+  static ray::Status Map(MEMFD_TYPE_NON_UNIQUE fd, int64_t capacity,
+                         std::unique_ptr<ClientRings> *rings);
+
+  ~ClientRings();
+
+  /// The ring of requests from the client to the store.
+  SpscRing &Requests() { return requests_; }
+
+  /// The ring of replies from the store to the client.
+  SpscRing &Replies() { return replies_; }
+
+  /// The fd of the shared memory, or INVALID_FD if it was already closed.
+  MEMFD_TYPE_NON_UNIQUE Fd() const { return fd_; }
+
+  /// The capacity in bytes of each of the two rings.
+  int64_t Capacity() const { return capacity_; }
+
+ private:
+  ClientRings(uint8_t *memory, int64_t mmap_size, int64_t capacity,
+              MEMFD_TYPE_NON_UNIQUE fd);
+
+  uint8_t *memory_;
+  const int64_t mmap_size_;
+  const int64_t capacity_;
+  MEMFD_TYPE_NON_UNIQUE fd_;
+  SpscRing requests_;
+  SpscRing replies_;
+};
+
+}  // namespace plasma
@@ -81,10 +81,12 @@ struct Allocation {
       : address(nullptr), size(0), fd(), offset(0), device_num(0), mmap_size(0) {}
 
   friend class PlasmaAllocator;
+  friend class SlabAllocator;
   friend class DummyAllocator;
   friend struct ObjectLifecycleManagerTest;
   FRIEND_TEST(ObjectStoreTest, PassThroughTest);
   FRIEND_TEST(EvictionPolicyTest, Test);
+  FRIEND_TEST(EvictionPolicyTest, PrefersReplaceableCopies);
 };
 
 /// This type is used by the Plasma store. It is here because it is exposed to
@@ -107,6 +109,12 @@ class LocalObject {
 
   const plasma::flatbuf::ObjectSource &GetSource() const { return source; }
 
+  bool IsFallbackAllocated() const { return fallback_allocated; }
+
+  int64_t GetSealTimeMs() const { return seal_time_ms; }
+
+  int32_t GetNumAccesses() const { return num_accesses; }
+
  private:
   friend class ObjectStore;
   friend class ObjectLifecycleManager;
@@ -115,6 +123,7 @@ class LocalObject {
   FRIEND_TEST(ObjectLifecycleManagerTest, RemoveReferenceOneRefNotSealed);
   friend struct ObjectStatsCollectorTest;
   FRIEND_TEST(EvictionPolicyTest, Test);
+  FRIEND_TEST(EvictionPolicyTest, PrefersReplaceableCopies);
 
   /// Allocation Info;
   Allocation allocation;
@@ -127,9 +136,17 @@ class LocalObject {
   int64_t create_time;
   /// How long creation of this object took.
   int64_t construct_duration;
+  /// Monotonic time in milliseconds of when this object was sealed, or -1 if it
+  /// is not sealed.
+  int64_t seal_time_ms;
+  /// Number of times a client took a reference to this object.
+  mutable int32_t num_accesses;
   /// The state of the object, e.g., whether it is open or sealed.
   ObjectState state;
   /// The source of the object. Used for debugging purposes.
   plasma::flatbuf::ObjectSource source;
+  /// Whether the object was allocated by the fallback allocator, i.e., lives
+  /// outside of the shared memory of the store.
+  bool fallback_allocated;
 };
 }  // namespace plasma
@@ -1,8 +1,12 @@
 #include "ray/object_manager/plasma/connection.h"
 
+#include <chrono>
+#include <thread>
+
 #ifndef _WIN32
 #include "ray/object_manager/plasma/fling.h"
 #endif
+#include "ray/common/ray_config.h"
 #include "ray/object_manager/plasma/plasma_generated.h"
 #include "ray/object_manager/plasma/protocol.h"
 #include "ray/util/logging.h"
@@ -46,6 +50,39 @@ const std::vector<std::string> GenerateEnumNames(const char *const *enum_names_p
 static const std::vector<std::string> object_store_message_enum =
     GenerateEnumNames(flatbuf::EnumNamesMessageType(), static_cast<int>(MessageType::MIN),
                       static_cast<int>(MessageType::MAX));
+
+const int64_t kRingWakeup = static_cast<int64_t>(MessageType::PlasmaRingWakeup);
+
+/// Whether the message is a request that goes through the client rings.
+bool IsRingRequest(int64_t type) {
+  switch (static_cast<MessageType>(type)) {
+  case MessageType::PlasmaGetRequest:
+  case MessageType::PlasmaReleaseRequest:
+  case MessageType::PlasmaContainsRequest:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// Whether the message is a reply that goes through the client rings.
+bool IsRingReply(int64_t type) {
+  switch (static_cast<MessageType>(type)) {
+  case MessageType::PlasmaGetReply:
+  case MessageType::PlasmaContainsReply:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// Wake up the consumer of the ring through the socket if it went to sleep.
+Status NotifyConsumer(ray::ServerConnection &connection, SpscRing &ring) {
+  if (!ring.ClaimWakeup()) {
+    return Status::OK();
+  }
+  return connection.WriteMessage(kRingWakeup, 0, nullptr);
+}
 }  // namespace
 
 Client::Client(ray::MessageHandler &message_handler, ray::local_stream_socket &&socket)
@@ -126,6 +163,55 @@ Status Client::SendFd(MEMFD_TYPE fd) {
   return Status::OK();
 }
 
+Status Client::WriteMessage(int64_t type, int64_t length, const uint8_t *message) {
+  if (rings_ == nullptr || !IsRingReply(type)) {
+    return ray::ServerConnection::WriteMessage(type, length, message);
+  }
+  auto &replies = rings_->Replies();
+  if (replies.TryPush(type, message, length)) {
+    return NotifyConsumer(*this, replies);
+  }
+  // The client waits for one reply at a time, so the ring only fills up if the
+  // reply is larger than the whole ring. Such replies go over the socket, and a
+  // wakeup in the ring tells the client to look there.
+  if (!replies.TryPush(kRingWakeup, nullptr, 0)) {
+    return Status::IOError("The reply ring of the plasma client is full.");
+  }
+  RAY_RETURN_NOT_OK(NotifyConsumer(*this, replies));
+  return ray::ServerConnection::WriteMessage(type, length, message);
+}
+
+Status Client::EnableRings(std::unique_ptr<ClientRings> rings) {
+#ifdef _WIN32
+  return Status::NotImplemented("Plasma client rings are not supported on Windows.");
+#else
+  auto ec = send_fd(GetNativeHandle(), rings->Fd());
+  if (ec <= 0) {
+    return Status::IOError("Failed to send the fd of the client rings.");
+  }
+  rings_ = std::move(rings);
+  return Status::OK();
+#endif
+}
+
+bool Client::PopRingRequest(int64_t *type, std::vector<uint8_t> *message) {
+  if (rings_ == nullptr) {
+    return false;
+  }
+  auto &requests = rings_->Requests();
+  if (requests.TryPop(type, message)) {
+    return true;
+  }
+  requests.MarkConsumerWaiting();
+  if (!requests.TryPop(type, message)) {
+    return false;
+  }
+  // A request came in while we were going to sleep, so stay awake. If the client
+  // claimed the flag first, its wakeup will find an empty ring, which is harmless.
+  requests.ClaimWakeup();
+  return true;
+}
+
 StoreConn::StoreConn(ray::local_stream_socket &&socket)
     : ray::ServerConnection(std::move(socket)) {}
 
@@ -149,4 +235,68 @@ Status StoreConn::RecvFd(MEMFD_TYPE_NON_UNIQUE *fd) {
   return Status::OK();
 }
 
+Status StoreConn::WriteMessage(int64_t type, int64_t length, const uint8_t *message) {
+  if (rings_ != nullptr && IsRingRequest(type)) {
+    auto &requests = rings_->Requests();
+    if (requests.TryPush(type, message, length)) {
+      return NotifyConsumer(*this, requests);
+    }
+    // The store is behind on our requests (or the request is larger than the
+    // ring). Fall back to the socket rather than waiting for room: the store
+    // handles these requests independently of each other, so it doesn't matter
+    // that this one may overtake the ones still in the ring.
+  }
+  return ray::ServerConnection::WriteMessage(type, length, message);
+}
+
+Status StoreConn::ReadMessage(int64_t type, std::vector<uint8_t> *message) {
+  if (rings_ == nullptr || !IsRingReply(type)) {
+    return ray::ServerConnection::ReadMessage(type, message);
+  }
+  int64_t reply_type;
+  RAY_RETURN_NOT_OK(PopRingReply(&reply_type, message));
+  if (reply_type == kRingWakeup) {
+    // The reply didn't fit into the ring and was sent over the socket.
+    return ray::ServerConnection::ReadMessage(type, message);
+  }
+  if (reply_type != type) {
+    return Status::IOError("Connection corrupted. Expected message type " +
+                           std::to_string(type) + ", but got message type " +
+                           std::to_string(reply_type) + " from the client ring.");
+  }
+  return Status::OK();
+}
+
+void StoreConn::EnableRings(std::unique_ptr<ClientRings> rings) {
+  rings_ = std::move(rings);
+}
+
+Status StoreConn::PopRingReply(int64_t *type, std::vector<uint8_t> *message) {
+  auto &replies = rings_->Replies();
+  // Most replies come back within microseconds, so poll for a bit before paying
+  // for a round trip through the kernel.
+  auto spin_deadline =
+      std::chrono::steady_clock::now() +
+      std::chrono::microseconds(RayConfig::instance().plasma_client_ring_spin_us());
+  do {
+    if (replies.TryPop(type, message)) {
+      return Status::OK();
+    }
+  } while (std::chrono::steady_clock::now() < spin_deadline);
+
+  std::vector<uint8_t> wakeup;
+  while (true) {
+    replies.MarkConsumerWaiting();
+    if (replies.TryPop(type, message)) {
+      if (!replies.ClaimWakeup()) {
+        // The store saw us waiting and sent a wakeup. Consume it, so that it isn't
+        // mistaken for the reply to a later socket request.
+        RAY_RETURN_NOT_OK(ray::ServerConnection::ReadMessage(kRingWakeup, &wakeup));
+      }
+      return Status::OK();
+    }
+    RAY_RETURN_NOT_OK(ray::ServerConnection::ReadMessage(kRingWakeup, &wakeup));
+  }
+}
+
 }  // namespace plasma
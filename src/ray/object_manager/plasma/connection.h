@@ -3,6 +3,7 @@
 #include "ray/common/client_connection.h"
 #include "ray/common/id.h"
 #include "ray/common/status.h"
+#include "ray/object_manager/plasma/client_ring.h"
 #include "ray/object_manager/plasma/compat.h"
 
 #include "absl/container/flat_hash_set.h"
@@ -31,6 +32,20 @@ class Client : public ray::ClientConnection, public ClientInterface {
 
   ray::Status SendFd(MEMFD_TYPE fd);
 
+  /// Write a message to the client. Once the client rings are enabled, replies to
+  /// ring requests are pushed to the reply ring instead of the socket.
+  ray::Status WriteMessage(int64_t type, int64_t length, const uint8_t *message);
+
+  /// Pass the fd of the given rings to the client, and route the Get, Release and
+  /// Contains messages of this client through them from now on.
+  ray::Status EnableRings(std::unique_ptr<ClientRings> rings);
+
+  /// Pop the next request of the client from the request ring. The store goes to
+  /// sleep once the ring is empty, until the client sends a wakeup message.
+  ///
+  /// \return False if there are no more requests.
+  bool PopRingRequest(int64_t *type, std::vector<uint8_t> *message);
+
   /// Object ids that are used by this client.
   std::unordered_set<ray::ObjectID> object_ids;
 
@@ -41,6 +56,8 @@ class Client : public ray::ClientConnection, public ClientInterface {
   /// File descriptors that are used by this client.
   /// TODO(ekl) we should also clean up old fds that are removed.
   absl::flat_hash_set<MEMFD_TYPE> used_fds_;
+  /// The shared memory rings of this client, if enabled.
+  std::unique_ptr<ClientRings> rings_;
 };
 
 std::ostream &operator<<(std::ostream &os, const std::shared_ptr<Client> &client);
@@ -54,6 +71,25 @@ class StoreConn : public ray::ServerConnection {
   ///
   /// \return A file descriptor.
   ray::Status RecvFd(MEMFD_TYPE_NON_UNIQUE *fd);
+
+  /// Write a message to the store. Once the rings are enabled, Get, Release and
+  /// Contains requests are pushed to the request ring instead of the socket.
+  ray::Status WriteMessage(int64_t type, int64_t length, const uint8_t *message);
+
+  /// Read a message from the store. Once the rings are enabled, replies to ring
+  /// requests are popped from the reply ring.
+  ray::Status ReadMessage(int64_t type, std::vector<uint8_t> *message);
+
+  /// Route the Get, Release and Contains messages through the given rings.
+  void EnableRings(std::unique_ptr<ClientRings> rings);
+
+ private:
+  /// Pop the next reply from the reply ring, sleeping on the socket if the store
+  /// takes a while.
+  ray::Status PopRingReply(int64_t *type, std::vector<uint8_t> *message);
+
+  /// The shared memory rings to the store, if enabled.
+  std::unique_ptr<ClientRings> rings_;
 };
 
 std::ostream &operator<<(std::ostream &os, const std::shared_ptr<StoreConn> &store_conn);
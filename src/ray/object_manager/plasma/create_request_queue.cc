@@ -27,15 +27,32 @@ namespace plasma {
 uint64_t CreateRequestQueue::AddRequest(const ObjectID &object_id,
                                         const std::shared_ptr<ClientInterface> &client,
                                         const CreateObjectCallback &create_callback,
-                                        size_t object_size) {
+                                        size_t object_size,
+                                        flatbuf::CreatePriority priority) {
   auto req_id = next_req_id_++;
   fulfilled_requests_[req_id] = nullptr;
-  queue_.emplace_back(
-      new CreateRequest(object_id, req_id, client, create_callback, object_size));
+  queues_[static_cast<size_t>(priority)].emplace_back(new CreateRequest(
+      object_id, req_id, client, create_callback, object_size, priority, get_time_()));
   num_bytes_pending_ += object_size;
   return req_id;
 }
 
+std::vector<uint64_t> CreateRequestQueue::AddBatchRequest(
+    const std::vector<ObjectID> &object_ids,
+    const std::shared_ptr<ClientInterface> &client,
+    const std::vector<CreateObjectCallback> &create_callbacks,
+    const std::vector<size_t> &object_sizes, flatbuf::CreatePriority priority) {
+  RAY_CHECK(object_ids.size() == create_callbacks.size());
+  RAY_CHECK(object_ids.size() == object_sizes.size());
+  std::vector<uint64_t> req_ids;
+  req_ids.reserve(object_ids.size());
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    req_ids.push_back(AddRequest(object_ids[i], client, create_callbacks[i],
+                                 object_sizes[i], priority));
+  }
+  return req_ids;
+}
+
 bool CreateRequestQueue::GetRequestResult(uint64_t req_id, PlasmaObject *result,
                                           PlasmaError *error) {
   auto it = fulfilled_requests_.find(req_id);
@@ -84,8 +101,8 @@ Status CreateRequestQueue::ProcessRequest(bool fallback_allocator,
 Status CreateRequestQueue::ProcessRequests() {
   // Suppress OOM dump to once per grace period.
   bool logged_oom = false;
-  while (!queue_.empty()) {
-    auto request_it = queue_.begin();
+  while (auto queue = NextQueue()) {
+    auto request_it = queue->begin();
     bool spilling_required = false;
     auto status =
         ProcessRequest(/*fallback_allocator=*/false, *request_it, &spilling_required);
@@ -149,19 +166,53 @@ void CreateRequestQueue::FinishRequest(
   it->second = std::move(request);
   RAY_CHECK(num_bytes_pending_ >= it->second->object_size);
   num_bytes_pending_ -= it->second->object_size;
-  queue_.erase(request_it);
+  queues_[static_cast<size_t>(it->second->priority)].erase(request_it);
+}
+
+std::list<std::unique_ptr<CreateRequestQueue::CreateRequest>>
+    *CreateRequestQueue::NextQueue() {
+  std::list<std::unique_ptr<CreateRequest>> *next = nullptr;
+  auto now = get_time_();
+  for (auto &queue : queues_) {
+    if (queue.empty()) {
+      continue;
+    }
+    if (next == nullptr) {
+      next = &queue;
+      continue;
+    }
+    // A lower priority request jumps ahead once it has been starved for long
+    // enough, and if it has been waiting for longer than the chosen one.
+    const auto &request = queue.front();
+    if (starvation_timeout_ns_ >= 0 &&
+        now - request->enqueue_time_ns > starvation_timeout_ns_ &&
+        request->enqueue_time_ns < next->front()->enqueue_time_ns) {
+      next = &queue;
+    }
+  }
+  return next;
+}
+
+size_t CreateRequestQueue::NumPendingRequests() const {
+  size_t num_requests = 0;
+  for (const auto &queue : queues_) {
+    num_requests += queue.size();
+  }
+  return num_requests;
 }
 
 void CreateRequestQueue::RemoveDisconnectedClientRequests(
     const std::shared_ptr<ClientInterface> &client) {
-  for (auto it = queue_.begin(); it != queue_.end();) {
-    if ((*it)->client == client) {
-      fulfilled_requests_.erase((*it)->request_id);
-      RAY_CHECK(num_bytes_pending_ >= (*it)->object_size);
-      num_bytes_pending_ -= (*it)->object_size;
-      it = queue_.erase(it);
-    } else {
-      it++;
+  for (auto &queue : queues_) {
+    for (auto it = queue.begin(); it != queue.end();) {
+      if ((*it)->client == client) {
+        fulfilled_requests_.erase((*it)->request_id);
+        RAY_CHECK(num_bytes_pending_ >= (*it)->object_size);
+        num_bytes_pending_ -= (*it)->object_size;
+        it = queue.erase(it);
+      } else {
+        it++;
+      }
     }
   }
 
@@ -38,12 +38,15 @@ class CreateRequestQueue {
                      ray::SpillObjectsCallback spill_objects_callback,
                      std::function<void()> trigger_global_gc,
                      std::function<int64_t()> get_time,
-                     std::function<std::string()> dump_debug_info_callback = nullptr)
+                     std::function<std::string()> dump_debug_info_callback = nullptr,
+                     int64_t starvation_timeout_ms = 10000)
       : oom_grace_period_ns_(oom_grace_period_s * 1e9),
+        starvation_timeout_ns_(starvation_timeout_ms * 1000000),
         spill_objects_callback_(spill_objects_callback),
         trigger_global_gc_(trigger_global_gc),
         get_time_(get_time),
-        dump_debug_info_callback_(dump_debug_info_callback) {}
+        dump_debug_info_callback_(dump_debug_info_callback),
+        queues_(static_cast<size_t>(flatbuf::CreatePriority::MAX) + 1) {}
 
   /// Add a request to the queue. The caller should use the returned request ID
   /// to later get the result of the request.
@@ -56,11 +59,30 @@ class CreateRequestQueue {
   /// drop this request if the client disconnects.
   /// \param create_callback A callback to attempt to create the object.
   /// \param object_size Object size in bytes.
+  /// \param priority The priority class of the request. Requests of a higher
+  /// priority are served first.
   /// \return A request ID that can be used to get the result.
-  uint64_t AddRequest(const ObjectID &object_id,
-                      const std::shared_ptr<ClientInterface> &client,
-                      const CreateObjectCallback &create_callback,
-                      const size_t object_size);
+  uint64_t AddRequest(
+      const ObjectID &object_id, const std::shared_ptr<ClientInterface> &client,
+      const CreateObjectCallback &create_callback, const size_t object_size,
+      flatbuf::CreatePriority priority = flatbuf::CreatePriority::UserPut);
+
+  /// Add a batch of requests to the queue, back to back in the given order.
+  /// Each request is processed and returns its result like a request added by
+  /// AddRequest.
+  ///
+  /// \param object_ids The IDs of the objects to create.
+  /// \param client The client that sent the requests.
+  /// \param create_callbacks A callback to attempt to create each object.
+  /// \param object_sizes The size in bytes of each object.
+  /// \param priority The priority class of all of the requests.
+  /// \return The request IDs, in the same order as the objects.
+  std::vector<uint64_t> AddBatchRequest(
+      const std::vector<ObjectID> &object_ids,
+      const std::shared_ptr<ClientInterface> &client,
+      const std::vector<CreateObjectCallback> &create_callbacks,
+      const std::vector<size_t> &object_sizes,
+      flatbuf::CreatePriority priority = flatbuf::CreatePriority::UserPut);
 
   /// Get the result of a request.
   ///
@@ -97,8 +119,10 @@ class CreateRequestQueue {
   /// Process requests in the queue.
   ///
   /// This will try to process as many requests in the queue as possible, in
-  /// FIFO order. If the first request is not serviceable, this will break and
-  /// the caller should try again later.
+  /// priority order and FIFO order within a priority. A request that has been
+  /// waiting for longer than the starvation timeout is served before requests
+  /// of a higher priority. If the next request is not serviceable, this will
+  /// break and the caller should try again later.
   ///
   /// \return Bad status for the first request in the queue if it failed to be
   /// serviced, or OK if all requests were fulfilled.
@@ -109,7 +133,7 @@ class CreateRequestQueue {
   /// \param client The client that was disconnected.
   void RemoveDisconnectedClientRequests(const std::shared_ptr<ClientInterface> &client);
 
-  size_t NumPendingRequests() const { return queue_.size(); }
+  size_t NumPendingRequests() const;
 
   size_t NumPendingBytes() const { return num_bytes_pending_; }
 
@@ -117,12 +141,15 @@ class CreateRequestQueue {
   struct CreateRequest {
     CreateRequest(const ObjectID &object_id, uint64_t request_id,
                   const std::shared_ptr<ClientInterface> &client,
-                  CreateObjectCallback create_callback, size_t object_size)
+                  CreateObjectCallback create_callback, size_t object_size,
+                  flatbuf::CreatePriority priority, int64_t enqueue_time_ns)
         : object_id(object_id),
           request_id(request_id),
           client(client),
           create_callback(create_callback),
-          object_size(object_size) {}
+          object_size(object_size),
+          priority(priority),
+          enqueue_time_ns(enqueue_time_ns) {}
 
     // The ObjectID to create.
     const ObjectID object_id;
@@ -140,6 +167,12 @@ class CreateRequestQueue {
 
     const size_t object_size;
 
+    // The priority class of the request.
+    const flatbuf::CreatePriority priority;
+
+    // When the request was queued, used to avoid starving low priority requests.
+    const int64_t enqueue_time_ns;
+
     // The results of the creation call. These should be sent back to the
     // client once ready.
     PlasmaError error = PlasmaError::OK;
@@ -155,6 +188,10 @@ class CreateRequestQueue {
   /// Finish a queued request and remove it from the queue.
   void FinishRequest(std::list<std::unique_ptr<CreateRequest>>::iterator request_it);
 
+  /// Returns the queue to serve the next request from, or nullptr if there are
+  /// no pending requests.
+  std::list<std::unique_ptr<CreateRequest>> *NextQueue();
+
   /// The next request ID to assign, so that the caller can get the results of
   /// a request by retrying. Start at 1 because 0 means "do not retry".
   uint64_t next_req_id_ = 1;
@@ -163,6 +200,10 @@ class CreateRequestQueue {
   /// -1 means grace period is infinite.
   const int64_t oom_grace_period_ns_;
 
+  /// Requests that have been waiting for longer than this are served before
+  /// requests of a higher priority. -1 means requests are never promoted.
+  const int64_t starvation_timeout_ns_;
+
   /// A callback to trigger object spilling. It tries to spill objects upto max
   /// throughput. It returns true if space is made by object spilling, and false if
   /// there's no more space to be made.
@@ -189,7 +230,9 @@ class CreateRequestQueue {
   /// in the object store. Then, the client does not need to poll on an
   /// OutOfMemory error and we can just respond to them once there is enough
   /// space made, or after a timeout.
-  std::list<std::unique_ptr<CreateRequest>> queue_;
+  ///
+  /// There is one queue per priority class, indexed by flatbuf::CreatePriority.
+  std::vector<std::list<std::unique_ptr<CreateRequest>>> queues_;
 
   /// A buffer of the results of fulfilled requests. The value will be null
   /// while the request is pending and will be set once the request has
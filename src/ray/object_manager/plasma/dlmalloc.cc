@@ -42,6 +42,7 @@
 
 #include "ray/common/ray_config.h"
 #include "ray/object_manager/plasma/plasma.h"
+#include "ray/object_manager/plasma/shared_memory.h"
 
 namespace plasma {
 
@@ -166,11 +167,24 @@ void create_and_mmap_buffer(int64_t size, void **pointer, int *fd) {
     }
   }
 
+  // Fallback files live on disk, so only the regions in the plasma directory are
+  // placed on huge pages and NUMA nodes.
+  const bool is_fallback = allocated_once && dlmalloc_config.fallback_enabled;
+  const bool transparent_hugepages =
+      !is_fallback && RayConfig::instance().plasma_transparent_hugepages();
+  const std::string numa_policy =
+      is_fallback ? "" : RayConfig::instance().plasma_numa_policy();
+  // The placement only applies to pages that are faulted in after it is set, so
+  // prefault the region by hand in that case instead of using MAP_POPULATE.
+  const bool prefault_after_placement =
+      RayConfig::instance().preallocate_plasma_memory() &&
+      (transparent_hugepages || !numa_policy.empty());
+
   // MAP_POPULATE can be used to pre-populate the page tables for this memory region
   // which avoids work when accessing the pages later. However it causes long pauses
   // when mmapping the files. Only supported on Linux.
   auto flags = MAP_SHARED;
-  if (RayConfig::instance().preallocate_plasma_memory()) {
+  if (RayConfig::instance().preallocate_plasma_memory() && !prefault_after_placement) {
     if (!MAP_POPULATE) {
       RAY_LOG(FATAL) << "MAP_POPULATE is not supported on this platform.";
     }
@@ -207,7 +221,19 @@ void create_and_mmap_buffer(int64_t size, void **pointer, int *fd) {
       RAY_LOG(ERROR)
           << "  (this probably means you have to increase /proc/sys/vm/nr_hugepages)";
     }
-  } else if (!allocated_once) {
+    return;
+  }
+  if (transparent_hugepages) {
+    internal::AdviseHugePages(*pointer, size);
+  }
+  if (!numa_policy.empty() && internal::SetNumaPolicy(*pointer, size, numa_policy)) {
+    RAY_LOG(INFO) << "Placed plasma memory with NUMA policy " << numa_policy;
+  }
+  if (prefault_after_placement) {
+    RAY_LOG(INFO) << "Preallocating all plasma memory by prefaulting its pages.";
+    internal::PrefaultRegion(*pointer, size);
+  }
+  if (!allocated_once) {
     initial_region_ptr = static_cast<char *>(*pointer);
     initial_region_size = size;
   }
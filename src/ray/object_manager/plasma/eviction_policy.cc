@@ -26,9 +26,23 @@ namespace plasma {
 void LRUCache::Add(const ObjectID &key, int64_t size) {
   auto it = item_map_.find(key);
   RAY_CHECK(it == item_map_.end());
-  // Note that it is important to use a list so the iterators stay valid.
-  item_list_.emplace_front(key, size);
-  item_map_.emplace(key, item_list_.begin());
+  int32_t handle;
+  if (free_items_.empty()) {
+    handle = static_cast<int32_t>(items_.size());
+    items_.emplace_back();
+  } else {
+    handle = free_items_.back();
+    free_items_.pop_back();
+  }
+  // New items are the most recently used.
+  items_[handle] = Item{key, size, -1, head_};
+  if (head_ != -1) {
+    items_[head_].prev = handle;
+  } else {
+    tail_ = handle;
+  }
+  head_ = handle;
+  item_map_.emplace(key, handle);
   used_capacity_ += size;
 }
 
@@ -37,14 +51,29 @@ int64_t LRUCache::Remove(const ObjectID &key) {
   if (it == item_map_.end()) {
     return -1;
   }
-  int64_t size = it->second->second;
+  int64_t size = items_[it->second].size;
   used_capacity_ -= size;
-  item_list_.erase(it->second);
+  RemoveItem(it->second);
   item_map_.erase(it);
   RAY_CHECK(used_capacity_ >= 0) << DebugString();
   return size;
 }
 
+void LRUCache::RemoveItem(int32_t handle) {
+  const auto &item = items_[handle];
+  if (item.prev != -1) {
+    items_[item.prev].next = item.next;
+  } else {
+    head_ = item.next;
+  }
+  if (item.next != -1) {
+    items_[item.next].prev = item.prev;
+  } else {
+    tail_ = item.prev;
+  }
+  free_items_.push_back(handle);
+}
+
 void LRUCache::AdjustCapacity(int64_t delta) {
   RAY_LOG(INFO) << "adjusting global lru capacity from " << Capacity() << " to "
                 << (Capacity() + delta) << " (max " << OriginalCapacity() << ")";
@@ -59,8 +88,8 @@ int64_t LRUCache::OriginalCapacity() const { return original_capacity_; }
 int64_t LRUCache::RemainingCapacity() const { return capacity_ - used_capacity_; }
 
 void LRUCache::Foreach(std::function<void(const ObjectID &)> f) {
-  for (auto &pair : item_list_) {
-    f(pair.first);
+  for (int32_t handle = head_; handle != -1; handle = items_[handle].next) {
+    f(items_[handle].key);
   }
 }
 
@@ -79,39 +108,241 @@ std::string LRUCache::DebugString() const {
 int64_t LRUCache::ChooseObjectsToEvict(int64_t num_bytes_required,
                                        std::vector<ObjectID> &objects_to_evict) {
   int64_t bytes_evicted = 0;
-  auto it = item_list_.end();
-  while (bytes_evicted < num_bytes_required && it != item_list_.begin()) {
-    it--;
-    objects_to_evict.push_back(it->first);
-    bytes_evicted += it->second;
-    bytes_evicted_total_ += it->second;
+  int32_t handle = tail_;
+  while (bytes_evicted < num_bytes_required && handle != -1) {
+    const auto &item = items_[handle];
+    objects_to_evict.push_back(item.key);
+    bytes_evicted += item.size;
+    bytes_evicted_total_ += item.size;
     num_evictions_total_ += 1;
+    handle = item.prev;
   }
   return bytes_evicted;
 }
 
 bool LRUCache::Exists(const ObjectID &key) const { return item_map_.count(key) > 0; }
 
+void GDSFCache::Add(const ObjectID &key, int64_t size) {
+  RAY_CHECK(item_map_.count(key) == 0);
+  auto &access_count = access_counts_[key];
+  // Newly created objects count as accessed once.
+  access_count = std::max<int64_t>(access_count, 1);
+  double priority = inflation_ + static_cast<double>(access_count) /
+                                     static_cast<double>(std::max<int64_t>(size, 1));
+  auto it = queue_.emplace(priority, std::make_pair(key, size));
+  item_map_.emplace(key, it);
+}
+
+int64_t GDSFCache::Remove(const ObjectID &key) {
+  auto it = item_map_.find(key);
+  if (it == item_map_.end()) {
+    return -1;
+  }
+  int64_t size = it->second->second.second;
+  queue_.erase(it->second);
+  item_map_.erase(it);
+  return size;
+}
+
+void GDSFCache::OnAccess(const ObjectID &key) { access_counts_[key]++; }
+
+void GDSFCache::OnDelete(const ObjectID &key) { access_counts_.erase(key); }
+
+int64_t GDSFCache::ChooseObjectsToEvict(int64_t num_bytes_required,
+                                        std::vector<ObjectID> &objects_to_evict) {
+  int64_t bytes_evicted = 0;
+  for (auto it = queue_.begin(); it != queue_.end() && bytes_evicted < num_bytes_required;
+       it++) {
+    objects_to_evict.push_back(it->second.first);
+    bytes_evicted += it->second.second;
+    bytes_evicted_total_ += it->second.second;
+    num_evictions_total_ += 1;
+    // Age the remaining objects, so that objects that used to be hot are
+    // eventually evicted too.
+    inflation_ = it->first;
+  }
+  return bytes_evicted;
+}
+
+bool GDSFCache::Exists(const ObjectID &key) const { return item_map_.count(key) > 0; }
+
+std::string GDSFCache::DebugString() const {
+  std::stringstream result;
+  result << "\n(" << name_ << ") num objects: " << item_map_.size();
+  result << "\n(" << name_ << ") inflation: " << inflation_;
+  result << "\n(" << name_ << ") num evictions: " << num_evictions_total_;
+  result << "\n(" << name_ << ") bytes evicted: " << bytes_evicted_total_;
+  return result.str();
+}
+
+void TwoQueueCache::Add(const ObjectID &key, int64_t size) {
+  RAY_CHECK(item_map_.count(key) == 0);
+  auto count_it = access_counts_.find(key);
+  bool is_protected = (count_it != access_counts_.end() &&
+                       count_it->second >= kPromotionThreshold) ||
+                      ghost_map_.count(key) > 0;
+  if (is_protected) {
+    protected_.emplace_front(key, size);
+    item_map_.emplace(key, Entry{true, protected_.begin()});
+  } else {
+    probation_.emplace_front(key, size);
+    item_map_.emplace(key, Entry{false, probation_.begin()});
+    probation_bytes_ += size;
+  }
+}
+
+int64_t TwoQueueCache::Remove(const ObjectID &key) {
+  auto it = item_map_.find(key);
+  if (it == item_map_.end()) {
+    return -1;
+  }
+  int64_t size = it->second.it->second;
+  if (it->second.is_protected) {
+    protected_.erase(it->second.it);
+  } else {
+    probation_.erase(it->second.it);
+    probation_bytes_ -= size;
+  }
+  item_map_.erase(it);
+  return size;
+}
+
+void TwoQueueCache::OnAccess(const ObjectID &key) { access_counts_[key]++; }
+
+void TwoQueueCache::OnDelete(const ObjectID &key) {
+  access_counts_.erase(key);
+  if (ghost_map_.count(key) > 0) {
+    return;
+  }
+  ghosts_.push_front(key);
+  ghost_map_.emplace(key, ghosts_.begin());
+  if (ghosts_.size() > kMaxGhostEntries) {
+    ghost_map_.erase(ghosts_.back());
+    ghosts_.pop_back();
+  }
+}
+
+int64_t TwoQueueCache::ChooseObjectsToEvict(int64_t num_bytes_required,
+                                            std::vector<ObjectID> &objects_to_evict) {
+  int64_t bytes_evicted = 0;
+  int64_t probation_bytes = probation_bytes_;
+  auto probation_it = probation_.rbegin();
+  auto protected_it = protected_.rbegin();
+  while (bytes_evicted < num_bytes_required) {
+    bool has_probation = probation_it != probation_.rend();
+    bool has_protected = protected_it != protected_.rend();
+    if (!has_probation && !has_protected) {
+      break;
+    }
+    const std::pair<ObjectID, int64_t> *victim;
+    // Evict from probation while it is over its share of the capacity.
+    if (has_probation && (!has_protected || probation_bytes > capacity_ / 4)) {
+      victim = &*probation_it++;
+      probation_bytes -= victim->second;
+    } else {
+      victim = &*protected_it++;
+    }
+    objects_to_evict.push_back(victim->first);
+    bytes_evicted += victim->second;
+    bytes_evicted_total_ += victim->second;
+    num_evictions_total_ += 1;
+  }
+  return bytes_evicted;
+}
+
+bool TwoQueueCache::Exists(const ObjectID &key) const {
+  return item_map_.count(key) > 0;
+}
+
+std::string TwoQueueCache::DebugString() const {
+  std::stringstream result;
+  result << "\n(" << name_ << ") num objects on probation: " << probation_.size();
+  result << "\n(" << name_ << ") bytes on probation: " << probation_bytes_;
+  result << "\n(" << name_ << ") num protected objects: " << protected_.size();
+  result << "\n(" << name_ << ") num evictions: " << num_evictions_total_;
+  result << "\n(" << name_ << ") bytes evicted: " << bytes_evicted_total_;
+  return result.str();
+}
+
+namespace {
+absl::flat_hash_map<std::string, EvictionCacheFactory> &EvictionCacheRegistry() {
+  static absl::flat_hash_map<std::string, EvictionCacheFactory> registry{
+      {"lru",
+       [](int64_t capacity) {
+         return std::make_unique<LRUCache>("global lru", capacity);
+       }},
+      {"gdsf", [](int64_t) { return std::make_unique<GDSFCache>("global gdsf"); }},
+      {"2q",
+       [](int64_t capacity) {
+         return std::make_unique<TwoQueueCache>("global 2q", capacity);
+       }},
+  };
+  return registry;
+}
+}  // namespace
+
+void RegisterEvictionCache(const std::string &name, EvictionCacheFactory factory) {
+  EvictionCacheRegistry()[name] = std::move(factory);
+}
+
+std::unique_ptr<EvictionCache> CreateEvictionCache(const std::string &name,
+                                                   int64_t capacity) {
+  auto &registry = EvictionCacheRegistry();
+  auto it = registry.find(name);
+  if (it == registry.end()) {
+    return nullptr;
+  }
+  return it->second(capacity);
+}
+
 EvictionPolicy::EvictionPolicy(const IObjectStore &object_store,
-                               const IAllocator &allocator)
+                               const IAllocator &allocator,
+                               std::unique_ptr<EvictionCache> cache,
+                               bool prefer_replaceable_copies)
     : pinned_memory_bytes_(0),
-      cache_("global lru", allocator.GetFootprintLimit()),
+      cache_(cache ? std::move(cache)
+                   : std::make_unique<LRUCache>("global lru",
+                                                allocator.GetFootprintLimit())),
+      replaceable_cache_(prefer_replaceable_copies
+                             ? std::make_unique<LRUCache>("replaceable lru",
+                                                          allocator.GetFootprintLimit())
+                             : nullptr),
       object_store_(object_store),
       allocator_(allocator) {}
 
 int64_t EvictionPolicy::ChooseObjectsToEvict(int64_t num_bytes_required,
                                              std::vector<ObjectID> &objects_to_evict) {
-  int64_t bytes_evicted =
-      cache_.ChooseObjectsToEvict(num_bytes_required, objects_to_evict);
-  // Update the LRU cache.
+  int64_t bytes_evicted = 0;
+  if (replaceable_cache_) {
+    bytes_evicted +=
+        replaceable_cache_->ChooseObjectsToEvict(num_bytes_required, objects_to_evict);
+  }
+  if (bytes_evicted < num_bytes_required) {
+    bytes_evicted += cache_->ChooseObjectsToEvict(num_bytes_required - bytes_evicted,
+                                                  objects_to_evict);
+  }
+  // Update the cache.
   for (auto &object_id : objects_to_evict) {
-    cache_.Remove(object_id);
+    GetCache(object_id).Remove(object_id);
   }
   return bytes_evicted;
 }
 
 void EvictionPolicy::ObjectCreated(const ObjectID &object_id) {
-  cache_.Add(object_id, GetObjectSize(object_id));
+  auto object = object_store_.GetObject(object_id);
+  if (replaceable_cache_) {
+    switch (object->GetSource()) {
+    case flatbuf::ObjectSource::ReceivedFromRemoteRaylet:
+      replaceable_objects_[object_id] = ObjectProvenance::kSecondary;
+      break;
+    case flatbuf::ObjectSource::RestoredFromStorage:
+      replaceable_objects_[object_id] = ObjectProvenance::kSpilled;
+      break;
+    default:
+      break;
+    }
+  }
+  GetCache(object_id).Add(object_id, object->GetObjectSize());
 }
 
 int64_t EvictionPolicy::RequireSpace(int64_t size,
@@ -131,21 +362,54 @@ int64_t EvictionPolicy::RequireSpace(int64_t size,
 }
 
 void EvictionPolicy::BeginObjectAccess(const ObjectID &object_id) {
-  // If the object is in the LRU cache, remove it.
-  cache_.Remove(object_id);
-  pinned_memory_bytes_ += GetObjectSize(object_id);
+  // If the object is in the cache, remove it.
+  GetCache(object_id).Remove(object_id);
+  auto object = object_store_.GetObject(object_id);
+  // The creator of an object uses it before it is sealed, which is not a real
+  // access.
+  if (object->Sealed()) {
+    cache_->OnAccess(object_id);
+  }
+  pinned_memory_bytes_ += object->GetObjectSize();
 }
 
 void EvictionPolicy::EndObjectAccess(const ObjectID &object_id) {
   auto size = GetObjectSize(object_id);
-  // Add the object to the LRU cache.
-  cache_.Add(object_id, size);
+  // Add the object to the cache.
+  GetCache(object_id).Add(object_id, size);
   pinned_memory_bytes_ -= size;
 }
 
 void EvictionPolicy::RemoveObject(const ObjectID &object_id) {
-  // If the object is in the LRU cache, remove it.
-  cache_.Remove(object_id);
+  // If the object is in the cache, remove it.
+  GetCache(object_id).Remove(object_id);
+  // The main cache keeps the access history of all objects.
+  cache_->OnDelete(object_id);
+  replaceable_objects_.erase(object_id);
+}
+
+void EvictionPolicy::SetObjectProvenance(const ObjectID &object_id,
+                                         ObjectProvenance provenance) {
+  if (!replaceable_cache_) {
+    return;
+  }
+  // Move the object to its new cache if it is evictable.
+  int64_t size = GetCache(object_id).Remove(object_id);
+  if (provenance == ObjectProvenance::kPrimary) {
+    replaceable_objects_.erase(object_id);
+  } else {
+    replaceable_objects_[object_id] = provenance;
+  }
+  if (size >= 0) {
+    GetCache(object_id).Add(object_id, size);
+  }
+}
+
+EvictionCache &EvictionPolicy::GetCache(const ObjectID &object_id) {
+  if (replaceable_cache_ && replaceable_objects_.contains(object_id)) {
+    return *replaceable_cache_;
+  }
+  return *cache_;
 }
 
 int64_t EvictionPolicy::GetObjectSize(const ObjectID &object_id) const {
@@ -153,8 +417,16 @@ int64_t EvictionPolicy::GetObjectSize(const ObjectID &object_id) const {
 }
 
 bool EvictionPolicy::IsObjectExists(const ObjectID &object_id) const {
-  return cache_.Exists(object_id);
+  return cache_->Exists(object_id) ||
+         (replaceable_cache_ && replaceable_cache_->Exists(object_id));
 }
 
-std::string EvictionPolicy::DebugString() const { return cache_.DebugString(); }
+std::string EvictionPolicy::DebugString() const {
+  std::stringstream result;
+  result << cache_->DebugString();
+  if (replaceable_cache_) {
+    result << replaceable_cache_->DebugString();
+  }
+  return result.str();
+}
 }  // namespace plasma
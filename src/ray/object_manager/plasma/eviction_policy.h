@@ -25,11 +25,14 @@
 
 #include <functional>
 #include <list>
+#include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "ray/object_manager/plasma/common.h"
 #include "ray/object_manager/plasma/object_store.h"
 #include "ray/object_manager/plasma/plasma.h"
@@ -37,6 +40,18 @@
 
 namespace plasma {
 
+/// How the evictable copy of an object relates to its other copies, which decides
+/// how expensive it is to get the object back once the copy is evicted.
+enum class ObjectProvenance {
+  /// The copy created by a worker. Unless the object was spilled, evicting it
+  /// loses the object until it is reconstructed.
+  kPrimary,
+  /// A copy pulled from another node, which can be pulled again.
+  kSecondary,
+  /// A copy of an object that was spilled or compressed, which can be restored.
+  kSpilled,
+};
+
 /// The eviction policy interface.
 class IEvictionPolicy {
  public:
@@ -98,11 +113,74 @@ class IEvictionPolicy {
   /// \param object_id The ID of the object that is now being used.
   virtual void RemoveObject(const ObjectID &object_id) = 0;
 
+  /// This method will be called when another copy of the object appears, e.g.,
+  /// when the object is spilled or its primary copy moves to another node.
+  ///
+  /// \param object_id The ID of the object.
+  /// \param provenance What the local copy of the object is now.
+  virtual void SetObjectProvenance(const ObjectID &object_id,
+                                   ObjectProvenance provenance) = 0;
+
   /// Returns debugging information for this eviction policy.
   virtual std::string DebugString() const = 0;
 };
 
-class LRUCache {
+/// The ordering of evictable objects used by EvictionPolicy. Objects are added
+/// to the cache when they become evictable (i.e., no client is using them), and
+/// removed when a client starts using them again or when they are deleted.
+///
+/// Implementations decide which objects are evicted first. They may keep
+/// history about objects that are not currently in the cache (e.g., access
+/// counts), which is dropped once OnDelete is called.
+class EvictionCache {
+ public:
+  virtual ~EvictionCache() = default;
+
+  /// Add an evictable object to the cache.
+  virtual void Add(const ObjectID &key, int64_t size) = 0;
+
+  /// Remove an object from the cache.
+  ///
+  /// \return The size of the removed object, or -1 if it wasn't in the cache.
+  virtual int64_t Remove(const ObjectID &key) = 0;
+
+  /// Called when a client starts using a sealed object.
+  virtual void OnAccess(const ObjectID &key) {}
+
+  /// Called when an object is deleted from the store.
+  virtual void OnDelete(const ObjectID &key) {}
+
+  /// Choose objects to evict without removing them from the cache.
+  ///
+  /// \param num_bytes_required The number of bytes of space to try to free up.
+  /// \param objects_to_evict The object IDs that were chosen for eviction will
+  ///        be stored into this vector.
+  /// \return The total number of bytes of space chosen to be evicted.
+  virtual int64_t ChooseObjectsToEvict(int64_t num_bytes_required,
+                                       std::vector<ObjectID> &objects_to_evict) = 0;
+
+  virtual bool Exists(const ObjectID &key) const = 0;
+
+  virtual std::string DebugString() const = 0;
+};
+
+/// Creates an eviction cache with the given capacity in bytes.
+using EvictionCacheFactory =
+    std::function<std::unique_ptr<EvictionCache>(int64_t capacity)>;
+
+/// Register an eviction cache under a name that can be selected through the
+/// plasma_eviction_policy config. Built-in caches are "lru", "gdsf" and "2q".
+/// This is not thread safe, and must be called before the store starts.
+void RegisterEvictionCache(const std::string &name, EvictionCacheFactory factory);
+
+/// Create the eviction cache registered under the given name.
+///
+/// \return The cache, or nullptr if no cache is registered with that name.
+std::unique_ptr<EvictionCache> CreateEvictionCache(const std::string &name,
+                                                   int64_t capacity);
+
+/// Evicts the least recently used object first.
+class LRUCache : public EvictionCache {
  public:
   LRUCache(const std::string &name, int64_t size)
       : name_(name),
@@ -112,12 +190,12 @@ class LRUCache {
         num_evictions_total_(0),
         bytes_evicted_total_(0) {}
 
-  void Add(const ObjectID &key, int64_t size);
+  void Add(const ObjectID &key, int64_t size) override;
 
-  int64_t Remove(const ObjectID &key);
+  int64_t Remove(const ObjectID &key) override;
 
   int64_t ChooseObjectsToEvict(int64_t num_bytes_required,
-                               std::vector<ObjectID> &objects_to_evict);
+                               std::vector<ObjectID> &objects_to_evict) override;
 
   int64_t OriginalCapacity() const;
 
@@ -129,18 +207,34 @@ class LRUCache {
 
   void Foreach(std::function<void(const ObjectID &)>);
 
-  bool Exists(const ObjectID &key) const;
+  bool Exists(const ObjectID &key) const override;
 
-  std::string DebugString() const;
+  std::string DebugString() const override;
 
  private:
-  /// A doubly-linked list containing the items in the cache and
-  /// their sizes in LRU order.
-  typedef std::list<std::pair<ObjectID, int64_t>> ItemList;
-  ItemList item_list_;
-  /// A hash table mapping the object ID of an object in the cache to its
-  /// location in the doubly linked list item_list_.
-  std::unordered_map<ObjectID, ItemList::iterator> item_map_;
+  /// An item of the cache, linked to its neighbours in LRU order by handle.
+  struct Item {
+    ObjectID key;
+    int64_t size;
+    int32_t prev;
+    int32_t next;
+  };
+
+  /// Unlink the item from the LRU order and free its slot.
+  void RemoveItem(int32_t handle);
+
+  /// The items in the cache, indexed by handle. Slots of removed items are
+  /// reused, so the items of a cache with millions of objects take a single
+  /// allocation instead of a list node each.
+  std::vector<Item> items_;
+  /// Handles of the slots in items_ that are not in use.
+  std::vector<int32_t> free_items_;
+  /// The most and least recently used items, or -1 if the cache is empty.
+  int32_t head_ = -1;
+  int32_t tail_ = -1;
+  /// A hash table mapping the object ID of an object in the cache to the
+  /// handle of its item.
+  absl::flat_hash_map<ObjectID, int32_t> item_map_;
 
   /// The name of this cache, used for debugging purposes only.
   const std::string name_;
@@ -156,10 +250,122 @@ class LRUCache {
   int64_t bytes_evicted_total_;
 };
 
-/// The eviction policy implementation
+/// Greedy-Dual-Size-Frequency. Each object gets the priority
+/// L + access_count / size, where L is the priority of the last evicted
+/// object, and the object with the lowest priority is evicted first. Large,
+/// rarely used objects are evicted before small, hot ones, and L ages out
+/// objects that used to be hot.
+class GDSFCache : public EvictionCache {
+ public:
+  explicit GDSFCache(const std::string &name) : name_(name) {}
+
+  void Add(const ObjectID &key, int64_t size) override;
+
+  int64_t Remove(const ObjectID &key) override;
+
+  void OnAccess(const ObjectID &key) override;
+
+  void OnDelete(const ObjectID &key) override;
+
+  int64_t ChooseObjectsToEvict(int64_t num_bytes_required,
+                               std::vector<ObjectID> &objects_to_evict) override;
+
+  bool Exists(const ObjectID &key) const override;
+
+  std::string DebugString() const override;
+
+ private:
+  typedef std::multimap<double, std::pair<ObjectID, int64_t>> PriorityQueue;
+  /// The objects in the cache ordered by priority, lowest first.
+  PriorityQueue queue_;
+  /// A hash table mapping the object ID of an object in the cache to its
+  /// location in queue_.
+  absl::flat_hash_map<ObjectID, PriorityQueue::iterator> item_map_;
+  /// The number of times each object in the store has been accessed.
+  absl::flat_hash_map<ObjectID, int64_t> access_counts_;
+  /// The priority of the last evicted object.
+  double inflation_ = 0;
+  /// The name of this cache, used for debugging purposes only.
+  const std::string name_;
+  /// The number of objects evicted from this cache.
+  int64_t num_evictions_total_ = 0;
+  /// The number of bytes evicted from this cache.
+  int64_t bytes_evicted_total_ = 0;
+};
+
+/// 2Q. Objects that have been accessed fewer than kPromotionThreshold times
+/// wait in a FIFO probation queue, which is evicted first as long as it holds
+/// more than a quarter of the capacity. Objects accessed more often, or
+/// recreated shortly after being evicted, live in an LRU protected queue. Scans
+/// that touch each object once can therefore not flush the hot set.
+class TwoQueueCache : public EvictionCache {
+ public:
+  TwoQueueCache(const std::string &name, int64_t capacity)
+      : name_(name), capacity_(capacity) {}
+
+  void Add(const ObjectID &key, int64_t size) override;
+
+  int64_t Remove(const ObjectID &key) override;
+
+  void OnAccess(const ObjectID &key) override;
+
+  void OnDelete(const ObjectID &key) override;
+
+  int64_t ChooseObjectsToEvict(int64_t num_bytes_required,
+                               std::vector<ObjectID> &objects_to_evict) override;
+
+  bool Exists(const ObjectID &key) const override;
+
+  std::string DebugString() const override;
+
+ private:
+  /// The number of accesses after which an object is protected.
+  static constexpr int64_t kPromotionThreshold = 2;
+  /// The number of evicted objects remembered, so that they are protected if
+  /// they are created again.
+  static constexpr size_t kMaxGhostEntries = 100000;
+
+  typedef std::list<std::pair<ObjectID, int64_t>> ItemList;
+  struct Entry {
+    bool is_protected;
+    ItemList::iterator it;
+  };
+  /// Objects on probation, most recently added first.
+  ItemList probation_;
+  /// Protected objects, most recently used first.
+  ItemList protected_;
+  /// A hash table mapping the object ID of an object in the cache to its
+  /// queue and location.
+  absl::flat_hash_map<ObjectID, Entry> item_map_;
+  /// The number of times each object in the store has been accessed.
+  absl::flat_hash_map<ObjectID, int64_t> access_counts_;
+  /// Recently deleted objects, most recently deleted first.
+  std::list<ObjectID> ghosts_;
+  absl::flat_hash_map<ObjectID, std::list<ObjectID>::iterator> ghost_map_;
+  int64_t probation_bytes_ = 0;
+  /// The name of this cache, used for debugging purposes only.
+  const std::string name_;
+  /// The capacity of the store in bytes.
+  const int64_t capacity_;
+  /// The number of objects evicted from this cache.
+  int64_t num_evictions_total_ = 0;
+  /// The number of bytes evicted from this cache.
+  int64_t bytes_evicted_total_ = 0;
+};
+
+/// The eviction policy implementation.
+///
+/// If replaceable copies are preferred, secondary and spilled copies are kept in an
+/// LRU cache of their own, which is evicted before the objects in the main cache.
+/// Evicting them only costs a pull or a restore if the object is needed again.
 class EvictionPolicy : public IEvictionPolicy {
  public:
-  EvictionPolicy(const IObjectStore &object_store, const IAllocator &allocator);
+  /// \param cache The cache ordering evictable objects. Defaults to LRU.
+  /// \param prefer_replaceable_copies Whether to evict secondary and spilled copies
+  /// before the primary copies.
+  EvictionPolicy(const IObjectStore &object_store, const IAllocator &allocator,
+                 std::unique_ptr<EvictionCache> cache = nullptr,
+                 bool prefer_replaceable_copies = false);
 
   void ObjectCreated(const ObjectID &object_id) override;
 
@@ -174,20 +380,32 @@ class EvictionPolicy : public IEvictionPolicy {
 
   void RemoveObject(const ObjectID &object_id) override;
 
+  void SetObjectProvenance(const ObjectID &object_id,
+                           ObjectProvenance provenance) override;
+
   std::string DebugString() const override;
 
  private:
   /// Returns the size of the object
   int64_t GetObjectSize(const ObjectID &object_id) const;
 
+  /// Returns the cache the object belongs in while it is evictable.
+  EvictionCache &GetCache(const ObjectID &object_id);
+
   /// Returns whether the object exist in cache or not
   bool IsObjectExists(const ObjectID &object_id) const;
 
   /// The number of bytes pinned by applications.
   int64_t pinned_memory_bytes_;
 
-  /// Datastructure for the LRU cache.
-  LRUCache cache_;
+  /// Datastructure for the evictable objects.
+  std::unique_ptr<EvictionCache> cache_;
+
+  /// The evictable secondary and spilled copies, if they are evicted first.
+  std::unique_ptr<LRUCache> replaceable_cache_;
+
+  /// The objects in the store whose local copy is not the primary copy.
+  absl::flat_hash_map<ObjectID, ObjectProvenance> replaceable_objects_;
 
   const IObjectStore &object_store_;
 
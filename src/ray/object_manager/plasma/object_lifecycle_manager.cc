@@ -23,13 +23,34 @@
 namespace plasma {
 using namespace flatbuf;
 
+namespace {
+std::unique_ptr<EvictionCache> CreateConfiguredEvictionCache(
+    const IAllocator &allocator) {
+  const auto &policy = RayConfig::instance().plasma_eviction_policy();
+  auto cache = CreateEvictionCache(policy, allocator.GetFootprintLimit());
+  RAY_CHECK(cache != nullptr) << "Unknown plasma eviction policy: " << policy;
+  return cache;
+}
+
+int64_t GetConfiguredJobMemoryQuota(const IAllocator &allocator) {
+  auto fraction = RayConfig::instance().plasma_job_memory_quota_fraction();
+  if (fraction <= 0 || fraction >= 1) {
+    return -1;
+  }
+  return static_cast<int64_t>(fraction * allocator.GetFootprintLimit());
+}
+}  // namespace
+
 ObjectLifecycleManager::ObjectLifecycleManager(
     IAllocator &allocator, ray::DeleteObjectCallback delete_object_callback)
     : object_store_(std::make_unique<ObjectStore>(allocator)),
-      eviction_policy_(std::make_unique<EvictionPolicy>(*object_store_, allocator)),
+      eviction_policy_(std::make_unique<EvictionPolicy>(
+          *object_store_, allocator, CreateConfiguredEvictionCache(allocator),
+          RayConfig::instance().plasma_evict_replaceable_copies_first())),
       delete_object_callback_(delete_object_callback),
       earger_deletion_objects_(),
       num_bytes_in_use_(0),
+      job_memory_quota_(GetConfiguredJobMemoryQuota(allocator)),
       stats_collector_() {}
 
 std::pair<const LocalObject *, flatbuf::PlasmaError> ObjectLifecycleManager::CreateObject(
@@ -40,7 +61,14 @@ std::pair<const LocalObject *, flatbuf::PlasmaError> ObjectLifecycleManager::Cre
   if (object_store_->GetObject(object_info.object_id) != nullptr) {
     return {nullptr, PlasmaError::ObjectExists};
   }
-  auto entry = CreateObjectInternal(object_info, source, fallback_allocator);
+  const LocalObject *entry = nullptr;
+  if (ExceedsJobQuota(object_info, source)) {
+    RAY_LOG(DEBUG) << "Object " << object_info.object_id << " exceeds the memory quota "
+                   << "of its job, falling back to allocating from filesystem.";
+    entry = object_store_->CreateObject(object_info, source, /*fallback_allocate*/ true);
+  } else {
+    entry = CreateObjectInternal(object_info, source, fallback_allocator);
+  }
 
   if (entry == nullptr) {
     return {nullptr, PlasmaError::OutOfMemory};
@@ -133,6 +161,7 @@ bool ObjectLifecycleManager::AddReference(const ObjectID &object_id) {
   }
   // Increase reference count.
   entry->ref_count++;
+  entry->num_accesses++;
   RAY_LOG(DEBUG) << "Object " << object_id << " reference has incremented"
                  << ", num bytes in use is now " << num_bytes_in_use_;
   stats_collector_.OnObjectRefIncreased(*entry);
@@ -169,6 +198,15 @@ bool ObjectLifecycleManager::RemoveReference(const ObjectID &object_id) {
   return true;
 }
 
+void ObjectLifecycleManager::SetObjectProvenance(const ObjectID &object_id,
+                                                 ObjectProvenance provenance) {
+  if (object_store_->GetObject(object_id) == nullptr) {
+    // The object was already evicted or deleted.
+    return;
+  }
+  eviction_policy_->SetObjectProvenance(object_id, provenance);
+}
+
 std::string ObjectLifecycleManager::EvictionPolicyDebugString() const {
   return eviction_policy_->DebugString();
 }
@@ -217,6 +255,19 @@ const LocalObject *ObjectLifecycleManager::CreateObjectInternal(
   return result;
 }
 
+bool ObjectLifecycleManager::ExceedsJobQuota(const ray::ObjectInfo &object_info,
+                                             plasma::flatbuf::ObjectSource source) const {
+  // Only limit the objects a job creates itself. Restored and pulled objects are
+  // needed by tasks that are about to run.
+  if (job_memory_quota_ < 0 || source != ObjectSource::CreatedByWorker) {
+    return false;
+  }
+  auto usage = stats_collector_.GetJobUsage(
+      ObjectStatsCollector::GetJobId(object_info.object_id));
+  auto num_bytes_in_shared_memory = usage.num_bytes - usage.num_bytes_fallback_allocated;
+  return num_bytes_in_shared_memory + object_info.GetObjectSize() > job_memory_quota_;
+}
+
 void ObjectLifecycleManager::EvictObjects(const std::vector<ObjectID> &object_ids) {
   for (const auto &object_id : object_ids) {
     RAY_LOG(DEBUG) << "evicting object " << object_id.Hex();
@@ -270,6 +321,11 @@ int64_t ObjectLifecycleManager::GetNumObjectsUnsealed() const {
   return object_store_->GetNumObjectsUnsealed();
 }
 
+ObjectStatsCollector::JobUsage ObjectLifecycleManager::GetJobUsage(
+    const ray::JobID &job_id) const {
+  return stats_collector_.GetJobUsage(job_id);
+}
+
 void ObjectLifecycleManager::GetDebugDump(std::stringstream &buffer) const {
   return stats_collector_.GetDebugDump(buffer);
 }
@@ -277,12 +333,13 @@ void ObjectLifecycleManager::GetDebugDump(std::stringstream &buffer) const {
 // For test only.
 ObjectLifecycleManager::ObjectLifecycleManager(
     std::unique_ptr<IObjectStore> store, std::unique_ptr<IEvictionPolicy> eviction_policy,
-    ray::DeleteObjectCallback delete_object_callback)
+    ray::DeleteObjectCallback delete_object_callback, int64_t job_memory_quota)
     : object_store_(std::move(store)),
       eviction_policy_(std::move(eviction_policy)),
       delete_object_callback_(delete_object_callback),
       earger_deletion_objects_(),
       num_bytes_in_use_(0),
+      job_memory_quota_(job_memory_quota),
       stats_collector_() {}
 
 }  // namespace plasma
@@ -30,6 +30,10 @@ namespace plasma {
 // ObjectLifecycleManager allocates LocalObjects from the allocator.
 // It tracks object’s lifecycle states such as reference count or object states
 // (created/sealed). It lazily garbage collects objects when running out of space.
+//
+// Objects created by the workers of a job that is over its memory quota skip the
+// shared memory and go straight to the fallback allocator, so that a single job
+// can't evict the objects of other jobs or force them to spill.
 class ObjectLifecycleManager {
  public:
   ObjectLifecycleManager(IAllocator &allocator,
@@ -40,7 +44,8 @@ class ObjectLifecycleManager {
   ///
   /// \param object_info Plasma object info.
   /// \param source From where the object is created.
-  /// \param fallback_allocator Whether to allow fallback allocation.
+  /// \param fallback_allocator Whether to allow fallback allocation. Objects over
+  /// the quota of their job are fallback allocated regardless.
   /// \return
   ///   - pointer to created object and PlasmaError::OK when succeeds.
   ///   - nullptr and error message, including ObjectExists/OutOfMemory
@@ -104,6 +109,10 @@ class ObjectLifecycleManager {
   /// \return The number of bytes evicted.
   int64_t RequireSpace(int64_t size);
 
+  /// Tell the eviction policy what the local copy of the object is, e.g., that
+  /// the object was spilled. Does nothing if the object doesn't exist.
+  void SetObjectProvenance(const ObjectID &object_id, ObjectProvenance provenance);
+
   std::string EvictionPolicyDebugString() const;
 
   bool IsObjectSealed(const ObjectID &object_id) const;
@@ -116,13 +125,21 @@ class ObjectLifecycleManager {
 
   int64_t GetNumObjectsUnsealed() const;
 
+  /// Get the plasma usage of a job.
+  ObjectStatsCollector::JobUsage GetJobUsage(const ray::JobID &job_id) const;
+
   void GetDebugDump(std::stringstream &buffer) const;
 
  private:
   // Test only
   ObjectLifecycleManager(std::unique_ptr<IObjectStore> store,
                          std::unique_ptr<IEvictionPolicy> eviction_policy,
-                         ray::DeleteObjectCallback delete_object_callback);
+                         ray::DeleteObjectCallback delete_object_callback,
+                         int64_t job_memory_quota = -1);
+
+  // Whether creating the object would take its job over the memory quota.
+  bool ExceedsJobQuota(const ray::ObjectInfo &object_info,
+                       plasma::flatbuf::ObjectSource source) const;
 
   const LocalObject *CreateObjectInternal(const ray::ObjectInfo &object_info,
                                           plasma::flatbuf::ObjectSource source,
@@ -152,6 +169,10 @@ class ObjectLifecycleManager {
   // Total bytes of the objects whose references are greater than 0.
   int64_t num_bytes_in_use_;
 
+  // The maximum number of bytes of shared memory the objects created by the
+  // workers of a single job may take. -1 means there is no quota.
+  const int64_t job_memory_quota_;
+
   ObjectStatsCollector stats_collector_;
 };
 
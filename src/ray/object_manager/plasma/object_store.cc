@@ -17,11 +17,19 @@
 
 #include "ray/object_manager/plasma/object_store.h"
 
+#include "ray/util/util.h"
+
 namespace plasma {
 
 ObjectStore::ObjectStore(IAllocator &allocator)
     : allocator_(allocator), object_table_() {}
 
+ObjectStore::~ObjectStore() {
+  for (const auto &entry : object_table_) {
+    ObjectAt(entry.second)->~LocalObject();
+  }
+}
+
 const LocalObject *ObjectStore::CreateObject(const ray::ObjectInfo &object_info,
                                              plasma::flatbuf::ObjectSource source,
                                              bool fallback_allocate) {
@@ -38,14 +46,17 @@ const LocalObject *ObjectStore::CreateObject(const ray::ObjectInfo &object_info,
   if (!allocation.has_value()) {
     return nullptr;
   }
-  auto ptr = std::make_unique<LocalObject>(std::move(allocation.value()));
-  auto entry =
-      object_table_.emplace(object_info.object_id, std::move(ptr)).first->second.get();
+  auto handle = NewObject(std::move(allocation.value()));
+  object_table_.emplace(object_info.object_id, handle);
+  auto entry = ObjectAt(handle);
   entry->object_info = object_info;
   entry->state = ObjectState::PLASMA_CREATED;
   entry->create_time = std::time(nullptr);
   entry->construct_duration = -1;
+  entry->seal_time_ms = -1;
+  entry->num_accesses = 0;
   entry->source = source;
+  entry->fallback_allocated = fallback_allocate;
 
   num_objects_unsealed_++;
   num_bytes_unsealed_ += entry->GetObjectSize();
@@ -59,7 +70,7 @@ const LocalObject *ObjectStore::GetObject(const ObjectID &object_id) const {
   if (it == object_table_.end()) {
     return nullptr;
   }
-  return it->second.get();
+  return ObjectAt(it->second);
 }
 
 const LocalObject *ObjectStore::SealObject(const ObjectID &object_id) {
@@ -69,22 +80,26 @@ const LocalObject *ObjectStore::SealObject(const ObjectID &object_id) {
   }
   entry->state = ObjectState::PLASMA_SEALED;
   entry->construct_duration = std::time(nullptr) - entry->create_time;
+  entry->seal_time_ms = current_time_ms();
   num_objects_unsealed_--;
   num_bytes_unsealed_ -= entry->GetObjectSize();
   return entry;
 }
 
 bool ObjectStore::DeleteObject(const ObjectID &object_id) {
-  auto entry = GetMutableObject(object_id);
-  if (entry == nullptr) {
+  auto it = object_table_.find(object_id);
+  if (it == object_table_.end()) {
     return false;
   }
+  auto handle = it->second;
+  auto entry = ObjectAt(handle);
   if (entry->state == ObjectState::PLASMA_CREATED) {
     num_bytes_unsealed_ -= entry->GetObjectSize();
     num_objects_unsealed_--;
   }
   allocator_.Free(std::move(entry->allocation));
-  object_table_.erase(object_id);
+  object_table_.erase(it);
+  ReleaseObject(handle);
   return true;
 }
 
@@ -99,7 +114,31 @@ LocalObject *ObjectStore::GetMutableObject(const ObjectID &object_id) {
   if (it == object_table_.end()) {
     return nullptr;
   }
-  return it->second.get();
+  return ObjectAt(it->second);
+}
+
+LocalObject *ObjectStore::ObjectAt(ObjectHandle handle) const {
+  return reinterpret_cast<LocalObject *>(&slabs_[handle / kSlabSize][handle % kSlabSize]);
+}
+
+ObjectStore::ObjectHandle ObjectStore::NewObject(Allocation allocation) {
+  if (free_handles_.empty()) {
+    ObjectHandle first = slabs_.size() * kSlabSize;
+    slabs_.emplace_back(new Slot[kSlabSize]);
+    // Hand out the lowest handles first.
+    for (size_t i = kSlabSize; i > 0; i--) {
+      free_handles_.push_back(first + i - 1);
+    }
+  }
+  auto handle = free_handles_.back();
+  free_handles_.pop_back();
+  new (ObjectAt(handle)) LocalObject(std::move(allocation));
+  return handle;
+}
+
+void ObjectStore::ReleaseObject(ObjectHandle handle) {
+  ObjectAt(handle)->~LocalObject();
+  free_handles_.push_back(handle);
 }
 
 }  // namespace plasma
@@ -17,6 +17,10 @@
 
 #pragma once
 
+#include <memory>
+#include <type_traits>
+#include <vector>
+
 #include "absl/container/flat_hash_map.h"
 #include "ray/object_manager/plasma/allocator.h"
 #include "ray/object_manager/plasma/common.h"
@@ -81,6 +85,8 @@ class ObjectStore : public IObjectStore {
  public:
   explicit ObjectStore(IAllocator &allocator);
 
+  ~ObjectStore();
+
   const LocalObject *CreateObject(const ray::ObjectInfo &object_info,
                                   plasma::flatbuf::ObjectSource source,
                                   bool fallback_allocate) override;
@@ -100,13 +106,37 @@ class ObjectStore : public IObjectStore {
  private:
   friend struct ObjectStatsCollectorTest;
 
+  /// Index of a LocalObject in the slabs.
+  using ObjectHandle = uint32_t;
+
+  /// Number of LocalObjects per slab.
+  static constexpr size_t kSlabSize = 1024;
+
+  /// Uninitialized storage for one LocalObject.
+  using Slot = std::aligned_storage<sizeof(LocalObject), alignof(LocalObject)>::type;
+
   LocalObject *GetMutableObject(const ObjectID &object_id);
 
+  LocalObject *ObjectAt(ObjectHandle handle) const;
+
+  /// Construct a LocalObject in a free slot, adding a slab if there is none.
+  ObjectHandle NewObject(Allocation allocation);
+
+  /// Destroy the LocalObject of the handle and free its slot.
+  void ReleaseObject(ObjectHandle handle);
+
   /// Allocator that allocates memory.
   IAllocator &allocator_;
 
-  /// Mapping from ObjectIDs to information about the object.
-  absl::flat_hash_map<ObjectID, std::unique_ptr<LocalObject>> object_table_;
+  /// Mapping from ObjectIDs to the handles of their LocalObjects.
+  absl::flat_hash_map<ObjectID, ObjectHandle> object_table_;
+
+  /// LocalObjects are kept in slabs that are never moved or freed, so that pointers
+  /// to them stay valid and an object doesn't need a heap allocation of its own.
+  std::vector<std::unique_ptr<Slot[]>> slabs_;
+
+  /// Handles of the slots that are not in use.
+  std::vector<ObjectHandle> free_handles_;
 
   /// Total number of bytes allocated to objects that are created but not yet
   /// sealed.
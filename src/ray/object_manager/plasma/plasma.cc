@@ -22,6 +22,11 @@
 namespace plasma {
 
 LocalObject::LocalObject(Allocation allocation)
-    : allocation(std::move(allocation)), ref_count(0) {}
+    : allocation(std::move(allocation)),
+      ref_count(0),
+      seal_time_ms(-1),
+      num_accesses(0),
+      source(flatbuf::ObjectSource::CreatedByWorker),
+      fallback_allocated(false) {}
 
 }  // namespace plasma
@@ -0,0 +1,334 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A load generator for the plasma store. It starts a store in this process and forks
+// client processes that create, seal, get and release objects against it. The sizes of
+// the objects are drawn from a configurable distribution, so that the store can be
+// driven into eviction and fallback allocation. It reports the latency percentiles of
+// each operation and the throughput over all clients.
+//
+// Example:
+//   plasma_bench --num_clients=8 --object_sizes=lognormal:65536:2 \
+//       --object_store_memory=1000000000
+//
+// The clients are forked, so this is not supported on Windows.
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/strings/str_split.h"
+#include "absl/time/clock.h"
+#include "gflags/gflags.h"
+#include "ray/common/ray_config.h"
+#include "ray/object_manager/plasma/client.h"
+#include "ray/object_manager/plasma/store_runner.h"
+#include "ray/util/logging.h"
+#include "ray/util/util.h"
+
+#ifndef _WIN32
+
+DEFINE_string(store_socket_name, "", "The socket of the store. Defaults to a temp path.");
+DEFINE_int64(object_store_memory, 1000000000, "The memory of the store in bytes.");
+DEFINE_string(plasma_directory, "", "The shared memory directory of the store.");
+DEFINE_string(fallback_directory, "", "The directory of fallback allocations.");
+DEFINE_int32(num_clients, 4, "The number of client processes.");
+DEFINE_int32(num_objects, 10000, "The number of objects created by each client.");
+DEFINE_string(object_sizes, "fixed:1048576",
+              "The distribution of object sizes in bytes: fixed:<size>, "
+              "uniform:<min>:<max> or lognormal:<median>:<sigma>.");
+DEFINE_int32(pinned_objects, 0,
+             "The number of its most recent objects each client keeps a reference to. "
+             "Pinned objects cannot be evicted, so this drives the store into fallback "
+             "allocation.");
+DEFINE_string(ray_config, "{}", "A JSON object of Ray config overrides.");
+
+namespace plasma {
+
+namespace {
+
+enum Operation { CREATE = 0, SEAL, GET, RELEASE, NUM_OPERATIONS };
+
+const char *kOperationNames[] = {"Create", "Seal", "Get", "Release"};
+
+/// Draws object sizes from the distribution given by --object_sizes.
+class ObjectSizeDistribution {
+ public:
+  explicit ObjectSizeDistribution(const std::string &spec) {
+    std::vector<std::string> parts = absl::StrSplit(spec, ':');
+    type_ = parts[0];
+    if (type_ == "fixed" && parts.size() == 2) {
+      a_ = std::stod(parts[1]);
+    } else if ((type_ == "uniform" || type_ == "lognormal") && parts.size() == 3) {
+      a_ = std::stod(parts[1]);
+      b_ = std::stod(parts[2]);
+    } else {
+      RAY_LOG(FATAL) << "Invalid object size distribution " << spec;
+    }
+  }
+
+  int64_t Sample(std::mt19937_64 &gen) const {
+    if (type_ == "uniform") {
+      return std::uniform_int_distribution<int64_t>(static_cast<int64_t>(a_),
+                                                    static_cast<int64_t>(b_))(gen);
+    } else if (type_ == "lognormal") {
+      return std::max<int64_t>(
+          1, std::lognormal_distribution<double>(std::log(a_), b_)(gen));
+    }
+    return static_cast<int64_t>(a_);
+  }
+
+ private:
+  std::string type_;
+  double a_ = 0;
+  double b_ = 0;
+};
+
+/// The latencies of one client, in microseconds, and how long its run took.
+struct ClientResult {
+  std::vector<int64_t> latencies_us[NUM_OPERATIONS];
+  int64_t elapsed_us = 0;
+  int64_t bytes = 0;
+  int64_t num_failed = 0;
+};
+
+int64_t ElapsedUs(absl::Time start) {
+  return absl::ToInt64Microseconds(absl::Now() - start);
+}
+
+ClientResult RunClient(int client_index, const std::string &socket_name) {
+  ClientResult result;
+  PlasmaClient client;
+  RAY_CHECK_OK(client.Connect(socket_name, "", 0, /*num_retries=*/300));
+  const ObjectSizeDistribution sizes(FLAGS_object_sizes);
+  std::mt19937_64 gen(client_index);
+  ray::rpc::Address owner_address;
+  std::deque<std::vector<ObjectBuffer>> pinned;
+
+  const auto run_start = absl::Now();
+  for (int i = 0; i < FLAGS_num_objects; i++) {
+    const auto object_id = ObjectID::FromRandom();
+    const int64_t size = sizes.Sample(gen);
+    std::shared_ptr<Buffer> data;
+
+    auto start = absl::Now();
+    auto status = client.CreateAndSpillIfNeeded(object_id, owner_address, size, nullptr,
+                                                0, &data,
+                                                flatbuf::ObjectSource::CreatedByWorker);
+    result.latencies_us[CREATE].push_back(ElapsedUs(start));
+    if (!status.ok()) {
+      result.num_failed++;
+      continue;
+    }
+    // Touch the object, as a writer would.
+    if (size > 0) {
+      data->Data()[0] = 1;
+      data->Data()[size - 1] = 1;
+    }
+
+    start = absl::Now();
+    RAY_CHECK_OK(client.Seal(object_id));
+    result.latencies_us[SEAL].push_back(ElapsedUs(start));
+
+    start = absl::Now();
+    RAY_CHECK_OK(client.Release(object_id));
+    result.latencies_us[RELEASE].push_back(ElapsedUs(start));
+
+    std::vector<ObjectBuffer> buffers;
+    start = absl::Now();
+    RAY_CHECK_OK(client.Get({object_id}, /*timeout_ms=*/-1, &buffers,
+                            /*is_from_worker=*/false));
+    result.latencies_us[GET].push_back(ElapsedUs(start));
+    result.bytes += size;
+
+    if (FLAGS_pinned_objects > 0) {
+      // Keep a reference until the object falls out of the pinned window. The buffers
+      // release the object when the last copy of them is destroyed.
+      pinned.push_back(buffers);
+      if (static_cast<int>(pinned.size()) > FLAGS_pinned_objects) {
+        pinned.pop_front();
+      }
+    }
+    start = absl::Now();
+    buffers.clear();
+    result.latencies_us[RELEASE].push_back(ElapsedUs(start));
+  }
+  result.elapsed_us = ElapsedUs(run_start);
+  pinned.clear();
+  RAY_CHECK_OK(client.Disconnect());
+  return result;
+}
+
+void WriteAll(int fd, const void *data, size_t size) {
+  const char *bytes = static_cast<const char *>(data);
+  while (size > 0) {
+    ssize_t written = write(fd, bytes, size);
+    RAY_CHECK(written > 0);
+    bytes += written;
+    size -= written;
+  }
+}
+
+void ReadAll(int fd, void *data, size_t size) {
+  char *bytes = static_cast<char *>(data);
+  while (size > 0) {
+    ssize_t num_read = read(fd, bytes, size);
+    RAY_CHECK(num_read > 0) << "A client exited before reporting its results";
+    bytes += num_read;
+    size -= num_read;
+  }
+}
+
+void WriteResult(int fd, const ClientResult &result) {
+  WriteAll(fd, &result.elapsed_us, sizeof(result.elapsed_us));
+  WriteAll(fd, &result.bytes, sizeof(result.bytes));
+  WriteAll(fd, &result.num_failed, sizeof(result.num_failed));
+  for (const auto &latencies : result.latencies_us) {
+    const int64_t count = latencies.size();
+    WriteAll(fd, &count, sizeof(count));
+    WriteAll(fd, latencies.data(), count * sizeof(int64_t));
+  }
+}
+
+ClientResult ReadResult(int fd) {
+  ClientResult result;
+  ReadAll(fd, &result.elapsed_us, sizeof(result.elapsed_us));
+  ReadAll(fd, &result.bytes, sizeof(result.bytes));
+  ReadAll(fd, &result.num_failed, sizeof(result.num_failed));
+  for (auto &latencies : result.latencies_us) {
+    int64_t count;
+    ReadAll(fd, &count, sizeof(count));
+    latencies.resize(count);
+    ReadAll(fd, latencies.data(), count * sizeof(int64_t));
+  }
+  return result;
+}
+
+int64_t Percentile(const std::vector<int64_t> &sorted, double percentile) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  return sorted[std::min(sorted.size() - 1,
+                         static_cast<size_t>(sorted.size() * percentile / 100))];
+}
+
+void PrintReport(const std::vector<ClientResult> &results) {
+  int64_t max_elapsed_us = 0;
+  int64_t bytes = 0;
+  int64_t num_failed = 0;
+  std::vector<int64_t> latencies[NUM_OPERATIONS];
+  for (const auto &result : results) {
+    max_elapsed_us = std::max(max_elapsed_us, result.elapsed_us);
+    bytes += result.bytes;
+    num_failed += result.num_failed;
+    for (int op = 0; op < NUM_OPERATIONS; op++) {
+      latencies[op].insert(latencies[op].end(), result.latencies_us[op].begin(),
+                           result.latencies_us[op].end());
+    }
+  }
+  const double seconds = max_elapsed_us / 1e6;
+  const int64_t num_objects = latencies[GET].size();
+  std::cout << "Clients: " << results.size() << ", objects: " << num_objects
+            << ", failed creates: " << num_failed << "\n"
+            << "Throughput: " << static_cast<int64_t>(num_objects / seconds)
+            << " objects/s, " << static_cast<int64_t>(bytes / seconds / 1e6)
+            << " MB/s\n";
+  for (int op = 0; op < NUM_OPERATIONS; op++) {
+    std::sort(latencies[op].begin(), latencies[op].end());
+    std::cout << kOperationNames[op] << " latency (us): p50 = "
+              << Percentile(latencies[op], 50) << ", p99 = "
+              << Percentile(latencies[op], 99)
+              << ", max = " << (latencies[op].empty() ? 0 : latencies[op].back())
+              << "\n";
+  }
+}
+
+}  // namespace
+
+}  // namespace plasma
+
+int main(int argc, char *argv[]) {
+  InitShutdownRAII ray_log_shutdown_raii(ray::RayLog::StartRayLog,
+                                         ray::RayLog::ShutDownRayLog, argv[0],
+                                         ray::RayLogLevel::WARNING,
+                                         /*log_dir=*/"");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  RayConfig::instance().initialize(FLAGS_ray_config);
+  const std::string socket_name =
+      FLAGS_store_socket_name.empty()
+          ? "/tmp/plasma_bench_" + std::to_string(getpid())
+          : FLAGS_store_socket_name;
+
+  // Fork the clients before the store starts any thread. They retry connecting until
+  // the store is up.
+  std::vector<std::pair<pid_t, int>> clients;
+  for (int i = 0; i < FLAGS_num_clients; i++) {
+    int fds[2];
+    RAY_CHECK(pipe(fds) == 0);
+    pid_t pid = fork();
+    RAY_CHECK(pid >= 0);
+    if (pid == 0) {
+      close(fds[0]);
+      plasma::WriteResult(fds[1], plasma::RunClient(i, socket_name));
+      close(fds[1]);
+      _exit(0);
+    }
+    close(fds[1]);
+    clients.emplace_back(pid, fds[0]);
+  }
+
+  plasma::plasma_store_runner.reset(new plasma::PlasmaStoreRunner(
+      socket_name, FLAGS_object_store_memory, /*hugepages_enabled=*/false,
+      FLAGS_plasma_directory, FLAGS_fallback_directory));
+  std::thread store_thread(
+      &plasma::PlasmaStoreRunner::Start, plasma::plasma_store_runner.get(),
+      /*spill_objects_callback=*/[] { return false; },
+      /*object_store_full_callback=*/[] {},
+      /*add_object_callback=*/[](const ray::ObjectInfo &) {},
+      /*delete_object_callback=*/[](const ray::ObjectID &) {});
+
+  std::vector<plasma::ClientResult> results;
+  for (const auto &client : clients) {
+    results.push_back(plasma::ReadResult(client.second));
+    close(client.second);
+    waitpid(client.first, nullptr, 0);
+  }
+  plasma::PrintReport(results);
+
+  plasma::plasma_store_runner->Stop();
+  store_thread.join();
+  plasma::plasma_store_runner.reset();
+  gflags::ShutDownCommandLineFlags();
+  return 0;
+}
+
+#else
+
+int main(int argc, char *argv[]) {
+  std::cerr << "plasma_bench is not supported on Windows" << std::endl;
+  return 1;
+}
+
+#endif
@@ -190,64 +190,106 @@ Status SendCreateRetryRequest(const std::shared_ptr<StoreConn> &store_conn,
 Status SendCreateRequest(const std::shared_ptr<StoreConn> &store_conn, ObjectID object_id,
                          const ray::rpc::Address &owner_address, int64_t data_size,
                          int64_t metadata_size, flatbuf::ObjectSource source,
-                         int device_num, bool try_immediately) {
+                         int device_num, bool try_immediately,
+                         flatbuf::CreatePriority priority) {
   flatbuffers::FlatBufferBuilder fbb;
   auto message = fb::CreatePlasmaCreateRequest(
       fbb, fbb.CreateString(object_id.Binary()),
       fbb.CreateString(owner_address.raylet_id()),
       fbb.CreateString(owner_address.ip_address()), owner_address.port(),
       fbb.CreateString(owner_address.worker_id()), data_size, metadata_size, source,
-      device_num, try_immediately);
+      device_num, try_immediately, priority);
   return PlasmaSend(store_conn, MessageType::PlasmaCreateRequest, &fbb, message);
 }
 
+namespace {
+void ParseCreateRequest(const fb::PlasmaCreateRequest &message,
+                        ray::ObjectInfo *object_info, flatbuf::ObjectSource *source,
+                        int *device_num, flatbuf::CreatePriority *priority) {
+  object_info->data_size = message.data_size();
+  object_info->metadata_size = message.metadata_size();
+  object_info->object_id = ObjectID::FromBinary(message.object_id()->str());
+  object_info->owner_raylet_id = NodeID::FromBinary(message.owner_raylet_id()->str());
+  object_info->owner_ip_address = message.owner_ip_address()->str();
+  object_info->owner_port = message.owner_port();
+  object_info->owner_worker_id = WorkerID::FromBinary(message.owner_worker_id()->str());
+  *source = message.source();
+  *device_num = message.device_num();
+  *priority = message.priority();
+}
+
+flatbuffers::Offset<fb::PlasmaCreateReply> BuildCreateReply(
+    flatbuffers::FlatBufferBuilder *fbb, ObjectID object_id,
+    uint64_t retry_with_request_id, const PlasmaObject &object, PlasmaError error_code) {
+  auto object_string = fbb->CreateString(object_id.Binary());
+  fb::PlasmaCreateReplyBuilder crb(*fbb);
+  crb.add_object_id(object_string);
+  crb.add_retry_with_request_id(retry_with_request_id);
+  if (retry_with_request_id > 0) {
+    // The request is not finished yet, there is no object to return.
+    return crb.Finish();
+  }
+  PlasmaObjectSpec plasma_object(
+      FD2INT(object.store_fd.first), object.store_fd.second, object.data_offset,
+      object.data_size, object.metadata_offset, object.metadata_size, object.device_num);
+  crb.add_error(static_cast<PlasmaError>(error_code));
+  crb.add_plasma_object(&plasma_object);
+  crb.add_store_fd(FD2INT(object.store_fd.first));
+  crb.add_unique_fd_id(object.store_fd.second);
+  crb.add_mmap_size(object.mmap_size);
+  if (object.device_num != 0) {
+    RAY_LOG(FATAL) << "This should be unreachable.";
+  }
+  return crb.Finish();
+}
+
+Status ParseCreateReply(const fb::PlasmaCreateReply &message, ObjectID *object_id,
+                        uint64_t *retry_with_request_id, PlasmaObject *object,
+                        MEMFD_TYPE *store_fd, int64_t *mmap_size) {
+  *object_id = ObjectID::FromBinary(message.object_id()->str());
+  *retry_with_request_id = message.retry_with_request_id();
+  if (*retry_with_request_id > 0) {
+    // The client should retry the request.
+    return Status::OK();
+  }
+
+  object->store_fd.first = INT2FD(message.plasma_object()->segment_index());
+  object->store_fd.second = message.plasma_object()->unique_fd_id();
+  object->data_offset = message.plasma_object()->data_offset();
+  object->data_size = message.plasma_object()->data_size();
+  object->metadata_offset = message.plasma_object()->metadata_offset();
+  object->metadata_size = message.plasma_object()->metadata_size();
+
+  store_fd->first = INT2FD(message.store_fd());
+  store_fd->second = message.unique_fd_id();
+  *mmap_size = message.mmap_size();
+
+  object->device_num = message.plasma_object()->device_num();
+  return PlasmaErrorStatus(message.error());
+}
+}  // namespace
+
 void ReadCreateRequest(uint8_t *data, size_t size, ray::ObjectInfo *object_info,
-                       flatbuf::ObjectSource *source, int *device_num) {
+                       flatbuf::ObjectSource *source, int *device_num,
+                       flatbuf::CreatePriority *priority) {
   RAY_DCHECK(data);
   auto message = flatbuffers::GetRoot<fb::PlasmaCreateRequest>(data);
   RAY_DCHECK(VerifyFlatbuffer(message, data, size));
-  object_info->data_size = message->data_size();
-  object_info->metadata_size = message->metadata_size();
-  object_info->object_id = ObjectID::FromBinary(message->object_id()->str());
-  object_info->owner_raylet_id = NodeID::FromBinary(message->owner_raylet_id()->str());
-  object_info->owner_ip_address = message->owner_ip_address()->str();
-  object_info->owner_port = message->owner_port();
-  object_info->owner_worker_id = WorkerID::FromBinary(message->owner_worker_id()->str());
-  *source = message->source();
-  *device_num = message->device_num();
-  return;
+  ParseCreateRequest(*message, object_info, source, device_num, priority);
 }
 
 Status SendUnfinishedCreateReply(const std::shared_ptr<Client> &client,
                                  ObjectID object_id, uint64_t retry_with_request_id) {
   flatbuffers::FlatBufferBuilder fbb;
-  auto object_string = fbb.CreateString(object_id.Binary());
-  fb::PlasmaCreateReplyBuilder crb(fbb);
-  crb.add_object_id(object_string);
-  crb.add_retry_with_request_id(retry_with_request_id);
-  auto message = crb.Finish();
+  auto message =
+      BuildCreateReply(&fbb, object_id, retry_with_request_id, {}, PlasmaError::OK);
   return PlasmaSend(client, MessageType::PlasmaCreateReply, &fbb, message);
 }
 
 Status SendCreateReply(const std::shared_ptr<Client> &client, ObjectID object_id,
                        const PlasmaObject &object, PlasmaError error_code) {
   flatbuffers::FlatBufferBuilder fbb;
-  PlasmaObjectSpec plasma_object(
-      FD2INT(object.store_fd.first), object.store_fd.second, object.data_offset,
-      object.data_size, object.metadata_offset, object.metadata_size, object.device_num);
-  auto object_string = fbb.CreateString(object_id.Binary());
-  fb::PlasmaCreateReplyBuilder crb(fbb);
-  crb.add_error(static_cast<PlasmaError>(error_code));
-  crb.add_plasma_object(&plasma_object);
-  crb.add_object_id(object_string);
-  crb.add_retry_with_request_id(0);
-  crb.add_store_fd(FD2INT(object.store_fd.first));
-  crb.add_unique_fd_id(object.store_fd.second);
-  crb.add_mmap_size(object.mmap_size);
-  if (object.device_num != 0) {
-    RAY_LOG(FATAL) << "This should be unreachable.";
-  }
-  auto message = crb.Finish();
+  auto message = BuildCreateReply(&fbb, object_id, 0, object, error_code);
   return PlasmaSend(client, MessageType::PlasmaCreateReply, &fbb, message);
 }
 
@@ -257,26 +299,97 @@ Status ReadCreateReply(uint8_t *data, size_t size, ObjectID *object_id,
   RAY_DCHECK(data);
   auto message = flatbuffers::GetRoot<fb::PlasmaCreateReply>(data);
   RAY_DCHECK(VerifyFlatbuffer(message, data, size));
-  *object_id = ObjectID::FromBinary(message->object_id()->str());
-  *retry_with_request_id = message->retry_with_request_id();
-  if (*retry_with_request_id > 0) {
-    // The client should retry the request.
-    return Status::OK();
+  return ParseCreateReply(*message, object_id, retry_with_request_id, object, store_fd,
+                          mmap_size);
+}
+
+Status SendCreateBatchRequest(const std::shared_ptr<StoreConn> &store_conn,
+                              const std::vector<ObjectID> &object_ids,
+                              const ray::rpc::Address &owner_address,
+                              const std::vector<int64_t> &data_sizes,
+                              const std::vector<int64_t> &metadata_sizes,
+                              flatbuf::ObjectSource source, int device_num,
+                              flatbuf::CreatePriority priority) {
+  RAY_CHECK(object_ids.size() == data_sizes.size());
+  RAY_CHECK(object_ids.size() == metadata_sizes.size());
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<fb::PlasmaCreateRequest>> requests;
+  requests.reserve(object_ids.size());
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    requests.push_back(fb::CreatePlasmaCreateRequest(
+        fbb, fbb.CreateString(object_ids[i].Binary()),
+        fbb.CreateString(owner_address.raylet_id()),
+        fbb.CreateString(owner_address.ip_address()), owner_address.port(),
+        fbb.CreateString(owner_address.worker_id()), data_sizes[i], metadata_sizes[i],
+        source, device_num, /*try_immediately=*/false, priority));
   }
+  auto message = fb::CreatePlasmaCreateBatchRequest(
+      fbb, fbb.CreateVector(MakeNonNull(requests.data()), requests.size()));
+  return PlasmaSend(store_conn, MessageType::PlasmaCreateBatchRequest, &fbb, message);
+}
 
-  object->store_fd.first = INT2FD(message->plasma_object()->segment_index());
-  object->store_fd.second = message->plasma_object()->unique_fd_id();
-  object->data_offset = message->plasma_object()->data_offset();
-  object->data_size = message->plasma_object()->data_size();
-  object->metadata_offset = message->plasma_object()->metadata_offset();
-  object->metadata_size = message->plasma_object()->metadata_size();
+void ReadCreateBatchRequest(uint8_t *data, size_t size,
+                            std::vector<ray::ObjectInfo> *object_infos,
+                            std::vector<flatbuf::ObjectSource> *sources,
+                            std::vector<int> *device_nums,
+                            std::vector<flatbuf::CreatePriority> *priorities) {
+  RAY_DCHECK(data);
+  auto message = flatbuffers::GetRoot<fb::PlasmaCreateBatchRequest>(data);
+  RAY_DCHECK(VerifyFlatbuffer(message, data, size));
+  const auto num_requests = message->requests()->size();
+  object_infos->resize(num_requests);
+  sources->resize(num_requests);
+  device_nums->resize(num_requests);
+  priorities->resize(num_requests);
+  for (uoffset_t i = 0; i < num_requests; i++) {
+    ParseCreateRequest(*message->requests()->Get(i), &(*object_infos)[i],
+                       &(*sources)[i], &(*device_nums)[i], &(*priorities)[i]);
+  }
+}
 
-  store_fd->first = INT2FD(message->store_fd());
-  store_fd->second = message->unique_fd_id();
-  *mmap_size = message->mmap_size();
+Status SendCreateBatchReply(const std::shared_ptr<Client> &client,
+                            const std::vector<ObjectID> &object_ids,
+                            const std::vector<uint64_t> &retry_with_request_ids,
+                            const std::vector<PlasmaObject> &objects,
+                            const std::vector<PlasmaError> &errors) {
+  RAY_CHECK(object_ids.size() == retry_with_request_ids.size());
+  RAY_CHECK(object_ids.size() == objects.size());
+  RAY_CHECK(object_ids.size() == errors.size());
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<fb::PlasmaCreateReply>> replies;
+  replies.reserve(object_ids.size());
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    replies.push_back(BuildCreateReply(&fbb, object_ids[i], retry_with_request_ids[i],
+                                       objects[i], errors[i]));
+  }
+  auto message = fb::CreatePlasmaCreateBatchReply(
+      fbb, fbb.CreateVector(MakeNonNull(replies.data()), replies.size()));
+  return PlasmaSend(client, MessageType::PlasmaCreateBatchReply, &fbb, message);
+}
 
-  object->device_num = message->plasma_object()->device_num();
-  return PlasmaErrorStatus(message->error());
+Status ReadCreateBatchReply(uint8_t *data, size_t size, std::vector<ObjectID> *object_ids,
+                            std::vector<uint64_t> *retry_with_request_ids,
+                            std::vector<PlasmaObject> *objects,
+                            std::vector<MEMFD_TYPE> *store_fds,
+                            std::vector<int64_t> *mmap_sizes,
+                            std::vector<Status> *statuses) {
+  RAY_DCHECK(data);
+  auto message = flatbuffers::GetRoot<fb::PlasmaCreateBatchReply>(data);
+  RAY_DCHECK(VerifyFlatbuffer(message, data, size));
+  const auto num_replies = message->replies()->size();
+  object_ids->resize(num_replies);
+  retry_with_request_ids->resize(num_replies);
+  objects->resize(num_replies);
+  store_fds->resize(num_replies);
+  mmap_sizes->resize(num_replies);
+  statuses->clear();
+  statuses->reserve(num_replies);
+  for (uoffset_t i = 0; i < num_replies; i++) {
+    statuses->push_back(ParseCreateReply(
+        *message->replies()->Get(i), &(*object_ids)[i], &(*retry_with_request_ids)[i],
+        &(*objects)[i], &(*store_fds)[i], &(*mmap_sizes)[i]));
+  }
+  return Status::OK();
 }
 
 Status SendAbortRequest(const std::shared_ptr<StoreConn> &store_conn,
@@ -340,6 +453,55 @@ Status ReadSealReply(uint8_t *data, size_t size, ObjectID *object_id) {
   return PlasmaErrorStatus(message->error());
 }
 
+Status SendSealBatchRequest(const std::shared_ptr<StoreConn> &store_conn,
+                            const std::vector<ObjectID> &object_ids) {
+  flatbuffers::FlatBufferBuilder fbb;
+  auto message = fb::CreatePlasmaSealBatchRequest(
+      fbb, ToFlatbuffer(&fbb, object_ids.data(), object_ids.size()));
+  return PlasmaSend(store_conn, MessageType::PlasmaSealBatchRequest, &fbb, message);
+}
+
+Status ReadSealBatchRequest(uint8_t *data, size_t size,
+                            std::vector<ObjectID> *object_ids) {
+  RAY_DCHECK(data);
+  auto message = flatbuffers::GetRoot<fb::PlasmaSealBatchRequest>(data);
+  RAY_DCHECK(VerifyFlatbuffer(message, data, size));
+  ConvertToVector(message->object_ids(), object_ids,
+                  [](const flatbuffers::String &object_id) {
+                    return ObjectID::FromBinary(object_id.str());
+                  });
+  return Status::OK();
+}
+
+Status SendSealBatchReply(const std::shared_ptr<Client> &client,
+                          const std::vector<ObjectID> &object_ids,
+                          const std::vector<PlasmaError> &errors) {
+  RAY_CHECK(object_ids.size() == errors.size());
+  flatbuffers::FlatBufferBuilder fbb;
+  auto message = fb::CreatePlasmaSealBatchReply(
+      fbb, ToFlatbuffer(&fbb, object_ids.data(), object_ids.size()),
+      fbb.CreateVector(MakeNonNull(reinterpret_cast<const int32_t *>(errors.data())),
+                       object_ids.size()));
+  return PlasmaSend(client, MessageType::PlasmaSealBatchReply, &fbb, message);
+}
+
+Status ReadSealBatchReply(uint8_t *data, size_t size, std::vector<ObjectID> *object_ids,
+                          std::vector<PlasmaError> *errors) {
+  RAY_DCHECK(data);
+  auto message = flatbuffers::GetRoot<fb::PlasmaSealBatchReply>(data);
+  RAY_DCHECK(VerifyFlatbuffer(message, data, size));
+  ConvertToVector(message->object_ids(), object_ids,
+                  [](const flatbuffers::String &object_id) {
+                    return ObjectID::FromBinary(object_id.str());
+                  });
+  errors->clear();
+  errors->reserve(message->errors()->size());
+  for (uoffset_t i = 0; i < message->errors()->size(); i++) {
+    errors->push_back(static_cast<PlasmaError>(message->errors()->Get(i)));
+  }
+  return Status::OK();
+}
+
 // Release messages.
 
 Status SendReleaseRequest(const std::shared_ptr<StoreConn> &store_conn,
@@ -519,19 +681,52 @@ Status ReadEvictReply(uint8_t *data, size_t size, int64_t &num_bytes) {
   return Status::OK();
 }
 
+// Client ring setup messages.
+
+Status SendRingSetupRequest(const std::shared_ptr<StoreConn> &store_conn,
+                            int64_t capacity) {
+  flatbuffers::FlatBufferBuilder fbb;
+  auto message = fb::CreatePlasmaRingSetupRequest(fbb, capacity);
+  return PlasmaSend(store_conn, MessageType::PlasmaRingSetupRequest, &fbb, message);
+}
+
+Status ReadRingSetupRequest(uint8_t *data, size_t size, int64_t *capacity) {
+  RAY_DCHECK(data);
+  auto message = flatbuffers::GetRoot<fb::PlasmaRingSetupRequest>(data);
+  RAY_DCHECK(VerifyFlatbuffer(message, data, size));
+  *capacity = message->capacity();
+  return Status::OK();
+}
+
+Status SendRingSetupReply(const std::shared_ptr<Client> &client, int64_t capacity) {
+  flatbuffers::FlatBufferBuilder fbb;
+  auto message = fb::CreatePlasmaRingSetupReply(fbb, capacity);
+  return PlasmaSend(client, MessageType::PlasmaRingSetupReply, &fbb, message);
+}
+
+Status ReadRingSetupReply(uint8_t *data, size_t size, int64_t *capacity) {
+  RAY_DCHECK(data);
+  auto message = flatbuffers::GetRoot<fb::PlasmaRingSetupReply>(data);
+  RAY_DCHECK(VerifyFlatbuffer(message, data, size));
+  *capacity = message->capacity();
+  return Status::OK();
+}
+
 // Get messages.
 
 Status SendGetRequest(const std::shared_ptr<StoreConn> &store_conn,
                       const ObjectID *object_ids, int64_t num_objects, int64_t timeout_ms,
-                      bool is_from_worker) {
+                      bool is_from_worker, int64_t num_objects_to_wait_for) {
   flatbuffers::FlatBufferBuilder fbb;
   auto message = fb::CreatePlasmaGetRequest(
-      fbb, ToFlatbuffer(&fbb, object_ids, num_objects), timeout_ms, is_from_worker);
+      fbb, ToFlatbuffer(&fbb, object_ids, num_objects), timeout_ms, is_from_worker,
+      num_objects_to_wait_for);
   return PlasmaSend(store_conn, MessageType::PlasmaGetRequest, &fbb, message);
 }
 
 Status ReadGetRequest(uint8_t *data, size_t size, std::vector<ObjectID> &object_ids,
-                      int64_t *timeout_ms, bool *is_from_worker) {
+                      int64_t *timeout_ms, bool *is_from_worker,
+                      int64_t *num_objects_to_wait_for) {
   RAY_DCHECK(data);
   auto message = flatbuffers::GetRoot<fb::PlasmaGetRequest>(data);
   RAY_DCHECK(VerifyFlatbuffer(message, data, size));
@@ -541,6 +736,7 @@ Status ReadGetRequest(uint8_t *data, size_t size, std::vector<ObjectID> &object_
   }
   *timeout_ms = message->timeout_ms();
   *is_from_worker = message->is_from_worker();
+  *num_objects_to_wait_for = message->num_objects_to_wait_for();
   return Status::OK();
 }
 
@@ -80,10 +80,12 @@ Status SendCreateRetryRequest(const std::shared_ptr<StoreConn> &store_conn,
 Status SendCreateRequest(const std::shared_ptr<StoreConn> &store_conn, ObjectID object_id,
                          const ray::rpc::Address &owner_address, int64_t data_size,
                          int64_t metadata_size, flatbuf::ObjectSource source,
-                         int device_num, bool try_immediately);
+                         int device_num, bool try_immediately,
+                         flatbuf::CreatePriority priority);
 
 void ReadCreateRequest(uint8_t *data, size_t size, ray::ObjectInfo *object_info,
-                       flatbuf::ObjectSource *source, int *device_num);
+                       flatbuf::ObjectSource *source, int *device_num,
+                       flatbuf::CreatePriority *priority);
 
 Status SendUnfinishedCreateReply(const std::shared_ptr<Client> &client,
                                  ObjectID object_id, uint64_t retry_with_request_id);
@@ -95,6 +97,37 @@ Status ReadCreateReply(uint8_t *data, size_t size, ObjectID *object_id,
                        uint64_t *retry_with_request_id, PlasmaObject *object,
                        MEMFD_TYPE *store_fd, int64_t *mmap_size);
 
+Status SendCreateBatchRequest(const std::shared_ptr<StoreConn> &store_conn,
+                              const std::vector<ObjectID> &object_ids,
+                              const ray::rpc::Address &owner_address,
+                              const std::vector<int64_t> &data_sizes,
+                              const std::vector<int64_t> &metadata_sizes,
+                              flatbuf::ObjectSource source, int device_num,
+                              flatbuf::CreatePriority priority);
+
+void ReadCreateBatchRequest(uint8_t *data, size_t size,
+                            std::vector<ray::ObjectInfo> *object_infos,
+                            std::vector<flatbuf::ObjectSource> *sources,
+                            std::vector<int> *device_nums,
+                            std::vector<flatbuf::CreatePriority> *priorities);
+
+/// A retry_with_request_ids entry > 0 marks an unfinished request, for which
+/// the corresponding entries of objects and errors are ignored.
+Status SendCreateBatchReply(const std::shared_ptr<Client> &client,
+                            const std::vector<ObjectID> &object_ids,
+                            const std::vector<uint64_t> &retry_with_request_ids,
+                            const std::vector<PlasmaObject> &objects,
+                            const std::vector<PlasmaError> &errors);
+
+/// The result of each creation is stored in statuses. The returned status is
+/// only an error if the reply can't be read.
+Status ReadCreateBatchReply(uint8_t *data, size_t size, std::vector<ObjectID> *object_ids,
+                            std::vector<uint64_t> *retry_with_request_ids,
+                            std::vector<PlasmaObject> *objects,
+                            std::vector<MEMFD_TYPE> *store_fds,
+                            std::vector<int64_t> *mmap_sizes,
+                            std::vector<Status> *statuses);
+
 Status SendAbortRequest(const std::shared_ptr<StoreConn> &store_conn, ObjectID object_id);
 
 Status ReadAbortRequest(uint8_t *data, size_t size, ObjectID *object_id);
@@ -114,14 +147,28 @@ Status SendSealReply(const std::shared_ptr<Client> &client, ObjectID object_id,
 
 Status ReadSealReply(uint8_t *data, size_t size, ObjectID *object_id);
 
+Status SendSealBatchRequest(const std::shared_ptr<StoreConn> &store_conn,
+                            const std::vector<ObjectID> &object_ids);
+
+Status ReadSealBatchRequest(uint8_t *data, size_t size,
+                            std::vector<ObjectID> *object_ids);
+
+Status SendSealBatchReply(const std::shared_ptr<Client> &client,
+                          const std::vector<ObjectID> &object_ids,
+                          const std::vector<PlasmaError> &errors);
+
+Status ReadSealBatchReply(uint8_t *data, size_t size, std::vector<ObjectID> *object_ids,
+                          std::vector<PlasmaError> *errors);
+
 /* Plasma Get message functions. */
 
 Status SendGetRequest(const std::shared_ptr<StoreConn> &store_conn,
                       const ObjectID *object_ids, int64_t num_objects, int64_t timeout_ms,
-                      bool is_from_worker);
+                      bool is_from_worker, int64_t num_objects_to_wait_for);
 
 Status ReadGetRequest(uint8_t *data, size_t size, std::vector<ObjectID> &object_ids,
-                      int64_t *timeout_ms, bool *is_from_worker);
+                      int64_t *timeout_ms, bool *is_from_worker,
+                      int64_t *num_objects_to_wait_for);
 
 Status SendGetReply(const std::shared_ptr<Client> &client, ObjectID object_ids[],
                     std::unordered_map<ObjectID, PlasmaObject> &plasma_objects,
@@ -191,4 +238,15 @@ Status SendEvictReply(const std::shared_ptr<Client> &client, int64_t num_bytes);
 
 Status ReadEvictReply(uint8_t *data, size_t size, int64_t &num_bytes);
 
+/* Plasma client ring setup message functions. */
+
+Status SendRingSetupRequest(const std::shared_ptr<StoreConn> &store_conn,
+                            int64_t capacity);
+
+Status ReadRingSetupRequest(uint8_t *data, size_t size, int64_t *capacity);
+
+Status SendRingSetupReply(const std::shared_ptr<Client> &client, int64_t capacity);
+
+Status ReadRingSetupReply(uint8_t *data, size_t size, int64_t *capacity);
+
 }  // namespace plasma
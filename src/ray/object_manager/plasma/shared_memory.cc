@@ -6,7 +6,14 @@
 #include <sys/mman.h>
 #include <unistd.h>
 #endif
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
+
+#include <cstring>
 
+#include "ray/common/ray_config.h"
 #include "ray/object_manager/plasma/malloc.h"
 #include "ray/util/logging.h"
 
@@ -33,6 +40,11 @@ ClientMmapTableEntry::ClientMmapTableEntry(MEMFD_TYPE fd, int64_t map_size)
     RAY_LOG(FATAL) << "mmap failed";
   }
   close(fd.first);  // Closing this fd has an effect on performance.
+  if (RayConfig::instance().plasma_transparent_hugepages()) {
+    // Map the store's huge pages with huge page table entries in the client
+    // too, which cuts TLB misses when scanning large objects.
+    internal::AdviseHugePages(pointer_, length_);
+  }
 #endif
 }
 
@@ -53,4 +65,79 @@ ClientMmapTableEntry::~ClientMmapTableEntry() {
   }
 }
 
+namespace internal {
+
+#ifdef __linux__
+// MADV_POPULATE_WRITE was added in Linux 5.14.
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
+void AdviseHugePages(void *addr, size_t size) {
+#ifdef MADV_HUGEPAGE
+  if (madvise(addr, size, MADV_HUGEPAGE) != 0) {
+    RAY_LOG(WARNING) << "madvise(MADV_HUGEPAGE) failed: " << std::strerror(errno);
+  }
+#endif
+}
+
+bool SetNumaPolicy(void *addr, size_t size, const std::string &policy) {
+  // Call the syscalls directly to avoid depending on libnuma.
+  unsigned long nodemask[16] = {0};
+  const unsigned long max_node = sizeof(nodemask) * 8;
+  int mode;
+  if (policy == "local") {
+    unsigned cpu, node;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+      RAY_LOG(WARNING) << "getcpu failed: " << std::strerror(errno);
+      return false;
+    }
+    const unsigned bits = sizeof(unsigned long) * 8;
+    if (node >= max_node) {
+      return false;
+    }
+    nodemask[node / bits] |= 1UL << (node % bits);
+    mode = MPOL_BIND;
+  } else if (policy == "interleave") {
+    if (syscall(SYS_get_mempolicy, nullptr, nodemask, max_node, nullptr,
+                MPOL_F_MEMS_ALLOWED) != 0) {
+      RAY_LOG(WARNING) << "get_mempolicy failed: " << std::strerror(errno);
+      return false;
+    }
+    mode = MPOL_INTERLEAVE;
+  } else {
+    RAY_LOG(FATAL) << "Unknown plasma NUMA policy: " << policy;
+    return false;
+  }
+  if (syscall(SYS_mbind, addr, size, mode, nodemask, max_node, 0) != 0) {
+    RAY_LOG(WARNING) << "mbind failed: " << std::strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+void PrefaultRegion(void *addr, size_t size) {
+  if (madvise(addr, size, MADV_POPULATE_WRITE) == 0) {
+    return;
+  }
+  // Older kernels: touch every page. The region was just created, so its
+  // contents are all zeros.
+  const size_t page_size = sysconf(_SC_PAGESIZE);
+  volatile uint8_t *pointer = static_cast<uint8_t *>(addr);
+  for (size_t offset = 0; offset < size; offset += page_size) {
+    pointer[offset] = 0;
+  }
+}
+#else
+void AdviseHugePages(void *addr, size_t size) {}
+
+bool SetNumaPolicy(void *addr, size_t size, const std::string &policy) {
+  RAY_LOG(WARNING) << "NUMA placement of plasma memory is only supported on Linux.";
+  return false;
+}
+
+void PrefaultRegion(void *addr, size_t size) {}
+#endif
+
+}  // namespace internal
 }  // namespace plasma
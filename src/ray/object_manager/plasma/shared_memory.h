@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <string>
 #include <utility>
 
 #include "ray/object_manager/plasma/compat.h"
@@ -30,4 +31,25 @@ class ClientMmapTableEntry {
   RAY_DISALLOW_COPY_AND_ASSIGN(ClientMmapTableEntry);
 };
 
+/// Placement of the memory that backs the object store. These are no-ops on
+/// platforms other than Linux.
+namespace internal {
+/// Ask the kernel to back the region with transparent huge pages. This only
+/// affects pages that are faulted in afterwards. For regions in /dev/shm,
+/// /sys/kernel/mm/transparent_hugepage/shmem_enabled must be "advise" or
+/// "always".
+void AdviseHugePages(void *addr, size_t size);
+
+/// Set the NUMA memory policy of the region. This only affects pages that are
+/// faulted in afterwards.
+///
+/// \param policy "local" binds the region to the NUMA node that the calling
+/// thread runs on, "interleave" spreads its pages over all allowed nodes.
+/// \return Whether the policy was applied.
+bool SetNumaPolicy(void *addr, size_t size, const std::string &policy);
+
+/// Fault in all pages of the region, so that first touches don't stall.
+void PrefaultRegion(void *addr, size_t size);
+}  // namespace internal
+
 }  // namespace plasma
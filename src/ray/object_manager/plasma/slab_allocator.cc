@@ -0,0 +1,202 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/slab_allocator.h"
+
+#include <algorithm>
+
+#include "ray/util/logging.h"
+
+namespace plasma {
+
+namespace {
+// The smallest block size served from slabs.
+const int64_t kMinBlockSize = 4 * 1024;
+
+// Blocks are aligned the same way as the allocations of PlasmaAllocator.
+const int64_t kBlockAlignment = 64;
+
+// Each power of two is split into this many size classes, which bounds the
+// internal fragmentation of a block to 1 / kSizeClassesPerDoubling.
+const int64_t kSizeClassesPerDoubling = 4;
+
+// A slab must hold at least this many blocks, otherwise it is cheaper to
+// allocate the object from the underlying allocator directly.
+const int64_t kMinBlocksPerSlab = 2;
+
+int64_t AlignUp(int64_t size) {
+  return (size + kBlockAlignment - 1) / kBlockAlignment * kBlockAlignment;
+}
+}  // namespace
+
+SlabAllocator::SlabAllocator(IAllocator &allocator, int64_t max_slab_object_size,
+                             int64_t slab_size)
+    : allocator_(allocator) {
+  // Don't let slabs take more than a small portion of the store, otherwise a
+  // couple of size classes could pin all of the memory on small stores.
+  slab_size = std::min(slab_size, allocator_.GetFootprintLimit() / 16);
+  for (int64_t base = kMinBlockSize; base <= max_slab_object_size; base *= 2) {
+    for (int64_t step = 0; step < kSizeClassesPerDoubling; step++) {
+      int64_t block_size = AlignUp(base + base * step / kSizeClassesPerDoubling);
+      if (block_size > max_slab_object_size) {
+        break;
+      }
+      int64_t num_blocks = slab_size / block_size;
+      if (num_blocks < kMinBlocksPerSlab) {
+        break;
+      }
+      size_classes_.push_back(block_size);
+      blocks_per_slab_.push_back(num_blocks);
+    }
+  }
+  available_slabs_.resize(size_classes_.size());
+  RAY_LOG(INFO) << "Plasma slab allocator enabled with " << size_classes_.size()
+                << " size classes up to "
+                << (size_classes_.empty() ? 0 : size_classes_.back()) << " bytes.";
+}
+
+SlabAllocator::~SlabAllocator() {
+  for (auto &entry : slabs_) {
+    allocator_.Free(std::move(entry.second->allocation));
+  }
+}
+
+absl::optional<Allocation> SlabAllocator::Allocate(size_t bytes) {
+  auto size_class = GetSizeClass(bytes);
+  if (size_class.has_value()) {
+    auto &available = available_slabs_[*size_class];
+    Slab *slab = available.empty() ? CreateSlab(*size_class) : *available.begin();
+    if (slab != nullptr) {
+      int64_t block_index = slab->free_blocks.back();
+      slab->free_blocks.pop_back();
+      if (slab->free_blocks.empty()) {
+        available.erase(slab);
+      }
+      slab_allocated_ += slab->block_size;
+      return BuildBlockAllocation(*slab, block_index, bytes);
+    }
+    // The underlying allocator can't fit a whole slab. It may still be able to
+    // fit the object itself.
+  }
+  auto allocation = allocator_.Allocate(bytes);
+  if (allocation.has_value()) {
+    direct_allocated_ += allocation->size;
+  }
+  return allocation;
+}
+
+absl::optional<Allocation> SlabAllocator::FallbackAllocate(size_t bytes) {
+  // Fallback allocations live in their own files, so there is nothing to
+  // fragment. Forward them directly.
+  auto allocation = allocator_.FallbackAllocate(bytes);
+  if (allocation.has_value()) {
+    direct_allocated_ += allocation->size;
+  }
+  return allocation;
+}
+
+void SlabAllocator::Free(Allocation allocation) {
+  RAY_CHECK(allocation.address != nullptr) << "Cannot free the nullptr";
+  Slab *slab = FindSlab(allocation.address);
+  if (slab == nullptr) {
+    direct_allocated_ -= allocation.size;
+    allocator_.Free(std::move(allocation));
+    return;
+  }
+  auto offset = static_cast<uint8_t *>(allocation.address) -
+                static_cast<uint8_t *>(slab->allocation.address);
+  RAY_CHECK(offset % slab->block_size == 0)
+      << "Freeing an address that is not the start of a block.";
+  slab->free_blocks.push_back(offset / slab->block_size);
+  slab_allocated_ -= slab->block_size;
+  if (static_cast<int64_t>(slab->free_blocks.size()) < slab->num_blocks) {
+    available_slabs_[slab->size_class].insert(slab);
+    return;
+  }
+  // All blocks are free, give the memory back so that other size classes and
+  // large objects can use it.
+  available_slabs_[slab->size_class].erase(slab);
+  auto it = slabs_.find(static_cast<const uint8_t *>(slab->allocation.address));
+  RAY_CHECK(it != slabs_.end());
+  allocator_.Free(std::move(it->second->allocation));
+  slabs_.erase(it);
+}
+
+int64_t SlabAllocator::GetFootprintLimit() const {
+  return allocator_.GetFootprintLimit();
+}
+
+int64_t SlabAllocator::Allocated() const { return slab_allocated_ + direct_allocated_; }
+
+int64_t SlabAllocator::FallbackAllocated() const {
+  return allocator_.FallbackAllocated();
+}
+
+absl::optional<size_t> SlabAllocator::GetSizeClass(size_t bytes) const {
+  auto it = std::lower_bound(size_classes_.begin(), size_classes_.end(),
+                             static_cast<int64_t>(bytes));
+  if (it == size_classes_.end()) {
+    return absl::nullopt;
+  }
+  return it - size_classes_.begin();
+}
+
+SlabAllocator::Slab *SlabAllocator::CreateSlab(size_t size_class) {
+  int64_t block_size = size_classes_[size_class];
+  int64_t num_blocks = blocks_per_slab_[size_class];
+  auto allocation = allocator_.Allocate(block_size * num_blocks);
+  if (!allocation.has_value()) {
+    return nullptr;
+  }
+  auto slab = std::make_unique<Slab>(std::move(allocation.value()));
+  slab->size_class = size_class;
+  slab->block_size = block_size;
+  slab->num_blocks = num_blocks;
+  slab->free_blocks.reserve(num_blocks);
+  // Hand out the lowest blocks first.
+  for (int64_t i = num_blocks - 1; i >= 0; i--) {
+    slab->free_blocks.push_back(i);
+  }
+  auto ptr = slab.get();
+  slabs_.emplace(static_cast<const uint8_t *>(ptr->allocation.address), std::move(slab));
+  available_slabs_[size_class].insert(ptr);
+  RAY_LOG(DEBUG) << "Created slab of " << num_blocks << " blocks of " << block_size
+                 << " bytes at " << ptr->allocation.address;
+  return ptr;
+}
+
+SlabAllocator::Slab *SlabAllocator::FindSlab(const void *address) const {
+  auto addr = static_cast<const uint8_t *>(address);
+  auto it = slabs_.upper_bound(addr);
+  if (it == slabs_.begin()) {
+    return nullptr;
+  }
+  it--;
+  const Slab &slab = *it->second;
+  if (addr >= it->first + slab.block_size * slab.num_blocks) {
+    return nullptr;
+  }
+  return it->second.get();
+}
+
+Allocation SlabAllocator::BuildBlockAllocation(const Slab &slab, int64_t block_index,
+                                               size_t bytes) const {
+  int64_t block_offset = block_index * slab.block_size;
+  const auto &region = slab.allocation;
+  return Allocation(static_cast<uint8_t *>(region.address) + block_offset,
+                    static_cast<int64_t>(bytes), region.fd, region.offset + block_offset,
+                    region.device_num, region.mmap_size);
+}
+
+}  // namespace plasma
@@ -0,0 +1,127 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/types/optional.h"
+#include "ray/object_manager/plasma/allocator.h"
+#include "ray/object_manager/plasma/common.h"
+
+namespace plasma {
+
+// SlabAllocator serves small allocations from size-class segregated slabs
+// carved out of the memory of another allocator (normally the dlmalloc based
+// PlasmaAllocator), and forwards large allocations to it directly.
+//
+// Each slab is a single allocation from the underlying allocator that is split
+// into equally sized blocks. Since all blocks of a slab have the same size,
+// freed blocks can be reused by objects of the same size class without
+// fragmenting the underlying mmap region. Slabs are handed back to the
+// underlying allocator as soon as all of their blocks are free.
+//
+// This class is not thread safe.
+class SlabAllocator : public IAllocator {
+ public:
+  /// \param allocator The allocator to carve slabs out of and to forward large
+  /// and fallback allocations to.
+  /// \param max_slab_object_size Allocations larger than this are forwarded to the
+  /// underlying allocator.
+  /// \param slab_size The size in bytes of each slab. A slab always holds at
+  /// least two blocks; size classes that can't fit two blocks are not slab
+  /// allocated.
+  SlabAllocator(IAllocator &allocator, int64_t max_slab_object_size, int64_t slab_size);
+
+  ~SlabAllocator();
+
+  absl::optional<Allocation> Allocate(size_t bytes) override;
+
+  absl::optional<Allocation> FallbackAllocate(size_t bytes) override;
+
+  void Free(Allocation allocation) override;
+
+  int64_t GetFootprintLimit() const override;
+
+  /// The number of bytes allocated to callers. Blocks are accounted for at their
+  /// size class, and free blocks cached in partially used slabs don't count.
+  int64_t Allocated() const override;
+
+  int64_t FallbackAllocated() const override;
+
+  /// The number of slabs currently carved out of the underlying allocator.
+  int64_t NumSlabs() const { return static_cast<int64_t>(slabs_.size()); }
+
+  /// The block sizes of the size classes served by this allocator.
+  const std::vector<int64_t> &SizeClasses() const { return size_classes_; }
+
+ private:
+  struct Slab {
+    explicit Slab(Allocation allocation) : allocation(std::move(allocation)) {}
+    /// The memory of this slab, allocated from the underlying allocator.
+    Allocation allocation;
+    /// The index of the size class this slab belongs to.
+    size_t size_class;
+    /// The size in bytes of each block.
+    int64_t block_size;
+    /// The total number of blocks in this slab.
+    int64_t num_blocks;
+    /// Indexes of the blocks that are not in use.
+    std::vector<int64_t> free_blocks;
+  };
+
+  /// Returns the index of the smallest size class that fits the given number of
+  /// bytes, or nullopt if the allocation should not be served from a slab.
+  absl::optional<size_t> GetSizeClass(size_t bytes) const;
+
+  /// Carve a new slab for the given size class out of the underlying allocator.
+  ///
+  /// \return The new slab, or nullptr if the underlying allocator is out of space.
+  Slab *CreateSlab(size_t size_class);
+
+  /// Returns the slab the address belongs to, or nullptr if it isn't slab
+  /// allocated.
+  Slab *FindSlab(const void *address) const;
+
+  /// Build the allocation for the given block of a slab.
+  Allocation BuildBlockAllocation(const Slab &slab, int64_t block_index,
+                                  size_t bytes) const;
+
+  /// The allocator slabs are carved out of.
+  IAllocator &allocator_;
+
+  /// Block sizes of each size class in ascending order.
+  std::vector<int64_t> size_classes_;
+
+  /// Number of blocks per slab of each size class.
+  std::vector<int64_t> blocks_per_slab_;
+
+  /// All slabs keyed by their start address, so that the slab of a block can be
+  /// found on Free.
+  std::map<const uint8_t *, std::unique_ptr<Slab>> slabs_;
+
+  /// Slabs of each size class that have at least one free block.
+  std::vector<absl::flat_hash_set<Slab *>> available_slabs_;
+
+  /// Bytes of the blocks handed out by this allocator.
+  int64_t slab_allocated_ = 0;
+
+  /// Bytes handed out by the underlying allocator directly (i.e., large objects).
+  int64_t direct_allocated_ = 0;
+};
+
+}  // namespace plasma
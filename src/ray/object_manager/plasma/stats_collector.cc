@@ -17,8 +17,49 @@
 
 #include "ray/object_manager/plasma/stats_collector.h"
 
+#include "ray/util/util.h"
+
 namespace plasma {
 
+void ObjectStatsCollector::Log2Histogram::Record(int64_t value) {
+  counts[BucketOf(value)]++;
+}
+
+int64_t ObjectStatsCollector::Log2Histogram::Count() const {
+  int64_t count = 0;
+  for (auto bucket_count : counts) {
+    count += bucket_count;
+  }
+  return count;
+}
+
+int ObjectStatsCollector::Log2Histogram::BucketOf(int64_t value) {
+  int bucket = 0;
+  while (value > 0 && bucket < kNumBuckets - 1) {
+    value >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+void ObjectStatsCollector::Log2Histogram::GetDebugDump(std::stringstream &buffer,
+                                                       const std::string &unit) const {
+  for (int i = 0; i < kNumBuckets; i++) {
+    if (counts[i] == 0) {
+      continue;
+    }
+    if (i == 0) {
+      buffer << "  - < 1 " << unit;
+    } else if (i == kNumBuckets - 1) {
+      buffer << "  - >= " << (int64_t{1} << (i - 1)) << " " << unit;
+    } else {
+      buffer << "  - [" << (int64_t{1} << (i - 1)) << ", " << (int64_t{1} << i) << ") "
+             << unit;
+    }
+    buffer << ": " << counts[i] << "\n";
+  }
+}
+
 void ObjectStatsCollector::OnObjectCreated(const LocalObject &obj) {
   const auto kDataSize = obj.GetObjectInfo().data_size;
   const auto kSource = obj.GetSource();
@@ -40,6 +81,14 @@ void ObjectStatsCollector::OnObjectCreated(const LocalObject &obj) {
   RAY_CHECK(!obj.Sealed());
   num_objects_unsealed_++;
   num_bytes_unsealed_ += kDataSize;
+  distributions_[static_cast<int>(kSource)].object_sizes.Record(kDataSize);
+
+  auto &job_usage = job_usages_[GetJobId(obj.GetObjectInfo().object_id)];
+  job_usage.num_objects++;
+  job_usage.num_bytes += obj.GetObjectSize();
+  if (obj.IsFallbackAllocated()) {
+    job_usage.num_bytes_fallback_allocated += obj.GetObjectSize();
+  }
 }
 
 void ObjectStatsCollector::OnObjectSealed(const LocalObject &obj) {
@@ -81,11 +130,27 @@ void ObjectStatsCollector::OnObjectDeleting(const LocalObject &obj) {
     num_bytes_errored_ -= kDataSize;
   }
 
+  auto job_it = job_usages_.find(GetJobId(obj.GetObjectInfo().object_id));
+  if (job_it != job_usages_.end()) {
+    auto &job_usage = job_it->second;
+    job_usage.num_objects--;
+    job_usage.num_bytes -= obj.GetObjectSize();
+    if (obj.IsFallbackAllocated()) {
+      job_usage.num_bytes_fallback_allocated -= obj.GetObjectSize();
+    }
+    if (job_usage.num_objects == 0) {
+      job_usages_.erase(job_it);
+    }
+  }
+
   if (obj.GetRefCount() > 0) {
     num_objects_in_use_--;
     num_bytes_in_use_ -= kDataSize;
   }
 
+  auto &distributions = distributions_[static_cast<int>(kSource)];
+  distributions.access_counts.Record(obj.GetNumAccesses());
+
   if (!obj.Sealed()) {
     num_objects_unsealed_--;
     num_bytes_unsealed_ -= kDataSize;
@@ -93,6 +158,8 @@ void ObjectStatsCollector::OnObjectDeleting(const LocalObject &obj) {
   }
 
   // obj sealed
+  distributions.lifetimes_ms.Record(ray::current_time_ms() - obj.GetSealTimeMs());
+
   if (obj.GetRefCount() == 1 &&
       kSource == plasma::flatbuf::ObjectSource::CreatedByWorker) {
     num_objects_spillable_--;
@@ -164,6 +231,25 @@ void ObjectStatsCollector::OnObjectRefDecreased(const LocalObject &obj) {
   }
 }
 
+ObjectStatsCollector::JobUsage ObjectStatsCollector::GetJobUsage(
+    const ray::JobID &job_id) const {
+  auto it = job_usages_.find(job_id);
+  if (it == job_usages_.end()) {
+    return JobUsage();
+  }
+  return it->second;
+}
+
+ray::JobID ObjectStatsCollector::GetJobId(const ObjectID &object_id) {
+  // Objects that don't belong to a task, e.g. in tests, are accounted to the nil
+  // job.
+  auto task_id = object_id.TaskId();
+  if (task_id.ActorId().IsNil()) {
+    return ray::JobID::Nil();
+  }
+  return task_id.JobId();
+}
+
 void ObjectStatsCollector::GetDebugDump(std::stringstream &buffer) const {
   buffer << "- objects spillable: " << num_objects_spillable_ << "\n";
   buffer << "- bytes spillable: " << num_bytes_spillable_ << "\n";
@@ -183,5 +269,30 @@ void ObjectStatsCollector::GetDebugDump(std::stringstream &buffer) const {
   buffer << "- bytes received: " << num_bytes_received_ << "\n";
   buffer << "- objects errored: " << num_objects_errored_ << "\n";
   buffer << "- bytes errored: " << num_bytes_errored_ << "\n";
+
+  for (int source = static_cast<int>(plasma::flatbuf::ObjectSource::MIN);
+       source <= static_cast<int>(plasma::flatbuf::ObjectSource::MAX); source++) {
+    const auto &distributions = distributions_[source];
+    if (distributions.object_sizes.Count() == 0) {
+      continue;
+    }
+    const auto name = plasma::flatbuf::EnumNamesObjectSource()[source];
+    buffer << "\n";
+    buffer << "- object sizes of " << name << ":\n";
+    distributions.object_sizes.GetDebugDump(buffer, "bytes");
+    buffer << "- lifetimes after seal of " << name << ":\n";
+    distributions.lifetimes_ms.GetDebugDump(buffer, "ms");
+    buffer << "- access counts of " << name << ":\n";
+    distributions.access_counts.GetDebugDump(buffer, "accesses");
+  }
+
+  if (!job_usages_.empty()) {
+    buffer << "\n";
+    for (const auto &entry : job_usages_) {
+      buffer << "- job " << entry.first << ": objects " << entry.second.num_objects
+             << ", bytes " << entry.second.num_bytes << ", bytes fallback allocated "
+             << entry.second.num_bytes_fallback_allocated << "\n";
+    }
+  }
 }
 }  // namespace plasma
\ No newline at end of file
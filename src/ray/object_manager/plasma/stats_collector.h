@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <array>
+
+#include "absl/container/flat_hash_map.h"
 #include "ray/object_manager/plasma/common.h"
 
 namespace plasma {
@@ -28,6 +31,47 @@ namespace plasma {
 // ObjectLifeCycleManager into this class.
 class ObjectStatsCollector {
  public:
+  // The plasma usage of a single job. An object belongs to the job of the task
+  // that created it.
+  struct JobUsage {
+    int64_t num_objects = 0;
+    // Bytes of data and metadata, including fallback allocated objects.
+    int64_t num_bytes = 0;
+    // Bytes of data and metadata allocated by the fallback allocator.
+    int64_t num_bytes_fallback_allocated = 0;
+  };
+
+  // A histogram with power of two buckets. Bucket 0 counts the values below 1, and
+  // bucket i > 0 the values in [2^(i-1), 2^i). The last bucket also counts all
+  // larger values. Recording a value costs a few shifts and an increment.
+  struct Log2Histogram {
+    static constexpr int kNumBuckets = 48;
+
+    void Record(int64_t value);
+
+    // The number of recorded values.
+    int64_t Count() const;
+
+    // The bucket a value falls into.
+    static int BucketOf(int64_t value);
+
+    // Write the non-empty buckets, one per line.
+    void GetDebugDump(std::stringstream &buffer, const std::string &unit) const;
+
+    std::array<int64_t, kNumBuckets> counts{};
+  };
+
+  // The distributions of the objects from one source, e.g., created by workers.
+  struct SourceDistributions {
+    // Sizes of the data of created objects, in bytes.
+    Log2Histogram object_sizes;
+    // Time from seal to deletion of sealed objects, in milliseconds.
+    Log2Histogram lifetimes_ms;
+    // Number of references taken to an object over its lifetime, recorded when
+    // the object is deleted.
+    Log2Histogram access_counts;
+  };
+
   // Called after a new object is created.
   void OnObjectCreated(const LocalObject &object);
 
@@ -43,6 +87,25 @@ class ObjectStatsCollector {
   // Called after an object's ref count is decreased by 1.
   void OnObjectRefDecreased(const LocalObject &object);
 
+  // Get the job an object is accounted to, i.e., the job of the task that
+  // created it.
+  static ray::JobID GetJobId(const ObjectID &object_id);
+
+  // Get the usage of a job. Jobs without objects in the store have no usage.
+  JobUsage GetJobUsage(const ray::JobID &job_id) const;
+
+  // Get the usage of all jobs with objects in the store.
+  const absl::flat_hash_map<ray::JobID, JobUsage> &GetJobUsages() const {
+    return job_usages_;
+  }
+
+  // Get the distributions of the objects from a source. They cover all objects
+  // since the store started, not just the ones in the store.
+  const SourceDistributions &GetDistributions(
+      plasma::flatbuf::ObjectSource source) const {
+    return distributions_[static_cast<int>(source)];
+  }
+
   // Debug dump the stats.
   void GetDebugDump(std::stringstream &buffer) const;
 
@@ -66,6 +129,12 @@ class ObjectStatsCollector {
   int64_t num_bytes_received_ = 0;
   int64_t num_objects_errored_ = 0;
   int64_t num_bytes_errored_ = 0;
+
+  absl::flat_hash_map<ray::JobID, JobUsage> job_usages_;
+
+  std::array<SourceDistributions,
+             static_cast<int>(plasma::flatbuf::ObjectSource::MAX) + 1>
+      distributions_;
 };
 
 }  // namespace plasma
\ No newline at end of file
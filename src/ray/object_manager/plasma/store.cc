@@ -32,6 +32,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
 #include <boost/bind.hpp>
 #include <chrono>
 #include <ctime>
@@ -83,7 +84,8 @@ void ToPlasmaObject(const LocalObject &entry, PlasmaObject *object, bool check_s
 
 struct GetRequest {
   GetRequest(instrumented_io_context &io_context, const std::shared_ptr<Client> &client,
-             const std::vector<ObjectID> &object_ids, bool is_from_worker);
+             const std::vector<ObjectID> &object_ids, bool is_from_worker,
+             int64_t num_objects_to_wait_for);
   /// The client that called get.
   std::shared_ptr<Client> client;
   /// The object IDs involved in this request. This is used in the reply.
@@ -133,7 +135,8 @@ struct GetRequest {
 
 GetRequest::GetRequest(instrumented_io_context &io_context,
                        const std::shared_ptr<Client> &client,
-                       const std::vector<ObjectID> &object_ids, bool is_from_worker)
+                       const std::vector<ObjectID> &object_ids, bool is_from_worker,
+                       int64_t num_objects_to_wait_for)
     : client(client),
       object_ids(object_ids.begin(), object_ids.end()),
       objects(object_ids.size()),
@@ -141,7 +144,11 @@ GetRequest::GetRequest(instrumented_io_context &io_context,
       is_from_worker(is_from_worker),
       timer_(io_context) {
   std::unordered_set<ObjectID> unique_ids(object_ids.begin(), object_ids.end());
-  num_objects_to_wait_for = unique_ids.size();
+  this->num_objects_to_wait_for = unique_ids.size();
+  if (num_objects_to_wait_for > 0) {
+    this->num_objects_to_wait_for =
+        std::min<int64_t>(this->num_objects_to_wait_for, num_objects_to_wait_for);
+  }
 }
 
 PlasmaStore::PlasmaStore(instrumented_io_context &main_service, IAllocator &allocator,
@@ -167,7 +174,8 @@ PlasmaStore::PlasmaStore(instrumented_io_context &main_service, IAllocator &allo
           spill_objects_callback, object_store_full_callback,
           /*get_time=*/
           []() { return absl::GetCurrentTimeNanos(); },
-          [this]() { return GetDebugDump(); }) {
+          [this]() { return GetDebugDump(); },
+          RayConfig::instance().plasma_create_request_starvation_timeout_ms()) {
   const auto event_stats_print_interval_ms =
       RayConfig::instance().event_stats_print_interval_ms();
   if (event_stats_print_interval_ms > 0 && RayConfig::instance().event_stats()) {
@@ -208,8 +216,19 @@ PlasmaError PlasmaStore::HandleCreateObjectRequest(const std::shared_ptr<Client>
   ray::ObjectInfo object_info;
   fb::ObjectSource source;
   int device_num;
-  ReadCreateRequest(input, input_size, &object_info, &source, &device_num);
+  fb::CreatePriority priority;
+  ReadCreateRequest(input, input_size, &object_info, &source, &device_num, &priority);
+  return HandleCreateObjectRequest(client, object_info, source, device_num,
+                                   fallback_allocator, object, spilling_required);
+}
 
+PlasmaError PlasmaStore::HandleCreateObjectRequest(const std::shared_ptr<Client> &client,
+                                                   const ray::ObjectInfo &object_info,
+                                                   fb::ObjectSource source,
+                                                   int device_num,
+                                                   bool fallback_allocator,
+                                                   PlasmaObject *object,
+                                                   bool *spilling_required) {
   if (device_num != 0) {
     RAY_LOG(ERROR) << "device_num != 0 but CUDA not enabled";
     return PlasmaError::OutOfMemory;
@@ -263,31 +282,32 @@ void PlasmaStore::RemoveGetRequest(const std::shared_ptr<GetRequest> &get_reques
     auto object_request_iter = object_get_requests_.find(object_id);
     if (object_request_iter != object_get_requests_.end()) {
       auto &get_requests = object_request_iter->second;
-      // Erase get_req from the vector.
-      auto it = std::find(get_requests.begin(), get_requests.end(), get_request);
-      if (it != get_requests.end()) {
-        get_requests.erase(it);
-        // If the vector is empty, remove the object ID from the map.
-        if (get_requests.empty()) {
-          object_get_requests_.erase(object_request_iter);
-        }
+      get_requests.erase(get_request);
+      // If there are no requests left, remove the object ID from the map.
+      if (get_requests.empty()) {
+        object_get_requests_.erase(object_request_iter);
       }
     }
   }
+  auto client_request_iter = client_get_requests_.find(get_request->client);
+  if (client_request_iter != client_get_requests_.end()) {
+    client_request_iter->second.erase(get_request);
+    if (client_request_iter->second.empty()) {
+      client_get_requests_.erase(client_request_iter);
+    }
+  }
   // Remove the get request.
   get_request->CancelTimer();
   get_request->MarkRemoved();
 }
 
 void PlasmaStore::RemoveGetRequestsForClient(const std::shared_ptr<Client> &client) {
-  std::unordered_set<std::shared_ptr<GetRequest>> get_requests_to_remove;
-  for (auto const &pair : object_get_requests_) {
-    for (const auto &get_request : pair.second) {
-      if (get_request->client == client) {
-        get_requests_to_remove.insert(get_request);
-      }
-    }
+  auto it = client_get_requests_.find(client);
+  if (it == client_get_requests_.end()) {
+    return;
   }
+  auto get_requests_to_remove = std::move(it->second);
+  client_get_requests_.erase(it);
 
   // It shouldn't be possible for a given client to be in the middle of multiple get
   // requests.
@@ -351,16 +371,14 @@ void PlasmaStore::NotifyObjectSealedToGetRequests(const ObjectID &object_id) {
     return;
   }
 
-  auto &get_requests = it->second;
+  // No get requests should be waiting for this object anymore. Take them out of
+  // the map first, since replying to a request removes it from the map.
+  auto get_requests = std::move(it->second);
+  object_get_requests_.erase(it);
 
-  // After finishing the loop below, get_requests and it will have been
-  // invalidated by the removal of object_id from object_get_requests_.
-  size_t index = 0;
-  size_t num_requests = get_requests.size();
-  for (size_t i = 0; i < num_requests; ++i) {
-    auto get_req = get_requests[index];
-    auto entry = object_lifecycle_mgr_.GetObject(object_id);
-    RAY_CHECK(entry != nullptr);
+  auto entry = object_lifecycle_mgr_.GetObject(object_id);
+  RAY_CHECK(entry != nullptr);
+  for (const auto &get_req : get_requests) {
     ToPlasmaObject(*entry, &get_req->objects[object_id], /* check sealed */ true);
     get_req->num_satisfied += 1;
     // Record the fact that this client will be using this object and will
@@ -368,32 +386,24 @@ void PlasmaStore::NotifyObjectSealedToGetRequests(const ObjectID &object_id) {
     AddToClientObjectIds(object_id, get_req->client);
 
     // If this get request is done, reply to the client.
-    if (get_req->num_satisfied == get_req->num_objects_to_wait_for) {
+    if (get_req->num_satisfied >= get_req->num_objects_to_wait_for) {
       ReturnFromGet(get_req);
-    } else {
-      // The call to ReturnFromGet will remove the current element in the
-      // array, so we only increment the counter in the else branch.
-      index += 1;
     }
   }
-
-  // No get requests should be waiting for this object anymore. The object ID
-  // may have been removed from the object_get_requests_ by ReturnFromGet, but
-  // if the get request has not returned yet, then remove the object ID from the
-  // map here.
-  it = object_get_requests_.find(object_id);
-  if (it != object_get_requests_.end()) {
-    object_get_requests_.erase(object_id);
-  }
 }
 
 void PlasmaStore::ProcessGetRequest(const std::shared_ptr<Client> &client,
                                     const std::vector<ObjectID> &object_ids,
-                                    int64_t timeout_ms, bool is_from_worker) {
+                                    int64_t timeout_ms, bool is_from_worker,
+                                    int64_t num_objects_to_wait_for) {
   // Create a get request for this object.
-  auto get_req = std::make_shared<GetRequest>(
-      GetRequest(io_context_, client, object_ids, is_from_worker));
+  auto get_req = std::make_shared<GetRequest>(GetRequest(
+      io_context_, client, object_ids, is_from_worker, num_objects_to_wait_for));
   for (auto object_id : object_ids) {
+    if (get_req->objects.count(object_id) > 0) {
+      // A duplicate of an object that is already accounted for.
+      continue;
+    }
     // Check if this object is already present
     // locally. If so, record that the object is being used and mark it as accounted for.
     auto entry = object_lifecycle_mgr_.GetObject(object_id);
@@ -410,13 +420,14 @@ void PlasmaStore::ProcessGetRequest(const std::shared_ptr<Client> &client,
       // data size to -1 to indicate that the object is not present.
       get_req->objects[object_id].data_size = -1;
       // Add the get request to the relevant data structures.
-      object_get_requests_[object_id].push_back(get_req);
+      object_get_requests_[object_id].insert(get_req);
+      client_get_requests_[client].insert(get_req);
     }
   }
 
-  // If all of the objects are present already or if the timeout is 0, return to
-  // the client.
-  if (get_req->num_satisfied == get_req->num_objects_to_wait_for || timeout_ms == 0) {
+  // If enough of the objects are present already or if the timeout is 0, return
+  // to the client.
+  if (get_req->num_satisfied >= get_req->num_objects_to_wait_for || timeout_ms == 0) {
     ReturnFromGet(get_req);
   } else if (timeout_ms != -1) {
     // Set a timer that will cause the get request to return to the client. Note
@@ -559,8 +570,8 @@ Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
         static_cast<void>(client->SendFd(result.store_fd));
       }
     } else {
-      auto req_id =
-          create_request_queue_.AddRequest(object_id, client, handle_create, object_size);
+      auto req_id = create_request_queue_.AddRequest(object_id, client, handle_create,
+                                                     object_size, request->priority());
       RAY_LOG(DEBUG) << "Received create request for object " << object_id
                      << " assigned request ID " << req_id << ", " << object_size
                      << " bytes";
@@ -568,6 +579,37 @@ Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
       ReplyToCreateClient(client, object_id, req_id);
     }
   } break;
+  case fb::MessageType::PlasmaCreateBatchRequest: {
+    std::vector<ray::ObjectInfo> object_infos;
+    std::vector<fb::ObjectSource> sources;
+    std::vector<int> device_nums;
+    std::vector<fb::CreatePriority> priorities;
+    ReadCreateBatchRequest(input, input_size, &object_infos, &sources, &device_nums,
+                           &priorities);
+    std::vector<ObjectID> object_ids;
+    std::vector<CreateRequestQueue::CreateObjectCallback> create_callbacks;
+    std::vector<size_t> object_sizes;
+    for (size_t i = 0; i < object_infos.size(); i++) {
+      const auto &object_info = object_infos[i];
+      object_ids.push_back(object_info.object_id);
+      object_sizes.push_back(object_info.data_size + object_info.metadata_size);
+      create_callbacks.push_back([this, client, object_info, source = sources[i],
+                                  device_num = device_nums[i]](
+                                     bool fallback_allocator, PlasmaObject *result,
+                                     bool *spilling_required) {
+        return HandleCreateObjectRequest(client, object_info, source, device_num,
+                                         fallback_allocator, result, spilling_required);
+      });
+    }
+    // All requests of a batch share the same priority.
+    auto req_ids = create_request_queue_.AddBatchRequest(
+        object_ids, client, create_callbacks, object_sizes,
+        priorities.empty() ? fb::CreatePriority::UserPut : priorities.front());
+    RAY_LOG(DEBUG) << "Received create request for " << object_ids.size()
+                   << " objects in a batch";
+    ProcessCreateRequests();
+    ReplyToCreateBatchClient(client, object_ids, req_ids);
+  } break;
   case fb::MessageType::PlasmaCreateRetryRequest: {
     auto request = flatbuffers::GetRoot<fb::PlasmaCreateRetryRequest>(input);
     RAY_DCHECK(plasma::VerifyFlatbuffer(request, input, input_size));
@@ -585,9 +627,11 @@ Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
     std::vector<ObjectID> object_ids_to_get;
     int64_t timeout_ms;
     bool is_from_worker;
+    int64_t num_objects_to_wait_for;
     RAY_RETURN_NOT_OK(ReadGetRequest(input, input_size, object_ids_to_get, &timeout_ms,
-                                     &is_from_worker));
-    ProcessGetRequest(client, object_ids_to_get, timeout_ms, is_from_worker);
+                                     &is_from_worker, &num_objects_to_wait_for));
+    ProcessGetRequest(client, object_ids_to_get, timeout_ms, is_from_worker,
+                      num_objects_to_wait_for);
   } break;
   case fb::MessageType::PlasmaReleaseRequest: {
     RAY_RETURN_NOT_OK(ReadReleaseRequest(input, input_size, &object_id));
@@ -616,6 +660,13 @@ Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
     SealObjects({object_id});
     RAY_RETURN_NOT_OK(SendSealReply(client, object_id, PlasmaError::OK));
   } break;
+  case fb::MessageType::PlasmaSealBatchRequest: {
+    std::vector<ObjectID> object_ids;
+    RAY_RETURN_NOT_OK(ReadSealBatchRequest(input, input_size, &object_ids));
+    SealObjects(object_ids);
+    std::vector<PlasmaError> errors(object_ids.size(), PlasmaError::OK);
+    RAY_RETURN_NOT_OK(SendSealBatchReply(client, object_ids, errors));
+  } break;
   case fb::MessageType::PlasmaEvictRequest: {
     // This code path should only be used for testing.
     int64_t num_bytes;
@@ -635,6 +686,14 @@ Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
     RAY_RETURN_NOT_OK(SendGetDebugStringReply(
         client, object_lifecycle_mgr_.EvictionPolicyDebugString()));
   } break;
+  case fb::MessageType::PlasmaRingSetupRequest: {
+    int64_t capacity;
+    RAY_RETURN_NOT_OK(ReadRingSetupRequest(input, input_size, &capacity));
+    RAY_RETURN_NOT_OK(SetupClientRings(client, capacity));
+  } break;
+  case fb::MessageType::PlasmaRingWakeup: {
+    RAY_RETURN_NOT_OK(ProcessRingRequests(client));
+  } break;
   default:
     // This code should be unreachable.
     RAY_CHECK(0);
@@ -642,6 +701,39 @@ Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
   return Status::OK();
 }
 
+Status PlasmaStore::SetupClientRings(const std::shared_ptr<Client> &client,
+                                     int64_t capacity) {
+  // Keep a misbehaving client from pinning a lot of memory.
+  const int64_t kMinRingCapacity = 4 * 1024;
+  const int64_t kMaxRingCapacity = 64 * 1024 * 1024;
+  capacity = std::min(std::max(capacity, kMinRingCapacity), kMaxRingCapacity);
+  std::unique_ptr<ClientRings> rings;
+  auto status = ClientRings::Create(capacity, &rings);
+  if (!status.ok()) {
+    RAY_LOG(WARNING) << "Failed to set up the shared memory rings of client " << client
+                     << ", it will use the socket instead: " << status.ToString();
+    return SendRingSetupReply(client, 0);
+  }
+  RAY_RETURN_NOT_OK(SendRingSetupReply(client, capacity));
+  return client->EnableRings(std::move(rings));
+}
+
+Status PlasmaStore::ProcessRingRequests(const std::shared_ptr<Client> &client) {
+  int64_t type;
+  std::vector<uint8_t> message;
+  while (client->PopRingRequest(&type, &message)) {
+    auto message_type = static_cast<fb::MessageType>(type);
+    if (message_type != fb::MessageType::PlasmaGetRequest &&
+        message_type != fb::MessageType::PlasmaReleaseRequest &&
+        message_type != fb::MessageType::PlasmaContainsRequest) {
+      return Status::IOError("Unexpected message type " + std::to_string(type) +
+                             " in the request ring of the client.");
+    }
+    RAY_RETURN_NOT_OK(ProcessMessage(client, message_type, message));
+  }
+  return Status::OK();
+}
+
 void PlasmaStore::DoAccept() {
   acceptor_.async_accept(socket_, boost::bind(&PlasmaStore::ConnectClient, this,
                                               boost::asio::placeholders::error));
@@ -696,11 +788,40 @@ void PlasmaStore::ReplyToCreateClient(const std::shared_ptr<Client> &client,
   }
 }
 
+void PlasmaStore::ReplyToCreateBatchClient(const std::shared_ptr<Client> &client,
+                                           const std::vector<ObjectID> &object_ids,
+                                           const std::vector<uint64_t> &req_ids) {
+  std::vector<uint64_t> retry_with_request_ids(object_ids.size(), 0);
+  std::vector<PlasmaObject> results(object_ids.size());
+  std::vector<PlasmaError> errors(object_ids.size(), PlasmaError::OK);
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    if (!create_request_queue_.GetRequestResult(req_ids[i], &results[i], &errors[i])) {
+      // The client retries unfinished requests one by one.
+      retry_with_request_ids[i] = req_ids[i];
+    }
+  }
+  if (!SendCreateBatchReply(client, object_ids, retry_with_request_ids, results, errors)
+           .ok()) {
+    return;
+  }
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    if (retry_with_request_ids[i] == 0 && errors[i] == PlasmaError::OK &&
+        results[i].device_num == 0) {
+      static_cast<void>(client->SendFd(results[i].store_fd));
+    }
+  }
+}
+
 int64_t PlasmaStore::GetConsumedBytes() {
   std::lock_guard<std::recursive_mutex> guard(mutex_);
   return total_consumed_bytes_;
 }
 
+int64_t PlasmaStore::GetPendingCreateBytes() {
+  std::lock_guard<std::recursive_mutex> guard(mutex_);
+  return create_request_queue_.NumPendingBytes();
+}
+
 bool PlasmaStore::IsObjectSpillable(const ObjectID &object_id) {
   // The lock is acquired when a request is received to the plasma store.
   // recursive mutex is used here to allow
@@ -713,6 +834,12 @@ bool PlasmaStore::IsObjectSpillable(const ObjectID &object_id) {
   return entry->Sealed() && entry->GetRefCount() == 1;
 }
 
+void PlasmaStore::SetObjectProvenance(const ObjectID &object_id,
+                                      ObjectProvenance provenance) {
+  std::lock_guard<std::recursive_mutex> guard(mutex_);
+  object_lifecycle_mgr_.SetObjectProvenance(object_id, provenance);
+}
+
 void PlasmaStore::PrintDebugDump() const {
   RAY_LOG(INFO) << GetDebugDump();
 
@@ -24,6 +24,8 @@
 #include <unordered_set>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "ray/common/asio/instrumented_io_context.h"
 #include "ray/common/ray_config.h"
 #include "ray/common/status.h"
@@ -118,9 +120,11 @@ class PlasmaStore {
   /// \param client The client making this request.
   /// \param object_ids Object IDs of the objects to be gotten.
   /// \param timeout_ms The timeout for the get request in milliseconds.
+  /// \param num_objects_to_wait_for The number of sealed objects to reply after, or
+  /// 0 to wait for all of them.
   void ProcessGetRequest(const std::shared_ptr<Client> &client,
                          const std::vector<ObjectID> &object_ids, int64_t timeout_ms,
-                         bool is_from_worker);
+                         bool is_from_worker, int64_t num_objects_to_wait_for);
 
   /// Seal a vector of objects. The objects are now immutable and can be accessed with
   /// get.
@@ -156,9 +160,16 @@ class PlasmaStore {
   /// before the object is pinned by raylet for the first time.
   bool IsObjectSpillable(const ObjectID &object_id);
 
+  /// Tell the eviction policy what the local copy of the object is, so that copies
+  /// which are cheap to get back are evicted first.
+  void SetObjectProvenance(const ObjectID &object_id, ObjectProvenance provenance);
+
   /// Return the plasma object bytes that are consumed by core workers.
   int64_t GetConsumedBytes();
 
+  /// Return the bytes of the create requests that wait for space.
+  int64_t GetPendingCreateBytes();
+
   /// Process queued requests to create an object.
   void ProcessCreateRequests();
 
@@ -196,9 +207,22 @@ class PlasmaStore {
                                         bool fallback_allocator, PlasmaObject *object,
                                         bool *spilling_required);
 
+  PlasmaError HandleCreateObjectRequest(const std::shared_ptr<Client> &client,
+                                        const ray::ObjectInfo &object_info,
+                                        plasma::flatbuf::ObjectSource source,
+                                        int device_num, bool fallback_allocator,
+                                        PlasmaObject *object, bool *spilling_required);
+
   void ReplyToCreateClient(const std::shared_ptr<Client> &client,
                            const ObjectID &object_id, uint64_t req_id);
 
+  /// Reply to a batch of create requests. The requests that are not finished
+  /// yet are returned with their request IDs, so that the client can retry
+  /// them.
+  void ReplyToCreateBatchClient(const std::shared_ptr<Client> &client,
+                                const std::vector<ObjectID> &object_ids,
+                                const std::vector<uint64_t> &req_ids);
+
   void AddToClientObjectIds(const ObjectID &object_id,
                             const std::shared_ptr<Client> &client);
 
@@ -233,11 +257,17 @@ class PlasmaStore {
   /// The allocator that allocates mmaped memory.
   IAllocator &allocator_;
   /// The object store stores created objects.
-  /// A hash table mapping object IDs to a vector of the get requests that are
-  /// waiting for the object to arrive.
-  std::unordered_map<ObjectID, std::vector<std::shared_ptr<GetRequest>>>
+  /// A hash table mapping object IDs to the get requests that are waiting for
+  /// the object to arrive.
+  absl::flat_hash_map<ObjectID, absl::flat_hash_set<std::shared_ptr<GetRequest>>>
       object_get_requests_;
 
+  /// The get requests of each client that are waiting for objects, so that a
+  /// disconnecting client doesn't need a scan of object_get_requests_.
+  absl::flat_hash_map<std::shared_ptr<Client>,
+                      absl::flat_hash_set<std::shared_ptr<GetRequest>>>
+      client_get_requests_;
+
   std::unordered_set<ObjectID> deletion_cache_;
 
   /// A callback to asynchronously spill objects when space is needed. The
@@ -88,7 +88,14 @@ void PlasmaStoreRunner::Start(ray::SpillObjectsCallback spill_objects_callback,
     absl::MutexLock lock(&store_runner_mutex_);
     allocator_ = std::make_unique<PlasmaAllocator>(plasma_directory_, fallback_directory_,
                                                    hugepages_enabled_, system_memory_);
-    store_.reset(new PlasmaStore(main_service_, *allocator_, socket_name_,
+    IAllocator *store_allocator = allocator_.get();
+    if (RayConfig::instance().plasma_slab_allocator_enabled()) {
+      slab_allocator_ = std::make_unique<SlabAllocator>(
+          *allocator_, RayConfig::instance().plasma_slab_max_object_size(),
+          RayConfig::instance().plasma_slab_size());
+      store_allocator = slab_allocator_.get();
+    }
+    store_.reset(new PlasmaStore(main_service_, *store_allocator, socket_name_,
                                  RayConfig::instance().object_store_full_delay_ms(),
                                  RayConfig::instance().object_spilling_threshold(),
                                  spill_objects_callback, object_store_full_callback,
@@ -113,14 +120,25 @@ void PlasmaStoreRunner::Shutdown() {
     store_->Stop();
     store_ = nullptr;
   }
+  // Slabs must be handed back before the underlying allocator goes away.
+  slab_allocator_ = nullptr;
 }
 
 bool PlasmaStoreRunner::IsPlasmaObjectSpillable(const ObjectID &object_id) {
   return store_->IsObjectSpillable(object_id);
 }
 
+void PlasmaStoreRunner::SetObjectProvenance(const ObjectID &object_id,
+                                            ObjectProvenance provenance) {
+  store_->SetObjectProvenance(object_id, provenance);
+}
+
 int64_t PlasmaStoreRunner::GetConsumedBytes() { return store_->GetConsumedBytes(); }
 
+int64_t PlasmaStoreRunner::GetPendingCreateBytes() {
+  return store_->GetPendingCreateBytes();
+}
+
 int64_t PlasmaStoreRunner::GetFallbackAllocated() const {
   absl::MutexLock lock(&store_runner_mutex_);
   return allocator_ ? allocator_->FallbackAllocated() : 0;
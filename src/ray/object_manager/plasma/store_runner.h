@@ -6,6 +6,7 @@
 #include "absl/synchronization/mutex.h"
 #include "ray/common/asio/instrumented_io_context.h"
 #include "ray/object_manager/plasma/plasma_allocator.h"
+#include "ray/object_manager/plasma/slab_allocator.h"
 #include "ray/object_manager/plasma/store.h"
 
 namespace plasma {
@@ -23,7 +24,10 @@ class PlasmaStoreRunner {
 
   bool IsPlasmaObjectSpillable(const ObjectID &object_id);
 
+  void SetObjectProvenance(const ObjectID &object_id, ObjectProvenance provenance);
+
   int64_t GetConsumedBytes();
+  int64_t GetPendingCreateBytes();
   int64_t GetFallbackAllocated() const;
 
   void GetAvailableMemoryAsync(std::function<void(size_t)> callback) const {
@@ -41,6 +45,8 @@ class PlasmaStoreRunner {
   std::string fallback_directory_;
   mutable instrumented_io_context main_service_;
   std::unique_ptr<PlasmaAllocator> allocator_;
+  /// Serves small objects out of slabs of allocator_, if enabled.
+  std::unique_ptr<SlabAllocator> slab_allocator_;
   std::unique_ptr<PlasmaStore> store_;
 };
 
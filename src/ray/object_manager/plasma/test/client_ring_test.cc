@@ -0,0 +1,204 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/client_ring.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include "gtest/gtest.h"
+
+namespace plasma {
+namespace {
+const int64_t kCapacity = 1024;
+
+// Rings are normally placed in shared memory, but any suitably aligned memory
+// works for testing.
+struct alignas(64) RingMemory {
+  uint8_t bytes[kCapacity * 2];
+};
+
+std::vector<uint8_t> ToBytes(const std::string &str) {
+  return std::vector<uint8_t>(str.begin(), str.end());
+}
+
+SpscRing MakeRing(RingMemory *memory, bool consumer_waiting = false) {
+  EXPECT_LE(SpscRing::RequiredSize(kCapacity), static_cast<int64_t>(sizeof(*memory)));
+  SpscRing::Initialize(memory->bytes, consumer_waiting);
+  return SpscRing(memory->bytes, kCapacity);
+}
+}  // namespace
+
+TEST(SpscRingTest, PushPop) {
+  RingMemory memory;
+  auto ring = MakeRing(&memory);
+  int64_t type;
+  std::vector<uint8_t> message;
+  ASSERT_FALSE(ring.TryPop(&type, &message));
+
+  auto hello = ToBytes("hello");
+  ASSERT_TRUE(ring.TryPush(1, hello.data(), hello.size()));
+  ASSERT_TRUE(ring.TryPush(2, nullptr, 0));
+  ASSERT_TRUE(ring.TryPop(&type, &message));
+  EXPECT_EQ(1, type);
+  EXPECT_EQ(hello, message);
+  ASSERT_TRUE(ring.TryPop(&type, &message));
+  EXPECT_EQ(2, type);
+  EXPECT_TRUE(message.empty());
+  ASSERT_FALSE(ring.TryPop(&type, &message));
+}
+
+TEST(SpscRingTest, WrapAround) {
+  RingMemory memory;
+  auto ring = MakeRing(&memory);
+  int64_t type;
+  std::vector<uint8_t> message;
+  // Messages of odd sizes make frames straddle the end of the ring.
+  for (int i = 0; i < 1000; i++) {
+    auto payload = ToBytes(std::string(i % 300, static_cast<char>('a' + i % 26)));
+    ASSERT_TRUE(ring.TryPush(i, payload.data(), payload.size()));
+    ASSERT_TRUE(ring.TryPop(&type, &message));
+    EXPECT_EQ(i, type);
+    EXPECT_EQ(payload, message);
+  }
+}
+
+TEST(SpscRingTest, Full) {
+  RingMemory memory;
+  auto ring = MakeRing(&memory);
+  EXPECT_TRUE(ring.Fits(kCapacity - 16));
+  EXPECT_FALSE(ring.Fits(kCapacity));
+
+  std::vector<uint8_t> payload(kCapacity / 2);
+  ASSERT_TRUE(ring.TryPush(1, payload.data(), payload.size()));
+  // The second message doesn't fit because of the frame headers.
+  ASSERT_FALSE(ring.TryPush(2, payload.data(), payload.size()));
+  int64_t type;
+  std::vector<uint8_t> message;
+  ASSERT_TRUE(ring.TryPop(&type, &message));
+  ASSERT_TRUE(ring.TryPush(2, payload.data(), payload.size()));
+}
+
+TEST(SpscRingTest, WakeupIsClaimedOnce) {
+  RingMemory memory;
+  auto ring = MakeRing(&memory, /*consumer_waiting=*/true);
+  // The consumer starts out asleep, so the first push wakes it up.
+  EXPECT_TRUE(ring.ClaimWakeup());
+  EXPECT_FALSE(ring.ClaimWakeup());
+
+  // A consumer that went to sleep and found a message after all takes its flag
+  // back, the producer then doesn't send a wakeup.
+  ring.MarkConsumerWaiting();
+  EXPECT_TRUE(ring.ClaimWakeup());
+  EXPECT_FALSE(ring.ClaimWakeup());
+}
+
+TEST(SpscRingTest, ConcurrentProducerConsumer) {
+  RingMemory memory;
+  auto ring = MakeRing(&memory, /*consumer_waiting=*/true);
+  const int kNumMessages = 100000;
+
+  // Stands in for the wakeup messages sent over the socket.
+  std::mutex mu;
+  std::condition_variable cv;
+  int pending_wakeups = 0;
+  auto send_wakeup = [&]() {
+    std::lock_guard<std::mutex> lock(mu);
+    pending_wakeups++;
+    cv.notify_one();
+  };
+  auto wait_for_wakeup = [&]() {
+    std::unique_lock<std::mutex> lock(mu);
+    cv.wait(lock, [&]() { return pending_wakeups > 0; });
+    pending_wakeups--;
+  };
+
+  std::thread producer([&]() {
+    for (int64_t i = 0; i < kNumMessages; i++) {
+      while (!ring.TryPush(i, reinterpret_cast<const uint8_t *>(&i), sizeof(i))) {
+        std::this_thread::yield();
+      }
+      if (ring.ClaimWakeup()) {
+        send_wakeup();
+      }
+    }
+  });
+
+  int64_t expected = 0;
+  int64_t type;
+  std::vector<uint8_t> message;
+  wait_for_wakeup();
+  while (expected < kNumMessages) {
+    if (ring.TryPop(&type, &message)) {
+      ASSERT_EQ(expected, type);
+      ASSERT_EQ(sizeof(int64_t), message.size());
+      ASSERT_EQ(expected, *reinterpret_cast<const int64_t *>(message.data()));
+      expected++;
+      continue;
+    }
+    ring.MarkConsumerWaiting();
+    if (ring.TryPop(&type, &message)) {
+      ASSERT_EQ(expected, type);
+      expected++;
+      if (!ring.ClaimWakeup()) {
+        wait_for_wakeup();
+      }
+      continue;
+    }
+    // If a wakeup was lost, this hangs.
+    wait_for_wakeup();
+  }
+  producer.join();
+  EXPECT_EQ(0, pending_wakeups);
+}
+
+#ifdef __linux__
+TEST(ClientRingsTest, SharedBetweenMappings) {
+  std::unique_ptr<ClientRings> store_side;
+  ASSERT_TRUE(ClientRings::Create(kCapacity, &store_side).ok());
+  std::unique_ptr<ClientRings> client_side;
+  ASSERT_TRUE(ClientRings::Map(dup(store_side->Fd()), kCapacity, &client_side).ok());
+
+  auto request = ToBytes("request");
+  ASSERT_TRUE(client_side->Requests().TryPush(1, request.data(), request.size()));
+  // The store is asleep until the client wakes it up.
+  EXPECT_TRUE(client_side->Requests().ClaimWakeup());
+  int64_t type;
+  std::vector<uint8_t> message;
+  ASSERT_TRUE(store_side->Requests().TryPop(&type, &message));
+  EXPECT_EQ(request, message);
+
+  auto reply = ToBytes("reply");
+  ASSERT_TRUE(store_side->Replies().TryPush(2, reply.data(), reply.size()));
+  // The client polls for replies, so it doesn't need a wakeup.
+  EXPECT_FALSE(store_side->Replies().ClaimWakeup());
+  ASSERT_TRUE(client_side->Replies().TryPop(&type, &message));
+  EXPECT_EQ(2, type);
+  EXPECT_EQ(reply, message);
+  EXPECT_FALSE(store_side->Requests().TryPop(&type, &message));
+}
+#endif
+
+}  // namespace plasma
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
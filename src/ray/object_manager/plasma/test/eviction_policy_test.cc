@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include "ray/object_manager/plasma/eviction_policy.h"
+
+#include <fstream>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ray/object_manager/plasma/object_store.h"
@@ -75,6 +78,201 @@ TEST(LRUCacheTest, Test) {
   EXPECT_EQ(1024, cache.OriginalCapacity());
 }
 
+TEST(GDSFCacheTest, EvictsLargeColdObjectsFirst) {
+  GDSFCache cache("cache");
+  ObjectID small = ObjectID::FromRandom();
+  ObjectID large = ObjectID::FromRandom();
+  cache.Add(large, 100);
+  cache.Add(small, 10);
+  {
+    std::vector<ObjectID> objects_to_evict;
+    EXPECT_EQ(100, cache.ChooseObjectsToEvict(1, objects_to_evict));
+    EXPECT_EQ(objects_to_evict, std::vector<ObjectID>{large});
+  }
+
+  // Frequently used objects are kept even when they are large.
+  EXPECT_EQ(100, cache.Remove(large));
+  for (int i = 0; i < 20; i++) {
+    cache.OnAccess(large);
+  }
+  cache.Add(large, 100);
+  {
+    std::vector<ObjectID> objects_to_evict;
+    EXPECT_EQ(10, cache.ChooseObjectsToEvict(1, objects_to_evict));
+    EXPECT_EQ(objects_to_evict, std::vector<ObjectID>{small});
+  }
+
+  // Choosing doesn't remove objects.
+  EXPECT_TRUE(cache.Exists(small));
+  EXPECT_EQ(10, cache.Remove(small));
+  EXPECT_EQ(-1, cache.Remove(small));
+  EXPECT_FALSE(cache.Exists(small));
+}
+
+TEST(TwoQueueCacheTest, ProtectsObjectsUsedMoreThanOnce) {
+  TwoQueueCache cache("cache", 100);
+  ObjectID hot = ObjectID::FromRandom();
+  cache.Add(hot, 10);
+  for (int i = 0; i < 2; i++) {
+    cache.Remove(hot);
+    cache.OnAccess(hot);
+    cache.Add(hot, 10);
+  }
+  std::vector<ObjectID> scan;
+  for (int i = 0; i < 5; i++) {
+    scan.push_back(ObjectID::FromRandom());
+    cache.Add(scan.back(), 10);
+  }
+
+  // Objects on probation are evicted first, oldest first.
+  std::vector<ObjectID> objects_to_evict;
+  EXPECT_EQ(30, cache.ChooseObjectsToEvict(30, objects_to_evict));
+  EXPECT_EQ(objects_to_evict, std::vector<ObjectID>(scan.begin(), scan.begin() + 3));
+
+  // Once probation is within its share of the capacity, protected objects are
+  // evicted first.
+  for (const auto &object_id : objects_to_evict) {
+    cache.Remove(object_id);
+  }
+  objects_to_evict.clear();
+  EXPECT_EQ(10, cache.ChooseObjectsToEvict(10, objects_to_evict));
+  EXPECT_EQ(objects_to_evict, std::vector<ObjectID>{hot});
+}
+
+TEST(TwoQueueCacheTest, ProtectsRecentlyDeletedObjects) {
+  TwoQueueCache cache("cache", 20);
+  ObjectID first = ObjectID::FromRandom();
+  ObjectID second = ObjectID::FromRandom();
+  cache.Add(first, 10);
+  cache.Remove(first);
+  cache.OnDelete(first);
+  cache.Add(second, 10);
+  // The object is created again after it was evicted, so it's protected.
+  cache.Add(first, 10);
+  std::vector<ObjectID> objects_to_evict;
+  EXPECT_EQ(10, cache.ChooseObjectsToEvict(1, objects_to_evict));
+  EXPECT_EQ(objects_to_evict, std::vector<ObjectID>{second});
+}
+
+TEST(EvictionCacheTest, Registry) {
+  for (const auto &name : {"lru", "gdsf", "2q"}) {
+    EXPECT_NE(nullptr, CreateEvictionCache(name, 100)) << name;
+  }
+  EXPECT_EQ(nullptr, CreateEvictionCache("random", 100));
+  RegisterEvictionCache("random", [](int64_t capacity) {
+    return std::make_unique<LRUCache>("random", capacity);
+  });
+  EXPECT_NE(nullptr, CreateEvictionCache("random", 100));
+}
+
+/// Replays an access trace against an eviction cache, the same way
+/// EvictionPolicy drives it, and counts how many accesses hit objects that are
+/// still in the store.
+class TraceReplayer {
+ public:
+  TraceReplayer(std::unique_ptr<EvictionCache> cache, int64_t capacity)
+      : cache_(std::move(cache)), capacity_(capacity) {}
+
+  void Access(const ObjectID &object_id, int64_t size) {
+    if (resident_.count(object_id) > 0) {
+      hits_++;
+    } else {
+      misses_++;
+      Create(object_id, size);
+    }
+    cache_->Remove(object_id);
+    cache_->OnAccess(object_id);
+    cache_->Add(object_id, size);
+  }
+
+  double HitRate() const { return static_cast<double>(hits_) / (hits_ + misses_); }
+
+ private:
+  void Create(const ObjectID &object_id, int64_t size) {
+    if (used_ + size > capacity_) {
+      std::vector<ObjectID> objects_to_evict;
+      cache_->ChooseObjectsToEvict(used_ + size - capacity_, objects_to_evict);
+      for (const auto &evicted : objects_to_evict) {
+        used_ -= resident_[evicted];
+        resident_.erase(evicted);
+        cache_->Remove(evicted);
+        cache_->OnDelete(evicted);
+      }
+    }
+    resident_[object_id] = size;
+    used_ += size;
+    cache_->Add(object_id, size);
+  }
+
+  std::unique_ptr<EvictionCache> cache_;
+  const int64_t capacity_;
+  absl::flat_hash_map<ObjectID, int64_t> resident_;
+  int64_t used_ = 0;
+  int64_t hits_ = 0;
+  int64_t misses_ = 0;
+};
+
+typedef std::vector<std::pair<ObjectID, int64_t>> Trace;
+
+absl::flat_hash_map<std::string, double> ReplayTrace(const Trace &trace,
+                                                     int64_t capacity) {
+  absl::flat_hash_map<std::string, double> hit_rates;
+  for (const auto &name : {"lru", "gdsf", "2q"}) {
+    TraceReplayer replayer(CreateEvictionCache(name, capacity), capacity);
+    for (const auto &access : trace) {
+      replayer.Access(access.first, access.second);
+    }
+    hit_rates[name] = replayer.HitRate();
+    std::cout << "Policy " << name << " hit rate: " << hit_rates[name] << std::endl;
+  }
+  return hit_rates;
+}
+
+TEST(EvictionCacheTest, TraceReplayScanResistance) {
+  // A small hot set is read between scans that are larger than the store, as
+  // in a shuffle.
+  const int64_t capacity = 100;
+  std::vector<ObjectID> hot_set;
+  for (int i = 0; i < 20; i++) {
+    hot_set.push_back(ObjectID::FromRandom());
+  }
+  Trace trace;
+  for (int round = 0; round < 50; round++) {
+    for (const auto &object_id : hot_set) {
+      trace.emplace_back(object_id, 1);
+    }
+    for (int i = 0; i < 20; i++) {
+      trace.emplace_back(ObjectID::FromRandom(), 10);
+    }
+  }
+  auto hit_rates = ReplayTrace(trace, capacity);
+  EXPECT_GT(hit_rates["gdsf"], hit_rates["lru"] + 0.25);
+  EXPECT_GT(hit_rates["2q"], hit_rates["lru"] + 0.25);
+}
+
+TEST(EvictionCacheTest, TraceReplayRecordedTrace) {
+  // Set RAY_PLASMA_EVICTION_TRACE to a file with one "<object> <size>" access
+  // per line and RAY_PLASMA_EVICTION_TRACE_CAPACITY to the store size in bytes
+  // to compare the policies on a recorded access pattern.
+  const char *path = std::getenv("RAY_PLASMA_EVICTION_TRACE");
+  if (path == nullptr) {
+    GTEST_SKIP() << "RAY_PLASMA_EVICTION_TRACE is not set.";
+  }
+  const char *capacity = std::getenv("RAY_PLASMA_EVICTION_TRACE_CAPACITY");
+  ASSERT_NE(nullptr, capacity);
+  std::ifstream file(path);
+  ASSERT_TRUE(file.is_open()) << path;
+  absl::flat_hash_map<std::string, ObjectID> object_ids;
+  Trace trace;
+  std::string object;
+  int64_t size;
+  while (file >> object >> size) {
+    auto it = object_ids.emplace(object, ObjectID::FromRandom()).first;
+    trace.emplace_back(it->second, size);
+  }
+  ReplayTrace(trace, std::stoll(capacity));
+}
+
 class MockAllocator : public IAllocator {
  public:
   MOCK_METHOD1(Allocate, absl::optional<Allocation>(size_t bytes));
@@ -180,6 +378,68 @@ TEST(EvictionPolicyTest, Test) {
     EXPECT_TRUE(policy.IsObjectExists(key1));
   }
 }
+
+TEST(EvictionPolicyTest, PrefersReplaceableCopies) {
+  MockAllocator allocator;
+  MockObjectStore store;
+  EXPECT_CALL(allocator, GetFootprintLimit()).WillRepeatedly(Return(100));
+  ObjectID primary1 = ObjectID::FromRandom();
+  ObjectID secondary = ObjectID::FromRandom();
+  ObjectID primary2 = ObjectID::FromRandom();
+  ObjectID restored = ObjectID::FromRandom();
+
+  LocalObject object1{Allocation()};
+  object1.object_info.data_size = 10;
+  object1.source = flatbuf::ObjectSource::CreatedByWorker;
+  LocalObject object2{Allocation()};
+  object2.object_info.data_size = 20;
+  object2.source = flatbuf::ObjectSource::ReceivedFromRemoteRaylet;
+  LocalObject object3{Allocation()};
+  object3.object_info.data_size = 30;
+  object3.source = flatbuf::ObjectSource::CreatedByWorker;
+  LocalObject object4{Allocation()};
+  object4.object_info.data_size = 40;
+  object4.source = flatbuf::ObjectSource::RestoredFromStorage;
+  EXPECT_CALL(store, GetObject(primary1)).WillRepeatedly(Return(&object1));
+  EXPECT_CALL(store, GetObject(secondary)).WillRepeatedly(Return(&object2));
+  EXPECT_CALL(store, GetObject(primary2)).WillRepeatedly(Return(&object3));
+  EXPECT_CALL(store, GetObject(restored)).WillRepeatedly(Return(&object4));
+
+  auto create_objects = [&](EvictionPolicy &policy) {
+    for (const auto &object_id : {primary1, secondary, primary2, restored}) {
+      policy.ObjectCreated(object_id);
+    }
+  };
+
+  {
+    // Without the preference, objects are evicted in LRU order.
+    EvictionPolicy policy(store, allocator);
+    create_objects(policy);
+    std::vector<ObjectID> objects_to_evict;
+    EXPECT_EQ(60, policy.ChooseObjectsToEvict(50, objects_to_evict));
+    EXPECT_EQ(objects_to_evict, (std::vector<ObjectID>{primary1, secondary, primary2}));
+  }
+
+  {
+    EvictionPolicy policy(store, allocator, /*cache=*/nullptr,
+                          /*prefer_replaceable_copies=*/true);
+    create_objects(policy);
+    std::vector<ObjectID> objects_to_evict;
+    // The pulled and the restored copies go first.
+    EXPECT_EQ(60, policy.ChooseObjectsToEvict(50, objects_to_evict));
+    EXPECT_EQ(objects_to_evict, (std::vector<ObjectID>{secondary, restored}));
+
+    // A spilled object goes before the remaining primary copy.
+    objects_to_evict.clear();
+    policy.SetObjectProvenance(primary2, ObjectProvenance::kSpilled);
+    EXPECT_EQ(30, policy.ChooseObjectsToEvict(10, objects_to_evict));
+    EXPECT_EQ(objects_to_evict, std::vector<ObjectID>{primary2});
+
+    objects_to_evict.clear();
+    EXPECT_EQ(10, policy.ChooseObjectsToEvict(100, objects_to_evict));
+    EXPECT_EQ(objects_to_evict, std::vector<ObjectID>{primary1});
+  }
+}
 }  // namespace plasma
 
 int main(int argc, char **argv) {
@@ -34,6 +34,7 @@ class MockEvictionPolicy : public IEvictionPolicy {
   MOCK_METHOD1(EndObjectAccess, void(const ObjectID &));
   MOCK_METHOD2(ChooseObjectsToEvict, int64_t(int64_t, std::vector<ObjectID> &));
   MOCK_METHOD1(RemoveObject, void(const ObjectID &));
+  MOCK_METHOD2(SetObjectProvenance, void(const ObjectID &, ObjectProvenance));
   MOCK_CONST_METHOD0(DebugString, std::string());
 };
 
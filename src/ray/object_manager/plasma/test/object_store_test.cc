@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "ray/object_manager/plasma/object_store.h"
+#include <algorithm>
 #include <limits>
 #include "absl/random/random.h"
 #include "absl/strings/str_format.h"
@@ -173,6 +174,39 @@ TEST(ObjectStoreTest, PassThroughTest) {
     EXPECT_EQ(store.GetNumObjectsUnsealed(), 0);
   }
 }
+
+TEST(ObjectStoreTest, ObjectsStayInPlace) {
+  MockAllocator allocator;
+  ObjectStore store(allocator);
+  EXPECT_CALL(allocator, Allocate(_)).WillRepeatedly(Invoke([](size_t bytes) {
+    return absl::optional<Allocation>(CreateAllocation(Allocation(), bytes));
+  }));
+  EXPECT_CALL(allocator, Free(_)).Times(AnyNumber());
+
+  // Enough objects to fill more than one slab.
+  std::vector<ObjectID> ids;
+  std::vector<const LocalObject *> entries;
+  for (int i = 0; i < 3000; i++) {
+    ids.push_back(ObjectID::FromRandom());
+    entries.push_back(store.CreateObject(CreateObjectInfo(ids.back(), 10), {}, false));
+    EXPECT_NE(entries.back(), nullptr);
+  }
+  // Deleting objects doesn't move the others.
+  for (int i = 0; i < 3000; i += 2) {
+    EXPECT_TRUE(store.DeleteObject(ids[i]));
+  }
+  for (int i = 1; i < 3000; i += 2) {
+    EXPECT_EQ(store.GetObject(ids[i]), entries[i]);
+    EXPECT_EQ(store.GetObject(ids[i])->object_info.object_id, ids[i]);
+  }
+  // New objects reuse the freed slots.
+  for (int i = 0; i < 3000; i += 2) {
+    auto entry = store.CreateObject(CreateObjectInfo(ids[i], 10), {}, false);
+    EXPECT_NE(std::find(entries.begin(), entries.end(), entry), entries.end());
+    EXPECT_EQ(store.SealObject(ids[i]), entry);
+  }
+  EXPECT_EQ(store.GetNumObjectsUnsealed(), 1500);
+}
 }  // namespace plasma
 
 int main(int argc, char **argv) {
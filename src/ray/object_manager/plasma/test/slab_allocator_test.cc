@@ -0,0 +1,161 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/slab_allocator.h"
+
+#include <boost/filesystem.hpp>
+
+#include "gtest/gtest.h"
+#include "ray/object_manager/plasma/plasma_allocator.h"
+
+using namespace boost::filesystem;
+
+namespace plasma {
+namespace {
+const int64_t kKB = 1024;
+const int64_t kMB = 1024 * 1024;
+
+std::string CreateTestDir() {
+  path directory = temp_directory_path() / unique_path();
+  create_directories(directory);
+  return directory.string();
+}
+}  // namespace
+
+// dlmalloc is a process wide singleton, so all cases share one allocator.
+class SlabAllocatorTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    underlying_ = new PlasmaAllocator(CreateTestDir(), CreateTestDir(),
+                                      /*hugepage_enabled=*/false, 64 * kMB);
+  }
+
+  static PlasmaAllocator *underlying_;
+};
+
+PlasmaAllocator *SlabAllocatorTest::underlying_ = nullptr;
+
+TEST_F(SlabAllocatorTest, SizeClasses) {
+  SlabAllocator allocator(*underlying_, /*max_slab_object_size=*/kMB,
+                          /*slab_size=*/4 * kMB);
+  const auto &size_classes = allocator.SizeClasses();
+  ASSERT_FALSE(size_classes.empty());
+  EXPECT_EQ(4 * kKB, size_classes.front());
+  EXPECT_EQ(kMB, size_classes.back());
+  for (size_t i = 1; i < size_classes.size(); i++) {
+    EXPECT_LT(size_classes[i - 1], size_classes[i]);
+    EXPECT_EQ(0, size_classes[i] % 64);
+    // Internal fragmentation is bounded by a quarter of the block size.
+    EXPECT_LE(size_classes[i] - size_classes[i - 1], size_classes[i] / 4);
+  }
+}
+
+TEST_F(SlabAllocatorTest, SmallObjectsShareSlabs) {
+  SlabAllocator allocator(*underlying_, /*max_slab_object_size=*/kMB,
+                          /*slab_size=*/4 * kMB);
+  std::vector<Allocation> allocations;
+  for (int i = 0; i < 3; i++) {
+    auto allocation = allocator.Allocate(100 * kKB);
+    ASSERT_TRUE(allocation.has_value());
+    EXPECT_EQ(100 * kKB, allocation->size);
+    allocations.push_back(std::move(allocation.value()));
+  }
+  // All three objects fit in the same slab, back to back.
+  EXPECT_EQ(1, allocator.NumSlabs());
+  auto block_size = static_cast<uint8_t *>(allocations[1].address) -
+                    static_cast<uint8_t *>(allocations[0].address);
+  EXPECT_GE(block_size, 100 * kKB);
+  EXPECT_EQ(allocations[0].fd, allocations[1].fd);
+  EXPECT_EQ(allocations[0].offset + block_size, allocations[1].offset);
+  EXPECT_EQ(allocations[0].mmap_size, allocations[1].mmap_size);
+  EXPECT_EQ(3 * block_size, allocator.Allocated());
+
+  // A freed block is reused by the next object of the same size class.
+  void *freed = allocations[1].address;
+  allocator.Free(std::move(allocations[1]));
+  EXPECT_EQ(2 * block_size, allocator.Allocated());
+  auto reused = allocator.Allocate(110 * kKB);
+  ASSERT_TRUE(reused.has_value());
+  EXPECT_EQ(freed, reused->address);
+  allocator.Free(std::move(reused.value()));
+
+  // The slab is handed back once all of its blocks are free.
+  allocator.Free(std::move(allocations[0]));
+  allocator.Free(std::move(allocations[2]));
+  EXPECT_EQ(0, allocator.NumSlabs());
+  EXPECT_EQ(0, allocator.Allocated());
+  EXPECT_EQ(0, underlying_->Allocated());
+}
+
+TEST_F(SlabAllocatorTest, LargeObjectsBypassSlabs) {
+  SlabAllocator allocator(*underlying_, /*max_slab_object_size=*/kMB,
+                          /*slab_size=*/4 * kMB);
+  auto allocation = allocator.Allocate(2 * kMB);
+  ASSERT_TRUE(allocation.has_value());
+  EXPECT_EQ(0, allocator.NumSlabs());
+  EXPECT_EQ(2 * kMB, allocator.Allocated());
+  EXPECT_EQ(2 * kMB, underlying_->Allocated());
+  allocator.Free(std::move(allocation.value()));
+  EXPECT_EQ(0, allocator.Allocated());
+  EXPECT_EQ(0, underlying_->Allocated());
+}
+
+TEST_F(SlabAllocatorTest, SizeClassesDontMix) {
+  SlabAllocator allocator(*underlying_, /*max_slab_object_size=*/kMB,
+                          /*slab_size=*/4 * kMB);
+  auto small = allocator.Allocate(8 * kKB);
+  auto large = allocator.Allocate(512 * kKB);
+  ASSERT_TRUE(small.has_value());
+  ASSERT_TRUE(large.has_value());
+  EXPECT_EQ(2, allocator.NumSlabs());
+  allocator.Free(std::move(small.value()));
+  EXPECT_EQ(1, allocator.NumSlabs());
+  allocator.Free(std::move(large.value()));
+  EXPECT_EQ(0, allocator.NumSlabs());
+}
+
+TEST_F(SlabAllocatorTest, FallsBackToDirectAllocationWhenSlabDoesNotFit) {
+  SlabAllocator allocator(*underlying_, /*max_slab_object_size=*/kMB,
+                          /*slab_size=*/4 * kMB);
+  // Fill up the store, then leave a 1MB hole, so that a fresh slab no longer
+  // fits while the object itself still does.
+  std::vector<Allocation> fillers;
+  for (int64_t filler_size : {4 * kMB, kMB}) {
+    while (true) {
+      auto allocation = underlying_->Allocate(filler_size);
+      if (!allocation.has_value()) {
+        break;
+      }
+      fillers.push_back(std::move(allocation.value()));
+    }
+  }
+  underlying_->Free(std::move(fillers.back()));
+  fillers.pop_back();
+  auto allocation = allocator.Allocate(100 * kKB);
+  ASSERT_TRUE(allocation.has_value());
+  EXPECT_EQ(0, allocator.NumSlabs());
+  EXPECT_EQ(100 * kKB, allocator.Allocated());
+  allocator.Free(std::move(allocation.value()));
+  for (auto &filler : fillers) {
+    underlying_->Free(std::move(filler));
+  }
+  EXPECT_EQ(0, allocator.Allocated());
+}
+
+}  // namespace plasma
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,6 +16,7 @@
 
 #include "absl/random/random.h"
 
+#include "ray/common/ray_config.h"
 #include "ray/object_manager/plasma/object_lifecycle_manager.h"
 
 using namespace ray;
@@ -32,7 +33,14 @@ int64_t Random(int64_t max) {
 
 class DummyAllocator : public IAllocator {
  public:
+  DummyAllocator(int64_t footprint_limit = std::numeric_limits<int64_t>::max(),
+                 bool fallback_enabled = false)
+      : footprint_limit_(footprint_limit), fallback_enabled_(fallback_enabled) {}
+
   absl::optional<Allocation> Allocate(size_t bytes) override {
+    if (allocated_ > footprint_limit_ - static_cast<int64_t>(bytes)) {
+      return absl::nullopt;
+    }
     allocated_ += bytes;
     auto allocation = Allocation();
     allocation.size = bytes;
@@ -40,21 +48,36 @@ class DummyAllocator : public IAllocator {
   }
 
   absl::optional<Allocation> FallbackAllocate(size_t bytes) override {
-    return absl::nullopt;
+    if (!fallback_enabled_) {
+      return absl::nullopt;
+    }
+    fallback_allocated_ += bytes;
+    auto allocation = Allocation();
+    allocation.size = bytes;
+    // Fallback allocations are told apart by their device number.
+    allocation.device_num = -1;
+    return std::move(allocation);
   }
 
-  void Free(Allocation allocation) override { allocated_ -= allocation.size; }
-
-  int64_t GetFootprintLimit() const override {
-    return std::numeric_limits<int64_t>::max();
+  void Free(Allocation allocation) override {
+    if (allocation.device_num == -1) {
+      fallback_allocated_ -= allocation.size;
+    } else {
+      allocated_ -= allocation.size;
+    }
   }
 
+  int64_t GetFootprintLimit() const override { return footprint_limit_; }
+
   int64_t Allocated() const override { return allocated_; }
 
-  int64_t FallbackAllocated() const override { return 0; }
+  int64_t FallbackAllocated() const override { return fallback_allocated_; }
 
  private:
+  const int64_t footprint_limit_;
+  const bool fallback_enabled_;
   int64_t allocated_ = 0;
+  int64_t fallback_allocated_ = 0;
 };
 
 struct ObjectStatsCollectorTest : public Test {
@@ -63,8 +86,11 @@ struct ObjectStatsCollectorTest : public Test {
     Reset();
   }
 
-  void Reset() {
-    allocator_ = std::make_unique<DummyAllocator>();
+  void Reset(std::unique_ptr<DummyAllocator> allocator =
+                 std::make_unique<DummyAllocator>()) {
+    // The objects of the old manager are freed to the old allocator.
+    manager_.reset();
+    allocator_ = std::move(allocator);
     manager_ =
         std::make_unique<ObjectLifecycleManager>(*allocator_, [](auto /* unused */) {});
     collector_ = &manager_->stats_collector_;
@@ -90,9 +116,17 @@ struct ObjectStatsCollectorTest : public Test {
     int64_t num_bytes_received = 0;
     int64_t num_objects_errored = 0;
     int64_t num_bytes_errored = 0;
+    absl::flat_hash_map<JobID, ObjectStatsCollector::JobUsage> job_usages;
 
     for (const auto &obj_entry : object_store_->object_table_) {
-      const auto &obj = obj_entry.second;
+      const auto obj = object_store_->ObjectAt(obj_entry.second);
+
+      auto &job_usage = job_usages[ObjectStatsCollector::GetJobId(obj_entry.first)];
+      job_usage.num_objects++;
+      job_usage.num_bytes += obj->GetObjectSize();
+      if (obj->fallback_allocated) {
+        job_usage.num_bytes_fallback_allocated += obj->GetObjectSize();
+      }
 
       if (obj->ref_count > 0) {
         num_objects_in_use++;
@@ -146,6 +180,14 @@ struct ObjectStatsCollectorTest : public Test {
     EXPECT_EQ(num_bytes_received, collector_->num_bytes_received_);
     EXPECT_EQ(num_objects_errored, collector_->num_objects_errored_);
     EXPECT_EQ(num_bytes_errored, collector_->num_bytes_errored_);
+    EXPECT_EQ(job_usages.size(), collector_->job_usages_.size());
+    for (const auto &entry : job_usages) {
+      auto usage = collector_->GetJobUsage(entry.first);
+      EXPECT_EQ(entry.second.num_objects, usage.num_objects);
+      EXPECT_EQ(entry.second.num_bytes, usage.num_bytes);
+      EXPECT_EQ(entry.second.num_bytes_fallback_allocated,
+                usage.num_bytes_fallback_allocated);
+    }
   }
 
   ray::ObjectInfo CreateNewObjectInfo(int64_t data_size) {
@@ -153,10 +195,20 @@ struct ObjectStatsCollectorTest : public Test {
     while (used_ids_.count(id) > 0) {
       id = ObjectID::FromRandom();
     }
+    return CreateNewObjectInfo(id, data_size);
+  }
+
+  ray::ObjectInfo CreateNewObjectInfo(const JobID &job_id, int64_t data_size) {
+    auto id = ObjectID::FromIndex(TaskID::ForDriverTask(job_id), used_ids_.size() + 1);
+    return CreateNewObjectInfo(id, data_size);
+  }
+
+  ray::ObjectInfo CreateNewObjectInfo(const ObjectID &id, int64_t data_size) {
     used_ids_.insert(id);
     ray::ObjectInfo info;
     info.object_id = id;
     info.data_size = data_size;
+    info.metadata_size = 0;
     return info;
   }
 
@@ -277,4 +329,115 @@ TEST_F(ObjectStatsCollectorTest, RefCountPassThrough) {
   manager_->DeleteObject(id2);
   ExpectStatsMatch();
 }
+
+TEST_F(ObjectStatsCollectorTest, JobUsage) {
+  auto job1 = JobID::FromInt(1);
+  auto job2 = JobID::FromInt(2);
+  auto info1 = CreateNewObjectInfo(job1, 100);
+  auto info2 = CreateNewObjectInfo(job1, 200);
+  auto info3 = CreateNewObjectInfo(job2, 300);
+  manager_->CreateObject(info1, ObjectSource::CreatedByWorker, false);
+  manager_->CreateObject(info2, ObjectSource::RestoredFromStorage, false);
+  manager_->CreateObject(info3, ObjectSource::CreatedByWorker, false);
+  ExpectStatsMatch();
+  EXPECT_EQ(2, manager_->GetJobUsage(job1).num_objects);
+  EXPECT_EQ(300, manager_->GetJobUsage(job1).num_bytes);
+  EXPECT_EQ(300, manager_->GetJobUsage(job2).num_bytes);
+
+  manager_->SealObject(info1.object_id);
+  EvictObject(info1.object_id);
+  manager_->AbortObject(info3.object_id);
+  ExpectStatsMatch();
+  EXPECT_EQ(200, manager_->GetJobUsage(job1).num_bytes);
+  EXPECT_EQ(0, manager_->GetJobUsage(job2).num_objects);
+}
+
+TEST_F(ObjectStatsCollectorTest, Distributions) {
+  using Histogram = ObjectStatsCollector::Log2Histogram;
+  EXPECT_EQ(0, Histogram::BucketOf(0));
+  EXPECT_EQ(1, Histogram::BucketOf(1));
+  EXPECT_EQ(2, Histogram::BucketOf(3));
+  EXPECT_EQ(11, Histogram::BucketOf(1024));
+  EXPECT_EQ(Histogram::kNumBuckets - 1,
+            Histogram::BucketOf(std::numeric_limits<int64_t>::max()));
+
+  auto info1 = CreateNewObjectInfo(100);
+  auto info2 = CreateNewObjectInfo(1000);
+  auto info3 = CreateNewObjectInfo(1000);
+  manager_->CreateObject(info1, ObjectSource::CreatedByWorker, false);
+  manager_->CreateObject(info2, ObjectSource::CreatedByWorker, false);
+  manager_->CreateObject(info3, ObjectSource::ReceivedFromRemoteRaylet, false);
+  const auto &by_worker = collector_->GetDistributions(ObjectSource::CreatedByWorker);
+  const auto &received =
+      collector_->GetDistributions(ObjectSource::ReceivedFromRemoteRaylet);
+  EXPECT_EQ(2, by_worker.object_sizes.Count());
+  EXPECT_EQ(1, by_worker.object_sizes.counts[Histogram::BucketOf(100)]);
+  EXPECT_EQ(1, by_worker.object_sizes.counts[Histogram::BucketOf(1000)]);
+  EXPECT_EQ(1, received.object_sizes.Count());
+
+  // Accesses and lifetimes are recorded when objects leave the store, and only
+  // sealed objects have a lifetime.
+  manager_->SealObject(info1.object_id);
+  for (int i = 0; i < 3; i++) {
+    manager_->AddReference(info1.object_id);
+    manager_->RemoveReference(info1.object_id);
+  }
+  EXPECT_EQ(0, by_worker.access_counts.Count());
+  manager_->DeleteObject(info1.object_id);
+  manager_->AbortObject(info2.object_id);
+  EXPECT_EQ(2, by_worker.access_counts.Count());
+  EXPECT_EQ(1, by_worker.access_counts.counts[Histogram::BucketOf(3)]);
+  EXPECT_EQ(1, by_worker.access_counts.counts[Histogram::BucketOf(0)]);
+  EXPECT_EQ(1, by_worker.lifetimes_ms.Count());
+  EXPECT_EQ(0, received.lifetimes_ms.Count());
+  ExpectStatsMatch();
+}
+
+TEST_F(ObjectStatsCollectorTest, JobMemoryQuota) {
+  RayConfig::instance().initialize(R"({"plasma_job_memory_quota_fraction": 0.5})");
+  Reset(std::make_unique<DummyAllocator>(/*footprint_limit=*/1000,
+                                         /*fallback_enabled=*/true));
+  auto job1 = JobID::FromInt(1);
+  auto job2 = JobID::FromInt(2);
+
+  // The first job fills its half of the store.
+  auto info1 = CreateNewObjectInfo(job1, 400);
+  auto result = manager_->CreateObject(info1, ObjectSource::CreatedByWorker, false);
+  ASSERT_EQ(PlasmaError::OK, result.second);
+  EXPECT_FALSE(result.first->IsFallbackAllocated());
+
+  // More objects of the job go to the fallback allocator, even though there is
+  // space left in the store.
+  auto info2 = CreateNewObjectInfo(job1, 200);
+  result = manager_->CreateObject(info2, ObjectSource::CreatedByWorker, false);
+  ASSERT_EQ(PlasmaError::OK, result.second);
+  EXPECT_TRUE(result.first->IsFallbackAllocated());
+  EXPECT_EQ(400, allocator_->Allocated());
+  EXPECT_EQ(200, allocator_->FallbackAllocated());
+
+  // Objects the job didn't create itself are not limited.
+  auto info3 = CreateNewObjectInfo(job1, 200);
+  result = manager_->CreateObject(info3, ObjectSource::ReceivedFromRemoteRaylet, false);
+  ASSERT_EQ(PlasmaError::OK, result.second);
+  EXPECT_FALSE(result.first->IsFallbackAllocated());
+
+  // Other jobs have a quota of their own.
+  auto info4 = CreateNewObjectInfo(job2, 400);
+  result = manager_->CreateObject(info4, ObjectSource::CreatedByWorker, false);
+  ASSERT_EQ(PlasmaError::OK, result.second);
+  EXPECT_FALSE(result.first->IsFallbackAllocated());
+  ExpectStatsMatch();
+  EXPECT_EQ(200, manager_->GetJobUsage(job1).num_bytes_fallback_allocated);
+
+  // Freeing up memory of the job makes room in its quota again.
+  manager_->SealObject(info1.object_id);
+  EvictObject(info1.object_id);
+  auto info5 = CreateNewObjectInfo(job1, 300);
+  result = manager_->CreateObject(info5, ObjectSource::CreatedByWorker, false);
+  ASSERT_EQ(PlasmaError::OK, result.second);
+  EXPECT_FALSE(result.first->IsFallbackAllocated());
+  ExpectStatsMatch();
+
+  RayConfig::instance().initialize(R"({"plasma_job_memory_quota_fraction": 1.0})");
+}
 }  // namespace plasma
\ No newline at end of file
@@ -14,7 +14,10 @@
 
 #include "ray/object_manager/pull_manager.h"
 
+#include <algorithm>
+
 #include "ray/common/common_protocol.h"
+#include "ray/stats/stats.h"
 
 namespace ray {
 
@@ -26,10 +29,12 @@ PullManager::PullManager(
     const std::function<double()> get_time, int pull_timeout_ms,
     int64_t num_bytes_available,
     std::function<std::unique_ptr<RayObject>(const ObjectID &)> pin_object,
-    std::function<std::string(const ObjectID &)> get_locally_spilled_object_url)
+    std::function<std::string(const ObjectID &)> get_locally_spilled_object_url,
+    SendStripedPullRequestCallback send_striped_pull_request)
     : self_node_id_(self_node_id),
       object_is_local_(object_is_local),
       send_pull_request_(send_pull_request),
+      send_striped_pull_request_(send_striped_pull_request),
       cancel_pull_request_(cancel_pull_request),
       restore_spilled_object_(restore_spilled_object),
       get_time_(get_time),
@@ -142,7 +147,8 @@ bool PullManager::ActivateNextPullBundleRequest(const Queue &bundles,
     }
 
     // Quota check.
-    if (respect_quota && num_active_bundles_ >= 1 && bytes_to_pull > RemainingQuota()) {
+    if (respect_quota && num_active_bundles_ >= 1 &&
+        bytes_to_pull > RemainingQuota() - AdmissionHeadroom()) {
       RAY_LOG(DEBUG) << "Bundle would exceed quota: "
                      << "num_bytes_being_pulled(" << num_bytes_being_pulled_
                      << ") + "
@@ -151,6 +157,9 @@ bool PullManager::ActivateNextPullBundleRequest(const Queue &bundles,
                      << ") - "
                         "pinned_objects_size("
                      << pinned_objects_size_
+                     << ") + "
+                        "admission_headroom("
+                     << AdmissionHeadroom()
                      << ") > "
                         "num_bytes_available("
                      << num_bytes_available_ << ")";
@@ -244,6 +253,12 @@ int64_t PullManager::RemainingQuota() {
 
 bool PullManager::OverQuota() { return RemainingQuota() < 0L; }
 
+int64_t PullManager::AdmissionHeadroom() const {
+  const double fraction =
+      std::max(0.0, RayConfig::instance().pull_manager_admission_headroom_fraction());
+  return static_cast<int64_t>(fraction * num_bytes_available_);
+}
+
 void PullManager::UpdatePullsBasedOnAvailableMemory(int64_t num_bytes_available) {
   if (num_bytes_available_ != num_bytes_available) {
     RAY_LOG(DEBUG) << "Updating pulls based on available memory: " << num_bytes_available;
@@ -285,6 +300,10 @@ void PullManager::UpdatePullsBasedOnAvailableMemory(int64_t num_bytes_available)
   while (wait_requests_remaining) {
     int64_t margin_required =
         NextRequestBundleSize(wait_request_bundles_, highest_wait_req_id_being_pulled_);
+    if (margin_required > 0) {
+      // Make room for the headroom too, so that the wait request is activated below.
+      margin_required += AdmissionHeadroom();
+    }
     DeactivateUntilMarginAvailable("task args request", task_argument_bundles_,
                                    /*retain_min=*/0, /*quota_margin=*/margin_required,
                                    &highest_task_req_id_being_pulled_,
@@ -324,6 +343,8 @@ void PullManager::UpdatePullsBasedOnAvailableMemory(int64_t num_bytes_available)
       }
     }
   }
+
+  RestoreAheadTaskArguments();
 }
 
 std::vector<ObjectID> PullManager::CancelPull(uint64_t request_id) {
@@ -368,6 +389,9 @@ std::vector<ObjectID> PullManager::CancelPull(uint64_t request_id) {
       RAY_LOG(DEBUG) << "Removing an object pull request of id: " << obj_id;
       it->second.bundle_request_ids.erase(bundle_it->first);
       if (it->second.bundle_request_ids.empty()) {
+        // The first pull of the object is not a retry.
+        stats::ObjectManagerPullRetries().Record(
+            std::max<int>(it->second.num_retries - 1, 0));
         object_pull_requests_.erase(it);
         object_ids_to_cancel_subscription.push_back(obj_id);
       }
@@ -433,6 +457,63 @@ void PullManager::OnLocationChange(const ObjectID &object_id,
   }
 }
 
+void PullManager::RestoreAheadTaskArguments() {
+  const uint64_t num_bundles = RayConfig::instance().pull_manager_restore_ahead_bundles();
+  if (num_bundles == 0) {
+    return;
+  }
+  // Forget the objects that were restored, got activated or are no longer needed.
+  for (auto it = restore_ahead_objects_.begin(); it != restore_ahead_objects_.end();) {
+    if (object_pull_requests_.count(it->first) == 0 || object_is_local_(it->first) ||
+        IsObjectActive(it->first)) {
+      restore_ahead_bytes_ -= it->second;
+      restore_ahead_objects_.erase(it++);
+    } else {
+      it++;
+    }
+  }
+
+  const int64_t budget = static_cast<int64_t>(
+      std::max(0.0, RayConfig::instance().pull_manager_restore_ahead_fraction()) *
+      num_bytes_available_);
+  auto bundle_it = task_argument_bundles_.upper_bound(highest_task_req_id_being_pulled_);
+  for (uint64_t i = 0; i < num_bundles && bundle_it != task_argument_bundles_.end();
+       i++, bundle_it++) {
+    for (const auto &ref : bundle_it->second.objects) {
+      const auto obj_id = ObjectRefToId(ref);
+      if (restore_ahead_objects_.contains(obj_id) || object_is_local_(obj_id) ||
+          IsObjectActive(obj_id)) {
+        continue;
+      }
+      const auto &request = object_pull_requests_.at(obj_id);
+      if (!request.object_size_set) {
+        continue;
+      }
+      bool can_restore_directly =
+          !get_locally_spilled_object_url_(obj_id).empty() ||
+          (!request.spilled_url.empty() && request.spilled_node_id.IsNil());
+      if (!can_restore_directly) {
+        continue;
+      }
+      const int64_t object_size = request.object_size;
+      if (restore_ahead_bytes_ + object_size > budget) {
+        return;
+      }
+      RAY_LOG(DEBUG) << "Restoring object " << obj_id << " of queued task bundle "
+                     << bundle_it->first << " ahead of time";
+      restore_ahead_bytes_ += object_size;
+      restore_ahead_objects_.emplace(obj_id, object_size);
+      restore_spilled_object_(obj_id, request.spilled_url,
+                              [obj_id](const ray::Status &status) {
+                                if (!status.ok()) {
+                                  RAY_LOG(DEBUG) << "Restoring object " << obj_id
+                                                 << " ahead of time failed: " << status;
+                                }
+                              });
+    }
+  }
+}
+
 void PullManager::TryToMakeObjectLocal(const ObjectID &object_id) {
   // The object is already local; abort.
   if (object_is_local_(object_id)) {
@@ -506,15 +587,19 @@ bool PullManager::PullFromRandomLocation(const ObjectID &object_id) {
   // Make sure that there is at least one client which is not the local client.
   // TODO(rkn): It may actually be possible for this check to fail.
   if (node_vector.size() == 1 && node_vector[0] == self_node_id_) {
-    RAY_LOG(WARNING) << "The object manager with ID " << self_node_id_
-                     << " is trying to pull object " << object_id
-                     << " but the object table suggests that this object manager "
-                     << "already has the object. The object may have been evicted. It is "
-                     << "most likely due to memory pressure, object pull has been "
-                     << "requested before object location is updated.";
+    RAY_LOG_RATE_LIMITED(WARNING, 1, 10)
+        << "The object manager with ID " << self_node_id_ << " is trying to pull object "
+        << object_id << " but the object table suggests that this object manager "
+        << "already has the object. The object may have been evicted. It is "
+        << "most likely due to memory pressure, object pull has been "
+        << "requested before object location is updated.";
     return false;
   }
 
+  if (TryStripedPull(object_id, it->second)) {
+    return true;
+  }
+
   // Choose a random client to pull the object from.
   // Generate a random index.
   std::uniform_int_distribution<int> distribution(0, node_vector.size() - 1);
@@ -525,7 +610,7 @@ bool PullManager::PullFromRandomLocation(const ObjectID &object_id) {
   if (node_id == self_node_id_) {
     std::swap(node_vector[node_index], node_vector[node_vector.size() - 1]);
     node_vector.pop_back();
-    RAY_LOG(WARNING)
+    RAY_LOG_RATE_LIMITED(WARNING, 1, 10)
         << "The object manager with ID " << self_node_id_ << " is trying to pull object "
         << object_id << " but the object table suggests that this object manager "
         << "already has the object. It is most likely due to memory pressure, object "
@@ -540,6 +625,34 @@ bool PullManager::PullFromRandomLocation(const ObjectID &object_id) {
   return true;
 }
 
+bool PullManager::TryStripedPull(const ObjectID &object_id,
+                                 const ObjectPullRequest &request) {
+  const int64_t min_size = RayConfig::instance().object_manager_striped_pull_min_size();
+  const int64_t max_stripes = RayConfig::instance().object_manager_max_pull_stripes();
+  if (!send_striped_pull_request_ || min_size < 0 || max_stripes < 2 ||
+      !request.object_size_set ||
+      request.object_size < static_cast<size_t>(min_size)) {
+    return false;
+  }
+  std::vector<NodeID> node_ids;
+  for (const auto &node_id : request.client_locations) {
+    if (node_id != self_node_id_) {
+      node_ids.push_back(node_id);
+    }
+  }
+  if (node_ids.size() < 2) {
+    return false;
+  }
+  std::shuffle(node_ids.begin(), node_ids.end(), gen_);
+  if (node_ids.size() > static_cast<size_t>(max_stripes)) {
+    node_ids.resize(max_stripes);
+  }
+  RAY_LOG(DEBUG) << "Sending striped pull requests from " << self_node_id_ << " to "
+                 << node_ids.size() << " nodes of object " << object_id;
+  send_striped_pull_request_(object_id, node_ids, request.object_size);
+  return true;
+}
+
 void PullManager::ResetRetryTimer(const ObjectID &object_id) {
   auto it = object_pull_requests_.find(object_id);
   if (it != object_pull_requests_.end()) {
@@ -612,6 +725,23 @@ void PullManager::UnpinObject(const ObjectID &object_id) {
 
 int PullManager::NumActiveRequests() const { return object_pull_requests_.size(); }
 
+BundlePriority PullManager::GetPullPriority(const ObjectID &object_id) const {
+  auto it = object_pull_requests_.find(object_id);
+  if (it == object_pull_requests_.end()) {
+    return BundlePriority::TASK_ARGS;
+  }
+  auto priority = BundlePriority::TASK_ARGS;
+  for (auto request_id : it->second.bundle_request_ids) {
+    if (get_request_bundles_.count(request_id)) {
+      return BundlePriority::GET_REQUEST;
+    }
+    if (wait_request_bundles_.count(request_id)) {
+      priority = BundlePriority::WAIT_REQUEST;
+    }
+  }
+  return priority;
+}
+
 bool PullManager::IsObjectActive(const ObjectID &object_id) const {
   absl::MutexLock lock(&active_objects_mu_);
   return active_object_pull_requests_.count(object_id) == 1;
@@ -645,6 +775,29 @@ bool PullManager::HasPullsQueued() const {
   return active_object_pull_requests_.size() != object_pull_requests_.size();
 }
 
+int64_t PullManager::GetObjectBytesByNode(
+    const std::vector<ObjectID> &object_ids,
+    absl::flat_hash_map<NodeID, int64_t> *bytes_by_node) const {
+  int64_t total_bytes = 0;
+  for (const auto &object_id : object_ids) {
+    auto it = object_pull_requests_.find(object_id);
+    if (it == object_pull_requests_.end() || !it->second.object_size_set) {
+      continue;
+    }
+    const auto &request = it->second;
+    total_bytes += request.object_size;
+    for (const auto &node_id : request.client_locations) {
+      (*bytes_by_node)[node_id] += request.object_size;
+    }
+    if (!request.spilled_node_id.IsNil() &&
+        std::find(request.client_locations.begin(), request.client_locations.end(),
+                  request.spilled_node_id) == request.client_locations.end()) {
+      (*bytes_by_node)[request.spilled_node_id] += request.object_size;
+    }
+  }
+  return total_bytes;
+}
+
 std::string PullManager::BundleInfo(const Queue &bundles,
                                     uint64_t highest_id_being_pulled) const {
   auto it = bundles.begin();
@@ -43,6 +43,10 @@ enum BundlePriority {
   TASK_ARGS,
 };
 
+/// A callback to pull the chunks of an object from several nodes at once.
+using SendStripedPullRequestCallback = std::function<void(
+    const ObjectID &object_id, const std::vector<NodeID> &node_ids, size_t object_size)>;
+
 // Not thread-safe except for IsObjectActive().
 class PullManager {
  public:
@@ -59,6 +63,9 @@ class PullManager {
   /// cancel pulling an object.
   /// \param restore_spilled_object A callback which should
   /// retrieve an spilled object from the external store.
+  /// \param send_striped_pull_request A callback which should pull the chunks of an
+  /// object of the given size from all of the given nodes at once. If set, it is
+  /// used for large objects that are on several nodes.
   PullManager(
       NodeID &self_node_id, const std::function<bool(const ObjectID &)> object_is_local,
       const std::function<void(const ObjectID &, const NodeID &)> send_pull_request,
@@ -67,7 +74,8 @@ class PullManager {
       const std::function<double()> get_time, int pull_timeout_ms,
       int64_t num_bytes_available,
       std::function<std::unique_ptr<RayObject>(const ObjectID &object_id)> pin_object,
-      std::function<std::string(const ObjectID &)> get_locally_spilled_object_url);
+      std::function<std::string(const ObjectID &)> get_locally_spilled_object_url,
+      SendStripedPullRequestCallback send_striped_pull_request = nullptr);
 
   /// Add a new pull request for a bundle of objects. The objects in the
   /// request will get pulled once:
@@ -134,6 +142,10 @@ class PullManager {
   /// The number of ongoing object pulls.
   int NumActiveRequests() const;
 
+  /// Returns the highest priority of the bundle requests that need the object, or
+  /// TASK_ARGS if there are none.
+  BundlePriority GetPullPriority(const ObjectID &object_id) const;
+
   /// Returns whether the object is actively being pulled. object_required
   /// returns whether the object is still needed by some pull request on this
   /// node (but may not be actively pulled due to throttling).
@@ -152,6 +164,17 @@ class PullManager {
   /// there are object sizes missing.
   bool HasPullsQueued() const;
 
+  /// Add up the sizes of the given objects by the nodes that hold a copy, as far as
+  /// the pulls of the objects know. Objects that are not being pulled or whose size
+  /// is not known yet are skipped. A spilled copy counts for the node it was spilled
+  /// on.
+  ///
+  /// \param object_ids The objects.
+  /// \param[out] bytes_by_node The number of bytes of the objects on each node.
+  /// \return The total size of the objects that were not skipped.
+  int64_t GetObjectBytesByNode(const std::vector<ObjectID> &object_ids,
+                               absl::flat_hash_map<NodeID, int64_t> *bytes_by_node) const;
+
   std::string DebugString() const;
 
   /// Returns the number of bytes of quota remaining. When this is less than zero,
@@ -212,6 +235,17 @@ class PullManager {
   /// e.g., for get requests and to ensure at least one active request.
   bool OverQuota();
 
+  /// Returns the number of bytes of quota that must remain after activating a wait
+  /// or task argument bundle. This is the hysteresis between activating and
+  /// deactivating bundles.
+  int64_t AdmissionHeadroom() const;
+
+  /// Restore the spilled objects of the first `pull_manager_restore_ahead_bundles`
+  /// inactive task argument bundles, as long as the objects being restored ahead fit in
+  /// `pull_manager_restore_ahead_fraction` of the memory available for pulls. Only
+  /// objects that this node can restore itself are restored ahead.
+  void RestoreAheadTaskArguments();
+
   /// Pin the object if possible. Only actively pulled objects should be pinned.
   bool TryPinObject(const ObjectID &object_id);
 
@@ -225,6 +259,13 @@ class PullManager {
   /// \return True if a pull request was sent, otherwise false.
   bool PullFromRandomLocation(const ObjectID &object_id);
 
+  /// Pull a large object from several of its locations at once, if it is large
+  /// enough and on enough nodes. The locations are chosen again on every retry,
+  /// so the chunks that a slow node didn't send yet are spread over all nodes.
+  ///
+  /// \return True if a striped pull request was sent, otherwise false.
+  bool TryStripedPull(const ObjectID &object_id, const ObjectPullRequest &request);
+
   /// Update the request retry time for the given request.
   /// The retry timer is incremented exponentially, capped at 1024 * 10 seconds.
   ///
@@ -277,6 +318,7 @@ class PullManager {
   NodeID self_node_id_;
   const std::function<bool(const ObjectID &)> object_is_local_;
   const std::function<void(const ObjectID &, const NodeID &)> send_pull_request_;
+  const SendStripedPullRequestCallback send_striped_pull_request_;
   const std::function<void(const ObjectID &)> cancel_pull_request_;
   const RestoreSpilledObjectCallback restore_spilled_object_;
   const std::function<double()> get_time_;
@@ -359,6 +401,14 @@ class PullManager {
   /// The total size of pinned objects.
   int64_t pinned_objects_size_ = 0;
 
+  /// The objects of inactive task argument bundles that are being restored ahead of
+  /// time, and their sizes. An object is forgotten once it is local, active or no
+  /// longer requested.
+  absl::flat_hash_map<ObjectID, int64_t> restore_ahead_objects_;
+
+  /// The total size of the objects being restored ahead of time.
+  int64_t restore_ahead_bytes_ = 0;
+
   // A callback to get the spilled object URL if the object is spilled locally.
   // It will return an empty string otherwise.
   std::function<std::string(const ObjectID &)> get_locally_spilled_object_url_;
@@ -14,61 +14,128 @@
 
 #include "ray/object_manager/push_manager.h"
 
+#include <cmath>
+
 #include "ray/common/common_protocol.h"
+#include "ray/stats/stats.h"
 #include "ray/util/util.h"
 
 namespace ray {
 
 void PushManager::StartPush(const NodeID &dest_id, const ObjectID &obj_id,
                             int64_t num_chunks,
-                            std::function<void(int64_t)> send_chunk_fn) {
+                            std::function<void(int64_t)> send_chunk_fn,
+                            int64_t priority, int64_t num_bytes) {
   auto push_id = std::make_pair(dest_id, obj_id);
-  if (push_info_.contains(push_id)) {
+  auto it = push_info_.find(push_id);
+  if (it != push_info_.end()) {
     RAY_LOG(DEBUG) << "Duplicate push request " << push_id.first << ", "
                    << push_id.second;
+    if (priority < it->second->priority) {
+      it->second->priority = priority;
+      EraseIdleFlows();
+      ScheduleRemainingPushes();
+    }
     return;
   }
   RAY_CHECK(num_chunks > 0);
-  push_info_[push_id].reset(new PushState(num_chunks, send_chunk_fn));
+  const int64_t chunk_bytes = std::max<int64_t>(1, num_bytes / num_chunks);
+  push_info_[push_id].reset(
+      new PushState(num_chunks, send_chunk_fn, priority, chunk_bytes));
   ScheduleRemainingPushes();
 }
 
+std::vector<NodeID> PushManager::GetPushDestinations(const ObjectID &obj_id) const {
+  std::vector<NodeID> dest_ids;
+  for (const auto &pair : push_info_) {
+    if (pair.first.second == obj_id) {
+      dest_ids.push_back(pair.first.first);
+    }
+  }
+  return dest_ids;
+}
+
 void PushManager::OnChunkComplete(const NodeID &dest_id, const ObjectID &obj_id) {
   auto push_id = std::make_pair(dest_id, obj_id);
   chunks_in_flight_ -= 1;
   if (--push_info_[push_id]->chunks_remaining <= 0) {
     push_info_.erase(push_id);
+    EraseIdleFlows();
     RAY_LOG(DEBUG) << "Push for " << push_id.first << ", " << push_id.second
                    << " completed, remaining: " << NumPushesInFlight();
   }
   ScheduleRemainingPushes();
 }
 
+double &PushManager::GetVirtualTime(const FlowID &flow_id) {
+  auto it = virtual_times_.find(flow_id);
+  if (it == virtual_times_.end()) {
+    // A new queue starts at the current virtual time, so that it neither waits
+    // for the other queues nor gets to catch up on their past service.
+    it = virtual_times_.emplace(flow_id, virtual_clock_).first;
+  }
+  return it->second;
+}
+
+void PushManager::EraseIdleFlows() {
+  absl::flat_hash_set<FlowID> active_flows;
+  for (const auto &pair : push_info_) {
+    active_flows.emplace(pair.second->priority, pair.first.first);
+  }
+  for (auto it = virtual_times_.begin(); it != virtual_times_.end();) {
+    if (active_flows.contains(it->first)) {
+      it++;
+    } else {
+      virtual_times_.erase(it++);
+    }
+  }
+}
+
 void PushManager::ScheduleRemainingPushes() {
-  bool keep_looping = true;
-  // Loop over all active pushes for approximate round-robin prioritization.
-  // TODO(ekl) this isn't the best implementation of round robin, we should
-  // consider tracking the number of chunks active per-push and balancing those.
-  while (chunks_in_flight_ < max_chunks_in_flight_ && keep_looping) {
-    // Loop over each active push and try to send another chunk.
-    auto it = push_info_.begin();
-    keep_looping = false;
-    while (it != push_info_.end() && chunks_in_flight_ < max_chunks_in_flight_) {
-      auto push_id = it->first;
-      auto &info = it->second;
-      if (info->next_chunk_id < info->num_chunks) {
-        // Send the next chunk for this push.
-        info->chunk_send_fn(info->next_chunk_id++);
-        chunks_in_flight_ += 1;
-        keep_looping = true;
-        RAY_LOG(DEBUG) << "Sending chunk " << info->next_chunk_id << " of "
-                       << info->num_chunks << " for push " << push_id.first << ", "
-                       << push_id.second << ", chunks in flight " << NumChunksInFlight()
-                       << " / " << max_chunks_in_flight_
-                       << " max, remaining chunks: " << NumChunksRemaining();
+  const double weight_ratio = std::max<double>(
+      1, RayConfig::instance().object_manager_push_priority_weight_ratio());
+  while (chunks_in_flight_ < max_chunks_in_flight_) {
+    // Pick the queue that was served the least weighted bytes, and the push in it
+    // that has sent the fewest chunks.
+    const PushID *next_push_id = nullptr;
+    PushState *next_push = nullptr;
+    double next_virtual_time = 0;
+    for (auto &pair : push_info_) {
+      auto &info = pair.second;
+      if (info->next_chunk_id >= info->num_chunks) {
+        continue;
       }
-      it++;
+      const double virtual_time =
+          GetVirtualTime(std::make_pair(info->priority, pair.first.first));
+      if (next_push == nullptr || virtual_time < next_virtual_time ||
+          (virtual_time == next_virtual_time &&
+           info->next_chunk_id < next_push->next_chunk_id)) {
+        next_push_id = &pair.first;
+        next_push = info.get();
+        next_virtual_time = virtual_time;
+      }
+    }
+    if (next_push == nullptr) {
+      break;
+    }
+    // Higher priorities are charged less per byte, so they get more bandwidth.
+    virtual_clock_ = next_virtual_time;
+    GetVirtualTime(std::make_pair(next_push->priority, next_push_id->first)) +=
+        next_push->chunk_bytes *
+        std::pow(weight_ratio, std::max<int64_t>(0, next_push->priority));
+    if (next_push->next_chunk_id == 0) {
+      stats::ObjectManagerPushQueueingMs().Record(
+          current_time_ms() - next_push->start_time_ms,
+          {{stats::PeerNodeKey, next_push_id->first.Hex()}});
     }
+    // Send the next chunk for this push.
+    next_push->chunk_send_fn(next_push->next_chunk_id++);
+    chunks_in_flight_ += 1;
+    RAY_LOG(DEBUG) << "Sending chunk " << next_push->next_chunk_id << " of "
+                   << next_push->num_chunks << " for push " << next_push_id->first
+                   << ", " << next_push_id->second << ", chunks in flight "
+                   << NumChunksInFlight() << " / " << max_chunks_in_flight_
+                   << " max, remaining chunks: " << NumChunksRemaining();
   }
 }
 
@@ -22,6 +22,7 @@
 #include "ray/common/id.h"
 #include "ray/common/ray_config.h"
 #include "ray/common/status.h"
+#include "ray/util/util.h"
 
 namespace ray {
 
@@ -39,7 +40,13 @@ class PushManager {
 
   /// Start pushing an object subject to max chunks in flight limit.
   ///
-  /// Duplicate concurrent pushes to the same destination will be suppressed.
+  /// Duplicate concurrent pushes to the same destination will be suppressed, but
+  /// raise the priority of the running push if theirs is higher.
+  ///
+  /// The chunks in flight are shared between the pushes by weighted fair queuing
+  /// over bytes. Each priority and destination pair is a queue; a priority gets
+  /// object_manager_push_priority_weight_ratio times the bandwidth of the next
+  /// lower one, and the pushes in a queue share its bandwidth equally.
   ///
   /// \param dest_id The node to send to.
   /// \param obj_id The object to send.
@@ -47,13 +54,19 @@ class PushManager {
   /// \param send_chunk_fn This function will be called with args 0...{num_chunks-1}.
   ///                      The caller promises to call PushManager::OnChunkComplete()
   ///                      once a call to send_chunk_fn finishes.
+  /// \param priority The priority of the push, lower values are higher priorities.
+  /// \param num_bytes The total number of bytes to send, or 0 if unknown.
   void StartPush(const NodeID &dest_id, const ObjectID &obj_id, int64_t num_chunks,
-                 std::function<void(int64_t)> send_chunk_fn);
+                 std::function<void(int64_t)> send_chunk_fn, int64_t priority = 0,
+                 int64_t num_bytes = 0);
 
   /// Called every time a chunk completes to trigger additional sends.
   /// TODO(ekl) maybe we should cancel the entire push on error.
   void OnChunkComplete(const NodeID &dest_id, const ObjectID &obj_id);
 
+  /// Return the nodes that an object is currently being pushed to.
+  std::vector<NodeID> GetPushDestinations(const ObjectID &obj_id) const;
+
   /// Return the number of chunks currently in flight. For testing only.
   int64_t NumChunksInFlight() const { return chunks_in_flight_; };
 
@@ -91,12 +104,22 @@ class PushManager {
     /// The number of chunks remaining to send. Once this number drops
     /// to zero, the push is considered complete.
     int64_t chunks_remaining;
-
-    PushState(int64_t num_chunks, std::function<void(int64_t)> chunk_send_fn)
+    /// The priority of the push, lower values are higher priorities.
+    int64_t priority;
+    /// The (approximate) number of bytes per chunk.
+    const int64_t chunk_bytes;
+    /// The time in milliseconds at which the push was started.
+    const int64_t start_time_ms;
+
+    PushState(int64_t num_chunks, std::function<void(int64_t)> chunk_send_fn,
+              int64_t priority, int64_t chunk_bytes)
         : num_chunks(num_chunks),
           chunk_send_fn(chunk_send_fn),
           next_chunk_id(0),
-          chunks_remaining(num_chunks) {}
+          chunks_remaining(num_chunks),
+          priority(priority),
+          chunk_bytes(chunk_bytes),
+          start_time_ms(current_time_ms()) {}
   };
 
   /// Called on completion events to trigger additional pushes.
@@ -105,6 +128,15 @@ class PushManager {
   /// Pair of (destination, object_id).
   typedef std::pair<NodeID, ObjectID> PushID;
 
+  /// Pair of (priority, destination), the queues that bandwidth is shared between.
+  typedef std::pair<int64_t, NodeID> FlowID;
+
+  /// Return the virtual time of a queue, starting new queues at the current one.
+  double &GetVirtualTime(const FlowID &flow_id);
+
+  /// Forget the virtual times of the queues without pushes.
+  void EraseIdleFlows();
+
   /// Max number of chunks in flight allowed.
   const int64_t max_chunks_in_flight_;
 
@@ -113,6 +145,13 @@ class PushManager {
 
   /// Tracks all pushes with chunk transfers in flight.
   absl::flat_hash_map<PushID, std::unique_ptr<PushState>> push_info_;
+
+  /// The virtual time of each queue, i.e. the weighted bytes it was served. The
+  /// queue with the lowest virtual time sends the next chunk.
+  absl::flat_hash_map<FlowID, double> virtual_times_;
+
+  /// The virtual time of the queue that sent the last chunk.
+  double virtual_clock_ = 0;
 };
 
 }  // namespace ray
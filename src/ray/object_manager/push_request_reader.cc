@@ -0,0 +1,158 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/push_request_reader.h"
+
+#include <string>
+
+namespace ray {
+
+namespace {
+/// Protobuf wire types, see
+/// https://developers.google.com/protocol-buffers/docs/encoding#structure.
+const uint64_t kWireTypeVarint = 0;
+const uint64_t kWireTypeFixed64 = 1;
+const uint64_t kWireTypeLengthDelimited = 2;
+const uint64_t kWireTypeFixed32 = 5;
+
+/// Reads bytes from a list of slices, handing out ranges of the slices instead of
+/// copies where possible.
+class SliceCursor {
+ public:
+  explicit SliceCursor(const std::vector<grpc::Slice> &slices) : slices_(slices) {}
+
+  bool AtEnd() {
+    SkipEmptySlices();
+    return slice_index_ == slices_.size();
+  }
+
+  /// Read the next n bytes as ranges of the slices.
+  bool ReadRanges(uint64_t n, std::vector<absl::Span<const uint8_t>> *ranges) {
+    while (n > 0) {
+      if (AtEnd()) {
+        return false;
+      }
+      const auto &slice = slices_[slice_index_];
+      const uint64_t length = std::min<uint64_t>(n, slice.size() - offset_);
+      ranges->emplace_back(slice.begin() + offset_, length);
+      offset_ += length;
+      n -= length;
+    }
+    return true;
+  }
+
+  /// Read the next n bytes and append them to the output.
+  bool Read(uint64_t n, std::string *output) {
+    std::vector<absl::Span<const uint8_t>> ranges;
+    if (!ReadRanges(n, &ranges)) {
+      return false;
+    }
+    for (const auto &range : ranges) {
+      output->append(reinterpret_cast<const char *>(range.data()), range.size());
+    }
+    return true;
+  }
+
+  /// Read a varint and append its encoding to the output.
+  bool ReadVarint(uint64_t *value, std::string *output) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (AtEnd()) {
+        return false;
+      }
+      const uint8_t byte = slices_[slice_index_].begin()[offset_++];
+      output->push_back(static_cast<char>(byte));
+      *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  void SkipEmptySlices() {
+    while (slice_index_ < slices_.size() && offset_ == slices_[slice_index_].size()) {
+      slice_index_++;
+      offset_ = 0;
+    }
+  }
+
+  const std::vector<grpc::Slice> &slices_;
+  size_t slice_index_ = 0;
+  size_t offset_ = 0;
+};
+}  // namespace
+
+bool PushRequestReader::Parse(const grpc::ByteBuffer &buffer) {
+  slices_.clear();
+  data_.clear();
+  if (!buffer.Dump(&slices_).ok()) {
+    return false;
+  }
+  // Copy all fields but the chunk data into a buffer that is then parsed as usual.
+  // Those fields are small compared to the chunk.
+  std::string header;
+  SliceCursor cursor(slices_);
+  while (!cursor.AtEnd()) {
+    uint64_t tag;
+    std::string tag_bytes;
+    if (!cursor.ReadVarint(&tag, &tag_bytes)) {
+      return false;
+    }
+    const uint64_t field_number = tag >> 3;
+    const uint64_t wire_type = tag & 0x7;
+    uint64_t value;
+    bool ok = false;
+    if (field_number == rpc::PushRequest::kDataFieldNumber &&
+        wire_type == kWireTypeLengthDelimited) {
+      std::string length_bytes;
+      // As for any protobuf field, the last occurrence wins.
+      data_.clear();
+      ok = cursor.ReadVarint(&value, &length_bytes) && cursor.ReadRanges(value, &data_);
+    } else {
+      header.append(tag_bytes);
+      switch (wire_type) {
+      case kWireTypeVarint:
+        ok = cursor.ReadVarint(&value, &header);
+        break;
+      case kWireTypeFixed64:
+        ok = cursor.Read(8, &header);
+        break;
+      case kWireTypeLengthDelimited:
+        ok = cursor.ReadVarint(&value, &header) && cursor.Read(value, &header);
+        break;
+      case kWireTypeFixed32:
+        ok = cursor.Read(4, &header);
+        break;
+      default:
+        break;
+      }
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  return request_.ParseFromString(header);
+}
+
+uint64_t PushRequestReader::GetDataSize() const {
+  uint64_t size = 0;
+  for (const auto &range : data_) {
+    size += range.size();
+  }
+  return size;
+}
+
+}  // namespace ray
@@ -0,0 +1,58 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <grpcpp/support/byte_buffer.h>
+
+#include <vector>
+
+#include "absl/types/span.h"
+#include "src/ray/protobuf/object_manager.pb.h"
+
+namespace ray {
+
+/// Parses a serialized PushRequest as received by gRPC, without copying the chunk
+/// data out of the gRPC buffer. This lets the chunk be written into the object
+/// store with a single copy.
+class PushRequestReader {
+ public:
+  /// Parse the request.
+  ///
+  /// \param buffer The serialized request.
+  /// \return Whether the request could be parsed.
+  bool Parse(const grpc::ByteBuffer &buffer);
+
+  /// The request with all fields set but `data`.
+  const rpc::PushRequest &GetRequest() const { return request_; }
+
+  /// The chunk data, as ranges of the gRPC buffer. The ranges are valid as long
+  /// as this reader is.
+  const std::vector<absl::Span<const uint8_t>> &GetData() const { return data_; }
+
+  /// The total size of the chunk data.
+  uint64_t GetDataSize() const;
+
+ private:
+  /// The slices of the gRPC buffer, which keep it alive.
+  std::vector<grpc::Slice> slices_;
+
+  /// The request without the chunk data.
+  rpc::PushRequest request_;
+
+  /// The chunk data.
+  std::vector<absl::Span<const uint8_t>> data_;
+};
+
+}  // namespace ray
@@ -0,0 +1,88 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/chunk_size_policy.h"
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+const uint64_t kMB = 1024 * 1024;
+
+/// Record chunks of different sizes over a link with the given delay and bandwidth.
+void RecordChunks(ChunkSizePolicy *policy, const NodeID &node_id, double rtt,
+                  double bytes_per_second) {
+  for (int i = 0; i < 20; i++) {
+    const uint64_t num_bytes = (1 + i % 5) * kMB;
+    policy->RecordChunkSent(node_id, num_bytes, rtt + num_bytes / bytes_per_second);
+  }
+}
+
+TEST(ChunkSizePolicyTest, TestDefaultWithoutMeasurements) {
+  ChunkSizePolicy policy(5 * kMB, 64 * kMB);
+  auto node_id = NodeID::FromRandom();
+  ASSERT_EQ(policy.GetBandwidthDelayProduct(node_id), 0);
+  ASSERT_EQ(policy.GetChunkSize(node_id, 100 * kMB), 5 * kMB);
+}
+
+TEST(ChunkSizePolicyTest, TestLargeBandwidthDelayProduct) {
+  ChunkSizePolicy policy(5 * kMB, 64 * kMB);
+  auto far_node = NodeID::FromRandom();
+  auto near_node = NodeID::FromRandom();
+  // 80MB in flight on a 50ms link at 1.6GB/s.
+  RecordChunks(&policy, far_node, 0.05, 1600.0 * kMB);
+  // 16KB in flight on a 0.1ms link.
+  RecordChunks(&policy, near_node, 0.0001, 160.0 * kMB);
+  ASSERT_NEAR(policy.GetBandwidthDelayProduct(far_node), 80 * kMB, kMB);
+  ASSERT_EQ(policy.GetChunkSize(far_node, 1000 * kMB), 20 * kMB);
+  ASSERT_EQ(policy.GetChunkSize(near_node, 1000 * kMB), 5 * kMB);
+
+  // The chunk size is capped.
+  auto very_far_node = NodeID::FromRandom();
+  RecordChunks(&policy, very_far_node, 1, 1600.0 * kMB);
+  ASSERT_EQ(policy.GetChunkSize(very_far_node, 1000 * kMB), 64 * kMB);
+}
+
+TEST(ChunkSizePolicyTest, TestSmallTail) {
+  ChunkSizePolicy policy(4 * kMB, 64 * kMB);
+  auto node_id = NodeID::FromRandom();
+  ASSERT_EQ(policy.GetChunkSize(node_id, 5 * kMB), 5 * kMB);
+  ASSERT_EQ(policy.GetChunkSize(node_id, 6 * kMB), 4 * kMB);
+}
+
+TEST(ChunkSizePolicyTest, TestBandwidth) {
+  ChunkSizePolicy policy(5 * kMB, 5 * kMB);
+  auto fast_node = NodeID::FromRandom();
+  auto slow_node = NodeID::FromRandom();
+  ASSERT_EQ(policy.GetBandwidth(fast_node), 0);
+  RecordChunks(&policy, fast_node, 0.0001, 1600.0 * kMB);
+  RecordChunks(&policy, slow_node, 0.02, 20.0 * kMB);
+  ASSERT_NEAR(policy.GetBandwidth(fast_node), 1600.0 * kMB, 16.0 * kMB);
+  ASSERT_NEAR(policy.GetBandwidth(slow_node), 20.0 * kMB, 0.2 * kMB);
+}
+
+TEST(ChunkSizePolicyTest, TestDisabled) {
+  ChunkSizePolicy policy(5 * kMB, 5 * kMB);
+  auto node_id = NodeID::FromRandom();
+  RecordChunks(&policy, node_id, 0.05, 1600.0 * kMB);
+  ASSERT_EQ(policy.GetChunkSize(node_id, 1000 * kMB), 5 * kMB);
+  ASSERT_EQ(policy.GetChunkSize(node_id, 6 * kMB), 5 * kMB);
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
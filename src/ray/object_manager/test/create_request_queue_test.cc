@@ -56,7 +56,7 @@ class CreateRequestQueueTest : public ::testing::Test {
             /*debug_dump_handler*/ nullptr) {}
 
   void AssertNoLeaks() {
-    ASSERT_TRUE(queue_.queue_.empty());
+    ASSERT_EQ(queue_.NumPendingRequests(), 0);
     ASSERT_TRUE(queue_.fulfilled_requests_.empty());
   }
 
@@ -104,6 +104,111 @@ TEST_F(CreateRequestQueueTest, TestSimple) {
   AssertNoLeaks();
 }
 
+TEST_F(CreateRequestQueueTest, TestBatch) {
+  std::vector<int> created;
+  std::vector<CreateRequestQueue::CreateObjectCallback> requests;
+  for (int i = 0; i < 3; i++) {
+    requests.push_back([&created, i](bool fallback, PlasmaObject *result,
+                                      bool *spill_requested) {
+      created.push_back(i);
+      result->data_size = 1234;
+      return PlasmaError::OK;
+    });
+  }
+  auto client = std::make_shared<MockClient>();
+  auto req_ids = queue_.AddBatchRequest(
+      {ObjectID::FromRandom(), ObjectID::FromRandom(), ObjectID::FromRandom()}, client,
+      requests, {1234, 1234, 1234});
+  ASSERT_EQ(req_ids.size(), 3);
+  ASSERT_EQ(queue_.NumPendingRequests(), 3);
+  ASSERT_EQ(queue_.NumPendingBytes(), 3 * 1234);
+  for (auto req_id : req_ids) {
+    ASSERT_REQUEST_UNFINISHED(queue_, req_id);
+  }
+
+  // The whole batch is processed at once, in order.
+  ASSERT_TRUE(queue_.ProcessRequests().ok());
+  ASSERT_EQ(created, std::vector<int>({0, 1, 2}));
+  for (auto req_id : req_ids) {
+    ASSERT_REQUEST_FINISHED(queue_, req_id, PlasmaError::OK);
+  }
+  ASSERT_EQ(queue_.NumPendingBytes(), 0);
+  AssertNoLeaks();
+}
+
+TEST_F(CreateRequestQueueTest, TestPriority) {
+  bool out_of_memory = true;
+  std::vector<std::string> created;
+  auto make_request = [&](const std::string &name) {
+    return [&, name](bool fallback, PlasmaObject *result, bool *spill_requested) {
+      if (out_of_memory && name == "put") {
+        return PlasmaError::OutOfMemory;
+      }
+      created.push_back(name);
+      result->data_size = 1234;
+      return PlasmaError::OK;
+    };
+  };
+
+  auto client = std::make_shared<MockClient>();
+  auto put_id = queue_.AddRequest(ObjectID::FromRandom(), client, make_request("put"),
+                                  1234, flatbuf::CreatePriority::UserPut);
+  auto restore_id =
+      queue_.AddRequest(ObjectID::FromRandom(), client, make_request("restore"), 1234,
+                        flatbuf::CreatePriority::Restore);
+  auto return_id =
+      queue_.AddRequest(ObjectID::FromRandom(), client, make_request("return"), 1234,
+                        flatbuf::CreatePriority::TaskReturn);
+
+  // The put is stuck waiting for memory, but doesn't block the others.
+  ASSERT_TRUE(queue_.ProcessRequests().IsObjectStoreFull());
+  ASSERT_EQ(created, std::vector<std::string>({"return", "restore"}));
+  ASSERT_REQUEST_FINISHED(queue_, return_id, PlasmaError::OK);
+  ASSERT_REQUEST_FINISHED(queue_, restore_id, PlasmaError::OK);
+  ASSERT_REQUEST_UNFINISHED(queue_, put_id);
+
+  out_of_memory = false;
+  ASSERT_TRUE(queue_.ProcessRequests().ok());
+  ASSERT_REQUEST_FINISHED(queue_, put_id, PlasmaError::OK);
+  AssertNoLeaks();
+}
+
+TEST_F(CreateRequestQueueTest, TestStarvation) {
+  std::vector<std::string> created;
+  // The put only fits into fallback memory, which the queue doesn't use before the
+  // OOM grace period is over.
+  auto put_request = [&](bool fallback, PlasmaObject *result, bool *spill_requested) {
+    if (!fallback) {
+      return PlasmaError::OutOfMemory;
+    }
+    created.push_back("put");
+    result->data_size = 1234;
+    return PlasmaError::OK;
+  };
+  auto return_request = [&](bool fallback, PlasmaObject *result,
+                            bool *spill_requested) {
+    created.push_back("return");
+    result->data_size = 1234;
+    return PlasmaError::OK;
+  };
+
+  auto client = std::make_shared<MockClient>();
+  auto put_id = queue_.AddRequest(ObjectID::FromRandom(), client, put_request, 1234,
+                                  flatbuf::CreatePriority::UserPut);
+  ASSERT_TRUE(queue_.ProcessRequests().IsObjectStoreFull());
+
+  // Once the put has waited for longer than the starvation timeout, it goes
+  // ahead of newer task returns.
+  current_time_ns_ += 11e9;
+  auto return_id = queue_.AddRequest(ObjectID::FromRandom(), client, return_request,
+                                     1234, flatbuf::CreatePriority::TaskReturn);
+  ASSERT_TRUE(queue_.ProcessRequests().ok());
+  ASSERT_EQ(created, std::vector<std::string>({"put", "return"}));
+  ASSERT_REQUEST_FINISHED(queue_, put_id, PlasmaError::OK);
+  ASSERT_REQUEST_FINISHED(queue_, return_id, PlasmaError::OK);
+  AssertNoLeaks();
+}
+
 TEST_F(CreateRequestQueueTest, TestOom) {
   auto oom_request = [&](bool fallback, PlasmaObject *result, bool *spill_requested) {
     return PlasmaError::OutOfMemory;
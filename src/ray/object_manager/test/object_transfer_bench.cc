@@ -0,0 +1,322 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A benchmark of the object transfer path between object managers. A sender pushes
+// objects to receivers over loopback gRPC, through the same PushManager, chunk readers
+// and ObjectManagerClient as the object manager. Objects are read from memory or from a
+// spilled object file. For each number of receivers, it reports the throughput and the
+// chunk latency percentiles, which shows how broadcasts scale.
+//
+// The receivers can emulate a slower network: each one replies to a chunk only once
+// the chunk would have crossed a link of the given bandwidth and latency. This holds
+// the chunk in flight on the sender, as a real link would.
+//
+// The receivers discard the chunks instead of writing them to an object store, since a
+// process has a single plasma store. Use --ray_config to compare settings such as
+// object_manager_zero_copy_push.
+//
+// Example:
+//   object_transfer_bench --receivers=1,2,4,8 --object_size=67108864 \
+//       --source=spilled --link_bandwidth_mbps=10000 --link_latency_us=100
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/strings/str_split.h"
+#include "absl/time/clock.h"
+#include "gflags/gflags.h"
+#include "ray/common/asio/instrumented_io_context.h"
+#include "ray/common/buffer.h"
+#include "ray/common/id.h"
+#include "ray/common/ray_config.h"
+#include "ray/object_manager/chunk_object_reader.h"
+#include "ray/object_manager/memory_object_reader.h"
+#include "ray/object_manager/push_manager.h"
+#include "ray/object_manager/spilled_object_reader.h"
+#include "ray/rpc/object_manager/object_manager_client.h"
+#include "ray/rpc/object_manager/object_manager_server.h"
+#include "ray/util/logging.h"
+#include "ray/util/util.h"
+
+DEFINE_string(receivers, "1,2,4,8",
+              "The numbers of receivers to broadcast to, one run for each.");
+DEFINE_int32(num_objects, 16, "The number of objects pushed to every receiver.");
+DEFINE_int64(object_size, 64 * 1024 * 1024, "The size of each object in bytes.");
+DEFINE_int64(chunk_size, 0, "The chunk size. 0 uses object_manager_default_chunk_size.");
+DEFINE_string(source, "memory",
+              "Where objects are read from: memory, or spilled to a file.");
+DEFINE_string(spill_directory, "/tmp", "The directory of the spilled object file.");
+DEFINE_int64(link_bandwidth_mbps, 0,
+             "The emulated bandwidth into each receiver in Mbit/s. 0 is unlimited.");
+DEFINE_int64(link_latency_us, 0, "The emulated latency of each chunk in microseconds.");
+DEFINE_string(ray_config, "{}", "A JSON object of Ray config overrides.");
+
+namespace ray {
+
+namespace {
+
+/// Receives pushed chunks over gRPC and discards them.
+class Receiver : public rpc::ObjectManagerServiceHandler {
+ public:
+  explicit Receiver(int index)
+      : io_service_("object_transfer_bench_receiver"),
+        work_(io_service_),
+        server_("ObjectTransferBenchReceiver" + std::to_string(index), 0),
+        service_(io_service_, *this) {
+    server_.RegisterService(service_);
+    server_.Run();
+    thread_ = std::thread([this] { io_service_.run(); });
+  }
+
+  ~Receiver() {
+    server_.Shutdown();
+    io_service_.stop();
+    thread_.join();
+  }
+
+  int GetPort() const { return server_.GetPort(); }
+
+  void HandlePush(const rpc::PushRequest &request, rpc::PushReply *reply,
+                  rpc::SendReplyCallback send_reply_callback) override {
+    if (FLAGS_link_bandwidth_mbps <= 0 && FLAGS_link_latency_us <= 0) {
+      send_reply_callback(Status::OK(), nullptr, nullptr);
+      return;
+    }
+    // Chunks cross the link one at a time, each after the previous one.
+    const int64_t now_ns = absl::GetCurrentTimeNanos();
+    const int64_t transmit_ns =
+        FLAGS_link_bandwidth_mbps > 0
+            ? static_cast<int64_t>(request.data().size()) * 8000 /
+                  FLAGS_link_bandwidth_mbps
+            : 0;
+    link_free_ns_ = std::max(link_free_ns_, now_ns) + transmit_ns;
+    const int64_t reply_in_us =
+        (link_free_ns_ - now_ns) / 1000 + FLAGS_link_latency_us;
+    auto timer = std::make_shared<boost::asio::deadline_timer>(
+        io_service_, boost::posix_time::microseconds(reply_in_us));
+    timer->async_wait([timer, send_reply_callback](const boost::system::error_code &) {
+      send_reply_callback(Status::OK(), nullptr, nullptr);
+    });
+  }
+
+  void HandlePull(const rpc::PullRequest &request, rpc::PullReply *reply,
+                  rpc::SendReplyCallback send_reply_callback) override {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+
+  void HandleFreeObjects(const rpc::FreeObjectsRequest &request,
+                         rpc::FreeObjectsReply *reply,
+                         rpc::SendReplyCallback send_reply_callback) override {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+
+ private:
+  instrumented_io_context io_service_;
+  boost::asio::io_service::work work_;
+  rpc::GrpcServer server_;
+  rpc::ObjectManagerGrpcService service_;
+  std::thread thread_;
+  /// When the emulated link finishes sending the chunks received so far.
+  int64_t link_free_ns_ = 0;
+};
+
+/// The result of one broadcast run.
+struct RunResult {
+  int64_t bytes = 0;
+  absl::Duration elapsed;
+  std::vector<int64_t> chunk_latencies_us;
+  int64_t num_failed_chunks = 0;
+};
+
+/// Create the reader of an object of `object_size` bytes, in memory or spilled to a
+/// file in the format written by the external storage.
+std::shared_ptr<IObjectReader> CreateObjectReader(int64_t object_size) {
+  auto data = std::make_shared<LocalMemoryBuffer>(object_size);
+  std::fill(data->Data(), data->Data() + object_size, 1);
+  if (FLAGS_source == "memory") {
+    return std::make_shared<MemoryObjectReader>(
+        data, std::make_shared<LocalMemoryBuffer>(nullptr, 0), rpc::Address());
+  }
+  RAY_CHECK(FLAGS_source == "spilled") << "Unknown source " << FLAGS_source;
+
+  // The header is the sizes of the owner address, the metadata and the data, as
+  // little endian integers, followed by the owner address. Like Ray, this assumes a
+  // little endian host.
+  std::string address;
+  rpc::Address().SerializeToString(&address);
+  const uint64_t header[] = {address.size(), 0, static_cast<uint64_t>(object_size)};
+  const std::string path = FLAGS_spill_directory + "/object_transfer_bench_" +
+                           std::to_string(getpid());
+  {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    file << address;
+    file.write(reinterpret_cast<const char *>(data->Data()), object_size);
+    RAY_CHECK(file.good()) << "Failed to write " << path;
+  }
+  const uint64_t total_size = sizeof(header) + address.size() + object_size;
+  auto reader = SpilledObjectReader::CreateSpilledObjectReader(
+      path + "?offset=0&size=" + std::to_string(total_size));
+  RAY_CHECK(reader.has_value()) << "Failed to read " << path;
+  return std::make_shared<SpilledObjectReader>(std::move(*reader));
+}
+
+/// Push every object to every receiver, as the object manager does, and wait until all
+/// the chunks are acknowledged.
+RunResult Broadcast(instrumented_io_context &io_service,
+                    rpc::ClientCallManager &client_call_manager,
+                    const std::vector<std::unique_ptr<Receiver>> &receivers,
+                    const std::shared_ptr<ChunkObjectReader> &chunk_reader) {
+  const uint64_t chunk_size = chunk_reader->GetChunkSize();
+  const uint64_t object_size = chunk_reader->GetObject().GetObjectSize();
+  const int64_t num_chunks = chunk_reader->GetNumChunks();
+  PushManager push_manager(std::max<int64_t>(
+      1, RayConfig::instance().object_manager_max_bytes_in_flight() / chunk_size));
+  std::vector<std::pair<NodeID, std::shared_ptr<rpc::ObjectManagerClient>>> clients;
+  for (const auto &receiver : receivers) {
+    clients.emplace_back(
+        NodeID::FromRandom(),
+        std::make_shared<rpc::ObjectManagerClient>(
+            "127.0.0.1", receiver->GetPort(), client_call_manager,
+            RayConfig::instance().object_manager_push_connections(),
+            RayConfig::instance().object_manager_separate_connections()));
+  }
+
+  auto result = std::make_shared<RunResult>();
+  auto remaining_chunks = std::make_shared<int64_t>(
+      num_chunks * FLAGS_num_objects * static_cast<int64_t>(receivers.size()));
+  std::promise<void> done;
+  const auto start = absl::Now();
+  io_service.post(
+      [&] {
+        for (int i = 0; i < FLAGS_num_objects; i++) {
+          const auto object_id = ObjectID::FromRandom();
+          for (const auto &client : clients) {
+            const auto node_id = client.first;
+            const auto rpc_client = client.second;
+            auto send_chunk = [&, object_id, node_id, rpc_client](int64_t chunk_index) {
+              rpc::PushRequest request;
+              request.set_push_id(UniqueID::FromRandom().Binary());
+              request.set_object_id(object_id.Binary());
+              request.set_data_size(object_size);
+              request.set_chunk_index(chunk_index);
+              request.set_chunk_size(chunk_size);
+              const auto send_time = absl::GetCurrentTimeNanos();
+              auto callback = [&, object_id, node_id, send_time](
+                                  const Status &status, const rpc::PushReply &reply) {
+                result->chunk_latencies_us.push_back(
+                    (absl::GetCurrentTimeNanos() - send_time) / 1000);
+                if (!status.ok()) {
+                  result->num_failed_chunks++;
+                }
+                push_manager.OnChunkComplete(node_id, object_id);
+                if (--*remaining_chunks == 0) {
+                  done.set_value();
+                }
+              };
+              std::vector<absl::Span<const uint8_t>> ranges;
+              if (RayConfig::instance().object_manager_zero_copy_push() &&
+                  chunk_reader->GetChunkRanges(chunk_index, &ranges)) {
+                std::vector<grpc::Slice> slices;
+                for (const auto &range : ranges) {
+                  slices.emplace_back(const_cast<uint8_t *>(range.data()),
+                                      range.size(), grpc::Slice::STATIC_SLICE);
+                  result->bytes += range.size();
+                }
+                rpc_client->Push(request, slices, callback);
+                return;
+              }
+              auto chunk = chunk_reader->GetChunk(chunk_index);
+              RAY_CHECK(chunk.has_value());
+              result->bytes += chunk->size();
+              request.set_data(std::move(*chunk));
+              rpc_client->Push(request, callback);
+            };
+            push_manager.StartPush(node_id, object_id, num_chunks, send_chunk,
+                                   /*priority=*/0, object_size);
+          }
+        }
+      },
+      "ObjectTransferBench.Broadcast");
+  done.get_future().wait();
+  result->elapsed = absl::Now() - start;
+  return std::move(*result);
+}
+
+int64_t Percentile(const std::vector<int64_t> &sorted, double percentile) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  return sorted[std::min(sorted.size() - 1,
+                         static_cast<size_t>(sorted.size() * percentile / 100))];
+}
+
+}  // namespace
+
+}  // namespace ray
+
+int main(int argc, char *argv[]) {
+  InitShutdownRAII ray_log_shutdown_raii(ray::RayLog::StartRayLog,
+                                         ray::RayLog::ShutDownRayLog, argv[0],
+                                         ray::RayLogLevel::WARNING,
+                                         /*log_dir=*/"");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  RayConfig::instance().initialize(FLAGS_ray_config);
+  const uint64_t chunk_size =
+      FLAGS_chunk_size > 0 ? FLAGS_chunk_size
+                           : RayConfig::instance().object_manager_default_chunk_size();
+  auto chunk_reader = std::make_shared<ray::ChunkObjectReader>(
+      ray::CreateObjectReader(FLAGS_object_size), chunk_size);
+
+  instrumented_io_context io_service("object_transfer_bench_sender");
+  boost::asio::io_service::work work(io_service);
+  std::thread io_thread([&io_service] { io_service.run(); });
+  {
+    ray::rpc::ClientCallManager client_call_manager(io_service);
+    std::cout << "Object size: " << FLAGS_object_size << " bytes, chunk size: "
+              << chunk_size << " bytes, objects: " << FLAGS_num_objects
+              << ", source: " << FLAGS_source << "\n";
+    for (const auto &num_receivers_str : absl::StrSplit(FLAGS_receivers, ',')) {
+      const int num_receivers = std::stoi(std::string(num_receivers_str));
+      std::vector<std::unique_ptr<ray::Receiver>> receivers;
+      for (int i = 0; i < num_receivers; i++) {
+        receivers.emplace_back(new ray::Receiver(i));
+      }
+      auto result =
+          ray::Broadcast(io_service, client_call_manager, receivers, chunk_reader);
+      std::sort(result.chunk_latencies_us.begin(), result.chunk_latencies_us.end());
+      const double seconds = absl::ToDoubleSeconds(result.elapsed);
+      std::cout << "Receivers: " << num_receivers << ", throughput: "
+                << static_cast<int64_t>(result.bytes / seconds / 1e6)
+                << " MB/s, per receiver: "
+                << static_cast<int64_t>(result.bytes / seconds / 1e6 / num_receivers)
+                << " MB/s, chunk latency (us): p50 = "
+                << ray::Percentile(result.chunk_latencies_us, 50)
+                << ", p99 = " << ray::Percentile(result.chunk_latencies_us, 99)
+                << ", failed chunks: " << result.num_failed_chunks << "\n";
+    }
+  }
+  io_service.stop();
+  io_thread.join();
+  gflags::ShutDownCommandLineFlags();
+  return 0;
+}
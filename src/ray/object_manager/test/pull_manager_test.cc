@@ -46,7 +46,9 @@ class PullManagerTestWithCapacity {
             [this](const ObjectID &object_id) { return PinReturn(); },
             [this](const ObjectID &object_id) {
               return GetLocalSpilledObjectURL(object_id);
-            }) {}
+            },
+            [this](const ObjectID &object_id, const std::vector<NodeID> &node_ids,
+                   size_t object_size) { striped_pull_requests_.push_back(node_ids); }) {}
 
   void AssertNoLeaks() {
     ASSERT_TRUE(pull_manager_.get_request_bundles_.empty());
@@ -61,8 +63,12 @@ class PullManagerTestWithCapacity {
     ASSERT_TRUE(pull_manager_.active_object_pull_requests_.empty());
     ASSERT_TRUE(pull_manager_.pinned_objects_.empty());
     ASSERT_EQ(pull_manager_.pinned_objects_size_, 0);
+    ASSERT_TRUE(pull_manager_.restore_ahead_objects_.empty());
+    ASSERT_EQ(pull_manager_.restore_ahead_bytes_, 0);
   }
 
+  int64_t RestoreAheadBytes() { return pull_manager_.restore_ahead_bytes_; }
+
   int NumPinnedObjects() { return pull_manager_.pinned_objects_.size(); }
 
   std::unique_ptr<RayObject> PinReturn() {
@@ -81,6 +87,7 @@ class PullManagerTestWithCapacity {
   bool object_is_local_;
   bool allow_pin_ = false;
   int num_send_pull_request_calls_;
+  std::vector<std::vector<NodeID>> striped_pull_requests_;
   int num_restore_spilled_object_calls_;
   std::function<void(const ray::Status &)> restore_object_callback_;
   double fake_time_;
@@ -173,6 +180,52 @@ TEST_P(PullManagerTest, TestStaleSubscription) {
   AssertNoLeaks();
 }
 
+TEST_P(PullManagerTest, TestStripedPull) {
+  RayConfig::instance().initialize(
+      R"({"object_manager_striped_pull_min_size": 1, )"
+      R"("object_manager_max_pull_stripes": 2})");
+  auto prio = BundlePriority::TASK_ARGS;
+  if (GetParam()) {
+    prio = BundlePriority::GET_REQUEST;
+  }
+  auto refs = CreateObjectRefs(1);
+  auto oid = ObjectRefsToIds(refs)[0];
+  std::vector<rpc::ObjectReference> objects_to_locate;
+  auto req_id = pull_manager_.Pull(refs, prio, &objects_to_locate);
+
+  // The object is pulled from up to two of the nodes that have it.
+  std::unordered_set<NodeID> client_ids = {NodeID::FromRandom(), NodeID::FromRandom(),
+                                           NodeID::FromRandom(), self_node_id_};
+  pull_manager_.OnLocationChange(oid, client_ids, "", NodeID::Nil(), 1);
+  ASSERT_EQ(num_send_pull_request_calls_, 0);
+  ASSERT_EQ(striped_pull_requests_.size(), 1);
+  const auto &node_ids = striped_pull_requests_[0];
+  ASSERT_EQ(node_ids.size(), 2);
+  ASSERT_NE(node_ids[0], node_ids[1]);
+  for (const auto &node_id : node_ids) {
+    ASSERT_TRUE(client_ids.count(node_id));
+    ASSERT_NE(node_id, self_node_id_);
+  }
+
+  // The missing chunks are striped again on a retry.
+  fake_time_ += 10;
+  pull_manager_.Tick();
+  ASSERT_EQ(striped_pull_requests_.size(), 2);
+
+  // With only one remote location, the object is pulled as usual.
+  fake_time_ += 20;
+  pull_manager_.OnLocationChange(oid, {NodeID::FromRandom(), self_node_id_}, "",
+                                 NodeID::Nil(), 1);
+  ASSERT_EQ(striped_pull_requests_.size(), 2);
+  ASSERT_EQ(num_send_pull_request_calls_, 1);
+
+  pull_manager_.CancelPull(req_id);
+  AssertNoLeaks();
+  RayConfig::instance().initialize(
+      R"({"object_manager_striped_pull_min_size": 67108864, )"
+      R"("object_manager_max_pull_stripes": 4})");
+}
+
 TEST_P(PullManagerTest, TestRestoreSpilledObjectRemote) {
   auto prio = BundlePriority::TASK_ARGS;
   if (GetParam()) {
@@ -649,6 +702,39 @@ TEST_P(PullManagerTest, TestDuplicateObjectsAreActivatedAndCleanedUp) {
   AssertNoLeaks();
 }
 
+TEST_P(PullManagerTest, TestGetObjectBytesByNode) {
+  auto prio = BundlePriority::TASK_ARGS;
+  if (GetParam()) {
+    prio = BundlePriority::GET_REQUEST;
+  }
+  auto refs = CreateObjectRefs(3);
+  auto oids = ObjectRefsToIds(refs);
+  std::vector<rpc::ObjectReference> objects_to_locate;
+  auto req_id = pull_manager_.Pull(refs, prio, &objects_to_locate);
+
+  NodeID node1 = NodeID::FromRandom();
+  NodeID node2 = NodeID::FromRandom();
+  NodeID spilled_node = NodeID::FromRandom();
+  pull_manager_.OnLocationChange(oids[0], {node1, node2}, "", NodeID::Nil(), 10);
+  pull_manager_.OnLocationChange(oids[1], {node1}, "remote_url/foo/bar", spilled_node,
+                                 20);
+  // The size of the last object is not known yet.
+
+  absl::flat_hash_map<NodeID, int64_t> bytes_by_node;
+  ASSERT_EQ(pull_manager_.GetObjectBytesByNode(oids, &bytes_by_node), 30);
+  ASSERT_EQ(bytes_by_node.size(), 3);
+  ASSERT_EQ(bytes_by_node[node1], 30);
+  ASSERT_EQ(bytes_by_node[node2], 10);
+  ASSERT_EQ(bytes_by_node[spilled_node], 20);
+
+  // Objects that are no longer pulled are skipped.
+  pull_manager_.CancelPull(req_id);
+  bytes_by_node.clear();
+  ASSERT_EQ(pull_manager_.GetObjectBytesByNode(oids, &bytes_by_node), 0);
+  ASSERT_TRUE(bytes_by_node.empty());
+  AssertNoLeaks();
+}
+
 TEST_P(PullManagerWithAdmissionControlTest, TestBasic) {
   auto prio = BundlePriority::TASK_ARGS;
   if (GetParam()) {
@@ -973,6 +1059,100 @@ TEST_F(PullManagerWithAdmissionControlTest, TestPrioritizeWorkerRequests) {
   AssertNoLeaks();
 }
 
+TEST_F(PullManagerWithAdmissionControlTest, TestAdmissionHeadroom) {
+  /// Test that bundles are activated with headroom but only deactivated once over
+  /// quota, so that they don't flap when the available memory changes a little.
+  RayConfig::instance().initialize(
+      R"({"pull_manager_admission_headroom_fraction": 0.25})");
+  int object_size = 4;
+  std::vector<ObjectID> oids;
+  std::vector<int64_t> req_ids;
+  std::unordered_set<NodeID> client_ids;
+  client_ids.insert(NodeID::FromRandom());
+  for (int i = 0; i < 3; i++) {
+    std::vector<rpc::ObjectReference> objects_to_locate;
+    auto refs = CreateObjectRefs(1);
+    req_ids.push_back(
+        pull_manager_.Pull(refs, BundlePriority::TASK_ARGS, &objects_to_locate));
+    oids.push_back(ObjectRefsToIds(refs)[0]);
+  }
+  for (auto &oid : oids) {
+    pull_manager_.OnLocationChange(oid, client_ids, "", NodeID::Nil(), object_size);
+  }
+
+  // The third bundle would fit, but not with a headroom of 3 bytes.
+  pull_manager_.UpdatePullsBasedOnAvailableMemory(12);
+  AssertNumActiveBundlesEquals(2);
+  ASSERT_FALSE(pull_manager_.IsObjectActive(oids[2]));
+
+  // Less memory within the headroom doesn't deactivate anything.
+  pull_manager_.UpdatePullsBasedOnAvailableMemory(8);
+  AssertNumActiveBundlesEquals(2);
+
+  // Bundles are deactivated once over quota, and only reactivated with headroom.
+  pull_manager_.UpdatePullsBasedOnAvailableMemory(7);
+  AssertNumActiveBundlesEquals(1);
+  pull_manager_.UpdatePullsBasedOnAvailableMemory(9);
+  AssertNumActiveBundlesEquals(1);
+  pull_manager_.UpdatePullsBasedOnAvailableMemory(11);
+  AssertNumActiveBundlesEquals(2);
+  ASSERT_TRUE(pull_manager_.IsObjectActive(oids[1]));
+
+  for (auto req_id : req_ids) {
+    pull_manager_.CancelPull(req_id);
+  }
+  AssertNoLeaks();
+  RayConfig::instance().initialize(
+      R"({"pull_manager_admission_headroom_fraction": 0.05})");
+}
+
+TEST_F(PullManagerWithAdmissionControlTest, TestRestoreAhead) {
+  /// Test that the spilled arguments of the next inactive task bundles are restored
+  /// ahead of time, within their own memory budget.
+  RayConfig::instance().initialize(
+      R"({"pull_manager_restore_ahead_bundles": 2,
+          "pull_manager_restore_ahead_fraction": 0.5})");
+  int object_size = 4;
+  std::vector<ObjectID> oids;
+  std::vector<int64_t> req_ids;
+  for (int i = 0; i < 4; i++) {
+    std::vector<rpc::ObjectReference> objects_to_locate;
+    auto refs = CreateObjectRefs(1);
+    req_ids.push_back(
+        pull_manager_.Pull(refs, BundlePriority::TASK_ARGS, &objects_to_locate));
+    oids.push_back(ObjectRefsToIds(refs)[0]);
+  }
+  std::unordered_set<NodeID> client_ids;
+  client_ids.insert(NodeID::FromRandom());
+  pull_manager_.OnLocationChange(oids[0], client_ids, "", NodeID::Nil(), object_size);
+  pull_manager_.OnLocationChange(oids[1], client_ids, "", NodeID::Nil(), object_size);
+  // The last two objects are spilled on this node.
+  for (int i = 2; i < 4; i++) {
+    ObjectSpilled(oids[i], "url" + std::to_string(i));
+    pull_manager_.OnLocationChange(oids[i], {}, "url" + std::to_string(i),
+                                   self_node_id_, object_size);
+  }
+  AssertNumActiveBundlesEquals(2);
+
+  // Only the third object fits in the restore ahead budget of 5 bytes.
+  ASSERT_EQ(num_restore_spilled_object_calls_, 1);
+  ASSERT_EQ(RestoreAheadBytes(), object_size);
+  pull_manager_.UpdatePullsBasedOnAvailableMemory(10);
+  ASSERT_EQ(num_restore_spilled_object_calls_, 1);
+
+  // Once the third bundle is active, its object is no longer restored ahead, so the
+  // fourth one is.
+  pull_manager_.CancelPull(req_ids[0]);
+  ASSERT_TRUE(pull_manager_.IsObjectActive(oids[2]));
+  ASSERT_EQ(RestoreAheadBytes(), object_size);
+
+  for (size_t i = 1; i < req_ids.size(); i++) {
+    pull_manager_.CancelPull(req_ids[i]);
+  }
+  AssertNoLeaks();
+  RayConfig::instance().initialize(R"({"pull_manager_restore_ahead_bundles": 0})");
+}
+
 INSTANTIATE_TEST_CASE_P(WorkerOrTaskRequests, PullManagerTest,
                         testing::Values(true, false));
 
@@ -120,6 +120,80 @@ TEST(TestPushManager, TestMultipleTransfers) {
   }
 }
 
+TEST(TestPushManager, TestGetPushDestinations) {
+  auto node1 = NodeID::FromRandom();
+  auto node2 = NodeID::FromRandom();
+  auto obj1 = ObjectID::FromRandom();
+  auto obj2 = ObjectID::FromRandom();
+  PushManager pm(5);
+  pm.StartPush(node1, obj1, 1, [](int64_t) {});
+  pm.StartPush(node2, obj1, 1, [](int64_t) {});
+  pm.StartPush(node1, obj2, 1, [](int64_t) {});
+  auto dest_ids = pm.GetPushDestinations(obj1);
+  ASSERT_EQ(dest_ids.size(), 2);
+  ASSERT_NE(std::find(dest_ids.begin(), dest_ids.end(), node1), dest_ids.end());
+  ASSERT_NE(std::find(dest_ids.begin(), dest_ids.end(), node2), dest_ids.end());
+
+  // Completed pushes are not counted.
+  pm.OnChunkComplete(node2, obj1);
+  ASSERT_EQ(pm.GetPushDestinations(obj1), std::vector<NodeID>{node1});
+  ASSERT_TRUE(pm.GetPushDestinations(ObjectID::FromRandom()).empty());
+}
+
+TEST(TestPushManager, TestHigherPriorityGetsMoreBandwidth) {
+  auto node1 = NodeID::FromRandom();
+  auto node2 = NodeID::FromRandom();
+  auto obj1 = ObjectID::FromRandom();
+  auto obj2 = ObjectID::FromRandom();
+  std::vector<ObjectID> sent;
+  PushManager pm(1);
+  // A large, low priority push is started first.
+  pm.StartPush(
+      node1, obj1, 100, [&](int64_t) { sent.push_back(obj1); }, /*priority=*/2,
+      /*num_bytes=*/100);
+  pm.StartPush(
+      node2, obj2, 10, [&](int64_t) { sent.push_back(obj2); }, /*priority=*/0,
+      /*num_bytes=*/10);
+  ASSERT_EQ(sent.size(), 1);
+  pm.OnChunkComplete(node1, obj1);
+  for (int i = 0; i < 9; i++) {
+    pm.OnChunkComplete(node2, obj2);
+  }
+  // The small push is done before the large one sends another chunk.
+  ASSERT_EQ(sent.size(), 11);
+  for (size_t i = 1; i < sent.size(); i++) {
+    ASSERT_EQ(sent[i], obj2);
+  }
+  pm.OnChunkComplete(node2, obj2);
+  ASSERT_EQ(sent.back(), obj1);
+  ASSERT_EQ(pm.NumPushesInFlight(), 1);
+}
+
+TEST(TestPushManager, TestFairShareAcrossDestinations) {
+  auto node1 = NodeID::FromRandom();
+  auto node2 = NodeID::FromRandom();
+  auto obj1 = ObjectID::FromRandom();
+  auto obj2 = ObjectID::FromRandom();
+  auto obj3 = ObjectID::FromRandom();
+  absl::flat_hash_map<NodeID, int> chunks_per_node;
+  std::vector<std::pair<NodeID, ObjectID>> in_flight;
+  PushManager pm(1);
+  for (const auto &push : std::vector<std::pair<NodeID, ObjectID>>{
+           {node1, obj1}, {node1, obj2}, {node2, obj3}}) {
+    pm.StartPush(push.first, push.second, 10, [&, push](int64_t) {
+      chunks_per_node[push.first]++;
+      in_flight.push_back(push);
+    });
+  }
+  for (int i = 0; i < 9; i++) {
+    auto push = in_flight.back();
+    pm.OnChunkComplete(push.first, push.second);
+  }
+  // Both destinations get the same share, although node1 has two pushes.
+  ASSERT_EQ(chunks_per_node[node1], 5);
+  ASSERT_EQ(chunks_per_node[node2], 5);
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
@@ -0,0 +1,89 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/push_request_reader.h"
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+namespace {
+rpc::PushRequest MakeRequest(const std::string &data) {
+  rpc::PushRequest request;
+  request.set_push_id("push_id");
+  request.set_object_id("object_id");
+  request.set_node_id("node_id");
+  request.mutable_owner_address()->set_ip_address("127.0.0.1");
+  request.mutable_owner_address()->set_port(1234);
+  request.set_chunk_index(3);
+  request.set_data_size(1 << 20);
+  request.set_metadata_size(7);
+  request.set_data(data);
+  return request;
+}
+
+/// Split the serialized request into slices of the given size, like gRPC may.
+grpc::ByteBuffer Serialize(const rpc::PushRequest &request, size_t slice_size) {
+  const auto serialized = request.SerializeAsString();
+  std::vector<grpc::Slice> slices;
+  for (size_t offset = 0; offset < serialized.size(); offset += slice_size) {
+    slices.emplace_back(serialized.substr(offset, slice_size));
+  }
+  return grpc::ByteBuffer(slices.data(), slices.size());
+}
+
+std::string Concatenate(const std::vector<absl::Span<const uint8_t>> &ranges) {
+  std::string result;
+  for (const auto &range : ranges) {
+    result.append(reinterpret_cast<const char *>(range.data()), range.size());
+  }
+  return result;
+}
+}  // namespace
+
+TEST(PushRequestReaderTest, ParseRequest) {
+  const std::string data(1000, 'x');
+  const auto request = MakeRequest(data);
+  for (size_t slice_size : {1, 7, 100, 10000}) {
+    PushRequestReader reader;
+    ASSERT_TRUE(reader.Parse(Serialize(request, slice_size)));
+    EXPECT_EQ(reader.GetDataSize(), data.size());
+    EXPECT_EQ(Concatenate(reader.GetData()), data);
+    // All other fields are parsed, and the data is not copied into the request.
+    auto expected = request;
+    expected.clear_data();
+    EXPECT_EQ(reader.GetRequest().SerializeAsString(), expected.SerializeAsString());
+  }
+}
+
+TEST(PushRequestReaderTest, ParseEmptyData) {
+  PushRequestReader reader;
+  ASSERT_TRUE(reader.Parse(Serialize(MakeRequest(""), 5)));
+  EXPECT_EQ(reader.GetDataSize(), 0);
+  EXPECT_EQ(reader.GetRequest().chunk_index(), 3);
+}
+
+TEST(PushRequestReaderTest, ParseTruncatedRequest) {
+  const auto serialized = MakeRequest(std::string(100, 'x')).SerializeAsString();
+  grpc::Slice slice(serialized.substr(0, serialized.size() - 1));
+  PushRequestReader reader;
+  ASSERT_FALSE(reader.Parse(grpc::ByteBuffer(&slice, 1)));
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -384,6 +384,45 @@ TYPED_TEST(ObjectReaderTest, GetChunk) {
   }
 }
 
+TEST(ChunkObjectReaderTest, GetChunkRanges) {
+  std::string data = "alotofdata";
+  std::string metadata = "meta";
+  rpc::Address owner_address;
+  owner_address.set_raylet_id("nonsense");
+  for (uint64_t chunk_size : {1, 3, 5, 100}) {
+    ChunkObjectReader reader(
+        std::make_shared<MemoryObjectReader>(
+            CreateMemoryObjectReader(data, metadata, owner_address)),
+        chunk_size);
+    std::string actual_output_by_chunks;
+    for (uint64_t i = 0; i < reader.GetNumChunks(); i++) {
+      std::vector<absl::Span<const uint8_t>> ranges;
+      ASSERT_TRUE(reader.GetChunkRanges(i, &ranges));
+      std::string chunk;
+      if (i == 0) {
+        // The chunk points into the object instead of a copy.
+        ASSERT_EQ(reinterpret_cast<const uint8_t *>(data.data()), ranges[0].data());
+      }
+      for (const auto &range : ranges) {
+        chunk.append(reinterpret_cast<const char *>(range.data()), range.size());
+      }
+      ASSERT_EQ(reader.GetChunk(i).value(), chunk);
+      actual_output_by_chunks.append(chunk);
+    }
+    ASSERT_EQ(data + metadata, actual_output_by_chunks);
+  }
+
+  // Spilled objects have to be read.
+  auto object_url =
+      CreateSpilledObjectReaderOnTmp(0 /* object_offset */, data, metadata, owner_address);
+  ChunkObjectReader spilled_reader(
+      std::make_shared<SpilledObjectReader>(
+          SpilledObjectReader::CreateSpilledObjectReader(object_url).value()),
+      5);
+  std::vector<absl::Span<const uint8_t>> ranges;
+  ASSERT_FALSE(spilled_reader.GetChunkRanges(0, &ranges));
+}
+
 TEST(StringAllocationTest, TestNoCopyWhenStringMoved) {
   // Since protobuf always allocate string on heap,
   // move assign a string field doesn't copy the data.
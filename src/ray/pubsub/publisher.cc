@@ -20,10 +20,26 @@ namespace pubsub {
 
 namespace pub_internal {
 
+namespace {
+
+template <typename KeyIdType>
+KeyIdType ParseKeyId(const std::string &key_id_binary) {
+  return KeyIdType::FromBinary(key_id_binary);
+}
+
+/// String keys are used as they are, so that a channel can mix keys of different
+/// kinds, like the filter keys of the GCS channels.
+template <>
+std::string ParseKeyId<std::string>(const std::string &key_id_binary) {
+  return key_id_binary;
+}
+
+}  // namespace
+
 template <typename KeyIdType>
 bool SubscriptionIndex<KeyIdType>::AddEntry(const std::string &key_id_binary,
                                             const SubscriberID &subscriber_id) {
-  const auto key_id = KeyIdType::FromBinary(key_id_binary);
+  const auto key_id = ParseKeyId<KeyIdType>(key_id_binary);
   auto &subscribing_key_ids = subscribers_to_key_id_[subscriber_id];
   auto key_added = subscribing_key_ids.emplace(key_id).second;
   auto &subscriber_map = key_id_to_subscribers_[key_id];
@@ -37,7 +53,7 @@ template <typename KeyIdType>
 absl::optional<std::reference_wrapper<const absl::flat_hash_set<SubscriberID>>>
 SubscriptionIndex<KeyIdType>::GetSubscriberIdsByKeyId(
     const std::string &key_id_binary) const {
-  const auto key_id = KeyIdType::FromBinary(key_id_binary);
+  const auto key_id = ParseKeyId<KeyIdType>(key_id_binary);
   auto it = key_id_to_subscribers_.find(key_id);
   if (it == key_id_to_subscribers_.end()) {
     return absl::nullopt;
@@ -48,7 +64,7 @@ SubscriptionIndex<KeyIdType>::GetSubscriberIdsByKeyId(
 
 template <typename KeyIdType>
 bool SubscriptionIndex<KeyIdType>::HasKeyId(const std::string &key_id_binary) const {
-  const auto key_id = KeyIdType::FromBinary(key_id_binary);
+  const auto key_id = ParseKeyId<KeyIdType>(key_id_binary);
   return key_id_to_subscribers_.count(key_id);
 }
 
@@ -86,7 +102,7 @@ template <typename KeyIdType>
 bool SubscriptionIndex<KeyIdType>::EraseEntry(const std::string &key_id_binary,
                                               const SubscriberID &subscriber_id) {
   // Erase keys from subscribers.
-  const auto key_id = KeyIdType::FromBinary(key_id_binary);
+  const auto key_id = ParseKeyId<KeyIdType>(key_id_binary);
   auto subscribers_to_message_it = subscribers_to_key_id_.find(subscriber_id);
   if (subscribers_to_message_it == subscribers_to_key_id_.end()) {
     return false;
@@ -138,17 +154,41 @@ bool Subscriber::ConnectToSubscriber(rpc::PubsubLongPollingReply *reply,
   return false;
 }
 
-void Subscriber::QueueMessage(const rpc::PubMessage &pub_message, bool try_publish) {
-  if (mailbox_.empty() || mailbox_.back()->pub_messages_size() >= publish_batch_size_) {
-    mailbox_.push_back(absl::make_unique<rpc::PubsubLongPollingReply>());
+void Subscriber::QueueMessage(const std::shared_ptr<const rpc::PubMessage> &pub_message,
+                              bool try_publish) {
+  // An object locations message carries all the locations of its object, so it
+  // supersedes an older one that hasn't been sent yet.
+  bool is_snapshot = coalesce_superseded_messages_ &&
+                     pub_message->pub_message_one_of_case() ==
+                         rpc::PubMessage::kWorkerObjectLocationsMessage;
+  if (is_snapshot) {
+    auto it = queued_snapshots_.find(
+        std::make_pair(pub_message->channel_type(), pub_message->key_id()));
+    if (it != queued_snapshots_.end()) {
+      *it->second = pub_message;
+      if (try_publish) {
+        PublishIfPossible();
+      }
+      return;
+    }
   }
 
-  // Update the long polling reply.
-  auto *next_long_polling_reply = mailbox_.back().get();
-  auto *new_pub_message = next_long_polling_reply->add_pub_messages();
-  new_pub_message->CopyFrom(pub_message);
+  if (mailbox_.empty() ||
+      mailbox_.back().size() >= static_cast<size_t>(publish_batch_size_)) {
+    mailbox_.emplace_back();
+  }
 
-  if (try_publish) {
+  // Queue a reference to the message. It is copied into the reply when it is sent.
+  auto &batch = mailbox_.back();
+  batch.push_back(pub_message);
+  if (is_snapshot) {
+    queued_snapshots_.emplace(
+        std::make_pair(pub_message->channel_type(), pub_message->key_id()),
+        &batch.back());
+  }
+
+  // A full batch will not grow any further, so there is no point holding it back.
+  if (try_publish || mailbox_.size() > 1) {
     PublishIfPossible();
   }
 }
@@ -159,20 +199,29 @@ bool Subscriber::PublishIfPossible(bool force) {
   }
 
   if (force || mailbox_.size() > 0) {
-    // If force publish is invoked, mailbox could be empty. We should always add a reply
+    // If force publish is invoked, mailbox could be empty. We should always reply
     // here because otherwise, there could be memory leak due to our grpc layer
     // implementation.
-    if (mailbox_.empty()) {
-      mailbox_.push_back(absl::make_unique<rpc::PubsubLongPollingReply>());
+    auto *reply = long_polling_connection_->reply;
+    if (!mailbox_.empty()) {
+      const auto &batch = mailbox_.front();
+      reply->mutable_pub_messages()->Reserve(batch.size());
+      for (const auto &message : batch) {
+        // The messages of this batch are no longer queued and can't be replaced.
+        if (!queued_snapshots_.empty()) {
+          queued_snapshots_.erase(
+              std::make_pair(message->channel_type(), message->key_id()));
+        }
+        reply->add_pub_messages()->CopyFrom(*message);
+      }
+      mailbox_.pop_front();
     }
 
-    // Reply to the long polling subscriber. Swap the reply here to avoid extra copy.
-    long_polling_connection_->reply->Swap(mailbox_.front().get());
+    // Reply to the long polling subscriber.
     long_polling_connection_->send_reply_callback(Status::OK(), nullptr, nullptr);
 
     // Clean up & update metadata.
     long_polling_connection_.reset(nullptr);
-    mailbox_.pop_front();
     last_connection_update_time_ms_ = get_time_ms_();
     return true;
   }
@@ -180,7 +229,8 @@ bool Subscriber::PublishIfPossible(bool force) {
 }
 
 bool Subscriber::CheckNoLeaks() const {
-  return !long_polling_connection_ && mailbox_.size() == 0;
+  return !long_polling_connection_ && mailbox_.size() == 0 &&
+         queued_snapshots_.empty();
 }
 
 bool Subscriber::IsDisconnected() const {
@@ -195,9 +245,16 @@ bool Subscriber::IsActiveConnectionTimedOut() const {
 
 // We need to define this in order for the compiler to find the definition.
 template class pub_internal::SubscriptionIndex<ObjectID>;
+template class pub_internal::SubscriptionIndex<std::string>;
 
 }  // namespace pub_internal
 
+std::shared_ptr<pub_internal::Subscriber> Publisher::CreateSubscriber() const {
+  return std::make_shared<pub_internal::Subscriber>(get_time_ms_, subscriber_timeout_ms_,
+                                                    publish_batch_size_,
+                                                    coalesce_superseded_messages_);
+}
+
 void Publisher::ConnectToSubscriber(const SubscriberID &subscriber_id,
                                     rpc::PubsubLongPollingReply *reply,
                                     rpc::SendReplyCallback send_reply_callback) {
@@ -207,11 +264,7 @@ void Publisher::ConnectToSubscriber(const SubscriberID &subscriber_id,
   absl::MutexLock lock(&mutex_);
   auto it = subscribers_.find(subscriber_id);
   if (it == subscribers_.end()) {
-    it = subscribers_
-             .emplace(subscriber_id,
-                      std::make_shared<pub_internal::Subscriber>(
-                          get_time_ms_, subscriber_timeout_ms_, publish_batch_size_))
-             .first;
+    it = subscribers_.emplace(subscriber_id, CreateSubscriber()).first;
   }
   auto &subscriber = it->second;
 
@@ -226,9 +279,7 @@ bool Publisher::RegisterSubscription(const rpc::ChannelType channel_type,
                                      const std::string &key_id_binary) {
   absl::MutexLock lock(&mutex_);
   if (subscribers_.count(subscriber_id) == 0) {
-    subscribers_.emplace(subscriber_id,
-                         std::make_shared<pub_internal::Subscriber>(
-                             get_time_ms_, subscriber_timeout_ms_, publish_batch_size_));
+    subscribers_.emplace(subscriber_id, CreateSubscriber());
   }
   auto subscription_index_it = subscription_index_map_.find(channel_type);
   RAY_CHECK(subscription_index_it != subscription_index_map_.end());
@@ -251,11 +302,45 @@ void Publisher::Publish(const rpc::ChannelType channel_type,
 
   cum_pub_message_cnt_[channel_type]++;
 
+  // All the subscribers share one copy of the message.
+  auto shared_message = std::make_shared<const rpc::PubMessage>(pub_message);
   for (const auto &subscriber_id : maybe_subscribers.value().get()) {
     auto it = subscribers_.find(subscriber_id);
     RAY_CHECK(it != subscribers_.end());
     auto &subscriber = it->second;
-    subscriber->QueueMessage(pub_message);
+    subscriber->QueueMessage(shared_message,
+                             /*try_publish=*/publish_batch_window_ms_ == 0);
+  }
+}
+
+void Publisher::PublishToKeys(const rpc::ChannelType channel_type,
+                              const rpc::PubMessage &pub_message,
+                              const std::vector<std::string> &key_id_binaries) {
+  absl::MutexLock lock(&mutex_);
+  auto subscription_index_it = subscription_index_map_.find(channel_type);
+  RAY_CHECK(subscription_index_it != subscription_index_map_.end());
+  // A subscriber that subscribes to several of the keys gets the message once.
+  absl::flat_hash_set<SubscriberID> subscriber_ids;
+  for (const auto &key_id_binary : key_id_binaries) {
+    auto maybe_subscribers =
+        subscription_index_it->second.GetSubscriberIdsByKeyId(key_id_binary);
+    if (maybe_subscribers.has_value()) {
+      const auto &key_subscribers = maybe_subscribers.value().get();
+      subscriber_ids.insert(key_subscribers.begin(), key_subscribers.end());
+    }
+  }
+  if (subscriber_ids.empty()) {
+    return;
+  }
+
+  cum_pub_message_cnt_[channel_type]++;
+
+  auto shared_message = std::make_shared<const rpc::PubMessage>(pub_message);
+  for (const auto &subscriber_id : subscriber_ids) {
+    auto it = subscribers_.find(subscriber_id);
+    RAY_CHECK(it != subscribers_.end());
+    it->second->QueueMessage(shared_message,
+                             /*try_publish=*/publish_batch_window_ms_ == 0);
   }
 }
 
@@ -325,6 +410,13 @@ void Publisher::CheckDeadSubscribers() {
   }
 }
 
+void Publisher::PublishBatchedMessages() {
+  absl::MutexLock lock(&mutex_);
+  for (const auto &it : subscribers_) {
+    it.second->PublishIfPossible();
+  }
+}
+
 bool Publisher::CheckNoLeaks() const {
   absl::MutexLock lock(&mutex_);
   for (const auto &subscriber : subscribers_) {
@@ -15,6 +15,9 @@
 #pragma once
 
 #include <gtest/gtest_prod.h>
+
+#include <deque>
+
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/synchronization/mutex.h"
@@ -86,8 +89,10 @@ struct LongPollConnection {
 class Subscriber {
  public:
   explicit Subscriber(const std::function<double()> &get_time_ms,
-                      uint64_t connection_timeout_ms, const int publish_batch_size)
-      : get_time_ms_(get_time_ms),
+                      uint64_t connection_timeout_ms, const int publish_batch_size,
+                      bool coalesce_superseded_messages = false)
+      : coalesce_superseded_messages_(coalesce_superseded_messages),
+        get_time_ms_(get_time_ms),
         connection_timeout_ms_(connection_timeout_ms),
         publish_batch_size_(publish_batch_size),
         last_connection_update_time_ms_(get_time_ms()) {}
@@ -103,12 +108,19 @@ class Subscriber {
   bool ConnectToSubscriber(rpc::PubsubLongPollingReply *reply,
                            rpc::SendReplyCallback send_reply_callback);
 
-  /// Queue the pubsub message to publish to the subscriber.
+  /// Queue the pubsub message to publish to the subscriber. The message is shared with
+  /// the other subscribers it is published to, and is only copied into the long polling
+  /// reply when it is sent.
   ///
   /// \param pub_message A message to publish.
   /// \param try_publish If true, it try publishing the object id if there is a
-  /// connection.
-  void QueueMessage(const rpc::PubMessage &pub_message, bool try_publish = true);
+  /// connection. A full batch is always published if possible.
+  ///
+  /// If superseded messages are coalesced and the message is a full snapshot of its
+  /// key, such as an object locations message, it replaces the queued snapshot of the
+  /// same key instead of being queued after it.
+  void QueueMessage(const std::shared_ptr<const rpc::PubMessage> &pub_message,
+                    bool try_publish = true);
 
   /// Publish all queued messages if possible.
   ///
@@ -133,8 +145,17 @@ class Subscriber {
   /// It is cached whenever new long polling is coming from the subscriber.
   /// It becomes a nullptr whenever the long polling request is replied.
   std::unique_ptr<LongPollConnection> long_polling_connection_;
-  /// Queued messages to publish.
-  std::list<std::unique_ptr<rpc::PubsubLongPollingReply>> mailbox_;
+  /// Queued messages to publish, in batches of up to `publish_batch_size_` messages.
+  /// A deque keeps the queued entries in place while a batch grows, so that
+  /// `queued_snapshots_` can point to them.
+  std::list<std::deque<std::shared_ptr<const rpc::PubMessage>>> mailbox_;
+  /// Whether a snapshot message replaces the queued snapshot of the same key.
+  const bool coalesce_superseded_messages_;
+  /// The queued snapshot messages in `mailbox_`, by channel and key. Only used if
+  /// superseded messages are coalesced.
+  absl::flat_hash_map<std::pair<rpc::ChannelType, std::string>,
+                      std::shared_ptr<const rpc::PubMessage> *>
+      queued_snapshots_;
   /// Callback to get the current time.
   const std::function<double()> get_time_ms_;
   /// The time in which the connection is considered as timed out.
@@ -205,8 +226,8 @@ class PublisherInterface {
 ///
 /// - Update pubsub.proto.
 /// - Add a new channel type -> index to subscription_index_map_.
-/// - If your SubscriptionIndex requires different id types, make sure to add template
-/// definition to the publisher.cc file.
+/// - Keys are indexed in their binary form. If your channel filters messages by several
+/// keys, publish with PublishToKeys.
 ///
 class Publisher : public PublisherInterface {
  public:
@@ -219,22 +240,43 @@ class Publisher : public PublisherInterface {
   /// \param subscriber_timeout_ms The subscriber timeout in milliseconds.
   /// Check out CheckDeadSubscribers for more details.
   /// \param publish_batch_size The batch size of published messages.
+  /// \param publish_batch_window_ms If non-zero, messages are held for up to
+  /// this long so that messages published to the same subscriber in quick
+  /// succession are coalesced into one long polling reply. If 0, messages are
+  /// published as soon as the subscriber is connected.
+  /// \param coalesce_superseded_messages If true, a snapshot message that is still
+  /// queued for a subscriber is replaced by a newer snapshot of the same key, so that
+  /// repeated updates of one key are sent once.
   explicit Publisher(PeriodicalRunner *periodical_runner,
                      const std::function<double()> get_time_ms,
-                     const uint64_t subscriber_timeout_ms, const int publish_batch_size)
+                     const uint64_t subscriber_timeout_ms, const int publish_batch_size,
+                     const uint64_t publish_batch_window_ms = 0,
+                     bool coalesce_superseded_messages = false)
       : periodical_runner_(periodical_runner),
         get_time_ms_(get_time_ms),
         subscriber_timeout_ms_(subscriber_timeout_ms),
-        publish_batch_size_(publish_batch_size) {
+        publish_batch_size_(publish_batch_size),
+        publish_batch_window_ms_(publish_batch_window_ms),
+        coalesce_superseded_messages_(coalesce_superseded_messages) {
     periodical_runner_->RunFnPeriodically([this] { CheckDeadSubscribers(); },
                                           subscriber_timeout_ms);
+    if (publish_batch_window_ms_ > 0) {
+      periodical_runner_->RunFnPeriodically([this] { PublishBatchedMessages(); },
+                                            publish_batch_window_ms_);
+    }
     // Insert index map for each channel.
     subscription_index_map_.emplace(rpc::ChannelType::WORKER_OBJECT_EVICTION,
-                                    pub_internal::SubscriptionIndex<ObjectID>());
+                                    pub_internal::SubscriptionIndex<std::string>());
     subscription_index_map_.emplace(rpc::ChannelType::WORKER_REF_REMOVED_CHANNEL,
-                                    pub_internal::SubscriptionIndex<ObjectID>());
+                                    pub_internal::SubscriptionIndex<std::string>());
     subscription_index_map_.emplace(rpc::ChannelType::WORKER_OBJECT_LOCATIONS_CHANNEL,
-                                    pub_internal::SubscriptionIndex<ObjectID>());
+                                    pub_internal::SubscriptionIndex<std::string>());
+    subscription_index_map_.emplace(rpc::ChannelType::GCS_ACTOR_CHANNEL,
+                                    pub_internal::SubscriptionIndex<std::string>());
+    subscription_index_map_.emplace(rpc::ChannelType::GCS_JOB_CHANNEL,
+                                    pub_internal::SubscriptionIndex<std::string>());
+    subscription_index_map_.emplace(rpc::ChannelType::GCS_NODE_INFO_CHANNEL,
+                                    pub_internal::SubscriptionIndex<std::string>());
   }
 
   ~Publisher() = default;
@@ -266,6 +308,18 @@ class Publisher : public PublisherInterface {
   void Publish(const rpc::ChannelType channel_type, const rpc::PubMessage &pub_message,
                const std::string &key_id_binary) override;
 
+  /// Publish the given message to the subscribers of any of the given keys. Each
+  /// subscriber gets the message once, even if it subscribes to several of the keys.
+  /// This is used to publish a message to subscribers that filter the channel in
+  /// different ways, for example by actor, by job or by node.
+  ///
+  /// \param channel_type The type of the channel.
+  /// \param pub_message The message to publish.
+  /// \param key_id_binaries The keys to publish the message to.
+  void PublishToKeys(const rpc::ChannelType channel_type,
+                     const rpc::PubMessage &pub_message,
+                     const std::vector<std::string> &key_id_binaries);
+
   /// Publish to the subscriber that the given key id is not available anymore.
   /// It will invoke the failure callback on the subscriber side.
   ///
@@ -330,6 +384,9 @@ class Publisher : public PublisherInterface {
   FRIEND_TEST(PublisherTest, TestUnregisterSubscription);
   FRIEND_TEST(PublisherTest, TestUnregisterSubscriber);
   FRIEND_TEST(PublisherTest, TestRegistrationIdempotency);
+  FRIEND_TEST(PublisherTest, TestPublishBatchWindow);
+  FRIEND_TEST(PublisherTest, TestCoalesceSupersededMessages);
+  FRIEND_TEST(PublisherTest, TestPublishToKeys);
   /// Testing only. Return true if there's no metadata remained in the private attribute.
   bool CheckNoLeaks() const;
 
@@ -340,6 +397,10 @@ class Publisher : public PublisherInterface {
   bool UnregisterSubscriberInternal(const SubscriberID &subscriber_id)
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  /// Publish the messages held back by the batching window to all connected
+  /// subscribers. Only used when publish_batch_window_ms_ is non-zero.
+  void PublishBatchedMessages() LOCKS_EXCLUDED(mutex_);
+
   // Periodic runner to invoke CheckDeadSubscribers.
   PeriodicalRunner *periodical_runner_;
 
@@ -349,6 +410,9 @@ class Publisher : public PublisherInterface {
   /// The timeout where subscriber is considered as dead.
   const uint64_t subscriber_timeout_ms_;
 
+  /// Create the subscriber state for a new subscriber.
+  std::shared_ptr<pub_internal::Subscriber> CreateSubscriber() const;
+
   /// Protects below fields. Since the coordinator runs in a core worker, it should be
   /// thread safe.
   mutable absl::Mutex mutex_;
@@ -358,12 +422,21 @@ class Publisher : public PublisherInterface {
       subscribers_ GUARDED_BY(mutex_);
 
   /// Index that stores the mapping of messages <-> subscribers.
-  absl::flat_hash_map<rpc::ChannelType, pub_internal::SubscriptionIndex<ObjectID>>
+  /// The keys are indexed in their binary form, so that channels whose keys are
+  /// not all IDs of one type can share the index.
+  absl::flat_hash_map<rpc::ChannelType, pub_internal::SubscriptionIndex<std::string>>
       subscription_index_map_ GUARDED_BY(mutex_);
 
   /// The maximum number of objects to publish for each publish calls.
   const int publish_batch_size_;
 
+  /// How long published messages may be held back so that they are coalesced
+  /// per subscriber. 0 means no batching window.
+  const uint64_t publish_batch_window_ms_;
+
+  /// Whether queued snapshot messages are replaced by newer snapshots of the same key.
+  const bool coalesce_superseded_messages_;
+
   absl::flat_hash_map<rpc::ChannelType, uint64_t> cum_pub_message_cnt_;
 };
 
@@ -290,7 +290,8 @@ TEST_F(PublisherTest, TestSubscriber) {
   std::unordered_set<ObjectID> published_objects;
   // Make sure publishing one object works as expected.
   auto oid = ObjectID::FromRandom();
-  subscriber->QueueMessage(GeneratePubMessage(oid), /*try_publish=*/false);
+  subscriber->QueueMessage(std::make_shared<rpc::PubMessage>(GeneratePubMessage(oid)),
+                           /*try_publish=*/false);
   published_objects.emplace(oid);
   ASSERT_TRUE(subscriber->PublishIfPossible());
   ASSERT_TRUE(object_ids_published.count(oid) > 0);
@@ -300,7 +301,7 @@ TEST_F(PublisherTest, TestSubscriber) {
   // Add 3 oids and see if it works properly.
   for (int i = 0; i < 3; i++) {
     oid = ObjectID::FromRandom();
-    subscriber->QueueMessage(GeneratePubMessage(oid),
+    subscriber->QueueMessage(std::make_shared<rpc::PubMessage>(GeneratePubMessage(oid)),
                              /*try_publish=*/false);
     published_objects.emplace(oid);
   }
@@ -339,7 +340,7 @@ TEST_F(PublisherTest, TestSubscriberBatchSize) {
   for (int i = 0; i < 10; i++) {
     auto oid = ObjectID::FromRandom();
     oids.push_back(oid);
-    subscriber->QueueMessage(GeneratePubMessage(oid),
+    subscriber->QueueMessage(std::make_shared<rpc::PubMessage>(GeneratePubMessage(oid)),
                              /*try_publish=*/false);
     published_objects.emplace(oid);
   }
@@ -408,7 +409,7 @@ TEST_F(PublisherTest, TestSubscriberActiveTimeout) {
 
   // A message is published, so the connection is refreshed.
   auto oid = ObjectID::FromRandom();
-  subscriber->QueueMessage(GeneratePubMessage(oid));
+  subscriber->QueueMessage(std::make_shared<rpc::PubMessage>(GeneratePubMessage(oid)));
   ASSERT_FALSE(subscriber->IsActiveConnectionTimedOut());
   ASSERT_FALSE(subscriber->IsDisconnected());
   ASSERT_EQ(reply_cnt, 2);
@@ -1003,6 +1004,195 @@ TEST_F(PublisherTest, TestPublishFailure) {
   ASSERT_EQ(failed_ids[0], oid);
 }
 
+TEST_F(PublisherTest, TestPublishBatchWindow) {
+  ///
+  /// Test that messages are held back and coalesced when a batch window is set.
+  ///
+  Publisher publisher(
+      /*periodic_runner=*/periodic_runner_.get(),
+      /*get_time_ms=*/[this]() { return current_time_; },
+      /*subscriber_timeout_ms=*/subscriber_timeout_ms_,
+      /*batch_size*/ 3,
+      /*publish_batch_window_ms=*/10);
+  int num_replies = 0;
+  std::vector<ObjectID> batched_ids;
+  rpc::PubsubLongPollingReply reply;
+  rpc::SendReplyCallback send_reply_callback =
+      [&reply, &batched_ids, &num_replies](Status status, std::function<void()> success,
+                                           std::function<void()> failure) {
+        num_replies++;
+        for (int i = 0; i < reply.pub_messages_size(); i++) {
+          const auto &msg = reply.pub_messages(i);
+          batched_ids.push_back(
+              ObjectID::FromBinary(msg.worker_object_eviction_message().object_id()));
+        }
+        reply = rpc::PubsubLongPollingReply();
+      };
+
+  const auto subscriber_node_id = NodeID::FromRandom();
+  publisher.ConnectToSubscriber(subscriber_node_id, &reply, send_reply_callback);
+  std::vector<ObjectID> oids;
+  for (int i = 0; i < 2; i++) {
+    const auto oid = ObjectID::FromRandom();
+    oids.push_back(oid);
+    publisher.RegisterSubscription(rpc::ChannelType::WORKER_OBJECT_EVICTION,
+                                   subscriber_node_id, oid.Binary());
+    publisher.Publish(rpc::ChannelType::WORKER_OBJECT_EVICTION, GeneratePubMessage(oid),
+                      oid.Binary());
+  }
+  // The subscriber is connected, but the messages are held for the window.
+  ASSERT_EQ(num_replies, 0);
+
+  // Once the window elapses, both messages go out in one reply.
+  publisher.PublishBatchedMessages();
+  ASSERT_EQ(num_replies, 1);
+  ASSERT_EQ(batched_ids, oids);
+
+  // A full batch is published right away without waiting for the window.
+  publisher.ConnectToSubscriber(subscriber_node_id, &reply, send_reply_callback);
+  for (int i = 0; i < 4; i++) {
+    const auto oid = ObjectID::FromRandom();
+    publisher.RegisterSubscription(rpc::ChannelType::WORKER_OBJECT_EVICTION,
+                                   subscriber_node_id, oid.Binary());
+    publisher.Publish(rpc::ChannelType::WORKER_OBJECT_EVICTION, GeneratePubMessage(oid),
+                      oid.Binary());
+  }
+  ASSERT_EQ(num_replies, 2);
+  ASSERT_EQ(batched_ids.size(), 5);
+}
+
+TEST_F(PublisherTest, TestCoalesceSupersededMessages) {
+  ///
+  /// Test that a queued locations update is replaced by a newer one of the same object.
+  ///
+  Publisher publisher(
+      /*periodic_runner=*/periodic_runner_.get(),
+      /*get_time_ms=*/[this]() { return current_time_; },
+      /*subscriber_timeout_ms=*/subscriber_timeout_ms_,
+      /*batch_size*/ 100,
+      /*publish_batch_window_ms=*/10,
+      /*coalesce_superseded_messages=*/true);
+  int num_replies = 0;
+  rpc::PubsubLongPollingReply reply;
+  rpc::PubsubLongPollingReply last_reply;
+  rpc::SendReplyCallback send_reply_callback =
+      [&reply, &last_reply, &num_replies](Status status, std::function<void()> success,
+                                          std::function<void()> failure) {
+        num_replies++;
+        last_reply = reply;
+        reply = rpc::PubsubLongPollingReply();
+      };
+
+  const auto subscriber_node_id = NodeID::FromRandom();
+  const auto oid = ObjectID::FromRandom();
+  const auto other_oid = ObjectID::FromRandom();
+  auto locations_message = [](const ObjectID &object_id, uint64_t object_size) {
+    rpc::PubMessage pub_message;
+    pub_message.set_key_id(object_id.Binary());
+    pub_message.set_channel_type(rpc::ChannelType::WORKER_OBJECT_LOCATIONS_CHANNEL);
+    pub_message.mutable_worker_object_locations_message()->set_object_size(object_size);
+    return pub_message;
+  };
+  publisher.ConnectToSubscriber(subscriber_node_id, &reply, send_reply_callback);
+  for (const auto &id : {oid, other_oid}) {
+    publisher.RegisterSubscription(rpc::ChannelType::WORKER_OBJECT_LOCATIONS_CHANNEL,
+                                   subscriber_node_id, id.Binary());
+  }
+  for (uint64_t i = 1; i <= 3; i++) {
+    publisher.Publish(rpc::ChannelType::WORKER_OBJECT_LOCATIONS_CHANNEL,
+                      locations_message(oid, i), oid.Binary());
+  }
+  publisher.Publish(rpc::ChannelType::WORKER_OBJECT_LOCATIONS_CHANNEL,
+                    locations_message(other_oid, 10), other_oid.Binary());
+
+  // Only the latest update of each object is sent.
+  publisher.PublishBatchedMessages();
+  ASSERT_EQ(num_replies, 1);
+  ASSERT_EQ(last_reply.pub_messages_size(), 2);
+  ASSERT_EQ(last_reply.pub_messages(0).key_id(), oid.Binary());
+  ASSERT_EQ(
+      last_reply.pub_messages(0).worker_object_locations_message().object_size(), 3);
+  ASSERT_EQ(last_reply.pub_messages(1).key_id(), other_oid.Binary());
+
+  // A sent update is not replaced by later ones.
+  publisher.Publish(rpc::ChannelType::WORKER_OBJECT_LOCATIONS_CHANNEL,
+                    locations_message(oid, 4), oid.Binary());
+  publisher.ConnectToSubscriber(subscriber_node_id, &reply, send_reply_callback);
+  publisher.PublishBatchedMessages();
+  ASSERT_EQ(num_replies, 2);
+  ASSERT_EQ(last_reply.pub_messages_size(), 1);
+  ASSERT_EQ(
+      last_reply.pub_messages(0).worker_object_locations_message().object_size(), 4);
+
+  for (const auto &id : {oid, other_oid}) {
+    publisher.UnregisterSubscription(rpc::ChannelType::WORKER_OBJECT_LOCATIONS_CHANNEL,
+                                     subscriber_node_id, id.Binary());
+  }
+  ASSERT_TRUE(publisher.CheckNoLeaks());
+}
+
+TEST_F(PublisherTest, TestPublishToKeys) {
+  // Subscribers that filter a channel by different keys get each message once.
+  std::vector<std::string> received_keys;
+  rpc::PubsubLongPollingReply reply;
+  rpc::SendReplyCallback send_reply_callback =
+      [&reply, &received_keys](Status status, std::function<void()> success,
+                               std::function<void()> failure) {
+        for (int i = 0; i < reply.pub_messages_size(); i++) {
+          received_keys.push_back(reply.pub_messages(i).key_id());
+        }
+        reply = rpc::PubsubLongPollingReply();
+      };
+
+  const auto actor_id = ActorID::Of(JobID::FromInt(1), TaskID::Nil(), 0);
+  const std::string job_key = "job:" + actor_id.JobId().Binary();
+  const auto actor_subscriber = NodeID::FromRandom();
+  const auto job_subscriber = NodeID::FromRandom();
+  const auto both_subscriber = NodeID::FromRandom();
+  object_status_publisher_->RegisterSubscription(rpc::ChannelType::GCS_ACTOR_CHANNEL,
+                                                 actor_subscriber, actor_id.Binary());
+  object_status_publisher_->RegisterSubscription(rpc::ChannelType::GCS_ACTOR_CHANNEL,
+                                                 job_subscriber, job_key);
+  object_status_publisher_->RegisterSubscription(rpc::ChannelType::GCS_ACTOR_CHANNEL,
+                                                 both_subscriber, actor_id.Binary());
+  object_status_publisher_->RegisterSubscription(rpc::ChannelType::GCS_ACTOR_CHANNEL,
+                                                 both_subscriber, job_key);
+
+  rpc::PubMessage pub_message;
+  pub_message.set_channel_type(rpc::ChannelType::GCS_ACTOR_CHANNEL);
+  pub_message.set_key_id(actor_id.Binary());
+  pub_message.mutable_actor_message()->set_state(rpc::ActorTableData::ALIVE);
+  object_status_publisher_->PublishToKeys(
+      rpc::ChannelType::GCS_ACTOR_CHANNEL, pub_message,
+      {actor_id.Binary(), job_key, "node:" + NodeID::FromRandom().Binary()});
+
+  for (const auto &subscriber : {actor_subscriber, job_subscriber, both_subscriber}) {
+    object_status_publisher_->ConnectToSubscriber(subscriber, &reply,
+                                                  send_reply_callback);
+  }
+  ASSERT_EQ(received_keys.size(), 3);
+  for (const auto &key : received_keys) {
+    ASSERT_EQ(key, actor_id.Binary());
+  }
+
+  // Nothing is queued for subscribers of other keys.
+  const auto other_job_subscriber = NodeID::FromRandom();
+  object_status_publisher_->RegisterSubscription(rpc::ChannelType::GCS_ACTOR_CHANNEL,
+                                                 other_job_subscriber,
+                                                 "job:" + JobID::FromInt(2).Binary());
+  object_status_publisher_->PublishToKeys(rpc::ChannelType::GCS_ACTOR_CHANNEL,
+                                          pub_message, {actor_id.Binary(), job_key});
+  object_status_publisher_->ConnectToSubscriber(other_job_subscriber, &reply,
+                                                send_reply_callback);
+  ASSERT_EQ(received_keys.size(), 3);
+
+  for (const auto &subscriber :
+       {actor_subscriber, job_subscriber, both_subscriber, other_job_subscriber}) {
+    object_status_publisher_->UnregisterSubscriber(subscriber);
+  }
+  ASSERT_TRUE(object_status_publisher_->CheckNoLeaks());
+}
+
 }  // namespace pubsub
 
 }  // namespace ray
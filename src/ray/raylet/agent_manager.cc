@@ -118,13 +118,83 @@ void AgentManager::StartAgent() {
 void AgentManager::CreateRuntimeEnv(const JobID &job_id,
                                     const std::string &serialized_runtime_env,
                                     CreateRuntimeEnvCallback callback) {
+  if (!RayConfig::instance().deduplicate_runtime_env_creation()) {
+    SendCreateRuntimeEnv(job_id, serialized_runtime_env, callback);
+    return;
+  }
+  auto &creation = runtime_env_creations_[job_id][serialized_runtime_env];
+  if (creation.created) {
+    callback(true, creation.serialized_runtime_env_context);
+    return;
+  }
+  creation.callbacks.push_back(callback);
+  if (creation.callbacks.size() > 1) {
+    // A creation of the same runtime env is already in flight.
+    return;
+  }
+  SendCreateRuntimeEnv(
+      job_id, serialized_runtime_env,
+      [this, job_id, serialized_runtime_env](
+          bool successful, const std::string &serialized_runtime_env_context) {
+        FinishCreateRuntimeEnv(job_id, serialized_runtime_env, successful,
+                               serialized_runtime_env_context);
+      });
+}
+
+void AgentManager::FinishCreateRuntimeEnv(
+    const JobID &job_id, const std::string &serialized_runtime_env, bool successful,
+    const std::string &serialized_runtime_env_context) {
+  std::vector<CreateRuntimeEnvCallback> callbacks;
+  auto job_it = runtime_env_creations_.find(job_id);
+  if (job_it != runtime_env_creations_.end()) {
+    auto it = job_it->second.find(serialized_runtime_env);
+    if (it != job_it->second.end()) {
+      callbacks.swap(it->second.callbacks);
+      if (successful) {
+        it->second.created = true;
+        it->second.serialized_runtime_env_context = serialized_runtime_env_context;
+      } else {
+        job_it->second.erase(it);
+        if (job_it->second.empty()) {
+          runtime_env_creations_.erase(job_it);
+        }
+      }
+    }
+  }
+  for (const auto &callback : callbacks) {
+    callback(successful, serialized_runtime_env_context);
+  }
+}
+
+void AgentManager::ClearRuntimeEnvCreations(const JobID &job_id) {
+  auto job_it = runtime_env_creations_.find(job_id);
+  if (job_it == runtime_env_creations_.end()) {
+    return;
+  }
+  // Keep the creations in flight, their requests are still waiting.
+  auto &creations = job_it->second;
+  for (auto it = creations.begin(); it != creations.end();) {
+    if (it->second.created) {
+      creations.erase(it++);
+    } else {
+      it++;
+    }
+  }
+  if (creations.empty()) {
+    runtime_env_creations_.erase(job_it);
+  }
+}
+
+void AgentManager::SendCreateRuntimeEnv(const JobID &job_id,
+                                        const std::string &serialized_runtime_env,
+                                        CreateRuntimeEnvCallback callback) {
   if (runtime_env_agent_client_ == nullptr) {
     RAY_LOG(INFO)
         << "Runtime env agent is not registered yet. Will retry CreateRuntimeEnv later: "
         << serialized_runtime_env;
     delay_executor_(
         [this, job_id, serialized_runtime_env, callback] {
-          CreateRuntimeEnv(job_id, serialized_runtime_env, callback);
+          SendCreateRuntimeEnv(job_id, serialized_runtime_env, callback);
         },
         RayConfig::instance().agent_manager_retry_interval_ms());
     return;
@@ -151,7 +221,7 @@ void AgentManager::CreateRuntimeEnv(const JobID &job_id,
               << ", maybe there are some network problems, will retry it later.";
           delay_executor_(
               [this, job_id, serialized_runtime_env, callback] {
-                CreateRuntimeEnv(job_id, serialized_runtime_env, callback);
+                SendCreateRuntimeEnv(job_id, serialized_runtime_env, callback);
               },
               RayConfig::instance().agent_manager_retry_interval_ms());
         }
@@ -19,6 +19,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "ray/common/id.h"
 #include "ray/rpc/agent_manager/agent_manager_client.h"
 #include "ray/rpc/agent_manager/agent_manager_server.h"
@@ -83,9 +84,35 @@ class AgentManager : public rpc::AgentManagerServiceHandler {
   virtual void DeleteRuntimeEnv(const std::string &serialized_runtime_env,
                                 DeleteRuntimeEnvCallback callback);
 
+  /// Forget the runtime envs created for a job, called when the job finishes.
+  /// \param[in] job_id The job.
+  void ClearRuntimeEnvCreations(const JobID &job_id);
+
  private:
   void StartAgent();
 
+  /// Send a request to the agent to create a runtime env, retrying until the agent
+  /// replies.
+  void SendCreateRuntimeEnv(const JobID &job_id,
+                            const std::string &serialized_runtime_env,
+                            CreateRuntimeEnvCallback callback);
+
+  /// Pass the outcome of creating a runtime env to all the requests waiting for it.
+  void FinishCreateRuntimeEnv(const JobID &job_id,
+                              const std::string &serialized_runtime_env,
+                              bool successful,
+                              const std::string &serialized_runtime_env_context);
+
+  /// The creation of a runtime env for a job.
+  struct RuntimeEnvCreation {
+    /// Whether the runtime env was created successfully. Failed creations are not
+    /// kept, so that the next request tries again.
+    bool created = false;
+    std::string serialized_runtime_env_context;
+    /// The requests waiting for the creation in flight.
+    std::vector<CreateRuntimeEnvCallback> callbacks;
+  };
+
  private:
   Options options_;
   pid_t agent_pid_ = 0;
@@ -95,6 +122,10 @@ class AgentManager : public rpc::AgentManagerServiceHandler {
   RuntimeEnvAgentClientFactoryFn runtime_env_agent_client_factory_;
   PutAgentAddressFn put_agent_address_;
   std::shared_ptr<rpc::RuntimeEnvAgentClientInterface> runtime_env_agent_client_;
+  /// The runtime env creations in flight or done, by job and serialized runtime env.
+  /// Only used if deduplicate_runtime_env_creation is set.
+  absl::flat_hash_map<JobID, absl::flat_hash_map<std::string, RuntimeEnvCreation>>
+      runtime_env_creations_;
 };
 
 class DefaultAgentManagerServiceHandler : public rpc::AgentManagerServiceHandler {
@@ -14,6 +14,9 @@
 
 #include "ray/raylet/dependency_manager.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace ray {
 
 namespace raylet {
@@ -193,10 +196,27 @@ bool DependencyManager::RequestTaskDependencies(
   }
 
   if (!required_objects.empty()) {
-    task_entry.pull_request_id =
-        object_manager_.Pull(required_objects, BundlePriority::TASK_ARGS);
-    RAY_LOG(DEBUG) << "Started pull for dependencies of task " << task_id
-                   << " request: " << task_entry.pull_request_id;
+    task_entry.pull_key.assign(task_entry.dependencies.begin(),
+                               task_entry.dependencies.end());
+    std::sort(task_entry.pull_key.begin(), task_entry.pull_key.end(),
+              [](const ObjectID &a, const ObjectID &b) {
+                return std::memcmp(a.Data(), b.Data(), ObjectID::Size()) < 0;
+              });
+    auto pull_it = task_pulls_.find(task_entry.pull_key);
+    if (pull_it == task_pulls_.end()) {
+      uint64_t pull_request_id =
+          object_manager_.Pull(required_objects, BundlePriority::TASK_ARGS);
+      pull_it =
+          task_pulls_.emplace(task_entry.pull_key, SharedTaskPull{pull_request_id, 0})
+              .first;
+      RAY_LOG(DEBUG) << "Started pull for dependencies of task " << task_id
+                     << " request: " << pull_request_id;
+    } else {
+      RAY_LOG(DEBUG) << "Task " << task_id << " shares pull request "
+                     << pull_it->second.pull_request_id;
+    }
+    pull_it->second.num_tasks++;
+    task_entry.pull_request_id = pull_it->second.pull_request_id;
   }
 
   return task_entry.num_missing_dependencies == 0;
@@ -209,9 +229,14 @@ void DependencyManager::RemoveTaskDependencies(const TaskID &task_id) {
       << "Can't remove dependencies of tasks that are not queued.";
 
   if (task_entry->second.pull_request_id > 0) {
-    RAY_LOG(DEBUG) << "Canceling pull for dependencies of task " << task_id
-                   << " request: " << task_entry->second.pull_request_id;
-    object_manager_.CancelPull(task_entry->second.pull_request_id);
+    auto pull_it = task_pulls_.find(task_entry->second.pull_key);
+    RAY_CHECK(pull_it != task_pulls_.end());
+    if (--pull_it->second.num_tasks == 0) {
+      RAY_LOG(DEBUG) << "Canceling pull for dependencies of task " << task_id
+                     << " request: " << task_entry->second.pull_request_id;
+      object_manager_.CancelPull(task_entry->second.pull_request_id);
+      task_pulls_.erase(pull_it);
+    }
   }
 
   for (const auto &obj_id : task_entry->second.dependencies) {
@@ -314,6 +339,7 @@ std::string DependencyManager::DebugString() const {
   std::stringstream result;
   result << "TaskDependencyManager:";
   result << "\n- task deps map size: " << queued_task_requests_.size();
+  result << "\n- task pulls map size: " << task_pulls_.size();
   result << "\n- get req map size: " << get_requests_.size();
   result << "\n- wait req map size: " << wait_requests_.size();
   result << "\n- local objects map size: " << local_objects_.size();
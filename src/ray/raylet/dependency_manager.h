@@ -206,6 +206,18 @@ class DependencyManager : public TaskDependencyManagerInterface {
     /// Used to identify the pull request for the dependencies to the object
     /// manager.
     uint64_t pull_request_id = 0;
+    /// The sorted dependencies, used to find the pull request that the task shares
+    /// with other queued tasks depending on the same objects.
+    std::vector<ObjectID> pull_key;
+  };
+
+  /// A pull request for the arguments of all queued tasks that depend on exactly the
+  /// same objects, so that they are pulled and accounted for once in the pull manager.
+  struct SharedTaskPull {
+    uint64_t pull_request_id;
+    /// The number of queued tasks using the pull request. The pull is canceled once
+    /// no task uses it anymore.
+    size_t num_tasks;
   };
 
   /// Stop tracking this object, if it is no longer needed by any worker or
@@ -224,6 +236,10 @@ class DependencyManager : public TaskDependencyManagerInterface {
   /// dependencies are all local or not.
   absl::flat_hash_map<TaskID, TaskDependencies> queued_task_requests_;
 
+  /// A map from the sorted dependencies of queued tasks to the pull request that
+  /// fetches them.
+  absl::flat_hash_map<std::vector<ObjectID>, SharedTaskPull> task_pulls_;
+
   /// A map from worker ID to the set of objects that the worker called
   /// `ray.get` on and a pull request ID for these objects. The pull request ID
   /// should be used to cancel the pull request in the object manager once the
@@ -69,6 +69,7 @@ class DependencyManagerTest : public ::testing::Test {
   void AssertNoLeaks() {
     ASSERT_TRUE(dependency_manager_.required_objects_.empty());
     ASSERT_TRUE(dependency_manager_.queued_task_requests_.empty());
+    ASSERT_TRUE(dependency_manager_.task_pulls_.empty());
     ASSERT_TRUE(dependency_manager_.get_requests_.empty());
     ASSERT_TRUE(dependency_manager_.wait_requests_.empty());
     // All pull requests are canceled.
@@ -125,8 +126,8 @@ TEST_F(DependencyManagerTest, TestMultipleTasks) {
     bool ready = dependency_manager_.RequestTaskDependencies(
         task_id, ObjectIdsToRefs({argument_id}));
     ASSERT_FALSE(ready);
-    // The object should be requested from the object manager once for each task.
-    ASSERT_EQ(object_manager_mock_.active_task_requests.size(), i + 1);
+    // The tasks depend on the same object, so they share one pull request.
+    ASSERT_EQ(object_manager_mock_.active_task_requests.size(), 1);
   }
 
   // Tell the task dependency manager that the object is local.
@@ -139,11 +140,40 @@ TEST_F(DependencyManagerTest, TestMultipleTasks) {
   ASSERT_TRUE(added_tasks.empty());
 
   for (auto &id : dependent_tasks) {
+    // The pull request is canceled once the last task is removed.
+    ASSERT_EQ(object_manager_mock_.active_task_requests.size(), 1);
     dependency_manager_.RemoveTaskDependencies(id);
   }
   AssertNoLeaks();
 }
 
+/// Test tasks that depend on different sets of objects. Each set is pulled once.
+TEST_F(DependencyManagerTest, TestSharedTaskPulls) {
+  ObjectID first_id = ObjectID::FromRandom();
+  ObjectID second_id = ObjectID::FromRandom();
+  TaskID first_task = RandomTaskId();
+  TaskID second_task = RandomTaskId();
+  TaskID third_task = RandomTaskId();
+  ASSERT_FALSE(dependency_manager_.RequestTaskDependencies(
+      first_task, ObjectIdsToRefs({first_id, second_id})));
+  // The same objects in a different order share the pull request.
+  ASSERT_FALSE(dependency_manager_.RequestTaskDependencies(
+      second_task, ObjectIdsToRefs({second_id, first_id})));
+  ASSERT_EQ(object_manager_mock_.active_task_requests.size(), 1);
+  // A subset of the objects is a different pull request.
+  ASSERT_FALSE(dependency_manager_.RequestTaskDependencies(third_task,
+                                                           ObjectIdsToRefs({first_id})));
+  ASSERT_EQ(object_manager_mock_.active_task_requests.size(), 2);
+
+  dependency_manager_.RemoveTaskDependencies(first_task);
+  ASSERT_EQ(object_manager_mock_.active_task_requests.size(), 2);
+  ASSERT_FALSE(dependency_manager_.TaskDependenciesBlocked(second_task));
+  dependency_manager_.RemoveTaskDependencies(second_task);
+  ASSERT_EQ(object_manager_mock_.active_task_requests.size(), 1);
+  dependency_manager_.RemoveTaskDependencies(third_task);
+  AssertNoLeaks();
+}
+
 /// Test task with multiple dependencies. The dependency manager should return
 /// the task ID as ready once all dependencies are local. If a dependency is
 /// later evicted, the dependency manager should return the task ID as waiting.
@@ -14,6 +14,12 @@
 
 #include "ray/raylet/local_object_manager.h"
 
+#include <zlib.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "absl/strings/match.h"
 #include "ray/common/asio/instrumented_io_context.h"
 #include "ray/stats/stats.h"
 #include "ray/util/util.h"
@@ -22,6 +28,34 @@ namespace ray {
 
 namespace raylet {
 
+namespace {
+/// Compress the given buffer with the fastest zlib level.
+///
+/// \return False if compression failed.
+bool CompressBuffer(const Buffer &buffer, std::string *compressed) {
+  uLongf compressed_size = compressBound(buffer.Size());
+  compressed->resize(compressed_size);
+  if (compress2(reinterpret_cast<Bytef *>(&(*compressed)[0]), &compressed_size,
+                buffer.Data(), buffer.Size(), Z_BEST_SPEED) != Z_OK) {
+    return false;
+  }
+  compressed->resize(compressed_size);
+  return true;
+}
+
+/// Decompress data that was compressed by CompressBuffer into a buffer of
+/// exactly the original size.
+///
+/// \return False if the data is corrupted.
+bool DecompressBuffer(const std::string &compressed, uint8_t *data, int64_t data_size) {
+  uLongf decompressed_size = data_size;
+  return uncompress(data, &decompressed_size,
+                    reinterpret_cast<const Bytef *>(compressed.data()),
+                    compressed.size()) == Z_OK &&
+         static_cast<int64_t>(decompressed_size) == data_size;
+}
+}  // namespace
+
 void LocalObjectManager::PinObjects(const std::vector<ObjectID> &object_ids,
                                     std::vector<std::unique_ptr<RayObject>> &&objects,
                                     const rpc::Address &owner_address) {
@@ -78,17 +112,54 @@ void LocalObjectManager::WaitForObjectFree(const rpc::Address &owner_address,
   }
 }
 
+std::vector<std::tuple<ObjectID, rpc::Address, int64_t>>
+LocalObjectManager::GetPinnedObjects() const {
+  std::vector<std::tuple<ObjectID, rpc::Address, int64_t>> objects;
+  objects.reserve(pinned_objects_.size());
+  for (const auto &entry : pinned_objects_) {
+    objects.emplace_back(entry.first, entry.second.second,
+                         entry.second.first->GetSize());
+  }
+  return objects;
+}
+
+bool LocalObjectManager::UnpinMigratedObject(const ObjectID &object_id) {
+  auto it = pinned_objects_.find(object_id);
+  if (it == pinned_objects_.end()) {
+    return false;
+  }
+  RAY_LOG(DEBUG) << "Unpinning migrated object " << object_id;
+  pinned_objects_size_ -= it->second.first->GetSize();
+  pinned_objects_.erase(it);
+  incompressible_objects_.erase(object_id);
+  migrated_objects_.insert(object_id);
+  return true;
+}
+
 void LocalObjectManager::ReleaseFreedObject(const ObjectID &object_id) {
+  if (migrated_objects_.erase(object_id) > 0) {
+    // The node that pinned the object releases it.
+    return;
+  }
   RAY_LOG(DEBUG) << "Unpinning object " << object_id;
-  // The object should be in one of these stats. pinned, spilling, or spilled.
+  // The object should be in one of these stats. pinned, spilling, compressed, or
+  // spilled.
   RAY_CHECK((pinned_objects_.count(object_id) > 0) ||
             (spilled_objects_url_.count(object_id) > 0) ||
-            (objects_pending_spill_.count(object_id) > 0));
+            (objects_pending_spill_.count(object_id) > 0) ||
+            (compressed_objects_.count(object_id) > 0));
   spilled_object_pending_delete_.push(object_id);
   if (pinned_objects_.count(object_id)) {
     pinned_objects_size_ -= pinned_objects_[object_id].first->GetSize();
     pinned_objects_.erase(object_id);
   }
+  incompressible_objects_.erase(object_id);
+  auto compressed_it = compressed_objects_.find(object_id);
+  if (compressed_it != compressed_objects_.end()) {
+    compressed_objects_size_ -= compressed_it->second.data.size();
+    compressed_objects_original_size_ -= compressed_it->second.data_size;
+    compressed_objects_.erase(compressed_it);
+  }
 
   // Try to evict all copies of the object from the cluster.
   if (free_objects_period_ms_ >= 0) {
@@ -112,7 +183,14 @@ void LocalObjectManager::FlushFreeObjects() {
 }
 
 void LocalObjectManager::SpillObjectUptoMaxThroughput() {
-  if (RayConfig::instance().object_spilling_config().empty()) {
+  // Compressing objects is much cheaper than spilling them, and the memory is
+  // freed right away.
+  if (CompressObjectsOfSize(min_spilling_size_)) {
+    return;
+  }
+
+  if (RayConfig::instance().object_spilling_config().empty() &&
+      native_object_spiller_ == nullptr) {
     return;
   }
 
@@ -130,13 +208,168 @@ void LocalObjectManager::SpillObjectUptoMaxThroughput() {
   }
 }
 
+void LocalObjectManager::SpillObjectsToFreeBytes(int64_t num_bytes_to_free) {
+  int64_t num_bytes_to_spill =
+      num_bytes_to_free - static_cast<int64_t>(num_bytes_pending_spill_);
+  if (num_bytes_to_spill <= 0 || CompressObjectsOfSize(num_bytes_to_spill)) {
+    return;
+  }
+
+  if (RayConfig::instance().object_spilling_config().empty() &&
+      native_object_spiller_ == nullptr) {
+    return;
+  }
+
+  while (num_bytes_to_spill > 0) {
+    {
+      absl::MutexLock lock(&mutex_);
+      if (num_active_workers_ >= max_active_workers_) {
+        break;
+      }
+    }
+    const size_t num_bytes_pending_spill = num_bytes_pending_spill_;
+    if (!SpillObjectsOfSize(std::min(num_bytes_to_spill, min_spilling_size_))) {
+      break;
+    }
+    num_bytes_to_spill -=
+        static_cast<int64_t>(num_bytes_pending_spill_ - num_bytes_pending_spill);
+    {
+      absl::MutexLock lock(&mutex_);
+      num_active_workers_ += 1;
+    }
+  }
+}
+
 bool LocalObjectManager::IsSpillingInProgress() {
   absl::MutexLock lock(&mutex_);
   return num_active_workers_ > 0;
 }
 
+bool LocalObjectManager::CompressObjectsOfSize(int64_t num_bytes_to_compress) {
+  if (max_compressed_objects_size_ <= 0 ||
+      compressed_objects_size_ >= max_compressed_objects_size_) {
+    return false;
+  }
+  const int64_t max_object_size =
+      RayConfig::instance().object_compression_max_object_size();
+  const double min_ratio = RayConfig::instance().object_compression_min_ratio();
+
+  std::vector<ObjectID> candidates;
+  for (const auto &entry : pinned_objects_) {
+    const auto &object = entry.second.first;
+    if (object->GetSize() <= max_object_size && object->HasData() &&
+        object->GetData()->Size() > 0 && !incompressible_objects_.contains(entry.first) &&
+        is_plasma_object_spillable_(entry.first)) {
+      candidates.push_back(entry.first);
+    }
+  }
+
+  int64_t bytes_compressed = 0;
+  int64_t num_compressed = 0;
+  for (const auto &object_id : candidates) {
+    if (bytes_compressed > num_bytes_to_compress) {
+      break;
+    }
+    auto it = pinned_objects_.find(object_id);
+    const auto &object = it->second.first;
+    const auto &data = object->GetData();
+    CompressedObject compressed_object;
+    if (!CompressBuffer(*data, &compressed_object.data) ||
+        compressed_object.data.size() * min_ratio > data->Size()) {
+      incompressible_objects_.insert(object_id);
+      continue;
+    }
+    if (compressed_objects_size_ + static_cast<int64_t>(compressed_object.data.size()) >
+        max_compressed_objects_size_) {
+      // The tier is full.
+      break;
+    }
+    compressed_object.data_size = data->Size();
+    if (object->HasMetadata()) {
+      const auto &metadata = object->GetMetadata();
+      compressed_object.metadata.assign(reinterpret_cast<const char *>(metadata->Data()),
+                                        metadata->Size());
+    }
+    compressed_object.owner_address = it->second.second;
+    RAY_LOG(DEBUG) << "Compressed object " << object_id << " from " << data->Size()
+                   << " to " << compressed_object.data.size() << " bytes";
+
+    const auto object_size = object->GetSize();
+    bytes_compressed += object_size;
+    num_compressed++;
+    compressed_objects_size_ += compressed_object.data.size();
+    compressed_objects_original_size_ += compressed_object.data_size;
+    if (on_object_spilled_) {
+      on_object_spilled_(object_id);
+    }
+    // Unpin the object, so that plasma can evict it.
+    pinned_objects_size_ -= object_size;
+    auto owner_address = it->second.second;
+    pinned_objects_.erase(it);
+    compressed_objects_.emplace(object_id, std::move(compressed_object));
+    // The data is in the memory of this node, so other nodes have to restore the
+    // object through this node regardless of the external storage.
+    SendSpilledURLToOwner(object_id, kCompressedObjectURLPrefix + object_id.Hex(),
+                          self_node_id_, object_size, owner_address);
+  }
+
+  if (num_compressed > 0) {
+    compressed_objects_total_ += num_compressed;
+    RAY_LOG(DEBUG) << "Compressed " << num_compressed << " objects of total size "
+                   << bytes_compressed << ", the compression tier now holds "
+                   << compressed_objects_size_ << " bytes";
+  }
+  return num_compressed > 0;
+}
+
+Status LocalObjectManager::RestoreCompressedObject(
+    const ObjectID &object_id, const CompressedObject &compressed_object) {
+  if (restore_object_in_store_ == nullptr) {
+    return Status::NotImplemented("Restoring compressed objects is not supported.");
+  }
+  auto data = std::make_shared<LocalMemoryBuffer>(compressed_object.data_size);
+  if (!DecompressBuffer(compressed_object.data, data->Data(), data->Size())) {
+    return Status::Invalid("Failed to decompress object " + object_id.Hex());
+  }
+  std::shared_ptr<Buffer> metadata;
+  if (!compressed_object.metadata.empty()) {
+    metadata = std::make_shared<LocalMemoryBuffer>(compressed_object.metadata.size());
+    std::memcpy(metadata->Data(), compressed_object.metadata.data(),
+                compressed_object.metadata.size());
+  }
+  RayObject object(data, metadata, {});
+  auto status = restore_object_in_store_(object_id, compressed_object.owner_address,
+                                         object);
+  if (status.ok()) {
+    decompressed_objects_total_++;
+  }
+  return status;
+}
+
+std::shared_ptr<IObjectReader> LocalObjectManager::ReadCompressedObject(
+    const ObjectID &object_id) {
+  auto it = compressed_objects_.find(object_id);
+  if (it == compressed_objects_.end()) {
+    return nullptr;
+  }
+  const auto &compressed_object = it->second;
+  auto data = std::make_shared<LocalMemoryBuffer>(compressed_object.data_size);
+  if (!DecompressBuffer(compressed_object.data, data->Data(), data->Size())) {
+    RAY_LOG(ERROR) << "Failed to decompress object " << object_id << " for a push.";
+    return nullptr;
+  }
+  auto metadata = std::make_shared<LocalMemoryBuffer>(compressed_object.metadata.size());
+  if (!compressed_object.metadata.empty()) {
+    std::memcpy(metadata->Data(), compressed_object.metadata.data(),
+                compressed_object.metadata.size());
+  }
+  return std::make_shared<MemoryObjectReader>(std::move(data), std::move(metadata),
+                                              compressed_object.owner_address);
+}
+
 bool LocalObjectManager::SpillObjectsOfSize(int64_t num_bytes_to_spill) {
-  if (RayConfig::instance().object_spilling_config().empty()) {
+  if (RayConfig::instance().object_spilling_config().empty() &&
+      native_object_spiller_ == nullptr) {
     return false;
   }
 
@@ -233,6 +466,10 @@ void LocalObjectManager::SpillObjectsInternal(
     }
     return;
   }
+  if (native_object_spiller_ != nullptr) {
+    SpillObjectsNatively(objects_to_spill, callback);
+    return;
+  }
   io_worker_pool_.PopSpillWorker(
       [this, objects_to_spill, callback](std::shared_ptr<WorkerInterface> io_worker) {
         rpc::SpillObjectsRequest request;
@@ -251,34 +488,73 @@ void LocalObjectManager::SpillObjectsInternal(
                 num_active_workers_ -= 1;
               }
               io_worker_pool_.PushSpillWorker(io_worker);
-              size_t num_objects_spilled = status.ok() ? r.spilled_objects_url_size() : 0;
-              // Object spilling is always done in the order of the request.
-              // For example, if an object succeeded, it'll guarentee that all objects
-              // before this will succeed.
-              RAY_CHECK(num_objects_spilled <= objects_to_spill.size());
-              for (size_t i = num_objects_spilled; i != objects_to_spill.size(); ++i) {
-                const auto &object_id = objects_to_spill[i];
-                auto it = objects_pending_spill_.find(object_id);
-                RAY_CHECK(it != objects_pending_spill_.end());
-                pinned_objects_size_ += it->second.first->GetSize();
-                num_bytes_pending_spill_ -= it->second.first->GetSize();
-                pinned_objects_.emplace(object_id, std::move(it->second));
-                objects_pending_spill_.erase(it);
-              }
-
               if (!status.ok()) {
                 RAY_LOG(ERROR) << "Failed to send object spilling request: "
                                << status.ToString();
-              } else {
-                OnObjectSpilled(objects_to_spill, r);
-              }
-              if (callback) {
-                callback(status);
               }
+              OnSpillObjectsDone(objects_to_spill, status, r, callback);
             });
       });
 }
 
+void LocalObjectManager::SpillObjectsNatively(
+    const std::vector<ObjectID> &objects_to_spill,
+    std::function<void(const ray::Status &)> callback) {
+  std::vector<const RayObject *> objects;
+  std::vector<rpc::Address> owner_addresses;
+  for (const auto &object_id : objects_to_spill) {
+    auto it = objects_pending_spill_.find(object_id);
+    RAY_CHECK(it != objects_pending_spill_.end());
+    // The objects stay in objects_pending_spill_ until the spill is done.
+    objects.push_back(it->second.first.get());
+    owner_addresses.push_back(it->second.second);
+  }
+  native_object_spiller_->SpillObjects(
+      objects_to_spill, objects, owner_addresses,
+      [this, objects_to_spill, callback](const ray::Status &status,
+                                         const std::vector<std::string> &urls) {
+        {
+          absl::MutexLock lock(&mutex_);
+          num_active_workers_ -= 1;
+        }
+        if (!status.ok()) {
+          RAY_LOG(ERROR) << "Failed to spill objects: " << status.ToString();
+        }
+        rpc::SpillObjectsReply reply;
+        for (const auto &url : urls) {
+          reply.add_spilled_objects_url(url);
+        }
+        OnSpillObjectsDone(objects_to_spill, status, reply, callback);
+      });
+}
+
+void LocalObjectManager::OnSpillObjectsDone(
+    const std::vector<ObjectID> &objects_to_spill, const ray::Status &status,
+    const rpc::SpillObjectsReply &reply,
+    std::function<void(const ray::Status &)> callback) {
+  size_t num_objects_spilled = status.ok() ? reply.spilled_objects_url_size() : 0;
+  // Object spilling is always done in the order of the request.
+  // For example, if an object succeeded, it'll guarentee that all objects
+  // before this will succeed.
+  RAY_CHECK(num_objects_spilled <= objects_to_spill.size());
+  for (size_t i = num_objects_spilled; i != objects_to_spill.size(); ++i) {
+    const auto &object_id = objects_to_spill[i];
+    auto it = objects_pending_spill_.find(object_id);
+    RAY_CHECK(it != objects_pending_spill_.end());
+    pinned_objects_size_ += it->second.first->GetSize();
+    num_bytes_pending_spill_ -= it->second.first->GetSize();
+    pinned_objects_.emplace(object_id, std::move(it->second));
+    objects_pending_spill_.erase(it);
+  }
+
+  if (status.ok()) {
+    OnObjectSpilled(objects_to_spill, reply);
+  }
+  if (callback) {
+    callback(status);
+  }
+}
+
 void LocalObjectManager::OnObjectSpilled(const std::vector<ObjectID> &object_ids,
                                          const rpc::SpillObjectsReply &worker_reply) {
   for (size_t i = 0; i < static_cast<size_t>(worker_reply.spilled_objects_url_size());
@@ -291,22 +567,18 @@ void LocalObjectManager::OnObjectSpilled(const std::vector<ObjectID> &object_ids
     const auto node_id_object_spilled =
         is_external_storage_type_fs_ ? self_node_id_ : NodeID::Nil();
 
-    // Update the object_id -> url_ref_count to use it for deletion later.
+    // Track the objects of the file to use it for deletion later.
     // We need to track the references here because a single file can contain
     // multiple objects, and we shouldn't delete the file until
     // all the objects are gone out of scope.
     // object_url is equivalent to url_with_offset.
-    auto parsed_url = ParseURL(object_url);
-    const auto base_url_it = parsed_url->find("url");
-    RAY_CHECK(base_url_it != parsed_url->end());
-    if (!url_ref_count_.contains(base_url_it->second)) {
-      url_ref_count_[base_url_it->second] = 1;
-    } else {
-      url_ref_count_[base_url_it->second] += 1;
-    }
+    AddToSpilledFile(object_id, object_url);
 
     // Mark that the object is spilled and unpin the pending requests.
     spilled_objects_url_.emplace(object_id, object_url);
+    if (on_object_spilled_) {
+      on_object_spilled_(object_id);
+    }
     RAY_LOG(DEBUG) << "Unpinning pending spill object " << object_id;
     auto it = objects_pending_spill_.find(object_id);
     RAY_CHECK(it != objects_pending_spill_.end());
@@ -314,36 +586,49 @@ void LocalObjectManager::OnObjectSpilled(const std::vector<ObjectID> &object_ids
     const auto worker_addr = it->second.second;
     num_bytes_pending_spill_ -= object_size;
     objects_pending_spill_.erase(it);
+    incompressible_objects_.erase(object_id);
 
     // Asynchronously Update the spilled URL.
-    rpc::AddSpilledUrlRequest request;
-    request.set_object_id(object_id.Binary());
-    request.set_spilled_url(object_url);
-    request.set_spilled_node_id(node_id_object_spilled.Binary());
-    request.set_size(object_size);
-
-    auto owner_client = owner_client_pool_.GetOrConnect(worker_addr);
-    RAY_LOG(DEBUG) << "Sending spilled URL " << object_url << " for object " << object_id
-                   << " to owner " << WorkerID::FromBinary(worker_addr.worker_id());
-    owner_client->AddSpilledUrl(
-        request,
-        [object_id, object_url](Status status, const rpc::AddSpilledUrlReply &reply) {
-          // TODO(sang): Currently we assume there's no network failure. We should handle
-          // it properly.
-          if (!status.ok()) {
-            RAY_LOG(DEBUG)
-                << "Failed to send spilled url for object " << object_id
-                << " to object directory, considering the object to have been freed: "
-                << status.ToString();
-          } else {
-            RAY_LOG(DEBUG) << "Object " << object_id << " spilled to " << object_url
-                           << " and object directory has been informed";
-          }
-        });
+    SendSpilledURLToOwner(object_id, object_url, node_id_object_spilled, object_size,
+                          worker_addr);
   }
 }
 
+void LocalObjectManager::SendSpilledURLToOwner(const ObjectID &object_id,
+                                               const std::string &object_url,
+                                               const NodeID &spilled_node_id,
+                                               int64_t object_size,
+                                               const rpc::Address &owner_address) {
+  rpc::AddSpilledUrlRequest request;
+  request.set_object_id(object_id.Binary());
+  request.set_spilled_url(object_url);
+  request.set_spilled_node_id(spilled_node_id.Binary());
+  request.set_size(object_size);
+
+  auto owner_client = owner_client_pool_.GetOrConnect(owner_address);
+  RAY_LOG(DEBUG) << "Sending spilled URL " << object_url << " for object " << object_id
+                 << " to owner " << WorkerID::FromBinary(owner_address.worker_id());
+  owner_client->AddSpilledUrl(
+      request,
+      [object_id, object_url](Status status, const rpc::AddSpilledUrlReply &reply) {
+        // TODO(sang): Currently we assume there's no network failure. We should handle
+        // it properly.
+        if (!status.ok()) {
+          RAY_LOG(DEBUG)
+              << "Failed to send spilled url for object " << object_id
+              << " to object directory, considering the object to have been freed: "
+              << status.ToString();
+        } else {
+          RAY_LOG(DEBUG) << "Object " << object_id << " spilled to " << object_url
+                         << " and object directory has been informed";
+        }
+      });
+}
+
 std::string LocalObjectManager::GetLocalSpilledObjectURL(const ObjectID &object_id) {
+  if (compressed_objects_.contains(object_id)) {
+    return kCompressedObjectURLPrefix + object_id.Hex();
+  }
   if (!is_external_storage_type_fs_) {
     // If the external storage is cloud storage like S3, returns the empty string.
     // In that case, the URL is supposed to be obtained by OBOD.
@@ -360,6 +645,26 @@ std::string LocalObjectManager::GetLocalSpilledObjectURL(const ObjectID &object_
 void LocalObjectManager::AsyncRestoreSpilledObject(
     const ObjectID &object_id, const std::string &object_url,
     std::function<void(const ray::Status &)> callback) {
+  auto compressed_it = compressed_objects_.find(object_id);
+  if (compressed_it != compressed_objects_.end()) {
+    auto status = RestoreCompressedObject(object_id, compressed_it->second);
+    if (!status.ok()) {
+      RAY_LOG(ERROR) << "Failed to restore compressed object " << object_id << ": "
+                     << status.ToString();
+    }
+    if (callback) {
+      callback(status);
+    }
+    return;
+  }
+  if (absl::StartsWith(object_url, kCompressedObjectURLPrefix)) {
+    // The object was freed while the restore request was in flight.
+    if (callback) {
+      callback(Status::ObjectNotFound("The compressed object was already freed."));
+    }
+    return;
+  }
+
   if (objects_pending_restore_.count(object_id) > 0) {
     // If the same object is restoring, we dedup here.
     return;
@@ -367,6 +672,10 @@ void LocalObjectManager::AsyncRestoreSpilledObject(
 
   RAY_CHECK(objects_pending_restore_.emplace(object_id).second)
       << "Object dedupe wasn't done properly. Please report if you see this issue.";
+  if (native_object_spiller_ != nullptr) {
+    RestoreObjectNatively(object_id, object_url, callback);
+    return;
+  }
   io_worker_pool_.PopRestoreWorker([this, object_id, object_url, callback](
                                        std::shared_ptr<WorkerInterface> io_worker) {
     auto start_time = absl::GetCurrentTimeNanos();
@@ -384,26 +693,8 @@ void LocalObjectManager::AsyncRestoreSpilledObject(
             RAY_LOG(ERROR) << "Failed to send restore spilled object request: "
                            << status.ToString();
           } else {
-            auto now = absl::GetCurrentTimeNanos();
-            auto restored_bytes = r.bytes_restored_total();
-            RAY_LOG(DEBUG) << "Restored " << restored_bytes << " in "
-                           << (now - start_time) / 1e6 << "ms. Object id:" << object_id;
-            restored_bytes_total_ += restored_bytes;
-            restored_objects_total_ += 1;
-            // Adjust throughput timing to account for concurrent restore operations.
-            restore_time_total_s_ +=
-                (now - std::max(start_time, last_restore_finish_ns_)) / 1e9;
-            if (now - last_restore_log_ns_ > 1e9) {
-              last_restore_log_ns_ = now;
-              RAY_LOG(INFO) << "Restored "
-                            << static_cast<int>(restored_bytes_total_ / (1024 * 1024))
-                            << " MiB, " << restored_objects_total_
-                            << " objects, read throughput "
-                            << static_cast<int>(restored_bytes_total_ / (1024 * 1024) /
-                                                restore_time_total_s_)
-                            << " MiB/s";
-            }
-            last_restore_finish_ns_ = now;
+            RAY_LOG(DEBUG) << "Restored object " << object_id;
+            RecordObjectRestored(start_time, r.bytes_restored_total());
           }
           if (callback) {
             callback(status);
@@ -412,6 +703,57 @@ void LocalObjectManager::AsyncRestoreSpilledObject(
   });
 }
 
+void LocalObjectManager::RestoreObjectNatively(
+    const ObjectID &object_id, const std::string &object_url,
+    std::function<void(const ray::Status &)> callback) {
+  auto start_time = absl::GetCurrentTimeNanos();
+  // The file of the object may have been compacted since the URL was handed out.
+  const auto spilled_objects_url_it = spilled_objects_url_.find(object_id);
+  native_object_spiller_->RestoreObject(
+      spilled_objects_url_it != spilled_objects_url_.end()
+          ? spilled_objects_url_it->second
+          : object_url, [this, start_time, object_id, callback](
+                      const ray::Status &read_status, std::shared_ptr<RayObject> object,
+                      const rpc::Address &owner_address) {
+        objects_pending_restore_.erase(object_id);
+        auto status = read_status;
+        if (status.ok()) {
+          status = restore_object_in_store_(object_id, owner_address, *object);
+        }
+        if (!status.ok()) {
+          RAY_LOG(ERROR) << "Failed to restore spilled object " << object_id << ": "
+                         << status.ToString();
+        } else {
+          RAY_LOG(DEBUG) << "Restored object " << object_id;
+          RecordObjectRestored(start_time, object->GetData()->Size());
+        }
+        if (callback) {
+          callback(status);
+        }
+      });
+}
+
+void LocalObjectManager::RecordObjectRestored(int64_t start_time,
+                                              int64_t restored_bytes) {
+  auto now = absl::GetCurrentTimeNanos();
+  RAY_LOG(DEBUG) << "Restored " << restored_bytes << " in " << (now - start_time) / 1e6
+                 << "ms";
+  restored_bytes_total_ += restored_bytes;
+  restored_objects_total_ += 1;
+  // Adjust throughput timing to account for concurrent restore operations.
+  restore_time_total_s_ += (now - std::max(start_time, last_restore_finish_ns_)) / 1e9;
+  if (now - last_restore_log_ns_ > 1e9) {
+    last_restore_log_ns_ = now;
+    RAY_LOG(INFO) << "Restored "
+                  << static_cast<int>(restored_bytes_total_ / (1024 * 1024)) << " MiB, "
+                  << restored_objects_total_ << " objects, read throughput "
+                  << static_cast<int>(restored_bytes_total_ / (1024 * 1024) /
+                                      restore_time_total_s_)
+                  << " MiB/s";
+  }
+  last_restore_finish_ns_ = now;
+}
+
 void LocalObjectManager::ProcessSpilledObjectsDeleteQueue(uint32_t max_batch_size) {
   std::vector<std::string> object_urls_to_delete;
   // Process upto batch size of objects to delete.
@@ -429,26 +771,9 @@ void LocalObjectManager::ProcessSpilledObjectsDeleteQueue(uint32_t max_batch_siz
     // Object id is either spilled or not spilled at this point.
     const auto spilled_objects_url_it = spilled_objects_url_.find(object_id);
     if (spilled_objects_url_it != spilled_objects_url_.end()) {
-      // If the object was spilled, see if we can delete it. We should first check the
-      // ref count.
-      std::string &object_url = spilled_objects_url_it->second;
-      // Note that here, we need to parse the object url to obtain the base_url.
-      auto parsed_url = ParseURL(object_url);
-      const auto base_url_it = parsed_url->find("url");
-      RAY_CHECK(base_url_it != parsed_url->end());
-      const auto &url_ref_count_it = url_ref_count_.find(base_url_it->second);
-      RAY_CHECK(url_ref_count_it != url_ref_count_.end())
-          << "url_ref_count_ should exist when spilled_objects_url_ exists. Please "
-             "submit a Github issue if you see this error.";
-      url_ref_count_it->second -= 1;
-
-      // If there's no more refs, delete the object.
-      if (url_ref_count_it->second == 0) {
-        url_ref_count_.erase(url_ref_count_it);
-        RAY_LOG(DEBUG) << "The URL " << object_url
-                       << " is deleted because the references are out of scope.";
-        object_urls_to_delete.emplace_back(object_url);
-      }
+      // If the object was spilled, see if we can delete its file.
+      RemoveFromSpilledFile(object_id, spilled_objects_url_it->second,
+                            &object_urls_to_delete);
       spilled_objects_url_.erase(spilled_objects_url_it);
     }
     spilled_object_pending_delete_.pop();
@@ -458,7 +783,160 @@ void LocalObjectManager::ProcessSpilledObjectsDeleteQueue(uint32_t max_batch_siz
   }
 }
 
+void LocalObjectManager::AddToSpilledFile(const ObjectID &object_id,
+                                          const std::string &object_url) {
+  auto parsed_url = ParseURL(object_url);
+  const auto base_url_it = parsed_url->find("url");
+  RAY_CHECK(base_url_it != parsed_url->end());
+  auto &spilled_file = spilled_files_[base_url_it->second];
+  spilled_file.objects.insert(object_id);
+  spilled_file.total_bytes += std::strtoll((*parsed_url)["size"].c_str(), nullptr, 10);
+}
+
+void LocalObjectManager::RemoveFromSpilledFile(const ObjectID &object_id,
+                                               const std::string &object_url,
+                                               std::vector<std::string> *urls_to_delete) {
+  // Note that here, we need to parse the object url to obtain the base_url.
+  auto parsed_url = ParseURL(object_url);
+  const auto base_url_it = parsed_url->find("url");
+  RAY_CHECK(base_url_it != parsed_url->end());
+  const auto spilled_file_it = spilled_files_.find(base_url_it->second);
+  RAY_CHECK(spilled_file_it != spilled_files_.end())
+      << "spilled_files_ should exist when spilled_objects_url_ exists. Please "
+         "submit a Github issue if you see this error.";
+  auto &spilled_file = spilled_file_it->second;
+  RAY_CHECK(spilled_file.objects.erase(object_id) == 1);
+  const int64_t object_size =
+      std::strtoll((*parsed_url)["size"].c_str(), nullptr, 10);
+  spilled_file.dead_bytes += object_size;
+  spilled_files_dead_bytes_ += object_size;
+
+  // If there's no more objects, delete the file.
+  if (spilled_file.objects.empty()) {
+    spilled_files_dead_bytes_ -= spilled_file.dead_bytes;
+    spilled_files_.erase(spilled_file_it);
+    RAY_LOG(DEBUG) << "The URL " << object_url
+                   << " is deleted because the references are out of scope.";
+    urls_to_delete->emplace_back(object_url);
+  } else {
+    MaybeCompactSpilledFile(base_url_it->second);
+  }
+}
+
+void LocalObjectManager::MaybeCompactSpilledFile(const std::string &base_url) {
+  // Only the native spiller can read the objects back without restoring them
+  // into plasma.
+  if (native_object_spiller_ == nullptr || spilled_file_compaction_dead_ratio_ <= 0) {
+    return;
+  }
+  auto &spilled_file = spilled_files_[base_url];
+  if (spilled_file.compacting ||
+      spilled_file.dead_bytes <
+          spilled_file_compaction_dead_ratio_ * spilled_file.total_bytes) {
+    return;
+  }
+  spilled_file.compacting = true;
+  CompactSpilledFile(base_url);
+}
+
+void LocalObjectManager::CompactSpilledFile(const std::string &base_url) {
+  const auto &spilled_file = spilled_files_[base_url];
+  RAY_LOG(DEBUG) << "Compacting spilled file " << base_url << ", "
+                 << spilled_file.dead_bytes << " of " << spilled_file.total_bytes
+                 << " bytes are freed";
+  std::vector<ObjectID> object_ids(spilled_file.objects.begin(),
+                                   spilled_file.objects.end());
+  // Read all the remaining objects of the file, and rewrite them at once.
+  auto objects =
+      std::make_shared<std::vector<std::pair<std::shared_ptr<RayObject>, rpc::Address>>>(
+          object_ids.size());
+  auto num_pending = std::make_shared<size_t>(object_ids.size());
+  auto read_status = std::make_shared<Status>();
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    native_object_spiller_->RestoreObject(
+        spilled_objects_url_[object_ids[i]],
+        [this, base_url, object_ids, objects, num_pending, read_status, i](
+            const ray::Status &status, std::shared_ptr<RayObject> object,
+            const rpc::Address &owner_address) {
+          if (status.ok()) {
+            (*objects)[i] = std::make_pair(std::move(object), owner_address);
+          } else {
+            *read_status = status;
+          }
+          if (--*num_pending > 0) {
+            return;
+          }
+          if (!read_status->ok()) {
+            OnSpilledFileCompacted(base_url, object_ids, *objects, *read_status, {});
+            return;
+          }
+          std::vector<const RayObject *> object_ptrs;
+          std::vector<rpc::Address> owner_addresses;
+          for (const auto &object : *objects) {
+            object_ptrs.push_back(object.first.get());
+            owner_addresses.push_back(object.second);
+          }
+          native_object_spiller_->SpillObjects(
+              object_ids, object_ptrs, owner_addresses,
+              [this, base_url, object_ids, objects](
+                  const ray::Status &status, const std::vector<std::string> &urls) {
+                OnSpilledFileCompacted(base_url, object_ids, *objects, status, urls);
+              });
+        });
+  }
+}
+
+void LocalObjectManager::OnSpilledFileCompacted(
+    const std::string &base_url, const std::vector<ObjectID> &object_ids,
+    const std::vector<std::pair<std::shared_ptr<RayObject>, rpc::Address>> &objects,
+    const ray::Status &status, const std::vector<std::string> &urls) {
+  if (!status.ok()) {
+    RAY_LOG(WARNING) << "Failed to compact spilled file " << base_url << ": "
+                     << status.ToString();
+    auto spilled_file_it = spilled_files_.find(base_url);
+    if (spilled_file_it != spilled_files_.end()) {
+      spilled_file_it->second.compacting = false;
+    }
+    return;
+  }
+  RAY_CHECK(urls.size() == object_ids.size());
+  const auto node_id_object_spilled =
+      is_external_storage_type_fs_ ? self_node_id_ : NodeID::Nil();
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    AddToSpilledFile(object_ids[i], urls[i]);
+  }
+  std::vector<std::string> urls_to_delete;
+  std::vector<size_t> freed_indices;
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    const auto &object_id = object_ids[i];
+    auto it = spilled_objects_url_.find(object_id);
+    if (it == spilled_objects_url_.end() || (*ParseURL(it->second))["url"] != base_url) {
+      freed_indices.push_back(i);
+      continue;
+    }
+    // Point the object to its new copy before the old file goes away, restores
+    // from now on read the new file.
+    RemoveFromSpilledFile(object_id, it->second, &urls_to_delete);
+    it->second = urls[i];
+    SendSpilledURLToOwner(object_id, urls[i], node_id_object_spilled,
+                          objects[i].first->GetSize(), objects[i].second);
+  }
+  // The objects that were freed while the file was compacted are already dead
+  // in the new file.
+  for (size_t i : freed_indices) {
+    RemoveFromSpilledFile(object_ids[i], urls[i], &urls_to_delete);
+  }
+  compacted_files_total_++;
+  if (!urls_to_delete.empty()) {
+    DeleteSpilledObjects(urls_to_delete);
+  }
+}
+
 void LocalObjectManager::DeleteSpilledObjects(std::vector<std::string> &urls_to_delete) {
+  if (native_object_spiller_ != nullptr) {
+    native_object_spiller_->DeleteSpilledObjects(urls_to_delete);
+    return;
+  }
   io_worker_pool_.PopDeleteWorker(
       [this, urls_to_delete](std::shared_ptr<WorkerInterface> io_worker) {
         RAY_LOG(DEBUG) << "Sending delete spilled object request. Length: "
@@ -511,6 +989,16 @@ std::string LocalObjectManager::DebugString() const {
   result << "- num bytes pending spill: " << num_bytes_pending_spill_ << "\n";
   result << "- cumulative spill requests: " << spilled_objects_total_ << "\n";
   result << "- cumulative restore requests: " << restored_objects_total_ << "\n";
+  result << "- num compressed objects: " << compressed_objects_.size() << "\n";
+  result << "- compressed objects size: " << compressed_objects_size_ << "\n";
+  result << "- compressed objects original size: " << compressed_objects_original_size_
+         << "\n";
+  result << "- cumulative compressed objects: " << compressed_objects_total_ << "\n";
+  result << "- cumulative decompressed objects: " << decompressed_objects_total_
+         << "\n";
+  result << "- num spilled files: " << spilled_files_.size() << "\n";
+  result << "- freed bytes in spilled files: " << spilled_files_dead_bytes_ << "\n";
+  result << "- cumulative compacted spilled files: " << compacted_files_total_ << "\n";
   return result.str();
 }
 
@@ -17,12 +17,15 @@
 #include <google/protobuf/repeated_field.h>
 
 #include <functional>
+#include <tuple>
 
 #include "ray/common/id.h"
 #include "ray/common/ray_object.h"
 #include "ray/gcs/accessor.h"
 #include "ray/object_manager/common.h"
+#include "ray/object_manager/memory_object_reader.h"
 #include "ray/pubsub/subscriber.h"
+#include "ray/raylet/native_object_spiller.h"
 #include "ray/raylet/worker_pool.h"
 #include "ray/rpc/worker/core_worker_client_pool.h"
 #include "ray/util/util.h"
@@ -34,8 +37,24 @@ namespace raylet {
 
 /// This class implements memory management for primary objects, objects that
 /// have been freed, and objects that have been spilled.
+///
+/// Before objects are spilled to external storage, primary copies that compress
+/// well are compressed into the memory of the raylet (the compression tier). They
+/// are reported to their owners like spilled objects, and restored back into
+/// plasma directly instead of through an IO worker.
+///
+/// Objects are spilled, restored and deleted by IO workers, unless a native
+/// spiller is given, which does the file IO in the raylet itself. With a native
+/// spiller, files of fused objects that are mostly freed are compacted, by
+/// rewriting their remaining objects into a new file.
 class LocalObjectManager {
  public:
+  /// Create an object in plasma from the given data. Returns an error if the
+  /// object couldn't be created.
+  using RestoreObjectInStoreCallback = std::function<Status(
+      const ObjectID &object_id, const rpc::Address &owner_address,
+      const RayObject &object)>;
+
   LocalObjectManager(
       const NodeID &node_id, std::string self_node_address, int self_node_port,
       size_t free_objects_batch_size, int64_t free_objects_period_ms,
@@ -46,7 +65,12 @@ class LocalObjectManager {
       int64_t max_fused_object_count,
       std::function<void(const std::vector<ObjectID> &)> on_objects_freed,
       std::function<bool(const ray::ObjectID &)> is_plasma_object_spillable,
-      pubsub::SubscriberInterface *core_worker_subscriber)
+      pubsub::SubscriberInterface *core_worker_subscriber,
+      int64_t max_compressed_objects_size = 0,
+      RestoreObjectInStoreCallback restore_object_in_store = nullptr,
+      NativeObjectSpiller *native_object_spiller = nullptr,
+      double spilled_file_compaction_dead_ratio = 0,
+      std::function<void(const ObjectID &)> on_object_spilled = nullptr)
       : self_node_id_(node_id),
         self_node_address_(self_node_address),
         self_node_port_(self_node_port),
@@ -63,7 +87,15 @@ class LocalObjectManager {
         is_plasma_object_spillable_(is_plasma_object_spillable),
         is_external_storage_type_fs_(is_external_storage_type_fs),
         max_fused_object_count_(max_fused_object_count),
-        core_worker_subscriber_(core_worker_subscriber) {}
+        core_worker_subscriber_(core_worker_subscriber),
+        max_compressed_objects_size_(max_compressed_objects_size),
+        restore_object_in_store_(restore_object_in_store),
+        native_object_spiller_(native_object_spiller),
+        spilled_file_compaction_dead_ratio_(spilled_file_compaction_dead_ratio),
+        on_object_spilled_(on_object_spilled) {
+    RAY_CHECK(native_object_spiller_ == nullptr || restore_object_in_store_ != nullptr)
+        << "Native object spilling needs to restore objects into plasma.";
+  }
 
   /// Pin objects.
   ///
@@ -84,11 +116,33 @@ class LocalObjectManager {
   void WaitForObjectFree(const rpc::Address &owner_address,
                          const std::vector<ObjectID> &object_ids);
 
-  /// Spill objects as much as possible as fast as possible up to the max throughput.
+  /// Get the objects whose primary copies are pinned on this node, excluding the
+  /// ones being spilled.
+  ///
+  /// \return The objects with their owners and sizes.
+  std::vector<std::tuple<ObjectID, rpc::Address, int64_t>> GetPinnedObjects() const;
+
+  /// Unpin the primary copy of an object after another node pinned the object as its
+  /// primary copy. The local copy can then be evicted, but unlike for a freed object,
+  /// the copies on other nodes are kept.
   ///
-  /// \return True if spilling is in progress.
+  /// \param object_id The migrated object.
+  /// \return Whether the object was still pinned on this node.
+  bool UnpinMigratedObject(const ObjectID &object_id);
+
+  /// Spill objects as much as possible as fast as possible up to the max throughput.
+  /// If objects can be compressed into the compression tier instead, only those
+  /// are compressed.
   void SpillObjectUptoMaxThroughput();
 
+  /// Spill objects until the given number of bytes, including the bytes that are
+  /// already being spilled, are being spilled, or until all spill workers are
+  /// busy. If objects can be compressed into the compression tier instead, only
+  /// those are compressed.
+  ///
+  /// \param num_bytes_to_free The number of bytes to free from the object store.
+  void SpillObjectsToFreeBytes(int64_t num_bytes_to_free);
+
   /// Spill objects to external storage.
   ///
   /// \param objects_ids_to_spill The objects to be spilled.
@@ -142,10 +196,19 @@ class LocalObjectManager {
 
   /// Return the spilled object URL if the object is spilled locally,
   /// or the empty string otherwise.
-  /// If the external storage is cloud, this will always return an empty string.
-  /// In that case, the URL is supposed to be obtained by the object directory.
+  /// If the external storage is cloud, this will always return an empty string
+  /// unless the object is in the compression tier. In that case, the URL is
+  /// supposed to be obtained by the object directory.
   std::string GetLocalSpilledObjectURL(const ObjectID &object_id);
 
+  /// Decompress an object of the compression tier into the memory of the raylet,
+  /// so that it can be pushed to other nodes without restoring it into plasma.
+  ///
+  /// \param object_id The ID of the object.
+  /// \return A reader over the decompressed object, or nullptr if the object is
+  /// not in the compression tier.
+  std::shared_ptr<IObjectReader> ReadCompressedObject(const ObjectID &object_id);
+
   std::string DebugString() const;
 
  private:
@@ -155,6 +218,30 @@ class LocalObjectManager {
               TestSpillObjectsOfSizeNumBytesToSpillHigherThanMinBytesToSpill);
   FRIEND_TEST(LocalObjectManagerTest, TestSpillObjectNotEvictable);
 
+  /// A primary copy that is held compressed in the memory of the raylet.
+  struct CompressedObject {
+    /// The compressed data of the object.
+    std::string data;
+    /// The size of the data before compression.
+    int64_t data_size;
+    /// The metadata of the object, which is not compressed.
+    std::string metadata;
+    /// The owner of the object.
+    rpc::Address owner_address;
+  };
+
+  /// A spilled file, which may contain multiple fused objects.
+  struct SpilledFile {
+    /// The objects in the file that are not freed yet.
+    absl::flat_hash_set<ObjectID> objects;
+    /// The total size of the objects in the file.
+    int64_t total_bytes = 0;
+    /// The size of the objects in the file that were freed.
+    int64_t dead_bytes = 0;
+    /// Whether the objects of the file are being rewritten into a new file.
+    bool compacting = false;
+  };
+
   /// Asynchronously spill objects when space is needed.
   /// The callback tries to spill objects as much as num_bytes_to_spill and returns
   /// true if we could spill the corresponding bytes.
@@ -164,6 +251,16 @@ class LocalObjectManager {
   /// \return True if it can spill num_bytes_to_spill. False otherwise.
   bool SpillObjectsOfSize(int64_t num_bytes_to_spill);
 
+  /// Compress pinned objects into the compression tier and unpin them.
+  ///
+  /// \param num_bytes_to_compress The total number of bytes of objects to compress.
+  /// \return True if any object was compressed.
+  bool CompressObjectsOfSize(int64_t num_bytes_to_compress);
+
+  /// Create a compressed object in plasma again.
+  Status RestoreCompressedObject(const ObjectID &object_id,
+                                 const CompressedObject &compressed_object);
+
   /// Internal helper method for spilling objects.
   void SpillObjectsInternal(const std::vector<ObjectID> &objects_ids,
                             std::function<void(const ray::Status &)> callback);
@@ -171,6 +268,28 @@ class LocalObjectManager {
   /// Release an object that has been freed by its owner.
   void ReleaseFreedObject(const ObjectID &object_id);
 
+  /// Hand the objects that are pending spill to the native spiller.
+  void SpillObjectsNatively(const std::vector<ObjectID> &objects_to_spill,
+                            std::function<void(const ray::Status &)> callback);
+
+  /// Put the objects that failed to spill back to the pinned objects and
+  /// report the spilled ones.
+  ///
+  /// \param objects_to_spill The objects of the spill request, in order.
+  /// \param status The status of the spill request.
+  /// \param reply The URLs of the objects that were spilled.
+  /// \param callback The callback of the spill request.
+  void OnSpillObjectsDone(const std::vector<ObjectID> &objects_to_spill,
+                          const ray::Status &status, const rpc::SpillObjectsReply &reply,
+                          std::function<void(const ray::Status &)> callback);
+
+  /// Restore a spilled object with the native spiller.
+  void RestoreObjectNatively(const ObjectID &object_id, const std::string &object_url,
+                             std::function<void(const ray::Status &)> callback);
+
+  /// Update the restore stats after an object has been restored.
+  void RecordObjectRestored(int64_t start_time, int64_t restored_bytes);
+
   /// Do operations that are needed after spilling objects such as
   /// 1. Unpin the pending spilling object.
   /// 2. Update the spilled URL to the owner.
@@ -179,6 +298,44 @@ class LocalObjectManager {
   void OnObjectSpilled(const std::vector<ObjectID> &object_ids,
                        const rpc::SpillObjectsReply &worker_reply);
 
+  /// Asynchronously tell the owner of an object where the object was spilled.
+  void SendSpilledURLToOwner(const ObjectID &object_id, const std::string &object_url,
+                             const NodeID &spilled_node_id, int64_t object_size,
+                             const rpc::Address &owner_address);
+
+  /// Add a spilled object to the file that it is spilled in.
+  ///
+  /// \param object_id The ID of the spilled object.
+  /// \param object_url The URL of the object, with the offset and size in the file.
+  void AddToSpilledFile(const ObjectID &object_id, const std::string &object_url);
+
+  /// Remove a freed object from the file that it is spilled in.
+  ///
+  /// \param object_id The ID of the freed object.
+  /// \param object_url The URL of the object, with the offset and size in the file.
+  /// \param urls_to_delete The URL is appended here if the file can be deleted.
+  void RemoveFromSpilledFile(const ObjectID &object_id, const std::string &object_url,
+                             std::vector<std::string> *urls_to_delete);
+
+  /// Start compacting the file if enough of it belongs to freed objects.
+  void MaybeCompactSpilledFile(const std::string &base_url);
+
+  /// Rewrite the objects of the file that are not freed yet into a new file.
+  void CompactSpilledFile(const std::string &base_url);
+
+  /// Point the objects that were rewritten by a compaction to their new URLs, and
+  /// delete the old file.
+  ///
+  /// \param base_url The URL of the compacted file.
+  /// \param object_ids The rewritten objects.
+  /// \param objects The rewritten objects, with their owners.
+  /// \param status The status of the rewrite.
+  /// \param urls The new URLs of the rewritten objects.
+  void OnSpilledFileCompacted(
+      const std::string &base_url, const std::vector<ObjectID> &object_ids,
+      const std::vector<std::pair<std::shared_ptr<RayObject>, rpc::Address>> &objects,
+      const ray::Status &status, const std::vector<std::string> &urls);
+
   /// Delete spilled objects stored in given urls.
   ///
   /// \param urls_to_delete List of urls to delete from external storages.
@@ -214,6 +371,10 @@ class LocalObjectManager {
   // Total size of objects pinned on this node.
   size_t pinned_objects_size_ = 0;
 
+  // Objects that were unpinned because another node pinned them, and that we still
+  // wait for the owner to free.
+  absl::flat_hash_set<ObjectID> migrated_objects_;
+
   // Objects that were pinned on this node but that are being spilled.
   // These objects will be released once spilling is complete and the URL is
   // written to the object directory.
@@ -248,10 +409,13 @@ class LocalObjectManager {
   /// pinned_objects_ entries are deleted when spilling happens.
   absl::flat_hash_map<ObjectID, std::string> spilled_objects_url_;
 
-  /// Base URL -> ref_count. It is used because there could be multiple objects
-  /// within a single spilled file. We need to ref count to avoid deleting the file
+  /// Base URL -> spilled file. It is used because there could be multiple objects
+  /// within a single spilled file. We need to track them to avoid deleting the file
   /// before all objects within that file are out of scope.
-  absl::flat_hash_map<std::string, uint64_t> url_ref_count_;
+  absl::flat_hash_map<std::string, SpilledFile> spilled_files_;
+
+  /// The total size of the freed objects that are still in spilled files.
+  int64_t spilled_files_dead_bytes_ = 0;
 
   /// Minimum bytes to spill to a single IO spill worker.
   int64_t min_spilling_size_;
@@ -283,6 +447,37 @@ class LocalObjectManager {
   /// It is used to subscribe objects to evict.
   pubsub::SubscriberInterface *core_worker_subscriber_;
 
+  /// The maximum total size of the compressed data in the compression tier. 0
+  /// disables the tier.
+  const int64_t max_compressed_objects_size_;
+
+  /// Callback to restore objects from the compression tier into plasma.
+  const RestoreObjectInStoreCallback restore_object_in_store_;
+
+  /// Objects in the compression tier.
+  absl::flat_hash_map<ObjectID, CompressedObject> compressed_objects_;
+
+  /// The total size of the compressed data in the compression tier.
+  int64_t compressed_objects_size_ = 0;
+
+  /// The total size of the objects in the compression tier before compression.
+  int64_t compressed_objects_original_size_ = 0;
+
+  /// Pinned objects that didn't compress well enough for the compression tier.
+  absl::flat_hash_set<ObjectID> incompressible_objects_;
+
+  /// If set, objects are spilled, restored and deleted by the raylet itself
+  /// instead of by IO workers.
+  NativeObjectSpiller *native_object_spiller_;
+
+  /// The fraction of freed bytes above which a spilled file is compacted. 0
+  /// disables compaction.
+  const double spilled_file_compaction_dead_ratio_;
+
+  /// Called when an object was spilled or compressed and is about to be unpinned,
+  /// so that plasma evicts it before the objects that have no other copy.
+  std::function<void(const ObjectID &)> on_object_spilled_;
+
   ///
   /// Stats
   ///
@@ -316,6 +511,15 @@ class LocalObjectManager {
 
   /// The last time a restore log finished.
   int64_t last_restore_log_ns_ = 0;
+
+  /// The total number of objects compressed into the compression tier.
+  int64_t compressed_objects_total_ = 0;
+
+  /// The total number of objects restored from the compression tier.
+  int64_t decompressed_objects_total_ = 0;
+
+  /// The total number of spilled files that were compacted.
+  int64_t compacted_files_total_ = 0;
 };
 
 };  // namespace raylet
@@ -18,6 +18,7 @@
 #include "ray/common/asio/instrumented_io_context.h"
 #include "ray/common/id.h"
 #include "ray/common/ray_config.h"
+#include "ray/common/span_tracer.h"
 #include "ray/common/status.h"
 #include "ray/common/task/task_common.h"
 #include "ray/gcs/gcs_client/service_based_gcs_client.h"
@@ -108,7 +109,7 @@ int main(int argc, char *argv[]) {
   std::unordered_map<std::string, double> static_resource_conf;
 
   // IO Service for node manager.
-  instrumented_io_context main_service;
+  instrumented_io_context main_service("raylet");
 
   // Ensure that the IO service keeps running. Without this, the service will exit as soon
   // as there is no more work to be processed.
@@ -133,6 +134,8 @@ int main(int argc, char *argv[]) {
         RAY_CHECK_OK(status);
         RAY_CHECK(stored_raylet_config.has_value());
         RayConfig::instance().initialize(stored_raylet_config.get());
+        ray::Process::SetUsePosixSpawn(
+            RayConfig::instance().worker_launch_use_posix_spawn());
 
         // Parse the worker port list.
         std::istringstream worker_port_list_string(worker_port_list);
@@ -248,8 +251,12 @@ int main(int argc, char *argv[]) {
         // Initialize event framework.
         if (RayConfig::instance().event_log_reporter_enabled() && !log_dir.empty()) {
           ray::RayEventInit(ray::rpc::Event_SourceType::Event_SourceType_RAYLET,
-                            {{"node_id", raylet->GetNodeId().Hex()}}, log_dir);
+                            {{"node_id", raylet->GetNodeId().Hex()}}, log_dir,
+                            RayConfig::instance().event_reporter_queue_size());
         };
+        if (!log_dir.empty()) {
+          ray::SpanTracer::Instance().Start("raylet", log_dir);
+        }
 
         raylet->Start();
       }));
@@ -261,6 +268,7 @@ int main(int argc, char *argv[]) {
   auto handler = [&main_service, &raylet_socket_name, &raylet, &gcs_client](
                      const boost::system::error_code &error, int signal_number) {
     RAY_LOG(INFO) << "Raylet received SIGTERM, shutting down...";
+    RAY_UNUSED(ray::SpanTracer::Instance().Dump());
     raylet->Stop();
     gcs_client->Disconnect();
     main_service.stop();
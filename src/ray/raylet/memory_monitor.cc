@@ -0,0 +1,168 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/memory_monitor.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace raylet {
+
+namespace {
+
+bool ReadFile(const std::string &path, std::string *content) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  *content = buffer.str();
+  return true;
+}
+
+/// Read a file holding a single number. A limit of "max" is not a number.
+bool ReadNumber(const std::string &path, int64_t *value) {
+  std::ifstream file(path);
+  return static_cast<bool>(file >> *value);
+}
+
+/// Find the value of a "<key> <value>" line, as in memory.stat and /proc/meminfo.
+bool FindValue(const std::string &content, const std::string &key, int64_t *value) {
+  std::istringstream lines(content);
+  std::string line;
+  while (std::getline(lines, line)) {
+    std::istringstream fields(line);
+    std::string name;
+    if (fields >> name && (name == key || name == key + ":")) {
+      return static_cast<bool>(fields >> *value);
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+MemoryMonitor::MemoryMonitor(double usage_threshold, double pressure_threshold,
+                             std::string root)
+    : usage_threshold_(usage_threshold),
+      pressure_threshold_(pressure_threshold),
+      root_(std::move(root)) {}
+
+bool MemoryMonitor::Refresh() {
+  const bool was_under_pressure = under_pressure_;
+  under_pressure_ = false;
+
+  int64_t used_bytes = 0;
+  int64_t limit_bytes = 0;
+  usage_fraction_ = -1;
+  if (usage_threshold_ > 0 && ReadMemoryUsage(&used_bytes, &limit_bytes) &&
+      limit_bytes > 0) {
+    usage_fraction_ = static_cast<double>(used_bytes) / limit_bytes;
+    under_pressure_ = usage_fraction_ > usage_threshold_;
+  }
+
+  pressure_ = -1;
+  if (pressure_threshold_ > 0 && ReadPressure(&pressure_)) {
+    under_pressure_ = under_pressure_ || pressure_ > pressure_threshold_;
+  }
+
+  if (under_pressure_ != was_under_pressure) {
+    RAY_LOG(INFO) << "Node is " << (under_pressure_ ? "" : "no longer ")
+                  << "under memory pressure, memory usage = " << usage_fraction_
+                  << ", memory stall percentage = " << pressure_;
+  }
+  return under_pressure_;
+}
+
+bool MemoryMonitor::ParsePressure(const std::string &content, double *some_avg10) {
+  std::istringstream lines(content);
+  std::string line;
+  while (std::getline(lines, line)) {
+    if (line.compare(0, 5, "some ") != 0) {
+      continue;
+    }
+    const auto pos = line.find("avg10=");
+    if (pos == std::string::npos) {
+      return false;
+    }
+    std::istringstream value(line.substr(pos + 6));
+    return static_cast<bool>(value >> *some_avg10);
+  }
+  return false;
+}
+
+bool MemoryMonitor::ReadMemoryUsage(int64_t *used_bytes, int64_t *limit_bytes) const {
+  int64_t system_total_bytes = -1;
+  int64_t system_available_bytes = -1;
+  std::string meminfo;
+  if (ReadFile(root_ + "/proc/meminfo", &meminfo)) {
+    int64_t total_kb = 0;
+    int64_t available_kb = 0;
+    if (FindValue(meminfo, "MemTotal", &total_kb) &&
+        FindValue(meminfo, "MemAvailable", &available_kb)) {
+      system_total_bytes = total_kb * 1024;
+      system_available_bytes = available_kb * 1024;
+    }
+  }
+
+  // cgroup v2, then cgroup v1. An unlimited cgroup has no limit below the memory of
+  // the system.
+  const std::string cgroup_files[2][4] = {
+      {"/sys/fs/cgroup/memory.current", "/sys/fs/cgroup/memory.max",
+       "/sys/fs/cgroup/memory.stat", "inactive_file"},
+      {"/sys/fs/cgroup/memory/memory.usage_in_bytes",
+       "/sys/fs/cgroup/memory/memory.limit_in_bytes", "/sys/fs/cgroup/memory/memory.stat",
+       "total_inactive_file"}};
+  for (const auto &files : cgroup_files) {
+    int64_t usage = 0;
+    int64_t limit = 0;
+    if (!ReadNumber(root_ + files[0], &usage) || !ReadNumber(root_ + files[1], &limit) ||
+        limit <= 0 || (system_total_bytes > 0 && limit >= system_total_bytes)) {
+      continue;
+    }
+    std::string stat;
+    int64_t inactive_file = 0;
+    if (ReadFile(root_ + files[2], &stat) && FindValue(stat, files[3], &inactive_file)) {
+      usage -= std::min(usage, inactive_file);
+    }
+    *used_bytes = usage;
+    *limit_bytes = limit;
+    return true;
+  }
+
+  if (system_total_bytes <= 0) {
+    return false;
+  }
+  *used_bytes = system_total_bytes - system_available_bytes;
+  *limit_bytes = system_total_bytes;
+  return true;
+}
+
+bool MemoryMonitor::ReadPressure(double *some_avg10) const {
+  std::string content;
+  return (ReadFile(root_ + "/sys/fs/cgroup/memory.pressure", &content) &&
+          ParsePressure(content, some_avg10)) ||
+         (ReadFile(root_ + "/proc/pressure/memory", &content) &&
+          ParsePressure(content, some_avg10));
+}
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -0,0 +1,84 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace ray {
+
+namespace raylet {
+
+/// Samples the memory use of the node, so that the raylet can hold back new work
+/// while the node is close to running out of memory. Unlike the object store
+/// limits, this covers the heap of the workers as well.
+///
+/// The memory use is read from the memory cgroup mounted at /sys/fs/cgroup, e.g. the
+/// one of the container of the raylet, if it has a limit (cgroup v2 or v1), and from
+/// /proc/meminfo otherwise. Page cache that can be reclaimed right away (inactive
+/// file pages) is not counted as used. The stall time is read from the memory
+/// pressure stall information (PSI) of the cgroup or of the system. Where none of
+/// these files exist, the node is never considered under pressure.
+class MemoryMonitor {
+ public:
+  /// \param usage_threshold The fraction of the memory limit in use above which the
+  /// node is under pressure. 0 disables the check.
+  /// \param pressure_threshold The percentage of time over the last 10 seconds in
+  /// which some tasks stalled on memory ("some avg10" of PSI), above which the node
+  /// is under pressure. 0 disables the check.
+  /// \param root The directory the /sys and /proc files are read from, for tests.
+  MemoryMonitor(double usage_threshold, double pressure_threshold,
+                std::string root = "");
+
+  /// Sample the memory use and the stall time of the node.
+  ///
+  /// \return Whether the node is under memory pressure.
+  bool Refresh();
+
+  /// Whether the node was under memory pressure at the last Refresh.
+  bool IsUnderPressure() const { return under_pressure_; }
+
+  /// The fraction of the memory limit in use at the last Refresh, or -1 if unknown.
+  double GetUsageFraction() const { return usage_fraction_; }
+
+  /// The "some avg10" stall percentage at the last Refresh, or -1 if unknown.
+  double GetPressure() const { return pressure_; }
+
+  /// Parse the "some avg10" value of a PSI file.
+  ///
+  /// \param content The content of the file.
+  /// \param[out] some_avg10 The percentage of time some tasks stalled over the last
+  /// 10 seconds.
+  /// \return Whether the value was found.
+  static bool ParsePressure(const std::string &content, double *some_avg10);
+
+ private:
+  /// Read the used and total memory of the memory cgroup, or of the system.
+  bool ReadMemoryUsage(int64_t *used_bytes, int64_t *limit_bytes) const;
+
+  /// Read the "some avg10" value of the memory cgroup, or of the system.
+  bool ReadPressure(double *some_avg10) const;
+
+  const double usage_threshold_;
+  const double pressure_threshold_;
+  const std::string root_;
+  bool under_pressure_ = false;
+  double usage_fraction_ = -1;
+  double pressure_ = -1;
+};
+
+}  // namespace raylet
+
+}  // namespace ray
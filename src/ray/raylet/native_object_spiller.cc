@@ -0,0 +1,382 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/native_object_spiller.h"
+
+#include <atomic>
+#include <boost/filesystem.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_split.h"
+#include "ray/common/buffer.h"
+#include "ray/object_manager/spilled_object_reader.h"
+#include "ray/util/logging.h"
+#include "ray/util/util.h"
+
+namespace ray {
+
+namespace raylet {
+
+namespace {
+/// The sub directory that spilled files are placed in, same as for IO workers.
+const char kSpilledObjectsDirectoryName[] = "ray_spilled_objects";
+
+/// Serialize a uint64_t as 8 little-endian bytes.
+void AppendUINT64(uint64_t value, std::string *output) {
+  for (size_t i = 0; i < sizeof(uint64_t); i++) {
+    output->push_back(static_cast<char>(value & 0xff));
+    value >>= 8;
+  }
+}
+
+/// Write the buffer, if any, to the stream.
+bool WriteBuffer(const std::shared_ptr<Buffer> &buffer, std::ostream &os) {
+  if (buffer == nullptr || buffer->Size() == 0) {
+    return true;
+  }
+  return static_cast<bool>(
+      os.write(reinterpret_cast<const char *>(buffer->Data()), buffer->Size()));
+}
+}  // namespace
+
+NativeObjectSpiller::NativeObjectSpiller(instrumented_io_context &main_io_context,
+                                         const std::vector<std::string> &directories,
+                                         int num_io_threads, uint64_t max_part_size)
+    : main_io_context_(main_io_context), max_part_size_(max_part_size) {
+  RAY_CHECK(!directories.empty()) << "No directories to spill objects to.";
+  RAY_CHECK(num_io_threads > 0);
+  for (const auto &directory : directories) {
+    auto path = boost::filesystem::path(directory) / kSpilledObjectsDirectoryName;
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(path, ec);
+    RAY_CHECK(!ec) << "Failed to create the directory " << path.string()
+                   << " to spill objects to: " << ec.message();
+    directories_.emplace_back(new SpillDirectory());
+    auto &spill_directory = *directories_.back();
+    spill_directory.path = path.string();
+    for (int i = 0; i < num_io_threads; i++) {
+      spill_directory.io_threads.emplace_back([&spill_directory]() {
+        SetThreadName("spill.io");
+        boost::asio::io_service::work work(spill_directory.io_context);
+        spill_directory.io_context.run();
+      });
+    }
+  }
+  // Start from a random directory, so that raylets sharing the directories
+  // spread their files over all of them.
+  next_directory_index_ = static_cast<size_t>(absl::GetCurrentTimeNanos()) %
+                          directories_.size();
+}
+
+NativeObjectSpiller::~NativeObjectSpiller() {
+  for (auto &directory : directories_) {
+    directory->io_context.stop();
+  }
+  for (auto &directory : directories_) {
+    for (auto &thread : directory->io_threads) {
+      thread.join();
+    }
+  }
+}
+
+std::vector<std::string> NativeObjectSpiller::ParseDirectories(
+    const std::string &directories) {
+  return absl::StrSplit(directories, ',', absl::SkipWhitespace());
+}
+
+NativeObjectSpiller::SpillDirectory &NativeObjectSpiller::ChooseSpillDirectory(
+    int64_t num_bytes) {
+  bool all_measured = true;
+  for (const auto &directory : directories_) {
+    all_measured = all_measured && directory->write_bytes_per_s > 0;
+  }
+  size_t chosen_index = next_directory_index_;
+  double min_cost = std::numeric_limits<double>::max();
+  for (size_t i = 0; i < directories_.size(); i++) {
+    size_t index = (next_directory_index_ + i) % directories_.size();
+    const auto &directory = *directories_[index];
+    double cost = all_measured ? (directory.bytes_queued + num_bytes) /
+                                     directory.write_bytes_per_s
+                               : directory.bytes_queued;
+    if (cost < min_cost) {
+      min_cost = cost;
+      chosen_index = index;
+    }
+  }
+  next_directory_index_ = (chosen_index + 1) % directories_.size();
+  return *directories_[chosen_index];
+}
+
+NativeObjectSpiller::SpillDirectory &NativeObjectSpiller::DirectoryOf(
+    const std::string &path) {
+  const auto parent_path = boost::filesystem::path(path).parent_path().string();
+  SpillDirectory *least_loaded = directories_[0].get();
+  for (auto &directory : directories_) {
+    if (directory->path == parent_path) {
+      return *directory;
+    }
+    if (directory->bytes_queued < least_loaded->bytes_queued) {
+      least_loaded = directory.get();
+    }
+  }
+  return *least_loaded;
+}
+
+/// A fused file being written, possibly as several parts in parallel.
+struct NativeObjectSpiller::SpillWrite {
+  std::string path;
+  std::vector<const RayObject *> objects;
+  /// The header of each object.
+  std::vector<std::string> headers;
+  /// The URL of each object.
+  std::vector<std::string> urls;
+  /// The index of the first object and the file offset of each part.
+  std::vector<std::pair<size_t, uint64_t>> parts;
+  /// The size of the file.
+  uint64_t file_size = 0;
+  /// When the file was created.
+  int64_t start_ns = 0;
+  /// The number of parts that are not written yet.
+  std::atomic<size_t> num_parts_pending{0};
+  /// Whether writing any of the parts failed.
+  std::atomic<bool> failed{false};
+};
+
+void NativeObjectSpiller::SpillObjects(const std::vector<ObjectID> &object_ids,
+                                       const std::vector<const RayObject *> &objects,
+                                       const std::vector<rpc::Address> &owner_addresses,
+                                       SpillCallback callback) {
+  RAY_CHECK(!object_ids.empty());
+  RAY_CHECK(object_ids.size() == objects.size() &&
+            objects.size() == owner_addresses.size());
+  auto write = std::make_shared<SpillWrite>();
+  write->objects = objects;
+  // Lay out the file here, so that the parts can be written independently. This
+  // also serializes the owner addresses here, protobufs aren't meant to be shared
+  // across threads.
+  uint64_t part_size = 0;
+  for (size_t i = 0; i < objects.size(); i++) {
+    const auto &object = *objects[i];
+    const auto owner_address = owner_addresses[i].SerializeAsString();
+    const uint64_t metadata_size =
+        object.HasMetadata() ? object.GetMetadata()->Size() : 0;
+    const uint64_t data_size = object.HasData() ? object.GetData()->Size() : 0;
+    // The header layout is documented in SpilledObjectReader::ParseObjectHeader.
+    std::string header;
+    AppendUINT64(owner_address.size(), &header);
+    AppendUINT64(metadata_size, &header);
+    AppendUINT64(data_size, &header);
+    header.append(owner_address);
+    const uint64_t object_size = header.size() + metadata_size + data_size;
+    if (write->parts.empty() || (max_part_size_ > 0 && part_size >= max_part_size_)) {
+      write->parts.emplace_back(i, write->file_size);
+      part_size = 0;
+    }
+    write->headers.push_back(std::move(header));
+    write->urls.push_back("?offset=" + std::to_string(write->file_size) +
+                          "&size=" + std::to_string(object_size));
+    write->file_size += object_size;
+    part_size += object_size;
+  }
+  const int64_t num_bytes = write->file_size;
+  auto &directory = ChooseSpillDirectory(num_bytes);
+  directory.bytes_queued += num_bytes;
+  // Use the first object as the name of the file, like IO workers do.
+  write->path = (boost::filesystem::path(directory.path) /
+                 (object_ids[0].Hex() + "-multi-" + std::to_string(object_ids.size())))
+                    .string();
+  for (auto &url : write->urls) {
+    url = write->path + url;
+  }
+  write->num_parts_pending = write->parts.size();
+
+  directory.io_context.post(
+      [this, &directory, write, callback]() {
+        write->start_ns = absl::GetCurrentTimeNanos();
+        std::ofstream os(write->path, std::ios::binary | std::ios::trunc);
+        boost::system::error_code ec;
+        if (os && write->parts.size() > 1) {
+          os.close();
+          // Size the file up front, so that the parts can be written at their
+          // offsets in any order.
+          boost::filesystem::resize_file(write->path, write->file_size, ec);
+        }
+        if (!os || ec) {
+          FinishSpill(directory, write,
+                      Status::IOError("Failed to open " + write->path + " for spilling."),
+                      callback);
+          return;
+        }
+        if (write->parts.size() == 1) {
+          FinishSpill(directory, write, WritePart(*write, 0, os), callback);
+          return;
+        }
+        // Write the parts concurrently on the threads of the directory.
+        for (size_t part = 0; part < write->parts.size(); part++) {
+          directory.io_context.post(
+              [this, &directory, write, callback, part]() {
+                std::fstream part_os(write->path,
+                                     std::ios::binary | std::ios::in | std::ios::out);
+                auto status = part_os ? WritePart(*write, part, part_os)
+                                      : Status::IOError("Failed to open " + write->path);
+                if (!status.ok()) {
+                  write->failed = true;
+                }
+                if (--write->num_parts_pending == 0) {
+                  FinishSpill(directory, write,
+                              write->failed ? Status::IOError("Failed to write to " +
+                                                              write->path)
+                                            : Status::OK(),
+                              callback);
+                }
+              },
+              "NativeObjectSpiller.WritePart");
+        }
+      },
+      "NativeObjectSpiller.WriteObjects");
+}
+
+void NativeObjectSpiller::FinishSpill(SpillDirectory &directory,
+                                      const std::shared_ptr<SpillWrite> &write,
+                                      const Status &status, SpillCallback callback) {
+  const int64_t num_bytes = write->file_size;
+  const int64_t duration_ns = absl::GetCurrentTimeNanos() - write->start_ns;
+  std::vector<std::string> urls;
+  if (status.ok()) {
+    urls = write->urls;
+  } else {
+    boost::system::error_code ec;
+    boost::filesystem::remove(write->path, ec);
+  }
+  main_io_context_.post(
+      [&directory, num_bytes, duration_ns, status, urls, callback]() {
+        directory.bytes_queued -= num_bytes;
+        if (status.ok() && num_bytes > 0 && duration_ns > 0) {
+          double bytes_per_s = num_bytes * 1e9 / duration_ns;
+          directory.write_bytes_per_s =
+              directory.write_bytes_per_s == 0
+                  ? bytes_per_s
+                  : 0.8 * directory.write_bytes_per_s + 0.2 * bytes_per_s;
+        }
+        callback(status, urls);
+      },
+      "NativeObjectSpiller.SpillObjects");
+}
+
+Status NativeObjectSpiller::WritePart(const SpillWrite &write, size_t part,
+                                      std::ostream &os) {
+  const size_t begin = write.parts[part].first;
+  const size_t end =
+      part + 1 < write.parts.size() ? write.parts[part + 1].first : write.objects.size();
+  if (!os.seekp(write.parts[part].second)) {
+    return Status::IOError("Failed to write to " + write.path);
+  }
+  for (size_t i = begin; i < end; i++) {
+    const auto &object = *write.objects[i];
+    const auto &header = write.headers[i];
+    if (!os.write(header.data(), header.size()) ||
+        !WriteBuffer(object.GetMetadata(), os) || !WriteBuffer(object.GetData(), os)) {
+      return Status::IOError("Failed to write to " + write.path);
+    }
+  }
+  if (!os.flush()) {
+    return Status::IOError("Failed to write to " + write.path);
+  }
+  return Status::OK();
+}
+
+void NativeObjectSpiller::RestoreObject(const std::string &object_url,
+                                        RestoreCallback callback) {
+  auto parsed_url = ParseURL(object_url);
+  auto &directory = DirectoryOf((*parsed_url)["url"]);
+  int64_t num_bytes = 0;
+  auto size_it = parsed_url->find("size");
+  if (size_it != parsed_url->end()) {
+    num_bytes = std::strtoll(size_it->second.c_str(), nullptr, 10);
+  }
+  directory.bytes_queued += num_bytes;
+  directory.io_context.post(
+      [this, &directory, num_bytes, object_url, callback]() {
+        std::shared_ptr<RayObject> object;
+        auto owner_address = std::make_shared<rpc::Address>();
+        auto status = ReadObject(object_url, &object, owner_address.get());
+        main_io_context_.post(
+            [&directory, num_bytes, status, object, owner_address, callback]() {
+              directory.bytes_queued -= num_bytes;
+              callback(status, object, *owner_address);
+            },
+            "NativeObjectSpiller.RestoreObject");
+      },
+      "NativeObjectSpiller.ReadObject");
+}
+
+Status NativeObjectSpiller::ReadObject(const std::string &object_url,
+                                       std::shared_ptr<RayObject> *object,
+                                       rpc::Address *owner_address) {
+  auto reader = SpilledObjectReader::CreateSpilledObjectReader(object_url);
+  if (!reader.has_value()) {
+    return Status::IOError("Failed to open spilled object " + object_url);
+  }
+  std::shared_ptr<Buffer> metadata;
+  if (reader->GetMetadataSize() > 0) {
+    auto buffer = std::make_shared<LocalMemoryBuffer>(reader->GetMetadataSize());
+    if (!reader->ReadFromMetadataSection(0, buffer->Size(),
+                                         reinterpret_cast<char *>(buffer->Data()))) {
+      return Status::IOError("Failed to read the metadata of " + object_url);
+    }
+    metadata = buffer;
+  }
+  auto data = std::make_shared<LocalMemoryBuffer>(reader->GetDataSize());
+  if (reader->GetDataSize() > 0 &&
+      !reader->ReadFromDataSection(0, data->Size(),
+                                   reinterpret_cast<char *>(data->Data()))) {
+    return Status::IOError("Failed to read the data of " + object_url);
+  }
+  *object = std::make_shared<RayObject>(data, metadata,
+                                        std::vector<rpc::ObjectReference>());
+  owner_address->CopyFrom(reader->GetOwnerAddress());
+  return Status::OK();
+}
+
+void NativeObjectSpiller::DeleteSpilledObjects(const std::vector<std::string> &urls) {
+  // Delete the files of each directory on the threads of that directory.
+  absl::flat_hash_map<SpillDirectory *, std::vector<std::string>> paths;
+  for (const auto &url : urls) {
+    auto parsed_url = ParseURL(url);
+    const auto base_url_it = parsed_url->find("url");
+    if (base_url_it != parsed_url->end()) {
+      paths[&DirectoryOf(base_url_it->second)].push_back(base_url_it->second);
+    }
+  }
+  for (auto &entry : paths) {
+    entry.first->io_context.post(
+        [paths = std::move(entry.second)]() {
+          for (const auto &path : paths) {
+            boost::system::error_code ec;
+            if (!boost::filesystem::remove(path, ec) || ec) {
+              RAY_LOG(ERROR) << "Failed to delete spilled file " << path << ": "
+                             << ec.message();
+            }
+          }
+        },
+        "NativeObjectSpiller.DeleteSpilledObjects");
+  }
+}
+
+}  // namespace raylet
+
+}  // namespace ray
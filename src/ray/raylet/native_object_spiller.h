@@ -0,0 +1,166 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ray/common/asio/instrumented_io_context.h"
+#include "ray/common/id.h"
+#include "ray/common/ray_object.h"
+#include "ray/common/status.h"
+#include "src/ray/protobuf/common.pb.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// Spills objects to and restores them from the local filesystem inside the
+/// raylet, without going through IO worker processes.
+///
+/// Objects are fused into files with the same format as the Python
+/// FileSystemStorage writes, and the returned URLs have the same form, so the
+/// files can be read by SpilledObjectReader and by IO workers alike.
+///
+/// Each directory is expected to be on its own device, and has its own IO threads,
+/// so that a slow or busy device doesn't hold up the others. A spill goes to the
+/// directory expected to finish it first, given the bytes queued on each directory
+/// and its measured write throughput. A restore or delete runs on the threads of the
+/// directory that holds the file. All callbacks are posted to the io_context given to
+/// the constructor.
+///
+/// A large fused file can be written as several parts at once, each a range of the
+/// file written by a different IO thread of its directory. A restore only reads the
+/// range of the file that holds the object.
+class NativeObjectSpiller {
+ public:
+  /// Callback with the URLs of the spilled objects, in the order of the request.
+  using SpillCallback =
+      std::function<void(const Status &status, const std::vector<std::string> &urls)>;
+
+  /// Callback with the restored object and its owner.
+  using RestoreCallback =
+      std::function<void(const Status &status, std::shared_ptr<RayObject> object,
+                         const rpc::Address &owner_address)>;
+
+  /// Create the spiller. The spill directories are created if they don't exist.
+  ///
+  /// \param main_io_context The event loop to post callbacks to.
+  /// \param directories The directories to spill to.
+  /// \param num_io_threads The number of threads that do the file IO of each
+  /// directory, i.e. the number of concurrent reads and writes per device.
+  /// \param max_part_size Once the objects written as one part of a fused file
+  /// reach this size, the next objects are written as another part, in parallel.
+  /// 0 writes every file as a single part.
+  NativeObjectSpiller(instrumented_io_context &main_io_context,
+                      const std::vector<std::string> &directories, int num_io_threads,
+                      uint64_t max_part_size = 0);
+
+  ~NativeObjectSpiller();
+
+  /// Parse a comma separated list of spill directories.
+  static std::vector<std::string> ParseDirectories(const std::string &directories);
+
+  /// Asynchronously fuse objects into a single file.
+  ///
+  /// \param object_ids The objects to spill.
+  /// \param objects The objects to spill. They must stay alive until the callback
+  /// is called.
+  /// \param owner_addresses The owners of the objects.
+  /// \param callback Called with the URL of each object once all objects are
+  /// written. If the file couldn't be written, no URLs are returned.
+  void SpillObjects(const std::vector<ObjectID> &object_ids,
+                    const std::vector<const RayObject *> &objects,
+                    const std::vector<rpc::Address> &owner_addresses,
+                    SpillCallback callback);
+
+  /// Asynchronously read a spilled object into memory.
+  ///
+  /// \param object_url The URL returned when the object was spilled.
+  /// \param callback Called with the object once it is read.
+  void RestoreObject(const std::string &object_url, RestoreCallback callback);
+
+  /// Asynchronously delete spilled files.
+  ///
+  /// \param urls URLs of the objects whose files should be deleted.
+  void DeleteSpilledObjects(const std::vector<std::string> &urls);
+
+ private:
+  struct SpillWrite;
+
+  /// Write one part of a fused file.
+  ///
+  /// \param write The file being written.
+  /// \param part The index of the part to write.
+  /// \param os The stream of the file to write to.
+  static Status WritePart(const SpillWrite &write, size_t part, std::ostream &os);
+
+  /// Read an object from the file at the given URL.
+  static Status ReadObject(const std::string &object_url,
+                           std::shared_ptr<RayObject> *object,
+                           rpc::Address *owner_address);
+
+  /// A directory to spill to, with the threads doing its file IO.
+  struct SpillDirectory {
+    std::string path;
+    /// The bytes of the spills and restores queued on this directory. Only
+    /// accessed by the main thread.
+    int64_t bytes_queued = 0;
+    /// Moving average of the write throughput in bytes per second, 0 until the
+    /// first spill to this directory is done. Only accessed by the main thread.
+    double write_bytes_per_s = 0;
+    /// The event loop of the IO threads.
+    instrumented_io_context io_context;
+    /// The threads doing the file IO.
+    std::vector<std::thread> io_threads;
+  };
+
+  /// Choose the directory to spill the given number of bytes to. Once all
+  /// directories have a measured throughput, this is the one expected to finish
+  /// the write first. Until then, it is the one with the fewest bytes queued. Ties
+  /// are broken in round robin order.
+  SpillDirectory &ChooseSpillDirectory(int64_t num_bytes);
+
+  /// Return the directory that holds the file at the given path, or the one with the
+  /// fewest bytes queued if the file is not in any of the directories.
+  SpillDirectory &DirectoryOf(const std::string &path);
+
+  /// Remove the file if it couldn't be written, and post the callback of the spill
+  /// to the main thread.
+  void FinishSpill(SpillDirectory &directory, const std::shared_ptr<SpillWrite> &write,
+                   const Status &status, SpillCallback callback);
+
+  /// The event loop of the raylet.
+  instrumented_io_context &main_io_context_;
+
+  /// The directories to spill to.
+  std::vector<std::unique_ptr<SpillDirectory>> directories_;
+
+  /// The size above which a fused file is split into parts written in parallel, 0
+  /// to write every file as a single part.
+  const uint64_t max_part_size_;
+
+  /// The index of the directory that ChooseSpillDirectory looks at first. Only
+  /// accessed by the main thread.
+  size_t next_directory_index_ = 0;
+};
+
+}  // namespace raylet
+
+}  // namespace ray
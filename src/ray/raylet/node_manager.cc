@@ -146,6 +146,37 @@ HeartbeatSender::~HeartbeatSender() {
   heartbeat_thread_.reset();
 }
 
+DebugStateWriter::DebugStateWriter(std::string path,
+                                   const instrumented_io_context &main_service)
+    : path_(std::move(path)), main_service_(main_service) {
+  thread_.reset(new std::thread([this] {
+    SetThreadName("debug_dump");
+    /// The asio work to keep io_service_ alive.
+    boost::asio::io_service::work io_service_work_(io_service_);
+    io_service_.run();
+  }));
+}
+
+DebugStateWriter::~DebugStateWriter() {
+  io_service_.stop();
+  if (thread_->joinable()) {
+    thread_->join();
+  }
+  thread_.reset();
+}
+
+void DebugStateWriter::Write(std::string snapshot) {
+  io_service_.post(
+      [this, snapshot = std::move(snapshot)]() {
+        std::fstream fs;
+        fs.open(path_, std::fstream::out | std::fstream::trunc);
+        fs << snapshot;
+        fs << "\nEvent stats:" << main_service_.StatsString();
+        fs.close();
+      },
+      "DebugStateWriter.Write");
+}
+
 void HeartbeatSender::Heartbeat() {
   uint64_t now_ms = current_time_ms();
   uint64_t interval = now_ms - last_heartbeat_at_ms_;
@@ -159,6 +190,20 @@ void HeartbeatSender::Heartbeat() {
   last_heartbeat_at_ms_ = now_ms;
   stats::HeartbeatReportMs.Record(interval);
 
+  if (RayConfig::instance().gcs_heartbeat_piggyback_on_resource_reports()) {
+    // The GCS renews our lease with every resource report it pulls. Still send a
+    // heartbeat every few periods, so that a few lost report replies can't get this
+    // node marked as dead.
+    uint64_t period_ms = RayConfig::instance().raylet_heartbeat_period_milliseconds();
+    int64_t max_skipped = RayConfig::instance().num_heartbeats_timeout() / 3;
+    if (now_ms - last_report_pulled_at_ms_ < period_ms &&
+        num_heartbeats_skipped_ < max_skipped) {
+      num_heartbeats_skipped_++;
+      return;
+    }
+    num_heartbeats_skipped_ = 0;
+  }
+
   auto heartbeat_data = std::make_shared<HeartbeatTableData>();
   heartbeat_data->set_node_id(self_node_id_.Binary());
   RAY_CHECK_OK(
@@ -188,6 +233,7 @@ NodeManager::NodeManager(instrumented_io_context &io_service, const NodeID &self
                    /*get_time=*/[]() { return absl::GetCurrentTimeNanos() / 1e6; }),
       client_call_manager_(io_service),
       worker_rpc_pool_(client_call_manager_),
+      raylet_client_pool_(client_call_manager_),
       core_worker_subscriber_(std::make_unique<pubsub::Subscriber>(
           self_node_id_, RayConfig::instance().max_command_batch_size(),
           /*get_client=*/
@@ -213,6 +259,10 @@ NodeManager::NodeManager(instrumented_io_context &io_service, const NodeID &self
           [this](const ObjectID &object_id) {
             return GetLocalObjectManager().GetLocalSpilledObjectURL(object_id);
           },
+          /*read_compressed_object=*/
+          [this](const ObjectID &object_id) {
+            return GetLocalObjectManager().ReadCompressedObject(object_id);
+          },
           /*spill_objects_callback=*/
           [this]() {
             // This callback is called from the plasma store thread.
@@ -248,11 +298,21 @@ NodeManager::NodeManager(instrumented_io_context &io_service, const NodeID &self
       temp_dir_(config.temp_dir),
       initial_config_(config),
       dependency_manager_(object_manager_),
-      node_manager_server_("NodeManager", config.node_manager_port),
+      node_manager_server_("NodeManager", config.node_manager_port,
+                           RayConfig::instance().node_manager_grpc_server_threads()),
       node_manager_service_(io_service, *this),
       agent_manager_service_handler_(
           new DefaultAgentManagerServiceHandler(agent_manager_)),
       agent_manager_service_(io_service, *agent_manager_service_handler_),
+      native_object_spiller_(
+          RayConfig::instance().native_object_spilling_directories().empty()
+              ? nullptr
+              : std::make_unique<NativeObjectSpiller>(
+                    io_service,
+                    NativeObjectSpiller::ParseDirectories(
+                        RayConfig::instance().native_object_spilling_directories()),
+                    RayConfig::instance().native_object_spilling_io_threads(),
+                    RayConfig::instance().native_object_spilling_part_size())),
       local_object_manager_(
           self_node_id_, config.node_manager_address, config.node_manager_port,
           RayConfig::instance().free_objects_batch_size(),
@@ -272,7 +332,22 @@ NodeManager::NodeManager(instrumented_io_context &io_service, const NodeID &self
           [this](const ObjectID &object_id) {
             return object_manager_.IsPlasmaObjectSpillable(object_id);
           },
-          /*core_worker_subscriber_=*/core_worker_subscriber_.get()),
+          /*core_worker_subscriber_=*/core_worker_subscriber_.get(),
+          /*max_compressed_objects_size=*/
+          RayConfig::instance().object_compression_tier_size(),
+          /*restore_object_in_store=*/
+          [this](const ObjectID &object_id, const rpc::Address &owner_address,
+                 const RayObject &object) {
+            return RestoreObjectInPlasma(object_id, owner_address, object);
+          },
+          /*native_object_spiller=*/native_object_spiller_.get(),
+          /*spilled_file_compaction_dead_ratio=*/
+          RayConfig::instance().spilled_file_compaction_dead_ratio(),
+          /*on_object_spilled=*/
+          [this](const ObjectID &object_id) {
+            object_manager_.SetObjectProvenance(object_id,
+                                                plasma::ObjectProvenance::kSpilled);
+          }),
       high_plasma_storage_usage_(RayConfig::instance().high_plasma_storage_usage()),
       local_gc_run_time_ns_(absl::GetCurrentTimeNanos()),
       local_gc_throttler_(RayConfig::instance().local_gc_min_interval_s() * 1e9),
@@ -286,11 +361,21 @@ NodeManager::NodeManager(instrumented_io_context &io_service, const NodeID &self
   RAY_LOG(INFO) << "Initializing NodeManager with ID " << self_node_id_;
   RAY_CHECK(RayConfig::instance().raylet_heartbeat_period_milliseconds() > 0);
   SchedulingResources local_resources(config.resource_config);
-  cluster_resource_scheduler_ =
+  memory_monitor_.reset(new MemoryMonitor(
+      RayConfig::instance().raylet_memory_pressure_usage_threshold(),
+      RayConfig::instance().raylet_memory_pressure_stall_threshold()));
+  auto cluster_resource_scheduler =
       std::shared_ptr<ClusterResourceScheduler>(new ClusterResourceScheduler(
           self_node_id_.Binary(), local_resources.GetTotalResources().GetResourceMap(),
           [this]() { return object_manager_.GetUsedMemory(); },
-          [this]() { return object_manager_.PullManagerHasPullsQueued(); }));
+          [this]() { return object_manager_.PullManagerHasPullsQueued(); },
+          [this]() { return memory_monitor_->IsUnderPressure(); }));
+  if (RayConfig::instance().gpu_topology_aware_allocation()) {
+    GpuDistances gpu_distances = DiscoverGpuTopology();
+    RAY_LOG(INFO) << "Discovered the topology of " << gpu_distances.size() << " GPUs.";
+    cluster_resource_scheduler->SetGpuTopology(std::move(gpu_distances));
+  }
+  cluster_resource_scheduler_ = cluster_resource_scheduler;
 
   auto get_node_info_func = [this](const NodeID &node_id) {
     return gcs_client_->Nodes().Get(node_id);
@@ -325,7 +410,30 @@ NodeManager::NodeManager(instrumented_io_context &io_service, const NodeID &self
              std::vector<std::unique_ptr<RayObject>> *results) {
         return GetObjectsFromPlasma(object_ids, results);
       },
-      max_task_args_memory));
+      max_task_args_memory,
+      [this](const std::vector<ObjectID> &object_ids,
+             absl::flat_hash_map<NodeID, int64_t> *bytes_by_node) {
+        return object_manager_.GetObjectBytesByNode(object_ids, bytes_by_node);
+      },
+      RayConfig::instance().coalesce_scheduling_passes() ? &io_service_ : nullptr,
+      [this](const JobID &job_id) {
+        auto job_config = worker_pool_.GetJobConfig(job_id);
+        return job_config && job_config->scheduling_weight() > 0
+                   ? job_config->scheduling_weight()
+                   : 1.0;
+      },
+      [this](std::shared_ptr<WorkerInterface> worker) {
+        // Kill the worker outside of the scheduling pass, which iterates over the
+        // leased workers. The owner retries the task when the worker dies.
+        io_service_.post(
+            [this, worker]() {
+              if (!worker->IsDead() && leased_workers_.count(worker->WorkerId())) {
+                DestroyWorker(worker, rpc::WorkerExitType::INTENDED_EXIT);
+              }
+            },
+            "NodeManager.PreemptWorker");
+      },
+      [this]() { return memory_monitor_->IsUnderPressure(); }));
   placement_group_resource_manager_ = std::make_shared<NewPlacementGroupResourceManager>(
       std::dynamic_pointer_cast<ClusterResourceScheduler>(cluster_resource_scheduler_),
       // TODO (Alex): Ideally we could do these in a more robust way (retry
@@ -411,9 +519,30 @@ ray::Status NodeManager::RegisterGcs() {
         /*subscribe_callback=*/resources_changed,
         /*done_callback=*/nullptr));
   };
-  // Register a callback to monitor new nodes and a callback to monitor removed nodes.
-  RAY_RETURN_NOT_OK(
-      gcs_client_->Nodes().AsyncSubscribeToNodeChange(on_node_change, on_done));
+  if (RayConfig::instance().raylet_fetch_all_node_resources_on_join()) {
+    // Fetch the resources of all nodes with a single request before the node table, so
+    // that adding the existing nodes doesn't take a request to the GCS per node.
+    RAY_RETURN_NOT_OK(gcs_client_->NodeResources().AsyncGetAllTotalResources(
+        [this, on_node_change, on_done](
+            Status status, const std::vector<rpc::TotalResources> &resources_list) {
+          RAY_CHECK_OK(status);
+          for (const auto &resources : resources_list) {
+            joining_node_resources_.emplace(
+                NodeID::FromBinary(resources.node_id()),
+                ResourceSet(MapFromProtobuf(resources.resources_total())));
+          }
+          RAY_CHECK_OK(gcs_client_->Nodes().AsyncSubscribeToNodeChange(
+              on_node_change, [this, on_done](Status status) {
+                // Nodes that were removed in the meantime are never added.
+                joining_node_resources_.clear();
+                on_done(status);
+              }));
+        }));
+  } else {
+    // Register a callback to monitor new nodes and a callback to monitor removed nodes.
+    RAY_RETURN_NOT_OK(
+        gcs_client_->Nodes().AsyncSubscribeToNodeChange(on_node_change, on_done));
+  }
 
   // Subscribe to resource usage batches from the monitor.
   const auto &resource_usage_batch_added =
@@ -452,6 +581,10 @@ ray::Status NodeManager::RegisterGcs() {
   RAY_RETURN_NOT_OK(
       gcs_client_->Jobs().AsyncSubscribeAll(job_subscribe_handler, nullptr));
 
+  if (RayConfig::instance().debug_dump_in_background()) {
+    debug_state_writer_.reset(new DebugStateWriter(
+        initial_config_.session_dir + "/debug_state.txt", io_service_));
+  }
   periodical_runner_.RunFnPeriodically(
       [this] {
         DumpDebugState();
@@ -470,6 +603,30 @@ ray::Status NodeManager::RegisterGcs() {
         RayConfig::instance().free_objects_period_milliseconds(),
         "NodeManager.deadline_timer.flush_free_objects");
   }
+  if (RayConfig::instance().object_spilling_high_watermark() > 0) {
+    periodical_runner_.RunFnPeriodically(
+        [this] { SpillObjectsAboveHighWatermark(); },
+        RayConfig::instance().object_spilling_watermark_check_period_ms(),
+        "NodeManager.deadline_timer.spill_objects_above_high_watermark");
+  }
+  if (RayConfig::instance().raylet_push_resource_reports()) {
+    periodical_runner_.RunFnPeriodically(
+        [this] { PushResourceReport(); }, report_resources_period_ms_,
+        "NodeManager.deadline_timer.push_resource_report");
+  }
+  if (RayConfig::instance().raylet_memory_pressure_usage_threshold() > 0 ||
+      RayConfig::instance().raylet_memory_pressure_stall_threshold() > 0) {
+    periodical_runner_.RunFnPeriodically(
+        [this] {
+          const bool was_under_pressure = memory_monitor_->IsUnderPressure();
+          if (!memory_monitor_->Refresh() && was_under_pressure) {
+            // Dispatch the tasks held back while the node was short of memory.
+            cluster_task_manager_->ScheduleAndDispatchTasks();
+          }
+        },
+        RayConfig::instance().raylet_memory_monitor_interval_ms(),
+        "NodeManager.deadline_timer.memory_monitor");
+  }
   last_resource_report_at_ms_ = now_ms;
   /// If periodic asio stats print is enabled, it will print it.
   const auto event_stats_print_interval_ms =
@@ -535,6 +692,9 @@ void NodeManager::HandleJobFinished(const JobID &job_id, const JobTableData &job
   RAY_LOG(DEBUG) << "HandleJobFinished " << job_id;
   RAY_CHECK(job_data.is_dead());
   worker_pool_.HandleJobFinished(job_id);
+  if (agent_manager_ != nullptr) {
+    agent_manager_->ClearRuntimeEnvCreations(job_id);
+  }
   runtime_env_manager_.RemoveURIReference(job_id.Hex());
 }
 
@@ -555,10 +715,8 @@ void NodeManager::FillNormalTaskResourceUsage(rpc::ResourcesData &resources_data
 void NodeManager::FillResourceReport(rpc::ResourcesData &resources_data) {
   resources_data.set_node_id(self_node_id_.Binary());
   resources_data.set_node_manager_address(initial_config_.node_manager_address);
-  // Update local cache from gcs remote cache, this is needed when gcs restart.
-  // We should always keep the cache view consistent.
-  cluster_resource_scheduler_->UpdateLastResourceUsage(
-      gcs_client_->NodeResources().GetLastResourceUsage());
+  // Resource reports are deltas against the previous report, with a periodic full
+  // snapshot. The snapshot also brings a restarted GCS up to date.
   cluster_resource_scheduler_->FillResourceUsage(resources_data);
   cluster_task_manager_->FillResourceUsage(
       resources_data, gcs_client_->NodeResources().GetLastResourceUsage());
@@ -590,6 +748,23 @@ void NodeManager::FillResourceReport(rpc::ResourcesData &resources_data) {
   }
 }
 
+void NodeManager::SpillObjectsAboveHighWatermark() {
+  const double capacity = object_manager_.GetMemoryCapacity();
+  // Creates that wait for space will need it soon, count them as used.
+  const int64_t used =
+      object_manager_.GetUsedMemory() + object_manager_.GetPendingCreateBytes();
+  const int64_t low_watermark =
+      capacity * RayConfig::instance().object_spilling_low_watermark();
+  if (used > capacity * RayConfig::instance().object_spilling_high_watermark()) {
+    spilling_above_low_watermark_ = true;
+  } else if (used <= low_watermark) {
+    spilling_above_low_watermark_ = false;
+  }
+  if (spilling_above_low_watermark_) {
+    local_object_manager_.SpillObjectsToFreeBytes(used - low_watermark);
+  }
+}
+
 void NodeManager::DoLocalGC() {
   auto all_workers = worker_pool_.GetAllRegisteredWorkers();
   for (const auto &driver : worker_pool_.GetAllRegisteredDrivers()) {
@@ -758,6 +933,13 @@ void NodeManager::NodeAdded(const GcsNodeInfo &node_info) {
   remote_node_manager_addresses_[node_id] =
       std::make_pair(node_info.node_manager_address(), node_info.node_manager_port());
 
+  auto joining_resources = joining_node_resources_.find(node_id);
+  if (joining_resources != joining_node_resources_.end()) {
+    ResourceCreateUpdated(node_id, joining_resources->second);
+    joining_node_resources_.erase(joining_resources);
+    return;
+  }
+
   // Fetch resource info for the remote node and update cluster resource map.
   RAY_CHECK_OK(gcs_client_->NodeResources().AsyncGetResources(
       node_id,
@@ -1496,6 +1678,25 @@ void NodeManager::ProcessPushErrorRequestMessage(const uint8_t *message_data) {
 void NodeManager::HandleUpdateResourceUsage(
     const rpc::UpdateResourceUsageRequest &request, rpc::UpdateResourceUsageReply *reply,
     rpc::SendReplyCallback send_reply_callback) {
+  if (request.forward_to_size() > 0) {
+    // Relay the batch to our subtree of the broadcast tree before applying it.
+    std::string serialized_batch = request.serialized_resource_usage_batch();
+    std::vector<rpc::Address> forward_to(request.forward_to().begin(),
+                                         request.forward_to().end());
+    for (auto &group : rpc::SplitBroadcastTargets(
+             std::move(forward_to), RayConfig::instance().resource_broadcast_fanout())) {
+      std::vector<rpc::Address> subtree(group.begin() + 1, group.end());
+      raylet_client_pool_.GetOrConnectByAddress(group.front())
+          ->UpdateResourceUsage(
+              serialized_batch, subtree,
+              [](const Status &status, const rpc::UpdateResourceUsageReply &reply) {
+                if (!status.ok()) {
+                  RAY_LOG(DEBUG) << "Failed to relay resource broadcast: " << status;
+                }
+              });
+    }
+  }
+
   rpc::ResourceUsageBroadcastData resource_usage_batch;
   resource_usage_batch.ParseFromString(request.serialized_resource_usage_batch());
 
@@ -1538,11 +1739,36 @@ void NodeManager::HandleUpdateResourceUsage(
   send_reply_callback(Status::OK(), nullptr, nullptr);
 }
 
+void NodeManager::PushResourceReport() {
+  // The changes made while a report is in flight go out with the next report.
+  if (resource_report_in_flight_) {
+    return;
+  }
+  auto resources_data = std::make_shared<rpc::ResourcesData>();
+  FillResourceReport(*resources_data);
+  if (resources_data->resources_total_size() == 0 &&
+      !resources_data->resources_available_changed() &&
+      !resources_data->resource_load_changed() && !resources_data->should_global_gc()) {
+    return;
+  }
+  resource_report_in_flight_ = true;
+  RAY_CHECK_OK(gcs_client_->NodeResources().AsyncReportResourceUsage(
+      resources_data, [this](const Status &status) {
+        if (!status.ok()) {
+          RAY_LOG(INFO) << "Failed to push the resource report to the GCS: " << status;
+        }
+        resource_report_in_flight_ = false;
+      }));
+}
+
 void NodeManager::HandleRequestResourceReport(
     const rpc::RequestResourceReportRequest &request,
     rpc::RequestResourceReportReply *reply, rpc::SendReplyCallback send_reply_callback) {
   auto resources_data = reply->mutable_resources();
   FillResourceReport(*resources_data);
+  if (heartbeat_sender_) {
+    heartbeat_sender_->OnResourceReportPulled();
+  }
 
   send_reply_callback(Status::OK(), nullptr, nullptr);
 }
@@ -1575,7 +1801,9 @@ void NodeManager::HandleRequestWorkerLease(const rpc::RequestWorkerLeaseRequest
     RAY_CHECK_OK(gcs_client_->Tasks().AsyncAdd(data, nullptr));
   }
 
-  if (RayConfig::instance().enable_worker_prestart()) {
+  // Workers started under memory pressure would add to it.
+  if (RayConfig::instance().enable_worker_prestart() &&
+      !memory_monitor_->IsUnderPressure()) {
     auto task_spec = task.GetTaskSpecification();
     // We floor the available CPUs to the nearest integer to avoid starting too
     // many workers when there is less than 1 CPU left. Otherwise, we could end
@@ -1593,11 +1821,14 @@ void NodeManager::HandleRequestWorkerLease(const rpc::RequestWorkerLeaseRequest
 void NodeManager::HandlePrepareBundleResources(
     const rpc::PrepareBundleResourcesRequest &request,
     rpc::PrepareBundleResourcesReply *reply, rpc::SendReplyCallback send_reply_callback) {
-  auto bundle_spec = BundleSpecification(request.bundle_spec());
-  RAY_LOG(DEBUG) << "Request to prepare bundle resources is received, "
-                 << bundle_spec.DebugString();
+  std::vector<std::shared_ptr<const BundleSpecification>> bundle_specs;
+  for (const auto &bundle : request.bundle_specs()) {
+    bundle_specs.push_back(std::make_shared<const BundleSpecification>(bundle));
+    RAY_LOG(DEBUG) << "Request to prepare bundle resources is received, "
+                   << bundle_specs.back()->DebugString();
+  }
 
-  auto prepared = placement_group_resource_manager_->PrepareBundle(bundle_spec);
+  auto prepared = placement_group_resource_manager_->PrepareBundles(bundle_specs);
   reply->set_success(prepared);
   send_reply_callback(Status::OK(), nullptr, nullptr);
 }
@@ -1605,10 +1836,13 @@ void NodeManager::HandlePrepareBundleResources(
 void NodeManager::HandleCommitBundleResources(
     const rpc::CommitBundleResourcesRequest &request,
     rpc::CommitBundleResourcesReply *reply, rpc::SendReplyCallback send_reply_callback) {
-  auto bundle_spec = BundleSpecification(request.bundle_spec());
-  RAY_LOG(DEBUG) << "Request to commit bundle resources is received, "
-                 << bundle_spec.DebugString();
-  placement_group_resource_manager_->CommitBundle(bundle_spec);
+  std::vector<std::shared_ptr<const BundleSpecification>> bundle_specs;
+  for (const auto &bundle : request.bundle_specs()) {
+    bundle_specs.push_back(std::make_shared<const BundleSpecification>(bundle));
+    RAY_LOG(DEBUG) << "Request to commit bundle resources is received, "
+                   << bundle_specs.back()->DebugString();
+  }
+  placement_group_resource_manager_->CommitBundles(bundle_specs);
   send_reply_callback(Status::OK(), nullptr, nullptr);
 
   cluster_task_manager_->ScheduleAndDispatchTasks();
@@ -1749,6 +1983,28 @@ void NodeManager::MarkObjectsAsFailed(
   }
 }
 
+Status NodeManager::RestoreObjectInPlasma(const ObjectID &object_id,
+                                          const rpc::Address &owner_address,
+                                          const RayObject &object) {
+  const auto &data = object.GetData();
+  const auto &metadata = object.GetMetadata();
+  std::shared_ptr<Buffer> plasma_data;
+  // Don't wait for space to be made, because spilling itself runs on this thread.
+  auto status = store_client_.TryCreateImmediately(
+      object_id, owner_address, data->Size(), metadata ? metadata->Data() : nullptr,
+      metadata ? metadata->Size() : 0, &plasma_data,
+      plasma::flatbuf::ObjectSource::RestoredFromStorage);
+  if (status.IsObjectExists()) {
+    // The object was restored already.
+    return Status::OK();
+  }
+  RAY_RETURN_NOT_OK(status);
+  std::memcpy(plasma_data->Data(), data->Data(), data->Size());
+  status = store_client_.Seal(object_id);
+  RAY_UNUSED(store_client_.Release(object_id));
+  return status;
+}
+
 void NodeManager::HandleDirectCallTaskBlocked(
     const std::shared_ptr<WorkerInterface> &worker, bool release_resources) {
   if (!worker || worker->IsBlocked() || worker->GetAssignedTaskId().IsNil() ||
@@ -1883,6 +2139,30 @@ void NodeManager::HandleObjectLocal(const ObjectInfo &object_info) {
                  << " tasks ready";
   cluster_task_manager_->TasksUnblocked(ready_task_ids);
 
+  // Pin the object if it is a replica that an owner asked us to keep.
+  auto replica_it = pending_replica_pins_.find(object_id);
+  if (replica_it != pending_replica_pins_.end()) {
+    const auto owner_address = replica_it->second.first;
+    object_manager_.CancelPull(replica_it->second.second);
+    pending_replica_pins_.erase(replica_it);
+    std::vector<std::unique_ptr<RayObject>> results;
+    bool pinned = false;
+    if (GetObjectsFromPlasma({object_id}, &results) && results[0] != nullptr) {
+      RAY_LOG(DEBUG) << "Pinning replica of object " << object_id;
+      local_object_manager_.PinObjects({object_id}, std::move(results), owner_address);
+      local_object_manager_.WaitForObjectFree(owner_address, {object_id});
+      pinned = true;
+    }
+    auto callbacks_it = replica_pinned_callbacks_.find(object_id);
+    if (callbacks_it != replica_pinned_callbacks_.end()) {
+      auto callbacks = std::move(callbacks_it->second);
+      replica_pinned_callbacks_.erase(callbacks_it);
+      for (const auto &callback : callbacks) {
+        callback(pinned);
+      }
+    }
+  }
+
   auto waiting_workers = absl::flat_hash_set<std::shared_ptr<WorkerInterface>>();
   {
     absl::MutexLock guard(&plasma_object_notification_lock_);
@@ -1982,6 +2262,13 @@ void NodeManager::ProcessSubscribePlasmaReady(
 }
 
 void NodeManager::DumpDebugState() const {
+  if (debug_state_writer_ != nullptr) {
+    uint64_t now_ms = current_time_ms();
+    std::string snapshot = ComponentsDebugString();
+    snapshot += "\nDebugString() time ms: " + std::to_string(current_time_ms() - now_ms);
+    debug_state_writer_->Write(std::move(snapshot));
+    return;
+  }
   std::fstream fs;
   fs.open(initial_config_.session_dir + "/debug_state.txt",
           std::fstream::out | std::fstream::trunc);
@@ -1994,6 +2281,17 @@ const NodeManagerConfig &NodeManager::GetInitialConfig() const { return initial_
 std::string NodeManager::DebugString() const {
   std::stringstream result;
   uint64_t now_ms = current_time_ms();
+  result << ComponentsDebugString();
+
+  // Event stats.
+  result << "\nEvent stats:" << io_service_.StatsString();
+
+  result << "\nDebugString() time ms: " << (current_time_ms() - now_ms);
+  return result.str();
+}
+
+std::string NodeManager::ComponentsDebugString() const {
+  std::stringstream result;
   result << "NodeManager:";
   result << "\nInitialConfigResources: " << initial_config_.resource_config.ToString();
   if (cluster_task_manager_ != nullptr) {
@@ -2017,11 +2315,6 @@ std::string NodeManager::DebugString() const {
   for (const auto &entry : remote_node_manager_addresses_) {
     result << "\n" << entry.first;
   }
-
-  // Event stats.
-  result << "\nEvent stats:" << io_service_.StatsString();
-
-  result << "\nDebugString() time ms: " << (current_time_ms() - now_ms);
   return result.str();
 }
 
@@ -2087,12 +2380,190 @@ void NodeManager::HandlePinObjectIDs(const rpc::PinObjectIDsRequest &request,
     send_reply_callback(Status::Invalid("Failed to get objects."), nullptr, nullptr);
     return;
   }
+  if (request.pull_if_missing()) {
+    // Pin the objects that are already local, and pull the rest. They are
+    // pinned in HandleObjectLocal once they arrive.
+    std::vector<ObjectID> local_object_ids;
+    std::vector<std::unique_ptr<RayObject>> local_results;
+    std::vector<ObjectID> missing_object_ids;
+    for (size_t i = 0; i < object_ids.size(); i++) {
+      if (results[i] != nullptr) {
+        local_object_ids.push_back(object_ids[i]);
+        local_results.push_back(std::move(results[i]));
+        continue;
+      }
+      missing_object_ids.push_back(object_ids[i]);
+      if (!pending_replica_pins_.contains(object_ids[i])) {
+        rpc::ObjectReference ref;
+        ref.set_object_id(object_ids[i].Binary());
+        ref.mutable_owner_address()->CopyFrom(owner_address);
+        auto pull_id = object_manager_.Pull({ref}, BundlePriority::TASK_ARGS);
+        pending_replica_pins_.emplace(object_ids[i],
+                                      std::make_pair(owner_address, pull_id));
+      }
+    }
+    local_object_manager_.PinObjects(local_object_ids, std::move(local_results),
+                                     owner_address);
+    local_object_manager_.WaitForObjectFree(owner_address, local_object_ids);
+    if (!request.reply_when_pinned() || missing_object_ids.empty()) {
+      send_reply_callback(Status::OK(), nullptr, nullptr);
+      return;
+    }
+    // Reply once the last of the missing objects arrived and was pinned.
+    auto num_pending = std::make_shared<size_t>(missing_object_ids.size());
+    auto all_pinned = std::make_shared<bool>(true);
+    for (const auto &object_id : missing_object_ids) {
+      replica_pinned_callbacks_[object_id].push_back(
+          [num_pending, all_pinned, send_reply_callback](bool pinned) {
+            *all_pinned = *all_pinned && pinned;
+            if (--(*num_pending) == 0) {
+              send_reply_callback(*all_pinned
+                                      ? Status::OK()
+                                      : Status::ObjectNotFound("Failed to pin objects."),
+                                  nullptr, nullptr);
+            }
+          });
+    }
+    return;
+  }
   local_object_manager_.PinObjects(object_ids, std::move(results), owner_address);
   // Wait for the object to be freed by the owner, which keeps the ref count.
   local_object_manager_.WaitForObjectFree(owner_address, object_ids);
   send_reply_callback(Status::OK(), nullptr, nullptr);
 }
 
+void NodeManager::HandleDrainObjects(const rpc::DrainObjectsRequest &request,
+                                     rpc::DrainObjectsReply *reply,
+                                     rpc::SendReplyCallback send_reply_callback) {
+  if (object_drain_ != nullptr) {
+    send_reply_callback(Status::Invalid("The objects of the node are being drained."),
+                        nullptr, nullptr);
+    return;
+  }
+  auto drain = std::make_unique<ObjectDrain>();
+  for (const auto &entry : gcs_client_->Nodes().GetAll()) {
+    const auto &node_info = entry.second;
+    if (node_info.state() != rpc::GcsNodeInfo::ALIVE || entry.first == self_node_id_) {
+      continue;
+    }
+    rpc::Address address;
+    address.set_raylet_id(node_info.node_id());
+    address.set_ip_address(node_info.node_manager_address());
+    address.set_port(node_info.node_manager_port());
+    drain->nodes.push_back(address);
+  }
+  const auto pinned_objects = local_object_manager_.GetPinnedObjects();
+  if (!pinned_objects.empty() && drain->nodes.empty()) {
+    send_reply_callback(Status::Invalid("There is no other node to migrate objects to."),
+                        nullptr, nullptr);
+    return;
+  }
+  RAY_LOG(INFO) << "Draining " << pinned_objects.size() << " objects to "
+                << drain->nodes.size() << " nodes";
+  drain->pending.assign(pinned_objects.begin(), pinned_objects.end());
+  drain->reply = reply;
+  drain->send_reply_callback = send_reply_callback;
+  object_drain_ = std::move(drain);
+  MigrateObjects();
+}
+
+void NodeManager::MigrateObjects() {
+  auto &drain = *object_drain_;
+  const auto max_in_flight =
+      static_cast<size_t>(RayConfig::instance().object_migration_max_in_flight());
+  const int64_t max_bytes_in_flight =
+      RayConfig::instance().object_migration_max_bytes_in_flight();
+  while (!drain.pending.empty() && drain.in_flight.size() < max_in_flight) {
+    const auto object_id = std::get<0>(drain.pending.front());
+    const auto owner_address = std::get<1>(drain.pending.front());
+    const int64_t object_size = std::get<2>(drain.pending.front());
+    if (!drain.in_flight.empty() &&
+        drain.bytes_in_flight + object_size > max_bytes_in_flight) {
+      break;
+    }
+    drain.pending.pop_front();
+    const auto &node_address = drain.nodes[drain.next_node++ % drain.nodes.size()];
+    const auto node_id = NodeID::FromBinary(node_address.raylet_id());
+    drain.in_flight.emplace(object_id, object_size);
+    drain.bytes_in_flight += object_size;
+    RAY_LOG(DEBUG) << "Migrating object " << object_id << " to node " << node_id;
+    raylet_client_pool_.GetOrConnectByAddress(node_address)
+        ->MigrateObjectIDs(
+            owner_address, {object_id},
+            [this, object_id, owner_address, node_id](
+                const Status &status, const rpc::PinObjectIDsReply &reply) {
+              if (!status.ok()) {
+                RAY_LOG(INFO) << "Failed to migrate object " << object_id
+                              << " to node " << node_id << ": " << status;
+              }
+              OnObjectMigrated(object_id, owner_address, node_id, status.ok());
+            });
+    execute_after(
+        io_service_,
+        [this, object_id, owner_address, node_id]() {
+          if (object_drain_ != nullptr && object_drain_->in_flight.contains(object_id)) {
+            RAY_LOG(INFO) << "Timed out migrating object " << object_id << " to node "
+                          << node_id;
+            OnObjectMigrated(object_id, owner_address, node_id, false);
+          }
+        },
+        RayConfig::instance().object_migration_timeout_ms());
+  }
+
+  if (drain.pending.empty() && drain.in_flight.empty()) {
+    RAY_LOG(INFO) << "Drained objects, " << drain.reply->num_migrated()
+                  << " migrated, " << drain.reply->num_failed() << " still pinned";
+    auto send_reply_callback = std::move(drain.send_reply_callback);
+    object_drain_.reset();
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+}
+
+void NodeManager::OnObjectMigrated(const ObjectID &object_id,
+                                   const rpc::Address &owner_address,
+                                   const NodeID &node_id, bool success) {
+  if (object_drain_ == nullptr) {
+    return;
+  }
+  auto &drain = *object_drain_;
+  auto it = drain.in_flight.find(object_id);
+  if (it == drain.in_flight.end()) {
+    // The migration timed out before.
+    return;
+  }
+  drain.bytes_in_flight -= it->second;
+  drain.in_flight.erase(it);
+  if (!success) {
+    drain.reply->set_num_failed(drain.reply->num_failed() + 1);
+    MigrateObjects();
+    return;
+  }
+  drain.reply->set_num_migrated(drain.reply->num_migrated() + 1);
+  // The object may have been freed or spilled in the meantime, then the owner already
+  // knows about it.
+  if (local_object_manager_.UnpinMigratedObject(object_id)) {
+    // The local copy is a secondary copy now.
+    object_manager_.SetObjectProvenance(object_id, plasma::ObjectProvenance::kSecondary);
+    rpc::UpdateObjectLocationBatchRequest request;
+    request.set_intended_worker_id(owner_address.worker_id());
+    auto update = request.add_updates();
+    update->set_object_id(object_id.Binary());
+    update->set_node_id(node_id.Binary());
+    update->set_added(true);
+    update->set_pinned(true);
+    worker_rpc_pool_.GetOrConnect(owner_address)
+        ->UpdateObjectLocationBatch(
+            request, [object_id](const Status &status,
+                                 const rpc::UpdateObjectLocationBatchReply &reply) {
+              if (!status.ok()) {
+                RAY_LOG(INFO) << "Failed to report the migration of object "
+                              << object_id << " to its owner: " << status;
+              }
+            });
+  }
+  MigrateObjects();
+}
+
 void NodeManager::HandleGetSystemConfig(const rpc::GetSystemConfigRequest &request,
                                         rpc::GetSystemConfigReply *reply,
                                         rpc::SendReplyCallback send_reply_callback) {
@@ -2117,6 +2588,7 @@ void NodeManager::HandleGetNodeStats(const rpc::GetNodeStatsRequest &node_stats_
   local_object_manager_.FillObjectSpillingStats(reply);
   // Report object store stats.
   object_manager_.FillObjectStoreStats(reply);
+  object_manager_.FillObjectTransferStats(reply);
   // Ensure we never report an empty set of metrics.
   if (!recorded_metrics_) {
     RecordMetrics();
@@ -2375,6 +2847,7 @@ void NodeManager::Stop() {
   if (heartbeat_sender_) {
     heartbeat_sender_.reset();
   }
+  debug_state_writer_.reset();
 }
 
 void NodeManager::RecordMetrics() {
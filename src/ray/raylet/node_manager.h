@@ -18,6 +18,7 @@
 #include "ray/rpc/grpc_client.h"
 #include "ray/rpc/node_manager/node_manager_server.h"
 #include "ray/rpc/node_manager/node_manager_client.h"
+#include "ray/rpc/node_manager/node_manager_client_pool.h"
 #include "ray/common/id.h"
 #include "ray/common/task/task.h"
 #include "ray/common/ray_object.h"
@@ -30,6 +31,7 @@
 #include "ray/raylet_client/raylet_client.h"
 #include "ray/common/runtime_env_manager.h"
 #include "ray/raylet/local_object_manager.h"
+#include "ray/raylet/memory_monitor.h"
 #include "ray/raylet/scheduling/scheduling_ids.h"
 #include "ray/raylet/scheduling/cluster_resource_scheduler.h"
 #include "ray/raylet/scheduling/cluster_task_manager.h"
@@ -115,6 +117,12 @@ class HeartbeatSender {
 
   ~HeartbeatSender();
 
+  /// Record that the GCS has just pulled a resource report from this node. If
+  /// `gcs_heartbeat_piggyback_on_resource_reports` is set, the GCS takes the report as a
+  /// heartbeat, so most heartbeats can be skipped while reports are flowing. This is
+  /// thread safe.
+  void OnResourceReportPulled() { last_report_pulled_at_ms_ = current_time_ms(); }
+
  private:
   /// Send heartbeats to the GCS.
   void Heartbeat();
@@ -132,6 +140,36 @@ class HeartbeatSender {
   /// The time that the last heartbeat was sent at. Used to make sure we are
   /// keeping up with heartbeats.
   uint64_t last_heartbeat_at_ms_;
+  /// The time that the GCS last pulled a resource report from this node.
+  std::atomic<uint64_t> last_report_pulled_at_ms_{0};
+  /// The number of heartbeats skipped in a row because resource reports were flowing.
+  int64_t num_heartbeats_skipped_ = 0;
+};
+
+/// Writes the debug state of the raylet to a file from a background thread. The
+/// caller takes a snapshot of the components that live on the main thread, and the
+/// writer adds the event loop stats, which are thread safe, and does the file I/O, so
+/// that a dump only costs the main loop the snapshot.
+class DebugStateWriter {
+ public:
+  /// Create a debug state writer.
+  ///
+  /// \param path The file that the debug state is written to.
+  /// \param main_service The event loop whose stats are added to the debug state.
+  DebugStateWriter(std::string path, const instrumented_io_context &main_service);
+
+  ~DebugStateWriter();
+
+  /// Write a snapshot of the debug state, followed by the event loop stats. This is
+  /// thread safe, and returns before the file is written.
+  void Write(std::string snapshot);
+
+ private:
+  const std::string path_;
+  const instrumented_io_context &main_service_;
+  /// The io service that the file is written from.
+  instrumented_io_context io_service_;
+  std::unique_ptr<std::thread> thread_;
 };
 
 class NodeManager : public rpc::NodeManagerServiceHandler {
@@ -198,6 +236,17 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
                            const std::vector<rpc::ObjectReference> object_ids,
                            const JobID &job_id);
 
+  /// Create an object in plasma with the given data, e.g. to restore an object
+  /// from the compression tier of the local object manager.
+  ///
+  /// \param object_id The ID of the object.
+  /// \param owner_address The owner of the object.
+  /// \param object The data and metadata of the object.
+  /// \return OK if the object was created, or if it exists already.
+  Status RestoreObjectInPlasma(const ObjectID &object_id,
+                               const rpc::Address &owner_address,
+                               const RayObject &object);
+
   /// Stop this node manager.
   void Stop();
 
@@ -246,9 +295,17 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
   /// report to GCS.
   void FillResourceReport(rpc::ResourcesData &resources_data);
 
+  /// Push the resource report to the GCS if it changed since the previous report and
+  /// no report is in flight. Used instead of the GCS polling the raylet.
+  void PushResourceReport();
+
   /// Write out debug state to a file.
   void DumpDebugState() const;
 
+  /// The debug state of the components of the node manager, without the event loop
+  /// stats.
+  std::string ComponentsDebugString() const;
+
   /// Flush objects that are out of scope in the application. This will attempt
   /// to eagerly evict all plasma copies of the object from the cluster.
   void FlushObjectsToFree();
@@ -549,9 +606,33 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
                                  rpc::GetGcsServerAddressReply *reply,
                                  rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Handle a `DrainObjects` request.
+  void HandleDrainObjects(const rpc::DrainObjectsRequest &request,
+                          rpc::DrainObjectsReply *reply,
+                          rpc::SendReplyCallback send_reply_callback) override;
+
+  /// Start migrating the next primary copies of the ongoing drain, up to the limits
+  /// of object_migration_max_in_flight and object_migration_max_bytes_in_flight, or
+  /// reply to the drain request once all migrations finished.
+  void MigrateObjects();
+
+  /// Handle the end of the migration of a primary copy to another node.
+  ///
+  /// \param object_id The migrated object.
+  /// \param owner_address The owner of the object.
+  /// \param node_id The node that was asked to pin the object.
+  /// \param success Whether the node pinned the object.
+  void OnObjectMigrated(const ObjectID &object_id, const rpc::Address &owner_address,
+                        const NodeID &node_id, bool success);
+
   /// Trigger local GC on each worker of this raylet.
   void DoLocalGC();
 
+  /// Spill objects in the background once the object store usage, including the
+  /// creates waiting for space, goes above the high watermark, until it goes below
+  /// the low watermark.
+  void SpillObjectsAboveHighWatermark();
+
   /// Push an error to the driver if this node is full of actors and so we are
   /// unable to schedule new tasks or actors at all.
   void WarnResourceDeadlock();
@@ -615,6 +696,10 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
   std::shared_ptr<gcs::GcsClient> gcs_client_;
   /// Class to send heartbeat to GCS.
   std::unique_ptr<HeartbeatSender> heartbeat_sender_;
+  /// Writes the debug state dumps, if they are written in the background.
+  std::unique_ptr<DebugStateWriter> debug_state_writer_;
+  /// Samples the memory use of the node, to hold back tasks when it is short of memory.
+  std::unique_ptr<MemoryMonitor> memory_monitor_;
   /// A pool of workers.
   WorkerPool worker_pool_;
   /// The `ClientCallManager` object that is shared by all `NodeManagerClient`s
@@ -622,6 +707,9 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
   rpc::ClientCallManager client_call_manager_;
   /// Pool of RPC client connections to core workers.
   rpc::CoreWorkerClientPool worker_rpc_pool_;
+  /// Pool of RPC client connections to other raylets, used to relay resource
+  /// broadcasts down the broadcast tree.
+  rpc::NodeManagerClientPool raylet_client_pool_;
   /// The raylet client to initiate the pubsub to core workers (owners).
   /// It is used to subscribe objects to evict.
   std::unique_ptr<pubsub::SubscriberInterface> core_worker_subscriber_;
@@ -638,6 +726,8 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
   PeriodicalRunner periodical_runner_;
   /// The period used for the resources report timer.
   uint64_t report_resources_period_ms_;
+  /// Whether a pushed resource report hasn't been acknowledged by the GCS yet.
+  bool resource_report_in_flight_ = false;
   /// The time that the last resource report was sent at. Used to make sure we are
   /// keeping up with resource reports.
   uint64_t last_resource_report_at_ms_;
@@ -667,6 +757,9 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
   std::unique_ptr<rpc::AgentManagerServiceHandler> agent_manager_service_handler_;
   rpc::AgentManagerGrpcService agent_manager_service_;
 
+  /// Spills and restores objects without IO workers, if enabled.
+  std::unique_ptr<NativeObjectSpiller> native_object_spiller_;
+
   /// Manages all local objects that are pinned (primary
   /// copies), freed, and/or spilled.
   LocalObjectManager local_object_manager_;
@@ -675,6 +768,10 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
   absl::flat_hash_map<NodeID, std::pair<std::string, int32_t>>
       remote_node_manager_addresses_;
 
+  /// The total resources of the nodes fetched from the GCS when this node joined, that
+  /// haven't been added yet. Only used if raylet_fetch_all_node_resources_on_join.
+  absl::flat_hash_map<NodeID, ResourceSet> joining_node_resources_;
+
   /// Map of workers leased out to direct call clients.
   std::unordered_map<WorkerID, std::shared_ptr<WorkerInterface>> leased_workers_;
 
@@ -693,6 +790,10 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
   /// When plasma storage usage is high, we'll run gc to reduce it.
   double high_plasma_storage_usage_ = 1.0;
 
+  /// Whether the object store usage went above the high watermark of background
+  /// spilling, and didn't go below the low watermark yet.
+  bool spilling_above_low_watermark_ = false;
+
   /// the timestampe local gc run
   uint64_t local_gc_run_time_ns_;
 
@@ -720,6 +821,31 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
   /// Cache for the NodeTable in the GCS.
   absl::flat_hash_set<NodeID> failed_nodes_cache_;
 
+  /// Objects that an owner asked this node to replicate, which are being pulled
+  /// and will be pinned once they are local. Maps to the owner's address and
+  /// the pull request ID.
+  absl::flat_hash_map<ObjectID, std::pair<rpc::Address, uint64_t>> pending_replica_pins_;
+
+  /// Callbacks to call with whether a pending replica could be pinned, for the
+  /// requests that wait for their objects to be pinned.
+  absl::flat_hash_map<ObjectID, std::vector<std::function<void(bool)>>>
+      replica_pinned_callbacks_;
+
+  /// The state of an ongoing DrainObjects request.
+  struct ObjectDrain {
+    /// The primary copies left to migrate, with their owners and sizes.
+    std::deque<std::tuple<ObjectID, rpc::Address, int64_t>> pending;
+    /// The sizes of the objects being migrated.
+    absl::flat_hash_map<ObjectID, int64_t> in_flight;
+    int64_t bytes_in_flight = 0;
+    /// The nodes to migrate to, in round-robin order.
+    std::vector<rpc::Address> nodes;
+    size_t next_node = 0;
+    rpc::DrainObjectsReply *reply;
+    rpc::SendReplyCallback send_reply_callback;
+  };
+  std::unique_ptr<ObjectDrain> object_drain_;
+
   /// Concurrency for the following map
   mutable absl::Mutex plasma_object_notification_lock_;
 
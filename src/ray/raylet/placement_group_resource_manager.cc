@@ -78,8 +78,55 @@ bool NewPlacementGroupResourceManager::PrepareBundle(
   return true;
 }
 
+bool NewPlacementGroupResourceManager::PrepareBundles(
+    const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs) {
+  std::vector<std::shared_ptr<const BundleSpecification>> prepared_bundles;
+  for (const auto &bundle_spec : bundle_specs) {
+    // A bundle that is already committed is not locked by this call, so it must not be
+    // returned if a later bundle of the batch fails.
+    auto iter = pg_bundles_.find(bundle_spec->BundleId());
+    bool committed =
+        iter != pg_bundles_.end() && iter->second->state_ == CommitState::COMMITTED;
+    if (!PrepareBundle(*bundle_spec)) {
+      RAY_LOG(DEBUG) << "Failed to prepare bundle " << bundle_spec->DebugString()
+                     << ", return the resources of the " << prepared_bundles.size()
+                     << " bundles prepared before it.";
+      for (const auto &prepared_bundle : prepared_bundles) {
+        ReturnBundle(*prepared_bundle);
+        bundle_spec_map_.erase(prepared_bundle->BundleId());
+      }
+      return false;
+    }
+    if (!committed) {
+      prepared_bundles.push_back(bundle_spec);
+    }
+  }
+  return true;
+}
+
 void NewPlacementGroupResourceManager::CommitBundle(
     const BundleSpecification &bundle_spec) {
+  absl::flat_hash_set<std::string> resource_names;
+  if (AddBundleResources(bundle_spec, &resource_names)) {
+    OnBundleResourcesAdded(resource_names);
+  }
+}
+
+void NewPlacementGroupResourceManager::CommitBundles(
+    const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs) {
+  absl::flat_hash_set<std::string> resource_names;
+  bool added = false;
+  for (const auto &bundle_spec : bundle_specs) {
+    added = AddBundleResources(*bundle_spec, &resource_names) || added;
+  }
+  if (added) {
+    OnBundleResourcesAdded(resource_names);
+  }
+}
+
+bool NewPlacementGroupResourceManager::AddBundleResources(
+    const BundleSpecification &bundle_spec,
+    absl::flat_hash_set<std::string> *resource_names) {
   auto it = pg_bundles_.find(bundle_spec.BundleId());
   if (it == pg_bundles_.end()) {
     // We should only ever receive a commit for a non-existent placement group when a
@@ -87,12 +134,12 @@ void NewPlacementGroupResourceManager::CommitBundle(
     RAY_LOG(DEBUG)
         << "Received a commit message for an unknown bundle. The bundle info is "
         << bundle_spec.DebugString();
-    return;
+    return false;
   } else {
     // Ignore request If the bundle state is already committed.
     if (it->second->state_ == CommitState::COMMITTED) {
       RAY_LOG(DEBUG) << "Duplicate committ bundle request, skip it directly.";
-      return;
+      return false;
     }
   }
 
@@ -105,6 +152,7 @@ void NewPlacementGroupResourceManager::CommitBundle(
   for (const auto &resource : bundle_spec.GetFormattedResources()) {
     const auto &resource_name = resource.first;
     const auto &original_resource_name = GetOriginalResourceName(resource_name);
+    resource_names->insert(resource_name);
     if (original_resource_name != kBundle_ResourceLabel) {
       const auto &instances =
           task_resource_instances.Get(original_resource_name, string_id_map);
@@ -114,8 +162,13 @@ void NewPlacementGroupResourceManager::CommitBundle(
                                                              {resource.second});
     }
   }
+  return true;
+}
+
+void NewPlacementGroupResourceManager::OnBundleResourcesAdded(
+    const absl::flat_hash_set<std::string> &resource_names) {
   cluster_resource_scheduler_->UpdateLocalAvailableResourcesFromResourceInstances();
-  update_resources_(cluster_resource_scheduler_->GetResourceTotals());
+  update_resources_(cluster_resource_scheduler_->GetResourceTotals(resource_names));
 }
 
 void NewPlacementGroupResourceManager::ReturnBundle(
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "ray/common/bundle_spec.h"
 #include "ray/common/id.h"
 #include "ray/common/task/scheduling_resources.h"
@@ -56,12 +57,26 @@ class PlacementGroupResourceManager {
   /// \param bundle_spec: Specification of bundle whose resources will be prepared.
   virtual bool PrepareBundle(const BundleSpecification &bundle_spec) = 0;
 
+  /// Lock the required resources of a batch of bundles. Either all the bundles are
+  /// prepared, or the resources of the ones prepared by this call are returned.
+  ///
+  /// \param bundle_specs: Specifications of bundles whose resources will be prepared.
+  /// \return Whether all the bundles are prepared.
+  virtual bool PrepareBundles(
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs) = 0;
+
   /// Convert the required resources to placement group resources(like CPU ->
   /// CPU_group_i). This is phase two of 2PC.
   ///
   /// \param bundle_spec: Specification of bundle whose resources will be commited.
   virtual void CommitBundle(const BundleSpecification &bundle_spec) = 0;
 
+  /// Commit a batch of bundles.
+  ///
+  /// \param bundle_specs: Specifications of bundles whose resources will be commited.
+  virtual void CommitBundles(
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs) = 0;
+
   /// Return back all the bundle resource.
   ///
   /// \param bundle_spec: Specification of bundle whose resources will be returned.
@@ -100,8 +115,14 @@ class NewPlacementGroupResourceManager : public PlacementGroupResourceManager {
 
   bool PrepareBundle(const BundleSpecification &bundle_spec);
 
+  bool PrepareBundles(
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs);
+
   void CommitBundle(const BundleSpecification &bundle_spec);
 
+  void CommitBundles(
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs);
+
   void ReturnBundle(const BundleSpecification &bundle_spec);
 
   const std::shared_ptr<ClusterResourceScheduler> GetResourceScheduler() const {
@@ -109,6 +130,19 @@ class NewPlacementGroupResourceManager : public PlacementGroupResourceManager {
   }
 
  private:
+  /// Convert the prepared resources of a bundle to placement group resources, without
+  /// publishing the new resource totals.
+  ///
+  /// \param[out] resource_names The names of the placement group resources added.
+  /// \return Whether the bundle was committed by this call.
+  bool AddBundleResources(const BundleSpecification &bundle_spec,
+                          absl::flat_hash_set<std::string> *resource_names);
+
+  /// Publish the totals of the placement group resources added by committed bundles.
+  /// Only these resources are sent, so the size of the update does not grow with the
+  /// number of bundles already on the node.
+  void OnBundleResourcesAdded(const absl::flat_hash_set<std::string> &resource_names);
+
   std::shared_ptr<ClusterResourceScheduler> cluster_resource_scheduler_;
 
   /// Called when a new custom resource is created.
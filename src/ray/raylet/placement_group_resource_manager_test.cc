@@ -38,6 +38,7 @@ class NewPlacementGroupResourceManagerTest : public ::testing::Test {
             cluster_resource_scheduler_,
             [this](const ray::gcs::NodeResourceInfoAccessor::ResourceMap &resources) {
               update_called_ = true;
+              updated_resources_ = resources;
             },
             [this](const std::vector<std::string> &resource_names) {
               delete_called_ = true;
@@ -59,6 +60,7 @@ class NewPlacementGroupResourceManagerTest : public ::testing::Test {
 
   bool update_called_ = false;
   bool delete_called_ = false;
+  ray::gcs::NodeResourceInfoAccessor::ResourceMap updated_resources_;
 };
 
 TEST_F(NewPlacementGroupResourceManagerTest, TestNewPrepareBundleResource) {
@@ -90,6 +92,53 @@ TEST_F(NewPlacementGroupResourceManagerTest,
   ASSERT_FALSE(new_placement_group_resource_manager_->PrepareBundle(bundle_spec));
 }
 
+TEST_F(NewPlacementGroupResourceManagerTest, TestNewPrepareAndCommitBundles) {
+  // 1. create bundle specs.
+  auto group_id = PlacementGroupID::FromRandom();
+  std::unordered_map<std::string, double> unit_resource;
+  unit_resource.insert({"CPU", 1.0});
+  std::vector<std::shared_ptr<const BundleSpecification>> bundle_specs;
+  for (int index = 1; index <= 3; ++index) {
+    bundle_specs.push_back(std::make_shared<const BundleSpecification>(
+        Mocker::GenBundleCreation(group_id, index, unit_resource)));
+  }
+  /// 2. init local available resource.
+  std::unordered_map<std::string, double> init_unit_resource;
+  init_unit_resource.insert({"CPU", 2.0});
+  InitLocalAvailableResource(init_unit_resource);
+  /// 3. the third bundle does not fit, so none of the bundles are prepared.
+  ASSERT_FALSE(new_placement_group_resource_manager_->PrepareBundles(bundle_specs));
+  bundle_specs.pop_back();
+  /// 4. the resources of the failed batch were returned, so two bundles fit.
+  ASSERT_TRUE(new_placement_group_resource_manager_->PrepareBundles(bundle_specs));
+  CheckAvailableResoueceEmpty("CPU");
+  ASSERT_FALSE(update_called_);
+  new_placement_group_resource_manager_->CommitBundles(bundle_specs);
+  ASSERT_TRUE(update_called_);
+  // Only the placement group resources are published, the CPU total did not change.
+  ASSERT_EQ(updated_resources_.size(), 6u);
+  ASSERT_EQ(updated_resources_.count("CPU"), 0);
+  ASSERT_EQ(updated_resources_["CPU_group_" + group_id.Hex()]->resource_capacity(), 2.0);
+  /// 5. check remaining resources is correct.
+  std::unordered_map<std::string, double> remaining_resources = {
+      {"CPU_group_" + group_id.Hex(), 2.0},
+      {"CPU_group_1_" + group_id.Hex(), 1.0},
+      {"CPU_group_2_" + group_id.Hex(), 1.0},
+      {"CPU", 2.0},
+      {"bundle_group_1_" + group_id.Hex(), 1000},
+      {"bundle_group_2_" + group_id.Hex(), 1000},
+      {"bundle_group_" + group_id.Hex(), 2000}};
+  auto remaining_resource_scheduler =
+      std::make_shared<ClusterResourceScheduler>("remaining", remaining_resources);
+  std::shared_ptr<TaskResourceInstances> resource_instances =
+      std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(remaining_resource_scheduler->AllocateLocalTaskResources(
+      init_unit_resource, resource_instances));
+  auto remaining_resource_instance =
+      remaining_resource_scheduler->GetLocalNodeResources();
+  CheckRemainingResourceCorrect(remaining_resource_instance);
+}
+
 TEST_F(NewPlacementGroupResourceManagerTest, TestNewCommitBundleResource) {
   // 1. create bundle spec.
   auto group_id = PlacementGroupID::FromRandom();
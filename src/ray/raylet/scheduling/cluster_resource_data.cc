@@ -316,7 +316,7 @@ bool NodeResources::operator==(const NodeResources &other) {
 
 bool NodeResources::operator!=(const NodeResources &other) { return !(*this == other); }
 
-std::string NodeResources::DebugString(StringIdMap string_to_in_map) const {
+std::string NodeResources::DebugString(const StringIdMap &string_to_in_map) const {
   std::stringstream buffer;
   buffer << " {\n";
   for (size_t i = 0; i < this->predefined_resources.size(); i++) {
@@ -350,7 +350,7 @@ std::string NodeResources::DebugString(StringIdMap string_to_in_map) const {
   return buffer.str();
 }
 
-std::string NodeResources::DictString(StringIdMap string_to_in_map) const {
+std::string NodeResources::DictString(const StringIdMap &string_to_in_map) const {
   std::stringstream buffer;
   bool first = true;
   buffer << "{";
@@ -436,7 +436,8 @@ void TaskResourceInstances::ClearCPUInstances() {
   }
 }
 
-std::string NodeResourceInstances::DebugString(StringIdMap string_to_int_map) const {
+std::string NodeResourceInstances::DebugString(
+    const StringIdMap &string_to_int_map) const {
   std::stringstream buffer;
   buffer << "{\n";
   for (size_t i = 0; i < this->predefined_resources.size(); i++) {
@@ -148,13 +148,16 @@ class NodeResources {
   NodeResources(const NodeResources &other)
       : predefined_resources(other.predefined_resources),
         custom_resources(other.custom_resources),
-        object_pulls_queued(other.object_pulls_queued) {}
+        object_pulls_queued(other.object_pulls_queued),
+        memory_pressure(other.memory_pressure) {}
   /// Available and total capacities for predefined resources.
   std::vector<ResourceCapacity> predefined_resources;
   /// Map containing custom resources. The key of each entry represents the
   /// custom resource ID.
   absl::flat_hash_map<int64_t, ResourceCapacity> custom_resources;
   bool object_pulls_queued = false;
+  /// Whether the node is short of memory, including memory outside of the object store.
+  bool memory_pressure = false;
 
   /// Amongst CPU, memory, and object store memory, calculate the utilization percentage
   /// of each resource and return the highest.
@@ -170,9 +173,9 @@ class NodeResources {
   bool operator==(const NodeResources &other);
   bool operator!=(const NodeResources &other);
   /// Returns human-readable string for these resources.
-  std::string DebugString(StringIdMap string_to_int_map) const;
+  std::string DebugString(const StringIdMap &string_to_int_map) const;
   /// Returns compact dict-like string.
-  std::string DictString(StringIdMap string_to_int_map) const;
+  std::string DictString(const StringIdMap &string_to_int_map) const;
 };
 
 /// Total and available capacities of each resource instance.
@@ -189,7 +192,7 @@ class NodeResourceInstances {
   /// Returns if this equals another node resources.
   bool operator==(const NodeResourceInstances &other);
   /// Returns human-readable string for these resources.
-  std::string DebugString(StringIdMap string_to_int_map) const;
+  std::string DebugString(const StringIdMap &string_to_int_map) const;
 };
 
 struct Node {
@@ -202,6 +205,8 @@ struct Node {
 
   const NodeResources &GetLocalView() const { return local_view_; }
 
+  const NodeResources &GetLastReported() const { return last_reported_; }
+
  private:
   /// The resource information according to the last heartbeat reported by
   /// this node.
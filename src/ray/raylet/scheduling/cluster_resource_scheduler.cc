@@ -24,7 +24,8 @@ namespace ray {
 
 ClusterResourceScheduler::ClusterResourceScheduler()
     : hybrid_spillback_(RayConfig::instance().scheduler_hybrid_scheduling()),
-      spread_threshold_(RayConfig::instance().scheduler_spread_threshold())
+      spread_threshold_(RayConfig::instance().scheduler_spread_threshold()),
+      locality_weight_(RayConfig::instance().scheduler_locality_weight())
 
           {};
 
@@ -32,6 +33,7 @@ ClusterResourceScheduler::ClusterResourceScheduler(
     int64_t local_node_id, const NodeResources &local_node_resources)
     : hybrid_spillback_(RayConfig::instance().scheduler_hybrid_scheduling()),
       spread_threshold_(RayConfig::instance().scheduler_spread_threshold()),
+      locality_weight_(RayConfig::instance().scheduler_locality_weight()),
       local_node_id_(local_node_id),
       gen_(std::chrono::high_resolution_clock::now().time_since_epoch().count()) {
   InitResourceUnitInstanceInfo();
@@ -43,10 +45,13 @@ ClusterResourceScheduler::ClusterResourceScheduler(
     const std::string &local_node_id,
     const std::unordered_map<std::string, double> &local_node_resources,
     std::function<int64_t(void)> get_used_object_store_memory,
-    std::function<bool(void)> get_pull_manager_at_capacity)
+    std::function<bool(void)> get_pull_manager_at_capacity,
+    std::function<bool(void)> get_memory_pressure)
     : hybrid_spillback_(RayConfig::instance().scheduler_hybrid_scheduling()),
       spread_threshold_(RayConfig::instance().scheduler_spread_threshold()),
-      get_pull_manager_at_capacity_(get_pull_manager_at_capacity) {
+      locality_weight_(RayConfig::instance().scheduler_locality_weight()),
+      get_pull_manager_at_capacity_(get_pull_manager_at_capacity),
+      get_memory_pressure_(get_memory_pressure) {
   local_node_id_ = string_to_int_map_.Insert(local_node_id);
   NodeResources node_resources = ResourceMapToNodeResources(
       string_to_int_map_, local_node_resources, local_node_resources);
@@ -82,6 +87,32 @@ void ClusterResourceScheduler::InitResourceUnitInstanceInfo() {
   }
 }
 
+namespace {
+
+/// Whether any resource total of `after` exceeds the one of `before`, i.e. whether a
+/// request that didn't fit the totals of a node before may fit them now.
+bool AnyTotalIncreased(const NodeResources &before, const NodeResources &after) {
+  for (size_t i = 0; i < after.predefined_resources.size(); i++) {
+    const FixedPoint before_total = i < before.predefined_resources.size()
+                                        ? before.predefined_resources[i].total
+                                        : FixedPoint();
+    if (after.predefined_resources[i].total > before_total) {
+      return true;
+    }
+  }
+  for (const auto &entry : after.custom_resources) {
+    auto it = before.custom_resources.find(entry.first);
+    const FixedPoint before_total =
+        it == before.custom_resources.end() ? FixedPoint() : it->second.total;
+    if (entry.second.total > before_total) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
 void ClusterResourceScheduler::AddOrUpdateNode(
     const std::string &node_id,
     const std::unordered_map<std::string, double> &resources_total,
@@ -97,49 +128,89 @@ void ClusterResourceScheduler::AddOrUpdateNode(int64_t node_id,
   if (it == nodes_.end()) {
     // This node is new, so add it to the map.
     nodes_.emplace(node_id, node_resources);
+    resource_totals_version_++;
   } else {
     // This node exists, so update its resources.
+    if (AnyTotalIncreased(it->second.GetLocalView(), node_resources)) {
+      resource_totals_version_++;
+    }
     it->second = Node(node_resources);
   }
+  node_resource_matrix_.Update(node_id, node_resources);
+}
+
+namespace {
+
+/// The capacity of a resource of a node, which is added if the node does not have
+/// the resource yet.
+ResourceCapacity &GetMutableCapacity(StringIdMap &string_to_int_map,
+                                     NodeResources &node_resources,
+                                     const std::string &label) {
+  const auto resource = ResourceStringToEnum(label);
+  if (resource != PredefinedResources_MAX) {
+    return node_resources.predefined_resources[resource];
+  }
+  return node_resources.custom_resources[string_to_int_map.Insert(label)];
 }
 
+}  // namespace
+
 bool ClusterResourceScheduler::UpdateNode(const std::string &node_id_string,
                                           const rpc::ResourcesData &resource_data) {
   auto node_id = string_to_int_map_.Insert(node_id_string);
-  if (!nodes_.contains(node_id)) {
+  auto it = nodes_.find(node_id);
+  if (it == nodes_.end()) {
     return false;
   }
 
-  auto resources_total = MapFromProtobuf(resource_data.resources_total());
-  auto resources_available = MapFromProtobuf(resource_data.resources_available());
-  NodeResources node_resources = ResourceMapToNodeResources(
-      string_to_int_map_, resources_total, resources_available);
-  NodeResources local_view;
-  RAY_CHECK(GetNodeResources(node_id, &local_view));
-
-  if (resource_data.resources_total_size() > 0) {
-    for (size_t i = 0; i < node_resources.predefined_resources.size(); ++i) {
-      local_view.predefined_resources[i].total =
-          node_resources.predefined_resources[i].total;
+  // Reports can be relayed out of order. Drop the ones that are older than the last
+  // one we applied.
+  if (resource_data.resources_version() > 0) {
+    auto &version = node_resources_versions_[node_id];
+    if (resource_data.resources_version() <= version) {
+      return true;
     }
-    for (auto &entry : node_resources.custom_resources) {
-      local_view.custom_resources[entry.first].total = entry.second.total;
+    version = resource_data.resources_version();
+  }
+
+  // A delta only holds the resources that changed, so it is applied on top of the
+  // last reported resources. A full snapshot replaces them. If the availability did
+  // not change, keep the local view, which includes the tasks we spilled back there.
+  const bool is_delta = resource_data.resources_delta();
+  NodeResources node_resources = resource_data.resources_available_changed()
+                                     ? it->second.GetLastReported()
+                                     : it->second.GetLocalView();
+  node_resources.predefined_resources.resize(PredefinedResources_MAX);
+
+  if (!is_delta && resource_data.resources_total_size() > 0) {
+    for (auto &capacity : node_resources.predefined_resources) {
+      capacity.total = 0;
     }
   }
+  for (const auto &entry : resource_data.resources_total()) {
+    GetMutableCapacity(string_to_int_map_, node_resources, entry.first).total =
+        entry.second;
+  }
 
   if (resource_data.resources_available_changed()) {
-    for (size_t i = 0; i < node_resources.predefined_resources.size(); ++i) {
-      local_view.predefined_resources[i].available =
-          node_resources.predefined_resources[i].available;
+    if (!is_delta) {
+      // Resources that are missing from a full snapshot are not available.
+      for (auto &capacity : node_resources.predefined_resources) {
+        capacity.available = 0;
+      }
+      for (auto &entry : node_resources.custom_resources) {
+        entry.second.available = 0;
+      }
     }
-    for (auto &entry : node_resources.custom_resources) {
-      local_view.custom_resources[entry.first].available = entry.second.available;
+    for (const auto &entry : resource_data.resources_available()) {
+      GetMutableCapacity(string_to_int_map_, node_resources, entry.first).available =
+          entry.second;
     }
-
-    local_view.object_pulls_queued = resource_data.object_pulls_queued();
+    node_resources.object_pulls_queued = resource_data.object_pulls_queued();
+    node_resources.memory_pressure = resource_data.memory_pressure();
   }
 
-  AddOrUpdateNode(node_id, local_view);
+  AddOrUpdateNode(node_id, node_resources);
   return true;
 }
 
@@ -150,6 +221,8 @@ bool ClusterResourceScheduler::RemoveNode(int64_t node_id) {
     return false;
   } else {
     nodes_.erase(it);
+    node_resources_versions_.erase(node_id);
+    node_resource_matrix_.Remove(node_id);
     return true;
   }
 }
@@ -201,6 +274,11 @@ int64_t ClusterResourceScheduler::IsSchedulable(const ResourceRequest &resource_
     return -1;
   }
 
+  if (resources.memory_pressure && node_id != local_node_id_) {
+    // The local node holds back dispatching under memory pressure itself.
+    return -1;
+  }
+
   // First, check predefined resources.
   for (size_t i = 0; i < PredefinedResources_MAX; i++) {
     if (resource_request.predefined_resources[i] >
@@ -310,7 +388,8 @@ int64_t ClusterResourceScheduler::GetBestSchedulableNodeSimpleBinPack(
 
 int64_t ClusterResourceScheduler::GetBestSchedulableNode(
     const ResourceRequest &resource_request, bool actor_creation, bool force_spillback,
-    int64_t *total_violations, bool *is_infeasible) {
+    int64_t *total_violations, bool *is_infeasible,
+    const absl::flat_hash_map<int64_t, float> *arg_locality) {
   // The zero cpu actor is a special case that must be handled the same way by all
   // scheduling policies.
   if (actor_creation && resource_request.IsEmpty()) {
@@ -337,8 +416,8 @@ int64_t ClusterResourceScheduler::GetBestSchedulableNode(
   // TODO (Alex): Setting require_available == force_spillback is a hack in order to
   // remain bug compatible with the legacy scheduling algorithms.
   int64_t best_node_id = raylet_scheduling_policy::HybridPolicy(
-      resource_request, local_node_id_, nodes_, spread_threshold_, force_spillback,
-      force_spillback);
+      resource_request, local_node_id_, nodes_, node_resource_matrix_, spread_threshold_,
+      force_spillback, force_spillback, arg_locality, locality_weight_);
   *is_infeasible = best_node_id == -1 ? true : false;
   if (!*is_infeasible) {
     // TODO (Alex): Support soft constraints if needed later.
@@ -355,11 +434,22 @@ int64_t ClusterResourceScheduler::GetBestSchedulableNode(
 std::string ClusterResourceScheduler::GetBestSchedulableNode(
     const std::unordered_map<std::string, double> &task_resources,
     bool requires_object_store_memory, bool actor_creation, bool force_spillback,
-    int64_t *total_violations, bool *is_infeasible) {
+    int64_t *total_violations, bool *is_infeasible,
+    const std::unordered_map<std::string, float> *arg_locality) {
   ResourceRequest resource_request = ResourceMapToResourceRequest(
       string_to_int_map_, task_resources, requires_object_store_memory);
+  absl::flat_hash_map<int64_t, float> arg_locality_by_id;
+  if (arg_locality != nullptr) {
+    for (const auto &entry : *arg_locality) {
+      const int64_t node_id = string_to_int_map_.Get(entry.first);
+      if (node_id != -1) {
+        arg_locality_by_id[node_id] = entry.second;
+      }
+    }
+  }
   int64_t node_id = GetBestSchedulableNode(
-      resource_request, actor_creation, force_spillback, total_violations, is_infeasible);
+      resource_request, actor_creation, force_spillback, total_violations, is_infeasible,
+      arg_locality != nullptr ? &arg_locality_by_id : nullptr);
 
   std::string id_string;
   if (node_id == -1) {
@@ -405,6 +495,7 @@ bool ClusterResourceScheduler::SubtractRemoteNodeAvailableResources(
   // arguments. Right now we do not modify object_pulls_queued in case of
   // performance regressions in spillback.
 
+  node_resource_matrix_.Update(node_id, *resources);
   return true;
 }
 
@@ -459,6 +550,7 @@ void ClusterResourceScheduler::AddLocalResourceInstances(
     node_instances->total[i] =
         std::max(node_instances->total[i], node_instances->available[i]);
   }
+  resource_totals_version_++;
   UpdateLocalAvailableResourcesFromResourceInstances();
 }
 
@@ -522,6 +614,7 @@ void ClusterResourceScheduler::UpdateResourceCapacity(const std::string &node_id
 
   auto local_view = it->second.GetMutableLocalView();
   FixedPoint resource_total_fp(resource_total);
+  resource_totals_version_++;
   if (idx != -1) {
     auto diff_capacity = resource_total_fp - local_view->predefined_resources[idx].total;
     local_view->predefined_resources[idx].total += diff_capacity;
@@ -552,6 +645,7 @@ void ClusterResourceScheduler::UpdateResourceCapacity(const std::string &node_id
       local_view->custom_resources.emplace(resource_id, resource_capacity);
     }
   }
+  node_resource_matrix_.Update(node_id, *local_view);
 }
 
 void ClusterResourceScheduler::DeleteLocalResource(const std::string &resource_name) {
@@ -599,6 +693,7 @@ void ClusterResourceScheduler::DeleteResource(const std::string &node_id_string,
       local_resources_.custom_resources.erase(c_itr);
     }
   }
+  node_resource_matrix_.Update(node_id, *local_view);
 }
 
 std::string ClusterResourceScheduler::SerializedTaskResourceInstances(
@@ -651,12 +746,9 @@ std::string ClusterResourceScheduler::DebugString(void) const {
 void ClusterResourceScheduler::InitResourceInstances(
     FixedPoint total, bool unit_instances, ResourceInstanceCapacities *instance_list) {
   if (unit_instances) {
-    size_t num_instances = static_cast<size_t>(total.Double());
-    instance_list->total.resize(num_instances);
-    instance_list->available.resize(num_instances);
-    for (size_t i = 0; i < num_instances; i++) {
-      instance_list->total[i] = instance_list->available[i] = 1.0;
-    };
+    size_t num_instances = static_cast<size_t>(total.Raw() / RESOURCE_UNIT_SCALING);
+    instance_list->total.assign(num_instances, 1);
+    instance_list->available.assign(num_instances, 1);
   } else {
     instance_list->total.resize(1);
     instance_list->available.resize(1);
@@ -701,7 +793,7 @@ void ClusterResourceScheduler::InitLocalResources(const NodeResources &node_reso
 
 std::vector<FixedPoint> ClusterResourceScheduler::AddAvailableResourceInstances(
     std::vector<FixedPoint> available, ResourceInstanceCapacities *resource_instances) {
-  std::vector<FixedPoint> overflow(available.size(), 0.);
+  std::vector<FixedPoint> overflow(available.size(), 0);
   for (size_t i = 0; i < available.size(); i++) {
     resource_instances->available[i] = resource_instances->available[i] + available[i];
     if (resource_instances->available[i] > resource_instances->total[i]) {
@@ -718,7 +810,7 @@ std::vector<FixedPoint> ClusterResourceScheduler::SubtractAvailableResourceInsta
     bool allow_going_negative) {
   RAY_CHECK(available.size() == resource_instances->available.size());
 
-  std::vector<FixedPoint> underflow(available.size(), 0.);
+  std::vector<FixedPoint> underflow(available.size(), 0);
   for (size_t i = 0; i < available.size(); i++) {
     if (resource_instances->available[i] < 0) {
       if (allow_going_negative) {
@@ -740,7 +832,7 @@ std::vector<FixedPoint> ClusterResourceScheduler::SubtractAvailableResourceInsta
 
 bool ClusterResourceScheduler::AllocateResourceInstances(
     FixedPoint demand, std::vector<FixedPoint> &available,
-    std::vector<FixedPoint> *allocation) {
+    std::vector<FixedPoint> *allocation, const GpuDistances *distances) {
   allocation->resize(available.size());
   FixedPoint remaining_demand = demand;
 
@@ -767,29 +859,42 @@ bool ClusterResourceScheduler::AllocateResourceInstances(
   // If resource constraint is soft, allocate as many full unit-capacity resources and
   // then distribute remaining_demand across remaining instances. Note that in case we can
   // overallocate this resource.
-  if (remaining_demand >= 1.) {
+  const FixedPoint unit(1);
+  if (distances != nullptr && remaining_demand >= FixedPoint(2)) {
+    std::vector<bool> is_free;
+    for (const auto &capacity : available) {
+      is_free.push_back(capacity == unit);
+    }
+    for (size_t i : PickClosestInstances(
+             is_free, static_cast<size_t>(remaining_demand.Double()), *distances)) {
+      (*allocation)[i] = unit;
+      available[i] = 0;
+      remaining_demand -= unit;
+    }
+  }
+  if (remaining_demand >= unit) {
     for (size_t i = 0; i < available.size(); i++) {
-      if (available[i] == 1.) {
+      if (available[i] == unit) {
         // Allocate a full unit-capacity instance.
-        (*allocation)[i] = 1.;
+        (*allocation)[i] = unit;
         available[i] = 0;
-        remaining_demand -= 1.;
+        remaining_demand -= unit;
       }
-      if (remaining_demand < 1.) {
+      if (remaining_demand < unit) {
         break;
       }
     }
   }
 
-  if (remaining_demand >= 1.) {
+  if (remaining_demand >= unit) {
     // Cannot satisfy a demand greater than one if no unit capacity resource is available.
     return false;
   }
 
   // Remaining demand is fractional. Find the best fit, if exists.
-  if (remaining_demand > 0.) {
+  if (remaining_demand > 0) {
     int64_t idx_best_fit = -1;
-    FixedPoint available_best_fit = 1.;
+    FixedPoint available_best_fit = unit;
     for (size_t i = 0; i < available.size(); i++) {
       if (available[i] >= remaining_demand) {
         if (idx_best_fit == -1 ||
@@ -819,9 +924,12 @@ bool ClusterResourceScheduler::AllocateTaskResourceInstances(
   task_allocation->predefined_resources.resize(PredefinedResources_MAX);
   for (size_t i = 0; i < PredefinedResources_MAX; i++) {
     if (resource_request.predefined_resources[i] > 0) {
+      const GpuDistances *distances =
+          i == GPU && !gpu_distances_.empty() ? &gpu_distances_ : nullptr;
       if (!AllocateResourceInstances(resource_request.predefined_resources[i],
                                      local_resources_.predefined_resources[i].available,
-                                     &task_allocation->predefined_resources[i])) {
+                                     &task_allocation->predefined_resources[i],
+                                     distances)) {
         // Allocation failed. Restore node's local resources by freeing the resources
         // of the failed allocation.
         FreeTaskResourceInstances(task_allocation);
@@ -867,6 +975,7 @@ void ClusterResourceScheduler::UpdateLocalAvailableResourcesFromResourceInstance
           local_resources_.predefined_resources[i].available[j];
     }
   }
+  node_resource_matrix_.Update(local_node_id_, *local_view);
 
   for (auto &custom_resource : local_resources_.custom_resources) {
     int64_t resource_name = custom_resource.first;
@@ -877,8 +986,12 @@ void ClusterResourceScheduler::UpdateLocalAvailableResourcesFromResourceInstance
     FixedPoint total =
         std::accumulate(instances.total.begin(), instances.total.end(), FixedPoint());
 
-    local_view->custom_resources[resource_name].available = available;
-    local_view->custom_resources[resource_name].total = total;
+    auto &capacity = local_view->custom_resources[resource_name];
+    if (total > capacity.total) {
+      resource_totals_version_++;
+    }
+    capacity.available = available;
+    capacity.total = total;
   }
 }
 
@@ -1012,6 +1125,33 @@ bool ClusterResourceScheduler::AllocateRemoteTaskResources(
   return SubtractRemoteNodeAvailableResources(node_id, resource_request);
 }
 
+void ClusterResourceScheduler::ReleaseRemoteTaskResources(
+    const std::string &node_string,
+    const std::unordered_map<std::string, double> &task_resources) {
+  ResourceRequest resource_request = ResourceMapToResourceRequest(
+      string_to_int_map_, task_resources, /*requires_object_store_memory=*/false);
+  auto node_id = string_to_int_map_.Insert(node_string);
+  RAY_CHECK(node_id != local_node_id_);
+  auto it = nodes_.find(node_id);
+  if (it == nodes_.end()) {
+    return;
+  }
+  NodeResources *resources = it->second.GetMutableLocalView();
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    auto &capacity = resources->predefined_resources[i];
+    capacity.available = std::min(
+        capacity.total, capacity.available + resource_request.predefined_resources[i]);
+  }
+  for (const auto &task_req_custom_resource : resource_request.custom_resources) {
+    auto it = resources->custom_resources.find(task_req_custom_resource.first);
+    if (it != resources->custom_resources.end()) {
+      it->second.available = std::min(
+          it->second.total, it->second.available + task_req_custom_resource.second);
+    }
+  }
+  node_resource_matrix_.Update(node_id, *resources);
+}
+
 void ClusterResourceScheduler::ReleaseWorkerResources(
     std::shared_ptr<TaskResourceInstances> task_allocation) {
   if (task_allocation == nullptr || task_allocation->IsEmpty()) {
@@ -1050,6 +1190,7 @@ void ClusterResourceScheduler::FillResourceUsage(rpc::ResourcesData &resources_d
   for (auto &node : nodes_) {
     if (node.first != local_node_id_) {
       node.second.ResetLocalView();
+      node_resource_matrix_.Update(node.first, node.second.GetLocalView());
     }
   }
 
@@ -1062,50 +1203,79 @@ void ClusterResourceScheduler::FillResourceUsage(rpc::ResourcesData &resources_d
     capacity.available = FixedPoint(capacity.total.Double() - used);
   }
 
-  for (int i = 0; i < PredefinedResources_MAX; i++) {
-    const auto &label = ResourceEnumToString((PredefinedResources)i);
-    const auto &capacity = resources.predefined_resources[i];
-    const auto &last_capacity = last_report_resources_->predefined_resources[i];
-    // Note: available may be negative, but only report positive to GCS.
-    if (capacity.available != last_capacity.available && capacity.available > 0) {
+  // Every `resource_report_full_snapshot_interval` reports carry all resources, so
+  // that receivers which missed a delta converge. The others only carry the
+  // resources that changed since the previous report.
+  const bool full_snapshot =
+      !RayConfig::instance().enable_light_weight_resource_report() ||
+      num_reports_since_full_snapshot_ == 0;
+  num_reports_since_full_snapshot_ =
+      (num_reports_since_full_snapshot_ + 1) %
+      std::max<uint64_t>(
+          1, RayConfig::instance().resource_report_full_snapshot_interval());
+  resources_data.set_resources_version(++resources_version_);
+  resources_data.set_resources_delta(!full_snapshot);
+  if (full_snapshot) {
+    resources_data.set_resources_available_changed(true);
+  }
+
+  auto fill_capacity = [&resources_data, full_snapshot](
+                           const std::string &label, const ResourceCapacity &capacity,
+                           const ResourceCapacity &last_capacity) {
+    // Note: available may be negative, but only report positive to GCS. A full
+    // snapshot leaves out unavailable resources, while a delta reports them as 0
+    // so that the receiver does not keep the old value.
+    if (full_snapshot) {
+      if (capacity.available > 0) {
+        (*resources_data.mutable_resources_available())[label] =
+            capacity.available.Double();
+      }
+      if (capacity.total > 0) {
+        (*resources_data.mutable_resources_total())[label] = capacity.total.Double();
+      }
+      return;
+    }
+    if (capacity.available != last_capacity.available &&
+        (capacity.available > 0 || last_capacity.available > 0)) {
       resources_data.set_resources_available_changed(true);
       (*resources_data.mutable_resources_available())[label] =
-          capacity.available.Double();
+          std::max(FixedPoint(0), capacity.available).Double();
     }
     if (capacity.total != last_capacity.total) {
       (*resources_data.mutable_resources_total())[label] = capacity.total.Double();
     }
+  };
+  for (int i = 0; i < PredefinedResources_MAX; i++) {
+    fill_capacity(ResourceEnumToString((PredefinedResources)i),
+                  resources.predefined_resources[i],
+                  last_report_resources_->predefined_resources[i]);
   }
   for (const auto &it : resources.custom_resources) {
     uint64_t custom_id = it.first;
-    const auto &capacity = it.second;
-    const auto &last_capacity = last_report_resources_->custom_resources[custom_id];
-    const auto &label = string_to_int_map_.Get(custom_id);
-    // Note: available may be negative, but only report positive to GCS.
-    if (capacity.available != last_capacity.available && capacity.available > 0) {
-      resources_data.set_resources_available_changed(true);
-      (*resources_data.mutable_resources_available())[label] =
-          capacity.available.Double();
-    }
-    if (capacity.total != last_capacity.total) {
-      (*resources_data.mutable_resources_total())[label] = capacity.total.Double();
-    }
+    fill_capacity(string_to_int_map_.Get(custom_id), it.second,
+                  last_report_resources_->custom_resources[custom_id]);
   }
 
   if (get_pull_manager_at_capacity_ != nullptr) {
     resources.object_pulls_queued = get_pull_manager_at_capacity_();
     if (last_report_resources_->object_pulls_queued != resources.object_pulls_queued) {
-      resources_data.set_object_pulls_queued(resources.object_pulls_queued);
       resources_data.set_resources_available_changed(true);
     }
   }
+  // Receivers take this flag whenever the available resources changed, so it is
+  // always set to the current value.
+  resources_data.set_object_pulls_queued(resources.object_pulls_queued);
 
-  if (resources != *last_report_resources_.get()) {
-    last_report_resources_.reset(new NodeResources(resources));
+  if (get_memory_pressure_ != nullptr) {
+    resources.memory_pressure = get_memory_pressure_();
+    if (last_report_resources_->memory_pressure != resources.memory_pressure) {
+      resources_data.set_resources_available_changed(true);
+    }
   }
+  resources_data.set_memory_pressure(resources.memory_pressure);
 
-  if (!RayConfig::instance().enable_light_weight_resource_report()) {
-    resources_data.set_resources_available_changed(true);
+  if (resources != *last_report_resources_.get()) {
+    last_report_resources_.reset(new NodeResources(resources));
   }
 }
 
@@ -1132,8 +1302,8 @@ ClusterResourceScheduler::GetResourceTotals() const {
     }
   }
 
-  for (auto entry : local_resources.custom_resources) {
-    std::string resource_name = string_to_int_map_.Get(entry.first);
+  for (const auto &entry : local_resources.custom_resources) {
+    const auto &resource_name = string_to_int_map_.Get(entry.first);
     double resource_total = entry.second.total.Double();
     if (resource_total > 0) {
       auto data = std::make_shared<rpc::ResourceTableData>();
@@ -1144,4 +1314,37 @@ ClusterResourceScheduler::GetResourceTotals() const {
   return map;
 }
 
+ray::gcs::NodeResourceInfoAccessor::ResourceMap
+ClusterResourceScheduler::GetResourceTotals(
+    const absl::flat_hash_set<std::string> &resource_names) const {
+  ray::gcs::NodeResourceInfoAccessor::ResourceMap map;
+  auto it = nodes_.find(local_node_id_);
+  RAY_CHECK(it != nodes_.end());
+  const auto &local_resources = it->second.GetLocalView();
+  for (size_t i = 0; i < local_resources.predefined_resources.size(); i++) {
+    std::string resource_name = ResourceEnumToString(static_cast<PredefinedResources>(i));
+    double resource_total = local_resources.predefined_resources[i].total.Double();
+    if (resource_total > 0 && resource_names.contains(resource_name)) {
+      auto data = std::make_shared<rpc::ResourceTableData>();
+      data->set_resource_capacity(resource_total);
+      map.emplace(resource_name, std::move(data));
+    }
+  }
+
+  for (const auto &resource_name : resource_names) {
+    auto entry =
+        local_resources.custom_resources.find(string_to_int_map_.Get(resource_name));
+    if (entry == local_resources.custom_resources.end()) {
+      continue;
+    }
+    double resource_total = entry->second.total.Double();
+    if (resource_total > 0) {
+      auto data = std::make_shared<rpc::ResourceTableData>();
+      data->set_resource_capacity(resource_total);
+      map.emplace(resource_name, std::move(data));
+    }
+  }
+  return map;
+}
+
 }  // namespace ray
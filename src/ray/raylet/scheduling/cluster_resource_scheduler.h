@@ -25,6 +25,8 @@
 #include "ray/raylet/scheduling/cluster_resource_data.h"
 #include "ray/raylet/scheduling/cluster_resource_scheduler_interface.h"
 #include "ray/raylet/scheduling/fixed_point.h"
+#include "ray/raylet/scheduling/gpu_topology.h"
+#include "ray/raylet/scheduling/node_resource_matrix.h"
 #include "ray/raylet/scheduling/scheduling_ids.h"
 #include "ray/util/logging.h"
 #include "src/ray/protobuf/gcs.pb.h"
@@ -50,7 +52,8 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
       const std::string &local_node_id,
       const std::unordered_map<std::string, double> &local_node_resources,
       std::function<int64_t(void)> get_used_object_store_memory = nullptr,
-      std::function<bool(void)> get_pull_manager_at_capacity = nullptr);
+      std::function<bool(void)> get_pull_manager_at_capacity = nullptr,
+      std::function<bool(void)> get_memory_pressure = nullptr);
 
   // Mapping from predefined resource indexes to resource strings
   std::string GetResourceNameFromIndex(int64_t res_idx);
@@ -66,6 +69,8 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
       const std::unordered_map<std::string, double> &resource_map_available);
 
   /// Update node resources. This hanppens when a node resource usage udpated.
+  /// Deltas are applied on top of the last report of the node, and reports older
+  /// than the last applied one are ignored.
   ///
   /// \param node_id_string ID of the node which resoruces need to be udpated.
   /// \param resource_data The node resource data.
@@ -158,12 +163,15 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   ///                     a node that can schedule resource_request is found).
   ///  \param is_infeasible[in]: It is set true if the task is not schedulable because it
   ///  is infeasible.
+  ///  \param arg_locality: If given, the fraction of the argument bytes of the task
+  ///  on each node, which the hybrid policy uses to prefer nodes that hold them.
   ///
   ///  \return -1, if no node can schedule the current request; otherwise,
   ///          return the ID of a node that can schedule the resource request.
-  int64_t GetBestSchedulableNode(const ResourceRequest &resource_request,
-                                 bool actor_creation, bool force_spillback,
-                                 int64_t *violations, bool *is_infeasible);
+  int64_t GetBestSchedulableNode(
+      const ResourceRequest &resource_request, bool actor_creation, bool force_spillback,
+      int64_t *violations, bool *is_infeasible,
+      const absl::flat_hash_map<int64_t, float> *arg_locality = nullptr);
 
   /// Similar to
   ///    int64_t GetBestSchedulableNode(const ResourceRequest &resource_request, int64_t
@@ -172,10 +180,12 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   /// \return "", if no node can schedule the current request; otherwise,
   ///          return the ID in string format of a node that can schedule the
   //           resource request.
+  /// The keys of `arg_locality` are node IDs in binary format.
   std::string GetBestSchedulableNode(
       const std::unordered_map<std::string, double> &resource_request,
       bool requires_object_store_memory, bool actor_creation, bool force_spillback,
-      int64_t *violations, bool *is_infeasible);
+      int64_t *violations, bool *is_infeasible,
+      const std::unordered_map<std::string, float> *arg_locality = nullptr);
 
   /// Return resources associated to the given node_id in ret_resources.
   /// If node_id not found, return false; otherwise return true.
@@ -187,6 +197,17 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   /// Get number of nodes in the cluster.
   int64_t NumNodes() const;
 
+  /// A counter that is bumped whenever the resource total of a node may have
+  /// increased, or a node was added. Requests that were infeasible can only become
+  /// feasible after it changed.
+  uint64_t GetResourceTotalsVersion() const { return resource_totals_version_; }
+
+  /// Set the distances between the GPUs of the local node, so that tasks that need
+  /// several GPUs get the closest ones.
+  ///
+  /// \param distances: The distances between the GPU instances.
+  void SetGpuTopology(GpuDistances distances) { gpu_distances_ = std::move(distances); }
+
   /// Temporarily get the StringIDMap.
   const StringIdMap &GetStringIdMap() const;
 
@@ -274,11 +295,14 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   /// \param available: List of available capacities of the instances of the resource.
   /// \param allocation: List of instance capacities allocated to satisfy the demand.
   /// This is a return parameter.
+  /// \param distances: Optional distances between the instances. If set, a demand of
+  /// several whole instances gets the closest free instances, instead of the first.
   ///
   /// \return true, if allocation successful. In this case, the sum of the elements in
   /// "allocation" is equal to "demand".
   bool AllocateResourceInstances(FixedPoint demand, std::vector<FixedPoint> &available,
-                                 std::vector<FixedPoint> *allocation);
+                                 std::vector<FixedPoint> *allocation,
+                                 const GpuDistances *distances = nullptr);
 
   /// Allocate local resources to satisfy a given request (resource_request).
   ///
@@ -383,6 +407,15 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
       const std::string &node_id,
       const std::unordered_map<std::string, double> &task_resources);
 
+  /// Give back resources taken by `AllocateRemoteTaskResources` to our view of a
+  /// remote node.
+  ///
+  /// \param node_id Remote node whose resources we release.
+  /// \param task_resources Resources that were allocated on the node.
+  void ReleaseRemoteTaskResources(
+      const std::string &node_id,
+      const std::unordered_map<std::string, double> &task_resources);
+
   void ReleaseWorkerResources(std::shared_ptr<TaskResourceInstances> task_allocation);
 
   /// Update the available resources of the local node given
@@ -398,7 +431,9 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
 
   /// Populate the relevant parts of the heartbeat table. This is intended for
   /// sending resource usage of raylet to gcs. In particular, this should fill in
-  /// resources_available and resources_total.
+  /// resources_available and resources_total. Most reports only hold the resources
+  /// that changed since the previous one; every
+  /// `resource_report_full_snapshot_interval` reports hold all of them.
   ///
   /// \param Output parameter. `resources_available` and `resources_total` are the only
   /// fields used.
@@ -407,6 +442,12 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   /// \return The total resource capacity of the node.
   ray::gcs::NodeResourceInfoAccessor::ResourceMap GetResourceTotals() const override;
 
+  /// \param resource_names The names of the resources to report.
+  /// \return The total capacity of the given resources of the node. Resources the node
+  /// does not have are left out.
+  ray::gcs::NodeResourceInfoAccessor::ResourceMap GetResourceTotals(
+      const absl::flat_hash_set<std::string> &resource_names) const;
+
   /// Update last report resources local cache from gcs cache,
   /// this is needed when gcs fo.
   ///
@@ -445,9 +486,14 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   const bool hybrid_spillback_;
   /// The threshold at which to switch from packing to spreading.
   const float spread_threshold_;
+  /// The weight of argument locality in the hybrid policy.
+  const float locality_weight_;
   /// List of nodes in the clusters and their resources organized as a map.
   /// The key of the map is the node ID.
   absl::flat_hash_map<int64_t, Node> nodes_;
+  /// The predefined resources of the local views in `nodes_`, for the scheduling
+  /// policy. Must be updated whenever a local view changes.
+  NodeResourceMatrix node_resource_matrix_;
   /// Identifier of local node.
   int64_t local_node_id_;
   /// Internally maintained random number generator.
@@ -459,10 +505,22 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   StringIdMap string_to_int_map_;
   /// Cached resources, used to compare with newest one in light heartbeat mode.
   std::unique_ptr<NodeResources> last_report_resources_;
+  /// The version of the last resource report of the local node.
+  uint64_t resources_version_ = 0;
+  /// The number of resource reports sent since the last full snapshot.
+  uint64_t num_reports_since_full_snapshot_ = 0;
+  /// The version of the last resource report applied for each remote node.
+  absl::flat_hash_map<int64_t, uint64_t> node_resources_versions_;
+  /// See `GetResourceTotalsVersion`.
+  uint64_t resource_totals_version_ = 1;
+  /// The distances between the GPUs of the local node, or empty if unknown.
+  GpuDistances gpu_distances_;
   /// Function to get used object store memory.
   std::function<int64_t(void)> get_used_object_store_memory_;
   /// Function to get whether the pull manager is at capacity.
   std::function<bool(void)> get_pull_manager_at_capacity_;
+  /// Function to get whether the local node is short of memory.
+  std::function<bool(void)> get_memory_pressure_;
 
   // Specify predefine resources that consists of unit-size instances.
   std::unordered_set<int64_t> predefined_unit_instance_resources_{};
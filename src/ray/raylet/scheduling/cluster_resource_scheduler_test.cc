@@ -14,8 +14,10 @@
 
 #include "ray/raylet/scheduling/cluster_resource_scheduler.h"
 
+#include <random>
 #include <string>
 
+#include "absl/time/clock.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ray/common/ray_config.h"
@@ -230,6 +232,19 @@ TEST_F(ClusterResourceSchedulerTest, SchedulingFixedPointTest) {
 
     ASSERT_TRUE(fp1.Double() == 1.);
   }
+
+  {
+    // Conversions from double round to the nearest unit instead of truncating, and
+    // integer conversions are exact.
+    ASSERT_EQ(FixedPoint(0.3).Raw(), 3000);
+    ASSERT_EQ(FixedPoint(-0.3).Raw(), -3000);
+    int64_t bytes = (int64_t{1} << 40) + 1;
+    ASSERT_EQ(FixedPoint(bytes).Raw(), bytes * RESOURCE_UNIT_SCALING);
+    ASSERT_EQ(FixedPoint::FromRaw(5), FixedPoint(0.0005));
+    FixedPoint fp1(1.);
+    fp1 += int64_t{2};
+    ASSERT_EQ(fp1, 3);
+  }
 }
 
 TEST_F(ClusterResourceSchedulerTest, SchedulingIdTest) {
@@ -1097,6 +1112,50 @@ TEST_F(ClusterResourceSchedulerTest, DirtyLocalViewTest) {
   }
 }
 
+TEST_F(ClusterResourceSchedulerTest, ResourceUsageDeltaTest) {
+  ClusterResourceScheduler local_scheduler("local", {{"CPU", 1}});
+  ClusterResourceScheduler remote_scheduler("remote", {{"CPU", 2}, {"GPU", 1}});
+  local_scheduler.AddOrUpdateNode("remote", {}, {});
+  const std::unordered_map<std::string, double> cpu_request = {{"CPU", 2}};
+  const std::unordered_map<std::string, double> gpu_request = {{"GPU", 1}};
+  int64_t t;
+  bool is_infeasible;
+
+  // The first report is a full snapshot.
+  rpc::ResourcesData snapshot;
+  remote_scheduler.FillResourceUsage(snapshot);
+  ASSERT_FALSE(snapshot.resources_delta());
+  ASSERT_TRUE(local_scheduler.UpdateNode("remote", snapshot));
+  ASSERT_EQ(local_scheduler.GetBestSchedulableNode(gpu_request, false, false, false, &t,
+                                                   &is_infeasible),
+            "remote");
+
+  // The next one only holds the GPUs, which are now in use.
+  std::shared_ptr<TaskResourceInstances> allocation =
+      std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(remote_scheduler.AllocateLocalTaskResources(gpu_request, allocation));
+  rpc::ResourcesData delta;
+  remote_scheduler.FillResourceUsage(delta);
+  ASSERT_TRUE(delta.resources_delta());
+  ASSERT_GT(delta.resources_version(), snapshot.resources_version());
+  ASSERT_EQ(delta.resources_total().size(), 0);
+  ASSERT_EQ(delta.resources_available().size(), 1);
+  ASSERT_EQ(delta.resources_available().at("GPU"), 0);
+  ASSERT_TRUE(local_scheduler.UpdateNode("remote", delta));
+  ASSERT_EQ(local_scheduler.GetBestSchedulableNode(gpu_request, false, false, false, &t,
+                                                   &is_infeasible),
+            "");
+  ASSERT_EQ(local_scheduler.GetBestSchedulableNode(cpu_request, false, false, false, &t,
+                                                   &is_infeasible),
+            "remote");
+
+  // A report that arrives late is ignored.
+  ASSERT_TRUE(local_scheduler.UpdateNode("remote", snapshot));
+  ASSERT_EQ(local_scheduler.GetBestSchedulableNode(gpu_request, false, false, false, &t,
+                                                   &is_infeasible),
+            "");
+}
+
 TEST_F(ClusterResourceSchedulerTest, DynamicResourceTest) {
   ClusterResourceScheduler resource_scheduler("local", {{"CPU", 2}});
 
@@ -1131,6 +1190,70 @@ TEST_F(ClusterResourceSchedulerTest, DynamicResourceTest) {
   ASSERT_TRUE(result.empty());
 }
 
+TEST_F(ClusterResourceSchedulerTest, ResourceTotalsVersionTest) {
+  ClusterResourceScheduler resource_scheduler("local", {{"CPU", 2}});
+  uint64_t version = resource_scheduler.GetResourceTotalsVersion();
+
+  // A new node may make requests feasible.
+  resource_scheduler.AddOrUpdateNode("remote", {{"CPU", 2}}, {{"CPU", 2}});
+  ASSERT_GT(resource_scheduler.GetResourceTotalsVersion(), version);
+  version = resource_scheduler.GetResourceTotalsVersion();
+
+  // Changes of the available resources or shrinking totals don't.
+  resource_scheduler.AddOrUpdateNode("remote", {{"CPU", 2}}, {{"CPU", 1}});
+  resource_scheduler.AddOrUpdateNode("remote", {{"CPU", 1}}, {{"CPU", 1}});
+  std::unordered_map<std::string, double> resource_request = {{"CPU", 1}};
+  std::shared_ptr<TaskResourceInstances> resource_instances =
+      std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(resource_scheduler.AllocateLocalTaskResources(resource_request,
+                                                            resource_instances));
+  resource_scheduler.FreeTaskResourceInstances(resource_instances);
+  ASSERT_EQ(resource_scheduler.GetResourceTotalsVersion(), version);
+
+  // Growing totals, or new resources, do.
+  resource_scheduler.AddOrUpdateNode("remote", {{"CPU", 1}, {"GPU", 1}},
+                                     {{"CPU", 1}, {"GPU", 1}});
+  ASSERT_GT(resource_scheduler.GetResourceTotalsVersion(), version);
+  version = resource_scheduler.GetResourceTotalsVersion();
+  resource_scheduler.AddLocalResourceInstances("custom123", {1.0});
+  ASSERT_GT(resource_scheduler.GetResourceTotalsVersion(), version);
+}
+
+TEST_F(ClusterResourceSchedulerTest, GpuTopologyTest) {
+  // GPU0 and GPU2, and GPU1 and GPU3, are connected by NVLink, but the pairs only
+  // through the sockets.
+  const std::string output =
+      "\tGPU0\tGPU1\tGPU2\tGPU3\tmlx5_0\tCPU Affinity\tNUMA Affinity\n"
+      "GPU0\t X \tSYS\tNV2\tSYS\tPIX\t0-23\t0\n"
+      "GPU1\tSYS\t X \tSYS\tNV2\tSYS\t24-47\t1\n"
+      "GPU2\tNV2\tSYS\t X \tSYS\tPIX\t0-23\t0\n"
+      "GPU3\tSYS\tNV2\tSYS\t X \tSYS\t24-47\t1\n"
+      "mlx5_0\tPIX\tSYS\tPIX\tSYS\t X \t\t\n"
+      "\n"
+      "Legend:\n"
+      "  X    = Self\n";
+  GpuDistances distances = ParseGpuTopology(output);
+  ASSERT_EQ(distances.size(), 4);
+  ASSERT_EQ(distances[0], std::vector<int>({0, 6, 1, 6}));
+  ASSERT_EQ(distances[3], std::vector<int>({6, 1, 6, 0}));
+  ASSERT_TRUE(ParseGpuTopology("No devices were found\n").empty());
+
+  // Pairs of GPUs go to the GPUs connected by NVLink, not to the first free ones.
+  ClusterResourceScheduler resource_scheduler("local", {{"GPU", 4}});
+  resource_scheduler.SetGpuTopology(distances);
+  std::unordered_map<std::string, double> resource_request = {{"GPU", 2}};
+  auto first = std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(resource_scheduler.AllocateLocalTaskResources(resource_request, first));
+  ASSERT_EQ(first->predefined_resources[GPU],
+            std::vector<FixedPoint>({1., 0., 1., 0.}));
+  auto second = std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(resource_scheduler.AllocateLocalTaskResources(resource_request, second));
+  ASSERT_EQ(second->predefined_resources[GPU],
+            std::vector<FixedPoint>({0., 1., 0., 1.}));
+  resource_scheduler.FreeTaskResourceInstances(first);
+  resource_scheduler.FreeTaskResourceInstances(second);
+}
+
 TEST_F(ClusterResourceSchedulerTest, AvailableResourceEmptyTest) {
   ClusterResourceScheduler resource_scheduler("local", {{"custom123", 5}});
   std::shared_ptr<TaskResourceInstances> resource_instances =
@@ -1255,6 +1378,102 @@ TEST_F(ClusterResourceSchedulerTest, TaskResourceInstancesSerializedStringTest)
   )");
 }
 
+/// Placement throughput of the scheduler on synthetic clusters. These tests are excluded
+/// from cluster_resource_scheduler_test and run by cluster_resource_scheduler_perf_test.
+/// Each result is also recorded as a test property, so it lands in the XML report.
+class SchedulerPerfTest : public ::testing::TestWithParam<int> {
+ public:
+  static constexpr int kNumCustomResources = 50;
+  static constexpr int kCustomResourcesPerNode = 10;
+
+  /// Build a cluster of `num_nodes` nodes with CPUs, GPUs, memory and a mix of custom
+  /// resources, all of them partially used.
+  void BuildCluster(int num_nodes) {
+    std::mt19937 gen(num_nodes);
+    scheduler_ = std::make_unique<ClusterResourceScheduler>(
+        NodeName(0), std::unordered_map<std::string, double>{{"CPU", 16}});
+    for (int i = 1; i <= num_nodes; i++) {
+      std::unordered_map<std::string, double> total = {
+          {"CPU", 64}, {"GPU", static_cast<double>(i % 9)}, {"memory", 256}};
+      for (int j = 0; j < kCustomResourcesPerNode; j++) {
+        total[CustomResourceName(gen() % kNumCustomResources)] = 8;
+      }
+      auto available = total;
+      for (auto &entry : available) {
+        entry.second = static_cast<double>(gen() % static_cast<int>(entry.second + 1));
+      }
+      scheduler_->AddOrUpdateNode(NodeName(i), total, available);
+    }
+  }
+
+  static std::string NodeName(int i) { return "node_" + std::to_string(i); }
+
+  static std::string CustomResourceName(int i) { return "custom_" + std::to_string(i); }
+
+  void Report(const std::string &name, int64_t num_ops, absl::Duration elapsed) {
+    const auto ops_per_second =
+        static_cast<int64_t>(num_ops / absl::ToDoubleSeconds(elapsed));
+    RAY_LOG(INFO) << name << " with " << GetParam() << " nodes: " << ops_per_second
+                  << " per second";
+    RecordProperty(name + "_per_second", std::to_string(ops_per_second));
+  }
+
+ protected:
+  std::unique_ptr<ClusterResourceScheduler> scheduler_;
+};
+
+TEST_P(SchedulerPerfTest, GetBestSchedulableNode) {
+  BuildCluster(GetParam());
+  std::mt19937 gen(0);
+  std::vector<std::unordered_map<std::string, double>> requests;
+  for (int i = 0; i < 100; i++) {
+    std::unordered_map<std::string, double> request = {
+        {"CPU", static_cast<double>(1 + gen() % 4)}};
+    if (i % 4 == 0) {
+      request["GPU"] = 1;
+    }
+    if (i % 2 == 0) {
+      request[CustomResourceName(gen() % kNumCustomResources)] = 1 + gen() % 2;
+    }
+    requests.push_back(request);
+  }
+
+  const int num_decisions = 20000;
+  int64_t violations;
+  bool is_infeasible;
+  const auto start = absl::Now();
+  for (int i = 0; i < num_decisions; i++) {
+    scheduler_->GetBestSchedulableNode(requests[i % requests.size()],
+                                       /*requires_object_store_memory=*/false,
+                                       /*actor_creation=*/false,
+                                       /*force_spillback=*/false, &violations,
+                                       &is_infeasible);
+  }
+  Report("decisions", num_decisions, absl::Now() - start);
+}
+
+TEST_P(SchedulerPerfTest, UpdateNode) {
+  const int num_nodes = GetParam();
+  BuildCluster(num_nodes);
+  std::mt19937 gen(0);
+
+  const int num_updates = 100000;
+  const auto start = absl::Now();
+  for (int i = 0; i < num_updates; i++) {
+    rpc::ResourcesData data;
+    data.set_node_id(NodeName(1 + i % num_nodes));
+    data.set_resources_available_changed(true);
+    data.set_resources_delta(true);
+    (*data.mutable_resources_available())["CPU"] = gen() % 65;
+    (*data.mutable_resources_available())["memory"] = gen() % 257;
+    scheduler_->UpdateNode(data.node_id(), data);
+  }
+  Report("updates", num_updates, absl::Now() - start);
+}
+
+INSTANTIATE_TEST_CASE_P(ClusterSizes, SchedulerPerfTest,
+                         ::testing::Values(1000, 5000, 10000));
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
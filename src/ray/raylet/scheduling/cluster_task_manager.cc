@@ -16,10 +16,16 @@
 
 #include <google/protobuf/map.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include <boost/range/join.hpp>
 
+#include "ray/common/span_tracer.h"
 #include "ray/stats/stats.h"
 #include "ray/util/logging.h"
+#include "ray/util/util.h"
 
 namespace ray {
 namespace raylet {
@@ -39,7 +45,14 @@ ClusterTaskManager::ClusterTaskManager(
     std::function<bool(const std::vector<ObjectID> &object_ids,
                        std::vector<std::unique_ptr<RayObject>> *results)>
         get_task_arguments,
-    size_t max_pinned_task_arguments_bytes)
+    size_t max_pinned_task_arguments_bytes,
+    std::function<int64_t(const std::vector<ObjectID> &object_ids,
+                          absl::flat_hash_map<NodeID, int64_t> *bytes_by_node)>
+        get_object_bytes_by_node,
+    instrumented_io_context *io_service,
+    std::function<double(const JobID &)> get_job_scheduling_weight,
+    std::function<void(std::shared_ptr<WorkerInterface>)> preempt_worker,
+    std::function<bool()> is_under_memory_pressure)
     : self_node_id_(self_node_id),
       cluster_resource_scheduler_(cluster_resource_scheduler),
       task_dependency_manager_(task_dependency_manager),
@@ -49,10 +62,16 @@ ClusterTaskManager::ClusterTaskManager(
       max_resource_shapes_per_load_report_(
           RayConfig::instance().max_resource_shapes_per_load_report()),
       report_worker_backlog_(RayConfig::instance().report_worker_backlog()),
+      gang_scheduling_timeout_ms_(RayConfig::instance().gang_scheduling_timeout_ms()),
       worker_pool_(worker_pool),
       leased_workers_(leased_workers),
       get_task_arguments_(get_task_arguments),
       max_pinned_task_arguments_bytes_(max_pinned_task_arguments_bytes),
+      get_object_bytes_by_node_(get_object_bytes_by_node),
+      io_service_(io_service),
+      get_job_scheduling_weight_(get_job_scheduling_weight),
+      preempt_worker_(preempt_worker),
+      is_under_memory_pressure_(is_under_memory_pressure),
       metric_tasks_queued_(0),
       metric_tasks_dispatched_(0),
       metric_tasks_spilled_(0) {}
@@ -65,6 +84,20 @@ bool ClusterTaskManager::SchedulePendingTasks() {
        shapes_it != tasks_to_schedule_.end();) {
     auto &work_queue = shapes_it->second;
     bool is_infeasible = false;
+    // All tasks of a scheduling class have the same placement resources, so the
+    // request only has to be built once per class.
+    std::unordered_map<std::string, double> placement_resources;
+    if (!work_queue.empty()) {
+      placement_resources = work_queue.front()
+                                ->task.GetTaskSpecification()
+                                .GetRequiredPlacementResources()
+                                .GetResourceMap();
+    }
+    // Whether a task of this class (and this kind) was placed on the local node in
+    // this pass. Queueing a task locally does not change the resource view, unlike
+    // spilling it back, so the scheduler would pick the local node for all following
+    // tasks of the same shape as well and they can skip it.
+    bool placed_locally[2] = {false, false};
     for (auto work_it = work_queue.begin(); work_it != work_queue.end();) {
       // Check every task in task_to_schedule queue to see
       // whether it can be scheduled. This avoids head-of-line
@@ -75,15 +108,18 @@ bool ClusterTaskManager::SchedulePendingTasks() {
       RayTask task = work->task;
       RAY_LOG(DEBUG) << "Scheduling pending task "
                      << task.GetTaskSpecification().TaskId();
-      auto placement_resources =
-          task.GetTaskSpecification().GetRequiredPlacementResources().GetResourceMap();
-      // This argument is used to set violation, which is an unsupported feature now.
-      int64_t _unused;
-      std::string node_id_string = cluster_resource_scheduler_->GetBestSchedulableNode(
-          placement_resources,
-          /*requires_object_store_memory=*/false,
-          task.GetTaskSpecification().IsActorCreationTask(),
-          /*force_spillback=*/false, &_unused, &is_infeasible);
+      const bool is_actor_creation = task.GetTaskSpecification().IsActorCreationTask();
+      std::string node_id_string;
+      if (placed_locally[is_actor_creation]) {
+        node_id_string = self_node_id_.Binary();
+      } else {
+        // This argument is used to set violation, which is an unsupported feature now.
+        int64_t _unused;
+        node_id_string = cluster_resource_scheduler_->GetBestSchedulableNode(
+            placement_resources,
+            /*requires_object_store_memory=*/false, is_actor_creation,
+            /*force_spillback=*/false, &_unused, &is_infeasible);
+      }
 
       // There is no node that has available resources to run the request.
       // Move on to the next shape.
@@ -95,6 +131,7 @@ bool ClusterTaskManager::SchedulePendingTasks() {
       }
 
       if (node_id_string == self_node_id_.Binary()) {
+        placed_locally[is_actor_creation] = true;
         // Warning: WaitForTaskArgsRequests must execute (do not let it short
         // circuit if did_schedule is true).
         bool task_scheduled = WaitForTaskArgsRequests(work);
@@ -106,7 +143,6 @@ bool ClusterTaskManager::SchedulePendingTasks() {
       }
       work_it = work_queue.erase(work_it);
     }
-
     if (is_infeasible) {
       RAY_CHECK(!work_queue.empty());
       // Only announce the first item as infeasible.
@@ -127,6 +163,98 @@ bool ClusterTaskManager::SchedulePendingTasks() {
   return did_schedule;
 }
 
+bool ClusterTaskManager::SchedulePendingGangs() {
+  bool did_schedule = false;
+  const int64_t now_ms = current_time_ms();
+  for (auto gang_it = pending_gangs_.begin(); gang_it != pending_gangs_.end();) {
+    auto &gang = gang_it->second;
+    std::vector<NodeID> placement;
+    if (static_cast<int32_t>(gang.members.size()) >= gang.size &&
+        PlaceGang(gang, &placement)) {
+      RAY_LOG(DEBUG) << "Placing all " << gang.members.size() << " tasks of gang "
+                     << gang_it->first;
+      for (size_t i = 0; i < gang.members.size(); i++) {
+        if (placement[i] == self_node_id_) {
+          // Warning: WaitForTaskArgsRequests must execute (do not let it short
+          // circuit if did_schedule is true).
+          bool task_scheduled = WaitForTaskArgsRequests(gang.members[i]);
+          did_schedule = task_scheduled || did_schedule;
+        } else {
+          Spillback(placement[i], gang.members[i]);
+        }
+      }
+      pending_gangs_.erase(gang_it++);
+    } else if (now_ms - gang.queued_at_ms > gang_scheduling_timeout_ms_) {
+      RAY_LOG(WARNING) << "Failing the " << gang.members.size() << " queued tasks of gang "
+                       << gang_it->first << ", because the gang of " << gang.size
+                       << " tasks could not be placed within "
+                       << gang_scheduling_timeout_ms_ << "ms.";
+      for (const auto &work : gang.members) {
+        RemoveFromBacklogTracker(work->task);
+        work->reply->set_gang_scheduling_failed(true);
+        work->callback();
+      }
+      pending_gangs_.erase(gang_it++);
+    } else {
+      gang_it++;
+    }
+  }
+  return did_schedule;
+}
+
+bool ClusterTaskManager::PlaceGang(const Gang &gang, std::vector<NodeID> *placement) {
+  // Take the resources of each placed task from our view of its node, so that the
+  // following tasks are placed around it. They are given back once the whole gang
+  // is placed, and taken again when each task is dispatched or spilled back. Nothing
+  // else runs on the event loop in between, so no other task can take them.
+  std::vector<std::shared_ptr<TaskResourceInstances>> local_allocations;
+  std::vector<std::pair<std::string, std::unordered_map<std::string, double>>>
+      remote_allocations;
+  bool placed = true;
+  for (const auto &work : gang.members) {
+    const auto &spec = work->task.GetTaskSpecification();
+    int64_t _unused;
+    bool is_infeasible = false;
+    std::string node_id_string = cluster_resource_scheduler_->GetBestSchedulableNode(
+        spec.GetRequiredPlacementResources().GetResourceMap(),
+        /*requires_object_store_memory=*/false, spec.IsActorCreationTask(),
+        /*force_spillback=*/false, &_unused, &is_infeasible);
+    if (node_id_string.empty()) {
+      placed = false;
+      break;
+    }
+    // The scheduler may also pick a node that is feasible but busy, so only count
+    // the task as placed if the node has the resources available right now.
+    auto task_resources = spec.GetRequiredResources().GetResourceMap();
+    if (node_id_string == self_node_id_.Binary()) {
+      auto allocated_instances = std::make_shared<TaskResourceInstances>();
+      if (!cluster_resource_scheduler_->AllocateLocalTaskResources(
+              task_resources, allocated_instances)) {
+        placed = false;
+        break;
+      }
+      local_allocations.push_back(allocated_instances);
+    } else {
+      if (!cluster_resource_scheduler_->AllocateRemoteTaskResources(node_id_string,
+                                                                    task_resources)) {
+        placed = false;
+        break;
+      }
+      remote_allocations.emplace_back(node_id_string, std::move(task_resources));
+    }
+    placement->push_back(NodeID::FromBinary(node_id_string));
+  }
+
+  for (auto &allocated_instances : local_allocations) {
+    cluster_resource_scheduler_->ReleaseWorkerResources(allocated_instances);
+  }
+  for (const auto &allocation : remote_allocations) {
+    cluster_resource_scheduler_->ReleaseRemoteTaskResources(allocation.first,
+                                                            allocation.second);
+  }
+  return placed;
+}
+
 bool ClusterTaskManager::WaitForTaskArgsRequests(std::shared_ptr<Work> work) {
   const auto &task = work->task;
   const auto &task_id = task.GetTaskSpecification().TaskId();
@@ -143,6 +271,7 @@ bool ClusterTaskManager::WaitForTaskArgsRequests(std::shared_ptr<Work> work) {
       RAY_LOG(DEBUG) << "Waiting for args for task: "
                      << task.GetTaskSpecification().TaskId();
       can_dispatch = false;
+      work->waiting_time_ns = absl::GetCurrentTimeNanos();
       auto it = waiting_task_queue_.insert(waiting_task_queue_.end(), work);
       RAY_CHECK(waiting_tasks_index_.emplace(task_id, it).second);
     }
@@ -249,6 +378,8 @@ bool ClusterTaskManager::PoppedWorkerHandler(
                    << worker->WorkerId();
 
     Dispatch(worker, leased_workers_, work->allocated_instances, task, reply, callback);
+    SpanTracer::Instance().Record("LeaseQueueAndDispatch", task_id, work->queued_time_ns,
+                                  absl::GetCurrentTimeNanos());
     erase_from_dispatch_queue_fn(work, scheduling_class);
     dispatched = true;
   }
@@ -264,16 +395,32 @@ bool ClusterTaskManager::PoppedWorkerHandler(
 void ClusterTaskManager::DispatchScheduledTasksToWorkers(
     WorkerPoolInterface &worker_pool,
     std::unordered_map<WorkerID, std::shared_ptr<WorkerInterface>> &leased_workers) {
+  // More tasks would only get workers killed for lack of memory. The queued tasks are
+  // dispatched once the memory pressure is gone.
+  if (is_under_memory_pressure_ && is_under_memory_pressure_()) {
+    RAY_LOG(DEBUG) << "Not dispatching tasks, the node is under memory pressure.";
+    return;
+  }
   // Check every task in task_to_dispatch queue to see
   // whether it can be dispatched and ran. This avoids head-of-line
   // blocking where a task which cannot be dispatched because
   // there are not enough available resources blocks other
   // tasks from being dispatched.
+  const bool fair_share = RayConfig::instance().fair_share_scheduling_across_jobs();
+  absl::flat_hash_map<JobID, int64_t> num_leased_by_job;
+  if (fair_share) {
+    for (const auto &entry : leased_workers) {
+      num_leased_by_job[entry.second->GetAssignedTask().GetTaskSpecification().JobId()]++;
+    }
+  }
   for (auto shapes_it = tasks_to_dispatch_.begin();
        shapes_it != tasks_to_dispatch_.end();) {
     auto &scheduling_class = shapes_it->first;
     auto &dispatch_queue = shapes_it->second;
     bool is_infeasible = false;
+    if (fair_share) {
+      OrderByFairShare(num_leased_by_job, dispatch_queue);
+    }
     for (auto work_it = dispatch_queue.begin(); work_it != dispatch_queue.end();) {
       auto &work = *work_it;
       const auto &task = work->task;
@@ -293,6 +440,7 @@ void ClusterTaskManager::DispatchScheduledTasksToWorkers(
         if (args_missing) {
           // Insert the task at the head of the waiting queue because we
           // prioritize spilling from the end of the queue.
+          work->waiting_time_ns = absl::GetCurrentTimeNanos();
           auto it = waiting_task_queue_.insert(waiting_task_queue_.begin(),
                                                std::move(*work_it));
           RAY_CHECK(waiting_tasks_index_.emplace(task_id, it).second);
@@ -321,8 +469,9 @@ void ClusterTaskManager::DispatchScheduledTasksToWorkers(
       // If the owner has died since this task was queued, cancel the task by
       // killing the worker (unless this task is for a detached actor).
       if (!spec.IsDetachedActor() && !is_owner_alive_(owner_worker_id, owner_node_id)) {
-        RAY_LOG(WARNING) << "RayTask: " << task.GetTaskSpecification().TaskId()
-                         << "'s caller is no longer running. Cancelling task.";
+        RAY_LOG_RATE_LIMITED(WARNING, 1, 10)
+            << "RayTask: " << task.GetTaskSpecification().TaskId()
+            << "'s caller is no longer running. Cancelling task.";
         if (!spec.GetDependencies().empty()) {
           task_dependency_manager_.RemoveTaskDependencies(task_id);
         }
@@ -346,6 +495,9 @@ void ClusterTaskManager::DispatchScheduledTasksToWorkers(
           // There must not be any other available nodes in the cluster, so the task
           // should stay on this node. We can skip the reest of the shape because the
           // scheduler will make the same decision.
+          if (preempt_worker_ && RayConfig::instance().preempt_lower_priority_tasks()) {
+            TryPreemptForTask(spec, leased_workers);
+          }
           break;
         }
         if (!spec.GetDependencies().empty()) {
@@ -394,10 +546,11 @@ bool ClusterTaskManager::TrySpillback(const std::shared_ptr<Work> &work,
   const auto &spec = work->task.GetTaskSpecification();
   int64_t _unused;
   auto placement_resources = spec.GetRequiredPlacementResources().GetResourceMap();
+  const auto arg_locality = GetArgumentLocality(work->task);
   std::string node_id_string = cluster_resource_scheduler_->GetBestSchedulableNode(
       placement_resources,
       /*requires_object_store_memory=*/false, spec.IsActorCreationTask(),
-      /*force_spillback=*/false, &_unused, &is_infeasible);
+      /*force_spillback=*/false, &_unused, &is_infeasible, &arg_locality);
 
   if (is_infeasible || node_id_string == self_node_id_.Binary() ||
       node_id_string.empty()) {
@@ -418,16 +571,28 @@ void ClusterTaskManager::QueueAndScheduleTask(
   auto work = std::make_shared<Work>(task, reply, [send_reply_callback] {
     send_reply_callback(Status::OK(), nullptr, nullptr);
   });
-  const auto &scheduling_class = task.GetTaskSpecification().GetSchedulingClass();
-  // If the scheduling class is infeasible, just add the work to the infeasible queue
-  // directly.
-  if (infeasible_tasks_.count(scheduling_class) > 0) {
+  const auto &spec = task.GetTaskSpecification();
+  const auto &scheduling_class = spec.GetSchedulingClass();
+  // The tasks of a gang are held by the raylet of their owner until all of them can
+  // be placed. The ones it spills back are scheduled like any other task by the
+  // raylets they are spilled to.
+  if (spec.IsGangTask() &&
+      NodeID::FromBinary(spec.CallerAddress().raylet_id()) == self_node_id_) {
+    auto &gang = pending_gangs_[spec.GangId()];
+    if (gang.members.empty()) {
+      gang.size = spec.GangSize();
+      gang.queued_at_ms = current_time_ms();
+    }
+    gang.members.push_back(work);
+  } else if (infeasible_tasks_.count(scheduling_class) > 0) {
+    // If the scheduling class is infeasible, just add the work to the infeasible queue
+    // directly.
     infeasible_tasks_[scheduling_class].push_back(work);
   } else {
     tasks_to_schedule_[scheduling_class].push_back(work);
   }
   AddToBacklogTracker(task);
-  ScheduleAndDispatchTasks();
+  RequestSchedulingPass();
 }
 
 void ClusterTaskManager::TasksUnblocked(const std::vector<TaskID> &ready_ids) {
@@ -443,12 +608,14 @@ void ClusterTaskManager::TasksUnblocked(const std::vector<TaskID> &ready_ids) {
       const auto &scheduling_key = task.GetTaskSpecification().GetSchedulingClass();
       RAY_LOG(DEBUG) << "Args ready, task can be dispatched "
                      << task.GetTaskSpecification().TaskId();
+      SpanTracer::Instance().Record("ArgPull", task_id, work->waiting_time_ns,
+                                    absl::GetCurrentTimeNanos());
       tasks_to_dispatch_[scheduling_key].push_back(work);
       waiting_task_queue_.erase(it->second);
       waiting_tasks_index_.erase(it);
     }
   }
-  ScheduleAndDispatchTasks();
+  RequestSchedulingPass();
 }
 
 void ClusterTaskManager::TaskFinished(std::shared_ptr<WorkerInterface> worker,
@@ -646,6 +813,27 @@ bool ClusterTaskManager::CancelTask(const TaskID &task_id,
     }
   }
 
+  for (auto gang_it = pending_gangs_.begin(); gang_it != pending_gangs_.end();
+       gang_it++) {
+    auto &members = gang_it->second.members;
+    for (auto work_it = members.begin(); work_it != members.end(); work_it++) {
+      const auto &task = (*work_it)->task;
+      if (task.GetTaskSpecification().TaskId() == task_id) {
+        RemoveFromBacklogTracker(task);
+        RAY_LOG(DEBUG) << "Canceling task " << task_id << " from gang "
+                       << gang_it->first;
+        ReplyCancelled(*work_it, runtime_env_setup_failed);
+        // The rest of the gang stays queued and fails once it times out, unless the
+        // owner cancels it as well.
+        members.erase(work_it);
+        if (members.empty()) {
+          pending_gangs_.erase(gang_it);
+        }
+        return true;
+      }
+    }
+  }
+
   auto iter = waiting_tasks_index_.find(task_id);
   if (iter != waiting_tasks_index_.end()) {
     const auto &task = (*iter->second)->task;
@@ -697,12 +885,57 @@ void ClusterTaskManager::FillPendingActorInfo(rpc::GetNodeStatsReply *reply) con
   }
 }
 
+namespace {
+
+/// The coarsest quantization of the shapes of a compact load report, which rounds
+/// quantities up to powers of 2^8.
+constexpr int kMaxShapeQuantizationLevel = 8;
+
+/// Round the quantities of a shape up to powers of 2^level. Fractional quantities
+/// round up to 1.
+ResourceSet QuantizeShape(const ResourceSet &shape, int level) {
+  const double base = std::pow(2, level);
+  std::unordered_map<std::string, double> quantized;
+  for (const auto &resource : shape.GetResourceMap()) {
+    double quantity = 1;
+    while (quantity < resource.second) {
+      quantity *= base;
+    }
+    quantized[resource.first] = quantity;
+  }
+  return ResourceSet(quantized);
+}
+
+void MarkResourceLoadChanged(
+    rpc::ResourcesData &data,
+    const std::shared_ptr<SchedulingResources> &last_reported_resources) {
+  if (RayConfig::instance().enable_light_weight_resource_report()) {
+    // Check whether resources have been changed.
+    std::unordered_map<std::string, double> local_resource_map(
+        data.resource_load().begin(), data.resource_load().end());
+    ResourceSet local_resource(local_resource_map);
+    if (last_reported_resources == nullptr ||
+        !last_reported_resources->GetLoadResources().IsEqual(local_resource)) {
+      data.set_resource_load_changed(true);
+    }
+  } else {
+    data.set_resource_load_changed(true);
+  }
+}
+
+}  // namespace
+
 void ClusterTaskManager::FillResourceUsage(
     rpc::ResourcesData &data,
     const std::shared_ptr<SchedulingResources> &last_reported_resources) {
   if (max_resource_shapes_per_load_report_ == 0) {
     return;
   }
+  if (RayConfig::instance().compact_resource_load_report()) {
+    FillCompactResourceLoad(data);
+    MarkResourceLoadChanged(data, last_reported_resources);
+    return;
+  }
   auto resource_loads = data.mutable_resource_load();
   auto resource_load_by_shape =
       data.mutable_resource_load_by_shape()->mutable_resource_demands();
@@ -864,17 +1097,86 @@ void ClusterTaskManager::FillResourceUsage(
     }
   }
 
-  if (RayConfig::instance().enable_light_weight_resource_report()) {
-    // Check whether resources have been changed.
-    std::unordered_map<std::string, double> local_resource_map(
-        data.resource_load().begin(), data.resource_load().end());
-    ResourceSet local_resource(local_resource_map);
-    if (last_reported_resources == nullptr ||
-        !last_reported_resources->GetLoadResources().IsEqual(local_resource)) {
-      data.set_resource_load_changed(true);
+  MarkResourceLoadChanged(data, last_reported_resources);
+}
+
+void ClusterTaskManager::FillCompactResourceLoad(rpc::ResourcesData &data) const {
+  auto resource_loads = data.mutable_resource_load();
+  // The demand of each shape, summed over the scheduling classes of the shape.
+  absl::flat_hash_map<ResourceSet, rpc::ResourceDemand> demands;
+  auto add_demand = [this, &demands, resource_loads](
+                        const SchedulingClass scheduling_class, size_t count,
+                        bool infeasible) {
+    const auto &resources =
+        TaskSpecification::GetSchedulingClassDescriptor(scheduling_class);
+    for (const auto &resource : resources.GetResourceMap()) {
+      (*resource_loads)[resource.first] += resource.second * count;
+    }
+    auto &demand = demands[resources];
+    if (infeasible) {
+      demand.set_num_infeasible_requests_queued(demand.num_infeasible_requests_queued() +
+                                                count);
+    } else {
+      demand.set_num_ready_requests_queued(demand.num_ready_requests_queued() + count);
+    }
+    auto backlog_it = backlog_tracker_.find(scheduling_class);
+    if (backlog_it != backlog_tracker_.end()) {
+      demand.set_backlog_size(demand.backlog_size() + backlog_it->second);
+    }
+  };
+  for (const auto &pair : tasks_to_schedule_) {
+    add_demand(pair.first, pair.second.size(), /*infeasible=*/false);
+  }
+  for (const auto &pair : tasks_to_dispatch_) {
+    add_demand(pair.first, pair.second.size(), /*infeasible=*/false);
+  }
+  for (const auto &pair : infeasible_tasks_) {
+    add_demand(pair.first, pair.second.size(), /*infeasible=*/true);
+  }
+
+  // Merge the shapes whose quantities round up to the same powers of 2^level, with
+  // coarser levels until the shapes fit. Rounding up keeps the reported demand an
+  // upper bound of the real one.
+  const size_t max_shapes = max_resource_shapes_per_load_report_ < 0
+                                ? std::numeric_limits<size_t>::max()
+                                : max_resource_shapes_per_load_report_;
+  for (int level = 1; demands.size() > max_shapes && level <= kMaxShapeQuantizationLevel;
+       level++) {
+    absl::flat_hash_map<ResourceSet, rpc::ResourceDemand> merged;
+    for (const auto &entry : demands) {
+      auto &demand = merged[QuantizeShape(entry.first, level)];
+      demand.set_num_ready_requests_queued(demand.num_ready_requests_queued() +
+                                           entry.second.num_ready_requests_queued());
+      demand.set_num_infeasible_requests_queued(
+          demand.num_infeasible_requests_queued() +
+          entry.second.num_infeasible_requests_queued());
+      demand.set_backlog_size(demand.backlog_size() + entry.second.backlog_size());
+    }
+    demands = std::move(merged);
+  }
+
+  // Shapes of distinct resources can't be merged. If there are still too many, the
+  // ones with the fewest queued tasks are left out.
+  std::vector<std::pair<ResourceSet, rpc::ResourceDemand>> entries(demands.begin(),
+                                                                   demands.end());
+  if (entries.size() > max_shapes) {
+    auto num_queued = [](const rpc::ResourceDemand &demand) {
+      return demand.num_ready_requests_queued() + demand.num_infeasible_requests_queued();
+    };
+    std::nth_element(entries.begin(), entries.begin() + max_shapes, entries.end(),
+                     [&num_queued](const auto &a, const auto &b) {
+                       return num_queued(a.second) > num_queued(b.second);
+                     });
+    entries.resize(max_shapes);
+  }
+  auto resource_load_by_shape =
+      data.mutable_resource_load_by_shape()->mutable_resource_demands();
+  for (auto &entry : entries) {
+    auto by_shape_entry = resource_load_by_shape->Add();
+    by_shape_entry->Swap(&entry.second);
+    for (const auto &resource : entry.first.GetResourceMap()) {
+      (*by_shape_entry->mutable_shape())[resource.first] = resource.second;
     }
-  } else {
-    data.set_resource_load_changed(true);
   }
 }
 
@@ -923,6 +1225,7 @@ std::string ClusterTaskManager::DebugStr() const {
   buffer << "Schedule queue length: " << num_tasks_to_schedule << "\n";
   buffer << "Dispatch queue length: " << num_tasks_to_dispatch << "\n";
   buffer << "Waiting tasks size: " << waiting_tasks_index_.size() << "\n";
+  buffer << "Number of pending gangs: " << pending_gangs_.size() << "\n";
   buffer << "Number of executing tasks: " << executing_task_args_.size() << "\n";
   buffer << "Number of pinned task arguments: " << pinned_task_arguments_.size() << "\n";
   buffer << "cluster_resource_scheduler state: "
@@ -948,6 +1251,15 @@ void ClusterTaskManager::RecordMetrics() {
 }
 
 void ClusterTaskManager::TryLocalInfeasibleTaskScheduling() {
+  if (RayConfig::instance().skip_unchanged_infeasible_checks()) {
+    // Feasibility only depends on the resource totals of the nodes, so there is no
+    // need to check the infeasible tasks again until one of them grew.
+    const uint64_t version = cluster_resource_scheduler_->GetResourceTotalsVersion();
+    if (version == infeasible_tasks_checked_version_) {
+      return;
+    }
+    infeasible_tasks_checked_version_ = version;
+  }
   for (auto shapes_it = infeasible_tasks_.begin();
        shapes_it != infeasible_tasks_.end();) {
     auto &work_queue = shapes_it->second;
@@ -1181,6 +1493,8 @@ bool ClusterTaskManager::ReturnCpuResourcesToBlockedWorker(
 }
 
 void ClusterTaskManager::ScheduleAndDispatchTasks() {
+  // Gangs go first, since they need the resources of many nodes at once.
+  SchedulePendingGangs();
   SchedulePendingTasks();
   DispatchScheduledTasksToWorkers(worker_pool_, leased_workers_);
   // TODO(swang): Spill from waiting queue first? Otherwise, we may end up
@@ -1191,6 +1505,108 @@ void ClusterTaskManager::ScheduleAndDispatchTasks() {
   SpillWaitingTasks();
 }
 
+void ClusterTaskManager::RequestSchedulingPass() {
+  if (io_service_ == nullptr) {
+    ScheduleAndDispatchTasks();
+    return;
+  }
+  // Every pass walks all the queued scheduling classes, so under a burst of lease
+  // requests one pass for the whole burst is much cheaper than one per request.
+  if (scheduling_pass_pending_) {
+    return;
+  }
+  scheduling_pass_pending_ = true;
+  io_service_->post(
+      [this]() {
+        scheduling_pass_pending_ = false;
+        ScheduleAndDispatchTasks();
+      },
+      "ClusterTaskManager.ScheduleAndDispatchTasks");
+}
+
+bool ClusterTaskManager::TryPreemptForTask(
+    const TaskSpecification &spec,
+    const std::unordered_map<WorkerID, std::shared_ptr<WorkerInterface>>
+        &leased_workers) {
+  for (auto it = preempted_workers_.begin(); it != preempted_workers_.end();) {
+    if (leased_workers.count(*it) == 0) {
+      preempted_workers_.erase(it++);
+    } else {
+      it++;
+    }
+  }
+  if (!preempted_workers_.empty()) {
+    return false;
+  }
+
+  std::shared_ptr<WorkerInterface> victim;
+  int32_t victim_priority = spec.Priority();
+  for (const auto &entry : leased_workers) {
+    const auto &worker = entry.second;
+    if (worker->IsDead() || worker->GetAssignedTaskId().IsNil()) {
+      continue;
+    }
+    const auto &leased_spec = worker->GetAssignedTask().GetTaskSpecification();
+    if (leased_spec.IsRetriable() && leased_spec.Priority() < victim_priority &&
+        spec.GetRequiredResources().IsSubset(leased_spec.GetRequiredResources())) {
+      victim = worker;
+      victim_priority = leased_spec.Priority();
+    }
+  }
+  if (victim == nullptr) {
+    return false;
+  }
+  RAY_LOG(INFO) << "Preempting worker " << victim->WorkerId() << " running task "
+                << victim->GetAssignedTaskId() << " of priority " << victim_priority
+                << " for task " << spec.TaskId() << " of priority " << spec.Priority();
+  preempted_workers_.insert(victim->WorkerId());
+  preempt_worker_(victim);
+  return true;
+}
+
+void ClusterTaskManager::OrderByFairShare(
+    const absl::flat_hash_map<JobID, int64_t> &num_leased_by_job,
+    std::deque<std::shared_ptr<Work>> &queue) const {
+  if (queue.size() < 2) {
+    return;
+  }
+  const JobID first_job_id = queue.front()->task.GetTaskSpecification().JobId();
+  if (std::all_of(queue.begin(), queue.end(),
+                  [&first_job_id](const std::shared_ptr<Work> &work) {
+                    return work->task.GetTaskSpecification().JobId() == first_job_id;
+                  })) {
+    return;
+  }
+
+  // The next position of each job in the fair order, and its weight.
+  absl::flat_hash_map<JobID, std::pair<int64_t, double>> jobs;
+  std::vector<std::pair<double, size_t>> order;
+  order.reserve(queue.size());
+  for (size_t i = 0; i < queue.size(); i++) {
+    const JobID job_id = queue[i]->task.GetTaskSpecification().JobId();
+    auto it = jobs.find(job_id);
+    if (it == jobs.end()) {
+      auto leased_it = num_leased_by_job.find(job_id);
+      int64_t num_leased =
+          leased_it == num_leased_by_job.end() ? 0 : leased_it->second;
+      double weight =
+          get_job_scheduling_weight_ ? get_job_scheduling_weight_(job_id) : 1.0;
+      it = jobs.emplace(job_id, std::make_pair(num_leased, std::max(weight, 1e-6)))
+               .first;
+    }
+    auto &position = it->second.first;
+    position++;
+    order.emplace_back(position / it->second.second, i);
+  }
+  std::sort(order.begin(), order.end());
+
+  std::deque<std::shared_ptr<Work>> ordered;
+  for (const auto &entry : order) {
+    ordered.push_back(std::move(queue[entry.second]));
+  }
+  queue.swap(ordered);
+}
+
 void ClusterTaskManager::SpillWaitingTasks() {
   RAY_LOG(DEBUG) << "Attempting to spill back from waiting task queue, num waiting: "
                  << waiting_task_queue_.size();
@@ -1224,11 +1640,14 @@ void ClusterTaskManager::SpillWaitingTasks() {
     // TODO(swang): The policy currently does not account for the amount of
     // object store memory availability. Ideally, we should pick the node with
     // the most memory availability.
+    // The arguments of waiting tasks are being pulled, so we know where they are.
+    // Prefer nodes that already hold them.
+    const auto arg_locality = GetArgumentLocality(task);
     std::string node_id_string = cluster_resource_scheduler_->GetBestSchedulableNode(
         placement_resources,
         /*requires_object_store_memory=*/true,
         task.GetTaskSpecification().IsActorCreationTask(),
-        /*force_spillback=*/force_spillback, &_unused, &is_infeasible);
+        /*force_spillback=*/force_spillback, &_unused, &is_infeasible, &arg_locality);
     if (!node_id_string.empty() && node_id_string != self_node_id_.Binary()) {
       NodeID node_id = NodeID::FromBinary(node_id_string);
       Spillback(node_id, *it);
@@ -1254,6 +1673,25 @@ void ClusterTaskManager::SpillWaitingTasks() {
   }
 }
 
+std::unordered_map<std::string, float> ClusterTaskManager::GetArgumentLocality(
+    const RayTask &task) const {
+  std::unordered_map<std::string, float> arg_locality;
+  const auto object_ids = task.GetTaskSpecification().GetDependencyIds();
+  if (get_object_bytes_by_node_ == nullptr || object_ids.empty()) {
+    return arg_locality;
+  }
+  absl::flat_hash_map<NodeID, int64_t> bytes_by_node;
+  const int64_t total_bytes = get_object_bytes_by_node_(object_ids, &bytes_by_node);
+  if (total_bytes <= 0) {
+    return arg_locality;
+  }
+  for (const auto &entry : bytes_by_node) {
+    arg_locality[entry.first.Binary()] =
+        static_cast<float>(entry.second) / static_cast<float>(total_bytes);
+  }
+  return arg_locality;
+}
+
 ResourceSet ClusterTaskManager::CalcNormalTaskResources() const {
   std::unordered_map<std::string, FixedPoint> total_normal_task_resources;
   const auto &string_id_map = cluster_resource_scheduler_->GetStringIdMap();
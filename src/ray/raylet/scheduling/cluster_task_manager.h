@@ -16,6 +16,8 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/time/clock.h"
+#include "ray/common/asio/instrumented_io_context.h"
 #include "ray/common/ray_object.h"
 #include "ray/common/task/task.h"
 #include "ray/common/task/task_common.h"
@@ -46,6 +48,10 @@ struct Work {
   std::function<void(void)> callback;
   std::shared_ptr<TaskResourceInstances> allocated_instances;
   WorkStatus status = WorkStatus::WAITING;
+  /// When the work was queued and when it started waiting for its arguments, for the
+  /// span tracer.
+  int64_t queued_time_ns = absl::GetCurrentTimeNanos();
+  int64_t waiting_time_ns = 0;
   Work(RayTask task, rpc::RequestWorkerLeaseReply *reply,
        std::function<void(void)> callback, WorkStatus status = WorkStatus::WAITING)
       : task(task),
@@ -88,6 +94,18 @@ class ClusterTaskManager : public ClusterTaskManagerInterface {
   /// \param is_owner_alive: A callback which returns if the owner process is alive
   /// (according to our ownership model).
   /// \param gcs_client: A gcs client.
+  /// \param get_object_bytes_by_node: Optional callback that adds up the known sizes
+  /// of objects by the nodes that hold them and returns their total size. It is used
+  /// to spill tasks back to nodes that hold their arguments.
+  /// \param io_service: Optional event loop of the caller. If set, queued and
+  /// unblocked tasks are scheduled by one pass posted to this loop, shared by all the
+  /// tasks that arrive before it runs, instead of one pass per call.
+  /// \param get_job_scheduling_weight: Optional callback to get the weight of a job,
+  /// when tasks are dispatched by fair share across jobs. Jobs weigh 1 without it.
+  /// \param preempt_worker: Optional callback to kill a leased worker, so that its
+  /// resources go to a task of higher priority. Tasks are not preempted without it.
+  /// \param is_under_memory_pressure: Optional callback that returns whether the node
+  /// is short of memory. No tasks are dispatched to workers while it is.
   ClusterTaskManager(
       const NodeID &self_node_id,
       std::shared_ptr<ClusterResourceScheduler> cluster_resource_scheduler,
@@ -100,7 +118,14 @@ class ClusterTaskManager : public ClusterTaskManagerInterface {
       std::function<bool(const std::vector<ObjectID> &object_ids,
                          std::vector<std::unique_ptr<RayObject>> *results)>
           get_task_arguments,
-      size_t max_pinned_task_arguments_bytes);
+      size_t max_pinned_task_arguments_bytes,
+      std::function<int64_t(const std::vector<ObjectID> &object_ids,
+                            absl::flat_hash_map<NodeID, int64_t> *bytes_by_node)>
+          get_object_bytes_by_node = nullptr,
+      instrumented_io_context *io_service = nullptr,
+      std::function<double(const JobID &)> get_job_scheduling_weight = nullptr,
+      std::function<void(std::shared_ptr<WorkerInterface>)> preempt_worker = nullptr,
+      std::function<bool()> is_under_memory_pressure = nullptr);
 
   /// (Step 1) Queue tasks and schedule.
   /// Queue task and schedule. This hanppens when processing the worker lease request.
@@ -211,6 +236,66 @@ class ClusterTaskManager : public ClusterTaskManagerInterface {
   /// \return True if any tasks are ready for dispatch.
   bool SchedulePendingTasks();
 
+  /// Schedule and dispatch tasks now, or, if scheduling passes are coalesced, make sure
+  /// that a pass is posted to the event loop.
+  void RequestSchedulingPass();
+
+  /// Preempt a leased worker to make room for a task that fits on no node. Only a
+  /// retriable normal task of lower priority than the task, whose resources cover the
+  /// task's, is preempted, the one of lowest priority first. No worker is preempted
+  /// while an earlier preempted worker still holds its lease.
+  ///
+  /// \param spec The task that does not fit.
+  /// \param leased_workers The workers leased by this node.
+  /// \return Whether a worker was preempted.
+  bool TryPreemptForTask(
+      const TaskSpecification &spec,
+      const std::unordered_map<WorkerID, std::shared_ptr<WorkerInterface>>
+          &leased_workers);
+
+  /// Reorder a dispatch queue by weighted fair share across jobs: the n-th queued task
+  /// of a job that holds k leased workers is ordered by (k + n) / weight, and the
+  /// queue order breaks ties. A job with a large backlog then no longer delays the
+  /// tasks of the other jobs of the same shape.
+  ///
+  /// \param num_leased_by_job The number of leased workers of each job.
+  /// \param queue The dispatch queue of a scheduling class.
+  void OrderByFairShare(const absl::flat_hash_map<JobID, int64_t> &num_leased_by_job,
+                        std::deque<std::shared_ptr<Work>> &queue) const;
+
+  /// Fill in `resource_load` and `resource_load_by_shape` with one entry per shape,
+  /// quantizing the shapes so that at most `max_resource_shapes_per_load_report_`
+  /// entries are reported. See `compact_resource_load_report`.
+  ///
+  /// \param data Output parameter.
+  void FillCompactResourceLoad(rpc::ResourcesData &data) const;
+
+  /// A set of tasks that are placed all at once or not at all, see
+  /// `TaskSpec.gang_id`.
+  struct Gang {
+    /// The number of tasks in the gang.
+    int32_t size = 0;
+    /// When the first task of the gang was queued.
+    int64_t queued_at_ms = 0;
+    /// The tasks of the gang that have been queued so far.
+    std::vector<std::shared_ptr<Work>> members;
+  };
+
+  /// Place every gang whose tasks have all been queued, if the cluster has the
+  /// available resources to run all of its tasks at once. Fail the tasks of gangs
+  /// that have waited for longer than `gang_scheduling_timeout_ms`.
+  ///
+  /// \return True if any tasks are ready for dispatch.
+  bool SchedulePendingGangs();
+
+  /// Pick a node for every task of a gang, taking into account the resources of the
+  /// tasks placed before it. The cluster resource view is left unchanged.
+  ///
+  /// \param gang: The gang to place.
+  /// \param placement: Output parameter. The node of each task of the gang.
+  /// \return True if all tasks of the gang could be placed.
+  bool PlaceGang(const Gang &gang, std::vector<NodeID> *placement);
+
   /// Handle the popped worker from worker pool.
   bool PoppedWorkerHandler(const std::shared_ptr<WorkerInterface> worker,
                            PopWorkerStatus status, const TaskID &task_id,
@@ -304,6 +389,14 @@ class ClusterTaskManager : public ClusterTaskManagerInterface {
   std::unordered_map<SchedulingClass, std::deque<std::shared_ptr<Work>>>
       infeasible_tasks_;
 
+  /// Gangs of tasks that have not been placed yet, keyed by gang ID. The tasks of a
+  /// gang are held by the raylet of their owner; once placed, they are queued
+  /// locally or spilled back like any other task.
+  absl::flat_hash_map<std::string, Gang> pending_gangs_;
+
+  /// How long a gang may wait to be placed before its tasks are failed.
+  const int64_t gang_scheduling_timeout_ms_;
+
   /// Track the cumulative backlog of all workers requesting a lease to this raylet.
   std::unordered_map<SchedulingClass, int> backlog_tracker_;
 
@@ -337,6 +430,34 @@ class ClusterTaskManager : public ClusterTaskManagerInterface {
   /// The maximum amount of bytes that can be used by executing task arguments.
   size_t max_pinned_task_arguments_bytes_;
 
+  /// Callback to find the nodes that hold task arguments.
+  std::function<int64_t(const std::vector<ObjectID> &object_ids,
+                        absl::flat_hash_map<NodeID, int64_t> *bytes_by_node)>
+      get_object_bytes_by_node_;
+
+  /// The event loop that coalesced scheduling passes are posted to, or nullptr to
+  /// schedule synchronously.
+  instrumented_io_context *io_service_;
+
+  /// Whether a scheduling pass has been posted to `io_service_` and not run yet.
+  bool scheduling_pass_pending_ = false;
+
+  /// Callback to get the weight of a job for fair share dispatching.
+  std::function<double(const JobID &)> get_job_scheduling_weight_;
+
+  /// Callback to kill a leased worker to make room for a task of higher priority.
+  std::function<void(std::shared_ptr<WorkerInterface>)> preempt_worker_;
+
+  /// Callback to check whether the node is short of memory.
+  std::function<bool()> is_under_memory_pressure_;
+
+  /// The preempted workers that may still hold their lease.
+  absl::flat_hash_set<WorkerID> preempted_workers_;
+
+  /// The resource totals version of the cluster resource scheduler when the
+  /// infeasible tasks were last checked, if `skip_unchanged_infeasible_checks` is set.
+  uint64_t infeasible_tasks_checked_version_ = 0;
+
   /// Metrics collected since the last report.
   uint64_t metric_tasks_queued_;
   uint64_t metric_tasks_dispatched_;
@@ -357,6 +478,10 @@ class ClusterTaskManager : public ClusterTaskManagerInterface {
 
   void Spillback(const NodeID &spillback_to, const std::shared_ptr<Work> &work);
 
+  /// The fraction of the argument bytes of a task on each node (by binary node ID),
+  /// as far as the object manager knows. Empty if nothing is known.
+  std::unordered_map<std::string, float> GetArgumentLocality(const RayTask &task) const;
+
   void AddToBacklogTracker(const RayTask &task);
   void RemoveFromBacklogTracker(const RayTask &task);
 
@@ -373,6 +498,9 @@ class ClusterTaskManager : public ClusterTaskManagerInterface {
 
   friend class ClusterTaskManagerTest;
   FRIEND_TEST(ClusterTaskManagerTest, FeasibleToNonFeasible);
+  FRIEND_TEST(ClusterTaskManagerTest, ScheduleQueuedTasksOfOneClassTest);
+  FRIEND_TEST(ClusterTaskManagerTest, GangSchedulingTest);
+  FRIEND_TEST(ClusterTaskManagerTest, GangSchedulingTimeoutTest);
 };
 }  // namespace raylet
 }  // namespace ray
@@ -15,9 +15,11 @@
 
 #include "ray/raylet/scheduling/cluster_task_manager.h"
 
+#include <cmath>
 #include <memory>
 #include <string>
 
+#include "absl/time/clock.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ray/common/id.h"
@@ -144,6 +146,40 @@ RayTask CreateTask(const std::unordered_map<std::string, double> &required_resou
                  TaskExecutionSpecification(execution_spec_message));
 }
 
+RayTask CreateGangTask(const std::unordered_map<std::string, double> &required_resources,
+                       const NodeID &owner_node_id, const std::string &gang_id,
+                       int gang_size) {
+  rpc::TaskSpec message =
+      CreateTask(required_resources).GetTaskSpecification().GetMessage();
+  message.mutable_caller_address()->set_raylet_id(owner_node_id.Binary());
+  message.set_gang_id(gang_id);
+  message.set_gang_size(gang_size);
+  rpc::TaskExecutionSpec execution_spec_message;
+  execution_spec_message.set_num_forwards(1);
+  return RayTask(TaskSpecification(std::move(message)),
+                 TaskExecutionSpecification(execution_spec_message));
+}
+
+RayTask CreateJobTask(const std::unordered_map<std::string, double> &required_resources,
+                      const JobID &job_id) {
+  rpc::TaskSpec message =
+      CreateTask(required_resources).GetTaskSpecification().GetMessage();
+  message.set_job_id(job_id.Binary());
+  return RayTask(TaskSpecification(std::move(message)),
+                 TaskExecutionSpecification(rpc::TaskExecutionSpec()));
+}
+
+RayTask CreatePriorityTask(
+    const std::unordered_map<std::string, double> &required_resources, int32_t priority,
+    int32_t max_retries) {
+  rpc::TaskSpec message =
+      CreateTask(required_resources).GetTaskSpecification().GetMessage();
+  message.set_priority(priority);
+  message.set_max_retries(max_retries);
+  return RayTask(TaskSpecification(std::move(message)),
+                 TaskExecutionSpecification(rpc::TaskExecutionSpec()));
+}
+
 class MockTaskDependencyManager : public TaskDependencyManagerInterface {
  public:
   MockTaskDependencyManager(std::unordered_set<ObjectID> &missing_objects)
@@ -267,6 +303,14 @@ class ClusterTaskManagerTest : public ::testing::Test {
     return count;
   }
 
+  void CoalesceSchedulingPasses(instrumented_io_context *io_service) {
+    task_manager_.io_service_ = io_service;
+  }
+
+  void SetPreemptWorker(std::function<void(std::shared_ptr<WorkerInterface>)> callback) {
+    task_manager_.preempt_worker_ = callback;
+  }
+
   NodeID id_;
   std::shared_ptr<ClusterResourceScheduler> scheduler_;
   MockWorkerPool pool_;
@@ -322,6 +366,166 @@ TEST_F(ClusterTaskManagerTest, BasicTest) {
   AssertNoLeaks();
 }
 
+TEST_F(ClusterTaskManagerTest, CoalesceSchedulingPassesTest) {
+  /*
+    With an event loop, the tasks queued before the loop runs are scheduled and
+    dispatched by a single pass posted to the loop.
+   */
+  instrumented_io_context io_service;
+  CoalesceSchedulingPasses(&io_service);
+  for (int i = 0; i < 2; i++) {
+    std::shared_ptr<MockWorker> worker =
+        std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234);
+    pool_.PushWorker(std::static_pointer_cast<WorkerInterface>(worker));
+  }
+
+  rpc::RequestWorkerLeaseReply reply1;
+  rpc::RequestWorkerLeaseReply reply2;
+  int num_callbacks = 0;
+  auto callback = [&num_callbacks](Status, std::function<void()>,
+                                   std::function<void()>) { num_callbacks++; };
+  RayTask task1 = CreateTask({{ray::kCPU_ResourceLabel, 1}});
+  RayTask task2 = CreateTask({{ray::kCPU_ResourceLabel, 1}});
+  task_manager_.QueueAndScheduleTask(task1, &reply1, callback);
+  task_manager_.QueueAndScheduleTask(task2, &reply2, callback);
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(num_callbacks, 0);
+  ASSERT_EQ(leased_workers_.size(), 0);
+
+  ASSERT_EQ(io_service.poll(), 1);
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(num_callbacks, 2);
+  ASSERT_EQ(leased_workers_.size(), 2);
+
+  for (auto &entry : leased_workers_) {
+    RayTask finished_task;
+    task_manager_.TaskFinished(entry.second, &finished_task);
+  }
+  CoalesceSchedulingPasses(nullptr);
+  AssertNoLeaks();
+}
+
+TEST_F(ClusterTaskManagerTest, FairShareAcrossJobsTest) {
+  /*
+    With fair share dispatching, a job that holds fewer workers goes ahead of the
+    backlog of a job that was queued before it.
+   */
+  RayConfig::instance().initialize(R"({"fair_share_scheduling_across_jobs": true})");
+  const JobID job_a = JobID::FromInt(1);
+  const JobID job_b = JobID::FromInt(2);
+  std::vector<TaskID> dispatched;
+  auto callback_for = [&dispatched](const TaskID &task_id) {
+    return [&dispatched, task_id](Status, std::function<void()>,
+                                  std::function<void()>) {
+      dispatched.push_back(task_id);
+    };
+  };
+  std::vector<RayTask> tasks;
+  for (int i = 0; i < 4; i++) {
+    tasks.push_back(CreateJobTask({{ray::kCPU_ResourceLabel, 4}}, job_a));
+  }
+  tasks.push_back(CreateJobTask({{ray::kCPU_ResourceLabel, 4}}, job_b));
+  std::vector<rpc::RequestWorkerLeaseReply> replies(tasks.size());
+
+  // The first two tasks of job A take all the CPUs.
+  for (int i = 0; i < 2; i++) {
+    pool_.PushWorker(std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234));
+    const TaskID task_id = tasks[i].GetTaskSpecification().TaskId();
+    task_manager_.QueueAndScheduleTask(tasks[i], &replies[i], callback_for(task_id));
+  }
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(dispatched.size(), 2);
+  for (size_t i = 2; i < tasks.size(); i++) {
+    const TaskID task_id = tasks[i].GetTaskSpecification().TaskId();
+    task_manager_.QueueAndScheduleTask(tasks[i], &replies[i], callback_for(task_id));
+  }
+  ASSERT_EQ(dispatched.size(), 2);
+
+  // Job B holds no workers, so its task goes before the rest of job A.
+  auto finished_worker = leased_workers_.begin()->second;
+  leased_workers_.erase(leased_workers_.begin());
+  RayTask finished_task;
+  task_manager_.TaskFinished(finished_worker, &finished_task);
+  pool_.PushWorker(std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234));
+  task_manager_.ScheduleAndDispatchTasks();
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(dispatched.size(), 3);
+  ASSERT_EQ(dispatched.back(), tasks[4].GetTaskSpecification().TaskId());
+
+  for (auto &entry : leased_workers_) {
+    task_manager_.TaskFinished(entry.second, &finished_task);
+  }
+  leased_workers_.clear();
+  ASSERT_TRUE(task_manager_.CancelTask(tasks[2].GetTaskSpecification().TaskId()));
+  ASSERT_TRUE(task_manager_.CancelTask(tasks[3].GetTaskSpecification().TaskId()));
+  RayConfig::instance().initialize(R"({"fair_share_scheduling_across_jobs": false})");
+  AssertNoLeaks();
+}
+
+TEST_F(ClusterTaskManagerTest, PreemptLowerPriorityTaskTest) {
+  /*
+    A task that fits on no node preempts a retriable task of lower priority, and
+    runs once the preempted worker returns its resources.
+   */
+  RayConfig::instance().initialize(R"({"preempt_lower_priority_tasks": true})");
+  std::vector<std::shared_ptr<WorkerInterface>> preempted;
+  SetPreemptWorker([&preempted](std::shared_ptr<WorkerInterface> worker) {
+    preempted.push_back(worker);
+  });
+  int num_callbacks = 0;
+  auto callback = [&num_callbacks](Status, std::function<void()>,
+                                   std::function<void()>) { num_callbacks++; };
+
+  // A task that is not retriable and a retriable one take all the CPUs.
+  RayTask fixed_task = CreatePriorityTask({{ray::kCPU_ResourceLabel, 4}}, 0, 0);
+  RayTask retriable_task = CreatePriorityTask({{ray::kCPU_ResourceLabel, 4}}, 0, 3);
+  rpc::RequestWorkerLeaseReply reply1;
+  rpc::RequestWorkerLeaseReply reply2;
+  for (int i = 0; i < 2; i++) {
+    pool_.PushWorker(std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234));
+  }
+  task_manager_.QueueAndScheduleTask(fixed_task, &reply1, callback);
+  task_manager_.QueueAndScheduleTask(retriable_task, &reply2, callback);
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(num_callbacks, 2);
+
+  // A task of the same priority doesn't preempt anything.
+  RayTask same_task = CreatePriorityTask({{ray::kCPU_ResourceLabel, 4}}, 0, 3);
+  rpc::RequestWorkerLeaseReply reply3;
+  task_manager_.QueueAndScheduleTask(same_task, &reply3, callback);
+  ASSERT_TRUE(preempted.empty());
+  ASSERT_TRUE(task_manager_.CancelTask(same_task.GetTaskSpecification().TaskId()));
+  num_callbacks--;
+
+  // A task of higher priority preempts the retriable task, once.
+  RayTask urgent_task = CreatePriorityTask({{ray::kCPU_ResourceLabel, 4}}, 1, 0);
+  rpc::RequestWorkerLeaseReply reply4;
+  task_manager_.QueueAndScheduleTask(urgent_task, &reply4, callback);
+  ASSERT_EQ(preempted.size(), 1);
+  ASSERT_EQ(preempted[0]->GetAssignedTaskId(),
+            retriable_task.GetTaskSpecification().TaskId());
+  task_manager_.ScheduleAndDispatchTasks();
+  ASSERT_EQ(preempted.size(), 1);
+
+  // The urgent task runs once the preempted worker is gone.
+  leased_workers_.erase(preempted[0]->WorkerId());
+  RayTask finished_task;
+  task_manager_.TaskFinished(preempted[0], &finished_task);
+  pool_.PushWorker(std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234));
+  task_manager_.ScheduleAndDispatchTasks();
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(num_callbacks, 3);
+  ASSERT_EQ(preempted.size(), 1);
+
+  for (auto &entry : leased_workers_) {
+    task_manager_.TaskFinished(entry.second, &finished_task);
+  }
+  leased_workers_.clear();
+  SetPreemptWorker(nullptr);
+  RayConfig::instance().initialize(R"({"preempt_lower_priority_tasks": false})");
+  AssertNoLeaks();
+}
+
 TEST_F(ClusterTaskManagerTest, DispatchQueueNonBlockingTest) {
   /*
     Test that if no worker is available for the first task in a dispatch
@@ -851,6 +1055,56 @@ TEST_F(ClusterTaskManagerTest, HeartbeatTest) {
   }
 }
 
+TEST_F(ClusterTaskManagerTest, CompactResourceLoadReportTest) {
+  /*
+    Test that a compact load report merges the shapes until they fit the maximum
+    number of shapes, without losing any of the queued tasks.
+   */
+  RayConfig::instance().initialize(R"({"compact_resource_load_report": true})");
+  rpc::RequestWorkerLeaseReply reply;
+  auto callback = [](Status, std::function<void()>, std::function<void()>) {};
+
+  // More distinct shapes than `max_resource_shapes_per_load_report`. The node has 8
+  // CPUs, so the larger shapes are infeasible.
+  const int num_shapes = 200;
+  std::vector<TaskID> to_cancel;
+  for (int i = 1; i <= num_shapes; i++) {
+    RayTask task = CreateTask({{ray::kCPU_ResourceLabel, i}});
+    task.SetBacklogSize(1);
+    task_manager_.QueueAndScheduleTask(task, &reply, callback);
+    to_cancel.push_back(task.GetTaskSpecification().TaskId());
+  }
+  pool_.TriggerCallbacks();
+
+  rpc::ResourcesData data;
+  task_manager_.FillResourceUsage(data);
+  const auto &demands = data.resource_load_by_shape().resource_demands();
+  ASSERT_LE(demands.size(), RayConfig::instance().max_resource_shapes_per_load_report());
+  uint64_t num_ready = 0;
+  uint64_t num_infeasible = 0;
+  int64_t backlog_size = 0;
+  for (const auto &demand : demands) {
+    // Quantities are rounded up to powers of two.
+    double quantity = demand.shape().at(ray::kCPU_ResourceLabel);
+    ASSERT_EQ(quantity, std::pow(2, std::round(std::log2(quantity))));
+    num_ready += demand.num_ready_requests_queued();
+    num_infeasible += demand.num_infeasible_requests_queued();
+    backlog_size += demand.backlog_size();
+  }
+  ASSERT_EQ(num_ready, 8);
+  ASSERT_EQ(num_infeasible, num_shapes - 8);
+  ASSERT_EQ(backlog_size, num_shapes);
+  // The aggregate load isn't quantized.
+  ASSERT_EQ(data.resource_load().at(ray::kCPU_ResourceLabel),
+            num_shapes * (num_shapes + 1) / 2);
+
+  for (auto &task_id : to_cancel) {
+    ASSERT_TRUE(task_manager_.CancelTask(task_id));
+  }
+  RayConfig::instance().initialize(R"({"compact_resource_load_report": false})");
+  AssertNoLeaks();
+}
+
 TEST_F(ClusterTaskManagerTest, BacklogReportTest) {
   /*
     Test basic scheduler functionality:
@@ -1050,6 +1304,115 @@ TEST_F(ClusterTaskManagerTest, TestMultipleInfeasibleTasksWarnOnce) {
   ASSERT_EQ(announce_infeasible_task_calls_, 1);
 }
 
+TEST_F(ClusterTaskManagerTest, ScheduleQueuedTasksOfOneClassTest) {
+  /*
+    Test that all queued tasks of a scheduling class are placed in one pass, once the
+    first of them can be placed on the local node.
+   */
+  const int num_tasks = 3;
+  int num_callbacks = 0;
+  auto callback = [&num_callbacks](Status, std::function<void()>,
+                                   std::function<void()>) { num_callbacks++; };
+  std::vector<rpc::RequestWorkerLeaseReply> replies(num_tasks);
+  for (int i = 0; i < num_tasks; i++) {
+    RayTask task = CreateTask({{"custom", 1}});
+    task_manager_.QueueAndScheduleTask(task, &replies[i], callback);
+  }
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(announce_infeasible_task_calls_, 1);
+  ASSERT_EQ(task_manager_.infeasible_tasks_.size(), 1);
+
+  // The tasks become feasible locally.
+  scheduler_->AddLocalResourceInstances("custom", {num_tasks});
+  for (int i = 0; i < num_tasks; i++) {
+    pool_.PushWorker(std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234));
+  }
+  task_manager_.ScheduleAndDispatchTasks();
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(num_callbacks, num_tasks);
+  ASSERT_EQ(leased_workers_.size(), num_tasks);
+  ASSERT_EQ(node_info_calls_, 0);
+
+  while (!leased_workers_.empty()) {
+    RayTask finished_task;
+    task_manager_.TaskFinished(leased_workers_.begin()->second, &finished_task);
+    leased_workers_.erase(leased_workers_.begin());
+  }
+  AssertNoLeaks();
+}
+
+TEST_F(ClusterTaskManagerTest, GangSchedulingTest) {
+  /*
+    Test that the tasks of a gang are held until all of them are queued, and are then
+    placed across nodes at once.
+   */
+  auto remote_node_id = NodeID::FromRandom();
+  AddNode(remote_node_id, 8);
+  int num_callbacks = 0;
+  auto callback = [&num_callbacks](Status, std::function<void()>,
+                                   std::function<void()>) { num_callbacks++; };
+
+  // Neither task fits next to the other on a single node.
+  auto task1 = CreateGangTask({{ray::kCPU_ResourceLabel, 8}}, id_, "gang", 2);
+  auto task2 = CreateGangTask({{ray::kCPU_ResourceLabel, 8}}, id_, "gang", 2);
+  rpc::RequestWorkerLeaseReply reply1;
+  rpc::RequestWorkerLeaseReply reply2;
+  task_manager_.QueueAndScheduleTask(task1, &reply1, callback);
+  pool_.TriggerCallbacks();
+  // The first task waits for the rest of its gang.
+  ASSERT_EQ(num_callbacks, 0);
+  ASSERT_EQ(pool_.num_pops, 0);
+
+  task_manager_.QueueAndScheduleTask(task2, &reply2, callback);
+  // One task is spilled back and the other one runs locally.
+  ASSERT_EQ(num_callbacks, 1);
+  ASSERT_EQ(pool_.num_pops, 1);
+  ASSERT_TRUE(task_manager_.pending_gangs_.empty());
+  ASSERT_EQ(reply1.retry_at_raylet_address().raylet_id().empty() +
+                reply2.retry_at_raylet_address().raylet_id().empty(),
+            1);
+
+  pool_.PushWorker(std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234));
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(num_callbacks, 2);
+  ASSERT_EQ(leased_workers_.size(), 1);
+
+  RayTask finished_task;
+  task_manager_.TaskFinished(leased_workers_.begin()->second, &finished_task);
+  leased_workers_.clear();
+  AssertNoLeaks();
+}
+
+TEST_F(ClusterTaskManagerTest, GangSchedulingTimeoutTest) {
+  /*
+    Test that a gang that cannot be placed as a whole is failed after its timeout,
+    without starting any of its tasks.
+   */
+  int num_callbacks = 0;
+  auto callback = [&num_callbacks](Status, std::function<void()>,
+                                   std::function<void()>) { num_callbacks++; };
+  auto task1 = CreateGangTask({{ray::kCPU_ResourceLabel, 8}}, id_, "gang", 2);
+  auto task2 = CreateGangTask({{ray::kCPU_ResourceLabel, 8}}, id_, "gang", 2);
+  rpc::RequestWorkerLeaseReply reply1;
+  rpc::RequestWorkerLeaseReply reply2;
+  task_manager_.QueueAndScheduleTask(task1, &reply1, callback);
+  task_manager_.QueueAndScheduleTask(task2, &reply2, callback);
+  // Only one of the tasks fits in the cluster, so neither starts.
+  ASSERT_EQ(num_callbacks, 0);
+  ASSERT_EQ(pool_.num_pops, 0);
+  ASSERT_EQ(task_manager_.pending_gangs_.size(), 1);
+
+  task_manager_.pending_gangs_["gang"].queued_at_ms -=
+      RayConfig::instance().gang_scheduling_timeout_ms() + 1;
+  task_manager_.ScheduleAndDispatchTasks();
+  ASSERT_EQ(num_callbacks, 2);
+  ASSERT_TRUE(reply1.gang_scheduling_failed());
+  ASSERT_TRUE(reply2.gang_scheduling_failed());
+  ASSERT_EQ(pool_.num_pops, 0);
+  ASSERT_TRUE(task_manager_.pending_gangs_.empty());
+  AssertNoLeaks();
+}
+
 TEST_F(ClusterTaskManagerTest, TestAnyPendingTasks) {
   /*
     Check if the manager can correctly identify pending tasks.
@@ -1519,6 +1882,42 @@ TEST_F(ClusterTaskManagerTest, PopWorkerExactlyOnce) {
   AssertNoLeaks();
 }
 
+/// Scheduling throughput of the task manager on synthetic clusters. These tests are
+/// excluded from cluster_task_manager_test and run by cluster_task_manager_perf_test.
+class ClusterTaskManagerPerfTest : public ClusterTaskManagerTest,
+                                   public ::testing::WithParamInterface<int> {};
+
+TEST_P(ClusterTaskManagerPerfTest, QueueAndScheduleTask) {
+  const int num_nodes = GetParam();
+  for (int i = 0; i < num_nodes; i++) {
+    AddNode(NodeID::FromRandom(), 64);
+  }
+  // Stay below the capacity of the cluster, so that every task is placed right away.
+  const int num_tasks = 10000;
+  std::vector<RayTask> tasks;
+  tasks.reserve(num_tasks);
+  for (int i = 0; i < num_tasks; i++) {
+    tasks.push_back(CreateTask({{ray::kCPU_ResourceLabel, 2}}));
+  }
+  std::vector<rpc::RequestWorkerLeaseReply> replies(num_tasks);
+  auto empty_callback = [](Status, std::function<void()>, std::function<void()>) {};
+
+  const auto start = absl::Now();
+  for (int i = 0; i < num_tasks; i++) {
+    task_manager_.QueueAndScheduleTask(tasks[i], &replies[i], empty_callback);
+  }
+  const auto elapsed = absl::Now() - start;
+
+  const auto tasks_per_second =
+      static_cast<int64_t>(num_tasks / absl::ToDoubleSeconds(elapsed));
+  RAY_LOG(INFO) << "Scheduled " << tasks_per_second << " tasks per second with "
+                << num_nodes << " nodes";
+  RecordProperty("tasks_per_second", std::to_string(tasks_per_second));
+}
+
+INSTANTIATE_TEST_CASE_P(ClusterSizes, ClusterTaskManagerPerfTest,
+                        ::testing::Values(1000, 5000, 10000));
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -16,15 +16,15 @@
 
 #include <cmath>
 
-FixedPoint::FixedPoint(double d) { i_ = (uint64_t)(d * RESOURCE_UNIT_SCALING); }
+FixedPoint::FixedPoint(double d) { i_ = std::llround(d * RESOURCE_UNIT_SCALING); }
 
-FixedPoint::FixedPoint(int i) { i_ = (i * RESOURCE_UNIT_SCALING); }
+FixedPoint::FixedPoint(int i) { i_ = ((int64_t)i * RESOURCE_UNIT_SCALING); }
 
-FixedPoint::FixedPoint(uint32_t i) { i_ = (i * RESOURCE_UNIT_SCALING); }
+FixedPoint::FixedPoint(uint32_t i) { i_ = ((int64_t)i * RESOURCE_UNIT_SCALING); }
 
-FixedPoint::FixedPoint(int64_t i) : FixedPoint((double)i) {}
+FixedPoint::FixedPoint(int64_t i) { i_ = (i * RESOURCE_UNIT_SCALING); }
 
-FixedPoint::FixedPoint(uint64_t i) : FixedPoint((double)i) {}
+FixedPoint::FixedPoint(uint64_t i) { i_ = ((int64_t)i * RESOURCE_UNIT_SCALING); }
 
 FixedPoint FixedPoint::operator+(FixedPoint const &ru) const {
   FixedPoint res;
@@ -54,30 +54,22 @@ FixedPoint FixedPoint::operator-() const {
   return res;
 }
 
-FixedPoint FixedPoint::operator+(double const d) const {
-  FixedPoint res;
-  res.i_ = i_ + (int64_t)(d * RESOURCE_UNIT_SCALING);
-  return res;
-}
+FixedPoint FixedPoint::operator+(double const d) const { return *this + FixedPoint(d); }
 
-FixedPoint FixedPoint::operator-(double const d) const {
-  FixedPoint res;
-  res.i_ = i_ - (int64_t)(d * RESOURCE_UNIT_SCALING);
-  return res;
-}
+FixedPoint FixedPoint::operator-(double const d) const { return *this - FixedPoint(d); }
 
 FixedPoint FixedPoint::operator=(double const d) {
-  i_ = (int64_t)(d * RESOURCE_UNIT_SCALING);
+  i_ = FixedPoint(d).i_;
   return *this;
 }
 
 FixedPoint FixedPoint::operator+=(double const d) {
-  i_ += (int64_t)(d * RESOURCE_UNIT_SCALING);
+  i_ += FixedPoint(d).i_;
   return *this;
 }
 
 FixedPoint FixedPoint::operator+=(int64_t const ru) {
-  *this += (double)ru;
+  i_ += ru * RESOURCE_UNIT_SCALING;
   return *this;
 }
 
@@ -93,4 +85,12 @@ std::ostream &operator<<(std::ostream &out, FixedPoint const &ru1) {
   return out;
 }
 
-double FixedPoint::Double() const { return round(i_) / RESOURCE_UNIT_SCALING; };
+double FixedPoint::Double() const { return (double)i_ / RESOURCE_UNIT_SCALING; };
+
+int64_t FixedPoint::Raw() const { return i_; };
+
+FixedPoint FixedPoint::FromRaw(int64_t raw) {
+  FixedPoint res;
+  res.i_ = raw;
+  return res;
+}
@@ -19,12 +19,14 @@
 
 #define RESOURCE_UNIT_SCALING 10000
 
-/// Fixed point data type.
+/// Fixed point data type. All arithmetic and comparisons between FixedPoints are done
+/// on the underlying integer, so only conversions from and to double use float math.
 class FixedPoint {
  private:
   int64_t i_;
 
  public:
+  /// Rounds to the nearest 1 / RESOURCE_UNIT_SCALING.
   FixedPoint(double d = 0);
   FixedPoint(int i);
   FixedPoint(uint32_t i);
@@ -60,5 +62,11 @@ class FixedPoint {
 
   double Double() const;
 
+  /// The value in units of 1 / RESOURCE_UNIT_SCALING.
+  int64_t Raw() const;
+
+  /// Construct from a value in units of 1 / RESOURCE_UNIT_SCALING.
+  static FixedPoint FromRaw(int64_t raw);
+
   friend std::ostream &operator<<(std::ostream &out, FixedPoint const &ru1);
 };
@@ -0,0 +1,181 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/scheduling/gpu_topology.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+#include <boost/algorithm/string.hpp>
+
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace {
+
+/// The distance of a connection type of `nvidia-smi topo -m`.
+int ConnectionDistance(const std::string &connection) {
+  if (connection == "X") {
+    return 0;
+  } else if (boost::starts_with(connection, "NV")) {
+    return 1;
+  } else if (connection == "PIX") {
+    return 2;
+  } else if (connection == "PXB") {
+    return 3;
+  } else if (connection == "PHB") {
+    return 4;
+  } else if (connection == "NODE") {
+    return 5;
+  }
+  // SYS, or anything newer that we don't know about.
+  return 6;
+}
+
+bool IsGpuLabel(const std::string &label) {
+  return label.size() > 3 && boost::starts_with(label, "GPU") &&
+         std::all_of(label.begin() + 3, label.end(), ::isdigit);
+}
+
+}  // namespace
+
+GpuDistances ParseGpuTopology(const std::string &output) {
+  std::istringstream lines(output);
+  std::string line;
+  size_t num_gpus = 0;
+  GpuDistances distances;
+  while (std::getline(lines, line)) {
+    std::vector<std::string> tokens;
+    boost::split(tokens, boost::trim_copy(line), boost::is_any_of(" \t"),
+                 boost::token_compress_on);
+    if (tokens.empty() || tokens[0].empty()) {
+      continue;
+    }
+    if (num_gpus == 0) {
+      // The header lists the GPUs first, and then the other devices.
+      if (IsGpuLabel(tokens[0])) {
+        while (num_gpus < tokens.size() && IsGpuLabel(tokens[num_gpus])) {
+          num_gpus++;
+        }
+      }
+      continue;
+    }
+    if (!IsGpuLabel(tokens[0]) || tokens.size() < num_gpus + 1) {
+      break;
+    }
+    std::vector<int> row;
+    for (size_t i = 1; i <= num_gpus; i++) {
+      row.push_back(ConnectionDistance(tokens[i]));
+    }
+    distances.push_back(std::move(row));
+    if (distances.size() == num_gpus) {
+      return distances;
+    }
+  }
+  return {};
+}
+
+GpuDistances DiscoverGpuTopology() {
+#ifdef _WIN32
+  return {};
+#else
+  FILE *pipe = popen("nvidia-smi topo -m 2>/dev/null", "r");
+  if (pipe == nullptr) {
+    return {};
+  }
+  std::string output;
+  char buffer[4096];
+  size_t num_read;
+  while ((num_read = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+    output.append(buffer, num_read);
+  }
+  pclose(pipe);
+  GpuDistances all_distances = ParseGpuTopology(output);
+
+  const char *visible_devices = std::getenv("CUDA_VISIBLE_DEVICES");
+  if (all_distances.empty() || visible_devices == nullptr) {
+    return all_distances;
+  }
+  std::vector<std::string> device_ids;
+  boost::split(device_ids, std::string(visible_devices), boost::is_any_of(","));
+  std::vector<size_t> visible;
+  for (const auto &device_id : device_ids) {
+    if (device_id.empty() ||
+        !std::all_of(device_id.begin(), device_id.end(), ::isdigit) ||
+        std::stoul(device_id) >= all_distances.size()) {
+      // E.g. GPU UUIDs, which `nvidia-smi topo -m` doesn't show.
+      RAY_LOG(INFO) << "Cannot map CUDA_VISIBLE_DEVICES=" << visible_devices
+                    << " to the GPU topology, allocating GPUs without it.";
+      return {};
+    }
+    visible.push_back(std::stoul(device_id));
+  }
+  GpuDistances distances(visible.size(), std::vector<int>(visible.size()));
+  for (size_t i = 0; i < visible.size(); i++) {
+    for (size_t j = 0; j < visible.size(); j++) {
+      distances[i][j] = all_distances[visible[i]][visible[j]];
+    }
+  }
+  return distances;
+#endif
+}
+
+std::vector<size_t> PickClosestInstances(const std::vector<bool> &is_free, size_t count,
+                                         const GpuDistances &distances) {
+  if (distances.size() != is_free.size() ||
+      static_cast<size_t>(std::count(is_free.begin(), is_free.end(), true)) < count) {
+    return {};
+  }
+  std::vector<size_t> best;
+  int64_t best_total = -1;
+  for (size_t seed = 0; seed < is_free.size(); seed++) {
+    if (!is_free[seed]) {
+      continue;
+    }
+    std::vector<size_t> picked = {seed};
+    std::vector<bool> is_picked(is_free.size(), false);
+    is_picked[seed] = true;
+    int64_t total = 0;
+    while (picked.size() < count) {
+      int64_t closest = -1;
+      int64_t closest_distance = 0;
+      for (size_t i = 0; i < is_free.size(); i++) {
+        if (!is_free[i] || is_picked[i]) {
+          continue;
+        }
+        int64_t distance = 0;
+        for (size_t j : picked) {
+          distance += distances[i][j];
+        }
+        if (closest == -1 || distance < closest_distance) {
+          closest = static_cast<int64_t>(i);
+          closest_distance = distance;
+        }
+      }
+      picked.push_back(static_cast<size_t>(closest));
+      is_picked[closest] = true;
+      total += closest_distance;
+    }
+    if (best_total == -1 || total < best_total) {
+      best = std::move(picked);
+      best_total = total;
+    }
+  }
+  return best;
+}
+
+}  // namespace ray
@@ -0,0 +1,53 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace ray {
+
+/// The distances between the GPUs of a node, indexed by GPU instance. Smaller is
+/// closer: 0 for the GPU itself, then NVLink, a single PCIe switch, several PCIe
+/// switches, the PCIe host bridge, the same NUMA node, and the slowest across NUMA
+/// nodes through the socket interconnect.
+using GpuDistances = std::vector<std::vector<int>>;
+
+/// Parse the GPU matrix of the output of `nvidia-smi topo -m`.
+///
+/// \param output The output of `nvidia-smi topo -m`.
+/// \return The distances between the GPUs, or empty if the output has no matrix.
+GpuDistances ParseGpuTopology(const std::string &output);
+
+/// Discover the distances between the GPUs that this process may use, i.e. those in
+/// CUDA_VISIBLE_DEVICES if it is set, in the order of the GPU instances of the node.
+///
+/// \return The distances between the GPUs, or empty if they can't be discovered.
+GpuDistances DiscoverGpuTopology();
+
+/// Pick the instances of a resource to allocate whole for a request, such that they
+/// are as close to each other as possible. Starting from each free instance, the
+/// closest free instance to the ones picked so far is added until there are enough,
+/// and the set with the smallest total distance between its instances wins.
+///
+/// \param is_free Whether each instance is entirely available.
+/// \param count The number of instances to pick.
+/// \param distances The distances between the instances.
+/// \return The picked instances, or empty if there are not enough free instances or
+/// the distances don't match the instances.
+std::vector<size_t> PickClosestInstances(const std::vector<bool> &is_free, size_t count,
+                                         const GpuDistances &distances);
+
+}  // namespace ray
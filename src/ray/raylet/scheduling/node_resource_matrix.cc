@@ -0,0 +1,225 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/scheduling/node_resource_matrix.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ray {
+
+namespace {
+
+/// The utilization of one resource, with the same arithmetic as
+/// NodeResources::CalculateCriticalResourceUtilization so that both agree on ties.
+/// Nodes without the resource have no utilization.
+inline float ResourceUtilization(int64_t available, int64_t total) {
+  return total == 0 ? 0
+                    : 1 - ((static_cast<double>(available) / RESOURCE_UNIT_SCALING) /
+                           (static_cast<double>(total) / RESOURCE_UNIT_SCALING));
+}
+
+}  // namespace
+
+void NodeResourceMatrix::Update(int64_t node_id, const NodeResources &resources) {
+  auto it = rows_.find(node_id);
+  size_t row;
+  if (it == rows_.end()) {
+    row = node_ids_.size();
+    rows_.emplace(node_id, row);
+    node_ids_.push_back(node_id);
+    for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+      total_[i].push_back(0);
+      available_[i].push_back(0);
+    }
+    object_pulls_queued_.push_back(0);
+    memory_pressure_.push_back(0);
+    if (node_ids_.size() > tree_leaves_) {
+      ResizeTree(node_ids_.size());
+    }
+  } else {
+    row = it->second;
+  }
+
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    if (i < resources.predefined_resources.size()) {
+      total_[i][row] = resources.predefined_resources[i].total.Raw();
+      available_[i][row] = resources.predefined_resources[i].available.Raw();
+    } else {
+      total_[i][row] = 0;
+      available_[i][row] = 0;
+    }
+  }
+  object_pulls_queued_[row] = resources.object_pulls_queued ? 1 : 0;
+  memory_pressure_[row] = resources.memory_pressure ? 1 : 0;
+  UpdateTree(row);
+}
+
+void NodeResourceMatrix::Remove(int64_t node_id) {
+  auto it = rows_.find(node_id);
+  if (it == rows_.end()) {
+    return;
+  }
+  const size_t row = it->second;
+  const size_t last = node_ids_.size() - 1;
+  rows_.erase(it);
+  if (row != last) {
+    node_ids_[row] = node_ids_[last];
+    rows_[node_ids_[row]] = row;
+    for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+      total_[i][row] = total_[i][last];
+      available_[i][row] = available_[i][last];
+    }
+    object_pulls_queued_[row] = object_pulls_queued_[last];
+    memory_pressure_[row] = memory_pressure_[last];
+    UpdateTree(row);
+  }
+  node_ids_.pop_back();
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    total_[i].pop_back();
+    available_[i].pop_back();
+  }
+  object_pulls_queued_.pop_back();
+  memory_pressure_.pop_back();
+  UpdateTree(last);
+}
+
+void NodeResourceMatrix::CheckPredefinedResources(
+    const ResourceRequest &resource_request, std::vector<uint8_t> *feasible,
+    std::vector<uint8_t> *available) const {
+  const size_t num_rows = node_ids_.size();
+  feasible->assign(num_rows, 1);
+  available->assign(num_rows, 1);
+  uint8_t *feasible_data = feasible->data();
+  uint8_t *available_data = available->data();
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    const int64_t demand = resource_request.predefined_resources[i].Raw();
+    const int64_t *total = total_[i].data();
+    const int64_t *avail = available_[i].data();
+    // Keep these loops free of branches so that they are vectorized.
+    for (size_t row = 0; row < num_rows; row++) {
+      feasible_data[row] &= static_cast<uint8_t>(total[row] >= demand);
+    }
+    for (size_t row = 0; row < num_rows; row++) {
+      available_data[row] &= static_cast<uint8_t>(avail[row] >= demand);
+    }
+  }
+}
+
+void NodeResourceMatrix::CalculateCriticalResourceUtilization(
+    std::vector<float> *utilization) const {
+  const size_t num_rows = node_ids_.size();
+  utilization->assign(num_rows, 0);
+  float *utilization_data = utilization->data();
+  for (const auto &i : {CPU, MEM, OBJECT_STORE_MEM}) {
+    const int64_t *total = total_[i].data();
+    const int64_t *avail = available_[i].data();
+    for (size_t row = 0; row < num_rows; row++) {
+      utilization_data[row] =
+          std::max(utilization_data[row], ResourceUtilization(avail[row], total[row]));
+    }
+  }
+}
+
+void NodeResourceMatrix::FindAvailableRows(const ResourceRequest &resource_request,
+                                           std::vector<size_t> *rows) const {
+  rows->clear();
+  if (tree_leaves_ == 0) {
+    return;
+  }
+  std::array<int64_t, PredefinedResources_MAX> demand;
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    demand[i] = resource_request.predefined_resources[i].Raw();
+  }
+  auto fits = [&demand](const std::array<int64_t, PredefinedResources_MAX> &entry) {
+    for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+      if (entry[i] < demand[i]) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Depth-first, left to right, so that the rows come out in ascending order.
+  std::vector<size_t> stack = {1};
+  while (!stack.empty()) {
+    const size_t index = stack.back();
+    stack.pop_back();
+    if (!fits(max_available_tree_[index])) {
+      continue;
+    }
+    if (index >= tree_leaves_) {
+      rows->push_back(index - tree_leaves_);
+    } else {
+      stack.push_back(2 * index + 1);
+      stack.push_back(2 * index);
+    }
+  }
+}
+
+bool NodeResourceMatrix::IsFeasibleAt(size_t row,
+                                      const ResourceRequest &resource_request) const {
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    if (total_[i][row] < resource_request.predefined_resources[i].Raw()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+float NodeResourceMatrix::CriticalResourceUtilizationAt(size_t row) const {
+  float highest = 0;
+  for (const auto &i : {CPU, MEM, OBJECT_STORE_MEM}) {
+    highest = std::max(highest, ResourceUtilization(available_[i][row], total_[i][row]));
+  }
+  return highest;
+}
+
+void NodeResourceMatrix::ResizeTree(size_t num_rows) {
+  tree_leaves_ = std::max<size_t>(1, tree_leaves_);
+  while (tree_leaves_ < num_rows) {
+    tree_leaves_ *= 2;
+  }
+  std::array<int64_t, PredefinedResources_MAX> empty;
+  empty.fill(std::numeric_limits<int64_t>::min());
+  max_available_tree_.assign(2 * tree_leaves_, empty);
+  for (size_t row = 0; row < node_ids_.size(); row++) {
+    for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+      max_available_tree_[tree_leaves_ + row][i] = available_[i][row];
+    }
+  }
+  for (size_t index = tree_leaves_ - 1; index > 0; index--) {
+    for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+      max_available_tree_[index][i] = std::max(max_available_tree_[2 * index][i],
+                                               max_available_tree_[2 * index + 1][i]);
+    }
+  }
+}
+
+void NodeResourceMatrix::UpdateTree(size_t row) {
+  size_t index = tree_leaves_ + row;
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    max_available_tree_[index][i] = row < node_ids_.size()
+                                        ? available_[i][row]
+                                        : std::numeric_limits<int64_t>::min();
+  }
+  for (index /= 2; index > 0; index /= 2) {
+    for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+      max_available_tree_[index][i] = std::max(max_available_tree_[2 * index][i],
+                                               max_available_tree_[2 * index + 1][i]);
+    }
+  }
+}
+
+}  // namespace ray
@@ -0,0 +1,126 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "ray/raylet/scheduling/cluster_resource_data.h"
+
+namespace ray {
+
+/// The predefined resources of all nodes in the cluster, stored column by column.
+///
+/// Each predefined resource has one contiguous array of totals and one of available
+/// amounts, with one row per node. Checking a request against every node then is a
+/// few tight loops over integers that the compiler can vectorize, instead of a map
+/// lookup and a walk over the `NodeResources` of each node. Custom resources are not
+/// stored here and have to be checked against the nodes themselves.
+///
+/// Rows are not in any particular order. Removing a node moves the last row into
+/// its place.
+///
+/// On top of the columns, a max segment tree over the rows holds the most available
+/// amount of each predefined resource in every range of rows. Finding the nodes a
+/// request fits on then only visits the ranges that may contain such a node, which
+/// is much fewer than all nodes when the cluster is busy.
+class NodeResourceMatrix {
+ public:
+  /// Add a node or overwrite its row.
+  ///
+  /// \param node_id The node.
+  /// \param resources The (local view of the) resources of the node.
+  void Update(int64_t node_id, const NodeResources &resources);
+
+  /// Remove a node. This is a no-op if the node is unknown.
+  ///
+  /// \param node_id The node.
+  void Remove(int64_t node_id);
+
+  /// The number of nodes.
+  size_t NumRows() const { return node_ids_.size(); }
+
+  /// The node stored at a row.
+  int64_t NodeIdAt(size_t row) const { return node_ids_[row]; }
+
+  /// Whether the node stored at a row has object pulls queued.
+  bool ObjectPullsQueuedAt(size_t row) const { return object_pulls_queued_[row] != 0; }
+
+  /// Whether the node stored at a row is short of memory.
+  bool MemoryPressureAt(size_t row) const { return memory_pressure_[row] != 0; }
+
+  /// Check the predefined resources of a request against all nodes. This is the
+  /// predefined resource part of `NodeResources::IsFeasible` and
+  /// `NodeResources::IsAvailable`. The latter also considers queued object pulls,
+  /// which is left to the caller.
+  ///
+  /// \param resource_request The request.
+  /// \param[out] feasible Per row, 1 if the totals of the node fit the request.
+  /// \param[out] available Per row, 1 if the available resources of the node fit the
+  /// request.
+  void CheckPredefinedResources(const ResourceRequest &resource_request,
+                                std::vector<uint8_t> *feasible,
+                                std::vector<uint8_t> *available) const;
+
+  /// Calculate `NodeResources::CalculateCriticalResourceUtilization` for all nodes.
+  ///
+  /// \param[out] utilization Per row, the critical resource utilization of the node.
+  void CalculateCriticalResourceUtilization(std::vector<float> *utilization) const;
+
+  /// Find the rows whose available predefined resources fit a request, using the
+  /// segment tree. This takes O(k log n) for k results.
+  ///
+  /// \param resource_request The request.
+  /// \param[out] rows The rows, in ascending order.
+  void FindAvailableRows(const ResourceRequest &resource_request,
+                         std::vector<size_t> *rows) const;
+
+  /// Whether the predefined resource totals of a row fit a request.
+  bool IsFeasibleAt(size_t row, const ResourceRequest &resource_request) const;
+
+  /// The critical resource utilization of a row.
+  float CriticalResourceUtilizationAt(size_t row) const;
+
+ private:
+  /// Rebuild the segment tree for at least `num_rows` rows.
+  void ResizeTree(size_t num_rows);
+
+  /// Copy a row (or an empty row, past the last one) into the segment tree and
+  /// update the ranges that contain it.
+  void UpdateTree(size_t row);
+
+  /// The node of each row.
+  std::vector<int64_t> node_ids_;
+  /// The row of each node.
+  absl::flat_hash_map<int64_t, size_t> rows_;
+  /// Per predefined resource, the raw total of each row. Missing resources are 0.
+  std::array<std::vector<int64_t>, PredefinedResources_MAX> total_;
+  /// Per predefined resource, the raw available amount of each row.
+  std::array<std::vector<int64_t>, PredefinedResources_MAX> available_;
+  /// Whether each row has object pulls queued.
+  std::vector<uint8_t> object_pulls_queued_;
+  /// Whether each row is short of memory.
+  std::vector<uint8_t> memory_pressure_;
+  /// The number of leaves of the segment tree, a power of two.
+  size_t tree_leaves_ = 0;
+  /// The segment tree, as an implicit binary tree whose root is at index 1 and whose
+  /// leaves start at `tree_leaves_`. Each entry holds, per predefined resource, the
+  /// maximum available amount of the rows below it. Leaves without a row hold the
+  /// lowest value, so that no request fits them.
+  std::vector<std::array<int64_t, PredefinedResources_MAX>> max_available_tree_;
+};
+
+}  // namespace ray
@@ -23,15 +23,14 @@ int64_t StringIdMap::Get(const std::string &string_id) const {
   }
 };
 
-std::string StringIdMap::Get(uint64_t id) const {
-  std::string id_string;
+const std::string &StringIdMap::Get(uint64_t id) const {
+  static const std::string kUnknownId = "-1";
   auto it = int_to_string_.find(id);
   if (it == int_to_string_.end()) {
-    id_string = "-1";
+    return kUnknownId;
   } else {
-    id_string = it->second;
+    return it->second;
   }
-  return id_string;
 };
 
 int64_t StringIdMap::Insert(const std::string &string_id, uint8_t max_id) {
@@ -60,4 +59,4 @@ int64_t StringIdMap::Insert(const std::string &string_id, uint8_t max_id) {
   }
 };
 
-int64_t StringIdMap::Count() { return string_to_int_.size(); }
+int64_t StringIdMap::Count() const { return string_to_int_.size(); }
@@ -41,8 +41,10 @@ class StringIdMap {
   /// Get string ID associated with an existing integer ID.
   ///
   /// \param Integre ID.
-  /// \return The string ID associated with the given integer ID.
-  std::string Get(uint64_t id) const;
+  /// \return The string ID associated with the given integer ID, or "-1" if there is
+  /// no such ID. The reference stays valid as long as the map, so callers that only
+  /// read the name do not need to copy it.
+  const std::string &Get(uint64_t id) const;
 
   /// Insert a string ID and get the associated integer ID.
   ///
@@ -56,5 +58,5 @@ class StringIdMap {
   /// deleting an ID still in use.
 
   /// Get number of identifiers.
-  int64_t Count();
+  int64_t Count() const;
 };
@@ -68,6 +68,10 @@ int64_t HybridPolicy(const ResourceRequest &resource_request, const int64_t loca
     }
     bool is_available = node.GetLocalView().IsAvailable(resource_request,
                                                         ignore_pull_manager_at_capacity);
+    // The local node holds back dispatching under memory pressure itself.
+    if (node_id != local_node_id && node.GetLocalView().memory_pressure) {
+      is_available = false;
+    }
     RAY_LOG(DEBUG) << "Node " << node_id << " is "
                    << (is_available ? "available" : "not available");
     float critical_resource_utilization =
@@ -103,6 +107,137 @@ int64_t HybridPolicy(const ResourceRequest &resource_request, const int64_t loca
   return best_node_id;
 }
 
+namespace {
+
+/// The best node among the nodes considered so far, by the same criteria as the
+/// traversal of the policy above. The nodes can be considered in any order.
+class BestNode {
+ public:
+  explicit BestNode(int64_t local_node_id) : local_node_id_(local_node_id) {}
+
+  void Consider(int64_t node_id, bool is_available, float critical_resource_utilization) {
+    // The traversal picks the first node in traversal order among the available
+    // nodes with the lowest utilization, or if there are none, among the feasible
+    // nodes with the lowest utilization.
+    bool update_best_node = false;
+    if (is_available != is_available_) {
+      update_best_node = is_available;
+    } else if (critical_resource_utilization != utilization_score_) {
+      update_best_node = critical_resource_utilization < utilization_score_;
+    } else {
+      update_best_node = Precedes(node_id, node_id_);
+    }
+
+    if (update_best_node) {
+      node_id_ = node_id;
+      utilization_score_ = critical_resource_utilization;
+      is_available_ = is_available;
+    }
+  }
+
+  int64_t NodeId() const { return node_id_; }
+
+  bool IsAvailable() const { return is_available_; }
+
+ private:
+  /// Whether node a comes before node b in the traversal order.
+  bool Precedes(int64_t a, int64_t b) const {
+    if (a == local_node_id_ || b == local_node_id_) {
+      return a == local_node_id_;
+    }
+    return a < b;
+  }
+
+  const int64_t local_node_id_;
+  int64_t node_id_ = -1;
+  float utilization_score_ = INFINITY;
+  bool is_available_ = false;
+};
+
+}  // namespace
+
+int64_t HybridPolicy(const ResourceRequest &resource_request, const int64_t local_node_id,
+                     const absl::flat_hash_map<int64_t, Node> &nodes,
+                     const NodeResourceMatrix &matrix, float spread_threshold,
+                     bool force_spillback, bool require_available,
+                     const absl::flat_hash_map<int64_t, float> *arg_locality,
+                     float locality_weight) {
+  RAY_DCHECK(matrix.NumRows() == nodes.size());
+  const bool has_custom_resources = !resource_request.custom_resources.empty();
+
+  // Consider the node at a row whose predefined resources are feasible.
+  auto consider = [&](BestNode *best, size_t row, bool is_available,
+                      float critical_resource_utilization) {
+    const int64_t node_id = matrix.NodeIdAt(row);
+    if (force_spillback && node_id == local_node_id) {
+      return;
+    }
+    // As above, the local node's pull manager may be at capacity.
+    if (node_id != local_node_id && resource_request.requires_object_store_memory &&
+        matrix.ObjectPullsQueuedAt(row)) {
+      is_available = false;
+    }
+    // The local node holds back dispatching under memory pressure itself.
+    if (node_id != local_node_id && matrix.MemoryPressureAt(row)) {
+      is_available = false;
+    }
+    if (has_custom_resources) {
+      const auto &it = nodes.find(node_id);
+      RAY_CHECK(it != nodes.end());
+      const auto &node = it->second;
+      if (!node.GetLocalView().IsFeasible(resource_request)) {
+        return;
+      }
+      is_available = is_available && node.GetLocalView().IsAvailable(
+                                         resource_request,
+                                         /*ignore_pull_manager_at_capacity=*/true);
+    }
+    if (!is_available && require_available) {
+      return;
+    }
+    if (critical_resource_utilization < spread_threshold) {
+      critical_resource_utilization = 0;
+    }
+    if (arg_locality != nullptr) {
+      auto locality_it = arg_locality->find(node_id);
+      if (locality_it != arg_locality->end()) {
+        critical_resource_utilization -= locality_weight * locality_it->second;
+      }
+    }
+    best->Consider(node_id, is_available, critical_resource_utilization);
+  };
+
+  // Step 1: Available nodes always win, so look for them first. The index only
+  // visits the nodes whose available predefined resources fit.
+  {
+    BestNode best(local_node_id);
+    std::vector<size_t> rows;
+    matrix.FindAvailableRows(resource_request, &rows);
+    for (const size_t row : rows) {
+      if (matrix.IsFeasibleAt(row, resource_request)) {
+        consider(&best, row, true, matrix.CriticalResourceUtilizationAt(row));
+      }
+    }
+    if (best.IsAvailable() || require_available) {
+      return best.IsAvailable() ? best.NodeId() : -1;
+    }
+  }
+
+  // Step 2: No node is available, so pick among all feasible nodes.
+  BestNode best(local_node_id);
+  std::vector<uint8_t> feasible;
+  std::vector<uint8_t> available;
+  std::vector<float> utilization;
+  matrix.CheckPredefinedResources(resource_request, &feasible, &available);
+  matrix.CalculateCriticalResourceUtilization(&utilization);
+  for (size_t row = 0; row < matrix.NumRows(); row++) {
+    if (feasible[row]) {
+      consider(&best, row, available[row], utilization[row]);
+    }
+  }
+  return best.NodeId();
+}
+
 }  // namespace raylet_scheduling_policy
 
 }  // namespace ray
@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "ray/raylet/scheduling/cluster_resource_data.h"
+#include "ray/raylet/scheduling/node_resource_matrix.h"
 
 namespace ray {
 namespace raylet_scheduling_policy {
@@ -56,5 +57,33 @@ int64_t HybridPolicy(const ResourceRequest &resource_request, const int64_t loca
                      const absl::flat_hash_map<int64_t, Node> &nodes,
                      float spread_threshold, bool force_spillback,
                      bool require_available);
+
+/// The same policy as above, but the predefined resources of the nodes are checked
+/// against `matrix`, which must hold a row for every node in `nodes`. Only the nodes
+/// that pass are looked up in `nodes`, and only if the request has custom resources.
+/// Instead of sorting the nodes into the traversal order, ties are broken by traversal
+/// order.
+///
+/// The available nodes are found through the index of the matrix, in time
+/// proportional to their number. Only if there are none, all nodes are scanned for
+/// feasible ones.
+///
+/// Optionally, nodes that hold the arguments of the task are preferred: after the
+/// truncation, the critical resource utilization of a node is lowered by
+/// `locality_weight` times the fraction of the argument bytes on the node. This never
+/// makes a feasible node win over an available one.
+///
+/// \param matrix: The predefined resources of the nodes in `nodes`.
+/// \param arg_locality: If given, the fraction of the argument bytes of the task on
+/// each node. Nodes that are missing hold none.
+/// \param locality_weight: The weight of the argument locality.
+///
+/// \return The same node as the policy above if there is no argument locality.
+int64_t HybridPolicy(const ResourceRequest &resource_request, const int64_t local_node_id,
+                     const absl::flat_hash_map<int64_t, Node> &nodes,
+                     const NodeResourceMatrix &matrix, float spread_threshold,
+                     bool force_spillback, bool require_available,
+                     const absl::flat_hash_map<int64_t, float> *arg_locality = nullptr,
+                     float locality_weight = 0);
 }  // namespace raylet_scheduling_policy
 }  // namespace ray
@@ -14,6 +14,8 @@
 
 #include "ray/raylet/scheduling/scheduling_policy.h"
 
+#include <random>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -278,6 +280,162 @@ TEST_F(SchedulingPolicyTest, ForceSpillbackOnlyFeasibleLocallyTest) {
   ASSERT_EQ(to_schedule, -1);
 }
 
+TEST_F(SchedulingPolicyTest, NodeResourceMatrixTest) {
+  StringIdMap map;
+  ResourceRequest req = ResourceMapToResourceRequest(map, {{"CPU", 1}}, false);
+  NodeResourceMatrix matrix;
+  matrix.Update(0, CreateNodeResources(0, 2, 0, 0, 0, 0));
+  matrix.Update(1, CreateNodeResources(2, 2, 0, 0, 0, 0));
+  matrix.Update(2, CreateNodeResources(0, 0, 0, 0, 0, 0));
+  ASSERT_EQ(matrix.NumRows(), 3);
+
+  std::vector<uint8_t> feasible;
+  std::vector<uint8_t> available;
+  matrix.CheckPredefinedResources(req, &feasible, &available);
+  ASSERT_EQ(feasible, std::vector<uint8_t>({1, 1, 0}));
+  ASSERT_EQ(available, std::vector<uint8_t>({0, 1, 0}));
+  std::vector<float> utilization;
+  matrix.CalculateCriticalResourceUtilization(&utilization);
+  ASSERT_EQ(utilization, std::vector<float>({1, 0, 0}));
+  std::vector<size_t> rows;
+  matrix.FindAvailableRows(req, &rows);
+  ASSERT_EQ(rows, std::vector<size_t>({1}));
+
+  // Removing a node moves the last row into its place.
+  matrix.Remove(0);
+  matrix.Remove(0);
+  ASSERT_EQ(matrix.NumRows(), 2);
+  ASSERT_EQ(matrix.NodeIdAt(0), 2);
+  ASSERT_EQ(matrix.NodeIdAt(1), 1);
+  matrix.Update(2, CreateNodeResources(1, 1, 0, 0, 0, 0));
+  matrix.CheckPredefinedResources(req, &feasible, &available);
+  ASSERT_EQ(feasible, std::vector<uint8_t>({1, 1}));
+  ASSERT_EQ(available, std::vector<uint8_t>({1, 1}));
+  matrix.FindAvailableRows(req, &rows);
+  ASSERT_EQ(rows, std::vector<size_t>({0, 1}));
+  matrix.Remove(1);
+  matrix.Remove(2);
+  matrix.FindAvailableRows(req, &rows);
+  ASSERT_TRUE(rows.empty());
+}
+
+TEST_F(SchedulingPolicyTest, NodeResourceMatrixPolicyTest) {
+  // The policy that uses the resource matrix picks the same nodes as the one that
+  // walks over the nodes.
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> units(0, 4);
+  std::uniform_int_distribution<int> coin(0, 1);
+  StringIdMap map;
+  const int64_t custom_id = map.Insert("custom");
+  for (int i = 0; i < 200; i++) {
+    absl::flat_hash_map<int64_t, Node> nodes;
+    NodeResourceMatrix matrix;
+    const int num_nodes = 1 + i % 20;
+    for (int64_t node_id = 0; node_id < num_nodes; node_id++) {
+      const int total_cpu = units(gen);
+      const int total_mem = units(gen);
+      const int total_gpu = units(gen);
+      NodeResources resources = CreateNodeResources(
+          std::uniform_int_distribution<int>(0, total_cpu)(gen), total_cpu,
+          std::uniform_int_distribution<int>(0, total_mem)(gen), total_mem,
+          std::uniform_int_distribution<int>(0, total_gpu)(gen), total_gpu);
+      if (coin(gen)) {
+        resources.predefined_resources.resize(PredefinedResources_MAX);
+        resources.predefined_resources[OBJECT_STORE_MEM].total = 4;
+        resources.predefined_resources[OBJECT_STORE_MEM].available = units(gen);
+      }
+      if (coin(gen)) {
+        const int total_custom = units(gen);
+        resources.custom_resources[custom_id].total = total_custom;
+        resources.custom_resources[custom_id].available =
+            std::uniform_int_distribution<int>(0, total_custom)(gen);
+      }
+      resources.object_pulls_queued = coin(gen);
+      nodes.emplace(node_id, resources);
+      matrix.Update(node_id, resources);
+    }
+    // Exercise the row moves.
+    const int64_t removed_node_id = num_nodes / 2;
+    nodes.erase(removed_node_id);
+    matrix.Remove(removed_node_id);
+    const int64_t local_node = removed_node_id == 0 ? 1 : 0;
+    if (!nodes.contains(local_node)) {
+      continue;
+    }
+
+    std::unordered_map<std::string, double> request = {{"CPU", units(gen) / 2.0}};
+    if (coin(gen)) {
+      request["GPU"] = units(gen) / 2.0;
+    }
+    if (coin(gen)) {
+      request["custom"] = units(gen) / 2.0;
+    }
+    ResourceRequest req = ResourceMapToResourceRequest(map, request, coin(gen));
+    for (float spread_threshold : {0.0f, 0.5f, 1.0f}) {
+      for (bool force_spillback : {false, true}) {
+        for (bool require_available : {false, true}) {
+          ASSERT_EQ(raylet_scheduling_policy::HybridPolicy(
+                        req, local_node, nodes, matrix, spread_threshold,
+                        force_spillback, require_available),
+                    raylet_scheduling_policy::HybridPolicy(req, local_node, nodes,
+                                                           spread_threshold,
+                                                           force_spillback,
+                                                           require_available));
+        }
+      }
+    }
+  }
+}
+
+TEST_F(SchedulingPolicyTest, ArgumentLocalityTest) {
+  // When spilling back, nodes that hold the arguments are preferred among nodes that
+  // are otherwise equally good, but never over a better availability.
+  StringIdMap map;
+  ResourceRequest req = ResourceMapToResourceRequest(map, {{"CPU", 1}}, false);
+  int64_t local_node = 0;
+  int64_t remote_node = 1;
+  int64_t remote_node_2 = 2;
+  int64_t remote_node_3 = 3;
+
+  absl::flat_hash_map<int64_t, Node> nodes;
+  nodes.emplace(local_node, CreateNodeResources(2, 2, 0, 0, 0, 0));
+  nodes.emplace(remote_node, CreateNodeResources(2, 2, 0, 0, 0, 0));
+  nodes.emplace(remote_node_2, CreateNodeResources(1, 2, 0, 0, 0, 0));
+  nodes.emplace(remote_node_3, CreateNodeResources(0, 2, 0, 0, 0, 0));
+  NodeResourceMatrix matrix;
+  for (const auto &entry : nodes) {
+    matrix.Update(entry.first, entry.second.GetLocalView());
+  }
+
+  // Without locality, the first remote node in traversal order wins.
+  absl::flat_hash_map<int64_t, float> arg_locality;
+  ASSERT_EQ(raylet_scheduling_policy::HybridPolicy(req, local_node, nodes, matrix, 0.51,
+                                                   true, false, &arg_locality, 0.5),
+            remote_node);
+
+  // Node 2 holds most of the arguments. Its utilization is below the threshold.
+  arg_locality[remote_node] = 0.2;
+  arg_locality[remote_node_2] = 0.8;
+  ASSERT_EQ(raylet_scheduling_policy::HybridPolicy(req, local_node, nodes, matrix, 0.51,
+                                                   true, false, &arg_locality, 0.5),
+            remote_node_2);
+
+  // Above the threshold, the difference in utilization outweighs the locality.
+  ASSERT_EQ(raylet_scheduling_policy::HybridPolicy(req, local_node, nodes, matrix, 0,
+                                                   true, false, &arg_locality, 0.5),
+            remote_node);
+  ASSERT_EQ(raylet_scheduling_policy::HybridPolicy(req, local_node, nodes, matrix, 0,
+                                                   true, false, &arg_locality, 1),
+            remote_node_2);
+
+  // A node that is not available never wins over an available one.
+  arg_locality.clear();
+  arg_locality[remote_node_3] = 1;
+  ASSERT_EQ(raylet_scheduling_policy::HybridPolicy(req, local_node, nodes, matrix, 0.51,
+                                                   true, false, &arg_locality, 10),
+            remote_node);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
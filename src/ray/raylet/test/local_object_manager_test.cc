@@ -14,6 +14,10 @@
 
 #include "ray/raylet/local_object_manager.h"
 
+#include <boost/filesystem.hpp>
+#include <random>
+
+#include "absl/strings/match.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ray/common/asio/instrumented_io_context.h"
@@ -385,6 +389,44 @@ TEST_F(LocalObjectManagerTest, TestPin) {
   ASSERT_EQ(freed, expected);
 }
 
+TEST_F(LocalObjectManagerTest, TestUnpinMigratedObject) {
+  rpc::Address owner_address;
+  owner_address.set_worker_id(WorkerID::FromRandom().Binary());
+
+  // One more object than a free batch, of which the first one is migrated.
+  std::vector<ObjectID> object_ids;
+  std::vector<std::unique_ptr<RayObject>> objects;
+  for (size_t i = 0; i < free_objects_batch_size + 1; i++) {
+    ObjectID object_id = ObjectID::FromRandom();
+    object_ids.push_back(object_id);
+    auto data_buffer = std::make_shared<MockObjectBuffer>(10, object_id, unpins);
+    auto object = std::make_unique<RayObject>(data_buffer, nullptr,
+                                              std::vector<rpc::ObjectReference>());
+    objects.push_back(std::move(object));
+  }
+  manager.PinObjects(object_ids, std::move(objects), owner_address);
+  manager.WaitForObjectFree(owner_address, object_ids);
+  ASSERT_EQ(manager.GetPinnedObjects().size(), free_objects_batch_size + 1);
+
+  ASSERT_TRUE(manager.UnpinMigratedObject(object_ids[0]));
+  ASSERT_FALSE(manager.UnpinMigratedObject(object_ids[0]));
+  ASSERT_EQ((*unpins)[object_ids[0]], 1);
+  auto pinned_objects = manager.GetPinnedObjects();
+  ASSERT_EQ(pinned_objects.size(), free_objects_batch_size);
+  for (const auto &pinned_object : pinned_objects) {
+    ASSERT_NE(std::get<0>(pinned_object), object_ids[0]);
+    ASSERT_EQ(std::get<2>(pinned_object), 10);
+  }
+
+  // Freeing the migrated object doesn't free the copy pinned by the other node.
+  for (size_t i = 0; i < free_objects_batch_size + 1; i++) {
+    EXPECT_CALL(*subscriber_, Unsubscribe(_, _, object_ids[i].Binary()));
+    ASSERT_TRUE(subscriber_->PublishObjectEviction());
+  }
+  std::unordered_set<ObjectID> expected(object_ids.begin() + 1, object_ids.end());
+  ASSERT_EQ(freed, expected);
+}
+
 TEST_F(LocalObjectManagerTest, TestRestoreSpilledObject) {
   // First, spill objects.
   std::vector<ObjectID> object_ids;
@@ -751,6 +793,48 @@ TEST_F(LocalObjectManagerTest, TestSpillUptoMaxThroughput) {
   ASSERT_FALSE(manager.IsSpillingInProgress());
 }
 
+TEST_F(LocalObjectManagerTest, TestSpillObjectsToFreeBytes) {
+  rpc::Address owner_address;
+  owner_address.set_worker_id(WorkerID::FromRandom().Binary());
+
+  std::vector<ObjectID> object_ids;
+  std::vector<std::unique_ptr<RayObject>> objects;
+  int64_t object_size = 1000;
+  for (size_t i = 0; i < 4; i++) {
+    ObjectID object_id = ObjectID::FromRandom();
+    object_ids.push_back(object_id);
+    auto data_buffer = std::make_shared<MockObjectBuffer>(object_size, object_id, unpins);
+    auto object = std::make_unique<RayObject>(data_buffer, nullptr,
+                                              std::vector<rpc::ObjectReference>());
+    objects.push_back(std::move(object));
+  }
+  manager.PinObjects(object_ids, std::move(objects), owner_address);
+
+  // Two objects are enough to free the bytes.
+  manager.SpillObjectsToFreeBytes(1500);
+  ASSERT_TRUE(manager.IsSpillingInProgress());
+  // The objects that are being spilled count towards the bytes to free.
+  manager.SpillObjectsToFreeBytes(1500);
+  for (size_t i = 0; i < 2; i++) {
+    ASSERT_TRUE(worker_pool.io_worker_client->ReplySpillObjects(
+        {BuildURL("url" + std::to_string(i))}));
+    ASSERT_TRUE(owner_client->ReplyAddSpilledUrl());
+  }
+  ASSERT_FALSE(worker_pool.io_worker_client->ReplySpillObjects({BuildURL("url2")}));
+  ASSERT_EQ(owner_client->object_urls.size(), 2);
+  ASSERT_FALSE(manager.IsSpillingInProgress());
+
+  // Spilling uses all the spill workers, but no more.
+  manager.SpillObjectsToFreeBytes(4000);
+  for (size_t i = 2; i < 4; i++) {
+    ASSERT_TRUE(worker_pool.io_worker_client->ReplySpillObjects(
+        {BuildURL("url" + std::to_string(i))}));
+    ASSERT_TRUE(owner_client->ReplyAddSpilledUrl());
+  }
+  ASSERT_EQ(owner_client->object_urls.size(), 4);
+  ASSERT_FALSE(manager.IsSpillingInProgress());
+}
+
 TEST_F(LocalObjectManagerTest, TestSpillError) {
   // Check that we can spill an object again if there was a transient error
   // during the first attempt.
@@ -1152,6 +1236,293 @@ TEST_F(LocalObjectManagerTest, TestDeleteURLRefCountRaceCondition) {
   ASSERT_EQ(deleted_urls_size, 1);
 }
 
+TEST_F(LocalObjectManagerTest, TestCompressObjects) {
+  // Objects restored from the compression tier, keyed by object ID.
+  std::unordered_map<ObjectID, std::string> restored;
+  LocalObjectManager compressing_manager(
+      manager_node_id_, "address", 1234, free_objects_batch_size,
+      /*free_objects_period_ms=*/1000, worker_pool, object_table, client_pool,
+      /*max_io_workers=*/2,
+      /*min_spilling_size=*/0,
+      /*is_external_storage_type_fs=*/true,
+      /*max_fused_object_count*/ max_fused_object_count_,
+      /*on_objects_freed=*/
+      [&](const std::vector<ObjectID> &object_ids) {
+        for (const auto &object_id : object_ids) {
+          freed.insert(object_id);
+        }
+      },
+      /*is_plasma_object_spillable=*/
+      [&](const ray::ObjectID &object_id) { return true; },
+      /*core_worker_subscriber=*/subscriber_.get(),
+      /*max_compressed_objects_size=*/1024 * 1024,
+      /*restore_object_in_store=*/
+      [&](const ObjectID &object_id, const rpc::Address &owner_address,
+          const RayObject &object) {
+        const auto &data = object.GetData();
+        restored.emplace(object_id, std::string(reinterpret_cast<char *>(data->Data()),
+                                                data->Size()));
+        return Status::OK();
+      });
+
+  rpc::Address owner_address;
+  owner_address.set_worker_id(WorkerID::FromRandom().Binary());
+  ObjectID object_id = ObjectID::FromRandom();
+  std::string payload(100 * 1024, 'a');
+  auto data_buffer = std::make_shared<LocalMemoryBuffer>(
+      reinterpret_cast<uint8_t *>(&payload[0]), payload.size(), /*copy_data=*/true);
+  std::vector<std::unique_ptr<RayObject>> objects;
+  objects.push_back(std::make_unique<RayObject>(data_buffer, nullptr,
+                                                std::vector<rpc::ObjectReference>()));
+  compressing_manager.PinObjects({object_id}, std::move(objects), owner_address);
+  compressing_manager.WaitForObjectFree(owner_address, {object_id});
+
+  // The object is compressed instead of spilled, so no IO worker is needed and
+  // the owner is told about it right away.
+  compressing_manager.SpillObjectUptoMaxThroughput();
+  ASSERT_FALSE(compressing_manager.IsSpillingInProgress());
+  const auto url = compressing_manager.GetLocalSpilledObjectURL(object_id);
+  ASSERT_TRUE(absl::StartsWith(url, kCompressedObjectURLPrefix));
+  ASSERT_EQ(owner_client->object_urls[object_id], url);
+  ASSERT_TRUE(owner_client->ReplyAddSpilledUrl());
+
+  // The object can be read for pushes without restoring it.
+  auto reader = compressing_manager.ReadCompressedObject(object_id);
+  ASSERT_NE(reader, nullptr);
+  ASSERT_EQ(reader->GetDataSize(), payload.size());
+  ASSERT_EQ(reader->GetMetadataSize(), 0);
+  std::string read_payload(payload.size(), 0);
+  ASSERT_TRUE(reader->ReadFromDataSection(0, payload.size(), &read_payload[0]));
+  ASSERT_EQ(read_payload, payload);
+  ASSERT_EQ(reader->GetOwnerAddress().worker_id(), owner_address.worker_id());
+  ASSERT_TRUE(restored.empty());
+  ASSERT_EQ(compressing_manager.ReadCompressedObject(ObjectID::FromRandom()), nullptr);
+
+  // The object is restored without an IO worker.
+  int num_times_fired = 0;
+  compressing_manager.AsyncRestoreSpilledObject(object_id, url,
+                                                [&](const Status &status) {
+                                                  ASSERT_TRUE(status.ok());
+                                                  num_times_fired++;
+                                                });
+  ASSERT_EQ(num_times_fired, 1);
+  ASSERT_EQ(restored[object_id], payload);
+
+  // Freeing the object drops it from the compression tier.
+  EXPECT_CALL(*subscriber_, Unsubscribe(_, _, object_id.Binary()));
+  ASSERT_TRUE(subscriber_->PublishObjectEviction());
+  ASSERT_TRUE(compressing_manager.GetLocalSpilledObjectURL(object_id).empty());
+}
+
+TEST_F(LocalObjectManagerTest, TestCompressIncompressibleObjects) {
+  LocalObjectManager compressing_manager(
+      manager_node_id_, "address", 1234, free_objects_batch_size,
+      /*free_objects_period_ms=*/1000, worker_pool, object_table, client_pool,
+      /*max_io_workers=*/2,
+      /*min_spilling_size=*/0,
+      /*is_external_storage_type_fs=*/true,
+      /*max_fused_object_count*/ max_fused_object_count_,
+      /*on_objects_freed=*/
+      [&](const std::vector<ObjectID> &object_ids) {},
+      /*is_plasma_object_spillable=*/
+      [&](const ray::ObjectID &object_id) { return true; },
+      /*core_worker_subscriber=*/subscriber_.get(),
+      /*max_compressed_objects_size=*/1024 * 1024,
+      /*restore_object_in_store=*/
+      [&](const ObjectID &object_id, const rpc::Address &owner_address,
+          const RayObject &object) { return Status::OK(); });
+
+  rpc::Address owner_address;
+  owner_address.set_worker_id(WorkerID::FromRandom().Binary());
+  ObjectID object_id = ObjectID::FromRandom();
+  // Random bytes don't compress.
+  std::string payload(100 * 1024, 0);
+  std::mt19937 gen(0);
+  for (auto &c : payload) {
+    c = static_cast<char>(gen());
+  }
+  auto data_buffer = std::make_shared<LocalMemoryBuffer>(
+      reinterpret_cast<uint8_t *>(&payload[0]), payload.size(), /*copy_data=*/true);
+  std::vector<std::unique_ptr<RayObject>> objects;
+  objects.push_back(std::make_unique<RayObject>(data_buffer, nullptr,
+                                                std::vector<rpc::ObjectReference>()));
+  compressing_manager.PinObjects({object_id}, std::move(objects), owner_address);
+
+  // The object is spilled as usual.
+  compressing_manager.SpillObjectUptoMaxThroughput();
+  ASSERT_TRUE(compressing_manager.IsSpillingInProgress());
+  ASSERT_TRUE(owner_client->object_urls.empty());
+  ASSERT_TRUE(worker_pool.io_worker_client->ReplySpillObjects({BuildURL("url")}));
+  ASSERT_TRUE(owner_client->ReplyAddSpilledUrl());
+  ASSERT_EQ(owner_client->object_urls[object_id], BuildURL("url"));
+}
+
+TEST_F(LocalObjectManagerTest, TestNativeSpillAndRestore) {
+  auto directory =
+      boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  // Keep the event loop running while the spiller does the file IO.
+  boost::asio::io_service::work work(io_service_);
+  NativeObjectSpiller spiller(io_service_, {directory.string()}, /*num_io_threads=*/1);
+  std::unordered_map<ObjectID, std::string> restored;
+  LocalObjectManager native_manager(
+      manager_node_id_, "address", 1234, free_objects_batch_size,
+      /*free_objects_period_ms=*/1000, worker_pool, object_table, client_pool,
+      /*max_io_workers=*/2,
+      /*min_spilling_size=*/0,
+      /*is_external_storage_type_fs=*/true,
+      /*max_fused_object_count*/ max_fused_object_count_,
+      /*on_objects_freed=*/[&](const std::vector<ObjectID> &object_ids) {},
+      /*is_plasma_object_spillable=*/
+      [&](const ray::ObjectID &object_id) { return true; },
+      /*core_worker_subscriber=*/subscriber_.get(),
+      /*max_compressed_objects_size=*/0,
+      /*restore_object_in_store=*/
+      [&](const ObjectID &object_id, const rpc::Address &owner_address,
+          const RayObject &object) {
+        const auto &data = object.GetData();
+        restored.emplace(object_id, std::string(reinterpret_cast<char *>(data->Data()),
+                                                data->Size()));
+        return Status::OK();
+      },
+      /*native_object_spiller=*/&spiller);
+
+  rpc::Address owner_address;
+  owner_address.set_worker_id(WorkerID::FromRandom().Binary());
+  ObjectID object_id = ObjectID::FromRandom();
+  std::string payload(1024, 'a');
+  auto data_buffer = std::make_shared<LocalMemoryBuffer>(
+      reinterpret_cast<uint8_t *>(&payload[0]), payload.size(), /*copy_data=*/true);
+  std::vector<std::unique_ptr<RayObject>> objects;
+  objects.push_back(std::make_unique<RayObject>(data_buffer, nullptr,
+                                                std::vector<rpc::ObjectReference>()));
+  native_manager.PinObjects({object_id}, std::move(objects), owner_address);
+  native_manager.WaitForObjectFree(owner_address, {object_id});
+
+  // The object is spilled without an IO worker.
+  int num_times_fired = 0;
+  native_manager.SpillObjects({object_id}, [&](const Status &status) {
+    ASSERT_TRUE(status.ok());
+    num_times_fired++;
+  });
+  io_service_.run_one();
+  ASSERT_EQ(num_times_fired, 1);
+  ASSERT_EQ(worker_pool.io_worker_client->callbacks.size(), 0);
+  const auto url = native_manager.GetLocalSpilledObjectURL(object_id);
+  ASSERT_FALSE(url.empty());
+  ASSERT_EQ(owner_client->object_urls[object_id], url);
+  ASSERT_TRUE(owner_client->ReplyAddSpilledUrl());
+
+  // The object is restored without an IO worker.
+  native_manager.AsyncRestoreSpilledObject(object_id, url, [&](const Status &status) {
+    ASSERT_TRUE(status.ok());
+    num_times_fired++;
+  });
+  io_service_.run_one();
+  ASSERT_EQ(num_times_fired, 2);
+  ASSERT_EQ(restored[object_id], payload);
+
+  // The spilled file is deleted once the object is freed.
+  EXPECT_CALL(*subscriber_, Unsubscribe(_, _, object_id.Binary()));
+  ASSERT_TRUE(subscriber_->PublishObjectEviction());
+  native_manager.FlushFreeObjects();
+  const auto path = (*ParseURL(url))["url"];
+  for (int i = 0; i < 1000 && boost::filesystem::exists(path); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_FALSE(boost::filesystem::exists(path));
+  boost::filesystem::remove_all(directory);
+}
+
+TEST_F(LocalObjectManagerTest, TestNativeCompactSpilledFile) {
+  auto directory =
+      boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  // Keep the event loop running while the spiller does the file IO.
+  boost::asio::io_service::work work(io_service_);
+  NativeObjectSpiller spiller(io_service_, {directory.string()}, /*num_io_threads=*/1);
+  std::unordered_map<ObjectID, std::string> restored;
+  LocalObjectManager native_manager(
+      manager_node_id_, "address", 1234, free_objects_batch_size,
+      /*free_objects_period_ms=*/1000, worker_pool, object_table, client_pool,
+      /*max_io_workers=*/2,
+      /*min_spilling_size=*/0,
+      /*is_external_storage_type_fs=*/true,
+      /*max_fused_object_count*/ max_fused_object_count_,
+      /*on_objects_freed=*/[&](const std::vector<ObjectID> &object_ids) {},
+      /*is_plasma_object_spillable=*/
+      [&](const ray::ObjectID &object_id) { return true; },
+      /*core_worker_subscriber=*/subscriber_.get(),
+      /*max_compressed_objects_size=*/0,
+      /*restore_object_in_store=*/
+      [&](const ObjectID &object_id, const rpc::Address &owner_address,
+          const RayObject &object) {
+        const auto &data = object.GetData();
+        restored.emplace(object_id, std::string(reinterpret_cast<char *>(data->Data()),
+                                                data->Size()));
+        return Status::OK();
+      },
+      /*native_object_spiller=*/&spiller,
+      /*spilled_file_compaction_dead_ratio=*/0.5);
+
+  rpc::Address owner_address;
+  owner_address.set_worker_id(WorkerID::FromRandom().Binary());
+  std::vector<ObjectID> object_ids;
+  std::vector<std::unique_ptr<RayObject>> objects;
+  for (size_t i = 0; i < 4; i++) {
+    object_ids.push_back(ObjectID::FromRandom());
+    std::string payload(1024, static_cast<char>('a' + i));
+    auto data_buffer = std::make_shared<LocalMemoryBuffer>(
+        reinterpret_cast<uint8_t *>(&payload[0]), payload.size(), /*copy_data=*/true);
+    objects.push_back(std::make_unique<RayObject>(
+        data_buffer, nullptr, std::vector<rpc::ObjectReference>()));
+  }
+  native_manager.PinObjects(object_ids, std::move(objects), owner_address);
+  native_manager.WaitForObjectFree(owner_address, object_ids);
+
+  // All objects are fused into one file.
+  native_manager.SpillObjects(object_ids,
+                              [&](const Status &status) { ASSERT_TRUE(status.ok()); });
+  io_service_.run_one();
+  std::vector<std::string> urls;
+  for (const auto &object_id : object_ids) {
+    urls.push_back(native_manager.GetLocalSpilledObjectURL(object_id));
+    ASSERT_TRUE(owner_client->ReplyAddSpilledUrl());
+  }
+  const auto old_path = (*ParseURL(urls[0]))["url"];
+  ASSERT_EQ((*ParseURL(urls[3]))["url"], old_path);
+
+  // Freeing one of the objects leaves the file in place.
+  EXPECT_CALL(*subscriber_, Unsubscribe(_, _, _)).Times(2);
+  ASSERT_TRUE(subscriber_->PublishObjectEviction());
+  native_manager.FlushFreeObjects();
+  ASSERT_TRUE(boost::filesystem::exists(old_path));
+  ASSERT_EQ(native_manager.GetLocalSpilledObjectURL(object_ids[1]), urls[1]);
+
+  // Once half of the file is freed, the other objects are read and rewritten
+  // into a new file.
+  ASSERT_TRUE(subscriber_->PublishObjectEviction());
+  native_manager.FlushFreeObjects();
+  io_service_.run_one();
+  io_service_.run_one();
+  io_service_.run_one();
+  for (size_t i = 2; i < 4; i++) {
+    const auto new_url = native_manager.GetLocalSpilledObjectURL(object_ids[i]);
+    ASSERT_NE((*ParseURL(new_url))["url"], old_path);
+    ASSERT_EQ(owner_client->object_urls[object_ids[i]], new_url);
+    ASSERT_TRUE(owner_client->ReplyAddSpilledUrl());
+  }
+  for (int i = 0; i < 1000 && boost::filesystem::exists(old_path); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_FALSE(boost::filesystem::exists(old_path));
+
+  // A restore with the URL from before the compaction reads the new file.
+  native_manager.AsyncRestoreSpilledObject(
+      object_ids[3], urls[3], [&](const Status &status) { ASSERT_TRUE(status.ok()); });
+  io_service_.run_one();
+  ASSERT_EQ(restored[object_ids[3]], std::string(1024, 'd'));
+  boost::filesystem::remove_all(directory);
+}
+
 }  // namespace raylet
 
 }  // namespace ray
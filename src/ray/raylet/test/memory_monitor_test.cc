@@ -0,0 +1,114 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/memory_monitor.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+namespace raylet {
+
+class MemoryMonitorTest : public ::testing::Test {
+ public:
+  MemoryMonitorTest()
+      : root_(boost::filesystem::temp_directory_path() /
+              boost::filesystem::unique_path()) {
+    boost::filesystem::create_directories(root_ / "proc" / "pressure");
+    boost::filesystem::create_directories(root_ / "sys" / "fs" / "cgroup");
+    // 10 GiB of memory, 4 GiB of which are available.
+    WriteFile("proc/meminfo",
+              "MemTotal:       10485760 kB\n"
+              "MemFree:         1048576 kB\n"
+              "MemAvailable:    4194304 kB\n");
+  }
+
+  ~MemoryMonitorTest() { boost::filesystem::remove_all(root_); }
+
+  void WriteFile(const std::string &path, const std::string &content) {
+    std::ofstream file((root_ / path).string());
+    file << content;
+  }
+
+  boost::filesystem::path root_;
+};
+
+TEST_F(MemoryMonitorTest, TestParsePressure) {
+  double some_avg10 = 0;
+  EXPECT_TRUE(MemoryMonitor::ParsePressure(
+      "some avg10=12.50 avg60=3.00 avg300=1.00 total=123456\n"
+      "full avg10=2.00 avg60=1.00 avg300=0.00 total=1234\n",
+      &some_avg10));
+  EXPECT_EQ(some_avg10, 12.5);
+  EXPECT_FALSE(MemoryMonitor::ParsePressure("", &some_avg10));
+  EXPECT_FALSE(MemoryMonitor::ParsePressure("full avg10=2.00\n", &some_avg10));
+}
+
+TEST_F(MemoryMonitorTest, TestSystemMemoryUsage) {
+  MemoryMonitor below(/*usage_threshold=*/0.7, /*pressure_threshold=*/0,
+                      root_.string());
+  EXPECT_FALSE(below.Refresh());
+  EXPECT_DOUBLE_EQ(below.GetUsageFraction(), 0.6);
+
+  MemoryMonitor above(/*usage_threshold=*/0.5, /*pressure_threshold=*/0,
+                      root_.string());
+  EXPECT_TRUE(above.Refresh());
+  EXPECT_TRUE(above.IsUnderPressure());
+}
+
+TEST_F(MemoryMonitorTest, TestCgroupMemoryUsage) {
+  MemoryMonitor monitor(/*usage_threshold=*/0.7, /*pressure_threshold=*/0,
+                        root_.string());
+  // An unlimited cgroup falls back to the memory of the system.
+  WriteFile("sys/fs/cgroup/memory.current", "3221225472\n");
+  WriteFile("sys/fs/cgroup/memory.max", "max\n");
+  EXPECT_FALSE(monitor.Refresh());
+  EXPECT_DOUBLE_EQ(monitor.GetUsageFraction(), 0.6);
+
+  // 3 GiB of a 4 GiB limit are in use, 1 GiB of which is inactive page cache.
+  WriteFile("sys/fs/cgroup/memory.max", "4294967296\n");
+  EXPECT_TRUE(monitor.Refresh());
+  EXPECT_DOUBLE_EQ(monitor.GetUsageFraction(), 0.75);
+  WriteFile("sys/fs/cgroup/memory.stat", "anon 2147483648\ninactive_file 1073741824\n");
+  EXPECT_FALSE(monitor.Refresh());
+  EXPECT_DOUBLE_EQ(monitor.GetUsageFraction(), 0.5);
+}
+
+TEST_F(MemoryMonitorTest, TestMemoryPressure) {
+  MemoryMonitor monitor(/*usage_threshold=*/0, /*pressure_threshold=*/10,
+                        root_.string());
+  // Without PSI, the node is never under pressure.
+  EXPECT_FALSE(monitor.Refresh());
+  EXPECT_EQ(monitor.GetPressure(), -1);
+
+  WriteFile("proc/pressure/memory", "some avg10=20.00 avg60=5.00 avg300=1.00 total=1\n");
+  EXPECT_TRUE(monitor.Refresh());
+  // The PSI of the cgroup takes precedence over the one of the system.
+  WriteFile("sys/fs/cgroup/memory.pressure",
+            "some avg10=5.00 avg60=5.00 avg300=1.00 total=1\n");
+  EXPECT_FALSE(monitor.Refresh());
+  EXPECT_EQ(monitor.GetPressure(), 5);
+}
+
+}  // namespace raylet
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
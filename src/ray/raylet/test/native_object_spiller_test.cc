@@ -0,0 +1,247 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/native_object_spiller.h"
+
+#include <boost/filesystem.hpp>
+
+#include "gtest/gtest.h"
+#include "ray/object_manager/spilled_object_reader.h"
+#include "ray/util/util.h"
+
+namespace ray {
+
+namespace raylet {
+
+namespace {
+std::shared_ptr<Buffer> MakeBuffer(const std::string &contents) {
+  return std::make_shared<LocalMemoryBuffer>(
+      reinterpret_cast<uint8_t *>(const_cast<char *>(contents.data())), contents.size(),
+      /*copy_data=*/true);
+}
+
+std::string ToString(const std::shared_ptr<Buffer> &buffer) {
+  if (buffer == nullptr) {
+    return "";
+  }
+  return std::string(reinterpret_cast<const char *>(buffer->Data()), buffer->Size());
+}
+}  // namespace
+
+class NativeObjectSpillerTest : public ::testing::Test {
+ public:
+  NativeObjectSpillerTest()
+      : directory_(boost::filesystem::temp_directory_path() /
+                   boost::filesystem::unique_path()),
+        work_(io_service_),
+        spiller_(io_service_, {directory_.string()}, /*num_io_threads=*/2) {
+    owner_address_.set_worker_id(WorkerID::FromRandom().Binary());
+    owner_address_.set_ip_address("127.0.0.1");
+  }
+
+  ~NativeObjectSpillerTest() { boost::filesystem::remove_all(directory_); }
+
+  std::vector<std::string> Spill(const std::vector<ObjectID> &object_ids,
+                                 const std::vector<const RayObject *> &objects) {
+    std::vector<rpc::Address> owner_addresses(object_ids.size(), owner_address_);
+    std::vector<std::string> spilled_urls;
+    bool done = false;
+    spiller_.SpillObjects(
+        object_ids, objects, owner_addresses,
+        [&](const Status &status, const std::vector<std::string> &urls) {
+          EXPECT_TRUE(status.ok());
+          spilled_urls = urls;
+          done = true;
+        });
+    // The callback is posted to the main event loop.
+    io_service_.run_one();
+    EXPECT_TRUE(done);
+    return spilled_urls;
+  }
+
+  boost::filesystem::path directory_;
+  instrumented_io_context io_service_;
+  boost::asio::io_service::work work_;
+  NativeObjectSpiller spiller_;
+  rpc::Address owner_address_;
+};
+
+TEST_F(NativeObjectSpillerTest, ParseDirectories) {
+  EXPECT_TRUE(NativeObjectSpiller::ParseDirectories("").empty());
+  EXPECT_EQ(NativeObjectSpiller::ParseDirectories("/tmp/a,/tmp/b"),
+            (std::vector<std::string>{"/tmp/a", "/tmp/b"}));
+}
+
+TEST_F(NativeObjectSpillerTest, SpillAndRestore) {
+  RayObject with_metadata(MakeBuffer("data"), MakeBuffer("meta"), {});
+  RayObject without_metadata(MakeBuffer(std::string(1024, 'x')), nullptr, {});
+  RayObject without_data(nullptr, MakeBuffer("error"), {});
+  std::vector<ObjectID> object_ids = {ObjectID::FromRandom(), ObjectID::FromRandom(),
+                                      ObjectID::FromRandom()};
+  std::vector<const RayObject *> objects = {&with_metadata, &without_metadata,
+                                            &without_data};
+  auto urls = Spill(object_ids, objects);
+  ASSERT_EQ(urls.size(), objects.size());
+
+  // All objects are fused into one file, named like IO workers name them.
+  auto base_url = (*ParseURL(urls[0]))["url"];
+  for (const auto &url : urls) {
+    EXPECT_EQ((*ParseURL(url))["url"], base_url);
+  }
+  EXPECT_EQ(boost::filesystem::path(base_url).filename().string(),
+            object_ids[0].Hex() + "-multi-3");
+
+  for (size_t i = 0; i < objects.size(); i++) {
+    // The file can be read the same way as the files of IO workers.
+    auto reader = SpilledObjectReader::CreateSpilledObjectReader(urls[i]);
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_EQ(reader->GetDataSize(), ToString(objects[i]->GetData()).size());
+    EXPECT_EQ(reader->GetOwnerAddress().worker_id(), owner_address_.worker_id());
+
+    bool done = false;
+    spiller_.RestoreObject(urls[i], [&](const Status &status,
+                                        std::shared_ptr<RayObject> object,
+                                        const rpc::Address &owner_address) {
+      ASSERT_TRUE(status.ok());
+      EXPECT_EQ(ToString(object->GetData()), ToString(objects[i]->GetData()));
+      EXPECT_EQ(ToString(object->GetMetadata()), ToString(objects[i]->GetMetadata()));
+      EXPECT_EQ(owner_address.worker_id(), owner_address_.worker_id());
+      done = true;
+    });
+    io_service_.run_one();
+    ASSERT_TRUE(done);
+  }
+}
+
+TEST_F(NativeObjectSpillerTest, SpillInParts) {
+  // Every object is written as its own part.
+  NativeObjectSpiller spiller(io_service_, {directory_.string()}, /*num_io_threads=*/4,
+                              /*max_part_size=*/1);
+  std::vector<std::unique_ptr<RayObject>> objects;
+  std::vector<const RayObject *> object_ptrs;
+  std::vector<ObjectID> object_ids;
+  for (int i = 0; i < 8; i++) {
+    objects.push_back(std::make_unique<RayObject>(
+        MakeBuffer(std::string(1000 + i, static_cast<char>('a' + i))),
+        MakeBuffer(std::to_string(i)), std::vector<rpc::ObjectReference>()));
+    object_ptrs.push_back(objects.back().get());
+    object_ids.push_back(ObjectID::FromRandom());
+  }
+  std::vector<rpc::Address> owner_addresses(object_ids.size(), owner_address_);
+  std::vector<std::string> urls;
+  spiller.SpillObjects(
+      object_ids, object_ptrs, owner_addresses,
+      [&](const Status &status, const std::vector<std::string> &spilled) {
+        ASSERT_TRUE(status.ok());
+        urls = spilled;
+      });
+  io_service_.run_one();
+  ASSERT_EQ(urls.size(), objects.size());
+
+  // The parts form a single file, in the same format as a file written at once.
+  for (size_t i = 0; i < objects.size(); i++) {
+    EXPECT_EQ((*ParseURL(urls[i]))["url"], (*ParseURL(urls[0]))["url"]);
+    auto reader = SpilledObjectReader::CreateSpilledObjectReader(urls[i]);
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_EQ(reader->GetDataSize(), objects[i]->GetData()->Size());
+    EXPECT_EQ(reader->GetOwnerAddress().worker_id(), owner_address_.worker_id());
+
+    bool done = false;
+    spiller.RestoreObject(urls[i], [&](const Status &status,
+                                       std::shared_ptr<RayObject> object,
+                                       const rpc::Address &owner_address) {
+      ASSERT_TRUE(status.ok());
+      EXPECT_EQ(ToString(object->GetData()), ToString(objects[i]->GetData()));
+      EXPECT_EQ(ToString(object->GetMetadata()), ToString(objects[i]->GetMetadata()));
+      done = true;
+    });
+    io_service_.run_one();
+    ASSERT_TRUE(done);
+  }
+}
+
+TEST_F(NativeObjectSpillerTest, SpillToMultipleDirectories) {
+  auto other_directory = directory_ / "other";
+  NativeObjectSpiller spiller(io_service_,
+                              {directory_.string(), other_directory.string()},
+                              /*num_io_threads=*/1);
+  RayObject object(MakeBuffer("data"), nullptr, {});
+  std::vector<std::string> urls;
+  for (int i = 0; i < 2; i++) {
+    spiller.SpillObjects(
+        {ObjectID::FromRandom()}, {&object}, {owner_address_},
+        [&](const Status &status, const std::vector<std::string> &spilled) {
+          ASSERT_TRUE(status.ok());
+          urls.push_back(spilled[0]);
+        });
+    io_service_.run_one();
+  }
+  ASSERT_EQ(urls.size(), 2);
+  // Both directories are idle, so the spills go to different directories.
+  auto first_directory =
+      boost::filesystem::path((*ParseURL(urls[0]))["url"]).parent_path();
+  auto second_directory =
+      boost::filesystem::path((*ParseURL(urls[1]))["url"]).parent_path();
+  EXPECT_NE(first_directory, second_directory);
+
+  // Each object is restored from the directory it was spilled to.
+  for (const auto &url : urls) {
+    bool done = false;
+    spiller.RestoreObject(url, [&](const Status &status,
+                                   std::shared_ptr<RayObject> restored,
+                                   const rpc::Address &owner_address) {
+      ASSERT_TRUE(status.ok());
+      EXPECT_EQ(ToString(restored->GetData()), "data");
+      done = true;
+    });
+    io_service_.run_one();
+    ASSERT_TRUE(done);
+  }
+}
+
+TEST_F(NativeObjectSpillerTest, RestoreMissingObject) {
+  bool done = false;
+  spiller_.RestoreObject(
+      (directory_ / "missing").string() + "?offset=0&size=10",
+      [&](const Status &status, std::shared_ptr<RayObject> object,
+          const rpc::Address &owner_address) {
+        EXPECT_TRUE(status.IsIOError());
+        done = true;
+      });
+  io_service_.run_one();
+  ASSERT_TRUE(done);
+}
+
+TEST_F(NativeObjectSpillerTest, DeleteSpilledObjects) {
+  RayObject object(MakeBuffer("data"), nullptr, {});
+  auto urls = Spill({ObjectID::FromRandom()}, {&object});
+  ASSERT_EQ(urls.size(), 1);
+  auto path = (*ParseURL(urls[0]))["url"];
+  ASSERT_TRUE(boost::filesystem::exists(path));
+  spiller_.DeleteSpilledObjects(urls);
+  // Deletion doesn't call back, so wait for the file to go away.
+  for (int i = 0; i < 1000 && boost::filesystem::exists(path); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_FALSE(boost::filesystem::exists(path));
+}
+
+}  // namespace raylet
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -109,6 +109,7 @@ class MockWorker : public WorkerInterface {
     RAY_CHECK(false) << "Method unused";
     return JobID::Nil();
   }
+  void SetAssignedJobId(const JobID &job_id) { RAY_CHECK(false) << "Method unused"; }
   int GetRuntimeEnvHash() const { return runtime_env_hash_; }
   void AssignActorId(const ActorID &actor_id) { RAY_CHECK(false) << "Method unused"; }
   const ActorID &GetActorId() const {
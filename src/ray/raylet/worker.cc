@@ -128,6 +128,8 @@ const std::unordered_set<TaskID> &Worker::GetBlockedTaskIds() const {
 
 const JobID &Worker::GetAssignedJobId() const { return assigned_job_id_; }
 
+void Worker::SetAssignedJobId(const JobID &job_id) { assigned_job_id_ = job_id; }
+
 int Worker::GetRuntimeEnvHash() const { return runtime_env_hash_; }
 
 void Worker::AssignActorId(const ActorID &actor_id) {
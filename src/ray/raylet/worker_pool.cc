@@ -17,6 +17,8 @@
 #include <algorithm>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/filesystem.hpp>
+#include <cmath>
+#include <map>
 
 #include "ray/common/constants.h"
 #include "ray/common/network_util.h"
@@ -51,6 +53,22 @@ bool RemoveWorker(
   return worker_pool.erase(worker) > 0;
 }
 
+// Whether the workers started for one job can run the tasks of another job, i.e. both
+// jobs start their workers with the same code search path, options and environment.
+bool JobConfigsCompatible(const ray::rpc::JobConfig &a, const ray::rpc::JobConfig &b) {
+  std::map<std::string, std::string> worker_env_a(a.worker_env().begin(),
+                                                  a.worker_env().end());
+  std::map<std::string, std::string> worker_env_b(b.worker_env().begin(),
+                                                  b.worker_env().end());
+  return a.num_java_workers_per_process() == b.num_java_workers_per_process() &&
+         a.num_cpp_workers_per_process() == b.num_cpp_workers_per_process() &&
+         std::equal(a.jvm_options().begin(), a.jvm_options().end(),
+                    b.jvm_options().begin(), b.jvm_options().end()) &&
+         std::equal(a.code_search_path().begin(), a.code_search_path().end(),
+                    b.code_search_path().begin(), b.code_search_path().end()) &&
+         worker_env_a == worker_env_b;
+}
+
 }  // namespace
 
 namespace ray {
@@ -219,6 +237,9 @@ Process WorkerPool::StartWorkerProcess(
   if (dynamic_options.empty()) {
     if (language == Language::JAVA) {
       workers_to_start = job_config->num_java_workers_per_process();
+    } else if (language == Language::CPP) {
+      workers_to_start =
+          std::max<int>(1, static_cast<int>(job_config->num_cpp_workers_per_process()));
     }
   }
 
@@ -260,6 +281,9 @@ Process WorkerPool::StartWorkerProcess(
   if (language == Language::JAVA) {
     options.push_back("-Dray.job.num-java-workers-per-process=" +
                       std::to_string(workers_to_start));
+  } else if (language == Language::CPP && workers_to_start > 1) {
+    options.push_back("--ray_num_workers_per_process=" +
+                      std::to_string(workers_to_start));
   }
 
   // Append user-defined per-process options here
@@ -352,7 +376,16 @@ Process WorkerPool::StartWorkerProcess(
 
   // Start a process and measure the startup time.
   auto start = std::chrono::high_resolution_clock::now();
-  Process proc = StartProcess(worker_command_args, env);
+  Process proc;
+  if (RayConfig::instance().worker_zygote_enabled() && language == Language::PYTHON &&
+      worker_type == rpc::WorkerType::WORKER && dynamic_options.empty() &&
+      (serialized_runtime_env == "{}" || serialized_runtime_env == "")) {
+    proc = StartWorkerProcessFromZygote(job_id, runtime_env_hash, worker_command_args,
+                                        env);
+  }
+  if (!proc.IsValid()) {
+    proc = StartProcess(worker_command_args, env);
+  }
   auto end = std::chrono::high_resolution_clock::now();
   auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
   stats::ProcessStartupTimeMs.Record(duration.count());
@@ -443,6 +476,43 @@ Process WorkerPool::StartProcess(const std::vector<std::string> &worker_command_
   return child;
 }
 
+Process WorkerPool::ForkWorkerFromZygote(const WorkerZygote &zygote) {
+  return zygote.Fork(RayConfig::instance().worker_zygote_fork_timeout_ms());
+}
+
+Process WorkerPool::StartWorkerProcessFromZygote(
+    const JobID &job_id, int runtime_env_hash,
+    std::vector<std::string> worker_command_args, const ProcessEnvironment &env) {
+  auto &zygote = zygotes_[job_id][runtime_env_hash];
+  if (zygote != nullptr) {
+    Process proc = ForkWorkerFromZygote(*zygote);
+    if (proc.IsValid()) {
+      RAY_LOG(DEBUG) << "Forked worker process " << proc.GetId() << " from zygote at "
+                     << zygote->SocketPath();
+      return proc;
+    }
+    if (get_time_() - zygote->StartTimeMs() <
+        RayConfig::instance().worker_register_timeout_seconds() * 1000) {
+      // The zygote is probably still initializing.
+      return Process();
+    }
+    RAY_LOG(WARNING) << "Worker zygote at " << zygote->SocketPath()
+                     << " is not responding, restarting it.";
+  }
+
+  // Start a zygote for this job and runtime env. The worker that triggered this is
+  // started the regular way, later ones are forked once the zygote is ready.
+  auto socket_path =
+      (boost::filesystem::temp_directory_path() /
+       ("ray_zygote_" + std::to_string(getpid()) + "_" +
+        std::to_string(num_zygotes_started_++)))
+          .string();
+  worker_command_args.push_back("--zygote-socket=" + socket_path);
+  zygote = std::make_unique<WorkerZygote>(StartProcess(worker_command_args, env),
+                                          socket_path, get_time_());
+  return Process();
+}
+
 Status WorkerPool::GetNextFreePort(int *port) {
   if (!free_ports_) {
     *port = 0;
@@ -481,6 +551,7 @@ void WorkerPool::HandleJobFinished(const JobID &job_id) {
   // https://github.com/ray-project/ray/issues/11437.
   // unfinished_jobs_.erase(job_id);
   finished_jobs_.insert(job_id);
+  zygotes_.erase(job_id);
 }
 
 boost::optional<const rpc::JobConfig &> WorkerPool::GetJobConfig(
@@ -768,9 +839,72 @@ void WorkerPool::PushWorker(const std::shared_ptr<WorkerInterface> &worker) {
   }
 }
 
+void WorkerPool::UpdateWorkerDemand() {
+  double alpha = RayConfig::instance().worker_demand_ewma_alpha();
+  double now = get_time_();
+  double elapsed_ms = now - last_worker_demand_update_ms_;
+  if (alpha <= 0 || elapsed_ms <= 0) {
+    return;
+  }
+  last_worker_demand_update_ms_ = now;
+  // Normalize to the idle killing threshold, since that is how far ahead the
+  // prediction needs to look.
+  double scale = RayConfig::instance().idle_worker_killing_time_threshold_ms() /
+                 std::max(elapsed_ms, 1.0);
+  for (auto &entry : states_by_lang_) {
+    auto &worker_demand = entry.second.worker_demand;
+    for (auto job_it = worker_demand.begin(); job_it != worker_demand.end();) {
+      auto &demand_by_runtime_env = job_it->second;
+      for (auto it = demand_by_runtime_env.begin(); it != demand_by_runtime_env.end();) {
+        auto &demand = it->second;
+        demand.average =
+            alpha * demand.num_popped * scale + (1 - alpha) * demand.average;
+        demand.num_popped = 0;
+        if (demand.average < 0.01) {
+          demand_by_runtime_env.erase(it++);
+        } else {
+          it++;
+        }
+      }
+      if (demand_by_runtime_env.empty() || finished_jobs_.count(job_it->first)) {
+        worker_demand.erase(job_it++);
+      } else {
+        job_it++;
+      }
+    }
+  }
+}
+
+int64_t WorkerPool::PredictedWorkerDemand(const State &state, const JobID &job_id,
+                                          int runtime_env_hash) const {
+  auto job_it = state.worker_demand.find(job_id);
+  if (job_it == state.worker_demand.end()) {
+    return 0;
+  }
+  auto it = job_it->second.find(runtime_env_hash);
+  if (it == job_it->second.end()) {
+    return 0;
+  }
+  return static_cast<int64_t>(std::ceil(it->second.average));
+}
+
 void WorkerPool::TryKillingIdleWorkers() {
   RAY_CHECK(idle_of_all_languages_.size() == idle_of_all_languages_map_.size());
 
+  UpdateWorkerDemand();
+  // The number of idle workers still to keep for each language, job and runtime env.
+  std::unordered_map<Language, std::unordered_map<JobID, std::unordered_map<int, int64_t>>,
+                     std::hash<int>>
+      num_to_keep;
+  for (const auto &entry : states_by_lang_) {
+    for (const auto &job_entry : entry.second.worker_demand) {
+      for (const auto &demand_entry : job_entry.second) {
+        num_to_keep[entry.first][job_entry.first][demand_entry.first] =
+            PredictedWorkerDemand(entry.second, job_entry.first, demand_entry.first);
+      }
+    }
+  }
+
   int64_t now = get_time_();
   size_t running_size = 0;
   for (const auto &worker : GetAllRegisteredWorkers()) {
@@ -782,12 +916,16 @@ void WorkerPool::TryKillingIdleWorkers() {
   // idle workers that it needs to.
   RAY_CHECK(running_size >= pending_exit_idle_workers_.size());
   running_size -= pending_exit_idle_workers_.size();
+  // When workers can be rebound to other jobs, the workers of finished jobs are kept
+  // within the soft limit like any other idle worker.
+  const bool reuse_workers_across_jobs =
+      RayConfig::instance().reuse_workers_across_jobs();
   // Kill idle workers in FIFO order.
   for (const auto &idle_pair : idle_of_all_languages_) {
     const auto &idle_worker = idle_pair.first;
     const auto &job_id = idle_worker->GetAssignedJobId();
     if (running_size <= static_cast<size_t>(num_workers_soft_limit_)) {
-      if (!finished_jobs_.count(job_id)) {
+      if (reuse_workers_across_jobs || !finished_jobs_.count(job_id)) {
         // Ignore the soft limit for jobs that have already finished, as we
         // should always clean up these workers.
         break;
@@ -809,6 +947,16 @@ void WorkerPool::TryKillingIdleWorkers() {
       // This is possible because a Java worker process may hold multiple workers.
       continue;
     }
+
+    auto &keep = num_to_keep[idle_worker->GetLanguage()][job_id]
+                            [idle_worker->GetRuntimeEnvHash()];
+    if (keep > 0) {
+      // Keep this worker warm for the demand we expect soon, instead of killing it
+      // and starting a new one again shortly after.
+      keep--;
+      continue;
+    }
+
     auto shim_process = idle_worker->GetShimProcess();
     auto &worker_state = GetStateForLanguage(idle_worker->GetLanguage());
 
@@ -842,7 +990,7 @@ void WorkerPool::TryKillingIdleWorkers() {
         static_cast<size_t>(num_workers_soft_limit_)) {
       // A Java worker process may contain multiple workers. Killing more workers than we
       // expect may slow the job.
-      if (!finished_jobs_.count(job_id)) {
+      if (reuse_workers_across_jobs || !finished_jobs_.count(job_id)) {
         // Ignore the soft limit for jobs that have already finished, as we
         // should always clean up these workers.
         return;
@@ -923,6 +1071,9 @@ void WorkerPool::PopWorker(const TaskSpecification &task_spec,
                            const std::string &allocated_instances_serialized_json) {
   RAY_LOG(DEBUG) << "Pop worker for task " << task_spec.TaskId();
   auto &state = GetStateForLanguage(task_spec.GetLanguage());
+  if (RayConfig::instance().worker_demand_ewma_alpha() > 0) {
+    state.worker_demand[task_spec.JobId()][task_spec.GetRuntimeEnvHash()].num_popped++;
+  }
 
   std::shared_ptr<WorkerInterface> worker = nullptr;
   auto start_worker_process_fn = [this, allocated_instances_serialized_json](
@@ -1031,6 +1182,11 @@ void WorkerPool::PopWorker(const TaskSpecification &task_spec,
       break;
     }
 
+    if (worker == nullptr && RayConfig::instance().reuse_workers_across_jobs() &&
+        TryRebindIdleWorker(task_spec, callback, allocated_instances_serialized_json)) {
+      return;
+    }
+
     if (worker == nullptr) {
       // There are no more non-actor workers available to execute this task.
       // Start a new worker process.
@@ -1063,6 +1219,83 @@ void WorkerPool::PopWorker(const TaskSpecification &task_spec,
   }
 }
 
+bool WorkerPool::TryRebindIdleWorker(
+    const TaskSpecification &task_spec, const PopWorkerCallback &callback,
+    const std::string &allocated_instances_serialized_json) {
+  auto job_config = GetJobConfig(task_spec.JobId());
+  if (!job_config) {
+    return false;
+  }
+  auto &state = GetStateForLanguage(task_spec.GetLanguage());
+  const int runtime_env_hash = task_spec.GetRuntimeEnvHash();
+  std::shared_ptr<WorkerInterface> worker = nullptr;
+  for (auto it = idle_of_all_languages_.rbegin(); it != idle_of_all_languages_.rend();
+       it++) {
+    const auto &candidate = it->first;
+    if (task_spec.GetLanguage() != candidate->GetLanguage() ||
+        runtime_env_hash != candidate->GetRuntimeEnvHash() ||
+        finished_jobs_.count(candidate->GetAssignedJobId()) == 0 ||
+        state.pending_disconnection_workers.count(candidate) > 0 ||
+        candidate->IsDead() || pending_exit_idle_workers_.count(candidate->WorkerId()) ||
+        workers_refused_rebind_.count(candidate->WorkerId())) {
+      continue;
+    }
+    // A Java worker process holds multiple workers, which can't be rebound one by one.
+    if (GetWorkersByProcess(candidate->GetProcess()).size() != 1) {
+      continue;
+    }
+    auto candidate_job_config = GetJobConfig(candidate->GetAssignedJobId());
+    if (!candidate_job_config ||
+        !JobConfigsCompatible(*candidate_job_config, *job_config)) {
+      continue;
+    }
+
+    state.idle.erase(candidate);
+    // We can't erase a reverse_iterator.
+    auto lit = it.base();
+    lit--;
+    worker = std::move(lit->first);
+    idle_of_all_languages_.erase(lit);
+    idle_of_all_languages_map_.erase(worker);
+    break;
+  }
+  if (worker == nullptr) {
+    return false;
+  }
+
+  RAY_LOG(DEBUG) << "Rebinding idle worker " << worker->WorkerId() << " of finished job "
+                 << worker->GetAssignedJobId() << " to job " << task_spec.JobId();
+  rpc::ResetWorkerJobRequest request;
+  request.set_job_id(task_spec.JobId().Binary());
+  request.set_serialized_job_config(job_config->SerializeAsString());
+  auto rpc_client = worker->rpc_client();
+  RAY_CHECK(rpc_client);
+  rpc_client->ResetWorkerJob(
+      request, [this, worker, task_spec, callback, allocated_instances_serialized_json](
+                   const ray::Status &status, const rpc::ResetWorkerJobReply &r) {
+        if (status.ok() && r.success() && !worker->IsDead()) {
+          worker->SetAssignedJobId(task_spec.JobId());
+          PopWorkerCallbackAsync(callback, worker);
+          return;
+        }
+        if (!status.ok()) {
+          RAY_LOG(ERROR) << "Failed to send reset worker job request: "
+                         << status.ToString();
+          // The worker is unreachable, don't hand it out again.
+          if (!worker->IsDead()) {
+            worker->MarkDead();
+          }
+        } else if (!worker->IsDead()) {
+          // The worker still owns objects of its previous job, so keep it idle for that
+          // job.
+          workers_refused_rebind_.insert(worker->WorkerId());
+          PushWorker(worker);
+        }
+        PopWorker(task_spec, callback, allocated_instances_serialized_json);
+      });
+  return true;
+}
+
 void WorkerPool::PrestartWorkers(const TaskSpecification &task_spec, int64_t backlog_size,
                                  int64_t num_available_cpus) {
   // Code path of task that needs a dedicated worker.
@@ -1080,13 +1313,20 @@ void WorkerPool::PrestartWorkers(const TaskSpecification &task_spec, int64_t bac
     num_usable_workers += entry.second.num_starting_workers;
   }
   // Some existing workers may be holding less than 1 CPU each, so we should
-  // start as many workers as needed to fill up the remaining CPUs.
-  auto desired_usable_workers = std::min<int64_t>(num_available_cpus, backlog_size);
+  // start as many workers as needed to fill up the remaining CPUs. Recent demand keeps
+  // workers warm for leases that will likely arrive soon, even if the current backlog
+  // is small.
+  auto desired_usable_workers = std::min<int64_t>(
+      num_available_cpus,
+      std::max<int64_t>(backlog_size,
+                        PredictedWorkerDemand(state, task_spec.JobId(),
+                                              task_spec.GetRuntimeEnvHash())));
   if (num_usable_workers < desired_usable_workers) {
     // Account for workers that are idle or already starting.
     int64_t num_needed = desired_usable_workers - num_usable_workers;
     RAY_LOG(DEBUG) << "Prestarting " << num_needed << " workers given task backlog size "
                    << backlog_size << " and available CPUs " << num_available_cpus;
+    ProcessSpawnBatch spawn_batch;
     for (int i = 0; i < num_needed; i++) {
       PopWorkerStatus status;
       StartWorkerProcess(task_spec.GetLanguage(), rpc::WorkerType::WORKER,
@@ -1100,6 +1340,7 @@ bool WorkerPool::DisconnectWorker(const std::shared_ptr<WorkerInterface> &worker
   auto &state = GetStateForLanguage(worker->GetLanguage());
   RAY_CHECK(RemoveWorker(state.registered_workers, worker));
   RAY_UNUSED(RemoveWorker(state.pending_disconnection_workers, worker));
+  workers_refused_rebind_.erase(worker->WorkerId());
 
   for (auto it = idle_of_all_languages_.begin(); it != idle_of_all_languages_.end();
        it++) {
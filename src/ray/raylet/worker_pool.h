@@ -33,6 +33,7 @@
 #include "ray/gcs/gcs_client.h"
 #include "ray/raylet/agent_manager.h"
 #include "ray/raylet/worker.h"
+#include "ray/raylet/worker_zygote.h"
 
 namespace ray {
 
@@ -375,7 +376,8 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   std::string DebugString() const;
 
   /// Try killing idle workers to ensure the running workers are in a
-  /// reasonable size.
+  /// reasonable size. Idle workers covered by the predicted demand of their job and
+  /// runtime env are kept.
   void TryKillingIdleWorkers();
 
  protected:
@@ -419,6 +421,13 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   virtual Process StartProcess(const std::vector<std::string> &worker_command_args,
                                const ProcessEnvironment &env);
 
+  /// Ask a zygote to fork a new worker process.
+  ///
+  /// \param zygote The zygote to fork from.
+  /// \return The forked worker process, or an invalid process if the zygote could not
+  /// fork one.
+  virtual Process ForkWorkerFromZygote(const WorkerZygote &zygote);
+
   /// Push an warning message to user if worker pool is getting to big.
   virtual void WarnAboutSize();
 
@@ -449,6 +458,15 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
     rpc::WorkerType worker_type;
   };
 
+  /// Recent demand for workers of one job and runtime env.
+  struct WorkerDemand {
+    /// The number of workers popped since the average was last updated.
+    int64_t num_popped = 0;
+    /// Moving average of the number of workers popped per
+    /// idle_worker_killing_time_threshold_ms.
+    double average = 0;
+  };
+
   struct TaskWaitingForWorkerInfo {
     /// The id of task.
     TaskID task_id;
@@ -496,6 +514,9 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
     /// The last size at which a warning about the number of registered workers
     /// was generated.
     int64_t last_warning_multiple;
+    /// Recent worker demand by job and runtime env hash. Only tracked when
+    /// worker_demand_ewma_alpha is set.
+    std::unordered_map<JobID, std::unordered_map<int, WorkerDemand>> worker_demand;
   };
 
   /// Pool states per language.
@@ -506,11 +527,39 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   /// idle.
   std::list<std::pair<std::shared_ptr<WorkerInterface>, int64_t>> idle_of_all_languages_;
 
+  /// Zygotes of Python workers, by job and runtime env hash. Only used when
+  /// worker_zygote_enabled is set.
+  std::unordered_map<JobID, std::unordered_map<int, std::unique_ptr<WorkerZygote>>>
+      zygotes_;
+
  private:
   /// A helper function that returns the reference of the pool state
   /// for a given language.
   State &GetStateForLanguage(const Language &language);
 
+  /// Try to get a Python worker process from the zygote of the given job and runtime
+  /// env. If there is no zygote yet, start one with the given worker command so that
+  /// later workers can be forked from it.
+  ///
+  /// \param job_id The job of the worker.
+  /// \param runtime_env_hash The runtime env hash of the worker.
+  /// \param worker_command_args The command the worker would be started with.
+  /// \param env The environment the worker would be started with.
+  /// \return The forked worker process, or an invalid process if the worker has to be
+  /// started the regular way.
+  /// Fold the workers popped since the last call into the moving averages of worker
+  /// demand, and forget demand that has decayed to nothing.
+  void UpdateWorkerDemand();
+
+  /// The number of workers of the given job and runtime env that are expected to be
+  /// popped within the next idle_worker_killing_time_threshold_ms.
+  int64_t PredictedWorkerDemand(const State &state, const JobID &job_id,
+                                int runtime_env_hash) const;
+
+  Process StartWorkerProcessFromZygote(const JobID &job_id, int runtime_env_hash,
+                                       std::vector<std::string> worker_command_args,
+                                       const ProcessEnvironment &env);
+
   /// Start a timer to monitor the starting worker process.
   ///
   /// If any workers in this process don't register within the timeout
@@ -596,6 +645,18 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
       const PopWorkerStatus &status, bool *found /* output */,
       bool *worker_used /* output */, TaskID *task_id /* output */);
 
+  /// Try to rebind an idle worker of a finished job to the job of the given task,
+  /// instead of starting a new worker process. The worker must have the same language
+  /// and runtime env as the task, and the two jobs must start their workers the same
+  /// way. If the worker refuses the rebinding, e.g. because it still owns objects, the
+  /// task pops a worker again.
+  ///
+  /// \return Whether a worker is being rebound for the task, in which case the
+  /// callback will be called once the worker accepted or refused.
+  bool TryRebindIdleWorker(const TaskSpecification &task_spec,
+                           const PopWorkerCallback &callback,
+                           const std::string &allocated_instances_serialized_json);
+
   /// For Process class for managing subprocesses (e.g. reaping zombies).
   instrumented_io_context *io_service_;
   /// Node ID of the current node.
@@ -643,6 +704,12 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   /// Set of jobs whose drivers have exited.
   absl::flat_hash_set<JobID> finished_jobs_;
 
+  /// The number of zygotes started so far, used to name their sockets.
+  int64_t num_zygotes_started_ = 0;
+
+  /// When the worker demand averages were last updated.
+  double last_worker_demand_update_ms_ = 0;
+
   /// This map stores the same data as `idle_of_all_languages_`, but in a map structure
   /// for lookup performance.
   std::unordered_map<std::shared_ptr<WorkerInterface>, int64_t>
@@ -652,6 +719,10 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   absl::flat_hash_map<WorkerID, std::shared_ptr<WorkerInterface>>
       pending_exit_idle_workers_;
 
+  /// Idle workers that refused to be rebound to another job. They aren't offered to
+  /// other jobs again, and are killed as usual once idle for long enough.
+  absl::flat_hash_set<WorkerID> workers_refused_rebind_;
+
   /// The runner to run function periodically.
   PeriodicalRunner periodical_runner_;
 
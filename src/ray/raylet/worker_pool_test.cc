@@ -27,6 +27,7 @@ namespace ray {
 namespace raylet {
 
 int NUM_WORKERS_PER_PROCESS_JAVA = 3;
+int NUM_WORKERS_PER_PROCESS_CPP = 2;
 int MAXIMUM_STARTUP_CONCURRENCY = 5;
 int MAX_IO_WORKER_SIZE = 2;
 int POOL_SIZE_SOFT_LIMIT = 5;
@@ -72,6 +73,13 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
     return true;
   }
 
+  void ResetWorkerJob(const rpc::ResetWorkerJobRequest &request,
+                      const rpc::ClientCallback<rpc::ResetWorkerJobReply> &callback) {
+    rpc::ResetWorkerJobReply reply;
+    reply.set_success(true);
+    callback(Status::OK(), reply);
+  }
+
   std::list<rpc::ClientCallback<rpc::ExitReply>> callbacks_;
   instrumented_io_context &io_service_;
 };
@@ -139,6 +147,20 @@ class WorkerPoolMock : public WorkerPool {
     return last_worker_process_;
   }
 
+  Process ForkWorkerFromZygote(const WorkerZygote &zygote) override {
+    // Use a bogus process ID that won't conflict with those in the system or with the
+    // ones returned by StartProcess.
+    return Process::FromPid(
+        static_cast<pid_t>(2 * PID_MAX_LIMIT + 1 + num_zygote_forks_++));
+  }
+
+  int NumZygoteForks() const { return num_zygote_forks_; }
+
+  size_t NumZygotes(const JobID &job_id) const {
+    auto it = zygotes_.find(job_id);
+    return it == zygotes_.end() ? 0 : it->second.size();
+  }
+
   void WarnAboutSize() override {}
 
   Process LastStartedWorkerProcess() const { return last_worker_process_; }
@@ -304,6 +326,7 @@ class WorkerPoolMock : public WorkerPool {
 
  private:
   Process last_worker_process_;
+  int num_zygote_forks_ = 0;
   // The worker commands by process.
   std::unordered_map<Process, std::vector<std::string>> worker_commands_by_proc_;
   double current_time_ms_ = 0;
@@ -326,7 +349,10 @@ class WorkerPoolTest : public ::testing::Test {
         std::to_string(MAX_IO_WORKER_SIZE) + "}");
     SetWorkerCommands({{Language::PYTHON, {"dummy_py_worker_command"}},
                        {Language::JAVA,
-                        {"java", "RAY_WORKER_DYNAMIC_OPTION_PLACEHOLDER", "MainClass"}}});
+                        {"java", "RAY_WORKER_DYNAMIC_OPTION_PLACEHOLDER", "MainClass"}},
+                       {Language::CPP,
+                        {"dummy_cpp_worker_command",
+                         "RAY_WORKER_DYNAMIC_OPTION_PLACEHOLDER"}}});
     std::promise<bool> promise;
     thread_io_service_.reset(new std::thread([this, &promise] {
       std::unique_ptr<boost::asio::io_service::work> work(
@@ -368,6 +394,7 @@ class WorkerPoolTest : public ::testing::Test {
                                                     mock_worker_rpc_clients_);
     rpc::JobConfig job_config;
     job_config.set_num_java_workers_per_process(NUM_WORKERS_PER_PROCESS_JAVA);
+    job_config.set_num_cpp_workers_per_process(NUM_WORKERS_PER_PROCESS_CPP);
     RegisterDriver(Language::PYTHON, JOB_ID, job_config);
   }
 
@@ -394,6 +421,11 @@ class WorkerPoolTest : public ::testing::Test {
               real_command.begin(), real_command.end(),
               GetNumJavaWorkersPerProcessSystemProperty(num_workers_per_process));
           ASSERT_NE(it, real_command.end());
+        } else if (language == Language::CPP) {
+          auto it = std::find(real_command.begin(), real_command.end(),
+                              "--ray_num_workers_per_process=" +
+                                  std::to_string(num_workers_per_process));
+          ASSERT_NE(it, real_command.end());
         }
       } else {
         ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(),
@@ -529,6 +561,10 @@ TEST_F(WorkerPoolTest, StartupJavaWorkerProcessCount) {
   TestStartupWorkerProcessCount(Language::JAVA, NUM_WORKERS_PER_PROCESS_JAVA);
 }
 
+TEST_F(WorkerPoolTest, StartupCppWorkerProcessCount) {
+  TestStartupWorkerProcessCount(Language::CPP, NUM_WORKERS_PER_PROCESS_CPP);
+}
+
 TEST_F(WorkerPoolTest, InitialWorkerProcessCount) {
   ASSERT_EQ(worker_pool_->NumWorkersStarting(), 0);
   ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 0);
@@ -1152,6 +1188,58 @@ TEST_F(WorkerPoolTest, TestWorkerCapping) {
   worker_pool_->ClearProcesses();
 }
 
+TEST_F(WorkerPoolTest, TestWorkerCappingWithPredictedDemand) {
+  RayConfig::instance().initialize(R"({"worker_demand_ewma_alpha": 1.0})");
+  auto job_id = JOB_ID;
+  RegisterDriver(Language::PYTHON, job_id);
+
+  ///
+  /// Register 8 workers (3 more than soft limit).
+  ///
+  int num_workers = POOL_SIZE_SOFT_LIMIT + 3;
+  for (int i = 0; i < num_workers; i++) {
+    PopWorkerStatus status;
+    Process proc = worker_pool_->StartWorkerProcess(
+        Language::PYTHON, rpc::WorkerType::WORKER, job_id, &status);
+    auto worker = worker_pool_->CreateWorker(Process(), Language::PYTHON, job_id);
+    RAY_CHECK_OK(worker_pool_->RegisterWorker(worker, proc.GetId(), proc.GetId(),
+                                              [](Status, int) {}));
+    worker_pool_->OnWorkerStarted(worker);
+    worker_pool_->PushWorker(worker);
+  }
+  // Start the demand measurement.
+  worker_pool_->TryKillingIdleWorkers();
+
+  ///
+  /// 7 leases arrive within one idle killing threshold.
+  ///
+  const auto task_spec = ExampleTaskSpec();
+  std::vector<std::shared_ptr<WorkerInterface>> popped_workers;
+  for (int i = 0; i < num_workers - 1; i++) {
+    popped_workers.push_back(worker_pool_->PopWorkerSync(task_spec));
+  }
+  for (const auto &worker : popped_workers) {
+    worker_pool_->PushWorker(worker);
+  }
+
+  // Without the prediction 3 workers would be killed to get down to the soft limit.
+  // The predicted demand keeps 7 of them warm, so only 1 is killed.
+  worker_pool_->SetCurrentTimeMs(1000);
+  worker_pool_->TryKillingIdleWorkers();
+  std::vector<WorkerID> idle_worker_ids;
+  for (const auto &worker : worker_pool_->GetIdleWorkers()) {
+    idle_worker_ids.push_back(worker.first->WorkerId());
+  }
+  int num_killed = 0;
+  for (const auto &worker_id : idle_worker_ids) {
+    if (mock_worker_rpc_clients_[worker_id]->ExitReplySucceed()) {
+      num_killed++;
+    }
+  }
+  ASSERT_EQ(num_killed, 1);
+  RayConfig::instance().initialize(R"({"worker_demand_ewma_alpha": 0})");
+}
+
 TEST_F(WorkerPoolTest, TestWorkerCappingLaterNWorkersNotOwningObjects) {
   ///
   /// When there are 2 * N idle workers where the first N workers own objects,
@@ -1299,6 +1387,33 @@ TEST_F(WorkerPoolTest, CacheWorkersByRuntimeEnvHash) {
   worker_pool_->ClearProcesses();
 }
 
+TEST_F(WorkerPoolTest, ReuseWorkersAcrossJobs) {
+  RayConfig::instance().initialize(R"({"reuse_workers_across_jobs": true})");
+  auto job_id2 = JobID::FromInt(2);
+  rpc::JobConfig job_config;
+  job_config.set_num_java_workers_per_process(NUM_WORKERS_PER_PROCESS_JAVA);
+  RegisterDriver(Language::PYTHON, job_id2, job_config);
+
+  PopWorkerStatus status;
+  Process proc = worker_pool_->StartWorkerProcess(
+      Language::PYTHON, rpc::WorkerType::WORKER, JOB_ID, &status);
+  auto worker = worker_pool_->CreateWorker(Process(), Language::PYTHON, JOB_ID);
+  RAY_CHECK_OK(worker_pool_->RegisterWorker(worker, proc.GetId(), proc.GetId(),
+                                            [](Status, int) {}));
+  worker_pool_->OnWorkerStarted(worker);
+  worker_pool_->PushWorker(worker);
+
+  // Once the job of the idle worker finished, the worker is rebound to the new job
+  // instead of starting a new process.
+  worker_pool_->HandleJobFinished(JOB_ID);
+  const auto task_spec = ExampleTaskSpec(ActorID::Nil(), Language::PYTHON, job_id2);
+  auto popped_worker = worker_pool_->PopWorkerSync(task_spec, /*push_workers=*/false);
+  ASSERT_EQ(popped_worker, worker);
+  ASSERT_EQ(popped_worker->GetAssignedJobId(), job_id2);
+  ASSERT_EQ(worker_pool_->GetIdleWorkerSize(), 0);
+  RayConfig::instance().initialize(R"({"reuse_workers_across_jobs": false})");
+}
+
 TEST_F(WorkerPoolTest, StartWorkWithDifferentShimPid) {
   auto task_spec = ExampleTaskSpec();
   auto worker = worker_pool_->PopWorkerSync(task_spec);
@@ -1439,6 +1554,42 @@ TEST_F(WorkerPoolTest, PopWorkerStatus) {
   worker_pool_->ClearProcesses();
 }
 
+TEST_F(WorkerPoolTest, ForkWorkersFromZygote) {
+  RayConfig::instance().initialize(R"({"worker_zygote_enabled": true})");
+  PopWorkerStatus status;
+  // The first worker is started the regular way, along with a zygote for the job.
+  Process first = worker_pool_->StartWorkerProcess(Language::PYTHON,
+                                                   rpc::WorkerType::WORKER, JOB_ID, &status);
+  ASSERT_TRUE(first.IsValid());
+  ASSERT_EQ(worker_pool_->GetProcessSize(), 2);
+  ASSERT_EQ(worker_pool_->NumZygotes(JOB_ID), 1);
+  int num_zygote_commands = 0;
+  for (const auto &entry : worker_pool_->GetProcesses()) {
+    for (const auto &arg : entry.second) {
+      if (arg.rfind("--zygote-socket=", 0) == 0) {
+        num_zygote_commands++;
+      }
+    }
+  }
+  ASSERT_EQ(num_zygote_commands, 1);
+  ASSERT_EQ(worker_pool_->NumZygoteForks(), 0);
+
+  // Later workers are forked from the zygote and register like any other worker.
+  Process forked = worker_pool_->StartWorkerProcess(
+      Language::PYTHON, rpc::WorkerType::WORKER, JOB_ID, &status);
+  ASSERT_TRUE(forked.IsValid());
+  ASSERT_EQ(worker_pool_->GetProcessSize(), 2);
+  ASSERT_EQ(worker_pool_->NumZygoteForks(), 1);
+  auto worker = worker_pool_->CreateWorker(Process());
+  RAY_CHECK_OK(worker_pool_->RegisterWorker(worker, forked.GetId(), forked.GetId(),
+                                            [](Status, int) {}));
+
+  // The zygote goes away with its job.
+  worker_pool_->HandleJobFinished(JOB_ID);
+  ASSERT_EQ(worker_pool_->NumZygotes(JOB_ID), 0);
+  RayConfig::instance().initialize(R"({"worker_zygote_enabled": false})");
+}
+
 }  // namespace raylet
 
 }  // namespace ray
@@ -0,0 +1,95 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/worker_zygote.h"
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace raylet {
+
+WorkerZygote::WorkerZygote(Process process, std::string socket_path,
+                           double start_time_ms)
+    : process_(std::move(process)),
+      socket_path_(std::move(socket_path)),
+      start_time_ms_(start_time_ms) {}
+
+WorkerZygote::~WorkerZygote() {
+  process_.Kill();
+#ifndef _WIN32
+  unlink(socket_path_.c_str());
+#endif
+}
+
+Process WorkerZygote::Fork(int64_t timeout_ms) const {
+#ifdef _WIN32
+  return Process();
+#else
+  struct sockaddr_un addr;
+  if (socket_path_.size() >= sizeof(addr.sun_path)) {
+    return Process();
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, socket_path_.c_str(), sizeof(addr.sun_path) - 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return Process();
+  }
+  struct timeval timeout;
+  timeout.tv_sec = timeout_ms / 1000;
+  timeout.tv_usec = (timeout_ms % 1000) * 1000;
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+  pid_t pid = -1;
+  // The zygote only creates the socket once it has finished initializing, so a failed
+  // connect usually means that it is still starting up.
+  if (connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == 0 &&
+      write(fd, "fork\n", 5) == 5) {
+    std::string reply;
+    char buffer[32];
+    ssize_t n;
+    while (reply.find('\n') == std::string::npos &&
+           (n = read(fd, buffer, sizeof(buffer))) > 0) {
+      reply.append(buffer, n);
+    }
+    if (reply.find('\n') != std::string::npos) {
+      pid = static_cast<pid_t>(std::strtol(reply.c_str(), nullptr, 10));
+    }
+  }
+  close(fd);
+
+  if (pid <= 0) {
+    RAY_LOG(DEBUG) << "Worker zygote " << process_.GetId() << " at " << socket_path_
+                   << " did not fork a worker.";
+    return Process();
+  }
+  return Process::FromPid(pid);
+#endif
+}
+
+}  // namespace raylet
+
+}  // namespace ray
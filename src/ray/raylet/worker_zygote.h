@@ -0,0 +1,66 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+
+#include "ray/util/process.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// A pre-initialized worker process that forks new workers on request. The zygote has
+/// already started the interpreter and imported the worker libraries, so the workers it
+/// forks skip most of the cold-start cost.
+///
+/// The zygote listens on a Unix domain socket. For every connection it forks a worker
+/// and replies with the worker's pid followed by a newline. The forked worker then
+/// starts up and registers with the raylet like any other worker.
+class WorkerZygote {
+ public:
+  /// \param process The zygote process.
+  /// \param socket_path The socket the zygote listens on once it is initialized.
+  /// \param start_time_ms When the zygote was started.
+  WorkerZygote(Process process, std::string socket_path, double start_time_ms);
+
+  /// Kills the zygote. Workers it has already forked are not affected.
+  ~WorkerZygote();
+
+  WorkerZygote(const WorkerZygote &) = delete;
+  WorkerZygote &operator=(const WorkerZygote &) = delete;
+
+  /// Ask the zygote to fork a new worker.
+  ///
+  /// \param timeout_ms How long to wait for the zygote to reply.
+  /// \return The forked worker, or an invalid process if the zygote is not listening
+  /// yet, has died, or did not reply in time.
+  Process Fork(int64_t timeout_ms) const;
+
+  /// The socket the zygote listens on.
+  const std::string &SocketPath() const { return socket_path_; }
+
+  /// When the zygote was started.
+  double StartTimeMs() const { return start_time_ms_; }
+
+ private:
+  Process process_;
+  const std::string socket_path_;
+  const double start_time_ms_;
+};
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -366,18 +366,22 @@ void raylet::RayletClient::CancelWorkerLease(
 }
 
 void raylet::RayletClient::PrepareBundleResources(
-    const BundleSpecification &bundle_spec,
+    const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
     const ray::rpc::ClientCallback<ray::rpc::PrepareBundleResourcesReply> &callback) {
   rpc::PrepareBundleResourcesRequest request;
-  request.mutable_bundle_spec()->CopyFrom(bundle_spec.GetMessage());
+  for (const auto &bundle_spec : bundle_specs) {
+    request.add_bundle_specs()->CopyFrom(bundle_spec->GetMessage());
+  }
   grpc_client_->PrepareBundleResources(request, callback);
 }
 
 void raylet::RayletClient::CommitBundleResources(
-    const BundleSpecification &bundle_spec,
+    const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
     const ray::rpc::ClientCallback<ray::rpc::CommitBundleResourcesReply> &callback) {
   rpc::CommitBundleResourcesRequest request;
-  request.mutable_bundle_spec()->CopyFrom(bundle_spec.GetMessage());
+  for (const auto &bundle_spec : bundle_specs) {
+    request.add_bundle_specs()->CopyFrom(bundle_spec->GetMessage());
+  }
   grpc_client_->CommitBundleResources(request, callback);
 }
 
@@ -425,6 +429,31 @@ void raylet::RayletClient::PinObjectIDs(
   grpc_client_->PinObjectIDs(request, rpc_callback);
 }
 
+void raylet::RayletClient::ReplicateObjectIDs(
+    const rpc::Address &caller_address, const std::vector<ObjectID> &object_ids,
+    const rpc::ClientCallback<rpc::PinObjectIDsReply> &callback) {
+  rpc::PinObjectIDsRequest request;
+  request.mutable_owner_address()->CopyFrom(caller_address);
+  for (const ObjectID &object_id : object_ids) {
+    request.add_object_ids(object_id.Binary());
+  }
+  request.set_pull_if_missing(true);
+  grpc_client_->PinObjectIDs(request, callback);
+}
+
+void raylet::RayletClient::MigrateObjectIDs(
+    const rpc::Address &owner_address, const std::vector<ObjectID> &object_ids,
+    const rpc::ClientCallback<rpc::PinObjectIDsReply> &callback) {
+  rpc::PinObjectIDsRequest request;
+  request.mutable_owner_address()->CopyFrom(owner_address);
+  for (const ObjectID &object_id : object_ids) {
+    request.add_object_ids(object_id.Binary());
+  }
+  request.set_pull_if_missing(true);
+  request.set_reply_when_pinned(true);
+  grpc_client_->PinObjectIDs(request, callback);
+}
+
 void raylet::RayletClient::GlobalGC(
     const rpc::ClientCallback<rpc::GlobalGCReply> &callback) {
   rpc::GlobalGCRequest request;
@@ -432,11 +461,14 @@ void raylet::RayletClient::GlobalGC(
 }
 
 void raylet::RayletClient::UpdateResourceUsage(
-
     std::string &serialized_resource_usage_batch,
+    const std::vector<rpc::Address> &forward_to,
     const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &callback) {
   rpc::UpdateResourceUsageRequest request;
   request.set_serialized_resource_usage_batch(serialized_resource_usage_batch);
+  for (const auto &address : forward_to) {
+    request.add_forward_to()->CopyFrom(address);
+  }
   grpc_client_->UpdateResourceUsage(request, callback);
 }
 
@@ -54,6 +54,20 @@ class PinObjectsInterface {
       const rpc::Address &caller_address, const std::vector<ObjectID> &object_ids,
       const ray::rpc::ClientCallback<ray::rpc::PinObjectIDsReply> &callback) = 0;
 
+  /// Request to a raylet to pull plasma objects that are not local to its node
+  /// and pin them once they arrive. The callback is called once the pulls have
+  /// been started.
+  virtual void ReplicateObjectIDs(
+      const rpc::Address &caller_address, const std::vector<ObjectID> &object_ids,
+      const ray::rpc::ClientCallback<ray::rpc::PinObjectIDsReply> &callback) = 0;
+
+  /// Request to a raylet to pull plasma objects that are not local to its node
+  /// and pin them as their primary copies. The callback is called once all the
+  /// objects are pinned.
+  virtual void MigrateObjectIDs(
+      const rpc::Address &owner_address, const std::vector<ObjectID> &object_ids,
+      const ray::rpc::ClientCallback<ray::rpc::PinObjectIDsReply> &callback) = 0;
+
   virtual ~PinObjectsInterface(){};
 };
 
@@ -95,25 +109,24 @@ class WorkerLeaseInterface {
 /// Interface for leasing resource.
 class ResourceReserveInterface {
  public:
-  /// Request a raylet to prepare resources of a given bundle for atomic placement group
-  /// creation. This is used for the first phase of atomic placement group creation. The
+  /// Request a raylet to prepare resources of the given bundles for atomic placement
+  /// group creation. This is used for the first phase of atomic placement group
+  /// creation. The bundles are prepared all together, or none of them are. The
   /// callback will be sent via gRPC.
-  /// \param resource_spec Resources that should be
-  /// allocated for the worker.
+  /// \param bundle_specs Bundles whose resources should be prepared.
   /// \return ray::Status
   virtual void PrepareBundleResources(
-      const BundleSpecification &bundle_spec,
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
       const ray::rpc::ClientCallback<ray::rpc::PrepareBundleResourcesReply>
           &callback) = 0;
 
-  /// Request a raylet to commit resources of a given bundle for atomic placement group
-  /// creation. This is used for the first phase of atomic placement group creation. The
-  /// callback will be sent via gRPC.
-  /// \param resource_spec Resources that should be
-  /// allocated for the worker.
+  /// Request a raylet to commit resources of the given bundles for atomic placement
+  /// group creation. This is used for the second phase of atomic placement group
+  /// creation. The callback will be sent via gRPC.
+  /// \param bundle_specs Bundles whose resources should be committed.
   /// \return ray::Status
   virtual void CommitBundleResources(
-      const BundleSpecification &bundle_spec,
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
       const ray::rpc::ClientCallback<ray::rpc::CommitBundleResourcesReply> &callback) = 0;
 
   virtual void CancelResourceReserve(
@@ -145,8 +158,14 @@ class DependencyWaiterInterface {
 /// Inteface for getting resource reports.
 class ResourceTrackingInterface {
  public:
+  /// Send a resource usage batch to the raylet.
+  ///
+  /// \param serialized_resource_usage_batch The serialized ResourceUsageBroadcastData.
+  /// \param forward_to Raylets that the receiver should relay the batch to.
+  /// \param callback Invoked when the receiver replies.
   virtual void UpdateResourceUsage(
       std::string &serialized_resource_usage_batch,
+      const std::vector<rpc::Address> &forward_to,
       const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &callback) = 0;
 
   virtual void RequestResourceReport(
@@ -385,13 +404,13 @@ class RayletClient : public RayletClientInterface {
 
   /// Implements PrepareBundleResourcesInterface.
   void PrepareBundleResources(
-      const BundleSpecification &bundle_spec,
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
       const ray::rpc::ClientCallback<ray::rpc::PrepareBundleResourcesReply> &callback)
       override;
 
   /// Implements CommitBundleResourcesInterface.
   void CommitBundleResources(
-      const BundleSpecification &bundle_spec,
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
       const ray::rpc::ClientCallback<ray::rpc::CommitBundleResourcesReply> &callback)
       override;
 
@@ -410,6 +429,14 @@ class RayletClient : public RayletClientInterface {
       const rpc::Address &caller_address, const std::vector<ObjectID> &object_ids,
       const ray::rpc::ClientCallback<ray::rpc::PinObjectIDsReply> &callback) override;
 
+  void ReplicateObjectIDs(
+      const rpc::Address &caller_address, const std::vector<ObjectID> &object_ids,
+      const ray::rpc::ClientCallback<ray::rpc::PinObjectIDsReply> &callback) override;
+
+  void MigrateObjectIDs(
+      const rpc::Address &owner_address, const std::vector<ObjectID> &object_ids,
+      const ray::rpc::ClientCallback<ray::rpc::PinObjectIDsReply> &callback) override;
+
   void GetSystemConfig(
       const rpc::ClientCallback<rpc::GetSystemConfigReply> &callback) override;
 
@@ -420,6 +447,7 @@ class RayletClient : public RayletClientInterface {
 
   void UpdateResourceUsage(
       std::string &serialized_resource_usage_batch,
+      const std::vector<rpc::Address> &forward_to,
       const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &callback) override;
 
   void RequestResourceReport(
@@ -14,13 +14,16 @@
 
 #pragma once
 
+#include <grpcpp/generic/generic_stub.h>
 #include <grpcpp/grpcpp.h>
 
 #include <boost/asio.hpp>
 
 #include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
 #include "ray/common/asio/instrumented_io_context.h"
 #include "ray/common/grpc_util.h"
+#include "ray/common/ray_config.h"
 #include "ray/common/status.h"
 #include "ray/util/util.h"
 
@@ -49,6 +52,9 @@ class ClientCall {
 
 class ClientCallManager;
 
+template <class Reply>
+class ClientCallPool;
+
 /// Represents the client callback function of a particular rpc method.
 ///
 /// \tparam Reply Type of the reply message.
@@ -68,7 +74,9 @@ class ClientCallImpl : public ClientCall {
   explicit ClientCallImpl(const ClientCallback<Reply> &callback,
                           std::shared_ptr<StatsHandle> stats_handle)
       : callback_(std::move(const_cast<ClientCallback<Reply> &>(callback))),
-        stats_handle_(std::move(stats_handle)) {}
+        stats_handle_(std::move(stats_handle)) {
+    context_.emplace();
+  }
 
   Status GetStatus() override {
     absl::MutexLock lock(&mutex_);
@@ -94,6 +102,23 @@ class ClientCallImpl : public ClientCall {
   std::shared_ptr<StatsHandle> GetStatsHandle() override { return stats_handle_; }
 
  private:
+  /// Reset a finished call so that it can be used for another request. The reply is
+  /// cleared rather than destroyed, so that it keeps the memory of its strings and
+  /// repeated fields.
+  void Reset() {
+    callback_ = nullptr;
+    stats_handle_.reset();
+    response_reader_.reset();
+    reply_.Clear();
+    status_ = grpc::Status();
+    {
+      absl::MutexLock lock(&mutex_);
+      return_status_ = Status();
+    }
+    // A client context can't be reused across requests.
+    context_.emplace();
+  }
+
   /// The reply message.
   Reply reply_;
 
@@ -120,10 +145,75 @@ class ClientCallImpl : public ClientCall {
   ray::Status return_status_ GUARDED_BY(mutex_);
 
   /// Context for the client. It could be used to convey extra information to
-  /// the server and/or tweak certain RPC behaviors.
-  grpc::ClientContext context_;
+  /// the server and/or tweak certain RPC behaviors. Always set, it is optional only
+  /// so that it can be recreated in place when the call is reused.
+  absl::optional<grpc::ClientContext> context_;
 
   friend class ClientCallManager;
+  friend class ClientCallPool<Reply>;
+};
+
+/// A process-wide pool of finished `ClientCallImpl` objects of one reply type. The
+/// calls handed out by the pool return to it when their last reference is dropped,
+/// which saves allocating the call, its reply and the reply's fields for every RPC.
+/// At most `grpc_client_call_pool_size` calls are kept. This class is thread-safe.
+///
+/// \tparam Reply Type of the Reply message.
+template <class Reply>
+class ClientCallPool {
+ public:
+  /// The pool is never destroyed, so that calls that finish during static
+  /// destruction can still return to it.
+  static ClientCallPool &Instance() {
+    static ClientCallPool *pool = new ClientCallPool();
+    return *pool;
+  }
+
+  /// Get a call for a new request, reusing a pooled call if there is one.
+  std::shared_ptr<ClientCallImpl<Reply>> Get(const ClientCallback<Reply> &callback,
+                                             std::shared_ptr<StatsHandle> stats_handle) {
+    if (RayConfig::instance().grpc_client_call_pool_size() == 0) {
+      return std::make_shared<ClientCallImpl<Reply>>(callback, std::move(stats_handle));
+    }
+    std::unique_ptr<ClientCallImpl<Reply>> call;
+    {
+      absl::MutexLock lock(&mutex_);
+      if (!free_calls_.empty()) {
+        call = std::move(free_calls_.back());
+        free_calls_.pop_back();
+      }
+    }
+    if (call == nullptr) {
+      call.reset(new ClientCallImpl<Reply>(callback, std::move(stats_handle)));
+    } else {
+      call->callback_ = callback;
+      call->stats_handle_ = std::move(stats_handle);
+    }
+    return std::shared_ptr<ClientCallImpl<Reply>>(
+        call.release(), [](ClientCallImpl<Reply> *released) {
+          ClientCallPool::Instance().Release(released);
+        });
+  }
+
+ private:
+  ClientCallPool() = default;
+
+  /// Return a call whose last reference was dropped to the pool, or delete it if the
+  /// pool is full.
+  void Release(ClientCallImpl<Reply> *released) {
+    std::unique_ptr<ClientCallImpl<Reply>> call(released);
+    // Reset outside of the lock, the callback may own arbitrary state.
+    call->Reset();
+    absl::MutexLock lock(&mutex_);
+    if (free_calls_.size() < RayConfig::instance().grpc_client_call_pool_size()) {
+      free_calls_.push_back(std::move(call));
+    }
+  }
+
+  absl::Mutex mutex_;
+
+  /// The finished calls that are ready for reuse.
+  std::vector<std::unique_ptr<ClientCallImpl<Reply>>> free_calls_ GUARDED_BY(mutex_);
 };
 
 /// This class wraps a `ClientCall`, and is used as the `tag` of gRPC's `CompletionQueue`.
@@ -217,12 +307,11 @@ class ClientCallManager {
       const Request &request, const ClientCallback<Reply> &callback,
       std::string call_name) {
     auto stats_handle = main_service_.RecordStart(call_name);
-    auto call =
-        std::make_shared<ClientCallImpl<Reply>>(callback, std::move(stats_handle));
+    auto call = ClientCallPool<Reply>::Instance().Get(callback, std::move(stats_handle));
     // Send request.
     // Find the next completion queue to wait for response.
     call->response_reader_ = (stub.*prepare_async_function)(
-        &call->context_, request, cqs_[rr_index_++ % num_threads_].get());
+        &*call->context_, request, cqs_[rr_index_++ % num_threads_].get());
     call->response_reader_->StartCall();
     // Create a new tag object. This object will eventually be deleted in the
     // `ClientCallManager::PollEventsFromCompletionQueue` when reply is received.
@@ -236,6 +325,28 @@ class ClientCallManager {
     return call;
   }
 
+  /// Create a new `ClientCall` and send a request that is already serialized.
+  ///
+  /// \param[in] stub The generic stub of the channel.
+  /// \param[in] method The full name of the rpc method, "/package.Service/Method".
+  /// \param[in] request The serialized request message.
+  /// \param[in] callback The callback function that handles the serialized reply.
+  ///
+  /// \return A `ClientCall` representing the request that was just sent.
+  std::shared_ptr<ClientCall> CreateGenericCall(
+      grpc::GenericStub &stub, const std::string &method, const grpc::ByteBuffer &request,
+      const ClientCallback<grpc::ByteBuffer> &callback, std::string call_name) {
+    auto stats_handle = main_service_.RecordStart(call_name);
+    auto call = ClientCallPool<grpc::ByteBuffer>::Instance().Get(callback,
+                                                                 std::move(stats_handle));
+    call->response_reader_ = stub.PrepareUnaryCall(
+        &*call->context_, method, request, cqs_[rr_index_++ % num_threads_].get());
+    call->response_reader_->StartCall();
+    auto tag = new ClientCallTag(call);
+    call->response_reader_->Finish(&call->reply_, &call->status_, (void *)tag);
+    return call;
+  }
+
  private:
   /// This function runs in a background thread. It keeps polling events from the
   /// `CompletionQueue`, and dispatches the event to the callbacks via the `ClientCall`
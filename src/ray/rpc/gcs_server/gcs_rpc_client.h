@@ -187,6 +187,10 @@ class GcsRpcClient {
   VOID_GCS_RPC_CLIENT_METHOD(NodeResourceInfoGcsService, GetAllAvailableResources,
                              node_resource_info_grpc_client_, )
 
+  /// Get total resources of all nodes from the GCS Service.
+  VOID_GCS_RPC_CLIENT_METHOD(NodeResourceInfoGcsService, GetAllTotalResources,
+                             node_resource_info_grpc_client_, )
+
   /// Report resource usage of a node to GCS Service.
   VOID_GCS_RPC_CLIENT_METHOD(NodeResourceInfoGcsService, ReportResourceUsage,
                              node_resource_info_grpc_client_, )
@@ -291,6 +295,10 @@ class GcsRpcClient {
                              internal_kv_grpc_client_, )
   VOID_GCS_RPC_CLIENT_METHOD(InternalKVGcsService, InternalKVKeys,
                              internal_kv_grpc_client_, )
+  VOID_GCS_RPC_CLIENT_METHOD(InternalKVGcsService, InternalKVMultiGet,
+                             internal_kv_grpc_client_, )
+  VOID_GCS_RPC_CLIENT_METHOD(InternalKVGcsService, InternalKVMultiPut,
+                             internal_kv_grpc_client_, )
 
  private:
   std::function<void(GcsServiceFailureType)> gcs_service_failure_detected_;
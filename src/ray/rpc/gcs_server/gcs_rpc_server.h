@@ -19,6 +19,7 @@
 #include "ray/rpc/grpc_server.h"
 #include "ray/rpc/server_call.h"
 #include "src/ray/protobuf/gcs_service.grpc.pb.h"
+#include "src/ray/protobuf/pubsub.grpc.pb.h"
 
 namespace ray {
 namespace rpc {
@@ -66,6 +67,18 @@ namespace rpc {
   RPC_SERVICE_HANDLER(InternalKVGcsService, HANDLER, \
                       RayConfig::instance().gcs_max_active_rpcs_per_handler())
 
+/// Long polling requests stay active until there are messages to publish, so the
+/// number of active requests is not limited.
+#define PUBLISHER_SERVICE_RPC_HANDLER(HANDLER) \
+  RPC_SERVICE_HANDLER(PublisherService, HANDLER, -1)
+
+/// Bulk read handlers are rejected when the event loop is overloaded, so that they
+/// don't delay the other requests further.
+#define GCS_BULK_READ_RPC_HANDLER(SERVICE, HANDLER)                                \
+  RPC_SERVICE_HANDLER_WITH_LOAD_SHEDDING(                                          \
+      SERVICE, HANDLER, RayConfig::instance().gcs_max_active_rpcs_per_handler(), \
+      RayConfig::instance().gcs_bulk_read_rpc_shed_queueing_ms())
+
 #define GCS_RPC_SEND_REPLY(send_reply_callback, reply, status) \
   reply->mutable_status()->set_code((int)status.code());       \
   reply->mutable_status()->set_message(status.message());      \
@@ -116,7 +129,7 @@ class JobInfoGrpcService : public GrpcService {
       std::vector<std::unique_ptr<ServerCallFactory>> *server_call_factories) override {
     JOB_INFO_SERVICE_RPC_HANDLER(AddJob);
     JOB_INFO_SERVICE_RPC_HANDLER(MarkJobFinished);
-    JOB_INFO_SERVICE_RPC_HANDLER(GetAllJobInfo);
+    GCS_BULK_READ_RPC_HANDLER(JobInfoGcsService, GetAllJobInfo);
     JOB_INFO_SERVICE_RPC_HANDLER(ReportJobError);
     JOB_INFO_SERVICE_RPC_HANDLER(GetNextJobID);
   }
@@ -187,10 +200,8 @@ class ActorInfoGrpcService : public GrpcService {
         GetActorInfo, RayConfig::instance().gcs_max_active_rpcs_per_handler());
     ACTOR_INFO_SERVICE_RPC_HANDLER(
         GetNamedActorInfo, RayConfig::instance().gcs_max_active_rpcs_per_handler());
-    ACTOR_INFO_SERVICE_RPC_HANDLER(
-        ListNamedActors, RayConfig::instance().gcs_max_active_rpcs_per_handler());
-    ACTOR_INFO_SERVICE_RPC_HANDLER(
-        GetAllActorInfo, RayConfig::instance().gcs_max_active_rpcs_per_handler());
+    GCS_BULK_READ_RPC_HANDLER(ActorInfoGcsService, ListNamedActors);
+    GCS_BULK_READ_RPC_HANDLER(ActorInfoGcsService, GetAllActorInfo);
     ACTOR_INFO_SERVICE_RPC_HANDLER(
         KillActorViaGcs, RayConfig::instance().gcs_max_active_rpcs_per_handler());
   }
@@ -273,6 +284,10 @@ class NodeResourceInfoGcsServiceHandler {
       rpc::GetAllAvailableResourcesReply *reply,
       rpc::SendReplyCallback send_reply_callback) = 0;
 
+  virtual void HandleGetAllTotalResources(const rpc::GetAllTotalResourcesRequest &request,
+                                          rpc::GetAllTotalResourcesReply *reply,
+                                          rpc::SendReplyCallback send_reply_callback) = 0;
+
   virtual void HandleReportResourceUsage(const ReportResourceUsageRequest &request,
                                          ReportResourceUsageReply *reply,
                                          SendReplyCallback send_reply_callback) = 0;
@@ -302,6 +317,7 @@ class NodeResourceInfoGrpcService : public GrpcService {
     NODE_RESOURCE_INFO_SERVICE_RPC_HANDLER(UpdateResources);
     NODE_RESOURCE_INFO_SERVICE_RPC_HANDLER(DeleteResources);
     NODE_RESOURCE_INFO_SERVICE_RPC_HANDLER(GetAllAvailableResources);
+    NODE_RESOURCE_INFO_SERVICE_RPC_HANDLER(GetAllTotalResources);
     NODE_RESOURCE_INFO_SERVICE_RPC_HANDLER(ReportResourceUsage);
     NODE_RESOURCE_INFO_SERVICE_RPC_HANDLER(GetAllResourceUsage);
   }
@@ -386,7 +402,7 @@ class ObjectInfoGrpcService : public GrpcService {
       const std::unique_ptr<grpc::ServerCompletionQueue> &cq,
       std::vector<std::unique_ptr<ServerCallFactory>> *server_call_factories) override {
     OBJECT_INFO_SERVICE_RPC_HANDLER(GetObjectLocations);
-    OBJECT_INFO_SERVICE_RPC_HANDLER(GetAllObjectLocations);
+    GCS_BULK_READ_RPC_HANDLER(ObjectInfoGcsService, GetAllObjectLocations);
     OBJECT_INFO_SERVICE_RPC_HANDLER(AddObjectLocation);
     OBJECT_INFO_SERVICE_RPC_HANDLER(RemoveObjectLocation);
   }
@@ -481,7 +497,7 @@ class StatsGrpcService : public GrpcService {
       const std::unique_ptr<grpc::ServerCompletionQueue> &cq,
       std::vector<std::unique_ptr<ServerCallFactory>> *server_call_factories) override {
     STATS_SERVICE_RPC_HANDLER(AddProfileData);
-    STATS_SERVICE_RPC_HANDLER(GetAllProfileInfo);
+    GCS_BULK_READ_RPC_HANDLER(StatsGcsService, GetAllProfileInfo);
   }
 
  private:
@@ -530,7 +546,7 @@ class WorkerInfoGrpcService : public GrpcService {
       std::vector<std::unique_ptr<ServerCallFactory>> *server_call_factories) override {
     WORKER_INFO_SERVICE_RPC_HANDLER(ReportWorkerFailure);
     WORKER_INFO_SERVICE_RPC_HANDLER(GetWorkerInfo);
-    WORKER_INFO_SERVICE_RPC_HANDLER(GetAllWorkerInfo);
+    GCS_BULK_READ_RPC_HANDLER(WorkerInfoGcsService, GetAllWorkerInfo);
     WORKER_INFO_SERVICE_RPC_HANDLER(AddWorkerInfo);
   }
 
@@ -591,7 +607,7 @@ class PlacementGroupInfoGrpcService : public GrpcService {
     PLACEMENT_GROUP_INFO_SERVICE_RPC_HANDLER(RemovePlacementGroup);
     PLACEMENT_GROUP_INFO_SERVICE_RPC_HANDLER(GetPlacementGroup);
     PLACEMENT_GROUP_INFO_SERVICE_RPC_HANDLER(GetNamedPlacementGroup);
-    PLACEMENT_GROUP_INFO_SERVICE_RPC_HANDLER(GetAllPlacementGroup);
+    GCS_BULK_READ_RPC_HANDLER(PlacementGroupInfoGcsService, GetAllPlacementGroup);
     PLACEMENT_GROUP_INFO_SERVICE_RPC_HANDLER(WaitPlacementGroupUntilReady);
   }
 
@@ -624,6 +640,14 @@ class InternalKVGcsServiceHandler {
   virtual void HandleInternalKVExists(const InternalKVExistsRequest &request,
                                       InternalKVExistsReply *reply,
                                       SendReplyCallback send_reply_callback) = 0;
+
+  virtual void HandleInternalKVMultiGet(const InternalKVMultiGetRequest &request,
+                                        InternalKVMultiGetReply *reply,
+                                        SendReplyCallback send_reply_callback) = 0;
+
+  virtual void HandleInternalKVMultiPut(const InternalKVMultiPutRequest &request,
+                                        InternalKVMultiPutReply *reply,
+                                        SendReplyCallback send_reply_callback) = 0;
 };
 
 class InternalKVGrpcService : public GrpcService {
@@ -642,6 +666,8 @@ class InternalKVGrpcService : public GrpcService {
     INTERNAL_KV_SERVICE_RPC_HANDLER(InternalKVDel);
     INTERNAL_KV_SERVICE_RPC_HANDLER(InternalKVExists);
     INTERNAL_KV_SERVICE_RPC_HANDLER(InternalKVKeys);
+    INTERNAL_KV_SERVICE_RPC_HANDLER(InternalKVMultiGet);
+    INTERNAL_KV_SERVICE_RPC_HANDLER(InternalKVMultiPut);
   }
 
  private:
@@ -649,6 +675,39 @@ class InternalKVGrpcService : public GrpcService {
   InternalKVGcsServiceHandler &service_handler_;
 };
 
+class PublisherServiceHandler {
+ public:
+  virtual ~PublisherServiceHandler() = default;
+  virtual void HandlePubsubLongPolling(const PubsubLongPollingRequest &request,
+                                       PubsubLongPollingReply *reply,
+                                       SendReplyCallback send_reply_callback) = 0;
+
+  virtual void HandlePubsubCommandBatch(const PubsubCommandBatchRequest &request,
+                                        PubsubCommandBatchReply *reply,
+                                        SendReplyCallback send_reply_callback) = 0;
+};
+
+/// The gRPC server of the GCS channels of `pubsub::Publisher`.
+class PublisherGrpcService : public GrpcService {
+ public:
+  explicit PublisherGrpcService(instrumented_io_context &io_service,
+                                PublisherServiceHandler &handler)
+      : GrpcService(io_service), service_handler_(handler) {}
+
+ protected:
+  grpc::Service &GetGrpcService() override { return service_; }
+  void InitServerCallFactories(
+      const std::unique_ptr<grpc::ServerCompletionQueue> &cq,
+      std::vector<std::unique_ptr<ServerCallFactory>> *server_call_factories) override {
+    PUBLISHER_SERVICE_RPC_HANDLER(PubsubLongPolling);
+    PUBLISHER_SERVICE_RPC_HANDLER(PubsubCommandBatch);
+  }
+
+ private:
+  PublisherService::AsyncService service_;
+  PublisherServiceHandler &service_handler_;
+};
+
 using JobInfoHandler = JobInfoGcsServiceHandler;
 using ActorInfoHandler = ActorInfoGcsServiceHandler;
 using NodeInfoHandler = NodeInfoGcsServiceHandler;
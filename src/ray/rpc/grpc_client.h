@@ -55,22 +55,30 @@ class GrpcClient {
         grpc::CreateCustomChannel(address + ":" + std::to_string(port),
                                   grpc::InsecureChannelCredentials(), argument);
     stub_ = GrpcService::NewStub(channel);
+    generic_stub_ = std::make_unique<grpc::GenericStub>(channel);
   }
 
+  /// \param use_own_connection Whether the channel gets a TCP connection of its own.
+  /// Otherwise, gRPC shares one connection between the channels to the same address
+  /// with the same arguments.
   GrpcClient(const std::string &address, const int port, ClientCallManager &call_manager,
-             int num_threads)
+             int num_threads, bool use_own_connection = false)
       : client_call_manager_(call_manager) {
     grpc::ResourceQuota quota;
     quota.SetMaxThreads(num_threads);
     grpc::ChannelArguments argument;
     argument.SetResourceQuota(quota);
     argument.SetInt(GRPC_ARG_ENABLE_HTTP_PROXY, 0);
+    if (use_own_connection) {
+      argument.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+    }
     argument.SetMaxSendMessageSize(::RayConfig::instance().max_grpc_message_size());
     argument.SetMaxReceiveMessageSize(::RayConfig::instance().max_grpc_message_size());
     std::shared_ptr<grpc::Channel> channel =
         grpc::CreateCustomChannel(address + ":" + std::to_string(port),
                                   grpc::InsecureChannelCredentials(), argument);
     stub_ = GrpcService::NewStub(channel);
+    generic_stub_ = std::make_unique<grpc::GenericStub>(channel);
   }
 
   /// Create a new `ClientCall` and send request.
@@ -94,10 +102,26 @@ class GrpcClient {
     RAY_CHECK(call != nullptr);
   }
 
+  /// Create a new `ClientCall` and send a request that is already serialized, e.g.,
+  /// to send large payloads without copying them into a message first.
+  ///
+  /// \param[in] method The full name of the rpc method, "/package.Service/Method".
+  /// \param[in] request The serialized request message.
+  /// \param[in] callback The callback function that handles the serialized reply.
+  void CallGenericMethod(const std::string &method, const grpc::ByteBuffer &request,
+                         const ClientCallback<grpc::ByteBuffer> &callback,
+                         std::string call_name = "UNKNOWN_RPC") {
+    auto call = client_call_manager_.CreateGenericCall(*generic_stub_, method, request,
+                                                       callback, std::move(call_name));
+    RAY_CHECK(call != nullptr);
+  }
+
  private:
   ClientCallManager &client_call_manager_;
   /// The gRPC-generated stub.
   std::unique_ptr<typename GrpcService::Stub> stub_;
+  /// The stub to send serialized requests on the same channel.
+  std::unique_ptr<grpc::GenericStub> generic_stub_;
 };
 
 }  // namespace rpc
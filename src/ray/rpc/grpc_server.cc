@@ -17,6 +17,7 @@
 #include <grpcpp/impl/service_type.h>
 
 #include <boost/asio/detail/socket_holder.hpp>
+#include <sstream>
 
 #include "ray/common/ray_config.h"
 #include "ray/rpc/grpc_server.h"
@@ -36,13 +37,14 @@ namespace ray {
 namespace rpc {
 
 GrpcServer::GrpcServer(std::string name, const uint32_t port, int num_threads,
-                       int64_t keepalive_time_ms)
+                       int64_t keepalive_time_ms, int num_priority_threads)
     : name_(std::move(name)),
       port_(port),
       is_closed_(true),
       num_threads_(num_threads),
+      num_priority_threads_(num_priority_threads),
       keepalive_time_ms_(keepalive_time_ms) {
-  cqs_.resize(num_threads_);
+  cqs_.resize(num_threads_ + num_priority_threads_);
 }
 
 void GrpcServer::Run() {
@@ -73,8 +75,8 @@ void GrpcServer::Run() {
   }
   // Get hold of the completion queue used for the asynchronous communication
   // with the gRPC runtime.
-  for (int i = 0; i < num_threads_; i++) {
-    cqs_[i] = builder.AddCompletionQueue();
+  for (auto &cq : cqs_) {
+    cq = builder.AddCompletionQueue();
   }
   // Build and start server.
   server_ = builder.BuildAndStart();
@@ -107,23 +109,54 @@ void GrpcServer::Run() {
     }
   }
   // Start threads that polls incoming requests.
-  for (int i = 0; i < num_threads_; i++) {
+  polling_cpus_ = GetPollingCpus(RayConfig::instance().grpc_server_polling_cpus(), name_);
+  for (size_t i = 0; i < cqs_.size(); i++) {
     polling_threads_.emplace_back(&GrpcServer::PollEventsFromCompletionQueue, this, i);
   }
   // Set the server as running.
   is_closed_ = false;
 }
 
-void GrpcServer::RegisterService(GrpcService &service) {
+void GrpcServer::RegisterService(GrpcService &service, bool priority) {
   services_.emplace_back(service.GetGrpcService());
 
-  for (int i = 0; i < num_threads_; i++) {
+  int begin = 0;
+  int end = num_threads_;
+  if (priority && num_priority_threads_ > 0) {
+    begin = num_threads_;
+    end = num_threads_ + num_priority_threads_;
+  }
+  for (int i = begin; i < end; i++) {
     service.InitServerCallFactories(cqs_[i], &server_call_factories_);
   }
 }
 
+std::vector<int> GrpcServer::GetPollingCpus(const std::string &polling_cpus,
+                                            const std::string &server_name) {
+  std::stringstream stream(polling_cpus);
+  std::string entry;
+  while (std::getline(stream, entry, ';')) {
+    auto pos = entry.find('=');
+    if (pos == std::string::npos || entry.substr(0, pos) != server_name) {
+      continue;
+    }
+    std::vector<int> cpus;
+    if (!ParseCpuList(entry.substr(pos + 1), &cpus)) {
+      RAY_LOG(WARNING) << "Invalid cpu list in grpc_server_polling_cpus for "
+                       << server_name << ": " << entry.substr(pos + 1);
+      cpus.clear();
+    }
+    return cpus;
+  }
+  return {};
+}
+
 void GrpcServer::PollEventsFromCompletionQueue(int index) {
   SetThreadName("server.poll" + std::to_string(index));
+  if (!polling_cpus_.empty() && !SetThreadAffinity(polling_cpus_)) {
+    RAY_LOG(WARNING) << "Failed to pin the polling thread " << index << " of " << name_
+                     << " to the configured CPUs.";
+  }
   void *tag;
   bool ok;
 
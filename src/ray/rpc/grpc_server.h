@@ -28,13 +28,19 @@ namespace ray {
 namespace rpc {
 /// \param MAX_ACTIVE_RPCS Maximum number of RPCs to handle at the same time. -1 means no
 /// limit.
-#define RPC_SERVICE_HANDLER(SERVICE, HANDLER, MAX_ACTIVE_RPCS)                  \
-  std::unique_ptr<ServerCallFactory> HANDLER##_call_factory(                    \
-      new ServerCallFactoryImpl<SERVICE, SERVICE##Handler, HANDLER##Request,    \
-                                HANDLER##Reply>(                                \
-          service_, &SERVICE::AsyncService::Request##HANDLER, service_handler_, \
-          &SERVICE##Handler::Handle##HANDLER, cq, main_service_,                \
-          #SERVICE ".grpc_server." #HANDLER, MAX_ACTIVE_RPCS));                 \
+#define RPC_SERVICE_HANDLER(SERVICE, HANDLER, MAX_ACTIVE_RPCS) \
+  RPC_SERVICE_HANDLER_WITH_LOAD_SHEDDING(SERVICE, HANDLER, MAX_ACTIVE_RPCS, -1)
+
+/// \param SHED_QUEUEING_MS Requests that waited longer than this in the event loop are
+/// rejected without being handled. -1 means requests are never rejected.
+#define RPC_SERVICE_HANDLER_WITH_LOAD_SHEDDING(SERVICE, HANDLER, MAX_ACTIVE_RPCS,   \
+                                               SHED_QUEUEING_MS)                   \
+  std::unique_ptr<ServerCallFactory> HANDLER##_call_factory(                       \
+      new ServerCallFactoryImpl<SERVICE, SERVICE##Handler, HANDLER##Request,       \
+                                HANDLER##Reply>(                                   \
+          service_, &SERVICE::AsyncService::Request##HANDLER, service_handler_,    \
+          &SERVICE##Handler::Handle##HANDLER, cq, main_service_,                   \
+          #SERVICE ".grpc_server." #HANDLER, MAX_ACTIVE_RPCS, SHED_QUEUEING_MS));  \
   server_call_factories->emplace_back(std::move(HANDLER##_call_factory));
 
 // Define a void RPC client method.
@@ -50,6 +56,9 @@ class GrpcService;
 /// A `GrpcServer` listens on a specific port. It owns
 /// 1) a `ServerCompletionQueue` that is used for polling events from gRPC,
 /// 2) and a thread that polls events from the `ServerCompletionQueue`.
+/// It may also own priority completion queues with their own polling threads, which
+/// serve only the services registered as priority services, so that their requests are
+/// not delayed behind a flood of other requests.
 ///
 /// Subclasses can register one or multiple services to a `GrpcServer`, see
 /// `RegisterServices`. And they should also implement `InitServerCallFactories` to decide
@@ -61,8 +70,12 @@ class GrpcServer {
   /// \param[in] name Name of this server, used for logging and debugging purpose.
   /// \param[in] port The port to bind this server to. If it's 0, a random available port
   ///  will be chosen.
+  /// \param[in] num_priority_threads The number of completion queues and polling threads
+  ///  reserved for priority services. If it's 0, priority services share the other
+  ///  completion queues.
   GrpcServer(std::string name, const uint32_t port, int num_threads = 1,
-             int64_t keepalive_time_ms = 7200000 /*2 hours, grpc default*/);
+             int64_t keepalive_time_ms = 7200000 /*2 hours, grpc default*/,
+             int num_priority_threads = 0);
 
   /// Destruct this gRPC server.
   ~GrpcServer() { Shutdown(); }
@@ -95,7 +108,17 @@ class GrpcServer {
   /// `GrpcServer`, as it holds the underlying `grpc::Service`.
   ///
   /// \param[in] service A `GrpcService` to register to this server.
-  void RegisterService(GrpcService &service);
+  /// \param[in] priority Whether to serve this service from the priority completion
+  ///  queues. Use it for small latency sensitive requests, such as liveness checks.
+  void RegisterService(GrpcService &service, bool priority = false);
+
+  /// Get the CPUs to pin the polling threads of a server to.
+  ///
+  /// \param[in] polling_cpus The `grpc_server_polling_cpus` config.
+  /// \param[in] server_name Name of the server.
+  /// \return The CPUs, or an empty list if the server is not pinned.
+  static std::vector<int> GetPollingCpus(const std::string &polling_cpus,
+                                         const std::string &server_name);
 
  protected:
   /// This function runs in a background thread. It keeps polling events from the
@@ -113,14 +136,19 @@ class GrpcServer {
   std::vector<std::reference_wrapper<grpc::Service>> services_;
   /// The `ServerCallFactory` objects.
   std::vector<std::unique_ptr<ServerCallFactory>> server_call_factories_;
-  /// The number of completion queues the server is polling from.
+  /// The number of completion queues the server is polling from, excluding the
+  /// priority ones.
   int num_threads_;
+  /// The number of priority completion queues. They come after the others in `cqs_`.
+  int num_priority_threads_;
   /// The `ServerCompletionQueue` object used for polling events.
   std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> cqs_;
   /// The `Server` object.
   std::unique_ptr<grpc::Server> server_;
   /// The polling threads used to check the completion queues.
   std::vector<std::thread> polling_threads_;
+  /// The CPUs the polling threads run on, empty if they are not pinned.
+  std::vector<int> polling_cpus_;
   /// The interval to send a new gRPC keepalive timeout from server -> client.
   /// gRPC server cannot get the ping response within the time, it triggers
   /// the watchdog timer fired error, which will close the connection.
@@ -115,6 +115,9 @@ class NodeManagerWorkerClient
   /// Get gcs server address.
   VOID_RPC_CLIENT_METHOD(NodeManagerService, GetGcsServerAddress, grpc_client_, )
 
+  /// Migrate the primary copies pinned on the raylet to other nodes.
+  VOID_RPC_CLIENT_METHOD(NodeManagerService, DrainObjects, grpc_client_, )
+
  private:
   /// Constructor.
   ///
@@ -14,6 +14,8 @@
 
 #include "ray/rpc/node_manager/node_manager_client_pool.h"
 
+#include <algorithm>
+
 namespace ray {
 namespace rpc {
 
@@ -52,5 +54,36 @@ void NodeManagerClientPool::Disconnect(ray::NodeID id) {
   client_map_.erase(it);
 }
 
+std::vector<std::vector<rpc::Address>> SplitBroadcastTargets(
+    std::vector<rpc::Address> targets, size_t fanout) {
+  std::vector<std::vector<rpc::Address>> groups;
+  if (fanout == 0 || targets.size() <= fanout) {
+    for (auto &target : targets) {
+      groups.push_back({std::move(target)});
+    }
+    return groups;
+  }
+
+  std::sort(targets.begin(), targets.end(),
+            [](const rpc::Address &a, const rpc::Address &b) {
+              if (a.ip_address() != b.ip_address()) {
+                return a.ip_address() < b.ip_address();
+              }
+              return a.port() < b.port();
+            });
+  // Spread the remainder over the first groups so that group sizes differ by at most
+  // one.
+  size_t base_size = targets.size() / fanout;
+  size_t remainder = targets.size() % fanout;
+  auto it = targets.begin();
+  for (size_t i = 0; i < fanout; i++) {
+    size_t group_size = base_size + (i < remainder ? 1 : 0);
+    groups.emplace_back(std::make_move_iterator(it),
+                        std::make_move_iterator(it + group_size));
+    it += group_size;
+  }
+  return groups;
+}
+
 }  // namespace rpc
 }  // namespace ray
@@ -80,5 +80,16 @@ class NodeManagerClientPool {
       GUARDED_BY(mu_);
 };
 
+/// Split the raylets that should receive a resource broadcast into at most `fanout`
+/// relay groups. The first raylet of each group receives the broadcast directly and
+/// relays it to the rest of its group, which it splits again the same way. Targets are
+/// ordered by IP address so that a group tends to stay within one rack or subnet.
+///
+/// \param targets The raylets that should receive the broadcast.
+/// \param fanout The maximum number of groups. 0 puts every raylet in its own group.
+/// \return The relay groups. None of them is empty.
+std::vector<std::vector<rpc::Address>> SplitBroadcastTargets(
+    std::vector<rpc::Address> targets, size_t fanout);
+
 }  // namespace rpc
 }  // namespace ray
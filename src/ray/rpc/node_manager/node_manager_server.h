@@ -41,7 +41,8 @@ namespace rpc {
   RPC_SERVICE_HANDLER(NodeManagerService, RequestObjectSpillage, -1)  \
   RPC_SERVICE_HANDLER(NodeManagerService, ReleaseUnusedBundles, -1)   \
   RPC_SERVICE_HANDLER(NodeManagerService, GetSystemConfig, -1)        \
-  RPC_SERVICE_HANDLER(NodeManagerService, GetGcsServerAddress, -1)
+  RPC_SERVICE_HANDLER(NodeManagerService, GetGcsServerAddress, -1)    \
+  RPC_SERVICE_HANDLER(NodeManagerService, DrainObjects, -1)
 
 /// Interface of the `NodeManagerService`, see `src/ray/protobuf/node_manager.proto`.
 class NodeManagerServiceHandler {
@@ -127,6 +128,10 @@ class NodeManagerServiceHandler {
   virtual void HandleGetGcsServerAddress(const GetGcsServerAddressRequest &request,
                                          GetGcsServerAddressReply *reply,
                                          SendReplyCallback send_reply_callback) = 0;
+
+  virtual void HandleDrainObjects(const DrainObjectsRequest &request,
+                                  DrainObjectsReply *reply,
+                                  SendReplyCallback send_reply_callback) = 0;
 };
 
 /// The `GrpcService` for `NodeManagerService`.
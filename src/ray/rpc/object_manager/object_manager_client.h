@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/wire_format_lite.h>
 #include <grpcpp/grpcpp.h>
 #include <grpcpp/resource_quota.h>
 #include <grpcpp/support/channel_arguments.h>
@@ -37,8 +40,13 @@ class ObjectManagerClient {
   /// \param[in] address Address of the node manager server.
   /// \param[in] port Port of the node manager server.
   /// \param[in] client_call_manager The `ClientCallManager` used for managing requests.
+  /// \param[in] num_connections The number of channels that pushes are spread over.
+  /// \param[in] separate_connections Whether each channel gets a TCP connection of its
+  /// own, and pulls and frees go through another connection that doesn't queue behind
+  /// the chunks of pushes. Otherwise, gRPC may send everything through one connection.
   ObjectManagerClient(const std::string &address, const int port,
-                      ClientCallManager &client_call_manager, int num_connections = 4)
+                      ClientCallManager &client_call_manager, int num_connections = 4,
+                      bool separate_connections = false)
       : num_connections_(num_connections) {
     push_rr_index_ = rand() % num_connections_;
     pull_rr_index_ = rand() % num_connections_;
@@ -46,7 +54,11 @@ class ObjectManagerClient {
     grpc_clients_.reserve(num_connections_);
     for (int i = 0; i < num_connections_; i++) {
       grpc_clients_.emplace_back(new GrpcClient<ObjectManagerService>(
-          address, port, client_call_manager, num_connections_));
+          address, port, client_call_manager, num_connections_, separate_connections));
+    }
+    if (separate_connections) {
+      control_client_.reset(new GrpcClient<ObjectManagerService>(
+          address, port, client_call_manager, 1, /*use_own_connection=*/true));
     }
   };
 
@@ -57,21 +69,74 @@ class ObjectManagerClient {
   VOID_RPC_CLIENT_METHOD(ObjectManagerService, Push,
                          grpc_clients_[push_rr_index_++ % num_connections_], )
 
+  /// Push object to remote object manager, with the chunk data given as slices
+  /// instead of in the data field of the request. The slices are sent as they are,
+  /// so their memory isn't copied.
+  ///
+  /// \param request The request message, without data.
+  /// \param data The chunk data.
+  /// \param callback The callback function that handles reply from server
+  void Push(const PushRequest &request, const std::vector<grpc::Slice> &data,
+            const ClientCallback<PushReply> &callback) {
+    RAY_CHECK(request.data().empty());
+    uint64_t data_size = 0;
+    for (const auto &slice : data) {
+      data_size += slice.size();
+    }
+    // Serialize the rest of the request, then append the header of the data field
+    // by hand. Protobuf accepts fields in any order, so the server parses this as a
+    // regular PushRequest.
+    std::string header = request.SerializeAsString();
+    {
+      using google::protobuf::internal::WireFormatLite;
+      google::protobuf::io::StringOutputStream string_stream(&header);
+      google::protobuf::io::CodedOutputStream coded_stream(&string_stream);
+      coded_stream.WriteTag(WireFormatLite::MakeTag(
+          PushRequest::kDataFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED));
+      coded_stream.WriteVarint64(data_size);
+    }
+    std::vector<grpc::Slice> slices;
+    slices.reserve(data.size() + 1);
+    slices.emplace_back(header);
+    slices.insert(slices.end(), data.begin(), data.end());
+    grpc::ByteBuffer buffer(slices.data(), slices.size());
+
+    grpc_clients_[push_rr_index_++ % num_connections_]->CallGenericMethod(
+        "/ray.rpc.ObjectManagerService/Push", buffer,
+        [callback](const Status &status, const grpc::ByteBuffer &reply_buffer) {
+          PushReply reply;
+          if (status.ok()) {
+            grpc::ByteBuffer reply_copy(reply_buffer);
+            RAY_UNUSED(
+                grpc::SerializationTraits<PushReply>::Deserialize(&reply_copy, &reply));
+          }
+          callback(status, reply);
+        },
+        "ObjectManagerService.grpc_client.Push");
+  }
+
   /// Pull object from remote object manager
   ///
   /// \param request The request message
   /// \param callback The callback function that handles reply from server
-  VOID_RPC_CLIENT_METHOD(ObjectManagerService, Pull,
-                         grpc_clients_[pull_rr_index_++ % num_connections_], )
+  VOID_RPC_CLIENT_METHOD(ObjectManagerService, Pull, ControlClient(pull_rr_index_), )
 
   /// Tell remote object manager to free objects
   ///
   /// \param request The request message
   /// \param callback  The callback function that handles reply
   VOID_RPC_CLIENT_METHOD(ObjectManagerService, FreeObjects,
-                         grpc_clients_[freeobjects_rr_index_++ % num_connections_], )
+                         ControlClient(freeobjects_rr_index_), )
 
  private:
+  /// The client for requests other than pushes.
+  GrpcClient<ObjectManagerService> *ControlClient(std::atomic<unsigned int> &rr_index) {
+    if (control_client_ != nullptr) {
+      return control_client_.get();
+    }
+    return grpc_clients_[rr_index++ % num_connections_].get();
+  }
+
   /// To optimize object manager performance we create multiple concurrent
   /// GRPC connections, and use these connections in a round-robin way.
   int num_connections_;
@@ -85,6 +150,10 @@ class ObjectManagerClient {
 
   /// The RPC clients.
   std::vector<std::unique_ptr<GrpcClient<ObjectManagerService>>> grpc_clients_;
+
+  /// The RPC client with a connection of its own for requests other than pushes, if
+  /// connections are separate.
+  std::unique_ptr<GrpcClient<ObjectManagerService>> control_client_;
 };
 
 }  // namespace rpc
@@ -23,11 +23,19 @@
 namespace ray {
 namespace rpc {
 
+/// `Push` is registered separately, see `ObjectManagerGrpcService`.
 #define RAY_OBJECT_MANAGER_RPC_HANDLERS               \
-  RPC_SERVICE_HANDLER(ObjectManagerService, Push, -1) \
   RPC_SERVICE_HANDLER(ObjectManagerService, Pull, -1) \
   RPC_SERVICE_HANDLER(ObjectManagerService, FreeObjects, -1)
 
+/// The object manager service, with `Push` requests received as raw bytes. This
+/// lets the chunk data be written into the object store straight from the gRPC
+/// buffer, instead of being copied into a `PushRequest` first.
+struct ObjectManagerRawPushService {
+  using AsyncService =
+      ObjectManagerService::WithRawMethod_Push<ObjectManagerService::AsyncService>;
+};
+
 /// Implementations of the `ObjectManagerGrpcService`, check interface in
 /// `src/ray/protobuf/object_manager.proto`.
 class ObjectManagerServiceHandler {
@@ -41,6 +49,41 @@ class ObjectManagerServiceHandler {
   /// \param[in] send_reply_callback The callback to be called when the request is done.
   virtual void HandlePush(const PushRequest &request, PushReply *reply,
                           SendReplyCallback send_reply_callback) = 0;
+  /// Handle a serialized `Push` request. This is what the server calls, the default
+  /// implementation parses the request and calls `HandlePush`.
+  ///
+  /// \param[in] request The serialized `PushRequest`.
+  /// \param[out] reply The serialized `PushReply`.
+  /// \param[in] send_reply_callback The callback to be called when the request is done.
+  virtual void HandleRawPush(const grpc::ByteBuffer &request, grpc::ByteBuffer *reply,
+                             SendReplyCallback send_reply_callback) {
+    auto push_request = std::make_shared<PushRequest>();
+    // Deserializing consumes the buffer, copying it only copies references.
+    grpc::ByteBuffer serialized_request(request);
+    if (!grpc::SerializationTraits<PushRequest>::Deserialize(&serialized_request,
+                                                             push_request.get())
+             .ok()) {
+      send_reply_callback(Status::Invalid("Failed to parse the push request."), nullptr,
+                          nullptr);
+      return;
+    }
+    auto push_reply = std::make_shared<PushReply>();
+    HandlePush(*push_request, push_reply.get(),
+               [push_request, push_reply, reply, send_reply_callback](
+                   Status status, std::function<void()> success,
+                   std::function<void()> failure) {
+                 SerializeRawPushReply(*push_reply, reply);
+                 send_reply_callback(status, std::move(success), std::move(failure));
+               });
+  }
+  /// Serialize a `PushReply` for `HandleRawPush`.
+  static void SerializeRawPushReply(const PushReply &push_reply,
+                                    grpc::ByteBuffer *reply) {
+    bool own_buffer;
+    RAY_CHECK(
+        grpc::SerializationTraits<PushReply>::Serialize(push_reply, reply, &own_buffer)
+            .ok());
+  }
   /// Handle a `Pull` request
   virtual void HandlePull(const PullRequest &request, PullReply *reply,
                           SendReplyCallback send_reply_callback) = 0;
@@ -68,11 +111,19 @@ class ObjectManagerGrpcService : public GrpcService {
       const std::unique_ptr<grpc::ServerCompletionQueue> &cq,
       std::vector<std::unique_ptr<ServerCallFactory>> *server_call_factories) override {
     RAY_OBJECT_MANAGER_RPC_HANDLERS
+    std::unique_ptr<ServerCallFactory> push_call_factory(
+        new ServerCallFactoryImpl<ObjectManagerRawPushService,
+                                  ObjectManagerServiceHandler, grpc::ByteBuffer,
+                                  grpc::ByteBuffer>(
+            service_, &ObjectManagerRawPushService::AsyncService::RequestPush,
+            service_handler_, &ObjectManagerServiceHandler::HandleRawPush, cq,
+            main_service_, "ObjectManagerService.grpc_server.Push", -1));
+    server_call_factories->emplace_back(std::move(push_call_factory));
   }
 
  private:
   /// The grpc async service object.
-  ObjectManagerService::AsyncService service_;
+  ObjectManagerRawPushService::AsyncService service_;
   /// The service handler that actually handle the requests.
   ObjectManagerServiceHandler &service_handler_;
 };
@@ -106,6 +106,10 @@ class ServerCallFactory {
   /// Get the maximum request number to handle at the same time. -1 means no limit.
   virtual int64_t GetMaxActiveRPCs() const = 0;
 
+  /// Get the longest time in milliseconds a request may wait in the event loop before
+  /// it is rejected instead of handled. -1 means requests are never rejected.
+  virtual int64_t GetShedQueueingMs() const { return -1; }
+
   virtual ~ServerCallFactory() = default;
 };
 
@@ -165,6 +169,7 @@ class ServerCallImpl : public ServerCall {
   void HandleRequest() override {
     STATS_grpc_server_req_handling.Record(1.0, call_name_);
     if (!io_service_.stopped()) {
+      post_time_ = absl::GetCurrentTimeNanos();
       io_service_.post([this] { HandleRequestImpl(); }, call_name_);
     } else {
       // Handle service for rpc call has stopped, we must handle the call here
@@ -186,6 +191,15 @@ class ServerCallImpl : public ServerCall {
       // a new request comes in.
       factory.CreateCall();
     }
+    if (factory.GetShedQueueingMs() != -1 &&
+        absl::GetCurrentTimeNanos() - post_time_ >
+            factory.GetShedQueueingMs() * 1000000) {
+      // The event loop is overloaded. Reject the request without handling it, so that
+      // the caller can back off instead of adding to the backlog.
+      RAY_LOG(DEBUG) << "Rejecting " << call_name_ << " because the server is overloaded.";
+      SendReply(Status::TimedOut("The server is overloaded, request rejected."));
+      return;
+    }
     (service_handler_.*handle_request_function_)(
         request_, &reply_,
         [this](Status status, std::function<void()> success,
@@ -265,6 +279,9 @@ class ServerCallImpl : public ServerCall {
   /// The ts when the request created
   int64_t start_time_;
 
+  /// The ts when the request was posted to the event loop.
+  int64_t post_time_ = 0;
+
   template <class T1, class T2, class T3, class T4>
   friend class ServerCallFactoryImpl;
 };
@@ -301,13 +318,16 @@ class ServerCallFactoryImpl : public ServerCallFactory {
   /// \param[in] io_service The event loop.
   /// \param[in] max_active_rpcs Maximum request number to handle at the same time. -1
   /// means no limit.
+  /// \param[in] shed_queueing_ms Requests that waited longer than this in the event loop
+  /// are rejected. -1 means requests are never rejected.
   ServerCallFactoryImpl(
       AsyncService &service,
       RequestCallFunction<GrpcService, Request, Reply> request_call_function,
       ServiceHandler &service_handler,
       HandleRequestFunction<ServiceHandler, Request, Reply> handle_request_function,
       const std::unique_ptr<grpc::ServerCompletionQueue> &cq,
-      instrumented_io_context &io_service, std::string call_name, int64_t max_active_rpcs)
+      instrumented_io_context &io_service, std::string call_name, int64_t max_active_rpcs,
+      int64_t shed_queueing_ms = -1)
       : service_(service),
         request_call_function_(request_call_function),
         service_handler_(service_handler),
@@ -315,7 +335,8 @@ class ServerCallFactoryImpl : public ServerCallFactory {
         cq_(cq),
         io_service_(io_service),
         call_name_(std::move(call_name)),
-        max_active_rpcs_(max_active_rpcs) {}
+        max_active_rpcs_(max_active_rpcs),
+        shed_queueing_ms_(shed_queueing_ms) {}
 
   void CreateCall() const override {
     // Create a new `ServerCall`. This object will eventually be deleted by
@@ -331,6 +352,8 @@ class ServerCallFactoryImpl : public ServerCallFactory {
 
   int64_t GetMaxActiveRPCs() const override { return max_active_rpcs_; }
 
+  int64_t GetShedQueueingMs() const override { return shed_queueing_ms_; }
+
  private:
   /// The gRPC-generated `AsyncService`.
   AsyncService &service_;
@@ -356,6 +379,10 @@ class ServerCallFactoryImpl : public ServerCallFactory {
   /// Maximum request number to handle at the same time.
   /// -1 means no limit.
   uint64_t max_active_rpcs_;
+
+  /// Longest time in milliseconds a request may wait in the event loop before it is
+  /// rejected. -1 means requests are never rejected.
+  int64_t shed_queueing_ms_;
 };
 
 }  // namespace rpc
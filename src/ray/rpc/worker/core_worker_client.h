@@ -20,14 +20,20 @@
 #pragma clang diagnostic warning "-Wunused-result"
 #endif
 
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <grpcpp/grpcpp.h>
 
+#include <algorithm>
 #include <deque>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/hash/hash.h"
 #include "ray/common/status.h"
 #include "ray/pubsub/subscriber.h"
@@ -54,6 +60,38 @@ const static int64_t RequestSizeInBytes(const PushTaskRequest &request) {
   return size;
 }
 
+/// Copy the fields of a task spec that are usually the same for every task of a
+/// remote function into a template. See PushTaskRequest.spec_template_id.
+inline void CopySpecTemplateFields(const TaskSpec &spec, TaskSpec *spec_template) {
+  spec_template->set_name(spec.name());
+  spec_template->set_language(spec.language());
+  spec_template->mutable_function_descriptor()->CopyFrom(spec.function_descriptor());
+  spec_template->set_job_id(spec.job_id());
+  *spec_template->mutable_required_resources() = spec.required_resources();
+  *spec_template->mutable_required_placement_resources() =
+      spec.required_placement_resources();
+  *spec_template->mutable_override_environment_variables() =
+      spec.override_environment_variables();
+  spec_template->set_serialized_runtime_env(spec.serialized_runtime_env());
+}
+
+/// Clear the fields of a task spec that CopySpecTemplateFields copies. Merging the
+/// template back into the spec restores them.
+inline void ClearSpecTemplateFields(TaskSpec *spec) {
+  spec->clear_name();
+  spec->clear_language();
+  spec->clear_function_descriptor();
+  spec->clear_job_id();
+  spec->clear_required_resources();
+  spec->clear_required_placement_resources();
+  spec->clear_override_environment_variables();
+  spec->clear_serialized_runtime_env();
+}
+
+/// A pushed task together with the callback for its reply.
+using PushTaskRequestAndCallback =
+    std::pair<std::unique_ptr<PushTaskRequest>, ClientCallback<PushTaskReply>>;
+
 // Shared between direct actor and task submitters.
 /* class CoreWorkerClientInterface; */
 
@@ -112,6 +150,16 @@ class CoreWorkerClientInterface : public pubsub::SubscriberClientInterface {
   virtual void PushActorTask(std::unique_ptr<PushTaskRequest> request, bool skip_queue,
                              const ClientCallback<PushTaskReply> &callback) {}
 
+  /// Push several actor tasks in order, as if each was pushed with PushActorTask
+  /// without skipping the queue. The client may send them in PushTaskBatch requests.
+  ///
+  /// \param[in] requests The requests to push and the callbacks for their replies.
+  virtual void PushActorTasks(std::vector<PushTaskRequestAndCallback> requests) {
+    for (auto &request : requests) {
+      PushActorTask(std::move(request.first), /*skip_queue=*/false, request.second);
+    }
+  }
+
   /// Similar to PushActorTask, but sets no ordering constraint. This is used to
   /// push non-actor tasks directly to a worker.
   virtual void PushNormalTask(std::unique_ptr<PushTaskRequest> request,
@@ -133,6 +181,11 @@ class CoreWorkerClientInterface : public pubsub::SubscriberClientInterface {
   virtual void GetObjectStatus(const GetObjectStatusRequest &request,
                                const ClientCallback<GetObjectStatusReply> &callback) {}
 
+  /// Ask the owner of several objects about their current status.
+  virtual void GetObjectStatusBatch(
+      const GetObjectStatusBatchRequest &request,
+      const ClientCallback<GetObjectStatusBatchReply> &callback) {}
+
   /// Ask the actor's owner to reply when the actor has gone out of scope.
   virtual void WaitForActorOutOfScope(
       const WaitForActorOutOfScopeRequest &request,
@@ -156,6 +209,10 @@ class CoreWorkerClientInterface : public pubsub::SubscriberClientInterface {
       const RemoveObjectLocationOwnerRequest &request,
       const ClientCallback<RemoveObjectLocationOwnerReply> &callback) {}
 
+  virtual void UpdateObjectLocationBatch(
+      const UpdateObjectLocationBatchRequest &request,
+      const ClientCallback<UpdateObjectLocationBatchReply> &callback) {}
+
   virtual void GetObjectLocationsOwner(
       const GetObjectLocationsOwnerRequest &request,
       const ClientCallback<GetObjectLocationsOwnerReply> &callback) {}
@@ -201,10 +258,21 @@ class CoreWorkerClientInterface : public pubsub::SubscriberClientInterface {
   virtual void Exit(const ExitRequest &request,
                     const ClientCallback<ExitReply> &callback) {}
 
+  virtual void ResetWorkerJob(const ResetWorkerJobRequest &request,
+                              const ClientCallback<ResetWorkerJobReply> &callback) {}
+
   virtual void AssignObjectOwner(const AssignObjectOwnerRequest &request,
                                  const ClientCallback<AssignObjectOwnerReply> &callback) {
   }
 
+  virtual void PushActorChannelMessages(
+      const PushActorChannelMessagesRequest &request,
+      const ClientCallback<PushActorChannelMessagesReply> &callback) {}
+
+  virtual void ReportGeneratorItemReturns(
+      const ReportGeneratorItemReturnsRequest &request,
+      const ClientCallback<ReportGeneratorItemReturnsReply> &callback) {}
+
   /// Returns the max acked sequence number, useful for checking on progress.
   virtual int64_t ClientProcessedUpToSeqno() { return -1; }
 
@@ -221,7 +289,9 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
   /// \param[in] port Port of the worker server.
   /// \param[in] client_call_manager The `ClientCallManager` used for managing requests.
   CoreWorkerClient(const rpc::Address &address, ClientCallManager &client_call_manager)
-      : addr_(address) {
+      : addr_(address),
+        max_batch_size_(RayConfig::instance().push_task_batch_max_size()),
+        max_spec_templates_(RayConfig::instance().max_task_spec_templates_per_worker()) {
     grpc_client_ = std::make_unique<GrpcClient<CoreWorkerService>>(
         addr_.ip_address(), addr_.port(), client_call_manager);
   };
@@ -233,6 +303,8 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
 
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, GetObjectStatus, grpc_client_, override)
 
+  VOID_RPC_CLIENT_METHOD(CoreWorkerService, GetObjectStatusBatch, grpc_client_, override)
+
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, KillActor, grpc_client_, override)
 
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, CancelTask, grpc_client_, override)
@@ -252,6 +324,9 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, RemoveObjectLocationOwner, grpc_client_,
                          override)
 
+  VOID_RPC_CLIENT_METHOD(CoreWorkerService, UpdateObjectLocationBatch, grpc_client_,
+                         override)
+
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, GetObjectLocationsOwner, grpc_client_,
                          override)
 
@@ -273,8 +348,16 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
 
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, Exit, grpc_client_, override)
 
+  VOID_RPC_CLIENT_METHOD(CoreWorkerService, ResetWorkerJob, grpc_client_, override)
+
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, AssignObjectOwner, grpc_client_, override)
 
+  VOID_RPC_CLIENT_METHOD(CoreWorkerService, PushActorChannelMessages, grpc_client_,
+                         override)
+
+  VOID_RPC_CLIENT_METHOD(CoreWorkerService, ReportGeneratorItemReturns, grpc_client_,
+                         override)
+
   void PushActorTask(std::unique_ptr<PushTaskRequest> request, bool skip_queue,
                      const ClientCallback<PushTaskReply> &callback) override {
     if (skip_queue) {
@@ -282,7 +365,13 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
       // processing this request. We could also set it to max_finished_seq_no_,
       // but we just set it to the default of -1 to avoid taking the lock.
       request->set_client_processed_up_to(-1);
-      INVOKE_RPC_CALL(CoreWorkerService, PushTask, *request, callback, grpc_client_);
+      auto push_callback = callback;
+      {
+        absl::MutexLock lock(&mutex_);
+        ApplySpecTemplate(request.get(), &push_callback);
+      }
+      INVOKE_RPC_CALL(CoreWorkerService, PushTask, *request, push_callback,
+                      grpc_client_);
       return;
     }
 
@@ -295,11 +384,26 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
     SendRequests();
   }
 
+  void PushActorTasks(std::vector<PushTaskRequestAndCallback> requests) override {
+    {
+      absl::MutexLock lock(&mutex_);
+      for (auto &request : requests) {
+        send_queue_.push_back(std::move(request));
+      }
+    }
+    SendRequests();
+  }
+
   void PushNormalTask(std::unique_ptr<PushTaskRequest> request,
                       const ClientCallback<PushTaskReply> &callback) override {
     request->set_sequence_number(-1);
     request->set_client_processed_up_to(-1);
-    INVOKE_RPC_CALL(CoreWorkerService, PushTask, *request, callback, grpc_client_);
+    auto push_callback = callback;
+    {
+      absl::MutexLock lock(&mutex_);
+      ApplySpecTemplate(request.get(), &push_callback);
+    }
+    INVOKE_RPC_CALL(CoreWorkerService, PushTask, *request, push_callback, grpc_client_);
   }
 
   void StealTasks(std::unique_ptr<StealTasksRequest> request,
@@ -317,10 +421,15 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
     auto this_ptr = this->shared_from_this();
 
     while (!send_queue_.empty() && rpc_bytes_in_flight_ < kMaxBytesInFlight) {
+      if (max_batch_size_ > 1 && send_queue_.size() > 1) {
+        SendRequestBatch(this_ptr);
+        continue;
+      }
       auto pair = std::move(*send_queue_.begin());
       send_queue_.pop_front();
 
       auto request = std::move(pair.first);
+      ApplySpecTemplate(request.get(), &pair.second);
       int64_t task_size = RequestSizeInBytes(*request);
       int64_t seq_no = request->sequence_number();
       request->set_client_processed_up_to(max_finished_seq_no_);
@@ -357,6 +466,110 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
   }
 
  private:
+  /// Send only an ID in place of the template fields of the task spec, if the remote
+  /// worker already knows the template. Otherwise, send the full spec and mark the
+  /// template as known once the worker replies.
+  ///
+  /// \param[in,out] request The request to send.
+  /// \param[in,out] callback The callback for the reply to the request.
+  void ApplySpecTemplate(PushTaskRequest *request,
+                         ClientCallback<PushTaskReply> *callback)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    if (max_spec_templates_ == 0) {
+      return;
+    }
+    TaskSpec spec_template;
+    CopySpecTemplateFields(request->task_spec(), &spec_template);
+    std::string key;
+    {
+      google::protobuf::io::StringOutputStream stream(&key);
+      google::protobuf::io::CodedOutputStream output(&stream);
+      output.SetSerializationDeterministic(true);
+      spec_template.SerializeToCodedStream(&output);
+    }
+    auto it = spec_template_ids_.find(key);
+    if (it == spec_template_ids_.end()) {
+      if (spec_template_ids_.size() >= max_spec_templates_) {
+        return;
+      }
+      it = spec_template_ids_.emplace(key, spec_template_ids_.size() + 1).first;
+    }
+    const int64_t template_id = it->second;
+    request->set_spec_template_id(template_id);
+    if (acked_spec_templates_.contains(template_id)) {
+      ClearSpecTemplateFields(request->mutable_task_spec());
+      return;
+    }
+
+    // The template is only used once a reply shows that the worker has cached it,
+    // because requests may be handled out of order.
+    request->set_defines_spec_template(true);
+    *callback = [this, this_ptr = shared_from_this(), template_id,
+                 callback = std::move(*callback)](const Status &status,
+                                                  const PushTaskReply &reply) {
+      if (status.ok()) {
+        absl::MutexLock lock(&mutex_);
+        acked_spec_templates_.insert(template_id);
+      }
+      callback(status, reply);
+    };
+  }
+
+  /// Send up to max_batch_size_ queued requests in a single PushTaskBatch request.
+  /// The reply to each task is delivered once the whole batch has been replied to.
+  void SendRequestBatch(const std::shared_ptr<CoreWorkerClient> &this_ptr)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    PushTaskBatchRequest batch;
+    std::vector<ClientCallback<PushTaskReply>> callbacks;
+    int64_t batch_size = 0;
+    int64_t max_seq_no = -1;
+    while (!send_queue_.empty() && callbacks.size() < max_batch_size_ &&
+           rpc_bytes_in_flight_ + batch_size < kMaxBytesInFlight) {
+      auto pair = std::move(*send_queue_.begin());
+      send_queue_.pop_front();
+
+      auto &request = *pair.first;
+      ApplySpecTemplate(&request, &pair.second);
+      batch_size += RequestSizeInBytes(request);
+      max_seq_no = std::max(max_seq_no, request.sequence_number());
+      request.set_client_processed_up_to(max_finished_seq_no_);
+      batch.add_requests()->Swap(&request);
+      callbacks.push_back(std::move(pair.second));
+    }
+    rpc_bytes_in_flight_ += batch_size;
+
+    auto rpc_callback = [this, this_ptr, max_seq_no, batch_size,
+                         callbacks = std::move(callbacks)](
+                            Status status, const rpc::PushTaskBatchReply &reply) {
+      {
+        absl::MutexLock lock(&mutex_);
+        if (max_seq_no > max_finished_seq_no_) {
+          max_finished_seq_no_ = max_seq_no;
+        }
+        rpc_bytes_in_flight_ -= batch_size;
+        RAY_CHECK(rpc_bytes_in_flight_ >= 0);
+      }
+      SendRequests();
+      for (size_t i = 0; i < callbacks.size(); i++) {
+        const int index = static_cast<int>(i);
+        if (!status.ok() || index >= reply.replies_size()) {
+          callbacks[i](status.ok() ? Status::IOError("Missing reply in task batch")
+                                   : status,
+                       PushTaskReply());
+        } else if (reply.status_codes(index) != static_cast<int>(StatusCode::OK)) {
+          callbacks[i](Status(StatusCode(reply.status_codes(index)),
+                              reply.status_messages(index)),
+                       reply.replies(index));
+        } else {
+          callbacks[i](Status::OK(), reply.replies(index));
+        }
+      }
+    };
+
+    RAY_UNUSED(INVOKE_RPC_CALL(CoreWorkerService, PushTaskBatch, batch,
+                               std::move(rpc_callback), grpc_client_));
+  }
+
   /// Protects against unsafe concurrent access from the callback thread.
   absl::Mutex mutex_;
 
@@ -375,6 +588,19 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
 
   /// The max sequence number we have processed responses for.
   int64_t max_finished_seq_no_ GUARDED_BY(mutex_) = -1;
+
+  /// The max number of queued tasks to send in one PushTaskBatch request.
+  const size_t max_batch_size_;
+
+  /// The max number of task spec templates to define on the remote worker.
+  const size_t max_spec_templates_;
+
+  /// The IDs of the task spec templates sent to the remote worker, keyed by the
+  /// serialized template.
+  absl::flat_hash_map<std::string, int64_t> spec_template_ids_ GUARDED_BY(mutex_);
+
+  /// The IDs of the templates that the remote worker is known to have cached.
+  absl::flat_hash_set<int64_t> acked_spec_templates_ GUARDED_BY(mutex_);
 };
 
 typedef std::function<std::shared_ptr<CoreWorkerClientInterface>(const rpc::Address &)>
@@ -14,6 +14,10 @@
 
 #include "ray/stats/metric.h"
 
+#include <algorithm>
+#include <limits>
+#include <unordered_set>
+
 #include "opencensus/stats/internal/aggregation_window.h"
 #include "opencensus/stats/internal/set_aggregation_window.h"
 #include "opencensus/stats/measure_registry.h"
@@ -41,6 +45,135 @@ void RegisterAsView(opencensus::stats::ViewDescriptor view_descriptor,
   view_descriptor.RegisterForExport();
 }
 
+namespace {
+
+/// The number of counter stripes of each fast metric series. Threads are assigned
+/// stripes round-robin, so that up to this many threads record without contention.
+constexpr size_t kNumFastMetricStripes = 16;
+
+size_t CurrentStripe() {
+  static std::atomic<size_t> next_stripe(0);
+  thread_local size_t stripe =
+      next_stripe.fetch_add(1, std::memory_order_relaxed) % kNumFastMetricStripes;
+  return stripe;
+}
+
+void AtomicAdd(std::atomic<double> *target, double value) {
+  double current = target->load(std::memory_order_relaxed);
+  while (!target->compare_exchange_weak(current, current + value,
+                                        std::memory_order_relaxed)) {
+  }
+}
+
+void AtomicMin(std::atomic<double> *target, double value) {
+  double current = target->load(std::memory_order_relaxed);
+  while (value < current &&
+         !target->compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+void AtomicMax(std::atomic<double> *target, double value) {
+  double current = target->load(std::memory_order_relaxed);
+  while (value > current &&
+         !target->compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+/// Protects the registered fast metrics and their series. It is only taken to bind
+/// tags and to harvest, never to record.
+absl::Mutex &FastMetricsMutex() {
+  static auto *mutex = new absl::Mutex();
+  return *mutex;
+}
+
+std::unordered_set<const FastMetric *> &FastMetrics() {
+  static auto *metrics = new std::unordered_set<const FastMetric *>();
+  return *metrics;
+}
+
+/// The counters of a fast metric with one set of tag values.
+class FastMetricSeries {
+ public:
+  FastMetricSeries(std::vector<std::string> tag_values, bool is_histogram,
+                   const std::vector<double> &boundaries)
+      : tag_values_(std::move(tag_values)),
+        is_histogram_(is_histogram),
+        boundaries_(boundaries) {
+    // Each stripe is allocated separately, so that stripes don't share cache lines.
+    for (auto &stripe : stripes_) {
+      stripe.reset(new Stripe(is_histogram_ ? boundaries_.size() + 1 : 0));
+    }
+  }
+
+  void Record(double value) {
+    auto &stripe = *stripes_[CurrentStripe()];
+    stripe.count.fetch_add(1, std::memory_order_relaxed);
+    AtomicAdd(&stripe.sum, value);
+    if (!is_histogram_) {
+      return;
+    }
+    AtomicAdd(&stripe.sum_of_squares, value * value);
+    AtomicMin(&stripe.min, value);
+    AtomicMax(&stripe.max, value);
+    // Like OpenCensus, bucket i holds the values in [boundaries[i - 1], boundaries[i]).
+    auto bucket = std::upper_bound(boundaries_.begin(), boundaries_.end(), value) -
+                  boundaries_.begin();
+    stripe.bucket_counts[bucket].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  FastMetricSnapshot Snapshot(const FastMetric &metric) const {
+    FastMetricSnapshot snapshot;
+    snapshot.metric = &metric;
+    snapshot.tag_values = tag_values_;
+    snapshot.bucket_counts.resize(is_histogram_ ? boundaries_.size() + 1 : 0);
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    for (const auto &stripe : stripes_) {
+      snapshot.count += stripe->count.load(std::memory_order_relaxed);
+      snapshot.sum += stripe->sum.load(std::memory_order_relaxed);
+      if (!is_histogram_) {
+        continue;
+      }
+      snapshot.sum_of_squares += stripe->sum_of_squares.load(std::memory_order_relaxed);
+      min = std::min(min, stripe->min.load(std::memory_order_relaxed));
+      max = std::max(max, stripe->max.load(std::memory_order_relaxed));
+      for (size_t i = 0; i < snapshot.bucket_counts.size(); i++) {
+        snapshot.bucket_counts[i] +=
+            stripe->bucket_counts[i].load(std::memory_order_relaxed);
+      }
+    }
+    if (is_histogram_ && snapshot.count > 0) {
+      snapshot.min = min;
+      snapshot.max = max;
+    }
+    return snapshot;
+  }
+
+ private:
+  struct Stripe {
+    explicit Stripe(size_t num_buckets)
+        : bucket_counts(new std::atomic<uint64_t>[num_buckets]) {
+      for (size_t i = 0; i < num_buckets; i++) {
+        bucket_counts[i].store(0, std::memory_order_relaxed);
+      }
+    }
+
+    std::atomic<uint64_t> count{0};
+    std::atomic<double> sum{0};
+    std::atomic<double> sum_of_squares{0};
+    std::atomic<double> min{std::numeric_limits<double>::infinity()};
+    std::atomic<double> max{-std::numeric_limits<double>::infinity()};
+    std::unique_ptr<std::atomic<uint64_t>[]> bucket_counts;
+  };
+
+  const std::vector<std::string> tag_values_;
+  const bool is_histogram_;
+  const std::vector<double> &boundaries_;
+  std::unique_ptr<Stripe> stripes_[kNumFastMetricStripes];
+};
+
 }  // namespace internal
 ///
 /// Stats Config
@@ -129,6 +262,82 @@ void Metric::Record(double value,
   Record(value, tags_pair_vec);
 }
 
+///
+/// FastMetric
+///
+FastMetric::FastMetric(const std::string &name, const std::string &description,
+                       const std::string &unit, FastMetricType type,
+                       const std::vector<double> &boundaries,
+                       const std::vector<std::string> &tag_keys)
+    : name_(name),
+      type_(type),
+      boundaries_(boundaries),
+      tag_keys_(tag_keys),
+      start_time_(absl::Now()) {
+  // Measure could be registered before, so we try to get it first.
+  MeasureDouble registered_measure =
+      opencensus::stats::MeasureRegistry::GetMeasureDoubleByName(name_);
+  if (registered_measure.IsValid()) {
+    measure_.reset(new MeasureDouble(registered_measure));
+  } else {
+    measure_.reset(new MeasureDouble(MeasureDouble::Register(name_, description, unit)));
+  }
+  absl::MutexLock lock(&internal::FastMetricsMutex());
+  internal::FastMetrics().insert(this);
+}
+
+FastMetric::~FastMetric() {
+  absl::MutexLock lock(&internal::FastMetricsMutex());
+  internal::FastMetrics().erase(this);
+}
+
+FastMetric::BoundMetric FastMetric::Bind(
+    const std::unordered_map<std::string, std::string> &tags) {
+  std::vector<std::string> tag_values;
+  tag_values.reserve(tag_keys_.size());
+  std::string series_key;
+  for (const auto &key : tag_keys_) {
+    auto it = tags.find(key);
+    std::string value = it == tags.end() ? "" : it->second;
+    // In case that tag containing non-printable chars we replace them to '?'
+    // It's important here because otherwise, the message will fail to be sent.
+    for (auto &c : value) {
+      if (!isprint(c)) {
+        c = '?';
+      }
+    }
+    // Values can't contain '\0' anymore, so it separates them unambiguously.
+    series_key.append(value).push_back('\0');
+    tag_values.push_back(std::move(value));
+  }
+
+  absl::MutexLock lock(&internal::FastMetricsMutex());
+  auto &series = series_[series_key];
+  if (series == nullptr) {
+    series.reset(new internal::FastMetricSeries(
+        std::move(tag_values), type_ == FastMetricType::HISTOGRAM, boundaries_));
+  }
+  return BoundMetric(series.get());
+}
+
+void FastMetric::BoundMetric::Record(double value) const {
+  if (StatsConfig::instance().IsStatsDisabled()) {
+    return;
+  }
+  series_->Record(value);
+}
+
+std::vector<FastMetricSnapshot> HarvestFastMetrics() {
+  std::vector<FastMetricSnapshot> snapshots;
+  absl::MutexLock lock(&internal::FastMetricsMutex());
+  for (const auto *metric : internal::FastMetrics()) {
+    for (const auto &series : metric->series_) {
+      snapshots.push_back(series.second->Snapshot(*metric));
+    }
+  }
+  return snapshots;
+}
+
 void Gauge::RegisterView() {
   opencensus::stats::ViewDescriptor view_descriptor =
       opencensus::stats::ViewDescriptor()
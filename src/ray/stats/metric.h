@@ -15,10 +15,13 @@
 #pragma once
 
 #include <ctype.h>
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <tuple>
 #include <unordered_map>
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "gtest/gtest_prod.h"
 #include "opencensus/stats/stats.h"
 #include "opencensus/stats/stats_exporter.h"
@@ -192,6 +195,113 @@ class Sum : public Metric {
 
 };  // class Sum
 
+namespace internal {
+class FastMetricSeries;
+}  // namespace internal
+
+struct FastMetricSnapshot;
+
+/// How the values of a fast metric are aggregated.
+enum class FastMetricType { SUM, HISTOGRAM };
+
+/// A metric for hot paths. Unlike `Metric`, recording a value doesn't go through the
+/// OpenCensus recorder: the tag values are bound once with `Bind`, and the returned
+/// handle adds values to counters striped by thread. The counters are only summed up
+/// when the exporters harvest the metrics, so recording takes no lock and does no tag
+/// lookup.
+///
+/// The exported values are cumulative, like the OpenCensus views of `Sum` and
+/// `Histogram`.
+///
+/// This class is thread safe. Handles must not outlive their metric.
+class FastMetric {
+ public:
+  /// A handle to record values with one set of tag values.
+  class BoundMetric {
+   public:
+    /// Record the value. It is a no-op if stats are disabled.
+    void Record(double value) const;
+
+   private:
+    friend class FastMetric;
+    explicit BoundMetric(internal::FastMetricSeries *series) : series_(series) {}
+
+    internal::FastMetricSeries *series_;
+  };
+
+  FastMetric(const std::string &name, const std::string &description,
+             const std::string &unit, FastMetricType type,
+             const std::vector<double> &boundaries,
+             const std::vector<std::string> &tag_keys);
+
+  virtual ~FastMetric();
+
+  /// Get the handle to record values with the given tag values. Binding the same tag
+  /// values again returns a handle to the same counters. Missing tags are empty.
+  ///
+  /// \param tags The values of the tag keys of this metric.
+  BoundMetric Bind(const std::unordered_map<std::string, std::string> &tags = {});
+
+  const std::string &GetName() const { return name_; }
+  FastMetricType GetType() const { return type_; }
+  const std::vector<double> &GetBoundaries() const { return boundaries_; }
+  const std::vector<std::string> &GetTagKeys() const { return tag_keys_; }
+  absl::Time GetStartTime() const { return start_time_; }
+  const opencensus::stats::MeasureDescriptor &GetMeasureDescriptor() const {
+    return measure_->GetDescriptor();
+  }
+
+ private:
+  friend std::vector<FastMetricSnapshot> HarvestFastMetrics();
+
+  const std::string name_;
+  const FastMetricType type_;
+  const std::vector<double> boundaries_;
+  const std::vector<std::string> tag_keys_;
+  const absl::Time start_time_;
+  /// The measure that describes this metric to the exporters. No value is recorded to
+  /// it.
+  std::unique_ptr<opencensus::stats::Measure<double>> measure_;
+  /// The counters of each bound set of tag values. Guarded by the registry mutex.
+  std::unordered_map<std::string, std::unique_ptr<internal::FastMetricSeries>> series_;
+};
+
+/// A fast metric that exports the sum of the recorded values.
+class FastSum : public FastMetric {
+ public:
+  FastSum(const std::string &name, const std::string &description,
+          const std::string &unit, const std::vector<std::string> &tag_keys = {})
+      : FastMetric(name, description, unit, FastMetricType::SUM, {}, tag_keys) {}
+};
+
+/// A fast metric that exports the distribution of the recorded values.
+class FastHistogram : public FastMetric {
+ public:
+  FastHistogram(const std::string &name, const std::string &description,
+                const std::string &unit, const std::vector<double> &boundaries,
+                const std::vector<std::string> &tag_keys = {})
+      : FastMetric(name, description, unit, FastMetricType::HISTOGRAM, boundaries,
+                   tag_keys) {}
+};
+
+/// The aggregated values of one fast metric with one set of tag values.
+struct FastMetricSnapshot {
+  const FastMetric *metric;
+  /// The values of the metric's tag keys, in the same order.
+  std::vector<std::string> tag_values;
+  uint64_t count = 0;
+  double sum = 0;
+  double sum_of_squares = 0;
+  double min = 0;
+  double max = 0;
+  /// The number of values in each bucket, for histograms. The first bucket is below
+  /// the first boundary.
+  std::vector<uint64_t> bucket_counts;
+};
+
+/// Sum up the counters of all the fast metrics. Called by the exporters.
+std::vector<FastMetricSnapshot> HarvestFastMetrics();
+
 /// Raw metric view point for exporter.
 struct MetricPoint {
   std::string metric_name;
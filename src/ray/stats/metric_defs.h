@@ -71,6 +71,50 @@ static Gauge ObjectManagerPullRequests("object_manager_num_pull_requests",
                                        "Number of active pull requests for objects.",
                                        "requests");
 
+static Histogram ObjectManagerChunkRoundTripMs(
+    "object_manager_chunk_round_trip_ms",
+    "Time from sending an object chunk to a node until the node acknowledged it.", "ms",
+    {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000}, {PeerNodeKey});
+
+static Histogram ObjectManagerChunkBandwidthMB(
+    "object_manager_chunk_bandwidth_mb",
+    "Throughput of the object chunks sent to a node, measured per chunk.", "MB/s",
+    {1, 10, 50, 100, 200, 500, 1000, 2000, 5000}, {PeerNodeKey});
+
+static Histogram ObjectManagerPushQueueingMs(
+    "object_manager_push_queueing_ms",
+    "Time from starting a push to a node until its first chunk is sent. If this is "
+    "high, pushes wait for the chunks of other pushes in flight.",
+    "ms", {1, 10, 100, 1000, 10000, 100000}, {PeerNodeKey});
+
+static Histogram ObjectManagerSpilledChunkReadMs(
+    "object_manager_spilled_chunk_read_ms",
+    "Time to read a chunk of a spilled object from external storage to push it.", "ms",
+    {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000});
+
+static Sum ObjectManagerCompressionBytesSaved(
+    "object_manager_compression_bytes_saved",
+    "Bytes of object chunks that were not sent to a node because the chunks were "
+    "compressed.",
+    "bytes", {PeerNodeKey});
+
+static Histogram ObjectManagerReceiveBufferCreateMs(
+    "object_manager_receive_buffer_create_ms",
+    "Time to allocate the object store buffer of an object being received. If this is "
+    "high, received objects wait for memory to be freed or spilled.",
+    "ms", {1, 10, 100, 1000, 10000, 100000});
+
+static Histogram ObjectManagerChunkWriteMs(
+    "object_manager_chunk_write_ms",
+    "Time to write a received object chunk into the object store, including waiting "
+    "for other chunks being written.",
+    "ms", {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000});
+
+static Histogram ObjectManagerPullRetries(
+    "object_manager_pull_retries",
+    "Number of times an object pull was retried before the pull was removed.", "retries",
+    {1, 2, 3, 5, 10});
+
 static Gauge ObjectDirectoryLocationSubscriptions(
     "object_directory_subscriptions",
     "Number of object location subscriptions. If this is high, the raylet is attempting "
@@ -140,6 +184,22 @@ static Gauge SpillingBandwidthMB("object_spilling_bandwidth_mb",
 static Gauge RestoringBandwidthMB("object_restoration_bandwidth_mb",
                                   "Bandwidth of object restoration.", "MB");
 
+static Gauge MemoryStoreUsedMemory(
+    "core_worker_memory_store_used_memory",
+    "Amount of memory occupied by inlined objects in a worker's in-memory store.",
+    "bytes");
+
+static Gauge TaskLineageBytes(
+    "core_worker_task_lineage_bytes",
+    "Size of the task specs a worker keeps to reconstruct objects through lineage.",
+    "bytes");
+
+static Gauge TaskLineageEvicted(
+    "core_worker_task_lineage_evicted",
+    "Number of finished tasks whose lineage was evicted to stay under the lineage "
+    "size limit.",
+    "tasks");
+
 ///
 /// GCS Server Metrics
 ///
@@ -102,9 +102,45 @@ void MetricPointExporter::ExportViewData(
       break;
     }
   }
+  ExportFastMetrics(points);
   metric_exporter_client_->ReportMetrics(points);
 }
 
+void MetricPointExporter::ExportFastMetrics(std::vector<MetricPoint> &points) {
+  const auto &global_tags = StatsConfig::instance().GetGlobalTags();
+  for (const auto &snapshot : HarvestFastMetrics()) {
+    const auto &metric = *snapshot.metric;
+    std::unordered_map<std::string, std::string> tags;
+    for (const auto &tag : global_tags) {
+      tags[tag.first.name()] = tag.second;
+    }
+    for (size_t i = 0; i < snapshot.tag_values.size(); ++i) {
+      tags[metric.GetTagKeys()[i]] = snapshot.tag_values[i];
+    }
+    const auto &measure_descriptor = metric.GetMeasureDescriptor();
+    const auto &metric_name = metric.GetName();
+    if (metric.GetType() == FastMetricType::SUM) {
+      MetricPoint point{metric_name, current_sys_time_ms(), snapshot.sum, tags,
+                        measure_descriptor};
+      points.push_back(std::move(point));
+    } else if (snapshot.count > 0) {
+      MetricPoint mean_point{metric_name + ".mean", current_sys_time_ms(),
+                             snapshot.sum / snapshot.count, tags, measure_descriptor};
+      MetricPoint max_point{metric_name + ".max", current_sys_time_ms(), snapshot.max,
+                            tags, measure_descriptor};
+      MetricPoint min_point{metric_name + ".min", current_sys_time_ms(), snapshot.min,
+                            tags, measure_descriptor};
+      points.push_back(std::move(mean_point));
+      points.push_back(std::move(max_point));
+      points.push_back(std::move(min_point));
+    }
+    if (points.size() >= report_batch_size_) {
+      metric_exporter_client_->ReportMetrics(points);
+      points.clear();
+    }
+  }
+}
+
 OpenCensusProtoExporter::OpenCensusProtoExporter(
     GetMetricsAgentClientFn get_metrics_agent_client)
     : get_metrics_agent_client_(get_metrics_agent_client) {
@@ -204,6 +240,58 @@ void OpenCensusProtoExporter::ExportViewData(
     }
   }
 
+  // Write the fast metrics, which are not recorded to OpenCensus views.
+  const auto &global_tags = StatsConfig::instance().GetGlobalTags();
+  auto end_time = absl::ToUnixSeconds(absl::Now());
+  for (const auto &snapshot : HarvestFastMetrics()) {
+    const auto &metric = *snapshot.metric;
+    const auto &measure_descriptor = metric.GetMeasureDescriptor();
+    auto request_point_proto = request_proto.add_metrics();
+    auto metric_descriptor_proto = request_point_proto->mutable_metric_descriptor();
+    metric_descriptor_proto->set_name(measure_descriptor.name());
+    metric_descriptor_proto->set_description(measure_descriptor.description());
+    metric_descriptor_proto->set_unit(measure_descriptor.units());
+    for (const auto &tag : global_tags) {
+      metric_descriptor_proto->add_label_keys()->set_key(tag.first.name());
+    }
+    for (const auto &key : metric.GetTagKeys()) {
+      metric_descriptor_proto->add_label_keys()->set_key(key);
+    }
+
+    auto metric_timeseries_proto = request_point_proto->add_timeseries();
+    metric_timeseries_proto->mutable_start_timestamp()->set_seconds(
+        absl::ToUnixSeconds(metric.GetStartTime()));
+    for (const auto &tag : global_tags) {
+      metric_timeseries_proto->add_label_values()->set_value(tag.second);
+    }
+    for (const auto &value : snapshot.tag_values) {
+      metric_timeseries_proto->add_label_values()->set_value(value);
+    }
+    auto point_proto = metric_timeseries_proto->add_points();
+    point_proto->mutable_timestamp()->set_seconds(end_time);
+
+    if (metric.GetType() == FastMetricType::SUM) {
+      point_proto->set_double_value(snapshot.sum);
+      continue;
+    }
+    auto distribution_proto = point_proto->mutable_distribution_value();
+    distribution_proto->set_count(snapshot.count);
+    distribution_proto->set_sum(snapshot.sum);
+    if (snapshot.count > 0) {
+      distribution_proto->set_sum_of_squared_deviation(
+          std::max(0.0, snapshot.sum_of_squares -
+                            snapshot.sum * snapshot.sum / snapshot.count));
+    }
+    auto bucket_opt_proto =
+        distribution_proto->mutable_bucket_options()->mutable_explicit_();
+    for (const auto &bound : metric.GetBoundaries()) {
+      bucket_opt_proto->add_bounds(bound);
+    }
+    for (const auto &count : snapshot.bucket_counts) {
+      distribution_proto->add_buckets()->set_count(count);
+    }
+  }
+
   // Get a client copy, this is the opencensus report thread.
   client_mutex_.Lock();
   auto client = client_;
@@ -84,6 +84,11 @@ class MetricPointExporter final : public opencensus::stats::StatsExporter::Handl
     }
   }
 
+  /// Harvest the fast metrics into points. A sum is exported as its value and a
+  /// histogram as its mean, max and min, like the OpenCensus views.
+  /// \param points, memory metric vector instance
+  void ExportFastMetrics(std::vector<MetricPoint> &points);
+
  private:
   std::shared_ptr<MetricExporterClient> metric_exporter_client_;
   /// Auto max minbatch size for reporting metrics to external components.
@@ -14,12 +14,47 @@
 
 #include "ray/stats/stats.h"
 
+#include <algorithm>
+
 namespace ray {
 
 namespace stats {
 std::shared_ptr<IOServicePool> metrics_io_service_pool;
 std::shared_ptr<MetricExporterClient> exporter;
+std::shared_ptr<prometheus::Exposer> native_exposer;
+std::shared_ptr<opencensus::exporters::stats::PrometheusExporter> native_collectable;
 absl::Mutex stats_mutex;
+
+int StartNativeExposition(int64_t base_port, int64_t num_ports) {
+  if (base_port <= 0) {
+    return 0;
+  }
+  for (int64_t port = base_port; port < base_port + std::max<int64_t>(num_ports, 1);
+       port++) {
+    try {
+      native_exposer =
+          std::make_shared<prometheus::Exposer>("0.0.0.0:" + std::to_string(port));
+    } catch (const std::exception &e) {
+      RAY_LOG(DEBUG) << "Port " << port << " is not available for metrics: " << e.what();
+      continue;
+    }
+    // The collectable renders the registered views when it is scraped, so nothing is
+    // batched or buffered in between.
+    native_collectable =
+        std::make_shared<opencensus::exporters::stats::PrometheusExporter>();
+    native_exposer->RegisterCollectable(native_collectable);
+    RAY_LOG(INFO) << "Serving metrics in the Prometheus format at port " << port;
+    return port;
+  }
+  RAY_LOG(WARNING) << "Failed to serve metrics natively, no free port in ["
+                   << base_port << ", " << base_port + num_ports << ").";
+  return 0;
+}
+
+void StopNativeExposition() {
+  native_exposer = nullptr;
+  native_collectable = nullptr;
+}
 }  // namespace stats
 
 }  // namespace ray
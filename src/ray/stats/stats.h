@@ -20,9 +20,11 @@
 #include <unordered_map>
 
 #include "absl/synchronization/mutex.h"
+#include "opencensus/exporters/stats/prometheus/prometheus_exporter.h"
 #include "opencensus/stats/internal/delta_producer.h"
 #include "opencensus/stats/stats.h"
 #include "opencensus/tags/tag_key.h"
+#include "prometheus/exposer.h"
 #include "ray/common/asio/instrumented_io_context.h"
 #include "ray/common/asio/io_service_pool.h"
 #include "ray/common/constants.h"
@@ -47,6 +49,16 @@ extern std::shared_ptr<IOServicePool> metrics_io_service_pool;
 extern std::shared_ptr<MetricExporterClient> exporter;
 extern absl::Mutex stats_mutex;
 
+/// Serve the views registered for export at /metrics over HTTP, on the first free
+/// port in [base_port, base_port + num_ports).
+/// \param base_port[in] The first port to try, the endpoint is disabled if not positive.
+/// \param num_ports[in] The number of ports to try.
+/// \return The port the endpoint listens on, or 0 if it is not served.
+int StartNativeExposition(int64_t base_port, int64_t num_ports);
+
+/// Stop serving the views started by StartNativeExposition.
+void StopNativeExposition();
+
 typedef std::function<void(Status status, const boost::optional<std::string> &result)>
     GetAgentAddressCallback;
 typedef std::function<void(const GetAgentAddressCallback &callback)> GetAgentAddressFn;
@@ -128,6 +140,8 @@ static inline void Init(const TagsType &global_tags, GetAgentAddressFn get_agent
   opencensus::stats::DeltaProducer::Get()->SetHarvestInterval(
       StatsConfig::instance().GetHarvestInterval());
   StatsConfig::instance().SetGlobalTags(global_tags);
+  StartNativeExposition(RayConfig::instance().native_metrics_export_port(),
+                        RayConfig::instance().native_metrics_export_port_range());
   for (auto &f : StatsConfig::instance().PopInitializers()) {
     f();
   }
@@ -146,6 +160,7 @@ static inline void Shutdown() {
   metrics_io_service_pool->Stop();
   opencensus::stats::DeltaProducer::Get()->Shutdown();
   opencensus::stats::StatsExporter::Shutdown();
+  StopNativeExposition();
   metrics_io_service_pool = nullptr;
   exporter = nullptr;
   StatsConfig::instance().SetIsInitialized(false);
@@ -227,6 +227,58 @@ TEST_F(StatsTest, STAT_DEF) {
   STATS_test_declare.Record(1.0, "Test");
 }
 
+TEST_F(StatsTest, FastMetricTest) {
+  stats::FastSum fast_sum("ray.test.fast_sum", "", "", {"method"});
+  stats::FastHistogram fast_histogram("ray.test.fast_histogram", "", "", {1.0, 10.0},
+                                      {"method"});
+  auto sum_a = fast_sum.Bind({{"method", "a"}});
+  auto sum_b = fast_sum.Bind({{"method", "b"}});
+  auto histogram = fast_histogram.Bind({{"method", "a"}});
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&fast_sum, sum_b, histogram]() {
+      // Binding the same tags again shares the counters.
+      auto sum_a = fast_sum.Bind({{"method", "a"}});
+      for (int j = 0; j < 1000; j++) {
+        sum_a.Record(1);
+        sum_b.Record(2);
+        histogram.Record(j % 20);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  auto snapshots = stats::HarvestFastMetrics();
+  ASSERT_EQ(snapshots.size(), 3);
+  for (const auto &snapshot : snapshots) {
+    ASSERT_EQ(snapshot.tag_values.size(), 1);
+    if (snapshot.metric == &fast_sum) {
+      ASSERT_EQ(snapshot.count, 8000);
+      ASSERT_EQ(snapshot.sum, snapshot.tag_values[0] == "a" ? 8000 : 16000);
+    } else {
+      ASSERT_EQ(snapshot.metric, &fast_histogram);
+      ASSERT_EQ(snapshot.count, 8000);
+      ASSERT_EQ(snapshot.min, 0);
+      ASSERT_EQ(snapshot.max, 19);
+      // Buckets are [-inf, 1), [1, 10) and [10, inf).
+      ASSERT_EQ(snapshot.bucket_counts, std::vector<uint64_t>({400, 3600, 4000}));
+    }
+  }
+}
+
+TEST(NativeExpositionTest, SkipsBusyPorts) {
+  ASSERT_EQ(stats::StartNativeExposition(0, 10), 0);
+  const int base_port = 43210;
+  // Hold the first port, as another process on the node would.
+  prometheus::Exposer busy("0.0.0.0:" + std::to_string(base_port));
+  ASSERT_EQ(stats::StartNativeExposition(base_port, 10), base_port + 1);
+  stats::StopNativeExposition();
+  ASSERT_EQ(stats::StartNativeExposition(base_port, 1), 0);
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
@@ -116,6 +116,92 @@ void LogEventReporter::Report(const rpc::Event &event, const json &custom_fields
   }
 }
 
+///
+/// AsyncEventReporter
+///
+AsyncEventReporter::AsyncEventReporter(std::shared_ptr<BaseEventReporter> reporter,
+                                       size_t max_queue_size)
+    : reporter_(std::move(reporter)), max_queue_size_(max_queue_size) {
+  thread_ = std::thread([this] { RunReporter(); });
+}
+
+AsyncEventReporter::~AsyncEventReporter() { Close(); }
+
+void AsyncEventReporter::Report(const rpc::Event &event, const json &custom_fields) {
+  const bool is_fatal = event.severity() == rpc::Event_Severity::Event_Severity_FATAL;
+  absl::MutexLock lock(&mutex_);
+  if (stopped_) {
+    return;
+  }
+  if (queue_.size() >= max_queue_size_ && !is_fatal) {
+    num_dropped_++;
+    return;
+  }
+  queue_.emplace_back(event, custom_fields);
+  const uint64_t seq = ++num_queued_;
+  queued_cv_.Signal();
+  // A fatal event raised by the background thread itself cannot be waited for.
+  if (!is_fatal || std::this_thread::get_id() == thread_.get_id()) {
+    return;
+  }
+  while (num_reported_ < seq && !stopped_) {
+    reported_cv_.Wait(&mutex_);
+  }
+}
+
+void AsyncEventReporter::Flush() {
+  absl::MutexLock lock(&mutex_);
+  const uint64_t seq = num_queued_;
+  while (num_reported_ < seq && !stopped_) {
+    reported_cv_.Wait(&mutex_);
+  }
+}
+
+void AsyncEventReporter::Close() {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (stopped_) {
+      return;
+    }
+    stopped_ = true;
+    queued_cv_.Signal();
+  }
+  thread_.join();
+  reporter_->Close();
+}
+
+uint64_t AsyncEventReporter::GetNumDroppedEvents() {
+  absl::MutexLock lock(&mutex_);
+  return num_dropped_;
+}
+
+void AsyncEventReporter::RunReporter() {
+  while (true) {
+    std::deque<std::pair<rpc::Event, json>> batch;
+    bool stopped;
+    {
+      absl::MutexLock lock(&mutex_);
+      while (queue_.empty() && !stopped_) {
+        queued_cv_.Wait(&mutex_);
+      }
+      batch.swap(queue_);
+      stopped = stopped_;
+    }
+    for (const auto &entry : batch) {
+      reporter_->Report(entry.first, entry.second);
+    }
+    reporter_->Flush();
+    {
+      absl::MutexLock lock(&mutex_);
+      num_reported_ += batch.size();
+      reported_cv_.SignalAll();
+    }
+    if (stopped) {
+      return;
+    }
+  }
+}
+
 ///
 /// EventManager
 ///
@@ -253,11 +339,19 @@ void RayEvent::SendMessage(const std::string &message) {
 
 void RayEventInit(rpc::Event_SourceType source_type,
                   const std::unordered_map<std::string, std::string> &custom_fields,
-                  const std::string &log_dir) {
+                  const std::string &log_dir, int64_t event_queue_size) {
   RayEventContext::Instance().SetEventContext(source_type, custom_fields);
   auto event_dir = boost::filesystem::path(log_dir) / boost::filesystem::path("event");
-  ray::EventManager::Instance().AddReporter(
-      std::make_shared<ray::LogEventReporter>(source_type, event_dir.string()));
+  if (event_queue_size > 0) {
+    // The background thread flushes once per batch instead of once per event.
+    ray::EventManager::Instance().AddReporter(std::make_shared<ray::AsyncEventReporter>(
+        std::make_shared<ray::LogEventReporter>(source_type, event_dir.string(),
+                                                /*force_flush=*/false),
+        event_queue_size));
+  } else {
+    ray::EventManager::Instance().AddReporter(
+        std::make_shared<ray::LogEventReporter>(source_type, event_dir.string()));
+  }
   RAY_LOG(INFO) << "Ray Event initialized for " << Event_SourceType_Name(source_type);
 }
 
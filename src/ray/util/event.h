@@ -17,11 +17,14 @@
 #include <boost/asio/ip/host_name.hpp>
 #include <cmath>
 #include <cstring>
+#include <deque>
 #include <iomanip>
 #include <iostream>
 #include <memory>
 #include <sstream>
+#include <thread>
 #include <vector>
+#include "absl/synchronization/mutex.h"
 #include "ray/util/logging.h"
 #include "ray/util/util.h"
 #include "spdlog/sinks/basic_file_sink.h"
@@ -49,6 +52,9 @@ class BaseEventReporter {
 
   virtual void Close() = 0;
 
+  /// Write out the reported events that are buffered.
+  virtual void Flush() {}
+
   virtual std::string GetReporterKey() = 0;
 };
 // responsible for writing event to specific file
@@ -71,7 +77,7 @@ class LogEventReporter : public BaseEventReporter {
 
   virtual void Close() override {}
 
-  virtual void Flush();
+  virtual void Flush() override;
 
   virtual std::string GetReporterKey() override { return "log.event.reporter"; }
 
@@ -86,6 +92,57 @@ class LogEventReporter : public BaseEventReporter {
   std::shared_ptr<spdlog::logger> log_sink_;
 };
 
+/// Reports events through another reporter from a background thread, so that the
+/// thread publishing an event does not wait for it to be written. Queued events are
+/// reported in batches, each followed by a single flush.
+///
+/// When the queue is full, new events are dropped and counted. Fatal events are always
+/// queued and waited for, since the process exits right after them.
+class AsyncEventReporter : public BaseEventReporter {
+ public:
+  /// \param reporter The reporter that writes the events.
+  /// \param max_queue_size Maximum number of events waiting to be reported.
+  AsyncEventReporter(std::shared_ptr<BaseEventReporter> reporter, size_t max_queue_size);
+
+  virtual ~AsyncEventReporter();
+
+  virtual void Init() override { reporter_->Init(); }
+
+  virtual void Report(const rpc::Event &event, const json &custom_fields) override;
+
+  /// Report the queued events, then stop the background thread and close the reporter.
+  virtual void Close() override;
+
+  /// Wait until the events queued so far are reported and flushed.
+  virtual void Flush() override;
+
+  virtual std::string GetReporterKey() override { return reporter_->GetReporterKey(); }
+
+  /// Return the number of events dropped because the queue was full.
+  uint64_t GetNumDroppedEvents();
+
+ private:
+  /// Report queued events in batches until the reporter is closed.
+  void RunReporter();
+
+  std::shared_ptr<BaseEventReporter> reporter_;
+  const size_t max_queue_size_;
+
+  absl::Mutex mutex_;
+  std::deque<std::pair<rpc::Event, json>> queue_ GUARDED_BY(mutex_);
+  /// Number of events queued and number of events reported and flushed so far.
+  uint64_t num_queued_ GUARDED_BY(mutex_) = 0;
+  uint64_t num_reported_ GUARDED_BY(mutex_) = 0;
+  uint64_t num_dropped_ GUARDED_BY(mutex_) = 0;
+  bool stopped_ GUARDED_BY(mutex_) = false;
+  /// Signaled when events are queued or the reporter is closed.
+  absl::CondVar queued_cv_;
+  /// Signaled when a batch of events is reported.
+  absl::CondVar reported_cv_;
+
+  std::thread thread_;
+};
+
 // store the reporters, add reporters and clean reporters
 class EventManager final {
  public:
@@ -224,8 +281,14 @@ class RayEvent {
   std::ostringstream osstream_;
 };
 
+/// Initialize the event framework for this process, reporting events to files under
+/// `log_dir`.
+///
+/// \param event_queue_size If positive, events are written by a background thread,
+/// and up to this many events wait to be written. Otherwise events are written by the
+/// thread that reports them.
 void RayEventInit(rpc::Event_SourceType source_type,
                   const std::unordered_map<std::string, std::string> &custom_fields,
-                  const std::string &log_dir);
+                  const std::string &log_dir, int64_t event_queue_size = 0);
 
 }  // namespace ray
@@ -18,4 +18,6 @@ namespace ray {
 
 #define EL_RAY_FATAL_CHECK_FAILED "RAY_FATAL_CHECK_FAILED"
 
+#define EL_RAY_EVENT_LOOP_STALLED "RAY_EVENT_LOOP_STALLED"
+
 }  // namespace ray
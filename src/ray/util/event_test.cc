@@ -17,6 +17,7 @@
 #include <boost/range.hpp>
 #include <csignal>
 #include <fstream>
+#include <future>
 #include <set>
 #include <thread>
 #include "gmock/gmock.h"
@@ -334,6 +335,87 @@ TEST(EVENT_TEST, LOG_MULTI_THREAD) {
   boost::filesystem::remove_all(log_dir.c_str());
 }
 
+TEST(EVENT_TEST, ASYNC_LOG) {
+  std::string log_dir = GenerateLogDir();
+
+  EventManager::Instance().ClearReporters();
+  RayEventContext::Instance().SetEventContext(
+      rpc::Event_SourceType::Event_SourceType_RAYLET,
+      std::unordered_map<std::string, std::string>(
+          {{"node_id", "node 1"}, {"job_id", "job 1"}, {"task_id", "task 1"}}));
+
+  auto reporter = std::make_shared<AsyncEventReporter>(
+      std::make_shared<LogEventReporter>(rpc::Event_SourceType::Event_SourceType_RAYLET,
+                                         log_dir, /*force_flush=*/false),
+      /*max_queue_size=*/10000);
+  EventManager::Instance().AddReporter(reporter);
+
+  int print_times = 1000;
+  for (int i = 1; i <= print_times; ++i) {
+    RAY_EVENT(INFO, "label " + std::to_string(i)) << "send message " + std::to_string(i);
+  }
+  reporter->Flush();
+
+  std::vector<std::string> vc;
+  ReadEventFromFile(vc, log_dir + "/event_RAYLET.log");
+
+  EXPECT_EQ((int)vc.size(), 1000);
+  EXPECT_EQ(reporter->GetNumDroppedEvents(), 0u);
+
+  // Events are written in the order they are reported.
+  for (int i = 0, len = vc.size(); i < print_times; ++i) {
+    json custom_fields;
+    rpc::Event ele = GetEventFromString(vc[len - print_times + i], &custom_fields);
+    CheckEventDetail(ele, "job 1", "node 1", "task 1", "RAYLET", "INFO",
+                     "label " + std::to_string(i + 1),
+                     "send message " + std::to_string(i + 1));
+  }
+
+  EventManager::Instance().ClearReporters();
+  boost::filesystem::remove_all(log_dir.c_str());
+}
+
+/// A reporter whose first report blocks until it is released.
+class BlockingEventReporter : public TestEventReporter {
+ public:
+  virtual void Report(const rpc::Event &event, const json &custom_fields) override {
+    if (!blocked_) {
+      blocked_ = true;
+      release_.get_future().wait();
+    }
+    TestEventReporter::Report(event, custom_fields);
+  }
+
+  void Release() { release_.set_value(); }
+
+ private:
+  bool blocked_ = false;
+  std::promise<void> release_;
+};
+
+TEST(EVENT_TEST, ASYNC_DROP_WHEN_FULL) {
+  TestEventReporter::event_list.clear();
+  EventManager::Instance().ClearReporters();
+  auto blocking_reporter = std::make_shared<BlockingEventReporter>();
+  auto reporter = std::make_shared<AsyncEventReporter>(blocking_reporter,
+                                                       /*max_queue_size=*/2);
+  EventManager::Instance().AddReporter(reporter);
+
+  // The background thread blocks on the first batch, of at most 2 events. Then 2 more
+  // events fill the queue, and the rest are dropped without blocking the caller.
+  int print_times = 13;
+  for (int i = 0; i < print_times; i++) {
+    RAY_EVENT(INFO, "label") << "message " << i;
+  }
+  EXPECT_GE(reporter->GetNumDroppedEvents(), static_cast<uint64_t>(print_times - 4));
+
+  blocking_reporter->Release();
+  reporter->Flush();
+  EXPECT_EQ(TestEventReporter::event_list.size() + reporter->GetNumDroppedEvents(),
+            static_cast<uint64_t>(print_times));
+  EventManager::Instance().ClearReporters();
+}
+
 TEST(EVENT_TEST, LOG_ROTATE) {
   std::string log_dir = GenerateLogDir();
 
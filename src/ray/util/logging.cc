@@ -27,11 +27,13 @@
 #endif
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 
+#include "spdlog/async.h"
 #include "spdlog/sinks/basic_file_sink.h"
 #include "spdlog/sinks/rotating_file_sink.h"
 #include "spdlog/sinks/stdout_color_sinks.h"
@@ -54,6 +56,9 @@ std::string RayLog::log_format_pattern_ = "[%Y-%m-%d %H:%M:%S,%e %L %P %t] %v";
 std::string RayLog::logger_name_ = "ray_log_sink";
 long RayLog::log_rotation_max_size_ = 1 << 29;
 long RayLog::log_rotation_file_num_ = 10;
+long RayLog::log_async_queue_size_ = 0;
+std::atomic<bool> RayLog::is_async_logging_enabled_(false);
+std::atomic<uint64_t> RayLog::num_suppressed_logs_(0);
 bool RayLog::is_failure_signal_handler_installed_ = false;
 
 std::string GetCallTrace() {
@@ -126,7 +131,15 @@ class SpdLogMessage final {
     // NOTE(lingxuan.zlx): See more fmt by visiting https://github.com/fmtlib/fmt.
     logger->log(static_cast<spdlog::level::level_enum>(loglevel_), /*fmt*/ "{}",
                 str_.str());
-    logger->flush();
+    if (!RayLog::IsAsyncLoggingEnabled()) {
+      logger->flush();
+    } else if (loglevel_ == static_cast<int>(spdlog::level::critical)) {
+      // The process exits right after a fatal log, so wait until it is written.
+      RayLog::DrainAsyncLogs();
+    } else if (loglevel_ >= static_cast<int>(spdlog::level::err)) {
+      // Queue a flush, so errors reach the file without waiting for the periodic flush.
+      logger->flush();
+    }
   }
 
   ~SpdLogMessage() { Flush(); }
@@ -233,6 +246,9 @@ void RayLog::StartRayLog(const std::string &app_name, RayLogLevel severity_thres
         log_rotation_file_num_ = file_num;
       }
     }
+    if (getenv("RAY_BACKEND_LOG_ASYNC_QUEUE_SIZE")) {
+      log_async_queue_size_ = std::atol(getenv("RAY_BACKEND_LOG_ASYNC_QUEUE_SIZE"));
+    }
     spdlog::set_pattern(log_format_pattern_);
     spdlog::set_level(static_cast<spdlog::level::level_enum>(severity_threshold_));
     // Sink all log stuff to default file logger we defined here. We may need
@@ -243,10 +259,23 @@ void RayLog::StartRayLog(const std::string &app_name, RayLogLevel severity_thres
       // logger.
       spdlog::drop(RayLog::GetLoggerName());
     }
-    file_logger = spdlog::rotating_logger_mt(
-        RayLog::GetLoggerName(),
-        dir_ends_with_slash + app_name_without_path + "_" + std::to_string(pid) + ".log",
-        log_rotation_max_size_, log_rotation_file_num_);
+    const std::string log_file_name =
+        dir_ends_with_slash + app_name_without_path + "_" + std::to_string(pid) + ".log";
+    if (log_async_queue_size_ > 0) {
+      // Records are written and rotated by a background thread. When the queue is
+      // full, e.g. because the disk stalls, the oldest records are dropped instead of
+      // blocking the caller.
+      spdlog::init_thread_pool(log_async_queue_size_, /*threads_n=*/1);
+      file_logger = spdlog::create_async_nb<spdlog::sinks::rotating_file_sink_mt>(
+          RayLog::GetLoggerName(), log_file_name, log_rotation_max_size_,
+          log_rotation_file_num_);
+      spdlog::flush_every(std::chrono::seconds(1));
+      is_async_logging_enabled_ = true;
+    } else {
+      file_logger = spdlog::rotating_logger_mt(RayLog::GetLoggerName(), log_file_name,
+                                               log_rotation_max_size_,
+                                               log_rotation_file_num_);
+    }
     spdlog::set_default_logger(file_logger);
   } else {
     auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
@@ -289,7 +318,9 @@ void RayLog::UninstallSignalAction() {
 
 void RayLog::ShutDownRayLog() {
   UninstallSignalAction();
-  if (spdlog::default_logger()) {
+  if (is_async_logging_enabled_) {
+    DrainAsyncLogs();
+  } else if (spdlog::default_logger()) {
     spdlog::default_logger()->flush();
   }
   // NOTE(lingxuan.zlx) All loggers will be closed in shutdown but we don't need drop
@@ -308,7 +339,9 @@ void WriteFailureMessage(const char *data) {
   // If logger writes logs to files, logs are fully-buffered, which is different from
   // stdout (line-buffered) and stderr (unbuffered). So always flush here in case logs are
   // lost when logger writes logs to files.
-  if (spdlog::default_logger()) {
+  if (RayLog::IsAsyncLoggingEnabled()) {
+    RayLog::DrainAsyncLogs();
+  } else if (spdlog::default_logger()) {
     spdlog::default_logger()->flush();
   }
 }
@@ -337,6 +370,51 @@ bool RayLog::IsLevelEnabled(RayLogLevel log_level) {
   return log_level >= severity_threshold_;
 }
 
+bool RayLog::IsAsyncLoggingEnabled() { return is_async_logging_enabled_; }
+
+void RayLog::DrainAsyncLogs() {
+  if (!is_async_logging_enabled_.exchange(false)) {
+    return;
+  }
+  // Shutting down spdlog joins the background thread once it has written all the
+  // queued records. Later logs go to stderr.
+  spdlog::shutdown();
+}
+
+uint64_t RayLog::GetNumSuppressedLogs() { return num_suppressed_logs_; }
+
+void RayLog::AddSuppressedLogs(uint64_t count) { num_suppressed_logs_ += count; }
+
+LogRateLimiter::LogRateLimiter(double per_second, int64_t burst)
+    : per_second_(per_second),
+      burst_(std::max<int64_t>(burst, 1)),
+      tokens_(burst_),
+      last_refill_(std::chrono::steady_clock::now()) {}
+
+bool LogRateLimiter::Acquire(uint64_t *suppressed) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto now = std::chrono::steady_clock::now();
+  const std::chrono::duration<double> elapsed = now - last_refill_;
+  last_refill_ = now;
+  tokens_ = std::min(burst_, tokens_ + elapsed.count() * per_second_);
+  if (tokens_ < 1) {
+    suppressed_++;
+    RayLog::AddSuppressedLogs(1);
+    return false;
+  }
+  tokens_ -= 1;
+  *suppressed = suppressed_;
+  suppressed_ = 0;
+  return true;
+}
+
+std::ostream &operator<<(std::ostream &os, const SuppressedLogs &suppressed_logs) {
+  if (suppressed_logs.count > 0) {
+    os << "[" << suppressed_logs.count << " similar messages suppressed] ";
+  }
+  return os;
+}
+
 std::string RayLog::GetLogFormatPattern() { return log_format_pattern_; }
 
 std::string RayLog::GetLoggerName() { return logger_name_; }
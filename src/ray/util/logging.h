@@ -54,6 +54,7 @@
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -173,6 +174,21 @@ enum class RayLogLevel {
       RAY_LOG_TIME_DELTA > RAY_LOG_TIME_PERIOD)                                          \
   RAY_LOG_INTERNAL(ray::RayLogLevel::level)
 
+/// Macros for RAY_LOG_RATE_LIMITED
+#define RAY_LOG_RATE_LIMITER RAY_LOG_EVERY_N_VARNAME(rateLimiter_, __LINE__)
+#define RAY_LOG_SUPPRESSED RAY_LOG_EVERY_N_VARNAME(suppressed_, __LINE__)
+
+// Rate limited logging, for hot paths that flood the logs during incidents. Log up to
+// `burst` messages at once, and `per_second` messages per second on average. A logged
+// message is prefixed with the number of messages suppressed before it.
+#define RAY_LOG_RATE_LIMITED(level, per_second, burst)                \
+  static ray::LogRateLimiter RAY_LOG_RATE_LIMITER(per_second, burst); \
+  uint64_t RAY_LOG_SUPPRESSED = 0;                                    \
+  if (ray::RayLog::IsLevelEnabled(ray::RayLogLevel::level) &&         \
+      RAY_LOG_RATE_LIMITER.Acquire(&RAY_LOG_SUPPRESSED))              \
+  RAY_LOG_INTERNAL(ray::RayLogLevel::level)                           \
+      << ray::SuppressedLogs{RAY_LOG_SUPPRESSED}
+
 // To make the logging lib plugable with other logging libs and make
 // the implementation unawared by the user, RayLog is only a declaration
 // which hide the implementation into logging.cc file.
@@ -210,6 +226,37 @@ class RayLogBase {
 /// The second argument: log content.
 using FatalLogCallback = std::function<void(const std::string &, const std::string &)>;
 
+/// A token bucket that limits how often a log site is logged. This class is thread
+/// safe.
+class LogRateLimiter {
+ public:
+  /// \param per_second The number of messages logged per second on average.
+  /// \param burst The number of messages that can be logged at once.
+  LogRateLimiter(double per_second, int64_t burst);
+
+  /// Take a token for a message.
+  ///
+  /// \param[out] suppressed Set to the number of messages suppressed since the last
+  /// logged one, if the message should be logged.
+  /// \return Whether the message should be logged.
+  bool Acquire(uint64_t *suppressed);
+
+ private:
+  std::mutex mutex_;
+  const double per_second_;
+  const double burst_;
+  double tokens_;
+  std::chrono::steady_clock::time_point last_refill_;
+  uint64_t suppressed_ = 0;
+};
+
+/// Prefix of a rate limited message, when messages were suppressed before it.
+struct SuppressedLogs {
+  uint64_t count;
+};
+
+std::ostream &operator<<(std::ostream &os, const SuppressedLogs &suppressed_logs);
+
 class RayLog : public RayLogBase {
  public:
   RayLog(const char *file_name, int line_number, RayLogLevel severity);
@@ -253,6 +300,22 @@ class RayLog : public RayLogBase {
   /// Get the log level from environment variable.
   static RayLogLevel GetLogLevelFromEnv();
 
+  /// Return whether logs are written to the log file by a background thread. This is
+  /// enabled by setting the environment variable RAY_BACKEND_LOG_ASYNC_QUEUE_SIZE to
+  /// the number of records that can be queued.
+  static bool IsAsyncLoggingEnabled();
+
+  /// Wait until the background thread has written all the queued logs, and switch
+  /// back to synchronous logging to stderr.
+  static void DrainAsyncLogs();
+
+  /// Return the number of messages suppressed by rate limited logging in this
+  /// process.
+  static uint64_t GetNumSuppressedLogs();
+
+  /// Count messages suppressed by rate limited logging.
+  static void AddSuppressedLogs(uint64_t count);
+
   static std::string GetLogFormatPattern();
 
   static std::string GetLoggerName();
@@ -293,6 +356,12 @@ class RayLog : public RayLogBase {
   static long log_rotation_max_size_;
   // Log rotation file number.
   static long log_rotation_file_num_;
+  // Number of records queued for the background thread, 0 to log synchronously.
+  static long log_async_queue_size_;
+  // Whether logs are currently written by the background thread.
+  static std::atomic<bool> is_async_logging_enabled_;
+  // Number of messages suppressed by rate limited logging.
+  static std::atomic<uint64_t> num_suppressed_logs_;
   // Ray default logger name.
   static std::string logger_name_;
 
@@ -14,9 +14,16 @@
 
 #include "ray/util/logging.h"
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 #include <chrono>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <thread>
 
 #include "absl/strings/str_format.h"
 #include "gmock/gmock.h"
@@ -186,8 +193,44 @@ TEST(PrintLogTest, TestRayLogEveryMs) {
   EXPECT_LT(occurrences, 15);
 }
 
+TEST(PrintLogTest, TestRayLogRateLimited) {
+  const uint64_t num_suppressed_logs = RayLog::GetNumSuppressedLogs();
+  CaptureStderr();
+  const std::string kLogStr = "this is a rate limited log";
+  for (int i = 0; i < 100; i++) {
+    RAY_LOG_RATE_LIMITED(INFO, 0.001, 5) << kLogStr;
+  }
+  std::string output = GetCapturedStderr();
+  size_t occurrences = 0;
+  std::string::size_type start = 0;
+  while ((start = output.find(kLogStr, start)) != std::string::npos) {
+    ++occurrences;
+    start += kLogStr.length();
+  }
+  // Only the burst is logged, the rest is counted.
+  EXPECT_EQ(occurrences, 5);
+  EXPECT_EQ(RayLog::GetNumSuppressedLogs() - num_suppressed_logs, 95);
+}
+
 #endif /* GTEST_HAS_STREAM_REDIRECTION */
 
+TEST(PrintLogTest, TestLogRateLimiter) {
+  LogRateLimiter limiter(/*per_second=*/1000, /*burst=*/2);
+  uint64_t suppressed = 0;
+  ASSERT_TRUE(limiter.Acquire(&suppressed));
+  ASSERT_TRUE(limiter.Acquire(&suppressed));
+  ASSERT_FALSE(limiter.Acquire(&suppressed));
+  ASSERT_FALSE(limiter.Acquire(&suppressed));
+  // Tokens are refilled over time, and the next logged message reports the messages
+  // suppressed before it.
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  ASSERT_TRUE(limiter.Acquire(&suppressed));
+  ASSERT_EQ(suppressed, 2);
+  std::ostringstream prefix;
+  prefix << SuppressedLogs{suppressed};
+  ASSERT_EQ(prefix.str(), "[2 similar messages suppressed] ");
+}
+
 TEST(PrintLogTest, LogTestWithInit) {
   // Test empty app name.
   RayLog::StartRayLog("", RayLogLevel::DEBUG, ray::GetUserTempDir() + ray::GetDirSep());
@@ -195,6 +238,31 @@ TEST(PrintLogTest, LogTestWithInit) {
   RayLog::ShutDownRayLog();
 }
 
+#ifndef _WIN32
+TEST(PrintLogTest, AsyncLogTest) {
+  setenv("RAY_BACKEND_LOG_ASYNC_QUEUE_SIZE", "1024", 1);
+  const std::string log_dir = ray::GetUserTempDir() + ray::GetDirSep();
+  RayLog::StartRayLog("AsyncLogTest", RayLogLevel::INFO, log_dir);
+  unsetenv("RAY_BACKEND_LOG_ASYNC_QUEUE_SIZE");
+  ASSERT_TRUE(RayLog::IsAsyncLoggingEnabled());
+  for (int i = 0; i < 100; i++) {
+    RAY_LOG(INFO) << "Async log message " << i;
+  }
+  RayLog::ShutDownRayLog();
+  ASSERT_FALSE(RayLog::IsAsyncLoggingEnabled());
+
+  // All the queued messages are written once the logs are drained.
+  const std::string log_file =
+      log_dir + "AsyncLogTest_" + std::to_string(getpid()) + ".log";
+  std::ifstream file(log_file);
+  std::stringstream content;
+  content << file.rdbuf();
+  EXPECT_THAT(content.str(), HasSubstr("Async log message 0"));
+  EXPECT_THAT(content.str(), HasSubstr("Async log message 99"));
+  std::remove(log_file.c_str());
+}
+#endif
+
 // This test will output large amount of logs to stderr, should be disabled in travis.
 TEST(LogPerfTest, PerfTest) {
   RayLog::StartRayLog("/fake/path/to/appdire/LogPerfTest", RayLogLevel::ERROR,
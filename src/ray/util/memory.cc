@@ -14,12 +14,141 @@
 
 #include "ray/util/memory.h"
 
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RAY_HAS_STREAMING_STORES
+#endif
+
+#include <algorithm>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
 #include <thread>
 #include <vector>
 
 namespace ray {
 
+namespace {
+
+/// A pool of threads that parallel_memcopy reuses, so that a copy doesn't pay for
+/// starting and joining threads.
+class MemcopyThreadPool {
+ public:
+  /// The pool of this process. It is never destroyed, so that copies from threads
+  /// that outlive static destructors still work.
+  static MemcopyThreadPool &Instance() {
+    static std::mutex mutex;
+    static MemcopyThreadPool *pool = nullptr;
+    std::lock_guard<std::mutex> lock(mutex);
+    // The threads of the parent don't exist in a forked child, start new ones.
+    if (pool == nullptr || pool->pid_ != getpid()) {
+      pool = new MemcopyThreadPool();
+    }
+    return *pool;
+  }
+
+  /// Run the tasks on the pool, and wait for them to finish. The calling thread
+  /// runs the first task itself.
+  void Run(std::vector<std::function<void()>> &tasks) {
+    if (tasks.empty()) {
+      return;
+    }
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+    size_t num_pending = tasks.size() - 1;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      while (threads_.size() < tasks.size() - 1) {
+        threads_.emplace_back([this]() { Work(); });
+        threads_.back().detach();
+      }
+      for (size_t i = 1; i < tasks.size(); i++) {
+        auto &task = tasks[i];
+        queue_.push_back([&task, &done_mutex, &done_cv, &num_pending]() {
+          task();
+          std::lock_guard<std::mutex> done_lock(done_mutex);
+          if (--num_pending == 0) {
+            done_cv.notify_one();
+          }
+        });
+      }
+    }
+    cv_.notify_all();
+    tasks[0]();
+    std::unique_lock<std::mutex> done_lock(done_mutex);
+    done_cv.wait(done_lock, [&num_pending]() { return num_pending == 0; });
+  }
+
+ private:
+  MemcopyThreadPool() : pid_(getpid()) {}
+
+  void Work() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return !queue_.empty(); });
+        task = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      task();
+    }
+  }
+
+  const int pid_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> queue_;
+  std::vector<std::thread> threads_;
+};
+
+/// Copy with stores that bypass the cache. The destination of a large copy doesn't
+/// fit in the cache anyway, and this saves reading it into the cache before it is
+/// overwritten.
+void streaming_memcopy(uint8_t *dst, const uint8_t *src, size_t nbytes) {
+#ifdef RAY_HAS_STREAMING_STORES
+  // Streaming stores need a 16 byte aligned destination.
+  const size_t head =
+      std::min<size_t>((16 - reinterpret_cast<uintptr_t>(dst) % 16) % 16, nbytes);
+  std::memcpy(dst, src, head);
+  dst += head;
+  src += head;
+  nbytes -= head;
+  const size_t body = nbytes - nbytes % 64;
+  for (size_t i = 0; i < body; i += 64) {
+    const __m128i *from = reinterpret_cast<const __m128i *>(src + i);
+    __m128i *to = reinterpret_cast<__m128i *>(dst + i);
+    __m128i a = _mm_loadu_si128(from);
+    __m128i b = _mm_loadu_si128(from + 1);
+    __m128i c = _mm_loadu_si128(from + 2);
+    __m128i d = _mm_loadu_si128(from + 3);
+    _mm_stream_si128(to, a);
+    _mm_stream_si128(to + 1, b);
+    _mm_stream_si128(to + 2, c);
+    _mm_stream_si128(to + 3, d);
+  }
+  std::memcpy(dst + body, src + body, nbytes - body);
+  // Make the streaming stores visible to other threads before returning.
+  _mm_sfence();
+#else
+  std::memcpy(dst, src, nbytes);
+#endif
+}
+
+void plain_memcopy(uint8_t *dst, const uint8_t *src, size_t nbytes) {
+  std::memcpy(dst, src, nbytes);
+}
+
+}  // namespace
+
 uint8_t *pointer_logical_and(const uint8_t *address, uintptr_t bits) {
   uintptr_t value = reinterpret_cast<uintptr_t>(address);
   return reinterpret_cast<uint8_t *>(value & bits);
@@ -27,7 +156,12 @@ uint8_t *pointer_logical_and(const uint8_t *address, uintptr_t bits) {
 
 void parallel_memcopy(uint8_t *dst, const uint8_t *src, int64_t nbytes,
                       uintptr_t block_size, int num_threads) {
-  std::vector<std::thread> threadpool(num_threads);
+  auto copy = nbytes >= kStreamingMemcopyThreshold ? streaming_memcopy : plain_memcopy;
+  if (nbytes < static_cast<int64_t>(2 * block_size * num_threads)) {
+    // Too small to split into aligned chunks.
+    copy(dst, src, nbytes);
+    return;
+  }
   uint8_t *left = pointer_logical_and(src + block_size - 1, ~(block_size - 1));
   uint8_t *right = pointer_logical_and(src + nbytes, ~(block_size - 1));
   int64_t num_blocks = (right - left) / block_size;
@@ -45,20 +179,20 @@ void parallel_memcopy(uint8_t *dst, const uint8_t *src, int64_t nbytes,
   // | prefix | num_threads * chunk_size | suffix |.
   // Each thread gets a "chunk" of k blocks.
 
-  // Start all threads first and handle leftovers while threads run.
-  for (int i = 0; i < num_threads; i++) {
-    threadpool[i] = std::thread(std::memcpy, dst + prefix + i * chunk_size,
-                                left + i * chunk_size, chunk_size);
-  }
-
-  std::memcpy(dst, src, prefix);
-  std::memcpy(dst + prefix + num_threads * chunk_size, right, suffix);
-
-  for (auto &t : threadpool) {
-    if (t.joinable()) {
-      t.join();
-    }
+  // The calling thread copies the leftovers along with the first chunk.
+  std::vector<std::function<void()>> tasks;
+  tasks.reserve(num_threads);
+  tasks.emplace_back([=]() {
+    copy(dst, src, prefix);
+    copy(dst + prefix + num_threads * chunk_size, right, suffix);
+    copy(dst + prefix, left, chunk_size);
+  });
+  for (int i = 1; i < num_threads; i++) {
+    tasks.emplace_back([=]() {
+      copy(dst + prefix + i * chunk_size, left + i * chunk_size, chunk_size);
+    });
   }
+  MemcopyThreadPool::Instance().Run(tasks);
 }
 
 }  // namespace ray
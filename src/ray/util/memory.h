@@ -18,8 +18,13 @@
 
 namespace ray {
 
+// Copies of at least this many bytes use stores that bypass the cache.
+constexpr int64_t kStreamingMemcopyThreshold = 8 * 1024 * 1024;
+
 // A helper function for doing memcpy with multiple threads. This is required
-// to saturate the memory bandwidth of modern cpus.
+// to saturate the memory bandwidth of modern cpus. The threads are kept in a
+// pool across calls. Large copies use non-temporal stores where available, so
+// that they don't evict the working set of the process from the cache.
 void parallel_memcopy(uint8_t *dst, const uint8_t *src, int64_t nbytes,
                       uintptr_t block_size, int num_threads);
 
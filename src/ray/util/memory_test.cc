@@ -0,0 +1,90 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/util/memory.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+namespace {
+void CheckCopy(int64_t nbytes, size_t src_offset, size_t dst_offset, int num_threads) {
+  std::vector<uint8_t> src(nbytes + src_offset);
+  for (size_t i = 0; i < src.size(); i++) {
+    src[i] = static_cast<uint8_t>(i * 31 + 7);
+  }
+  std::vector<uint8_t> dst(nbytes + dst_offset + 1, 0);
+  parallel_memcopy(dst.data() + dst_offset, src.data() + src_offset, nbytes,
+                   /*block_size=*/64, num_threads);
+  ASSERT_EQ(std::memcmp(dst.data() + dst_offset, src.data() + src_offset, nbytes), 0)
+      << nbytes << " bytes, offsets " << src_offset << " and " << dst_offset;
+  // Nothing is written past the end.
+  ASSERT_EQ(dst.back(), 0);
+}
+}  // namespace
+
+TEST(ParallelMemcopyTest, TestSizesAndAlignments) {
+  for (int64_t nbytes : {int64_t(0), int64_t(1), int64_t(1000), int64_t(1 << 20) + 3,
+                         kStreamingMemcopyThreshold + 77}) {
+    for (size_t offset : {0, 1, 15}) {
+      CheckCopy(nbytes, offset, 15 - offset, /*num_threads=*/4);
+    }
+  }
+}
+
+TEST(ParallelMemcopyTest, TestConcurrentCopies) {
+  // Copies from several threads share the pool.
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([i]() {
+      for (int j = 0; j < 10; j++) {
+        CheckCopy((int64_t(1) << 20) + i, i, j, /*num_threads=*/1 + i);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+// Reports the copy bandwidth, see memory_perf_test.
+TEST(ParallelMemcopyTest, PerfTest) {
+  const int64_t nbytes = int64_t(1) << 30;
+  std::vector<uint8_t> src(nbytes, 1);
+  std::vector<uint8_t> dst(nbytes, 0);
+  for (int num_threads : {1, 2, 4, 6, 8}) {
+    double best_s = 0;
+    for (int i = 0; i < 3; i++) {
+      auto start = std::chrono::steady_clock::now();
+      parallel_memcopy(dst.data(), src.data(), nbytes, /*block_size=*/64, num_threads);
+      double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+                     .count();
+      best_s = i == 0 ? s : std::min(best_s, s);
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::memcpy(dst.data(), src.data(), nbytes);
+    double memcpy_s =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << num_threads << " threads: " << nbytes / best_s / 1e9
+              << " GB/s, memcpy: " << nbytes / memcpy_s / 1e9 << " GB/s" << std::endl;
+  }
+}
+
+}  // namespace ray
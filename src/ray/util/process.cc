@@ -22,8 +22,10 @@
 #include <Winternl.h>
 #include <process.h>
 #else
+#include <fcntl.h>
 #include <poll.h>
 #include <signal.h>
+#include <spawn.h>
 #include <stddef.h>
 #include <sys/types.h>
 #include <sys/wait.h>
@@ -60,6 +62,34 @@ int execvpe(const char *program, char *const argv[], char *const envp[]) {
 
 namespace ray {
 
+namespace {
+
+std::atomic<bool> use_posix_spawn(false);
+
+/// The innermost spawn batch of this thread.
+thread_local ProcessSpawnBatch *current_spawn_batch = nullptr;
+
+ProcessEnvironment ReadParentEnvironment() {
+  ProcessEnvironment env;
+  for (char *const *e = environ; *e; ++e) {
+    RAY_CHECK(*e && **e != '\0') << "environment variable name is absent";
+    const char *key_end = strchr(*e + 1 /* +1 is needed for Windows */, '=');
+    RAY_CHECK(key_end) << "environment variable value is absent: " << e;
+    env[std::string(*e, static_cast<size_t>(key_end - *e))] = key_end + 1;
+  }
+  return env;
+}
+
+}  // namespace
+
+ProcessSpawnBatch::ProcessSpawnBatch()
+    : outer_(current_spawn_batch),
+      parent_env_(outer_ != nullptr ? outer_->parent_env_ : ReadParentEnvironment()) {
+  current_spawn_batch = this;
+}
+
+ProcessSpawnBatch::~ProcessSpawnBatch() { current_spawn_batch = outer_; }
+
 bool EnvironmentVariableLess::operator()(char a, char b) const {
   // TODO(mehrdadn): This is only used on Windows due to current lack of Unicode support.
   // It should be changed when Process adds Unicode support on Windows.
@@ -100,13 +130,9 @@ class ProcessFD {
     ec = std::error_code();
     intptr_t fd;
     pid_t pid;
-    ProcessEnvironment new_env;
-    for (char *const *e = environ; *e; ++e) {
-      RAY_CHECK(*e && **e != '\0') << "environment variable name is absent";
-      const char *key_end = strchr(*e + 1 /* +1 is needed for Windows */, '=');
-      RAY_CHECK(key_end) << "environment variable value is absent: " << e;
-      new_env[std::string(*e, static_cast<size_t>(key_end - *e))] = key_end + 1;
-    }
+    ProcessEnvironment new_env = current_spawn_batch != nullptr
+                                     ? current_spawn_batch->parent_env_
+                                     : ReadParentEnvironment();
     for (const auto &item : env) {
       new_env[item.first] = item.second;
     }
@@ -163,12 +189,23 @@ class ProcessFD {
     new_env_ptrs.push_back(static_cast<char *>(NULL));
     char **envp = &new_env_ptrs[0];
 
-    // TODO(mehrdadn): Use clone() on Linux or posix_spawnp() on Mac to avoid duplicating
-    // file descriptors into the child process, as that can be problematic.
+    // TODO(mehrdadn): Avoid duplicating file descriptors into the child process, as that
+    // can be problematic.
     int pipefds[2];  // Create pipe to get PID & track lifetime
     if (pipe(pipefds) == -1) {
       pipefds[0] = pipefds[1] = -1;
     }
+    if (!decouple && use_posix_spawn.load(std::memory_order_relaxed)) {
+      pid = -1;
+      if (pipefds[0] != -1) {
+        pid = SpawnWithoutFork(argv, envp, pipefds);
+      }
+      fd = pipefds[0];
+      if (pid == -1) {
+        ec = std::error_code(errno, std::system_category());
+      }
+      return ProcessFD(pid, fd);
+    }
     pid = pipefds[1] != -1 ? fork() : -1;
     if (pid <= 0 && pipefds[0] != -1) {
       close(pipefds[0]);  // not the parent, so close the read end of the pipe
@@ -210,6 +247,43 @@ class ProcessFD {
 #endif
     return ProcessFD(pid, fd);
   }
+
+#ifndef _WIN32
+  /// Start a process with posix_spawnp(), which uses vfork() or clone(CLONE_VM |
+  /// CLONE_VFORK) where available, so the page tables of this process aren't copied.
+  /// The child inherits the write end of the pipe, to track its lifetime, and the
+  /// write end is closed here. On failure, the read end is closed as well.
+  /// \return The pid of the child, or -1 with errno set on failure.
+  static pid_t SpawnWithoutFork(const char *argv[], char **envp, int pipefds[2]) {
+    // Only the child holds the write end, so the read end sees EOF when it exits.
+    (void)fcntl(pipefds[0], F_SETFD, FD_CLOEXEC);
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    // The child starts with the default SIGCHLD handler, as in the fork() path.
+    sigset_t default_signals;
+    sigemptyset(&default_signals);
+    sigaddset(&default_signals, SIGCHLD);
+    posix_spawnattr_setsigdefault(&attr, &default_signals);
+    short flags = POSIX_SPAWN_SETSIGDEF;
+#ifdef POSIX_SPAWN_USEVFORK
+    flags |= POSIX_SPAWN_USEVFORK;
+#endif
+    posix_spawnattr_setflags(&attr, flags);
+    pid_t pid;
+    int error = posix_spawnp(&pid, argv[0], nullptr, &attr,
+                             const_cast<char *const *>(argv), envp);
+    posix_spawnattr_destroy(&attr);
+    close(pipefds[1]);
+    pipefds[1] = -1;
+    if (error != 0) {
+      close(pipefds[0]);
+      pipefds[0] = -1;
+      errno = error;
+      return -1;
+    }
+    return pid;
+  }
+#endif
 };
 
 ProcessFD::~ProcessFD() {
@@ -336,6 +410,10 @@ Process &Process::operator=(Process other) {
 
 Process::Process(pid_t pid) { p_ = std::make_shared<ProcessFD>(pid); }
 
+void Process::SetUsePosixSpawn(bool use) {
+  use_posix_spawn.store(use, std::memory_order_relaxed);
+}
+
 Process::Process(const char *argv[], void *io_service, std::error_code &ec, bool decouple,
                  const ProcessEnvironment &env) {
   (void)io_service;
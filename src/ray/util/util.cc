@@ -19,9 +19,14 @@
 #ifndef _WIN32
 #include <sys/un.h>
 #endif
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 #include <algorithm>
 #include <boost/asio/generic/stream_protocol.hpp>
+#include <fstream>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -376,3 +381,59 @@ std::shared_ptr<std::unordered_map<std::string, std::string>> ParseURL(std::stri
   result->emplace(key_value_pair.first, key_value_pair.second);
   return result;
 }
+
+bool ParseCpuList(const std::string &cpu_list, std::vector<int> *cpus) {
+  std::stringstream stream(cpu_list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+    if (item.empty()) {
+      continue;
+    }
+    if (item.compare(0, 4, "node") == 0) {
+      std::ifstream node_file("/sys/devices/system/node/" + item + "/cpulist");
+      std::string node_cpu_list;
+      if (item.size() == 4 ||
+          item.find_first_not_of("0123456789", 4) != std::string::npos ||
+          !std::getline(node_file, node_cpu_list) ||
+          !ParseCpuList(node_cpu_list, cpus)) {
+        return false;
+      }
+      continue;
+    }
+    if (item.find_first_not_of("0123456789-") != std::string::npos) {
+      return false;
+    }
+    int first = -1;
+    int last = -1;
+    int num_parsed = sscanf(item.c_str(), "%d-%d", &first, &last);
+    if (num_parsed == 1 && item.find('-') == std::string::npos) {
+      last = first;
+    } else if (num_parsed != 2) {
+      return false;
+    }
+    if (first < 0 || last < first) {
+      return false;
+    }
+    for (int cpu = first; cpu <= last; cpu++) {
+      cpus->push_back(cpu);
+    }
+  }
+  return true;
+}
+
+bool SetThreadAffinity(const std::vector<int> &cpus) {
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    if (cpu >= CPU_SETSIZE) {
+      return false;
+    }
+    CPU_SET(cpu, &cpu_set);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+  return false;
+#endif
+}
@@ -135,6 +135,19 @@ ParseUrlEndpoint(const std::string &endpoint, int default_port = 0);
 /// }
 std::shared_ptr<std::unordered_map<std::string, std::string>> ParseURL(std::string url);
 
+/// Parse a list of CPUs in the Linux cpulist format, such as "0-3,8,10-11". An item
+/// can also be "node<N>", which stands for all the CPUs of NUMA node N.
+///
+/// \param cpu_list The list to parse.
+/// \param[out] cpus The CPUs of the list, in the order they appear.
+/// \return false if the list is malformed or names an unknown NUMA node.
+bool ParseCpuList(const std::string &cpu_list, std::vector<int> *cpus);
+
+/// Restrict the calling thread to run on the given CPUs. Only supported on Linux.
+///
+/// \return false if it is not supported, or the kernel rejects the CPUs.
+bool SetThreadAffinity(const std::vector<int> &cpus);
+
 class InitShutdownRAII {
  public:
   /// Type of the Shutdown function.
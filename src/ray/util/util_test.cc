@@ -111,6 +111,18 @@ TEST(UtilTest, ParseURLTest) {
   ASSERT_EQ(parsed_url["size"], "8388878");
 }
 
+TEST(UtilTest, ParseCpuListTest) {
+  std::vector<int> cpus;
+  ASSERT_TRUE(ParseCpuList("0-2, 5,7-7", &cpus));
+  ASSERT_EQ(cpus, std::vector<int>({0, 1, 2, 5, 7}));
+  cpus.clear();
+  ASSERT_TRUE(ParseCpuList("", &cpus));
+  ASSERT_TRUE(cpus.empty());
+  for (const auto &invalid : {"1-", "-1", "3-1", "5x", "node", "nodex", "node99999"}) {
+    ASSERT_FALSE(ParseCpuList(invalid, &cpus)) << invalid;
+  }
+}
+
 TEST(UtilTest, CreateCommandLineTest) {
   typedef std::vector<std::string> ArgList;
   CommandLineSyntax posix = CommandLineSyntax::POSIX, win32 = CommandLineSyntax::Windows,
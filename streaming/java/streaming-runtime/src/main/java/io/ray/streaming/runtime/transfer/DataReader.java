@@ -247,13 +247,14 @@ public class DataReader {
 
     // kMessageBundleHeaderSize + kUniqueIDSize:
     // magicNum(4b) + bundleTs(8b) + lastMessageId(8b) + messageListSize(4b)
-    // + bundleType(4b) + rawBundleSize(4b) + channelID
-    static final int LENGTH = 4 + 8 + 8 + 4 + 4 + 4 + ChannelId.ID_LENGTH;
+    // + bundleType(4b) + watermark(8b) + rawBundleSize(4b) + channelID
+    static final int LENGTH = 4 + 8 + 8 + 4 + 4 + 8 + 4 + ChannelId.ID_LENGTH;
     private int magicNum;
     private long bundleTs;
     private long lastMessageId;
     private int messageListSize;
     private DataBundleType bundleType;
+    private long watermark;
     private String channelID;
     private int rawBundleSize;
 
@@ -274,6 +275,7 @@ public class DataReader {
       } else {
         bundleType = DataBundleType.EMPTY;
       }
+      watermark = buffer.getLong();
       // rawBundleSize
       rawBundleSize = buffer.getInt();
       channelID = getQueueIdString(buffer);
@@ -299,6 +301,10 @@ public class DataReader {
       return bundleType;
     }
 
+    public long getWatermark() {
+      return watermark;
+    }
+
     public String getChannelID() {
       return channelID;
     }
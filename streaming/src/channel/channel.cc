@@ -49,6 +49,18 @@ StreamingStatus StreamingQueueProducer::CreateQueue() {
                                                  channel_info_.queue_size);
   STREAMING_CHECK(queue_ != nullptr);
 
+  std::string replay_log_dir = boost::any_cast<std::string>(
+      transfer_config_->Get(ConfigEnum::REPLAY_LOG_DIR, std::string()));
+  if (!replay_log_dir.empty()) {
+    uint32_t segment_size = boost::any_cast<uint32_t>(
+        transfer_config_->Get(ConfigEnum::REPLAY_LOG_SEGMENT_SIZE));
+    Status status = queue_->EnableReplayLog(replay_log_dir, segment_size);
+    if (!status.ok()) {
+      STREAMING_LOG(WARNING) << "Failed to enable replay log of "
+                             << channel_info_.channel_id << ": " << status;
+    }
+  }
+
   STREAMING_LOG(INFO) << "StreamingQueueProducer CreateQueue queue id => "
                       << channel_info_.channel_id << ", queue size => "
                       << channel_info_.queue_size;
@@ -67,17 +79,33 @@ StreamingStatus StreamingQueueProducer::ClearTransferCheckpoint(
 
 StreamingStatus StreamingQueueProducer::RefreshChannelInfo() {
   channel_info_.queue_info.consumed_message_id = queue_->GetMinConsumedMsgID();
+  channel_info_.queue_info.pushed_bytes = queue_->GetPushedBytes();
+  channel_info_.queue_info.consumed_bytes = queue_->GetConsumedBytes();
   return StreamingStatus::OK;
 }
 
 StreamingStatus StreamingQueueProducer::NotifyChannelConsumed(uint64_t msg_id) {
   queue_->SetQueueEvictionLimit(msg_id);
+  // Evict the released items now, rather than when the writer finds the queue full.
+  queue_->TryEvictItems();
   return StreamingStatus::OK;
 }
 
 StreamingStatus StreamingQueueProducer::ProduceItemToChannel(uint8_t *data,
                                                              uint32_t data_size) {
-  StreamingMessageBundleMetaPtr meta = StreamingMessageBundleMeta::FromBytes(data);
+  return ProduceBufferToChannel(std::make_shared<LocalMemoryBuffer>(data, data_size,
+                                                                    /*copy_data=*/true));
+}
+
+StreamingStatus StreamingQueueProducer::ProduceSharedItemToChannel(
+    std::shared_ptr<uint8_t> data, uint32_t data_size) {
+  return ProduceBufferToChannel(MakeBufferRef(data, data.get(), data_size));
+}
+
+StreamingStatus StreamingQueueProducer::ProduceBufferToChannel(
+    std::shared_ptr<LocalMemoryBuffer> buffer) {
+  StreamingMessageBundleMetaPtr meta =
+      StreamingMessageBundleMeta::FromBytes(buffer->Data());
   uint64_t msg_id_end = meta->GetLastMessageId();
   uint64_t msg_id_start =
       (meta->GetMessageListSize() == 0 ? msg_id_end
@@ -87,8 +115,7 @@ StreamingStatus StreamingQueueProducer::ProduceItemToChannel(uint8_t *data,
                        << ", msg_id_start=" << msg_id_start
                        << ", msg_id_end=" << msg_id_end << ", meta=" << *meta;
 
-  Status status =
-      PushQueueItem(data, data_size, current_time_ms(), msg_id_start, msg_id_end);
+  Status status = PushQueueItem(buffer, current_time_ms(), msg_id_start, msg_id_end);
   if (status.code() != StatusCode::OK) {
     STREAMING_LOG(DEBUG) << channel_info_.channel_id << " => Queue is full"
                          << " meesage => " << status.message();
@@ -98,21 +125,20 @@ StreamingStatus StreamingQueueProducer::ProduceItemToChannel(uint8_t *data,
     STREAMING_CHECK(status.code() == StatusCode::OutOfMemory)
         << "status => " << status.message()
         << ", perhaps data block is so large that it can't be stored in"
-        << ", data block size => " << data_size;
+        << ", data block size => " << buffer->Size();
 
     return StreamingStatus::FullChannel;
   }
   return StreamingStatus::OK;
 }
 
-Status StreamingQueueProducer::PushQueueItem(uint8_t *data, uint32_t data_size,
+Status StreamingQueueProducer::PushQueueItem(std::shared_ptr<LocalMemoryBuffer> buffer,
                                              uint64_t timestamp, uint64_t msg_id_start,
                                              uint64_t msg_id_end) {
   STREAMING_LOG(DEBUG) << "StreamingQueueProducer::PushQueueItem:"
                        << " qid: " << channel_info_.channel_id
-                       << " data_size: " << data_size;
-  Status status =
-      queue_->Push(data, data_size, timestamp, msg_id_start, msg_id_end, false);
+                       << " data_size: " << buffer->Size();
+  Status status = queue_->Push(buffer, timestamp, msg_id_start, msg_id_end, false);
   if (status.IsOutOfMemory()) {
     status = queue_->TryEvictItems();
     if (!status.ok()) {
@@ -120,7 +146,7 @@ Status StreamingQueueProducer::PushQueueItem(uint8_t *data, uint32_t data_size,
       return status;
     }
 
-    status = queue_->Push(data, data_size, timestamp, msg_id_start, msg_id_end, false);
+    status = queue_->Push(buffer, timestamp, msg_id_start, msg_id_end, false);
   }
 
   queue_->Send();
@@ -153,7 +179,10 @@ StreamingQueueStatus StreamingQueueConsumer::GetQueue(
                                      *init_param.sync_function);
   STREAMING_LOG(INFO) << "Create ReaderQueue " << queue_id
                       << " pull from start_msg_id: " << start_msg_id;
-  queue_ = downstream_handler->CreateDownstreamQueue(queue_id, init_param.actor_id);
+  uint32_t local_ring_size = boost::any_cast<uint32_t>(transfer_config_->Get(
+      ConfigEnum::LOCAL_TRANSPORT_RING_SIZE, static_cast<uint32_t>(0)));
+  queue_ = downstream_handler->CreateDownstreamQueue(queue_id, init_param.actor_id,
+                                                     local_ring_size);
   STREAMING_CHECK(queue_ != nullptr);
 
   bool is_first_pull;
@@ -25,6 +25,10 @@ struct StreamingQueueInfo {
   uint64_t last_message_id = 0;
   uint64_t target_message_id = 0;
   uint64_t consumed_message_id = 0;
+  /// Total size in bytes of the items pushed into the queue and consumed by the
+  /// downstream reader.
+  uint64_t pushed_bytes = 0;
+  uint64_t consumed_bytes = 0;
 };
 
 struct ChannelCreationParameter {
@@ -55,6 +59,23 @@ struct ProducerChannelInfo {
   uint64_t in_event_queue_cnt = 0;
   bool in_event_queue = false;
   bool flow_control = false;
+
+  /// The following parameters are used for adaptive batching. The writer holds back
+  /// the messages of a channel until they fill a bundle of `target_bundle_size`
+  /// messages, or the oldest one has waited for the target latency.
+  int64_t batch_start_ts = 0;
+  bool batch_lingering = false;
+  /// Arrival rate of the messages in messages per millisecond, smoothed over samples.
+  double arrival_rate = 0;
+  int64_t rate_sample_ts = 0;
+  uint64_t rate_sample_message_id = 0;
+  uint32_t target_bundle_size = 1;
+  /// Number of bundles collected and number of messages in them.
+  uint64_t bundle_cnt = 0;
+  uint64_t bundle_message_cnt = 0;
+
+  /// Event time watermark set by the user, and carried by every bundle of the channel.
+  uint64_t watermark = 0;
 };
 
 struct ConsumerChannelInfo {
@@ -73,6 +94,13 @@ struct ConsumerChannelInfo {
   // Total count of notify request.
   uint64_t notify_cnt = 0;
   uint64_t resend_notify_timer;
+
+  /// Event time watermark of the latest bundle received from the channel.
+  uint64_t watermark = 0;
+  /// Time of the latest data or barrier bundle received from the channel. A channel that
+  /// only sends empty bundles for a while is idle.
+  int64_t last_active_ts = 0;
+  bool is_idle = false;
 };
 
 /// Two types of channel are presented:
@@ -96,6 +124,13 @@ class ProducerChannel {
                                                   uint64_t checkpoint_offset) = 0;
   virtual StreamingStatus RefreshChannelInfo() = 0;
   virtual StreamingStatus ProduceItemToChannel(uint8_t *data, uint32_t data_size) = 0;
+  /// Produce an item whose bytes are owned by `data`. Channels that keep items until
+  /// they are consumed may reference `data` instead of copying it, so the caller must
+  /// not modify the bytes afterwards.
+  virtual StreamingStatus ProduceSharedItemToChannel(std::shared_ptr<uint8_t> data,
+                                                     uint32_t data_size) {
+    return ProduceItemToChannel(data.get(), data_size);
+  }
   virtual StreamingStatus NotifyChannelConsumed(uint64_t channel_offset) = 0;
 
  protected:
@@ -133,11 +168,14 @@ class StreamingQueueProducer : public ProducerChannel {
                                           uint64_t checkpoint_offset) override;
   StreamingStatus RefreshChannelInfo() override;
   StreamingStatus ProduceItemToChannel(uint8_t *data, uint32_t data_size) override;
+  StreamingStatus ProduceSharedItemToChannel(std::shared_ptr<uint8_t> data,
+                                             uint32_t data_size) override;
   StreamingStatus NotifyChannelConsumed(uint64_t offset_id) override;
 
  private:
   StreamingStatus CreateQueue();
-  Status PushQueueItem(uint8_t *data, uint32_t data_size, uint64_t timestamp,
+  StreamingStatus ProduceBufferToChannel(std::shared_ptr<LocalMemoryBuffer> buffer);
+  Status PushQueueItem(std::shared_ptr<LocalMemoryBuffer> buffer, uint64_t timestamp,
                        uint64_t msg_id_start, uint64_t msg_id_end);
 
  private:
@@ -40,6 +40,16 @@ void StreamingConfig::FromProto(const uint8_t *data, uint32_t size) {
   RESET_IF_INT_CONF(ReaderConsumedStep, config.reader_consumed_step())
   RESET_IF_INT_CONF(EventDrivenFlowControlInterval,
                     config.event_driven_flow_control_interval())
+  RESET_IF_INT_CONF(WriterCreditBytes, config.writer_credit_bytes())
+  RESET_IF_INT_CONF(BundleTargetLatencyMs, config.bundle_target_latency_ms())
+  RESET_IF_INT_CONF(LocalTransportRingSize, config.local_transport_ring_size())
+  RESET_IF_NOT_DEFAULT_CONF(AsyncClearCheckpoint, config.async_clear_checkpoint(), false)
+  RESET_IF_NOT_DEFAULT_CONF(EventTimeMerge, config.event_time_merge(), false)
+  RESET_IF_INT_CONF(IdleChannelTimeoutMs, config.idle_channel_timeout_ms())
+  RESET_IF_INT_CONF(BundleCompressionLevel, config.bundle_compression_level())
+  RESET_IF_STR_CONF(BundleCompressionDictionary, config.bundle_compression_dictionary())
+  RESET_IF_STR_CONF(ReplayLogDir, config.replay_log_dir())
+  RESET_IF_INT_CONF(ReplayLogSegmentSize, config.replay_log_segment_size())
   STREAMING_CHECK(writer_consumed_step_ >= reader_consumed_step_)
       << "Writer consuemd step " << writer_consumed_step_
       << "can not be smaller then reader consumed step " << reader_consumed_step_;
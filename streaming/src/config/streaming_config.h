@@ -48,6 +48,44 @@ class StreamingConfig {
 
   uint32_t event_driven_flow_control_interval_ = 1;
 
+  // Bytes a writer may send ahead of its reader with credit based flow control. 0
+  // means the size of the channel.
+  uint32_t writer_credit_bytes_ = 0;
+
+  // Target latency of adaptive batching, that is the longest time a message may wait in
+  // the writer for its bundle to fill. 0 disables adaptive batching, and messages are
+  // sent as soon as the writer thread sees them.
+  uint32_t bundle_target_latency_ms_ = 0;
+
+  // Size in bytes of the shared memory ring through which an upstream actor on the same
+  // node sends data to a reader, it should be larger than the queue size. 0 disables
+  // the shared memory transport.
+  uint32_t local_transport_ring_size_ = 0;
+
+  // Release the data of finished checkpoints in a background thread of the writer, so
+  // that the caller of ClearCheckpoint is not blocked.
+  bool async_clear_checkpoint_ = false;
+
+  // Merge the channels of a reader in order of the event time watermark of the bundles,
+  // so that the reader emits in event time order.
+  bool event_time_merge_ = false;
+
+  // Time after which a channel that only sends empty bundles is considered idle, and is
+  // no longer waited for by the event time merge.
+  uint32_t idle_channel_timeout_ms_ = 5000;
+
+  // The zlib level the writer compresses the raw data of bundles with, 0 disables
+  // compression. Readers decompress bundles regardless.
+  uint32_t bundle_compression_level_ = 0;
+
+  // Preset dictionary for bundle compression, shared by writers and readers.
+  std::string bundle_compression_dictionary_;
+
+  // Directory of the replay log the writer spills bundles to, empty disables it.
+  std::string replay_log_dir_;
+
+  uint32_t replay_log_segment_size_ = 64 * 1024 * 1024;
+
   ReliabilityLevel streaming_strategy_ = ReliabilityLevel::EXACTLY_ONCE;
   StreamingRole streaming_role = StreamingRole::TRANSFORM;
 
@@ -72,6 +110,17 @@ class StreamingConfig {
                         flow_control_type_)
   DECL_GET_SET_PROPERTY(uint32_t, EventDrivenFlowControlInterval,
                         event_driven_flow_control_interval_)
+  DECL_GET_SET_PROPERTY(uint32_t, WriterCreditBytes, writer_credit_bytes_)
+  DECL_GET_SET_PROPERTY(uint32_t, BundleTargetLatencyMs, bundle_target_latency_ms_)
+  DECL_GET_SET_PROPERTY(uint32_t, LocalTransportRingSize, local_transport_ring_size_)
+  DECL_GET_SET_PROPERTY(bool, AsyncClearCheckpoint, async_clear_checkpoint_)
+  DECL_GET_SET_PROPERTY(bool, EventTimeMerge, event_time_merge_)
+  DECL_GET_SET_PROPERTY(uint32_t, IdleChannelTimeoutMs, idle_channel_timeout_ms_)
+  DECL_GET_SET_PROPERTY(uint32_t, BundleCompressionLevel, bundle_compression_level_)
+  DECL_GET_SET_PROPERTY(const std::string &, BundleCompressionDictionary,
+                        bundle_compression_dictionary_)
+  DECL_GET_SET_PROPERTY(const std::string &, ReplayLogDir, replay_log_dir_)
+  DECL_GET_SET_PROPERTY(uint32_t, ReplayLogSegmentSize, replay_log_segment_size_)
   DECL_GET_SET_PROPERTY(StreamingRole, StreamingRole, streaming_role)
   DECL_GET_SET_PROPERTY(ReliabilityLevel, ReliabilityLevel, streaming_strategy_)
 
@@ -3,9 +3,12 @@
 #include <algorithm>
 #include <chrono>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <thread>
+#include <vector>
 
 #include "message/message_bundle.h"
 #include "ray/util/logging.h"
@@ -36,6 +39,8 @@ void DataReader::Init(const std::vector<ObjectID> &input_ids,
   STREAMING_LOG(INFO) << input_ids.size() << " queue to init.";
 
   transfer_config_->Set(ConfigEnum::QUEUE_ID_VECTOR, input_ids);
+  transfer_config_->Set(ConfigEnum::LOCAL_TRANSPORT_RING_SIZE,
+                        runtime_context_->GetConfig().GetLocalTransportRingSize());
 
   last_fetched_queue_item_ = nullptr;
   timer_interval_ = timer_interval;
@@ -98,7 +103,8 @@ StreamingStatus DataReader::InitChannelMerger(uint32_t timeout_ms) {
   STREAMING_LOG(INFO) << "[Reader] Initializing queue merger.";
   // Init reader merger by given comparator when it's first created.
   StreamingReaderMsgPtrComparator comparator(
-      runtime_context_->GetConfig().GetReliabilityLevel());
+      runtime_context_->GetConfig().GetReliabilityLevel(),
+      runtime_context_->GetConfig().GetEventTimeMerge());
   if (!reader_merger_) {
     reader_merger_.reset(
         new PriorityQueue<std::shared_ptr<DataBundle>, StreamingReaderMsgPtrComparator>(
@@ -183,6 +189,7 @@ StreamingStatus DataReader::GetMessageFromChannel(ConsumerChannelInfo &channel_i
         STREAMING_LOG(DEBUG) << "CheckBundle, result=" << status
                              << ", last_msg_id=" << last_message_id_[message->from];
         if (status == BundleCheckStatus::BundleToBeSplit) {
+          DecompressBundle(message);
           SplitBundle(message, last_message_id_[qid]);
         }
         if (status == BundleCheckStatus::BundleToBeThrown && message->meta->IsBarrier()) {
@@ -191,6 +198,10 @@ StreamingStatus DataReader::GetMessageFromChannel(ConsumerChannelInfo &channel_i
         }
         is_valid_bundle = status != BundleCheckStatus::BundleToBeThrown;
       }
+      // Bundles are only decompressed once they are known to be delivered.
+      if (is_valid_bundle) {
+        DecompressBundle(message);
+      }
     }
   }
   if (RuntimeStatus::Interrupted == runtime_context_->GetRuntimeStatus()) {
@@ -206,9 +217,32 @@ StreamingStatus DataReader::GetMessageFromChannel(ConsumerChannelInfo &channel_i
   STREAMING_LOG(DEBUG) << "[Reader] received message id="
                        << message->meta->GetLastMessageId() << ", queue id=" << qid;
   last_message_id_[message->from] = message->meta->GetLastMessageId();
+  UpdateChannelWatermark(channel_info, message);
   return StreamingStatus::OK;
 }
 
+void DataReader::UpdateChannelWatermark(ConsumerChannelInfo &channel_info,
+                                        std::shared_ptr<DataBundle> &message) {
+  int64_t current_time = current_time_ms();
+  if (!message->meta->IsEmptyMsg() || channel_info.last_active_ts == 0) {
+    channel_info.last_active_ts = current_time;
+  }
+  bool is_idle =
+      message->meta->IsEmptyMsg() &&
+      current_time - channel_info.last_active_ts >
+          static_cast<int64_t>(runtime_context_->GetConfig().GetIdleChannelTimeoutMs());
+  if (is_idle != channel_info.is_idle) {
+    STREAMING_LOG(INFO) << "[Reader] channel " << channel_info.channel_id
+                        << (is_idle ? " becomes idle" : " becomes active")
+                        << ", watermark=" << message->meta->GetWatermark();
+    channel_info.is_idle = is_idle;
+  }
+  uint64_t watermark = message->meta->GetWatermark();
+  channel_info.watermark = std::max(channel_info.watermark, watermark);
+  message->merge_watermark =
+      is_idle ? std::max(channel_info.watermark, last_merged_watermark_) : watermark;
+}
+
 BundleCheckStatus DataReader::CheckBundle(const std::shared_ptr<DataBundle> &message) {
   uint64_t end_msg_id = message->meta->GetLastMessageId();
   uint64_t start_msg_id = message->meta->IsEmptyMsg()
@@ -236,29 +270,63 @@ BundleCheckStatus DataReader::CheckBundle(const std::shared_ptr<DataBundle> &mes
 }
 
 void DataReader::SplitBundle(std::shared_ptr<DataBundle> &message, uint64_t last_msg_id) {
-  std::list<StreamingMessagePtr> msg_list;
-  StreamingMessageBundle::GetMessageListFromRawData(
-      message->data + kMessageBundleHeaderSize,
-      message->data_size - kMessageBundleHeaderSize, message->meta->GetMessageListSize(),
-      msg_list);
-  uint32_t bundle_size = 0;
-  for (auto it = msg_list.begin(); it != msg_list.end();) {
-    if ((*it)->GetMessageId() > last_msg_id) {
-      bundle_size += (*it)->ClassBytesSize();
-      it++;
-    } else {
-      it = msg_list.erase(it);
-    }
+  // Parse the messages in place. Message ids increase within a bundle, so the messages
+  // to keep are the tail of the raw data, and are copied at once.
+  const uint8_t *raw_data = message->data + kMessageBundleHeaderSize;
+  const uint32_t raw_data_size = message->data_size - kMessageBundleHeaderSize;
+  std::vector<StreamingMessageView> message_views;
+  StreamingMessageBundle::GetMessageViewsFromRawData(
+      raw_data, raw_data_size, message->meta->GetMessageListSize(), message_views);
+  size_t first_kept = 0;
+  uint32_t dropped_size = 0;
+  while (first_kept < message_views.size() &&
+         message_views[first_kept].message_id <= last_msg_id) {
+    dropped_size += message_views[first_kept].ClassBytesSize();
+    first_kept++;
   }
+  STREAMING_CHECK(first_kept < message_views.size());
   STREAMING_LOG(DEBUG) << "Split message, from_queue_id=" << message->from
-                       << ", start_msg_id=" << msg_list.front()->GetMessageId()
-                       << ", end_msg_id=" << msg_list.back()->GetMessageId();
+                       << ", start_msg_id=" << message_views[first_kept].message_id
+                       << ", end_msg_id=" << message_views.back().message_id;
   // recreate bundle
-  auto cut_msg_bundle = std::make_shared<StreamingMessageBundle>(
-      msg_list, message->meta->GetMessageBundleTs(), msg_list.back()->GetMessageId(),
-      StreamingMessageBundleType::Bundle, bundle_size);
-  message->Realloc(cut_msg_bundle->ClassBytesSize());
-  cut_msg_bundle->ToBytes(message->data);
+  const uint32_t bundle_size = raw_data_size - dropped_size;
+  StreamingMessageBundleMeta cut_meta(
+      message->meta->GetMessageBundleTs(), message_views.back().message_id,
+      message_views.size() - first_kept, StreamingMessageBundleType::Bundle);
+  cut_meta.SetWatermark(message->meta->GetWatermark());
+  uint8_t *old_data = message->data;
+  const bool old_data_reallocated = message->is_reallocated;
+  message->Realloc(kMessageBundleHeaderSize + bundle_size);
+  message->data_size = kMessageBundleHeaderSize + bundle_size;
+  cut_meta.ToBytes(message->data);
+  std::memcpy(message->data + kMessageBundleMetaHeaderSize, &bundle_size,
+              sizeof(bundle_size));
+  std::memcpy(message->data + kMessageBundleHeaderSize, raw_data + dropped_size,
+              bundle_size);
+  if (old_data_reallocated) {
+    delete[] old_data;
+  }
+  message->meta = StreamingMessageBundleMeta::FromBytes(message->data);
+}
+
+void DataReader::DecompressBundle(std::shared_ptr<DataBundle> &message) {
+  if (!StreamingMessageBundleMeta::IsCompressed(message->data)) {
+    return;
+  }
+  if (bundle_codec_ == nullptr) {
+    bundle_codec_.reset(new BundleCodec(
+        Z_DEFAULT_COMPRESSION,
+        runtime_context_->GetConfig().GetBundleCompressionDictionary()));
+  }
+  uint8_t *old_data = message->data;
+  const bool old_data_reallocated = message->is_reallocated;
+  const uint32_t bundle_size = BundleCodec::DecompressedSize(old_data);
+  message->Realloc(bundle_size);
+  bundle_codec_->Decompress(old_data, message->data);
+  message->data_size = bundle_size;
+  if (old_data_reallocated) {
+    delete[] old_data;
+  }
   message->meta = StreamingMessageBundleMeta::FromBytes(message->data);
 }
 
@@ -268,6 +336,7 @@ StreamingStatus DataReader::StashNextMessageAndPop(std::shared_ptr<DataBundle> &
 
   // Get the first message.
   message = reader_merger_->top();
+  last_merged_watermark_ = std::max(last_merged_watermark_, message->merge_watermark);
   STREAMING_LOG(DEBUG) << "Messages to be popped=" << *message
                        << ", merger size=" << reader_merger_->size()
                        << ", bytes=" << Util::Byte2hex(message->data, message->data_size);
@@ -483,6 +552,23 @@ void DataReader::NotifyConsumed(std::shared_ptr<DataBundle> &message) {
   }
 }
 
+uint64_t DataReader::GetWatermark() {
+  uint64_t min_watermark = std::numeric_limits<uint64_t>::max();
+  uint64_t max_watermark = 0;
+  for (auto &item : channel_info_map_) {
+    auto &channel_info = item.second;
+    if (!channel_info.is_idle) {
+      min_watermark = std::min(min_watermark, channel_info.watermark);
+    }
+    max_watermark = std::max(max_watermark, channel_info.watermark);
+  }
+  // All channels are idle, nothing holds the watermark back.
+  if (min_watermark == std::numeric_limits<uint64_t>::max()) {
+    return max_watermark;
+  }
+  return min_watermark;
+}
+
 bool StreamingReaderMsgPtrComparator::operator()(const std::shared_ptr<DataBundle> &a,
                                                  const std::shared_ptr<DataBundle> &b) {
   if (comp_strategy == ReliabilityLevel::EXACTLY_ONCE) {
@@ -490,6 +576,9 @@ bool StreamingReaderMsgPtrComparator::operator()(const std::shared_ptr<DataBundl
       return a->last_barrier_id > b->last_barrier_id;
   }
   STREAMING_CHECK(a->meta);
+  if (event_time_merge && a->merge_watermark != b->merge_watermark) {
+    return a->merge_watermark > b->merge_watermark;
+  }
   // We proposed fixed id sequnce for stability of message in sorting.
   if (a->meta->GetMessageBundleTs() == b->meta->GetMessageBundleTs()) {
     return a->from.Hash() > b->from.Hash();
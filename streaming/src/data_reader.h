@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "channel/channel.h"
+#include "message/bundle_codec.h"
 #include "message/message_bundle.h"
 #include "message/priority_queue.h"
 #include "reliability/barrier_helper.h"
@@ -33,11 +34,15 @@ static inline std::ostream &operator<<(std::ostream &os,
 }
 
 /// This is implementation of merger policy in StreamingReaderMsgPtrComparator.
+/// Bundles are ordered by bundle timestamp, or by event time watermark if event time
+/// merge is enabled.
 struct StreamingReaderMsgPtrComparator {
-  explicit StreamingReaderMsgPtrComparator(ReliabilityLevel strategy)
-      : comp_strategy(strategy){};
+  explicit StreamingReaderMsgPtrComparator(ReliabilityLevel strategy,
+                                           bool event_time = false)
+      : comp_strategy(strategy), event_time_merge(event_time){};
   StreamingReaderMsgPtrComparator(){};
   ReliabilityLevel comp_strategy = ReliabilityLevel::EXACTLY_ONCE;
+  bool event_time_merge = false;
 
   bool operator()(const std::shared_ptr<DataBundle> &a,
                   const std::shared_ptr<DataBundle> &b);
@@ -71,11 +76,17 @@ class DataReader {
 
   ObjectID last_read_q_id_;
 
+  /// Largest event time watermark of the bundles popped from the merger.
+  uint64_t last_merged_watermark_ = 0;
+
   static const uint32_t kReadItemTimeout;
   StreamingBarrierHelper barrier_helper_;
   std::shared_ptr<ReliabilityHelper> reliability_helper_;
   std::unordered_map<ObjectID, uint64_t> last_message_id_;
 
+  /// Decompresses compressed bundles, created at the first one.
+  std::unique_ptr<BundleCodec> bundle_codec_;
+
   friend class ReliabilityHelper;
   friend class AtLeastOnceHelper;
 
@@ -130,6 +141,10 @@ class DataReader {
   //// Notify message related channel to clear data.
   void NotifyConsumed(std::shared_ptr<DataBundle> &message);
 
+  /// Get the event time watermark of the reader, that is the smallest watermark of the
+  /// channels that are not idle. Windows ending before it can be fired.
+  uint64_t GetWatermark();
+
  private:
   /// Create channels and connect to all upstream.
   StreamingStatus InitChannel(std::vector<TransferCreationStatus> &creation_status);
@@ -153,9 +168,20 @@ class DataReader {
 
   bool BarrierAlign(std::shared_ptr<DataBundle> &message);
 
+  /// Track the watermark and the idleness of the channel of a received bundle, and
+  /// decide the watermark the bundle is merged by. An empty bundle of an idle channel
+  /// is merged at the current watermark of the reader, so that the idle channel
+  /// neither holds back the other channels nor starves.
+  void UpdateChannelWatermark(ConsumerChannelInfo &channel_info,
+                              std::shared_ptr<DataBundle> &message);
+
   BundleCheckStatus CheckBundle(const std::shared_ptr<DataBundle> &message);
 
   static void SplitBundle(std::shared_ptr<DataBundle> &message, uint64_t last_msg_id);
+
+  /// Replace a compressed bundle with its decompressed copy, which is a no-op for
+  /// bundles that aren't compressed.
+  void DecompressBundle(std::shared_ptr<DataBundle> &message);
 };
 }  // namespace streaming
 }  // namespace ray
@@ -1,11 +1,13 @@
 #include "data_writer.h"
 
+#include <algorithm>
 #include <chrono>
 #include <functional>
 #include <list>
 #include <memory>
 #include <numeric>
 
+#include "ray/util/macros.h"
 #include "util/streaming_util.h"
 
 namespace ray {
@@ -54,6 +56,10 @@ void DataWriter::Run() {
       std::make_shared<std::thread>(&DataWriter::EmptyMessageTimerCallback, this);
   flow_control_thread_ =
       std::make_shared<std::thread>(&DataWriter::FlowControlTimer, this);
+  if (runtime_context_->GetConfig().GetAsyncClearCheckpoint()) {
+    clear_checkpoint_thread_ =
+        std::make_shared<std::thread>(&DataWriter::ClearCheckpointLoop, this);
+  }
 }
 
 /// Since every memory ring buffer's size is limited, when the writing buffer is
@@ -63,7 +69,75 @@ uint64_t DataWriter::WriteMessageToBufferRing(const ObjectID &q_id, uint8_t *dat
                                               uint32_t data_size,
                                               StreamingMessageType message_type) {
   // TODO(lingxuan.zlx): currently, unsafe in multithreads
-  ProducerChannelInfo &channel_info = channel_info_map_[q_id];
+  return WriteMessageToChannel(channel_info_map_[q_id], data, data_size, message_type);
+}
+
+uint32_t DataWriter::PartitionOfKey(uint64_t key, uint32_t num_partitions) {
+  // The finalizer of splitmix64, so that similar keys spread over all partitions.
+  key ^= key >> 30;
+  key *= 0xbf58476d1ce4e5b9ULL;
+  key ^= key >> 27;
+  key *= 0x94d049bb133111ebULL;
+  key ^= key >> 31;
+  // Scale the high bits to [0, num_partitions) with a multiply instead of a division.
+  return static_cast<uint32_t>(((key >> 32) * num_partitions) >> 32);
+}
+
+size_t DataWriter::WritePartitionedMessages(const std::vector<ObjectID> &channel_ids,
+                                            const std::vector<uint64_t> &keys,
+                                            const std::vector<uint8_t *> &data,
+                                            const std::vector<uint32_t> &data_sizes) {
+  STREAMING_CHECK(!channel_ids.empty());
+  STREAMING_CHECK(keys.size() == data.size() && data.size() == data_sizes.size());
+  const size_t num_messages = keys.size();
+  const uint32_t num_partitions = channel_ids.size();
+
+  // Hash the whole batch in one tight loop, which the compiler can vectorize.
+  std::vector<uint32_t> partitions(num_messages);
+  for (size_t i = 0; i < num_messages; ++i) {
+    partitions[i] = PartitionOfKey(keys[i], num_partitions);
+  }
+
+  // Group the messages by partition with a counting sort, which keeps the order of the
+  // messages of each partition.
+  std::vector<size_t> offsets(num_partitions + 1, 0);
+  for (uint32_t partition : partitions) {
+    ++offsets[partition + 1];
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<size_t> order(num_messages);
+  std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+  for (size_t i = 0; i < num_messages; ++i) {
+    order[next[partitions[i]]++] = i;
+  }
+
+  size_t written = 0;
+  for (uint32_t partition = 0; partition < num_partitions; ++partition) {
+    const size_t begin = offsets[partition];
+    const size_t end = offsets[partition + 1];
+    if (begin == end) {
+      continue;
+    }
+    ProducerChannelInfo &channel_info = channel_info_map_[channel_ids[partition]];
+    for (size_t j = begin; j < end; ++j) {
+      // Messages are copied into the ring, fetch the next one meanwhile.
+      if (j + 1 < end) {
+        RAY_PREFETCH(data[order[j + 1]]);
+      }
+      const size_t i = order[j];
+      if (WriteMessageToChannel(channel_info, data[i], data_sizes[i],
+                                StreamingMessageType::Message) == 0) {
+        return written;
+      }
+      ++written;
+    }
+  }
+  return written;
+}
+
+uint64_t DataWriter::WriteMessageToChannel(ProducerChannelInfo &channel_info,
+                                           uint8_t *data, uint32_t data_size,
+                                           StreamingMessageType message_type) {
   // Write message id stands for current lastest message id and differs from
   // channel.current_message_id if it's barrier message.
   uint64_t &write_message_id = channel_info.current_message_id;
@@ -71,7 +145,7 @@ uint64_t DataWriter::WriteMessageToBufferRing(const ObjectID &q_id, uint8_t *dat
     write_message_id++;
   }
 
-  STREAMING_LOG(DEBUG) << "WriteMessageToBufferRing q_id: " << q_id
+  STREAMING_LOG(DEBUG) << "WriteMessageToBufferRing q_id: " << channel_info.channel_id
                        << " data_size: " << data_size
                        << ", message_type=" << static_cast<uint32_t>(message_type)
                        << ", data=" << Util::Byte2hex(data, data_size)
@@ -91,6 +165,7 @@ uint64_t DataWriter::WriteMessageToBufferRing(const ObjectID &q_id, uint8_t *dat
       data, data_size, write_message_id, message_type));
 
   if (ring_buffer_ptr->Size() == 1) {
+    channel_info.batch_start_ts = current_time_ms();
     if (channel_info.in_event_queue) {
       ++channel_info.in_event_queue_cnt;
       STREAMING_LOG(DEBUG) << "user_event had been in event_queue";
@@ -119,6 +194,8 @@ StreamingStatus DataWriter::InitChannel(const ObjectID &q_id,
       runtime_context_->GetConfig().GetRingBufferCapacity(),
       StreamingRingBufferType::SPSC);
   channel_info.message_pass_by_ts = current_time_ms();
+  channel_info.rate_sample_ts = channel_info.message_pass_by_ts;
+  channel_info.rate_sample_message_id = channel_message_id;
   std::shared_ptr<ProducerChannel> channel;
 
   if (runtime_context_->IsMockTest()) {
@@ -141,6 +218,12 @@ StreamingStatus DataWriter::Init(const std::vector<ObjectID> &queue_id_vec,
 
   output_queue_ids_ = queue_id_vec;
   transfer_config_->Set(ConfigEnum::QUEUE_ID_VECTOR, queue_id_vec);
+  const std::string &replay_log_dir = runtime_context_->GetConfig().GetReplayLogDir();
+  if (!replay_log_dir.empty()) {
+    transfer_config_->Set(ConfigEnum::REPLAY_LOG_DIR, replay_log_dir);
+    transfer_config_->Set(ConfigEnum::REPLAY_LOG_SEGMENT_SIZE,
+                          runtime_context_->GetConfig().GetReplayLogSegmentSize());
+  }
 
   for (size_t i = 0; i < queue_id_vec.size(); ++i) {
     StreamingStatus status = InitChannel(queue_id_vec[i], init_params[i],
@@ -155,11 +238,25 @@ StreamingStatus DataWriter::Init(const std::vector<ObjectID> &queue_id_vec,
     flow_controller_ = std::make_shared<UnconsumedSeqFlowControl>(
         channel_map_, runtime_context_->GetConfig().GetWriterConsumedStep());
     break;
+  case proto::FlowControlType::CreditFlowControl:
+    flow_controller_ = std::make_shared<CreditFlowControl>(
+        channel_map_, runtime_context_->GetConfig().GetWriterCreditBytes());
+    break;
   default:
     flow_controller_ = std::make_shared<NoFlowControl>();
     break;
   }
 
+  const uint32_t compression_level =
+      runtime_context_->GetConfig().GetBundleCompressionLevel();
+  if (compression_level > 0) {
+    STREAMING_CHECK(compression_level <= Z_BEST_COMPRESSION)
+        << "Invalid bundle compression level " << compression_level;
+    bundle_codec_.reset(new BundleCodec(
+        compression_level,
+        runtime_context_->GetConfig().GetBundleCompressionDictionary()));
+  }
+
   reliability_helper_ = ReliabilityHelperFactory::CreateReliabilityHelper(
       runtime_context_->GetConfig(), barrier_helper_, this, nullptr);
   // Register empty event and user event to event server.
@@ -218,6 +315,13 @@ void DataWriter::BroadcastBarrier(uint64_t barrier_id, const uint8_t *data,
                       << barrier_id;
 }
 
+void DataWriter::UpdateWatermark(const ObjectID &q_id, uint64_t watermark) {
+  auto &channel_info = channel_info_map_[q_id];
+  if (watermark > channel_info.watermark) {
+    channel_info.watermark = watermark;
+  }
+}
+
 DataWriter::DataWriter(std::shared_ptr<RuntimeContext> &runtime_context)
     : transfer_config_(new Config()), runtime_context_(runtime_context) {}
 
@@ -237,6 +341,11 @@ DataWriter::~DataWriter() {
       STREAMING_LOG(INFO) << "FlowControl timer thread waiting for join";
       flow_control_thread_->join();
     }
+    if (clear_checkpoint_thread_ && clear_checkpoint_thread_->joinable()) {
+      STREAMING_LOG(INFO) << "Clear checkpoint thread waiting for join";
+      clear_checkpoint_cv_.notify_all();
+      clear_checkpoint_thread_->join();
+    }
     int user_event_count = 0;
     int empty_event_count = 0;
     int flow_control_event_count = 0;
@@ -277,13 +386,13 @@ StreamingStatus DataWriter::WriteEmptyMessage(ProducerChannelInfo &channel_info)
   // Make an empty bundle, use old ts from reloaded meta if it's not nullptr.
   StreamingMessageBundlePtr bundle_ptr = std::make_shared<StreamingMessageBundle>(
       channel_info.current_message_id, current_time_ms());
+  bundle_ptr->SetWatermark(channel_info.watermark);
   auto &q_ringbuffer = channel_info.writer_ring_buffer;
   q_ringbuffer->ReallocTransientBuffer(bundle_ptr->ClassBytesSize());
   bundle_ptr->ToBytes(q_ringbuffer->GetTransientBufferMutable());
 
-  StreamingStatus status = channel_map_[q_id]->ProduceItemToChannel(
-      const_cast<uint8_t *>(q_ringbuffer->GetTransientBuffer()),
-      q_ringbuffer->GetTransientBufferSize());
+  StreamingStatus status = channel_map_[q_id]->ProduceSharedItemToChannel(
+      q_ringbuffer->GetTransientBufferShared(), q_ringbuffer->GetTransientBufferSize());
   STREAMING_LOG(DEBUG) << "q_id =>" << q_id << " send empty message, meta info =>"
                        << bundle_ptr->ToString();
 
@@ -296,8 +405,9 @@ StreamingStatus DataWriter::WriteEmptyMessage(ProducerChannelInfo &channel_info)
 StreamingStatus DataWriter::WriteTransientBufferToChannel(
     ProducerChannelInfo &channel_info) {
   StreamingRingBufferPtr &buffer_ptr = channel_info.writer_ring_buffer;
-  StreamingStatus status = channel_map_[channel_info.channel_id]->ProduceItemToChannel(
-      buffer_ptr->GetTransientBufferMutable(), buffer_ptr->GetTransientBufferSize());
+  StreamingStatus status =
+      channel_map_[channel_info.channel_id]->ProduceSharedItemToChannel(
+          buffer_ptr->GetTransientBufferShared(), buffer_ptr->GetTransientBufferSize());
   RETURN_IF_NOT_OK(status)
   auto transient_bundle_meta =
       StreamingMessageBundleMeta::FromBytes(buffer_ptr->GetTransientBuffer());
@@ -368,6 +478,12 @@ bool DataWriter::CollectFromRingBuffer(ProducerChannelInfo &channel_info,
                          << ", queue size => " << channel_info.queue_size;
   }
 
+  ++channel_info.bundle_cnt;
+  channel_info.bundle_message_cnt += message_list.size();
+  if (!buffer_ptr->IsEmpty()) {
+    channel_info.batch_start_ts = current_time_ms();
+  }
+
   StreamingMessageBundlePtr bundle_ptr;
   StreamingMessageBundleType bundleType = StreamingMessageBundleType::Bundle;
   if (is_barrier) {
@@ -376,6 +492,7 @@ bool DataWriter::CollectFromRingBuffer(ProducerChannelInfo &channel_info,
   bundle_ptr = std::make_shared<StreamingMessageBundle>(
       std::move(message_list), current_time_ms(), message_list.back()->GetMessageId(),
       bundleType, bundle_buffer_size);
+  bundle_ptr->SetWatermark(channel_info.watermark);
 
   STREAMING_LOG(DEBUG) << "CollectFromRingBuffer done, bundle=" << *bundle_ptr;
 
@@ -383,9 +500,49 @@ bool DataWriter::CollectFromRingBuffer(ProducerChannelInfo &channel_info,
   bundle_ptr->ToBytes(buffer_ptr->GetTransientBufferMutable());
 
   STREAMING_CHECK(bundle_ptr->ClassBytesSize() == buffer_ptr->GetTransientBufferSize());
+  if (bundle_codec_ != nullptr) {
+    buffer_ptr->SetTransientBufferSize(
+        bundle_codec_->Compress(buffer_ptr->GetTransientBufferMutable(),
+                                buffer_ptr->GetTransientBufferSize()));
+  }
   return true;
 }
 
+void DataWriter::UpdateBundleTarget(ProducerChannelInfo &channel_info,
+                                    int64_t current_ts) {
+  const uint32_t target_latency =
+      runtime_context_->GetConfig().GetBundleTargetLatencyMs();
+  int64_t elapsed = current_ts - channel_info.rate_sample_ts;
+  if (target_latency == 0 || elapsed < std::max<int64_t>(target_latency, 1)) {
+    return;
+  }
+  double rate = static_cast<double>(channel_info.current_message_id -
+                                    channel_info.rate_sample_message_id) /
+                elapsed;
+  // Smooth the samples so that a short burst or pause does not swing the bundle size.
+  channel_info.arrival_rate = 0.8 * channel_info.arrival_rate + 0.2 * rate;
+  channel_info.rate_sample_ts = current_ts;
+  channel_info.rate_sample_message_id = channel_info.current_message_id;
+  // At low rates the target is a single message, so nothing waits for a bundle to fill.
+  double target_size = channel_info.arrival_rate * target_latency;
+  double max_size =
+      static_cast<double>(runtime_context_->GetConfig().GetRingBufferCapacity());
+  channel_info.target_bundle_size =
+      static_cast<uint32_t>(std::max(1.0, std::min(target_size, max_size)));
+}
+
+bool DataWriter::ShouldLingerForBatch(ProducerChannelInfo &channel_info,
+                                      int64_t current_ts) {
+  const uint32_t target_latency =
+      runtime_context_->GetConfig().GetBundleTargetLatencyMs();
+  if (target_latency == 0 || channel_info.writer_ring_buffer->IsTransientAvaliable()) {
+    return false;
+  }
+  size_t buffer_size = channel_info.writer_ring_buffer->Size();
+  return buffer_size > 0 && buffer_size < channel_info.target_bundle_size &&
+         current_ts - channel_info.batch_start_ts < target_latency;
+}
+
 void DataWriter::Stop() {
   for (auto &output_queue : output_queue_ids_) {
     ProducerChannelInfo &channel_info = channel_info_map_[output_queue];
@@ -414,6 +571,14 @@ bool DataWriter::WriteAllToChannel(ProducerChannelInfo *info) {
       channel_info.flow_control = true;
       break;
     }
+    // Wait for more messages to fill the bundle, FlowControlTimer resumes the channel
+    // once it is full enough or the target latency is reached.
+    int64_t batch_ts = current_time_ms();
+    UpdateBundleTarget(channel_info, batch_ts);
+    if (ShouldLingerForBatch(channel_info, batch_ts)) {
+      channel_info.batch_lingering = true;
+      break;
+    }
     uint64_t ring_buffer_remain = channel_info.writer_ring_buffer->Size();
     StreamingStatus write_status = WriteBufferToChannel(channel_info, ring_buffer_remain);
     int64_t current_ts = current_time_ms();
@@ -494,7 +659,14 @@ void DataWriter::EmptyMessageTimerCallback() {
                            << " flow_control_event:" << channel_info.flow_control_cnt
                            << " empty_event_cnt:" << channel_info.sent_empty_cnt
                            << " rb_full_cnt:" << channel_info.rb_full_cnt
-                           << " queue_full_cnt:" << channel_info.queue_full_cnt;
+                           << " queue_full_cnt:" << channel_info.queue_full_cnt
+                           << " bundle_cnt:" << channel_info.bundle_cnt
+                           << " avg_bundle_size:"
+                           << (channel_info.bundle_cnt == 0
+                                   ? 0
+                                   : channel_info.bundle_message_cnt /
+                                         channel_info.bundle_cnt)
+                           << " target_bundle_size:" << channel_info.target_bundle_size;
     }
 
     std::this_thread::sleep_for(std::chrono::milliseconds(
@@ -532,6 +704,13 @@ void DataWriter::FlowControlTimer() {
         return;
       }
       ProducerChannelInfo &channel_info = channel_info_map_[output_queue];
+      if (channel_info.batch_lingering &&
+          !ShouldLingerForBatch(channel_info, current_time_ms())) {
+        channel_info.batch_lingering = false;
+        Event event{&channel_info, EventType::FlowEvent,
+                    channel_info.writer_ring_buffer->IsFull()};
+        event_service_->Push(event);
+      }
       if (!channel_info.flow_control) {
         continue;
       }
@@ -553,6 +732,40 @@ void DataWriter::GetOffsetInfo(
 }
 
 void DataWriter::ClearCheckpoint(uint64_t barrier_id) {
+  if (clear_checkpoint_thread_) {
+    {
+      std::lock_guard<std::mutex> lock(clear_checkpoint_mutex_);
+      pending_clear_barrier_ids_.push_back(barrier_id);
+    }
+    clear_checkpoint_cv_.notify_one();
+    return;
+  }
+  ClearCheckpointInternal(barrier_id);
+}
+
+void DataWriter::ClearCheckpointLoop() {
+  while (true) {
+    uint64_t barrier_id;
+    {
+      std::unique_lock<std::mutex> lock(clear_checkpoint_mutex_);
+      clear_checkpoint_cv_.wait_for(lock, std::chrono::milliseconds(100), [this] {
+        return !pending_clear_barrier_ids_.empty() ||
+               runtime_context_->GetRuntimeStatus() != RuntimeStatus::Running;
+      });
+      if (runtime_context_->GetRuntimeStatus() != RuntimeStatus::Running) {
+        return;
+      }
+      if (pending_clear_barrier_ids_.empty()) {
+        continue;
+      }
+      barrier_id = pending_clear_barrier_ids_.front();
+      pending_clear_barrier_ids_.pop_front();
+    }
+    ClearCheckpointInternal(barrier_id);
+  }
+}
+
+void DataWriter::ClearCheckpointInternal(uint64_t barrier_id) {
   if (!barrier_helper_.Contains(barrier_id)) {
     STREAMING_LOG(WARNING) << "no such barrier id => " << barrier_id;
     return;
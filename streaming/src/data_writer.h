@@ -1,6 +1,8 @@
 #pragma once
 
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -10,6 +12,7 @@
 #include "config/streaming_config.h"
 #include "event_service.h"
 #include "flow_control.h"
+#include "message/bundle_codec.h"
 #include "message/message_bundle.h"
 #include "reliability/barrier_helper.h"
 #include "reliability_helper.h"
@@ -63,6 +66,25 @@ class DataWriter {
       const ObjectID &q_id, uint8_t *data, uint32_t data_size,
       StreamingMessageType message_type = StreamingMessageType::Message);
 
+  ///  Write a batch of keyed messages, each to the channel its key hashes to. The
+  ///  partitions of the whole batch are computed first, then the messages of each
+  ///  channel are written to its buffer ring in one pass, which is much cheaper than
+  ///  calling WriteMessageToBufferRing for every message. The messages of a channel
+  ///  keep their order in the batch.
+  ///  \param channel_ids, channels to partition over, partition i goes to channel_ids[i]
+  ///  \param keys, partition key of each message
+  ///  \param data, pointer of raw data of each message
+  ///  \param data_sizes, raw data size of each message
+  ///  \return number of messages written, less than the batch size if writer stopped
+  size_t WritePartitionedMessages(const std::vector<ObjectID> &channel_ids,
+                                  const std::vector<uint64_t> &keys,
+                                  const std::vector<uint8_t *> &data,
+                                  const std::vector<uint32_t> &data_sizes);
+
+  ///  The partition of a key among num_partitions, as WritePartitionedMessages
+  ///  computes it.
+  static uint32_t PartitionOfKey(uint64_t key, uint32_t num_partitions);
+
   /// Send barrier to all channel. note there are user defined data in barrier bundle
   /// \param barrier_id
   /// \param data
@@ -70,6 +92,14 @@ class DataWriter {
   ///
   void BroadcastBarrier(uint64_t barrier_id, const uint8_t *data, uint32_t data_size);
 
+  /// Advance the event time watermark of a channel, that is the promise that no
+  /// message written to the channel from now on has a smaller event time. The
+  /// watermark is carried by the following bundles, including empty ones, so that
+  /// readers merging by event time can make progress. It never goes backwards.
+  /// \param q_id, destination channel id
+  /// \param watermark, event time watermark
+  void UpdateWatermark(const ObjectID &q_id, uint64_t watermark);
+
   /// To relieve stress from large source/input data, we define a new function
   /// clear_check_point
   /// in producer/writer class. Worker can invoke this function if and only if
@@ -77,6 +107,8 @@ class DataWriter {
   /// flag is passed in reader/consumer, which means writer's producing became more
   /// rhythmical and reader
   /// can't walk on old way anymore.
+  /// If async clear checkpoint is enabled, the data is released later in a background
+  /// thread, and this function returns immediately.
   /// \param barrier_id: user-defined numerical checkpoint id
   void ClearCheckpoint(uint64_t barrier_id);
 
@@ -95,6 +127,11 @@ class DataWriter {
  private:
   bool IsMessageAvailableInBuffer(ProducerChannelInfo &channel_info);
 
+  /// Push a message into the buffer ring of a channel, see WriteMessageToBufferRing.
+  /// \param channel_info
+  uint64_t WriteMessageToChannel(ProducerChannelInfo &channel_info, uint8_t *data,
+                                 uint32_t data_size, StreamingMessageType message_type);
+
   /// This function handles two scenarios. When there is data in the transient
   /// buffer, the existing data is written into the channel first, otherwise a
   /// certain amount of message is first collected from the buffer and serialized
@@ -115,6 +152,18 @@ class DataWriter {
 
   bool CollectFromRingBuffer(ProducerChannelInfo &channel_info, uint64_t &buffer_remain);
 
+  /// Re-estimate the arrival rate of a channel, and derive the bundle size that can be
+  /// filled within the target latency.
+  /// \param channel_info
+  /// \param current_ts
+  void UpdateBundleTarget(ProducerChannelInfo &channel_info, int64_t current_ts);
+
+  /// Whether the messages of a channel should wait for more messages to join their
+  /// bundle.
+  /// \param channel_info
+  /// \param current_ts
+  bool ShouldLingerForBatch(ProducerChannelInfo &channel_info, int64_t current_ts);
+
   StreamingStatus WriteChannelProcess(ProducerChannelInfo &channel_info,
                                       bool *is_empty_message);
 
@@ -141,18 +190,35 @@ class DataWriter {
 
   void ClearCheckpointId(ProducerChannelInfo &channel_info, uint64_t seq_id);
 
+  /// Release the data of all channels up to the given barrier.
+  void ClearCheckpointInternal(uint64_t barrier_id);
+
+  /// Release the data of the checkpoints queued by ClearCheckpoint, run by
+  /// clear_checkpoint_thread_.
+  void ClearCheckpointLoop();
+
  private:
   std::shared_ptr<EventService> event_service_;
 
   std::shared_ptr<std::thread> empty_message_thread_;
 
   std::shared_ptr<std::thread> flow_control_thread_;
+
+  std::shared_ptr<std::thread> clear_checkpoint_thread_;
+  // Barrier ids of finished checkpoints whose data is not released yet.
+  std::mutex clear_checkpoint_mutex_;
+  std::condition_variable clear_checkpoint_cv_;
+  std::deque<uint64_t> pending_clear_barrier_ids_;
   // One channel have unique identity.
   std::vector<ObjectID> output_queue_ids_;
   // Flow controller makes a decision when it's should be blocked and avoid
   // unnecessary overflow.
   std::shared_ptr<FlowControl> flow_controller_;
 
+  // Compresses bundles before they are written to channels, only set if compression
+  // is enabled. It's only used by the thread of the event service.
+  std::unique_ptr<BundleCodec> bundle_codec_;
+
   StreamingBarrierHelper barrier_helper_;
   std::shared_ptr<ReliabilityHelper> reliability_helper_;
 
@@ -6,115 +6,184 @@
 namespace ray {
 namespace streaming {
 
-EventQueue::~EventQueue() {
-  is_active_ = false;
-  no_full_cv_.notify_all();
-  no_empty_cv_.notify_all();
-};
+MpscEventRing::MpscEventRing(size_t capacity) {
+  size_t ring_size = 1;
+  while (ring_size < capacity) {
+    ring_size <<= 1;
+  }
+  slots_.reset(new Slot[ring_size]);
+  for (size_t i = 0; i < ring_size; ++i) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  mask_ = ring_size - 1;
+  enqueue_index_.store(0, std::memory_order_relaxed);
+  dequeue_index_ = 0;
+}
+
+bool MpscEventRing::TryPush(const Event &event) {
+  size_t index = enqueue_index_.load(std::memory_order_relaxed);
+  Slot *slot;
+  while (true) {
+    slot = &slots_[index & mask_];
+    size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(index);
+    if (diff == 0) {
+      // The slot is free in this lap, claim it.
+      if (enqueue_index_.compare_exchange_weak(index, index + 1,
+                                               std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // The slot still holds an event of the previous lap.
+      return false;
+    } else {
+      index = enqueue_index_.load(std::memory_order_relaxed);
+    }
+  }
+  slot->event = event;
+  slot->sequence.store(index + 1, std::memory_order_release);
+  return true;
+}
+
+bool MpscEventRing::Front(Event &event) const {
+  const Slot &slot = slots_[dequeue_index_ & mask_];
+  if (slot.sequence.load(std::memory_order_acquire) != dequeue_index_ + 1) {
+    return false;
+  }
+  event = slot.event;
+  return true;
+}
+
+void MpscEventRing::Pop() {
+  Slot &slot = slots_[dequeue_index_ & mask_];
+  // Hand the slot over to the producers of the next lap.
+  slot.sequence.store(dequeue_index_ + mask_ + 1, std::memory_order_release);
+  ++dequeue_index_;
+}
+
+size_t MpscEventRing::PopBatch(std::deque<Event> &events, size_t max_num) {
+  size_t num = 0;
+  Event event;
+  while (num < max_num && Front(event)) {
+    events.push_back(event);
+    Pop();
+    ++num;
+  }
+  return num;
+}
+
+EventQueue::~EventQueue() { Freeze(); };
 
 void EventQueue::Unfreeze() { is_active_ = true; }
 
 void EventQueue::Freeze() {
   is_active_ = false;
+  std::lock_guard<std::mutex> lock(wait_mutex_);
   no_empty_cv_.notify_all();
   no_full_cv_.notify_all();
 }
 
 void EventQueue::Push(const Event &t) {
-  std::unique_lock<std::mutex> lock(ring_buffer_mutex_);
-  while (Size() >= capacity_ && is_active_) {
-    STREAMING_LOG(WARNING) << " EventQueue is full, its size:" << Size()
-                           << " capacity:" << capacity_
-                           << " buffer size:" << buffer_.size()
-                           << " urgent_buffer size:" << urgent_buffer_.size();
-    no_full_cv_.wait(lock);
-    STREAMING_LOG(WARNING) << "Event server is full_sleep be notified";
-  }
-  if (!is_active_) {
-    return;
-  }
-  if (t.urgent) {
-    buffer_.push(t);
-  } else {
-    urgent_buffer_.push(t);
+  // Reserve room for the event, so that the rings can never overflow.
+  size_t size = size_.load();
+  while (true) {
+    if (!is_active_) {
+      return;
+    }
+    if (size < capacity_) {
+      if (size_.compare_exchange_weak(size, size + 1)) {
+        break;
+      }
+      continue;
+    }
+    STREAMING_LOG(WARNING) << " EventQueue is full, its size:" << size
+                           << " capacity:" << capacity_;
+    std::unique_lock<std::mutex> lock(wait_mutex_);
+    ++producers_waiting_;
+    no_full_cv_.wait_for(lock, std::chrono::milliseconds(kConditionTimeoutMs),
+                         [this]() { return !is_active_ || !Full(); });
+    --producers_waiting_;
+    size = size_.load();
   }
-  if (1 == Size()) {
+  bool pushed = t.urgent ? urgent_ring_.TryPush(t) : ring_.TryPush(t);
+  STREAMING_CHECK(pushed) << "Event ring overflows, size " << Size();
+  NotifyNotEmpty();
+}
+
+void EventQueue::NotifyNotEmpty() {
+  // Pairs with the store of consumer_waiting_ in WaitFor, either the consumer sees the
+  // new event or this thread sees that the consumer is waiting.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (consumer_waiting_) {
+    std::lock_guard<std::mutex> lock(wait_mutex_);
     no_empty_cv_.notify_one();
   }
 }
 
 void EventQueue::Pop() {
-  std::unique_lock<std::mutex> lock(ring_buffer_mutex_);
-  if (Size() >= capacity_) {
-    STREAMING_LOG(WARNING) << "Pop should notify"
-                           << " size : " << Size();
-  }
   if (urgent_) {
-    urgent_buffer_.pop();
+    urgent_ring_.Pop();
   } else {
-    buffer_.pop();
+    batch_.pop_front();
+  }
+  --size_;
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (producers_waiting_ > 0) {
+    std::lock_guard<std::mutex> lock(wait_mutex_);
+    no_full_cv_.notify_all();
   }
-  no_full_cv_.notify_all();
 }
 
 constexpr int EventQueue::kConditionTimeoutMs;
-void EventQueue::WaitFor(std::unique_lock<std::mutex> &lock) {
+constexpr size_t EventQueue::kBatchSize;
+void EventQueue::WaitFor() {
   // To avoid deadlock when EventQueue is empty but is_active is changed in other
   // thread, Event queue should awaken this condtion variable and check it again.
   while (is_active_ && Empty()) {
-    int timeout = kConditionTimeoutMs;  // This avoids const & to static (linking error)
-    if (!no_empty_cv_.wait_for(lock, std::chrono::milliseconds(timeout),
+    std::unique_lock<std::mutex> lock(wait_mutex_);
+    consumer_waiting_ = true;
+    if (!no_empty_cv_.wait_for(lock, std::chrono::milliseconds(kConditionTimeoutMs),
                                [this]() { return !is_active_ || !Empty(); })) {
       STREAMING_LOG(DEBUG) << "No empty condition variable wait timeout."
                            << " Empty => " << Empty() << ", is active " << is_active_;
     }
+    consumer_waiting_ = false;
   }
 }
 
 bool EventQueue::Get(Event &evt) {
-  std::unique_lock<std::mutex> lock(ring_buffer_mutex_);
-  WaitFor(lock);
+  WaitFor();
   if (!is_active_) {
     return false;
   }
-  if (!urgent_buffer_.empty()) {
+  if (urgent_ring_.Front(front_)) {
     urgent_ = true;
-    evt = urgent_buffer_.front();
-  } else {
-    urgent_ = false;
-    evt = buffer_.front();
+    evt = front_;
+    return true;
   }
+  urgent_ = false;
+  if (batch_.empty() && ring_.PopBatch(batch_, kBatchSize) == 0) {
+    // A producer has reserved room but not published its event yet.
+    return false;
+  }
+  front_ = batch_.front();
+  evt = front_;
   return true;
 }
 
 Event EventQueue::PopAndGet() {
-  std::unique_lock<std::mutex> lock(ring_buffer_mutex_);
-  WaitFor(lock);
-  if (!is_active_) {
-    // Return error event if queue is active.
-    return Event({nullptr, EventType::ErrorEvent, false});
-  }
-  if (!urgent_buffer_.empty()) {
-    Event res = urgent_buffer_.front();
-    urgent_buffer_.pop();
-    if (Full()) {
-      no_full_cv_.notify_one();
+  Event res;
+  while (!Get(res)) {
+    if (!is_active_) {
+      // Return error event if queue is active.
+      return Event({nullptr, EventType::ErrorEvent, false});
     }
-    return res;
   }
-  Event res = buffer_.front();
-  buffer_.pop();
-  if (Size() + 1 == capacity_) no_full_cv_.notify_one();
+  Pop();
   return res;
 }
 
-Event &EventQueue::Front() {
-  std::unique_lock<std::mutex> lock(ring_buffer_mutex_);
-  if (urgent_buffer_.size()) {
-    return urgent_buffer_.front();
-  }
-  return buffer_.front();
-}
+Event &EventQueue::Front() { return front_; }
 
 EventService::EventService(uint32_t event_size)
     : worker_id_(CoreWorkerProcess::IsInitialized()
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <unordered_map>
 
@@ -46,6 +49,41 @@ struct Event {
   }
 };
 
+/// Bounded multi-producer single-consumer ring of events. Every slot carries a
+/// sequence number that tells whether it is free for a producer or ready for the
+/// consumer, so producers only contend on the enqueue index and the consumer never
+/// takes a lock.
+class MpscEventRing {
+ public:
+  explicit MpscEventRing(size_t capacity);
+
+  /// Called by producers.
+  /// \return false if the ring is full.
+  bool TryPush(const Event &event);
+
+  /// Read the oldest event without removing it, called by the consumer.
+  /// \return false if the ring is empty.
+  bool Front(Event &event) const;
+
+  /// Remove the oldest event, called by the consumer after a successful Front.
+  void Pop();
+
+  /// Move up to `max_num` events to the back of `events`, called by the consumer.
+  /// \return the number of events moved.
+  size_t PopBatch(std::deque<Event> &events, size_t max_num);
+
+ private:
+  struct Slot {
+    std::atomic<size_t> sequence;
+    Event event;
+  };
+
+  std::unique_ptr<Slot[]> slots_;
+  size_t mask_;
+  alignas(64) std::atomic<size_t> enqueue_index_;
+  alignas(64) size_t dequeue_index_;
+};
+
 /// Data writer utilizes what's called an event-driven programming model
 /// that includes two important components: event service and event
 /// queue. In the process of data transmission, the writer will first define
@@ -53,9 +91,21 @@ struct Event {
 /// different events in actual operation, these events will be put into the event
 /// queue, and finally the event server will schedule the previously registered
 /// processing functions ordered by its priority.
+///
+/// Events may be pushed from any thread, but only one thread may get and pop them at
+/// a time. Pushing takes no lock unless the queue is full or the consumer sleeps on an
+/// empty queue.
 class EventQueue {
  public:
-  EventQueue(size_t size) : urgent_(false), capacity_(size), is_active_(true) {}
+  EventQueue(size_t size)
+      : urgent_ring_(size),
+        ring_(size),
+        urgent_(false),
+        capacity_(size),
+        size_(0),
+        is_active_(true),
+        consumer_waiting_(false),
+        producers_waiting_(0) {}
 
   virtual ~EventQueue();
 
@@ -79,34 +129,45 @@ class EventQueue {
 
   /// It mainly divides event into two different levels: normal event and urgent
   /// event, and the total size of the queue is the sum of them.
-  inline size_t Size() const { return buffer_.size() + urgent_buffer_.size(); }
+  inline size_t Size() const { return size_; }
 
  private:
-  /// (NOTE:lingxuan.zlx) There is no strict thread-safe when query empty or full,
-  /// but it can reduce lock contention. In fact, these functions are thread-safe
-  /// when invoked via Push/Pop where buffer size will only be changed in whole process.
-  inline bool Empty() const { return buffer_.empty() && urgent_buffer_.empty(); }
+  inline bool Empty() const { return size_ == 0; }
 
-  inline bool Full() const { return buffer_.size() + urgent_buffer_.size() == capacity_; }
+  inline bool Full() const { return size_ >= capacity_; }
 
   /// Wait for queue util it's timeout or any stuff in.
-  void WaitFor(std::unique_lock<std::mutex> &lock);
+  void WaitFor();
+
+  /// Wake up the consumer if it sleeps on an empty queue.
+  void NotifyNotEmpty();
 
  private:
-  std::mutex ring_buffer_mutex_;
-  std::condition_variable no_empty_cv_;
-  std::condition_variable no_full_cv_;
-  // Normal events wil be pushed into buffer_.
-  std::queue<Event> buffer_;
-  // This field urgent_buffer_ is used for serving urgent event.
-  std::queue<Event> urgent_buffer_;
-  // Urgent event will be poped out first if urgent_ flag is true.
+  // Urgent events are pushed into urgent_ring_, and served before normal events.
+  MpscEventRing urgent_ring_;
+  // Normal events will be pushed into ring_.
+  MpscEventRing ring_;
+  // Normal events taken from ring_ in a batch, only accessed by the consumer.
+  std::deque<Event> batch_;
+  // The event returned by the last Get, only accessed by the consumer.
+  Event front_;
+  // Whether the event returned by the last Get is urgent.
   bool urgent_;
   size_t capacity_;
+  // Number of events in the queue, including those in batch_.
+  std::atomic<size_t> size_;
   // Event service active flag.
-  bool is_active_;
+  std::atomic<bool> is_active_;
+  // Only used to sleep and wake up when the queue is empty or full.
+  std::mutex wait_mutex_;
+  std::condition_variable no_empty_cv_;
+  std::condition_variable no_full_cv_;
+  std::atomic<bool> consumer_waiting_;
+  std::atomic<int> producers_waiting_;
   // Pop/Get timeout ms for condition variables wait.
   static constexpr int kConditionTimeoutMs = 200;
+  // Max number of normal events taken from ring_ at once.
+  static constexpr size_t kBatchSize = 64;
 };
 
 class EventService {
@@ -30,6 +30,25 @@ bool UnconsumedSeqFlowControl::ShouldFlowControl(ProducerChannelInfo &channel_in
   }
   return false;
 }
+
+CreditFlowControl::CreditFlowControl(
+    std::unordered_map<ObjectID, std::shared_ptr<ProducerChannel>> &channel_map,
+    uint32_t credit_bytes)
+    : channel_map_(channel_map), credit_bytes_(credit_bytes) {}
+
+bool CreditFlowControl::ShouldFlowControl(ProducerChannelInfo &channel_info) {
+  channel_map_[channel_info.channel_id]->RefreshChannelInfo();
+  auto &queue_info = channel_info.queue_info;
+  uint64_t credit_bytes = credit_bytes_ > 0 ? credit_bytes_ : channel_info.queue_size;
+  if (queue_info.pushed_bytes >= queue_info.consumed_bytes + credit_bytes) {
+    STREAMING_LOG(DEBUG) << "Flow control stop writing to downstream, pushed bytes => "
+                         << queue_info.pushed_bytes << ", consumed bytes => "
+                         << queue_info.consumed_bytes << ", credit bytes => "
+                         << credit_bytes << ", q id => " << channel_info.channel_id;
+    return true;
+  }
+  return false;
+}
 }  // namespace streaming
 
 }  // namespace ray
@@ -10,6 +10,8 @@ class ProducerTransfer;
 /// api so it can keep fixed length messages in this process, which makes a
 /// continuous datastream in channel or on the transporting way, then downstream
 /// can read them from channel immediately.
+/// Credit flow control bounds the bytes in flight instead, so channels carrying large
+/// bundles do not queue up much more data than channels carrying small ones.
 /// To debug or compare with theses flow control methods, we also support
 /// no-flow-control that will do nothing in transporting.
 class FlowControl {
@@ -40,5 +42,26 @@ class UnconsumedSeqFlowControl : public FlowControl {
   std::unordered_map<ObjectID, std::shared_ptr<ProducerChannel>> &channel_map_;
   uint32_t consumed_step_;
 };
+
+/// Flow control by credits in bytes. The downstream reader reports how many bytes it
+/// has consumed whenever it notifies the upstream queue, and the writer may have at
+/// most `credit_bytes` bytes pushed but not yet consumed. Credits are returned as fast
+/// as the reader consumes, so a slow reader throttles its writer without holding back
+/// the other channels.
+class CreditFlowControl : public FlowControl {
+ public:
+  /// \param credit_bytes Bytes a channel may send ahead of its reader. 0 means the
+  /// size of the channel.
+  CreditFlowControl(
+      std::unordered_map<ObjectID, std::shared_ptr<ProducerChannel>> &channel_map,
+      uint32_t credit_bytes);
+  ~CreditFlowControl() = default;
+  bool ShouldFlowControl(ProducerChannelInfo &channel_info);
+
+ private:
+  /// Reference to channel_map_ variable in DataWriter, see UnconsumedSeqFlowControl.
+  std::unordered_map<ObjectID, std::shared_ptr<ProducerChannel>> &channel_map_;
+  uint32_t credit_bytes_;
+};
 }  // namespace streaming
 }  // namespace ray
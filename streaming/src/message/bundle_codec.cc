@@ -0,0 +1,109 @@
+#include "message/bundle_codec.h"
+
+#include <cstring>
+
+#include "util/streaming_logging.h"
+
+namespace ray {
+namespace streaming {
+
+BundleCodec::BundleCodec(int level, const std::string &dictionary)
+    : dictionary_(dictionary) {
+  std::memset(&deflate_stream_, 0, sizeof(deflate_stream_));
+  std::memset(&inflate_stream_, 0, sizeof(inflate_stream_));
+  STREAMING_CHECK(deflateInit(&deflate_stream_, level) == Z_OK);
+  STREAMING_CHECK(inflateInit(&inflate_stream_) == Z_OK);
+}
+
+BundleCodec::~BundleCodec() {
+  deflateEnd(&deflate_stream_);
+  inflateEnd(&inflate_stream_);
+}
+
+uint32_t BundleCodec::Compress(uint8_t *bundle, uint32_t bundle_size) {
+  STREAMING_CHECK(bundle_size >= kMessageBundleHeaderSize);
+  const uint32_t raw_size = bundle_size - kMessageBundleHeaderSize;
+  if (raw_size < kMinCompressedRawSize ||
+      !StreamingMessageBundleMeta::CheckBundleMagicNum(bundle) ||
+      StreamingMessageBundleMeta::IsCompressed(bundle)) {
+    return bundle_size;
+  }
+  uint8_t *raw_data = bundle + kMessageBundleHeaderSize;
+
+  STREAMING_CHECK(deflateReset(&deflate_stream_) == Z_OK);
+  if (!dictionary_.empty()) {
+    STREAMING_CHECK(deflateSetDictionary(
+                        &deflate_stream_,
+                        reinterpret_cast<const Bytef *>(dictionary_.data()),
+                        dictionary_.size()) == Z_OK);
+  }
+  scratch_.resize(deflateBound(&deflate_stream_, raw_size));
+  deflate_stream_.next_in = raw_data;
+  deflate_stream_.avail_in = raw_size;
+  deflate_stream_.next_out = scratch_.data();
+  deflate_stream_.avail_out = scratch_.size();
+  STREAMING_CHECK(deflate(&deflate_stream_, Z_FINISH) == Z_STREAM_END);
+  const uint32_t compressed_size = deflate_stream_.total_out;
+  if (kCompressedRawHeaderSize + compressed_size >= raw_size) {
+    return bundle_size;
+  }
+
+  const uint32_t magic_num =
+      StreamingMessageBundleMeta::StreamingMessageBundleCompressedMagicNum;
+  std::memcpy(bundle, &magic_num, sizeof(magic_num));
+  const uint32_t compressed_raw_size = kCompressedRawHeaderSize + compressed_size;
+  std::memcpy(bundle + kMessageBundleMetaHeaderSize, &compressed_raw_size,
+              sizeof(compressed_raw_size));
+  const uint32_t codec = static_cast<uint32_t>(StreamingBundleCodecType::Zlib);
+  std::memcpy(raw_data, &codec, sizeof(codec));
+  std::memcpy(raw_data + sizeof(codec), &raw_size, sizeof(raw_size));
+  std::memcpy(raw_data + kCompressedRawHeaderSize, scratch_.data(), compressed_size);
+  return kMessageBundleHeaderSize + compressed_raw_size;
+}
+
+uint32_t BundleCodec::DecompressedSize(const uint8_t *bundle) {
+  STREAMING_CHECK(StreamingMessageBundleMeta::IsCompressed(bundle));
+  uint32_t raw_size;
+  std::memcpy(&raw_size, bundle + kMessageBundleHeaderSize + sizeof(uint32_t),
+              sizeof(raw_size));
+  return kMessageBundleHeaderSize + raw_size;
+}
+
+void BundleCodec::Decompress(const uint8_t *bundle, uint8_t *out) {
+  const uint8_t *raw_data = bundle + kMessageBundleHeaderSize;
+  uint32_t compressed_raw_size;
+  std::memcpy(&compressed_raw_size, bundle + kMessageBundleMetaHeaderSize,
+              sizeof(compressed_raw_size));
+  uint32_t codec;
+  std::memcpy(&codec, raw_data, sizeof(codec));
+  STREAMING_CHECK(codec == static_cast<uint32_t>(StreamingBundleCodecType::Zlib))
+      << "Unknown bundle codec " << codec;
+  const uint32_t raw_size = DecompressedSize(bundle) - kMessageBundleHeaderSize;
+
+  std::memcpy(out, bundle, kMessageBundleHeaderSize);
+  const uint32_t magic_num = StreamingMessageBundleMeta::StreamingMessageBundleMagicNum;
+  std::memcpy(out, &magic_num, sizeof(magic_num));
+  std::memcpy(out + kMessageBundleMetaHeaderSize, &raw_size, sizeof(raw_size));
+
+  STREAMING_CHECK(inflateReset(&inflate_stream_) == Z_OK);
+  inflate_stream_.next_in = const_cast<Bytef *>(raw_data + kCompressedRawHeaderSize);
+  inflate_stream_.avail_in = compressed_raw_size - kCompressedRawHeaderSize;
+  inflate_stream_.next_out = out + kMessageBundleHeaderSize;
+  inflate_stream_.avail_out = raw_size;
+  int result = inflate(&inflate_stream_, Z_FINISH);
+  if (result == Z_NEED_DICT) {
+    STREAMING_CHECK(!dictionary_.empty())
+        << "The bundle was compressed with a dictionary, but none is configured";
+    STREAMING_CHECK(inflateSetDictionary(
+                        &inflate_stream_,
+                        reinterpret_cast<const Bytef *>(dictionary_.data()),
+                        dictionary_.size()) == Z_OK)
+        << "The bundle was compressed with a different dictionary";
+    result = inflate(&inflate_stream_, Z_FINISH);
+  }
+  STREAMING_CHECK(result == Z_STREAM_END && inflate_stream_.total_out == raw_size)
+      << "Failed to decompress bundle, zlib result " << result;
+}
+
+}  // namespace streaming
+}  // namespace ray
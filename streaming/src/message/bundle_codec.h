@@ -0,0 +1,70 @@
+#pragma once
+
+#include <zlib.h>
+
+#include <string>
+#include <vector>
+
+#include "message/message_bundle.h"
+
+namespace ray {
+namespace streaming {
+
+enum class StreamingBundleCodecType : uint32_t { None = 0, Zlib = 1 };
+
+/// BundleCodec compresses the raw data of serialized message bundles, so that fewer
+/// bytes are sent between nodes. A compressed bundle keeps the header of the bundle,
+/// but with StreamingMessageBundleCompressedMagicNum, and its RawBundleSize is the
+/// size of the compressed raw data, with the following layout:
+///
+///  +-----------------------+
+///  | Codec=U32             |
+///  +-----------------------+
+///  | UncompressedSize=U32  |
+///  +-----------------------+
+///  | CompressedData=var    |
+///  +-----------------------+
+///
+/// A preset dictionary of content common to the messages lets small bundles compress
+/// well. The writer and the readers of a channel must use the same dictionary.
+class BundleCodec {
+ public:
+  /// \param level zlib compression level from 1 (fastest) to 9 (smallest)
+  /// \param dictionary preset dictionary, none if empty
+  BundleCodec(int level, const std::string &dictionary);
+
+  ~BundleCodec();
+
+  BundleCodec(const BundleCodec &) = delete;
+  BundleCodec &operator=(const BundleCodec &) = delete;
+
+  /// Compress the raw data of a serialized bundle in place. The bundle is left as is
+  /// if it is empty, too small, or compression doesn't make it smaller.
+  /// \param bundle serialized bundle
+  /// \param bundle_size size of the serialized bundle
+  /// \return size of the bundle after compression
+  uint32_t Compress(uint8_t *bundle, uint32_t bundle_size);
+
+  /// Size of a compressed serialized bundle once it is decompressed.
+  static uint32_t DecompressedSize(const uint8_t *bundle);
+
+  /// Decompress a compressed serialized bundle.
+  /// \param bundle compressed serialized bundle
+  /// \param out buffer of DecompressedSize(bundle) bytes for the bundle
+  void Decompress(const uint8_t *bundle, uint8_t *out);
+
+  /// Raw data smaller than this isn't worth compressing.
+  static constexpr uint32_t kMinCompressedRawSize = 64;
+  /// Size of the codec and uncompressed size fields before the compressed data.
+  static constexpr uint32_t kCompressedRawHeaderSize = 2 * sizeof(uint32_t);
+
+ private:
+  const std::string dictionary_;
+  z_stream deflate_stream_;
+  z_stream inflate_stream_;
+  /// Compressed output, reused across bundles.
+  std::vector<uint8_t> scratch_;
+};
+
+}  // namespace streaming
+}  // namespace ray
@@ -59,6 +59,22 @@ StreamingMessagePtr StreamingMessage::FromBytes(const uint8_t *bytes,
   return std::make_shared<StreamingMessage>(data_ptr, data_size, msg_id, msg_type);
 }
 
+StreamingMessageView StreamingMessageView::FromBytes(const uint8_t *bytes) {
+  StreamingMessageView view;
+  uint32_t byte_offset = 0;
+  view.payload_size = *reinterpret_cast<const uint32_t *>(bytes + byte_offset);
+  byte_offset += sizeof(view.payload_size);
+
+  view.message_id = *reinterpret_cast<const uint64_t *>(bytes + byte_offset);
+  byte_offset += sizeof(view.message_id);
+
+  view.message_type = *reinterpret_cast<const StreamingMessageType *>(bytes + byte_offset);
+  byte_offset += sizeof(view.message_type);
+
+  view.payload = bytes + byte_offset;
+  return view;
+}
+
 void StreamingMessage::ToBytes(uint8_t *serlizable_data) {
   uint32_t byte_offset = 0;
   std::memcpy(serlizable_data + byte_offset, reinterpret_cast<char *>(&payload_size_),
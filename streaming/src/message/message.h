@@ -139,5 +139,19 @@ class StreamingMessage {
   friend std::ostream &operator<<(std::ostream &os, const StreamingMessage &message);
 };
 
+/// A message parsed in place from its serialized bytes, without copying the payload.
+/// It is only valid as long as the bytes are.
+struct StreamingMessageView {
+  const uint8_t *payload = nullptr;
+  uint32_t payload_size = 0;
+  uint64_t message_id = 0;
+  StreamingMessageType message_type = StreamingMessageType::Message;
+
+  inline uint32_t ClassBytesSize() const { return kMessageHeaderSize + payload_size; }
+
+  /// Parse a message serialized by StreamingMessage::ToBytes.
+  static StreamingMessageView FromBytes(const uint8_t *bytes);
+};
+
 }  // namespace streaming
 }  // namespace ray
@@ -56,7 +56,8 @@ bool StreamingMessageBundleMeta::operator==(StreamingMessageBundleMeta &meta) co
   return this->message_list_size_ == meta.GetMessageListSize() &&
          this->message_bundle_ts_ == meta.GetMessageBundleTs() &&
          this->bundle_type_ == meta.GetBundleType() &&
-         this->last_message_id_ == meta.GetLastMessageId();
+         this->last_message_id_ == meta.GetLastMessageId() &&
+         this->watermark_ == meta.GetWatermark();
 }
 
 bool StreamingMessageBundleMeta::operator==(StreamingMessageBundleMeta *meta) const {
@@ -67,7 +68,8 @@ std::ostream &operator<<(std::ostream &os, const StreamingMessageBundleMeta &met
   os << "{"
      << "last_message_id_: " << meta.last_message_id_
      << ", message_list_size_: " << meta.message_list_size_
-     << ", bundle_type_: " << static_cast<int>(meta.bundle_type_) << "}";
+     << ", bundle_type_: " << static_cast<int>(meta.bundle_type_)
+     << ", watermark_: " << meta.watermark_ << "}";
   return os;
 }
 
@@ -104,6 +106,7 @@ StreamingMessageBundle::StreamingMessageBundle(StreamingMessageBundle &bundle) {
   raw_bundle_size_ = bundle.raw_bundle_size_;
   bundle_type_ = bundle.bundle_type_;
   last_message_id_ = bundle.last_message_id_;
+  watermark_ = bundle.watermark_;
   message_list_ = bundle.message_list_;
 }
 
@@ -142,6 +145,7 @@ StreamingMessageBundlePtr StreamingMessageBundle::FromBytes(const uint8_t *bytes
   auto result = std::make_shared<StreamingMessageBundle>(
       message_list, meta_ptr->GetMessageBundleTs(), meta_ptr->GetLastMessageId(),
       meta_ptr->GetBundleType());
+  result->SetWatermark(meta_ptr->GetWatermark());
   STREAMING_CHECK(byte_offset == result->ClassBytesSize());
   return result;
 }
@@ -159,6 +163,18 @@ void StreamingMessageBundle::GetMessageListFromRawData(
   STREAMING_CHECK(byte_offset == byte_size);
 }
 
+void StreamingMessageBundle::GetMessageViewsFromRawData(
+    const uint8_t *bytes, uint32_t byte_size, uint32_t message_list_size,
+    std::vector<StreamingMessageView> &message_views) {
+  uint32_t byte_offset = 0;
+  message_views.reserve(message_views.size() + message_list_size);
+  for (size_t i = 0; i < message_list_size; ++i) {
+    message_views.push_back(StreamingMessageView::FromBytes(bytes + byte_offset));
+    byte_offset += message_views.back().ClassBytesSize();
+  }
+  STREAMING_CHECK(byte_offset == byte_size);
+}
+
 void StreamingMessageBundle::GetMessageList(
     std::list<StreamingMessagePtr> &message_list) {
   message_list = message_list_;
@@ -5,6 +5,7 @@
 #include <memory>
 #include <numeric>
 #include <string>
+#include <vector>
 
 #include "message/message.h"
 #include "ray/common/id.h"
@@ -26,9 +27,9 @@ class StreamingMessageBundle;
 typedef std::shared_ptr<StreamingMessageBundle> StreamingMessageBundlePtr;
 typedef std::shared_ptr<StreamingMessageBundleMeta> StreamingMessageBundleMetaPtr;
 
-constexpr uint32_t kMessageBundleMetaHeaderSize = sizeof(uint32_t) + sizeof(uint32_t) +
-                                                  sizeof(uint64_t) + sizeof(uint64_t) +
-                                                  sizeof(StreamingMessageBundleType);
+constexpr uint32_t kMessageBundleMetaHeaderSize =
+    sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint64_t) +
+    sizeof(StreamingMessageBundleType) + sizeof(uint64_t);
 
 constexpr uint32_t kMessageBundleHeaderSize =
     kMessageBundleMetaHeaderSize + sizeof(uint32_t);
@@ -36,6 +37,8 @@ constexpr uint32_t kMessageBundleHeaderSize =
 class StreamingMessageBundleMeta {
  public:
   static const uint32_t StreamingMessageBundleMagicNum = 0xCAFEBABA;
+  /// Magic number of bundles whose raw data is compressed, see BundleCodec.
+  static const uint32_t StreamingMessageBundleCompressedMagicNum = 0xCAFEBABC;
 
  protected:
   uint64_t message_bundle_ts_;
@@ -46,6 +49,10 @@ class StreamingMessageBundleMeta {
 
   StreamingMessageBundleType bundle_type_;
 
+  /// Event time watermark of the channel when the bundle was collected, the writer
+  /// promises that no later bundle of the channel carries a smaller watermark.
+  uint64_t watermark_ = 0;
+
  private:
   /// To speed up memory copy and serilization, we use memory layout of compiler related
   /// member variables. It's must be modified if any field is going to be inserted before
@@ -82,6 +89,10 @@ class StreamingMessageBundleMeta {
 
   inline StreamingMessageBundleType GetBundleType() const { return bundle_type_; }
 
+  inline uint64_t GetWatermark() const { return watermark_; }
+
+  inline void SetWatermark(uint64_t watermark) { watermark_ = watermark; }
+
   inline bool IsBarrier() { return StreamingMessageBundleType::Barrier == bundle_type_; }
   inline bool IsBundle() { return StreamingMessageBundleType::Bundle == bundle_type_; }
   inline bool IsEmptyMsg() { return StreamingMessageBundleType::Empty == bundle_type_; }
@@ -93,7 +104,13 @@ class StreamingMessageBundleMeta {
 
   inline static bool CheckBundleMagicNum(const uint8_t *bytes) {
     const uint32_t *magic_num = reinterpret_cast<const uint32_t *>(bytes);
-    return *magic_num == StreamingMessageBundleMagicNum;
+    return *magic_num == StreamingMessageBundleMagicNum ||
+           *magic_num == StreamingMessageBundleCompressedMagicNum;
+  }
+
+  inline static bool IsCompressed(const uint8_t *bytes) {
+    const uint32_t *magic_num = reinterpret_cast<const uint32_t *>(bytes);
+    return *magic_num == StreamingMessageBundleCompressedMagicNum;
   }
 
   std::string ToString() {
@@ -111,6 +128,7 @@ class StreamingMessageBundleMeta {
 /// (milliseconds from 1970) LastMessageId( the last id of bundle) (0,INF]
 /// MessageListSize(bundle len of message)
 /// BundleType(a. bundle = 3 , b. barrier =2, c. empty = 1)
+/// Watermark(64bits event time watermark of the channel)
 /// RawBundleSize（binary length of data)
 /// RawData ( binary data)
 ///
@@ -178,6 +196,11 @@ class StreamingMessageBundle : public StreamingMessageBundleMeta {
                                         uint32_t message_list_size,
                                         std::list<StreamingMessagePtr> &message_list);
 
+  /// Parse the messages of a bundle's raw data in place, without copying them.
+  static void GetMessageViewsFromRawData(const uint8_t *bytes, uint32_t bytes_size,
+                                         uint32_t message_list_size,
+                                         std::vector<StreamingMessageView> &message_views);
+
   static void ConvertMessageListToRawData(
       const std::list<StreamingMessagePtr> &message_list, uint32_t raw_data_size,
       uint8_t *raw_data);
@@ -192,6 +215,9 @@ struct DataBundle {
   uint32_t last_barrier_id;
   StreamingMessageBundleMetaPtr meta;
   bool is_reallocated = false;
+  /// Event time watermark the reader merges the bundle by, which is the watermark of
+  /// the bundle unless its channel is idle.
+  uint64_t merge_watermark = 0;
 
   ~DataBundle() {
     if (is_reallocated) {
@@ -0,0 +1,239 @@
+#include "queue/local_transport.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+namespace ray {
+namespace streaming {
+
+/// Longest time a send waits for the consumer to free space in a full ring, before
+/// falling back to a direct actor call.
+static constexpr int64_t LOCAL_SEND_TIMEOUT_MS = 1000;
+/// Longest time the receiver sleeps between two polls of an idle ring.
+static constexpr int64_t LOCAL_RECEIVE_MAX_IDLE_US = 1000;
+
+struct ShmRing::Header {
+  /// Indices only grow, and are taken modulo the capacity to address the ring. They are
+  /// kept on separate cache lines, since they are written by different processes.
+  alignas(64) std::atomic<uint64_t> write_index;
+  alignas(64) std::atomic<uint64_t> read_index;
+  alignas(64) uint64_t capacity;
+  std::atomic<bool> closed;
+};
+
+std::string ShmRing::PathOf(const ObjectID &queue_id) {
+  return "/dev/shm/ray_streaming_queue_" + queue_id.Hex();
+}
+
+std::shared_ptr<ShmRing> ShmRing::Create(const ObjectID &queue_id, uint64_t capacity) {
+  std::string path = PathOf(queue_id);
+  // Build the ring under a temporary name, and rename it once initialized, so that a
+  // producer never opens a partially initialized ring.
+  std::string tmp_path = path + "." + std::to_string(getpid());
+  int fd = open(tmp_path.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+  if (fd < 0) {
+    STREAMING_LOG(WARNING) << "Failed to create shared memory ring " << tmp_path << ", "
+                           << strerror(errno);
+    return nullptr;
+  }
+  uint64_t map_size = sizeof(Header) + capacity;
+  void *base = MAP_FAILED;
+  if (ftruncate(fd, map_size) == 0) {
+    base = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  if (base == MAP_FAILED) {
+    STREAMING_LOG(WARNING) << "Failed to map shared memory ring " << tmp_path << ", "
+                           << strerror(errno);
+    close(fd);
+    unlink(tmp_path.c_str());
+    return nullptr;
+  }
+  Header *header = new (base) Header();
+  header->capacity = capacity;
+  if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+    STREAMING_LOG(WARNING) << "Failed to publish shared memory ring " << path << ", "
+                           << strerror(errno);
+    munmap(base, map_size);
+    close(fd);
+    unlink(tmp_path.c_str());
+    return nullptr;
+  }
+  STREAMING_LOG(INFO) << "Created shared memory ring " << path << ", capacity "
+                      << capacity;
+  return std::shared_ptr<ShmRing>(
+      new ShmRing(path, fd, static_cast<uint8_t *>(base), map_size, true));
+}
+
+std::shared_ptr<ShmRing> ShmRing::Open(const ObjectID &queue_id) {
+  std::string path = PathOf(queue_id);
+  int fd = open(path.c_str(), O_RDWR);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 ||
+      static_cast<uint64_t>(file_stat.st_size) <= sizeof(Header)) {
+    close(fd);
+    return nullptr;
+  }
+  uint64_t map_size = file_stat.st_size;
+  void *base = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) {
+    close(fd);
+    return nullptr;
+  }
+  auto ring = std::shared_ptr<ShmRing>(
+      new ShmRing(path, fd, static_cast<uint8_t *>(base), map_size, false));
+  if (sizeof(Header) + ring->Capacity() != map_size || ring->IsClosed()) {
+    return nullptr;
+  }
+  STREAMING_LOG(INFO) << "Opened shared memory ring " << path;
+  return ring;
+}
+
+ShmRing::ShmRing(const std::string &path, int fd, uint8_t *base, uint64_t map_size,
+                 bool is_owner)
+    : path_(path),
+      fd_(fd),
+      base_(base),
+      map_size_(map_size),
+      header_(reinterpret_cast<Header *>(base)),
+      data_(base + sizeof(Header)),
+      is_owner_(is_owner) {}
+
+ShmRing::~ShmRing() {
+  if (is_owner_) {
+    // Only remove the file if it is still ours, a newer consumer of the same queue may
+    // have replaced it.
+    struct stat own_stat;
+    struct stat path_stat;
+    if (fstat(fd_, &own_stat) == 0 && stat(path_.c_str(), &path_stat) == 0 &&
+        own_stat.st_ino == path_stat.st_ino) {
+      unlink(path_.c_str());
+    }
+  }
+  munmap(base_, map_size_);
+  close(fd_);
+}
+
+bool ShmRing::Write(const uint8_t *data, uint32_t size) {
+  uint64_t record_size = sizeof(uint32_t) + size;
+  uint64_t write_index = header_->write_index.load(std::memory_order_relaxed);
+  uint64_t read_index = header_->read_index.load(std::memory_order_acquire);
+  if (write_index - read_index + record_size > Capacity()) {
+    return false;
+  }
+  CopyIn(write_index, reinterpret_cast<const uint8_t *>(&size), sizeof(uint32_t));
+  CopyIn(write_index + sizeof(uint32_t), data, size);
+  header_->write_index.store(write_index + record_size, std::memory_order_release);
+  return true;
+}
+
+std::shared_ptr<LocalMemoryBuffer> ShmRing::Read() {
+  uint64_t read_index = header_->read_index.load(std::memory_order_relaxed);
+  uint64_t write_index = header_->write_index.load(std::memory_order_acquire);
+  if (read_index == write_index) {
+    return nullptr;
+  }
+  uint32_t size = 0;
+  CopyOut(read_index, reinterpret_cast<uint8_t *>(&size), sizeof(uint32_t));
+  auto buffer = std::make_shared<LocalMemoryBuffer>(static_cast<size_t>(size));
+  CopyOut(read_index + sizeof(uint32_t), buffer->Data(), size);
+  header_->read_index.store(read_index + sizeof(uint32_t) + size,
+                            std::memory_order_release);
+  return buffer;
+}
+
+void ShmRing::Close() { header_->closed.store(true, std::memory_order_release); }
+
+bool ShmRing::IsClosed() const { return header_->closed.load(std::memory_order_acquire); }
+
+uint64_t ShmRing::Capacity() const { return header_->capacity; }
+
+void ShmRing::CopyIn(uint64_t index, const uint8_t *data, uint64_t size) {
+  uint64_t offset = index % Capacity();
+  uint64_t first_part = std::min(size, Capacity() - offset);
+  std::memcpy(data_ + offset, data, first_part);
+  std::memcpy(data_, data + first_part, size - first_part);
+}
+
+void ShmRing::CopyOut(uint64_t index, uint8_t *data, uint64_t size) const {
+  uint64_t offset = index % Capacity();
+  uint64_t first_part = std::min(size, Capacity() - offset);
+  std::memcpy(data, data_ + offset, first_part);
+  std::memcpy(data + first_part, data_, size - first_part);
+}
+
+bool LocalTransport::ConnectLocal(const ObjectID &queue_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  ring_ = ShmRing::Open(queue_id);
+  return ring_ != nullptr;
+}
+
+void LocalTransport::Send(std::shared_ptr<LocalMemoryBuffer> buffer) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (ring_ != nullptr) {
+      if (sizeof(uint32_t) + buffer->Size() > ring_->Capacity()) {
+        STREAMING_LOG(WARNING) << "Message of " << buffer->Size()
+                               << " bytes does not fit in the shared memory ring of "
+                               << ring_->Capacity() << " bytes, send it by actor call.";
+      } else {
+        int64_t start_ms = current_time_ms();
+        while (!ring_->IsClosed()) {
+          if (ring_->Write(buffer->Data(), buffer->Size())) {
+            return;
+          }
+          if (current_time_ms() - start_ms > LOCAL_SEND_TIMEOUT_MS) {
+            break;
+          }
+          std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        STREAMING_LOG(WARNING) << "Shared memory ring is closed or stays full, fall "
+                                  "back to actor calls.";
+        ring_.reset();
+      }
+    }
+  }
+  Transport::Send(std::move(buffer));
+}
+
+LocalTransportReceiver::LocalTransportReceiver(
+    std::shared_ptr<ShmRing> ring,
+    std::function<void(std::shared_ptr<LocalMemoryBuffer>)> callback)
+    : ring_(std::move(ring)), callback_(std::move(callback)), stopped_(false) {
+  thread_ = std::thread(&LocalTransportReceiver::Run, this);
+}
+
+LocalTransportReceiver::~LocalTransportReceiver() {
+  ring_->Close();
+  stopped_ = true;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void LocalTransportReceiver::Run() {
+  int64_t idle_us = 0;
+  while (!stopped_) {
+    auto buffer = ring_->Read();
+    if (buffer != nullptr) {
+      callback_(std::move(buffer));
+      idle_us = 0;
+      continue;
+    }
+    // Back off while the ring stays idle, to bound the cost of polling.
+    idle_us = std::min(std::max<int64_t>(idle_us * 2, 10), LOCAL_RECEIVE_MAX_IDLE_US);
+    std::this_thread::sleep_for(std::chrono::microseconds(idle_us));
+  }
+}
+
+}  // namespace streaming
+}  // namespace ray
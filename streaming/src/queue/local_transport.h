@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "queue/transport.h"
+
+namespace ray {
+namespace streaming {
+
+/// ShmRing is a single producer single consumer ring of byte records, kept in a file
+/// under /dev/shm so that two actors on the same node can exchange messages without
+/// submitting a task per message. The ring is created by the consumer and opened by the
+/// producer. A ring can only be opened on the node where it was created, which is how
+/// the producer finds out that its peer is co-located.
+class ShmRing {
+ public:
+  /// Create a ring for the given queue, replacing any stale ring of the same queue.
+  /// \param[in] queue_id id of the queue the ring belongs to.
+  /// \param[in] capacity size of the ring in bytes.
+  /// \return the ring, or nullptr if shared memory is not available.
+  static std::shared_ptr<ShmRing> Create(const ObjectID &queue_id, uint64_t capacity);
+
+  /// Open the ring of the given queue created by a consumer on the same node.
+  /// \param[in] queue_id id of the queue the ring belongs to.
+  /// \return the ring, or nullptr if there is no such ring on this node.
+  static std::shared_ptr<ShmRing> Open(const ObjectID &queue_id);
+
+  ~ShmRing();
+
+  /// Append a record to the ring.
+  /// \return false if there is not enough free space for the record.
+  bool Write(const uint8_t *data, uint32_t size);
+
+  /// Remove the oldest record from the ring.
+  /// \return the record, or nullptr if the ring is empty.
+  std::shared_ptr<LocalMemoryBuffer> Read();
+
+  /// Mark the ring as closed by the consumer, producers stop writing to it.
+  void Close();
+
+  bool IsClosed() const;
+
+  uint64_t Capacity() const;
+
+ private:
+  struct Header;
+
+  ShmRing(const std::string &path, int fd, uint8_t *base, uint64_t map_size,
+          bool is_owner);
+
+  static std::string PathOf(const ObjectID &queue_id);
+
+  /// Copy bytes into or out of the ring at a monotonically increasing index, wrapping
+  /// around the end of the ring.
+  void CopyIn(uint64_t index, const uint8_t *data, uint64_t size);
+  void CopyOut(uint64_t index, uint8_t *data, uint64_t size) const;
+
+  std::string path_;
+  int fd_;
+  uint8_t *base_;
+  uint64_t map_size_;
+  Header *header_;
+  uint8_t *data_;
+  /// Whether this process created the ring, and should remove it on destruction.
+  bool is_owner_;
+};
+
+/// LocalTransport sends asynchronous messages through the ShmRing of a queue once it is
+/// connected, and falls back to direct actor calls otherwise. Synchronous calls always
+/// go through direct actor calls.
+class LocalTransport : public Transport {
+ public:
+  LocalTransport(const ActorID &peer_actor_id, RayFunction &async_func,
+                 RayFunction &sync_func)
+      : Transport(peer_actor_id, async_func, sync_func) {}
+
+  virtual ~LocalTransport() = default;
+
+  /// Look up the ring of a queue on this node, and send the following messages through
+  /// it if found. Called when the downstream queue pulls, so that the messages sent
+  /// after the pull follow the pull response in order.
+  /// \param[in] queue_id id of the queue.
+  /// \return whether the transport is connected to a local ring.
+  bool ConnectLocal(const ObjectID &queue_id);
+
+  virtual void Send(std::shared_ptr<LocalMemoryBuffer> buffer) override;
+
+ private:
+  std::mutex mutex_;
+  std::shared_ptr<ShmRing> ring_;
+};
+
+/// LocalTransportReceiver polls a ShmRing in a separate thread, and hands the received
+/// messages to a callback.
+class LocalTransportReceiver {
+ public:
+  LocalTransportReceiver(
+      std::shared_ptr<ShmRing> ring,
+      std::function<void(std::shared_ptr<LocalMemoryBuffer>)> callback);
+
+  ~LocalTransportReceiver();
+
+ private:
+  void Run();
+
+  std::shared_ptr<ShmRing> ring_;
+  std::function<void(std::shared_ptr<LocalMemoryBuffer>)> callback_;
+  std::atomic<bool> stopped_;
+  std::thread thread_;
+};
+
+}  // namespace streaming
+}  // namespace ray
@@ -61,7 +61,8 @@ void DataMessage::ToProtobuf(std::string *output) {
   msg.SerializeToString(output);
 }
 
-std::shared_ptr<DataMessage> DataMessage::FromBytes(uint8_t *bytes) {
+std::shared_ptr<DataMessage> DataMessage::FromBytes(
+    uint8_t *bytes, std::shared_ptr<LocalMemoryBuffer> owner) {
   uint64_t *fbs_length = (uint64_t *)(bytes + kItemMetaHeaderSize);
   bytes += kItemHeaderSize;
   std::string inputpb(reinterpret_cast<char const *>(bytes), *fbs_length);
@@ -77,9 +78,10 @@ std::shared_ptr<DataMessage> DataMessage::FromBytes(uint8_t *bytes) {
   bool raw = message.raw();
   bytes += *fbs_length;
 
-  /// Copy data and create a new buffer for streaming queue.
+  /// Reference the received buffer if it is owned, otherwise copy the data.
   std::shared_ptr<LocalMemoryBuffer> buffer =
-      std::make_shared<LocalMemoryBuffer>(bytes, (size_t)length, true);
+      owner != nullptr ? MakeBufferRef(owner, bytes, (size_t)length)
+                       : std::make_shared<LocalMemoryBuffer>(bytes, (size_t)length, true);
   std::shared_ptr<DataMessage> data_msg =
       std::make_shared<DataMessage>(src_actor_id, dst_actor_id, queue_id, seq_id,
                                     msg_id_start, msg_id_end, buffer, raw);
@@ -91,6 +93,7 @@ void NotificationMessage::ToProtobuf(std::string *output) {
   queue::protobuf::StreamingQueueNotificationMsg msg;
   FillMessageCommon(msg.mutable_common());
   msg.set_seq_id(msg_id_);
+  msg.set_consumed_bytes(consumed_bytes_);
   msg.SerializeToString(output);
 }
 
@@ -105,8 +108,8 @@ std::shared_ptr<NotificationMessage> NotificationMessage::FromBytes(uint8_t *byt
   ObjectID queue_id = ObjectID::FromBinary(message.common().queue_id());
   uint64_t seq_id = message.seq_id();
 
-  std::shared_ptr<NotificationMessage> notify_msg =
-      std::make_shared<NotificationMessage>(src_actor_id, dst_actor_id, queue_id, seq_id);
+  std::shared_ptr<NotificationMessage> notify_msg = std::make_shared<NotificationMessage>(
+      src_actor_id, dst_actor_id, queue_id, seq_id, message.consumed_bytes());
 
   return notify_msg;
 }
@@ -233,7 +236,8 @@ void ResendDataMessage::ToProtobuf(std::string *output) {
   msg.SerializeToString(output);
 }
 
-std::shared_ptr<ResendDataMessage> ResendDataMessage::FromBytes(uint8_t *bytes) {
+std::shared_ptr<ResendDataMessage> ResendDataMessage::FromBytes(
+    uint8_t *bytes, std::shared_ptr<LocalMemoryBuffer> owner) {
   uint64_t *fbs_length = (uint64_t *)(bytes + kItemMetaHeaderSize);
   bytes += kItemHeaderSize;
   std::string inputpb(reinterpret_cast<char const *>(bytes), *fbs_length);
@@ -258,9 +262,9 @@ std::shared_ptr<ResendDataMessage> ResendDataMessage::FromBytes(uint8_t *bytes)
                        << " queue_id:" << queue_id << " length:" << length;
 
   bytes += *fbs_length;
-  /// COPY
   std::shared_ptr<LocalMemoryBuffer> buffer =
-      std::make_shared<LocalMemoryBuffer>(bytes, (size_t)length, true);
+      owner != nullptr ? MakeBufferRef(owner, bytes, (size_t)length)
+                       : std::make_shared<LocalMemoryBuffer>(bytes, (size_t)length, true);
   std::shared_ptr<ResendDataMessage> pull_data_msg = std::make_shared<ResendDataMessage>(
       src_actor_id, dst_actor_id, queue_id, first_seq_id, seq_id, msg_id_start,
       msg_id_end, last_seq_id, buffer, raw);
@@ -8,6 +8,16 @@
 namespace ray {
 namespace streaming {
 
+/// Wrap `size` bytes at `data` in a buffer without copying them. `owner` owns the
+/// bytes, and is kept alive for as long as the returned buffer is referenced.
+template <typename T>
+std::shared_ptr<LocalMemoryBuffer> MakeBufferRef(std::shared_ptr<T> owner, uint8_t *data,
+                                                 size_t size) {
+  return std::shared_ptr<LocalMemoryBuffer>(
+      new LocalMemoryBuffer(data, size, /*copy_data=*/false),
+      [owner](LocalMemoryBuffer *buffer) { delete buffer; });
+}
+
 /// Base class of all message classes.
 /// All payloads transferred through direct actor call are packed into a unified package,
 /// consisting of protobuf-formatted metadata and data, including data and control
@@ -78,7 +88,12 @@ class DataMessage : public Message {
         raw_(raw) {}
   virtual ~DataMessage() {}
 
-  static std::shared_ptr<DataMessage> FromBytes(uint8_t *bytes);
+  /// Parse a data message.
+  /// \param[in] bytes the serialized message.
+  /// \param[in] owner an optional buffer that owns `bytes`. If given, the data of the
+  /// message references it instead of being copied.
+  static std::shared_ptr<DataMessage> FromBytes(
+      uint8_t *bytes, std::shared_ptr<LocalMemoryBuffer> owner = nullptr);
   virtual void ToProtobuf(std::string *output);
   inline uint64_t SeqId() { return seq_id_; }
   inline uint64_t MsgIdStart() { return msg_id_start_; }
@@ -102,8 +117,11 @@ class DataMessage : public Message {
 class NotificationMessage : public Message {
  public:
   NotificationMessage(const ActorID &actor_id, const ActorID &peer_actor_id,
-                      const ObjectID &queue_id, uint64_t msg_id)
-      : Message(actor_id, peer_actor_id, queue_id), msg_id_(msg_id) {}
+                      const ObjectID &queue_id, uint64_t msg_id,
+                      uint64_t consumed_bytes = 0)
+      : Message(actor_id, peer_actor_id, queue_id),
+        msg_id_(msg_id),
+        consumed_bytes_(consumed_bytes) {}
 
   virtual ~NotificationMessage() {}
 
@@ -111,10 +129,13 @@ class NotificationMessage : public Message {
   virtual void ToProtobuf(std::string *output);
 
   inline uint64_t MsgId() { return msg_id_; }
+  inline uint64_t ConsumedBytes() { return consumed_bytes_; }
   inline queue::protobuf::StreamingQueueMessageType Type() { return type_; }
 
  private:
   uint64_t msg_id_;
+  /// Total size in bytes of the items consumed by the reader.
+  uint64_t consumed_bytes_;
   const queue::protobuf::StreamingQueueMessageType type_ =
       queue::protobuf::StreamingQueueMessageType::StreamingQueueNotificationMsgType;
 };
@@ -223,7 +244,9 @@ class ResendDataMessage : public Message {
         raw_(raw) {}
   virtual ~ResendDataMessage() {}
 
-  static std::shared_ptr<ResendDataMessage> FromBytes(uint8_t *bytes);
+  /// Parse a resent data message, see `DataMessage::FromBytes`.
+  static std::shared_ptr<ResendDataMessage> FromBytes(
+      uint8_t *bytes, std::shared_ptr<LocalMemoryBuffer> owner = nullptr);
   virtual void ToProtobuf(std::string *output);
   inline uint64_t MsgIdStart() { return msg_id_start_; }
   inline uint64_t MsgIdEnd() { return msg_id_end_; }
@@ -1,5 +1,7 @@
 #include "queue/queue.h"
 
+#include <unistd.h>
+
 #include <chrono>
 #include <thread>
 
@@ -106,14 +108,28 @@ Status WriterQueue::Push(uint8_t *buffer, uint32_t buffer_size, uint64_t timesta
   if (IsPendingFull(buffer_size)) {
     return Status::OutOfMemory("Queue Push OutOfMemory");
   }
+  return Push(std::make_shared<LocalMemoryBuffer>(buffer, buffer_size, true), timestamp,
+              msg_id_start, msg_id_end, raw);
+}
+
+Status WriterQueue::Push(std::shared_ptr<LocalMemoryBuffer> buffer, uint64_t timestamp,
+                         uint64_t msg_id_start, uint64_t msg_id_end, bool raw) {
+  uint32_t buffer_size = buffer->Size();
+  if (IsPendingFull(buffer_size)) {
+    return Status::OutOfMemory("Queue Push OutOfMemory");
+  }
 
   while (is_resending_) {
     STREAMING_LOG(INFO) << "This queue is resending data, wait.";
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
   }
 
-  QueueItem item(seq_id_, buffer, buffer_size, timestamp, msg_id_start, msg_id_end, raw);
+  QueueItem item(seq_id_, buffer, timestamp, msg_id_start, msg_id_end, raw);
+  if (replay_log_) {
+    RAY_RETURN_NOT_OK(replay_log_->Append(item));
+  }
   Queue::Push(item);
+  pushed_bytes_ += buffer_size;
   STREAMING_LOG(DEBUG) << "WriterQueue::Push seq_id: " << seq_id_;
   seq_id_++;
   return Status::OK();
@@ -131,6 +147,7 @@ void WriterQueue::Send() {
 }
 
 Status WriterQueue::TryEvictItems() {
+  std::unique_lock<std::mutex> lock(evict_mutex_);
   QueueItem item = FrontProcessed();
   STREAMING_LOG(DEBUG) << "TryEvictItems queue_id: " << queue_id_ << " first_item: ("
                        << item.MsgIdStart() << "," << item.MsgIdEnd() << ")"
@@ -140,17 +157,24 @@ Status WriterQueue::TryEvictItems() {
                        << " data_size_sent_: " << data_size_sent_
                        << " data_size_: " << data_size_;
 
+  if (replay_log_ && eviction_limit_ != QUEUE_INVALID_SEQ_ID) {
+    replay_log_->Truncate(eviction_limit_);
+  }
+
   if (min_consumed_msg_id_ == QUEUE_INVALID_SEQ_ID ||
       min_consumed_msg_id_ < item.MsgIdEnd()) {
     return Status::OutOfMemory("The queue is full and some reader doesn't consume");
   }
 
-  if (eviction_limit_ == QUEUE_INVALID_SEQ_ID || eviction_limit_ < item.MsgIdEnd()) {
-    return Status::OutOfMemory("The queue is full and eviction limit block evict");
+  // The replay log keeps the items the checkpoint still needs.
+  uint64_t evict_target_msg_id = min_consumed_msg_id_;
+  if (!replay_log_) {
+    if (eviction_limit_ == QUEUE_INVALID_SEQ_ID || eviction_limit_ < item.MsgIdEnd()) {
+      return Status::OutOfMemory("The queue is full and eviction limit block evict");
+    }
+    evict_target_msg_id = std::min(min_consumed_msg_id_, eviction_limit_);
   }
 
-  uint64_t evict_target_msg_id = std::min(min_consumed_msg_id_, eviction_limit_);
-
   int count = 0;
   while (item.MsgIdEnd() <= evict_target_msg_id) {
     PopProcessed();
@@ -163,9 +187,24 @@ Status WriterQueue::TryEvictItems() {
   return Status::OK();
 }
 
+Status WriterQueue::EnableReplayLog(const std::string &dir, uint64_t segment_size) {
+  STREAMING_CHECK(seq_id_ == QUEUE_INITIAL_SEQ_ID)
+      << "Replay log of " << queue_id_ << " enabled after push.";
+  if (access(dir.c_str(), W_OK) != 0) {
+    return Status::IOError("Replay log directory " + dir + " is not writable.");
+  }
+  STREAMING_LOG(INFO) << "Enable replay log of " << queue_id_ << " in " << dir
+                      << ", segment size: " << segment_size;
+  replay_log_.reset(new ReplayLog(dir, queue_id_, segment_size));
+  return Status::OK();
+}
+
 void WriterQueue::OnNotify(std::shared_ptr<NotificationMessage> notify_msg) {
   STREAMING_LOG(INFO) << "OnNotify target msg_id: " << notify_msg->MsgId();
   min_consumed_msg_id_ = notify_msg->MsgId();
+  if (notify_msg->ConsumedBytes() > consumed_bytes_) {
+    consumed_bytes_ = notify_msg->ConsumedBytes();
+  }
 }
 
 void WriterQueue::ResendItem(QueueItem &item, uint64_t first_seq_id,
@@ -198,6 +237,18 @@ int WriterQueue::ResendItems(std::list<QueueItem>::iterator start_iter,
   return count;
 }
 
+int WriterQueue::ResendLoggedItems(uint64_t first_seq_id, uint64_t last_seq_id) {
+  int count = 0;
+  for (auto &item : replay_log_->Read(first_seq_id, last_seq_id)) {
+    ResendItem(item, first_seq_id, last_seq_id);
+    count++;
+  }
+
+  STREAMING_LOG(INFO) << "ResendLoggedItems total count: " << count;
+  is_resending_ = false;
+  return count;
+}
+
 void WriterQueue::FindItem(
     uint64_t target_msg_id, std::function<void()> greater_callback,
     std::function<void()> less_callback,
@@ -251,7 +302,30 @@ void WriterQueue::OnPull(
              callback(std::move(buffer));
            },
            /// target_msg_id is too small.
-           [this, &pull_msg, &callback]() {
+           [this, &pull_msg, &callback, &service]() {
+             uint64_t target_seq_id;
+             if (replay_log_ &&
+                 replay_log_->FindSeqId(pull_msg->MsgId(), &target_seq_id)) {
+               // The item was evicted, resend it and the items after it up to the last
+               // sent one from the replay log.
+               auto first_pending = std::next(watershed_iter_);
+               uint64_t last_seq_id = first_pending == buffer_queue_.end()
+                                          ? seq_id_ - 1
+                                          : first_pending->SeqId() - 1;
+               is_resending_ = true;
+               STREAMING_LOG(INFO) << "OnPull resend from replay log, seq_id: "
+                                   << target_seq_id << " to " << last_seq_id;
+               service.post(std::bind(&WriterQueue::ResendLoggedItems, this,
+                                      target_seq_id, last_seq_id));
+               PullResponseMessage msg(
+                   pull_msg->PeerActorId(), pull_msg->ActorId(), pull_msg->QueueId(),
+                   target_seq_id, pull_msg->MsgId(),
+                   queue::protobuf::StreamingQueueError::OK, is_upstream_first_pull_);
+               std::unique_ptr<LocalMemoryBuffer> buffer = msg.ToBytes();
+               is_upstream_first_pull_ = false;
+               callback(std::move(buffer));
+               return;
+             }
              STREAMING_LOG(WARNING) << "Data lost.";
              PullResponseMessage msg(pull_msg->PeerActorId(), pull_msg->ActorId(),
                                      pull_msg->QueueId(), QUEUE_INVALID_SEQ_ID,
@@ -284,6 +358,7 @@ void ReaderQueue::OnConsumed(uint64_t msg_id) {
   STREAMING_LOG(INFO) << "OnConsumed: " << msg_id;
   QueueItem item = FrontProcessed();
   while (item.MsgIdEnd() <= msg_id) {
+    consumed_bytes_ += item.DataSize();
     PopProcessed();
     item = FrontProcessed();
   }
@@ -295,7 +370,7 @@ void ReaderQueue::Notify(uint64_t msg_id) {
   CreateNotifyTask(msg_id, task_args);
   // SubmitActorTask
 
-  NotificationMessage msg(actor_id_, peer_actor_id_, queue_id_, msg_id);
+  NotificationMessage msg(actor_id_, peer_actor_id_, queue_id_, msg_id, consumed_bytes_);
   std::unique_ptr<LocalMemoryBuffer> buffer = msg.ToBytes();
 
   transport_->Send(std::move(buffer));
@@ -2,9 +2,11 @@
 
 #include <iterator>
 #include <list>
+#include <mutex>
 #include <vector>
 
 #include "queue/queue_item.h"
+#include "queue/replay_log.h"
 #include "queue/transport.h"
 #include "queue/utils.h"
 #include "ray/common/id.h"
@@ -153,6 +155,11 @@ class WriterQueue : public Queue {
   Status Push(uint8_t *buffer, uint32_t buffer_size, uint64_t timestamp,
               uint64_t msg_id_start, uint64_t msg_id_end, bool raw = false);
 
+  /// Push a buffer into queue without copying it. The queue item holds a reference to
+  /// the buffer until the item is evicted, so the buffer must not be modified.
+  Status Push(std::shared_ptr<LocalMemoryBuffer> buffer, uint64_t timestamp,
+              uint64_t msg_id_start, uint64_t msg_id_end, bool raw = false);
+
   /// Callback function, will be called when downstream queue notifies
   /// it has consumed some items.
   /// NOTE: this callback function is called in queue thread.
@@ -168,16 +175,31 @@ class WriterQueue : public Queue {
   /// Send items through direct call.
   void Send();
 
-  /// Called when user pushs item into queue. The count of items
-  /// can be evicted, determined by eviction_limit_ and min_consumed_msg_id_.
+  /// Called when user pushs item into queue, and when a checkpoint is cleared. The count
+  /// of items can be evicted, determined by eviction_limit_ and min_consumed_msg_id_.
+  /// With a replay log, the items the reader has consumed are evicted without waiting
+  /// for the checkpoint, and the log is truncated up to eviction_limit_ instead.
   Status TryEvictItems();
 
+  /// Spill the items pushed from now on to a replay log in `dir`, so that pull requests
+  /// for evicted items are served from disk. Must be called before the first push.
+  Status EnableReplayLog(const std::string &dir, uint64_t segment_size);
+
+  bool HasReplayLog() { return replay_log_ != nullptr; }
+
   void SetQueueEvictionLimit(uint64_t msg_id) { eviction_limit_ = msg_id; }
 
   uint64_t EvictionLimit() { return eviction_limit_; }
 
   uint64_t GetMinConsumedMsgID() { return min_consumed_msg_id_; }
 
+  /// Return the total size in bytes of the items pushed into the queue.
+  uint64_t GetPushedBytes() { return pushed_bytes_; }
+
+  /// Return the total size in bytes of the items the downstream queue consumed, as of
+  /// its last notification.
+  uint64_t GetConsumedBytes() { return consumed_bytes_; }
+
   void SetPeerLastIds(uint64_t msg_id, uint64_t seq_id) {
     peer_last_msg_id_ = msg_id;
     peer_last_seq_id_ = seq_id;
@@ -199,6 +221,8 @@ class WriterQueue : public Queue {
   /// \param last_seq_id, the seq id of the last item in this resend sequence.
   int ResendItems(std::list<QueueItem>::iterator start_iter, uint64_t first_seq_id,
                   uint64_t last_seq_id);
+  /// Resend the items with seq ids in [first_seq_id, last_seq_id] from the replay log.
+  int ResendLoggedItems(uint64_t first_seq_id, uint64_t last_seq_id);
   /// Find the item which the message with `target_msg_id` in. If the `target_msg_id`
   /// is larger than the largest message id in the queue, the `greater_callback` callback
   /// will be called; If the `target_message_id` is smaller than the smallest message id
@@ -216,12 +240,18 @@ class WriterQueue : public Queue {
   uint64_t seq_id_;
   uint64_t eviction_limit_;
   uint64_t min_consumed_msg_id_;
+  /// Serializes evictions by the writer thread and by checkpoint clearing.
+  std::mutex evict_mutex_;
+  /// Read by the flow control of the data writer, from other threads.
+  std::atomic<uint64_t> pushed_bytes_{0};
+  std::atomic<uint64_t> consumed_bytes_{0};
   uint64_t peer_last_msg_id_;
   uint64_t peer_last_seq_id_;
   std::shared_ptr<Transport> transport_;
 
   std::atomic<bool> is_resending_;
   bool is_upstream_first_pull_;
+  std::unique_ptr<ReplayLog> replay_log_;
 };
 
 /// Queue in downstream.
@@ -264,6 +294,8 @@ class ReaderQueue : public Queue {
   ActorID peer_actor_id_;
   uint64_t last_recv_seq_id_;
   uint64_t last_recv_msg_id_;
+  /// Total size in bytes of the items consumed, reported to the upstream queue.
+  uint64_t consumed_bytes_ = 0;
   std::shared_ptr<PromiseWrapper> promise_for_pull_;
   std::shared_ptr<Transport> transport_;
 };
@@ -31,7 +31,7 @@ std::shared_ptr<Message> QueueMessageHandler::ParseMessage(
     message = NotificationMessage::FromBytes(bytes);
     break;
   case queue::protobuf::StreamingQueueMessageType::StreamingQueueDataMsgType:
-    message = DataMessage::FromBytes(bytes);
+    message = DataMessage::FromBytes(bytes, buffer);
     break;
   case queue::protobuf::StreamingQueueMessageType::StreamingQueueCheckMsgType:
     message = CheckMessage::FromBytes(bytes);
@@ -46,7 +46,7 @@ std::shared_ptr<Message> QueueMessageHandler::ParseMessage(
     message = PullResponseMessage::FromBytes(bytes);
     break;
   case queue::protobuf::StreamingQueueResendDataMsgType:
-    message = ResendDataMessage::FromBytes(bytes);
+    message = ResendDataMessage::FromBytes(bytes, buffer);
     break;
   default:
     STREAMING_CHECK(false) << "nonsupport message type: "
@@ -91,7 +91,8 @@ void QueueMessageHandler::SetPeerActorID(const ObjectID &queue_id,
                                          const ActorID &actor_id, RayFunction &async_func,
                                          RayFunction &sync_func) {
   actors_.emplace(queue_id, actor_id);
-  out_transports_.emplace(queue_id, std::make_shared<ray::streaming::Transport>(
+  // The transport sends by actor calls until it is connected to a local ring.
+  out_transports_.emplace(queue_id, std::make_shared<ray::streaming::LocalTransport>(
                                         actor_id, async_func, sync_func));
 }
 
@@ -282,6 +283,14 @@ void UpstreamQueueMessageHandler::OnPullRequest(
     return;
   }
 
+  // A downstream queue on this node has created a shared memory ring before pulling,
+  // so the items resent for this pull and all later ones can go through it.
+  auto transport =
+      std::dynamic_pointer_cast<LocalTransport>(GetOutTransport(pull_msg->QueueId()));
+  if (transport != nullptr && transport->ConnectLocal(pull_msg->QueueId())) {
+    STREAMING_LOG(INFO) << "Send data of queue " << pull_msg->QueueId()
+                        << " through shared memory";
+  }
   queue->second->OnPull(pull_msg, handler_service_, callback);
 }
 
@@ -311,7 +320,7 @@ bool DownstreamQueueMessageHandler::DownstreamQueueExists(const ObjectID &queue_
 }
 
 std::shared_ptr<ReaderQueue> DownstreamQueueMessageHandler::CreateDownstreamQueue(
-    const ObjectID &queue_id, const ActorID &peer_actor_id) {
+    const ObjectID &queue_id, const ActorID &peer_actor_id, uint64_t local_ring_size) {
   STREAMING_LOG(INFO) << "CreateDownstreamQueue: " << queue_id << " " << peer_actor_id
                       << "->" << actor_id_;
   auto it = downstream_queues_.find(queue_id);
@@ -324,6 +333,18 @@ std::shared_ptr<ReaderQueue> DownstreamQueueMessageHandler::CreateDownstreamQueu
       std::make_unique<streaming::ReaderQueue>(queue_id, actor_id_, peer_actor_id,
                                                GetOutTransport(queue_id));
   downstream_queues_[queue_id] = queue;
+  if (local_ring_size > 0) {
+    // Create the ring before the queue pulls, the upstream queue looks it up when it
+    // handles the pull.
+    auto ring = ShmRing::Create(queue_id, local_ring_size);
+    if (ring != nullptr) {
+      auto callback = [this](std::shared_ptr<LocalMemoryBuffer> buffer) {
+        DispatchMessageAsync(buffer);
+      };
+      local_receivers_[queue_id] = std::unique_ptr<LocalTransportReceiver>(
+          new LocalTransportReceiver(ring, callback));
+    }
+  }
   return queue;
 }
 
@@ -373,6 +394,7 @@ std::shared_ptr<LocalMemoryBuffer> DownstreamQueueMessageHandler::OnCheckQueue(
 
 void DownstreamQueueMessageHandler::ReleaseAllDownQueues() {
   STREAMING_LOG(INFO) << "ReleaseAllDownQueues size: " << downstream_queues_.size();
+  local_receivers_.clear();
   downstream_queues_.clear();
   Release();
 }
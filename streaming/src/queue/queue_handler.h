@@ -5,6 +5,7 @@
 #include <boost/thread.hpp>
 #include <thread>
 
+#include "queue/local_transport.h"
 #include "queue/queue.h"
 #include "util/streaming_logging.h"
 
@@ -177,8 +178,11 @@ class DownstreamQueueMessageHandler : public QueueMessageHandler {
   /// Create a downstream queue.
   /// \param queue_id, queue id of the queue to be created.
   /// \param peer_actor_id, actor id of peer actor.
+  /// \param local_ring_size, size of the shared memory ring through which a peer actor
+  /// on the same node sends its data. 0 means data is always sent by actor calls.
   std::shared_ptr<ReaderQueue> CreateDownstreamQueue(const ObjectID &queue_id,
-                                                     const ActorID &peer_actor_id);
+                                                     const ActorID &peer_actor_id,
+                                                     uint64_t local_ring_size = 0);
   /// Request to pull messages from corresponded upstream queue, whose message id
   /// is larger than `start_msg_id`. Multiple attempts to pull until timeout.
   /// \param queue_id, queue id of the queue to be pulled.
@@ -210,6 +214,9 @@ class DownstreamQueueMessageHandler : public QueueMessageHandler {
  private:
   std::unordered_map<ObjectID, std::shared_ptr<streaming::ReaderQueue>>
       downstream_queues_;
+  /// Receivers of the queues whose data may come through shared memory.
+  std::unordered_map<ObjectID, std::unique_ptr<LocalTransportReceiver>>
+      local_receivers_;
   static std::shared_ptr<DownstreamQueueMessageHandler> downstream_handler_;
 };
 
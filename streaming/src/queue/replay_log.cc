@@ -0,0 +1,166 @@
+#include "queue/replay_log.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "queue/message.h"
+#include "util/streaming_logging.h"
+
+namespace ray {
+namespace streaming {
+
+namespace {
+
+/// The header in front of the data of each record in a segment file.
+struct RecordHeader {
+  uint64_t seq_id;
+  uint64_t msg_id_start;
+  uint64_t msg_id_end;
+  uint64_t timestamp;
+  uint32_t size;
+  uint32_t raw;
+};
+
+/// Records start at 8 byte aligned offsets, so their headers can be read in place.
+uint64_t RecordSpace(uint32_t data_size) {
+  return (sizeof(RecordHeader) + data_size + 7) & ~static_cast<uint64_t>(7);
+}
+
+}  // namespace
+
+ReplayLogSegment::~ReplayLogSegment() {
+  munmap(data, capacity);
+  close(fd);
+  unlink(path.c_str());
+}
+
+ReplayLog::ReplayLog(const std::string &dir, const ObjectID &queue_id,
+                     uint64_t segment_size)
+    : dir_(dir),
+      queue_id_(queue_id.Hex()),
+      segment_size_(segment_size),
+      next_segment_index_(0) {}
+
+Status ReplayLog::OpenSegment(uint64_t min_capacity) {
+  uint64_t capacity = std::max(segment_size_, min_capacity);
+  std::string path =
+      dir_ + "/" + queue_id_ + "-" + std::to_string(next_segment_index_++) + ".log";
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return Status::IOError("Failed to create replay log segment " + path + ": " +
+                           strerror(errno));
+  }
+  if (ftruncate(fd, capacity) != 0) {
+    Status status = Status::IOError("Failed to size replay log segment " + path + ": " +
+                                    strerror(errno));
+    close(fd);
+    unlink(path.c_str());
+    return status;
+  }
+  void *data = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    Status status = Status::IOError("Failed to map replay log segment " + path + ": " +
+                                    strerror(errno));
+    close(fd);
+    unlink(path.c_str());
+    return status;
+  }
+  // Segments are written once from start to end, and read back in the same order.
+  madvise(data, capacity, MADV_SEQUENTIAL);
+  segments_.push_back(std::make_shared<ReplayLogSegment>(
+      path, fd, static_cast<uint8_t *>(data), capacity));
+  STREAMING_LOG(DEBUG) << "Opened replay log segment " << path << " of " << capacity
+                       << " bytes.";
+  return Status::OK();
+}
+
+Status ReplayLog::Append(QueueItem item) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  STREAMING_CHECK(records_.empty() || records_.back().seq_id + 1 == item.SeqId())
+      << "Replay log of " << queue_id_ << " expects seq_id "
+      << records_.back().seq_id + 1 << ", got " << item.SeqId();
+  uint32_t size = item.Buffer()->Size();
+  uint64_t space = RecordSpace(size);
+  if (segments_.empty() ||
+      segments_.back()->capacity - segments_.back()->used < space) {
+    RAY_RETURN_NOT_OK(OpenSegment(space));
+  }
+
+  auto &segment = segments_.back();
+  uint64_t offset = segment->used;
+  RecordHeader header{item.SeqId(),     item.MsgIdStart(), item.MsgIdEnd(),
+                      item.TimeStamp(), size,              item.IsRaw()};
+  std::memcpy(segment->data + offset, &header, sizeof(header));
+  std::memcpy(segment->data + offset + sizeof(header), item.Buffer()->Data(), size);
+  segment->used += space;
+
+  records_.push_back(Record{item.SeqId(), item.MsgIdStart(), item.MsgIdEnd(),
+                            item.TimeStamp(), item.IsRaw(), segment,
+                            offset + sizeof(header), size});
+  return Status::OK();
+}
+
+bool ReplayLog::FindSeqId(uint64_t msg_id, uint64_t *seq_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = std::lower_bound(
+      records_.begin(), records_.end(), msg_id,
+      [](const Record &record, uint64_t msg_id) { return record.msg_id_end < msg_id; });
+  if (it == records_.end() || it->msg_id_start > msg_id) {
+    return false;
+  }
+  *seq_id = it->seq_id;
+  return true;
+}
+
+std::vector<QueueItem> ReplayLog::Read(uint64_t first_seq_id, uint64_t last_seq_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  std::vector<QueueItem> items;
+  if (records_.empty() || first_seq_id > last_seq_id ||
+      last_seq_id < records_.front().seq_id) {
+    return items;
+  }
+  uint64_t front_seq_id = records_.front().seq_id;
+  uint64_t begin = std::max(first_seq_id, front_seq_id) - front_seq_id;
+  uint64_t end = std::min<uint64_t>(last_seq_id - front_seq_id + 1, records_.size());
+  for (uint64_t i = begin; i < end; i++) {
+    const Record &record = records_[i];
+    items.emplace_back(
+        record.seq_id,
+        MakeBufferRef(record.segment, record.segment->data + record.offset, record.size),
+        record.timestamp, record.msg_id_start, record.msg_id_end, record.raw);
+  }
+  return items;
+}
+
+size_t ReplayLog::Truncate(uint64_t msg_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!records_.empty() && records_.front().msg_id_end <= msg_id) {
+    records_.pop_front();
+  }
+  // The last segment is kept for the following appends.
+  size_t count = 0;
+  while (segments_.size() > 1 &&
+         (records_.empty() || records_.front().segment != segments_.front())) {
+    segments_.pop_front();
+    count++;
+  }
+  return count;
+}
+
+size_t ReplayLog::SegmentCount() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return segments_.size();
+}
+
+size_t ReplayLog::RecordCount() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return records_.size();
+}
+
+}  // namespace streaming
+}  // namespace ray
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "queue/queue_item.h"
+#include "ray/common/id.h"
+#include "ray/common/status.h"
+
+namespace ray {
+namespace streaming {
+
+/// A segment file of the replay log, mapped into memory. The file is removed once the
+/// segment is truncated and no item read from it is alive.
+struct ReplayLogSegment {
+  ReplayLogSegment(std::string path, int fd, uint8_t *data, uint64_t capacity)
+      : path(std::move(path)), fd(fd), data(data), capacity(capacity), used(0) {}
+  ~ReplayLogSegment();
+
+  std::string path;
+  int fd;
+  uint8_t *data;
+  uint64_t capacity;
+  uint64_t used;
+};
+
+/// Spills the items of a writer queue to sequential segment files, so that the queue
+/// can evict the items the reader has consumed before the checkpoint allows it, and
+/// still resend them if the reader pulls them again after a failover.
+/// Each record is a fixed header followed by the item data. Records are only appended,
+/// and whole segments are dropped once a checkpoint covers all their records.
+/// The log is written by the writer thread and read by the queue thread.
+class ReplayLog {
+ public:
+  /// \param dir, the directory to create the segment files in.
+  /// \param queue_id, the queue the log belongs to, which names its segment files.
+  /// \param segment_size, the size in bytes of a segment file. Items larger than that
+  /// get a segment of their own.
+  ReplayLog(const std::string &dir, const ObjectID &queue_id, uint64_t segment_size);
+
+  /// Append an item to the log. The item must have the next seq id after the last
+  /// appended item.
+  Status Append(QueueItem item);
+
+  /// Find the seq id of the logged item which contains `msg_id`.
+  /// \return false if no logged item contains it.
+  bool FindSeqId(uint64_t msg_id, uint64_t *seq_id);
+
+  /// Read the logged items with seq ids in [first_seq_id, last_seq_id]. The buffers of
+  /// the items reference the mapped segments instead of copying them.
+  std::vector<QueueItem> Read(uint64_t first_seq_id, uint64_t last_seq_id);
+
+  /// Drop the segments whose items all end at or before `msg_id`.
+  /// \return the number of dropped segments.
+  size_t Truncate(uint64_t msg_id);
+
+  size_t SegmentCount();
+
+  size_t RecordCount();
+
+ private:
+  struct Record {
+    uint64_t seq_id;
+    uint64_t msg_id_start;
+    uint64_t msg_id_end;
+    uint64_t timestamp;
+    bool raw;
+    std::shared_ptr<ReplayLogSegment> segment;
+    uint64_t offset;
+    uint32_t size;
+  };
+
+  Status OpenSegment(uint64_t min_capacity);
+
+  std::string dir_;
+  std::string queue_id_;
+  uint64_t segment_size_;
+  uint64_t next_segment_index_;
+  std::mutex mutex_;
+  /// Records ordered by seq id, the segments keep the same order.
+  std::deque<Record> records_;
+  std::deque<std::shared_ptr<ReplayLogSegment>> segments_;
+};
+
+}  // namespace streaming
+}  // namespace ray
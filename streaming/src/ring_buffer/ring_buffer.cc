@@ -62,6 +62,10 @@ uint8_t *StreamingRingBuffer::GetTransientBufferMutable() const {
   return transient_buffer_.GetTransientBufferMutable();
 }
 
+std::shared_ptr<uint8_t> StreamingRingBuffer::GetTransientBufferShared() const {
+  return transient_buffer_.GetTransientBufferShared();
+}
+
 void StreamingRingBuffer::ReallocTransientBuffer(uint32_t size) {
   transient_buffer_.ReallocTransientBuffer(size);
 }
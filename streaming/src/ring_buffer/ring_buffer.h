@@ -8,6 +8,7 @@
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <vector>
 
 #include "message/message.h"
 #include "ray/common/status.h"
@@ -41,14 +42,21 @@ class StreamingTransientBuffer {
 
   inline uint8_t *GetTransientBufferMutable() const { return transient_buffer_.get(); }
 
+  /// Channels may keep a reference to the transient buffer after it is produced,
+  /// instead of copying it. The buffer isn't reused while such references exist.
+  inline std::shared_ptr<uint8_t> GetTransientBufferShared() const {
+    return transient_buffer_;
+  }
+
   ///  To reuse transient buffer, we will realloc buffer memory if size of needed
-  ///  message bundle raw data is greater-than original buffer size.
+  ///  message bundle raw data is greater-than original buffer size, or if the
+  ///  original buffer is still referenced by a channel.
   ///  \param size buffer size
   ///
   inline void ReallocTransientBuffer(uint32_t size) {
     transient_buffer_size_ = size;
     transient_flag_ = true;
-    if (max_transient_buffer_size_ > size) {
+    if (max_transient_buffer_size_ > size && transient_buffer_.use_count() == 1) {
       return;
     }
     max_transient_buffer_size_ = size;
@@ -122,45 +130,75 @@ class RingBufferImplThreadSafe : public AbstractRingBuffer<T> {
   boost::circular_buffer<T> buffer_;
 };
 
+/// Lock-free ring buffer for a single producer and a single consumer. The read and
+/// write indices only increase, and are masked into a power-of-two sized array instead
+/// of wrapped with a division. Each index sits on its own cache line, so the producer
+/// and the consumer do not invalidate each other's line on every operation.
 template <class T>
 class RingBufferImplLockFree : public AbstractRingBuffer<T> {
  private:
+  static constexpr size_t kCacheLineSize = 64;
+
   std::vector<T> buffer_;
-  std::atomic<size_t> capacity_;
-  std::atomic<size_t> read_index_;
-  std::atomic<size_t> write_index_;
+  const size_t capacity_;
+  const size_t mask_;
+  /// Only written by the consumer.
+  alignas(kCacheLineSize) std::atomic<size_t> read_index_;
+  /// Only written by the producer.
+  alignas(kCacheLineSize) std::atomic<size_t> write_index_;
+  char padding_[kCacheLineSize - sizeof(std::atomic<size_t>)];
 
  public:
   RingBufferImplLockFree(size_t size)
-      : buffer_(size, nullptr), capacity_(size), read_index_(0), write_index_(0) {}
+      : buffer_(RoundUpToPowerOfTwo(size)),
+        capacity_(size),
+        mask_(buffer_.size() - 1),
+        read_index_(0),
+        write_index_(0) {
+    STREAMING_CHECK(size > 0);
+  }
   virtual ~RingBufferImplLockFree() = default;
 
   void Push(const T &t) {
     STREAMING_CHECK(!Full());
-    buffer_[write_index_] = t;
-    write_index_ = IncreaseIndex(write_index_);
+    const size_t write_index = write_index_.load(std::memory_order_relaxed);
+    buffer_[write_index & mask_] = t;
+    write_index_.store(write_index + 1, std::memory_order_release);
   }
 
   void Pop() {
     STREAMING_CHECK(!Empty());
-    read_index_ = IncreaseIndex(read_index_);
+    const size_t read_index = read_index_.load(std::memory_order_relaxed);
+    // Release the element now rather than when its slot is reused.
+    buffer_[read_index & mask_] = T();
+    read_index_.store(read_index + 1, std::memory_order_release);
   }
 
   T &Front() {
     STREAMING_CHECK(!Empty());
-    return buffer_[read_index_];
+    return buffer_[read_index_.load(std::memory_order_relaxed) & mask_];
   }
 
-  bool Empty() const { return write_index_ == read_index_; }
+  bool Empty() const { return Size() == 0; }
 
-  bool Full() const { return IncreaseIndex(write_index_) == read_index_; }
+  bool Full() const { return Size() >= capacity_; }
 
-  size_t Size() const { return (write_index_ + capacity_ - read_index_) % capacity_; }
+  size_t Size() const {
+    // Load the read index first, so that it is never ahead of the write index.
+    const size_t read_index = read_index_.load(std::memory_order_acquire);
+    return write_index_.load(std::memory_order_acquire) - read_index;
+  }
 
   size_t Capacity() const { return capacity_; }
 
  private:
-  size_t IncreaseIndex(size_t index) const { return (index + 1) % capacity_; }
+  static size_t RoundUpToPowerOfTwo(size_t size) {
+    size_t power = 1;
+    while (power < size) {
+      power <<= 1;
+    }
+    return power;
+  }
 };
 
 enum class StreamingRingBufferType : uint8_t { SPSC_LOCK, SPSC };
@@ -205,6 +243,8 @@ class StreamingRingBuffer {
 
   uint8_t *GetTransientBufferMutable() const;
 
+  std::shared_ptr<uint8_t> GetTransientBufferShared() const;
+
   void ReallocTransientBuffer(uint32_t size);
 
   bool IsTransientAvaliable();
@@ -129,6 +129,32 @@ TEST_F(MockWriterTest, test_write_to_transfer) {
   EXPECT_TRUE(!mock_writer->IsMessageAvailableInBuffer(input_ids[0]));
 }
 
+TEST_F(MockWriterTest, test_write_partitioned_messages) {
+  int channel_num = 4;
+  GenRandomChannelIdVector(input_ids, channel_num);
+  mock_writer->Init(input_ids);
+  std::vector<uint64_t> keys;
+  std::vector<uint8_t *> messages;
+  std::vector<uint32_t> message_sizes;
+  std::vector<size_t> expected_sizes(channel_num, 0);
+  for (uint64_t key = 0; key < 64; ++key) {
+    keys.push_back(key);
+    messages.push_back(data);
+    message_sizes.push_back(data_size);
+    ++expected_sizes[DataWriter::PartitionOfKey(key, channel_num)];
+  }
+  EXPECT_EQ(mock_writer->WritePartitionedMessages(input_ids, keys, messages,
+                                                  message_sizes),
+            keys.size());
+  for (int i = 0; i < channel_num; ++i) {
+    // Keys are spread over all channels.
+    EXPECT_GT(expected_sizes[i], 0u);
+    auto &channel_info = mock_writer->GetChannelInfoMap()[input_ids[i]];
+    EXPECT_EQ(channel_info.writer_ring_buffer->Size(), expected_sizes[i]);
+    EXPECT_EQ(channel_info.current_message_id, expected_sizes[i]);
+  }
+}
+
 }  // namespace streaming
 }  // namespace ray
 
@@ -1,7 +1,9 @@
 #include <cstring>
 #include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "message/bundle_codec.h"
 #include "message/message.h"
 #include "message/message_bundle.h"
 
@@ -104,6 +106,7 @@ TEST(StreamingSerializationTest, streaming_message_bundle_serialization_test) {
     }
     StreamingMessageBundle messageBundle(message_list, 0, 1,
                                          StreamingMessageBundleType::Bundle);
+    messageBundle.SetWatermark(k);
     size_t message_length = messageBundle.ClassBytesSize();
     uint8_t *bytes = new uint8_t[message_length];
     messageBundle.ToBytes(bytes);
@@ -120,10 +123,41 @@ TEST(StreamingSerializationTest, streaming_message_bundle_serialization_test) {
     EXPECT_EQ(bundle_meta_ptr->GetLastMessageId(), bundle_ptr->GetLastMessageId());
     EXPECT_EQ(bundle_meta_ptr->GetMessageBundleTs(), bundle_ptr->GetMessageBundleTs());
     EXPECT_EQ(bundle_meta_ptr->GetMessageListSize(), bundle_ptr->GetMessageListSize());
+    EXPECT_EQ(bundle_meta_ptr->GetWatermark(), bundle_ptr->GetWatermark());
     delete[] bytes;
   }
 }
 
+TEST(StreamingSerializationTest, streaming_message_view_test) {
+  std::list<StreamingMessagePtr> message_list;
+  for (int i = 0; i < 100; ++i) {
+    std::vector<uint8_t> data(i + 1, static_cast<uint8_t>(i));
+    message_list.push_back(std::make_shared<StreamingMessage>(
+        data.data(), i + 1, i + 1, StreamingMessageType::Message));
+  }
+  StreamingMessageBundle bundle(message_list, 0, 100, StreamingMessageBundleType::Bundle);
+  std::vector<uint8_t> bytes(bundle.ClassBytesSize());
+  bundle.ToBytes(bytes.data());
+
+  // The views point into the serialized bundle instead of copying the messages.
+  std::vector<StreamingMessageView> message_views;
+  StreamingMessageBundle::GetMessageViewsFromRawData(
+      bytes.data() + kMessageBundleHeaderSize, bundle.GetRawBundleSize(),
+      bundle.GetMessageListSize(), message_views);
+  ASSERT_EQ(message_views.size(), message_list.size());
+  auto message = message_list.begin();
+  for (const auto &view : message_views) {
+    EXPECT_EQ(view.message_id, (*message)->GetMessageId());
+    EXPECT_EQ(view.message_type, (*message)->GetMessageType());
+    EXPECT_EQ(view.payload_size, (*message)->PayloadSize());
+    EXPECT_EQ(view.ClassBytesSize(), (*message)->ClassBytesSize());
+    EXPECT_EQ(std::memcmp(view.payload, (*message)->Payload(), view.payload_size), 0);
+    EXPECT_GE(view.payload, bytes.data());
+    EXPECT_LT(view.payload, bytes.data() + bytes.size());
+    message++;
+  }
+}
+
 TEST(StreamingSerializationTest, streaming_message_bundle_equal_test) {
   std::list<StreamingMessagePtr> message_list;
   std::list<StreamingMessagePtr> message_list_same;
@@ -169,6 +203,53 @@ TEST(StreamingSerializationTest, streaming_message_bundle_equal_test) {
   delete[] bytes;
 }
 
+TEST(StreamingSerializationTest, streaming_message_bundle_compression_test) {
+  const std::string text = "{\"event\": \"click\", \"page\": \"/index.html\"}";
+  for (const std::string &dictionary : {std::string(), text}) {
+    std::list<StreamingMessagePtr> message_list;
+    for (int i = 0; i < 20; ++i) {
+      message_list.push_back(std::make_shared<StreamingMessage>(
+          reinterpret_cast<const uint8_t *>(text.data()), text.size(), i + 1,
+          StreamingMessageType::Message));
+    }
+    StreamingMessageBundle bundle(message_list, 0, 20,
+                                  StreamingMessageBundleType::Bundle);
+    bundle.SetWatermark(7);
+    uint32_t bundle_size = bundle.ClassBytesSize();
+    std::vector<uint8_t> bytes(bundle_size);
+    bundle.ToBytes(bytes.data());
+
+    BundleCodec codec(6, dictionary);
+    uint32_t compressed_size = codec.Compress(bytes.data(), bundle_size);
+    EXPECT_LT(compressed_size, bundle_size);
+    EXPECT_TRUE(StreamingMessageBundleMeta::IsCompressed(bytes.data()));
+    // The meta data can be read without decompressing.
+    auto meta = StreamingMessageBundleMeta::FromBytes(bytes.data());
+    EXPECT_EQ(meta->GetLastMessageId(), 20u);
+    EXPECT_EQ(meta->GetWatermark(), 7u);
+
+    EXPECT_EQ(BundleCodec::DecompressedSize(bytes.data()), bundle_size);
+    std::vector<uint8_t> decompressed(bundle_size);
+    BundleCodec reader_codec(6, dictionary);
+    reader_codec.Decompress(bytes.data(), decompressed.data());
+    EXPECT_FALSE(StreamingMessageBundleMeta::IsCompressed(decompressed.data()));
+    auto bundle_ptr = StreamingMessageBundle::FromBytes(decompressed.data());
+    EXPECT_TRUE(bundle_ptr->operator==(bundle));
+  }
+
+  // Small bundles are left uncompressed.
+  uint8_t data[] = {1, 2, 3};
+  std::list<StreamingMessagePtr> message_list;
+  message_list.push_back(
+      std::make_shared<StreamingMessage>(data, 3, 1, StreamingMessageType::Message));
+  StreamingMessageBundle bundle(message_list, 0, 1, StreamingMessageBundleType::Bundle);
+  std::vector<uint8_t> bytes(bundle.ClassBytesSize());
+  bundle.ToBytes(bytes.data());
+  BundleCodec codec(6, "");
+  EXPECT_EQ(codec.Compress(bytes.data(), bytes.size()), bytes.size());
+  EXPECT_FALSE(StreamingMessageBundleMeta::IsCompressed(bytes.data()));
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
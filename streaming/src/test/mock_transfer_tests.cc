@@ -185,6 +185,82 @@ TEST_F(StreamingTransferTest, flow_control_test) {
   write_thread.join();
 }
 
+TEST_F(StreamingTransferTest, adaptive_batching_test) {
+  StreamingConfig config;
+  config.SetBundleTargetLatencyMs(5);
+  writer_runtime_context->SetConfig(config);
+  InitTransfer();
+  writer->Run();
+  uint32_t data_size = 16;
+  std::shared_ptr<uint8_t> data(new uint8_t[data_size]);
+  auto func = [data, data_size](int index) { std::fill_n(data.get(), data_size, index); };
+
+  size_t num = 10000;
+  std::thread write_thread([this, data, data_size, &func, num]() {
+    for (size_t i = 0; i < num; ++i) {
+      func(i);
+      writer->WriteMessageToBufferRing(queue_vec[0], data.get(), data_size);
+    }
+  });
+
+  std::list<StreamingMessagePtr> read_message_list;
+  while (read_message_list.size() < num) {
+    std::shared_ptr<DataBundle> msg;
+    reader->GetBundle(5000, msg);
+    StreamingMessageBundlePtr bundle_ptr = StreamingMessageBundle::FromBytes(msg->data);
+    auto &message_list = bundle_ptr->GetMessageList();
+    std::copy(message_list.begin(), message_list.end(),
+              std::back_inserter(read_message_list));
+  }
+  int index = 0;
+  for (auto &message : read_message_list) {
+    func(index++);
+    EXPECT_EQ(std::memcmp(message->Payload(), data.get(), data_size), 0);
+  }
+  write_thread.join();
+
+  std::unordered_map<ObjectID, ProducerChannelInfo> *writer_offset_info = nullptr;
+  writer->GetOffsetInfo(writer_offset_info);
+  auto &channel_info = (*writer_offset_info)[queue_vec[0]];
+  EXPECT_EQ(channel_info.bundle_message_cnt, num);
+  EXPECT_LE(channel_info.bundle_cnt, num);
+}
+
+TEST_F(StreamingTransferTest, event_time_merge_test) {
+  StreamingConfig config;
+  config.SetEventTimeMerge(true);
+  reader_runtime_context->SetConfig(config);
+  int channel_num = 2;
+  InitTransfer(channel_num);
+  writer->Run();
+
+  uint64_t num = 1000;
+  std::thread write_thread([this, num, channel_num]() {
+    for (uint64_t i = 0; i < num; ++i) {
+      // The second channel runs ahead of the first one in event time.
+      for (int j = 0; j < channel_num; ++j) {
+        uint64_t event_time = i + j * 10;
+        writer->UpdateWatermark(queue_vec[j], event_time);
+        writer->WriteMessageToBufferRing(queue_vec[j],
+                                         reinterpret_cast<uint8_t *>(&event_time),
+                                         sizeof(event_time));
+      }
+    }
+  });
+
+  uint64_t read_num = 0;
+  uint64_t last_watermark = 0;
+  while (read_num < num * channel_num) {
+    std::shared_ptr<DataBundle> msg;
+    ASSERT_EQ(reader->GetBundle(5000, msg), StreamingStatus::OK);
+    EXPECT_GE(msg->meta->GetWatermark(), last_watermark);
+    last_watermark = msg->meta->GetWatermark();
+    read_num += msg->meta->GetMessageListSize();
+  }
+  write_thread.join();
+  EXPECT_EQ(reader->GetWatermark(), num - 1);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
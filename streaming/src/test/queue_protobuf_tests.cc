@@ -24,6 +24,35 @@ TEST(ProtoBufTest, MessageCommonTest) {
   EXPECT_EQ(msg.QueueId(), msg2->QueueId());
 }
 
+TEST(ProtoBufTest, DataMessageReferencesOwnerTest) {
+  JobID job_id = JobID::FromInt(0);
+  TaskID task_id = TaskID::ForDriverTask(job_id);
+  ray::ActorID actor_id = ray::ActorID::Of(job_id, task_id, 0);
+  ray::ActorID peer_actor_id = ray::ActorID::Of(job_id, task_id, 1);
+  ObjectID queue_id = ray::ObjectID::FromRandom();
+
+  uint8_t data[128];
+  memset(data, 7, sizeof(data));
+  std::shared_ptr<LocalMemoryBuffer> buffer =
+      std::make_shared<LocalMemoryBuffer>(data, 128, true);
+  DataMessage msg(actor_id, peer_actor_id, queue_id, 100, 1000, 2000, buffer, true);
+  std::shared_ptr<LocalMemoryBuffer> serialized_buffer = msg.ToBytes();
+  std::weak_ptr<LocalMemoryBuffer> weak_serialized_buffer = serialized_buffer;
+  std::shared_ptr<DataMessage> msg2 =
+      DataMessage::FromBytes(serialized_buffer->Data(), serialized_buffer);
+  uint8_t *begin = serialized_buffer->Data();
+  uint8_t *end = begin + serialized_buffer->Size();
+  EXPECT_TRUE(msg2->Buffer()->Data() >= begin && msg2->Buffer()->Data() < end);
+  EXPECT_EQ(msg2->Buffer()->Size(), 128u);
+  EXPECT_EQ(memcmp(msg2->Buffer()->Data(), data, sizeof(data)), 0);
+
+  // The message keeps the received buffer alive until its data is released.
+  serialized_buffer.reset();
+  EXPECT_FALSE(weak_serialized_buffer.expired());
+  msg2.reset();
+  EXPECT_TRUE(weak_serialized_buffer.expired());
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,99 @@
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "queue/queue.h"
+#include "queue/replay_log.h"
+using namespace ray;
+using namespace ray::streaming;
+
+namespace {
+
+std::string MakeTempDir() {
+  char dir[] = "/tmp/replay_log_tests_XXXXXX";
+  EXPECT_NE(mkdtemp(dir), nullptr);
+  return dir;
+}
+
+QueueItem MakeItem(uint64_t seq_id, uint32_t size) {
+  std::vector<uint8_t> data(size, static_cast<uint8_t>(seq_id));
+  return QueueItem(seq_id, data.data(), size, 0, seq_id * 10, seq_id * 10 + 9, true);
+}
+
+}  // namespace
+
+TEST(ReplayLogTest, AppendReadTruncateTest) {
+  std::string dir = MakeTempDir();
+  ObjectID queue_id = ObjectID::FromRandom();
+  {
+    // Two records of 100 bytes fit in a segment, together with their headers.
+    ReplayLog log(dir, queue_id, 320);
+    for (uint64_t seq_id = 1; seq_id <= 6; seq_id++) {
+      EXPECT_TRUE(log.Append(MakeItem(seq_id, 100)).ok());
+    }
+    // An item larger than a segment gets a segment of its own.
+    EXPECT_TRUE(log.Append(MakeItem(7, 1000)).ok());
+    EXPECT_EQ(log.SegmentCount(), 4u);
+    EXPECT_EQ(log.RecordCount(), 7u);
+
+    uint64_t seq_id = 0;
+    EXPECT_TRUE(log.FindSeqId(35, &seq_id));
+    EXPECT_EQ(seq_id, 3u);
+    EXPECT_FALSE(log.FindSeqId(5, &seq_id));
+    EXPECT_FALSE(log.FindSeqId(80, &seq_id));
+
+    auto items = log.Read(3, 5);
+    EXPECT_EQ(items.size(), 3u);
+    for (auto &item : items) {
+      EXPECT_EQ(item.MsgIdStart(), item.SeqId() * 10);
+      EXPECT_TRUE(item.IsRaw());
+      EXPECT_EQ(item.DataSize(), 100u);
+      EXPECT_EQ(item.Buffer()->Data()[99], static_cast<uint8_t>(item.SeqId()));
+    }
+
+    // The first segment ends with msg id 29, the second one is only partly covered.
+    EXPECT_EQ(log.Truncate(39), 1u);
+    EXPECT_EQ(log.SegmentCount(), 3u);
+    EXPECT_FALSE(log.FindSeqId(35, &seq_id));
+    EXPECT_TRUE(log.FindSeqId(45, &seq_id));
+    // Items read before the truncation still reference their segment.
+    EXPECT_EQ(log.Truncate(69), 2u);
+    EXPECT_EQ(items[2].Buffer()->Data()[0], 5u);
+    EXPECT_EQ(log.RecordCount(), 1u);
+  }
+  // The segment files are removed with the log.
+  EXPECT_EQ(rmdir(dir.c_str()), 0);
+}
+
+TEST(ReplayLogTest, WriterQueueEvictsConsumedItemsTest) {
+  JobID job_id = JobID::FromInt(0);
+  TaskID task_id = TaskID::ForDriverTask(job_id);
+  ActorID actor_id = ActorID::Of(job_id, task_id, 0);
+  ActorID peer_actor_id = ActorID::Of(job_id, task_id, 1);
+  ObjectID queue_id = ObjectID::FromRandom();
+  std::string dir = MakeTempDir();
+  {
+    WriterQueue queue(queue_id, actor_id, peer_actor_id, 1024, nullptr);
+    EXPECT_TRUE(queue.EnableReplayLog(dir, 4096).ok());
+    uint8_t data[100];
+    memset(data, 0, sizeof(data));
+    for (uint64_t msg_id = 1; msg_id <= 4; msg_id++) {
+      EXPECT_TRUE(queue.Push(data, sizeof(data), 0, msg_id, msg_id, true).ok());
+      queue.PopPending();
+    }
+    queue.OnNotify(
+        std::make_shared<NotificationMessage>(peer_actor_id, actor_id, queue_id, 3));
+    // No checkpoint is finished, the consumed items are evicted anyway.
+    EXPECT_TRUE(queue.TryEvictItems().ok());
+    EXPECT_EQ(queue.ProcessedDataSize(), 100u);
+  }
+  EXPECT_EQ(rmdir(dir.c_str()), 0);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -60,6 +60,33 @@ TEST(StreamingRingBufferTest, spsc_test) {
   EXPECT_EQ(count, data_n);
 }
 
+TEST(StreamingRingBufferTest, spsc_capacity_test) {
+  // The capacity is not a power of two, and the indices wrap around many times.
+  StreamingRingBuffer ring_buffer(3, StreamingRingBufferType::SPSC);
+  EXPECT_EQ(ring_buffer.Capacity(), 3);
+  uint64_t next_push = 0;
+  uint64_t next_pop = 0;
+  for (int k = 0; k < 1000; ++k) {
+    while (!ring_buffer.IsFull()) {
+      ring_buffer.Push(std::make_shared<StreamingMessage>(
+          reinterpret_cast<uint8_t *>(&next_push), sizeof(next_push), next_push,
+          StreamingMessageType::Message));
+      next_push++;
+    }
+    EXPECT_EQ(ring_buffer.Size(), 3);
+    // Pop one or two messages, so that the ring is refilled at different offsets.
+    for (int i = 0; i <= k % 2; ++i) {
+      EXPECT_EQ(ring_buffer.Front()->GetMessageId(), next_pop++);
+      ring_buffer.Pop();
+    }
+  }
+  while (!ring_buffer.IsEmpty()) {
+    EXPECT_EQ(ring_buffer.Front()->GetMessageId(), next_pop++);
+    ring_buffer.Pop();
+  }
+  EXPECT_EQ(next_pop, next_push);
+}
+
 TEST(StreamingRingBufferTest, mutex_test) {
   size_t m_num = data_n;
   StreamingRingBuffer ring_buffer(m_num, StreamingRingBufferType::SPSC_LOCK);
@@ -0,0 +1,157 @@
+// Throughput and latency benchmark of DataWriter -> DataReader.
+//
+// The writer and the reader run in this process over the mock transport, so the
+// numbers cover bundling, flow control, the event service and serialization, but not
+// the network. Each message carries its send time, and the reader reports the end to
+// end latency percentiles.
+//
+// Example:
+//   streaming_bench --message_size=1024 --num_channels=4 --num_messages=200000 \
+//     --flow_control=unconsumed_seq
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "data_reader.h"
+#include "data_writer.h"
+#include "gflags/gflags.h"
+
+DEFINE_uint32(message_size, 1024, "Payload size of each message in bytes.");
+DEFINE_uint32(num_channels, 1, "Number of channels between the writer and the reader.");
+DEFINE_uint64(num_messages, 100000, "Number of messages written to each channel.");
+DEFINE_string(flow_control, "unconsumed_seq",
+              "Flow control type: unconsumed_seq, credit or none.");
+DEFINE_uint32(ring_buffer_capacity, 0,
+              "Capacity of the writer ring buffers in messages, 0 for the default.");
+DEFINE_uint32(bundle_target_latency_ms, 0,
+              "Target latency of adaptive batching, 0 to disable it.");
+DEFINE_uint64(queue_size, 10 * 1024 * 1024, "Size of each channel in bytes.");
+
+using namespace ray;
+using namespace ray::streaming;
+
+namespace {
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+double Percentile(const std::vector<int64_t> &sorted, double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  size_t index = static_cast<size_t>(p / 100.0 * (sorted.size() - 1));
+  return sorted[index] / 1000.0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (FLAGS_message_size < sizeof(int64_t)) {
+    std::cerr << "message_size must be at least " << sizeof(int64_t) << std::endl;
+    return 1;
+  }
+
+  StreamingConfig config;
+  if (FLAGS_flow_control == "unconsumed_seq") {
+    config.SetFlowControlType(proto::FlowControlType::UnconsumedSeqFlowControl);
+  } else if (FLAGS_flow_control == "credit") {
+    config.SetFlowControlType(proto::FlowControlType::CreditFlowControl);
+  } else if (FLAGS_flow_control == "none") {
+    config.SetFlowControlType(proto::FlowControlType::NoFlowControl);
+  } else {
+    std::cerr << "Unknown flow control type " << FLAGS_flow_control << std::endl;
+    return 1;
+  }
+  if (FLAGS_ring_buffer_capacity > 0) {
+    config.SetRingBufferCapacity(FLAGS_ring_buffer_capacity);
+  }
+  config.SetBundleTargetLatencyMs(FLAGS_bundle_target_latency_ms);
+
+  auto writer_runtime_context = std::make_shared<RuntimeContext>();
+  auto reader_runtime_context = std::make_shared<RuntimeContext>();
+  writer_runtime_context->SetConfig(config);
+  reader_runtime_context->SetConfig(config);
+  writer_runtime_context->MarkMockTest();
+  reader_runtime_context->MarkMockTest();
+  auto writer = std::make_shared<DataWriter>(writer_runtime_context);
+  auto reader = std::make_shared<DataReader>(reader_runtime_context);
+
+  std::vector<ObjectID> queue_ids;
+  for (uint32_t i = 0; i < FLAGS_num_channels; ++i) {
+    queue_ids.push_back(ObjectID::FromRandom());
+  }
+  std::vector<uint64_t> message_ids(queue_ids.size(), 0);
+  std::vector<uint64_t> queue_sizes(queue_ids.size(), FLAGS_queue_size);
+  std::vector<ChannelCreationParameter> params(queue_ids.size());
+  std::vector<TransferCreationStatus> creation_status;
+  writer->Init(queue_ids, params, message_ids, queue_sizes);
+  reader->Init(queue_ids, params, message_ids, creation_status, -1);
+  writer->Run();
+
+  const uint64_t total_messages = FLAGS_num_messages * FLAGS_num_channels;
+  int64_t start_ns = NowNs();
+  std::thread write_thread([&writer, &queue_ids]() {
+    std::vector<uint8_t> data(FLAGS_message_size, 0);
+    for (uint64_t i = 0; i < FLAGS_num_messages; ++i) {
+      for (auto &queue_id : queue_ids) {
+        int64_t send_ns = NowNs();
+        std::memcpy(data.data(), &send_ns, sizeof(send_ns));
+        writer->WriteMessageToBufferRing(queue_id, data.data(), data.size());
+      }
+    }
+  });
+
+  std::vector<int64_t> latencies_ns;
+  latencies_ns.reserve(total_messages);
+  uint64_t num_bundles = 0;
+  while (latencies_ns.size() < total_messages) {
+    std::shared_ptr<DataBundle> bundle;
+    if (reader->GetBundle(5000, bundle) != StreamingStatus::OK || bundle == nullptr) {
+      std::cerr << "Timed out after receiving " << latencies_ns.size() << " of "
+                << total_messages << " messages" << std::endl;
+      return 1;
+    }
+    int64_t receive_ns = NowNs();
+    StreamingMessageBundlePtr bundle_ptr =
+        StreamingMessageBundle::FromBytes(bundle->data);
+    auto &message_list = bundle_ptr->GetMessageList();
+    for (auto &message : message_list) {
+      int64_t send_ns;
+      std::memcpy(&send_ns, message->Payload(), sizeof(send_ns));
+      latencies_ns.push_back(receive_ns - send_ns);
+    }
+    num_bundles += message_list.empty() ? 0 : 1;
+  }
+  double elapsed_s = (NowNs() - start_ns) / 1e9;
+  write_thread.join();
+
+  std::sort(latencies_ns.begin(), latencies_ns.end());
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "channels: " << FLAGS_num_channels
+            << ", message size: " << FLAGS_message_size
+            << ", flow control: " << FLAGS_flow_control << std::endl;
+  std::cout << "messages: " << total_messages << ", bundles: " << num_bundles
+            << ", messages per bundle: "
+            << static_cast<double>(total_messages) / std::max<uint64_t>(num_bundles, 1)
+            << std::endl;
+  std::cout << "throughput: " << total_messages / elapsed_s << " messages/s, "
+            << total_messages * FLAGS_message_size / elapsed_s / (1 << 20) << " MiB/s"
+            << std::endl;
+  std::cout << "latency (us): p50 " << Percentile(latencies_ns, 50) << ", p90 "
+            << Percentile(latencies_ns, 90) << ", p99 " << Percentile(latencies_ns, 99)
+            << ", p99.9 " << Percentile(latencies_ns, 99.9) << ", max "
+            << Percentile(latencies_ns, 100) << std::endl;
+
+  writer->Stop();
+  reader->Stop();
+  return 0;
+}
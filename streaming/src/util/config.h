@@ -8,8 +8,11 @@ namespace ray {
 namespace streaming {
 enum class ConfigEnum : uint32_t {
   QUEUE_ID_VECTOR = 0,
+  LOCAL_TRANSPORT_RING_SIZE = 1,
+  REPLAY_LOG_DIR = 2,
+  REPLAY_LOG_SEGMENT_SIZE = 3,
   MIN = QUEUE_ID_VECTOR,
-  MAX = QUEUE_ID_VECTOR
+  MAX = REPLAY_LOG_SEGMENT_SIZE
 };
 }
 }  // namespace ray